@@ -0,0 +1,92 @@
+#pragma once
+
+// Value sets of the extended-type adapter benchmark matrix
+// (bench_adapters.cpp): boundaries and typical values of each SQL type,
+// the same kinds of values the adapter tests in tests/adapters check.
+
+#include <array>
+#include <chrono>
+#include <string_view>
+
+namespace fbpp::bench::adapter_values {
+
+// INT128 <-> ttmath Int128
+
+inline constexpr std::string_view kInt128Max = "170141183460469231731687303715884105727";
+inline constexpr std::string_view kInt128Min = "-170141183460469231731687303715884105728";
+
+inline constexpr std::array<std::string_view, 7> kInt128 = {
+    "0",
+    "1",
+    "-1",
+    "1234567890",
+    "-1234567890",
+    "99999999999999999999999999999999",
+    "123456789012345678901234567890123456",
+};
+
+// NUMERIC(p, s) <-> TTNumeric, as text at the column's scale
+
+/// NUMERIC(18,4): BIGINT storage
+inline constexpr std::array<std::string_view, 5> kNumeric18_4 = {
+    "0.1234",
+    "-123.4567",
+    "29.99",
+    "0.15",
+    "0.0875",
+};
+
+/// NUMERIC(38,2): INT128 storage, up to the 36 integer digits
+inline constexpr std::array<std::string_view, 5> kNumeric38_2 = {
+    "123.45",
+    "149.95",
+    "-123.45",
+    "999999999999999999999999999999999999.99",
+    "-999999999999999999999999999999999999.99",
+};
+
+/// NUMERIC(38,6): INT128 storage, beyond 64 bits
+inline constexpr std::array<std::string_view, 3> kNumeric38_6 = {
+    "123.456789",
+    "0.999999",
+    "-12345678901234567890123.456789",
+};
+
+// DECFLOAT(16) / DECFLOAT(34) <-> CppDecimal DecDouble / DecQuad
+
+inline constexpr std::array<std::string_view, 5> kDecFloat16 = {
+    "9999999999999999",
+    "-12345.6789",
+    "123.456",
+    "1E-300",
+    "1E+300",
+};
+
+inline constexpr std::array<std::string_view, 8> kDecFloat34 = {
+    "0.1",
+    "0.01",
+    "0.001",
+    "123.456789012345678901234567890123",
+    "-999.999999999999999999999999999999",
+    "1E-30",
+    "1E+30",
+    "3.141592653589793238462643383279502884197",
+};
+
+// TIMESTAMP [WITH TIME ZONE] <-> std::chrono
+
+/// 2024-06-01 12:34:56.1234 UTC
+inline std::chrono::sys_time<std::chrono::microseconds> sampleUtcTime() {
+    using namespace std::chrono;
+    using namespace std::chrono_literals;
+
+    return sys_days{year{2024} / June / day{1}} + 12h + 34min + 56s + 123400us;
+}
+
+/// Zones of the round-trip tests; Warsaw is outside the legacy built-in subset
+inline constexpr std::array<std::string_view, 2> kZones = {
+    "Europe/Berlin",
+    "Europe/Warsaw",
+};
+
+} // namespace fbpp::bench::adapter_values
@@ -0,0 +1,280 @@
+// Offline adapter matrix: encode (pack) and decode (unpack) throughput of
+// every (SQL type, adapter) pair of the extended types over a synthetic
+// column buffer, with a precision check of the pair's value set
+// (adapter_values.hpp). Needs the Firebird client library, not a server.
+//
+// Each benchmark is labelled "<SQL type> / <adapter>" and reports, next to
+// the timings and items/s (one item = one cell):
+//
+//   values   size of the value set
+//   exact    values that come back identical after encode + decode
+//   lossy    values that do not (rounded, truncated or renormalized)
+//
+//   fbpp_bench --benchmark_filter=OfflineAdapter
+//   cmake --build . --target fbpp_bench_adapters   # -> fbpp_bench_adapters.csv
+
+#include "bench_support.hpp"
+
+#include "adapter_values.hpp"
+
+#include "fbpp/adapters/chrono_datetime.hpp"
+#include "fbpp/adapters/cppdecimal_decfloat.hpp"
+#include "fbpp/adapters/ttmath_int128.hpp"
+#include "fbpp/adapters/ttmath_numeric.hpp"
+#include "fbpp/core/pack_utils.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace fbpp::bench {
+
+namespace {
+
+using namespace fbpp::core;
+namespace sets = adapter_values;
+
+/// Rows (messages) of one synthetic column buffer
+constexpr unsigned kBlockRows = 64;
+
+template<typename T>
+using Row4 = std::tuple<T, T, T, T>;
+
+// One (SQL type, adapter) pair: the adapted C++ type, the column layout,
+// the value set and the text a value is compared by.
+
+struct Int128Pair {
+    using Value = adapters::Int128;
+    static constexpr const char* label = "INT128 / ttmath::Int";
+    static constexpr unsigned sqlType = SQL_INT128;
+    static constexpr unsigned length = 16;
+    static constexpr int scale = 0;
+
+    static std::vector<Value> values() {
+        std::vector<Value> result;
+        for (const auto text : sets::kInt128) {
+            result.push_back(make_int128(std::string(text)));
+        }
+        result.push_back(make_int128(std::string(sets::kInt128Max)));
+        result.push_back(make_int128(std::string(sets::kInt128Min)));
+        return result;
+    }
+    static std::string text(const Value& value) { return value.ToString(); }
+};
+
+template<unsigned SqlType, unsigned Length, int Scale, const auto& Set>
+struct NumericPair {
+    using Value = adapters::TTNumeric<2, Scale>;
+    static constexpr unsigned sqlType = SqlType;
+    static constexpr unsigned length = Length;
+    static constexpr int scale = Scale;
+
+    static std::vector<Value> values() {
+        std::vector<Value> result;
+        for (const auto text : Set) {
+            result.emplace_back(std::string(text));
+        }
+        return result;
+    }
+    static std::string text(const Value& value) { return value.to_string(); }
+};
+
+struct Numeric18_4Pair : NumericPair<SQL_INT64, 8, -4, sets::kNumeric18_4> {
+    static constexpr const char* label = "NUMERIC(18,4) / TTNumeric<2,-4>";
+};
+
+struct Numeric38_2Pair : NumericPair<SQL_INT128, 16, -2, sets::kNumeric38_2> {
+    static constexpr const char* label = "NUMERIC(38,2) / TTNumeric<2,-2>";
+};
+
+struct Numeric38_6Pair : NumericPair<SQL_INT128, 16, -6, sets::kNumeric38_6> {
+    static constexpr const char* label = "NUMERIC(38,6) / TTNumeric<2,-6>";
+};
+
+template<typename Decimal, unsigned SqlType, unsigned Length, const auto& Set>
+struct DecimalPair {
+    using Value = Decimal;
+    static constexpr unsigned sqlType = SqlType;
+    static constexpr unsigned length = Length;
+    static constexpr int scale = 0;
+
+    static std::vector<Value> values() {
+        std::vector<Value> result;
+        for (const auto text : Set) {
+            result.emplace_back(std::string(text).c_str());
+        }
+        return result;
+    }
+    static std::string text(const Value& value) { return value.toString(); }
+};
+
+struct DecFloat16Pair : DecimalPair<dec::DecDouble, SQL_DEC16, 8, sets::kDecFloat16> {
+    static constexpr const char* label = "DECFLOAT(16) / dec::DecDouble";
+};
+
+struct DecFloat34Pair : DecimalPair<dec::DecQuad, SQL_DEC34, 16, sets::kDecFloat34> {
+    static constexpr const char* label = "DECFLOAT(34) / dec::DecQuad";
+};
+
+struct TimestampPair {
+    using Value = std::chrono::system_clock::time_point;
+    static constexpr const char* label = "TIMESTAMP / system_clock::time_point";
+    static constexpr unsigned sqlType = SQL_TIMESTAMP;
+    static constexpr unsigned length = 8;
+    static constexpr int scale = 0;
+
+    static std::vector<Value> values() {
+        return {std::chrono::time_point_cast<Value::duration>(sets::sampleUtcTime())};
+    }
+    static std::string text(const Value& value) {
+        return std::to_string(value.time_since_epoch().count());
+    }
+};
+
+#if !defined(__BORLANDC__)
+struct TimestampTzPair {
+    using Value = ZonedTimestamp;
+    static constexpr const char* label = "TIMESTAMP WITH TIME ZONE / zoned_time";
+    static constexpr unsigned sqlType = SQL_TIMESTAMP_TZ;
+    static constexpr unsigned length = 12;
+    static constexpr int scale = 0;
+
+    static std::vector<Value> values() {
+        std::vector<Value> result;
+        for (const auto zone : sets::kZones) {
+            result.push_back(makeZonedTimestamp(zone, sets::sampleUtcTime()));
+        }
+        return result;
+    }
+    static std::string text(const Value& value) {
+        return std::to_string(value.get_sys_time().time_since_epoch().count()) + " " +
+               std::string(value.get_time_zone()->name());
+    }
+};
+#endif
+
+/**
+ * @brief kBlockRows messages of kColumns columns of one pair, the cells
+ *        cycling through its value set, and the result of its precision
+ *        check
+ */
+template<typename Pair>
+struct ColumnBlock {
+    using Value = typename Pair::Value;
+
+    std::shared_ptr<const MessageMetadata> metadata;
+    unsigned messageLength = 0;
+    std::vector<uint8_t> buffer;
+    std::vector<Row4<Value>> rows;
+    std::size_t valueCount = 0;
+    std::size_t exact = 0;
+
+    ColumnBlock() {
+        MessageBuilder builder(kColumns);
+        for (unsigned i = 0; i < kColumns; ++i) {
+            builder.addField("C" + std::to_string(i), Pair::sqlType, Pair::length, Pair::scale);
+        }
+        metadata = std::shared_ptr<const MessageMetadata>(builder.build());
+        messageLength = metadata->getMessageLength();
+        buffer.resize(static_cast<std::size_t>(messageLength) * kBlockRows);
+
+        const std::vector<Value> set = Pair::values();
+        valueCount = set.size();
+        for (const auto& value : set) {
+            Row4<Value> row{value, value, value, value};
+            pack(row, buffer.data(), metadata.get());
+            const auto restored = unpack<Row4<Value>>(buffer.data(), metadata.get());
+            if (Pair::text(std::get<0>(restored)) == Pair::text(value)) {
+                ++exact;
+            }
+        }
+
+        for (unsigned r = 0; r < kBlockRows; ++r) {
+            const auto cell = [&](unsigned c) -> const Value& {
+                return set[(r * kColumns + c) % set.size()];
+            };
+            rows.emplace_back(cell(0), cell(1), cell(2), cell(3));
+            pack(rows.back(), message(r), metadata.get());
+        }
+    }
+
+    uint8_t* message(unsigned row) {
+        return buffer.data() + static_cast<std::size_t>(row) * messageLength;
+    }
+
+    void report(benchmark::State& state) const {
+        state.SetLabel(Pair::label);
+        state.SetItemsProcessed(state.iterations() * kBlockRows * kColumns);
+        state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(buffer.size()));
+        state.counters["values"] = static_cast<double>(valueCount);
+        state.counters["exact"] = static_cast<double>(exact);
+        state.counters["lossy"] = static_cast<double>(valueCount - exact);
+    }
+};
+
+template<typename Pair>
+void BM_OfflineAdapterEncode(benchmark::State& state) {
+    std::unique_ptr<ColumnBlock<Pair>> block;
+    try {
+        block = std::make_unique<ColumnBlock<Pair>>();
+    } catch (const std::exception& e) {
+        state.SkipWithError(e.what());
+        return;
+    }
+    for (auto _ : state) {
+        for (unsigned r = 0; r < kBlockRows; ++r) {
+            pack(block->rows[r], block->message(r), block->metadata.get());
+        }
+        benchmark::DoNotOptimize(block->buffer.data());
+    }
+    block->report(state);
+}
+
+template<typename Pair>
+void BM_OfflineAdapterDecode(benchmark::State& state) {
+    std::unique_ptr<ColumnBlock<Pair>> block;
+    try {
+        block = std::make_unique<ColumnBlock<Pair>>();
+    } catch (const std::exception& e) {
+        state.SkipWithError(e.what());
+        return;
+    }
+    for (auto _ : state) {
+        for (unsigned r = 0; r < kBlockRows; ++r) {
+            auto row = unpack<Row4<typename Pair::Value>>(block->message(r),
+                                                          block->metadata.get());
+            benchmark::DoNotOptimize(row);
+        }
+    }
+    block->report(state);
+}
+
+#if !defined(__BORLANDC__)
+#define FBPP_BENCH_ADAPTER_TZ(fn) BENCHMARK_TEMPLATE(fn, TimestampTzPair)
+#else
+#define FBPP_BENCH_ADAPTER_TZ(fn) static_assert(true)
+#endif
+
+#define FBPP_BENCH_ADAPTER(fn)                   \
+    BENCHMARK_TEMPLATE(fn, Int128Pair);          \
+    BENCHMARK_TEMPLATE(fn, Numeric18_4Pair);     \
+    BENCHMARK_TEMPLATE(fn, Numeric38_2Pair);     \
+    BENCHMARK_TEMPLATE(fn, Numeric38_6Pair);     \
+    BENCHMARK_TEMPLATE(fn, DecFloat16Pair);      \
+    BENCHMARK_TEMPLATE(fn, DecFloat34Pair);      \
+    BENCHMARK_TEMPLATE(fn, TimestampPair);       \
+    FBPP_BENCH_ADAPTER_TZ(fn)
+
+FBPP_BENCH_ADAPTER(BM_OfflineAdapterEncode);
+FBPP_BENCH_ADAPTER(BM_OfflineAdapterDecode);
+
+#undef FBPP_BENCH_ADAPTER
+#undef FBPP_BENCH_ADAPTER_TZ
+
+} // namespace
+
+} // namespace fbpp::bench
@@ -0,0 +1,273 @@
+// Offline codec benchmarks: pack / unpack of tuples, structs and JSON over
+// synthetic IMetadataBuilder layouts, and the three row access paths
+// (RowView, Row, unpack<T>) over one packed message. Needs the Firebird
+// client library, not a server.
+
+#include "bench_support.hpp"
+
+#include "fbpp/core/pack_utils.hpp"
+#include "fbpp/core/row.hpp"
+#include "fbpp/core/struct_descriptor.hpp"
+#include "fbpp/core/type_traits.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace fbpp::bench {
+
+// kColumns columns of one type, as a struct
+template<typename T>
+struct Cells {
+    T c0;
+    T c1;
+    T c2;
+    T c3;
+};
+
+} // namespace fbpp::bench
+
+namespace fbpp::core {
+
+template<typename T>
+struct StructDescriptor<fbpp::bench::Cells<T>> {
+    static constexpr unsigned length() {
+        if constexpr (std::is_same_v<T, std::string>) {
+            return fbpp::bench::kVarcharLength;
+        } else {
+            return static_cast<unsigned>(FirebirdTypeTraits<T>::size);
+        }
+    }
+    static constexpr unsigned type = static_cast<unsigned>(FirebirdTypeTraits<T>::sql_type);
+
+    static constexpr auto fields = std::make_tuple(
+        makeField<&fbpp::bench::Cells<T>::c0>("C0", type, 0, length(), 0, true),
+        makeField<&fbpp::bench::Cells<T>::c1>("C1", type, 0, length(), 0, true),
+        makeField<&fbpp::bench::Cells<T>::c2>("C2", type, 0, length(), 0, true),
+        makeField<&fbpp::bench::Cells<T>::c3>("C3", type, 0, length(), 0, true)
+    );
+};
+
+} // namespace fbpp::core
+
+namespace fbpp::bench {
+
+namespace {
+
+using namespace fbpp::core;
+
+template<typename T>
+using Row4 = std::tuple<T, T, T, T>;
+
+template<typename T>
+Row4<T> sampleRow() {
+    const T value = sampleValue<T>();
+    return Row4<T>{value, value, value, value};
+}
+
+template<typename T>
+Cells<T> sampleCells() {
+    const T value = sampleValue<T>();
+    return Cells<T>{value, value, value, value};
+}
+
+// Metadata plus one message packed from the sample row
+template<typename T>
+struct Message {
+    std::shared_ptr<const MessageMetadata> metadata = syntheticMetadata<T>();
+    std::vector<uint8_t> buffer = std::vector<uint8_t>(metadata->getMessageLength());
+
+    Message() { pack(sampleRow<T>(), buffer.data(), metadata.get()); }
+};
+
+template<typename T>
+void BM_OfflinePackTuple(benchmark::State& state) {
+    Message<T> message;
+    const auto row = sampleRow<T>();
+    for (auto _ : state) {
+        pack(row, message.buffer.data(), message.metadata.get());
+        benchmark::DoNotOptimize(message.buffer.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename T>
+void BM_OfflineUnpackTuple(benchmark::State& state) {
+    Message<T> message;
+    for (auto _ : state) {
+        auto row = unpack<Row4<T>>(message.buffer.data(), message.metadata.get());
+        benchmark::DoNotOptimize(row);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename T>
+void BM_OfflinePackStruct(benchmark::State& state) {
+    Message<T> message;
+    const auto cells = sampleCells<T>();
+    for (auto _ : state) {
+        pack(cells, message.buffer.data(), message.metadata.get());
+        benchmark::DoNotOptimize(message.buffer.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename T>
+void BM_OfflineUnpackStruct(benchmark::State& state) {
+    Message<T> message;
+    for (auto _ : state) {
+        auto cells = unpack<Cells<T>>(message.buffer.data(), message.metadata.get());
+        benchmark::DoNotOptimize(cells);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename T>
+void BM_OfflinePackJson(benchmark::State& state) {
+    Message<T> message;
+    // The JSON form the unpacker produces, as positional parameters
+    nlohmann::json params = nlohmann::json::array();
+    for (const auto& [name, value] :
+         unpack<nlohmann::json>(message.buffer.data(), message.metadata.get()).items()) {
+        params.push_back(value);
+    }
+    for (auto _ : state) {
+        pack(params, message.buffer.data(), message.metadata.get());
+        benchmark::DoNotOptimize(message.buffer.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename T>
+void BM_OfflineUnpackJson(benchmark::State& state) {
+    Message<T> message;
+    for (auto _ : state) {
+        auto json = unpack<nlohmann::json>(message.buffer.data(), message.metadata.get());
+        benchmark::DoNotOptimize(json);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+#define FBPP_BENCH_CODEC(fn)                 \
+    BENCHMARK_TEMPLATE(fn, int32_t);         \
+    BENCHMARK_TEMPLATE(fn, int64_t);         \
+    BENCHMARK_TEMPLATE(fn, double);          \
+    BENCHMARK_TEMPLATE(fn, std::string);     \
+    BENCHMARK_TEMPLATE(fn, Int128);          \
+    BENCHMARK_TEMPLATE(fn, DecFloat16);      \
+    BENCHMARK_TEMPLATE(fn, DecFloat34);      \
+    BENCHMARK_TEMPLATE(fn, Date);            \
+    BENCHMARK_TEMPLATE(fn, Time);            \
+    BENCHMARK_TEMPLATE(fn, Timestamp);       \
+    BENCHMARK_TEMPLATE(fn, TimestampTz);     \
+    BENCHMARK_TEMPLATE(fn, TimeTz)
+
+FBPP_BENCH_CODEC(BM_OfflinePackTuple);
+FBPP_BENCH_CODEC(BM_OfflineUnpackTuple);
+FBPP_BENCH_CODEC(BM_OfflinePackStruct);
+FBPP_BENCH_CODEC(BM_OfflineUnpackStruct);
+FBPP_BENCH_CODEC(BM_OfflinePackJson);
+FBPP_BENCH_CODEC(BM_OfflineUnpackJson);
+
+#undef FBPP_BENCH_CODEC
+
+// Numeric columns as text: get<std::string> / string parameters, the
+// to_chars / from_chars paths of the codec
+
+template<typename T>
+void BM_OfflineUnpackAsString(benchmark::State& state) {
+    Message<T> message;
+    for (auto _ : state) {
+        auto row = unpack<Row4<std::string>>(message.buffer.data(), message.metadata.get());
+        benchmark::DoNotOptimize(row);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename T>
+void BM_OfflinePackFromString(benchmark::State& state) {
+    Message<T> message;
+    const auto row = unpack<Row4<std::string>>(message.buffer.data(), message.metadata.get());
+    for (auto _ : state) {
+        pack(row, message.buffer.data(), message.metadata.get());
+        benchmark::DoNotOptimize(message.buffer.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+#define FBPP_BENCH_NUMBER_TEXT(fn)           \
+    BENCHMARK_TEMPLATE(fn, int32_t);         \
+    BENCHMARK_TEMPLATE(fn, int64_t);         \
+    BENCHMARK_TEMPLATE(fn, double);          \
+    BENCHMARK_TEMPLATE(fn, DecFloat34)
+
+FBPP_BENCH_NUMBER_TEXT(BM_OfflineUnpackAsString);
+FBPP_BENCH_NUMBER_TEXT(BM_OfflinePackFromString);
+
+#undef FBPP_BENCH_NUMBER_TEXT
+
+// Row access: the same 4 x VARCHAR / INTEGER message read three ways
+
+using AccessRow = std::tuple<int32_t, std::string, double, Int128>;
+
+struct AccessMessage {
+    std::shared_ptr<const MessageMetadata> metadata;
+    std::vector<uint8_t> buffer;
+
+    AccessMessage() {
+        MessageBuilder builder(4);
+        builder.addField<int32_t>("ID");
+        builder.addFieldWithLength<std::string>("NAME", kVarcharLength);
+        builder.addField<double>("AMOUNT");
+        builder.addField<Int128>("BIG");
+        metadata = std::shared_ptr<const MessageMetadata>(builder.build());
+        buffer.resize(metadata->getMessageLength());
+        pack(AccessRow{42, sampleValue<std::string>(), 1.25, sampleValue<Int128>()},
+             buffer.data(), metadata.get());
+    }
+};
+
+void BM_OfflineRowView(benchmark::State& state) {
+    AccessMessage message;
+    for (auto _ : state) {
+        RowView view(message.metadata, message.buffer.data(), nullptr);
+        benchmark::DoNotOptimize(view.get<int32_t>(0));
+        benchmark::DoNotOptimize(view.getView(1));
+        benchmark::DoNotOptimize(view.get<double>(2));
+        benchmark::DoNotOptimize(view.get<Int128>(3));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OfflineRowView);
+
+void BM_OfflineRow(benchmark::State& state) {
+    AccessMessage message;
+    for (auto _ : state) {
+        // The owning snapshot fetchOne() returns: buffer copy included
+        Row row(message.metadata, message.buffer, nullptr);
+        benchmark::DoNotOptimize(row.get<int32_t>(0));
+        benchmark::DoNotOptimize(row.get<std::string>(1));
+        benchmark::DoNotOptimize(row.get<double>(2));
+        benchmark::DoNotOptimize(row.get<Int128>(3));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OfflineRow);
+
+void BM_OfflineFetchTuple(benchmark::State& state) {
+    AccessMessage message;
+    for (auto _ : state) {
+        // What ResultSet::fetch<T>() does per row
+        auto row = unpack<AccessRow>(message.buffer.data(), message.metadata.get());
+        benchmark::DoNotOptimize(row);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OfflineFetchTuple);
+
+} // namespace
+
+} // namespace fbpp::bench
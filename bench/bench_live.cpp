@@ -0,0 +1,216 @@
+// Live end-to-end benchmarks against the scratch database (see
+// LiveDatabase): full scans through the three row access paths, Batch
+// addMany, the cost of the attachment counter info request, and prepare
+// latency per IStatement prefetch profile.
+
+#include "bench_support.hpp"
+
+#include "fbpp/core/batch.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace fbpp::bench {
+
+namespace {
+
+using namespace fbpp::core;
+
+const std::string kScanSql = "SELECT ID, NAME, AMOUNT, BIG, DF, TS FROM BENCH_T";
+
+using ScanRow = std::tuple<int32_t, std::optional<std::string>, std::optional<double>,
+                           std::optional<Int128>, std::optional<DecFloat34>,
+                           std::optional<Timestamp>>;
+
+// Scan benchmarks: one iteration = one full scan of BENCH_T; items = rows
+template<typename Body>
+void scan(benchmark::State& state, Body body) {
+    auto* db = LiveDatabase::get(state);
+    if (!db) {
+        return;
+    }
+    auto stmt = db->connection().prepareStatement(kScanSql);
+    int64_t rows = 0;
+    for (auto _ : state) {
+        auto tx = db->connection().StartTransaction();
+        auto cursor = tx->openCursor(stmt);
+        cursor->setPrefetch(static_cast<unsigned>(state.range(0)));
+        rows += body(*cursor);
+        cursor->close();
+        tx->Commit();
+    }
+    state.SetItemsProcessed(rows);
+}
+
+void BM_LiveScanFetchTuple(benchmark::State& state) {
+    scan(state, [](ResultSet& cursor) {
+        int64_t n = 0;
+        ScanRow row;
+        while (cursor.fetch(row)) {
+            benchmark::DoNotOptimize(row);
+            ++n;
+        }
+        return n;
+    });
+}
+BENCHMARK(BM_LiveScanFetchTuple)->Arg(1)->Arg(64)->Unit(benchmark::kMillisecond);
+
+void BM_LiveScanRowView(benchmark::State& state) {
+    scan(state, [](ResultSet& cursor) {
+        int64_t n = 0;
+        for (const auto& view : cursor.rows()) {
+            benchmark::DoNotOptimize(view.get<int32_t>(0));
+            benchmark::DoNotOptimize(view.getView(1));
+            benchmark::DoNotOptimize(view.get<double>(2));
+            benchmark::DoNotOptimize(view.get<Int128>(3));
+            benchmark::DoNotOptimize(view.get<DecFloat34>(4));
+            benchmark::DoNotOptimize(view.get<Timestamp>(5));
+            ++n;
+        }
+        return n;
+    });
+}
+BENCHMARK(BM_LiveScanRowView)->Arg(1)->Arg(64)->Unit(benchmark::kMillisecond);
+
+void BM_LiveScanRow(benchmark::State& state) {
+    scan(state, [](ResultSet& cursor) {
+        int64_t n = 0;
+        while (auto row = cursor.fetchOne()) {
+            benchmark::DoNotOptimize(row->get<int32_t>(0));
+            benchmark::DoNotOptimize(row->get<std::string>(1));
+            benchmark::DoNotOptimize(row->get<double>(2));
+            benchmark::DoNotOptimize(row->get<Int128>(3));
+            benchmark::DoNotOptimize(row->get<DecFloat34>(4));
+            benchmark::DoNotOptimize(row->get<Timestamp>(5));
+            ++n;
+        }
+        return n;
+    });
+}
+BENCHMARK(BM_LiveScanRow)->Arg(1)->Arg(64)->Unit(benchmark::kMillisecond);
+
+void BM_LivePointLookup(benchmark::State& state) {
+    auto* db = LiveDatabase::get(state);
+    if (!db) {
+        return;
+    }
+    auto stmt = db->connection().prepareStatement("SELECT ID, NAME FROM BENCH_T WHERE ID = ?");
+    auto tx = db->connection().StartTransaction();
+    int32_t id = 0;
+    for (auto _ : state) {
+        id = id % kLiveRows + 1;
+        auto cursor = tx->openCursor(stmt, std::make_tuple(id));
+        std::tuple<int32_t, std::optional<std::string>> row;
+        benchmark::DoNotOptimize(cursor->fetch(row));
+        cursor->close();
+    }
+    tx->Commit();
+}
+BENCHMARK(BM_LivePointLookup)->Unit(benchmark::kMicrosecond);
+
+// One iteration = range(0) rows through addMany + execute, rolled back
+void BM_LiveBatchAddMany(benchmark::State& state) {
+    auto* db = LiveDatabase::get(state);
+    if (!db) {
+        return;
+    }
+    const auto count = static_cast<int32_t>(state.range(0));
+    using Insert = std::tuple<int32_t, std::string, double, Int128, DecFloat34, Timestamp>;
+    std::vector<Insert> rows;
+    rows.reserve(count);
+    for (int32_t i = 1; i <= count; ++i) {
+        rows.emplace_back(kLiveRows + i, "batch " + std::to_string(i), i * 0.5,
+                          Int128(int64_t{i}), sampleValue<DecFloat34>(), sampleValue<Timestamp>());
+    }
+    auto stmt = db->connection().prepareStatement(
+        "INSERT INTO BENCH_T (ID, NAME, AMOUNT, BIG, DF, TS) VALUES (?, ?, ?, ?, ?, ?)");
+    for (auto _ : state) {
+        auto tx = db->connection().StartTransaction();
+        auto batch = stmt->createBatch(tx.get(), false);
+        batch->addMany(rows);
+        batch->execute(tx.get());
+        tx->Rollback();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_LiveBatchAddMany)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+// One uncached prepare with the prefetch flags of range(0), followed by
+// what fbpp reads of every statement (type, both message formats), so
+// items a profile leaves out are paid as the extra round trips they cost
+void BM_LivePrepareProfile(benchmark::State& state) {
+    auto* db = LiveDatabase::get(state);
+    if (!db) {
+        return;
+    }
+    static const unsigned kProfiles[] = {
+        Statement::PREPARE_PREFETCH_NONE,
+        Statement::PREPARE_PREFETCH_MINIMAL,
+        Statement::PREPARE_PREFETCH_METADATA,
+        Statement::PREPARE_PREFETCH_ALL,
+    };
+    static const char* const kNames[] = {"none", "minimal", "metadata", "all"};
+    const auto profile = static_cast<std::size_t>(state.range(0));
+    state.SetLabel(kNames[profile]);
+    for (auto _ : state) {
+        auto stmt = db->connection().prepareStatementUncached(
+            "SELECT ID, NAME, AMOUNT FROM BENCH_T WHERE ID BETWEEN ? AND ?", kProfiles[profile]);
+        benchmark::DoNotOptimize(stmt->getType());
+        benchmark::DoNotOptimize(stmt->getInputMetadata()->getCount());
+        benchmark::DoNotOptimize(stmt->getOutputMetadata()->getCount());
+    }
+}
+BENCHMARK(BM_LivePrepareProfile)->DenseRange(0, 3)->Unit(benchmark::kMicrosecond);
+
+// Cost of one Connection::getServerCounters() reading; captureServerCounters
+// pays two per execute / cursor.
+void BM_LiveServerCounters(benchmark::State& state) {
+    auto* db = LiveDatabase::get(state);
+    if (!db) {
+        return;
+    }
+    for (auto _ : state) {
+        auto counters = db->connection().getServerCounters();
+        benchmark::DoNotOptimize(counters);
+    }
+}
+BENCHMARK(BM_LiveServerCounters)->Unit(benchmark::kMicrosecond);
+
+// The same lookup through the statement cache with metrics, with and
+// without server counter capture (range(0))
+void BM_LiveLookupWithMetrics(benchmark::State& state) {
+    auto* db = LiveDatabase::get(state);
+    if (!db) {
+        return;
+    }
+    auto& connection = db->connection();
+    const auto saved = connection.getStatementCacheConfig();
+    auto config = saved;
+    config.collectMetrics = true;
+    config.captureServerCounters = state.range(0) != 0;
+    connection.setStatementCacheConfig(config);
+
+    auto stmt = connection.prepareStatement("SELECT ID, NAME FROM BENCH_T WHERE ID = ?");
+    auto tx = connection.StartTransaction();
+    int32_t id = 0;
+    for (auto _ : state) {
+        id = id % kLiveRows + 1;
+        auto cursor = tx->openCursor(stmt, std::make_tuple(id));
+        std::tuple<int32_t, std::optional<std::string>> row;
+        benchmark::DoNotOptimize(cursor->fetch(row));
+        cursor->close();
+    }
+    tx->Commit();
+    connection.setStatementCacheConfig(saved);
+}
+BENCHMARK(BM_LiveLookupWithMetrics)->ArgName("counters")->Arg(0)->Arg(1)
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+
+} // namespace fbpp::bench
@@ -0,0 +1,173 @@
+// Replay benchmarks: the live scans and batch load of bench_live.cpp run
+// against recorded messages (fbpp_util/replay_backend.hpp) instead of a
+// server. Decoding and packing cost without network or engine noise, and
+// stable enough to track between builds.
+
+#include "bench_support.hpp"
+
+#include "fbpp/core/batch.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp_util/alloc_counter.hpp"
+#include "fbpp_util/replay_backend.hpp"
+
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace fbpp::bench {
+
+namespace {
+
+using namespace fbpp::core;
+using fbpp::util::RecordedMessages;
+using fbpp::util::ReplayCapture;
+using fbpp::util::ReplaySession;
+
+using ScanRow = std::tuple<int32_t, std::optional<std::string>, std::optional<double>,
+                           std::optional<Int128>, std::optional<DecFloat34>,
+                           std::optional<Timestamp>>;
+using Insert = std::tuple<int32_t, std::string, double, Int128, DecFloat34, Timestamp>;
+
+// Same columns as BENCH_T
+std::shared_ptr<const MessageMetadata> benchLayout() {
+    MessageBuilder builder(6);
+    builder.addField<int32_t>("ID");
+    builder.addFieldWithLength<std::string>("NAME", kVarcharLength);
+    builder.addField<double>("AMOUNT");
+    builder.addField<Int128>("BIG");
+    builder.addField<DecFloat34>("DF");
+    builder.addField<Timestamp>("TS");
+    return std::shared_ptr<const MessageMetadata>(builder.build());
+}
+
+std::vector<Insert> insertRows(int32_t count) {
+    std::vector<Insert> rows;
+    rows.reserve(count);
+    for (int32_t i = 1; i <= count; ++i) {
+        rows.emplace_back(i, "row " + std::to_string(i), i * 0.5, Int128(int64_t{i}),
+                          sampleValue<DecFloat34>(), sampleValue<Timestamp>());
+    }
+    return rows;
+}
+
+struct Replay {
+    ReplaySession session;
+    std::shared_ptr<const RecordedMessages> input;
+    std::shared_ptr<const RecordedMessages> rows;   // kLiveRows, packed by Batch
+};
+
+Replay& replay() {
+    static Replay instance = [] {
+        Replay r;
+        auto metadata = benchLayout();
+        r.input = std::make_shared<RecordedMessages>(*metadata);
+        auto capture = std::make_shared<ReplayCapture>(true);
+        auto insert = r.session.prepareInsert(r.input, capture);
+        auto batch = insert->createBatch(r.session.transaction().get(), false);
+        batch->addMany(insertRows(kLiveRows));
+        batch->execute(r.session.transaction().get());
+
+        auto rows = std::make_shared<RecordedMessages>(*metadata);
+        const auto bytes = capture->data();
+        for (size_t offset = 0; offset < bytes.size(); offset += rows->messageLength()) {
+            rows->add(bytes.data() + offset);
+        }
+        r.rows = std::move(rows);
+        return r;
+    }();
+    return instance;
+}
+
+// Heap allocations per row over the timed loop, cursor open and close included
+void countAllocations(benchmark::State& state, const fbpp::util::AllocationCounter& counter,
+                      int64_t rows) {
+    state.counters["allocs/row"] =
+        rows ? static_cast<double>(counter.allocations()) / static_cast<double>(rows) : 0.0;
+}
+
+// One iteration = one cursor over the kLiveRows recorded rows; items = rows
+template<typename Body>
+void scan(benchmark::State& state, Body body) {
+    auto& r = replay();
+    auto stmt = r.session.prepare(r.rows);
+    int64_t rows = 0;
+    fbpp::util::AllocationCounter allocations;
+    for (auto _ : state) {
+        auto cursor = r.session.transaction()->openCursor(stmt);
+        cursor->setPrefetch(static_cast<unsigned>(state.range(0)));
+        rows += body(*cursor);
+        cursor->close();
+    }
+    countAllocations(state, allocations, rows);
+    state.SetItemsProcessed(rows);
+}
+
+} // namespace
+
+void BM_ReplayScanFetchTuple(benchmark::State& state) {
+    scan(state, [](ResultSet& cursor) {
+        int64_t n = 0;
+        ScanRow row;
+        while (cursor.fetch(row)) {
+            benchmark::DoNotOptimize(row);
+            ++n;
+        }
+        return n;
+    });
+}
+BENCHMARK(BM_ReplayScanFetchTuple)->Arg(1)->Arg(64)->Unit(benchmark::kMillisecond);
+
+void BM_ReplayScanRowView(benchmark::State& state) {
+    scan(state, [](ResultSet& cursor) {
+        int64_t n = 0;
+        for (const auto& view : cursor.rows()) {
+            benchmark::DoNotOptimize(view.get<int32_t>(0));
+            benchmark::DoNotOptimize(view.getView(1));
+            benchmark::DoNotOptimize(view.get<double>(2));
+            benchmark::DoNotOptimize(view.get<Int128>(3));
+            benchmark::DoNotOptimize(view.get<DecFloat34>(4));
+            benchmark::DoNotOptimize(view.get<Timestamp>(5));
+            ++n;
+        }
+        return n;
+    });
+}
+BENCHMARK(BM_ReplayScanRowView)->Arg(1)->Arg(64)->Unit(benchmark::kMillisecond);
+
+void BM_ReplayScanRow(benchmark::State& state) {
+    scan(state, [](ResultSet& cursor) {
+        int64_t n = 0;
+        while (auto row = cursor.fetchOne()) {
+            benchmark::DoNotOptimize(row->get<int32_t>(0));
+            benchmark::DoNotOptimize(row->get<std::string>(1));
+            benchmark::DoNotOptimize(row->get<double>(2));
+            benchmark::DoNotOptimize(row->get<Int128>(3));
+            benchmark::DoNotOptimize(row->get<DecFloat34>(4));
+            benchmark::DoNotOptimize(row->get<Timestamp>(5));
+            ++n;
+        }
+        return n;
+    });
+}
+BENCHMARK(BM_ReplayScanRow)->Arg(1)->Arg(64)->Unit(benchmark::kMillisecond);
+
+// One iteration = range(0) rows packed through addMany + execute
+void BM_ReplayBatchAddMany(benchmark::State& state) {
+    auto& r = replay();
+    const auto rows = insertRows(static_cast<int32_t>(state.range(0)));
+    auto stmt = r.session.prepareInsert(r.input, nullptr);
+    fbpp::util::AllocationCounter allocations;
+    for (auto _ : state) {
+        auto batch = stmt->createBatch(r.session.transaction().get(), false);
+        batch->addMany(rows);
+        benchmark::DoNotOptimize(batch->execute(r.session.transaction().get()));
+    }
+    countAllocations(state, allocations, state.iterations() * state.range(0));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ReplayBatchAddMany)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+} // namespace fbpp::bench
@@ -0,0 +1,113 @@
+// SQL front-end benchmarks: named-parameter parsing and cache key hashing
+// (offline), StatementCache::get hits and misses (live).
+
+#include "bench_support.hpp"
+
+#include "fbpp/core/named_param_parser.hpp"
+#include "fbpp/core/statement_cache.hpp"
+
+#include <string>
+
+namespace fbpp::bench {
+
+namespace {
+
+using namespace fbpp::core;
+
+const std::string kNamedSql =
+    "SELECT o.id, o.customer_id, o.total, c.name\n"
+    "  FROM orders o JOIN customers c ON c.id = o.customer_id\n"
+    " WHERE o.created_at >= :from AND o.created_at < :to -- window\n"
+    "   AND (o.status = :status OR :status IS NULL)\n"
+    "   AND c.region = 'north' /* literal, not a :param */\n"
+    " ORDER BY o.created_at DESC ROWS :limit";
+
+void BM_OfflineNamedParamParse(benchmark::State& state) {
+    for (auto _ : state) {
+        auto result = NamedParamParser::parse(kNamedSql);
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(kNamedSql.size()));
+}
+BENCHMARK(BM_OfflineNamedParamParse);
+
+void BM_OfflineNamedParamParseCached(benchmark::State& state) {
+    for (auto _ : state) {
+        auto result = NamedParamParser::parseCached(kNamedSql);
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_OfflineNamedParamParseCached);
+
+// The statement cache key: normalized-token hash of the text
+void BM_OfflineSqlKeyHash(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(SqlKey::hashOf(kNamedSql, 0));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(kNamedSql.size()));
+}
+BENCHMARK(BM_OfflineSqlKeyHash);
+
+void BM_OfflineSqlKeyEquivalent(benchmark::State& state) {
+    const std::string other = "select O.ID, o.customer_id, o.total, c.name from orders o "
+                              "join customers c on c.id = o.customer_id where "
+                              "o.created_at >= :from and o.created_at < :to and "
+                              "(o.status = :status or :status is null) and "
+                              "c.region = 'north' order by o.created_at desc rows :limit";
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(SqlKey::equivalent(kNamedSql, other));
+    }
+}
+BENCHMARK(BM_OfflineSqlKeyEquivalent);
+
+void BM_LiveStatementCacheHit(benchmark::State& state) {
+    auto* db = LiveDatabase::get(state);
+    if (!db) {
+        return;
+    }
+    StatementCache cache;
+    const std::string sql = "SELECT ID, NAME FROM BENCH_T WHERE ID = ?";
+    cache.get(&db->connection(), sql);   // Prepared once
+    for (auto _ : state) {
+        auto stmt = cache.get(&db->connection(), sql);
+        benchmark::DoNotOptimize(stmt.get());
+    }
+}
+BENCHMARK(BM_LiveStatementCacheHit);
+
+void BM_LiveStatementCacheHitKey(benchmark::State& state) {
+    auto* db = LiveDatabase::get(state);
+    if (!db) {
+        return;
+    }
+    StatementCache cache;
+    const SqlKey key("SELECT ID, NAME FROM BENCH_T WHERE ID = ?");
+    cache.get(&db->connection(), key);
+    for (auto _ : state) {
+        auto stmt = cache.get(&db->connection(), key);
+        benchmark::DoNotOptimize(stmt.get());
+    }
+}
+BENCHMARK(BM_LiveStatementCacheHitKey);
+
+// A miss is a server prepare: every iteration uses new SQL text
+void BM_LiveStatementCacheMiss(benchmark::State& state) {
+    auto* db = LiveDatabase::get(state);
+    if (!db) {
+        return;
+    }
+    StatementCache::CacheConfig config;
+    config.maxSize = 64;
+    StatementCache cache(config);
+    int64_t n = 0;
+    for (auto _ : state) {
+        auto stmt = cache.get(&db->connection(),
+                              "SELECT ID, NAME FROM BENCH_T WHERE ID = " + std::to_string(++n));
+        benchmark::DoNotOptimize(stmt.get());
+    }
+}
+BENCHMARK(BM_LiveStatementCacheMiss)->Unit(benchmark::kMicrosecond);
+
+} // namespace
+
+} // namespace fbpp::bench
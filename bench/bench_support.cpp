@@ -0,0 +1,129 @@
+#include "bench_support.hpp"
+
+#include "fbpp/core/batch.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp_util/connection_helper.hpp"
+
+#include <chrono>
+#include <exception>
+#include <tuple>
+
+namespace fbpp::bench {
+
+using namespace fbpp::core;
+
+namespace {
+
+// GMT in Firebird's time zone table
+constexpr uint16_t kZoneGmt = 65535;
+
+Timestamp sampleTimestamp() {
+    using namespace std::chrono;
+    return Timestamp(sys_days{year{2024} / June / day{1}} + hours{12} + minutes{34} +
+                     seconds{56} + milliseconds{789});
+}
+
+// "<path>.fdb" -> "<path>_bench.fdb", keeping a "server:" prefix
+std::string benchDatabase(const std::string& database) {
+    const auto separator = database.rfind(':');
+    const auto pathStart = separator == std::string::npos ? 0 : separator + 1;
+    const auto dot = database.rfind('.');
+    if (dot == std::string::npos || dot < pathStart) {
+        return database + "_bench";
+    }
+    return database.substr(0, dot) + "_bench" + database.substr(dot);
+}
+
+} // namespace
+
+template<> int32_t sampleValue<int32_t>() { return 123456789; }
+template<> int64_t sampleValue<int64_t>() { return 1234567890123456789LL; }
+template<> double sampleValue<double>() { return 12345.6789; }
+template<> std::string sampleValue<std::string>() { return "benchmark value 0123"; }
+template<> Int128 sampleValue<Int128>() { return Int128(int64_t{1} << 62); }
+template<> DecFloat16 sampleValue<DecFloat16>() { return DecFloat16("1234567.890123"); }
+template<> DecFloat34 sampleValue<DecFloat34>() {
+    return DecFloat34("12345678901234567890.12345678901234");
+}
+template<> Date sampleValue<Date>() { return Date(2024, 6, 1); }
+template<> Time sampleValue<Time>() {
+    using namespace std::chrono;
+    return Time(hours{12} + minutes{34} + seconds{56} + milliseconds{789});
+}
+template<> Timestamp sampleValue<Timestamp>() { return sampleTimestamp(); }
+template<> TimestampTz sampleValue<TimestampTz>() {
+    return TimestampTz(sampleTimestamp(), kZoneGmt, 0);
+}
+template<> TimeTz sampleValue<TimeTz>() { return TimeTz(sampleValue<Time>(), kZoneGmt, 0); }
+
+LiveDatabase* LiveDatabase::get(benchmark::State& state) {
+    // One attempt per process: an unreachable server is not retried by
+    // every live benchmark.
+    static std::string error;
+    static std::unique_ptr<LiveDatabase> instance = [] {
+        std::unique_ptr<LiveDatabase> db(new LiveDatabase());
+        try {
+            db->setUp();
+            return db;
+        } catch (const std::exception& e) {
+            error = std::string("live database unavailable: ") + e.what();
+        }
+        return std::unique_ptr<LiveDatabase>();
+    }();
+
+    if (!instance) {
+        state.SkipWithError(error.c_str());
+    }
+    return instance.get();
+}
+
+void LiveDatabase::setUp() {
+    params_ = fbpp::util::getConnectionParams("tests.temp_db");
+    params_.database = benchDatabase(params_.database);
+    try {
+        Connection::dropDatabase(params_);
+    } catch (const FirebirdException&) {
+        // Not there yet
+    }
+    Connection::createDatabase(params_);
+    connection_ = std::make_unique<Connection>(params_);
+
+    connection_->ExecuteDDL(
+        "CREATE TABLE BENCH_T ("
+        " ID INTEGER NOT NULL PRIMARY KEY,"
+        " NAME VARCHAR(32),"
+        " AMOUNT NUMERIC(18,4),"
+        " BIG INT128,"
+        " DF DECFLOAT(34),"
+        " TS TIMESTAMP)");
+
+    using Seed = std::tuple<int32_t, std::string, double, Int128, DecFloat34, Timestamp>;
+    std::vector<Seed> rows;
+    rows.reserve(kLiveRows);
+    for (int32_t id = 1; id <= kLiveRows; ++id) {
+        rows.emplace_back(id, "name " + std::to_string(id), id * 1.25,
+                          Int128(static_cast<int64_t>(id) << 40), sampleValue<DecFloat34>(),
+                          sampleTimestamp());
+    }
+
+    auto tx = connection_->StartTransaction();
+    auto insert = connection_->prepareStatement(
+        "INSERT INTO BENCH_T (ID, NAME, AMOUNT, BIG, DF, TS) VALUES (?, ?, ?, ?, ?, ?)");
+    auto batch = insert->createBatch(tx.get());
+    batch->addMany(rows);
+    batch->execute(tx.get());
+    tx->Commit();
+}
+
+LiveDatabase::~LiveDatabase() {
+    connection_.reset();
+    try {
+        Connection::dropDatabase(params_);
+    } catch (...) {
+        // Best effort
+    }
+}
+
+} // namespace fbpp::bench
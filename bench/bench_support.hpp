@@ -0,0 +1,78 @@
+#pragma once
+
+// Shared fixtures of fbpp_bench: synthetic message layouts for the offline
+// benchmarks and one scratch database for the live ones.
+
+#include <benchmark/benchmark.h>
+
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/extended_types.hpp"
+#include "fbpp/core/message_builder.hpp"
+#include "fbpp/core/message_metadata.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fbpp::bench {
+
+/// Columns of every synthetic layout: one type, kColumns times
+constexpr unsigned kColumns = 4;
+
+/// VARCHAR length used for std::string columns
+constexpr unsigned kVarcharLength = 32;
+
+/// Rows seeded into the live table (BENCH_T)
+constexpr int32_t kLiveRows = 10000;
+
+/**
+ * @brief Output-style metadata of kColumns nullable columns of type T,
+ *        built with IMetadataBuilder (client library only, no server)
+ */
+template<typename T>
+std::shared_ptr<const core::MessageMetadata> syntheticMetadata() {
+    core::MessageBuilder builder(kColumns);
+    for (unsigned i = 0; i < kColumns; ++i) {
+        const std::string name = "C" + std::to_string(i);
+        if constexpr (std::is_same_v<T, std::string>) {
+            builder.addFieldWithLength<T>(name, kVarcharLength);
+        } else {
+            builder.addField<T>(name);
+        }
+    }
+    return std::shared_ptr<const core::MessageMetadata>(builder.build());
+}
+
+/// A representative non-trivial value of each benchmarked type
+template<typename T>
+T sampleValue();
+
+/**
+ * @brief Scratch database of the live benchmarks
+ *
+ * Recreated once per process from the "tests.temp_db" config section (its
+ * path gets a "_bench" suffix) and dropped at exit. Holds BENCH_T
+ * (ID INTEGER, NAME VARCHAR(32), AMOUNT NUMERIC(18,4), BIG INT128,
+ * DF DECFLOAT(34), TS TIMESTAMP) with kLiveRows rows. Live benchmarks call
+ * get(state) and return when it is null: the benchmark is then reported
+ * as skipped with the reason (no server, bad config).
+ */
+class LiveDatabase {
+public:
+    static LiveDatabase* get(benchmark::State& state);
+
+    core::Connection& connection() { return *connection_; }
+    const core::ConnectionParams& params() const { return params_; }
+
+    ~LiveDatabase();
+
+private:
+    LiveDatabase() = default;
+    void setUp();
+
+    core::ConnectionParams params_;
+    std::unique_ptr<core::Connection> connection_;
+};
+
+} // namespace fbpp::bench
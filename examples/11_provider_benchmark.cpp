@@ -0,0 +1,138 @@
+/**
+ * @file 11_provider_benchmark.cpp
+ * @brief Per-call latency of embedded, loopback, XNET and TCP attachments
+ *
+ * Runs the same small workloads through each way of reaching one local
+ * database file and prints the mean time per operation:
+ * - point lookup: execute + fetch of a prepared singleton SELECT
+ * - transaction:  start + commit of an empty transaction
+ * - scan:         fetch every row of RDB$RELATIONS
+ *
+ * Usage: 11_provider_benchmark <local database path> [iterations]
+ *
+ * Embedded needs the engine plugin under the Firebird root directory
+ * (FIREBIRD environment variable) and a database file the server does not
+ * hold open: SuperServer locks it exclusively, so run embedded against a
+ * copy or with the server stopped. Variants that cannot attach are
+ * reported and skipped. XNET exists on Windows only.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/exception.hpp"
+#include <fbpp_util/connection_helper.hpp>
+
+using namespace fbpp::core;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct Variant {
+    std::string name;
+    std::string database;
+    std::string providers;
+};
+
+// Mean microseconds per call of `op` over `iterations` calls
+double measure(int iterations, const std::function<void()>& op) {
+    op();   // Warm-up: first prepare, page cache
+    const auto started = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        op();
+    }
+    const auto elapsed = std::chrono::duration<double, std::micro>(Clock::now() - started);
+    return elapsed.count() / iterations;
+}
+
+void runVariant(const Variant& variant, const ConnectionParams& credentials, int iterations) {
+    ConnectionParams params = credentials;
+    params.database = variant.database;
+    params.providers = variant.providers;
+
+    std::cout << std::left << std::setw(10) << variant.name;
+    try {
+        const auto attachStarted = Clock::now();
+        Connection conn(params);
+        const auto attachMs =
+            std::chrono::duration<double, std::milli>(Clock::now() - attachStarted).count();
+
+        auto lookup = conn.prepareStatement(
+            "SELECT CURRENT_CONNECTION FROM RDB$DATABASE");
+        auto scan = conn.prepareStatement(
+            "SELECT RDB$RELATION_ID, RDB$RELATION_NAME FROM RDB$RELATIONS");
+
+        auto tx = conn.StartTransaction();
+        const double lookupUs = measure(iterations, [&] {
+            auto cursor = tx->openCursor(lookup);
+            std::tuple<int64_t> row;
+            cursor->fetch(row);
+            cursor->close();
+        });
+        const double scanUs = measure(std::max(1, iterations / 10), [&] {
+            auto cursor = tx->openCursor(scan);
+            std::tuple<int16_t, std::string> row;
+            while (cursor->fetch(row)) {
+            }
+            cursor->close();
+        });
+        tx->Commit();
+
+        const double transactionUs = measure(iterations, [&] {
+            conn.StartTransaction()->Commit();
+        });
+
+        std::cout << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(12) << attachMs
+                  << std::setw(14) << lookupUs
+                  << std::setw(14) << transactionUs
+                  << std::setw(14) << scanUs << "\n";
+    } catch (const std::exception& e) {
+        std::cout << "unavailable: " << e.what() << "\n";
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <local database path> [iterations]\n";
+        return 1;
+    }
+    const std::string path = argv[1];
+    const int iterations = argc > 2 ? std::max(1, std::atoi(argv[2])) : 2000;
+
+    // User / password from the regular example configuration
+    const auto credentials = fbpp::util::getConnectionParams("db");
+
+    std::vector<Variant> variants = {
+        {"embedded", path, "Engine13"},
+        {"loopback", path, "Loopback"},
+#if defined(_WIN32)
+        {"xnet", "xnet://" + path, "Remote"},
+#endif
+        {"tcp", "inet://localhost/" + path, "Remote"},
+    };
+
+    std::cout << "Iterations: " << iterations << " (scan: " << std::max(1, iterations / 10) << ")\n\n";
+    std::cout << std::left << std::setw(10) << "provider" << std::right
+              << std::setw(12) << "attach ms"
+              << std::setw(14) << "lookup us"
+              << std::setw(14) << "tx us"
+              << std::setw(14) << "scan us" << "\n";
+    for (const auto& variant : variants) {
+        runVariant(variant, credentials, iterations);
+    }
+    return 0;
+}
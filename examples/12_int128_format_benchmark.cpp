@@ -0,0 +1,128 @@
+/**
+ * @file 12_int128_format_benchmark.cpp
+ * @brief Native INT128 text conversion vs Firebird's IUtil / IInt128
+ *
+ * Formats and parses the same set of NUMERIC(38,4)-style values through
+ * IInt128::toString / fromString and through fbpp::core::toChars /
+ * int128FromString, and prints nanoseconds per value. Both paths produce
+ * identical text; the benchmark checks that as it goes.
+ *
+ * Usage: 12_int128_format_benchmark [values] [scale]
+ *
+ * Needs only the Firebird client library (no database).
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "fbpp/core/environment.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/extended_types.hpp"
+#include "fbpp/core/firebird_compat.hpp"
+#include "fbpp/core/int128_chars.hpp"
+
+using namespace fbpp::core;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+template<typename Fn>
+double nanosPerValue(size_t count, Fn&& fn) {
+    fn();   // Warm-up
+    const auto started = Clock::now();
+    fn();
+    const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - started);
+    return elapsed.count() / static_cast<double>(count);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    const int scale = argc > 2 ? std::atoi(argv[2]) : -4;
+
+    try {
+        auto& env = Environment::getInstance();
+        Firebird::ThrowStatusWrapper status(env.getMaster()->getStatus());
+        Firebird::IInt128* helper = env.getUtil()->getInt128(&status);
+
+        // Financial-looking magnitudes: mostly up to 10^18, some full width.
+        std::mt19937_64 rng(2024);
+        std::vector<Int128> values;
+        values.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t parts[2] = {rng(), (i % 8 == 0) ? (rng() >> 2) : 0};
+            if (parts[1] == 0) {
+                parts[0] %= 1000000000000000000ULL;
+            }
+            if (i % 3 == 0) {
+                parts[0] = ~parts[0] + 1;
+                parts[1] = ~parts[1] + (parts[0] == 0 ? 1 : 0);
+            }
+            values.emplace_back(reinterpret_cast<const uint8_t*>(parts));
+        }
+
+        std::vector<std::string> texts(count);
+        const double utilFormat = nanosPerValue(count, [&] {
+            char buffer[64];
+            for (size_t i = 0; i < count; ++i) {
+                FB_I128 raw;
+                std::memcpy(&raw, values[i].data(), 16);
+                helper->toString(&status, &raw, scale, sizeof(buffer), buffer);
+                texts[i] = buffer;
+            }
+        });
+
+        size_t mismatches = 0;
+        const double nativeFormat = nanosPerValue(count, [&] {
+            char buffer[kInt128MaxChars];
+            for (size_t i = 0; i < count; ++i) {
+                const auto result = toChars(buffer, buffer + sizeof(buffer), values[i], scale);
+                if (std::string_view(buffer, static_cast<size_t>(result.ptr - buffer)) != texts[i]) {
+                    ++mismatches;
+                }
+            }
+        });
+
+        const double utilParse = nanosPerValue(count, [&] {
+            for (size_t i = 0; i < count; ++i) {
+                FB_I128 raw;
+                helper->fromString(&status, scale, texts[i].c_str(), &raw);
+            }
+        });
+
+        const double nativeParse = nanosPerValue(count, [&] {
+            for (size_t i = 0; i < count; ++i) {
+                Int128 parsed;
+                const char* text = texts[i].data();
+                fromChars(text, text + texts[i].size(), parsed, scale);
+                if (parsed != values[i]) {
+                    ++mismatches;
+                }
+            }
+        });
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << count << " values, scale " << scale << " (ns per value)\n"
+                  << "  format  IUtil " << std::setw(8) << utilFormat
+                  << "   native " << std::setw(8) << nativeFormat << "\n"
+                  << "  parse   IUtil " << std::setw(8) << utilParse
+                  << "   native " << std::setw(8) << nativeParse << "\n";
+        status.dispose();
+
+        if (mismatches != 0) {
+            std::cerr << mismatches << " results differ from IUtil\n";
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,160 @@
+/**
+ * @file 13_decfloat_benchmark.cpp
+ * @brief Native DECFLOAT(16/34) conversion vs Firebird's IUtil / IDecFloat
+ *
+ * Formats and parses the same set of DECFLOAT(16) and DECFLOAT(34) values
+ * through IDecFloat16/34::toString / fromString and through
+ * fbpp::core::toChars / decFloat16FromString / decFloat34FromString, and
+ * prints nanoseconds per value. Both paths produce identical text and
+ * bytes; the benchmark checks that as it goes.
+ *
+ * Usage: 13_decfloat_benchmark [values]
+ *
+ * Needs only the Firebird client library (no database).
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "fbpp/core/decfloat_chars.hpp"
+#include "fbpp/core/environment.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/extended_types.hpp"
+#include "fbpp/core/firebird_compat.hpp"
+
+using namespace fbpp::core;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+template<typename Fn>
+double nanosPerValue(size_t count, Fn&& fn) {
+    fn();   // Warm-up
+    const auto started = Clock::now();
+    fn();
+    const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - started);
+    return elapsed.count() / static_cast<double>(count);
+}
+
+// Amounts and measurements: up to `digits` digits, modest exponents.
+std::vector<std::string> sampleTexts(size_t count, int digits) {
+    std::mt19937_64 rng(2019);
+    std::vector<std::string> texts;
+    texts.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::string text = (i % 3 == 0) ? "-" : "";
+        const int length = 1 + static_cast<int>(rng() % digits);
+        for (int d = 0; d < length; ++d) {
+            text += static_cast<char>('0' + rng() % 10);
+        }
+        text += "E" + std::to_string(static_cast<int>(rng() % 41) - 30);
+        texts.push_back(std::move(text));
+    }
+    return texts;
+}
+
+struct Timings {
+    double utilFormat;
+    double nativeFormat;
+    double utilParse;
+    double nativeParse;
+};
+
+template<typename Dec, typename Raw, typename Helper, typename Parse>
+Timings run(const std::vector<std::string>& inputs, Helper* helper,
+            Firebird::ThrowStatusWrapper& status, Parse parse, size_t& mismatches) {
+    const size_t count = inputs.size();
+    std::vector<Dec> values;
+    values.reserve(count);
+    for (const auto& text : inputs) {
+        values.push_back(parse(text));
+    }
+
+    Timings t{};
+    std::vector<std::string> texts(count);
+    t.utilFormat = nanosPerValue(count, [&] {
+        char buffer[64];
+        for (size_t i = 0; i < count; ++i) {
+            Raw raw;
+            std::memcpy(&raw, values[i].data(), sizeof(raw));
+            helper->toString(&status, &raw, sizeof(buffer), buffer);
+            texts[i] = buffer;
+        }
+    });
+
+    t.nativeFormat = nanosPerValue(count, [&] {
+        char buffer[64];
+        for (size_t i = 0; i < count; ++i) {
+            const auto result = toChars(buffer, buffer + sizeof(buffer), values[i]);
+            if (std::string_view(buffer, static_cast<size_t>(result.ptr - buffer)) != texts[i]) {
+                ++mismatches;
+            }
+        }
+    });
+
+    t.utilParse = nanosPerValue(count, [&] {
+        for (size_t i = 0; i < count; ++i) {
+            Raw raw;
+            helper->fromString(&status, texts[i].c_str(), &raw);
+        }
+    });
+
+    t.nativeParse = nanosPerValue(count, [&] {
+        for (size_t i = 0; i < count; ++i) {
+            if (parse(texts[i]) != values[i]) {
+                ++mismatches;
+            }
+        }
+    });
+    return t;
+}
+
+void print(const char* label, const Timings& t) {
+    std::cout << label << "\n"
+              << "  format  IUtil " << std::setw(8) << t.utilFormat
+              << "   native " << std::setw(8) << t.nativeFormat << "\n"
+              << "  parse   IUtil " << std::setw(8) << t.utilParse
+              << "   native " << std::setw(8) << t.nativeParse << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+
+    try {
+        auto& env = Environment::getInstance();
+        Firebird::ThrowStatusWrapper status(env.getMaster()->getStatus());
+        Firebird::IDecFloat16* helper16 = env.getUtil()->getDecFloat16(&status);
+        Firebird::IDecFloat34* helper34 = env.getUtil()->getDecFloat34(&status);
+
+        size_t mismatches = 0;
+        const Timings t16 = run<DecFloat16, FB_DEC16>(
+            sampleTexts(count, 16), helper16, status,
+            [](const std::string& text) { return decFloat16FromString(text); }, mismatches);
+        const Timings t34 = run<DecFloat34, FB_DEC34>(
+            sampleTexts(count, 34), helper34, status,
+            [](const std::string& text) { return decFloat34FromString(text); }, mismatches);
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << count << " values (ns per value)\n";
+        print("DECFLOAT(16)", t16);
+        print("DECFLOAT(34)", t34);
+        status.dispose();
+
+        if (mismatches != 0) {
+            std::cerr << mismatches << " results differ from IUtil\n";
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
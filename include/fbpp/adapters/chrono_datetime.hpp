@@ -6,6 +6,7 @@
 #include "fbpp/core/timestamp_utils.hpp"
 #include "fbpp/core/extended_types.hpp"
 #include "fbpp/core/firebird_compat.hpp"
+#include "fbpp/core/time_zone_table.hpp"
 #include <array>
 #include <chrono>
 #include <string>
@@ -104,97 +105,33 @@ struct TypeAdapter<std::chrono::zoned_time<std::chrono::microseconds>> {
         return std::chrono::microseconds(static_cast<int64_t>(value) * 100);
     }
 
+    // Both directions stay off IUtil per value: the UTC instant is plain
+    // arithmetic and zone ids / names come from the process-wide
+    // TimeZoneTable (one engine call per distinct zone).
     static firebird_type to_firebird(const user_type& zt) {
-        try {
-            auto& env = Environment::getInstance();
-            Firebird::ThrowStatusWrapper status(env.getMaster()->getStatus());
-            Firebird::IUtil* util = env.getUtil();
-
-            const auto localTime = std::chrono::time_point_cast<std::chrono::microseconds>(zt.get_local_time());
-            const auto localDay = std::chrono::floor<std::chrono::days>(localTime);
-            const auto ymd = std::chrono::year_month_day{localDay};
-            const auto timeOfDay = std::chrono::hh_mm_ss<std::chrono::microseconds>{
-                std::chrono::duration_cast<std::chrono::microseconds>(localTime - localDay)
-            };
-
-            ISC_TIMESTAMP_TZ raw{};
-            std::string timeZoneName(zt.get_time_zone()->name());
-            util->encodeTimeStampTz(
-                &status,
-                &raw,
-                static_cast<unsigned>(static_cast<int>(ymd.year())),
-                static_cast<unsigned>(ymd.month()),
-                static_cast<unsigned>(ymd.day()),
-                static_cast<unsigned>(timeOfDay.hours().count()),
-                static_cast<unsigned>(timeOfDay.minutes().count()),
-                static_cast<unsigned>(timeOfDay.seconds().count()),
-                to_firebird_fractions(timeOfDay.subseconds()),
-                timeZoneName.c_str()
-            );
+        const auto [fb_date, fb_time] = timestamp_utils::to_firebird_timestamp(
+            std::chrono::time_point_cast<std::chrono::system_clock::duration>(zt.get_sys_time()));
+        const uint16_t zoneId = TimeZoneTable::instance().zoneId(zt.get_time_zone());
 
-            const auto info = zt.get_time_zone()->get_info(zt.get_sys_time());
-            const auto offset = std::chrono::duration_cast<std::chrono::minutes>(info.offset);
+        const auto info = zt.get_time_zone()->get_info(zt.get_sys_time());
+        const auto offset = std::chrono::duration_cast<std::chrono::minutes>(info.offset);
 
-            return TimestampTz(
-                static_cast<uint32_t>(raw.utc_timestamp.timestamp_date),
-                static_cast<uint32_t>(raw.utc_timestamp.timestamp_time),
-                static_cast<uint16_t>(raw.time_zone),
-                static_cast<int16_t>(offset.count())
-            );
-        } catch (const Firebird::FbException& e) {
-            throw FirebirdException(e);
-        }
+        return TimestampTz(fb_date, fb_time, zoneId, static_cast<int16_t>(offset.count()));
     }
 
     static user_type from_firebird(const firebird_type& fb_tz) {
+        auto& zones = TimeZoneTable::instance();
         try {
-            auto& env = Environment::getInstance();
-            Firebird::ThrowStatusWrapper status(env.getMaster()->getStatus());
-            Firebird::IUtil* util = env.getUtil();
-
-            ISC_TIMESTAMP_TZ raw{};
-            raw.utc_timestamp.timestamp_date = static_cast<ISC_DATE>(fb_tz.getDate());
-            raw.utc_timestamp.timestamp_time = static_cast<ISC_TIME>(fb_tz.getTime());
-            raw.time_zone = static_cast<ISC_USHORT>(fb_tz.getZoneId());
-
-            unsigned year{};
-            unsigned month{};
-            unsigned day{};
-            unsigned hours{};
-            unsigned minutes{};
-            unsigned seconds{};
-            unsigned fractions{};
-            std::array<char, 128> timeZoneName{};
-
-            util->decodeTimeStampTz(
-                &status,
-                &raw,
-                &year,
-                &month,
-                &day,
-                &hours,
-                &minutes,
-                &seconds,
-                &fractions,
-                static_cast<unsigned>(timeZoneName.size()),
-                timeZoneName.data()
-            );
-
-            (void) year;
-            (void) month;
-            (void) day;
-            (void) hours;
-            (void) minutes;
-            (void) seconds;
-            (void) fractions;
-
             auto utcTime = timestamp_utils::from_firebird_timestamp(fb_tz.getDate(), fb_tz.getTime());
+            // The cached zone pointer saves locate_zone() per value; only
+            // zones the tz database cannot resolve go by name (and fail there)
+            if (const auto* zone = zones.timeZone(fb_tz.getZoneId())) {
+                return makeZonedTimestamp(zone, utcTime);
+            }
             return makeZonedTimestamp(
-                std::string_view(timeZoneName.data()),
+                std::string_view(zones.name(fb_tz.getZoneId())),
                 std::chrono::time_point_cast<std::chrono::microseconds>(utcTime)
             );
-        } catch (const Firebird::FbException& e) {
-            throw FirebirdException(e);
         } catch (const std::runtime_error& e) {
             throw FirebirdException(std::string("Failed to construct ZonedTimestamp: ") + e.what());
         }
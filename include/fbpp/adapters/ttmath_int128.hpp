@@ -65,8 +65,32 @@ struct TypeAdapter<fbpp::adapters::Int128> {
 };
 
 // Helper function to create Int128 from string
+// Plain decimal text ([+-]digits) is accumulated in a native __int128 where
+// the compiler has one; other bases and other text keep ttmath's FromString
 inline fbpp::adapters::Int128 make_int128(const std::string& str, int base = 10) {
     fbpp::adapters::Int128 result;
+#if defined(__SIZEOF_INT128__) && !defined(FBPP_NO_NATIVE_INT128)
+    if (base == 10 && !str.empty()) {
+        __extension__ typedef unsigned __int128 Native;
+        const bool negative = str[0] == '-';
+        std::size_t i = (negative || str[0] == '+') ? 1 : 0;
+        const Native limit = (Native{1} << 127) - (negative ? 0 : 1);
+        Native magnitude = 0;
+        bool ok = i < str.size();
+        for (; ok && i < str.size(); ++i) {
+            const unsigned digit = static_cast<unsigned char>(str[i]) - '0';
+            ok = digit < 10 && magnitude <= (limit - digit) / 10;
+            magnitude = magnitude * 10 + digit;
+        }
+        if (ok) {
+            if (negative) {
+                magnitude = ~magnitude + 1;
+            }
+            std::memcpy(result.table, &magnitude, 16);
+            return result;
+        }
+    }
+#endif
     result.FromString(str, base);
     return result;
 }
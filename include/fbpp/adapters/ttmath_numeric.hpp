@@ -2,7 +2,13 @@
 
 #include "fbpp/core/type_adapter.hpp"
 #include "fbpp/adapters/ttmath_int128.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/scaled_numeric.hpp"
 #include <ttmath/ttmath.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <cmath>
 #include <sstream>
@@ -10,18 +16,34 @@
 
 namespace fbpp::core::detail {
 
-// mul/div by 10^n for ttmath::Int
+// Decimal digits per word operation: 10^18 fits a 64-bit ttmath word,
+// 10^9 a 32-bit one.
+inline constexpr unsigned kPow10PerWord = TTMATH_BITS_PER_UINT >= 64 ? 18 : 9;
+
+// mul/div by 10^n for ttmath::Int / UInt, one word operation per
+// kPow10PerWord digits. Chained truncating divisions equal one truncating
+// division by the product. mul_pow10 returns true on overflow.
 template<class BigInt>
-inline void mul_pow10(BigInt& v, unsigned n) { for (unsigned i = 0; i < n; ++i) v.MulInt(10); }
+inline bool mul_pow10(BigInt& v, unsigned n) {
+    bool carry = false;
+    for (; n > kPow10PerWord; n -= kPow10PerWord) {
+        carry |= v.MulInt(static_cast<ttmath::sint>(kPow10Int64[kPow10PerWord])) != 0;
+    }
+    if (n > 0) carry |= v.MulInt(static_cast<ttmath::sint>(kPow10Int64[n])) != 0;
+    return carry;
+}
 
 template<class BigInt>
-inline void div_pow10_trunc(BigInt& v, unsigned n) { for (unsigned i = 0; i < n; ++i) v.DivInt(10); }
+inline void div_pow10_trunc(BigInt& v, unsigned n) {
+    for (; n > kPow10PerWord; n -= kPow10PerWord) {
+        v.DivInt(static_cast<ttmath::sint>(kPow10Int64[kPow10PerWord]));
+    }
+    if (n > 0) v.DivInt(static_cast<ttmath::sint>(kPow10Int64[n]));
+}
 
-// crude sign detection via text (API-нейтрально к ttmath)
 template<class BigInt>
 inline bool is_negative(const BigInt& v) {
-    auto s = v.ToString();
-    return !s.empty() && s[0] == '-';
+    return v.IsSign();
 }
 
 } //namespace fbpp::core::detail
@@ -49,8 +71,26 @@ public:
     static constexpr int scale = Scale;
 
 private:
+    using MagnitudeType = ttmath::UInt<IntWords>;
+
     IntType value_;  // Stored as integer with scale applied
 
+    // |value_| as an unsigned integer (exact for the minimum value too)
+    MagnitudeType magnitude() const {
+        MagnitudeType mag;
+        std::memcpy(mag.table, value_.table, sizeof(mag.table));
+        if (value_.IsSign()) {
+            mag.BitNot();
+            mag.AddOne();
+        }
+        return mag;
+    }
+
+    [[noreturn]] static void throw_overflow(unsigned length) {
+        throw fbpp::core::FirebirdException("TTNumeric value does not fit a " +
+                                            std::to_string(length) + "-byte scaled integer");
+    }
+
 public:
     // Default constructor - zero value
     TTNumeric() : value_(0) {}
@@ -77,106 +117,181 @@ public:
     const IntType& raw_value() const { return value_; }
     IntType& raw_value() { return value_; }
 
-    // Convert to string with decimal point
+    // Convert to string with decimal point; trailing fractional zeros
+    // are dropped ("1.5", "-0.05", "12")
     std::string to_string() const {
-        if (scale >= 0) {
-            // No decimal places
-            return value_.ToString();
+        using fbpp::core::detail::kPow10PerWord;
+        constexpr std::size_t frac = scale < 0 ? static_cast<std::size_t>(-scale) : 0;
+        // Magnitude digits, least significant first
+        char digits[IntWords * TTMATH_BITS_PER_UINT * 30103 / 100000 + 2 + frac];
+        std::size_t count = 0;
+
+        MagnitudeType mag = magnitude();
+        const auto divisor = static_cast<ttmath::uint>(fbpp::core::kPow10Int64[kPow10PerWord]);
+        while (!mag.IsZero()) {
+            ttmath::uint rem = 0;
+            mag.DivInt(divisor, &rem);
+            const bool last = mag.IsZero();
+            for (unsigned k = 0; k < kPow10PerWord && (!last || rem != 0); ++k) {
+                digits[count++] = static_cast<char>('0' + rem % 10);
+                rem /= 10;
+            }
         }
-
-        std::string int_str = value_.ToString();
-        bool is_negative = false;
-
-        // Handle negative numbers
-        if (!int_str.empty() && int_str[0] == '-') {
-            is_negative = true;
-            int_str = int_str.substr(1);
+        while (count <= frac) {
+            digits[count++] = '0';
+        }
+        std::size_t zeros = 0;   // Trailing fractional zeros to drop
+        while (zeros < frac && digits[zeros] == '0') {
+            ++zeros;
         }
 
-        int decimal_places = -scale;
+        std::string result;
+        result.reserve(count + 2);
+        if (value_.IsSign()) {
+            result += '-';
+        }
+        for (std::size_t i = count; i > frac; --i) {
+            result += digits[i - 1];
+        }
+        if (zeros < frac) {
+            result += '.';
+            for (std::size_t i = frac; i > zeros; --i) {
+                result += digits[i - 1];
+            }
+        }
+        return result;
+    }
 
-        // Pad with zeros if necessary
-        while (int_str.length() <= static_cast<size_t>(decimal_places)) {
-            int_str = "0" + int_str;
+    // Parse "[+-]digits[.digits]" (leading spaces skipped, parsing stops at
+    // the first other character); fractional digits past the scale are
+    // truncated
+    void from_string(const std::string& str) {
+        using fbpp::core::detail::kPow10PerWord;
+        const char* p = str.data();
+        const char* const end = p + str.size();
+        while (p < end && std::isspace(static_cast<unsigned char>(*p))) {
+            ++p;
+        }
+        bool negative = false;
+        if (p < end && (*p == '+' || *p == '-')) {
+            negative = *p == '-';
+            ++p;
         }
 
-        // Insert decimal point
-        size_t point_pos = int_str.length() - decimal_places;
-        std::string int_part = int_str.substr(0, point_pos);
-        std::string frac_part = int_str.substr(point_pos);
-
-        // Check if fractional part is all zeros
-        bool all_zeros = true;
-        for (char c : frac_part) {
-            if (c != '0') {
-                all_zeros = false;
-                break;
+        // Digits are gathered into one word, then folded in by mul + add
+        MagnitudeType mag;
+        mag.SetZero();
+        ttmath::uint chunk = 0;
+        unsigned chunk_digits = 0;
+        auto flush = [&] {
+            if (chunk_digits != 0) {
+                mag.MulInt(static_cast<ttmath::uint>(fbpp::core::kPow10Int64[chunk_digits]));
+                mag.AddInt(chunk);
+                chunk = 0;
+                chunk_digits = 0;
             }
-        }
+        };
+        auto push = [&](char ch) {
+            chunk = chunk * 10 + static_cast<ttmath::uint>(ch - '0');
+            if (++chunk_digits == kPow10PerWord) {
+                flush();
+            }
+        };
+        auto is_digit = [](char ch) { return ch >= '0' && ch <= '9'; };
 
-        std::string result;
-        if (all_zeros) {
-            // No decimal point needed
-            result = int_part;
-        } else {
-            // Add decimal point and remove trailing zeros
-            result = int_part + "." + frac_part;
-            while (result.back() == '0' && result[result.length() - 2] != '.') {
-                result.pop_back();
+        for (; p < end && is_digit(*p); ++p) {
+            push(*p);
+        }
+        const unsigned keep = scale < 0 ? static_cast<unsigned>(-scale) : 0;
+        unsigned frac_digits = 0;
+        const bool has_point = p < end && *p == '.';
+        if (has_point) {
+            for (++p; p < end && is_digit(*p) && frac_digits < keep; ++p, ++frac_digits) {
+                push(*p);
             }
         }
-
-        if (is_negative) {
-            result = "-" + result;
+        flush();
+        if (frac_digits < keep) {
+            fbpp::core::detail::mul_pow10(mag, keep - frac_digits);
+        } else if (scale > 0 && has_point) {
+            fbpp::core::detail::div_pow10_trunc(mag, static_cast<unsigned>(scale));
         }
 
-        return result;
+        std::memcpy(value_.table, mag.table, sizeof(value_.table));
+        if (negative) {
+            value_.ChangeSign();
+        }
     }
 
-    // Parse from string
-    void from_string(const std::string& str) {
-        size_t dot_pos = str.find('.');
-
-        if (dot_pos == std::string::npos) {
-            // No decimal point - integer value
-            value_.FromString(str);
-
-            // Apply scale
-            if (scale < 0) {
-                for (int i = 0; i < -scale; ++i) {
-                    value_ *= 10;
-                }
+    /**
+     * @brief Value of a scaled wire integer
+     *
+     * `in_le` holds the little-endian two's complement integer of a
+     * NUMERIC / DECIMAL column (length 2/4/8/16 bytes: SMALLINT, INTEGER,
+     * INT64, INT128 storage) with Firebird scale `wire_scale`. The words
+     * are copied with sign extension and the scale aligned to Scale by
+     * multiplying or truncating division by powers of ten; no text is
+     * involved. Throws FirebirdException if the value does not fit.
+     */
+    static TTNumeric from_wire(const uint8_t* in_le, unsigned length, int wire_scale) {
+        TTNumeric result;
+        auto& raw = result.value_;
+        const bool neg = length > 0 && (in_le[length - 1] & 0x80) != 0;
+        std::memset(raw.table, neg ? 0xFF : 0x00, sizeof(raw.table));
+        const std::size_t avail = std::min<std::size_t>(length, sizeof(raw.table));
+        std::memcpy(raw.table, in_le, avail);
+        if (length > avail) {
+            // Wider than IntType: the dropped bytes must be sign extension
+            const uint8_t fill = neg ? 0xFF : 0x00;
+            const bool fits = std::all_of(in_le + avail, in_le + length,
+                                          [fill](uint8_t b) { return b == fill; }) &&
+                              raw.IsSign() == neg;
+            if (!fits) {
+                throw_overflow(length);
             }
-        } else {
-            // Has decimal point
-            std::string int_part = str.substr(0, dot_pos);
-            std::string frac_part = str.substr(dot_pos + 1);
+        }
+        if (wire_scale > scale) {
+            if (fbpp::core::detail::mul_pow10(raw, static_cast<unsigned>(wire_scale - scale))) {
+                throw_overflow(length);
+            }
+        } else if (wire_scale < scale) {
+            fbpp::core::detail::div_pow10_trunc(raw, static_cast<unsigned>(scale - wire_scale));
+        }
+        return result;
+    }
 
-            // Remove trailing zeros from fractional part
-            while (!frac_part.empty() && frac_part.back() == '0') {
-                frac_part.pop_back();
+    /**
+     * @brief Store as a scaled wire integer (inverse of from_wire())
+     *
+     * Truncates when wire_scale has fewer decimal places than Scale;
+     * throws FirebirdException if the aligned value needs more than
+     * `length` bytes.
+     */
+    void to_wire(uint8_t* out_le, unsigned length, int wire_scale) const {
+        IntType big = value_;
+        if (scale > wire_scale) {
+            if (fbpp::core::detail::mul_pow10(big, static_cast<unsigned>(scale - wire_scale))) {
+                throw_overflow(length);
             }
+        } else if (scale < wire_scale) {
+            fbpp::core::detail::div_pow10_trunc(big, static_cast<unsigned>(wire_scale - scale));
+        }
 
-            // Combine parts
-            std::string combined = int_part + frac_part;
-            value_.FromString(combined);
-
-            // Adjust for scale difference
-            int current_scale = -static_cast<int>(frac_part.length());
-            int scale_diff = scale - current_scale;
-
-            if (scale_diff < 0) {
-                // Need more decimal places
-                for (int i = 0; i < -scale_diff; ++i) {
-                    value_ *= 10;
-                }
-            } else if (scale_diff > 0) {
-                // Need fewer decimal places (truncate)
-                for (int i = 0; i < scale_diff; ++i) {
-                    value_ /= 10;
-                }
+        const bool neg = big.IsSign();
+        const auto* bytes = reinterpret_cast<const uint8_t*>(big.table);
+        const std::size_t avail = std::min<std::size_t>(length, sizeof(big.table));
+        if (avail < sizeof(big.table)) {
+            const uint8_t fill = neg ? 0xFF : 0x00;
+            const bool fits = avail > 0 &&
+                              std::all_of(bytes + avail, bytes + sizeof(big.table),
+                                          [fill](uint8_t b) { return b == fill; }) &&
+                              ((bytes[avail - 1] & 0x80) != 0) == neg;
+            if (!fits) {
+                throw_overflow(length);
             }
         }
+        std::memset(out_le, neg ? 0xFF : 0x00, length);
+        std::memcpy(out_le, bytes, avail);
     }
 
     // Convert from double (may lose precision)
@@ -184,7 +299,7 @@ public:
         if (scale >= 0) {
             value_ = static_cast<int64_t>(d);
         } else {
-            double scaled = d * std::pow(10.0, -scale);
+            double scaled = d * fbpp::core::pow10Double(-scale);
             value_ = static_cast<int64_t>(std::round(scaled));
         }
     }
@@ -195,7 +310,7 @@ public:
             return static_cast<double>(value_.ToInt());
         } else {
             double raw = static_cast<double>(value_.ToInt());
-            return raw / std::pow(10.0, -scale);
+            return raw / fbpp::core::pow10Double(-scale);
         }
     }
 
@@ -214,9 +329,7 @@ public:
 
         // Divide by 10^(-scale) to maintain correct scale
         if (scale < 0) {
-            for (int i = 0; i < -scale; ++i) {
-                result /= 10;
-            }
+            fbpp::core::detail::div_pow10_trunc(result, static_cast<unsigned>(-scale));
         }
 
         return TTNumeric(result);
@@ -228,9 +341,7 @@ public:
 
         // Multiply by 10^(-scale) before division to maintain precision
         if (scale < 0) {
-            for (int i = 0; i < -scale; ++i) {
-                result *= 10;
-            }
+            fbpp::core::detail::mul_pow10(result, static_cast<unsigned>(-scale));
         }
 
         result /= other.value_;
@@ -253,9 +364,7 @@ public:
 
         // Adjust scale for multiplication
         if (scale < 0) {
-            for (int i = 0; i < -scale; ++i) {
-                value_ /= 10;
-            }
+            fbpp::core::detail::div_pow10_trunc(value_, static_cast<unsigned>(-scale));
         }
         return *this;
     }
@@ -263,9 +372,7 @@ public:
     TTNumeric& operator/=(const TTNumeric& other) {
         // Adjust scale for division
         if (scale < 0) {
-            for (int i = 0; i < -scale; ++i) {
-                value_ *= 10;
-            }
+            fbpp::core::detail::mul_pow10(value_, static_cast<unsigned>(-scale));
         }
 
         value_ /= other.value_;
@@ -287,9 +394,7 @@ public:
     TTNumeric& operator++() {
         IntType one(1);
         if (scale < 0) {
-            for (int i = 0; i < -scale; ++i) {
-                one *= 10;
-            }
+            fbpp::core::detail::mul_pow10(one, static_cast<unsigned>(-scale));
         }
         value_ += one;
         return *this;
@@ -298,9 +403,7 @@ public:
     TTNumeric& operator--() {
         IntType one(1);
         if (scale < 0) {
-            for (int i = 0; i < -scale; ++i) {
-                one *= 10;
-            }
+            fbpp::core::detail::mul_pow10(one, static_cast<unsigned>(-scale));
         }
         value_ -= one;
         return *this;
@@ -404,28 +507,7 @@ struct TypeAdapter<fbpp::adapters::TTNumeric<IntWords, Scale>> {
                             uint8_t* out_le)
     {
         if (!out_le) return;
-        using fbpp::core::detail::mul_pow10;
-        using fbpp::core::detail::div_pow10_trunc;
-        using fbpp::core::detail::is_negative;
-
-        // 1) Приводим масштаб значения к масштабу столбца БД
-        auto big = value.raw_value(); // копия, чтобы не менять source
-        const int type_scale_abs = (user_type::scale < 0) ? -user_type::scale : user_type::scale;
-        const int db_scale_abs   = (fb_scale         < 0) ? -fb_scale         : fb_scale;
-
-        if (db_scale_abs > type_scale_abs) {
-            mul_pow10(big, static_cast<unsigned>(db_scale_abs - type_scale_abs));
-        } else if (db_scale_abs < type_scale_abs) {
-            div_pow10_trunc(big, static_cast<unsigned>(type_scale_abs - db_scale_abs));
-        }
-
-        // 2) Записываем two's complement в fb_length байт (LE) с корректным знаковым заполнением
-        const bool neg = is_negative(big);
-        std::memset(out_le, neg ? 0xFF : 0x00, fb_length);
-        const size_t avail = std::min<size_t>(fb_length, sizeof(big.table));
-        std::memcpy(out_le, big.table, avail);
-
-        // TODO (по желанию): проверить переполнение по precision колонки
+        value.to_wire(out_le, fb_length, fb_scale);
     }
 
     // Читаем little-endian two's complement из Firebird и приводим к масштабe типа
@@ -433,29 +515,7 @@ struct TypeAdapter<fbpp::adapters::TTNumeric<IntWords, Scale>> {
                                    unsigned fb_length,
                                    int16_t fb_scale)
     {
-        using fbpp::core::detail::mul_pow10;
-        using fbpp::core::detail::div_pow10_trunc;
-
-        IntType raw{};
-        // sign-extend вход в буфер ttmath::Int
-        const bool neg = (fb_length > 0) && (in_le[fb_length - 1] & 0x80);
-        std::memset(raw.table, neg ? 0xFF : 0x00, sizeof(raw.table));
-        const size_t avail = std::min<size_t>(fb_length, sizeof(raw.table));
-        std::memcpy(raw.table, in_le, avail);
-
-        user_type val(raw);
-
-        // Привести масштаб БД к масштабу типа
-        const int type_scale_abs = (user_type::scale < 0) ? -user_type::scale : user_type::scale;
-        const int db_scale_abs   = (fb_scale         < 0) ? -fb_scale         : fb_scale;
-
-        if (type_scale_abs > db_scale_abs) {
-            mul_pow10(val.raw_value(), static_cast<unsigned>(type_scale_abs - db_scale_abs));
-        } else if (type_scale_abs < db_scale_abs) {
-            div_pow10_trunc(val.raw_value(), static_cast<unsigned>(db_scale_abs - type_scale_abs));
-        }
-
-        return val;
+        return user_type::from_wire(in_le, fb_length, fb_scale);
     }
 };
 
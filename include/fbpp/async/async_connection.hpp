@@ -0,0 +1,318 @@
+#pragma once
+
+// fbpp_async — coroutine front end over the blocking core API.
+//
+// An AsyncConnection owns one core::Connection and a Strand on an IoPool
+// (the core Executor; Executor::shared() unless one is given). Every
+// awaitable runs its Firebird calls on the strand (so the connection keeps
+// its one-thread-at-a-time contract) and resumes the awaiting coroutine on
+// the pool thread that finished them; thousands of suspended requests cost
+// no threads.
+//
+//   auto pool = std::make_shared<fbpp::async::IoPool>(8);
+//   fbpp::async::AsyncConnection db(pool, params);
+//
+//   Task<> handler(AsyncConnection& db) {
+//       auto tx = co_await db.startTransaction();
+//       auto stmt = co_await db.prepare("INSERT INTO t VALUES (?, ?)");
+//       co_await db.execute(tx, stmt, std::make_tuple(1, "a"));
+//       auto rows = co_await db.rows<std::tuple<int, std::string>>(tx, select);
+//       while (auto row = co_await rows.next()) { ... }
+//       co_await db.commit(tx);
+//   }
+//
+// The awaitables work from any coroutine type (see task.hpp for a minimal
+// one). An AsyncConnection must outlive the operations and row streams
+// awaited on it, and the core objects it hands out (transactions,
+// statements) are only touched through it. Its destructor detaches on the
+// strand and waits, so destroy it outside its own coroutines' strand hops.
+
+#include "fbpp/async/io_pool.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/transaction_impl.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/transaction_options.hpp"
+
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace fbpp::async {
+
+/**
+ * @brief Awaitable that runs `work` on a strand and resumes with its result
+ */
+template<typename T, typename Work>
+class Operation {
+public:
+    Operation(Strand& strand, Work work) : strand_(&strand), work_(std::move(work)) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> awaiting) {
+        // The coroutine (and this awaiter in its frame) may be resumed and
+        // destroyed as soon as the task ran: touch nothing after post().
+        strand_->post([this, awaiting] {
+            try {
+                if constexpr (std::is_void_v<T>) {
+                    work_();
+                } else {
+                    result_.emplace(work_());
+                }
+            } catch (...) {
+                error_ = std::current_exception();
+            }
+            awaiting.resume();
+        });
+    }
+
+    T await_resume() {
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+        if constexpr (!std::is_void_v<T>) {
+            return std::move(*result_);
+        }
+    }
+
+private:
+    using Stored = std::conditional_t<std::is_void_v<T>, bool, T>;
+
+    Strand* strand_;
+    Work work_;
+    std::optional<Stored> result_;
+    std::exception_ptr error_;
+};
+
+/**
+ * @brief Buffered async stream over the rows of a cursor
+ *
+ * next() hands out buffered rows without suspending and refills the
+ * buffer with up to chunkRows() fetches per strand hop. Move-only; the
+ * cursor is closed on the strand when the stream goes away.
+ */
+template<typename Row>
+class RowStream {
+public:
+    RowStream(Strand& strand, std::unique_ptr<core::ResultSet> cursor, size_t chunkRows)
+        : strand_(&strand),
+          cursor_(std::shared_ptr<core::ResultSet>(std::move(cursor))),
+          chunkRows_(chunkRows == 0 ? 1 : chunkRows) {}
+
+    RowStream(RowStream&&) noexcept = default;
+    RowStream& operator=(RowStream&& other) noexcept {
+        if (this != &other) {
+            closeCursor();
+            strand_ = other.strand_;
+            cursor_ = std::move(other.cursor_);
+            buffer_ = std::move(other.buffer_);
+            chunkRows_ = other.chunkRows_;
+            exhausted_ = other.exhausted_;
+        }
+        return *this;
+    }
+    RowStream(const RowStream&) = delete;
+    RowStream& operator=(const RowStream&) = delete;
+
+    ~RowStream() { closeCursor(); }
+
+    class NextAwaiter {
+    public:
+        explicit NextAwaiter(RowStream& stream) : stream_(&stream) {}
+
+        bool await_ready() const noexcept {
+            return !stream_->buffer_.empty() || stream_->exhausted_;
+        }
+
+        void await_suspend(std::coroutine_handle<> awaiting) {
+            RowStream* stream = stream_;
+            stream->strand_->post([this, stream, awaiting] {
+                try {
+                    stream->fill();
+                } catch (...) {
+                    error_ = std::current_exception();
+                }
+                awaiting.resume();
+            });
+        }
+
+        std::optional<Row> await_resume() {
+            if (error_) {
+                std::rethrow_exception(error_);
+            }
+            auto& buffer = stream_->buffer_;
+            if (buffer.empty()) {
+                return std::nullopt;
+            }
+            std::optional<Row> row(std::move(buffer.front()));
+            buffer.pop_front();
+            return row;
+        }
+
+    private:
+        RowStream* stream_;
+        std::exception_ptr error_;
+    };
+
+    /// Next row, or std::nullopt after the last one
+    NextAwaiter next() { return NextAwaiter(*this); }
+
+    size_t chunkRows() const noexcept { return chunkRows_; }
+
+private:
+    // Strand side: fetch up to chunkRows_ rows into the buffer.
+    void fill() {
+        for (size_t i = 0; i < chunkRows_; ++i) {
+            Row row{};
+            if (!cursor_->fetch(row)) {
+                exhausted_ = true;
+                cursor_->close();
+                return;
+            }
+            buffer_.push_back(std::move(row));
+        }
+    }
+
+    void closeCursor() noexcept {
+        if (!cursor_) {
+            return;
+        }
+        try {
+            strand_->post([cursor = std::move(cursor_)]() mutable { cursor.reset(); });
+        } catch (...) {
+        }
+    }
+
+    Strand* strand_;
+    std::shared_ptr<core::ResultSet> cursor_;   // shared: std::function needs copyable
+    std::deque<Row> buffer_;
+    size_t chunkRows_;
+    bool exhausted_ = false;
+};
+
+/**
+ * @brief Tuning of an AsyncConnection
+ */
+struct AsyncConnectionOptions {
+    // Rows fetched per strand hop by RowStream::next()
+    size_t rowChunk = 256;
+};
+
+/**
+ * @brief Coroutine-facing owner of one Connection
+ *
+ * The attachment is opened by the first awaited operation (or connect()),
+ * on the strand.
+ */
+class AsyncConnection {
+public:
+    AsyncConnection(std::shared_ptr<IoPool> pool, core::ConnectionParams params,
+                    AsyncConnectionOptions options = {})
+        : strand_(std::move(pool)), params_(std::move(params)), options_(options) {}
+
+    /// On the process-wide core::Executor::shared()
+    explicit AsyncConnection(core::ConnectionParams params, AsyncConnectionOptions options = {})
+        : AsyncConnection(core::Executor::shared(), std::move(params), options) {}
+
+    ~AsyncConnection() {
+        try {
+            strand_.post([this] { connection_.reset(); });
+        } catch (...) {
+            connection_.reset();
+        }
+        strand_.waitIdle();
+    }
+
+    AsyncConnection(const AsyncConnection&) = delete;
+    AsyncConnection& operator=(const AsyncConnection&) = delete;
+
+    /**
+     * @brief Run `fn(core::Connection&)` on the strand
+     *
+     * The general escape hatch: anything the blocking API does, awaited.
+     */
+    template<typename Fn>
+    auto run(Fn fn) {
+        using Result = std::invoke_result_t<Fn&, core::Connection&>;
+        auto work = [this, fn = std::move(fn)]() mutable -> Result {
+            return fn(connection());
+        };
+        return Operation<Result, decltype(work)>(strand_, std::move(work));
+    }
+
+    auto connect() {
+        return run([](core::Connection&) {});
+    }
+
+    auto startTransaction(core::TransactionOptions options = {}) {
+        return run([options](core::Connection& conn) { return conn.StartTransaction(options); });
+    }
+
+    auto prepare(std::string sql) {
+        return run([sql = std::move(sql)](core::Connection& conn) {
+            return conn.prepareStatement(sql);
+        });
+    }
+
+    template<typename Params>
+    auto execute(std::shared_ptr<core::Transaction> tx, std::shared_ptr<core::Statement> stmt,
+                 Params params) {
+        return run([tx = std::move(tx), stmt = std::move(stmt),
+                    params = std::move(params)](core::Connection&) {
+            return tx->execute(stmt, params);
+        });
+    }
+
+    auto commit(std::shared_ptr<core::Transaction> tx) {
+        return run([tx = std::move(tx)](core::Connection&) { tx->Commit(); });
+    }
+
+    auto rollback(std::shared_ptr<core::Transaction> tx) {
+        return run([tx = std::move(tx)](core::Connection&) { tx->Rollback(); });
+    }
+
+    /**
+     * @brief Open a cursor and stream its rows as `Row` (tuple or described struct)
+     */
+    template<typename Row, typename Params = std::tuple<>>
+    auto rows(std::shared_ptr<core::Transaction> tx, std::shared_ptr<core::Statement> stmt,
+              Params params = {}) {
+        return run([this, tx = std::move(tx), stmt = std::move(stmt),
+                    params = std::move(params)](core::Connection&) {
+            if constexpr (std::is_same_v<Params, std::tuple<>>) {
+                return RowStream<Row>(strand_, tx->openCursor(stmt), options_.rowChunk);
+            } else {
+                return RowStream<Row>(strand_, tx->openCursor(stmt, params), options_.rowChunk);
+            }
+        });
+    }
+
+    Strand& strand() noexcept { return strand_; }
+    const core::ConnectionParams& params() const noexcept { return params_; }
+
+private:
+    // Strand side only.
+    core::Connection& connection() {
+        if (!connection_) {
+            connection_ = std::make_unique<core::Connection>(params_);
+        }
+        return *connection_;
+    }
+
+    Strand strand_;
+    core::ConnectionParams params_;
+    AsyncConnectionOptions options_;
+    std::unique_ptr<core::Connection> connection_;
+};
+
+} // namespace fbpp::async
@@ -0,0 +1,19 @@
+#pragma once
+
+// The async front end runs its blocking Firebird calls on the core
+// Executor: IoPool is that pool and Strand its serial queue, so coroutine
+// I/O shares workers with the rest of the library (Executor::shared()) or
+// gets a pool of its own (std::make_shared<IoPool>(n)).
+//
+// Coroutines never block on the wire themselves: each call is posted to a
+// strand and the awaiting coroutine is resumed when it is done, so the
+// number of in-flight requests is independent of the number of threads.
+
+#include "fbpp/core/executor.hpp"
+
+namespace fbpp::async {
+
+using IoPool = core::Executor;
+using Strand = core::Strand;
+
+} // namespace fbpp::async
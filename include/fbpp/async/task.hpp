@@ -0,0 +1,198 @@
+#pragma once
+
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace fbpp::async {
+
+template<typename T = void>
+class Task;
+
+namespace detail {
+
+struct TaskPromiseBase {
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+    std::exception_ptr error;
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> self) noexcept {
+            return self.promise().continuation;
+        }
+        void await_resume() noexcept {}
+    };
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    void unhandled_exception() noexcept { error = std::current_exception(); }
+};
+
+template<typename T>
+struct TaskPromise : TaskPromiseBase {
+    std::optional<T> value;
+
+    Task<T> get_return_object() noexcept;
+
+    template<typename U>
+    void return_value(U&& result) { value.emplace(std::forward<U>(result)); }
+
+    T take() {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return std::move(*value);
+    }
+};
+
+template<>
+struct TaskPromise<void> : TaskPromiseBase {
+    Task<void> get_return_object() noexcept;
+
+    void return_void() noexcept {}
+
+    void take() {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief Minimal lazy coroutine task
+ *
+ * Starts when awaited (or passed to syncWait()) and resumes its awaiter
+ * on completion. fbpp awaitables work from any coroutine type; Task is
+ * for callers without a runtime of their own, and for tests.
+ */
+template<typename T>
+class Task {
+public:
+    using promise_type = detail::TaskPromise<T>;
+
+    explicit Task(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    bool await_ready() const noexcept { return !handle_ || handle_.done(); }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle_.promise().continuation = awaiting;
+        return handle_;
+    }
+
+    T await_resume() { return handle_.promise().take(); }
+
+private:
+    std::coroutine_handle<promise_type> handle_;
+};
+
+namespace detail {
+
+template<typename T>
+Task<T> TaskPromise<T>::get_return_object() noexcept {
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+// Started by syncWait(); signals the waiting thread when the task finishes
+struct SyncWaiter {
+    struct promise_type {
+        std::mutex* mutex = nullptr;
+        std::condition_variable* done = nullptr;
+        bool* finished = nullptr;
+
+        SyncWaiter get_return_object() noexcept {
+            return SyncWaiter{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        auto final_suspend() noexcept {
+            struct Notify {
+                bool await_ready() noexcept { return false; }
+                void await_suspend(std::coroutine_handle<promise_type> self) noexcept {
+                    auto& p = self.promise();
+                    std::lock_guard<std::mutex> lock(*p.mutex);
+                    *p.finished = true;
+                    p.done->notify_all();
+                }
+                void await_resume() noexcept {}
+            };
+            return Notify{};
+        }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept {}
+    };
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+// Waits for `task` without taking its result (syncWait() takes it)
+template<typename T>
+struct Completion {
+    Task<T>& task;
+    bool await_ready() const noexcept { return task.await_ready(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        return task.await_suspend(awaiting);
+    }
+    void await_resume() const noexcept {}
+};
+
+template<typename T>
+SyncWaiter awaitInto(Task<T>& task) {
+    co_await Completion<T>{task};
+}
+
+} // namespace detail
+
+/**
+ * @brief Block the calling thread until `task` completes; returns its result
+ *
+ * For program edges (main, tests). Never call from an IoPool thread.
+ */
+template<typename T>
+T syncWait(Task<T> task) {
+    std::mutex mutex;
+    std::condition_variable done;
+    bool finished = false;
+
+    auto waiter = detail::awaitInto(task);
+    waiter.handle.promise().mutex = &mutex;
+    waiter.handle.promise().done = &done;
+    waiter.handle.promise().finished = &finished;
+    waiter.handle.resume();
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&] { return finished; });
+    }
+    waiter.handle.destroy();
+    return task.await_resume();
+}
+
+} // namespace fbpp::async
@@ -1,7 +1,15 @@
 #pragma once
 
 #include "fbpp/core/firebird_compat.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <iterator>
 #include <memory>
+#include <ranges>
+#include <span>
+#include <string>
 #include <vector>
 #include <tuple>
 #include <nlohmann/json_fwd.hpp>
@@ -12,6 +20,59 @@ namespace fbpp::core {
 class Transaction;
 class Statement;
 class MessageMetadata;
+class Blob;
+class JsonTextPacker;
+class ParamBinder;
+class StatementMetrics;
+struct JsonText;
+struct ColumnBatch;
+
+namespace detail {
+
+class MemoryAccount;
+
+/// Sentinel ending a std::counted_iterator at its count or at the end of
+/// the underlying range, whichever comes first, so Batch::addMany() can
+/// take one bounded chunk of a longer range.
+template<typename Sentinel>
+struct ChunkEnd {
+    Sentinel last{};
+
+    template<typename It>
+    friend bool operator==(const std::counted_iterator<It>& it, const ChunkEnd& end) {
+        return it.count() == 0 || it.base() == end.last;
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief How a batch accepts BLOB contents (IBatch::TAG_BLOB_POLICY)
+ */
+enum class BatchBlobPolicy : unsigned {
+    None = 0,       // BLOB columns only take ids of blobs created elsewhere
+    IdEngine = 1,   // Batch::addBlob(); ids assigned by the engine
+    IdUser = 2,     // Batch::addBlob(); ids assigned by the batch
+    Stream = 3      // Batch::addBlobStream(); caller-built inline stream
+};
+
+/**
+ * @brief Options of Statement::createBatch()
+ */
+struct BatchOptions {
+    // TAG_RECORD_COUNTS. Off, Batch::execute() leaves perMessageStatus
+    // empty and walks the completion state only for failures.
+    bool recordCounts = true;
+    bool continueOnError = false;   // TAG_MULTIERROR
+    BatchBlobPolicy blobPolicy = BatchBlobPolicy::None;
+    // TAG_DETAILED_ERRORS: failed messages the server keeps a status
+    // vector for (0 = server default, 64). Later failures only report
+    // EXECUTE_FAILED.
+    unsigned detailedErrors = 0;
+    // TAG_BUFFER_BYTES_SIZE: server-side buffer for the batch's messages
+    // and BLOBs (0 = server default)
+    size_t bufferBytes = 0;
+};
 
 /**
  * @brief Batch execution result
@@ -20,8 +81,93 @@ struct BatchResult {
     unsigned totalMessages = 0;
     unsigned successCount = 0;
     unsigned failedCount = 0;
+    // Empty for batches without record counts
     std::vector<int> perMessageStatus; // Status for each message (-1 = failed, >=0 = records affected)
     std::vector<std::string> errors;   // Error messages for failed records
+    std::vector<unsigned> errorIndices; // Message index of each errors[] entry
+
+    /**
+     * @brief Append the result of a later execute of the same load
+     *
+     * Message indexes of `next` (perMessageStatus positions, errorIndices
+     * and the "Message N" prefix of its errors) continue after this
+     * result's messages, as if both had run as one batch.
+     */
+    void merge(const BatchResult& next);
+};
+
+/**
+ * @brief Lazy view over a batch's IBatchCompletionState
+ *
+ * Returned by Batch::executeDeferred(). Nothing is copied or formatted up
+ * front: counts are one pass over the per-message states, taken on first
+ * use, and error texts are formatted only for the messages asked about.
+ * Owns the completion state; move-only.
+ */
+class BatchCompletion {
+public:
+    static constexpr unsigned npos = 0xFFFFFFFFu;
+    static constexpr size_t kAllErrors = static_cast<size_t>(-1);
+
+    explicit BatchCompletion(Firebird::IBatchCompletionState* state);
+    ~BatchCompletion();
+
+    BatchCompletion(BatchCompletion&& other) noexcept;
+    BatchCompletion& operator=(BatchCompletion&& other) noexcept;
+    BatchCompletion(const BatchCompletion&) = delete;
+    BatchCompletion& operator=(const BatchCompletion&) = delete;
+
+    /// Number of messages in the batch
+    unsigned size() const;
+
+    /// Records affected (>= 0), EXECUTE_FAILED (-1) or SUCCESS_NO_INFO (-2)
+    int state(unsigned index) const;
+
+    bool failed(unsigned index) const { return state(index) == -1; }
+
+    unsigned failedCount() const;
+    unsigned successCount() const { return size() - failedCount(); }
+
+    /**
+     * @brief Index of the first failed message at or after `from`, or npos
+     */
+    unsigned nextError(unsigned from = 0) const;
+
+    /**
+     * @brief Formatted server error of a failed message
+     *
+     * Empty if the message did not fail or the server kept no details
+     * for it (see BatchOptions::detailedErrors).
+     */
+    std::string errorMessage(unsigned index) const;
+
+    /**
+     * @brief Materialise a BatchResult, formatting at most `maxErrors` errors
+     *
+     * failedCount and perMessageStatus still cover every message.
+     */
+    BatchResult toResult(size_t maxErrors = kAllErrors) const;
+
+    /**
+     * @brief toResult() without perMessageStatus, visiting failures only
+     *
+     * For batches without record counts. `stoppedAtError`: the batch ran
+     * without TAG_MULTIERROR, so only its last message can have failed.
+     */
+    BatchResult toSummary(size_t maxErrors = kAllErrors, bool stoppedAtError = false) const;
+
+private:
+    Firebird::ThrowStatusWrapper& status() const;
+    // Count failed message `index` into `result`, formatting it within maxErrors
+    void addFailure(BatchResult& result, unsigned index, size_t maxErrors) const;
+    void reset() noexcept;
+
+    Firebird::IBatchCompletionState* state_ = nullptr;
+    Firebird::IStatus* status_ = nullptr;
+    mutable Firebird::ThrowStatusWrapper statusWrapper_{nullptr};
+    mutable Firebird::IStatus* errorStatus_ = nullptr;   // Lazily, for errorMessage()
+    mutable unsigned size_ = npos;                        // Cached getSize()
+    mutable unsigned failed_ = npos;                      // Cached failure count
 };
 
 /**
@@ -35,8 +181,12 @@ public:
      * @brief Construct batch from Firebird IBatch
      * @param batch Firebird batch interface
      * @param metadata Message metadata for input parameters
+     * @param jsonTextPacker Packer for JsonText rows (the statement's named
+     *        keys); nullptr uses the positional packer of `metadata`
      */
-    Batch(Firebird::IBatch* batch, std::shared_ptr<MessageMetadata> metadata);
+    Batch(Firebird::IBatch* batch, std::shared_ptr<const MessageMetadata> metadata,
+          BatchBlobPolicy blobPolicy = BatchBlobPolicy::None,
+          const JsonTextPacker* jsonTextPacker = nullptr);
     
     /**
      * @brief Destructor - ensures proper cleanup
@@ -66,6 +216,43 @@ public:
      */
     template<typename... Args>
     void addMany(const std::vector<std::tuple<Args...>>& paramsList);
+
+    /**
+     * @brief Add single described struct to batch
+     *
+     * T must have a StructDescriptor (see struct_descriptor.hpp); fields
+     * are packed straight from the struct in descriptor order.
+     */
+    template<typename T>
+    void add(const T& row);
+
+    /**
+     * @brief Add a contiguous run of described structs to batch
+     */
+    template<typename T>
+    void addMany(std::span<const T> rows);
+
+    /**
+     * @brief Add every row of an iterator range to batch
+     *
+     * Rows (tuples, JSON or described structs) are packed into a reusable
+     * stream buffer owned by the batch and handed to IBatch::add() one
+     * chunk of getStreamChunkBytes() at a time, so neither the input nor
+     * the packed stream has to be materialised in full. If a row fails to
+     * pack, the chunks already handed over stay in the batch
+     * (see getMessageCount()).
+     *
+     * @return The iterator reached (equal to `last`), so a bounded
+     *         std::counted_iterator source can be resumed.
+     */
+    template<std::input_iterator It, std::sentinel_for<It> Sentinel>
+    It addMany(It first, Sentinel last);
+
+    /**
+     * @brief Add every row of an input range to batch (see addMany(first, last))
+     */
+    template<std::ranges::input_range Range>
+    void addMany(Range&& rows);
     
     /**
      * @brief Add single JSON object to batch
@@ -78,13 +265,123 @@ public:
      * @param paramsList Vector of JSON objects or arrays
      */
     void addMany(const std::vector<nlohmann::json>& paramsList);
+
+    /**
+     * @brief Add one raw JSON document (object or array) to batch
+     *
+     * Scanned straight into the message, keys as for execute(); ranges of
+     * JsonText (e.g. splitJsonLines() of NDJSON) go through addMany().
+     */
+    void add(const JsonText& row);
+
+    /**
+     * @brief Add the message a ParamBinder has packed by name
+     *
+     * The binder's buffer() is handed over as is, so rows built with
+     * set() / bind() batch at the cost of a tuple add(); clear() the
+     * binder before the next row. Its statement must have this batch's
+     * input layout: checked field by field for each new binder metadata,
+     * then only by pointer (binders over one statement share it).
+     * @throws FirebirdException if the layouts differ
+     */
+    void add(const ParamBinder& binder);
+
+    /**
+     * @brief Add messages packed elsewhere against this batch's metadata
+     *
+     * `messages` holds `count` messages back to back, getMessageBytes()
+     * apart. Lets packing run away from the thread that talks to the
+     * server (see BulkLoaderOptions::pipelined).
+     */
+    void addPacked(const uint8_t* messages, size_t count);
+
+    /**
+     * @brief Add every row of a columnar block (the inverse of fetchColumns)
+     *
+     * Column i feeds parameter i. Each column is packed into the stream
+     * buffer of addMany() with one kernel per column (copies for
+     * fixed-width values, batch conversions for dates, times and rescaled
+     * NUMERIC), a chunk of getStreamChunkBytes() at a time. String /
+     * Binary values of BLOB parameters are sent as batch BLOBs and need
+     * BatchBlobPolicy::IdEngine or IdUser. The layout is checked before
+     * the first message is added (see detail::checkColumnEncoding()).
+     * @throws FirebirdException if a column does not fit its parameter
+     */
+    void addColumns(const ColumnBatch& columns);
     
+    /**
+     * @brief Add a BLOB to the batch from memory
+     *
+     * Needs BatchBlobPolicy::IdEngine or IdUser. The contents travel with
+     * the batch messages (no Transaction::createBlob round trip); the
+     * returned id is only valid inside this batch — put it into the BLOB
+     * column of a row added afterwards. Handed to IBatch in segments of
+     * at most kBlobSegmentBytes.
+     */
+    Blob addBlob(const void* data, size_t length);
+
+    /**
+     * @brief Add a BLOB read from a stream until EOF, one segment at a time
+     */
+    Blob addBlob(std::istream& in);
+
+    /**
+     * @brief Add a BLOB produced by a callback, one segment at a time
+     *
+     * `source(buffer, capacity)` writes up to `capacity` bytes and returns
+     * how many; 0 ends the BLOB.
+     */
+    Blob addBlob(const std::function<size_t(uint8_t* buffer, size_t capacity)>& source);
+
+    /**
+     * @brief Make an existing BLOB (e.g. from Transaction::createBlob)
+     *        usable in this batch
+     *
+     * Needs a BLOB policy other than None; returns the batch-local id.
+     */
+    Blob registerBlob(const Blob& existing);
+
+    /**
+     * @brief Append raw data to the inline BLOB stream (BatchBlobPolicy::Stream)
+     *
+     * `data` continues the stream of BLOB records described for
+     * IBatch::addBlobStream(): each record is an ISC_QUAD id, a 32-bit
+     * total length, a 32-bit BPB length, the BPB and the data, aligned to
+     * getBlobAlignment(). Records may be split across calls.
+     */
+    void addBlobStream(const void* data, size_t length);
+
+    /**
+     * @brief Alignment of BLOB records in the inline stream
+     */
+    unsigned getBlobAlignment() const;
+
+    BatchBlobPolicy getBlobPolicy() const;
+
+    /// Largest piece addBlob() hands to IBatch at once (segment length is 16-bit)
+    static constexpr size_t kBlobSegmentBytes = 32 * 1024;
+
     /**
      * @brief Execute batch and get results
      * @param transaction Transaction to use
-     * @return BatchResult with execution statistics and errors
+     * @return BatchResult with execution statistics and errors; per-message
+     *         states only if the batch was created with record counts
      */
     BatchResult execute(Transaction* transaction);
+
+    /**
+     * @brief Execute batch and get results, formatting at most `maxErrors`
+     *        error messages (counts still cover every message)
+     */
+    BatchResult execute(Transaction* transaction, size_t maxErrors);
+
+    /**
+     * @brief Execute batch and return a lazy view of the completion state
+     *
+     * For large loads that only look at counts or a few errors; see
+     * BatchCompletion.
+     */
+    BatchCompletion executeDeferred(Transaction* transaction);
     
     /**
      * @brief Cancel batch without executing
@@ -96,6 +393,34 @@ public:
      * @return Number of messages
      */
     unsigned getMessageCount() const;
+
+    /**
+     * @brief Bytes of message data added so far (aligned messages)
+     *
+     * What the messages occupy in the server-side batch buffer, whose
+     * limit is TAG_BUFFER_BYTES_SIZE; BLOB data is not included.
+     */
+    size_t getBufferedBytes() const;
+
+    /**
+     * @brief Bytes one message occupies in the batch buffer (aligned length)
+     */
+    size_t getMessageBytes() const;
+
+    /**
+     * @brief Size of the packing chunk passed to IBatch::add() by addMany()
+     */
+    size_t getStreamChunkBytes() const;
+
+    /**
+     * @brief Set the packing chunk size (at least one message per chunk)
+     *
+     * Keep it below the server-side batch buffer (TAG_BUFFER_BYTES_SIZE).
+     */
+    void setStreamChunkBytes(size_t bytes);
+
+    /// Default addMany() chunk size
+    static constexpr size_t kDefaultStreamChunkBytes = 4 * 1024 * 1024;
     
     /**
      * @brief Check if batch is valid
@@ -104,6 +429,17 @@ public:
     bool isValid() const;
     
 private:
+    friend class Statement;   // trackMemory(), applyOptions(), setMetrics()
+
+    // Charge the batch's buffers to a connection's memory account
+    void trackMemory(std::shared_ptr<detail::MemoryAccount> account);
+
+    // Options the IBatch was created with, for execute()
+    void applyOptions(const BatchOptions& options);
+
+    // Phase timings of the producing statement's key (FBPP_PROFILE)
+    void setMetrics(std::shared_ptr<StatementMetrics> metrics);
+
     class BatchImpl;
     std::unique_ptr<BatchImpl> impl_;
 };
@@ -4,6 +4,8 @@
 #include "fbpp/core/pack_utils.hpp"  // Use universal pack/unpack functions
 #include "fbpp/core/message_metadata.hpp"
 #include "fbpp/core/exception.hpp"
+#include "fbpp/core/memory_usage.hpp"
+#include "fbpp/core/statement_metrics.hpp"
 #include <nlohmann/json.hpp>
 #include <cstring>
 
@@ -13,14 +15,63 @@ namespace fbpp::core {
 class Batch::BatchImpl {
 public:
     Firebird::IBatch* batch_ = nullptr;
-    std::shared_ptr<MessageMetadata> metadata_;
+    std::shared_ptr<const MessageMetadata> metadata_;
     Firebird::IStatus* status_ = nullptr;
     mutable Firebird::ThrowStatusWrapper statusWrapper_{nullptr};
     unsigned messageCount_ = 0;
     std::vector<uint8_t> buffer_;  // Reusable buffer for packing
+    const JsonTextPacker* jsonTextPacker_ = nullptr;  // Cached on metadata_; null -> positional
+    // Binder metadata add(const ParamBinder&) last found compatible
+    std::shared_ptr<const MessageMetadata> binderLayout_;
+    
+    // addMany() stream arena: messageLength_ rounded up to the message
+    // alignment, packed back to back, flushed every chunkBytes_. Kept for
+    // the lifetime of the batch so repeated addMany() calls do not
+    // reallocate.
+    size_t messageLength_ = 0;
+    size_t alignedLength_ = 0;
+    size_t chunkBytes_ = Batch::kDefaultStreamChunkBytes;
+    std::vector<uint8_t> stream_;
+
+    BatchBlobPolicy blobPolicy_ = BatchBlobPolicy::None;
+    bool recordCounts_ = true;       // BatchOptions::recordCounts
+    bool continueOnError_ = false;   // BatchOptions::continueOnError
+    uint32_t lastUserBlobId_ = 0;    // BatchBlobPolicy::IdUser
+    std::vector<uint8_t> blobChunk_; // addBlob() read buffer
+
+    // Connection::memoryUsage() accounting (see Batch::trackMemory)
+    detail::MemoryCharge memory_;
+
+    // Statement key the phase timers record into; null unless collected
+    std::shared_ptr<StatementMetrics> metrics_;
+
+    // Report the buffers' capacity to the memory account, if any
+    void chargeBuffers() noexcept {
+        memory_.set(buffer_.capacity() + stream_.capacity() + blobChunk_.capacity());
+    }
     
-    BatchImpl(Firebird::IBatch* batch, std::shared_ptr<MessageMetadata> metadata);
+    BatchImpl(Firebird::IBatch* batch, std::shared_ptr<const MessageMetadata> metadata);
+
+    // Throw unless the batch was created with a policy addBlob() accepts
+    void requireBlobIds(const char* operation) const;
+
+    // IBatch::addBlob() with the first piece; returns the batch-local id
+    ISC_QUAD beginBlob(const void* data, size_t length);
+
+    // IBatch::appendBlobData() in pieces of at most kBlobSegmentBytes
+    void appendBlob(const uint8_t* data, size_t length);
     ~BatchImpl();
+
+    // Messages per addMany() chunk; sizes stream_ on first use
+    size_t prepareStream();
+
+    // Hand the first `count` packed messages of stream_ to IBatch::add()
+    void addStream(size_t count);
+    
+    // Packer for JsonText rows
+    const JsonTextPacker& jsonText() const {
+        return jsonTextPacker_ ? *jsonTextPacker_ : JsonTextPacker::of(*metadata_);
+    }
     
     // Get status wrapper
     Firebird::ThrowStatusWrapper& status() const {
@@ -40,16 +91,21 @@ void Batch::add(const std::tuple<Args...>& params) {
     size_t bufferSize = impl_->metadata_->getMessageLength();
     if (impl_->buffer_.size() < bufferSize) {
         impl_->buffer_.resize(bufferSize);
+        impl_->chargeBuffers();
     }
     
     // Clear buffer
     std::memset(impl_->buffer_.data(), 0, bufferSize);
     
     // Use universal pack function instead of TuplePacker directly
-    pack(params, impl_->buffer_.data(), impl_->metadata_.get(), nullptr);
+    {
+        detail::PhaseTimer packing(impl_->metrics_.get(), Phase::Pack);
+        pack(params, impl_->buffer_.data(), impl_->metadata_.get(), nullptr);
+    }
     
     // Add to batch
     try {
+        detail::PhaseTimer wire(impl_->metrics_.get(), Phase::Wire);
         impl_->batch_->add(&impl_->status(), 1, impl_->buffer_.data());
         impl_->messageCount_++;
     } catch (const Firebird::FbException& e) {
@@ -59,43 +115,58 @@ void Batch::add(const std::tuple<Args...>& params) {
 
 template<typename... Args>
 void Batch::addMany(const std::vector<std::tuple<Args...>>& paramsList) {
+    addMany(paramsList.begin(), paramsList.end());
+}
+
+template<typename T>
+void Batch::add(const T& row) {
+    static_assert(is_struct_packable_v<T>,
+                  "Batch::add() takes a tuple, JSON or a type with a StructDescriptor");
+    addMany(&row, &row + 1);
+}
+
+template<typename T>
+void Batch::addMany(std::span<const T> rows) {
+    static_assert(is_struct_packable_v<T>,
+                  "Batch::addMany(span) takes a type with a StructDescriptor");
+    addMany(rows.data(), rows.data() + rows.size());
+}
+
+template<std::input_iterator It, std::sentinel_for<It> Sentinel>
+It Batch::addMany(It first, Sentinel last) {
     if (!impl_ || !impl_->batch_) {
         throw FirebirdException("Invalid batch");
     }
     
-    if (paramsList.empty()) {
-        return;
+    const size_t perChunk = impl_->prepareStream();
+    const size_t alignedLength = impl_->alignedLength_;
+    size_t inChunk = 0;
+
+    for (; first != last; ++first) {
+        uint8_t* message = impl_->stream_.data() + inChunk * alignedLength;
+        detail::PhaseTimer packing(impl_->metrics_.get(), Phase::Pack);
+        if constexpr (std::is_same_v<std::remove_cvref_t<decltype(*first)>, JsonText>) {
+            impl_->jsonText().pack((*first).text, message, nullptr);   // Clears the message itself
+        } else {
+            std::memset(message, 0, impl_->messageLength_);
+            pack(*first, message, impl_->metadata_.get(), nullptr);
+        }
+
+        if (++inChunk == perChunk) {
+            impl_->addStream(inChunk);
+            inChunk = 0;
+        }
     }
     
-    // Calculate buffer size for all messages
-    size_t messageLength = impl_->metadata_->getMessageLength();
-    size_t messageAlign = impl_->metadata_->getAlignment();
-    
-    // Align each message to boundary
-    size_t alignedLength = ((messageLength + messageAlign - 1) / messageAlign) * messageAlign;
-    size_t totalSize = alignedLength * paramsList.size();
-    
-    // Allocate stream buffer
-    std::vector<uint8_t> streamBuffer(totalSize);
-    std::memset(streamBuffer.data(), 0, totalSize);
-    
-    // Pack all tuples using universal pack function
-    uint8_t* ptr = streamBuffer.data();
-    
-    for (const auto& params : paramsList) {
-        pack(params, ptr, impl_->metadata_.get(), nullptr);
-        ptr += alignedLength;
+    if (inChunk > 0) {
+        impl_->addStream(inChunk);
     }
+    return first;
+}
     
-    // Add all messages to batch at once
-    try {
-        impl_->batch_->add(&impl_->status(), 
-                          static_cast<unsigned>(paramsList.size()), 
-                          streamBuffer.data());
-        impl_->messageCount_ += paramsList.size();
-    } catch (const Firebird::FbException& e) {
-        throw FirebirdException(e);
-    }
+template<std::ranges::input_range Range>
+void Batch::addMany(Range&& rows) {
+    addMany(std::ranges::begin(rows), std::ranges::end(rows));
 }
 
 // JSON support methods (non-template)
@@ -108,16 +179,21 @@ inline void Batch::add(const nlohmann::json& params) {
     size_t bufferSize = impl_->metadata_->getMessageLength();
     if (impl_->buffer_.size() < bufferSize) {
         impl_->buffer_.resize(bufferSize);
+        impl_->chargeBuffers();
     }
     
     // Clear buffer
     std::memset(impl_->buffer_.data(), 0, bufferSize);
     
     // Use universal pack function for JSON
-    pack(params, impl_->buffer_.data(), impl_->metadata_.get(), nullptr);
+    {
+        detail::PhaseTimer packing(impl_->metrics_.get(), Phase::Pack);
+        pack(params, impl_->buffer_.data(), impl_->metadata_.get(), nullptr);
+    }
     
     // Add to batch
     try {
+        detail::PhaseTimer wire(impl_->metrics_.get(), Phase::Wire);
         impl_->batch_->add(&impl_->status(), 1, impl_->buffer_.data());
         impl_->messageCount_++;
     } catch (const Firebird::FbException& e) {
@@ -126,43 +202,11 @@ inline void Batch::add(const nlohmann::json& params) {
 }
 
 inline void Batch::addMany(const std::vector<nlohmann::json>& paramsList) {
-    if (!impl_ || !impl_->batch_) {
-        throw FirebirdException("Invalid batch");
-    }
-    
-    if (paramsList.empty()) {
-        return;
-    }
-    
-    // Calculate buffer size for all messages
-    size_t messageLength = impl_->metadata_->getMessageLength();
-    size_t messageAlign = impl_->metadata_->getAlignment();
-    
-    // Align each message to boundary
-    size_t alignedLength = ((messageLength + messageAlign - 1) / messageAlign) * messageAlign;
-    size_t totalSize = alignedLength * paramsList.size();
-    
-    // Allocate stream buffer
-    std::vector<uint8_t> streamBuffer(totalSize);
-    std::memset(streamBuffer.data(), 0, totalSize);
-    
-    // Pack all JSON objects using universal pack function
-    uint8_t* ptr = streamBuffer.data();
-    
-    for (const auto& params : paramsList) {
-        pack(params, ptr, impl_->metadata_.get(), nullptr);
-        ptr += alignedLength;
-    }
+    addMany(paramsList.begin(), paramsList.end());
+}
     
-    // Add all messages to batch at once
-    try {
-        impl_->batch_->add(&impl_->status(), 
-                          static_cast<unsigned>(paramsList.size()), 
-                          streamBuffer.data());
-        impl_->messageCount_ += paramsList.size();
-    } catch (const Firebird::FbException& e) {
-        throw FirebirdException(e);
-    }
+inline void Batch::add(const JsonText& row) {
+    addMany(&row, &row + 1);
 }
 
 } // namespace fbpp::core
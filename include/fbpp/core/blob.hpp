@@ -0,0 +1,240 @@
+#pragma once
+
+#include "fbpp/core/environment.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/firebird_compat.hpp"
+#include "fbpp/core/text_codec.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fbpp {
+namespace core {
+
+class Transaction;
+
+/**
+ * @brief isc_info_blob_* summary of an open BLOB
+ */
+struct BlobInfo {
+    uint64_t totalLength = 0;
+    uint32_t numSegments = 0;
+    uint32_t maxSegmentSize = 0;
+    bool isStream = false;
+};
+
+/**
+ * @brief Origin of BlobReader::seek() (blb_seek_* modes)
+ */
+enum class BlobSeekOrigin {
+    Begin = 0,      // from head
+    Current = 1,    // blb_seek_relative
+    End = 2         // blb_seek_from_tail
+};
+
+/**
+ * @brief Streaming reader over one BLOB
+ *
+ * Reads into caller memory through getSegment() without staging copies,
+ * so a BLOB of any size streams with a buffer of the caller's choosing.
+ * Keeps the owning Transaction alive, like ResultSet.
+ *
+ * Thread-safety contract: same as the Transaction it was opened from.
+ */
+class BlobReader {
+public:
+    /// Default chunk of readAll(); also the largest single getSegment() request
+    static constexpr size_t kDefaultReadSize = 64 * 1024 - 1;
+
+    BlobReader(Firebird::IBlob* blob, std::shared_ptr<Transaction> transaction,
+               size_t readSize = kDefaultReadSize);
+
+    BlobReader(BlobReader&& other) noexcept;
+    BlobReader& operator=(BlobReader&& other) noexcept;
+    BlobReader(const BlobReader&) = delete;
+    BlobReader& operator=(const BlobReader&) = delete;
+
+    ~BlobReader();
+
+    /**
+     * @brief Fill up to `maxBytes` of `buffer`
+     * @return Bytes read; less than maxBytes only at the end, 0 == EOF
+     */
+    size_t read(void* buffer, size_t maxBytes);
+
+    size_t read(std::span<std::byte> buffer) {
+        return read(buffer.data(), buffer.size());
+    }
+
+    /**
+     * @brief Hand the rest of the BLOB to `sink` in chunks of readSize() bytes
+     *
+     * The span points into a buffer owned by the reader and is only valid
+     * during the call. Throw from `sink` to stop early.
+     * @return Bytes passed to `sink`
+     */
+    uint64_t readAll(const std::function<void(std::span<const std::byte>)>& sink);
+
+    /// Read the rest of the BLOB into memory, pre-sized from info()
+    std::vector<uint8_t> readAll();
+
+    /**
+     * @brief Hand the rest of a text BLOB to `sink`, converted by `transcoder`
+     *
+     * One converted chunk per read of readSize() bytes, through one buffer
+     * reused for the whole BLOB; characters cut by a read boundary come out
+     * whole with the next chunk. Ends with transcoder.finish().
+     * @return Converted bytes passed to `sink`
+     * @throws FirebirdException as TextTranscoder for malformed or
+     *         unmappable text
+     */
+    uint64_t readAllText(TextTranscoder& transcoder,
+                         const std::function<void(std::string_view)>& sink);
+
+    /**
+     * @brief Write the rest of the BLOB to a file (created or truncated)
+     *
+     * Sizes the file from info() and reads straight into a mapping of it
+     * where the platform allows, so the client library's copy is the only
+     * one; otherwise streams like readAll(sink).
+     * @return Bytes written
+     */
+    uint64_t readToFile(const std::string& path);
+
+    BlobInfo info() const;
+
+    /**
+     * @brief Reposition a stream BLOB
+     * @return New absolute offset
+     * @throws FirebirdException on segmented BLOBs
+     */
+    uint64_t seek(int64_t offset, BlobSeekOrigin origin = BlobSeekOrigin::Begin);
+
+    bool eof() const { return eof_; }
+    bool isOpen() const { return blob_ != nullptr; }
+
+    size_t readSize() const { return readSize_; }
+    void setReadSize(size_t bytes);
+
+    /// Close the BLOB handle (also done by the destructor)
+    void close();
+
+private:
+    Firebird::ThrowStatusWrapper& status() const {
+        statusWrapper_.init();
+        return statusWrapper_;
+    }
+    void release() noexcept;
+
+    Firebird::IBlob* blob_ = nullptr;
+    std::shared_ptr<Transaction> transaction_;   // Keeps the BLOB's transaction alive
+    Firebird::IStatus* status_ = nullptr;
+    mutable Firebird::ThrowStatusWrapper statusWrapper_{nullptr};
+    size_t readSize_ = kDefaultReadSize;
+    std::vector<std::byte> chunk_;               // readAll(sink) buffer, on demand
+    bool eof_ = false;
+};
+
+/**
+ * @brief Incremental writer of one new BLOB
+ *
+ * write() hands caller memory straight to putSegment() in segments of up
+ * to segmentSize() bytes, so data from a mapped file or any large buffer
+ * is never staged. Stream BLOBs (isc_bpb_type_stream) are seekable on
+ * read and ignore segment boundaries.
+ *
+ * The destructor cancels an unfinished BLOB: only finish() makes it
+ * usable. Thread-safety contract: same as the owning Transaction.
+ */
+class BlobWriter {
+public:
+    /// putSegment() lengths are unsigned short: the largest segment
+    static constexpr size_t kMaxSegmentBytes = 64 * 1024 - 1;
+
+    BlobWriter(Firebird::IBlob* blob, const ISC_QUAD& blobId,
+               std::shared_ptr<Transaction> transaction,
+               size_t segmentSize = kMaxSegmentBytes);
+
+    BlobWriter(BlobWriter&& other) noexcept;
+    BlobWriter& operator=(BlobWriter&& other) noexcept;
+    BlobWriter(const BlobWriter&) = delete;
+    BlobWriter& operator=(const BlobWriter&) = delete;
+
+    ~BlobWriter();
+
+    void write(const void* data, size_t bytes);
+
+    void write(std::span<const std::byte> data) {
+        write(data.data(), data.size());
+    }
+
+    /// Copy `in` to the BLOB through one segment-sized buffer
+    uint64_t writeFrom(std::istream& in);
+
+    /**
+     * @brief Write one piece of text, converted by `transcoder`
+     *
+     * A character cut at the end of `text` is held by the transcoder and
+     * written with the next piece; call flushText() after the last one.
+     */
+    void writeText(std::string_view text, TextTranscoder& transcoder);
+
+    /// Write what `transcoder` still holds and end its text
+    void flushText(TextTranscoder& transcoder);
+
+    /**
+     * @brief Copy text from `in` to the BLOB, converted by `transcoder`
+     * @return Bytes written to the BLOB
+     */
+    uint64_t writeTextFrom(std::istream& in, TextTranscoder& transcoder);
+
+    /// Copy an open file descriptor to its end through one segment-sized buffer
+    uint64_t writeFromFd(int fd);
+
+    /**
+     * @brief Write a whole file
+     *
+     * Maps the file and writes from the mapping where the platform allows
+     * (no user-space copy), otherwise streams it like writeFrom().
+     */
+    uint64_t writeFile(const std::string& path);
+
+    /**
+     * @brief Close the BLOB and return its id for binding
+     */
+    ISC_QUAD finish();
+
+    /// Discard the BLOB (also done by the destructor if not finished)
+    void cancel();
+
+    const ISC_QUAD& id() const { return blobId_; }
+    uint64_t bytesWritten() const { return written_; }
+    size_t segmentSize() const { return segmentSize_; }
+    bool isOpen() const { return blob_ != nullptr; }
+
+private:
+    Firebird::ThrowStatusWrapper& status() const {
+        statusWrapper_.init();
+        return statusWrapper_;
+    }
+    void release() noexcept;
+    std::vector<std::byte>& buffer();
+
+    Firebird::IBlob* blob_ = nullptr;
+    ISC_QUAD blobId_{};
+    std::shared_ptr<Transaction> transaction_;   // Keeps the BLOB's transaction alive
+    Firebird::IStatus* status_ = nullptr;
+    mutable Firebird::ThrowStatusWrapper statusWrapper_{nullptr};
+    size_t segmentSize_ = kMaxSegmentBytes;
+    uint64_t written_ = 0;
+    std::vector<std::byte> buffer_;              // writeFrom*/writeFile fallback, on demand
+};
+
+} // namespace core
+} // namespace fbpp
@@ -0,0 +1,481 @@
+#pragma once
+
+// BulkLoader<T> — sustained INSERT/UPDATE loads on top of Batch.
+//
+// IBatch keeps every added message in a server-side buffer whose size is
+// capped by TAG_BUFFER_BYTES_SIZE; overflowing it fails the whole batch.
+// BulkLoader tracks the packed bytes of the current Batch, executes it
+// once BulkLoaderOptions::flushBytes is reached and starts the next one,
+// so callers no longer pick a row count per batch by hand. Every flush's
+// BatchResult is merged into one result with load-wide message indexes.
+//
+//   BulkLoader<std::tuple<int, std::string>> loader(stmt, tx);
+//   loader.addMany(rows);          // any input range, flushed as needed
+//   auto result = loader.finish(); // last flush; commit is up to the caller
+//
+// Rows are anything Batch::addMany() packs: tuples, JSON, described
+// structs. One loader belongs to one thread.
+//
+// Pipelined mode (BulkLoaderOptions::pipelined): addMany() packs rows in a
+// producer task on Executor::shared() into two alternating chunk buffers
+// while the calling thread hands the other chunk to IBatch::add() and
+// executes full batches, so packing overlaps the execute round trip. All
+// server calls stay on the calling thread; the producer only packs,
+// against its own MessageMetadata::clone(). Called from a worker of the
+// shared executor, addMany() packs sequentially instead (the producer
+// could be queued behind its own consumer).
+//
+// IBatch arrived with Firebird 4. Against an older server (or with
+// BulkLoadMethod::ExecuteBlock) the loader packs rows into one buffer per
+// flush instead and runs it through ExecuteBlockBatch in rowCounts mode:
+// up to blockRows rows per EXECUTE BLOCK, each block shape prepared once
+// per loader. Results, flushes and continueOnError read the same; per-row
+// counts are always reported, and pipelined mode packs sequentially.
+
+#include "fbpp/core/batch.hpp"
+#include "fbpp/core/batch_impl.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/execute_block_batch.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/message_metadata.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/executor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+namespace fbpp::core {
+
+/// How a BulkLoader sends its rows
+enum class BulkLoadMethod {
+    Automatic,     // IBatch on Firebird 4 and later, EXECUTE BLOCK before
+    Batch,         // Always IBatch
+    ExecuteBlock   // Always ExecuteBlockBatch
+};
+
+/**
+ * @brief Flush and commit policy of a BulkLoader
+ */
+struct BulkLoaderOptions {
+    // Execute the current batch once its messages reach this many bytes.
+    // Default stays below the 10 MB server-side batch buffer of FB4/FB5.
+    size_t flushBytes = 8 * 1024 * 1024;
+    // CommitRetaining() after every N flushes; 0 never commits.
+    unsigned commitEveryFlushes = 0;
+    // BatchOptions of each batch. Without record counts results carry no
+    // perMessageStatus (EXECUTE BLOCK loads drop theirs to match).
+    bool recordCounts = true;
+    bool continueOnError = false;
+    size_t bufferBytes = 0;   // TAG_BUFFER_BYTES_SIZE; keep above flushBytes
+    // Pack addMany() rows in a producer task while batches execute
+    bool pipelined = false;
+    // Error texts formatted per flush; failed counts and indexes still
+    // cover every message. Large continueOnError loads keep this small.
+    size_t maxErrorMessages = BatchCompletion::kAllErrors;
+    // Called with each flush's result after its execute and before the
+    // commitEveryFlushes commit, on the thread that flushed (BulkLoader only)
+    std::function<void(const BatchResult&)> onFlush;
+    BulkLoadMethod method = BulkLoadMethod::Automatic;
+    // Rows per EXECUTE BLOCK (ExecuteBlockOptions::maxRows)
+    size_t blockRows = 64;
+};
+
+namespace detail {
+
+/**
+ * @brief Two packed-message buffers handed between packer and sender
+ *
+ * The producer fills the free chunk while the consumer sends the other;
+ * each side blocks only when it would overtake the other.
+ */
+class PackPipeline {
+public:
+    struct Chunk {
+        std::vector<uint8_t> data;
+        size_t count = 0;   // Messages packed into data
+    };
+
+    explicit PackPipeline(size_t chunkBytes) {
+        for (auto& chunk : chunks_) {
+            chunk.data.assign(chunkBytes, 0);
+        }
+    }
+
+    /// Producer: wait for a free chunk; nullptr once the consumer stopped
+    Chunk* waitFree() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return stopped_ || filled_ - released_ < chunks_.size(); });
+        return stopped_ ? nullptr : &chunks_[filled_ % chunks_.size()];
+    }
+
+    /// Producer: the chunk from waitFree() is ready to send
+    void publish() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++filled_;
+        cv_.notify_all();
+    }
+
+    /// Producer: no more chunks; `error` is rethrown by the consumer
+    void close(std::exception_ptr error = nullptr) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        error_ = std::move(error);
+        cv_.notify_all();
+    }
+
+    /// Consumer: wait for a packed chunk; nullptr once closed and drained
+    Chunk* waitFilled() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return closed_ || filled_ > released_; });
+        return filled_ > released_ ? &chunks_[released_ % chunks_.size()] : nullptr;
+    }
+
+    /// Consumer: the chunk from waitFilled() has been copied out
+    void release() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++released_;
+        cv_.notify_all();
+    }
+
+    /// Consumer: give up; a waiting producer returns
+    void stop() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+        cv_.notify_all();
+    }
+
+    std::exception_ptr error() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return error_;
+    }
+
+private:
+    std::array<Chunk, 2> chunks_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    size_t filled_ = 0;
+    size_t released_ = 0;
+    bool closed_ = false;
+    bool stopped_ = false;
+    std::exception_ptr error_;
+};
+
+} // namespace detail
+
+/**
+ * @brief Auto-flushing bulk loader for rows of type T
+ */
+template<typename T>
+class BulkLoader {
+public:
+    /// Boundaries of one executed batch within result()
+    struct FlushInfo {
+        unsigned firstMessage = 0;
+        unsigned messageCount = 0;
+        unsigned failedCount = 0;
+    };
+
+    BulkLoader(std::shared_ptr<Statement> statement,
+               std::shared_ptr<Transaction> transaction,
+               BulkLoaderOptions options = {})
+        : statement_(std::move(statement)),
+          transaction_(std::move(transaction)),
+          options_(options) {
+        if (!statement_ || !statement_->isValid()) {
+            throw FirebirdException("BulkLoader: statement is not valid");
+        }
+        if (!transaction_ || !transaction_->isActive()) {
+            throw FirebirdException("BulkLoader: valid active transaction required");
+        }
+        Connection* connection = transaction_->getConnection();
+        if (options_.method == BulkLoadMethod::ExecuteBlock ||
+            (options_.method == BulkLoadMethod::Automatic && connection &&
+             connection->getEngineMajorVersion() < 4)) {
+            if (!connection) {
+                throw FirebirdException(
+                    "BulkLoader: EXECUTE BLOCK needs the transaction's connection");
+            }
+            ExecuteBlockOptions blockOptions;
+            blockOptions.maxRows = options_.blockRows;
+            blockOptions.rowCounts = true;
+            blockOptions.continueOnError = options_.continueOnError;
+            blocks_ = std::make_unique<ExecuteBlockBatch>(*connection, statement_, blockOptions);
+            if (auto input = statement_->getInputMetadata()) {
+                pendingStride_ = input->getMessageLength();
+            }
+        }
+    }
+
+    /// Rows added since the last flush are cancelled, not executed; call
+    /// finish() to keep them.
+    ~BulkLoader() = default;
+
+    BulkLoader(const BulkLoader&) = delete;
+    BulkLoader& operator=(const BulkLoader&) = delete;
+    BulkLoader(BulkLoader&&) noexcept = default;
+    BulkLoader& operator=(BulkLoader&&) noexcept = default;
+
+    /**
+     * @brief Add one row, flushing first if the batch is full
+     */
+    void add(const T& row) {
+        addSequential(&row, &row + 1);
+    }
+
+    /**
+     * @brief Add every row of an iterator range, flushing as needed
+     *
+     * In pipelined mode the range is read by a producer task and must
+     * not be touched by anyone else until addMany() returns. If a row
+     * fails to pack, the rows before it are still added and the error is
+     * rethrown once they are.
+     */
+    template<std::input_iterator It, std::sentinel_for<It> Sentinel>
+    void addMany(It first, Sentinel last) {
+        if (options_.pipelined && !blocks_ && !Executor::shared()->onWorkerThread()) {
+            addPipelined(std::move(first), std::move(last));
+        } else {
+            addSequential(std::move(first), std::move(last));
+        }
+    }
+
+    /**
+     * @brief Add every row of an input range, flushing as needed
+     */
+    template<std::ranges::input_range Range>
+    void addMany(Range&& rows) {
+        addMany(std::ranges::begin(rows), std::ranges::end(rows));
+    }
+
+    /**
+     * @brief Execute the rows added since the last flush
+     *
+     * Merges the batch's result into result() and, if configured, commits
+     * retaining every commitEveryFlushes flushes.
+     */
+    void flush() {
+        BatchResult result;
+        if (blocks_) {
+            if (pendingCount_ == 0) {
+                return;
+            }
+            result = blocks_->execute(*transaction_, pending_.data(), pendingCount_,
+                                      pendingStride_, options_.maxErrorMessages);
+            if (!options_.recordCounts) {
+                result.perMessageStatus.clear();
+            }
+            pending_.clear();
+            pendingCount_ = 0;
+        } else {
+            if (!batch_ || batch_->getMessageCount() == 0) {
+                return;
+            }
+            result = batch_->execute(transaction_.get(), options_.maxErrorMessages);
+            batch_.reset();
+        }
+        flushes_.push_back({result_.totalMessages, result.totalMessages, result.failedCount});
+        result_.merge(result);
+        ++flushCount_;
+        if (options_.onFlush) {
+            options_.onFlush(result);
+        }
+
+        if (options_.commitEveryFlushes != 0 &&
+            flushCount_ % options_.commitEveryFlushes == 0) {
+            transaction_->CommitRetaining();
+        }
+    }
+
+    /**
+     * @brief Flush the remaining rows and return the merged result
+     *
+     * The transaction is left open: committing the tail is the caller's
+     * decision.
+     */
+    BatchResult finish() {
+        flush();
+        return result_;
+    }
+
+    /// Merged result of all flushes so far
+    const BatchResult& result() const { return result_; }
+
+    /// Number of executed batches
+    unsigned flushCount() const { return flushCount_; }
+
+    /// Per-batch slices of result(), in execution order
+    const std::vector<FlushInfo>& flushes() const { return flushes_; }
+
+    /// Bytes waiting in the current (not yet executed) batch
+    size_t bufferedBytes() const {
+        if (blocks_) {
+            return pendingCount_ * pendingStride_;
+        }
+        return batch_ ? batch_->getBufferedBytes() : 0;
+    }
+
+    /// Rows go through EXECUTE BLOCK rather than IBatch
+    bool usesExecuteBlock() const { return blocks_ != nullptr; }
+
+    const BulkLoaderOptions& options() const { return options_; }
+
+private:
+    // Rows that still fit below the flush threshold (at least one, so a
+    // threshold smaller than a message still makes progress).
+    size_t roomIn(const Batch& batch) const {
+        const size_t messageBytes = std::max<size_t>(batch.getMessageBytes(), 1);
+        const size_t buffered = batch.getBufferedBytes();
+        return buffered >= options_.flushBytes
+            ? 1 : std::max<size_t>((options_.flushBytes - buffered) / messageBytes, 1);
+    }
+
+    template<typename It, typename Sentinel>
+    void addSequential(It first, Sentinel last) {
+        if (blocks_) {
+            addBlocks(std::move(first), std::move(last));
+            return;
+        }
+        while (first != last) {
+            Batch& batch = currentBatch();
+            auto reached = batch.addMany(
+                std::counted_iterator(std::move(first),
+                                      static_cast<std::iter_difference_t<It>>(roomIn(batch))),
+                detail::ChunkEnd<Sentinel>{last});
+            first = std::move(reached).base();
+
+            if (batch.getBufferedBytes() >= options_.flushBytes) {
+                flush();
+            }
+        }
+    }
+
+    // Pack each row with the transaction (for BLOB parameters) into the
+    // pending buffer; a row that fails to pack leaves the buffer as it was
+    template<typename It, typename Sentinel>
+    void addBlocks(It first, Sentinel last) {
+        auto metadata = statement_->getInputMetadata();
+        for (; first != last; ++first) {
+            pending_.resize((pendingCount_ + 1) * pendingStride_);
+            if (metadata) {
+                uint8_t* message = pending_.data() + pendingCount_ * pendingStride_;
+                std::memset(message, 0, pendingStride_);
+                pack(*first, message, metadata.get(), transaction_.get());
+            }
+            ++pendingCount_;
+            if (bufferedBytes() >= options_.flushBytes) {
+                flush();
+            }
+        }
+    }
+
+    template<typename It, typename Sentinel>
+    void addPipelined(It first, Sentinel last) {
+        if (first == last) {
+            return;
+        }
+
+        // Both sides use the stride of the batch the consumer fills; the
+        // producer packs against its own metadata wrapper.
+        const size_t messageBytes = std::max<size_t>(currentBatch().getMessageBytes(), 1);
+        const size_t chunkBytes = std::min(options_.flushBytes, batch_->getStreamChunkBytes());
+        const size_t perChunk = std::max<size_t>(chunkBytes / messageBytes, 1);
+        auto metadata = statement_->getInputMetadata()->clone();
+        const size_t messageLength = metadata->getMessageLength();
+
+        detail::PackPipeline pipe(perChunk * messageBytes);
+
+        TaskGroup producer(*Executor::shared());
+        producer.run([&] {
+            std::exception_ptr error;
+            while (!error && first != last) {
+                auto* chunk = pipe.waitFree();
+                if (!chunk) {
+                    return;
+                }
+                chunk->count = 0;
+                try {
+                    for (; chunk->count < perChunk && first != last; ++first) {
+                        uint8_t* message = chunk->data.data() + chunk->count * messageBytes;
+                        std::memset(message, 0, messageLength);
+                        pack(*first, message, metadata.get(), nullptr);
+                        ++chunk->count;
+                    }
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                pipe.publish();
+            }
+            pipe.close(std::move(error));
+        });
+
+        try {
+            while (auto* chunk = pipe.waitFilled()) {
+                size_t offset = 0;
+                bool released = false;
+                while (!released) {
+                    const size_t count = std::min(roomIn(currentBatch()), chunk->count - offset);
+                    batch_->addPacked(chunk->data.data() + offset * messageBytes, count);
+                    offset += count;
+                    if (offset == chunk->count) {
+                        // IBatch::add() copied it; packing resumes during execute.
+                        pipe.release();
+                        released = true;
+                    }
+                    if (batch_->getBufferedBytes() >= options_.flushBytes) {
+                        flush();
+                    }
+                }
+            }
+        } catch (...) {
+            pipe.stop();
+            producer.wait();
+            throw;
+        }
+
+        producer.wait();
+        if (auto error = pipe.error()) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    Batch& currentBatch() {
+        // Batch::execute() releases the IBatch, so every flush needs a new one.
+        if (!batch_) {
+            BatchOptions batchOptions;
+            batchOptions.recordCounts = options_.recordCounts;
+            batchOptions.continueOnError = options_.continueOnError;
+            batchOptions.bufferBytes = options_.bufferBytes;
+            batch_ = statement_->createBatch(transaction_.get(), batchOptions);
+            // One IBatch::add() per chunk never exceeds the flush threshold.
+            batch_->setStreamChunkBytes(
+                std::min(batch_->getStreamChunkBytes(), std::max<size_t>(options_.flushBytes, 1)));
+        }
+        return *batch_;
+    }
+
+    std::shared_ptr<Statement> statement_;
+    std::shared_ptr<Transaction> transaction_;
+    BulkLoaderOptions options_;
+    std::unique_ptr<Batch> batch_;
+    std::unique_ptr<ExecuteBlockBatch> blocks_;   // Set when rows go through EXECUTE BLOCK
+    std::vector<uint8_t> pending_;                // Packed rows of the next block flush
+    size_t pendingCount_ = 0;
+    size_t pendingStride_ = 0;
+    BatchResult result_;
+    std::vector<FlushInfo> flushes_;
+    unsigned flushCount_ = 0;
+};
+
+} // namespace fbpp::core
@@ -0,0 +1,157 @@
+#pragma once
+
+// Deadline- and stop_token-bounded execution.
+//
+// CancelScope arms Connection::cancelOperation(CancelOperation::RAISE) for
+// the duration of a scope: when the deadline passes or the stop_token is
+// signalled, whatever the connection is executing fails with isc_cancelled
+// and the blocked call returns. Deadlines of every scope in the process
+// share one timer thread (started on first use), so bounding a query does
+// not cost a watchdog thread of its own; stop requests cancel from the
+// thread that calls request_stop().
+//
+//   {
+//       CancelScope scope(conn, std::chrono::milliseconds(250));
+//       tx->execute(stmt, params);         // throws once the deadline fires
+//   }
+//
+// executeAsync() / openCursorAsync() run the call on an executor (default:
+// Executor::shared()) inside such a scope. The caller must not use the
+// connection until the future is ready. For a purely server-side limit see
+// Statement::setTimeout().
+
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/executor.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/result_set.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <stop_token>
+#include <utility>
+
+namespace fbpp {
+namespace core {
+
+/**
+ * @brief Cancels a connection's current operation at a deadline or stop request
+ *
+ * Not copyable or movable. The connection must outlive the scope. A
+ * cancel raised just after the guarded call finished affects nothing the
+ * caller waits on; check fired() to tell a cancellation from other errors.
+ * Throws FirebirdException up front if the deadline already passed or
+ * stop was already requested.
+ */
+class CancelScope {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    CancelScope(Connection& connection, Clock::time_point deadline);
+    CancelScope(Connection& connection, std::chrono::milliseconds timeout)
+        : CancelScope(connection, Clock::now() + timeout) {}
+    CancelScope(Connection& connection, std::stop_token stop);
+    CancelScope(Connection& connection, std::optional<Clock::time_point> deadline,
+                std::stop_token stop);
+
+    ~CancelScope();
+
+    CancelScope(const CancelScope&) = delete;
+    CancelScope& operator=(const CancelScope&) = delete;
+
+    /// cancelOperation(RAISE) was sent
+    bool fired() const { return fired_->load(std::memory_order_acquire); }
+
+private:
+    Connection& connection_;
+    std::shared_ptr<std::atomic<bool>> fired_;
+    Clock::time_point deadline_{};
+    uint64_t timerId_ = 0;                          // 0: no deadline armed
+    std::optional<std::stop_callback<std::function<void()>>> stopCallback_;
+};
+
+/**
+ * @brief Bounds and executor of executeAsync() / openCursorAsync()
+ */
+struct AsyncOptions {
+    std::optional<CancelScope::Clock::time_point> deadline;
+    std::stop_token stop;
+    // Runs the task; empty = Executor::shared()
+    std::function<void(std::function<void()>)> executor;
+
+    static AsyncOptions timeout(std::chrono::milliseconds limit) {
+        AsyncOptions options;
+        options.deadline = CancelScope::Clock::now() + limit;
+        return options;
+    }
+};
+
+namespace detail {
+
+template<typename Result, typename Fn>
+std::future<Result> runCancellable(Connection& connection, AsyncOptions options, Fn fn) {
+    auto task = std::make_shared<std::packaged_task<Result()>>(
+        [&connection, deadline = options.deadline, stop = options.stop,
+         fn = std::move(fn)]() mutable -> Result {
+            CancelScope scope(connection, deadline, stop);
+            return fn();
+        });
+    auto future = task->get_future();
+    // Not std::async: its future would block in the destructor, turning a
+    // dropped future into a wait for the query.
+    if (options.executor) {
+        options.executor([task] { (*task)(); });
+    } else {
+        Executor::shared()->post([task] { (*task)(); });
+    }
+    return future;
+}
+
+} // namespace detail
+
+/**
+ * @brief Transaction::execute() on an executor, cancelled at options.deadline / options.stop
+ *
+ * `params` is copied into the task. The future rethrows execution errors
+ * (FirebirdException with isc_cancelled after a cancel).
+ */
+template<typename Params>
+std::future<unsigned> executeAsync(std::shared_ptr<Transaction> transaction,
+                                   std::shared_ptr<Statement> statement,
+                                   Params params, AsyncOptions options = {}) {
+    Connection& connection = *transaction->getConnection();
+    return detail::runCancellable<unsigned>(
+        connection, std::move(options),
+        [transaction = std::move(transaction), statement = std::move(statement),
+         params = std::move(params)] {
+            return transaction->execute(statement, params);
+        });
+}
+
+/**
+ * @brief Transaction::openCursor() on an executor, cancelled like executeAsync()
+ *
+ * The bound covers opening the cursor (where a SELECT does most of its
+ * work before the first row); wrap later fetches in a CancelScope of
+ * their own.
+ */
+template<typename Params>
+std::future<std::unique_ptr<ResultSet>> openCursorAsync(std::shared_ptr<Transaction> transaction,
+                                                        std::shared_ptr<Statement> statement,
+                                                        Params params, AsyncOptions options = {}) {
+    Connection& connection = *transaction->getConnection();
+    return detail::runCancellable<std::unique_ptr<ResultSet>>(
+        connection, std::move(options),
+        [transaction = std::move(transaction), statement = std::move(statement),
+         params = std::move(params)] {
+            return transaction->openCursor(statement, params);
+        });
+}
+
+} // namespace core
+} // namespace fbpp
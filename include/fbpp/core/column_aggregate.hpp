@@ -0,0 +1,132 @@
+#pragma once
+
+// Exact SUM / MIN / MAX / COUNT over columnar batches.
+//
+// Combining partial aggregates on the client (one SUM per shard, one MIN
+// per time slice) through doubles loses NUMERIC(38,x) and DECFLOAT(34)
+// digits. ExactAggregate folds ColumnBatch columns without leaving the
+// exact domain:
+//
+//   SMALLINT / INTEGER / BIGINT / INT128, NUMERIC / DECIMAL
+//       fixed point: INT128 at one scale. Sums keep a carry count beyond
+//       128 bits, so they overflow only if the final value does (sum()
+//       throws then). Columns and partials of different scales are
+//       aligned to the finer one.
+//   DECFLOAT(16) / DECFLOAT(34)
+//       decimal128 arithmetic through decNumber (the vendored cppdecimal),
+//       Firebird's context: 34 digits, round half up.
+//
+//   ExactAggregate total;
+//   ColumnBatch batch;
+//   while (cursor->fetchColumns(batch, 4096)) {
+//       total.add(batch.columns[0]);
+//   }
+//   other.merge(total);                      // Partials fold the same way
+//   std::cout << total.sumText().value_or("NULL");
+//
+// NULLs are skipped; sum / min / max of no values are empty, as SQL gives
+// NULL. For a column that already is a partial COUNT(*), read sum().
+//
+// The integer kernels run over the dense value buffers: NULL slots hold 0,
+// so sums ignore the validity bitmap, and narrower columns are summed as
+// 32-bit halves in int64 lanes the compiler vectorizes.
+
+#include "fbpp/core/column_batch.hpp"
+#include "fbpp/core/extended_types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace fbpp {
+namespace core {
+
+/**
+ * @brief Exact partial aggregate of one numeric column
+ *
+ * Not thread-safe; one per column per thread, then merge().
+ */
+class ExactAggregate {
+public:
+    enum class Domain {
+        None,         // Nothing added yet
+        FixedPoint,   // Integer and NUMERIC / DECIMAL columns
+        DecFloat      // DECFLOAT columns
+    };
+
+    /**
+     * @brief Fold every row of `column` in
+     * @throws FirebirdException for a column of another type (FLOAT, text,
+     *         ...), one of the other domain, unparsable DECFLOAT text, or
+     *         a scale alignment that leaves INT128 range
+     */
+    void add(const ColumnVector& column);
+
+    /**
+     * @brief Fold another partial in (e.g. another shard's)
+     * @throws FirebirdException as add()
+     */
+    void merge(const ExactAggregate& other);
+
+    Domain domain() const noexcept { return domain_; }
+
+    /// Non-NULL values folded in
+    uint64_t count() const noexcept { return count_; }
+
+    /// FixedPoint: scale of sum() / min() / max()
+    int scale() const noexcept { return scale_; }
+
+    /**
+     * @brief FixedPoint results (raw INT128 at scale())
+     * @throws FirebirdException for the DecFloat domain; sum() also when
+     *         the total is outside INT128 range
+     */
+    std::optional<Int128> sum() const;
+    std::optional<Int128> min() const;
+    std::optional<Int128> max() const;
+
+    /**
+     * @brief DecFloat results
+     * @throws FirebirdException for the FixedPoint domain; decSum() also
+     *         when the total overflowed DECFLOAT(34)
+     */
+    std::optional<DecFloat34> decSum() const;
+    std::optional<DecFloat34> decMin() const;
+    std::optional<DecFloat34> decMax() const;
+
+    /// Either domain as text ("-12.50" at scale -2; DECFLOAT notation)
+    std::optional<std::string> sumText() const;
+    std::optional<std::string> minText() const;
+    std::optional<std::string> maxText() const;
+
+private:
+    void enter(Domain domain, const std::string& column);
+    // Bring sum / min / max to `scale` (< scale_)
+    void refine(int scale);
+    void addFixed(const ColumnVector& column);
+    void addDecFloat(const ColumnVector& column);
+    // Fold a block's sum (with its carries) and extremes at scale_
+    void foldFixed(const Int128& sum, int64_t carries, const Int128& min, const Int128& max,
+                   uint64_t count);
+    void checkDomain(Domain domain, const char* what) const;
+
+    Domain domain_ = Domain::None;
+    uint64_t count_ = 0;
+
+    // FixedPoint. The exact sum is sum_ + carries_ * 2^128.
+    int scale_ = 0;
+    Int128 sum_;
+    int64_t carries_ = 0;
+    Int128 min_;
+    Int128 max_;
+
+    // DecFloat (decQuad bytes)
+    DecFloat34 decSum_;
+    DecFloat34 decMin_;
+    DecFloat34 decMax_;
+    bool decOverflow_ = false;
+};
+
+} // namespace core
+} // namespace fbpp
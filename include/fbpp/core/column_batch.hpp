@@ -0,0 +1,292 @@
+#pragma once
+
+// Columnar (struct-of-arrays) view of a block of fetched rows.
+//
+// ResultSet::fetchColumns(batchSize) stages up to batchSize messages and
+// decodes them column-at-a-time into one ColumnVector per output column:
+// a contiguous typed value buffer plus an LSB-first validity bitmap
+// (bit set = value present). Variable-width columns (String / Binary)
+// use the Arrow layout: rowCount+1 int32 offsets into a byte buffer.
+//
+// Physical representation per Firebird type:
+//   BOOLEAN                      -> Boolean   (uint8_t, 0/1)
+//   SMALLINT / INTEGER / BIGINT  -> Int16 / Int32 / Int64 (raw, see scale)
+//   NUMERIC / DECIMAL (scale<0)  -> Int16 / Int32 / Int64 unscaled + scale
+//   INT128                       -> Int128    (16-byte little-endian, + scale)
+//   FLOAT / DOUBLE PRECISION     -> Float / Double
+//   DATE                         -> Date      (int32 days since 1970-01-01)
+//   TIME [WITH TIME ZONE]        -> Time      (int64 us since midnight, UTC for TZ)
+//   TIMESTAMP [WITH TIME ZONE]   -> Timestamp (int64 us since 1970-01-01, UTC for TZ)
+//   CHAR / VARCHAR, DECFLOAT     -> String    (CHAR right-trimmed, DECFLOAT as text)
+//   BLOB SUB_TYPE TEXT           -> String    (content loaded via transaction)
+//   other BLOB                   -> Binary    (content loaded via transaction)
+//
+// TIME / TIMESTAMP WITH TIME ZONE columns also fill `zoneIds`; pass them
+// with the UTC values to TimeZoneTable::toLocalMicros() for wall-clock time.
+//
+// Null slots keep a zero value (fixed-width) or an empty range (String /
+// Binary) so the value buffers stay dense and index-aligned with rows.
+//
+// Batch::addColumns() takes a ColumnBatch of the same layout the other way
+// round, packing each column into the batch messages with one kernel per
+// column; see detail::encodeColumnBatch() for the conversions it accepts.
+
+#include "fbpp/core/message_metadata.hpp"
+#include "fbpp/core/exception.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace fbpp {
+namespace core {
+
+class Transaction;
+
+/**
+ * @brief Physical type of a decoded column
+ */
+enum class ColumnType {
+    Boolean,
+    Int16,
+    Int32,
+    Int64,
+    Int128,
+    Float,
+    Double,
+    Date,
+    Time,
+    Timestamp,
+    String,
+    Binary
+};
+
+/**
+ * @brief Map column layout to its columnar physical type
+ * @throws FirebirdException for SQL types without a columnar mapping (ARRAY)
+ */
+ColumnType columnTypeFor(const ColumnPlan& column);
+
+/**
+ * @brief Width in bytes of one fixed-width value, or 0 for String / Binary
+ */
+std::size_t columnValueWidth(ColumnType type) noexcept;
+
+/**
+ * @brief One decoded column: dense values plus a validity bitmap
+ */
+struct ColumnVector {
+    std::string name;                 // displayName() of the source field
+    ColumnType type = ColumnType::Int32;
+    unsigned sqlType = 0;             // Firebird SQL type (nullable bit stripped)
+    int scale = 0;                    // Decimal scale for integer / Int128 columns
+    std::size_t length = 0;           // Number of rows
+    std::size_t nullCount = 0;
+
+    std::vector<uint8_t> values;      // Fixed-width payload or String/Binary bytes
+    std::vector<int32_t> offsets;     // String/Binary only: length + 1 entries
+    std::vector<uint8_t> validity;    // LSB-first bitmap, (length + 7) / 8 bytes
+    std::vector<uint16_t> zoneIds;    // WITH TIME ZONE only: Firebird zone id per row (0 for NULL)
+
+    bool isNull(std::size_t row) const noexcept {
+        return (validity[row >> 3] & (1u << (row & 7))) == 0;
+    }
+
+    /**
+     * @brief Typed view over a fixed-width column
+     *
+     * T must have the column's value width (e.g. int64_t for Int64 and
+     * Timestamp, int32_t for Date, uint8_t for Boolean).
+     */
+    template<typename T>
+    std::span<const T> view() const {
+        if (sizeof(T) != columnValueWidth(type)) {
+            throw FirebirdException("ColumnVector::view: element size does not match column '" +
+                                    name + "'");
+        }
+        return {reinterpret_cast<const T*>(values.data()), length};
+    }
+
+    /**
+     * @brief Bytes of one String / Binary value (empty for NULL)
+     */
+    std::string_view stringAt(std::size_t row) const {
+        if (columnValueWidth(type) != 0) {
+            throw FirebirdException("ColumnVector::stringAt: column '" + name +
+                                    "' is not variable-width");
+        }
+        const auto begin = static_cast<std::size_t>(offsets[row]);
+        const auto end = static_cast<std::size_t>(offsets[row + 1]);
+        return {reinterpret_cast<const char*>(values.data()) + begin, end - begin};
+    }
+};
+
+/**
+ * @brief A block of rows decoded into per-column vectors
+ */
+struct ColumnBatch {
+    std::size_t rowCount = 0;
+    std::vector<ColumnVector> columns;
+
+    bool empty() const noexcept { return rowCount == 0; }
+
+    /**
+     * @brief Find a column by display name (ASCII case-insensitive)
+     * @return Pointer to the column or nullptr
+     */
+    const ColumnVector* find(std::string_view name) const noexcept;
+};
+
+/**
+ * @brief One column gathered across ColumnBatches: typed values plus validity
+ *
+ * The member type of generated columnar results (query_generator's
+ * <Query>Columns). T is the physical value type of the column (int64_t
+ * for Int64 / Time / Timestamp, int32_t for Date, uint8_t for Boolean,
+ * std::array<uint8_t, 16> for Int128) or std::string for String / Binary.
+ * NULL rows hold T{} so values stay index-aligned with rows.
+ */
+template<typename T>
+struct ColumnArray {
+    std::vector<T> values;
+    std::vector<uint8_t> validity;    // LSB-first bitmap, bit set = value present
+    std::size_t nullCount = 0;
+
+    std::size_t size() const noexcept { return values.size(); }
+
+    bool isNull(std::size_t row) const noexcept {
+        return (validity[row >> 3] & (1u << (row & 7))) == 0;
+    }
+
+    /// Append every row of `column`
+    void append(const ColumnVector& column) {
+        const std::size_t base = values.size();
+        if constexpr (std::is_same_v<T, std::string>) {
+            values.reserve(base + column.length);
+            for (std::size_t row = 0; row < column.length; ++row) {
+                values.emplace_back(column.stringAt(row));
+            }
+        } else {
+            const auto source = column.template view<T>();
+            values.insert(values.end(), source.begin(), source.end());
+        }
+
+        validity.resize((base + column.length + 7) / 8, 0);
+        if (base % 8 == 0) {
+            std::memcpy(validity.data() + base / 8, column.validity.data(),
+                        (column.length + 7) / 8);
+            if (column.length % 8 != 0) {
+                validity.back() &= static_cast<uint8_t>((1u << (column.length % 8)) - 1);
+            }
+        } else {
+            for (std::size_t row = 0; row < column.length; ++row) {
+                if (!column.isNull(row)) {
+                    validity[(base + row) >> 3] |= static_cast<uint8_t>(1u << ((base + row) & 7));
+                }
+            }
+        }
+        nullCount += column.nullCount;
+    }
+
+    void clear() noexcept {
+        values.clear();
+        validity.clear();
+        nullCount = 0;
+    }
+};
+
+/**
+ * @brief Throw unless `batch` has exactly the columns `expected`, in order
+ *
+ * Generated columnar results check each batch once before appending it.
+ */
+inline void checkColumnTypes(const ColumnBatch& batch, std::span<const ColumnType> expected,
+                             std::string_view query) {
+    bool matches = batch.columns.size() == expected.size();
+    for (std::size_t i = 0; matches && i < expected.size(); ++i) {
+        matches = batch.columns[i].type == expected[i];
+    }
+    if (!matches) {
+        throw FirebirdException("Columnar result of " + std::string(query) +
+                                ": columns differ from the generated layout; regenerate");
+    }
+}
+
+/**
+ * @brief Values of an Int16 / Int32 / Int64 column as doubles, scale applied
+ *
+ * Writes col.length values to `out` (NULL slots give 0), dividing by one
+ * precomputed factor instead of rebuilding 10^-scale per value.
+ * @throws FirebirdException for other column types
+ */
+void numericToDouble(const ColumnVector& col, double* out);
+
+/**
+ * @brief Values of an Int16 / Int32 / Int64 column as int64 at `scale`
+ *
+ * Exact fixed-point (see rescaleNumeric()): bring NUMERIC columns to a
+ * common scale and sum them as integers. Lowering the scale rounds half
+ * away from zero.
+ * @throws FirebirdException for other column types or int64 overflow
+ */
+void numericToInt64(const ColumnVector& col, int scale, int64_t* out);
+
+namespace detail {
+
+/**
+ * @brief Decode `rowCount` messages laid out `stride` bytes apart into `batch`
+ *
+ * Column-at-a-time: for each column the whole block is walked once, so the
+ * destination buffer is written sequentially. Existing ColumnVector buffers
+ * in `batch` are reused when the shape matches, keeping their capacity.
+ * `transaction` is required only for BLOB columns.
+ */
+void decodeColumnBatch(const MessageMetadata& metadata,
+                       const uint8_t* rows,
+                       std::size_t stride,
+                       std::size_t rowCount,
+                       Transaction* transaction,
+                       ColumnBatch& batch);
+
+/**
+ * @brief Throw unless every column of `batch` can be packed into `metadata`
+ *
+ * Columns map to the message fields by position and must have the type
+ * columnTypeFor() gives the field, a consistent length and buffers of
+ * that length. Integer columns are also accepted for any SMALLINT /
+ * INTEGER / BIGINT field whatever their scale, and String / Binary
+ * columns for any BLOB field.
+ */
+void checkColumnEncoding(const MessageMetadata& metadata, const ColumnBatch& batch);
+
+/**
+ * @brief Pack rows [firstRow, firstRow + rowCount) of `batch` into messages
+ *        laid out `stride` bytes apart
+ *
+ * The inverse of decodeColumnBatch(), column-at-a-time: fixed-width values
+ * are copied, dates / times go through the timestamp_utils batch kernels
+ * and integer columns are rescaled to the field's scale with
+ * rescaleNumeric() before being narrowed (range-checked) to its width.
+ * Every field, null flags included, is written. WITH TIME ZONE fields take
+ * the column's zoneIds, or "+00:00" if it has none. BLOB fields get the id
+ * `blobId` returns for each value's bytes; without it they throw.
+ * `batch` must have passed checkColumnEncoding().
+ */
+void encodeColumnBatch(const MessageMetadata& metadata,
+                       const ColumnBatch& batch,
+                       std::size_t firstRow,
+                       std::size_t rowCount,
+                       uint8_t* rows,
+                       std::size_t stride,
+                       const std::function<ISC_QUAD(std::string_view)>& blobId);
+
+} // namespace detail
+
+} // namespace core
+} // namespace fbpp
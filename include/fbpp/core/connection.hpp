@@ -1,14 +1,25 @@
 #pragma once
 
 #include "fbpp/core/environment.hpp"
+#include "fbpp/core/event_subscription.hpp"
+#include "fbpp/core/memory_usage.hpp"
 #include "fbpp/core/message_metadata.hpp"
 #include "fbpp/core/transaction.hpp"
+#include "fbpp/core/transaction_options.hpp"
 #include "fbpp/core/statement.hpp"
 #include "fbpp/core/statement_cache.hpp"
+#include "fbpp/core/transfer_tuning.hpp"
 #include "fbpp/core/named_param_parser.hpp"
+#include "fbpp/core/one_shot_message.hpp"
 #include "fbpp/core/firebird_compat.hpp"
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <memory>
+#include <optional>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 namespace fbpp {
@@ -19,9 +30,105 @@ class Transaction;
 class Statement;
 class ResultSet;
 class StatementCache;
+class TaskGroup;
+
+namespace detail {
+class EventHub;
+class DeferredRelease;
+
+inline size_t nextStatementSlot() noexcept {
+    static std::atomic<size_t> next{0};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+}
+
+/// Dense index of `Tag` for Connection::prepareStatement(key, slot),
+/// assigned process-wide on first use
+template<typename Tag>
+size_t statementSlot() noexcept {
+    static const size_t slot = detail::nextStatementSlot();
+    return slot;
+}
+
+// When the server handles of destroyed statements and unclosed cursors
+// are freed. Statement::free() and ResultSet::close() are always
+// synchronous; this covers the destructors only (cache evictions, cursors
+// dropped mid-fetch), which otherwise pay a round trip each.
+enum class HandleRelease {
+    immediate,     // In the destructor, as before
+    nextRequest,   // Queued; freed by the connection's next transaction
+                   // start, prepare, execute or cursor open
+    background     // Queued; freed by a task on Executor::shared() as well
+};
+
+// Reattaching after the attachment is lost (server restart, shutdown, a
+// network failure). Connection::reconnect() uses the attempts and backoff
+// whether or not `enabled` is set.
+struct ReconnectPolicy {
+    // Reconnect inside StartTransaction / prepareStatement / Execute /
+    // readTransaction when they, or an earlier statement execute or cursor
+    // open, fail with a lost-connection error (Connection::isConnectionLost)
+    bool enabled = false;
+    unsigned maxAttempts = 5;                        // Attaches per reconnect
+    std::chrono::milliseconds initialBackoff{100};   // Before the second; doubles
+    std::chrono::milliseconds maxBackoff{5000};
+    // Most used statement cache keys prepared again on the new attachment,
+    // most used first (0 = none); other keys are prepared on demand
+    size_t reprepareTopN = 32;
+    bool reprepareInBackground = true;               // false: inside reconnect()
+};
 
 struct ConnectionOptions {
     StatementCacheConfig statementCache;
+    // IStatement prefetch flags of prepares that do not pass their own
+    // (Statement::PREPARE_DEFAULT). The minimal profile returns the type
+    // and both message formats with the prepare itself; the plan and
+    // the rest are fetched by the first call that asks for them.
+    unsigned prepareFlags = Statement::PREPARE_PREFETCH_MINIMAL;
+    // Inline BLOB transfer limit for the attachment's statements (bytes,
+    // Firebird 5.0.3+ client and server). 0 keeps the client default;
+    // ignored where unsupported. See Statement::setMaxInlineBlobSize().
+    unsigned maxInlineBlobSize = 0;
+    // Connection::readTransaction() is refreshed with CommitRetaining after
+    // this many uses (0 = never), so its statement snapshots stay short.
+    unsigned readTransactionRefresh = 1000;
+    // Posts answered within this window of the first one reach event
+    // callbacks as one batch (0 = deliver each answer on its own).
+    std::chrono::milliseconds eventBatchWindow{10};
+    // Event names per queEvents registration; 0 = as many as one EPB holds
+    // (64 KB of names), so all subscriptions share a single registration.
+    unsigned eventNamesPerRegistration = 0;
+    HandleRelease handleRelease = HandleRelease::nextRequest;
+    ReconnectPolicy reconnect;
+    // Client bytes (MemoryUsage::clientBytes()) above which the statement
+    // cache is shrunk; checked every 64 prepares. 0 = no limit.
+    size_t memorySoftLimit = 0;
+    // BLOB read, batch chunk and prefetch sizes; see transfer_tuning.hpp
+    TransferOptions transfer;
+};
+
+// WireCrypt setting of an attachment (firebird.conf values)
+enum class WireCrypt {
+    Default,     // Client firebird.conf (Enabled unless configured)
+    Disabled,
+    Enabled,
+    Required
+};
+
+// Client-side wire protocol settings of one attachment. Sent as DPB items
+// and isc_dpb_config lines, which override the client's firebird.conf for
+// this attachment only. Zero / Default leaves a setting alone.
+struct WireOptions {
+    // WireCompression = true (zlib). Both sides need zlib and the server
+    // must not have it disabled; pays off for wide fetches over slow links.
+    bool compression = false;
+    WireCrypt crypt = WireCrypt::Default;
+    unsigned connectTimeoutSeconds = 0;   // isc_dpb_connect_timeout
+    unsigned keepAliveSeconds = 0;        // isc_dpb_dummy_packet_interval
+    // TcpRemoteBufferSize: bytes per packet (1448..32767, default 8192)
+    unsigned remoteBufferSize = 0;
+    // Extra firebird.conf lines, appended to isc_dpb_config verbatim
+    std::string config;
 };
 
 struct ConnectionParams {
@@ -31,7 +138,29 @@ struct ConnectionParams {
     std::string charset = "UTF8";
     std::string role;
     int sql_dialect = 3;  // SQL dialect (1, 2, or 3). Default: 3 (modern dialect)
+    // Providers for this attachment (firebird.conf syntax, e.g. "Engine13"
+    // for the in-process engine, "Remote", "Loopback"); empty keeps the
+    // client configuration (Remote, Engine13, Loopback).
+    std::string providers;
+    // Page cache buffers of the attachment (isc_dpb_num_buffers), 0 = database default
+    unsigned pageBuffers = 0;
+    // Workers for sweep and index creation/activation run by the attachment
+    // (isc_dpb_parallel_workers, Firebird 5), 0 = server ParallelWorkers.
+    // Capped by the server's MaxParallelWorkers.
+    unsigned parallelWorkers = 0;
+    WireOptions wire;
     ConnectionOptions options;
+
+    // Attach through the in-process engine (no server, no network hop).
+    // `database` is a local path; the engine plugin must be installed
+    // under the Firebird root directory (see Environment::setRootDirectory).
+    // Firebird 3 names the provider "Engine12".
+    static ConnectionParams embedded(std::string database, std::string provider = "Engine13") {
+        ConnectionParams params;
+        params.database = std::move(database);
+        params.providers = std::move(provider);
+        return params;
+    }
 };
 
 // Procedure metadata exposed by Connection::listProcedures /
@@ -99,12 +228,45 @@ public:
     static void dropDatabase(const ConnectionParams& params);
     static bool databaseExists(const std::string& database, const ConnectionParams& params = {});
 
+    // Attach on a worker of Executor::shared(). The future rethrows the
+    // attach error. The connection is thread-affine only while in use: hand
+    // it to the thread that will use it once the future is ready.
+    static std::future<std::unique_ptr<Connection>> connectAsync(ConnectionParams params);
+
+    // Open `count` attachments concurrently, at most `parallelism` at a time
+    // (0 = all at once), so startup costs about one attach round trip
+    // instead of `count`. All or nothing: if any attach fails, the opened
+    // ones are closed and the first error is rethrown.
+    static std::vector<std::unique_ptr<Connection>> connectMany(const ConnectionParams& params,
+                                                                size_t count,
+                                                                size_t parallelism = 0);
+
     // Execute SQL and return transaction (for quick operations)
     std::shared_ptr<Transaction> Execute(const std::string& sql);
 
     // Start a new transaction
     std::shared_ptr<Transaction> StartTransaction();
 
+    // Start a transaction with explicit isolation / access / lock
+    // resolution. The TPB is built once per distinct options value and
+    // reused by later calls on this connection. Throws before contacting
+    // the server on conflicting options (lock timeout with NO WAIT).
+    std::shared_ptr<Transaction> StartTransaction(const TransactionOptions& options);
+
+    // Take over a transaction left in limbo by a two-phase commit (see
+    // Transaction::Prepare), to Commit() or Rollback() it
+    std::shared_ptr<Transaction> reconnectTransaction(uint64_t id);
+
+    // Long-lived read-only READ COMMITTED transaction for autocommit-style
+    // reads, started on first use and shared by every caller on this
+    // connection: a point lookup costs its open/fetch only, with no start
+    // and commit of its own.
+    //   auto rs = conn.readTransaction()->openCursor(stmt, params);
+    // READ CONSISTENCY on Firebird 4+, RECORD_VERSION before. Do not
+    // Commit() or Rollback() it (it is restarted if that happens); write
+    // through a transaction of your own.
+    std::shared_ptr<Transaction> readTransaction();
+
     // Execute SQL in existing transaction
     void ExecuteInTransaction(Transaction* tra, const std::string& sql);
 
@@ -112,7 +274,27 @@ public:
     void ExecuteDDL(const std::string& ddl);
 
     // Prepare statement with cache (returns shared_ptr for shared ownership)
-    std::shared_ptr<Statement> prepareStatement(const std::string& sql, unsigned flags = 0);
+    std::shared_ptr<Statement> prepareStatement(const std::string& sql,
+                                                unsigned flags = Statement::PREPARE_DEFAULT);
+
+    // Same, for a key built once by the caller: repeat calls skip SQL
+    // normalization and hashing entirely.
+    std::shared_ptr<Statement> prepareStatement(const SqlKey& key);
+
+    // Same, remembered in `slot` (statementSlot<T>(), one per query
+    // descriptor type): while nobody else holds the statement last prepared
+    // there, it is handed out again straight from an array, with no cache
+    // lookup. A slot must always be used with the same key. With the cache
+    // disabled this is prepareStatement(key).
+    std::shared_ptr<Statement> prepareStatement(const SqlKey& key, size_t slot);
+
+    // Same cache, checked out as a move-only StatementLease: a hit allocates
+    // nothing, and the instance returns to the pool when the lease ends.
+    // Hot paths that execute in place; a cursor opened from a lease keeps
+    // its instance out of the pool (see StatementLease).
+    StatementLease leaseStatement(const std::string& sql,
+                                  unsigned flags = Statement::PREPARE_DEFAULT);
+    StatementLease leaseStatement(const SqlKey& key);
 
     // Prepare a one-off statement without consulting or populating the
     // statement cache. Use when scanning many SQLs for metadata only —
@@ -122,14 +304,85 @@ public:
     // goes out of scope.
     std::shared_ptr<Statement> prepareStatementUncached(
         const std::string& sql,
-        unsigned flags = Statement::PREPARE_PREFETCH_ALL);
+        unsigned flags = Statement::PREPARE_DEFAULT);
+
+    // Run `sql` once through IAttachment::execute / openCursor: no prepare
+    // round trip and no statement cache entry, for DDL, maintenance and
+    // dynamic reports that are not repeated. Parameters (a tuple, or JSON
+    // as an array or by name) travel in a message described from the
+    // values themselves (see one_shot_message.hpp); the server converts
+    // them to the statement's parameter types. The affected-row count is
+    // not available without a statement. Repeated SQL belongs in
+    // prepareStatement().
+    void executeOnce(Transaction* transaction, const std::string& sql);
+
+    template<typename InParams>
+    void executeOnce(Transaction* transaction, const std::string& sql, const InParams& params);
+
+    std::unique_ptr<ResultSet> openCursorOnce(const std::shared_ptr<Transaction>& transaction,
+                                              const std::string& sql);
+
+    template<typename InParams>
+    std::unique_ptr<ResultSet> openCursorOnce(const std::shared_ptr<Transaction>& transaction,
+                                              const std::string& sql,
+                                              const InParams& params);
+
+    // IStatement::prepare() flags for a requested set: PREPARE_DEFAULT
+    // resolves to ConnectionOptions::prepareFlags
+    unsigned prepareFlags(unsigned flags) const noexcept {
+        if (flags == Statement::PREPARE_DEFAULT) {
+            flags = options_.prepareFlags;
+        }
+        return flags & ~static_cast<unsigned>(Statement::PREPARE_DEFAULT);
+    }
 
     // Clear all cached statements
     void clearStatementCache();
 
+    // Free the handles queued by ConnectionOptions::handleRelease now;
+    // returns how many. The request paths call this themselves.
+    size_t releaseDeferredHandles();
+    // Handles freed through the queue since the connection was opened
+    uint64_t deferredHandlesReleased() const;
+    // The queue, for Statement / ResultSet destructors; they hold it weakly
+    // as they may outlive the connection
+    const std::shared_ptr<detail::DeferredRelease>& deferredRelease() const { return releases_; }
+
     // Get cache statistics
     StatementCache::Statistics getCacheStatistics() const;
 
+    // Per-statement metrics (StatementCacheConfig::collectMetrics), most
+    // total server time first; empty while not collected. limit 0 = all.
+    std::vector<StatementMetricsSnapshot> getStatementMetrics(size_t limit = 0) const;
+
+    // The same, one trace message per statement
+    void traceStatementMetrics(fbpp::util::TraceLevel level = fbpp::util::TraceLevel::info,
+                               size_t limit = 0) const;
+
+    // Client memory of this connection (statement cache estimate, live
+    // cursors, batches and arenas) and, with `includeServer`, the
+    // database's memory on the server (one getInfo round trip; left empty
+    // if the server does not answer). See memory_usage.hpp.
+    MemoryUsage memoryUsage(bool includeServer = true) const;
+
+    // Account the result sets and batches of this connection charge
+    const std::shared_ptr<detail::MemoryAccount>& memoryAccount() const { return memory_; }
+
+    // The attachment's page and per-table record counters, as of now (one
+    // getInfo round trip). Take two readings and ServerCounters::delta()
+    // for the work in between; StatementCacheConfig::captureServerCounters
+    // does that around every cached statement's execute and cursor.
+    ServerCounters getServerCounters() const;
+
+    // Export the statement cache's most used keys for the warm-up of later
+    // connections (StatementCacheConfig::warmupFile). limit 0 = all.
+    void saveStatementHotSet(const std::string& path, size_t limit = 0) const;
+
+    // Block until the statement warm-up started by the constructor has
+    // finished. Pools call this before handing the connection out; until
+    // then statements not yet warmed are simply prepared on demand.
+    void waitForWarmup();
+
     // Configure runtime connection behavior
     void setOptions(const ConnectionOptions& options);
     const ConnectionOptions& getOptions() const { return options_; }
@@ -141,9 +394,49 @@ public:
     // Check if connected
     bool isConnected() const;
 
+    // True if `error` means the attachment is gone: a network error, a
+    // lost or shut down connection, an invalid attachment handle (any GDS
+    // code in the status vector)
+    static bool isConnectionLost(const FirebirdException& error);
+
+    // True if `error` means the schema changed under a prepared statement:
+    // an unsuccessful metadata update, an object in use, or a table,
+    // column or procedure that no longer exists
+    static bool isMetadataChanged(const FirebirdException& error);
+
+    // Drop the attachment and attach again with the constructor's
+    // parameters, up to ReconnectPolicy::maxAttempts times on
+    // lost-connection errors, backing off in between; any other attach
+    // error is thrown at once. Transactions, cursors and event
+    // subscriptions of the old attachment are gone. The statement cache is
+    // emptied and its reprepareTopN most used keys prepared again (on the
+    // warm-up task: see waitForWarmup()); Statements handed out before
+    // prepare themselves again on their next execute or cursor open.
+    // Throws the last attach error and stays disconnected if every attempt
+    // fails; with the policy enabled the next request tries again.
+    void reconnect();
+
+    // Incremented by every successful reconnect(); a Statement prepared
+    // under an older value re-prepares before its next use
+    uint64_t generation() const noexcept { return generation_.load(std::memory_order_acquire); }
+
     // Cancel operations on this attachment
     void cancelOperation(CancelOperation option);
 
+    // Subscribe to database events (POST_EVENT). All subscriptions of this
+    // connection share one queEvents registration and one dispatcher
+    // thread, which runs the callback; see event_subscription.hpp. The
+    // handle cancels on destruction and stops delivering with the
+    // connection.
+    std::unique_ptr<EventSubscription> subscribeEvents(std::vector<std::string> names,
+                                                       EventSubscription::Callback callback);
+
+    // Same, with every name posted within one batch window in one call
+    std::unique_ptr<EventSubscription> subscribeEventBatches(std::vector<std::string> names,
+                                                             EventSubscription::BatchCallback callback);
+
+    EventStatistics getEventStatistics() const;
+
     // Major version of the attached Firebird engine (3, 4, 5, ...). Cached
     // after the first call. Use to gate access to FB4+-only types
     // (INT128, DECFLOAT, TIMESTAMP/TIME WITH TIME ZONE) — those types
@@ -151,9 +444,23 @@ public:
     // surfaces an opaque "unsupported SQL type" error otherwise.
     int getEngineMajorVersion() const;
 
+    // Page size, ODS, server version, wire protocol and its compression /
+    // encryption, as the attachment reports them (one getInfo round trip)
+    DatabaseInfo getDatabaseInfo() const;
+
+    // Transfer sizes of this attachment: ConnectionOptions::transfer over
+    // figures chosen from getDatabaseInfo(), which is asked once per attach
+    // (on first use). Applied by openBlob(), createBatch() and openCursor().
+    const TransferTuning& transferTuning() const;
+
     // Get attachment
     Firebird::IAttachment* getAttachment() const { return attachment_; }
 
+    // Identity of the metadata this connection sees: database, connection
+    // charset and dialect. Connections with equal scopes share statement
+    // templates (StatementCacheConfig::sharedTemplates).
+    const std::string& getTemplateScope() const { return templateScope_; }
+
     struct QueryMetadataInfo {
         std::vector<FieldInfo> inputFields;
         std::vector<FieldInfo> outputFields;
@@ -182,28 +489,157 @@ public:
     Connection& operator=(const Connection&) = delete;
 
 private:
+    friend class Statement;   // noteRequestFailure(), noteSchemaError()
+
     // Internal helper to get a ready-to-use ThrowStatusWrapper
     Firebird::ThrowStatusWrapper& status() const {
         statusWrapper_.init();
         return statusWrapper_;
     }
 
+    // The non-template halves of executeOnce() / openCursorOnce(); `input`
+    // null for no parameters
+    void executeOnceMessage(Transaction* transaction, const std::string& sql,
+                            const MessageMetadata* input, const uint8_t* buffer);
+    std::unique_ptr<ResultSet> openCursorOnceMessage(const std::shared_ptr<Transaction>& transaction,
+                                                     const std::string& sql,
+                                                     const MessageMetadata* input,
+                                                     const uint8_t* buffer);
+    // Positional SQL and input message of a one-shot statement, packed
+    // into `buffer`
+    template<typename InParams>
+    std::pair<std::string, std::unique_ptr<MessageMetadata>> packOnce(
+        Transaction* transaction, const std::string& sql, const InParams& params,
+        std::vector<uint8_t>& buffer);
+
     void connect(const ConnectionParams& params);
     void disconnect();
+    // reconnect() first if a lost connection was seen and the policy is on
+    void reconnectIfLost();
+    // fn(); once more after a reconnect if it failed with a lost connection
+    template<typename Fn>
+    auto withReconnect(Fn&& fn) -> decltype(fn());
+    // A request of a Statement failed: remember a lost connection
+    void noteRequestFailure(const FirebirdException& error) noexcept;
+    // A prepared statement failed: publish a schema change on a metadata
+    // error, unless it comes from a change not applied here yet
+    void noteSchemaError(const FirebirdException& error) noexcept;
+    // Apply schema changes published since the last prepare
+    void syncSchema();
+    // Empty the statement cache for schema epoch `epoch`, preparing its
+    // hottest keys again in the background
+    void invalidateStatements(uint64_t epoch);
+    void startWarmup();
+    // Prepare `entries` into the cache, on Executor::shared() if `background`
+    void startWarmupThread(std::vector<StatementCache::HotEntry> entries, bool background);
+    void applyHandleRelease();
+    // Shrink the statement cache if over ConnectionOptions::memorySoftLimit
+    void checkMemoryLimit();
+    // Forget the statements of prepareStatement(key, slot); wherever the
+    // statement cache is cleared
+    void dropStatementSlots() noexcept { statementSlots_.clear(); }
+    const std::vector<unsigned char>& transactionParameters(const TransactionOptions& options);
 
     Firebird::IAttachment* attachment_ = nullptr;
     Environment& env_;
+    ConnectionParams params_;                      // Of the last attach, for reconnect()
     // Each connection owns its status wrapper and keeps it thread-local by contract.
     Firebird::IStatus* status_;                    // created from master, disposed in destructor
     mutable Firebird::ThrowStatusWrapper statusWrapper_{nullptr};
     ConnectionOptions options_{};
+    std::string templateScope_;
 
     // Statement cache (lazy initialized)
     mutable std::unique_ptr<StatementCache> statementCache_;
+    // By statementSlot<T>(): the statement last prepared for that slot
+    std::vector<std::shared_ptr<Statement>> statementSlots_;
+
+    // Background warm-up, a task on Executor::shared(); only touches
+    // statementCache_ (created before it starts) and the attachment,
+    // through statuses of its own.
+    std::unique_ptr<TaskGroup> warmup_;
+    std::atomic<bool> warmupCancel_{false};
+
+    std::atomic<uint64_t> generation_{0};   // Successful reconnects
+    std::atomic<bool> lost_{false};          // A lost-connection error was seen
+    // StatementTemplateRegistry::schemaChanges() at the last check, and the
+    // schemaEpoch(templateScope_) the statement cache was filled under
+    uint64_t schemaChanges_ = 0;
+    uint64_t schemaEpoch_ = 0;
+
+    // Built TPBs by options value; a connection sees few distinct values.
+    std::vector<std::pair<TransactionOptions, std::vector<unsigned char>>> tpbCache_;
+
+    std::shared_ptr<Transaction> readTransaction_;   // Lazy, see readTransaction()
+    unsigned readTransactionUses_ = 0;
 
     // Cached engine version (lazy on first getEngineMajorVersion()).
     mutable int engineMajor_ = 0;
+
+    // Lazy, see transferTuning(); both reset by every attach, the tuning
+    // by setOptions() as well
+    mutable std::optional<DatabaseInfo> databaseInfo_;
+    mutable std::optional<TransferTuning> tuning_;
+
+    // Event multiplexer, created by the first subscription; shared with
+    // the subscription handles, which may outlive the connection.
+    std::shared_ptr<detail::EventHub> events_;
+
+    // Handles whose release was deferred (ConnectionOptions::handleRelease)
+    std::shared_ptr<detail::DeferredRelease> releases_;
+
+    // Memory accounting (see memoryUsage())
+    std::shared_ptr<detail::MemoryAccount> memory_ = std::make_shared<detail::MemoryAccount>();
+    unsigned memoryCheckCountdown_ = 0;
+    size_t softLimitShrinks_ = 0;
 };
 
+template<typename InParams>
+std::pair<std::string, std::unique_ptr<MessageMetadata>> Connection::packOnce(
+    Transaction* transaction, const std::string& sql, const InParams& params,
+    std::vector<uint8_t>& buffer) {
+    const auto parsed = NamedParamParser::parseCached(sql);
+    std::string actualSql = parsed->hasNamedParams ? parsed->convertedSql : sql;
+
+    std::unique_ptr<MessageMetadata> input;
+    if constexpr (is_json_v<InParams>) {
+        if (params.is_object() && !parsed->hasNamedParams) {
+            throw FirebirdException(
+                "executeOnce: JSON object parameters need named parameters in the SQL");
+        }
+        const nlohmann::json positional = NamedParamHelper::convertToPositional(
+            params, parsed->nameToPositions,
+            static_cast<unsigned>(params.is_array() ? params.size() : parsed->parameters.size()));
+        input = detail::oneShotInput(positional);
+        buffer.assign(input->getMessageLength(), 0);
+        pack(positional, buffer.data(), input.get(), transaction);
+    } else if constexpr (is_tuple_v<InParams>) {
+        input = detail::oneShotInput(params);
+        buffer.assign(input->getMessageLength(), 0);
+        pack(params, buffer.data(), input.get(), transaction);
+    } else {
+        static_assert(detail::dependent_false_v<InParams>,
+                      "One-shot statements take a tuple or JSON parameters");
+    }
+    return {std::move(actualSql), std::move(input)};
+}
+
+template<typename InParams>
+void Connection::executeOnce(Transaction* transaction, const std::string& sql,
+                             const InParams& params) {
+    std::vector<uint8_t> buffer;
+    auto [actualSql, input] = packOnce(transaction, sql, params, buffer);
+    executeOnceMessage(transaction, actualSql, input.get(), buffer.data());
+}
+
+template<typename InParams>
+std::unique_ptr<ResultSet> Connection::openCursorOnce(
+    const std::shared_ptr<Transaction>& transaction, const std::string& sql,
+    const InParams& params) {
+    std::vector<uint8_t> buffer;
+    auto [actualSql, input] = packOnce(transaction.get(), sql, params, buffer);
+    return openCursorOnceMessage(transaction, actualSql, input.get(), buffer.data());
+}
+
 } // namespace core
 } // namespace fbpp
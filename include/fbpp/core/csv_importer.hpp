@@ -0,0 +1,118 @@
+#pragma once
+
+// CsvImporter — CSV / TSV files straight into Batch messages.
+//
+// The input (a file, mapped read-only where the platform allows, or text
+// already in memory) is cut into segments of about segmentBytes at record
+// boundaries; quote parity decides where a record ends, so quoted fields
+// may hold separators and line breaks. Worker threads parse segments into
+// packed messages laid out for the statement's input metadata; the
+// calling thread hands finished segments, in input order, to Batch and
+// executes a batch whenever it reaches loader.flushBytes, as BulkLoader
+// does. All server calls stay on the calling thread.
+//
+//   auto stmt = conn->prepareStatement("INSERT INTO t (id, amount) VALUES (?, ?)");
+//   CsvImporter importer(stmt, tx, {.header = true});
+//   auto result = importer.importFile("/data/t.csv");
+//   // result.lineErrors, result.batch, result.rowsPerSecond()
+//
+// Fields map to the statement's parameters in order. Values are parsed as
+// the codec parses strings (INT128, DECFLOAT and scaled NUMERIC keep their
+// exact text); integers, floating point, booleans and text take a direct
+// path. A TIMESTAMP may use ' ' instead of 'T' between date and time.
+// BLOB parameters are not supported.
+//
+// Lines that do not parse (wrong field count, bad values, unterminated
+// quotes) are skipped and reported with their 1-based line number; the
+// import stops once more than maxLineErrors lines failed. Server-side row
+// errors land in the merged BatchResult, whose message indexes count the
+// accepted rows.
+
+#include "fbpp/core/batch.hpp"
+#include "fbpp/core/bulk_loader.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fbpp::core {
+
+class Statement;
+class Transaction;
+
+/**
+ * @brief Format and threading of a CsvImporter
+ */
+struct CsvImportOptions {
+    char delimiter = ',';          // '\t' for TSV
+    char quote = '"';              // RFC 4180 quoting; '\0' disables it
+    bool header = false;           // First record holds column names
+    std::string nullText;          // Unquoted field equal to this -> NULL
+    unsigned threads = 0;          // Parser threads; 0 = hardware concurrency
+    size_t segmentBytes = 4 * 1024 * 1024;   // Input per parse task
+    size_t maxLineErrors = 1000;   // Stop once more lines than this fail
+    BulkLoaderOptions loader;      // Flush / commit policy (pipelined unused)
+};
+
+/**
+ * @brief A record that could not be packed
+ */
+struct CsvLineError {
+    size_t line = 0;       // 1-based physical line where the record starts
+    std::string message;
+};
+
+/**
+ * @brief Outcome and throughput of one import
+ */
+struct CsvImportResult {
+    size_t records = 0;          // Records read, header and blank lines excluded
+    size_t rowsAdded = 0;        // Records packed and handed to batches
+    uint64_t bytes = 0;          // Input size
+    double seconds = 0.0;        // Wall time of the whole import
+    unsigned flushes = 0;        // Batches executed
+    std::vector<CsvLineError> lineErrors;
+    BatchResult batch;           // Merged server results of all batches
+
+    double rowsPerSecond() const { return seconds > 0 ? rowsAdded / seconds : 0.0; }
+    double megabytesPerSecond() const {
+        return seconds > 0 ? static_cast<double>(bytes) / (1024.0 * 1024.0) / seconds : 0.0;
+    }
+};
+
+class CsvImporter {
+public:
+    /**
+     * @throws FirebirdException for an invalid statement or transaction,
+     *         a statement without parameters or with BLOB parameters
+     */
+    CsvImporter(std::shared_ptr<Statement> statement,
+                std::shared_ptr<Transaction> transaction,
+                CsvImportOptions options = {});
+
+    /**
+     * @brief Import a file (memory-mapped on POSIX)
+     *
+     * The transaction is left open: committing is the caller's decision.
+     * @throws FirebirdException when the file cannot be read, too many
+     *         lines fail or a batch cannot be executed
+     */
+    CsvImportResult importFile(const std::string& path);
+
+    /**
+     * @brief Import text already in memory
+     */
+    CsvImportResult importText(std::string_view text);
+
+    const CsvImportOptions& options() const { return options_; }
+
+private:
+    std::shared_ptr<Statement> statement_;
+    std::shared_ptr<Transaction> transaction_;
+    CsvImportOptions options_;
+};
+
+} // namespace fbpp::core
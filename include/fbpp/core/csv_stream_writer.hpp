@@ -0,0 +1,119 @@
+#pragma once
+
+// Streaming CSV / TSV serialization of fetched rows.
+//
+// CsvStreamWriter formats each row straight from the message buffer into
+// a reusable chunk handed to a sink whenever it fills, like
+// JsonStreamWriter. Numbers use std::to_chars; NUMERIC/DECIMAL, INT128,
+// DECFLOAT and date/time types use the codec's (and JsonUnpacker's) text.
+// Fields are quoted per RFC 4180 only when they hold the delimiter, the
+// quote or a line break, found with the SIMD scan of text_scan.hpp.
+//
+// With CsvWriteOptions::background the sink runs on a writer thread: a
+// full chunk is swapped for an empty one and the fetch loop carries on
+// while the previous chunk is written.
+
+#include "fbpp/core/message_metadata.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace fbpp::core {
+
+class Transaction;
+
+/**
+ * @brief Format and buffering of a CsvStreamWriter
+ */
+struct CsvWriteOptions {
+    char delimiter = ',';              // '\t' for TSV
+    char quote = '"';                  // '\0' never quotes (plain TSV)
+    bool header = true;                // Column display names first
+    std::string nullText;              // Written for NULL
+    std::string lineEnd = "\r\n";      // RFC 4180; "\n" for Unix tools
+    std::size_t chunkBytes = 1024 * 1024;
+    bool background = false;           // Run the sink on a writer thread
+};
+
+/**
+ * @brief Writes rows as CSV records, chunk by chunk, into a sink
+ *
+ * Call writeRow() per row (ResultSet::writeCsv() does this for a cursor)
+ * and finish() once. The sink receives chunks of about chunkBytes and
+ * must consume them before returning; in background mode it is called
+ * from the writer thread, one chunk at a time.
+ */
+class CsvStreamWriter {
+public:
+    using Sink = std::function<void(std::string_view)>;
+
+    explicit CsvStreamWriter(Sink sink, CsvWriteOptions options = {});
+
+    /// Sink writing into `out`; the stream must outlive the writer
+    explicit CsvStreamWriter(std::ostream& out, CsvWriteOptions options = {});
+
+    /// Stops the writer thread; rows not flushed by finish() are dropped
+    ~CsvStreamWriter();
+
+    CsvStreamWriter(const CsvStreamWriter&) = delete;
+    CsvStreamWriter& operator=(const CsvStreamWriter&) = delete;
+
+    /**
+     * @brief Write the header record now (once; no-op if disabled)
+     *
+     * writeRow() does this on the first row; call it directly so an
+     * empty result still gets its header.
+     */
+    void writeHeader(const MessageMetadata& metadata);
+
+    /**
+     * @brief Append one row decoded from `buffer`
+     * @param transaction Needed to load BLOB columns
+     * @throws FirebirdException after finish(), for an unsupported type,
+     *         or with the error of a failed background sink call
+     */
+    void writeRow(const uint8_t* buffer, const MessageMetadata& metadata,
+                  Transaction* transaction = nullptr);
+
+    /**
+     * @brief Flush, wait for the sink and stop the writer thread
+     */
+    void finish();
+
+    std::size_t rowCount() const noexcept { return rows_; }
+    bool finished() const noexcept { return finished_; }
+
+private:
+    void writeValue(const ColumnPlan& column, const uint8_t* buffer, Transaction* transaction);
+    void writeField(std::string_view text);
+    void flush();
+    void drain();
+    void run();
+
+    Sink sink_;
+    CsvWriteOptions options_;
+    std::string out_;       // Chunk being filled
+    std::string scratch_;   // Codec text for string-mapped types; capacity reused
+    std::size_t rows_ = 0;
+    bool headerWritten_ = false;
+    bool finished_ = false;
+
+    // Background mode: one chunk in flight on thread_
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::string pending_;
+    bool hasPending_ = false;
+    bool stop_ = false;
+    std::exception_ptr error_;
+};
+
+} // namespace fbpp::core
@@ -0,0 +1,116 @@
+#pragma once
+
+// End-to-end time budget of one request.
+//
+// A DeadlineScope makes a deadline ambient on the calling thread; every
+// blocking step of the library under it spends from the same budget
+// instead of each having a timeout of its own:
+//
+//   {
+//       DeadlineScope budget(std::chrono::milliseconds(200));
+//       auto conn = pool.acquire();                   // waits at most the budget
+//       auto stmt = conn->prepareStatement(sql);      // cache miss: prepare bounded
+//       auto rs = tx->openCursor(stmt, params);       // statement timeout = remaining
+//       while (rs->fetch(row)) { ... }                // checked between rows
+//   }
+//
+//   - ConnectionPool::acquire() waits until the earlier of its own timeout
+//     and the deadline.
+//   - StatementCache prepares and single-flight waits stop at the deadline.
+//   - Statement execute / openCursor set the statement timeout to the
+//     remaining time on Firebird 4+ (the server timer also covers the
+//     cursor's fetches) and arm a CancelScope around the call on older
+//     servers, where fetches are only checked between rows.
+//   - ResultSet fetches and Transaction::loadBlob() check it; loadBlob runs
+//     under a CancelScope.
+//
+// Once the budget is gone the step throws FirebirdException: "Deadline
+// exceeded: <step>" before a call, isc_cancelled after cancelOperation()
+// or a statement timeout during one. Deadline::isExceeded() recognises
+// all of them, so an overloaded service can shed the request at once
+// instead of queueing it behind the ones already late.
+
+#include "fbpp/core/exception.hpp"
+
+#include <chrono>
+#include <cstdint>
+
+namespace fbpp {
+namespace core {
+
+/**
+ * @brief A point in time a request must finish by
+ */
+class Deadline {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit Deadline(Clock::time_point at) : at_(at) {}
+
+    static Deadline after(std::chrono::milliseconds budget) {
+        return Deadline(Clock::now() + budget);
+    }
+
+    Clock::time_point at() const { return at_; }
+    bool expired() const { return Clock::now() >= at_; }
+
+    /// Time left, rounded up to whole milliseconds; 0 once expired
+    std::chrono::milliseconds remaining() const;
+
+    /// Throws FirebirdException("Deadline exceeded: <stage>") once expired
+    void check(const char* stage) const;
+
+    /// Deadline of the innermost DeadlineScope on this thread, nullptr if none
+    static const Deadline* current() noexcept;
+
+    /// Failure caused by a deadline: ours, a cancel or a statement timeout
+    static bool isExceeded(const FirebirdException& error);
+
+private:
+    Clock::time_point at_;
+};
+
+/**
+ * @brief Makes a deadline ambient on this thread for the scope's lifetime
+ *
+ * Scopes nest; an inner scope never extends the outer budget, the earlier
+ * deadline wins. Not copyable or movable; destroy in reverse order of
+ * construction (as automatic variables are).
+ */
+class DeadlineScope {
+public:
+    explicit DeadlineScope(Deadline deadline);
+    explicit DeadlineScope(std::chrono::milliseconds budget)
+        : DeadlineScope(Deadline::after(budget)) {}
+    ~DeadlineScope();
+
+    DeadlineScope(const DeadlineScope&) = delete;
+    DeadlineScope& operator=(const DeadlineScope&) = delete;
+
+    const Deadline& deadline() const { return deadline_; }
+
+    /**
+     * @brief Lifts the ambient deadline for the scope's lifetime
+     *
+     * For internal work that must not fail with the request it runs on
+     * behalf of (e.g. the one-off engine version probe).
+     */
+    class Suspend {
+    public:
+        Suspend() noexcept;
+        ~Suspend();
+
+        Suspend(const Suspend&) = delete;
+        Suspend& operator=(const Suspend&) = delete;
+
+    private:
+        const Deadline* previous_;
+    };
+
+private:
+    Deadline deadline_;
+    const Deadline* previous_;
+};
+
+} // namespace core
+} // namespace fbpp
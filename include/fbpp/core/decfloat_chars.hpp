@@ -0,0 +1,42 @@
+#pragma once
+
+#include "fbpp/core/extended_types.hpp"
+
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace fbpp::core {
+
+/**
+ * @brief DECFLOAT(16/34) conversions without IUtil / IDecFloat calls
+ *
+ * Firebird stores DECFLOAT as IEEE 754-2008 decimal64 / decimal128 in DPD
+ * encoding, the same layout as decNumber's decDouble / decQuad that the
+ * vendored cppdecimal provides. These functions run decNumber directly on
+ * the wire bytes: the text matches IDecFloat16/34::toString, parsing uses
+ * Firebird's default context (round half up, error on syntax / overflow).
+ */
+
+/// Longest toChars() output (sign, 16/34 digits, point, exponent)
+constexpr std::size_t kDecFloat16MaxChars = 24;
+constexpr std::size_t kDecFloat34MaxChars = 42;
+
+std::to_chars_result toChars(char* first, char* last, const DecFloat16& value) noexcept;
+std::to_chars_result toChars(char* first, char* last, const DecFloat34& value) noexcept;
+
+/// Parse decimal text ("1.25", "-3E+5", "Infinity", "NaN"); throws FirebirdException
+DecFloat16 decFloat16FromString(std::string_view text);
+DecFloat34 decFloat34FromString(std::string_view text);
+
+/// Nearest double (via the shortest exact text, correctly rounded)
+double toDouble(const DecFloat16& value);
+double toDouble(const DecFloat34& value);
+
+/// From the shortest text that reads back as `value` (0.1 -> "0.1"), the
+/// same digits a double bound to a DECFLOAT parameter gets
+DecFloat16 decFloat16FromDouble(double value);
+DecFloat34 decFloat34FromDouble(double value);
+
+} // namespace fbpp::core
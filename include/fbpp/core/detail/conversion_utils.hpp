@@ -2,12 +2,16 @@
 
 #include "fbpp/core/exception.hpp"
 #include <string>
+#include <string_view>
+#include <charconv>
+#include <cstddef>
 #include <cstdint>
 #include <cmath>
 #include <algorithm>
 #include <cstdio>
 #include <cctype>
 #include <limits>
+#include <system_error>
 
 namespace fbpp::core::detail {
 
@@ -84,27 +88,75 @@ inline int64_t string_to_decimal_i64(const std::string& str, int scaleNeg /* <0
 }
 
 inline std::string decimal_to_string_i64(int64_t v, int scaleNeg /* <0 */) {
-    const uint32_t s = static_cast<uint32_t>(-scaleNeg); // число знаков после точки
-    bool neg = v < 0;
-    uint64_t u = neg ? uint64_t(-(v + 1)) + 1 : uint64_t(v); // модуль без UB
+    const uint32_t s = static_cast<uint32_t>(-scaleNeg); // number of fraction digits
+    if (s >= 19) throw FirebirdException("Scale too large");
+    const bool neg = v < 0;
+    const uint64_t u = neg ? uint64_t(-(v + 1)) + 1 : uint64_t(v); // magnitude without UB
 
-    static const uint64_t POW10[19] = {1ull,10ull,100ull,1000ull,10000ull,100000ull,1000000ull,10000000ull,100000000ull,1000000000ull,
-        10000000000ull,100000000000ull,1000000000000ull,10000000000000ull,100000000000000ull,1000000000000000ull,10000000000000000ull,
-        100000000000000000ull,1000000000000000000ull};
+    // Digits of the magnitude, left-padded to at least s + 1 so there is
+    // an integer digit, then the point inserted s digits from the right
+    char digits[24];
+    const auto result = std::to_chars(digits, digits + sizeof(digits), u);
+    const size_t count = static_cast<size_t>(result.ptr - digits);
+    const size_t padded = std::max<size_t>(count, s + 1);
 
-    if (s >= 19) throw FirebirdException("Scale too large");
-    uint64_t p = POW10[s];
-    uint64_t hi = u / p, lo = u % p;
+    char text[48];
+    char* out = text;
+    if (neg) *out++ = '-';
+    out = std::fill_n(out, padded - count, '0');
+    out = std::copy(digits, result.ptr, out);
+    if (s) {
+        std::copy_backward(out - s, out, out + 1);
+        *(out - s) = '.';
+        ++out;
+    }
+    return std::string(text, out);
+}
+
+// Longest std::to_chars text of an integer or of the shortest round-trip
+// float/double ("-2.2250738585072014e-308")
+constexpr size_t kNumberMaxChars = 32;
 
-    char frac[32];
-    std::snprintf(frac, sizeof frac, "%0*llu", int(s), (unsigned long long)lo);
+// Decimal text of an integer, or the shortest text that parses back to the
+// same float/double ("0.1", "1e+20"); locale independent. Assigned into
+// `out` so a reused string keeps its capacity.
+template<typename Number>
+void assign_number(std::string& out, Number value) {
+    char buffer[kNumberMaxChars];
+    out.assign(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value).ptr);
+}
 
-    std::string out = std::to_string(hi);
-    if (s) { out.push_back('.'); out += frac; }
-    if (neg) out.insert(out.begin(), '-');
+template<typename Number>
+std::string number_to_string(Number value) {
+    std::string out;
+    assign_number(out, value);
     return out;
 }
 
+// Parse a FLOAT / DOUBLE PRECISION value: surrounding blanks and a leading
+// '+' are allowed, anything else after the number is an error; "inf" and
+// "nan" are accepted as std::from_chars does
+template<typename Float>
+Float string_to_floating(std::string_view text, const char* sqlTypeName) {
+    const char* first = text.data();
+    const char* last = first + text.size();
+    while (first != last && std::isspace(static_cast<unsigned char>(*first))) ++first;
+    while (last != first && std::isspace(static_cast<unsigned char>(*(last - 1)))) --last;
+    if (last - first > 1 && *first == '+' && first[1] != '-') ++first;
+
+    Float value{};
+    const auto result = std::from_chars(first, last, value);
+    if (result.ec == std::errc::result_out_of_range) {
+        throw FirebirdException(std::string("Value out of range for ") + sqlTypeName + ": " +
+                                std::string(text));
+    }
+    if (result.ec != std::errc{} || result.ptr != last || first == last) {
+        throw FirebirdException(std::string("Invalid ") + sqlTypeName + " value: '" +
+                                std::string(text) + "'");
+    }
+    return value;
+}
+
 // Helper to parse ISO date string "YYYY-MM-DD"
 inline void parseIsoDate(const std::string& str, unsigned& year, unsigned& month, unsigned& day) {
     if (str.length() < 10 || str[4] != '-' || str[7] != '-') {
@@ -0,0 +1,75 @@
+#pragma once
+
+// Per-connection queue of server handles whose release was taken off the
+// caller's path: statements destroyed by a cache eviction (or dropped by
+// their last owner) and cursors destroyed without close(). See
+// ConnectionOptions::handleRelease for when the queue is drained.
+
+#include "fbpp/core/firebird_compat.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace fbpp::core::detail {
+
+class DeferredRelease {
+public:
+    DeferredRelease() = default;
+    ~DeferredRelease() { close(); }
+
+    DeferredRelease(const DeferredRelease&) = delete;
+    DeferredRelease& operator=(const DeferredRelease&) = delete;
+
+    // Take ownership of a handle to free later; false when the queue does
+    // not accept handles (immediate mode or closed): the caller frees it.
+    // `keepAlive` is held until the cursor is closed — the statement, so
+    // no other cursor is opened on it meanwhile.
+    bool push(Firebird::IStatement* statement);
+    bool push(Firebird::IResultSet* cursor, std::shared_ptr<void> keepAlive);
+
+    // Free everything queued so far, waiting for a drain in progress on
+    // another thread. Returns the handles freed by this call.
+    std::size_t drain() noexcept;
+
+    // Handles queued or being freed; one relaxed load for the request paths
+    bool pending() const noexcept { return pending_.load(std::memory_order_acquire) != 0; }
+
+    // Accept handles; `background` drains them in a task on Executor::shared()
+    void enable(bool background);
+    // Stop accepting handles (already queued ones stay until drain())
+    void disable() noexcept;
+    // Wait for the drain task, free what is queued and refuse further handles
+    void close() noexcept;
+
+    std::uint64_t released() const noexcept { return released_.load(std::memory_order_relaxed); }
+
+private:
+    struct Cursor {
+        Firebird::IResultSet* cursor;
+        std::shared_ptr<void> keepAlive;
+    };
+
+    void schedule();     // Under mutex_: queue the drain task unless queued
+    void run();          // The drain task
+    void waitUnscheduled(std::unique_lock<std::mutex>& lock);
+
+    std::mutex mutex_;                 // Queues and state
+    std::mutex drainMutex_;            // Held while handles are freed
+    std::condition_variable idle_;     // The drain task finished
+    std::vector<Cursor> cursors_;
+    std::vector<Firebird::IStatement*> statements_;
+    std::atomic<std::size_t> pending_{0};
+    std::atomic<std::uint64_t> released_{0};
+    bool accepting_ = false;
+    bool closed_ = false;
+    bool background_ = false;
+    bool scheduled_ = false;           // The drain task is queued or running
+};
+
+} // namespace fbpp::core::detail
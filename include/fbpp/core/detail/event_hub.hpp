@@ -0,0 +1,115 @@
+#pragma once
+
+// Per-connection multiplexer behind Connection::subscribeEvents(); see
+// fbpp/core/event_subscription.hpp for the public contract.
+
+#include "fbpp/core/environment.hpp"
+#include "fbpp/core/event_subscription.hpp"
+#include "fbpp/core/firebird_compat.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace fbpp::core::detail {
+
+class EventCallback;
+
+class EventHub {
+public:
+    // One answer of the server, copied on the fbclient thread
+    struct Delivery {
+        std::uint64_t registration = 0;
+        std::vector<unsigned char> counts;   // EPB with the new counters
+    };
+
+    // Shared with the fbclient callbacks, which may outlive the hub
+    struct Inbox {
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::vector<Delivery> pending;
+        bool closed = false;
+    };
+
+    EventHub(Environment& env, Firebird::IAttachment* attachment,
+             std::chrono::milliseconds batchWindow, unsigned namesPerRegistration);
+    ~EventHub();
+
+    EventHub(const EventHub&) = delete;
+    EventHub& operator=(const EventHub&) = delete;
+
+    // Register `names` (queEvents for the blocks that change) and return the
+    // subscriber id. Throws FirebirdException; nothing changes on failure.
+    std::uint64_t subscribe(const std::vector<std::string>& names,
+                            EventSubscription::BatchCallback callback);
+    void unsubscribe(std::uint64_t id) noexcept;
+
+    // Stop the dispatcher and cancel every registration. Called by the
+    // Connection before it detaches; later calls are no-ops.
+    void shutdown() noexcept;
+    bool isOpen() const noexcept { return !closed_.load(std::memory_order_acquire); }
+
+    EventStatistics statistics() const;
+
+private:
+    // Names sharing one queEvents registration, in EPB order
+    struct Block {
+        std::vector<std::string> names;
+        std::vector<std::uint32_t> counts;   // Last counters the server reported
+        std::vector<bool> primed;            // Counter known (priming answer seen)
+        std::uint64_t registration = 0;      // 0 = not queued
+        Firebird::IEvents* events = nullptr;
+        EventCallback* callback = nullptr;
+    };
+
+    struct Subscriber {
+        std::unordered_set<std::string> names;
+        std::shared_ptr<const EventSubscription::BatchCallback> callback;
+    };
+
+    void run();
+    // Apply deliveries, re-queue their blocks and add the posts to `fired`
+    void absorb(std::vector<Delivery>& deliveries, std::vector<EventNotification>& fired);
+    void dispatch(const std::vector<EventNotification>& fired);
+
+    std::size_t blockFor(std::size_t nameBytes);
+    void queue(Block& block);
+    void dequeue(Block& block, bool cancel) noexcept;
+    void requeue(Block& block);
+    void removeName(const std::string& name);
+
+    Environment& env_;
+    Firebird::IAttachment* attachment_;
+    const std::chrono::milliseconds batchWindow_;
+    const unsigned namesPerRegistration_;
+
+    std::shared_ptr<Inbox> inbox_;
+    std::thread dispatcher_;
+    std::thread::id dispatcherId_;           // Set once, under mutex_
+    std::atomic<bool> closed_{false};
+
+    mutable std::mutex mutex_;               // Everything below
+    std::condition_variable idle_;           // dispatching_ went back to 0
+    std::vector<Block> blocks_;              // Never shrinks: block indices are stable
+    struct NameRef {
+        std::size_t block = 0;
+        std::size_t refs = 0;
+    };
+    std::unordered_map<std::string, NameRef> names_;
+    std::map<std::uint64_t, Subscriber> subscribers_;
+    std::uint64_t nextSubscriber_ = 0;
+    std::uint64_t nextRegistration_ = 0;
+    std::uint64_t dispatching_ = 0;           // Subscriber whose callback runs now
+    EventStatistics stats_;
+};
+
+} // namespace fbpp::core::detail
@@ -0,0 +1,60 @@
+#pragma once
+
+// Fetch buffers a Statement keeps between its cursors. A closed ResultSet
+// hands its row buffer, prefetch window and column staging block back here,
+// and the statement's next cursor starts with them, so reopening a
+// statement does not allocate them again. Only capacity is kept: the
+// buffers come back empty and are sized by the cursor as before.
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace fbpp::core::detail {
+
+struct FetchBuffers {
+    std::vector<uint8_t> row;       // ResultSet::buffer_
+    std::vector<uint8_t> window;    // ResultSet::window_
+    std::vector<uint8_t> columns;   // ResultSet::columnStage_
+
+    size_t capacity() const noexcept {
+        return row.capacity() + window.capacity() + columns.capacity();
+    }
+};
+
+class FetchBufferStash {
+public:
+    // The buffers of the last closed cursor, empty; none the first time
+    FetchBuffers take() noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return std::exchange(kept_, FetchBuffers{});
+    }
+
+    // Keep each of `buffers` that is larger than the one kept already
+    void put(FetchBuffers& buffers) noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        keep(kept_.row, buffers.row);
+        keep(kept_.window, buffers.window);
+        keep(kept_.columns, buffers.columns);
+    }
+
+    size_t capacity() const noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return kept_.capacity();
+    }
+
+private:
+    static void keep(std::vector<uint8_t>& kept, std::vector<uint8_t>& returned) noexcept {
+        if (returned.capacity() > kept.capacity()) {
+            returned.clear();
+            kept.swap(returned);
+        }
+    }
+
+    mutable std::mutex mutex_;
+    FetchBuffers kept_;
+};
+
+} // namespace fbpp::core::detail
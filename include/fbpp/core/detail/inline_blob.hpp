@@ -0,0 +1,58 @@
+#pragma once
+
+#include "fbpp/core/firebird_compat.hpp"
+
+namespace fbpp {
+namespace core {
+namespace detail {
+
+// Inline BLOB transfer (Firebird 5.0.3+, protocol 19): the server sends
+// BLOBs up to a size limit together with the fetched row, and the client
+// serves openBlob/getSegment/getInfo/close for them locally. The limit is
+// set through IAttachment/IStatement::setMaxInlineBlobSize(), which older
+// headers lack and older client libraries reject with an interface
+// version error. Both cases report "not applied" instead of failing.
+
+template<typename Interface>
+concept HasInlineBlobSize = requires(Interface* object, Firebird::ThrowStatusWrapper* status,
+                                     unsigned bytes) {
+    object->setMaxInlineBlobSize(status, bytes);
+    object->getMaxInlineBlobSize(status);
+};
+
+template<typename Interface>
+bool trySetMaxInlineBlobSize(Interface* object, Firebird::ThrowStatusWrapper& status,
+                             unsigned bytes) {
+    if constexpr (HasInlineBlobSize<Interface>) {
+        try {
+            object->setMaxInlineBlobSize(&status, bytes);
+            return true;
+        } catch (const Firebird::FbException&) {
+            return false;
+        }
+    } else {
+        (void)object;
+        (void)status;
+        (void)bytes;
+        return false;
+    }
+}
+
+template<typename Interface>
+unsigned tryGetMaxInlineBlobSize(Interface* object, Firebird::ThrowStatusWrapper& status) {
+    if constexpr (HasInlineBlobSize<Interface>) {
+        try {
+            return object->getMaxInlineBlobSize(&status);
+        } catch (const Firebird::FbException&) {
+            return 0;
+        }
+    } else {
+        (void)object;
+        (void)status;
+        return 0;
+    }
+}
+
+} // namespace detail
+} // namespace core
+} // namespace fbpp
@@ -0,0 +1,78 @@
+#pragma once
+
+// Read-only or read-write mapping of a whole file (POSIX only).
+//
+// Shared by BlobWriter::writeFile() / BlobReader::readToFile() and the
+// CSV importer; on Windows those fall back to stream I/O.
+
+#include "fbpp/core/exception.hpp"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fbpp::core::detail {
+
+// File descriptor plus at most one mapping of it, both released on scope exit.
+class MappedFile {
+public:
+    MappedFile(const std::string& path, int flags)
+        : fd_(::open(path.c_str(), flags, 0644)) {
+        if (fd_ < 0) {
+            throw FirebirdException("Cannot open " + path + ": " + std::strerror(errno));
+        }
+    }
+
+    ~MappedFile() {
+        unmap();
+        ::close(fd_);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    int fd() const { return fd_; }
+
+    /// Map the first `size` bytes; nullptr if the file cannot be mapped
+    void* map(size_t size, bool writable) {
+        unmap();
+        void* data = ::mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                            writable ? MAP_SHARED : MAP_PRIVATE, fd_, 0);
+        if (data == MAP_FAILED) {
+            return nullptr;
+        }
+        ::madvise(data, size, MADV_SEQUENTIAL);
+        data_ = data;
+        size_ = size;
+        return data_;
+    }
+
+    void unmap() {
+        if (data_) {
+            ::munmap(data_, size_);
+            data_ = nullptr;
+            size_ = 0;
+        }
+    }
+
+    /// Size of a regular file, 0 for anything else
+    size_t regularSize() const {
+        struct stat st {};
+        return ::fstat(fd_, &st) == 0 && S_ISREG(st.st_mode) ? static_cast<size_t>(st.st_size) : 0;
+    }
+
+private:
+    int fd_;
+    void* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+} // namespace fbpp::core::detail
+#endif
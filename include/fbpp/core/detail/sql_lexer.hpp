@@ -0,0 +1,101 @@
+#pragma once
+
+// Lexical regions of an SQL text: code, quoted literals and comments.
+//
+// Shared by NamedParamParser (which rewrites :name markers found in code)
+// and the statement cache key (which normalizes code and drops comments),
+// so both agree on where a literal or comment starts and ends. One forward
+// pass; each region is located with memchr-style searches rather than a
+// per-character state machine. constexpr, so sql<"..."> literals are lexed
+// at compile time by the same rules.
+
+#include <cstddef>
+#include <string_view>
+
+namespace fbpp::core::detail {
+
+class SqlLexer {
+public:
+    enum class Kind {
+        Code,      // Anything outside literals and comments
+        Literal,   // '...' or "..." including the quotes; '' / "" stay inside
+        Comment    // -- up to (not including) the line break, or /* ... */
+    };
+
+    struct Span {
+        Kind kind = Kind::Code;
+        std::size_t begin = 0;
+        std::size_t end = 0;   // One past the last byte
+    };
+
+    constexpr explicit SqlLexer(std::string_view sql) noexcept : sql_(sql) {}
+
+    // Next region in text order; false at end of text. Unterminated
+    // literals and comments run to the end.
+    constexpr bool next(Span& span) noexcept {
+        const std::size_t size = sql_.size();
+        if (pos_ >= size) {
+            return false;
+        }
+        span.begin = pos_;
+        const char c = sql_[pos_];
+
+        if (c == '\'' || c == '"') {
+            std::size_t p = pos_ + 1;
+            for (;;) {
+                p = sql_.find(c, p);
+                if (p == std::string_view::npos) {
+                    p = size;
+                    break;
+                }
+                ++p;
+                if (p < size && sql_[p] == c) {
+                    ++p;   // Doubled quote: escaped, literal continues
+                    continue;
+                }
+                break;
+            }
+            return finish(span, Kind::Literal, p);
+        }
+        if (opensComment(pos_)) {
+            std::size_t p = 0;
+            if (c == '-') {
+                p = sql_.find_first_of("\r\n", pos_ + 2);
+                p = p == std::string_view::npos ? size : p;
+            } else {
+                // Start after "/*" so "/*/" does not close the comment
+                p = sql_.find("*/", pos_ + 2);
+                p = p == std::string_view::npos ? size : p + 2;
+            }
+            return finish(span, Kind::Comment, p);
+        }
+
+        std::size_t p = pos_ + 1;
+        while (p < size && sql_[p] != '\'' && sql_[p] != '"' && !opensComment(p)) {
+            ++p;
+        }
+        return finish(span, Kind::Code, p);
+    }
+
+private:
+    constexpr bool opensComment(std::size_t p) const noexcept {
+        if (p + 1 >= sql_.size()) {
+            return false;
+        }
+        const char c = sql_[p];
+        const char ahead = sql_[p + 1];
+        return (c == '-' && ahead == '-') || (c == '/' && ahead == '*');
+    }
+
+    constexpr bool finish(Span& span, Kind kind, std::size_t end) noexcept {
+        span.kind = kind;
+        span.end = end;
+        pos_ = end;
+        return true;
+    }
+
+    std::string_view sql_;
+    std::size_t pos_ = 0;
+};
+
+} // namespace fbpp::core::detail
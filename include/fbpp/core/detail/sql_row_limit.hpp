@@ -0,0 +1,140 @@
+#pragma once
+
+// Row-limited form of a SELECT text: "<select> ROWS n", for cursors that
+// only want the first rows (fetchOne, existence checks, top-N lookups).
+// The server then stops producing rows at n instead of running the whole
+// result for a cursor that is abandoned after the first fetch.
+//
+// Only texts where appending the clause is certainly valid are rewritten:
+// a SELECT (or WITH ... SELECT) with no row-limiting or locking clause of
+// its own at the top level (FIRST / SKIP / ROWS / OFFSET / FETCH,
+// FOR UPDATE, WITH LOCK). Anything else is left alone and limited on the
+// client side only. Regions come from the lexer the statement cache uses.
+
+#include "fbpp/core/detail/sql_lexer.hpp"
+#include "fbpp/core/detail/sql_token_stream.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace fbpp::core::detail {
+
+namespace row_limit {
+
+constexpr bool isWordChar(char c) noexcept {
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') ||
+           c == '_' || c == '$';
+}
+
+// Case-insensitive compare of an SQL word with an upper-case keyword
+constexpr bool isKeyword(std::string_view word, std::string_view keyword) noexcept {
+    if (word.size() != keyword.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < word.size(); ++i) {
+        if (asciiUpper(static_cast<unsigned char>(word[i])) !=
+            static_cast<unsigned char>(keyword[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Top-level words that already limit, skip or lock rows
+constexpr bool limitsRows(std::string_view word) noexcept {
+    for (std::string_view keyword : {"FIRST", "SKIP", "ROWS", "OFFSET", "FETCH", "FOR", "LOCK"}) {
+        if (isKeyword(word, keyword)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace row_limit
+
+/**
+ * @brief `sql` capped at `rows` rows, or nullopt when it is not rewritten
+ *
+ * Trailing comments and a trailing ';' are dropped before the clause is
+ * appended. rows == 0 yields nullopt (no limit).
+ */
+inline std::optional<std::string> limitRowsSql(std::string_view sql, std::uint64_t rows) {
+    if (rows == 0) {
+        return std::nullopt;
+    }
+
+    SqlLexer lexer(sql);
+    SqlLexer::Span span;
+    std::size_t depth = 0;
+    std::size_t end = 0;             // One past the last byte outside comments
+    bool terminated = false;         // A top-level ';' was seen
+    bool firstWord = true;
+    while (lexer.next(span)) {
+        if (span.kind == SqlLexer::Kind::Comment) {
+            continue;
+        }
+        if (span.kind == SqlLexer::Kind::Literal) {
+            if (terminated) {
+                return std::nullopt;   // More than one statement
+            }
+            end = span.end;
+            continue;
+        }
+        for (std::size_t p = span.begin; p < span.end;) {
+            const char c = sql[p];
+            if (isAsciiSpace(static_cast<unsigned char>(c))) {
+                ++p;
+                continue;
+            }
+            if (terminated) {
+                return std::nullopt;
+            }
+            if (row_limit::isWordChar(c)) {
+                std::size_t q = p + 1;
+                while (q < span.end && row_limit::isWordChar(sql[q])) {
+                    ++q;
+                }
+                const std::string_view word = sql.substr(p, q - p);
+                if (firstWord) {
+                    if (!row_limit::isKeyword(word, "SELECT") &&
+                        !row_limit::isKeyword(word, "WITH")) {
+                        return std::nullopt;
+                    }
+                    firstWord = false;
+                } else if (depth == 0 && row_limit::limitsRows(word)) {
+                    return std::nullopt;
+                }
+                end = q;
+                p = q;
+                continue;
+            }
+            if (c == '(') {
+                ++depth;
+            } else if (c == ')') {
+                if (depth == 0) {
+                    return std::nullopt;
+                }
+                --depth;
+            } else if (c == ';' && depth == 0) {
+                terminated = true;
+                ++p;
+                continue;
+            }
+            end = p + 1;
+            ++p;
+        }
+    }
+    if (firstWord || depth != 0) {
+        return std::nullopt;
+    }
+
+    std::string limited(sql.substr(0, end));
+    limited += " ROWS ";
+    limited += std::to_string(rows);
+    return limited;
+}
+
+} // namespace fbpp::core::detail
@@ -0,0 +1,113 @@
+#pragma once
+
+// Normalized form of an SQL text, one character at a time, and the
+// statement cache key hash over it (SqlKey::hashOf). constexpr, so a
+// sql<"..."> literal gets the same key at compile time as its text would
+// at run time.
+
+#include "fbpp/core/detail/sql_lexer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace fbpp::core::detail {
+
+// ASCII classification as in the "C" locale, usable in constant expressions
+constexpr bool isAsciiSpace(unsigned char c) noexcept {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+constexpr unsigned char asciiUpper(unsigned char c) noexcept {
+    return c >= 'a' && c <= 'z' ? static_cast<unsigned char>(c - 'a' + 'A') : c;
+}
+
+constexpr char asciiLower(char c) noexcept {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// Yields the normalized form of an SQL text one character at a time:
+// comments act as whitespace, whitespace runs collapse to one space,
+// leading/trailing whitespace is dropped, and everything outside '...' and
+// "..." literals is upper-cased. Lets the cache hash and compare SQL
+// without materialising a normalized copy. Regions come from the same
+// lexer NamedParamParser uses.
+class SqlTokenStream {
+public:
+    constexpr explicit SqlTokenStream(std::string_view sql) noexcept : sql_(sql), lexer_(sql) {}
+
+    // Next normalized character (0..255), or -1 at end of text.
+    constexpr int next() noexcept {
+        if (pending_ >= 0) {
+            const int c = pending_;
+            pending_ = -1;
+            return c;
+        }
+
+        for (;;) {
+            if (pos_ == span_.end) {
+                if (!lexer_.next(span_)) {
+                    return -1;  // Trailing whitespace is never emitted.
+                }
+                pos_ = span_.begin;
+                if (span_.kind == SqlLexer::Kind::Comment) {
+                    pos_ = span_.end;
+                    space_ = true;
+                    continue;
+                }
+            }
+
+            const auto c = static_cast<unsigned char>(sql_[pos_++]);
+            // Inside a literal - preserve everything.
+            if (span_.kind == SqlLexer::Kind::Literal) {
+                return emit(c);
+            }
+            if (isAsciiSpace(c)) {
+                space_ = true;
+                continue;
+            }
+            return emit(asciiUpper(c));
+        }
+    }
+
+private:
+    constexpr int emit(unsigned char c) noexcept {
+        if (space_ && started_) {
+            space_ = false;
+            pending_ = c;
+            return ' ';
+        }
+        space_ = false;
+        started_ = true;
+        return c;
+    }
+
+    std::string_view sql_;
+    SqlLexer lexer_;
+    SqlLexer::Span span_;
+    std::size_t pos_ = 0;
+    bool space_ = false;
+    bool started_ = false;
+    int pending_ = -1;
+};
+
+// SqlKey::hashOf(sql, flags)
+constexpr std::uint64_t sqlKeyHash(std::string_view sql, unsigned flags) noexcept {
+    // FNV-1a over the normalized stream, flags mixed in, then a splitmix
+    // finaliser so the low bits (shard index) are well distributed.
+    std::uint64_t h = 0xcbf29ce484222325ULL;
+    SqlTokenStream stream(sql);
+    for (int c = stream.next(); c >= 0; c = stream.next()) {
+        h ^= static_cast<std::uint64_t>(c);
+        h *= 0x100000001b3ULL;
+    }
+    h ^= static_cast<std::uint64_t>(flags) + 0x9e3779b97f4a7c15ULL;
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+} // namespace fbpp::core::detail
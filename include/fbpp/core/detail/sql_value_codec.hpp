@@ -4,24 +4,33 @@
 #include "fbpp/core/transaction.hpp"
 #include "fbpp/core/type_adapter.hpp"
 #include "fbpp/core/extended_types.hpp"
+#include "fbpp/core/decfloat_chars.hpp"
+#include "fbpp/core/int128_chars.hpp"
+#include "fbpp/core/scaled_numeric.hpp"
+#include "fbpp/core/time_zone_table.hpp"
+#include "fbpp/core/timestamp_utils.hpp"
 #include "fbpp/core/exception.hpp"
 #include "fbpp/core/firebird_compat.hpp"
 #include "fbpp/core/environment.hpp"
 #include "fbpp_util/trace.h"
 #include "fbpp/core/detail/conversion_utils.hpp"
+#include "fbpp/core/detail/text_scan.hpp"
 
 #include <algorithm>
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <limits>
 #include <optional>
+#include <span>
 #include <string>
 #include <type_traits>
 #include <utility>
 #include <vector>
-#include <iomanip>
-#include <sstream>
+#include <charconv>
+#include <string_view>
+#include <system_error>
 
 namespace fbpp::core::detail::sql_value_codec {
 
@@ -75,7 +84,18 @@ inline ISC_QUAD createBlob(Transaction* transaction, const std::vector<uint8_t>&
     return transaction->createBlob(data);
 }
 
+inline ISC_QUAD createBlob(Transaction* transaction, std::span<const std::byte> data) {
+    if (!transaction) {
+        ISC_QUAD nullId{};
+        return nullId;
+    }
+    return transaction->createBlob(data);
+}
+
 inline int64_t pow10_int(int scale) {
+    if (scale >= 0 && scale <= kMaxInt64Pow10) {
+        return pow10Int64(scale);
+    }
     int64_t result = 1;
     for (int i = 0; i < scale; ++i) {
         result *= 10;
@@ -108,59 +128,73 @@ inline int64_t round_to_i64_checked(double value, const char* sqlTypeName) {
     return static_cast<int64_t>(value - 0.5);
 }
 
-// Expand scientific notation to plain decimal string (accuracy limited by provided digits)
-inline std::string normalize_scientific(const std::string& str) {
-    auto ePos = str.find_first_of("eE");
-    if (ePos == std::string::npos) {
-        return str;
+// Expand scientific notation to plain decimal text in `out` ("1.2345E+10"
+// -> "12345000000"); text without an exponent is copied as is. Digits are
+// kept as given, so accuracy is that of the input.
+inline void assign_plain_decimal(std::string& out, std::string_view text) {
+    const auto ePos = text.find_first_of("eE");
+    if (ePos == std::string_view::npos) {
+        out.assign(text);
+        return;
     }
 
-    std::string mantissa = str.substr(0, ePos);
-    int exp = std::stoi(str.substr(ePos + 1));
+    const char* expFirst = text.data() + ePos + 1;
+    const char* expLast = text.data() + text.size();
+    if (expFirst != expLast && *expFirst == '+') {
+        ++expFirst;
+    }
+    int exp = 0;
+    const auto parsed = std::from_chars(expFirst, expLast, exp);
+    if (parsed.ec != std::errc{} || parsed.ptr != expLast) {
+        throw FirebirdException("Invalid decimal exponent: " + std::string(text));
+    }
 
+    std::string_view mantissa = text.substr(0, ePos);
     bool negative = false;
     if (!mantissa.empty() && (mantissa[0] == '+' || mantissa[0] == '-')) {
         negative = mantissa[0] == '-';
-        mantissa.erase(mantissa.begin());
+        mantissa.remove_prefix(1);
     }
+    const auto dotPos = mantissa.find('.');
+    const std::string_view intDigits = mantissa.substr(0, dotPos);
+    const std::string_view fracDigits =
+        dotPos == std::string_view::npos ? std::string_view{} : mantissa.substr(dotPos + 1);
 
-    auto dotPos = mantissa.find('.');
-    int fracDigits = 0;
-    if (dotPos != std::string::npos) {
-        fracDigits = static_cast<int>(mantissa.size() - dotPos - 1);
-        mantissa.erase(dotPos, 1);
+    // All digits, then the point moved by the exponent
+    out.clear();
+    if (negative) {
+        out.push_back('-');
     }
-
-    int newDotPos = static_cast<int>(mantissa.size()) - fracDigits + exp;
-    if (newDotPos < 0) {
-        mantissa.insert(mantissa.begin(), static_cast<size_t>(-newDotPos), '0');
-        newDotPos = 0;
-    } else if (newDotPos > static_cast<int>(mantissa.size())) {
-        mantissa.append(static_cast<size_t>(newDotPos - static_cast<int>(mantissa.size())), '0');
-    }
-
-    if (newDotPos == 0) {
-        mantissa.insert(mantissa.begin(), {'0', '.'});
-    } else if (newDotPos < static_cast<int>(mantissa.size())) {
-        mantissa.insert(mantissa.begin() + newDotPos, '.');
+    const size_t start = out.size();
+    out.append(intDigits).append(fracDigits);
+    const long digits = static_cast<long>(out.size() - start);
+    long point = static_cast<long>(intDigits.size()) + exp;
+    if (point <= 0) {
+        out.insert(start, static_cast<size_t>(1 - point), '0');
+        point = 1;
+    } else if (point > digits) {
+        out.append(static_cast<size_t>(point - digits), '0');
     }
-
-    // Trim leading zeros (keep one before dot)
-    auto nonZero = mantissa.find_first_not_of('0');
-    if (nonZero != std::string::npos && mantissa[nonZero] != '.') {
-        mantissa.erase(0, nonZero);
-    } else if (nonZero != std::string::npos && mantissa[nonZero] == '.') {
-        // keep one zero before dot
-        mantissa.erase(0, nonZero - 1);
+    if (start + static_cast<size_t>(point) < out.size()) {
+        out.insert(start + static_cast<size_t>(point), 1, '.');
     }
 
-    if (mantissa.empty()) {
-        mantissa = "0";
+    // Leading zeros, keeping one before the point
+    size_t zeros = 0;
+    while (start + zeros + 1 < out.size() && out[start + zeros] == '0' &&
+           out[start + zeros + 1] != '.') {
+        ++zeros;
     }
-    if (negative && mantissa != "0") {
-        mantissa.insert(mantissa.begin(), '-');
+    out.erase(start, zeros);
+    if (negative && out.compare(start, std::string::npos, "0") == 0) {
+        out.erase(0, start);
     }
-    return mantissa;
+}
+
+inline std::string normalize_scientific(std::string_view str) {
+    std::string out;
+    assign_plain_decimal(out, str);
+    return out;
 }
 
 template<typename Target, typename Source>
@@ -174,14 +208,145 @@ Target checked_narrow(Source value, const char* sqlTypeName) {
 
 template<typename FloatType>
 std::string floating_to_string(FloatType value) {
-    std::ostringstream oss;
-    oss << std::setprecision(std::numeric_limits<FloatType>::max_digits10) << value;
-    return oss.str();
+    // Shortest round-trip text: DECFLOAT / CHAR targets get "0.1", not the
+    // 17-digit "0.10000000000000001" of a max_digits10 stream
+    return number_to_string(value);
 }
 
 template<typename T>
 void write_sql_value(const SqlWriteContext& ctx, const T& value, uint8_t* dataPtr);
 
+// A string converted to a non-text field (numbers, date/time, INT128,
+// DECFLOAT, time zones): parsed by type. `ctx.field` is set.
+inline void write_string_converted(const SqlWriteContext& ctx, const std::string& strValue,
+                                   uint8_t* dataPtr) {
+    if (ctx.field->type == SQL_INT128) {
+        // Native parser: no IUtil / IInt128 calls per value.
+        const Int128 parsed = int128FromString(strValue, ctx.field->scale);
+        std::memcpy(dataPtr, parsed.data(), 16);
+    } else if (ctx.field->type == SQL_DEC16) {
+        // Native decNumber parse, same DPD bytes as IDecFloat16::fromString.
+        const DecFloat16 parsed = decFloat16FromString(strValue);
+        std::memcpy(dataPtr, parsed.data(), 8);
+    } else if (ctx.field->type == SQL_DEC34) {
+        const DecFloat34 parsed = decFloat34FromString(strValue);
+        std::memcpy(dataPtr, parsed.data(), 16);
+    } else if (ctx.field->type == SQL_TIMESTAMP) {
+        unsigned year, month, day, hours, minutes, seconds, fractions;
+        // Try to parse ISO format first
+        try {
+            if (strValue.length() >= 19 && strValue[10] == 'T') {
+                 parseIsoDate(strValue.substr(0, 10), year, month, day);
+                 parseIsoTime(strValue.substr(11), hours, minutes, seconds, fractions);
+            } else {
+                 // Fallback or other formats? For now assume ISO or throw
+                 throw FirebirdException("Expected ISO timestamp format YYYY-MM-DDTHH:MM:SS");
+            }
+        } catch (...) {
+            throw FirebirdException("Invalid timestamp format: " + strValue);
+        }
+        const uint32_t date = timestamp_utils::encode_firebird_date(year, month, day);
+        const uint32_t time = timestamp_utils::encode_firebird_time(hours, minutes, seconds, fractions);
+        std::memcpy(dataPtr, &date, 4);
+        std::memcpy(dataPtr + 4, &time, 4);
+    } else if (ctx.field->type == SQL_TYPE_TIME) {
+        unsigned hours, minutes, seconds, fractions;
+        parseIsoTime(strValue, hours, minutes, seconds, fractions);
+        const uint32_t time = timestamp_utils::encode_firebird_time(hours, minutes, seconds, fractions);
+        std::memcpy(dataPtr, &time, 4);
+    } else if (ctx.field->type == SQL_TYPE_DATE) {
+        unsigned year, month, day;
+        parseIsoDate(strValue, year, month, day);
+        const uint32_t date = timestamp_utils::encode_firebird_date(year, month, day);
+        std::memcpy(dataPtr, &date, 4);
+    } else {
+        // Handle extended types conversion from string
+        auto& env = Environment::getInstance();
+        Firebird::ThrowStatusWrapper status(env.getMaster()->getStatus());
+        Firebird::IUtil* util = env.getUtil();
+
+        switch (ctx.field->type) {
+            case SQL_TIMESTAMP_TZ: {
+                unsigned year, month, day, hours, minutes, seconds, fractions;
+                std::string dtStr, tzStr;
+                splitTzSuffix(strValue, 19, dtStr, tzStr);
+
+                parseIsoDate(dtStr.substr(0, 10), year, month, day);
+                parseIsoTime(dtStr.substr(11), hours, minutes, seconds, fractions);
+
+                // Delegate to the engine: encodeTimeStampTz converts the
+                // wall-clock time to UTC and encodes the zone id properly
+                // (offset zones are stored as displacement+1439, names as
+                // IANA ids). Hand-rolling this produced values other
+                // clients could not decode.
+                ISC_TIMESTAMP_TZ tstz{};
+                util->encodeTimeStampTz(&status, &tstz, year, month, day,
+                                        hours, minutes, seconds, fractions,
+                                        tzStr.c_str());
+                std::memcpy(dataPtr, &tstz.utc_timestamp.timestamp_date, 4);
+                std::memcpy(dataPtr + 4, &tstz.utc_timestamp.timestamp_time, 4);
+                std::memcpy(dataPtr + 8, &tstz.time_zone, 2);
+                break;
+            }
+            case SQL_TIME_TZ: {
+                std::string timeStr, tzStr;
+                splitTzSuffix(strValue, 8, timeStr, tzStr);
+
+                unsigned hours, minutes, seconds, fractions;
+                parseIsoTime(timeStr, hours, minutes, seconds, fractions);
+
+                // Delegate zone encoding + UTC conversion to the engine
+                // (see SQL_TIMESTAMP_TZ above).
+                ISC_TIME_TZ ttz{};
+                util->encodeTimeTz(&status, &ttz, hours, minutes, seconds,
+                                   fractions, tzStr.c_str());
+                std::memcpy(dataPtr, &ttz.utc_time, 4);
+                std::memcpy(dataPtr + 4, &ttz.time_zone, 2);
+                break;
+            }
+            case SQL_SHORT: {
+                int64_t val = string_to_decimal_i64(strValue, ctx.field->scale);
+                if (val > INT16_MAX || val < INT16_MIN) throw FirebirdException("Value out of range for SMALLINT");
+                int16_t v = static_cast<int16_t>(val);
+                std::memcpy(dataPtr, &v, 2);
+                break;
+            }
+            case SQL_LONG: {
+                int64_t val = string_to_decimal_i64(strValue, ctx.field->scale);
+                if (val > INT32_MAX || val < INT32_MIN) throw FirebirdException("Value out of range for INTEGER");
+                int32_t v = static_cast<int32_t>(val);
+                std::memcpy(dataPtr, &v, 4);
+                break;
+            }
+            case SQL_INT64: {
+                int64_t val = string_to_decimal_i64(strValue, ctx.field->scale);
+                std::memcpy(dataPtr, &val, 8);
+                break;
+            }
+            case SQL_FLOAT: {
+                const float val = string_to_floating<float>(strValue, "FLOAT");
+                std::memcpy(dataPtr, &val, 4);
+                break;
+            }
+            case SQL_DOUBLE:
+            case SQL_D_FLOAT: {
+                const double val = string_to_floating<double>(strValue, "DOUBLE PRECISION");
+                std::memcpy(dataPtr, &val, 8);
+                break;
+            }
+            case SQL_BOOLEAN: {
+                // Simple boolean parsing
+                bool val = (strValue == "true" || strValue == "1" || strValue == "TRUE");
+                uint8_t b = val ? 1 : 0;
+                std::memcpy(dataPtr, &b, 1);
+                break;
+            }
+            default:
+                throw FirebirdException("Unsupported type for string conversion: " + std::to_string(ctx.field->type));
+        }
+    }
+}
+
 template<typename T>
 void write_sql_value(const SqlWriteContext& ctx, const std::optional<T>& value, uint8_t* dataPtr) {
     if (!value.has_value()) {
@@ -237,7 +402,7 @@ void write_sql_value(const SqlWriteContext& ctx, const T& value, uint8_t* dataPt
                         return;
                     }
                     default:
-                        write_sql_value(ctx, std::to_string(numericValue), dataPtr);
+                        write_sql_value(ctx, number_to_string(numericValue), dataPtr);
                         return;
                 }
             }
@@ -294,7 +459,7 @@ void write_sql_value(const SqlWriteContext& ctx, const T& value, uint8_t* dataPt
                     // which handles them via IUtil or throws a meaningful
                     // error. Falling through used to mark the field NOT NULL
                     // with NOTHING written (silently stored zero).
-                    write_sql_value(ctx, std::to_string(numericValue), dataPtr);
+                    write_sql_value(ctx, number_to_string(numericValue), dataPtr);
                     return;
             }
         }
@@ -381,20 +546,41 @@ void write_sql_value(const SqlWriteContext& ctx, const T& value, uint8_t* dataPt
                     return;
             }
         }
-    } else if constexpr (std::is_same_v<ValueType, std::string> || std::is_same_v<ValueType, const char*>) {
-        std::string strValue;
-        if constexpr (std::is_same_v<ValueType, const char*>) {
-            if (value) strValue = value;
+    } else if constexpr (is_fixed_string_v<ValueType>) {
+        if (ctx.field && (ctx.field->type == SQL_TEXT || ctx.field->type == SQL_VARYING)) {
+            if (value.size() > static_cast<size_t>(ctx.field->length)) {
+                throw FirebirdException(
+                    "String value too long for field " + ctx.field->name +
+                    ": " + std::to_string(value.size()) + " bytes, field holds " +
+                    std::to_string(ctx.field->length) + " bytes");
+            }
+            if (ctx.field->type == SQL_TEXT) {
+                std::memcpy(dataPtr, value.data(), value.size());
+                std::memset(dataPtr + value.size(), ' ', ctx.field->length - value.size());
+            } else {
+                const uint16_t len = static_cast<uint16_t>(value.size());
+                std::memcpy(dataPtr, &len, sizeof(uint16_t));
+                std::memcpy(dataPtr + sizeof(uint16_t), value.data(), value.size());
+            }
+            setNotNull(ctx.nullIndicator);
+        } else {
+            write_sql_value(ctx, value.str(), dataPtr);   // Same conversions as std::string
+        }
+        return;
+    } else if constexpr (std::is_same_v<ValueType, std::string> || is_text_view_v<ValueType>) {
+        // A std::string, a std::string_view or a C string is read in place
+        std::string_view text;
+        if constexpr (std::is_pointer_v<ValueType>) {
+            if (value) text = value;
         } else {
-            strValue = value;
+            text = value;
         }
 
         if (isAnyBlob(ctx.field)) {
             // String bytes go to BLOB storage as-is. Works for SUB_TYPE TEXT
             // and SUB_TYPE BINARY (and any other sub-type) — the bytes are
             // the bytes; caller picks the interpretation via column type.
-            std::vector<uint8_t> blobData(strValue.begin(), strValue.end());
-            ISC_QUAD blobId = createBlob(ctx.transaction, blobData);
+            ISC_QUAD blobId = createBlob(ctx.transaction, std::as_bytes(std::span(text)));
             std::memcpy(dataPtr, &blobId, sizeof(ISC_QUAD));
         } else if (ctx.field && (ctx.field->type == SQL_TEXT || ctx.field->type == SQL_VARYING)) {
             // IMessageMetadata::getLength() returns the DATA capacity in
@@ -402,163 +588,59 @@ void write_sql_value(const SqlWriteContext& ctx, const T& value, uint8_t* dataPt
             // for separately by the engine when laying out offsets.
             // Oversize input raises an error (mirroring the engine's
             // "string right truncation") instead of silently corrupting data.
-            if (strValue.size() > static_cast<size_t>(ctx.field->length)) {
+            if (text.size() > static_cast<size_t>(ctx.field->length)) {
                 throw FirebirdException(
                     "String value too long for field " + ctx.field->name +
-                    ": " + std::to_string(strValue.size()) + " bytes, field holds " +
+                    ": " + std::to_string(text.size()) + " bytes, field holds " +
                     std::to_string(ctx.field->length) + " bytes");
             }
             if (ctx.field->type == SQL_TEXT) {
-                std::memcpy(dataPtr, strValue.data(), strValue.size());
-                if (strValue.size() < ctx.field->length) {
-                    std::memset(dataPtr + strValue.size(), ' ',
-                                ctx.field->length - strValue.size());
+                std::memcpy(dataPtr, text.data(), text.size());
+                if (text.size() < ctx.field->length) {
+                    std::memset(dataPtr + text.size(), ' ',
+                                ctx.field->length - text.size());
                 }
             } else { // SQL_VARYING
-                uint16_t len = static_cast<uint16_t>(strValue.size());
+                uint16_t len = static_cast<uint16_t>(text.size());
                 std::memcpy(dataPtr, &len, sizeof(uint16_t));
-                std::memcpy(dataPtr + sizeof(uint16_t), strValue.data(), strValue.size());
+                std::memcpy(dataPtr + sizeof(uint16_t), text.data(), text.size());
             }
         } else if (ctx.field) {
-            // Handle extended types conversion from string
-            auto& env = Environment::getInstance();
-            Firebird::ThrowStatusWrapper status(env.getMaster()->getStatus());
-            Firebird::IUtil* util = env.getUtil();
-
-            switch (ctx.field->type) {
-                case SQL_INT128: {
-                    auto int128Helper = util->getInt128(&status);
-                    FB_I128 fb128;
-                    int128Helper->fromString(&status, ctx.field->scale, strValue.c_str(), &fb128);
-                    std::memcpy(dataPtr, &fb128, 16);
-                    break;
-                }
-                case SQL_DEC16: {
-                    auto decFloat16Helper = util->getDecFloat16(&status);
-                    FB_DEC16 fb16;
-                    decFloat16Helper->fromString(&status, strValue.c_str(), &fb16);
-                    std::memcpy(dataPtr, &fb16, 8);
-                    break;
-                }
-                case SQL_DEC34: {
-                    auto decFloat34Helper = util->getDecFloat34(&status);
-                    FB_DEC34 fb34;
-                    decFloat34Helper->fromString(&status, strValue.c_str(), &fb34);
-                    std::memcpy(dataPtr, &fb34, 16);
-                    break;
-                }
-                case SQL_TIMESTAMP: {
-                    unsigned year, month, day, hours, minutes, seconds, fractions;
-                    // Try to parse ISO format first
-                    try {
-                        if (strValue.length() >= 19 && strValue[10] == 'T') {
-                             parseIsoDate(strValue.substr(0, 10), year, month, day);
-                             parseIsoTime(strValue.substr(11), hours, minutes, seconds, fractions);
-                        } else {
-                             // Fallback or other formats? For now assume ISO or throw
-                             throw FirebirdException("Expected ISO timestamp format YYYY-MM-DDTHH:MM:SS");
-                        }
-                    } catch (...) {
-                        throw FirebirdException("Invalid timestamp format: " + strValue);
-                    }
-                    ISC_DATE date = util->encodeDate(year, month, day);
-                    ISC_TIME time = util->encodeTime(hours, minutes, seconds, fractions);
-                    std::memcpy(dataPtr, &date, 4);
-                    std::memcpy(dataPtr + 4, &time, 4);
-                    break;
-                }
-                case SQL_TIMESTAMP_TZ: {
-                    unsigned year, month, day, hours, minutes, seconds, fractions;
-                    std::string dtStr, tzStr;
-                    splitTzSuffix(strValue, 19, dtStr, tzStr);
-
-                    parseIsoDate(dtStr.substr(0, 10), year, month, day);
-                    parseIsoTime(dtStr.substr(11), hours, minutes, seconds, fractions);
-
-                    // Delegate to the engine: encodeTimeStampTz converts the
-                    // wall-clock time to UTC and encodes the zone id properly
-                    // (offset zones are stored as displacement+1439, names as
-                    // IANA ids). Hand-rolling this produced values other
-                    // clients could not decode.
-                    ISC_TIMESTAMP_TZ tstz{};
-                    util->encodeTimeStampTz(&status, &tstz, year, month, day,
-                                            hours, minutes, seconds, fractions,
-                                            tzStr.c_str());
-                    std::memcpy(dataPtr, &tstz.utc_timestamp.timestamp_date, 4);
-                    std::memcpy(dataPtr + 4, &tstz.utc_timestamp.timestamp_time, 4);
-                    std::memcpy(dataPtr + 8, &tstz.time_zone, 2);
-                    break;
-                }
-                case SQL_TYPE_TIME: {
-                    unsigned hours, minutes, seconds, fractions;
-                    parseIsoTime(strValue, hours, minutes, seconds, fractions);
-                    ISC_TIME time = util->encodeTime(hours, minutes, seconds, fractions);
-                    std::memcpy(dataPtr, &time, 4);
-                    break;
-                }
-                case SQL_TIME_TZ: {
-                    std::string timeStr, tzStr;
-                    splitTzSuffix(strValue, 8, timeStr, tzStr);
-
-                    unsigned hours, minutes, seconds, fractions;
-                    parseIsoTime(timeStr, hours, minutes, seconds, fractions);
-
-                    // Delegate zone encoding + UTC conversion to the engine
-                    // (see SQL_TIMESTAMP_TZ above).
-                    ISC_TIME_TZ ttz{};
-                    util->encodeTimeTz(&status, &ttz, hours, minutes, seconds,
-                                       fractions, tzStr.c_str());
-                    std::memcpy(dataPtr, &ttz.utc_time, 4);
-                    std::memcpy(dataPtr + 4, &ttz.time_zone, 2);
-                    break;
-                }
-                case SQL_TYPE_DATE: {
-                    unsigned year, month, day;
-                    parseIsoDate(strValue, year, month, day);
-                    ISC_DATE date = util->encodeDate(year, month, day);
-                    std::memcpy(dataPtr, &date, 4);
-                    break;
-                }
-                case SQL_SHORT: {
-                    int64_t val = string_to_decimal_i64(strValue, ctx.field->scale);
-                    if (val > INT16_MAX || val < INT16_MIN) throw FirebirdException("Value out of range for SMALLINT");
-                    int16_t v = static_cast<int16_t>(val);
-                    std::memcpy(dataPtr, &v, 2);
-                    break;
-                }
-                case SQL_LONG: {
-                    int64_t val = string_to_decimal_i64(strValue, ctx.field->scale);
-                    if (val > INT32_MAX || val < INT32_MIN) throw FirebirdException("Value out of range for INTEGER");
-                    int32_t v = static_cast<int32_t>(val);
-                    std::memcpy(dataPtr, &v, 4);
-                    break;
-                }
-                case SQL_INT64: {
-                    int64_t val = string_to_decimal_i64(strValue, ctx.field->scale);
-                    std::memcpy(dataPtr, &val, 8);
-                    break;
-                }
-                case SQL_FLOAT: {
-                    float val = std::stof(strValue);
-                    std::memcpy(dataPtr, &val, 4);
-                    break;
-                }
-                case SQL_DOUBLE:
-                case SQL_D_FLOAT: {
-                    double val = std::stod(strValue);
-                    std::memcpy(dataPtr, &val, 8);
-                    break;
-                }
-                case SQL_BOOLEAN: {
-                    // Simple boolean parsing
-                    bool val = (strValue == "true" || strValue == "1" || strValue == "TRUE");
-                    uint8_t b = val ? 1 : 0;
-                    std::memcpy(dataPtr, &b, 1);
-                    break;
+            // Conversions parse a std::string: only a view is copied, and
+            // only here
+            if constexpr (std::is_same_v<ValueType, std::string>) {
+                write_string_converted(ctx, value, dataPtr);
+            } else {
+                write_string_converted(ctx, std::string(text), dataPtr);
+            }
+        }
+    } else if constexpr (is_byte_span_v<ValueType>) {
+        // Bytes are bytes: streamed into a BLOB from the span, or copied
+        // once into a binary CHAR / VARCHAR (OCTETS)
+        if (isAnyBlob(ctx.field)) {
+            ISC_QUAD blobId = createBlob(ctx.transaction, value);
+            std::memcpy(dataPtr, &blobId, sizeof(ISC_QUAD));
+        } else if (ctx.field && (ctx.field->type == SQL_TEXT || ctx.field->type == SQL_VARYING)) {
+            if (value.size() > static_cast<size_t>(ctx.field->length)) {
+                throw FirebirdException(
+                    "Binary value too long for field " + ctx.field->name +
+                    ": " + std::to_string(value.size()) + " bytes, field holds " +
+                    std::to_string(ctx.field->length) + " bytes");
+            }
+            if (ctx.field->type == SQL_TEXT) {
+                std::memcpy(dataPtr, value.data(), value.size());
+                if (value.size() < ctx.field->length) {
+                    std::memset(dataPtr + value.size(), 0, ctx.field->length - value.size());
                 }
-                default:
-                    throw FirebirdException("Unsupported type for string conversion: " + std::to_string(ctx.field->type));
+            } else {
+                const uint16_t len = static_cast<uint16_t>(value.size());
+                std::memcpy(dataPtr, &len, sizeof(uint16_t));
+                std::memcpy(dataPtr + sizeof(uint16_t), value.data(), value.size());
             }
+        } else {
+            throw FirebirdException(
+                "Binary value for field " + (ctx.field ? ctx.field->name : std::string("<unknown>")) +
+                ": only CHAR / VARCHAR and BLOB columns take bytes");
         }
     } else if constexpr (std::is_same_v<ValueType, bool>) {
         uint8_t boolVal = value ? 1 : 0;
@@ -614,14 +696,20 @@ void read_sql_value(const SqlReadContext& ctx, const uint8_t* dataPtr, std::opti
         return;
     }
 
-    T tmp{};
-    read_sql_value(SqlReadContext{ctx.field, ctx.transaction, ctx.nullIndicator}, dataPtr, tmp);
-    value = std::move(tmp);
+    // Decode into a present value: a reused std::optional<std::string>
+    // keeps its capacity (ResultSet::fetchInto)
+    if (!value) {
+        value.emplace();
+    }
+    read_sql_value(SqlReadContext{ctx.field, ctx.transaction, ctx.nullIndicator}, dataPtr, *value);
 }
 
 template<typename T>
 void read_sql_value(const SqlReadContext& ctx, const uint8_t* dataPtr, T& value) {
     using ValueType = std::decay_t<T>;
+    static_assert(!std::is_same_v<ValueType, std::string_view> && !is_byte_span_v<ValueType>,
+                  "std::string_view and std::span<const std::byte> are parameter types; "
+                  "read into std::string instead");
 
     if (isNull(ctx.nullIndicator)) {
         std::string fieldName = ctx.field ? ctx.field->name : "<unknown>";
@@ -658,8 +746,7 @@ void read_sql_value(const SqlReadContext& ctx, const uint8_t* dataPtr, T& value)
             } else {
                 std::memcpy(&raw, dataPtr, sizeof(int64_t));
             }
-            const int64_t factor = pow10_int(scale);
-            value = static_cast<ValueType>(static_cast<double>(raw) / static_cast<double>(factor));
+            value = static_cast<ValueType>(scaledToDouble(raw, -scale));
             return;
         }
         // Scale==0: dispatch by the actual wire type. A blind
@@ -697,6 +784,12 @@ void read_sql_value(const SqlReadContext& ctx, const uint8_t* dataPtr, T& value)
                 value = static_cast<ValueType>(v);
                 return;
             }
+            case SQL_DEC16:
+                value = static_cast<ValueType>(toDouble(DecFloat16(dataPtr)));
+                return;
+            case SQL_DEC34:
+                value = static_cast<ValueType>(toDouble(DecFloat34(dataPtr)));
+                return;
             default:
                 throw FirebirdException(
                     "Unsupported read of SQL type " +
@@ -775,6 +868,30 @@ void read_sql_value(const SqlReadContext& ctx, const uint8_t* dataPtr, T& value)
             value = checked_narrow<ValueType>(raw, "target integer type");
         }
         return;
+    } else if constexpr (is_fixed_string_v<ValueType>) {
+        std::string_view text;
+        std::string converted;
+        if (ctx.field && (ctx.field->type == SQL_TEXT || ctx.field->type == SQL_VARYING)) {
+            const auto* chars = reinterpret_cast<const char*>(dataPtr);
+            if (ctx.field->type == SQL_VARYING) {
+                uint16_t len{};
+                std::memcpy(&len, dataPtr, sizeof(uint16_t));
+                text = std::string_view(chars + sizeof(uint16_t), len);
+            } else {
+                text = std::string_view(chars, trimmedLength(chars, ctx.field->length));
+            }
+        } else {
+            read_sql_value(ctx, dataPtr, converted);   // Same conversions as std::string
+            text = converted;
+        }
+        if (text.size() > value.capacity()) {
+            throw FirebirdException(
+                "String value too long for FixedString<" + std::to_string(value.capacity()) +
+                "> from field " + (ctx.field ? ctx.field->name : std::string("<unknown>")) +
+                ": " + std::to_string(text.size()) + " bytes");
+        }
+        value.assign(text);
+        return;
     } else if constexpr (std::is_same_v<ValueType, std::string>) {
         if (isAnyBlob(ctx.field) && ctx.transaction) {
             // Any BLOB sub-type loads into std::string as a byte buffer.
@@ -793,130 +910,137 @@ void read_sql_value(const SqlReadContext& ctx, const uint8_t* dataPtr, T& value)
                 std::memcpy(&len, dataPtr, sizeof(uint16_t));
                 value.assign(reinterpret_cast<const char*>(dataPtr + sizeof(uint16_t)), len);
             } else {
-                // SQL_TEXT
-                value.assign(reinterpret_cast<const char*>(dataPtr), ctx.field->length);
-                // Trim trailing spaces
-                value.erase(value.find_last_not_of(' ') + 1);
+                // SQL_TEXT: copy without the blank padding
+                const auto* text = reinterpret_cast<const char*>(dataPtr);
+                value.assign(text, trimmedLength(text, ctx.field->length));
+            }
+        } else if (ctx.field && ctx.field->type == SQL_INT128) {
+            // Native formatter, same text as IInt128::toString.
+            char buffer[kInt128MaxChars + 16];
+            const auto result = toChars(buffer, buffer + sizeof(buffer),
+                                        Int128(dataPtr), ctx.field->scale);
+            value.assign(buffer, result.ptr);
+        } else if (ctx.field && ctx.field->type == SQL_DEC16) {
+            // Native decNumber formatter, same text as IDecFloat16::toString.
+            char buffer[kDecFloat16MaxChars];
+            const auto result = toChars(buffer, buffer + sizeof(buffer), DecFloat16(dataPtr));
+            assign_plain_decimal(value, {buffer, static_cast<size_t>(result.ptr - buffer)});
+        } else if (ctx.field && ctx.field->type == SQL_DEC34) {
+            char buffer[kDecFloat34MaxChars];
+            const auto result = toChars(buffer, buffer + sizeof(buffer), DecFloat34(dataPtr));
+            assign_plain_decimal(value, {buffer, static_cast<size_t>(result.ptr - buffer)});
+        } else if (ctx.field && (ctx.field->type == SQL_TIMESTAMP ||
+                                 ctx.field->type == SQL_TYPE_DATE ||
+                                 ctx.field->type == SQL_TYPE_TIME)) {
+            // Calendar fields are plain integer arithmetic (timestamp_utils);
+            // only the WITH TIME ZONE types below need the engine.
+            uint32_t date = 0;
+            uint32_t time = 0;
+            if (ctx.field->type == SQL_TYPE_TIME) {
+                std::memcpy(&time, dataPtr, 4);
+            } else {
+                std::memcpy(&date, dataPtr, 4);
+                if (ctx.field->type == SQL_TIMESTAMP) {
+                    std::memcpy(&time, dataPtr + 4, 4);
+                }
+            }
+            unsigned year, month, day, hours, minutes, seconds, fractions;
+            timestamp_utils::decode_firebird_date(date, year, month, day);
+            timestamp_utils::decode_firebird_time(time, hours, minutes, seconds, fractions);
+            char buffer[64];
+            int length = 0;
+            if (ctx.field->type == SQL_TIMESTAMP) {
+                length = std::snprintf(buffer, sizeof(buffer), "%04u-%02u-%02uT%02u:%02u:%02u.%04u",
+                                       year, month, day, hours, minutes, seconds, fractions);
+            } else if (ctx.field->type == SQL_TYPE_DATE) {
+                length = std::snprintf(buffer, sizeof(buffer), "%04u-%02u-%02u", year, month, day);
+            } else {
+                length = std::snprintf(buffer, sizeof(buffer), "%02u:%02u:%02u.%04u",
+                                       hours, minutes, seconds, fractions);
             }
+            value.assign(buffer, static_cast<size_t>(length));
         } else if (ctx.field) {
-            // Handle extended types conversion to string
-            auto& env = Environment::getInstance();
-            Firebird::ThrowStatusWrapper status(env.getMaster()->getStatus());
-            Firebird::IUtil* util = env.getUtil();
+            // Numbers, booleans and the zoned types. Only a TIME WITH TIME
+            // ZONE in a region zone needs IUtil, so the environment is not
+            // touched for the others.
             char buffer[128]; // Buffer for string conversions
 
             switch (ctx.field->type) {
-                case SQL_INT128: {
-                    auto int128Helper = util->getInt128(&status);
-                    FB_I128 fb128;
-                    std::memcpy(&fb128, dataPtr, 16);
-                    int128Helper->toString(&status, &fb128, ctx.field->scale, sizeof(buffer), buffer);
-                    value = buffer;
-                    break;
-                }
-                case SQL_DEC16: {
-                    auto decFloat16Helper = util->getDecFloat16(&status);
-                    FB_DEC16 fb16;
-                    std::memcpy(&fb16, dataPtr, 8);
-                    decFloat16Helper->toString(&status, &fb16, sizeof(buffer), buffer);
-                    value = normalize_scientific(buffer);
-                    break;
-                }
-                case SQL_DEC34: {
-                    auto decFloat34Helper = util->getDecFloat34(&status);
-                    FB_DEC34 fb34;
-                    std::memcpy(&fb34, dataPtr, 16);
-                    decFloat34Helper->toString(&status, &fb34, sizeof(buffer), buffer);
-                    value = normalize_scientific(buffer);
-                    break;
-                }
-                case SQL_TIMESTAMP: {
-                    ISC_TIMESTAMP timestamp;
-                    std::memcpy(&timestamp.timestamp_date, dataPtr, 4);
-                    std::memcpy(&timestamp.timestamp_time, dataPtr + 4, 4);
-                    unsigned year, month, day, hours, minutes, seconds, fractions;
-                    util->decodeDate(timestamp.timestamp_date, &year, &month, &day);
-                    util->decodeTime(timestamp.timestamp_time, &hours, &minutes, &seconds, &fractions);
-                    std::snprintf(buffer, sizeof(buffer), "%04u-%02u-%02uT%02u:%02u:%02u.%04u",
-                                  year, month, day, hours, minutes, seconds, fractions);
-                    value = buffer;
-                    break;
-                }
                 case SQL_TIMESTAMP_TZ: {
-                    // The wire value is UTC timestamp + Firebird zone id;
-                    // the engine decodes it back to wall-clock time and a
-                    // zone string ("+05:00" for offset zones, IANA name for
-                    // region zones). The old code read the offset from
-                    // struct padding bytes, which are not part of the type.
-                    ISC_TIMESTAMP_TZ tstz{};
-                    std::memcpy(&tstz.utc_timestamp.timestamp_date, dataPtr, 4);
-                    std::memcpy(&tstz.utc_timestamp.timestamp_time, dataPtr + 4, 4);
-                    std::memcpy(&tstz.time_zone, dataPtr + 8, 2);
+                    // The wire value is UTC timestamp + Firebird zone id.
+                    // Wall-clock time is UTC plus the zone's offset at that
+                    // instant and the zone string ("+05:00" for offset
+                    // zones, IANA name for region zones) is the cached one,
+                    // both from TimeZoneTable: no engine call per value.
+                    uint32_t utc[2];
+                    uint16_t zoneId;
+                    std::memcpy(utc, dataPtr, 8);
+                    std::memcpy(&zoneId, dataPtr + 8, 2);
+                    auto& zones = TimeZoneTable::instance();
+                    int64_t micros = 0;
+                    timestamp_utils::firebird_timestamps_to_unix_micros(utc, 1, &micros);
+                    micros += static_cast<int64_t>(zones.offsetMinutes(zoneId, micros)) * 60000000;
+                    uint32_t local[2];
+                    timestamp_utils::unix_micros_to_firebird_timestamps(&micros, 1, local);
                     unsigned year, month, day, hours, minutes, seconds, fractions;
-                    char tzBuf[64] = {};
-                    util->decodeTimeStampTz(&status, &tstz, &year, &month, &day,
-                                            &hours, &minutes, &seconds, &fractions,
-                                            sizeof(tzBuf), tzBuf);
-                    std::snprintf(buffer, sizeof(buffer), "%04u-%02u-%02uT%02u:%02u:%02u.%04u",
-                                  year, month, day, hours, minutes, seconds, fractions);
-                    std::string out(buffer);
-                    if (tzBuf[0] == '+' || tzBuf[0] == '-') {
-                        out += tzBuf;          // offset zone: append directly
-                    } else if (tzBuf[0] != '\0') {
-                        out += ' ';
-                        out += tzBuf;          // region zone: " Europe/Moscow"
+                    timestamp_utils::decode_firebird_date(local[0], year, month, day);
+                    timestamp_utils::decode_firebird_time(local[1], hours, minutes, seconds,
+                                                          fractions);
+                    const int length = std::snprintf(
+                        buffer, sizeof(buffer), "%04u-%02u-%02uT%02u:%02u:%02u.%04u",
+                        year, month, day, hours, minutes, seconds, fractions);
+                    const std::string& zoneName = zones.name(zoneId);
+                    std::string out;
+                    out.reserve(static_cast<size_t>(length) + 1 + zoneName.size());
+                    out.assign(buffer, static_cast<size_t>(length));
+                    if (!TimeZoneTable::isOffsetZone(zoneId)) {
+                        out += ' ';            // region zone: " Europe/Moscow"
                     }
+                    out += zoneName;           // offset zone: appended directly
                     value = std::move(out);
                     break;
                 }
-                case SQL_TYPE_TIME: {
-                    ISC_TIME time;
-                    std::memcpy(&time, dataPtr, 4);
-                    unsigned hours, minutes, seconds, fractions;
-                    util->decodeTime(time, &hours, &minutes, &seconds, &fractions);
-                    std::snprintf(buffer, sizeof(buffer), "%02u:%02u:%02u.%04u",
-                                  hours, minutes, seconds, fractions);
-                    value = buffer;
-                    break;
-                }
                 case SQL_TIME_TZ: {
-                    // See SQL_TIMESTAMP_TZ above: delegate decoding to the
-                    // engine instead of reading padding bytes.
+                    // Offset zones are plain arithmetic as above. Region
+                    // zones stay with the engine: their offset depends on
+                    // the reference date Firebird picks for TIME values.
                     ISC_TIME_TZ ttz{};
                     std::memcpy(&ttz.utc_time, dataPtr, 4);
                     std::memcpy(&ttz.time_zone, dataPtr + 4, 2);
+                    const uint16_t zoneId = static_cast<uint16_t>(ttz.time_zone);
+                    auto& zones = TimeZoneTable::instance();
                     unsigned hours, minutes, seconds, fractions;
-                    char tzBuf[64] = {};
-                    util->decodeTimeTz(&status, &ttz, &hours, &minutes, &seconds,
-                                       &fractions, sizeof(tzBuf), tzBuf);
+                    if (TimeZoneTable::isOffsetZone(zoneId)) {
+                        constexpr int64_t kTicksPerDay = 24LL * 3600 * 10000;
+                        const int64_t ticks = static_cast<int64_t>(ttz.utc_time) +
+                            static_cast<int64_t>(zones.offsetMinutes(zoneId, 0)) * 600000;
+                        timestamp_utils::decode_firebird_time(
+                            static_cast<uint32_t>(((ticks % kTicksPerDay) + kTicksPerDay) % kTicksPerDay),
+                            hours, minutes, seconds, fractions);
+                    } else {
+                        auto& env = Environment::getInstance();
+                        Firebird::ThrowStatusWrapper status(env.getMaster()->getStatus());
+                        char tzBuf[64] = {};
+                        env.getUtil()->decodeTimeTz(&status, &ttz, &hours, &minutes, &seconds,
+                                                    &fractions, sizeof(tzBuf), tzBuf);
+                    }
                     std::snprintf(buffer, sizeof(buffer), "%02u:%02u:%02u.%04u",
                                   hours, minutes, seconds, fractions);
                     std::string out(buffer);
-                    if (tzBuf[0] == '+' || tzBuf[0] == '-') {
-                        out += tzBuf;
-                    } else if (tzBuf[0] != '\0') {
+                    if (!TimeZoneTable::isOffsetZone(zoneId)) {
                         out += ' ';
-                        out += tzBuf;
                     }
+                    out += zones.name(zoneId);
                     value = std::move(out);
                     break;
                 }
-                case SQL_TYPE_DATE: {
-                    ISC_DATE date;
-                    std::memcpy(&date, dataPtr, 4);
-                    unsigned year, month, day;
-                    util->decodeDate(date, &year, &month, &day);
-                    std::snprintf(buffer, sizeof(buffer), "%04u-%02u-%02u", year, month, day);
-                    value = buffer;
-                    break;
-                }
                 case SQL_SHORT: {
                     int16_t v;
                     std::memcpy(&v, dataPtr, 2);
                     if (ctx.field->scale < 0) {
                         value = decimal_to_string_i64(v, ctx.field->scale);
                     } else {
-                        value = std::to_string(v);
+                        assign_number(value, v);
                     }
                     break;
                 }
@@ -926,7 +1050,7 @@ void read_sql_value(const SqlReadContext& ctx, const uint8_t* dataPtr, T& value)
                     if (ctx.field->scale < 0) {
                         value = decimal_to_string_i64(v, ctx.field->scale);
                     } else {
-                        value = std::to_string(v);
+                        assign_number(value, v);
                     }
                     break;
                 }
@@ -936,21 +1060,21 @@ void read_sql_value(const SqlReadContext& ctx, const uint8_t* dataPtr, T& value)
                     if (ctx.field->scale < 0) {
                         value = decimal_to_string_i64(v, ctx.field->scale);
                     } else {
-                        value = std::to_string(v);
+                        assign_number(value, v);
                     }
                     break;
                 }
                 case SQL_FLOAT: {
                     float v;
                     std::memcpy(&v, dataPtr, 4);
-                    value = std::to_string(v);
+                    assign_number(value, v);   // Shortest round-trip, not %f
                     break;
                 }
                 case SQL_DOUBLE:
                 case SQL_D_FLOAT: {
                     double v;
                     std::memcpy(&v, dataPtr, 8);
-                    value = std::to_string(v);
+                    assign_number(value, v);
                     break;
                 }
                 case SQL_BOOLEAN: {
@@ -1004,7 +1128,39 @@ void read_sql_value(const SqlReadContext& ctx, const uint8_t* dataPtr, T& value)
     } else if constexpr (std::is_same_v<ValueType, Blob>) {
         value = Blob(dataPtr);
     } else if constexpr (std::is_same_v<ValueType, TextBlob>) {
-        value = TextBlob(dataPtr);
+        if (!ctx.transaction) {
+            value = TextBlob(dataPtr);
+            return;
+        }
+        // Read on first getText(), through whichever copy asks first. The
+        // weak reference makes a late read fail cleanly instead of using a
+        // transaction that is gone; a transaction nobody owns is read now.
+        auto load = [](Transaction& transaction, const uint8_t* id) {
+            ISC_QUAD blobId{};
+            std::memcpy(&blobId, id, sizeof(ISC_QUAD));
+            auto reader = transaction.openBlob(blobId);
+            std::string text;
+            text.reserve(static_cast<size_t>(reader.info().totalLength));
+            reader.readAll([&](std::span<const std::byte> chunk) {
+                text.append(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+            });
+            return text;
+        };
+        std::weak_ptr<Transaction> owner = ctx.transaction->weak_from_this();
+        if (owner.expired()) {
+            value = TextBlob(dataPtr);
+            if (!value.isNull()) {
+                value.setText(load(*ctx.transaction, dataPtr));
+            }
+            return;
+        }
+        value = TextBlob(dataPtr, [owner = std::move(owner), load](const uint8_t* id) {
+            auto transaction = owner.lock();
+            if (!transaction || !transaction->isActive()) {
+                throw FirebirdException("TextBlob: the transaction that fetched it has ended");
+            }
+            return load(*transaction, id);
+        });
     } else {
         std::memcpy(&value, dataPtr, sizeof(ValueType));
     }
@@ -0,0 +1,163 @@
+#pragma once
+
+// Byte scanning for CHAR / VARCHAR values in fetch buffers.
+//
+// CHAR(n) arrives blank-padded to its full byte length (4*n for UTF8), so
+// trimming is the dominant cost of text-heavy fetches. trimmedLength()
+// compares 32 (AVX2) or 16 (SSE2 / NEON) bytes per step from the end and
+// falls back to a scalar loop for the remainder. findCsvSpecial() scans
+// forward the same way for the bytes that force CSV quoting. The
+// instruction set is picked at compile time from the target flags; no
+// runtime dispatch.
+
+#include "fbpp/core/firebird_compat.hpp"
+#include "fbpp/core/message_metadata.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define FBPP_TEXT_SCAN_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FBPP_TEXT_SCAN_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define FBPP_TEXT_SCAN_NEON 1
+#endif
+
+namespace fbpp {
+namespace core {
+namespace detail {
+
+/// Length of `data[0, length)` without its trailing ' ' bytes
+inline std::size_t trimmedLength(const char* data, std::size_t length) noexcept {
+    std::size_t end = length;
+#if defined(FBPP_TEXT_SCAN_AVX2)
+    const __m256i blanks = _mm256_set1_epi8(' ');
+    while (end >= 32) {
+        const __m256i block = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(data + end - 32));
+        const auto nonBlank = ~static_cast<uint32_t>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, blanks)));
+        if (nonBlank != 0) {
+            return end - static_cast<std::size_t>(std::countl_zero(nonBlank));
+        }
+        end -= 32;
+    }
+#elif defined(FBPP_TEXT_SCAN_SSE2)
+    const __m128i blanks = _mm_set1_epi8(' ');
+    while (end >= 16) {
+        const __m128i block = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(data + end - 16));
+        const auto nonBlank = static_cast<uint16_t>(
+            ~_mm_movemask_epi8(_mm_cmpeq_epi8(block, blanks)));
+        if (nonBlank != 0) {
+            return end - static_cast<std::size_t>(std::countl_zero(nonBlank));
+        }
+        end -= 16;
+    }
+#elif defined(FBPP_TEXT_SCAN_NEON)
+    const uint8x16_t blanks = vdupq_n_u8(' ');
+    while (end >= 16) {
+        const uint8x16_t block = vld1q_u8(reinterpret_cast<const uint8_t*>(data + end - 16));
+        if (vminvq_u8(vceqq_u8(block, blanks)) != 0xFF) {
+            break;   // Non-blank in this block: the scalar loop finds it
+        }
+        end -= 16;
+    }
+#endif
+    while (end > 0 && data[end - 1] == ' ') {
+        --end;
+    }
+    return end;
+}
+
+/**
+ * @brief Index of the first `delimiter`, `quote`, '\r' or '\n' in
+ *        `data[0, length)`, or `length` if there is none
+ */
+inline std::size_t findCsvSpecial(const char* data, std::size_t length,
+                                  char delimiter, char quote) noexcept {
+    std::size_t pos = 0;
+#if defined(FBPP_TEXT_SCAN_AVX2)
+    const __m256i d = _mm256_set1_epi8(delimiter);
+    const __m256i q = _mm256_set1_epi8(quote);
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i lf = _mm256_set1_epi8('\n');
+    for (; pos + 32 <= length; pos += 32) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+        const __m256i hit = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, d), _mm256_cmpeq_epi8(block, q)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, cr), _mm256_cmpeq_epi8(block, lf)));
+        if (const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(hit))) {
+            return pos + static_cast<std::size_t>(std::countr_zero(mask));
+        }
+    }
+#elif defined(FBPP_TEXT_SCAN_SSE2)
+    const __m128i d = _mm_set1_epi8(delimiter);
+    const __m128i q = _mm_set1_epi8(quote);
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i lf = _mm_set1_epi8('\n');
+    for (; pos + 16 <= length; pos += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        const __m128i hit = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(block, d), _mm_cmpeq_epi8(block, q)),
+            _mm_or_si128(_mm_cmpeq_epi8(block, cr), _mm_cmpeq_epi8(block, lf)));
+        if (const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(hit))) {
+            return pos + static_cast<std::size_t>(std::countr_zero(mask));
+        }
+    }
+#elif defined(FBPP_TEXT_SCAN_NEON)
+    const uint8x16_t d = vdupq_n_u8(static_cast<uint8_t>(delimiter));
+    const uint8x16_t q = vdupq_n_u8(static_cast<uint8_t>(quote));
+    const uint8x16_t cr = vdupq_n_u8('\r');
+    const uint8x16_t lf = vdupq_n_u8('\n');
+    for (; pos + 16 <= length; pos += 16) {
+        const uint8x16_t block = vld1q_u8(reinterpret_cast<const uint8_t*>(data + pos));
+        const uint8x16_t hit = vorrq_u8(vorrq_u8(vceqq_u8(block, d), vceqq_u8(block, q)),
+                                        vorrq_u8(vceqq_u8(block, cr), vceqq_u8(block, lf)));
+        if (vmaxvq_u8(hit) != 0) {
+            break;   // Hit in this block: the scalar loop finds it
+        }
+    }
+#endif
+    for (; pos < length; ++pos) {
+        const char c = data[pos];
+        if (c == delimiter || c == quote || c == '\r' || c == '\n') {
+            return pos;
+        }
+    }
+    return length;
+}
+
+/**
+ * @brief View of a CHAR (trimmed) or VARCHAR value in a message buffer
+ *
+ * `field` must be SQL_TEXT or SQL_VARYING; the view aliases `dataPtr`.
+ */
+inline std::string_view textView(unsigned type, unsigned length, const uint8_t* dataPtr) noexcept {
+    const auto* chars = reinterpret_cast<const char*>(dataPtr);
+    if (type == SQL_VARYING) {
+        uint16_t used = 0;
+        std::memcpy(&used, dataPtr, sizeof(used));
+        return std::string_view(chars + sizeof(uint16_t), used);
+    }
+    return std::string_view(chars, trimmedLength(chars, length));
+}
+
+inline std::string_view textView(const FieldInfo& field, const uint8_t* dataPtr) noexcept {
+    return textView(field.type, field.length, dataPtr);
+}
+
+inline bool isTextField(const FieldInfo& field) noexcept {
+    return field.type == SQL_TEXT || field.type == SQL_VARYING;
+}
+
+} // namespace detail
+} // namespace core
+} // namespace fbpp
@@ -0,0 +1,136 @@
+#pragma once
+
+// DistributedTransaction — client-coordinated two-phase commit over several
+// attachments.
+//
+// One Transaction per participant Connection:
+//
+//   DistributedTransactionOptions options;
+//   options.logFile = "/var/lib/app/2pc.log";
+//   DistributedTransaction dtx({&orders, &billing}, options);
+//   dtx[0].execute(debit, std::make_tuple(account, amount));
+//   dtx[1].execute(credit, std::make_tuple(account, amount));
+//   dtx.commit();
+//
+// commit() prepares every participant at once (a thread per participant
+// but the first, which runs on the caller), so phase 1 costs one round
+// trip however many databases take part; phase 2 commits the same way.
+// IDtc (the client library's own coordinator) runs each phase one
+// participant after another.
+//
+// Between the phases the decision is appended to logFile and synced to
+// disk. A coordinator that dies after that point leaves prepared
+// transactions in limbo that recover() commits; one that dies before it
+// leaves prepared transactions that recover() rolls back (presumed
+// abort). The log starts with a coordinator id generated on first use;
+// every prepare message carries it along with the global id, so recover()
+// touches only limbo transactions prepared against the same log, and
+// coordinators with other logs may keep running meanwhile. Without a
+// logFile nothing is written and limbo transactions can only be rolled
+// back; they share one anonymous coordinator, so recover() with an empty
+// logFile must run while no log-less DistributedTransaction is prepared.
+//
+// A log belongs to one coordinator process at a time: recover() rolls back
+// whatever of its log is prepared and undecided, so run it at startup,
+// before that process begins new transactions.
+//
+// Participants must be distinct connections, each used by no other
+// thread while the transaction is open.
+
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/transaction_options.hpp"
+
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fbpp {
+namespace core {
+
+struct DistributedTransactionOptions {
+    // Options of every participant's transaction
+    TransactionOptions transaction;
+    // Decision log for recover(); empty = none
+    std::filesystem::path logFile;
+    // Run the phases on a thread per participant; false = one after another
+    bool parallel = true;
+};
+
+/**
+ * @brief What DistributedTransaction::recover() resolved
+ */
+struct DistributedRecovery {
+    size_t committed = 0;
+    size_t rolledBack = 0;
+};
+
+class DistributedTransaction {
+public:
+    enum class State { Active, Prepared, Committed, RolledBack, InDoubt };
+
+    DistributedTransaction(std::vector<Connection*> participants,
+                           DistributedTransactionOptions options = {});
+    /// Rolls back unless committed or rolled back already
+    ~DistributedTransaction();
+
+    DistributedTransaction(const DistributedTransaction&) = delete;
+    DistributedTransaction& operator=(const DistributedTransaction&) = delete;
+
+    size_t size() const noexcept { return transactions_.size(); }
+
+    /// Transaction of participant i, for statements on its connection
+    Transaction& operator[](size_t i) const { return *transactions_.at(i); }
+    const std::shared_ptr<Transaction>& transaction(size_t i) const { return transactions_.at(i); }
+
+    /// Global id written into prepare messages and the log
+    const std::string& id() const noexcept { return id_; }
+    State state() const noexcept { return state_; }
+
+    /**
+     * @brief Phase 1 on every participant, concurrently
+     *
+     * If any participant fails, all are rolled back and the first error
+     * is thrown.
+     */
+    void prepare();
+
+    /**
+     * @brief prepare() if needed, log the decision, then phase 2 concurrently
+     *
+     * A participant whose commit fails after the decision is left in limbo
+     * (state() InDoubt) for recover(), and the error is thrown.
+     */
+    void commit();
+
+    /// Roll back every participant (prepared or not); throws the first error
+    void rollback();
+
+    /**
+     * @brief Resolve this coordinator's limbo transactions on `databases`
+     *
+     * Commits those whose decision is in `logFile`, rolls back the others
+     * prepared under the log's coordinator id, and leaves those of other
+     * logs (and of non-DistributedTransaction coordinators) alone.
+     */
+    static DistributedRecovery recover(const std::vector<Connection*>& databases,
+                                       const std::filesystem::path& logFile);
+
+private:
+    template<typename Fn>
+    std::vector<std::exception_ptr> forEach(Fn&& fn);
+
+    void rollbackQuietly() noexcept;
+
+    std::vector<Connection*> participants_;
+    std::vector<std::shared_ptr<Transaction>> transactions_;
+    DistributedTransactionOptions options_;
+    std::string id_;
+    State state_ = State::Active;
+};
+
+} // namespace core
+} // namespace fbpp
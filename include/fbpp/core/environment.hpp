@@ -1,7 +1,14 @@
 #pragma once
 
 #include "fbpp/core/firebird_compat.hpp"
+#include "fbpp/core/startup_profile.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <mutex>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace fbpp {
 namespace core {
@@ -11,9 +18,17 @@ namespace core {
  *
  * Thread-safety contract:
  * - Construction uses C++ local-static initialization and is safe to race.
- * - After initialization the object is immutable and may be read concurrently.
+ * - Construction only initializes the master interface. The dispatcher
+ *   (getProvider()) and IUtil (getUtil()) are fetched on first use, once,
+ *   so code that never attaches does not load them (see startup_profile.hpp).
+ * - The interfaces never change once fetched and may be read concurrently.
  * - This singleton intentionally models process-wide Firebird interfaces, not a
  *   per-connection or per-library-instance sandbox.
+ *
+ * Embedded use: the client library loads the in-process engine when an
+ * attachment asks for its provider (ConnectionParams::providers, see
+ * ConnectionParams::embedded()). setRootDirectory() points the library at
+ * the directory holding firebird.conf, plugins/ and the message files.
  */
 class Environment {
 public:
@@ -22,9 +37,104 @@ public:
         return instance;
     }
 
-    Firebird::IMaster*   getMaster()   const { return master_;   }
-    Firebird::IProvider* getProvider() const { return provider_; }
-    Firebird::IUtil*     getUtil()     const { return util_;     }
+    /**
+     * Set the Firebird root directory (the FIREBIRD environment variable)
+     * for this process. The client library reads it once, so this must run
+     * before the first getInstance(); throws afterwards.
+     */
+    static void setRootDirectory(const std::string& directory) {
+        if (initialized().load(std::memory_order_acquire)) {
+            throw std::runtime_error("Firebird root directory must be set before first use");
+        }
+#if defined(_WIN32)
+        _putenv_s("FIREBIRD", directory.c_str());
+#else
+        setenv("FIREBIRD", directory.c_str(), 1);
+#endif
+    }
+
+    /**
+     * Shut down every provider, closing all attachments of this process.
+     * Embedded engines flush and stop their threads; call on orderly exit.
+     * No Connection may be used afterwards.
+     */
+    void shutdown(unsigned timeoutMs = 0) const {
+        Firebird::IProvider* provider = getProvider();
+        Firebird::ThrowStatusWrapper status(master_->getStatus());
+        try {
+            provider->shutdown(&status, timeoutMs, fb_shutrsn_app_stopped);
+        } catch (...) {
+            status.dispose();
+            throw;
+        }
+        status.dispose();
+    }
+
+    /**
+     * Borrow a cleared IStatus from the calling thread's pool, or a new one
+     * from the master when the pool is empty. Wrapper objects (cursors,
+     * statements, transactions, batches, BLOBs) take theirs here, so
+     * creating and dropping them does not allocate once the pool is warm.
+     */
+    Firebird::IStatus* acquireStatus() const {
+        if (!statusPoolGone()) {
+            auto& pool = statusPool();
+            if (!pool.statuses.empty()) {
+                Firebird::IStatus* status = pool.statuses.back();
+                pool.statuses.pop_back();
+                return status;
+            }
+        }
+        return master_->getStatus();
+    }
+
+    /**
+     * Give a status back (from any thread: it joins that thread's pool).
+     * Statuses beyond the pool size, and any released while the thread
+     * exits, are disposed. Null is ignored.
+     */
+    void releaseStatus(Firebird::IStatus* status) const noexcept {
+        if (!status) {
+            return;
+        }
+        if (!statusPoolGone()) {
+            auto& pool = statusPool();
+            if (pool.statuses.size() < kStatusPoolSize) {
+                status->init();
+                pool.statuses.push_back(status);   // Capacity reserved up front
+                return;
+            }
+        }
+        status->dispose();
+    }
+
+    Firebird::IMaster* getMaster() const { return master_; }
+
+    /// The dispatcher; throws std::runtime_error if the library has none
+    Firebird::IProvider* getProvider() const {
+        std::call_once(providerOnce_, [this] {
+            const auto started = detail::startupClock(StartupPhase::ProviderLoad);
+            provider_ = master_->getDispatcher();
+            if (!provider_)
+                throw std::runtime_error("Failed to get Firebird provider interface");
+            detail::recordStartupPhase(StartupPhase::ProviderLoad, started);
+        });
+        return provider_;
+    }
+
+    /// The utility interface; throws std::runtime_error if the library has none
+    Firebird::IUtil* getUtil() const {
+        Firebird::IUtil* util = util_.load(std::memory_order_acquire);
+        if (!util) {
+            // The master hands out one process-wide IUtil: racing callers
+            // store the same pointer
+            util = master_->getUtilInterface();
+            if (!util)
+                throw std::runtime_error("Failed to get Firebird util interface");
+            util_.store(util, std::memory_order_release);
+        }
+        return util;
+    }
 
     Environment(const Environment&)            = delete;
     Environment& operator=(const Environment&) = delete;
@@ -32,26 +142,54 @@ public:
     Environment& operator=(Environment&&)      = delete;
 
 private:
-    Environment()
-        : master_(Firebird::fb_get_master_interface())
-        , provider_(nullptr)
-        , util_(nullptr)
-    {
+    Environment() {
+        const auto started = detail::startupClock(StartupPhase::MasterInit);
+        master_ = Firebird::fb_get_master_interface();
         if (!master_)
             throw std::runtime_error("Failed to get Firebird master interface");
-        provider_ = master_->getDispatcher();
-        if (!provider_)
-            throw std::runtime_error("Failed to get Firebird provider interface");
-        util_ = master_->getUtilInterface();
-        if (!util_)
-            throw std::runtime_error("Failed to get Firebird util interface");
+        detail::recordStartupPhase(StartupPhase::MasterInit, started);
+        initialized().store(true, std::memory_order_release);
+    }
+
+    static std::atomic<bool>& initialized() {
+        static std::atomic<bool> flag{false};
+        return flag;
     }
 
     ~Environment() = default; // Interfaces are managed by Firebird
 
-    Firebird::IMaster*   master_;
-    Firebird::IProvider* provider_;
-    Firebird::IUtil*     util_;
+    // Idle statuses kept per thread; a request rarely has more wrappers alive
+    static constexpr std::size_t kStatusPoolSize = 32;
+
+    struct StatusPool {
+        std::vector<Firebird::IStatus*> statuses;
+
+        StatusPool() { statuses.reserve(kStatusPoolSize); }
+        ~StatusPool() {
+            statusPoolGone() = true;
+            for (auto* status : statuses) {
+                status->dispose();
+            }
+        }
+    };
+
+    static StatusPool& statusPool() {
+        static thread_local StatusPool pool;
+        return pool;
+    }
+
+    // Set once the thread's pool is destroyed: wrappers dropped by later
+    // thread-exit destructors dispose their statuses directly
+    static bool& statusPoolGone() noexcept {
+        static thread_local bool gone = false;
+        return gone;
+    }
+
+    Firebird::IMaster* master_ = nullptr;
+    // Fetched on first use (getProvider() / getUtil())
+    mutable std::once_flag providerOnce_;
+    mutable Firebird::IProvider* provider_ = nullptr;
+    mutable std::atomic<Firebird::IUtil*> util_{nullptr};
 };
 
 } // namespace core
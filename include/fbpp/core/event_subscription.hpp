@@ -0,0 +1,106 @@
+#pragma once
+
+// Database events (POST_EVENT) delivered to client callbacks.
+//
+// Every Connection multiplexes all of its subscriptions over one
+// IAttachment::queEvents registration: names subscribed by any number of
+// EventSubscriptions are packed into a single event parameter block (EPB),
+// and a name shared by several subscriptions is registered once. One
+// dispatcher thread per connection re-arms the registration and invokes
+// the callbacks, so subscribing to hundreds of table-change events costs
+// one round trip per change of the name set and no thread per name.
+//
+//   auto sub = conn.subscribeEvents({"CHG$ORDERS", "CHG$ITEMS"},
+//       [&](const std::string& name, unsigned count) { ... });
+//
+// Delivery:
+//  - Events are delivered when the posting transaction commits; a rollback
+//    posts nothing. `count` is the number of posts since the last callback.
+//  - The first answer of the server to a new registration only reports the
+//    current counters (priming) and is not delivered.
+//  - Firebird events fire once: the dispatcher re-queues the registration
+//    before it runs callbacks, so posts made meanwhile are not lost.
+//  - Posts arriving within ConnectionOptions::eventBatchWindow of each
+//    other are coalesced into one batch per subscription.
+//
+// Callbacks run on the dispatcher thread, never on the caller's: they must
+// not use the Connection (it is not thread-safe) and should only hand the
+// notification over — signal a queue, invalidate a cache. A callback may
+// cancel subscriptions, including its own. Remote events need the server's
+// RemoteAuxPort reachable from the client.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fbpp::core {
+
+class Connection;
+
+namespace detail {
+class EventHub;
+}
+
+/**
+ * @brief One event name and the number of posts since it was last delivered
+ */
+struct EventNotification {
+    std::string name;
+    unsigned count = 0;
+};
+
+/**
+ * @brief Event counters of one connection
+ */
+struct EventStatistics {
+    std::size_t subscriptions = 0;
+    std::size_t names = 0;           // Distinct names registered
+    std::size_t registrations = 0;   // Live queEvents registrations
+    std::uint64_t queued = 0;        // queEvents calls so far
+    std::uint64_t deliveries = 0;    // Answers of the server, priming included
+    std::uint64_t batches = 0;       // Batches handed to callbacks
+};
+
+/**
+ * @brief Handle of a subscription made by Connection::subscribeEvents()
+ *
+ * Non-copyable, non-movable and internally synchronized. Destroying the
+ * handle cancels the subscription. Once cancel() returns its callback is
+ * not running and will not run again (unless cancel() is called from the
+ * callback itself, which then finishes normally). Subscriptions stop
+ * delivering when their Connection is destroyed.
+ */
+class EventSubscription {
+public:
+    using Callback = std::function<void(const std::string& name, unsigned count)>;
+    using BatchCallback = std::function<void(const std::vector<EventNotification>& events)>;
+
+    ~EventSubscription();
+
+    EventSubscription(const EventSubscription&) = delete;
+    EventSubscription& operator=(const EventSubscription&) = delete;
+
+    /// Stop delivery; idempotent
+    void cancel();
+
+    bool isActive() const noexcept;
+
+    const std::vector<std::string>& names() const noexcept { return names_; }
+
+private:
+    friend class Connection;
+
+    EventSubscription(std::shared_ptr<detail::EventHub> hub, std::uint64_t id,
+                      std::vector<std::string> names);
+
+    std::shared_ptr<detail::EventHub> hub_;
+    std::uint64_t id_;
+    std::vector<std::string> names_;
+    std::atomic<bool> active_{true};
+};
+
+} // namespace fbpp::core
@@ -3,6 +3,8 @@
 #include "fbpp/core/firebird_compat.hpp"
 #include <cstdint>
 #include <exception>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -37,31 +39,44 @@ struct FirebirdStatusEntry {
  * - `getErrorMessages()` returns parsed per-entry messages.
  * - `getStatusVector()` returns a copied snapshot of the original Firebird
  *   status vector payloads in a stable C++ representation.
+ *
+ * Construction from a Firebird status only copies the vector and computes
+ * the codes; the texts behind `what()` and `getErrorMessages()` are
+ * formatted on first use (once per exception and its copies), so retry
+ * loops that inspect codes only never pay for message lookup.
  */
 class FirebirdException : public std::exception {
 public:
     explicit FirebirdException(std::string message);
     explicit FirebirdException(const Firebird::FbException& fb_ex);
 
-    const char* what() const noexcept override { return message_.c_str(); }
+    const char* what() const noexcept override;
 
     int getErrorCode() const noexcept { return error_code_; }
     const std::string& getSQLState() const noexcept { return sql_state_; }
     int getSQLCode() const noexcept { return sql_code_; }
-    const std::vector<std::string>& getErrorMessages() const noexcept { return error_messages_; }
+    const std::vector<std::string>& getErrorMessages() const noexcept;
     const std::vector<FirebirdStatusEntry>& getStatusVector() const noexcept {
         return status_vector_;
     }
 
 private:
-    std::string message_;
+    // Texts formatted from status_vector_, shared by copies of the exception
+    struct Formatted {
+        std::once_flag once;
+        std::string message;
+        std::vector<std::string> errorMessages;
+    };
+
+    std::string message_;          // Set by the message constructor only
     int         error_code_ {0};
     std::string sql_state_;
     int         sql_code_ {0};
-    std::vector<std::string> error_messages_;
     std::vector<FirebirdStatusEntry> status_vector_;
+    std::shared_ptr<Formatted> formatted_;
 
     void extractErrorDetails(Firebird::IStatus* status);
+    const Formatted* formatted() const noexcept;
 };
 
 } // namespace core
@@ -0,0 +1,196 @@
+#pragma once
+
+// ExecuteBlockBatch — many rows of one INSERT ... RETURNING in one round
+// trip.
+//
+// IBatch returns no RETURNING values, so inserts that need their generated
+// keys back otherwise run row by row. ExecuteBlockBatch packs up to
+// maxRows rows into one parameterized EXECUTE BLOCK that runs the INSERT
+// once per row and SUSPENDs its RETURNING values:
+//
+//   fbpp::core::ExecuteBlockBatch insert(conn,
+//       "INSERT INTO item (name, qty) VALUES (?, ?) RETURNING id");
+//   auto ids = insert.returning<std::tuple<int32_t>>(*tx, items);   // ids[i] for items[i]
+//
+// The block for K rows takes K times the statement's parameters plus a row
+// count; K is rounded up to a power of two (as NamedParamParser::expandList
+// does for IN-lists), the slots past the count are skipped, and each shape
+// is prepared once and kept. Returned rows come back in input order. The
+// block's parameters and outputs are declared with the types the server
+// describes for the statement, so rows bind exactly as they would to the
+// statement itself.
+//
+// The statement must be an INSERT (or UPDATE OR INSERT) with a RETURNING
+// clause: one returned row per input row.
+//
+// With ExecuteBlockOptions::rowCounts the statement is instead any DML
+// without RETURNING, and execute() runs packed messages through the blocks
+// the way Batch::execute() runs them through IBatch: each row's statement
+// sits in its own WHEN ANY block, and the block returns its row count or its
+// GDSCODE / SQLSTATE. This is BulkLoader's path on servers without IBatch
+// (before Firebird 4).
+
+#include "fbpp/core/batch.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/message_metadata.hpp"
+#include "fbpp/core/pack_plan.hpp"
+#include "fbpp/core/pack_utils.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/row.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace fbpp {
+namespace core {
+
+struct ExecuteBlockOptions {
+    /// Rows per block, rounded down to a power of two; also capped so the
+    /// block's input message stays within Firebird's 64 KB
+    std::size_t maxRows = 64;
+    /// DML without RETURNING, run through execute() with per-row counts
+    bool rowCounts = false;
+    /// execute(): keep running the rows after a failed one; otherwise the
+    /// rest of the block and later blocks are skipped, as IBatch without
+    /// TAG_MULTIERROR does
+    bool continueOnError = false;
+};
+
+class ExecuteBlockBatch {
+public:
+    /// `sql` is the single-row statement, positional or with named parameters
+    ExecuteBlockBatch(Connection& connection, std::string sql, ExecuteBlockOptions options = {});
+    /// Same for a statement already prepared on `connection`
+    ExecuteBlockBatch(Connection& connection, std::shared_ptr<Statement> statement,
+                      ExecuteBlockOptions options = {});
+
+    /**
+     * @brief Insert `rows`, calling `sink(rowIndex, view)` per returned row
+     *
+     * Row is a tuple or described struct with one value per parameter, as
+     * Transaction::execute() takes. The RowView is valid during the call only.
+     *
+     * @return Rows returned
+     */
+    template<typename Row, typename Sink>
+    std::size_t each(Transaction& transaction, std::span<const Row> rows, Sink&& sink);
+
+    /// Insert `rows`; result[i] holds the RETURNING values of rows[i]
+    template<typename Out, typename Row>
+    std::vector<Out> returning(Transaction& transaction, std::span<const Row> rows);
+
+    template<typename Out, typename Row>
+    std::vector<Out> returning(Transaction& transaction, const std::vector<Row>& rows) {
+        return returning<Out>(transaction, std::span<const Row>(rows));
+    }
+
+    /**
+     * @brief Run `count` messages packed against the statement's input metadata
+     *
+     * rowCounts mode only. Message i starts at `messages + i * stride`. The
+     * result reads like Batch::execute()'s: perMessageStatus holds each
+     * row's count or -1, and errors "Message N: ..." the first `maxErrors`
+     * failures' SQLSTATE and GDSCODE. Without continueOnError it stops after
+     * the first failure and covers only the rows that ran.
+     */
+    BatchResult execute(Transaction& transaction, const std::uint8_t* messages, std::size_t count,
+                        std::size_t stride, std::size_t maxErrors = BatchCompletion::kAllErrors);
+
+    /// Most rows one block carries
+    std::size_t rowsPerBlock() const noexcept { return rowsPerBlock_; }
+    /// Block shapes prepared so far
+    std::size_t shapes() const noexcept { return shapes_.size(); }
+    /// Text of the block for `slots` rows
+    std::string blockSql(std::size_t slots) const;
+
+private:
+    struct Shape {
+        std::shared_ptr<Statement> statement;
+        std::shared_ptr<const MessageMetadata> input;
+        std::vector<std::uint8_t> message;   // Reused input message
+    };
+
+    // The statement with slot `slot`'s block parameters for its markers
+    std::string slotStatement(std::size_t slot) const;
+    // Declarations and body of a rowCounts block, after the parameters
+    std::string countedBody(std::size_t slots) const;
+    // Prepared block for `rows` rows (rounded up to a power of two)
+    Shape& shapeFor(std::size_t rows);
+    // Block message with every slot NULL and the row count set
+    void reset(Shape& shape, std::size_t rows) const;
+    // Copy one packed row message of the statement into block slot `slot`
+    void place(Shape& shape, const std::uint8_t* row, std::size_t slot) const;
+
+    Connection& connection_;
+    std::shared_ptr<Statement> statement_;
+    std::shared_ptr<const MessageMetadata> rowInput_;
+    std::vector<std::string> pieces_;           // Positional SQL split at its '?'
+    std::vector<std::string> parameterTypes_;   // Declared type per parameter
+    std::vector<std::string> outputNames_;
+    std::vector<std::string> outputTypes_;
+    std::size_t rowsPerBlock_ = 1;
+    bool rowCounts_ = false;
+    bool continueOnError_ = false;
+    std::map<std::size_t, Shape> shapes_;       // By slot count
+    std::vector<std::uint8_t> row_;             // One packed row message
+};
+
+template<typename Row, typename Sink>
+std::size_t ExecuteBlockBatch::each(Transaction& transaction, std::span<const Row> rows,
+                                    Sink&& sink) {
+    if (rowCounts_) {
+        throw FirebirdException("ExecuteBlockBatch: rowCounts statements run through execute()");
+    }
+    std::size_t returned = 0;
+    for (std::size_t begin = 0; begin < rows.size(); begin += rowsPerBlock_) {
+        const std::size_t count = std::min(rowsPerBlock_, rows.size() - begin);
+        Shape& shape = shapeFor(count);
+        reset(shape, count);
+        if (rowInput_) {
+            const auto& plan = PackPlan<Row>::of(*rowInput_);
+            for (std::size_t i = 0; i < count; ++i) {
+                std::fill(row_.begin(), row_.end(), std::uint8_t{0});
+                plan.pack(rows[begin + i], row_.data(), &transaction);
+                place(shape, row_.data(), i);
+            }
+        }
+
+        auto cursor = transaction.openCursorMessage(shape.statement,
+                                                    shape.input->getRawMetadata(),
+                                                    shape.message.data());
+        std::size_t index = begin;
+        for (const auto& view : cursor->rows()) {
+            sink(index++, view);
+        }
+        cursor->close();
+        if (index != begin + count) {
+            throw FirebirdException("ExecuteBlockBatch: " + std::to_string(count) +
+                                    " rows returned " + std::to_string(index - begin));
+        }
+        returned += count;
+    }
+    return returned;
+}
+
+template<typename Out, typename Row>
+std::vector<Out> ExecuteBlockBatch::returning(Transaction& transaction,
+                                              std::span<const Row> rows) {
+    std::vector<Out> result;
+    result.reserve(rows.size());
+    each(transaction, rows, [&](std::size_t, const RowView& view) {
+        result.push_back(unpack<Out>(view.data(), &view.metadata(), view.transaction()));
+    });
+    return result;
+}
+
+} // namespace core
+} // namespace fbpp
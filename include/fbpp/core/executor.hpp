@@ -0,0 +1,268 @@
+#pragma once
+
+// Executor — the library's one thread pool.
+//
+// Async connections, parallel decode, sharded fan-out, parallel sorts,
+// pipelined batches and background warm-up all need threads. Rather than
+// each of them starting its own, they post to an Executor, by default the
+// process-wide Executor::shared(), so the process runs one set of workers
+// sized to its cores (or to setSharedThreadCount()):
+//
+//   fbpp::core::Executor::setSharedThreadCount(8);     // once, before first use
+//   auto& pool = *fbpp::core::Executor::shared();
+//   pool.parallelFor(parts.size(), [&](std::size_t i) { decode(parts[i]); });
+//
+//   fbpp::core::Strand strand;                         // one per Connection
+//   strand.post([&] { conn.ExecuteDDL(ddl); });        // runs after earlier posts
+//
+// Each worker owns a task deque. A task posted from a worker goes to that
+// worker's deque, one posted from elsewhere to the next deque round-robin;
+// a worker takes the oldest task of its own deque and, when that is empty,
+// steals the newest one of another worker's, so bursts posted on one
+// thread spread over the pool without a shared queue. Idle workers sleep.
+//
+// Waiting inside a task for other tasks (TaskGroup::wait(), parallelFor(),
+// waitHelping()) runs queued tasks on the waiting worker meanwhile, so
+// nested fan-out does not deadlock a small pool. Blocking calls (a query,
+// a fetch) still hold their worker while they block: size the shared pool
+// for the mix, or give I/O-bound fan-out an Executor of its own.
+//
+// A Connection is not thread-safe: post everything that uses one through
+// the same Strand, which runs its tasks one at a time, in order, on any
+// worker, without reserving a thread between them.
+//
+// A task that throws is traced and dropped; TaskGroup carries exceptions
+// back to its waiter. The destructor runs every task already posted (and
+// any they post), then joins. The shared executor is never destroyed.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fbpp {
+namespace core {
+
+/// Counters of an Executor since construction
+struct ExecutorStats {
+    uint64_t posted = 0;
+    uint64_t executed = 0;
+    uint64_t stolen = 0;       ///< Tasks a worker took from another worker's deque
+    uint64_t helped = 0;       ///< Tasks run by a worker waiting in waitHelping()
+};
+
+class Executor {
+public:
+    using Task = std::function<void()>;
+
+    explicit Executor(std::size_t threads = std::thread::hardware_concurrency());
+    ~Executor();
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    /**
+     * @brief The process-wide executor, started on first use
+     *
+     * Sized by setSharedThreadCount(), else to the hardware threads. Its
+     * workers live until the process exits.
+     */
+    static const std::shared_ptr<Executor>& shared();
+
+    /**
+     * @brief Workers of shared(); 0 = hardware threads
+     * @throws FirebirdException once shared() runs with another count
+     */
+    static void setSharedThreadCount(std::size_t threads);
+
+    void post(Task task);
+
+    std::size_t threadCount() const noexcept { return workers_.size(); }
+
+    /// The calling thread is one of this executor's workers
+    bool onWorkerThread() const noexcept;
+
+    /**
+     * @brief Run one queued task on the calling worker
+     * @return false when nothing was queued or the caller is not a worker
+     */
+    bool runPendingTask();
+
+    /**
+     * @brief Wait on `ready` under `lock` until `done()` holds
+     *
+     * On a worker of this executor, queued tasks run meanwhile (and the
+     * wait re-checks every millisecond), so the tasks being waited for
+     * cannot be stuck behind the waiter. Elsewhere an ordinary wait.
+     */
+    template<typename Predicate>
+    void waitHelping(std::unique_lock<std::mutex>& lock, std::condition_variable& ready,
+                     Predicate done) {
+        if (!onWorkerThread()) {
+            ready.wait(lock, done);
+            return;
+        }
+        while (!done()) {
+            lock.unlock();
+            const bool ran = runPendingTask();
+            lock.lock();
+            if (!ran) {
+                ready.wait_for(lock, std::chrono::milliseconds(1), done);
+            }
+        }
+    }
+
+    /**
+     * @brief Call `body(i)` for every i in [0, count), spread over the pool
+     *
+     * The calling thread takes part; at most `maxTasks` run at once
+     * (0 = threadCount() + 1). Indexes are claimed one at a time. The
+     * first exception stops further claims and is rethrown once every
+     * running body has returned.
+     */
+    template<typename Body>
+    void parallelFor(std::size_t count, Body body, std::size_t maxTasks = 0);
+
+    /// post() as a std::function, for the `executor` fields of option structs
+    std::function<void(Task)> poster();
+
+    ExecutorStats stats() const noexcept;
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(std::size_t index);
+    bool take(std::size_t index, Task& task);   // Own deque, then steal
+    void run(Task& task) noexcept;
+    void stop() noexcept;                       // Drain, then join every worker
+
+    std::vector<std::unique_ptr<Worker>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<std::size_t> nextQueue_{0};       // Round-robin target of outside posts
+    std::atomic<std::ptrdiff_t> pending_{0};      // Queued tasks (briefly -1 while a push lands)
+    std::atomic<std::size_t> sleepers_{0};
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;                       // Under sleepMutex_
+
+    std::atomic<uint64_t> posted_{0};
+    std::atomic<uint64_t> executed_{0};
+    std::atomic<uint64_t> stolen_{0};
+    std::atomic<uint64_t> helped_{0};
+};
+
+/**
+ * @brief Tasks run on an Executor and waited for together
+ *
+ * wait() returns once every task run() so far has finished, whether it
+ * returned or threw, and rethrows the first exception. The destructor
+ * waits too (dropping any exception), so locals the tasks refer to stay
+ * valid.
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(Executor& executor = *Executor::shared()) : executor_(executor) {}
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void run(Executor::Task task);
+    void wait();
+
+    Executor& executor() const noexcept { return executor_; }
+
+private:
+    Executor& executor_;
+    std::mutex mutex_;
+    std::condition_variable done_;
+    std::size_t pending_ = 0;
+    std::exception_ptr error_;
+};
+
+/**
+ * @brief Runs posted tasks one at a time, in order, on an Executor
+ *
+ * A Connection is single-threaded; its strand keeps every call on it
+ * serialized while no worker is reserved for it between calls. The
+ * destructor waits for queued tasks to finish, so it must not run on the
+ * strand itself.
+ */
+class Strand {
+public:
+    explicit Strand(std::shared_ptr<Executor> executor = Executor::shared());
+    ~Strand();
+
+    Strand(const Strand&) = delete;
+    Strand& operator=(const Strand&) = delete;
+
+    void post(Executor::Task task);
+
+    /// Block until every task posted so far has run (never call on the strand)
+    void waitIdle();
+
+    Executor& pool() const noexcept { return *executor_; }
+
+private:
+    void drain();
+
+    std::shared_ptr<Executor> executor_;
+    std::mutex mutex_;
+    std::condition_variable idle_;
+    std::deque<Executor::Task> tasks_;
+    bool running_ = false;   // A drain() is queued or running on the executor
+};
+
+template<typename Body>
+void Executor::parallelFor(std::size_t count, Body body, std::size_t maxTasks) {
+    if (count == 0) {
+        return;
+    }
+    const std::size_t width = maxTasks != 0 ? maxTasks : threadCount() + 1;
+    const std::size_t helpers = (count < width ? count : width) - 1;
+    std::atomic<std::size_t> next{0};
+    auto loop = [&] {
+        for (std::size_t i = next++; i < count; i = next++) {
+            try {
+                body(i);
+            } catch (...) {
+                next = count;
+                throw;
+            }
+        }
+    };
+    TaskGroup group(*this);
+    for (std::size_t t = 0; t < helpers; ++t) {
+        group.run(loop);
+    }
+    std::exception_ptr error;
+    try {
+        loop();
+    } catch (...) {
+        error = std::current_exception();
+    }
+    if (!error) {
+        group.wait();
+        return;
+    }
+    try {
+        group.wait();
+    } catch (...) {
+        // The caller's own error is the one reported
+    }
+    std::rethrow_exception(error);
+}
+
+} // namespace core
+} // namespace fbpp
@@ -0,0 +1,79 @@
+#pragma once
+
+// Expected<T> — a value, or the FirebirdException a call would have thrown.
+//
+// Returned by the try* variants (Transaction::tryExecute(),
+// ResultSet::tryFetch()) for paths where failure is routine, e.g. a retry
+// loop on update conflicts:
+//
+//   for (;;) {
+//       auto done = tx->tryExecute(update, params);
+//       if (done) break;
+//       if (done.error().getSQLState() != "40001") throw done.error();
+//       ...restart the transaction...
+//   }
+//
+// The exception carries the codes and a status snapshot; its message is
+// formatted only if what() is called. Shaped after C++23 std::expected,
+// which the C++20 baseline does not have.
+
+#include "fbpp/core/exception.hpp"
+
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace fbpp {
+namespace core {
+
+template<typename T>
+class Expected {
+    static_assert(!std::is_same_v<std::decay_t<T>, FirebirdException>,
+                  "Expected<FirebirdException> is ambiguous");
+
+public:
+    Expected(T value) : state_(std::in_place_index<0>, std::move(value)) {}
+    Expected(FirebirdException error) : state_(std::in_place_index<1>, std::move(error)) {}
+
+    bool has_value() const noexcept { return state_.index() == 0; }
+    explicit operator bool() const noexcept { return has_value(); }
+
+    /// The value; rethrows the error if there is none
+    T& value() & {
+        throwIfError();
+        return std::get<0>(state_);
+    }
+    const T& value() const& {
+        throwIfError();
+        return std::get<0>(state_);
+    }
+    T&& value() && {
+        throwIfError();
+        return std::get<0>(std::move(state_));
+    }
+
+    T& operator*() & noexcept { return *std::get_if<0>(&state_); }
+    const T& operator*() const& noexcept { return *std::get_if<0>(&state_); }
+    T* operator->() noexcept { return std::get_if<0>(&state_); }
+    const T* operator->() const noexcept { return std::get_if<0>(&state_); }
+
+    template<typename U>
+    T value_or(U&& fallback) const& {
+        return has_value() ? std::get<0>(state_) : static_cast<T>(std::forward<U>(fallback));
+    }
+
+    /// Only valid when !has_value()
+    const FirebirdException& error() const& noexcept { return *std::get_if<1>(&state_); }
+
+private:
+    void throwIfError() const {
+        if (!has_value()) {
+            throw std::get<1>(state_);
+        }
+    }
+
+    std::variant<T, FirebirdException> state_;
+};
+
+} // namespace core
+} // namespace fbpp
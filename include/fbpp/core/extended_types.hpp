@@ -6,8 +6,15 @@
 #include <cstring>
 #include <array>
 #include <chrono>
+#include <compare>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <stdexcept>
 #include <string_view>
+#include <type_traits>
 #include <utility>
 
 #if defined(_MSVC_LANG) && (_MSVC_LANG > __cplusplus)
@@ -16,13 +23,27 @@
 #define FBPP_EXTENDED_TYPES_CPLUSPLUS __cplusplus
 #endif
 
+// Native 128-bit integer arithmetic where the compiler has it (GCC / Clang
+// on x86-64, aarch64, ...); MSVC keeps the multiword code. Define
+// FBPP_NO_NATIVE_INT128 to force the multiword code everywhere.
+#if defined(__SIZEOF_INT128__) && !defined(FBPP_NO_NATIVE_INT128)
+#define FBPP_NATIVE_INT128 1
+#endif
+
 namespace fbpp::core {
 
+#if defined(FBPP_NATIVE_INT128)
+__extension__ typedef __int128 NativeInt128;
+__extension__ typedef unsigned __int128 NativeUInt128;
+#endif
+
 /**
  * @brief 128-bit integer type for Firebird INT128
  *
- * Minimal wrapper for raw data storage and Firebird API integration.
- * For conversions use IUtil interface from Firebird API.
+ * Wrapper for raw data storage and Firebird API integration, with the
+ * comparison and wrapping +/- an aggregation needs. Text conversion and
+ * NUMERIC rescaling: see int128_chars.hpp. With FBPP_NATIVE_INT128 the
+ * operations compile to native __int128 code.
  */
 class Int128 {
 public:
@@ -44,10 +65,43 @@ public:
         std::memcpy(data_.data(), bytes, 16);
     }
 
+    // Construct from the two's complement halves
+    static Int128 fromParts(int64_t high, uint64_t low) noexcept {
+        Int128 result;
+        result.setParts(static_cast<uint64_t>(high), low);
+        return result;
+    }
+
+#if defined(FBPP_NATIVE_INT128)
+    explicit Int128(NativeInt128 value) noexcept {
+        std::memcpy(data_.data(), &value, 16);
+    }
+
+    NativeInt128 toNative() const noexcept {
+        NativeInt128 value;
+        std::memcpy(&value, data_.data(), 16);
+        return value;
+    }
+#endif
+
     // Get raw bytes for Firebird API (little-endian)
     const uint8_t* data() const { return data_.data(); }
     uint8_t* data() { return data_.data(); }
 
+    uint64_t low() const noexcept {
+        uint64_t value;
+        std::memcpy(&value, data_.data(), 8);
+        return value;
+    }
+
+    int64_t high() const noexcept {
+        int64_t value;
+        std::memcpy(&value, data_.data() + 8, 8);
+        return value;
+    }
+
+    bool isNegative() const noexcept { return (data_[15] & 0x80) != 0; }
+
     // Equality comparison for testing
     bool operator==(const Int128& other) const {
         return std::memcmp(data_.data(), other.data_.data(), 16) == 0;
@@ -57,14 +111,63 @@ public:
         return !(*this == other);
     }
 
+    // Signed order
+    std::strong_ordering operator<=>(const Int128& other) const noexcept {
+#if defined(FBPP_NATIVE_INT128)
+        const NativeInt128 a = toNative();
+        const NativeInt128 b = other.toNative();
+        return a < b ? std::strong_ordering::less
+                     : a > b ? std::strong_ordering::greater : std::strong_ordering::equal;
+#else
+        if (auto order = high() <=> other.high(); order != 0) {
+            return order;
+        }
+        return low() <=> other.low();
+#endif
+    }
+
+    // Two's complement arithmetic, wrapping on overflow like the unsigned
+    // integer types (sum in a wider scale or check the range to detect it)
+    Int128& operator+=(const Int128& other) noexcept {
+#if defined(FBPP_NATIVE_INT128)
+        *this = Int128(static_cast<NativeInt128>(static_cast<NativeUInt128>(toNative()) +
+                                                 static_cast<NativeUInt128>(other.toNative())));
+#else
+        const uint64_t lo = low() + other.low();
+        const uint64_t carry = lo < low() ? 1 : 0;
+        setParts(static_cast<uint64_t>(high()) + static_cast<uint64_t>(other.high()) + carry, lo);
+#endif
+        return *this;
+    }
+
+    Int128& operator-=(const Int128& other) noexcept {
+        return *this += -other;
+    }
+
+    Int128 operator-() const noexcept {
+        // ~x + 1
+        const uint64_t lo = ~low() + 1;
+        return fromParts(static_cast<int64_t>(~static_cast<uint64_t>(high()) + (lo == 0 ? 1 : 0)),
+                         lo);
+    }
+
+    friend Int128 operator+(Int128 a, const Int128& b) noexcept { return a += b; }
+    friend Int128 operator-(Int128 a, const Int128& b) noexcept { return a -= b; }
+
 private:
+    void setParts(uint64_t high, uint64_t low) noexcept {
+        std::memcpy(data_.data(), &low, 8);
+        std::memcpy(data_.data() + 8, &high, 8);
+    }
+
     std::array<uint8_t, 16> data_;  // Little-endian storage
 };
 
 /**
  * @brief DECFLOAT(16) - Decimal64 IEEE 754-2008
  *
- * Minimal wrapper for raw data storage. Use IDecFloat16 interface for conversions.
+ * Raw DPD bytes as sent on the wire. Text / double conversions use
+ * decNumber directly (decfloat_chars.hpp), not IDecFloat16.
  */
 class DecFloat16 {
 public:
@@ -106,7 +209,8 @@ private:
 /**
  * @brief DECFLOAT(34) - Decimal128 IEEE 754-2008
  *
- * Minimal wrapper for raw data storage. Use IDecFloat34 interface for conversions.
+ * Raw DPD bytes as sent on the wire. Text / double conversions use
+ * decNumber directly (decfloat_chars.hpp), not IDecFloat34.
  */
 class DecFloat34 {
 public:
@@ -416,36 +520,132 @@ protected:
 };
 
 /**
- * @brief Text BLOB wrapper with caching
+ * @brief Text BLOB handle with lazily loaded, shared content
  *
- * Minimal text BLOB support with optional caching.
+ * Holds the BLOB id and a shared buffer. A fetched TextBlob reads nothing
+ * until the first getText(), which streams the BLOB through the fetching
+ * transaction; copies share the buffer, so the text is read at most once.
+ * getText() after that transaction has ended throws FirebirdException.
  */
 class TextBlob : public Blob {
 public:
+    /// Reads the text of the BLOB with the given id
+    using Loader = std::function<std::string(const uint8_t* id)>;
+
     TextBlob() : Blob() {}
 
     // Construct from blob ID
     explicit TextBlob(const uint8_t* id) : Blob(id) {}
 
+    // Construct from blob ID, loading the text on first getText()
+    TextBlob(const uint8_t* id, Loader loader) : Blob(id), content_(std::make_shared<Content>()) {
+        content_->loader = std::move(loader);
+    }
+
     // Construct from text (will create BLOB on pack)
-    explicit TextBlob(const std::string& text) : Blob(), cached_text_(text) {}
+    explicit TextBlob(const std::string& text) : Blob() { setText(text); }
 
-    // Text access (for caching)
-    bool hasText() const { return cached_text_.has_value(); }
+    /// True once the text is in memory (loaded or set); never loads
+    bool hasText() const {
+        if (!content_) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(content_->mutex);
+        return content_->text.has_value();
+    }
+
+    /// The text, loaded on first use; empty for an unbound or NULL BLOB
     const std::string& getText() const {
-        if (!cached_text_) {
-            static const std::string empty;
+        static const std::string empty;
+        if (!content_) {
             return empty;
         }
-        return *cached_text_;
+        std::lock_guard<std::mutex> lock(content_->mutex);
+        if (!content_->text) {
+            if (!content_->loader || isNull()) {
+                return empty;
+            }
+            content_->text = content_->loader(getId());
+            content_->loader = nullptr;
+        }
+        return *content_->text;
     }
-    void setText(const std::string& text) { cached_text_ = text; }
-    void clearText() { cached_text_.reset(); }
+
+    /// Replace the text; copies made earlier keep the old content
+    void setText(const std::string& text) {
+        content_ = std::make_shared<Content>();
+        content_->text = text;
+    }
+    void clearText() { content_.reset(); }
 
 private:
-    mutable std::optional<std::string> cached_text_;
+    struct Content {
+        std::mutex mutex;
+        std::optional<std::string> text;
+        Loader loader;
+    };
+
+    std::shared_ptr<Content> content_;
 };
 
+/**
+ * @brief CHAR/VARCHAR value of at most N bytes, stored inline
+ *
+ * For short codes in hot structs: fetching a row into one never touches
+ * the heap. Reads trim CHAR padding like std::string does; a value longer
+ * than N throws (std::length_error here, FirebirdException on fetch).
+ */
+template<std::size_t N>
+class FixedString {
+    static_assert(N > 0 && N <= 32765, "FixedString capacity must fit a CHAR/VARCHAR");
+
+public:
+    FixedString() noexcept = default;
+    FixedString(std::string_view text) { assign(text); }
+    FixedString(const char* text) : FixedString(std::string_view(text)) {}
+
+    void assign(const char* data, std::size_t size) {
+        if (size > N) {
+            throw std::length_error("FixedString<" + std::to_string(N) + ">: value of " +
+                                    std::to_string(size) + " bytes does not fit");
+        }
+        std::memcpy(data_.data(), data, size);
+        size_ = static_cast<std::uint16_t>(size);
+    }
+    void assign(std::string_view text) { assign(text.data(), text.size()); }
+    void clear() noexcept { size_ = 0; }
+
+    static constexpr std::size_t capacity() noexcept { return N; }
+    const char* data() const noexcept { return data_.data(); }
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    std::string_view view() const noexcept { return {data_.data(), size_}; }
+    operator std::string_view() const noexcept { return view(); }
+    std::string str() const { return std::string(view()); }
+
+    friend bool operator==(const FixedString& a, const FixedString& b) noexcept {
+        return a.view() == b.view();
+    }
+    friend bool operator==(const FixedString& a, std::string_view b) noexcept { return a.view() == b; }
+    friend bool operator==(const FixedString& a, const char* b) noexcept {
+        return a.view() == std::string_view(b);
+    }
+
+private:
+    std::array<char, N> data_{};
+    std::uint16_t size_ = 0;
+};
+
+template<typename T>
+struct is_fixed_string : std::false_type {};
+
+template<std::size_t N>
+struct is_fixed_string<FixedString<N>> : std::true_type {};
+
+template<typename T>
+inline constexpr bool is_fixed_string_v = is_fixed_string<T>::value;
+
 } // namespace fbpp::core
 
 #undef FBPP_EXTENDED_TYPES_CPLUSPLUS
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "fbpp/core/extended_types.hpp"
+
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace fbpp::core {
+
+/**
+ * @brief Text conversion of INT128 / NUMERIC(38,x) without IUtil calls
+ *
+ * Pure C++ replacement for IInt128::toString / fromString, writing into
+ * caller buffers in the style of std::to_chars / std::from_chars. Digits
+ * are handled 19 at a time in unsigned __int128 where FBPP_NATIVE_INT128
+ * is defined, 9 at a time in 32-bit limbs otherwise. The text
+ * matches Firebird's: "-123.45" for scale -2, "0.05", trailing zeros for a
+ * positive scale; scales outside [-38, 4] are written as "<digits>E<scale>".
+ */
+
+/// Buffer size that always fits toChars() for scales in [-38, 4]
+constexpr std::size_t kInt128MaxChars = 48;
+
+/**
+ * @brief Format `value * 10^scale` into [first, last)
+ *
+ * Not NUL-terminated. On a short buffer returns {last, value_too_large}.
+ */
+std::to_chars_result toChars(char* first, char* last, const Int128& value, int scale = 0) noexcept;
+
+/**
+ * @brief Parse a decimal ("-12.5", "1e3", "+7") into `value` at `scale`
+ *
+ * Extra fractional digits beyond -scale are rounded half away from zero.
+ * Returns invalid_argument for malformed text, result_out_of_range when the
+ * scaled value does not fit INT128. Parsing stops at the first character
+ * that cannot continue the number; `ptr` points there.
+ */
+std::from_chars_result fromChars(const char* first, const char* last, Int128& value,
+                                 int scale = 0) noexcept;
+
+/**
+ * @brief Bring `count` INT128 raw values from `fromScale` to `toScale`
+ *
+ * Same contract as rescaleNumeric() for int64: raising the precision
+ * multiplies and throws FirebirdException if a value leaves INT128 range,
+ * lowering it divides, rounding half away from zero. `out` may alias `raw`.
+ */
+void rescaleInt128(const Int128* raw, std::size_t count, int fromScale, int toScale,
+                   Int128* out);
+
+/// toChars() into a std::string
+std::string int128ToString(const Int128& value, int scale = 0);
+
+/// fromChars() over the whole of `text` (surrounding blanks allowed); throws FirebirdException
+Int128 int128FromString(std::string_view text, int scale = 0);
+
+} // namespace fbpp::core
@@ -0,0 +1,113 @@
+#pragma once
+
+// Nested JSON documents from one joined query.
+//
+// An "orders with their lines" endpoint usually runs one child query per
+// parent and builds an nlohmann::json tree. JsonNestWriter takes the rows
+// of a single query ordered by the parent key instead, and groups
+// consecutive rows with equal keys into one object whose children are a
+// nested array, writing through a JsonStreamWriter as the rows arrive:
+//
+//   auto stmt = conn.prepareStatement(
+//       "SELECT o.id, o.customer, l.line_no, l.sku, l.qty "
+//       "FROM orders o LEFT JOIN order_lines l ON l.order_id = o.id "
+//       "ORDER BY o.id, l.line_no");
+//   JsonStreamWriter json(out);
+//   JsonNestWriter nest(json, {
+//       {{"ID", "CUSTOMER"}, 1, "LINES"},
+//       {{"LINE_NO", "SKU", "QTY"}, 0}});
+//   tx->openCursor(stmt)->writeJson(nest);
+//   nest.finish();
+//   json.finish();
+//
+//   -> [{"ID":1,"CUSTOMER":"a","LINES":[{"LINE_NO":1,"SKU":"x","QTY":2},...]},...]
+//
+// Rows must arrive grouped: a parent key that comes back after another one
+// starts a second object. A child whose identifying columns are all NULL
+// (the unmatched side of a LEFT JOIN) is left out, so a parent without
+// children gets an empty array. Only the key bytes of the open objects are
+// kept between rows; values use JsonStreamWriter's mapping.
+
+#include "fbpp/core/json_stream_writer.hpp"
+#include "fbpp/core/message_metadata.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace fbpp::core {
+
+class Transaction;
+
+/**
+ * @brief One level of a nested document, outermost first
+ */
+struct JsonNestLevel {
+    // Columns written into this level's objects, by display name (the
+    // member names as well)
+    std::vector<std::string> columns;
+    // The first keyColumns of `columns` identify an object: consecutive
+    // rows with equal values belong to the same one. 0 = every row is an
+    // object of its own (innermost level only).
+    std::size_t keyColumns = 1;
+    // Member holding the next level's array; required except innermost
+    std::string children;
+};
+
+/**
+ * @brief Groups consecutive rows into nested objects in a JsonStreamWriter
+ *
+ * Each outermost object is one element of the writer's array (its rowCount()
+ * counts them). Call writeRow() per row (ResultSet::writeJson(JsonNestWriter&)
+ * does this for a cursor), then finish() before the writer's finish().
+ */
+class JsonNestWriter {
+public:
+    /// @throws FirebirdException on an empty or inconsistent level list
+    JsonNestWriter(JsonStreamWriter& writer, std::vector<JsonNestLevel> levels);
+
+    JsonNestWriter(const JsonNestWriter&) = delete;
+    JsonNestWriter& operator=(const JsonNestWriter&) = delete;
+
+    /**
+     * @brief Add one row decoded from `buffer`
+     *
+     * Column names are resolved against `metadata` on the first row and
+     * again whenever another metadata object is passed.
+     * @throws FirebirdException for a column missing from `metadata`
+     */
+    void writeRow(const uint8_t* buffer, const MessageMetadata& metadata,
+                  Transaction* transaction = nullptr);
+
+    /// Close the objects still open; the writer stays open
+    void finish();
+
+    /// Rows consumed so far (the writer's rowCount() counts outermost objects)
+    std::size_t rowCount() const noexcept { return rows_; }
+
+private:
+    struct Level {
+        JsonNestLevel spec;
+        std::vector<const ColumnPlan*> columns;   // Resolved spec.columns
+        std::vector<uint8_t> key;                 // Key bytes of the open object
+        std::size_t written = 0;                  // Objects in the open parent's array
+        bool open = false;
+    };
+
+    void resolve(const MessageMetadata& metadata);
+    // Columns identifying an object of `level`
+    std::size_t identityColumns(const Level& level) const noexcept;
+    bool sameKey(const Level& level, const uint8_t* buffer) const noexcept;
+    bool nullKey(const Level& level, const uint8_t* buffer) const noexcept;
+    void storeKey(Level& level, const uint8_t* buffer);
+    void open(std::size_t depth, const uint8_t* buffer, Transaction* transaction);
+    void close(std::size_t depth);
+
+    JsonStreamWriter& writer_;
+    std::vector<Level> levels_;
+    const MessageMetadata* metadata_ = nullptr;
+    std::size_t rows_ = 0;
+};
+
+} // namespace fbpp::core
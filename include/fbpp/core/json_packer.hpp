@@ -106,8 +106,8 @@ inline void packJsonToBuffer(const nlohmann::json& jsonData, uint8_t* buffer,
 
     // Pack each field
     for (unsigned i = 0; i < fieldCount; ++i) {
-        // Get field info from metadata
-        FieldInfo fieldInfo = metadata->getField(i);
+        // Cached field info — no per-row FieldInfo copy
+        const FieldInfo& fieldInfo = metadata->getFieldRef(i);
         
         // Get value from JSON
         nlohmann::json value;
@@ -0,0 +1,107 @@
+#pragma once
+
+// Streaming JSON serialization of fetched rows.
+//
+// JsonUnpacker builds an nlohmann::json object per row; exporting a large
+// result set that way allocates a node per cell and then a second copy in
+// dump(). JsonStreamWriter writes JSON text straight from the message
+// buffer into a reusable chunk that is handed to a sink whenever it fills,
+// so memory stays at one chunk regardless of the row count.
+//
+// Values follow JsonUnpacker's mapping: NULL -> null, BOOLEAN -> true/false,
+// integers without scale and floating point -> numbers, text and BLOB ->
+// strings, and NUMERIC/DECIMAL, INT128, DECFLOAT and date/time types ->
+// strings with the codec's text. Object keys are the column display names
+// (FIELD_<i> when empty), in column order. Text is written as stored:
+// unlike nlohmann's dump(), invalid UTF-8 is passed through, not rejected.
+
+#include "fbpp/core/message_metadata.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+namespace fbpp::core {
+
+class Transaction;
+
+/**
+ * @brief Shape of each streamed row
+ */
+enum class JsonRowShape {
+    Object,   // {"ID":1,"NAME":"a"}
+    Array     // [1,"a"]
+};
+
+/**
+ * @brief Writes rows as one JSON array, chunk by chunk, into a sink
+ *
+ * Call writeRow() per row (ResultSet::writeJson() does this for a cursor)
+ * and finish() once; the output is "[row,row,...]". The sink receives
+ * chunks of about `chunkBytes` and must consume them before returning.
+ */
+class JsonStreamWriter {
+public:
+    using Sink = std::function<void(std::string_view)>;
+
+    explicit JsonStreamWriter(Sink sink, JsonRowShape shape = JsonRowShape::Object,
+                              std::size_t chunkBytes = 64 * 1024);
+
+    /// Sink writing into `out`; the stream must outlive the writer
+    explicit JsonStreamWriter(std::ostream& out, JsonRowShape shape = JsonRowShape::Object,
+                              std::size_t chunkBytes = 64 * 1024);
+
+    JsonStreamWriter(const JsonStreamWriter&) = delete;
+    JsonStreamWriter& operator=(const JsonStreamWriter&) = delete;
+
+    /**
+     * @brief Append one row decoded from `buffer`
+     * @param transaction Needed to load BLOB columns
+     * @throws FirebirdException after finish() or for an unsupported type
+     */
+    void writeRow(const uint8_t* buffer, const MessageMetadata& metadata,
+                  Transaction* transaction = nullptr);
+
+    /**
+     * @brief Close the array ("[]" if no rows were written) and flush
+     */
+    void finish();
+
+    // Building blocks for elements that are not one row each (see
+    // JsonNestWriter). beginRow() and endRow() bracket one element of the
+    // top-level array; in between the caller writes the element's JSON
+    // with the calls below, which do not check its structure.
+
+    /// Separator before the next element; counts it in rowCount()
+    void beginRow();
+    /// Flush if the chunk is full
+    void endRow();
+    /// Structural text ("{", "],", ...), as is
+    void writeRaw(std::string_view json) { out_ += json; }
+    /// `"name":`, escaped as a string value
+    void writeKey(std::string_view name);
+    /// One column's value read from `buffer`, with writeRow()'s mapping
+    void writeColumn(const ColumnPlan& column, const uint8_t* buffer,
+                     Transaction* transaction = nullptr);
+
+    std::size_t rowCount() const noexcept { return rows_; }
+    bool finished() const noexcept { return finished_; }
+
+private:
+    void writeValue(const ColumnPlan& column, const uint8_t* buffer, Transaction* transaction);
+    void writeString(std::string_view text);
+    void flush();
+
+    Sink sink_;
+    JsonRowShape shape_;
+    std::size_t chunkBytes_;
+    std::string out_;       // Pending chunk
+    std::string scratch_;   // Codec text for string-mapped types; capacity reused
+    std::size_t rows_ = 0;
+    bool finished_ = false;
+};
+
+} // namespace fbpp::core
@@ -0,0 +1,90 @@
+#pragma once
+
+// Packing of raw JSON text straight into message buffers.
+//
+// JsonPacker needs a parsed nlohmann::json document, so NDJSON ingest used
+// to build a DOM per line only to walk it once. JsonTextPacker scans the
+// text of one object or array and writes each value through the codec as
+// it is read; keys are resolved against a table sorted once per packer
+// (positional indexes "0".."n-1" plus, for named SQL, the :name keys).
+//
+// Value rules follow JsonPacker: null -> NULL, strings / booleans /
+// numbers through the codec (integers beyond int64 and numbers bound to
+// INT128 / DECFLOAT columns keep their exact text), missing keys -> NULL,
+// unknown keys and nested objects/arrays are errors.
+
+#include "fbpp/core/message_metadata.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace fbpp::core {
+
+class Transaction;
+
+/**
+ * @brief One JSON document (object or array of parameters) as raw text
+ *
+ * A row type for pack(), Statement::execute() and Batch::addMany(); the
+ * text must stay alive until the call returns.
+ */
+struct JsonText {
+    std::string_view text;
+};
+
+/**
+ * @brief Split NDJSON into one JsonText per non-blank line (CR LF accepted)
+ */
+std::vector<JsonText> splitJsonLines(std::string_view ndjson);
+
+class JsonTextPacker {
+public:
+    using NameMap = std::unordered_map<std::string, std::vector<size_t>>;
+
+    /**
+     * @param metadata Input metadata the messages are packed for
+     * @param nameToPositions Statement::getNamedParamMapping() for named
+     *        SQL (copied); nullptr accepts positional keys only
+     */
+    explicit JsonTextPacker(const MessageMetadata& metadata,
+                            const NameMap* nameToPositions = nullptr);
+
+    /**
+     * @brief Pack one document into `buffer` (getMessageLength() bytes)
+     * @throws FirebirdException for malformed JSON (with the byte offset),
+     *         size mismatches, unknown keys or values the column rejects
+     */
+    void pack(std::string_view json, uint8_t* buffer, Transaction* transaction = nullptr) const;
+
+    /**
+     * @brief Positional-keys packer for `metadata`, built once and cached on it
+     */
+    static const JsonTextPacker& of(const MessageMetadata& metadata);
+
+    /**
+     * @brief Packer for `metadata` with the statement's named keys, cached on it
+     *
+     * Input metadata is per prepared statement, as is its name mapping.
+     */
+    static const JsonTextPacker& of(const MessageMetadata& metadata, const NameMap& nameToPositions);
+
+private:
+    struct Key {
+        std::string text;                  // Lowercased name or decimal index
+        std::vector<unsigned> positions;
+    };
+
+    const Key* find(std::string_view key) const noexcept;
+
+    std::shared_ptr<const MetadataLayout> layout_;   // Column plan and FieldInfo
+    std::vector<Key> keys_;   // Sorted by text
+    bool named_ = false;
+};
+
+} // namespace fbpp::core
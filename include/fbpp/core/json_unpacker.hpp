@@ -122,31 +122,28 @@ inline void unpackValueToJson(nlohmann::json& jsonValue, const uint8_t* data_ptr
 // Helper to iterate through all fields and unpack to JSON
 inline void unpackFieldsToJson(nlohmann::json& result, const uint8_t* buffer, const MessageMetadata* metadata,
                                ::fbpp::core::Transaction* transaction = nullptr) {
-    unsigned fieldCount = metadata->getCount();
+    const auto& plan = metadata->getColumnPlan();
+    const unsigned fieldCount = static_cast<unsigned>(plan.size());
     
     for (unsigned i = 0; i < fieldCount; ++i) {
-        // Get field info and offsets from metadata
-        FieldInfo fieldInfo = metadata->getField(i);
-        unsigned data_offset = metadata->getOffset(i);
-        unsigned null_offset = metadata->getNullOffset(i);
+        const ColumnPlan& column = plan[i];
         
-        const uint8_t* data_ptr = buffer + data_offset;
-        const int16_t* null_ptr = reinterpret_cast<const int16_t*>(buffer + null_offset);
+        const uint8_t* data_ptr = buffer + column.offset;
+        const int16_t* null_ptr = reinterpret_cast<const int16_t*>(buffer + column.nullOffset);
+        
+        // Unpack this field to JSON
+        nlohmann::json fieldValue;
+        unpackValueToJson(fieldValue, data_ptr, null_ptr, column.field, transaction);
         
         // User-facing identifier via shared identity helper. Generic
         // FIELD_N fallback covers the (rare) case where both name and
         // alias are empty.
-        std::string fieldName = displayName(fieldInfo);
+        const std::string& fieldName = displayName(*column.field);
         if (fieldName.empty()) {
-            fieldName = "FIELD_" + std::to_string(i);
+            result["FIELD_" + std::to_string(i)] = std::move(fieldValue);
+        } else {
+            result[fieldName] = std::move(fieldValue);
         }
-        
-        // Unpack this field to JSON
-        nlohmann::json fieldValue;
-        unpackValueToJson(fieldValue, data_ptr, null_ptr, &fieldInfo, transaction);
-        
-        // Add to result object
-        result[fieldName] = fieldValue;
     }
 }
 
@@ -0,0 +1,161 @@
+#pragma once
+
+// Client memory held on behalf of one Connection.
+//
+// Result sets, batches and row arenas of a connection charge the bytes of
+// their buffers to the connection's MemoryAccount as they grow; the
+// statement cache is estimated on request (texts, parameter metadata and
+// one message buffer pair per instance). Connection::memoryUsage() sums it
+// all up, with the server's own counters for the database (one getInfo
+// round trip) when asked for:
+//
+//   auto usage = conn.memoryUsage();
+//   std::cout << usage.clientBytes() << " bytes here, "
+//             << usage.serverCurrentMemory.value_or(0) << " on the server\n";
+//
+// ConnectionOptions::memorySoftLimit turns the sum into a limit: once the
+// client bytes are over it, the connection shrinks its statement cache —
+// pooled instances first, then whole keys in eviction order — until the
+// cache fits in what the live objects leave.
+//
+// Figures are capacities of the buffers fbpp allocates itself; what the
+// Firebird client library keeps per handle is not visible and not counted.
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace fbpp {
+namespace core {
+
+/**
+ * @brief Snapshot of a connection's memory (Connection::memoryUsage())
+ */
+struct MemoryUsage {
+    // Statement cache, estimated
+    size_t cachedStatements = 0;       // Keys
+    size_t idleStatements = 0;         // Pooled instances
+    size_t statementCacheBytes = 0;
+
+    // Live objects of the connection and the capacity of their buffers
+    size_t resultSets = 0;
+    size_t resultSetBytes = 0;         // Row buffers and prefetch windows
+    size_t batches = 0;
+    size_t batchBytes = 0;             // Message, stream and BLOB buffers
+    size_t arenas = 0;
+    size_t arenaBytes = 0;             // Blocks of the ResultArenas of its cursors
+
+    // Cache shrinks triggered by ConnectionOptions::memorySoftLimit so far
+    size_t softLimitShrinks = 0;
+
+    // Server side, for the whole database (isc_info_current_memory /
+    // isc_info_max_memory); empty when not requested or not answered
+    std::optional<uint64_t> serverCurrentMemory;
+    std::optional<uint64_t> serverMaxMemory;
+
+    size_t clientBytes() const noexcept {
+        return statementCacheBytes + resultSetBytes + batchBytes + arenaBytes;
+    }
+};
+
+namespace detail {
+
+/**
+ * @brief Per-connection byte and object counters (lock-free)
+ *
+ * Shared with the objects charging it, which may outlive the connection.
+ */
+class MemoryAccount {
+public:
+    enum Kind { resultSets, batches, arenas, kKinds };
+
+    void attach(Kind kind) noexcept { objects_[kind].fetch_add(1, std::memory_order_relaxed); }
+    void detach(Kind kind) noexcept { objects_[kind].fetch_sub(1, std::memory_order_relaxed); }
+    void add(Kind kind, size_t bytes) noexcept { bytes_[kind].fetch_add(bytes, std::memory_order_relaxed); }
+    void sub(Kind kind, size_t bytes) noexcept { bytes_[kind].fetch_sub(bytes, std::memory_order_relaxed); }
+
+    size_t objects(Kind kind) const noexcept { return objects_[kind].load(std::memory_order_relaxed); }
+    size_t bytes(Kind kind) const noexcept { return bytes_[kind].load(std::memory_order_relaxed); }
+
+private:
+    std::array<std::atomic<size_t>, kKinds> objects_{};
+    std::array<std::atomic<size_t>, kKinds> bytes_{};
+};
+
+/**
+ * @brief One object's charge to a MemoryAccount; released on destruction
+ *
+ * Unattached charges ignore set(), so objects created without a
+ * connection cost one null test per update.
+ */
+class MemoryCharge {
+public:
+    MemoryCharge() = default;
+    ~MemoryCharge() { reset(); }
+
+    MemoryCharge(MemoryCharge&& other) noexcept
+        : account_(std::move(other.account_)), kind_(other.kind_), bytes_(other.bytes_) {
+        other.bytes_ = 0;
+    }
+    MemoryCharge& operator=(MemoryCharge&& other) noexcept {
+        if (this != &other) {
+            reset();
+            account_ = std::move(other.account_);
+            kind_ = other.kind_;
+            bytes_ = other.bytes_;
+            other.bytes_ = 0;
+        }
+        return *this;
+    }
+    MemoryCharge(const MemoryCharge&) = delete;
+    MemoryCharge& operator=(const MemoryCharge&) = delete;
+
+    // Charge `account` from now on, with the bytes set so far
+    void attach(std::shared_ptr<MemoryAccount> account, MemoryAccount::Kind kind,
+                size_t bytes) noexcept {
+        reset();
+        account_ = std::move(account);
+        kind_ = kind;
+        if (account_) {
+            account_->attach(kind_);
+        }
+        set(bytes);
+    }
+
+    bool attached() const noexcept { return account_ != nullptr; }
+
+    void set(size_t bytes) noexcept {
+        if (!account_ || bytes == bytes_) {
+            return;
+        }
+        if (bytes > bytes_) {
+            account_->add(kind_, bytes - bytes_);
+        } else {
+            account_->sub(kind_, bytes_ - bytes);
+        }
+        bytes_ = bytes;
+    }
+
+    void reset() noexcept {
+        if (account_) {
+            account_->sub(kind_, bytes_);
+            account_->detach(kind_);
+            account_.reset();
+        }
+        bytes_ = 0;
+    }
+
+private:
+    std::shared_ptr<MemoryAccount> account_;
+    MemoryAccount::Kind kind_ = MemoryAccount::resultSets;
+    size_t bytes_ = 0;
+};
+
+} // namespace detail
+
+} // namespace core
+} // namespace fbpp
@@ -2,8 +2,13 @@
 
 #include "fbpp/core/environment.hpp"
 #include "fbpp/core/firebird_compat.hpp"
+#include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <typeindex>
+#include <utility>
 #include <vector>
 
 namespace fbpp {
@@ -42,6 +47,31 @@ struct FieldInfo {
     unsigned nullOffset;     // Null indicator offset
 };
 
+/**
+ * @brief Compact, string-free layout of one column, used by the per-row
+ * pack/unpack hot paths.
+ *
+ * Built once per MessageMetadata (together with the FieldInfo cache) and
+ * never modified afterwards. Reading a column plan instead of calling
+ * getField(index) avoids copying the four std::string members of FieldInfo
+ * and the IMessageMetadata virtual calls behind getOffset()/getNullOffset().
+ *
+ * `field` points at the cached FieldInfo the plan was built from; it stays
+ * valid for the lifetime of the owning MessageMetadata and is what the
+ * sql_value_codec context and error messages use.
+ */
+struct ColumnPlan {
+    unsigned type;           // SQL type code (nullable bit preserved)
+    unsigned subType;        // Subtype (for BLOB, etc.)
+    unsigned length;         // Field length in bytes
+    int scale;               // Scale for NUMERIC/DECIMAL
+    unsigned charSet;        // Character set ID
+    unsigned offset;         // Offset in message buffer
+    unsigned nullOffset;     // Null indicator offset
+    bool nullable;           // Can be NULL
+    const FieldInfo* field;  // Owning metadata's cached descriptor
+};
+
 /**
  * @brief Canonical user-facing identifier for a field.
  *
@@ -53,6 +83,68 @@ inline const std::string& displayName(const FieldInfo& f) noexcept {
     return f.alias.empty() ? f.name : f.alias;
 }
 
+/**
+ * @brief Hash of the binary shape of a message: per field, in order, the
+ * type, subtype, length, scale, charset, offset and null offset.
+ *
+ * Names do not take part. query_generator computes it at build time from the
+ * described statement and emits it as a descriptor's `layout_hash`; at run
+ * time the same function over the live metadata (MetadataLayout::layoutHash)
+ * tells, in one compare, whether the build-time offsets still hold.
+ */
+inline std::uint64_t messageLayoutHash(const std::vector<FieldInfo>& fields) noexcept {
+    // FNV-1a over the 32-bit values
+    std::uint64_t h = 14695981039346656037ull;
+    auto mix = [&h](std::uint32_t value) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            h = (h ^ ((value >> shift) & 0xffu)) * 1099511628211ull;
+        }
+    };
+    mix(static_cast<std::uint32_t>(fields.size()));
+    for (const auto& field : fields) {
+        mix(field.type);
+        mix(field.subType);
+        mix(field.length);
+        mix(static_cast<std::uint32_t>(field.scale));
+        mix(field.charSet);
+        mix(field.offset);
+        mix(field.nullOffset);
+    }
+    return h;
+}
+
+/**
+ * @brief Everything MessageMetadata decodes from IMessageMetadata, in one
+ * immutable block.
+ *
+ * Built once by loadFields() and never modified afterwards, so several
+ * MessageMetadata instances describing the same message format — the same
+ * SQL prepared on different attachments — can share one layout instead of
+ * each repeating the per-field interface calls and string copies (see
+ * StatementTemplateRegistry).
+ *
+ * Non-copyable: `columnPlan[i].field` points into `fields`.
+ */
+struct MetadataLayout {
+    std::vector<FieldInfo> fields;
+    // UPPERCASE forms of fields[i].name and .alias for case-insensitive lookup.
+    std::vector<std::string> nameUpper;
+    std::vector<std::string> aliasUpper;
+    // (key, index) pairs sorted by key, then index: raw name / alias keys and
+    // their UPPERCASE forms. getIndex(name) binary-searches these; the keys
+    // are views into the strings above.
+    std::vector<std::pair<std::string_view, unsigned>> exactNames;
+    std::vector<std::pair<std::string_view, unsigned>> upperNames;
+    // String-free per-column layout; entries point into fields.
+    std::vector<ColumnPlan> columnPlan;
+    unsigned messageLength = 0;
+    std::uint64_t layoutHash = 0;   // messageLayoutHash(fields)
+
+    MetadataLayout() = default;
+    MetadataLayout(const MetadataLayout&) = delete;
+    MetadataLayout& operator=(const MetadataLayout&) = delete;
+};
+
 /**
  * @brief Wrapper for Firebird IMessageMetadata interface
  * 
@@ -63,6 +155,17 @@ public:
     // Constructors
     MessageMetadata() = default;
     explicit MessageMetadata(Firebird::IMessageMetadata* metadata);
+
+    /**
+     * @brief Wrap metadata reusing a layout decoded elsewhere
+     *
+     * The layout is adopted only if it describes `metadata`: same field
+     * count and message length, and the same type, subtype, length, scale
+     * and offsets for every field. Otherwise it is ignored and fields are
+     * loaded from `metadata` as usual. A null layout is allowed.
+     */
+    MessageMetadata(Firebird::IMessageMetadata* metadata,
+                    std::shared_ptr<const MetadataLayout> layout);
     
     // Move semantics
     MessageMetadata(MessageMetadata&& other) noexcept;
@@ -87,6 +190,52 @@ public:
      * @return Field information
      */
     FieldInfo getField(unsigned index) const;
+
+    /**
+     * @brief Get cached field information by index without copying
+     *
+     * The reference stays valid for the lifetime of this MessageMetadata.
+     *
+     * @param index Field index (0-based)
+     * @return Reference to the cached field information
+     */
+    const FieldInfo& getFieldRef(unsigned index) const;
+
+    /**
+     * @brief Get the precompiled per-column plan
+     *
+     * One entry per field, in field order. Built lazily on first use (or
+     * eagerly by ResultSet when a cursor opens) and immutable afterwards.
+     *
+     * @return Reference to the cached column plan
+     */
+    const std::vector<ColumnPlan>& getColumnPlan() const;
+
+    /**
+     * @brief Get the shared, immutable decoded layout
+     *
+     * Loads fields on first use. The returned layout can be handed to the
+     * two-argument constructor of another MessageMetadata for the same
+     * message format.
+     */
+    std::shared_ptr<const MetadataLayout> getLayout() const;
+
+    /**
+     * @brief New wrapper over the same IMessageMetadata with its own status
+     *
+     * One MessageMetadata must not be used from two threads at once; a
+     * clone can be, one per thread. The decoded layout is shared.
+     */
+    std::shared_ptr<MessageMetadata> clone() const;
+
+    /**
+     * @brief Per-metadata slot for derived, type-specific plans
+     *
+     * Backs PackPlan<T>::of(); `key` names the plan type. Plans keep the
+     * layout they were built from, so they do not depend on this object.
+     */
+    std::shared_ptr<const void> findPlan(std::type_index key) const;
+    void storePlan(std::type_index key, std::shared_ptr<const void> plan) const;
     
     /**
      * @brief Get field information by name (matches against name OR alias).
@@ -104,7 +253,7 @@ public:
      * @param name Field name (raw or case-insensitive with whitespace)
      * @return Field information or nullopt if not found
      */
-    std::optional<FieldInfo> getField(const std::string& name) const;
+    std::optional<FieldInfo> getField(std::string_view name) const;
 
     /**
      * @brief Get all fields information
@@ -117,11 +266,13 @@ public:
      *
      * Same lookup semantics as getField(name) — exact pass first, then
      * case-insensitive ASCII match with whitespace trim. First by index wins.
+     * Both passes are binary searches over tables built with the layout, and
+     * the lookup allocates only for names longer than 64 bytes.
      *
      * @param name Field name (raw or case-insensitive with whitespace)
      * @return Field index or nullopt if not found
      */
-    std::optional<unsigned> getIndex(const std::string& name) const;
+    std::optional<unsigned> getIndex(std::string_view name) const;
     
     /**
      * @brief Get field name by index
@@ -280,15 +431,15 @@ private:
     Firebird::IStatus* status_;
     mutable Firebird::ThrowStatusWrapper statusWrapper_{nullptr};
     
-    // Cached field information (lazy-loaded)
-    mutable std::vector<FieldInfo> fields_;
-    // Pre-computed UPPERCASE forms of fields_[i].name and .alias for case-
-    // insensitive lookup. Populated together with fields_ in loadFields().
-    mutable std::vector<std::string> name_upper_;
-    mutable std::vector<std::string> alias_upper_;
-    mutable bool fieldsLoaded_ = false;
+    // Cached field information (lazy-loaded, possibly shared)
+    mutable std::shared_ptr<const MetadataLayout> layout_;
+
+    // Plans derived from layout_ (see findPlan); a handful per statement
+    mutable std::vector<std::pair<std::type_index, std::shared_ptr<const void>>> plans_;
 
     void loadFields() const;
+    const MetadataLayout& layout() const;
+    bool describes(const MetadataLayout& layout) const;
 };
 
 } // namespace core
@@ -0,0 +1,158 @@
+#pragma once
+
+// MonitoringSampler — periodic MON$ sampling on a connection of its own.
+//
+// Every sample is one short read-only snapshot transaction: the server
+// builds its monitoring snapshot once, on the first MON$ read, and the
+// sampler reads everything it needs from that snapshot (statements with
+// their MON$IO_STATS / MON$RECORD_STATS in one join, plus the attachment
+// count). Statement texts are BLOBs; each is loaded once per statement id
+// and then remembered, so steady-state samples move counters only.
+//
+//   MonitoringSampler sampler(params);            // samples every 10 s
+//   sampler.addMetricsSource(appConnection);      // correlate client metrics
+//   ...
+//   auto sample = sampler.latest();               // or wait for the trace
+//
+// Page and record counters are cumulative per MON$STATEMENTS row; each
+// sample reports the growth since the previous sample, summed over the
+// rows that share a fingerprint (SqlKey::hashOf(text, 0), the value of
+// Statement::getFingerprint() for the same text). Statements whose
+// fingerprint matches a key of a metrics source carry that key's client
+// metrics. The top entries by page reads and by running time go to the
+// trace sink (component "MonitoringSampler") after every sample.
+//
+// Reading MON$ tables shows every attachment only to SYSDBA, the owner of
+// the database or a user with MONITOR_ANY_ATTACHMENT; others see their
+// own. The sampler's own attachment is left out.
+
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/statement_metrics.hpp"
+#include "fbpp_util/trace.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace fbpp {
+namespace core {
+
+/**
+ * @brief Schedule and publishing policy of a MonitoringSampler
+ */
+struct MonitoringSamplerOptions {
+    // Period of the sampling thread; 0 runs no thread (call sample())
+    std::chrono::milliseconds interval{std::chrono::seconds(10)};
+    // Entries per top list
+    std::size_t topN = 10;
+    // Level of the per-sample trace lines; nullopt publishes nothing
+    std::optional<fbpp::util::TraceLevel> traceLevel = fbpp::util::TraceLevel::info;
+};
+
+/**
+ * @brief MON$ activity of the statements sharing one fingerprint
+ *
+ * Counters are deltas since the previous sample (for rows first seen in
+ * this sample: everything they counted so far).
+ */
+struct MonitoredStatement {
+    uint64_t fingerprint = 0;     // SqlKey::hashOf(sql, 0)
+    std::string sql;              // MON$SQL_TEXT
+    std::size_t instances = 0;    // MON$STATEMENTS rows with this text
+    std::size_t active = 0;       // Of which executing at the sample
+    uint64_t pageReads = 0;
+    uint64_t pageWrites = 0;
+    uint64_t pageFetches = 0;
+    uint64_t pageMarks = 0;
+    uint64_t seqReads = 0;        // Records read by full scan
+    uint64_t idxReads = 0;        // Records read through an index
+    // Summed time the executing instances have been running (MON$TIMESTAMP)
+    std::chrono::milliseconds running{0};
+    // Client metrics of the same fingerprint from a metrics source
+    std::optional<StatementMetricsSnapshot> client;
+};
+
+/**
+ * @brief One MonitoringSampler reading
+ */
+struct MonitoringSample {
+    std::chrono::system_clock::time_point taken;
+    std::chrono::microseconds cost{0};       // Client-side duration of the sample
+    std::size_t attachments = 0;             // Other attachments visible
+    std::size_t statements = 0;              // MON$STATEMENTS rows with SQL text
+    std::vector<MonitoredStatement> topByReads;    // Page reads, descending
+    std::vector<MonitoredStatement> topByTime;     // Running time, descending
+};
+
+/**
+ * @brief Samples MON$STATEMENTS / MON$IO_STATS / MON$RECORD_STATS periodically
+ *
+ * Thread-safe; samples are serialized. The connection is opened by the
+ * constructor and used by nothing else.
+ */
+class MonitoringSampler {
+public:
+    explicit MonitoringSampler(ConnectionParams params, MonitoringSamplerOptions options = {});
+    ~MonitoringSampler();
+
+    MonitoringSampler(const MonitoringSampler&) = delete;
+    MonitoringSampler& operator=(const MonitoringSampler&) = delete;
+
+    /**
+     * @brief Correlate samples with the statement metrics of `connection`
+     *
+     * The connection's statement cache must collect metrics
+     * (StatementCacheConfig::collectMetrics); it must outlive the sampler
+     * or be removed first.
+     */
+    void addMetricsSource(const Connection& connection);
+    void removeMetricsSource(const Connection& connection);
+
+    /// Take a sample now (and trace it); also what the thread runs
+    MonitoringSample sample();
+
+    /// Most recent sample, if any was taken
+    std::optional<MonitoringSample> latest() const;
+
+    /// Stop the sampling thread (the destructor does it too)
+    void stop();
+
+    const MonitoringSamplerOptions& options() const noexcept { return options_; }
+
+private:
+    // Last counters of one MON$STATEMENTS row
+    struct Tracked {
+        uint64_t fingerprint = 0;
+        uint64_t reads = 0, writes = 0, fetches = 0, marks = 0, seqReads = 0, idxReads = 0;
+        uint64_t seenInSample = 0;
+    };
+
+    void run();
+    void publish(const MonitoringSample& sample) const;
+
+    MonitoringSamplerOptions options_;
+    std::unique_ptr<Connection> connection_;
+
+    std::mutex sampleMutex_;             // One sample at a time; guards the fields below
+    std::unordered_map<int64_t, Tracked> tracked_;          // By MON$STATEMENT_ID
+    std::unordered_map<uint64_t, std::string> texts_;       // Fingerprint -> SQL text
+    uint64_t samples_ = 0;
+
+    mutable std::mutex mutex_;           // Guards latest_, sources_, shutdown_
+    std::optional<MonitoringSample> latest_;
+    std::vector<const Connection*> sources_;
+    bool shutdown_ = false;
+    std::condition_variable stopping_;
+    std::thread thread_;
+};
+
+} // namespace core
+} // namespace fbpp
@@ -0,0 +1,221 @@
+#pragma once
+
+// MultiGet — look up many keys with one query shape instead of one cursor
+// per key.
+//
+// The SQL names the key list once, as a list parameter:
+//
+//   fbpp::core::MultiGet lookup(conn, "SELECT id, name FROM product WHERE id IN (:ids)", "ids");
+//   auto rows = lookup.fetch(*tx, std::vector<int64_t>{17, 4, 17, 99});
+//   // rows[i]: the Rows whose key column equals keys[i] (rows[0] == rows[2])
+//
+// Two ways to run it:
+//
+//   inList    The list is expanded to a bucketed IN-list
+//             (NamedParamParser::expandList) of at most maxInList keys; the
+//             distinct keys take ceil(n / maxInList) round trips, and the
+//             power-of-two shapes keep the statement cache small.
+//   keyTable  The keys go into a global temporary table through one Batch,
+//             and the list becomes `IN (SELECT K FROM <table> WHERE ...)`:
+//             two round trips for any number of keys. The table is created
+//             on first use (ON COMMIT DELETE ROWS); every call tags its keys
+//             with a fresh batch id, so calls in one transaction do not see
+//             each other's keys.
+//
+// automatic picks inList up to keyTableThreshold distinct keys and the key
+// table above. The key table is a StagingTable. Every result row is matched back to the requested keys by
+// its key column (first output column unless keyColumn names another one);
+// a key requested twice gets the row twice, a key without rows gets none.
+// Keys are integers or std::string; compare VARCHAR rather than padded CHAR
+// key columns.
+
+#include "fbpp/core/batch.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/named_param_parser.hpp"
+#include "fbpp/core/param_binder.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/row.hpp"
+#include "fbpp/core/staging_table.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace fbpp {
+namespace core {
+
+enum class MultiGetStrategy {
+    automatic,   ///< inList up to keyTableThreshold distinct keys, keyTable above
+    inList,      ///< Bucketed IN-lists of at most maxInList keys each
+    keyTable     ///< Keys loaded into a GTT through a Batch
+};
+
+struct MultiGetOptions {
+    MultiGetStrategy strategy = MultiGetStrategy::automatic;
+    std::size_t maxInList = 256;          ///< Keys per IN-list (rounded down to a power of two)
+    std::size_t keyTableThreshold = 1024; ///< automatic: above this many distinct keys use the key table
+    /// Key table name; empty = FBPP_MULTIGET_KEYS_I / _S for integer / string keys
+    std::string keyTable;
+    /// SQL type of the key table's K column; empty = BIGINT / VARCHAR(200)
+    std::string keyType;
+    std::string keyColumn;                ///< Output column holding the key; empty = the first
+};
+
+/// What the last MultiGet call did
+struct MultiGetStats {
+    MultiGetStrategy strategy = MultiGetStrategy::inList;   ///< Strategy actually used
+    std::size_t distinctKeys = 0;
+    std::size_t roundTrips = 0;           ///< Batch loads plus cursors opened
+    std::size_t rows = 0;                 ///< Result rows (before fan-out to duplicate keys)
+};
+
+class MultiGet {
+public:
+    /// `sql` must reference `listName` as `:listName` (or `@listName`) and
+    /// have no other parameters
+    MultiGet(Connection& connection, std::string sql, std::string listName,
+             MultiGetOptions options = {});
+
+    /**
+     * @brief Run the lookup, calling `sink(keyIndex, row)` per match
+     *
+     * keyIndex indexes `keys`; a row matching a key given several times is
+     * passed once per occurrence. The RowView is valid during the call only.
+     *
+     * @return Statistics of this call (also kept as lastStats())
+     */
+    template<typename Key, typename Sink>
+    const MultiGetStats& each(Transaction& transaction, std::span<const Key> keys, Sink&& sink);
+
+    /// Rows per key: result[i] holds the owning Rows matching keys[i]
+    template<typename Key>
+    std::vector<std::vector<Row>> fetch(Transaction& transaction, const std::vector<Key>& keys);
+
+    const MultiGetStats& lastStats() const noexcept { return stats_; }
+
+private:
+    template<typename Key>
+    static constexpr bool kIntegerKey = std::is_integral_v<Key> && !std::is_same_v<Key, bool>;
+
+    // Open the keyTable query over the keys loaded with `batchId`
+    std::unique_ptr<ResultSet> openKeyTable(Transaction& transaction, const StagingTable& table,
+                                            std::int64_t batchId);
+    StagingTable& ensureKeyTable(bool integerKeys);
+    static std::int64_t nextBatchId();
+    unsigned keyColumnOf(const ResultSet& cursor) const;
+
+    Connection& connection_;
+    std::string sql_;
+    std::string listName_;
+    MultiGetOptions options_;
+    std::unique_ptr<StagingTable> keyTable_[2];   // Created / verified table, by integerKeys
+    MultiGetStats stats_;
+};
+
+template<typename Key, typename Sink>
+const MultiGetStats& MultiGet::each(Transaction& transaction, std::span<const Key> keys,
+                                    Sink&& sink) {
+    static_assert(kIntegerKey<Key> || std::is_same_v<Key, std::string>,
+                  "MultiGet keys are integers or std::string");
+
+    // Distinct keys in first-seen order, each with the positions asking for it
+    std::unordered_map<Key, std::vector<std::size_t>> wanted;
+    std::vector<Key> distinct;
+    wanted.reserve(keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        auto [it, added] = wanted.try_emplace(keys[i]);
+        if (added) {
+            distinct.push_back(keys[i]);
+        }
+        it->second.push_back(i);
+    }
+
+    stats_ = MultiGetStats{};
+    stats_.distinctKeys = distinct.size();
+    stats_.strategy = options_.strategy;
+    if (stats_.strategy == MultiGetStrategy::automatic) {
+        stats_.strategy = distinct.size() > options_.keyTableThreshold ? MultiGetStrategy::keyTable
+                                                                       : MultiGetStrategy::inList;
+    }
+    if (distinct.empty()) {
+        return stats_;
+    }
+
+    auto drain = [&](ResultSet& cursor) {
+        const unsigned keyColumn = keyColumnOf(cursor);
+        for (const auto& row : cursor.rows()) {
+            ++stats_.rows;
+            const auto key = row.template get<Key>(keyColumn);
+            if (!key) {
+                continue;
+            }
+            auto it = wanted.find(*key);
+            if (it == wanted.end()) {
+                continue;
+            }
+            for (std::size_t index : it->second) {
+                sink(index, row);
+            }
+        }
+        cursor.close();
+    };
+
+    if (stats_.strategy == MultiGetStrategy::keyTable) {
+        StagingTable& table = ensureKeyTable(kIntegerKey<Key>);
+        const std::int64_t id = nextBatchId();
+        using KeyColumn = std::conditional_t<kIntegerKey<Key>, std::int64_t, std::string>;
+        std::vector<std::tuple<std::int64_t, KeyColumn>> rows;
+        rows.reserve(distinct.size());
+        for (const auto& key : distinct) {
+            rows.emplace_back(id, static_cast<KeyColumn>(key));
+        }
+        table.load(transaction, rows);
+        ++stats_.roundTrips;
+        auto cursor = openKeyTable(transaction, table, id);
+        drain(*cursor);
+        return stats_;
+    }
+
+    // Largest power of two within maxInList, so no chunk's bucket exceeds it
+    std::size_t chunk = 1;
+    while (chunk * 2 <= std::max<std::size_t>(options_.maxInList, 1)) {
+        chunk *= 2;
+    }
+    for (std::size_t begin = 0; begin < distinct.size(); begin += chunk) {
+        const std::span<const Key> part(distinct.data() + begin,
+                                        std::min(chunk, distinct.size() - begin));
+        auto statement = connection_.prepareStatement(
+            NamedParamParser::expandList(sql_, listName_, part.size()));
+        ParamBinder binder(statement, &transaction);
+        if (!binder.setList(listName_, part)) {
+            throw FirebirdException("MultiGet: SQL has no list parameter ':" + listName_ + "'");
+        }
+        auto cursor = transaction.openCursor(statement, binder);
+        ++stats_.roundTrips;
+        drain(*cursor);
+    }
+    return stats_;
+}
+
+template<typename Key>
+std::vector<std::vector<Row>> MultiGet::fetch(Transaction& transaction,
+                                              const std::vector<Key>& keys) {
+    std::vector<std::vector<Row>> result(keys.size());
+    each<Key>(transaction, std::span<const Key>(keys), [&](std::size_t index, const RowView& row) {
+        result[index].emplace_back(row);
+    });
+    return result;
+}
+
+} // namespace core
+} // namespace fbpp
@@ -0,0 +1,204 @@
+#pragma once
+
+// MultiplexedConnection — one attachment shared by any number of threads.
+//
+// Callers never touch the Connection: every request is queued to a
+// dedicated I/O thread that owns it, so IAttachment calls are serialized
+// and the one-thread-at-a-time contract holds however many threads share
+// the attachment. A caller blocks (run(), execute(), query()) or takes a
+// future (submit()) until its request is done.
+//
+//   MultiplexedConnection db(params);
+//   // from any thread:
+//   db.execute("INSERT INTO audit (id, what) VALUES (?, ?)", std::make_tuple(id, what));
+//   auto rows = db.query<std::tuple<int32_t, std::string>>(
+//       "SELECT id, name FROM account WHERE owner = ?", std::make_tuple(owner));
+//   auto n = db.run([](Connection& conn) { ...; return count; });
+//
+// The I/O thread takes everything queued at once per wake-up. Consecutive
+// autocommit writes (execute()) in that batch share one transaction and
+// one commit, up to maxGroup at a time; if the group fails it is rolled
+// back and each write runs again on its own, so only the failing one
+// reports its error. Reads (query()) run in the connection's shared
+// read-only transaction (Connection::readTransaction()). Requests run in
+// queue order, so a read queued after a write sees it committed.
+//
+// Suits many mostly idle threads when attachments are the scarce server
+// resource; one busy I/O thread is the throughput limit. A run() function
+// must not keep the Connection or objects created from it (statements,
+// transactions, cursors) past its return, nor queue requests on the same
+// MultiplexedConnection and wait for them.
+
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fbpp {
+namespace core {
+
+struct MultiplexedConnectionOptions {
+    // Autocommit writes committed in one transaction (1 = no grouping)
+    size_t maxGroup = 64;
+};
+
+/// Counters of a MultiplexedConnection since construction
+struct MultiplexStats {
+    uint64_t requests = 0;        ///< Requests queued
+    uint64_t wakeups = 0;         ///< Batches the I/O thread took off the queue
+    uint64_t groups = 0;          ///< Write transactions of more than one write
+    uint64_t groupedWrites = 0;   ///< Writes committed in such a group
+    uint64_t groupRetries = 0;    ///< Failed groups whose writes ran again one by one
+    size_t maxQueued = 0;         ///< Most requests waiting at once
+};
+
+class MultiplexedConnection {
+public:
+    explicit MultiplexedConnection(ConnectionParams params,
+                                   MultiplexedConnectionOptions options = {});
+    /// Runs what is queued, then detaches
+    ~MultiplexedConnection();
+
+    MultiplexedConnection(const MultiplexedConnection&) = delete;
+    MultiplexedConnection& operator=(const MultiplexedConnection&) = delete;
+
+    /// Queue `fn(Connection&)` for the I/O thread; the future has its result
+    template<typename Fn>
+    std::future<std::invoke_result_t<Fn&, Connection&>> submit(Fn fn);
+
+    /// submit() and wait; rethrows what `fn` threw
+    template<typename Fn>
+    std::invoke_result_t<Fn&, Connection&> run(Fn fn) {
+        return submit(std::move(fn)).get();
+    }
+
+    /// Autocommit INSERT / UPDATE / DELETE / EXECUTE PROCEDURE; affected rows
+    template<typename Params = std::tuple<>>
+    unsigned execute(std::string sql, Params params = {});
+
+    /// All rows of a SELECT, read in the shared read-only transaction
+    template<typename Row, typename Params = std::tuple<>>
+    std::vector<Row> query(std::string sql, Params params = {});
+
+    MultiplexStats stats() const;
+    const MultiplexedConnectionOptions& options() const noexcept { return options_; }
+
+private:
+    struct Request {
+        // I/O thread; `group` is the write transaction of a grouped write
+        std::function<void(Connection&, Transaction* group)> work;
+        // Completes the caller's future: null = success
+        std::function<void(std::exception_ptr)> finish;
+        bool grouped = false;
+    };
+
+    template<typename T>
+    struct Result {
+        std::promise<T> promise;
+        std::optional<std::conditional_t<std::is_void_v<T>, bool, T>> value;
+
+        void finish(std::exception_ptr error) {
+            if (error) {
+                promise.set_exception(error);
+            } else if constexpr (std::is_void_v<T>) {
+                promise.set_value();
+            } else {
+                promise.set_value(std::move(*value));
+            }
+        }
+    };
+
+    void enqueue(Request request);
+    void run();
+    void runOne(Request& request);
+    void runWrite(Request& request);
+    void runGroup(Request* first, size_t count);
+
+    MultiplexedConnectionOptions options_;
+    std::unique_ptr<Connection> connection_;
+
+    mutable std::mutex mutex_;   // Guards queue_, stopping_, stats_
+    std::condition_variable wake_;
+    std::deque<Request> queue_;
+    bool stopping_ = false;
+    MultiplexStats stats_;
+    std::thread thread_;
+};
+
+template<typename Fn>
+std::future<std::invoke_result_t<Fn&, Connection&>> MultiplexedConnection::submit(Fn fn) {
+    using T = std::invoke_result_t<Fn&, Connection&>;
+    auto result = std::make_shared<Result<T>>();
+    auto future = result->promise.get_future();
+    Request request;
+    // Held by pointer: std::function needs a copyable target, `fn` may be move-only
+    request.work = [fn = std::make_shared<Fn>(std::move(fn)), result](Connection& connection,
+                                                                        Transaction*) {
+        if constexpr (std::is_void_v<T>) {
+            (*fn)(connection);
+        } else {
+            result->value.emplace((*fn)(connection));
+        }
+    };
+    request.finish = [result](std::exception_ptr error) { result->finish(error); };
+    enqueue(std::move(request));
+    return future;
+}
+
+template<typename Params>
+unsigned MultiplexedConnection::execute(std::string sql, Params params) {
+    auto result = std::make_shared<Result<unsigned>>();
+    auto future = result->promise.get_future();
+    Request request;
+    request.grouped = true;
+    request.work = [sql = std::move(sql), params = std::move(params),
+                    result](Connection& connection, Transaction* group) {
+        auto stmt = connection.prepareStatement(sql);
+        if constexpr (std::is_same_v<Params, std::tuple<>>) {
+            result->value.emplace(group->execute(stmt));
+        } else {
+            result->value.emplace(group->execute(stmt, params));
+        }
+    };
+    request.finish = [result](std::exception_ptr error) { result->finish(error); };
+    enqueue(std::move(request));
+    return future.get();
+}
+
+template<typename Row, typename Params>
+std::vector<Row> MultiplexedConnection::query(std::string sql, Params params) {
+    return run([sql = std::move(sql), params = std::move(params)](Connection& connection) {
+        auto stmt = connection.prepareStatement(sql);
+        auto tx = connection.readTransaction();
+        std::unique_ptr<ResultSet> cursor;
+        if constexpr (std::is_same_v<Params, std::tuple<>>) {
+            cursor = tx->openCursor(stmt);
+        } else {
+            cursor = tx->openCursor(stmt, params);
+        }
+        std::vector<Row> rows;
+        cursor->fetchAll(rows);
+        cursor->close();
+        return rows;
+    });
+}
+
+} // namespace core
+} // namespace fbpp
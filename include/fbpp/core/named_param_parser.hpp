@@ -1,6 +1,8 @@
 #pragma once
 
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 
@@ -24,6 +26,9 @@ struct NamedParamInfo {
  * - Case-insensitive parameter names
  * - Multiple uses of same parameter
  * - String literals and comments
+ *
+ * One forward pass over the lexical regions of detail::SqlLexer: literal
+ * and comment regions are copied in bulk, only code is scanned for markers.
  */
 class NamedParamParser {
 public:
@@ -41,18 +46,42 @@ public:
 
     static ParseResult parse(const std::string& sql);
 
-private:
-    // Check if we're inside a string literal
-    static bool isInString(const std::string& sql, size_t pos, char& quoteChar);
+    /**
+     * @brief parse() memoized process-wide by SQL text
+     *
+     * Keyed by a hash of the exact text (verified on lookup) and bounded
+     * to kCacheCapacity entries; statement preparation goes through here,
+     * so re-preparing the same text skips the parse.
+     */
+    static std::shared_ptr<const ParseResult> parseCached(const std::string& sql);
 
-    // Check if we're inside a comment
-    static bool isInComment(const std::string& sql, size_t pos);
+    /// Maximum number of memoized parse results
+    static constexpr size_t kCacheCapacity = 512;
+
+    /**
+     * @brief Expand a list parameter (`id IN (:ids)`) into a bucketed shape
+     *
+     * Every `:name` / `@name` marker outside literals and comments becomes
+     * `:name__0, :name__1, ... :name__{n-1}` with n = listBucket(count), so
+     * lists of 1..1024 values yield only 11 distinct SQL texts (and cache
+     * entries). Bind the values with ParamBinder::setList(), which pads
+     * the unused tail with the last value. Name matching is
+     * case-insensitive; text without the marker is returned unchanged.
+     */
+    static std::string expandList(const std::string& sql, std::string_view name, size_t count);
+
+    /**
+     * @brief Replace every `:name` / `@name` marker outside literals and
+     *        comments with `text` (same matching rules as expandList())
+     */
+    static std::string replaceParam(const std::string& sql, std::string_view name,
+                                    std::string_view text);
 
-    // Extract parameter name starting at position
-    static std::string extractParamName(const std::string& sql, size_t& pos);
+    /// Placeholders expandList() emits for `count` values: next power of two, at least 1
+    static size_t listBucket(size_t count) noexcept;
 
-    // Convert parameter name to lowercase for case-insensitive comparison
-    static std::string toLower(const std::string& str);
+    /// Separator between a list parameter name and its element index
+    static constexpr std::string_view kListElementSeparator = "__";
 };
 
 } // namespace core
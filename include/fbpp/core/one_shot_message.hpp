@@ -0,0 +1,113 @@
+#pragma once
+
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/message_builder.hpp"
+#include "fbpp/core/message_metadata.hpp"
+#include "fbpp/core/struct_descriptor.hpp"
+#include "fbpp/core/type_traits.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+namespace fbpp::core::detail {
+
+// Input messages of one-shot statements (Connection::executeOnce,
+// Connection::openCursorOnce). Nothing is prepared, so there is no input
+// metadata to ask: the message is described from the values themselves,
+// one nullable field per parameter, and the server converts each field to
+// the parameter's type as it executes.
+//
+// Strings get a VARCHAR of their own byte length; longer than a VARCHAR
+// holds, a BLOB. A NULL (nullopt, JSON null) is a one-byte VARCHAR.
+
+// Largest VARCHAR of an input message, in bytes
+inline constexpr std::size_t kOneShotMaxVarchar = 32765;
+
+inline void describeOneShotText(MessageBuilder& builder, unsigned index,
+                                const std::string& name, std::size_t bytes) {
+    if (bytes > kOneShotMaxVarchar) {
+        builder.setField(index, name, SQL_BLOB, static_cast<unsigned>(sizeof(ISC_QUAD)));
+    } else {
+        builder.setField(index, name, SQL_VARYING,
+                         static_cast<unsigned>(std::max<std::size_t>(bytes, 1)));
+    }
+}
+
+template<typename T>
+void describeOneShotValue(MessageBuilder& builder, unsigned index, const T& value) {
+    const std::string name = "PARAM_" + std::to_string(index);
+    if constexpr (is_optional_v<T>) {
+        if (value) {
+            describeOneShotValue(builder, index, *value);
+        } else {
+            builder.setField(index, name, SQL_VARYING, 1);
+        }
+    } else if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view> ||
+                         is_byte_span_v<T>) {
+        describeOneShotText(builder, index, name, value.size());
+    } else if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, char*>) {
+        describeOneShotText(builder, index, name, value ? std::char_traits<char>::length(value) : 0);
+    } else {
+        builder.setField<T>(index, name);
+    }
+}
+
+template<typename... Args>
+std::unique_ptr<MessageMetadata> oneShotInput(const std::tuple<Args...>& params) {
+    static_assert(sizeof...(Args) > 0, "A one-shot statement without parameters takes no tuple");
+    try {
+        MessageBuilder builder(static_cast<unsigned>(sizeof...(Args)));
+        std::apply(
+            [&](const auto&... values) {
+                unsigned index = 0;
+                (describeOneShotValue(builder, index++, values), ...);
+            },
+            params);
+        return builder.build();
+    } catch (const Firebird::FbException& e) {
+        throw FirebirdException(e);
+    }
+}
+
+// `positional` is a JSON array, named keys already resolved
+inline std::unique_ptr<MessageMetadata> oneShotInput(const nlohmann::json& positional) {
+    if (!positional.is_array() || positional.empty()) {
+        throw FirebirdException("One-shot JSON parameters must be a non-empty array");
+    }
+    try {
+        MessageBuilder builder(static_cast<unsigned>(positional.size()));
+        for (unsigned i = 0; i < positional.size(); ++i) {
+            const nlohmann::json& value = positional[i];
+            const std::string name = "PARAM_" + std::to_string(i);
+            if (value.is_null()) {
+                builder.setField(i, name, SQL_VARYING, 1);
+            } else if (value.is_boolean()) {
+                builder.setField<bool>(i, name);
+            } else if (value.is_number_unsigned() &&
+                       value.get<uint64_t>() >
+                           static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+                // packJsonValue() writes these as their decimal text
+                describeOneShotText(builder, i, name, std::to_string(value.get<uint64_t>()).size());
+            } else if (value.is_number_integer()) {
+                builder.setField<int64_t>(i, name);
+            } else if (value.is_number_float()) {
+                builder.setField<double>(i, name);
+            } else if (value.is_string()) {
+                describeOneShotText(builder, i, name, value.get_ref<const std::string&>().size());
+            } else {
+                throw FirebirdException("Unsupported JSON value for one-shot parameter " +
+                                        std::to_string(i) + ": " + value.type_name());
+            }
+        }
+        return builder.build();
+    } catch (const Firebird::FbException& e) {
+        throw FirebirdException(e);
+    }
+}
+
+} // namespace fbpp::core::detail
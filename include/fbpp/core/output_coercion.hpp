@@ -0,0 +1,88 @@
+#pragma once
+
+// OutputCoercion — ask the server to convert output columns before they are
+// sent, instead of decoding the native type on the client.
+//
+// A cursor opened with a coercion describes its output message with the
+// converted types; Firebird converts every row server-side (as it does for
+// SET BIND), so a NUMERIC(18,4) column arrives as a DOUBLE and a DECFLOAT as
+// text, and the client decodes a plain double / string:
+//
+//   OutputCoercion coercion;
+//   coercion.numerics = CoerceTo::Double;
+//   coercion.decfloats = CoerceTo::Varchar;
+//   coercion.columns["CREATED_AT"] = CoerceTo::Timestamp;
+//   auto cursor = tx->openCursor(stmt, coercion);
+//   std::tuple<int32_t, double, std::string, Timestamp> row;
+//
+// The same spec in text form, as query_generator --output-coercion takes it:
+//
+//   NUMERIC=DOUBLE;DECFLOAT=VARCHAR;column:CREATED_AT=TIMESTAMP
+//
+// A WITH TIME ZONE value coerced to Timestamp loses its zone and is given in
+// the session time zone; attach with SET TIME ZONE 'UTC' (or
+// isc_dpb_session_time_zone) to read UTC.
+
+#include "fbpp/core/message_metadata.hpp"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fbpp {
+namespace core {
+
+enum class CoerceTo {
+    Native,      ///< Leave the column as described by the statement
+    Double,      ///< DOUBLE PRECISION
+    BigInt,      ///< BIGINT, keeping a NUMERIC's scale
+    Varchar,     ///< VARCHAR holding the value's text form
+    Timestamp    ///< Without time zone: TIME / TIMESTAMP in the session time zone
+};
+
+struct OutputCoercion {
+    /// NUMERIC / DECIMAL with a scale, and INT128: Double, BigInt or Varchar
+    CoerceTo numerics = CoerceTo::Native;
+    /// DECFLOAT(16) and DECFLOAT(34): Double, BigInt or Varchar
+    CoerceTo decfloats = CoerceTo::Native;
+    /// TIME / TIMESTAMP WITH TIME ZONE: Timestamp or Varchar
+    CoerceTo timeZones = CoerceTo::Native;
+    /// By column name (alias, else origin name; upper case), ahead of the
+    /// type rules; Native exempts a column from them
+    std::map<std::string, CoerceTo> columns;
+
+    bool empty() const noexcept;
+
+    /// Canonical text form, accepted by parse(); "" when empty()
+    std::string toString() const;
+
+    /**
+     * @brief Read a spec such as "NUMERIC=DOUBLE; column:TOTAL=VARCHAR"
+     *
+     * Rules are separated by ';' or ','; keys are NUMERIC, DECFLOAT,
+     * TIMEZONE or column:<name>; targets NATIVE, DOUBLE, BIGINT, VARCHAR or
+     * TIMESTAMP, all case-insensitive. Throws FirebirdException on anything
+     * else.
+     */
+    static OutputCoercion parse(std::string_view spec);
+};
+
+/**
+ * @brief Output format of `fields` under `coercion`
+ *
+ * Built with the master's IMetadataBuilder, so it needs no attachment and
+ * the same fields always give the same offsets. Returns nullptr when the
+ * coercion changes no column. Throws FirebirdException for a column rule
+ * the column's type cannot take (BLOB, ARRAY, BOOLEAN, or Timestamp on a
+ * non-temporal column).
+ */
+std::shared_ptr<const MessageMetadata> coerceOutput(const std::vector<FieldInfo>& fields,
+                                                    const OutputCoercion& coercion);
+
+std::shared_ptr<const MessageMetadata> coerceOutput(const MessageMetadata& native,
+                                                    const OutputCoercion& coercion);
+
+} // namespace core
+} // namespace fbpp
@@ -0,0 +1,399 @@
+#pragma once
+
+// PackPlan<T> — tuple/struct packing resolved once per message format.
+//
+// pack() of a tuple or described struct used to look every column up in
+// MessageMetadata, re-check descriptor types and let sql_value_codec
+// switch on the SQL type, per value and per row. A PackPlan does the
+// matching once: it validates arity (and descriptor types for structs),
+// copies offsets and picks a writer per column — a direct store for the
+// common native cases (integers and floats into same-kind columns at
+// non-negative scale, std::string / std::string_view / FixedString into
+// CHAR/VARCHAR), the codec for
+// everything else. Packing a row is then one memset and one indirect call
+// per column.
+//
+// A struct whose descriptor carries its build-time layout (exact_layout_v,
+// see struct_descriptor.hpp) and matches the live one skips even that
+// indirection: stores are chosen at compile time from the descriptor's
+// types and write at its constant offsets.
+//
+// Plans are cached per MessageMetadata (PackPlan<T>::of), so Statement,
+// Batch and ParamBinder share them through the statement's input metadata.
+// Like MessageMetadata itself, a plan cache is not thread-safe; a plan
+// that has been obtained is immutable.
+
+#include "fbpp/core/message_metadata.hpp"
+#include "fbpp/core/struct_descriptor.hpp"
+#include "fbpp/core/type_traits.hpp"
+#include "fbpp/core/detail/sql_value_codec.hpp"
+#include "fbpp/core/exception.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <typeindex>
+#include <utility>
+
+namespace fbpp::core {
+
+class Transaction;
+
+namespace detail {
+
+/// Writes one column value (`value` points at the C++ field)
+using PackWriteFn = void (*)(const void* value, uint8_t* data, int16_t* nullPtr,
+                             const FieldInfo* field, Transaction* transaction);
+
+// Column stores. Each mirrors the matching sql_value_codec branch for the
+// one column kind it was selected for.
+
+struct CodecStore {
+    template<typename V>
+    static void write(const V& value, uint8_t* data, int16_t* nullPtr,
+                      const FieldInfo* field, Transaction* transaction) {
+        sql_value_codec::SqlWriteContext ctx{field, transaction, nullPtr};
+        sql_value_codec::write_sql_value(ctx, value, data);
+    }
+};
+
+template<typename Target>
+struct IntStore {
+    static constexpr const char* sqlName() {
+        if constexpr (sizeof(Target) == 2) return "SMALLINT";
+        else if constexpr (sizeof(Target) == 4) return "INTEGER";
+        else return "BIGINT";
+    }
+
+    template<typename V>
+    static void write(const V& value, uint8_t* data, int16_t* nullPtr,
+                      const FieldInfo*, Transaction*) {
+        const int64_t numericValue = static_cast<int64_t>(value);
+        const Target v = sql_value_codec::checked_narrow<Target>(numericValue, sqlName());
+        std::memcpy(data, &v, sizeof(v));
+        sql_value_codec::setNotNull(nullPtr);
+    }
+};
+
+template<typename Target>
+struct FloatStore {
+    template<typename V>
+    static void write(const V& value, uint8_t* data, int16_t* nullPtr,
+                      const FieldInfo*, Transaction*) {
+        const Target v = static_cast<Target>(value);
+        std::memcpy(data, &v, sizeof(v));
+        sql_value_codec::setNotNull(nullPtr);
+    }
+};
+
+template<bool Varying>
+struct StringStore {
+    template<typename V>
+    static void write(const V& value, uint8_t* data, int16_t* nullPtr,
+                      const FieldInfo* field, Transaction*) {
+        if (value.size() > static_cast<size_t>(field->length)) {
+            throw FirebirdException(
+                "String value too long for field " + field->name +
+                ": " + std::to_string(value.size()) + " bytes, field holds " +
+                std::to_string(field->length) + " bytes");
+        }
+        if constexpr (Varying) {
+            const uint16_t len = static_cast<uint16_t>(value.size());
+            std::memcpy(data, &len, sizeof(uint16_t));
+            std::memcpy(data + sizeof(uint16_t), value.data(), value.size());
+        } else {
+            std::memcpy(data, value.data(), value.size());
+            if (value.size() < field->length) {
+                std::memset(data + value.size(), ' ', field->length - value.size());
+            }
+        }
+        sql_value_codec::setNotNull(nullPtr);
+    }
+};
+
+template<typename V, typename Store>
+void writeColumn(const void* value, uint8_t* data, int16_t* nullPtr,
+                 const FieldInfo* field, Transaction* transaction) {
+    const V& typed = *static_cast<const V*>(value);
+    if constexpr (is_optional_v<V>) {
+        if (!typed.has_value()) {
+            sql_value_codec::setNull(nullPtr);
+            return;
+        }
+        Store::write(*typed, data, nullPtr, field, transaction);
+    } else {
+        Store::write(typed, data, nullPtr, field, transaction);
+    }
+}
+
+/**
+ * @brief Pick the writer for a C++ type V going into `field`
+ */
+template<typename V>
+PackWriteFn selectPackWriter(const FieldInfo& field) {
+    using U = typename unwrap_optional<V>::type;
+
+    if constexpr (!has_type_adapter_v<U>) {
+        const unsigned fieldType = sql_value_codec::normalize_sql_type(field.type);
+
+        if constexpr (std::is_integral_v<U> && !std::is_same_v<U, bool>) {
+            if (field.scale >= 0) {
+                switch (fieldType) {
+                    case SQL_SHORT: return &writeColumn<V, IntStore<int16_t>>;
+                    case SQL_LONG:  return &writeColumn<V, IntStore<int32_t>>;
+                    case SQL_INT64: return &writeColumn<V, IntStore<int64_t>>;
+                    default: break;
+                }
+            }
+        } else if constexpr (std::is_floating_point_v<U>) {
+            if (field.scale >= 0) {
+                switch (fieldType) {
+                    case SQL_FLOAT:   return &writeColumn<V, FloatStore<float>>;
+                    case SQL_DOUBLE:
+                    case SQL_D_FLOAT: return &writeColumn<V, FloatStore<double>>;
+                    default: break;
+                }
+            }
+        } else if constexpr (std::is_same_v<U, std::string> || std::is_same_v<U, std::string_view> ||
+                             is_fixed_string_v<U>) {
+            // Same test as the codec (un-normalized type)
+            if (field.type == SQL_VARYING) return &writeColumn<V, StringStore<true>>;
+            if (field.type == SQL_TEXT) return &writeColumn<V, StringStore<false>>;
+        }
+    }
+
+    return &writeColumn<V, CodecStore>;
+}
+
+/**
+ * @brief selectPackWriter() resolved at compile time for a pinned column
+ */
+template<typename V, unsigned SqlType, int Scale>
+constexpr auto pinnedStore() {
+    using U = typename unwrap_optional<V>::type;
+    constexpr unsigned fieldType = SqlType & ~1u;   // normalize_sql_type
+
+    if constexpr (has_type_adapter_v<U>) {
+        return std::type_identity<CodecStore>{};
+    } else if constexpr (std::is_integral_v<U> && !std::is_same_v<U, bool> && Scale >= 0) {
+        if constexpr (fieldType == SQL_SHORT) return std::type_identity<IntStore<int16_t>>{};
+        else if constexpr (fieldType == SQL_LONG) return std::type_identity<IntStore<int32_t>>{};
+        else if constexpr (fieldType == SQL_INT64) return std::type_identity<IntStore<int64_t>>{};
+        else return std::type_identity<CodecStore>{};
+    } else if constexpr (std::is_floating_point_v<U> && Scale >= 0) {
+        if constexpr (fieldType == SQL_FLOAT) return std::type_identity<FloatStore<float>>{};
+        else if constexpr (fieldType == SQL_DOUBLE || fieldType == SQL_D_FLOAT)
+            return std::type_identity<FloatStore<double>>{};
+        else return std::type_identity<CodecStore>{};
+    } else if constexpr (std::is_same_v<U, std::string> || std::is_same_v<U, std::string_view> ||
+                         is_fixed_string_v<U>) {
+        if constexpr (SqlType == SQL_VARYING) return std::type_identity<StringStore<true>>{};
+        else if constexpr (SqlType == SQL_TEXT) return std::type_identity<StringStore<false>>{};
+        else return std::type_identity<CodecStore>{};
+    } else {
+        return std::type_identity<CodecStore>{};
+    }
+}
+
+template<typename V, unsigned SqlType, int Scale>
+using pinned_store_t = typename decltype(pinnedStore<V, SqlType, Scale>())::type;
+
+template<typename T, typename = void>
+struct pack_plan_traits;
+
+template<typename T>
+struct pack_plan_traits<T, std::enable_if_t<is_tuple_v<T>>> {
+    static constexpr size_t size = std::tuple_size_v<T>;
+
+    template<size_t I>
+    using value_type = std::remove_cvref_t<std::tuple_element_t<I, T>>;
+
+    template<size_t I>
+    static const void* address(const T& row) { return &std::get<I>(row); }
+
+    template<size_t I>
+    static void* address(T& row) { return &std::get<I>(row); }
+};
+
+template<typename T>
+struct pack_plan_traits<T, std::enable_if_t<StructPackable<T>>> {
+    using Fields = std::decay_t<decltype(StructDescriptor<T>::fields)>;
+    static constexpr size_t size = std::tuple_size_v<Fields>;
+
+    template<size_t I>
+    using value_type = std::remove_cvref_t<
+        typename std::tuple_element_t<I, Fields>::field_type>;
+
+    template<size_t I>
+    static const void* address(const T& row) {
+        return &std::get<I>(StructDescriptor<T>::fields).access(row);
+    }
+
+    template<size_t I>
+    static void* address(T& row) {
+        return &std::get<I>(StructDescriptor<T>::fields).access(row);
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief Column-by-column packing program for T against one message format
+ *
+ * T is a std::tuple or a type with a StructDescriptor. Construction
+ * validates T against the metadata and throws FirebirdException with the
+ * same messages pack() always used.
+ */
+template<typename T>
+class PackPlan {
+    using Traits = detail::pack_plan_traits<T>;
+    static constexpr size_t kColumns = Traits::size;
+
+public:
+    explicit PackPlan(const MessageMetadata& metadata)
+        : layout_(metadata.getLayout()) {
+        const auto& plan = layout_->columnPlan;
+
+        if constexpr (is_tuple_v<T>) {
+            if (kColumns != plan.size()) {
+                throw FirebirdException(
+                    "Tuple arity mismatch: tuple has " + std::to_string(kColumns) +
+                    " elements, but query expects " + std::to_string(plan.size()) + " parameters"
+                );
+            }
+        } else {
+            if (kColumns != plan.size()) {
+                throw FirebirdException(
+                    std::string("Field count mismatch for ") +
+                    detail::descriptor_name<T>() +
+                    ": expected " + std::to_string(kColumns) +
+                    ", got " + std::to_string(plan.size())
+                );
+            }
+            checkDescriptor(std::make_index_sequence<kColumns>{});
+            if constexpr (detail::exact_layout_v<T>) {
+                exact_ = layout_->layoutHash == StructDescriptor<T>::layout_hash;
+            }
+        }
+
+        build(std::make_index_sequence<kColumns>{});
+    }
+
+    /**
+     * @brief Pack `row` into a message buffer of messageLength() bytes
+     * @param transaction Transaction for BLOB columns (optional)
+     */
+    void pack(const T& row, uint8_t* buffer, Transaction* transaction = nullptr) const {
+        std::memset(buffer, 0, layout_->messageLength);
+        if constexpr (detail::exact_layout_v<T>) {
+            if (exact_) {
+                packExact(row, buffer, transaction, std::make_index_sequence<kColumns>{});
+                return;
+            }
+        }
+        packColumns(row, buffer, transaction, std::make_index_sequence<kColumns>{});
+    }
+
+    unsigned messageLength() const noexcept { return layout_->messageLength; }
+
+    /// True when T's build-time layout matched and pack() is the
+    /// compile-time resolved path
+    bool exact() const noexcept { return exact_; }
+
+    /**
+     * @brief Plan for `metadata`, built on first use and cached on it
+     */
+    static const PackPlan& of(const MessageMetadata& metadata) {
+        const std::type_index key(typeid(PackPlan));
+        if (auto cached = metadata.findPlan(key)) {
+            return *static_cast<const PackPlan*>(cached.get());
+        }
+        auto plan = std::make_shared<const PackPlan>(metadata);
+        const PackPlan& ref = *plan;
+        metadata.storePlan(key, std::move(plan));
+        return ref;
+    }
+
+private:
+    struct Column {
+        unsigned offset = 0;
+        unsigned nullOffset = 0;
+        const FieldInfo* field = nullptr;
+        detail::PackWriteFn write = nullptr;
+    };
+
+    template<size_t... I>
+    void build(std::index_sequence<I...>) {
+        ((columns_[I] = Column{
+            layout_->columnPlan[I].offset,
+            layout_->columnPlan[I].nullOffset,
+            layout_->columnPlan[I].field,
+            detail::selectPackWriter<typename Traits::template value_type<I>>(
+                *layout_->columnPlan[I].field)
+        }), ...);
+    }
+
+    template<size_t... I>
+    void checkDescriptor(std::index_sequence<I...>) const {
+        (checkField(std::get<I>(StructDescriptor<T>::fields), *layout_->columnPlan[I].field), ...);
+    }
+
+    template<typename Descriptor>
+    static void checkField(const Descriptor& descriptor, const FieldInfo& fieldInfo) {
+        if (descriptor.sqlType != fieldInfo.type) {
+            throw FirebirdException(
+                std::string("SQL type mismatch for field '") + descriptor.sqlName +
+                "': expected " + std::to_string(descriptor.sqlType) +
+                ", got " + std::to_string(fieldInfo.type)
+            );
+        }
+        if (descriptor.scale != 0 && descriptor.scale != fieldInfo.scale) {
+            throw FirebirdException(
+                std::string("Scale mismatch for field '") + descriptor.sqlName +
+                "': expected " + std::to_string(descriptor.scale) +
+                ", got " + std::to_string(fieldInfo.scale)
+            );
+        }
+    }
+
+    template<size_t... I>
+    void packColumns(const T& row, uint8_t* buffer, Transaction* transaction,
+                     std::index_sequence<I...>) const {
+        (columns_[I].write(Traits::template address<I>(row),
+                           buffer + columns_[I].offset,
+                           reinterpret_cast<int16_t*>(buffer + columns_[I].nullOffset),
+                           columns_[I].field,
+                           transaction), ...);
+    }
+
+    template<size_t I>
+    void packExactColumn(const T& row, uint8_t* buffer, Transaction* transaction) const {
+        constexpr auto& descriptor = std::get<I>(StructDescriptor<T>::fields);
+        using V = typename Traits::template value_type<I>;
+        using Store = detail::pinned_store_t<V, descriptor.sqlType, descriptor.scale>;
+        detail::writeColumn<V, Store>(
+            Traits::template address<I>(row),
+            buffer + StructDescriptor<T>::offsets[I],
+            reinterpret_cast<int16_t*>(buffer + StructDescriptor<T>::null_offsets[I]),
+            columns_[I].field,
+            transaction);
+    }
+
+    template<size_t... I>
+    void packExact(const T& row, uint8_t* buffer, Transaction* transaction,
+                   std::index_sequence<I...>) const {
+        (packExactColumn<I>(row, buffer, transaction), ...);
+    }
+
+    std::shared_ptr<const MetadataLayout> layout_;   // Owns the FieldInfo
+    std::array<Column, kColumns> columns_{};
+    bool exact_ = false;
+};
+
+} // namespace fbpp::core
@@ -2,9 +2,12 @@
 
 #include "fbpp/core/struct_descriptor.hpp"
 #include "fbpp/core/message_metadata.hpp"
+#include "fbpp/core/pack_plan.hpp"
+#include "fbpp/core/unpack_plan.hpp"
 #include "fbpp/core/type_traits.hpp"
 #include "fbpp/core/tuple_packer.hpp"
 #include "fbpp/core/json_packer.hpp"
+#include "fbpp/core/json_text_packer.hpp"
 #include "fbpp/core/tuple_unpacker.hpp"
 #include "fbpp/core/json_unpacker.hpp"
 #include <nlohmann/json.hpp>
@@ -17,7 +20,7 @@ class Transaction;
 
 /**
  * @brief Universal pack function - packs data of any supported type into Firebird buffer
- * @tparam T Type to pack (tuple, json, etc)
+ * @tparam T Type to pack (tuple, json, JsonText, etc)
  * @param data Data to pack
  * @param buffer Output buffer
  * @param metadata Message metadata describing the buffer structure
@@ -28,23 +31,28 @@ inline void pack(const T& data,
                  uint8_t* buffer,
                  const MessageMetadata* metadata,
                  Transaction* transaction = nullptr) {
-    if constexpr (is_struct_packable_v<T>) {
-        packStruct(data, buffer, metadata, transaction);
-    }
-    else if constexpr (is_tuple_v<T>) {
-        // For tuple - use TuplePacker with proper template arguments
-        std::apply([&](auto&&... args) {
-            TuplePacker<std::decay_t<decltype(args)>...> packer;
-            packer.pack(data, buffer, metadata, transaction);
-        }, data);
+    if constexpr (is_struct_packable_v<T> || is_tuple_v<T>) {
+        // Tuples and structs: the metadata's cached PackPlan<T> (validated
+        // once, direct stores for native columns)
+        if (!buffer || !metadata) {
+            throw FirebirdException("Invalid parameters for pack");
+        }
+        PackPlan<T>::of(*metadata).pack(data, buffer, transaction);
     }
     else if constexpr (is_json_v<T>) {
         // For JSON - use JsonPacker
         JsonPacker packer;
         packer.pack(data, buffer, metadata, transaction);
     }
+    else if constexpr (std::is_same_v<T, JsonText>) {
+        // Raw JSON text: scanned straight into the buffer, no DOM
+        if (!buffer || !metadata) {
+            throw FirebirdException("Invalid parameters for pack");
+        }
+        JsonTextPacker::of(*metadata).pack(data.text, buffer, transaction);
+    }
     else {
-        static_assert(detail::dependent_false_v<T>, "Unsupported type for packing. Use tuple, json, or struct with StructDescriptor");
+        static_assert(detail::dependent_false_v<T>, "Unsupported type for packing. Use tuple, json, JsonText, or struct with StructDescriptor");
     }
 }
 
@@ -56,7 +64,29 @@ struct UnpackerHelper<T, std::enable_if_t<is_struct_packable_v<T>>> {
     static T unpack(const uint8_t* buffer,
                     const MessageMetadata* metadata,
                     Transaction* transaction) {
-        return unpackStruct<T>(buffer, metadata, transaction);
+        T result{};
+        unpackInto(buffer, metadata, result, transaction);
+        return result;
+    }
+
+    static void unpackInto(const uint8_t* buffer,
+                           const MessageMetadata* metadata,
+                           T& out,
+                           Transaction* transaction) {
+        if constexpr (detail::message_layout_v<T> || detail::pinned_decode_v<T>) {
+            // Their own fast paths and fallbacks
+            unpackStructInto(out, buffer, metadata, transaction);
+        } else {
+            // The metadata's cached UnpackPlan<T> (validated once, typed
+            // loads for native columns)
+            if (!buffer) {
+                throw FirebirdException("NULL buffer in unpackStruct");
+            }
+            if (!metadata) {
+                throw FirebirdException("NULL metadata in unpackStruct");
+            }
+            UnpackPlan<T>::of(*metadata).unpack(buffer, out, transaction);
+        }
     }
 };
 
@@ -65,8 +95,19 @@ struct UnpackerHelper<std::tuple<Args...>, void> {
     static std::tuple<Args...> unpack(const uint8_t* buffer,
                                       const MessageMetadata* metadata,
                                       Transaction* transaction) {
-        TupleUnpacker<Args...> unpacker;
-        return unpacker.unpack(buffer, metadata, transaction);
+        std::tuple<Args...> result;
+        unpackInto(buffer, metadata, result, transaction);
+        return result;
+    }
+
+    static void unpackInto(const uint8_t* buffer,
+                           const MessageMetadata* metadata,
+                           std::tuple<Args...>& out,
+                           Transaction* transaction) {
+        if (!buffer || !metadata) {
+            throw FirebirdException("Invalid parameters for unpack");
+        }
+        UnpackPlan<std::tuple<Args...>>::of(*metadata).unpack(buffer, out, transaction);
     }
 };
 
@@ -78,6 +119,14 @@ struct UnpackerHelper<nlohmann::json, void> {
         JsonUnpacker unpacker;
         return unpacker.unpack(buffer, metadata, transaction);
     }
+
+    static void unpackInto(const uint8_t* buffer,
+                           const MessageMetadata* metadata,
+                           nlohmann::json& out,
+                           Transaction* transaction) {
+        JsonUnpacker unpacker;
+        unpacker.unpack(buffer, metadata, out, transaction);
+    }
 };
 
 template<typename T>
@@ -89,6 +138,11 @@ struct UnpackerHelper<T, std::enable_if_t<!is_struct_packable_v<T> && !is_tuple_
                       "Unsupported type for unpacking. Use tuple, json, or struct with StructDescriptor");
         return T{};
     }
+
+    static void unpackInto(const uint8_t*, const MessageMetadata*, T&, Transaction*) {
+        static_assert(detail::dependent_false_v<T>,
+                      "Unsupported type for unpacking. Use tuple, json, or struct with StructDescriptor");
+    }
 };
 
 template<typename T>
@@ -98,4 +152,18 @@ inline T unpack(const uint8_t* buffer,
     return UnpackerHelper<T>::unpack(buffer, metadata, transaction);
 }
 
+/**
+ * @brief Universal unpack into an existing value
+ *
+ * Overwrites every field of `out` in place, so strings (also inside
+ * optionals) reuse their capacity instead of being rebuilt per row.
+ */
+template<typename T>
+inline void unpackInto(const uint8_t* buffer,
+                       const MessageMetadata* metadata,
+                       T& out,
+                       Transaction* transaction = nullptr) {
+    UnpackerHelper<T>::unpackInto(buffer, metadata, out, transaction);
+}
+
 } // namespace fbpp::core
@@ -0,0 +1,301 @@
+#pragma once
+
+// ParallelBulkLoader<T> — fan a row source out over several connections.
+//
+// Initial seeding is bound by a single attachment's insert rate long
+// before the server runs out of CPU. ParallelBulkLoader splits the rows
+// into N partitions, opens one Connection + Transaction per partition on
+// its own worker thread and feeds each through a BulkLoader (so every
+// partition is a sequence of size-capped Batch executes). Per-partition
+// results are folded back into one BatchResult indexed by source
+// position, next to wall-clock throughput.
+//
+//   ParallelBulkLoader<Row> loader(params, "INSERT INTO t VALUES (?, ?)");
+//   auto report = loader.load(rows);                       // contiguous slices
+//   auto keyed = loader.load(rows, [](const Row& r) {      // by key
+//       return static_cast<size_t>(std::get<0>(r));
+//   });
+//
+// Partitions commit independently: a failed partition rolls back alone.
+// Rows that conflict on a key should land in the same partition (keyed
+// load), or concurrent transactions wait on each other's locks.
+
+#include "fbpp/core/bulk_loader.hpp"
+#include "fbpp/core/batch.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/exception.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <ranges>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace fbpp::core {
+
+/**
+ * @brief Partitioning and commit policy of a ParallelBulkLoader
+ */
+struct ParallelLoadOptions {
+    // Partitions, i.e. connections and worker threads
+    unsigned partitions = 4;
+    // Per-partition BulkLoader settings (flush size, continueOnError, ...)
+    BulkLoaderOptions loader;
+    // Commit each partition that finished; false rolls every partition back
+    // (dry run). A partition with failed messages commits only when
+    // loader.continueOnError is set.
+    bool commit = true;
+};
+
+/**
+ * @brief Outcome of one partition
+ */
+struct ParallelPartitionResult {
+    size_t rows = 0;                     // Rows assigned to the partition
+    BatchResult result;                  // Indexes local to the partition
+    bool committed = false;
+    std::string error;                   // Connect/prepare/execute failure, if any
+    std::chrono::steady_clock::duration elapsed{};
+};
+
+/**
+ * @brief Aggregated outcome of a parallel load
+ */
+struct ParallelLoadResult {
+    // All rows, indexed by source position. Rows of a partition that threw
+    // are reported EXECUTE_FAILED without a message of their own.
+    BatchResult result;
+    std::vector<ParallelPartitionResult> partitions;
+    size_t committedRows = 0;            // Successful rows of committed partitions
+    std::chrono::steady_clock::duration elapsed{};
+
+    /// Committed rows per wall-clock second
+    double rowsPerSecond() const {
+        const double seconds = std::chrono::duration<double>(elapsed).count();
+        return seconds > 0 ? static_cast<double>(committedRows) / seconds : 0.0;
+    }
+
+    /// Every partition committed and no message failed
+    bool ok() const {
+        return result.failedCount == 0 &&
+               std::all_of(partitions.begin(), partitions.end(),
+                           [](const auto& p) { return p.committed; });
+    }
+};
+
+/**
+ * @brief Multi-connection bulk loader for rows of type T
+ *
+ * Rows are whatever BulkLoader<T> accepts. load() blocks until every
+ * partition finished; the row range must stay alive and unmodified
+ * meanwhile. One loader may run several loads one after another.
+ */
+template<typename T>
+class ParallelBulkLoader {
+public:
+    /// Opens one connection; called once per partition, on its worker thread
+    using ConnectionFactory = std::function<std::unique_ptr<Connection>()>;
+
+    ParallelBulkLoader(ConnectionFactory factory, std::string sql,
+                       ParallelLoadOptions options = {})
+        : factory_(std::move(factory)), sql_(std::move(sql)), options_(options) {
+        if (!factory_) {
+            throw FirebirdException("ParallelBulkLoader: connection factory required");
+        }
+        if (options_.partitions == 0) {
+            throw FirebirdException("ParallelBulkLoader: at least one partition required");
+        }
+    }
+
+    ParallelBulkLoader(const ConnectionParams& params, std::string sql,
+                       ParallelLoadOptions options = {})
+        : ParallelBulkLoader([params] { return std::make_unique<Connection>(params); },
+                             std::move(sql), options) {}
+
+    /**
+     * @brief Load `rows` split into contiguous, equally sized slices
+     *
+     * Sorted input gives every connection its own key range.
+     */
+    template<std::ranges::random_access_range Range>
+    ParallelLoadResult load(const Range& rows) {
+        const size_t total = static_cast<size_t>(std::ranges::size(rows));
+        const size_t parts = std::min<size_t>(options_.partitions, std::max<size_t>(total, 1));
+
+        std::vector<std::vector<size_t>> slices(parts);
+        for (size_t p = 0; p < parts; ++p) {
+            const size_t lo = total * p / parts;
+            const size_t hi = total * (p + 1) / parts;
+            slices[p].reserve(hi - lo);
+            for (size_t i = lo; i < hi; ++i) {
+                slices[p].push_back(i);
+            }
+        }
+        return run(rows, slices);
+    }
+
+    /**
+     * @brief Load `rows`, routing each to partition partitionOf(row) % partitions
+     *
+     * Rows keep their source order within a partition.
+     */
+    template<std::ranges::random_access_range Range, typename PartitionFn>
+    ParallelLoadResult load(const Range& rows, PartitionFn&& partitionOf) {
+        std::vector<std::vector<size_t>> slices(options_.partitions);
+        size_t index = 0;
+        for (const auto& row : rows) {
+            slices[static_cast<size_t>(partitionOf(row)) % slices.size()].push_back(index++);
+        }
+        return run(rows, slices);
+    }
+
+    const ParallelLoadOptions& options() const { return options_; }
+
+private:
+    template<typename Range>
+    ParallelLoadResult run(const Range& rows, const std::vector<std::vector<size_t>>& slices) {
+        ParallelLoadResult report;
+        report.partitions.resize(slices.size());
+
+        const auto started = std::chrono::steady_clock::now();
+        {
+            std::vector<std::thread> workers;
+            workers.reserve(slices.size());
+            for (size_t p = 0; p < slices.size(); ++p) {
+                workers.emplace_back([&, p] {
+                    loadPartition(rows, slices[p], report.partitions[p]);
+                });
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        }
+        report.elapsed = std::chrono::steady_clock::now() - started;
+
+        size_t total = 0;
+        for (const auto& slice : slices) {
+            total += slice.size();
+        }
+        collect(slices, total, report);
+        return report;
+    }
+
+    template<typename Range>
+    void loadPartition(const Range& rows, const std::vector<size_t>& slice,
+                       ParallelPartitionResult& out) const {
+        const auto started = std::chrono::steady_clock::now();
+        out.rows = slice.size();
+
+        try {
+            // Declaration order: the connection outlives its statement/transaction.
+            std::unique_ptr<Connection> connection = factory_();
+            if (!connection || !connection->isConnected()) {
+                throw FirebirdException("ParallelBulkLoader: connection factory returned no connection");
+            }
+            auto transaction = connection->StartTransaction();
+            auto statement = connection->prepareStatement(sql_);
+
+            try {
+                BulkLoader<T> loader(statement, transaction, options_.loader);
+                auto first = std::ranges::begin(rows);
+                loader.addMany(slice | std::views::transform(
+                    [first](size_t i) -> decltype(auto) { return first[i]; }));
+                out.result = loader.finish();
+
+                const bool accept = out.result.failedCount == 0 || options_.loader.continueOnError;
+                if (options_.commit && accept) {
+                    transaction->Commit();
+                    out.committed = true;
+                } else {
+                    transaction->Rollback();
+                }
+            } catch (...) {
+                if (transaction->isActive()) {
+                    try { transaction->Rollback(); } catch (...) {}
+                }
+                throw;
+            }
+        } catch (const std::exception& e) {
+            out.error = e.what();
+        } catch (...) {
+            out.error = "unknown error";
+        }
+
+        out.elapsed = std::chrono::steady_clock::now() - started;
+    }
+
+    // Fold partition results into source order.
+    static void collect(const std::vector<std::vector<size_t>>& slices, size_t total,
+                        ParallelLoadResult& report) {
+        auto& merged = report.result;
+        merged.totalMessages = static_cast<unsigned>(total);
+        merged.perMessageStatus.assign(total, Firebird::IBatchCompletionState::EXECUTE_FAILED);
+
+        std::vector<std::pair<unsigned, std::string>> errors;
+        for (size_t p = 0; p < slices.size(); ++p) {
+            const auto& slice = slices[p];
+            auto& part = report.partitions[p];
+            // Without record counts a partition lists only its failures
+            std::vector<int> listed;
+            if (part.result.perMessageStatus.empty() && part.result.totalMessages > 0) {
+                listed.assign(part.result.totalMessages,
+                              Firebird::IBatchCompletionState::SUCCESS_NO_INFO);
+                for (unsigned index : part.result.errorIndices) {
+                    if (index < listed.size()) {
+                        listed[index] = Firebird::IBatchCompletionState::EXECUTE_FAILED;
+                    }
+                }
+            }
+            const auto& statuses = listed.empty() ? part.result.perMessageStatus : listed;
+
+            for (size_t i = 0; i < slice.size(); ++i) {
+                const int state = i < statuses.size()
+                    ? statuses[i] : Firebird::IBatchCompletionState::EXECUTE_FAILED;
+                merged.perMessageStatus[slice[i]] = state;
+                if (state == Firebird::IBatchCompletionState::EXECUTE_FAILED) {
+                    ++merged.failedCount;
+                } else {
+                    ++merged.successCount;
+                    if (part.committed) {
+                        ++report.committedRows;
+                    }
+                }
+            }
+
+            const auto& partErrors = part.result.errors;
+            const auto& partIndices = part.result.errorIndices;
+            for (size_t e = 0; e < partErrors.size() && e < partIndices.size(); ++e) {
+                if (partIndices[e] >= slice.size()) {
+                    continue;
+                }
+                const unsigned index = static_cast<unsigned>(slice[partIndices[e]]);
+                const auto colon = partErrors[e].find(": ");
+                errors.emplace_back(index, std::string("Message ") + std::to_string(index) +
+                    (colon == std::string::npos ? ": " + partErrors[e] : partErrors[e].substr(colon)));
+            }
+        }
+
+        std::sort(errors.begin(), errors.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+        merged.errors.reserve(errors.size());
+        merged.errorIndices.reserve(errors.size());
+        for (auto& [index, message] : errors) {
+            merged.errorIndices.push_back(index);
+            merged.errors.push_back(std::move(message));
+        }
+    }
+
+    ConnectionFactory factory_;
+    std::string sql_;
+    ParallelLoadOptions options_;
+};
+
+} // namespace fbpp::core
@@ -10,6 +10,9 @@
 // trim + lowercase name normalization with non-throwing unknown-name
 // semantics (legacy IBO behaviour). Lazy construction without Transaction,
 // reuse via clear(), move-friendly for storing in std::optional / std::map.
+//
+// Hot statements can resolve names once with slot("name") and bind through
+// the returned ParamSlot: no normalization, no map lookup, no allocation.
 
 #include "fbpp/core/statement.hpp"
 #include "fbpp/core/message_metadata.hpp"
@@ -17,12 +20,17 @@
 #include "fbpp/core/result_set.hpp"
 #include "fbpp/core/detail/sql_value_codec.hpp"
 #include "fbpp/core/tuple_packer.hpp"
+#include "fbpp/core/pack_plan.hpp"
+#include "fbpp/core/named_param_parser.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cctype>
+#include <charconv>
 #include <cstdint>
 #include <cstring>
 #include <memory>
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -30,6 +38,28 @@
 namespace fbpp {
 namespace core {
 
+/**
+ * @brief A named parameter resolved once: every '?' it expands to
+ *
+ * Obtained from ParamBinder::slot(); valid for any binder over a statement
+ * that shares the same input metadata (binders over one statement do).
+ * An unknown name gives an empty slot, and binding it returns false like
+ * set() does.
+ */
+class ParamSlot {
+public:
+    ParamSlot() = default;
+
+    bool empty() const noexcept { return fields_.empty(); }
+    std::size_t size() const noexcept { return fields_.size(); }
+
+private:
+    friend class ParamBinder;
+
+    const MessageMetadata* metadata_ = nullptr;
+    std::vector<std::pair<unsigned, const FieldInfo*>> fields_;   // (position, field)
+};
+
 class ParamBinder {
 public:
     // Lazy construction: tx is optional. Without tx, BLOB-typed parameters
@@ -63,12 +93,15 @@ public:
     // (handled via the codec's std::optional overload — no explicit set()
     // overload needed). For literal NULL without spelling the inner type,
     // use set(name, std::nullopt) — see overload below.
+    //
+    // std::string_view, C strings and std::span<const std::byte> are written
+    // from the caller's memory (a BLOB parameter is streamed from it), so a
+    // network frame or a mapped file is bound without a copy first.
     template<typename T>
     bool set(std::string_view name, const T& value) {
         if (!meta_) return false;
         const auto& mapping = stmt_->getNamedParamMapping();
-        const std::string key = normalizeName(name);
-        auto it = mapping.find(key);
+        auto it = mapping.find(normalizeName(name));
         if (it == mapping.end()) return false;
         for (size_t pos : it->second) {
             writeAt(pos, value);
@@ -87,8 +120,7 @@ public:
     bool setNull(std::string_view name) {
         if (!meta_) return false;
         const auto& mapping = stmt_->getNamedParamMapping();
-        const std::string key = normalizeName(name);
-        auto it = mapping.find(key);
+        auto it = mapping.find(normalizeName(name));
         if (it == mapping.end()) return false;
         for (size_t pos : it->second) {
             int16_t* nullPtr = nullIndicatorAt(pos);
@@ -98,6 +130,140 @@ public:
         return true;
     }
 
+    // Bind at positions known at compile time, sql<"...">.positions<"name">
+    // (fbpp/core/sql_literal.hpp): no normalization, no map lookup. The
+    // statement must be prepared from that literal; a position past its
+    // parameters throws.
+    template<typename T, std::size_t N>
+    bool set(const std::array<std::size_t, N>& positions, const T& value) {
+        if (!meta_) return false;
+        for (size_t pos : positions) {
+            checkPosition(pos);
+            writeAt(pos, value);
+        }
+        return true;
+    }
+
+    template<std::size_t N>
+    bool set(const std::array<std::size_t, N>& positions, std::nullopt_t) {
+        return setNull(positions);
+    }
+
+    template<std::size_t N>
+    bool setNull(const std::array<std::size_t, N>& positions) {
+        if (!meta_) return false;
+        for (size_t pos : positions) {
+            checkPosition(pos);
+            detail::sql_value_codec::setNull(nullIndicatorAt(pos));
+            bound_[pos] = true;
+        }
+        return true;
+    }
+
+    // Bind a list parameter expanded by NamedParamParser::expandList():
+    // values[i] goes to name__i, slots past the end repeat the last value
+    // (duplicates keep both IN and NOT IN semantics), an empty list binds
+    // NULL throughout. Returns false if the statement has no such list;
+    // throws if it was expanded for fewer values than given.
+    template<typename T, std::size_t Extent>
+    bool setList(std::string_view name, std::span<T, Extent> values) {
+        if (!meta_) return false;
+        const auto& mapping = stmt_->getNamedParamMapping();
+        normalizeName(name);
+        key_ += NamedParamParser::kListElementSeparator;
+        const size_t base = key_.size();
+        auto element = [&](size_t index) {
+            char digits[24];
+            key_.resize(base);
+            key_.append(digits, std::to_chars(digits, digits + sizeof(digits), index).ptr);
+            auto it = mapping.find(key_);
+            return it == mapping.end() ? nullptr : &it->second;
+        };
+
+        size_t slots = 0;
+        while (element(slots)) ++slots;
+        if (slots == 0) return false;
+        if (values.size() > slots) {
+            throw FirebirdException("ParamBinder: list '" + std::string(name) + "' has " +
+                                    std::to_string(values.size()) +
+                                    " values but the statement was expanded for " +
+                                    std::to_string(slots));
+        }
+        for (size_t i = 0; i < slots; ++i) {
+            for (size_t pos : *element(i)) {
+                if (values.empty()) {
+                    detail::sql_value_codec::setNull(nullIndicatorAt(pos));
+                    bound_[pos] = true;
+                } else {
+                    writeAt(pos, values[i < values.size() ? i : values.size() - 1]);
+                }
+            }
+        }
+        return true;
+    }
+
+    template<typename T>
+    bool setList(std::string_view name, const std::vector<T>& values) {
+        return setList(name, std::span<const T>(values));
+    }
+
+    // Resolve `name` once (same normalization as set()). The slot points
+    // into this statement's input metadata.
+    ParamSlot slot(std::string_view name) {
+        ParamSlot result;
+        if (!meta_) return result;
+        const auto& mapping = stmt_->getNamedParamMapping();
+        auto it = mapping.find(normalizeName(name));
+        if (it == mapping.end()) return result;
+        result.metadata_ = meta_.get();
+        result.fields_.reserve(it->second.size());
+        for (size_t pos : it->second) {
+            const auto index = static_cast<unsigned>(pos);
+            result.fields_.emplace_back(index, &meta_->getFieldRef(index));
+        }
+        return result;
+    }
+
+    // set() through a pre-resolved slot: writes straight into the buffer.
+    // Returns false for an empty slot; throws for a slot from a statement
+    // with different input metadata.
+    template<typename T>
+    bool bind(const ParamSlot& slot, const T& value) {
+        if (!checkSlot(slot)) return false;
+        for (const auto& [pos, fi] : slot.fields_) {
+            uint8_t* dataPtr = buffer_.data() + fi->offset;
+            int16_t* nullPtr = reinterpret_cast<int16_t*>(buffer_.data() + fi->nullOffset);
+            detail::packValueWithCodec(value, dataPtr, nullPtr, fi, tx_);
+            bound_[pos] = true;
+        }
+        return true;
+    }
+
+    bool bind(const ParamSlot& slot, std::nullopt_t) { return bindNull(slot); }
+
+    bool bindNull(const ParamSlot& slot) {
+        if (!checkSlot(slot)) return false;
+        for (const auto& [pos, fi] : slot.fields_) {
+            detail::sql_value_codec::setNull(
+                reinterpret_cast<int16_t*>(buffer_.data() + fi->nullOffset));
+            bound_[pos] = true;
+        }
+        return true;
+    }
+
+    // Bind every parameter positionally from a tuple or described struct —
+    // one value per '?' in order — through the input metadata's cached
+    // PackPlan. Throws on arity/descriptor mismatch like Statement::execute.
+    template<typename Row>
+        requires (is_tuple_v<Row> || is_struct_packable_v<Row>)
+    void setAll(const Row& values) {
+        if (!meta_) {
+            throw FirebirdException("ParamBinder: statement has no input parameters");
+        }
+        PackPlan<Row>::of(*meta_).pack(values, buffer_.data(), tx_);
+        std::fill(bound_.begin(), bound_.end(), true);
+    }
+
     // Late-bind transaction (needed before binding values into BLOB columns).
     void setTransaction(Transaction* tx) noexcept { tx_ = tx; }
     Transaction* transaction() const noexcept { return tx_; }
@@ -114,19 +280,37 @@ public:
 
     // Used by Transaction::execute / openCursor overloads.
     const MessageMetadata* metadata() const noexcept { return meta_.get(); }
+    const std::shared_ptr<const MessageMetadata>& sharedMetadata() const noexcept { return meta_; }
     const uint8_t* buffer() const noexcept { return buffer_.data(); }
     bool empty() const noexcept { return !meta_ || meta_->getCount() == 0; }
 
 private:
     template<typename T>
     void writeAt(size_t pos, const T& value) {
-        FieldInfo fi = meta_->getField(static_cast<unsigned>(pos));
-        uint8_t* dataPtr = buffer_.data() + meta_->getOffset(static_cast<unsigned>(pos));
+        const FieldInfo& fi = meta_->getFieldRef(static_cast<unsigned>(pos));
+        uint8_t* dataPtr = buffer_.data() + fi.offset;
         int16_t* nullPtr = nullIndicatorAt(pos);
         detail::packValueWithCodec(value, dataPtr, nullPtr, &fi, tx_);
         bound_[pos] = true;
     }
 
+    void checkPosition(size_t pos) const {
+        if (pos >= meta_->getCount()) {
+            throw FirebirdException("ParamBinder: parameter position " + std::to_string(pos) +
+                                    " is past the statement's " +
+                                    std::to_string(meta_->getCount()) + " parameters");
+        }
+    }
+
+    bool checkSlot(const ParamSlot& slot) const {
+        if (slot.empty()) return false;
+        if (slot.metadata_ != meta_.get()) {
+            throw FirebirdException(
+                "ParamBinder: slot was resolved against another statement");
+        }
+        return true;
+    }
+
     int16_t* nullIndicatorAt(size_t pos) noexcept {
         return reinterpret_cast<int16_t*>(
             buffer_.data() + meta_->getNullOffset(static_cast<unsigned>(pos)));
@@ -140,28 +324,43 @@ private:
         }
     }
 
-    static std::string normalizeName(std::string_view name) {
+    const std::string& normalizeName(std::string_view name) {
         // Trim ASCII whitespace and lowercase. Statement::namedParamMapping_
-        // stores keys already in lowercase (via NamedParamParser).
+        // stores keys already in lowercase (via NamedParamParser). Written
+        // into key_ so repeated set() calls reuse its capacity.
         size_t b = 0, e = name.size();
         while (b < e && std::isspace(static_cast<unsigned char>(name[b]))) ++b;
         while (e > b && std::isspace(static_cast<unsigned char>(name[e - 1]))) --e;
-        std::string out;
-        out.reserve(e - b);
-        for (size_t i = b; i < e; ++i) {
-            out.push_back(static_cast<char>(
-                std::tolower(static_cast<unsigned char>(name[i]))));
+        key_.assign(name.data() + b, e - b);
+        for (char& ch : key_) {
+            ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
         }
-        return out;
+        return key_;
     }
 
     std::shared_ptr<Statement> stmt_;
-    std::unique_ptr<MessageMetadata> meta_;
+    std::shared_ptr<const MessageMetadata> meta_;
     std::vector<uint8_t> buffer_;
     std::vector<bool> bound_;
+    std::string key_;   // normalizeName() scratch
     Transaction* tx_ = nullptr;
 };
 
+// ---- Statement::binder (declared in statement.hpp). ----
+
+inline ParamBinder& Statement::binder(Transaction* transaction) {
+    if (!binder_) {
+        // Non-owning handle: the binder lives inside this Statement, and
+        // owning it would keep a cache checkout from ever returning.
+        binder_ = std::make_unique<ParamBinder>(
+            std::shared_ptr<Statement>(std::shared_ptr<Statement>{}, this), transaction);
+        return *binder_;
+    }
+    binder_->clear();
+    binder_->setTransaction(transaction);
+    return *binder_;
+}
+
 // ---- Transaction overloads (declarations are in transaction.hpp). ----
 
 inline unsigned Transaction::execute(const std::shared_ptr<Statement>& statement,
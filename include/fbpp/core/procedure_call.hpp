@@ -0,0 +1,128 @@
+#pragma once
+
+// ProcedureCall — a stored procedure call prepared once and re-executed.
+//
+// Calling a procedure through SQL means rendering EXECUTE PROCEDURE text,
+// preparing it and binding per call. A ProcedureCall is built once from a
+// ProcedureInfo (Connection::describeProcedure(), or schema::MetadataCache
+// for warm starts without the probe prepare) and keeps the prepared
+// statement, its metadata and the message buffers. A call is then a pack
+// into the input buffer (PackPlan, cached per metadata), one execute and
+// an unpack of the OUT row; the affected-records info request that
+// Transaction::execute() sends afterwards is skipped.
+//
+//   ProcedureCall addLine(conn, conn.describeProcedure("ADD_ORDER_LINE"));
+//   auto [lineId] = addLine.call<std::tuple<int32_t>>(*tx, std::make_tuple(order, sku, 2));
+//
+// The statement is prepared uncached (it belongs to this object, not to
+// the connection's StatementCache). Like Statement, one ProcedureCall is
+// used by one thread at a time; it must not outlive its Connection.
+
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/pack_utils.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/transaction_impl.hpp"
+#include "fbpp/core/type_traits.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace fbpp::core {
+
+/// "EXECUTE PROCEDURE "PKG"."NAME"(?, ...)" or "SELECT * FROM ..." for
+/// selectable procedures; identifiers are quoted as stored.
+std::string renderProcedureCallSql(const ProcedureInfo& info, unsigned inputCount);
+
+class ProcedureCall {
+public:
+    /// Prepare the call described by `info` (params must be loaded). Throws
+    /// FirebirdException if the prepared statement does not match them.
+    ProcedureCall(Connection& connection, ProcedureInfo info);
+
+    /// Shorthand for ProcedureCall(connection, connection.describeProcedure(...)).
+    ProcedureCall(Connection& connection, const std::string& name,
+                  const std::string& packageName = std::string());
+
+    const ProcedureInfo& info() const noexcept { return info_; }
+    const std::string& sql() const noexcept { return sql_; }
+    const std::shared_ptr<Statement>& statement() const noexcept { return statement_; }
+    unsigned inputCount() const noexcept { return inputCount_; }
+    unsigned outputCount() const noexcept { return outputCount_; }
+
+    /// Executable procedure: bind `in`, execute and return the OUT
+    /// parameters as Out (tuple or described struct).
+    template<typename Out, typename In>
+    Out call(Transaction& transaction, const In& in) {
+        if (!outputMetadata_) {
+            throw FirebirdException("Procedure " + qualifiedName() + " has no output parameters");
+        }
+        run(transaction, in);
+        return unpack<Out>(outBuffer_.data(), outputMetadata_.get(), &transaction);
+    }
+
+    template<typename Out>
+    Out call(Transaction& transaction) {
+        return call<Out>(transaction, std::tuple<>{});
+    }
+
+    /// Executable procedure whose OUT parameters (if any) are not needed.
+    template<typename In>
+    void execute(Transaction& transaction, const In& in) {
+        run(transaction, in);
+    }
+
+    void execute(Transaction& transaction) {
+        run(transaction, std::tuple<>{});
+    }
+
+    /// Selectable procedure: cursor over its SUSPENDed rows.
+    template<typename In>
+    std::unique_ptr<ResultSet> open(Transaction& transaction, const In& in) {
+        requireKind(ProcedureKind::Selectable);
+        if (!inputMetadata_) {
+            return transaction.openCursor(statement_);
+        }
+        return transaction.openCursor(statement_, in);
+    }
+
+    std::unique_ptr<ResultSet> open(Transaction& transaction) {
+        return open(transaction, std::tuple<>{});
+    }
+
+private:
+    template<typename In>
+    void run(Transaction& transaction, const In& in) {
+        requireKind(ProcedureKind::Executable);
+        if (inputMetadata_) {
+            pack(in, inBuffer_.data(), inputMetadata_.get(), &transaction);
+        } else if constexpr (is_tuple_v<In>) {
+            if constexpr (std::tuple_size_v<In> != 0) {
+                throw FirebirdException("Procedure " + qualifiedName() + " takes no parameters");
+            }
+        }
+        executePacked(transaction);
+    }
+
+    void executePacked(Transaction& transaction);
+    // Selectable for open(); anything else (Unknown included) for call()
+    void requireKind(ProcedureKind kind) const;
+    std::string qualifiedName() const;
+
+    ProcedureInfo info_;
+    std::string sql_;
+    std::shared_ptr<Statement> statement_;
+    std::shared_ptr<const MessageMetadata> inputMetadata_;
+    std::shared_ptr<const MessageMetadata> outputMetadata_;
+    std::vector<uint8_t> inBuffer_;
+    std::vector<uint8_t> outBuffer_;
+    unsigned inputCount_ = 0;
+    unsigned outputCount_ = 0;
+};
+
+} // namespace fbpp::core
@@ -0,0 +1,129 @@
+#pragma once
+
+// Single-flight coalescing of identical concurrent read queries, opt-in.
+//
+// When many threads issue the same SELECT with the same parameters at
+// once (a cache stampede), QueryCoalescer lets the first caller run it and
+// makes the others wait for that run and share its result instead of
+// sending the query again. Calls are keyed as QueryResultCache keys them:
+// the normalized SQL text (SqlKey) plus the packed input message. Nothing
+// is kept once a run finishes: the next call after it runs the query again.
+//
+//   QueryCoalescer coalescer;                              // shared by the threads
+//   auto rows = coalescer.query(*lease, *tx, "SELECT ... WHERE id = ?",
+//                               std::make_tuple(id));      // ResultSnapshot
+//
+// The shared result is a binary ResultSnapshot, immutable and readable
+// from every thread. A failed run fails every caller that waited for it
+// with the same exception.
+//
+// A caller that joins a run gets the rows the first caller's transaction
+// read, not its own: use it for reads that do not depend on the caller's
+// snapshot or uncommitted writes. Queries with BLOB or ARRAY output
+// columns cannot be shared (ResultSnapshotWriter rejects them).
+
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/result_snapshot.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/statement_cache.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fbpp::core {
+
+/**
+ * @brief Waiting and snapshot format of a QueryCoalescer
+ */
+struct QueryCoalescerOptions {
+    // A caller waits at most this long for the run it joined, then runs the
+    // query itself; 0 waits for as long as the run takes
+    std::chrono::milliseconds maxWait{0};
+    SnapshotWriteOptions snapshot;
+};
+
+/**
+ * @brief Counters of a QueryCoalescer
+ */
+struct QueryCoalescerStats {
+    std::size_t runs = 0;           // Queries sent to the server by a leading call
+    std::size_t joined = 0;         // Calls served by another caller's run
+    std::size_t failures = 0;       // Runs that threw
+    std::size_t waitTimeouts = 0;   // Calls that gave up waiting after maxWait
+    std::size_t inFlight = 0;       // Runs going on now
+    std::size_t waiting = 0;        // Calls waiting for one now
+};
+
+/**
+ * @brief Runs each distinct (query, parameters) pair once among concurrent callers
+ *
+ * Thread-safe; each caller brings its own connection and transaction.
+ */
+class QueryCoalescer {
+public:
+    explicit QueryCoalescer(QueryCoalescerOptions options = {});
+
+    QueryCoalescer(const QueryCoalescer&) = delete;
+    QueryCoalescer& operator=(const QueryCoalescer&) = delete;
+
+    /**
+     * @brief Result of `key` with `params`, from a run going on or a new one
+     * @tparam InParams Anything Statement::openCursor() accepts
+     */
+    template<typename InParams>
+    std::shared_ptr<const ResultSnapshot> query(Connection& connection, Transaction& transaction,
+                                                const SqlKey& key, const InParams& params) {
+        auto statement = connection.prepareStatement(key);
+        return run(key, statement->packInput(&transaction, params),
+                   [&] { return transaction.openCursor(statement, params); });
+    }
+
+    template<typename InParams>
+    std::shared_ptr<const ResultSnapshot> query(Connection& connection, Transaction& transaction,
+                                                const std::string& sql, const InParams& params) {
+        return query(connection, transaction, SqlKey(sql), params);
+    }
+
+    /// Parameterless query
+    std::shared_ptr<const ResultSnapshot> query(Connection& connection, Transaction& transaction,
+                                                const std::string& sql);
+
+    QueryCoalescerStats stats() const;
+
+private:
+    using OpenCursor = std::function<std::unique_ptr<ResultSet>()>;
+
+    struct Flight {
+        std::string sql;
+        std::vector<uint8_t> input;
+        bool done = false;
+        std::shared_ptr<const ResultSnapshot> result;
+        std::exception_ptr error;
+    };
+
+    // Join the run of (key, input) or lead a new one with `open`
+    std::shared_ptr<const ResultSnapshot> run(const SqlKey& key, std::vector<uint8_t> input,
+                                              const OpenCursor& open);
+
+    // Run `open` and snapshot its rows
+    std::shared_ptr<const ResultSnapshot> capture(const OpenCursor& open) const;
+
+    QueryCoalescerOptions options_;
+    mutable std::mutex mutex_;
+    std::condition_variable finished_;   // Some flight is done
+    std::unordered_multimap<std::uint64_t, std::shared_ptr<Flight>> flights_;
+    QueryCoalescerStats stats_;
+};
+
+} // namespace fbpp::core
@@ -1,10 +1,18 @@
 #pragma once
 
+#include "fbpp/core/batch.hpp"
+#include "fbpp/core/batch_impl.hpp"
+#include "fbpp/core/column_batch.hpp"
 #include "fbpp/core/connection.hpp"
+#include "fbpp/core/output_coercion.hpp"
 #include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement.hpp"
 #include "fbpp/core/struct_pack.hpp"
 #include "fbpp/core/transaction.hpp"
+#include <cstddef>
+#include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <type_traits>
 #include <utility>
@@ -29,22 +37,70 @@ struct StructDescriptor<NoResult> {
     static constexpr auto fields = std::make_tuple();
 };
 
+namespace detail {
+
+// Descriptor::outputCoercion, when the descriptor has one, parsed once
+template<typename Descriptor, typename = void>
+struct DescriptorCoercion {
+    static const OutputCoercion* get() { return nullptr; }
+};
+
 template<typename Descriptor>
-std::vector<typename Descriptor::Output> executeQuery(Connection& connection,
-                                                      Transaction& transaction,
-                                                      const typename Descriptor::Input& params) {
-    auto statement = connection.prepareStatement(std::string(Descriptor::sql));
+struct DescriptorCoercion<Descriptor, std::void_t<decltype(Descriptor::outputCoercion)>> {
+    static const OutputCoercion* get() {
+        static const OutputCoercion coercion = OutputCoercion::parse(Descriptor::outputCoercion);
+        return coercion.empty() ? nullptr : &coercion;
+    }
+};
+
+// The descriptor's statement: its key is hashed once per process, and the
+// connection hands the statement out again from the descriptor's slot
+template<typename Descriptor>
+std::shared_ptr<Statement> prepareDescriptor(Connection& connection) {
+    static const SqlKey key{std::string(Descriptor::sql)};
+    return connection.prepareStatement(key, statementSlot<Descriptor>());
+}
+
+// With a limit the descriptor's SELECT runs as its "... ROWS n" shape
+// where it takes one (Statement::limitedTo), and the cursor stops there
+template<typename Descriptor>
+std::unique_ptr<ResultSet> openDescriptorCursor(Connection& connection,
+                                                Transaction& transaction,
+                                                const typename Descriptor::Input& params,
+                                                RowLimit limit = {}) {
+    auto statement = prepareDescriptor<Descriptor>(connection);
     bool hasParams = false;
     if (auto meta = statement->getInputMetadata()) {
         hasParams = meta->getCount() > 0;
     }
+    if (auto limited = statement->limitedTo(limit.rows)) {
+        statement = std::move(limited);
+    }
 
+    const OutputCoercion* coercion = DescriptorCoercion<Descriptor>::get();
     std::unique_ptr<ResultSet> cursor;
-    if (hasParams) {
-        cursor = transaction.openCursor(statement, params);
+    if (coercion) {
+        cursor = hasParams ? transaction.openCursor(statement, params, *coercion)
+                           : transaction.openCursor(statement, *coercion);
     } else {
-        cursor = transaction.openCursor(statement);
+        cursor = hasParams ? transaction.openCursor(statement, params)
+                           : transaction.openCursor(statement);
     }
+    cursor->setRowLimit(limit.rows);
+    return cursor;
+}
+
+} // namespace detail
+
+/// All rows of a Select descriptor; with a limit, at most `limit.rows`
+/// of them, the rest never produced by the server where the SELECT takes
+/// a ROWS clause.
+template<typename Descriptor>
+std::vector<typename Descriptor::Output> executeQuery(Connection& connection,
+                                                      Transaction& transaction,
+                                                      const typename Descriptor::Input& params,
+                                                      RowLimit limit = {}) {
+    auto cursor = detail::openDescriptorCursor<Descriptor>(connection, transaction, params, limit);
 
     std::vector<typename Descriptor::Output> rows;
     typename Descriptor::Output row{};
@@ -54,30 +110,45 @@ std::vector<typename Descriptor::Output> executeQuery(Connection& connection,
     return rows;
 }
 
+/// First row of a Select descriptor. Runs the "... ROWS 1" shape of the
+/// SELECT where it takes one, and closes the cursor as soon as the row is
+/// read, so existence checks and top-1 lookups on large queries leave no
+/// server work behind.
 template<typename Descriptor>
 std::optional<typename Descriptor::Output> fetchOne(Connection& connection,
                                                     Transaction& transaction,
                                                     const typename Descriptor::Input& params) {
-    auto statement = connection.prepareStatement(std::string(Descriptor::sql));
-    bool hasParams = false;
-    if (auto meta = statement->getInputMetadata()) {
-        hasParams = meta->getCount() > 0;
-    }
-
-    std::unique_ptr<ResultSet> cursor;
-    if (hasParams) {
-        cursor = transaction.openCursor(statement, params);
-    } else {
-        cursor = transaction.openCursor(statement);
-    }
+    auto cursor = detail::openDescriptorCursor<Descriptor>(connection, transaction, params,
+                                                           RowLimit{1});
 
     typename Descriptor::Output row{};
-    if (cursor->fetch(row)) {
+    const bool found = cursor->fetch(row);
+    cursor->close();
+    if (found) {
         return row;
     }
     return std::nullopt;
 }
 
+/// executeQuery() on Connection::readTransaction(): an autocommit read
+/// without a transaction start and commit of its own.
+template<typename Descriptor>
+std::vector<typename Descriptor::Output> executeQuery(Connection& connection,
+                                                      const typename Descriptor::Input& params,
+                                                      RowLimit limit = {}) {
+    auto transaction = connection.readTransaction();
+    return executeQuery<Descriptor>(connection, *transaction, params, limit);
+}
+
+/// fetchOne() on Connection::readTransaction(): a point lookup costs its
+/// open and fetch round trips only.
+template<typename Descriptor>
+std::optional<typename Descriptor::Output> fetchOne(Connection& connection,
+                                                    const typename Descriptor::Input& params) {
+    auto transaction = connection.readTransaction();
+    return fetchOne<Descriptor>(connection, *transaction, params);
+}
+
 /// Execute a singleton statement that BOTH takes parameters and returns one
 /// row of output — `INSERT/UPDATE/DELETE ... RETURNING` of a single row, or
 /// `EXECUTE PROCEDURE` with OUT parameters. Returns {affectedRows, output}.
@@ -90,7 +161,7 @@ std::pair<unsigned, typename Descriptor::Output> executeReturning(
         Connection& connection,
         Transaction& transaction,
         const typename Descriptor::Input& params) {
-    auto statement = connection.prepareStatement(std::string(Descriptor::sql));
+    auto statement = detail::prepareDescriptor<Descriptor>(connection);
     return transaction.execute(statement, params, typename Descriptor::Output{});
 }
 
@@ -104,11 +175,100 @@ typename Descriptor::Output executeReturningOne(
     return executeReturning<Descriptor>(connection, transaction, params).second;
 }
 
+/// Default prefetch window of streamQuery()
+inline constexpr unsigned kDefaultStreamPrefetch = 128;
+
+/**
+ * @brief Single-pass range over the rows of an open cursor
+ *
+ * Returned by streamQuery(). Owns the cursor (which keeps its statement
+ * alive); rows are fetched as the range is walked, through the cursor's
+ * prefetch window, so a large result is never materialised. begin() may be
+ * called once. Move-only.
+ */
+template<typename Row>
+class QueryStream {
+public:
+    explicit QueryStream(std::unique_ptr<ResultSet> cursor)
+        : cursor_(std::move(cursor)) {}
+
+    ResultSet::Iterator<Row> begin() { return ResultSet::Iterator<Row>(cursor_.get()); }
+    ResultSet::Iterator<Row> end() { return ResultSet::Iterator<Row>(cursor_.get(), true); }
+
+    /// The underlying cursor, e.g. to close() it before the end
+    ResultSet& cursor() { return *cursor_; }
+
+private:
+    std::unique_ptr<ResultSet> cursor_;
+};
+
+/// Open a Select descriptor as a QueryStream; `prefetch` rows are pulled
+/// per server round trip (see ResultSet::setPrefetch()). A loop that only
+/// wants the first rows passes a `limit`: the server stops producing at it
+/// and no refill reads past it.
+template<typename Descriptor>
+QueryStream<typename Descriptor::Output> streamQuery(Connection& connection,
+                                                     Transaction& transaction,
+                                                     const typename Descriptor::Input& params,
+                                                     unsigned prefetch = kDefaultStreamPrefetch,
+                                                     RowLimit limit = {}) {
+    auto cursor = detail::openDescriptorCursor<Descriptor>(connection, transaction, params,
+                                                           limit);
+    cursor->setPrefetch(prefetch);
+    return QueryStream<typename Descriptor::Output>(std::move(cursor));
+}
+
+/// Default rows per ResultSet::fetchColumns() call of fetchColumnar()
+inline constexpr std::size_t kDefaultColumnarBatch = 4096;
+
+/**
+ * @brief All rows of a Select descriptor as its generated columnar result
+ *
+ * `Descriptor::Columns` (emitted by query_generator next to the Output
+ * struct) holds one ColumnArray per output column. Rows are fetched
+ * `batchRows` at a time with ResultSet::fetchColumns() and appended column
+ * by column, so code that scans one column reads only that column's memory.
+ */
+template<typename Descriptor>
+typename Descriptor::Columns fetchColumnar(Connection& connection,
+                                           Transaction& transaction,
+                                           const typename Descriptor::Input& params,
+                                           std::size_t batchRows = kDefaultColumnarBatch) {
+    auto cursor = detail::openDescriptorCursor<Descriptor>(connection, transaction, params);
+    typename Descriptor::Columns columns;
+    ColumnBatch batch;
+    while (cursor->fetchColumns(batch, batchRows > 0 ? batchRows : 1)) {
+        columns.append(batch);
+    }
+    return columns;
+}
+
+/**
+ * @brief Run a Modify descriptor once per row in one IBatch round trip
+ *
+ * The rows are packed through the descriptor's PackPlan straight into the
+ * batch stream (Batch::addMany). Per-row outcomes are in the BatchResult;
+ * with options.continueOnError the good rows are applied anyway.
+ */
+template<typename Descriptor>
+BatchResult executeBatch(Connection& connection,
+                         Transaction& transaction,
+                         std::span<const typename Descriptor::Input> rows,
+                         const BatchOptions& options = {}) {
+    if (rows.empty()) {
+        return BatchResult{};
+    }
+    auto statement = detail::prepareDescriptor<Descriptor>(connection);
+    auto batch = statement->createBatch(&transaction, options);
+    batch->addMany(rows);
+    return batch->execute(&transaction);
+}
+
 template<typename Descriptor>
 unsigned executeNonQuery(Connection& connection,
                          Transaction& transaction,
                          const typename Descriptor::Input& params) {
-    auto statement = connection.prepareStatement(std::string(Descriptor::sql));
+    auto statement = detail::prepareDescriptor<Descriptor>(connection);
     bool hasParams = false;
     if (auto meta = statement->getInputMetadata()) {
         hasParams = meta->getCount() > 0;
@@ -0,0 +1,147 @@
+#pragma once
+
+// Column and parameter indexes of a generated query.
+//
+// query_generator emits, next to each query's In / Out structs, an
+// `enum class Col : unsigned` of its output columns and an
+// `enum class Param : unsigned` of its parameters (a named parameter used
+// twice is one enumerator), reachable through the query's descriptor:
+//
+//   using Accounts = generated::queries::QueryDescriptor<QueryId::Accounts>;
+//   auto& binder = stmt->binder(tx.get());
+//   fbpp::core::set<Accounts::Param::OWNER>(binder, owner);
+//   for (const auto& view : cursor->rows()) {
+//       std::optional<int64_t> amount = fbpp::core::get<Accounts::Col::AMOUNT>(view);
+//   }
+//
+// The generator specializes QueryFields<Enum> with the names, types and
+// scales it described, and QueryField<Id> with each enumerator's C++ type
+// and index (positions for a parameter). The first access through a
+// MessageMetadata checks those against the live statement and throws if
+// the statement changed; the check is kept as a plan of that metadata, so
+// every later access is a fixed index without the name lookup of
+// get<T>("AMOUNT") / set("owner", v).
+
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/message_metadata.hpp"
+#include "fbpp/core/param_binder.hpp"
+#include "fbpp/core/row.hpp"
+
+#include <array>
+#include <cctype>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <typeindex>
+
+namespace fbpp {
+namespace core {
+
+/// One column or parameter as described when the query was generated
+struct QueryFieldInfo {
+    std::string_view name;   ///< Column name; a parameter's SQL name
+    unsigned sqlType;        ///< Without the nullable bit
+    int scale;
+};
+
+/// Generated per Col / Param enum: `static constexpr std::array<QueryFieldInfo, N> fields`
+/// (a Param enum's fields are the statement's parameter positions in order)
+template<typename Enum>
+struct QueryFields;
+
+/// Generated per enumerator: `using type` (a parameter's may be std::optional)
+/// and `static constexpr unsigned index` for a column or
+/// `static constexpr std::array<std::size_t, N> positions` for a parameter
+template<auto Id>
+struct QueryField;
+
+namespace detail {
+
+inline bool sameQueryFieldName(std::string_view described, const std::string& live) {
+    if (described.size() != live.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < live.size(); ++i) {
+        if (std::toupper(static_cast<unsigned char>(described[i])) !=
+            std::toupper(static_cast<unsigned char>(live[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Enum's generated fields checked against one MessageMetadata
+ *
+ * Exists (as a plan of the metadata) only once the check passed: same
+ * count, and per field the same name (columns; name or alias, any case),
+ * SQL type and scale.
+ */
+template<typename Enum>
+class QueryFieldsCheck {
+public:
+    static void verify(const MessageMetadata& metadata, bool columns) {
+        const std::type_index key(typeid(QueryFieldsCheck));
+        if (metadata.findPlan(key)) {
+            return;
+        }
+        constexpr const auto& fields = QueryFields<Enum>::fields;
+        const char* what = columns ? "column" : "parameter";
+        if (metadata.getCount() != fields.size()) {
+            throw FirebirdException(std::string("Generated query has ") +
+                                    std::to_string(fields.size()) + " " + what +
+                                    "s, the statement " + std::to_string(metadata.getCount()));
+        }
+        for (unsigned i = 0; i < fields.size(); ++i) {
+            const FieldInfo& live = metadata.getFieldRef(i);
+            const bool named = !columns || sameQueryFieldName(fields[i].name, live.alias) ||
+                               sameQueryFieldName(fields[i].name, live.name);
+            if (!named || (live.type & ~1u) != fields[i].sqlType ||
+                live.scale != fields[i].scale) {
+                throw FirebirdException(std::string("Generated ") + what + " " +
+                                        std::string(fields[i].name) + " (" +
+                                        std::to_string(i) + ") does not match the statement's " +
+                                        displayName(live) + " (sql_type=" +
+                                        std::to_string(live.type) + ", scale=" +
+                                        std::to_string(live.scale) + ")");
+            }
+        }
+        metadata.storePlan(key, std::make_shared<const QueryFieldsCheck>());
+    }
+};
+
+} // namespace detail
+
+/// Value of generated column `Id` in a RowView or Row; nullopt for NULL
+template<auto Id, typename View>
+auto get(const View& view) -> std::optional<typename QueryField<Id>::type> {
+    static_assert(std::is_enum_v<decltype(Id)>, "get<Id>: Id must be a generated Col");
+    detail::QueryFieldsCheck<decltype(Id)>::verify(view.metadata(), true);
+    return view.template get<typename QueryField<Id>::type>(QueryField<Id>::index);
+}
+
+/// Bind generated parameter `Id` at every position it expands to
+template<auto Id>
+bool set(ParamBinder& binder, const typename QueryField<Id>::type& value) {
+    static_assert(std::is_enum_v<decltype(Id)>, "set<Id>: Id must be a generated Param");
+    if (const MessageMetadata* metadata = binder.metadata()) {
+        detail::QueryFieldsCheck<decltype(Id)>::verify(*metadata, false);
+    }
+    return binder.set(QueryField<Id>::positions, value);
+}
+
+/// Bind NULL to generated parameter `Id`
+template<auto Id>
+bool setNull(ParamBinder& binder) {
+    static_assert(std::is_enum_v<decltype(Id)>, "setNull<Id>: Id must be a generated Param");
+    if (const MessageMetadata* metadata = binder.metadata()) {
+        detail::QueryFieldsCheck<decltype(Id)>::verify(*metadata, false);
+    }
+    return binder.setNull(QueryField<Id>::positions);
+}
+
+} // namespace core
+} // namespace fbpp
@@ -0,0 +1,164 @@
+#pragma once
+
+// Client-side cache of query results, opt-in, above Statement.
+//
+// QueryResultCache keys a result by the normalized SQL text (SqlKey: case,
+// whitespace and comments do not matter) plus the packed input message, so
+// two calls hit the same entry exactly when Firebird would receive the same
+// statement and the same parameter bytes. Results are kept as binary
+// ResultSnapshots and served as RowView without decoding or a server round
+// trip; the statement behind a key is taken from the connection's statement
+// cache (enabled by default) to pack the parameters.
+//
+// An entry lives until its TTL expires, it is evicted (LRU by snapshot
+// bytes), or a table it depends on is invalidated. Its tables are the
+// relations of its output columns plus any listed in QueryCacheHints; call
+// invalidateTable() after writes, or let invalidateOnEvents() do it when a
+// trigger posts a change event, which reaches every process listening.
+//
+// Cached results are not tied to a transaction: a hit returns what an
+// earlier transaction read. Use it for reference data that changes rarely.
+
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/event_subscription.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/result_snapshot.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/statement_cache.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace fbpp::core {
+
+/**
+ * @brief Capacity and lifetime of a QueryResultCache
+ */
+struct QueryResultCacheOptions {
+    std::chrono::milliseconds ttl{std::chrono::minutes(5)};   // 0 = no expiry
+    std::size_t maxBytes = 64 * 1024 * 1024;     // Snapshot bytes kept in total
+    std::size_t maxEntryBytes = 4 * 1024 * 1024; // Larger results are returned, not kept
+    SnapshotWriteOptions snapshot;               // Block size / compression of entries
+};
+
+/**
+ * @brief Per-call overrides of a cached query
+ */
+struct QueryCacheHints {
+    std::optional<std::chrono::milliseconds> ttl;   // Instead of the cache default
+    std::vector<std::string> tables;    // Dependencies besides the output relations
+};
+
+/**
+ * @brief Counters of a QueryResultCache
+ */
+struct QueryResultCacheStats {
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    std::size_t evictions = 0;       // Dropped for space
+    std::size_t expirations = 0;     // Dropped on TTL
+    std::size_t invalidations = 0;   // Dropped by invalidateTable() / clear()
+    std::size_t entries = 0;
+    std::size_t bytes = 0;
+};
+
+/**
+ * @brief LRU cache of query results as ResultSnapshots
+ *
+ * Thread-safe. Misses run the query outside the lock; concurrent misses
+ * on one key both run it and the later result replaces the earlier one
+ * (QueryCoalescer, query_coalescer.hpp, runs them once without caching).
+ * Queries with BLOB or ARRAY output columns cannot be cached
+ * (ResultSnapshotWriter rejects them).
+ */
+class QueryResultCache {
+public:
+    explicit QueryResultCache(QueryResultCacheOptions options = {});
+
+    QueryResultCache(const QueryResultCache&) = delete;
+    QueryResultCache& operator=(const QueryResultCache&) = delete;
+
+    /**
+     * @brief Cached result of `key` with `params`, or run it in `transaction`
+     * @tparam InParams Anything Statement::openCursor() accepts
+     */
+    template<typename InParams>
+    std::shared_ptr<const ResultSnapshot> query(Connection& connection, Transaction& transaction,
+                                                const SqlKey& key, const InParams& params,
+                                                const QueryCacheHints& hints = {}) {
+        auto statement = connection.prepareStatement(key);
+        return lookup(key, statement->packInput(&transaction, params), hints,
+                      [&] { return transaction.openCursor(statement, params); });
+    }
+
+    template<typename InParams>
+    std::shared_ptr<const ResultSnapshot> query(Connection& connection, Transaction& transaction,
+                                                const std::string& sql, const InParams& params,
+                                                const QueryCacheHints& hints = {}) {
+        return query(connection, transaction, SqlKey(sql), params, hints);
+    }
+
+    /// Parameterless query
+    std::shared_ptr<const ResultSnapshot> query(Connection& connection, Transaction& transaction,
+                                                const std::string& sql,
+                                                const QueryCacheHints& hints = {});
+
+    /// Drop every entry depending on `table` (case-insensitive)
+    /// @return Number of entries dropped
+    std::size_t invalidateTable(std::string_view table);
+
+    /// Invalidate each of `tables` when the event `prefix` + TABLE (upper
+    /// case) is posted, e.g. by `POST_EVENT 'CHG$ORDERS'` in an AFTER trigger.
+    /// One subscription on `connection` for all tables; the cache must
+    /// outlive the returned handle.
+    std::unique_ptr<EventSubscription> invalidateOnEvents(Connection& connection,
+                                                          const std::vector<std::string>& tables,
+                                                          std::string_view prefix = {});
+
+    /// Drop every entry
+    void clear();
+
+    QueryResultCacheStats stats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        std::uint64_t hash = 0;
+        std::string sql;
+        std::vector<uint8_t> input;
+        std::shared_ptr<const ResultSnapshot> snapshot;
+        std::size_t bytes = 0;
+        std::optional<Clock::time_point> expires;
+        std::vector<std::string> tables;   // UPPERCASE
+    };
+    using EntryList = std::list<Entry>;
+    using OpenCursor = std::function<std::unique_ptr<ResultSet>()>;
+
+    // Hit, or run `open` and keep the result under (key, input)
+    std::shared_ptr<const ResultSnapshot> lookup(const SqlKey& key, std::vector<uint8_t> input,
+                                                 const QueryCacheHints& hints, const OpenCursor& open);
+
+    EntryList::iterator find(std::uint64_t hash, std::string_view sql, const std::vector<uint8_t>& input);
+    void erase(EntryList::iterator it);
+    void store(Entry entry);
+
+    QueryResultCacheOptions options_;
+    mutable std::mutex mutex_;
+    EntryList entries_;   // Most recently used first
+    std::unordered_multimap<std::uint64_t, EntryList::iterator> index_;
+    QueryResultCacheStats stats_;
+};
+
+} // namespace fbpp::core
@@ -0,0 +1,159 @@
+#pragma once
+
+// Bump-pointer block allocator for materialized result data.
+//
+// A ResultArena hands out memory from a list of large blocks: each
+// allocation advances a pointer inside the current block, a new block is
+// taken when it is full, and nothing is freed individually. Rows, strings
+// and BLOB bytes materialized from one result set therefore sit in a few
+// contiguous blocks, and dropping the arena frees them all at once.
+//
+//   auto arena = std::make_shared<ResultArena>();
+//   cursor->setArena(arena);
+//   std::vector<Row> rows;
+//   cursor->fetchRows(rows);          // message bytes live in `arena`
+//   ...
+//   rows.clear(); arena.reset();      // one release per block
+//
+// Rows keep a shared_ptr to their arena, so it lives as long as any row
+// taken from it. An arena is not thread-safe; fill it from one thread.
+// An arena set on a cursor charges its blocks to that cursor's connection
+// (Connection::memoryUsage()).
+//
+// spillTo() bounds the arena's memory: once its heap blocks reach the
+// budget, later blocks are mapped from an unlinked temporary file and
+// handed back to the kernel as soon as they are filled. Their bytes stay
+// at the same addresses, so pointers into them remain valid; reading
+// them pages the data back in from the page cache or the file.
+
+#include "fbpp/core/memory_usage.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fbpp {
+namespace core {
+
+class ResultSet;
+
+class ResultArena {
+public:
+    /// First block size; later blocks double up to kMaxBlockSize
+    static constexpr std::size_t kDefaultBlockSize = 64 * 1024;
+    static constexpr std::size_t kMaxBlockSize = 4 * 1024 * 1024;
+
+    explicit ResultArena(std::size_t blockSize = kDefaultBlockSize);
+    ~ResultArena();
+
+    ResultArena(const ResultArena&) = delete;
+    ResultArena& operator=(const ResultArena&) = delete;
+    ResultArena(ResultArena&&) noexcept;
+    ResultArena& operator=(ResultArena&&) noexcept;
+
+    /**
+     * @brief Keep at most `memoryBudget` bytes of blocks on the heap
+     *
+     * Blocks taken after that come from a temporary file in `directory`
+     * (the system temp directory if empty), created on first use and
+     * removed when the arena goes. POSIX only: elsewhere the budget is
+     * ignored and every block stays on the heap.
+     */
+    void spillTo(std::size_t memoryBudget, std::string directory = {});
+
+    /**
+     * @brief Uninitialized memory for `bytes` bytes
+     *
+     * `alignment` must be a power of two. A request larger than the block
+     * size gets a block of its own. Valid until clear() or destruction.
+     */
+    void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) {
+        const auto at = alignUp(cursor_, alignment);
+        if (at > reinterpret_cast<std::uintptr_t>(end_) ||
+            bytes > reinterpret_cast<std::uintptr_t>(end_) - at) {
+            return allocateSlow(bytes, alignment);
+        }
+        cursor_ = reinterpret_cast<std::uint8_t*>(at) + bytes;
+        bytesUsed_ += bytes;
+        return reinterpret_cast<void*>(at);
+    }
+
+    /// Copy of `bytes` bytes of `data`
+    std::uint8_t* copy(const void* data, std::size_t bytes,
+                       std::size_t alignment = alignof(std::max_align_t)) {
+        auto* out = static_cast<std::uint8_t*>(allocate(bytes, alignment));
+        if (bytes != 0) {
+            std::memcpy(out, data, bytes);
+        }
+        return out;
+    }
+
+    /// Copy of `text`; the view stays valid until clear()
+    std::string_view copyString(std::string_view text) {
+        const auto* out = copy(text.data(), text.size(), 1);
+        return {reinterpret_cast<const char*>(out), text.size()};
+    }
+
+    /**
+     * @brief Forget every allocation
+     *
+     * Keeps the largest block for reuse and frees the others; everything
+     * handed out before is invalid afterwards.
+     */
+    void clear() noexcept;
+
+    /// Bytes handed out (alignment padding excluded)
+    std::size_t bytesUsed() const noexcept { return bytesUsed_; }
+
+    /// Bytes held in blocks, spilled ones included
+    std::size_t bytesReserved() const noexcept { return bytesReserved_; }
+
+    /// Bytes of blocks mapped from the spill file
+    std::size_t bytesSpilled() const noexcept { return bytesSpilled_; }
+
+    std::size_t blockCount() const noexcept { return blocks_.size(); }
+
+private:
+    friend class ResultSet;   // trackIn()
+
+    // Charge the blocks to a connection, unless one is charged already
+    void trackIn(const std::shared_ptr<detail::MemoryAccount>& account) noexcept {
+        if (!memory_.attached()) {
+            memory_.attach(account, detail::MemoryAccount::arenas, bytesReserved_);
+        }
+    }
+
+    struct Block {
+        std::unique_ptr<std::uint8_t[]> data;
+        std::size_t size = 0;
+    };
+
+    static std::uintptr_t alignUp(const std::uint8_t* p, std::size_t alignment) noexcept {
+        const auto value = reinterpret_cast<std::uintptr_t>(p);
+        return (value + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+    }
+
+    void* allocateSlow(std::size_t bytes, std::size_t alignment);
+
+    class SpillFile;
+
+    std::vector<Block> blocks_;
+    std::uint8_t* cursor_ = nullptr;    // Next free byte of the block being filled
+    std::uint8_t* end_ = nullptr;       // Its end
+    std::size_t nextBlockSize_;
+    std::size_t bytesUsed_ = 0;
+    std::size_t bytesReserved_ = 0;
+    std::size_t bytesSpilled_ = 0;
+    std::size_t memoryBudget_ = 0;      // 0 = no spilling
+    std::string spillDirectory_;
+    std::unique_ptr<SpillFile> spill_;  // Created with the first spilled block
+    detail::MemoryCharge memory_;
+};
+
+} // namespace core
+} // namespace fbpp
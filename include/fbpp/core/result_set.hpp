@@ -1,14 +1,22 @@
 #pragma once
 
+#include "fbpp/core/column_batch.hpp"
 #include "fbpp/core/environment.hpp"
+#include "fbpp/core/expected.hpp"
 #include "fbpp/core/message_metadata.hpp"
 #include "fbpp/core/pack_utils.hpp"
+#include "fbpp/core/result_arena.hpp"
 #include "fbpp/core/firebird_compat.hpp"
 #include "fbpp/core/row.hpp"
+#include "fbpp/core/row_sink.hpp"
+#include "fbpp/core/slow_query_log.hpp"
+#include "fbpp/core/statement_metrics.hpp"
+#include <chrono>
 #include <cstdint>
 #include <iterator>
 #include <memory>
 #include <optional>
+#include <type_traits>
 #include <vector>
 #include <nlohmann/json_fwd.hpp>
 
@@ -18,6 +26,38 @@ namespace core {
 // Forward declarations
 class Statement;
 class Transaction;
+class JsonStreamWriter;
+class JsonNestWriter;
+class CsvStreamWriter;
+class ResultSnapshotWriter;
+struct ServerCounters;
+class SpanObserver;
+
+namespace detail {
+class FetchBufferStash;
+}
+
+/**
+ * @brief Tuning of ResultSet::decodeParallel()
+ */
+struct ParallelDecodeOptions {
+    unsigned workers = 0;              // Decode tasks at once; 0 = Executor::shared() threads
+    std::size_t blockRows = 256;       // Rows per block handed to a decode task
+    std::size_t maxBlocksInFlight = 0; // Fetched but undelivered blocks; 0 = 2 * workers
+    bool ordered = true;               // Deliver blocks in fetch order (false: as decoded)
+};
+
+/**
+ * @brief Most rows a cursor is to serve (0 = no limit)
+ *
+ * Given to Statement / Transaction::openCursor and the query_executor
+ * helpers: a SELECT that can take it runs as "... ROWS n" (a statement
+ * key of its own, see Statement::limitedTo), and the cursor stops at n
+ * rows either way (ResultSet::setRowLimit).
+ */
+struct RowLimit {
+    std::uint64_t rows = 0;
+};
 
 /**
  * @brief Wrapper for Firebird IResultSet interface
@@ -45,14 +85,14 @@ public:
     // Constructors
     //ResultSet() = default;
     ResultSet(Firebird::IResultSet* resultSet,
-              std::unique_ptr<MessageMetadata> metadata);
+              std::shared_ptr<const MessageMetadata> metadata);
 
     // Constructor with owning Transaction reference. The cursor keeps the
     // transaction alive: a server-side cursor is only usable while its
     // transaction exists, so the shortest-lived object in the chain holds
     // the ownership.
     ResultSet(Firebird::IResultSet* resultSet,
-              std::unique_ptr<MessageMetadata> metadata,
+              std::shared_ptr<const MessageMetadata> metadata,
               std::shared_ptr<Transaction> transaction);
     
     // Move semantics
@@ -78,23 +118,30 @@ public:
             return false;
         }
         
-        // Ensure buffer is allocated
-        if (buffer_.empty()) {
-            buffer_.resize(getBufferSize());
-        }
-        
-        // Fetch next row
-        int result = fetchNext(buffer_.data());
-        if (result != RESULT_OK) {
+        // Fetch next row (directly or from the prefetch window)
+        const uint8_t* row = nextRow();
+        if (!row) {
             eof_ = true;
             return false;
         }
         
         // Use universal unpack
-        record = unpack<T>(buffer_.data(), metadata_.get(), transaction_.get());
+        detail::SlowQueryTimer timer(unpackClock());
+        detail::PhaseTimer phase(metrics_.get(), Phase::Unpack);
+        record = unpack<T>(row, metadata_.get(), transaction_.get());
         return true;
     }
     
+    /// fetch() that returns a FirebirdException instead of throwing it
+    template<typename T>
+    Expected<bool> tryFetch(T& record) {
+        try {
+            return fetch(record);
+        } catch (const FirebirdException& e) {
+            return e;
+        }
+    }
+
     /**
      * @brief Fetch all remaining rows as specified type
      * @tparam T Type to unpack rows into (tuple, json, etc)
@@ -103,24 +150,327 @@ public:
     template<typename T>
     void fetchAll(std::vector<T>& results) {
         results.clear();
+        // Message-layout rows: fetched straight into the vector's elements
+        if constexpr (detail::message_layout_v<T>) {
+            if (metadata_ && detail::MessageRowFormat<T>::describes(*metadata_)) {
+                while (true) {
+                    T& record = results.emplace_back();
+                    if (!fetchMessage(&record)) {
+                        results.pop_back();
+                        return;
+                    }
+                }
+            }
+        }
         T record;
         while (fetch(record)) {
             results.push_back(std::move(record));
         }
     }
 
+    /**
+     * @brief Fetch all remaining rows into `results`, reusing its elements
+     *
+     * Existing elements are overwritten in place (unpackInto()): strings,
+     * also inside optionals, keep their capacity, so refreshing the same
+     * query into the same vector allocates only for rows or values larger
+     * than before. The vector grows when there are more rows and drops the
+     * elements past the last row.
+     *
+     * @return Number of rows fetched (results.size() afterwards)
+     */
+    template<typename T>
+    std::size_t fetchInto(std::vector<T>& results) {
+        std::size_t count = 0;
+        if constexpr (detail::message_layout_v<T>) {
+            if (metadata_ && detail::MessageRowFormat<T>::describes(*metadata_)) {
+                while (true) {
+                    if (count == results.size()) {
+                        results.emplace_back();
+                    }
+                    if (!fetchMessage(&results[count])) {
+                        break;
+                    }
+                    ++count;
+                }
+                results.erase(results.begin() + static_cast<std::ptrdiff_t>(count), results.end());
+                return count;
+            }
+        }
+        while (isValid() && !eof_) {
+            const uint8_t* row = nextRow();
+            if (!row) {
+                eof_ = true;
+                break;
+            }
+            if (count == results.size()) {
+                results.emplace_back();
+            }
+            detail::SlowQueryTimer timer(unpackClock());
+            detail::PhaseTimer phase(metrics_.get(), Phase::Unpack);
+            unpackInto(row, metadata_.get(), results[count], transaction_.get());
+            ++count;
+        }
+        results.erase(results.begin() + static_cast<std::ptrdiff_t>(count), results.end());
+        return count;
+    }
+
     /// Fetch one row as an owning Row, or nullopt at end of result set.
     /// Throws if the cursor has already been closed. Useful when the
     /// caller wants to keep the row past cursor lifetime (typical
     /// EXECUTE PROCEDURE OUT-param consumer).
     std::optional<Row> fetchOne();
 
+    /**
+     * @brief Append the remaining rows to `rows` as owning Rows
+     *
+     * With an arena set (setArena) every row's bytes are copied into it,
+     * so a million rows are a few large blocks rather than a million
+     * buffers, and dropping the rows and the arena frees them at once.
+     *
+     * @param maxRows Stop after this many rows (0 = all)
+     * @return Number of rows appended
+     */
+    std::size_t fetchRows(std::vector<Row>& rows, std::size_t maxRows = 0);
+
+    /**
+     * @brief Scrollable cursor positioning
+     *
+     * Need a cursor opened with Statement::CURSOR_TYPE_SCROLLABLE; on a
+     * forward-only cursor the server rejects them. Positions are 1-based;
+     * a negative absolute position counts from the end (-1 = last row).
+     * Relative moves and fetchPrior() count from the row last returned,
+     * also when the prefetch window has read ahead of it: the window is
+     * discarded and the offset corrected for the rows it held. A following
+     * fetch() continues forward from the new position.
+     *
+     * @return false when the move leaves the result set (the cursor then
+     *         sits before the first or after the last row)
+     */
+    template<typename T>
+    bool fetchFirst(T& record) { return scrollInto(ScrollMove::first, 0, record); }
+
+    template<typename T>
+    bool fetchLast(T& record) { return scrollInto(ScrollMove::last, 0, record); }
+
+    template<typename T>
+    bool fetchPrior(T& record) { return scrollInto(ScrollMove::prior, 0, record); }
+
+    template<typename T>
+    bool fetchAbsolute(int position, T& record) {
+        return scrollInto(ScrollMove::absolute, position, record);
+    }
+
+    template<typename T>
+    bool fetchRelative(int offset, T& record) {
+        return scrollInto(ScrollMove::relative, offset, record);
+    }
+
+    /**
+     * @brief Fetch up to `rows` rows starting at absolute `position`
+     *
+     * One server-side positioning call followed by forward fetches,
+     * decoded into `batch` the way fetchColumns() does, so a paged UI can
+     * jump between pages reusing the same block and the same ColumnBatch
+     * buffers. Needs a scrollable cursor (see fetchAbsolute()).
+     *
+     * @param position 1-based first row of the page (negative: from the end)
+     * @param rows Page size (must be > 0)
+     * @return true if the page has at least one row; batch.rowCount is
+     *         less than `rows` on the last page
+     */
+    bool fetchPage(int position, std::size_t rows, ColumnBatch& batch);
+
+    /**
+     * @brief Materialize fetchOne() / fetchRows() rows into `arena`
+     *
+     * Rows share the arena and keep it alive; Row::getBlobBytes() copies
+     * BLOB contents into it as well. Null (the default) gives every Row a
+     * buffer of its own. Already materialized rows are not affected.
+     */
+    void setArena(std::shared_ptr<ResultArena> arena) noexcept {
+        arena_ = std::move(arena);
+        if (arena_ && memory_.attached()) {
+            arena_->trackIn(memoryAccount_);
+        }
+    }
+
+    const std::shared_ptr<ResultArena>& getArena() const noexcept { return arena_; }
+
+    /**
+     * @brief How fetchOne() / fetchRows() rows refer to the transaction
+     *
+     * RowOwnership::borrowed skips the per-row reference to the transaction
+     * (see RowOwnership); the caller keeps the transaction alive while the
+     * rows read BLOBs. Cursors from Transaction::openBorrowedCursor() start
+     * borrowed, all others shared.
+     */
+    void setRowOwnership(RowOwnership ownership) noexcept { rowOwnership_ = ownership; }
+    RowOwnership rowOwnership() const noexcept { return rowOwnership_; }
+
+    /**
+     * @brief Fetch up to batchSize rows decoded into per-column arrays
+     *
+     * Rows are staged as raw messages and then decoded column-at-a-time
+     * into `batch` (see column_batch.hpp for the physical layout). Buffers
+     * already held by `batch` are reused, so calling this in a loop with
+     * the same ColumnBatch keeps its capacity. Rows buffered by the
+     * prefetch window are consumed first.
+     *
+     * @param batch Destination; replaced with the next block of rows
+     * @param batchSize Maximum number of rows to fetch (must be > 0)
+     * @return true if at least one row was fetched
+     */
+    bool fetchColumns(ColumnBatch& batch, std::size_t batchSize);
+
+    /**
+     * @brief Convenience overload returning a fresh ColumnBatch
+     * @return Batch with rowCount == 0 at end of result set
+     */
+    ColumnBatch fetchColumns(std::size_t batchSize) {
+        ColumnBatch batch;
+        fetchColumns(batch, batchSize);
+        return batch;
+    }
+
+    /**
+     * @brief Stream the remaining rows as JSON text into `writer`
+     *
+     * Rows go from the fetch buffer straight to JSON (see
+     * json_stream_writer.hpp); nothing is retained per row. The caller
+     * calls writer.finish() once all cursors for the document are written.
+     *
+     * @param maxRows Stop after this many rows (0 = all)
+     * @return Number of rows written
+     */
+    std::size_t writeJson(JsonStreamWriter& writer, std::size_t maxRows = 0);
+
+    /**
+     * @brief Stream the remaining rows into nested objects (json_nest_writer.hpp)
+     *
+     * The caller calls writer.finish() and then the stream writer's
+     * finish() once all rows for the document are written.
+     *
+     * @param maxRows Stop after this many rows (0 = all)
+     * @return Number of rows consumed
+     */
+    std::size_t writeJson(JsonNestWriter& writer, std::size_t maxRows = 0);
+
+    /**
+     * @brief Stream the remaining rows as CSV records into `writer`
+     *
+     * Writes the header (if enabled) even when no rows remain. With a
+     * background writer the sink runs while the next rows are fetched;
+     * the caller calls writer.finish() at the end.
+     *
+     * @param maxRows Stop after this many rows (0 = all)
+     * @return Number of rows written
+     */
+    std::size_t writeCsv(CsvStreamWriter& writer, std::size_t maxRows = 0);
+
+    /**
+     * @brief Copy the remaining raw messages into a binary snapshot
+     *
+     * Messages go to `writer` as fetched, without decoding (see
+     * result_snapshot.hpp); the caller calls writer.finish() at the end.
+     *
+     * @param maxRows Stop after this many rows (0 = all)
+     * @return Number of rows written
+     */
+    std::size_t writeSnapshot(ResultSnapshotWriter& writer, std::size_t maxRows = 0);
+
+    /**
+     * @brief Fetch on this thread, decode into T on the shared executor
+     *
+     * The calling thread copies raw messages into blocks of
+     * options.blockRows rows (through the prefetch window, if set) and
+     * hands each block to a decode task on Executor::shared(), which
+     * decodes it with the same unpack<T>() as fetch(). Decoded blocks come
+     * back to the calling thread and are passed to `sink(std::vector<T>& rows)` there, so the
+     * sink needs no locking; it may move the rows out. With
+     * options.ordered the blocks arrive in fetch order, otherwise in the
+     * order they finish.
+     *
+     * Worth it when decoding costs more than fetching (wide rows, JSON,
+     * struct conversions). Decoding that reads BLOB contents calls the
+     * attachment from the workers. A decode or sink exception stops the
+     * pipeline and is rethrown here once the decode tasks have finished.
+     *
+     * @return Number of rows delivered
+     */
+    template<typename T, typename Sink>
+    std::size_t decodeParallel(Sink&& sink, const ParallelDecodeOptions& options = {});
+
+    /**
+     * @brief Drive the remaining rows into a RowSink (see row_sink.hpp)
+     *
+     * Messages are fetched (through the prefetch window, if set) into
+     * blocks of options.blockRows rows and passed to sink.consume() between
+     * sink.begin(metadata) and sink.end(). With options.workers the sink
+     * runs in tasks on Executor::shared() while the next blocks are
+     * fetched, at most options.maxBlocksInFlight blocks ahead of it. A sink
+     * exception stops the fetch and is rethrown here once those tasks have
+     * finished; end()
+     * is then not called.
+     *
+     * @return Number of rows handed to the sink
+     */
+    template<typename Sink>
+        requires RowSink<std::remove_cvref_t<Sink>>
+    std::size_t writeTo(Sink&& sink, const RowSinkOptions& options = {});
+
     /// Range of RowView snapshots — for hot loops without per-row copy.
     /// Each ++iterator overwrites the same internal buffer; the
     /// previous RowView is invalidated. Copy to Row before keeping.
     class RowsRange;
     RowsRange rows();
 
+    /// Resolve a column name once; pass the ref to RowView / Row accessors
+    ColumnRef column(std::string_view name) const {
+        if (!metadata_) {
+            throw FirebirdException("Result set has no output columns");
+        }
+        return ColumnRef::resolve(*metadata_, name);
+    }
+
+    /**
+     * @brief Set the prefetch window size
+     *
+     * With rows > 1 the cursor pulls up to `rows` messages per refill into
+     * a contiguous block of aligned message buffers and serves fetch(),
+     * fetchOne() and rows() from there, so iteration walks sequential
+     * memory. rows == 1 (the default) fetches one message per call straight
+     * into the single row buffer. Rows that are already buffered are still
+     * served after the window is changed; the new size applies from the
+     * next refill.
+     *
+     * A RowView stays bound to the slot it was taken from, but the
+     * staleness guard still invalidates it on the next row, exactly as in
+     * unbuffered mode.
+     *
+     * @param rows Messages per refill (0 is treated as 1)
+     */
+    void setPrefetch(unsigned rows);
+
+    /**
+     * @brief Current prefetch window size (1 = unbuffered)
+     */
+    unsigned getPrefetch() const noexcept { return prefetch_; }
+
+    /**
+     * @brief Serve at most `rows` rows in all (0 = no limit)
+     *
+     * Past the limit fetch(), fetchOne(), rows() and iteration report the
+     * end without a server round trip, and no refill asks the server for
+     * more rows than remain, so a fetchOne() with a prefetch window of
+     * 128 still fetches one row. Counts rows served since the cursor was
+     * opened; fetchColumns() stops at it as well and a fetchPage() page
+     * holds at most that many rows. Scroll moves are not limited.
+     */
+    void setRowLimit(std::uint64_t rows) noexcept { rowLimit_ = rows; }
+
+    std::uint64_t getRowLimit() const noexcept { return rowLimit_; }
+
     /// Generation counter — bumped on every fetchNext / close. RowView
     /// snapshots its value and uses it for the staleness guard.
     std::uint64_t generation() const noexcept { return generation_; }
@@ -187,6 +537,51 @@ public:
         statement_ = std::move(statement);
     }
 
+    /**
+     * @brief Time server fetches into the producing statement's metrics
+     *        (set by Statement::openCursor when metrics are collected)
+     */
+    void setMetrics(std::shared_ptr<StatementMetrics> metrics) noexcept {
+        metrics_ = std::move(metrics);
+    }
+
+    /**
+     * @brief Attachment counters read just before the cursor opened;
+     *        close() adds the delta to the metrics (captureServerCounters)
+     */
+    void setServerCountersBaseline(ServerCounters before);
+
+    /**
+     * @brief Charge this cursor's buffers (and its arena) to a connection's
+     *        memory account (set by Statement::openCursor)
+     */
+    void trackMemory(std::shared_ptr<detail::MemoryAccount> account);
+
+    /**
+     * @brief Start with the fetch buffers a closed cursor left in `stash`,
+     *        and leave ours there on close (set by Statement::openCursor)
+     */
+    void recycleBuffers(std::shared_ptr<detail::FetchBufferStash> stash);
+
+    /**
+     * @brief Take over a started fetch-loop span (Statement::openCursor);
+     *        close() ends it with the number of rows served
+     */
+    void attachSpan(SpanObserver* observer, void* span) noexcept {
+        spanObserver_ = observer;
+        span_ = span;
+        spanRows_ = 0;
+    }
+
+    /**
+     * @brief Take over the timing of a sampled statement (Statement::openCursor);
+     *        close() adds the fetch and unpack parts and reports it
+     * @see slow_query_log.hpp
+     */
+    void attachSlowQuery(std::unique_ptr<detail::SlowQueryProbe> probe) noexcept {
+        slowQuery_ = std::move(probe);
+    }
+
     /**
      * @brief Helper class for row iteration
      */
@@ -261,14 +656,85 @@ public:
     Iterator<RowType> end() { return Iterator<RowType>(this, true); }
 
 private:
+    enum class ScrollMove { first, last, prior, absolute, relative };
+
+    /**
+     * @brief Position the server cursor and fetch the row there
+     * @param buffer Destination message (getBufferSize() bytes)
+     * @return `buffer`, or nullptr if the move left the result set
+     */
+    const uint8_t* scrollRow(ScrollMove move, int offset, uint8_t* buffer);
+
+    template<typename T>
+    bool scrollInto(ScrollMove move, int offset, T& record) {
+        if (buffer_.empty()) {
+            buffer_.resize(getBufferSize());
+            chargeBuffers();
+        }
+        const uint8_t* row = scrollRow(move, offset, buffer_.data());
+        if (!row) {
+            return false;
+        }
+        detail::SlowQueryTimer timer(unpackClock());
+        detail::PhaseTimer phase(metrics_.get(), Phase::Unpack);
+        record = unpack<T>(row, metadata_.get(), transaction_.get());
+        return true;
+    }
+
     /**
      * @brief Fetch next row into buffer (internal use)
      * @param buffer Buffer to receive row data
      * @return Fetch status (RESULT_OK, RESULT_NO_DATA, or RESULT_ERROR)
      */
     int fetchNext(void* buffer);
+
+    /**
+     * @brief Advance to the next row
+     * @return Pointer to the row message, or nullptr at end of result set
+     */
+    const uint8_t* nextRow();
+
+    /**
+     * @brief Copy the next row message into `target` (getMessageLength() bytes)
+     *
+     * Unbuffered, the server writes it there directly; through the prefetch
+     * window it is copied out of its slot.
+     * @return false at end of result set
+     */
+    bool fetchMessage(void* target);
+
+    /**
+     * @brief Refill the prefetch window from the server cursor
+     * @return Number of messages placed in the window
+     */
+    unsigned refillWindow();
+
+    // Drop metrics_, clearing this thread's BLOB attribution if it is ours
+    void releaseMetrics() noexcept;
+
+    // Add the server counter delta since the baseline to metrics_, if any
+    void recordServerCounters() noexcept;
+
+    // End the attached span, if any
+    void endSpan(bool failed) noexcept;
+
+    // Report the attached slow-query probe, if any; before statement_ is released
+    void finishSlowQuery(bool failed) noexcept;
+
+    // Where decoding time goes: the probe's unpack part, or nowhere
+    std::chrono::steady_clock::duration* unpackClock() noexcept {
+        return slowQuery_ ? &slowQuery_->timings.unpack : nullptr;
+    }
     
     void cleanup();
+
+    // Hand the fetch buffers to recycler_, if any; the cursor is closed
+    void returnBuffers() noexcept;
+
+    // Report the buffers' capacity to the memory account, if any
+    void chargeBuffers() const noexcept {
+        memory_.set(buffer_.capacity() + window_.capacity() + columnStage_.capacity());
+    }
     
     // Internal helper to get a ready-to-use ThrowStatusWrapper
     Firebird::ThrowStatusWrapper& status() const {
@@ -283,9 +749,19 @@ private:
     std::shared_ptr<const MessageMetadata> metadata_;
     // Owning: the cursor is the shortest-lived object of the chain and
     // must keep its transaction (and statement, see retainStatement)
-    // alive. Both are released by close().
+    // alive. Both are released by close(). A borrowed cursor holds a
+    // non-owning transaction_ and no statement_.
     std::shared_ptr<Transaction> transaction_;
     std::shared_ptr<Statement> statement_;
+    std::shared_ptr<StatementMetrics> metrics_;   // Null unless collected
+    std::unique_ptr<ServerCounters> serverBaseline_;   // Null unless captured
+    // Fetch-loop span (see attachSpan); null observer = none
+    SpanObserver* spanObserver_ = nullptr;
+    void* span_ = nullptr;
+    std::uint64_t spanRows_ = 0;   // Rows served, for the span, the probe and rowLimit_
+    std::uint64_t rowLimit_ = 0;   // setRowLimit(); 0 = none
+    // Sampled by the slow-query log (see attachSlowQuery); null = not timed
+    std::unique_ptr<detail::SlowQueryProbe> slowQuery_;
     Firebird::IStatus* status_;
     mutable Firebird::ThrowStatusWrapper statusWrapper_{nullptr};
     bool eof_ = false;
@@ -296,6 +772,30 @@ private:
     // Bumped on each successful fetchNext and on close(). Used by
     // RowView for the staleness guard.
     std::uint64_t generation_ = 0;
+
+    // Prefetch window: windowCount_ messages of windowStride_ bytes each,
+    // windowPos_ is the next one to serve. windowDrained_ records that the
+    // server cursor already returned RESULT_NO_DATA.
+    unsigned prefetch_ = 1;
+    std::vector<uint8_t> window_;
+    unsigned windowStride_ = 0;
+    unsigned windowCount_ = 0;
+    unsigned windowPos_ = 0;
+    bool windowDrained_ = false;
+
+    // Staging block for fetchColumns(): raw messages before columnar decode.
+    std::vector<uint8_t> columnStage_;
+
+    // Where the three buffers above go on close (see recycleBuffers)
+    std::shared_ptr<detail::FetchBufferStash> recycler_;
+
+    // Destination of materialized Rows (setArena); null = per-row buffers
+    std::shared_ptr<ResultArena> arena_;
+    RowOwnership rowOwnership_ = RowOwnership::shared;
+
+    // Connection::memoryUsage() accounting (see trackMemory)
+    std::shared_ptr<detail::MemoryAccount> memoryAccount_;
+    mutable detail::MemoryCharge memory_;
 };
 
 /// Range adapter for `for (const auto& v : cursor->rows())`. Constructs
@@ -348,3 +848,7 @@ private:
 
 } // namespace core
 } // namespace fbpp
+
+// ResultSet::decodeParallel() / writeTo() — need the full ResultSet definition
+#include "fbpp/core/result_set_parallel.hpp"
+#include "fbpp/core/result_set_sink.hpp"
@@ -0,0 +1,196 @@
+#pragma once
+
+// ResultSet::decodeParallel(): one fetching thread (the caller), decode
+// tasks on Executor::shared(), and a bounded set of message blocks cycling
+// between them. Included at the end of result_set.hpp.
+//
+//   cursor->decodeParallel<nlohmann::json>([&](std::vector<nlohmann::json>& rows) {
+//       for (auto& row : rows) out << row.dump() << '\n';
+//   }, {.workers = 6, .blockRows = 512});
+
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/executor.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace fbpp {
+namespace core {
+
+template<typename T, typename Sink>
+std::size_t ResultSet::decodeParallel(Sink&& sink, const ParallelDecodeOptions& options) {
+    if (!isValid()) {
+        throw FirebirdException("ResultSet::decodeParallel called on closed cursor");
+    }
+    Executor& executor = *Executor::shared();
+    const std::size_t workerCount = options.workers != 0 ? options.workers
+                                                         : executor.threadCount();
+    const std::size_t blockRows = std::max<std::size_t>(options.blockRows, 1);
+    const std::size_t maxBlocks = options.maxBlocksInFlight != 0
+                                      ? std::max<std::size_t>(options.maxBlocksInFlight, 1)
+                                      : 2 * workerCount;
+    // Messages stay aligned for the codec's typed reads
+    constexpr std::size_t kAlign = alignof(std::max_align_t);
+    const std::size_t length = metadata_->getMessageLength();
+    const std::size_t stride = (length + kAlign - 1) / kAlign * kAlign;
+
+    struct Block {
+        std::size_t seq = 0;
+        std::size_t rows = 0;
+        std::unique_ptr<std::max_align_t[]> raw;
+        std::vector<T> decoded;
+        std::exception_ptr error;
+    };
+
+    const MessageMetadata* meta = metadata_.get();
+    Transaction* tx = transaction_.get();
+
+    std::mutex mutex;
+    std::condition_variable blockDone;   // done gained a block, or a decoder finished
+    std::deque<Block*> pending;
+    std::map<std::size_t, Block*> done;  // By seq; relaxed mode takes begin() too
+    std::size_t decoders = 0;            // Decode tasks queued or running
+    bool stopping = false;
+
+    std::vector<std::unique_ptr<Block>> blocks;
+    std::vector<Block*> idle;
+
+    // Stops the decode tasks and waits for them on every exit path
+    struct Drain {
+        Executor& executor;
+        std::mutex& mutex;
+        std::condition_variable& blockDone;
+        bool& stopping;
+        std::size_t& decoders;
+        ~Drain() {
+            std::unique_lock<std::mutex> lock(mutex);
+            stopping = true;
+            executor.waitHelping(lock, blockDone, [&] { return decoders == 0; });
+        }
+    } drain{executor, mutex, blockDone, stopping, decoders};
+
+    // One task decodes pending blocks until none is left; at most
+    // workerCount run at once
+    auto decode = [&] {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopping && !pending.empty()) {
+            Block* block = pending.front();
+            pending.pop_front();
+            lock.unlock();
+            try {
+                block->decoded.resize(block->rows);
+                const auto* raw = reinterpret_cast<const uint8_t*>(block->raw.get());
+                for (std::size_t r = 0; r < block->rows; ++r) {
+                    block->decoded[r] = unpack<T>(raw + r * stride, meta, tx);
+                }
+            } catch (...) {
+                block->error = std::current_exception();
+            }
+            lock.lock();
+            done.emplace(block->seq, block);
+            blockDone.notify_all();
+        }
+        // Under the lock: the caller may return as soon as it can take it
+        --decoders;
+        blockDone.notify_all();
+    };
+
+    std::size_t nextSeq = 0;        // Next block to fill
+    std::size_t deliverSeq = 0;     // Next block to deliver in ordered mode
+    std::size_t delivered = 0;      // Blocks delivered
+    std::size_t total = 0;
+
+    // Hand finished blocks to the sink; with `wait`, block for at least one
+    auto deliver = [&](bool wait) {
+        for (;;) {
+            Block* block = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                auto ready = [&] {
+                    return !done.empty() && (!options.ordered || done.begin()->first == deliverSeq);
+                };
+                if (wait) {
+                    executor.waitHelping(lock, blockDone, ready);
+                } else if (!ready()) {
+                    return;
+                }
+                auto it = done.begin();
+                block = it->second;
+                done.erase(it);
+            }
+            wait = false;
+            if (block->error) {
+                std::rethrow_exception(block->error);
+            }
+            ++deliverSeq;
+            ++delivered;
+            total += block->rows;
+            sink(block->decoded);
+            idle.push_back(block);
+        }
+    };
+
+    while (!eof_) {
+        if (idle.empty()) {
+            if (blocks.size() < maxBlocks) {
+                auto block = std::make_unique<Block>();
+                block->raw.reset(new std::max_align_t[stride * blockRows / sizeof(std::max_align_t)]);
+                idle.push_back(block.get());
+                blocks.push_back(std::move(block));
+            } else {
+                deliver(true);
+                continue;
+            }
+        }
+        Block* block = idle.back();
+        auto* raw = reinterpret_cast<uint8_t*>(block->raw.get());
+        block->rows = 0;
+        while (block->rows < blockRows) {
+            const uint8_t* row = nextRow();
+            if (!row) {
+                break;
+            }
+            std::memcpy(raw + block->rows * stride, row, length);
+            ++block->rows;
+        }
+        if (block->rows == 0) {
+            break;
+        }
+        idle.pop_back();
+        block->seq = nextSeq++;
+        block->error = nullptr;
+        bool start = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending.push_back(block);
+            if (decoders < workerCount) {
+                ++decoders;
+                start = true;
+            }
+        }
+        if (start) {
+            try {
+                executor.post(decode);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                --decoders;
+                throw;
+            }
+        }
+        deliver(false);
+    }
+    while (delivered < nextSeq) {
+        deliver(true);
+    }
+    return total;
+}
+
+} // namespace core
+} // namespace fbpp
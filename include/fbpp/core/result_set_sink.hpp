@@ -0,0 +1,210 @@
+#pragma once
+
+// ResultSet::writeTo(): the fetch loop behind every RowSink (row_sink.hpp).
+// The calling thread fetches into a bounded set of message blocks; the
+// sink consumes them there or in tasks on Executor::shared(). Included at the end of
+// result_set.hpp.
+//
+//   JsonStreamWriter writer(out);
+//   cursor->writeTo(JsonRowSink(writer), {.blockRows = 512, .workers = 1});
+//   writer.finish();
+
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/executor.hpp"
+#include "fbpp/core/row_sink.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace fbpp {
+namespace core {
+
+template<typename Sink>
+    requires RowSink<std::remove_cvref_t<Sink>>
+std::size_t ResultSet::writeTo(Sink&& sink, const RowSinkOptions& options) {
+    if (!isValid()) {
+        throw FirebirdException("ResultSet::writeTo called on closed cursor");
+    }
+    using SinkType = std::remove_cvref_t<Sink>;
+    const unsigned workerCount = options.workers == 0        ? 0u
+                                 : row_sink_concurrent_v<SinkType> ? options.workers
+                                                                   : 1u;
+    const std::size_t blockRows = std::max<std::size_t>(options.blockRows, 1);
+    const std::size_t maxBlocks = options.maxBlocksInFlight != 0
+                                      ? std::max<std::size_t>(options.maxBlocksInFlight, 1)
+                                      : 2 * static_cast<std::size_t>(std::max(workerCount, 1u));
+    // Messages stay aligned for the codec's typed reads
+    constexpr std::size_t kAlign = alignof(std::max_align_t);
+    const std::size_t length = metadata_->getMessageLength();
+    const std::size_t stride = (length + kAlign - 1) / kAlign * kAlign;
+
+    struct Block {
+        MessageBlock messages;
+        std::unique_ptr<std::max_align_t[]> raw;
+    };
+    std::vector<std::unique_ptr<Block>> blocks;
+    auto newBlock = [&] {
+        auto block = std::make_unique<Block>();
+        block->raw.reset(new std::max_align_t[stride * blockRows / sizeof(std::max_align_t)]);
+        blocks.push_back(std::move(block));
+        return blocks.back().get();
+    };
+
+    std::size_t total = 0;
+    std::size_t nextSeq = 0;
+    // Fill `block` from the cursor; false once there is nothing left
+    auto fill = [&](Block& block) {
+        auto* raw = reinterpret_cast<uint8_t*>(block.raw.get());
+        std::size_t rows = 0;
+        while (rows < blockRows && !eof_ &&
+               (options.maxRows == 0 || total + rows < options.maxRows)) {
+            const uint8_t* row = nextRow();
+            if (!row) {
+                eof_ = true;
+                break;
+            }
+            std::memcpy(raw + rows * stride, row, length);
+            ++rows;
+        }
+        MessageBlock& messages = block.messages;
+        messages.data = raw;
+        messages.rows = rows;
+        messages.stride = stride;
+        messages.seq = nextSeq++;
+        messages.firstRow = total;
+        messages.transaction = transaction_.get();
+        if (!messages.metadata) {
+            messages.metadata = metadata_;
+        }
+        total += rows;
+        return rows != 0;
+    };
+
+    sink.begin(*metadata_);
+
+    if (workerCount == 0) {
+        Block* block = newBlock();
+        while (fill(*block)) {
+            sink.consume(block->messages);
+        }
+        sink.end();
+        return total;
+    }
+
+    Executor& executor = *Executor::shared();
+    std::mutex mutex;
+    std::condition_variable blockFree;   // idle gained a block, or a consumer finished
+    std::deque<Block*> pending;          // Fetch order
+    std::vector<Block*> idle;
+    std::exception_ptr error;            // First sink failure
+    std::size_t consumers = 0;           // Consume tasks queued or running
+    bool stopping = false;
+
+    // Stops the consume tasks and waits for them on every exit path
+    struct Drain {
+        Executor& executor;
+        std::mutex& mutex;
+        std::condition_variable& blockFree;
+        bool& stopping;
+        std::size_t& consumers;
+        ~Drain() {
+            std::unique_lock<std::mutex> lock(mutex);
+            stopping = true;
+            executor.waitHelping(lock, blockFree, [&] { return consumers == 0; });
+        }
+    } drain{executor, mutex, blockFree, stopping, consumers};
+
+    // One task consumes pending blocks in fetch order until none is left;
+    // at most workerCount run at once (one for a non-concurrent sink)
+    auto consume = [&] {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopping && !pending.empty()) {
+            Block* block = pending.front();
+            pending.pop_front();
+            const bool failed = error != nullptr;
+            lock.unlock();
+            std::exception_ptr failure;
+            if (!failed) {
+                try {
+                    sink.consume(block->messages);
+                } catch (...) {
+                    failure = std::current_exception();
+                }
+            }
+            lock.lock();
+            if (failure && !error) {
+                error = failure;
+            }
+            idle.push_back(block);
+            blockFree.notify_all();
+        }
+        // Under the lock: the caller may return as soon as it can take it
+        --consumers;
+        blockFree.notify_all();
+    };
+
+    for (;;) {
+        Block* block = nullptr;
+        {
+            // Backpressure: with every block waiting for the sink, wait too
+            std::unique_lock<std::mutex> lock(mutex);
+            if (idle.empty() && blocks.size() >= maxBlocks) {
+                executor.waitHelping(lock, blockFree, [&] { return error || !idle.empty(); });
+            }
+            if (error) {
+                break;
+            }
+            if (!idle.empty()) {
+                block = idle.back();
+                idle.pop_back();
+            }
+        }
+        if (!block) {
+            block = newBlock();
+        }
+        if (!fill(*block)) {
+            std::lock_guard<std::mutex> lock(mutex);
+            idle.push_back(block);
+            break;
+        }
+        bool start = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending.push_back(block);
+            if (consumers < workerCount) {
+                ++consumers;
+                start = true;
+            }
+        }
+        if (start) {
+            try {
+                executor.post(consume);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                --consumers;
+                throw;
+            }
+        }
+    }
+
+    // Let the consume tasks finish (or skip, after a failure) the queued blocks
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        executor.waitHelping(lock, blockFree, [&] { return idle.size() == blocks.size(); });
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    sink.end();
+    return total;
+}
+
+} // namespace core
+} // namespace fbpp
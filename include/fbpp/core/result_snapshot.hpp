@@ -0,0 +1,179 @@
+#pragma once
+
+// Binary snapshots of result sets: raw message buffers plus their layout.
+//
+// ResultSnapshotWriter stores the output MessageMetadata (types, lengths,
+// scales, charsets, offsets and names of every column) followed by the
+// fetched messages exactly as Firebird delivered them, in blocks of
+// blockRows aligned messages. Nothing is decoded or re-encoded, so INT128,
+// DECFLOAT and time zone values round-trip bit for bit.
+//
+// ResultSnapshot maps a snapshot file (or adopts an in-memory copy) and
+// hands out RowView objects over the stored messages. Uncompressed blocks
+// are read in place from the mapping; zstd blocks (FBPP_WITH_ZSTD builds)
+// are inflated once when the snapshot is opened. The metadata is rebuilt
+// with IMetadataBuilder, so reading needs the Firebird client library but
+// no attachment.
+//
+// BLOB and ARRAY columns hold ids that mean nothing outside their
+// transaction and are rejected by the writer; cast them to VARCHAR or use
+// inline BLOB retrieval before snapshotting.
+//
+// File layout (native byte order, every section 8-byte aligned):
+//   "FBPPSNAP" u32 version u32 compression u32 fieldCount u32 messageLength
+//   u32 stride u32 0, then per field u32 type, subType, length, i32 scale,
+//   u32 charSet, offset, nullOffset, u8 nullable and four u32-prefixed
+//   strings (name, relation, owner, alias); then blocks of
+//   u32 rows u32 0 u64 storedBytes + payload; a block with rows == 0
+//   ends the data and is followed by u64 total row count.
+
+#include "fbpp/core/message_metadata.hpp"
+#include "fbpp/core/row.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fbpp::core {
+
+namespace detail {
+class MappedFile;
+}
+
+/// Block codec of a snapshot
+enum class SnapshotCompression : std::uint32_t {
+    none = 0,
+    zstd = 1,   // Needs a build with -DFBPP_WITH_ZSTD=ON
+};
+
+/**
+ * @brief Block size and codec of a ResultSnapshotWriter
+ */
+struct SnapshotWriteOptions {
+    SnapshotCompression compression = SnapshotCompression::none;
+    int compressionLevel = 3;          // zstd level
+    std::size_t blockRows = 4096;      // Messages per block
+};
+
+/**
+ * @brief Writes fetched messages into a binary snapshot stream
+ *
+ * Construct with the cursor's output metadata, call writeRow() per message
+ * (ResultSet::writeSnapshot() does this for a cursor) and finish() once.
+ * The stream must outlive the writer.
+ */
+class ResultSnapshotWriter {
+public:
+    /**
+     * @throws FirebirdException for BLOB/ARRAY columns or zstd requested
+     *         in a build without it
+     */
+    ResultSnapshotWriter(std::ostream& out, const MessageMetadata& metadata,
+                         SnapshotWriteOptions options = {});
+
+    ResultSnapshotWriter(const ResultSnapshotWriter&) = delete;
+    ResultSnapshotWriter& operator=(const ResultSnapshotWriter&) = delete;
+
+    /// Append one message of the metadata's layout
+    void writeRow(const uint8_t* message);
+
+    /// Write the last block and the trailer
+    void finish();
+
+    std::size_t rowCount() const noexcept { return rows_; }
+    bool finished() const noexcept { return finished_; }
+
+private:
+    void writeBlock();
+
+    std::ostream& out_;
+    SnapshotWriteOptions options_;
+    std::size_t messageLength_;
+    std::size_t stride_;
+    std::vector<uint8_t> block_;        // blockRows aligned messages
+    std::vector<uint8_t> compressed_;   // zstd output; capacity reused
+    std::size_t blockCount_ = 0;        // Rows in block_
+    std::size_t rows_ = 0;
+    bool finished_ = false;
+};
+
+/**
+ * @brief Read-only snapshot of a result set
+ *
+ * Rows are addressed by index; row() returns a RowView with the usual
+ * typed accessors. Views point into the snapshot, so it must outlive
+ * them. const access is safe from several threads.
+ */
+class ResultSnapshot {
+public:
+    /// Map a snapshot file (read into memory where mmap is unavailable)
+    static ResultSnapshot open(const std::string& path);
+
+    /// Adopt a snapshot held in memory
+    static ResultSnapshot fromBytes(std::vector<uint8_t> bytes);
+
+    ResultSnapshot(ResultSnapshot&&) noexcept;
+    ResultSnapshot& operator=(ResultSnapshot&&) noexcept;
+    ~ResultSnapshot();
+
+    const std::shared_ptr<const MessageMetadata>& metadata() const noexcept { return metadata_; }
+    std::size_t rowCount() const noexcept { return rowCount_; }
+    bool empty() const noexcept { return rowCount_ == 0; }
+
+    /// Raw message of row `index`
+    /// @throws FirebirdException if index >= rowCount()
+    const uint8_t* rowData(std::size_t index) const;
+
+    RowView row(std::size_t index) const {
+        return RowView(metadata_, rowData(index), nullptr);
+    }
+
+    /// Random-access walk yielding RowView by value
+    class Iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = RowView;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = void;
+        using reference         = RowView;
+
+        Iterator(const ResultSnapshot* snapshot, std::size_t index) noexcept
+            : snapshot_(snapshot), index_(index) {}
+
+        RowView operator*() const { return snapshot_->row(index_); }
+        Iterator& operator++() noexcept { ++index_; return *this; }
+        bool operator==(const Iterator& other) const noexcept { return index_ == other.index_; }
+        bool operator!=(const Iterator& other) const noexcept { return index_ != other.index_; }
+
+    private:
+        const ResultSnapshot* snapshot_;
+        std::size_t index_;
+    };
+
+    Iterator begin() const noexcept { return Iterator(this, 0); }
+    Iterator end() const noexcept { return Iterator(this, rowCount_); }
+
+private:
+    struct Block {
+        std::size_t firstRow;
+        std::size_t rows;
+        const uint8_t* data;
+    };
+
+    ResultSnapshot() = default;
+    void parse(const uint8_t* data, std::size_t size);
+
+    std::unique_ptr<detail::MappedFile> file_;
+    std::vector<uint8_t> bytes_;        // Whole snapshot when not mapped
+    std::vector<uint8_t> inflated_;     // Decompressed blocks
+    std::shared_ptr<const MessageMetadata> metadata_;
+    std::vector<Block> blocks_;
+    std::size_t stride_ = 0;
+    std::size_t rowCount_ = 0;
+};
+
+} // namespace fbpp::core
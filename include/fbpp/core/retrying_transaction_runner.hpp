@@ -0,0 +1,146 @@
+#pragma once
+
+// RetryingTransactionRunner — run a unit of work in its own transaction and
+// start over when it loses a concurrency conflict.
+//
+//   fbpp::core::RetryPolicy policy;
+//   policy.transaction = fbpp::core::TransactionOptions::noWait();
+//   fbpp::core::RetryingTransactionRunner runner(conn, policy);
+//   auto stock = runner.run([&](fbpp::core::Transaction& tx) {
+//       tx.execute(decrement, std::make_tuple(itemId));
+//       return readStock(tx, itemId);
+//   });
+//
+// Every attempt starts a transaction with RetryPolicy::transaction, calls
+// the work with it and commits. A FirebirdException carrying one of the
+// conflict codes (update conflict, lock conflict, deadlock, lock time-out)
+// anywhere in its status vector, from the work or from the commit, rolls
+// back and retries after a jittered exponential backoff ("full jitter":
+// uniform in [0, min(maxBackoff, initialBackoff * multiplier^n)]), which
+// spreads colliding writers apart instead of having them collide again in
+// lockstep. Any other exception rolls back and propagates at once; the
+// last conflict propagates when maxAttempts is used up.
+//
+// With the default wait transaction a conflict surfaces only after the
+// competing transaction ends; noWait() or lockTimeout() surface it at once
+// or after a bound and let the backoff do the waiting.
+//
+// The work may run several times: keep side effects outside the database
+// idempotent or move them after run(). A runner drives one connection and
+// is used by one thread at a time, like the connection; stats() may be
+// read from any thread.
+
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/statement_metrics.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/transaction_options.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fbpp {
+namespace core {
+
+struct RetryPolicy {
+    unsigned maxAttempts = 8;                           ///< Including the first one
+    std::chrono::milliseconds initialBackoff{2};
+    std::chrono::milliseconds maxBackoff{500};
+    double multiplier = 2.0;
+    TransactionOptions transaction;                     ///< TPB of every attempt
+    std::vector<int> extraRetryableCodes;               ///< More GDS codes to treat as conflicts
+    /// Called before each retry's backoff, with the attempt that failed (1-based)
+    std::function<void(unsigned attempt, const FirebirdException& error)> onRetry;
+};
+
+/// Counters of a RetryingTransactionRunner since construction
+struct RetryStats {
+    uint64_t runs = 0;             ///< run() calls
+    uint64_t attempts = 0;         ///< Transactions started
+    uint64_t commits = 0;
+    uint64_t conflicts = 0;        ///< Retryable errors seen (retried or not)
+    uint64_t exhausted = 0;        ///< run() calls that gave up on a conflict
+    uint64_t failures = 0;         ///< run() calls ended by another exception
+    LatencySnapshot backoff;       ///< Sleeps between attempts
+    LatencySnapshot runLatency;    ///< Successful run() calls, retries included
+
+    double retriesPerRun() const noexcept {
+        return runs ? static_cast<double>(attempts - runs) / static_cast<double>(runs) : 0.0;
+    }
+};
+
+class RetryingTransactionRunner {
+public:
+    explicit RetryingTransactionRunner(Connection& connection, RetryPolicy policy = {});
+
+    /// Run `work(Transaction&)` to commit, retrying on conflicts; returns its result
+    template<typename Work>
+    std::invoke_result_t<Work&, Transaction&> run(Work&& work);
+
+    /// True if `error` is a concurrency conflict (any GDS code in the vector)
+    bool isRetryable(const FirebirdException& error) const;
+
+    /// Default conflict codes only
+    static bool isConflict(const FirebirdException& error);
+
+    RetryStats stats() const;
+    const RetryPolicy& policy() const noexcept { return policy_; }
+
+private:
+    std::shared_ptr<Transaction> begin();
+    // Roll back what is left of the attempt; true = retry after the backoff
+    bool handleFailure(Transaction* transaction, unsigned attempt, const FirebirdException& error);
+    void handleOtherFailure(Transaction* transaction) noexcept;
+    void recordSuccess(std::chrono::steady_clock::time_point started) noexcept;
+
+    Connection& connection_;
+    RetryPolicy policy_;
+    std::atomic<uint64_t> runs_{0};
+    std::atomic<uint64_t> attempts_{0};
+    std::atomic<uint64_t> commits_{0};
+    std::atomic<uint64_t> conflicts_{0};
+    std::atomic<uint64_t> exhausted_{0};
+    std::atomic<uint64_t> failures_{0};
+    LatencyHistogram backoff_;
+    LatencyHistogram runLatency_;
+};
+
+template<typename Work>
+std::invoke_result_t<Work&, Transaction&> RetryingTransactionRunner::run(Work&& work) {
+    using Result = std::invoke_result_t<Work&, Transaction&>;
+    runs_.fetch_add(1, std::memory_order_relaxed);
+    const auto started = std::chrono::steady_clock::now();
+    for (unsigned attempt = 1;; ++attempt) {
+        std::shared_ptr<Transaction> transaction;
+        try {
+            transaction = begin();
+            if constexpr (std::is_void_v<Result>) {
+                work(*transaction);
+                transaction->Commit();
+                recordSuccess(started);
+                return;
+            } else {
+                Result result = work(*transaction);
+                transaction->Commit();
+                recordSuccess(started);
+                return result;
+            }
+        } catch (const FirebirdException& e) {
+            if (!handleFailure(transaction.get(), attempt, e)) {
+                throw;
+            }
+        } catch (...) {
+            handleOtherFailure(transaction.get());
+            throw;
+        }
+    }
+}
+
+} // namespace core
+} // namespace fbpp
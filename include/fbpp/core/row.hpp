@@ -9,26 +9,36 @@
 //              construct, designed for hot loops via ResultSet::rows().
 //
 //   Row      — owning copy. Independent of the cursor — holds its own
-//              bytes and a shared_ptr to metadata. Safe to keep after
-//              the cursor is closed. BLOB reads still need a live
-//              transaction (Row holds shared_ptr<Transaction> for that).
+//              bytes (or a slice of a shared ResultArena, see
+//              ResultSet::setArena) and a shared_ptr to metadata. Safe to
+//              keep after the cursor is closed. BLOB reads still need a
+//              live transaction (Row holds shared_ptr<Transaction> for that,
+//              or only borrows it, see RowOwnership).
 //
 // Both use the same per-field codec (sql_value_codec::read_sql_value)
 // as TupleUnpacker / StructDescriptor, so any type those paths support
-// works here too. get<T>(name | index) returns std::optional<T>:
+// works here too. get<T>(name | index | ColumnRef) returns std::optional<T>:
 //   nullopt    iff column is SQL NULL,
 //   throws     iff column name unknown or T does not match column type.
+//
+// getView() / getBytes() return CHAR / VARCHAR contents as a string_view /
+// byte span into the row buffer instead of a new std::string. A ColumnRef
+// (ResultSet::column(name), RowView::column(name)) resolves a name once so
+// loops over rows() index directly.
 
 #include "fbpp/core/exception.hpp"
 #include "fbpp/core/firebird_compat.hpp"
 #include "fbpp/core/message_metadata.hpp"
+#include "fbpp/core/result_arena.hpp"
 #include "fbpp/core/transaction.hpp"
 #include "fbpp/core/detail/sql_value_codec.hpp"
+#include "fbpp/core/detail/text_scan.hpp"
 
 #include <cstdint>
 #include <cstring>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <type_traits>
@@ -39,6 +49,47 @@ namespace core {
 
 class ResultSet;
 
+/**
+ * @brief Column position resolved once by name
+ *
+ * Tied to the metadata it was resolved against, which all cursors of one
+ * statement share; RowView / Row accessors taking a ColumnRef throw if it
+ * came from another statement.
+ */
+class ColumnRef {
+public:
+    ColumnRef() = default;
+
+    /// Resolve `name` (name or alias, case-insensitive) in `metadata`; throws if absent
+    static ColumnRef resolve(const MessageMetadata& metadata, std::string_view name) {
+        auto idx = metadata.getIndex(name);
+        if (!idx) {
+            throw FirebirdException(
+                std::string("Column not found: '") + std::string(name) + "'");
+        }
+        return ColumnRef(&metadata, *idx);
+    }
+
+    unsigned index() const noexcept { return index_; }
+    bool valid() const noexcept { return metadata_ != nullptr; }
+
+    /// Index for rows described by `metadata`; throws for a foreign ref
+    unsigned indexFor(const MessageMetadata* metadata) const {
+        if (metadata_ != metadata) {
+            throw FirebirdException(
+                "ColumnRef was resolved against a different result set");
+        }
+        return index_;
+    }
+
+private:
+    ColumnRef(const MessageMetadata* metadata, unsigned index) noexcept
+        : metadata_(metadata), index_(index) {}
+
+    const MessageMetadata* metadata_ = nullptr;
+    unsigned index_ = 0;
+};
+
 namespace detail {
 
 // Validate that requested C++ type T is compatible with the column's
@@ -77,6 +128,43 @@ inline bool sqlTypeMatches(const FieldInfo& fi) {
     }
 }
 
+// Shared by RowView / Row::getView(): CHAR / VARCHAR only, since every
+// other type needs a conversion (and therefore storage) to become text.
+inline std::optional<std::string_view> rowTextView(const FieldInfo& fi, const uint8_t* buf) {
+    const int16_t* nullPtr = reinterpret_cast<const int16_t*>(buf + fi.nullOffset);
+    if (nullPtr && *nullPtr == -1) {
+        return std::nullopt;
+    }
+    if (!isTextField(fi)) {
+        throw FirebirdException(
+            std::string("getView() needs a CHAR/VARCHAR column; '") +
+            std::string(displayName(fi)) + "' has sql_type=" + std::to_string(fi.type));
+    }
+    return textView(fi, buf + fi.offset);
+}
+
+// Raw CHAR / VARCHAR bytes: VARCHAR content, or the full CHAR(n) slot with
+// its padding (blanks, or NULs for OCTETS) — no trimming for binary data.
+inline std::optional<std::span<const std::byte>> rowBytesView(const FieldInfo& fi,
+                                                               const uint8_t* buf) {
+    const int16_t* nullPtr = reinterpret_cast<const int16_t*>(buf + fi.nullOffset);
+    if (nullPtr && *nullPtr == -1) {
+        return std::nullopt;
+    }
+    if (!isTextField(fi)) {
+        throw FirebirdException(
+            std::string("getBytes() needs a CHAR/VARCHAR column; '") +
+            std::string(displayName(fi)) + "' has sql_type=" + std::to_string(fi.type));
+    }
+    const auto* data = reinterpret_cast<const std::byte*>(buf + fi.offset);
+    if (fi.type == SQL_VARYING) {
+        uint16_t length = 0;
+        std::memcpy(&length, data, sizeof(length));
+        return std::span<const std::byte>(data + sizeof(uint16_t), length);
+    }
+    return std::span<const std::byte>(data, fi.length);
+}
+
 } // namespace detail
 
 class RowView {
@@ -97,7 +185,7 @@ public:
 
     bool isNull(unsigned index) const {
         checkValid();
-        const FieldInfo& fi = meta_->getField(index);
+        const FieldInfo& fi = meta_->getFieldRef(index);
         const int16_t* nullPtr = reinterpret_cast<const int16_t*>(
             buf_ + fi.nullOffset);
         return nullPtr && *nullPtr == -1;
@@ -110,7 +198,7 @@ public:
     template<typename T>
     std::optional<T> get(unsigned index) const {
         checkValid();
-        const FieldInfo& fi = meta_->getField(index);
+        const FieldInfo& fi = meta_->getFieldRef(index);
         const int16_t* nullPtr = reinterpret_cast<const int16_t*>(
             buf_ + fi.nullOffset);
         if (nullPtr && *nullPtr == -1) {
@@ -134,6 +222,51 @@ public:
         return get<T>(resolveIndex(name));
     }
 
+    /// CHAR (trimmed) / VARCHAR value without copying; nullopt for NULL.
+    /// Points into the fetch buffer, so it shares this view's lifetime.
+    std::optional<std::string_view> getView(unsigned index) const {
+        checkValid();
+        return detail::rowTextView(meta_->getFieldRef(index), buf_);
+    }
+
+    std::optional<std::string_view> getView(std::string_view name) const {
+        return getView(resolveIndex(name));
+    }
+
+    /// CHAR / VARCHAR bytes without copying (CHAR keeps its padding); nullopt for NULL
+    std::optional<std::span<const std::byte>> getBytes(unsigned index) const {
+        checkValid();
+        return detail::rowBytesView(meta_->getFieldRef(index), buf_);
+    }
+
+    std::optional<std::span<const std::byte>> getBytes(std::string_view name) const {
+        return getBytes(resolveIndex(name));
+    }
+
+    // ColumnRef overloads: no name lookup per row
+    bool isNull(const ColumnRef& column) const {
+        return isNull(column.indexFor(meta_.get()));
+    }
+
+    template<typename T>
+    std::optional<T> get(const ColumnRef& column) const {
+        return get<T>(column.indexFor(meta_.get()));
+    }
+
+    std::optional<std::string_view> getView(const ColumnRef& column) const {
+        return getView(column.indexFor(meta_.get()));
+    }
+
+    std::optional<std::span<const std::byte>> getBytes(const ColumnRef& column) const {
+        return getBytes(column.indexFor(meta_.get()));
+    }
+
+    /// Resolve a column name once for use across rows
+    ColumnRef column(std::string_view name) const {
+        checkValid();
+        return ColumnRef::resolve(*meta_, name);
+    }
+
     unsigned columnCount() const {
         checkValid();
         return meta_->getCount();
@@ -162,12 +295,7 @@ public:
 private:
     unsigned resolveIndex(std::string_view name) const {
         checkValid();
-        auto idx = meta_->getIndex(std::string(name));
-        if (!idx) {
-            throw FirebirdException(
-                std::string("Column not found: '") + std::string(name) + "'");
-        }
-        return *idx;
+        return ColumnRef::resolve(*meta_, name).index();
     }
 
     void checkValid() const;
@@ -179,6 +307,21 @@ private:
     std::uint64_t snapshotGen_ = 0;
 };
 
+/**
+ * @brief How a Row refers to the transaction of its BLOB reads
+ *
+ * shared   — the Row holds a reference: BLOB reads work for as long as
+ *            the Row lives. The default.
+ * borrowed — the Row only points at the transaction: no reference count
+ *            is touched per row (creating, moving or dropping it), and the
+ *            caller's scope guarantees the transaction outlives the Row's
+ *            BLOB reads. Scalar reads do not use the transaction either way.
+ */
+enum class RowOwnership {
+    shared,
+    borrowed
+};
+
 class Row {
 public:
     /// Snapshot a RowView into an owning Row. Copies the buffer,
@@ -187,6 +330,13 @@ public:
     /// stay valid after the cursor closes.
     explicit Row(const RowView& view);
 
+    /// Same, but the bytes are copied into `arena` instead of a buffer of
+    /// their own; the Row keeps the arena alive. Null `arena` = own buffer.
+    /// RowOwnership::borrowed points at the view's transaction instead of
+    /// capturing it.
+    Row(const RowView& view, std::shared_ptr<ResultArena> arena,
+        RowOwnership ownership = RowOwnership::shared);
+
     /// Direct construction for callers that build buffers outside of
     /// ResultSet (tests, generated code).
     Row(std::shared_ptr<const MessageMetadata> meta,
@@ -199,9 +349,9 @@ public:
     Row& operator=(const Row&) = delete;
 
     bool isNull(unsigned index) const {
-        const FieldInfo& fi = meta_->getField(index);
+        const FieldInfo& fi = meta_->getFieldRef(index);
         const int16_t* nullPtr = reinterpret_cast<const int16_t*>(
-            buf_.data() + fi.nullOffset);
+            data_ + fi.nullOffset);
         return nullPtr && *nullPtr == -1;
     }
 
@@ -211,9 +361,9 @@ public:
 
     template<typename T>
     std::optional<T> get(unsigned index) const {
-        const FieldInfo& fi = meta_->getField(index);
+        const FieldInfo& fi = meta_->getFieldRef(index);
         const int16_t* nullPtr = reinterpret_cast<const int16_t*>(
-            buf_.data() + fi.nullOffset);
+            data_ + fi.nullOffset);
         if (nullPtr && *nullPtr == -1) {
             return std::nullopt;
         }
@@ -223,7 +373,7 @@ public:
                 std::string(displayName(fi)) + "' (sql_type=" +
                 std::to_string(fi.type) + ")");
         }
-        const uint8_t* dataPtr = buf_.data() + fi.offset;
+        const uint8_t* dataPtr = data_ + fi.offset;
         detail::sql_value_codec::SqlReadContext ctx{&fi, tx_.get(), nullPtr};
         T value{};
         detail::sql_value_codec::read_sql_value(ctx, dataPtr, value);
@@ -235,25 +385,81 @@ public:
         return get<T>(resolveIndex(name));
     }
 
+    /// CHAR (trimmed) / VARCHAR value without copying; valid while this Row lives
+    std::optional<std::string_view> getView(unsigned index) const {
+        return detail::rowTextView(meta_->getFieldRef(index), data_);
+    }
+
+    std::optional<std::string_view> getView(std::string_view name) const {
+        return getView(resolveIndex(name));
+    }
+
+    /// CHAR / VARCHAR bytes without copying; valid while this Row lives
+    std::optional<std::span<const std::byte>> getBytes(unsigned index) const {
+        return detail::rowBytesView(meta_->getFieldRef(index), data_);
+    }
+
+    std::optional<std::span<const std::byte>> getBytes(std::string_view name) const {
+        return getBytes(resolveIndex(name));
+    }
+
+    bool isNull(const ColumnRef& column) const {
+        return isNull(column.indexFor(meta_.get()));
+    }
+
+    template<typename T>
+    std::optional<T> get(const ColumnRef& column) const {
+        return get<T>(column.indexFor(meta_.get()));
+    }
+
+    std::optional<std::string_view> getView(const ColumnRef& column) const {
+        return getView(column.indexFor(meta_.get()));
+    }
+
+    std::optional<std::span<const std::byte>> getBytes(const ColumnRef& column) const {
+        return getBytes(column.indexFor(meta_.get()));
+    }
+
+    ColumnRef column(std::string_view name) const { return ColumnRef::resolve(*meta_, name); }
+
     unsigned columnCount() const { return meta_->getCount(); }
     std::string columnName(unsigned index) const { return meta_->getDisplayName(index); }
     FieldInfo columnInfo(unsigned index) const { return meta_->getField(index); }
     const MessageMetadata& metadata() const { return *meta_; }
-    const uint8_t* data() const { return buf_.data(); }
+    const uint8_t* data() const { return data_; }
     Transaction* transaction() const { return tx_.get(); }
+    /// False for a borrowed transaction (or none)
+    bool ownsTransaction() const noexcept { return tx_.use_count() > 0; }
+
+    /**
+     * @brief BLOB contents, read through the row's transaction
+     *
+     * The bytes are copied into the row's arena (one is created for a row
+     * that has none) and stay valid while the arena lives; each call reads
+     * the BLOB again. nullopt iff the column is NULL; throws if it is not a
+     * BLOB or the row has no transaction.
+     */
+    std::optional<std::span<const std::byte>> getBlobBytes(unsigned index) const;
+
+    std::optional<std::span<const std::byte>> getBlobBytes(std::string_view name) const {
+        return getBlobBytes(resolveIndex(name));
+    }
+
+    /// Arena holding this row's bytes, or null for a row with its own buffer
+    const std::shared_ptr<ResultArena>& arena() const noexcept { return arena_; }
 
 private:
     unsigned resolveIndex(std::string_view name) const {
-        auto idx = meta_->getIndex(std::string(name));
-        if (!idx) {
-            throw FirebirdException(
-                std::string("Column not found: '") + std::string(name) + "'");
-        }
-        return *idx;
+        return ColumnRef::resolve(*meta_, name).index();
     }
 
+    void captureTransaction(Transaction* tx, RowOwnership ownership);
+
     std::shared_ptr<const MessageMetadata> meta_;
-    std::vector<uint8_t> buf_;
+    const uint8_t* data_ = nullptr;           // buf_ or a block of arena_
+    std::vector<uint8_t> buf_;                // Empty for arena-backed rows
+    mutable std::shared_ptr<ResultArena> arena_;   // Shared by the rows of one result set
+    // Owning, or non-owning (empty control block) for RowOwnership::borrowed
     std::shared_ptr<Transaction> tx_;
 };
 
@@ -0,0 +1,204 @@
+#pragma once
+
+// RowSink — one interface for everything that consumes fetched rows.
+//
+// A sink receives the cursor's output metadata once, then blocks of raw
+// messages as they are fetched, then an end call:
+//
+//   struct CountingSink {
+//       std::size_t rows = 0;
+//       void begin(const MessageMetadata&) {}
+//       void consume(const MessageBlock& block) { rows += block.rows; }
+//       void end() {}
+//   };
+//
+//   CountingSink sink;
+//   cursor->writeTo(sink, {.blockRows = 1024, .workers = 1});
+//
+// ResultSet::writeTo() (result_set_sink.hpp) is the engine: it fetches
+// through the prefetch window into a bounded set of message blocks and
+// hands them to the sink, on the calling thread or on worker threads while
+// the next blocks are fetched. When all blocks are waiting for the sink the
+// fetch waits too, so a slow sink bounds memory instead of growing a queue.
+//
+// consume() calls never overlap unless the sink declares
+// `static constexpr bool concurrent = true`; they then run on every worker
+// at once (decode in parallel) and MessageBlock::seq gives the fetch order.
+//
+// Adapters below drive the existing writers (JSON, CSV, snapshot), decode
+// blocks into T, or call a function per RowView.
+
+#include "fbpp/core/csv_stream_writer.hpp"
+#include "fbpp/core/json_stream_writer.hpp"
+#include "fbpp/core/message_metadata.hpp"
+#include "fbpp/core/pack_utils.hpp"
+#include "fbpp/core/result_snapshot.hpp"
+#include "fbpp/core/row.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fbpp::core {
+
+class Transaction;
+
+/**
+ * @brief Fetched messages handed to RowSink::consume()
+ *
+ * Valid during the call only: the engine reuses the storage for later
+ * blocks. Messages are `stride` bytes apart and aligned for typed reads.
+ */
+struct MessageBlock {
+    const uint8_t* data = nullptr;
+    std::size_t rows = 0;
+    std::size_t stride = 0;
+    std::size_t seq = 0;        // Block number in fetch order, from 0
+    std::size_t firstRow = 0;   // Position of the block's first row in the result, from 0
+    std::shared_ptr<const MessageMetadata> metadata;
+    Transaction* transaction = nullptr;   // For BLOB columns
+
+    const uint8_t* message(std::size_t row) const noexcept { return data + row * stride; }
+
+    /// Named access to one message (shares the metadata: one reference per view)
+    RowView view(std::size_t row) const { return RowView(metadata, message(row), transaction); }
+};
+
+template<typename S>
+concept RowSink = requires(S& sink, const MessageMetadata& metadata, const MessageBlock& block) {
+    sink.begin(metadata);
+    sink.consume(block);
+    sink.end();
+};
+
+// A sink whose consume() may run on several threads at once
+template<typename S>
+inline constexpr bool row_sink_concurrent_v = [] {
+    if constexpr (requires { S::concurrent; }) {
+        return static_cast<bool>(S::concurrent);
+    } else {
+        return false;
+    }
+}();
+
+/**
+ * @brief Tuning of ResultSet::writeTo()
+ */
+struct RowSinkOptions {
+    std::size_t blockRows = 256;       // Messages per block
+    std::size_t maxRows = 0;           // Stop after this many rows (0 = all)
+    unsigned workers = 0;              // Sink tasks at once; 0 = consume on the calling thread.
+                                       // A non-concurrent sink uses at most one.
+    std::size_t maxBlocksInFlight = 0; // Fetched but unconsumed blocks; 0 = 2 * workers
+};
+
+/// Rows into a JsonStreamWriter; the caller still calls writer.finish()
+class JsonRowSink {
+public:
+    explicit JsonRowSink(JsonStreamWriter& writer) noexcept : writer_(writer) {}
+
+    void begin(const MessageMetadata&) {}
+    void consume(const MessageBlock& block) {
+        for (std::size_t r = 0; r < block.rows; ++r) {
+            writer_.writeRow(block.message(r), *block.metadata, block.transaction);
+        }
+    }
+    void end() {}
+
+private:
+    JsonStreamWriter& writer_;
+};
+
+/// Rows into a CsvStreamWriter; writes the header even for no rows
+class CsvRowSink {
+public:
+    explicit CsvRowSink(CsvStreamWriter& writer) noexcept : writer_(writer) {}
+
+    void begin(const MessageMetadata& metadata) { writer_.writeHeader(metadata); }
+    void consume(const MessageBlock& block) {
+        for (std::size_t r = 0; r < block.rows; ++r) {
+            writer_.writeRow(block.message(r), *block.metadata, block.transaction);
+        }
+    }
+    void end() {}
+
+private:
+    CsvStreamWriter& writer_;
+};
+
+/// Raw messages into a ResultSnapshotWriter
+class SnapshotRowSink {
+public:
+    explicit SnapshotRowSink(ResultSnapshotWriter& writer) noexcept : writer_(writer) {}
+
+    void begin(const MessageMetadata&) {}
+    void consume(const MessageBlock& block) {
+        for (std::size_t r = 0; r < block.rows; ++r) {
+            writer_.writeRow(block.message(r));
+        }
+    }
+    void end() {}
+
+private:
+    ResultSnapshotWriter& writer_;
+};
+
+/**
+ * @brief Decodes each block into T and passes `f(std::vector<T>&)` the rows
+ *
+ * The vector is reused across blocks (unpackInto(): strings keep their
+ * capacity); `f` may move rows out. With RowSinkOptions::workers the
+ * decode runs off the fetching thread.
+ */
+template<typename T, typename F>
+class DecodeRowSink {
+public:
+    explicit DecodeRowSink(F f) : f_(std::move(f)) {}
+
+    void begin(const MessageMetadata&) {}
+    void consume(const MessageBlock& block) {
+        rows_.resize(block.rows);
+        for (std::size_t r = 0; r < block.rows; ++r) {
+            unpackInto(block.message(r), block.metadata.get(), rows_[r], block.transaction);
+        }
+        f_(rows_);
+    }
+    void end() {}
+
+private:
+    F f_;
+    std::vector<T> rows_;
+};
+
+template<typename T, typename F>
+DecodeRowSink<T, std::decay_t<F>> decodeSink(F&& f) {
+    return DecodeRowSink<T, std::decay_t<F>>(std::forward<F>(f));
+}
+
+/// Calls `f(const RowView&)` per row; the view is valid during the call
+template<typename F>
+class RowViewSink {
+public:
+    explicit RowViewSink(F f) : f_(std::move(f)) {}
+
+    void begin(const MessageMetadata&) {}
+    void consume(const MessageBlock& block) {
+        for (std::size_t r = 0; r < block.rows; ++r) {
+            f_(block.view(r));
+        }
+    }
+    void end() {}
+
+private:
+    F f_;
+};
+
+template<typename F>
+RowViewSink<std::decay_t<F>> rowViewSink(F&& f) {
+    return RowViewSink<std::decay_t<F>>(std::forward<F>(f));
+}
+
+} // namespace fbpp::core
@@ -0,0 +1,267 @@
+#pragma once
+
+// RowStore — in-memory result set in a compact row encoding.
+//
+// A raw Firebird message reserves the declared size of every column: a
+// VARCHAR(255) holding "ok" still takes 257 bytes plus a 2-byte null
+// indicator. RowStore re-encodes each fetched message as
+//
+//   [null bitmap][fixed-width slots][variable-length area]
+//
+//   null bitmap   one bit per column
+//   fixed slots   the column's message bytes for numeric / date / time /
+//                 BLOB id columns; a 4-byte end offset into the
+//                 variable area for CHAR / VARCHAR (a NULL column keeps
+//                 its slot, zeroed)
+//   variable area CHAR contents without the trailing pad, VARCHAR
+//                 contents without the length prefix
+//
+// Encoded rows are allocated back to back from a ResultArena, and an index
+// of row pointers gives random access. sort() / sortBy() permute the index
+// only; filter() returns a store that shares the encoded rows.
+//
+//   RowStore store = RowStore::fromResultSet(*cursor);
+//   store.sortBy(store.column("NAME"));
+//   auto big = store.filter([](const RowView& r) { return r.get<int64_t>(2) > 1000; });
+//   for (std::size_t i = 0; i < big.size(); ++i) {
+//       RowView row = big.view(i);            // valid until the next view()
+//       ...
+//   }
+//
+// view() expands one row back into message layout in a scratch buffer and
+// returns an ordinary RowView, so every get<T>() the cursor supports works
+// here too; get<T>() / getView() / isNull() on the store itself expand or
+// read a single column instead. BLOB columns keep their ids: reading them
+// needs the transaction the store was filled from, which the store holds.
+//
+// RowStoreIndex (row_store_index.hpp) adds hash lookups and joins on one
+// column; RowSorter (row_store_sort.hpp) multi-key parallel sorts and k-way
+// merges of sorted stores; RowStoreView (row_store_view.hpp) filtered,
+// sorted windows that leave the store as it is.
+//
+// For results larger than memory, spillTo() caps the encoded rows kept on
+// the heap; past the budget the arena takes its blocks from a temporary
+// file and drops each filled one from the resident set (see
+// ResultArena::spillTo). Rows stay where they were written, so view(),
+// sorting and scans work unchanged; only the row index (one pointer per
+// row) and the scratch buffers stay in memory.
+//
+//   RowStore store(cursor->getSharedMetadata(), cursor->getTransaction());
+//   store.spillTo(256 * 1024 * 1024);
+//   store.append(*cursor);
+//
+// Not thread-safe, including const access (the scratch buffer is shared).
+
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/message_metadata.hpp"
+#include "fbpp/core/result_arena.hpp"
+#include "fbpp/core/row.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace fbpp {
+namespace core {
+
+class ResultSet;
+class RowStoreIndex;
+class RowSorter;
+class RowStoreView;
+class Transaction;
+
+class RowStore {
+public:
+    /// Empty store without columns
+    RowStore() = default;
+
+    /// Empty store for messages laid out as `metadata`
+    explicit RowStore(std::shared_ptr<const MessageMetadata> metadata,
+                      std::shared_ptr<Transaction> transaction = nullptr,
+                      std::shared_ptr<ResultArena> arena = nullptr);
+
+    /// Store filled with the remaining rows of `resultSet`
+    static RowStore fromResultSet(ResultSet& resultSet, std::size_t maxRows = 0);
+
+    RowStore(RowStore&&) noexcept = default;
+    RowStore& operator=(RowStore&&) noexcept = default;
+    RowStore(const RowStore&) = delete;
+    RowStore& operator=(const RowStore&) = delete;
+
+    /**
+     * @brief Spill rows appended from now on to disk past `memoryBudget` bytes
+     *
+     * Applies to the store's arena, and with it to every store sharing it.
+     */
+    void spillTo(std::size_t memoryBudget, std::string directory = {}) {
+        arena_->spillTo(memoryBudget, std::move(directory));
+    }
+
+    /// Encode one message (metadata() layout) as the last row
+    void append(const uint8_t* message);
+
+    /**
+     * @brief Append the remaining rows of `resultSet`
+     * @param maxRows Stop after this many rows (0 = all)
+     * @return Number of rows appended
+     * @throws FirebirdException if the cursor's columns differ from the store's
+     */
+    std::size_t append(ResultSet& resultSet, std::size_t maxRows = 0);
+
+    std::size_t size() const noexcept { return rows_.size(); }
+    bool empty() const noexcept { return rows_.empty(); }
+
+    const MessageMetadata& metadata() const { return *meta_; }
+    std::shared_ptr<const MessageMetadata> sharedMetadata() const noexcept { return meta_; }
+    Transaction* transaction() const noexcept { return tx_.get(); }
+    unsigned columnCount() const noexcept { return static_cast<unsigned>(columns_.size()); }
+
+    /// Resolve a column name once (same rules as ResultSet::column)
+    unsigned column(std::string_view name) const {
+        return ColumnRef::resolve(*meta_, name).index();
+    }
+
+    bool isNull(std::size_t row, unsigned column) const {
+        const uint8_t* r = encoded(row);
+        checkColumn(column);
+        return (r[column >> 3] >> (column & 7)) & 1;
+    }
+
+    /// CHAR (trimmed) / VARCHAR contents without copying; valid while the store lives
+    std::optional<std::string_view> getView(std::size_t row, unsigned column) const;
+
+    /// Decode one column, as RowView::get<T>()
+    template<typename T>
+    std::optional<T> get(std::size_t row, unsigned column) const {
+        expandColumn(row, column);
+        return RowView(meta_, scratch_.data(), tx_.get()).get<T>(column);
+    }
+
+    template<typename T>
+    std::optional<T> get(std::size_t row, std::string_view name) const {
+        return get<T>(row, this->column(name));
+    }
+
+    /// Row `row` expanded to message layout; valid until the next view() / get()
+    RowView view(std::size_t row) const;
+
+    /// Expand row `row` into `message` (metadata().getMessageLength() bytes)
+    void expand(std::size_t row, uint8_t* message) const;
+
+    /// Owning Row for row `row` (shares the store's transaction)
+    Row toRow(std::size_t row) const;
+
+    /**
+     * @brief Stable sort by one column, NULLs first when ascending
+     *
+     * Compares encoded values directly: integers (scaled ones included),
+     * FLOAT / DOUBLE, BOOLEAN, DATE, TIME, TIMESTAMP, INT128, and
+     * CHAR / VARCHAR by bytes (no collation).
+     * @throws FirebirdException for other column types; use sort()
+     */
+    void sortBy(unsigned column, bool descending = false);
+
+    /// Stable sort with a comparator over two expanded rows
+    template<typename Less>
+    void sort(Less less) {
+        std::vector<uint8_t> other(messageLength_);
+        ++revision_;
+        std::stable_sort(rows_.begin(), rows_.end(), [&](const uint8_t* a, const uint8_t* b) {
+            expandEncoded(a, scratch_.data());
+            expandEncoded(b, other.data());
+            return less(RowView(meta_, scratch_.data(), tx_.get()),
+                        RowView(meta_, other.data(), tx_.get()));
+        });
+    }
+
+    /// Rows for which `predicate(const RowView&)` holds; shares the encoded rows
+    template<typename Predicate>
+    RowStore filter(Predicate predicate) const {
+        RowStore out = emptyCopy();
+        for (const uint8_t* r : rows_) {
+            expandEncoded(r, scratch_.data());
+            if (predicate(RowView(meta_, scratch_.data(), tx_.get()))) {
+                out.rows_.push_back(r);
+                out.encodedBytes_ += encodedSize(r);
+            }
+        }
+        return out;
+    }
+
+    /// Encoded bytes of this store's rows plus the row index
+    std::size_t bytesUsed() const noexcept;
+
+    /// Arena holding the encoded rows (shared with filtered stores)
+    const std::shared_ptr<ResultArena>& arena() const noexcept { return arena_; }
+
+private:
+    friend class RowStoreIndex;
+    friend class RowSorter;
+    friend class RowStoreView;
+
+    enum class Slot : uint8_t { Fixed, Char, Varying };
+
+    struct Column {
+        Slot kind = Slot::Fixed;
+        uint8_t pad = ' ';          // CHAR padding byte
+        unsigned offset = 0;        // Message offset of the value
+        unsigned nullOffset = 0;    // Message offset of the null indicator
+        unsigned length = 0;        // Declared length (message bytes for Fixed)
+        unsigned slot = 0;          // Encoded offset of the fixed slot
+        int previousVar = -1;       // Slot of the previous CHAR / VARCHAR, -1 = first
+        unsigned sqlType = 0;
+    };
+
+    const uint8_t* encoded(std::size_t row) const {
+        if (row >= rows_.size()) {
+            throw FirebirdException("RowStore row " + std::to_string(row) + " out of range (" +
+                                    std::to_string(rows_.size()) + " rows)");
+        }
+        return rows_[row];
+    }
+
+    // -1 / 0 / 1 for two non-NULL fixed slots
+    using SlotCompare = int (*)(const uint8_t*, const uint8_t*);
+
+    // Direct ordering of fixed slots of SQL type `sqlType`; null if none
+    static SlotCompare slotComparator(unsigned sqlType);
+
+    void checkColumn(unsigned column) const {
+        if (column >= columns_.size()) {
+            throw FirebirdException("RowStore column " + std::to_string(column) + " out of range");
+        }
+    }
+
+    // Variable-area bytes of CHAR / VARCHAR column `c` of encoded row `r`
+    std::string_view varBytes(const uint8_t* r, const Column& c) const;
+
+    // Encoded value of one column: the fixed slot or the variable bytes; empty if NULL
+    std::optional<std::string_view> valueBytes(std::size_t row, unsigned column) const;
+
+    std::size_t encodedSize(const uint8_t* r) const;
+    void expandEncoded(const uint8_t* r, uint8_t* message) const;
+    void expandColumn(std::size_t row, unsigned column) const;
+    RowStore emptyCopy() const;
+
+    std::shared_ptr<const MessageMetadata> meta_;
+    std::shared_ptr<Transaction> tx_;
+    std::shared_ptr<ResultArena> arena_;
+    std::vector<Column> columns_;
+    std::vector<const uint8_t*> rows_;
+    unsigned bitmapBytes_ = 0;
+    unsigned fixedBytes_ = 0;       // Bitmap and fixed slots
+    int lastVarSlot_ = -1;          // Slot of the last CHAR / VARCHAR, -1 = none
+    unsigned messageLength_ = 0;
+    std::size_t encodedBytes_ = 0;  // Sum over rows_ (this store's view)
+    uint64_t revision_ = 0;         // Bumped when rows_ changes (RowStoreIndex staleness)
+    mutable std::vector<uint8_t> scratch_;
+};
+
+} // namespace core
+} // namespace fbpp
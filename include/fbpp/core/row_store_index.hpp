@@ -0,0 +1,215 @@
+#pragma once
+
+// RowStoreIndex — hash index on one RowStore column, and hash joins.
+//
+// Joining two materialized results client side (two databases, or a query
+// result against cached reference data) otherwise means decoding every key
+// into an std::unordered_map<std::string, Row>. The index hashes the
+// column's encoded bytes where they lie in the store instead: an
+// open-addressing table of distinct keys, each heading a chain of the rows
+// that carry it (in row order). Lookups return row numbers of the store.
+//
+//   RowStore customers = RowStore::fromResultSet(*refCursor);
+//   RowStoreIndex byId(customers, customers.column("ID"));
+//   RowStore orders = RowStore::fromResultSet(*orderCursor);
+//   hashJoin(orders, orders.column("CUSTOMER_ID"), byId,
+//            [&](std::size_t order, std::size_t customer) {
+//                if (customer == RowStoreIndex::npos) return;   // JoinKind::left only
+//                ... customers.getView(customer, nameColumn) ...
+//            }, JoinKind::left);
+//
+// Key columns:
+//   SMALLINT / INTEGER / BIGINT / INT128   by value, widened, so they join
+//                                          each other; scales must match
+//   CHAR (trimmed) / VARCHAR               by bytes: no collation, no
+//                                          character set conversion
+//   BOOLEAN / DATE / TIME / TIMESTAMP      by value, same type only
+// FLOAT / DOUBLE, DECFLOAT, the WITH TIME ZONE types and BLOB have no
+// canonical bytes and are rejected. NULL keys are not indexed and never
+// match, as in SQL.
+//
+// The index refers to the store by address and to its rows by position:
+// keep the store alive and in place. append() and sort() / sortBy() on the
+// store make the index stale; using a stale index throws. Rebuild it then.
+
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/row_store.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace fbpp {
+namespace core {
+
+class RowStoreIndex {
+public:
+    /// Build row of an unmatched probe row in a JoinKind::left join
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    /**
+     * @brief Index column `column` of `store` as it is now
+     * @throws FirebirdException for a column type without canonical bytes
+     */
+    RowStoreIndex(const RowStore& store, unsigned column);
+    RowStoreIndex(const RowStore& store, std::string_view column)
+        : RowStoreIndex(store, store.column(column)) {}
+
+    /// Rows of the indexed store carrying one key, in row order
+    class Matches {
+    public:
+        class iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::size_t;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = std::size_t;
+
+            iterator() = default;
+            std::size_t operator*() const noexcept { return at_ - 1; }
+            iterator& operator++() noexcept {
+                at_ = next_[at_ - 1];
+                return *this;
+            }
+            iterator operator++(int) noexcept {
+                iterator old = *this;
+                ++*this;
+                return old;
+            }
+            bool operator==(const iterator& other) const noexcept { return at_ == other.at_; }
+
+        private:
+            friend class Matches;
+            iterator(const uint32_t* next, uint32_t at) noexcept : next_(next), at_(at) {}
+
+            const uint32_t* next_ = nullptr;
+            uint32_t at_ = 0;   // Row + 1, 0 = end
+        };
+
+        iterator begin() const noexcept { return iterator(next_, head_); }
+        iterator end() const noexcept { return iterator(next_, 0); }
+        bool empty() const noexcept { return head_ == 0; }
+        /// First matching row; only when !empty()
+        std::size_t front() const noexcept { return head_ - 1; }
+        std::size_t count() const noexcept {
+            return static_cast<std::size_t>(std::distance(begin(), end()));
+        }
+
+    private:
+        friend class RowStoreIndex;
+        Matches(const uint32_t* next, uint32_t head) noexcept : next_(next), head_(head) {}
+
+        const uint32_t* next_ = nullptr;
+        uint32_t head_ = 0;
+    };
+
+    /// Integer key column: `key` is the unscaled value (NUMERIC(12,2) 1.25 -> 125)
+    Matches find(int64_t key) const;
+
+    /// CHAR / VARCHAR key column; compare CHAR keys without the trailing pad
+    Matches find(std::string_view key) const;
+
+    /**
+     * @brief Rows matching the key in column `column` of row `row` of `other`
+     * @throws FirebirdException if that column cannot join the indexed one
+     */
+    Matches find(const RowStore& other, std::size_t row, unsigned column) const;
+
+    /// True when `other`'s column `column` can be looked up in this index
+    bool joinable(const RowStore& other, unsigned column) const;
+
+    const RowStore& store() const noexcept { return *store_; }
+    unsigned column() const noexcept { return column_; }
+    std::size_t keys() const noexcept { return keys_; }     // Distinct keys
+    std::size_t rows() const noexcept { return rows_; }     // Rows with a non-NULL key
+
+    /// The store changed since the index was built
+    bool stale() const noexcept { return store_->revision_ != revision_; }
+
+    std::size_t bytesUsed() const noexcept {
+        return slots_.capacity() * sizeof(Slot) + next_.capacity() * sizeof(uint32_t);
+    }
+
+private:
+    enum class KeyClass : uint8_t { Integer, Text, Value };
+
+    struct KeyType {
+        KeyClass keyClass = KeyClass::Value;
+        unsigned sqlType = 0;
+        int scale = 0;
+    };
+
+    // Canonical key bytes: in `buffer` for integers, in the store otherwise
+    struct Key {
+        const uint8_t* data = nullptr;
+        std::size_t size = 0;
+        uint64_t buffer[2] = {};
+    };
+
+    struct Slot {
+        uint32_t tag = 0;    // High hash bits
+        uint32_t head = 0;   // First row + 1, 0 = empty
+        uint32_t tail = 0;   // Last row + 1
+    };
+
+    static KeyType keyType(const RowStore& store, unsigned column);
+    static bool keyOf(const RowStore& store, std::size_t row, unsigned column,
+                      const KeyType& type, Key& key);
+    void checkFresh() const;
+    Matches lookup(const Key& key) const;
+
+    const RowStore* store_ = nullptr;
+    unsigned column_ = 0;
+    KeyType type_;
+    uint64_t revision_ = 0;
+    std::vector<Slot> slots_;        // Power of two, at most half full
+    std::vector<uint32_t> next_;     // Per row: next row + 1 with the same key, 0 = last
+    std::size_t keys_ = 0;
+    std::size_t rows_ = 0;
+};
+
+enum class JoinKind {
+    inner,   // Probe rows with a match, once per matching build row
+    left     // Also unmatched probe rows, with RowStoreIndex::npos
+};
+
+/**
+ * @brief Hash join `probe` against the store indexed by `build`
+ *
+ * Calls `onMatch(probeRow, buildRow)` per output pair, in probe row order.
+ * @return Number of calls
+ * @throws FirebirdException if the two key columns cannot join
+ */
+template<typename F>
+std::size_t hashJoin(const RowStore& probe, unsigned probeColumn, const RowStoreIndex& build,
+                     F&& onMatch, JoinKind kind = JoinKind::inner) {
+    if (!build.joinable(probe, probeColumn)) {
+        throw FirebirdException("hashJoin: probe column " + std::to_string(probeColumn) +
+                                " cannot join the indexed column " +
+                                std::to_string(build.column()));
+    }
+    std::size_t calls = 0;
+    for (std::size_t row = 0; row < probe.size(); ++row) {
+        const RowStoreIndex::Matches matches = build.find(probe, row, probeColumn);
+        if (matches.empty()) {
+            if (kind == JoinKind::left) {
+                onMatch(row, RowStoreIndex::npos);
+                ++calls;
+            }
+            continue;
+        }
+        for (std::size_t match : matches) {
+            onMatch(row, match);
+            ++calls;
+        }
+    }
+    return calls;
+}
+
+} // namespace core
+} // namespace fbpp
@@ -0,0 +1,127 @@
+#pragma once
+
+// RowSorter — multi-key sort and k-way merge of RowStores on encoded bytes.
+//
+// RowStore::sortBy() orders by one column; sort() with a comparator expands
+// both rows into message layout for every comparison. RowSorter compares
+// the encoded column values where they lie in the store, key after key, the
+// way sortBy() compares one:
+//
+//   RowSorter sorter({{store.column("REGION")},
+//                     {store.column("NAME"), false, NullOrder::Last, true},
+//                     {store.column("TOTAL"), true}});
+//   sorter.sort(store);                          // runs in parallel, then merged
+//   RowStore all = sorter.merge({&shard0, &shard1, &shard2});
+//
+// sort() cuts the row index into runs of runRows rows, sorts the runs on
+// Executor::shared() (at most `threads` at once) and merges them with a
+// k-way heap merge; only the row index is permuted, as with sortBy(). The
+// comparisons read the encoded rows only, so a store spilled to disk
+// (RowStore::spillTo) sorts the same way while its rows stay in the mapped
+// file.
+//
+// merge() takes stores each already ordered by the keys (e.g. one per
+// shard, or runs sorted separately) and copies their encoded rows, in
+// merged order, into one new store; its arena can be spilling. The stores
+// must have the same columns.
+//
+// Key columns are compared as sortBy() compares them: integers (scaled ones
+// included), FLOAT / DOUBLE, BOOLEAN, DATE, TIME, TIMESTAMP, and INT128 by
+// value, CHAR (trimmed) / VARCHAR by bytes. caseInsensitive folds ASCII
+// letters only: the client has no collation tables, so accented letters and
+// other character sets still compare by bytes. Both sort() and merge() are
+// stable: ties keep row order, and in merge() the order of the inputs.
+
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/result_arena.hpp"
+#include "fbpp/core/row_store.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace fbpp {
+namespace core {
+
+enum class NullOrder {
+    Default,   // First ascending, last descending (as Firebird's ORDER BY)
+    First,
+    Last
+};
+
+struct SortKey {
+    unsigned column = 0;
+    bool descending = false;
+    NullOrder nulls = NullOrder::Default;
+    bool caseInsensitive = false;   // CHAR / VARCHAR: ASCII letters compare folded
+};
+
+struct RowSortOptions {
+    std::size_t runRows = 64 * 1024;   // Rows per sorted run
+    unsigned threads = 0;              // Runs sorted at once; 0 = the shared executor's width
+};
+
+class RowSorter {
+public:
+    explicit RowSorter(std::vector<SortKey> keys, RowSortOptions options = {});
+    RowSorter(std::initializer_list<SortKey> keys, RowSortOptions options = {})
+        : RowSorter(std::vector<SortKey>(keys), options) {}
+
+    const std::vector<SortKey>& keys() const noexcept { return keys_; }
+
+    /**
+     * @brief Stable sort of `store`'s rows by the keys
+     * @return Number of runs merged (1 when the store fit in one run)
+     * @throws FirebirdException for a key column without a direct ordering
+     */
+    std::size_t sort(RowStore& store) const;
+
+    /**
+     * @brief Stable sort of row numbers of `store` by the keys
+     *
+     * Leaves the store's own order alone (RowStoreView orders its
+     * selection this way). Runs on the calling thread.
+     * @throws FirebirdException for a key column without a direct ordering,
+     *         or a row number out of range
+     */
+    void sortRows(const RowStore& store, std::span<std::size_t> rows) const;
+
+    /**
+     * @brief Merge stores each already sorted by the keys into one store
+     *
+     * The result shares the first store's metadata and transaction; its
+     * rows are copies in `arena` (a new one when null).
+     * @throws FirebirdException if the stores' columns differ
+     */
+    RowStore merge(std::span<const RowStore* const> sorted,
+                   std::shared_ptr<ResultArena> arena = nullptr) const;
+
+    RowStore merge(std::initializer_list<const RowStore*> sorted,
+                   std::shared_ptr<ResultArena> arena = nullptr) const {
+        return merge(std::span<const RowStore* const>(sorted.begin(), sorted.size()),
+                     std::move(arena));
+    }
+
+    /// -1 / 0 / 1 comparing row `a` of `left` with row `b` of `right`
+    int compare(const RowStore& left, std::size_t a, const RowStore& right,
+                std::size_t b) const;
+
+private:
+    struct CompiledKey;
+
+    // Keys resolved against `store`'s layout
+    std::vector<CompiledKey> compile(const RowStore& store) const;
+    static int compareRows(const RowStore& store, const std::vector<CompiledKey>& keys,
+                           const uint8_t* a, const uint8_t* b);
+    static void checkSameColumns(const RowStore& first, const RowStore& other);
+
+    std::vector<SortKey> keys_;
+    RowSortOptions options_;
+};
+
+} // namespace core
+} // namespace fbpp
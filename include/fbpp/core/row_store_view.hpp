@@ -0,0 +1,164 @@
+#pragma once
+
+// RowStoreView — filtered, sorted window over a RowStore.
+//
+// A grid over a loaded result asks for "rows 2000..2049 of those whose NAME
+// contains 'ab' and whose REGION is 'EU', by TOTAL descending", again on
+// every key stroke. Refiltering a RowStore with filter() copies the row
+// index and expands every row for the predicate; RowStoreView keeps a list
+// of store row numbers instead and reads the encoded values in place:
+//
+//   RowStoreView view(store);
+//   view.addIndex(store.column("REGION"));
+//   view.orderBy({{store.column("TOTAL"), true}});
+//   view.whereEquals(store.column("REGION"), "EU");
+//   view.whereText(store.column("NAME"), "ab");
+//   for (std::size_t row : view.window(2000, 50)) {
+//       ... store.getView(row, nameColumn) ...
+//   }
+//   view.clearFilters();                     // Every row again, still sorted
+//
+// orderBy() sorts the row numbers once (RowSorter keys, compared on the
+// encoded bytes) and keeps each row's rank; filters narrow the selection in
+// that order, so a new filter never re-sorts. An equality filter on a
+// column given to addIndex() looks its rows up in a RowStoreIndex: the
+// first filter after clearFilters() then costs its matches, not a scan.
+//
+// Filters combine with AND; whereText() matches CHAR (trimmed) / VARCHAR
+// bytes, folding ASCII letters only, as RowSorter does. The store itself is
+// not modified, so indexes on it stay fresh. append() or sort() on the
+// store make the view stale, and using a stale view throws: rebuild it.
+//
+// Not thread-safe.
+
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/row_store.hpp"
+#include "fbpp/core/row_store_index.hpp"
+#include "fbpp/core/row_store_sort.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fbpp {
+namespace core {
+
+enum class TextMatch {
+    Contains,
+    Prefix,
+    Exact
+};
+
+class RowStoreView {
+public:
+    /// Every row of `store`, in store order; keep the store alive and in place
+    explicit RowStoreView(const RowStore& store);
+
+    /**
+     * @brief Index `column` for whereEquals()
+     * @throws FirebirdException for a column RowStoreIndex cannot key
+     */
+    void addIndex(unsigned column);
+    bool indexed(unsigned column) const noexcept;
+
+    /**
+     * @brief Order the view by `keys`; empty keys restore store order
+     *
+     * The current filters are kept.
+     * @throws FirebirdException for a key column without a direct ordering
+     */
+    void orderBy(std::vector<SortKey> keys);
+    const std::vector<SortKey>& keys() const noexcept { return keys_; }
+
+    /**
+     * @brief Keep rows whose `column` equals `key`
+     *
+     * Integer columns take the unscaled value (NUMERIC(12,2) 1.25 -> 125),
+     * CHAR / VARCHAR the text without trailing pad. NULLs never match.
+     * @throws FirebirdException for other column types
+     */
+    void whereEquals(unsigned column, int64_t key);
+    void whereEquals(unsigned column, std::string_view key);
+
+    /**
+     * @brief Keep rows whose CHAR / VARCHAR `column` matches `text`
+     * @throws FirebirdException for other column types
+     */
+    void whereText(unsigned column, std::string_view text, TextMatch match = TextMatch::Contains,
+                   bool caseInsensitive = true);
+
+    /// Keep rows for which `predicate(store, row)` holds
+    template<typename Predicate>
+    void where(Predicate predicate) {
+        checkFresh();
+        keep([&](std::size_t row) { return predicate(*store_, row); });
+    }
+
+    /// Every row again, in the current order
+    void clearFilters();
+    bool filtered() const noexcept { return filtered_; }
+
+    /// Rows in the view
+    std::size_t size() const noexcept { return selection_.size(); }
+    bool empty() const noexcept { return selection_.empty(); }
+
+    /// Store row at `position` of the view
+    std::size_t row(std::size_t position) const {
+        if (position >= selection_.size()) {
+            throw FirebirdException("RowStoreView position " + std::to_string(position) +
+                                    " out of range (" + std::to_string(selection_.size()) +
+                                    " rows)");
+        }
+        return selection_[position];
+    }
+
+    /// Store rows at positions [first, first + count), clipped to the view
+    std::span<const std::size_t> window(std::size_t first, std::size_t count) const noexcept {
+        if (first >= selection_.size()) {
+            return {};
+        }
+        return std::span<const std::size_t>(selection_).subspan(
+            first, std::min(count, selection_.size() - first));
+    }
+
+    const RowStore& store() const noexcept { return *store_; }
+
+    /// The store was appended to or re-sorted since the view was built
+    bool stale() const noexcept { return store_->revision_ != revision_; }
+
+private:
+    void checkFresh() const;
+    const RowStoreIndex* indexFor(unsigned column) const noexcept;
+    // Narrow the selection to rows for which `test(row)` holds
+    template<typename Test>
+    void keep(Test test) {
+        std::size_t kept = 0;
+        for (std::size_t row : selection_) {
+            if (test(row)) {
+                selection_[kept++] = row;
+            }
+        }
+        selection_.resize(kept);
+        filtered_ = true;
+    }
+    // Narrow the selection to the rows of an index lookup
+    void keepMatches(const RowStoreIndex::Matches& matches);
+    // Every store row, in the current order
+    void selectAll();
+
+    const RowStore* store_;
+    uint64_t revision_;
+    std::vector<RowStoreIndex> indexes_;
+    std::vector<SortKey> keys_;
+    std::vector<std::size_t> order_;       // Rows by keys_; empty = store order
+    std::vector<std::size_t> rank_;        // Per row: its position in order_
+    std::vector<std::size_t> selection_;   // Rows in the view, in order
+    bool filtered_ = false;
+};
+
+} // namespace core
+} // namespace fbpp
@@ -0,0 +1,136 @@
+#pragma once
+
+// Powers of ten and batch scaling for NUMERIC / DECIMAL values.
+//
+// Firebird stores NUMERIC(p,s) as a SMALLINT / INTEGER / BIGINT / INT128
+// holding value * 10^s. Per-cell conversions used to rebuild the factor
+// every time (a multiply loop for the integer factor, std::pow for the
+// double divisor). The tables below hold every factor an int64 can take
+// and every power of ten a double represents exactly, and the kernels
+// apply one factor across a whole array: an exact integer rescale for
+// fixed-point aggregation, and a division loop the compiler vectorizes
+// for double output.
+
+#include "fbpp/core/exception.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+namespace fbpp {
+namespace core {
+
+/// Largest n with 10^n representable in int64_t
+inline constexpr int kMaxInt64Pow10 = 18;
+
+/// 10^0 .. 10^18
+inline constexpr std::array<int64_t, kMaxInt64Pow10 + 1> kPow10Int64 = [] {
+    std::array<int64_t, kMaxInt64Pow10 + 1> table{};
+    int64_t value = 1;
+    for (auto& entry : table) {
+        entry = value;
+        value = value < std::numeric_limits<int64_t>::max() / 10 ? value * 10 : value;
+    }
+    return table;
+}();
+
+/// 10^0 .. 10^22: every power of ten a double holds exactly
+inline constexpr std::array<double, 23> kPow10Double = [] {
+    std::array<double, 23> table{};
+    double value = 1.0;
+    for (auto& entry : table) {
+        entry = value;
+        value *= 10.0;
+    }
+    return table;
+}();
+
+/// 10^n for n in [0, 18]
+constexpr int64_t pow10Int64(int n) noexcept {
+    return kPow10Int64[static_cast<std::size_t>(n)];
+}
+
+/// 10^n as a double; exact for n in [0, 22]
+inline double pow10Double(int n) noexcept {
+    if (n >= 0 && n < static_cast<int>(kPow10Double.size())) {
+        return kPow10Double[static_cast<std::size_t>(n)];
+    }
+    return std::pow(10.0, n);
+}
+
+/**
+ * @brief `raw * 10^scale` as a double
+ *
+ * A negative scale divides by the exact factor, so the result is the
+ * correctly rounded quotient (0.1 for raw 1 at scale -1, not 1 * 0.1).
+ */
+inline double scaledToDouble(int64_t raw, int scale) noexcept {
+    if (scale < 0) {
+        return static_cast<double>(raw) / pow10Double(-scale);
+    }
+    return static_cast<double>(raw) * pow10Double(scale);
+}
+
+/// scaledToDouble() over `count` values
+template<typename Raw>
+inline void scaledToDouble(const Raw* raw, std::size_t count, int scale, double* out) noexcept {
+    const double factor = pow10Double(scale < 0 ? -scale : scale);
+    if (scale < 0) {
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = static_cast<double>(raw[i]) / factor;
+        }
+    } else {
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = static_cast<double>(raw[i]) * factor;
+        }
+    }
+}
+
+/**
+ * @brief Bring `count` raw values from `fromScale` to `toScale` exactly
+ *
+ * Raising the precision (toScale < fromScale) multiplies and throws
+ * FirebirdException if a value leaves int64 range; lowering it divides,
+ * rounding half away from zero as Firebird does. Lets columns of
+ * different NUMERIC scales be summed as int64 at one common scale.
+ * `out` may alias `raw` when Raw is int64_t.
+ */
+template<typename Raw>
+inline void rescaleNumeric(const Raw* raw, std::size_t count, int fromScale, int toScale,
+                           int64_t* out) {
+    const int shift = fromScale - toScale;
+    if (shift > kMaxInt64Pow10 || shift < -kMaxInt64Pow10) {
+        throw FirebirdException("NUMERIC rescale by 10^" + std::to_string(shift) +
+                                " is outside int64 range");
+    }
+    if (shift >= 0) {
+        const int64_t factor = pow10Int64(shift);
+        const int64_t upper = std::numeric_limits<int64_t>::max() / factor;
+        const int64_t lower = std::numeric_limits<int64_t>::min() / factor;
+        bool overflow = false;
+        for (std::size_t i = 0; i < count; ++i) {
+            const int64_t v = static_cast<int64_t>(raw[i]);
+            overflow |= (v > upper) | (v < lower);
+            // Unsigned multiply: wraps instead of UB; the flag reports it
+            out[i] = static_cast<int64_t>(static_cast<uint64_t>(v) * static_cast<uint64_t>(factor));
+        }
+        if (overflow) {
+            throw FirebirdException("Scaled value out of range for BIGINT");
+        }
+        return;
+    }
+    const int64_t factor = pow10Int64(-shift);
+    const int64_t half = factor / 2;
+    for (std::size_t i = 0; i < count; ++i) {
+        const int64_t v = static_cast<int64_t>(raw[i]);
+        const int64_t quotient = v / factor;
+        const int64_t remainder = v % factor;
+        out[i] = quotient + (remainder >= half) - (remainder <= -half);
+    }
+}
+
+} // namespace core
+} // namespace fbpp
@@ -0,0 +1,454 @@
+#pragma once
+
+// ShardedExecutor — one query on every shard database, results merged.
+//
+// Tenants spread over N databases are queried with the same SQL on one
+// connection per shard. Each shard prepares the statement through its
+// connection's statement cache, runs it in a transaction of its own and
+// fetches all rows, all shards at once; the caller gets the rows merged:
+//
+//   ShardedExecutor shards(shardParams);                      // one Connection each
+//   auto all = shards.concat<Order>("SELECT ... WHERE day = ?", std::tuple{day});
+//   auto top = shards.mergeSorted<Order>("SELECT ... ORDER BY total DESC",
+//                                        [](const Order& a, const Order& b) {
+//                                            return a.total > b.total;
+//                                        });
+//   auto sum = shards.combine<std::tuple<int64_t>>("SELECT COUNT(*) FROM orders",
+//                                                  [](auto a, const auto& b) {
+//                                                      std::get<0>(a) += std::get<0>(b);
+//                                                      return a;
+//                                                  });
+//
+//   concat       shard 0's rows, then shard 1's, ...
+//   mergeSorted  k-way merge of rows every shard returned already ordered
+//                the way `less` orders them (ties keep shard order)
+//   combine      folds every row of every shard into one with
+//                `combine(Row acc, const Row& next)`, for partial aggregates
+//   mergeSortedStore
+//                every shard's rows fetched into a RowStore, sorted on the
+//                client by a RowSorter's keys and k-way merged into one
+//                store, encoded (see row_store_sort.hpp)
+//   aggregate    aggregate-merge mode: every column of every shard's rows
+//                folded into an exact SUM / MIN / MAX / COUNT (INT128 for
+//                NUMERIC, decimal128 for DECFLOAT; see column_aggregate.hpp)
+//
+// A failing shard does not fail the call: its error lands in
+// ShardedResult::errors and its rows are left out; rethrow() turns that
+// into an exception. ShardOptions::timeout bounds every shard with a
+// CancelScope (one deadline for the whole call), failFast cancels the
+// remaining shards after the first error. The per-shard tasks run on
+// Executor::shared(), at most its thread count at once; set
+// ShardOptions::executor to use a pool of the caller's instead (e.g. an
+// Executor sized for many slow shards).
+//
+// A shard connection must not be used elsewhere while a call is running.
+
+#include "fbpp/core/column_aggregate.hpp"
+#include "fbpp/core/column_batch.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/result_arena.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/row_store.hpp"
+#include "fbpp/core/row_store_sort.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/transaction_options.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fbpp {
+namespace core {
+
+/**
+ * @brief Bounds and executor of one ShardedExecutor call
+ */
+struct ShardOptions {
+    // Deadline of the whole call, applied to every shard (CancelScope)
+    std::optional<std::chrono::milliseconds> timeout;
+    std::stop_token stop;
+    // Cancel the shards still running once one has failed
+    bool failFast = false;
+    TransactionOptions transaction = TransactionOptions::readOnlyReadCommitted();
+    // Runs one shard's task; empty = Executor::shared()
+    std::function<void(std::function<void()>)> executor;
+};
+
+/**
+ * @brief Failure of one shard
+ */
+struct ShardError {
+    std::size_t shard = 0;
+    std::exception_ptr error;
+    bool cancelled = false;   // Timed out, stopped, or cancelled by failFast
+    std::string message;
+};
+
+/**
+ * @brief Merged rows of a ShardedExecutor call
+ */
+template<typename Row>
+struct ShardedResult {
+    std::vector<Row> rows;
+    std::vector<std::size_t> shardRows;   // Rows each shard returned (0 for failed shards)
+    std::vector<ShardError> errors;       // In shard order
+
+    bool complete() const noexcept { return errors.empty(); }
+
+    /// Rethrow the first shard's error, if any
+    void rethrow() const {
+        if (!errors.empty()) {
+            std::rethrow_exception(errors.front().error);
+        }
+    }
+};
+
+/**
+ * @brief Merged rows of a ShardedExecutor::mergeSortedStore() call
+ */
+struct ShardedRowStore {
+    RowStore rows;                        // Column-less when no shard returned a result
+    std::vector<std::size_t> shardRows;   // Rows each shard returned (0 for failed shards)
+    std::vector<ShardError> errors;       // In shard order
+
+    bool complete() const noexcept { return errors.empty(); }
+
+    /// Rethrow the first shard's error, if any
+    void rethrow() const {
+        if (!errors.empty()) {
+            std::rethrow_exception(errors.front().error);
+        }
+    }
+};
+
+/**
+ * @brief Merged aggregates of a ShardedExecutor::aggregate() call
+ */
+struct ShardedAggregate {
+    std::vector<ExactAggregate> columns;  // One per output column; empty when no shard answered
+    std::vector<std::string> names;       // Their display names
+    std::vector<std::size_t> shardRows;   // Rows each shard returned (0 for failed shards)
+    std::vector<ShardError> errors;       // In shard order
+
+    bool complete() const noexcept { return errors.empty(); }
+
+    /// Column by display name (ASCII case-insensitive), or nullptr
+    const ExactAggregate* find(std::string_view name) const noexcept {
+        for (std::size_t i = 0; i < names.size(); ++i) {
+            if (names[i].size() == name.size() &&
+                std::equal(names[i].begin(), names[i].end(), name.begin(), [](char a, char b) {
+                    return std::tolower(static_cast<unsigned char>(a)) ==
+                           std::tolower(static_cast<unsigned char>(b));
+                })) {
+                return &columns[i];
+            }
+        }
+        return nullptr;
+    }
+
+    /// Rethrow the first shard's error, if any
+    void rethrow() const {
+        if (!errors.empty()) {
+            std::rethrow_exception(errors.front().error);
+        }
+    }
+};
+
+class ShardedExecutor {
+public:
+    /// Shards on connections owned elsewhere; they must outlive the executor
+    explicit ShardedExecutor(std::vector<Connection*> shards);
+
+    /// Shards on connections of its own, opened here
+    explicit ShardedExecutor(const std::vector<ConnectionParams>& shards);
+
+    ~ShardedExecutor();
+
+    ShardedExecutor(const ShardedExecutor&) = delete;
+    ShardedExecutor& operator=(const ShardedExecutor&) = delete;
+
+    std::size_t shardCount() const noexcept { return shards_.size(); }
+    Connection& shard(std::size_t index) const;
+
+    /**
+     * @brief Run `fn(Connection&, shard)` on every shard in parallel
+     *
+     * The general fan-out behind the merging calls. Waits for every shard.
+     * @return The shards that threw, in shard order
+     */
+    std::vector<ShardError> forEach(const std::function<void(Connection&, std::size_t)>& fn,
+                                    const ShardOptions& options = {});
+
+    /// Rows of every shard, shard by shard
+    template<typename Row, typename Params = std::tuple<>>
+    ShardedResult<Row> concat(const std::string& sql, const Params& params = {},
+                              const ShardOptions& options = {}) {
+        ShardedResult<Row> result;
+        std::vector<std::vector<Row>> perShard = fetchShards<Row>(sql, params, options, result);
+        std::size_t total = 0;
+        for (const auto& rows : perShard) {
+            total += rows.size();
+        }
+        result.rows.reserve(total);
+        for (auto& rows : perShard) {
+            std::move(rows.begin(), rows.end(), std::back_inserter(result.rows));
+        }
+        return result;
+    }
+
+    /**
+     * @brief k-way merge of per-shard ordered rows
+     *
+     * Each shard's SQL must return its rows ordered as `less` orders them
+     * (ORDER BY); the merge does not sort.
+     */
+    template<typename Row, typename Less, typename Params = std::tuple<>>
+    ShardedResult<Row> mergeSorted(const std::string& sql, Less less, const Params& params = {},
+                                   const ShardOptions& options = {}) {
+        ShardedResult<Row> result;
+        std::vector<std::vector<Row>> perShard = fetchShards<Row>(sql, params, options, result);
+
+        struct Cursor {
+            std::size_t shard;
+            std::size_t next;
+        };
+        // Heap top: the smallest next row, the lower shard on ties
+        auto after = [&](const Cursor& a, const Cursor& b) {
+            const Row& x = perShard[a.shard][a.next];
+            const Row& y = perShard[b.shard][b.next];
+            if (less(y, x)) {
+                return true;
+            }
+            return !less(x, y) && a.shard > b.shard;
+        };
+        std::priority_queue<Cursor, std::vector<Cursor>, decltype(after)> heap(after);
+        std::size_t total = 0;
+        for (std::size_t s = 0; s < perShard.size(); ++s) {
+            total += perShard[s].size();
+            if (!perShard[s].empty()) {
+                heap.push(Cursor{s, 0});
+            }
+        }
+        result.rows.reserve(total);
+        while (!heap.empty()) {
+            Cursor top = heap.top();
+            heap.pop();
+            result.rows.push_back(std::move(perShard[top.shard][top.next]));
+            if (++top.next < perShard[top.shard].size()) {
+                heap.push(top);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Fold all rows into one: `combine(Row acc, const Row& next) -> Row`
+     *
+     * Rows are folded in shard order, starting from the first row; the
+     * result holds that one row, or none when no shard returned any.
+     */
+    template<typename Row, typename Combine, typename Params = std::tuple<>>
+    ShardedResult<Row> combine(const std::string& sql, Combine combine, const Params& params = {},
+                               const ShardOptions& options = {}) {
+        ShardedResult<Row> result;
+        std::vector<std::vector<Row>> perShard = fetchShards<Row>(sql, params, options, result);
+        std::optional<Row> acc;
+        for (auto& rows : perShard) {
+            for (auto& row : rows) {
+                if (!acc) {
+                    acc.emplace(std::move(row));
+                } else {
+                    acc.emplace(combine(std::move(*acc), row));
+                }
+            }
+        }
+        if (acc) {
+            result.rows.push_back(std::move(*acc));
+        }
+        return result;
+    }
+
+    /**
+     * @brief Rows of every shard in one RowStore, ordered by `sorter`'s keys
+     *
+     * Each shard's task fetches its rows into a RowStore and sorts them
+     * there with `sorter`, so the SQL needs no ORDER BY and the server's
+     * collations cannot disagree with the merge; the sorted stores are
+     * then k-way merged into one, rows copied into `arena` (a new one when
+     * null; pass a spilling arena for large results). Every shard must
+     * return the same columns. The shard transactions are committed by the
+     * time the call returns, so BLOB ids in the rows cannot be read.
+     */
+    template<typename Params = std::tuple<>>
+    ShardedRowStore mergeSortedStore(const std::string& sql, const RowSorter& sorter,
+                                     const Params& params = {}, const ShardOptions& options = {},
+                                     std::shared_ptr<ResultArena> arena = nullptr) {
+        ShardedRowStore result;
+        std::vector<RowStore> perShard(shards_.size());
+        result.errors = forEach(
+            [&](Connection& connection, std::size_t shard) {
+                auto statement = connection.prepareStatement(sql);
+                auto transaction = connection.StartTransaction(options.transaction);
+                std::unique_ptr<ResultSet> cursor;
+                if constexpr (std::is_same_v<Params, std::tuple<>>) {
+                    cursor = transaction->openCursor(statement);
+                } else {
+                    cursor = transaction->openCursor(statement, params);
+                }
+                perShard[shard] = RowStore::fromResultSet(*cursor);
+                cursor->close();
+                transaction->Commit();
+                sorter.sort(perShard[shard]);
+            },
+            options);
+        for (const ShardError& error : result.errors) {
+            perShard[error.shard] = RowStore();
+        }
+        std::vector<const RowStore*> sorted;
+        result.shardRows.resize(perShard.size());
+        for (std::size_t s = 0; s < perShard.size(); ++s) {
+            result.shardRows[s] = perShard[s].size();
+            if (perShard[s].columnCount() != 0) {
+                sorted.push_back(&perShard[s]);
+            }
+        }
+        if (!sorted.empty()) {
+            result.rows = sorter.merge(sorted, std::move(arena));
+        }
+        return result;
+    }
+
+    /**
+     * @brief Exact aggregates of every column over every shard's rows
+     *
+     * Each shard's task fetches its rows column-at-a-time (fetchColumns,
+     * `batchSize` rows per block) and folds every column into an
+     * ExactAggregate; the per-shard partials are then merged in shard
+     * order. Every column must be an integer, NUMERIC / DECIMAL or DECFLOAT
+     * column. For per-shard partial aggregates
+     *
+     *   SELECT SUM(amount), MIN(amount), MAX(amount), COUNT(*) FROM orders
+     *
+     * read sum() of the SUM and COUNT columns, min() / max() of the others.
+     * A failing shard's partial is left out, as in the other calls.
+     */
+    template<typename Params = std::tuple<>>
+    ShardedAggregate aggregate(const std::string& sql, const Params& params = {},
+                               const ShardOptions& options = {}, std::size_t batchSize = 4096) {
+        struct Partial {
+            std::vector<ExactAggregate> columns;
+            std::vector<std::string> names;
+            std::size_t rows = 0;
+            bool answered = false;
+        };
+        ShardedAggregate result;
+        std::vector<Partial> perShard(shards_.size());
+        result.errors = forEach(
+            [&](Connection& connection, std::size_t shard) {
+                auto statement = connection.prepareStatement(sql);
+                auto transaction = connection.StartTransaction(options.transaction);
+                std::unique_ptr<ResultSet> cursor;
+                if constexpr (std::is_same_v<Params, std::tuple<>>) {
+                    cursor = transaction->openCursor(statement);
+                } else {
+                    cursor = transaction->openCursor(statement, params);
+                }
+                Partial& partial = perShard[shard];
+                const auto& plan = cursor->getMetadata()->getColumnPlan();
+                partial.columns.resize(plan.size());
+                for (const ColumnPlan& column : plan) {
+                    partial.names.push_back(displayName(*column.field));
+                }
+                ColumnBatch batch;
+                while (cursor->fetchColumns(batch, batchSize)) {
+                    for (std::size_t c = 0; c < batch.columns.size(); ++c) {
+                        partial.columns[c].add(batch.columns[c]);
+                    }
+                    partial.rows += batch.rowCount;
+                }
+                cursor->close();
+                transaction->Commit();
+                partial.answered = true;
+            },
+            options);
+        for (const ShardError& error : result.errors) {
+            perShard[error.shard] = Partial();
+        }
+        result.shardRows.resize(perShard.size());
+        for (std::size_t s = 0; s < perShard.size(); ++s) {
+            Partial& partial = perShard[s];
+            result.shardRows[s] = partial.rows;
+            if (!partial.answered) {
+                continue;
+            }
+            if (result.columns.empty()) {
+                result.columns = std::move(partial.columns);
+                result.names = std::move(partial.names);
+                continue;
+            }
+            if (partial.columns.size() != result.columns.size()) {
+                throw FirebirdException("ShardedExecutor::aggregate: shard " + std::to_string(s) +
+                                        " returned " + std::to_string(partial.columns.size()) +
+                                        " columns, expected " +
+                                        std::to_string(result.columns.size()));
+            }
+            for (std::size_t c = 0; c < partial.columns.size(); ++c) {
+                result.columns[c].merge(partial.columns[c]);
+            }
+        }
+        return result;
+    }
+
+private:
+    // All rows of `sql` per shard; failed shards come back empty, with
+    // their errors and the row counts in `result`
+    template<typename Row, typename Params, typename Result>
+    std::vector<std::vector<Row>> fetchShards(const std::string& sql, const Params& params,
+                                              const ShardOptions& options, Result& result) {
+        std::vector<std::vector<Row>> perShard(shards_.size());
+        result.errors = forEach(
+            [&](Connection& connection, std::size_t shard) {
+                auto statement = connection.prepareStatement(sql);
+                auto transaction = connection.StartTransaction(options.transaction);
+                std::unique_ptr<ResultSet> cursor;
+                if constexpr (std::is_same_v<Params, std::tuple<>>) {
+                    cursor = transaction->openCursor(statement);
+                } else {
+                    cursor = transaction->openCursor(statement, params);
+                }
+                cursor->fetchAll(perShard[shard]);
+                cursor->close();
+                transaction->Commit();
+            },
+            options);
+        for (const ShardError& error : result.errors) {
+            perShard[error.shard].clear();
+        }
+        result.shardRows.resize(perShard.size());
+        for (std::size_t s = 0; s < perShard.size(); ++s) {
+            result.shardRows[s] = perShard[s].size();
+        }
+        return perShard;
+    }
+
+    std::vector<Connection*> shards_;
+    std::vector<std::unique_ptr<Connection>> owned_;
+};
+
+} // namespace core
+} // namespace fbpp
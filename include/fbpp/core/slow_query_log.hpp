@@ -0,0 +1,186 @@
+#pragma once
+
+// Sampled slow-query log, with the plan of every statement it logs.
+//
+// With a log installed, fbpp times a sample of the executes and cursors
+// in four parts: packing the parameters, the execute / open call, the
+// server fetch rounds and decoding the fetched rows. When the parts add
+// up to the threshold or more, one trace entry goes out with the SQL
+// fingerprint and text, a parameter summary (sizes only unless values are
+// asked for), the breakdown, the row count and the detailed plan
+// (Statement::getPlan(true), read from the server once per prepared
+// statement and kept by it):
+//
+//   fbpp::util::AsyncTraceSink async(fileSink);   // Written off the caller's thread
+//   fbpp::util::setTraceSink(&async);
+//
+//   SlowQueryLogOptions options;
+//   options.threshold = std::chrono::milliseconds(200);
+//   options.sampleRate = 0.1;                     // One statement in ten
+//   SlowQueryLog slowLog(options);
+//   setSlowQueryLog(&slowLog);
+//
+// A cursor is timed from open to close, but only its own work counts: the
+// time the caller spends between two fetches is not part of the total, so
+// a cursor read slowly is not a slow query. Its row count is the rows
+// served. Rows read through RowView (rows()) are decoded by the caller and
+// are not in the unpack part.
+//
+// The draw happens as the statement starts. One that is not drawn costs
+// the draw and the two clock reads around packing; without a log, each
+// site costs one atomic load. The log is process-wide like the span
+// observer: install it before fbpp is used and keep it alive until the
+// last sampled cursor is closed. Its methods are called concurrently from
+// every thread that uses fbpp.
+
+#include "fbpp/core/message_metadata.hpp"
+#include "fbpp_util/trace.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fbpp {
+namespace core {
+
+class Statement;
+
+enum class SlowQueryKind {
+    Execute,   // Statement execute (DML, DDL, EXECUTE PROCEDURE)
+    Cursor     // openCursor to ResultSet close
+};
+
+struct SlowQueryLogOptions {
+    // Statements whose timed parts add up to this or more are logged
+    std::chrono::microseconds threshold{100000};
+    // Fraction of statements timed, from 0 (none) to 1 (all)
+    double sampleRate = 1.0;
+    // Log the parameter values too, not only their sizes (may expose data)
+    bool parameterValues = false;
+    // Read the detailed plan of each logged statement
+    bool capturePlan = true;
+    fbpp::util::TraceLevel level = fbpp::util::TraceLevel::warn;
+};
+
+struct SlowQueryTimings {
+    std::chrono::steady_clock::duration pack{};      // Parameters into the input message
+    std::chrono::steady_clock::duration execute{};   // Execute or open call
+    std::chrono::steady_clock::duration fetch{};     // Server fetch rounds
+    std::chrono::steady_clock::duration unpack{};    // Fetched rows into the caller's types
+
+    std::chrono::steady_clock::duration total() const noexcept {
+        return pack + execute + fetch + unpack;
+    }
+};
+
+struct SlowQueryEntry {
+    SlowQueryKind kind = SlowQueryKind::Execute;
+    std::string_view sql;          // Empty when the statement is not known
+    uint64_t fingerprint = 0;      // SqlKey::hashOf of the text (see span_observer.hpp)
+    std::string parameters;        // "$1=4B $2=NULL" or the values; empty without any
+    SlowQueryTimings timings;
+    uint64_t rows = 0;             // Execute: affected; Cursor: served
+    bool failed = false;
+    std::string plan;              // Empty when not captured
+};
+
+struct SlowQueryLogStats {
+    uint64_t sampled = 0;   // Statements timed
+    uint64_t logged = 0;    // Of those, written as slow
+};
+
+/**
+ * @brief Writes sampled statements slower than a threshold to the trace sink
+ *
+ * write() sends one entry per slow statement to fbpp::util::trace() under
+ * the "SlowQuery" component; override it to send entries elsewhere.
+ */
+class SlowQueryLog {
+public:
+    explicit SlowQueryLog(SlowQueryLogOptions options = {});
+    virtual ~SlowQueryLog() = default;
+
+    SlowQueryLog(const SlowQueryLog&) = delete;
+    SlowQueryLog& operator=(const SlowQueryLog&) = delete;
+
+    const SlowQueryLogOptions& options() const noexcept { return options_; }
+    SlowQueryLogStats stats() const noexcept;
+
+    /// Draw whether the statement about to start is timed
+    bool sample() noexcept;
+
+    /**
+     * @brief Log a timed statement if it was slow (called by Statement and
+     *        ResultSet); never throws
+     * @param statement Source of the SQL text and plan, may be null
+     * @param inputLayout Layout of `input`; null without a parameter summary
+     */
+    void report(SlowQueryKind kind, uint64_t fingerprint, const Statement* statement,
+                const SlowQueryTimings& timings, uint64_t rows, bool failed,
+                const MessageMetadata* inputLayout, const void* input) noexcept;
+
+    /// Parameter summary of an input message, per options().parameterValues
+    std::string describeParameters(const MessageMetadata& layout, const void* message) const;
+
+    /// Multi-line text of an entry, as write() logs it
+    static std::string format(const SlowQueryEntry& entry);
+
+protected:
+    /// Called concurrently, once per slow statement
+    virtual void write(const SlowQueryEntry& entry);
+
+private:
+    SlowQueryLogOptions options_;
+    uint64_t sampleBelow_ = 0;   // Draws under this are timed (sampleRate < 1)
+    std::atomic<uint64_t> sampled_{0};
+    std::atomic<uint64_t> logged_{0};
+};
+
+void setSlowQueryLog(SlowQueryLog* log);
+SlowQueryLog* getSlowQueryLog() noexcept;
+
+namespace detail {
+
+/// Adds the time until the end of its scope to `total`, if given one
+class SlowQueryTimer {
+public:
+    explicit SlowQueryTimer(std::chrono::steady_clock::duration* total) noexcept
+        : total_(total),
+          started_(total ? std::chrono::steady_clock::now()
+                         : std::chrono::steady_clock::time_point{}) {}
+
+    ~SlowQueryTimer() {
+        if (total_) {
+            *total_ += std::chrono::steady_clock::now() - started_;
+        }
+    }
+
+    SlowQueryTimer(const SlowQueryTimer&) = delete;
+    SlowQueryTimer& operator=(const SlowQueryTimer&) = delete;
+
+private:
+    std::chrono::steady_clock::duration* total_;
+    std::chrono::steady_clock::time_point started_;
+};
+
+/// A sampled cursor, from open to close (see ResultSet::attachSlowQuery)
+struct SlowQueryProbe {
+    SlowQueryLog* log = nullptr;
+    uint64_t fingerprint = 0;
+    // Borrowed cursors only, whose caller keeps the statement alive; an
+    // owning cursor reports through the statement it retains, if any
+    const Statement* statement = nullptr;
+    SlowQueryTimings timings;
+    // Copy of the input message; null layout = no parameter summary
+    std::shared_ptr<const MessageMetadata> inputLayout;
+    std::vector<uint8_t> input;
+};
+
+} // namespace detail
+
+} // namespace core
+} // namespace fbpp
@@ -0,0 +1,155 @@
+#pragma once
+
+// Span hooks for external tracing (see fbpp/ext/otel.hpp for the
+// OpenTelemetry observer built on them).
+//
+// With an observer installed, fbpp reports one span per connect, prepare,
+// execute, cursor (open to close: the fetch loop), commit and rollback,
+// with the SQL text, its fingerprint (SqlKey::hashOf of the text, i.e.
+// equal for statements that differ only in case, whitespace or comments)
+// and the row count. Without one, each site costs one atomic load.
+//
+// The observer is process-wide like the trace sink: install it before
+// fbpp is used and keep it alive until every span it started has ended
+// (the last cursor is closed). Its methods are called concurrently from
+// every thread that uses fbpp.
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <string_view>
+
+namespace Firebird {
+class IMessageMetadata;
+}
+
+namespace fbpp {
+namespace core {
+
+enum class SpanKind {
+    Connect,
+    Prepare,
+    Execute,     // Statement execute (DML, DDL, EXECUTE PROCEDURE)
+    FetchLoop,   // openCursor to ResultSet close; rows = rows served
+    Commit,
+    Rollback
+};
+
+/// Lower-case operation name of a span kind ("connect", "fetch", ...)
+const char* spanKindName(SpanKind kind) noexcept;
+
+struct SpanStart {
+    SpanKind kind = SpanKind::Execute;
+    std::string_view sql;          // Empty for Connect / Commit / Rollback
+    uint64_t fingerprint = 0;      // 0 when there is no SQL
+    std::string_view database;     // Set for Connect
+    // Execute / FetchLoop with parameters: the packed input message and
+    // its layout, valid only during startSpan() (see fbpp_util/workload.hpp)
+    Firebird::IMessageMetadata* inputMetadata = nullptr;
+    const void* input = nullptr;
+};
+
+struct SpanEnd {
+    uint64_t rows = 0;             // Execute: affected; FetchLoop: served
+    bool failed = false;
+    std::string_view error;        // what() of the failure, if known
+};
+
+class SpanObserver {
+public:
+    virtual ~SpanObserver() = default;
+
+    /// Returns an opaque handle passed back to endSpan() (may be nullptr).
+    /// Must not throw; exceptions are swallowed.
+    virtual void* startSpan(const SpanStart& start) = 0;
+
+    virtual void endSpan(void* span, const SpanEnd& end) noexcept = 0;
+};
+
+void setSpanObserver(SpanObserver* observer);
+SpanObserver* getSpanObserver() noexcept;
+
+namespace detail {
+
+/**
+ * @brief One span around a scope; inert without an observer
+ *
+ * Two steps so that attributes are only computed when someone listens:
+ *
+ *   detail::SpanScope span(SpanKind::Execute);
+ *   if (span.active()) span.start(sql, fingerprint);
+ *
+ * A scope left by an exception ends its span as failed.
+ */
+class SpanScope {
+public:
+    explicit SpanScope(SpanKind kind) noexcept
+        : observer_(getSpanObserver()), kind_(kind) {}
+
+    ~SpanScope() {
+        if (started_ && !ended_) {
+            end_.failed = end_.failed || std::uncaught_exceptions() > exceptions_;
+            observer_->endSpan(span_, end_);
+        }
+    }
+
+    SpanScope(const SpanScope&) = delete;
+    SpanScope& operator=(const SpanScope&) = delete;
+
+    bool active() const noexcept { return observer_ != nullptr; }
+
+    /// Start the span (no-op without an observer or if already started)
+    void start(std::string_view sql = {}, uint64_t fingerprint = 0,
+               std::string_view database = {}) noexcept {
+        if (!observer_ || started_) {
+            return;
+        }
+        exceptions_ = std::uncaught_exceptions();
+        try {
+            span_ = observer_->startSpan(
+                SpanStart{kind_, sql, fingerprint, database, inputMetadata_, input_});
+            started_ = true;
+        } catch (...) {
+            observer_ = nullptr;
+        }
+    }
+
+    /// Input message reported by start(); call before it
+    void setInput(Firebird::IMessageMetadata* metadata, const void* message) noexcept {
+        inputMetadata_ = metadata;
+        input_ = message;
+    }
+
+    void setRows(uint64_t rows) noexcept { end_.rows = rows; }
+    void fail(std::string_view error) noexcept {
+        end_.failed = true;
+        end_.error = error;
+    }
+
+    bool started() const noexcept { return started_ && !ended_; }
+
+    /// Hand the started span to another owner (ResultSet), which must end
+    /// it through observer(); this scope no longer does.
+    void* release() noexcept {
+        ended_ = true;
+        return span_;
+    }
+
+    SpanObserver* observer() const noexcept { return observer_; }
+
+private:
+    SpanObserver* observer_;
+    SpanKind kind_;
+    void* span_ = nullptr;
+    Firebird::IMessageMetadata* inputMetadata_ = nullptr;
+    const void* input_ = nullptr;
+    SpanEnd end_;
+    int exceptions_ = 0;
+    bool started_ = false;
+    bool ended_ = false;
+};
+
+} // namespace detail
+
+} // namespace core
+} // namespace fbpp
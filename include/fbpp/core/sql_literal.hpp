@@ -0,0 +1,231 @@
+#pragma once
+
+// sql<"..."> — SQL string literals whose named parameters are parsed at
+// compile time.
+//
+// The literal's positional text, its statement cache key hash and each
+// parameter's positions are constants, computed by the same lexer and
+// normalization as NamedParamParser::parse() and SqlKey::hashOf():
+//
+//   constexpr auto byOwner = sql<"SELECT id FROM account WHERE owner = :owner">;
+//   auto stmt = conn.prepareStatement(byOwner);   // no parse, no key hashing
+//   auto& binder = stmt->binder(tx.get());
+//   binder.set(byOwner.positions<"owner">, owner);   // no name lookup
+//
+// static_assert(byOwner.positionalSql() == "SELECT id FROM account WHERE owner = ?")
+// holds, and positions<"ownr"> does not compile. The literal converts to a
+// SqlKey built once per literal that carries the parse result, so a cache
+// miss prepares without parsing either. It shares the cache entry of the
+// same text passed as a std::string.
+
+#include "fbpp/core/detail/sql_lexer.hpp"
+#include "fbpp/core/detail/sql_token_stream.hpp"
+#include "fbpp/core/named_param_parser.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/statement_cache.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace fbpp {
+namespace core {
+
+/// A string literal as a template argument: sql<"...">
+template<std::size_t N>
+struct FixedSql {
+    char text[N]{};
+
+    consteval FixedSql(const char (&literal)[N]) {
+        for (std::size_t i = 0; i < N; ++i) {
+            text[i] = literal[i];
+        }
+    }
+
+    constexpr std::string_view view() const noexcept { return {text, N - 1}; }
+};
+
+namespace detail {
+
+constexpr bool isSqlNameStart(char ch) noexcept {
+    return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || ch == '_';
+}
+
+constexpr bool isSqlNameChar(char ch) noexcept {
+    return isSqlNameStart(ch) || (ch >= '0' && ch <= '9');
+}
+
+/// NamedParamParser::ParseResult of a text of at most N - 1 characters
+template<std::size_t N>
+struct CompiledSql {
+    struct Param {
+        std::size_t nameBegin = 0;    // In names
+        std::size_t nameLength = 0;
+        std::size_t position = 0;     // Of its '?'
+        std::size_t sqlOffset = 0;    // Of its marker in the original text
+    };
+
+    char positional[N]{};             // Converted text, NUL-terminated
+    std::size_t positionalLength = 0;
+    char names[N]{};                  // Lower-cased names, back to back
+    std::array<Param, N> params{};
+    std::size_t paramCount = 0;       // Named markers
+    std::size_t placeholders = 0;     // '?' in the converted text
+
+    constexpr std::string_view nameOf(std::size_t index) const noexcept {
+        return {names + params[index].nameBegin, params[index].nameLength};
+    }
+
+    /// Markers of `name` (case-insensitive)
+    constexpr std::size_t countOf(std::string_view name) const noexcept {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < paramCount; ++i) {
+            count += sameName(nameOf(i), name) ? 1 : 0;
+        }
+        return count;
+    }
+
+    static constexpr bool sameName(std::string_view lowered, std::string_view name) noexcept {
+        if (lowered.size() != name.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < name.size(); ++i) {
+            if (lowered[i] != asciiLower(name[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// NamedParamParser::parse(), step for step
+template<std::size_t N>
+constexpr CompiledSql<N> compileSql(std::string_view sql) {
+    CompiledSql<N> result;
+    std::size_t out = 0;
+    std::size_t namesEnd = 0;
+    auto copy = [&](std::size_t begin, std::size_t end) {
+        for (std::size_t k = begin; k < end; ++k) {
+            result.positional[out++] = sql[k];
+        }
+    };
+
+    SqlLexer lexer(sql);
+    SqlLexer::Span span;
+    while (lexer.next(span)) {
+        if (span.kind != SqlLexer::Kind::Code) {
+            copy(span.begin, span.end);
+            continue;
+        }
+        std::size_t copied = span.begin;
+        for (std::size_t i = span.begin; i < span.end; ++i) {
+            const char ch = sql[i];
+            if (ch == '?') {
+                ++result.placeholders;
+                continue;
+            }
+            if ((ch != ':' && ch != '@') || i + 1 >= span.end || !isSqlNameStart(sql[i + 1])) {
+                continue;
+            }
+            std::size_t nameEnd = i + 2;
+            while (nameEnd < span.end && isSqlNameChar(sql[nameEnd])) {
+                ++nameEnd;
+            }
+
+            auto& param = result.params[result.paramCount++];
+            param.nameBegin = namesEnd;
+            param.nameLength = nameEnd - i - 1;
+            param.position = result.placeholders++;
+            param.sqlOffset = i;
+            for (std::size_t k = i + 1; k < nameEnd; ++k) {
+                result.names[namesEnd++] = asciiLower(sql[k]);
+            }
+
+            copy(copied, i);
+            result.positional[out++] = '?';
+            copied = nameEnd;
+            i = nameEnd - 1;
+        }
+        copy(copied, span.end);
+    }
+    result.positionalLength = out;
+    return result;
+}
+
+} // namespace detail
+
+/**
+ * @brief A compile-time parsed SQL literal; use through sql<"...">
+ */
+template<FixedSql Text>
+class SqlLiteral {
+public:
+    static constexpr auto compiled = detail::compileSql<sizeof(Text.text)>(Text.view());
+
+    /// The literal as written
+    static constexpr std::string_view text() noexcept { return Text.view(); }
+
+    /// With '?' for every named parameter, as sent to Firebird
+    static constexpr std::string_view positionalSql() noexcept {
+        return {compiled.positional, compiled.positionalLength};
+    }
+
+    /// SqlKey::hashOf(text(), Statement::PREPARE_DEFAULT)
+    static constexpr std::uint64_t hash =
+        detail::sqlKeyHash(Text.view(), Statement::PREPARE_DEFAULT);
+
+    static constexpr bool hasNamedParams = compiled.paramCount > 0;
+
+    /// Input parameters of the statement ('?' in positionalSql())
+    static constexpr std::size_t parameterCount = compiled.placeholders;
+
+    /// Every position of the parameter `Name` (case-insensitive)
+    template<FixedSql Name>
+    static constexpr auto positions = [] {
+        constexpr std::size_t count = compiled.countOf(Name.view());
+        static_assert(count > 0, "sql<>: the literal has no such named parameter");
+        std::array<std::size_t, count> result{};
+        std::size_t next = 0;
+        for (std::size_t i = 0; i < compiled.paramCount; ++i) {
+            if (compiled.sameName(compiled.nameOf(i), Name.view())) {
+                result[next++] = compiled.params[i].position;
+            }
+        }
+        return result;
+    }();
+
+    /// Cache key with hash and parse result filled in, built on first use
+    static const SqlKey& key() {
+        static const SqlKey instance(std::string(text()), Statement::PREPARE_DEFAULT, hash,
+                                     parseResult());
+        return instance;
+    }
+
+    operator const SqlKey&() const { return key(); }
+
+private:
+    static std::shared_ptr<const NamedParamParser::ParseResult> parseResult() {
+        auto result = std::make_shared<NamedParamParser::ParseResult>();
+        result->convertedSql.assign(positionalSql());
+        result->hasNamedParams = hasNamedParams;
+        result->parameters.reserve(compiled.paramCount);
+        for (std::size_t i = 0; i < compiled.paramCount; ++i) {
+            const auto& param = compiled.params[i];
+            NamedParamInfo& info = result->parameters.emplace_back();
+            info.name.assign(compiled.nameOf(i));
+            info.position = param.position;
+            info.sqlOffset = param.sqlOffset;
+            result->nameToPositions[info.name].push_back(param.position);
+        }
+        return result;
+    }
+};
+
+template<FixedSql Text>
+inline constexpr SqlLiteral<Text> sql{};
+
+} // namespace core
+} // namespace fbpp
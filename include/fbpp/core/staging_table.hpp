@@ -0,0 +1,111 @@
+#pragma once
+
+// StagingTable — a client-side row set loaded into a global temporary
+// table, so one set-based statement can join it instead of issuing a
+// point lookup per key.
+//
+//   fbpp::core::StagingTableOptions options;
+//   options.primaryKey = {"ID"};
+//   fbpp::core::StagingTable keys(conn, {{"ID", "BIGINT NOT NULL"}}, options);
+//   keys.load(*tx, ids);                   // e.g. std::vector<std::tuple<int64_t>>
+//   auto cur = tx->openCursor(conn.prepareStatement(
+//       "SELECT o.* FROM orders o JOIN " + keys.name() + " k ON k.ID = o.customer_id"));
+//
+// The table is ON COMMIT DELETE ROWS: rows belong to the transaction that
+// loaded them and vanish at its end, so every connection can share one
+// definition. It is created on first use and reused afterwards; the
+// default name is derived from the column definitions, so a different
+// column set gets a different table. load() goes through Batch, executed
+// whenever flushBytes of messages are buffered.
+
+#include "fbpp/core/batch.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fbpp {
+namespace core {
+
+struct StagingColumn {
+    std::string name;
+    std::string type;     ///< SQL type and constraints, e.g. "VARCHAR(40) CHARACTER SET UTF8"
+};
+
+struct StagingTableOptions {
+    /// Table name; empty = FBPP_STAGE_ plus a hash of the definition.
+    /// An existing table of that name is used as it is.
+    std::string name;
+    std::vector<std::string> primaryKey;          ///< Optional key, indexing the join columns
+    std::size_t flushBytes = 8 * 1024 * 1024;     ///< load(): execute the batch at this size
+};
+
+class StagingTable {
+public:
+    /// Creates the table unless it exists (also when another connection
+    /// creates it concurrently)
+    StagingTable(Connection& connection, std::vector<StagingColumn> columns,
+                 StagingTableOptions options = {});
+
+    const std::string& name() const noexcept { return name_; }
+    const std::vector<StagingColumn>& columns() const noexcept { return columns_; }
+    /// INSERT of every column, in definition order
+    const std::string& insertSql() const noexcept { return insertSql_; }
+
+    /**
+     * @brief Insert `rows` in `transaction`
+     *
+     * Rows are anything Batch::addMany() packs, with one field per column.
+     * A rejected row stops the load with a FirebirdException; the rows
+     * already inserted stay until the transaction ends.
+     *
+     * @return Rows inserted
+     */
+    template<std::ranges::input_range Range>
+    std::size_t load(Transaction& transaction, Range&& rows);
+
+    /// Remove this transaction's rows before its end
+    void clear(Transaction& transaction);
+
+private:
+    // Execute one filled batch; throws on a rejected message
+    std::size_t execute(Batch& batch, Transaction& transaction);
+
+    Connection& connection_;
+    std::vector<StagingColumn> columns_;
+    StagingTableOptions options_;
+    std::string name_;
+    std::string insertSql_;
+};
+
+template<std::ranges::input_range Range>
+std::size_t StagingTable::load(Transaction& transaction, Range&& rows) {
+    auto statement = connection_.prepareStatement(insertSql_);
+    std::size_t loaded = 0;
+    using It = std::ranges::iterator_t<Range>;
+    using Sentinel = std::ranges::sentinel_t<Range>;
+    It first = std::ranges::begin(rows);
+    const Sentinel last = std::ranges::end(rows);
+    while (first != last) {
+        auto batch = statement->createBatch(&transaction, false);
+        const std::size_t messageBytes = std::max<std::size_t>(batch->getMessageBytes(), 1);
+        const std::size_t room = std::max<std::size_t>(options_.flushBytes / messageBytes, 1);
+        auto reached = batch->addMany(
+            std::counted_iterator(std::move(first),
+                                  static_cast<std::iter_difference_t<It>>(room)),
+            detail::ChunkEnd<Sentinel>{last});
+        first = std::move(reached).base();
+        loaded += execute(*batch, transaction);
+    }
+    return loaded;
+}
+
+} // namespace core
+} // namespace fbpp
@@ -0,0 +1,72 @@
+#pragma once
+
+// Where a process spends its time before the first query.
+//
+// fbpp times the first occurrence of each startup step: client library
+// (master interface) initialization, loading the dispatcher that hosts the
+// providers, the first attach and the first prepare. Each is recorded once
+// per process, as its duration and as its end measured from the moment
+// fbpp was loaded, and is traced at info level under the "Startup"
+// component as it happens. A short-lived tool can print the whole profile
+// before exiting:
+//
+//   auto connection = std::make_unique<Connection>(params);
+//   ...
+//   std::cerr << startupProfile().describe() << '\n';
+//
+// The dispatcher and the IUtil interface are fetched on first use (see
+// Environment), so a process that only packs or decodes messages never
+// loads them. After startup each step costs one atomic load per call.
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace fbpp {
+namespace core {
+
+enum class StartupPhase {
+    MasterInit,     // fb_get_master_interface(), in the first Environment::getInstance()
+    ProviderLoad,   // IMaster::getDispatcher(), in the first Environment::getProvider()
+    FirstAttach,    // First Connection::connect(), DPB to attachment
+    FirstPrepare    // First prepare, probe transaction included
+};
+
+/// Lower-case name of a phase ("master init", "first attach", ...)
+const char* startupPhaseName(StartupPhase phase) noexcept;
+
+struct StartupPhaseTiming {
+    bool reached = false;
+    std::chrono::microseconds took{0};   // Duration of the step
+    std::chrono::microseconds at{0};     // End of the step, since fbpp was loaded
+};
+
+struct StartupProfile {
+    StartupPhaseTiming masterInit;
+    StartupPhaseTiming providerLoad;
+    StartupPhaseTiming firstAttach;
+    StartupPhaseTiming firstPrepare;
+
+    const StartupPhaseTiming& operator[](StartupPhase phase) const noexcept;
+
+    /// One line per phase: "first attach 12.400 ms (at 15.100 ms)"
+    std::string describe() const;
+};
+
+/// Steps recorded so far in this process
+StartupProfile startupProfile() noexcept;
+
+namespace detail {
+
+/// now() while `phase` is still unrecorded, a default time_point after
+/// that (one atomic load)
+std::chrono::steady_clock::time_point startupClock(StartupPhase phase) noexcept;
+
+/// Record `phase` as started at `started` and ending now; ignored for a
+/// default `started` and once the phase is recorded
+void recordStartupPhase(StartupPhase phase, std::chrono::steady_clock::time_point started) noexcept;
+
+} // namespace detail
+
+} // namespace core
+} // namespace fbpp
@@ -5,8 +5,13 @@
 #include "fbpp/core/pack_utils.hpp"
 #include "fbpp/core/named_param_helper.hpp"
 #include "fbpp/core/firebird_compat.hpp"
+#include "fbpp/core/output_coercion.hpp"
 #include "fbpp/core/result_set.hpp"
+#include "fbpp/core/slow_query_log.hpp"
+#include "fbpp/core/statement_metrics.hpp"
+#include <chrono>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 #include <tuple>
@@ -20,7 +25,15 @@ namespace core {
 class Connection;
 class Transaction;
 class MessageMetadata;
+class ParamBinder;
+struct MetadataLayout;
 class Batch;
+class SqlKey;
+struct BatchOptions;
+
+namespace detail {
+class DeferredRelease;
+}
 
 /**
  * @brief Wrapper for Firebird IStatement interface
@@ -41,6 +54,8 @@ class Batch;
 class Statement {
     // Transaction needs access to execute methods
     friend class Transaction;
+    friend class ProcedureCall;
+    friend class ResultSet;   // releaseQueue()
     
 public:
     /**
@@ -56,7 +71,15 @@ public:
         PREPARE_PREFETCH_AFFECTED_RECORDS = Firebird::IStatement::PREPARE_PREFETCH_AFFECTED_RECORDS,
         PREPARE_PREFETCH_FLAGS = Firebird::IStatement::PREPARE_PREFETCH_FLAGS,
         PREPARE_PREFETCH_METADATA = Firebird::IStatement::PREPARE_PREFETCH_METADATA,
-        PREPARE_PREFETCH_ALL = Firebird::IStatement::PREPARE_PREFETCH_ALL
+        PREPARE_PREFETCH_ALL = Firebird::IStatement::PREPARE_PREFETCH_ALL,
+        // What fbpp reads after every prepare: the statement type and both
+        // message formats. Flags, plans and affected records are left to
+        // the first getFlags() / getPlan() / getAffectedRecords().
+        PREPARE_PREFETCH_MINIMAL = PREPARE_PREFETCH_TYPE | PREPARE_PREFETCH_INPUT_PARAMETERS |
+                                   PREPARE_PREFETCH_OUTPUT_PARAMETERS,
+        // Not a Firebird flag: "use the connection's
+        // ConnectionOptions::prepareFlags", resolved at prepare time
+        PREPARE_DEFAULT = 0x80000000u
     };
 
     /**
@@ -144,6 +167,9 @@ public:
     
     /**
      * @brief Get statement plan
+     *
+     * Fetched from the server on the first call per kind and kept.
+     *
      * @param detailed If true, get detailed plan
      * @return Execution plan as string
      */
@@ -157,15 +183,47 @@ public:
     
     /**
      * @brief Get input metadata
-     * @return Input metadata or nullptr if no input parameters
+     *
+     * Built once per prepared statement (fields, name index and column
+     * plan included) and shared by every execute / ParamBinder / Batch,
+     * so re-executing a cached statement costs no metadata round-trips.
+     *
+     * @return Shared input metadata or nullptr if no input parameters
      */
-    std::unique_ptr<MessageMetadata> getInputMetadata() const;
+    std::shared_ptr<const MessageMetadata> getInputMetadata() const;
     
     /**
      * @brief Get output metadata
-     * @return Output metadata or nullptr if no output (non-SELECT)
+     *
+     * Cached like getInputMetadata(); every cursor opened without an
+     * explicit output format shares this instance.
+     *
+     * @return Shared output metadata or nullptr if no output (non-SELECT)
      */
-    std::unique_ptr<MessageMetadata> getOutputMetadata() const;
+    std::shared_ptr<const MessageMetadata> getOutputMetadata() const;
+
+    /**
+     * @brief Output format under `coercion`; nullptr when it changes nothing
+     *
+     * Built once and kept until another coercion is asked for or the
+     * statement is prepared again.
+     */
+    std::shared_ptr<const MessageMetadata>
+    getCoercedOutputMetadata(const OutputCoercion& coercion) const;
+
+    /**
+     * @brief ParamBinder owned by this instance, cleared for reuse
+     *
+     * Built once (by StatementCache when it prepares the instance, else on
+     * first call) and clear()ed on every later call, so binding costs no
+     * metadata lookup or buffer allocation. Instances pooled by the cache
+     * keep their binder across checkouts; since a checkout is exclusive,
+     * so is the binder. The reference is valid while this Statement lives.
+     * Defined in param_binder.hpp.
+     *
+     * @param transaction Attached via ParamBinder::setTransaction()
+     */
+    ParamBinder& binder(Transaction* transaction = nullptr);
     
     /**
      * @brief Get timeout for statement execution
@@ -178,6 +236,23 @@ public:
      * @param timeout Timeout in milliseconds (0 = no timeout)
      */
     void setTimeout(unsigned timeout);
+
+    /**
+     * @brief Send BLOBs up to `bytes` inline with fetched rows
+     *
+     * Firebird 5.0.3+ client and server: such BLOBs are then read by
+     * loadBlob()/BlobReader without any round trip, which is what makes
+     * per-row BLOB columns (Row, JsonUnpacker, RAD decoder) cheap. Applies
+     * to cursors opened afterwards; 0 disables inlining.
+     *
+     * @return false if the client library does not support inline BLOBs
+     */
+    bool setMaxInlineBlobSize(unsigned bytes);
+
+    /**
+     * @brief Current inline BLOB limit (0 = disabled or unsupported)
+     */
+    unsigned getMaxInlineBlobSize() const;
     
     /**
      * @brief Create batch for batch operations
@@ -189,6 +264,16 @@ public:
     std::unique_ptr<Batch> createBatch(Transaction* transaction,
                                        bool recordCounts = true,
                                        bool continueOnError = false);
+
+    /**
+     * @brief Create batch with full options (BLOB policy included)
+     * @param transaction Transaction to use for batch
+     * @param options Record counts, multi-error, detailed errors, buffer size
+     *                and TAG_BLOB_POLICY
+     * @return Batch object for batch operations
+     */
+    std::unique_ptr<Batch> createBatch(Transaction* transaction,
+                                       const BatchOptions& options);
     
     /**
      * @brief Create batch for batch operations (low-level Firebird 4.0+)
@@ -243,8 +328,122 @@ public:
         hasNamedParams_ = hasNamed;
     }
 
+    /**
+     * @brief Seed metadata with layouts decoded by another prepare of the
+     *        same SQL (called by StatementCache)
+     *
+     * Each layout is used only if it still matches this statement's
+     * message format (see MessageMetadata); otherwise metadata loads
+     * from the server as usual. Must be called before the metadata is
+     * first requested.
+     */
+    void setMetadataLayouts(std::shared_ptr<const MetadataLayout> input,
+                            std::shared_ptr<const MetadataLayout> output) {
+        inputLayout_ = std::move(input);
+        outputLayout_ = std::move(output);
+    }
+
+    /**
+     * @brief Record execute / openCursor / fetch timings into `metrics`
+     *        (called by StatementCache; nullptr stops recording)
+     *
+     * Cursors opened afterwards time their fetches into the same object.
+     * @see statement_metrics.hpp
+     */
+    void setMetrics(std::shared_ptr<StatementMetrics> metrics) noexcept {
+        metrics_ = std::move(metrics);
+    }
+
+    const std::shared_ptr<StatementMetrics>& getMetrics() const noexcept { return metrics_; }
+
+    /**
+     * @brief Capacity of the fetch buffers kept for this statement's next cursor
+     *
+     * A cursor leaves its row buffer, prefetch window and column staging
+     * block here on close; the next openCursor() starts with them.
+     */
+    size_t recycledFetchBytes() const noexcept;
+
+    /**
+     * @brief Record the SQL text and prepare flags this instance was
+     *        prepared with (positional form; called by the preparing code)
+     *
+     * After Connection::reconnect() they prepare the statement again on
+     * the new attachment, before its next execute, cursor or batch.
+     */
+    void setSql(std::string sql, unsigned prepareFlags = PREPARE_DEFAULT) {
+        sql_ = std::move(sql);
+        fingerprint_ = 0;
+        prepareFlags_ = prepareFlags;
+        limitRows_ = 0;
+        limitKey_.reset();
+    }
+
+    /**
+     * @brief SQL text sent to prepare (empty if not recorded)
+     */
+    const std::string& getSql() const noexcept { return sql_; }
+
+    /**
+     * @brief SqlKey::hashOf(getSql(), 0), computed on first use; 0 if no
+     *        SQL was recorded. Span attribute (see span_observer.hpp).
+     */
+    uint64_t getFingerprint() const;
+
+    /**
+     * @brief Pack parameters into a fresh input message
+     *
+     * The buffer openCursor() would send: named JSON / JsonText keys are
+     * resolved the same way and unused bytes are zero, so equal parameters
+     * give equal bytes (the key of QueryResultCache).
+     *
+     * @return Message of getInputMetadata()'s length; empty when the
+     *         statement takes no parameters
+     */
+    template<typename InParams>
+    std::vector<uint8_t> packInput(Transaction* transaction, const InParams& params);
+
+    /**
+     * @brief This SELECT capped at `rows` rows ("... ROWS n"), prepared
+     *        through the connection's cache as a key of its own
+     *
+     * Kept by the cache like any statement, so a top-1 lookup repeated in
+     * a loop prepares once. Named parameters keep their positions. nullptr
+     * when rows is 0, the text already limits or locks rows or is not a
+     * plain SELECT (see detail::limitRowsSql), the connection's statement
+     * cache is off, or the capped text fails to prepare.
+     */
+    std::shared_ptr<Statement> limitedTo(uint64_t rows);
+
+    /**
+     * @brief Run a SELECT known to return at most one row as a singleton
+     *
+     * One IStatement::execute() with the output message instead of
+     * openCursor() + fetch() + close(): no cursor is opened and no
+     * affected-records request follows. The row is unpacked into T (tuple,
+     * described struct or JSON) straight from the output message.
+     * @return nullopt when the SELECT returned no row
+     * @throws FirebirdException if the statement has no output columns or
+     *         the server finds more than one row (isc_sing_select_err);
+     *         use openCursor() for those
+     */
+    template<typename T, typename InParams>
+    std::optional<T> selectOne(Transaction* transaction, const InParams& params);
+
+    template<typename T>
+    std::optional<T> selectOne(Transaction* transaction) {
+        return selectOne<T>(transaction, std::tuple<>{});
+    }
+
 private:
+    // packInput() into `buffer`, which holds `layout`'s zeroed message
+    template<typename InParams>
+    void packInputInto(Transaction* transaction, const InParams& params,
+                       const MessageMetadata& layout, uint8_t* buffer);
+
     void cleanup();
+    // The connection's deferred-release queue, if it is still alive
+    std::shared_ptr<detail::DeferredRelease> releaseQueue() const { return releases_.lock(); }
     
     // ========================================================================
     // Private methods - can only be called through Transaction
@@ -264,13 +463,19 @@ private:
      * @param inBuffer Input buffer
      * @param outMetadata Output metadata (for RETURNING clause)
      * @param outBuffer Output buffer
+     * @param countRecords Ask the server for the affected-records count
+     *                     (one more round trip); false returns 0
+     * @param rowFound Singleton SELECT (see selectOne()): set to false
+     *                 instead of throwing when the server has no row
      * @return Number of affected rows
      */
     unsigned execute(Transaction* transaction,
                     Firebird::IMessageMetadata* inMetadata,
                     const void* inBuffer,
                     Firebird::IMessageMetadata* outMetadata = nullptr,
-                    void* outBuffer = nullptr);
+                    void* outBuffer = nullptr,
+                    bool countRecords = true,
+                    bool* rowFound = nullptr);
     
     /**
      * @brief Execute statement with template parameters
@@ -352,11 +557,96 @@ private:
     template<typename InParams>
     std::unique_ptr<ResultSet> openCursor(std::shared_ptr<Transaction> transaction,
                                           const InParams& params);
+
+    /**
+     * @brief Open cursor serving at most `limit.rows` rows
+     *
+     * Runs limitedTo(limit.rows) when the text takes a "ROWS n" clause, so
+     * the server stops producing rows at the limit, and this statement
+     * otherwise; either way the cursor stops there (ResultSet::setRowLimit)
+     * and keeps the statement it ran on alive. limit.rows == 0 is a plain
+     * openCursor().
+     */
+    std::unique_ptr<ResultSet> openCursor(Transaction* transaction, RowLimit limit);
+
+    template<typename InParams>
+    std::unique_ptr<ResultSet> openCursor(Transaction* transaction,
+                                          const InParams& params,
+                                          RowLimit limit);
+
+    /**
+     * @brief Open cursor whose rows the server converts by `coercion`
+     *
+     * Rows are described by getCoercedOutputMetadata(coercion) rather than
+     * the statement's own output format; fetch them into types matching it.
+     * Transaction::openCursor(statement, [params,] coercion) calls these.
+     */
+    std::unique_ptr<ResultSet> openCursor(Transaction* transaction,
+                                          const OutputCoercion& coercion,
+                                          unsigned flags = 0);
+
+    template<typename InParams>
+    std::unique_ptr<ResultSet> openCursor(Transaction* transaction,
+                                          const InParams& params,
+                                          const OutputCoercion& coercion,
+                                          unsigned flags = 0);
+
+    /**
+     * @brief Open cursor whose rows come in `outFormat`
+     *
+     * Firebird converts each row to it, as for a coercion; messageFormat<T>()
+     * of a message-layout struct makes its rows plain copies of T.
+     * Transaction::openCursor(statement, [params,] outFormat) calls these.
+     */
+    std::unique_ptr<ResultSet> openCursor(Transaction* transaction,
+                                          const std::shared_ptr<const MessageMetadata>& outFormat,
+                                          unsigned flags = 0);
+
+    template<typename InParams>
+    std::unique_ptr<ResultSet> openCursor(Transaction* transaction,
+                                          const InParams& params,
+                                          const std::shared_ptr<const MessageMetadata>& outFormat,
+                                          unsigned flags = 0);
+
+    /**
+     * @brief Open a cursor that borrows `transaction` and this statement
+     *
+     * The ResultSet takes no reference to either (no shared_from_this, no
+     * retained statement) and its rows start RowOwnership::borrowed, so a
+     * hot loop opening many short cursors touches no reference count. The
+     * caller's scope must keep the transaction and the statement alive
+     * until the cursor and the rows reading BLOBs are gone; use openCursor()
+     * otherwise. The transaction need not be shared_ptr-managed.
+     */
+    std::unique_ptr<ResultSet> openBorrowedCursor(Transaction& transaction, unsigned flags = 0);
+
+    template<typename InParams>
+    std::unique_ptr<ResultSet> openBorrowedCursor(Transaction& transaction,
+                                                  const InParams& params,
+                                                  unsigned flags = 0);
     
 private:
+    // Core of openCursor() / openBorrowedCursor()
+    std::unique_ptr<ResultSet> openCursorImpl(Transaction* transaction,
+                                              Firebird::IMessageMetadata* inMetadata,
+                                              const void* inBuffer,
+                                              Firebird::IMessageMetadata* outMetadata,
+                                              unsigned flags,
+                                              bool borrowed,
+                                              const OutputCoercion* coercion = nullptr,
+                                              std::shared_ptr<const MessageMetadata> format = {});
+
+    // Prepare again in `transaction` if the connection reconnected since
+    // this handle was prepared
+    void revalidate(Transaction& transaction);
+    // A failed request: lets the connection notice a lost attachment
+    FirebirdException requestFailed(const Firebird::FbException& error) const;
+
     Environment& env_;
     Firebird::IStatement* statement_ = nullptr;
     Connection* connection_ = nullptr;  // Non-owning pointer
+    // Where the destructor hands the handle (ConnectionOptions::handleRelease)
+    std::weak_ptr<detail::DeferredRelease> releases_;
     Firebird::IStatus* status_;
     Firebird::ThrowStatusWrapper& status() const {
         statusWrapper_.init();
@@ -364,16 +654,64 @@ private:
     }
     mutable Firebird::ThrowStatusWrapper statusWrapper_{nullptr};
     
-    // Cached metadata (lazy-loaded)
-    mutable std::unique_ptr<MessageMetadata> inputMetadata_;
-    mutable std::unique_ptr<MessageMetadata> outputMetadata_;
+    // Cached metadata (lazy-loaded, shared with cursors/binders/batches)
+    mutable std::shared_ptr<const MessageMetadata> inputMetadata_;
+    mutable std::shared_ptr<const MessageMetadata> outputMetadata_;
+    mutable bool inputMetadataLoaded_ = false;
+    mutable bool outputMetadataLoaded_ = false;
+    // Last getCoercedOutputMetadata(): canonical spec and its format
+    mutable std::optional<std::string> coercionKey_;
+    mutable std::shared_ptr<const MessageMetadata> coercedOutput_;
+    // Optional pre-decoded layouts (see setMetadataLayouts)
+    std::shared_ptr<const MetadataLayout> inputLayout_;
+    std::shared_ptr<const MetadataLayout> outputLayout_;
+
+    std::shared_ptr<const MessageMetadata> loadMetadata(bool input) const;
+    // Bytes of a message sent / received with `raw`; the cached metadata
+    // answers without an API call when it is the same format
+    unsigned messageBytes(Firebird::IMessageMetadata* raw, bool input) const;
+    // Attachment counters when metrics_ asks for them, nullopt otherwise
+    // (also when the info request fails)
+    std::optional<ServerCounters> readServerCounters() const;
+    // getInputMetadata() if `raw` is its format, null otherwise
+    std::shared_ptr<const MessageMetadata> inputLayoutOf(Firebird::IMessageMetadata* raw) const;
+    // Fetched on first use each (see Flags::PREPARE_PREFETCH_MINIMAL)
     mutable unsigned type_ = 0;
     mutable unsigned flags_ = 0;
-    mutable bool metadataLoaded_ = false;
+    mutable bool typeLoaded_ = false;
+    mutable bool flagsLoaded_ = false;
+    mutable std::optional<std::string> plans_[2];   // getPlan(false) / getPlan(true)
 
     // Named parameters support
     std::unordered_map<std::string, std::vector<size_t>> namedParamMapping_;
     bool hasNamedParams_ = false;
+
+    // Per-key metrics shared with the cache entry (see setMetrics)
+    std::shared_ptr<StatementMetrics> metrics_;
+    // Time of the last packInput() while a slow-query log is installed,
+    // taken by the next execute / openCursor (see slow_query_log.hpp)
+    std::chrono::steady_clock::duration packTime_{};
+    // Input message of execute(transaction, params), kept between calls so
+    // a reused statement packs without allocating
+    std::vector<uint8_t> inputBuffer_;
+    // Output message of selectOne(), kept the same way
+    std::vector<uint8_t> singletonBuffer_;
+    // Fetch buffers handed from each closed cursor to the next (created by
+    // the first openCursor)
+    std::shared_ptr<detail::FetchBufferStash> fetchBuffers_;
+
+    std::string sql_;
+    mutable uint64_t fingerprint_ = 0;
+    unsigned prepareFlags_ = PREPARE_DEFAULT;
+    uint64_t generation_ = 0;   // Connection::generation() at prepare
+
+    // Last limitedTo() shape: its row count and key, null if not cappable
+    uint64_t limitRows_ = 0;
+    std::shared_ptr<const SqlKey> limitKey_;
+
+    // Reusable binder (see binder()); refers back to this instance, so it
+    // is never moved along with the statement
+    std::unique_ptr<ParamBinder> binder_;
 };
 
 } // namespace core
@@ -415,30 +753,14 @@ unsigned Statement::execute(Transaction* transaction, const InParams& params) {
         return execute(transaction);
     }
     
-    // Allocate buffer based on metadata
-    size_t bufferSize = inMeta->getMessageLength();
-    std::vector<uint8_t> buffer(bufferSize);
-
-    // Handle named parameters for JSON
-    if constexpr (is_json_v<InParams>) {
-        if (hasNamedParams_ && !namedParamMapping_.empty()) {
-            // Convert named parameters to positional
-            nlohmann::json positional = NamedParamHelper::convertToPositional(
-                params, namedParamMapping_, inMeta->getCount());
-            pack(positional, buffer.data(), inMeta.get(), transaction);
-        } else {
-            // Use universal pack function as-is
-            pack(params, buffer.data(), inMeta.get(), transaction);
-        }
-    } else {
-        // Use universal pack function for non-JSON types
-        pack(params, buffer.data(), inMeta.get(), transaction);
-    }
+    // assign() keeps the capacity of the previous call
+    inputBuffer_.assign(inMeta->getMessageLength(), 0);
+    packInputInto(transaction, params, *inMeta, inputBuffer_.data());
 
     // Execute with packed parameters
     return execute(transaction,
                   inMeta->getRawMetadata(),
-                  buffer.data(),
+                  inputBuffer_.data(),
                   nullptr,
                   nullptr);
 }
@@ -456,36 +778,12 @@ std::pair<unsigned, OutParams> Statement::execute(Transaction* transaction,
         throw FirebirdException("Transaction is null");
     }
     
-    // Handle input parameters based on type
-    std::unique_ptr<MessageMetadata> inMeta;
+    // Input parameters, packed as by the execute() above (any packable
+    // type, including generated procedure Input structs)
+    std::shared_ptr<const MessageMetadata> inMeta = getInputMetadata();
     std::vector<uint8_t> inBuffer;
-    
-    // Get input metadata
-    inMeta = getInputMetadata();
     if (inMeta) {
-        inBuffer.resize(inMeta->getMessageLength());
-        
-        if constexpr (is_tuple_v<InParams>) {
-            // Use universal pack for tuple
-            pack(inParams, inBuffer.data(), inMeta.get(), transaction);
-        } else if constexpr (is_json_v<InParams>) {
-            // Handle named parameters for JSON
-            if (hasNamedParams_ && !namedParamMapping_.empty()) {
-                // Convert named parameters to positional
-                nlohmann::json positional = NamedParamHelper::convertToPositional(
-                    inParams, namedParamMapping_, inMeta->getCount());
-                pack(positional, inBuffer.data(), inMeta.get(), transaction);
-            } else {
-                // Use universal pack for JSON
-                pack(inParams, inBuffer.data(), inMeta.get(), transaction);
-            }
-        } else {
-            // Universal pack for struct / other StructDescriptor-packable input,
-            // mirroring the non-RETURNING execute() path above. Enables generated
-            // proc Input structs with EXECUTE PROCEDURE ... RETURNING.
-            // (Additive: only affects input types that previously threw here.)
-            pack(inParams, inBuffer.data(), inMeta.get(), transaction);
-        }
+        inBuffer = packInput(transaction, inParams);
     }
 
     // Prepare output buffer
@@ -504,11 +802,54 @@ std::pair<unsigned, OutParams> Statement::execute(Transaction* transaction,
                                    outBuffer.data());
     
     // Use universal unpack function
+    detail::PhaseTimer phase(metrics_.get(), Phase::Unpack);
     OutParams result = unpack<OutParams>(outBuffer.data(), outMeta.get(), transaction);
     
     return {affectedRows, result};
 }
 
+template<typename T, typename InParams>
+std::optional<T> Statement::selectOne(Transaction* transaction, const InParams& params) {
+    if (!isValid()) {
+        throw FirebirdException("Statement is not valid");
+    }
+
+    if (!transaction || !transaction->isActive()) {
+        throw FirebirdException("Invalid or inactive transaction");
+    }
+
+    auto outMeta = getOutputMetadata();
+    if (!outMeta) {
+        throw FirebirdException("selectOne: the statement returns no columns");
+    }
+
+    auto inMeta = getInputMetadata();
+    if (inMeta) {
+        inputBuffer_.assign(inMeta->getMessageLength(), 0);
+        packInputInto(transaction, params, *inMeta, inputBuffer_.data());
+    } else if constexpr (is_tuple_v<InParams>) {
+        if constexpr (std::tuple_size_v<InParams> > 0) {
+            throw FirebirdException("Statement has no parameters but tuple provided");
+        }
+    }
+
+    singletonBuffer_.resize(outMeta->getMessageLength());
+    bool found = false;
+    execute(transaction,
+            inMeta ? inMeta->getRawMetadata() : nullptr,
+            inMeta ? inputBuffer_.data() : nullptr,
+            outMeta->getRawMetadata(),
+            singletonBuffer_.data(),
+            false,
+            &found);
+    if (!found) {
+        return std::nullopt;
+    }
+
+    detail::PhaseTimer phase(metrics_.get(), Phase::Unpack);
+    return unpack<T>(singletonBuffer_.data(), outMeta.get(), transaction);
+}
+
 // Template implementation for openCursor with parameters
 template<typename InParams>
 std::unique_ptr<ResultSet> Statement::openCursor(Transaction* transaction,
@@ -541,32 +882,111 @@ std::unique_ptr<ResultSet> Statement::openCursor(Transaction* transaction,
         return openCursor(transaction, flags);
     }
     
-    // Allocate buffer based on metadata
-    size_t bufferSize = inMeta->getMessageLength();
-    std::vector<uint8_t> buffer(bufferSize);
+    std::vector<uint8_t> buffer = packInput(transaction, params);
+
+    // Open cursor with packed parameters
+    return openCursor(transaction,
+                     inMeta->getRawMetadata(),
+                     buffer.data(),
+                     nullptr,
+                     flags);
+}
+
+template<typename InParams>
+std::unique_ptr<ResultSet> Statement::openCursor(Transaction* transaction,
+                                                 const InParams& params,
+                                                 const OutputCoercion& coercion,
+                                                 unsigned flags) {
+    if (!isValid()) {
+        throw FirebirdException("Statement is not valid");
+    }
+    auto inMeta = getInputMetadata();
+    if (!inMeta) {
+        return openCursor(transaction, coercion, flags);
+    }
+    std::vector<uint8_t> buffer = packInput(transaction, params);
+    return openCursorImpl(transaction, inMeta->getRawMetadata(), buffer.data(), nullptr, flags,
+                          false, &coercion);
+}
+
+template<typename InParams>
+std::unique_ptr<ResultSet> Statement::openCursor(
+    Transaction* transaction,
+    const InParams& params,
+    const std::shared_ptr<const MessageMetadata>& outFormat,
+    unsigned flags) {
+    if (!isValid()) {
+        throw FirebirdException("Statement is not valid");
+    }
+    auto inMeta = getInputMetadata();
+    if (!inMeta) {
+        return openCursor(transaction, outFormat, flags);
+    }
+    std::vector<uint8_t> buffer = packInput(transaction, params);
+    return openCursorImpl(transaction, inMeta->getRawMetadata(), buffer.data(), nullptr, flags,
+                          false, nullptr, outFormat);
+}
+
+template<typename InParams>
+std::vector<uint8_t> Statement::packInput(Transaction* transaction, const InParams& params) {
+    auto inMeta = getInputMetadata();
+    if (!inMeta) {
+        return {};
+    }
+
+    std::vector<uint8_t> buffer(inMeta->getMessageLength());
+    packInputInto(transaction, params, *inMeta, buffer.data());
+    return buffer;
+}
+
+template<typename InParams>
+void Statement::packInputInto(Transaction* transaction, const InParams& params,
+                              const MessageMetadata& layout, uint8_t* buffer) {
+    // Timed for the slow-query log, when one is installed
+    const bool timed = getSlowQueryLog() != nullptr;
+    const auto started = timed ? std::chrono::steady_clock::now()
+                               : std::chrono::steady_clock::time_point{};
+    detail::PhaseTimer phase(metrics_.get(), Phase::Pack);
 
     // Handle named parameters for JSON
     if constexpr (is_json_v<InParams>) {
         if (hasNamedParams_ && !namedParamMapping_.empty()) {
             // Convert named parameters to positional
             nlohmann::json positional = NamedParamHelper::convertToPositional(
-                params, namedParamMapping_, inMeta->getCount());
-            pack(positional, buffer.data(), inMeta.get(), transaction);
+                params, namedParamMapping_, layout.getCount());
+            pack(positional, buffer, &layout, transaction);
         } else {
             // Use universal pack function as-is
-            pack(params, buffer.data(), inMeta.get(), transaction);
+            pack(params, buffer, &layout, transaction);
+        }
+    } else if constexpr (std::is_same_v<InParams, JsonText>) {
+        if (hasNamedParams_ && !namedParamMapping_.empty()) {
+            // Named keys resolved by the packer itself, no positional copy
+            JsonTextPacker::of(layout, namedParamMapping_).pack(params.text, buffer, transaction);
+        } else {
+            pack(params, buffer, &layout, transaction);
         }
     } else {
         // Use universal pack function for non-JSON types
-        pack(params, buffer.data(), inMeta.get(), transaction);
+        pack(params, buffer, &layout, transaction);
+    }
+    if (timed) {
+        packTime_ = std::chrono::steady_clock::now() - started;
     }
+}
 
-    // Open cursor with packed parameters
-    return openCursor(transaction,
-                     inMeta->getRawMetadata(),
-                     buffer.data(),
-                     nullptr,
-                     flags);
+template<typename InParams>
+std::unique_ptr<ResultSet> Statement::openCursor(Transaction* transaction,
+                                                 const InParams& params,
+                                                 RowLimit limit) {
+    std::shared_ptr<Statement> limited = limitedTo(limit.rows);
+    auto rs = limited ? limited->openCursor(transaction, params, 0u)
+                      : openCursor(transaction, params, 0u);
+    if (limited) {
+        rs->retainStatement(std::move(limited));
+    }
+    rs->setRowLimit(limit.rows);
+    return rs;
 }
 
 // OpenCursor with template parameters (shared_ptr version)
@@ -576,6 +996,22 @@ std::unique_ptr<ResultSet> Statement::openCursor(std::shared_ptr<Transaction> tr
     return openCursor(transaction.get(), params, 0);
 }
 
+template<typename InParams>
+std::unique_ptr<ResultSet> Statement::openBorrowedCursor(Transaction& transaction,
+                                                         const InParams& params,
+                                                         unsigned flags) {
+    if (!isValid()) {
+        throw FirebirdException("Statement is not valid");
+    }
+    auto inMeta = getInputMetadata();
+    if (!inMeta) {
+        return openBorrowedCursor(transaction, flags);
+    }
+    std::vector<uint8_t> buffer = packInput(&transaction, params);
+    return openCursorImpl(&transaction, inMeta->getRawMetadata(), buffer.data(), nullptr,
+                          flags, true);
+}
+
 } // namespace core
 } // namespace fbpp
 
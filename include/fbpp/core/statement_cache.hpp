@@ -1,11 +1,23 @@
 #pragma once
 
+#include "fbpp/core/named_param_parser.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/statement_metrics.hpp"
+#include "fbpp_util/trace.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
 #include <unordered_map>
-#include <list>
-#include <chrono>
-#include <mutex>
+#include <utility>
 #include <vector>
 
 namespace fbpp {
@@ -14,6 +26,16 @@ namespace core {
 // Forward declarations
 class Statement;
 class Connection;
+class StatementTemplate;
+class StatementLease;
+
+/**
+ * @brief Admission/eviction policy of the statement cache
+ */
+enum class StatementCachePolicy {
+    Lru,            // Evict the least recently used key; admit everything
+    CostAwareLfu    // TinyLFU-style: frequency sketch x measured prepare time
+};
 
 /**
  * @brief Configuration for statement cache
@@ -22,26 +44,129 @@ struct StatementCacheConfig {
     size_t maxSize = 100;     // Maximum number of cached statements
     bool enabled = true;      // Enable/disable cache
     size_t ttlMinutes = 60;   // Time-to-live for unused statements
+    StatementCachePolicy policy = StatementCachePolicy::Lru;
+    // Share named-parameter parsing and metadata layouts with other
+    // connections to the same database (see statement_template.hpp)
+    bool sharedTemplates = false;
+
+    // Warm-up (opt-in): when a Connection opens, pre-prepare the hottest
+    // statements recorded by StatementCache::saveHotSet()
+    std::string warmupFile;           // Hot-set file; empty disables warm-up
+    size_t warmupTopN = 32;           // Entries prepared, most used first
+    bool warmupInBackground = true;   // false: prepare inside the Connection constructor
+
+    // Schema changes: after Connection::ExecuteDDL() on any connection to
+    // the same database, or a request failing with a metadata error
+    // (Connection::isMetadataChanged), the next prepare empties the cache
+    // and prepares its schemaReprepareTopN most used keys again in the
+    // background, instead of every stale key failing once per caller
+    bool followSchemaChanges = true;
+    size_t schemaReprepareTopN = 32;  // 0: prepare again on demand only
+
+    // Per-key latency histograms, row and byte counts (see
+    // statement_metrics.hpp); off by default
+    bool collectMetrics = false;
+    // With collectMetrics: add the attachment's page / record counter
+    // deltas around each execute and cursor to the key's metrics. Costs
+    // two getInfo round trips per call; off by default
+    bool captureServerCounters = false;
+    // With collectMetrics, in a build with FBPP_PROFILE: time the pack,
+    // wire and unpack phases of each call separately (PhaseBreakdown).
+    // Ignored without FBPP_PROFILE; off by default
+    bool profilePhases = false;
+
+    // Idle prepared instances kept across all keys (0 = 2 x maxSize). A
+    // key pools as many as its recent peak of concurrent checkouts; past
+    // this budget only each key's first idle instance is kept.
+    size_t maxIdleStatements = 0;
+};
+
+/**
+ * @brief Precomputed statement cache key
+ *
+ * The cache identifies SQL by a 64-bit hash streamed over its normalized
+ * token stream (comments dropped, whitespace runs collapsed, case folded
+ * outside quoted literals) plus the prepare flags; no normalized copy of
+ * the text is built. A caller that holds a SqlKey and passes it to
+ * Connection::prepareStatement() / StatementCache::get() skips even that
+ * pass on repeat calls.
+ */
+class SqlKey {
+public:
+    explicit SqlKey(std::string sql, unsigned flags = Statement::PREPARE_DEFAULT)
+        : sql_(std::move(sql)), flags_(flags), hash_(hashOf(sql_, flags_)) {}
+
+    /**
+     * @brief Key computed elsewhere (sql<"..."> literals: at compile time)
+     *
+     * `hash` must be hashOf(sql, flags) and `parsed` NamedParamParser::parse(sql),
+     * or null; a statement prepared through the key then skips the parse.
+     */
+    SqlKey(std::string sql, unsigned flags, uint64_t hash,
+           std::shared_ptr<const NamedParamParser::ParseResult> parsed)
+        : sql_(std::move(sql)), flags_(flags), hash_(hash), parsed_(std::move(parsed)) {}
+
+    const std::string& sql() const noexcept { return sql_; }
+    unsigned flags() const noexcept { return flags_; }
+    uint64_t hash() const noexcept { return hash_; }
+    /// Named parameters of sql(), if known up front; null otherwise
+    const std::shared_ptr<const NamedParamParser::ParseResult>& parsed() const noexcept {
+        return parsed_;
+    }
+
+    /**
+     * @brief Hash of the normalized SQL text mixed with flags
+     */
+    static uint64_t hashOf(std::string_view sql, unsigned flags) noexcept;
+
+    /**
+     * @brief true if both texts normalize to the same token stream
+     *
+     * Used to verify hash matches; allocation-free.
+     */
+    static bool equivalent(std::string_view a, std::string_view b) noexcept;
+
+private:
+    std::string sql_;
+    unsigned flags_ = 0;
+    uint64_t hash_ = 0;
+    std::shared_ptr<const NamedParamParser::ParseResult> parsed_;
 };
 
 /**
  * @brief LRU cache of prepared statements with checkout/return pooling
  *
  * Provides caching mechanism for prepared statements to avoid repeated
- * preparation overhead. Uses LRU eviction policy over SQL keys.
+ * preparation overhead. Uses LRU eviction policy over SQL keys by default.
+ *
+ * StatementCachePolicy::CostAwareLfu instead scores each key by its
+ * estimated access frequency (a count-min sketch over all lookups, halved
+ * periodically) times its measured prepare time. When the cache is full a
+ * newly prepared key is admitted only if it outscores the lowest-scoring
+ * entry, which it then replaces; otherwise it is handed out unpooled. A
+ * burst of cheap one-off statements thus cannot flush expensive hot ones.
  *
  * Checkout semantics: get() hands each caller an EXCLUSIVE Statement
  * instance. While a caller (or a cursor retaining the statement) holds the
  * shared_ptr, nobody else receives the same instance — concurrent get()
  * calls for the same SQL receive additional instances prepared on demand
  * (still counted as key hits). When the last reference drops, the instance
- * returns to the per-key idle pool for reuse. This is what makes one
+ * returns to the per-key idle pool for reuse. Each key pools up to the
+ * highest number of its instances checked out at once over the last two
+ * demand windows (kDemandWindow lookups cache-wide), within the cache-wide
+ * maxIdleStatements budget; a key used by one caller at a time holds a
+ * single idle instance. This is what makes one
  * IStatement's single-cursor limit, setTimeout() and free() private to one
  * user instead of leaking across unrelated call sites.
  *
  * Thread-safety contract:
- * - Cache bookkeeping is protected by an internal mutex (shared with the
- *   checkout deleters so returns are safe at any time).
+ * - Entries live in kShardCount shards, each with its own mutex; a lookup
+ *   or checkout return locks only the shard of its key. Structural changes
+ *   (insert with eviction, remove, clear, resize) additionally serialise on
+ *   one structure mutex, which the hit path never takes.
+ * - prepare() runs outside every cache lock. Concurrent misses on the same
+ *   key are single-flighted: one caller prepares and creates the entry, the
+ *   others wait for it and then proceed as hits.
  * - A checked-out Statement instance remains bound to the owning Connection
  *   and is not safe to execute concurrently from multiple threads.
  */
@@ -73,12 +198,34 @@ public:
         unsigned flags;
         std::chrono::steady_clock::time_point lastUsed;
         size_t useCount = 0;
+        uint64_t lruTick = 0;     // Cache-wide use counter value at last use
+        uint64_t hash = 0;        // SqlKey::hashOf(sql, flags)
+        uint64_t id = 0;          // Unique per entry; checkouts return by id
+        uint64_t prepareMicros = 0; // Measured cost of preparing this SQL
+        // Demand: instances checked out now, and the most at once in the
+        // current / previous demand window (sizes the idle pool)
+        size_t checkedOut = 0;
+        size_t peakCheckedOut = 0;
+        size_t previousPeak = 0;
+        uint64_t windowStart = 0;   // lruTick the current window began at
+        std::shared_ptr<StatementTemplate> tmpl;   // Set when sharedTemplates is on
+        // Shared with every instance of this key while metrics are collected
+        std::shared_ptr<StatementMetrics> metrics;
 
         // Metadata about parameters
         std::vector<ParamInfo> inputParams;
         std::vector<ParamInfo> outputParams;
     };
 
+    /**
+     * @brief One exported hot-set entry (see getHotSet / saveHotSet)
+     */
+    struct HotEntry {
+        std::string sql;
+        unsigned flags = 0;
+        size_t useCount = 0;
+    };
+
     /**
      * @brief Cache statistics
      */
@@ -88,6 +235,33 @@ public:
         size_t missCount = 0;        // Cache misses
         size_t evictionCount = 0;    // Number of evictions
         double hitRate = 0.0;        // Hit rate percentage
+
+        // Contention counters
+        size_t lockContentionCount = 0;    // Shard lock acquisitions that had to block
+        size_t singleFlightWaitCount = 0;  // get() calls that waited for another thread's prepare
+        size_t concurrentPrepareCount = 0; // Extra instances prepared: all pooled ones checked out
+
+        // Idle pools
+        size_t idleCount = 0;          // Idle instances held across all keys
+        size_t idleDropCount = 0;      // Returned instances freed: key's pool or the budget full
+
+        size_t warmupCount = 0;      // Hot-set entries cached by warmUp() (their prepares count as misses)
+
+        // Eviction policy
+        StatementCachePolicy policy = StatementCachePolicy::Lru;   // Active policy
+        size_t admissionRejectCount = 0;   // New keys CostAwareLfu declined to cache
+        uint64_t prepareMicrosSaved = 0;   // Sum of cached prepare times over hits
+
+        /**
+         * @brief Hits and misses recorded while a policy was active
+         */
+        struct PolicyStatistics {
+            StatementCachePolicy policy = StatementCachePolicy::Lru;
+            size_t hitCount = 0;
+            size_t missCount = 0;
+            double hitRate = 0.0;    // Hit rate percentage
+        };
+        std::vector<PolicyStatistics> byPolicy;   // One element per policy
     };
 
 public:
@@ -106,12 +280,37 @@ public:
      * @brief Get or create cached statement
      * @param connection Connection to use for preparation
      * @param sql SQL query text
-     * @param flags Statement preparation flags
+     * @param flags Statement preparation flags; PREPARE_DEFAULT = the
+     *              connection's ConnectionOptions::prepareFlags
      * @return Shared pointer to cached statement
      */
     std::shared_ptr<Statement> get(Connection* connection,
                                    const std::string& sql,
-                                   unsigned flags = 0);
+                                   unsigned flags = Statement::PREPARE_DEFAULT);
+
+    /**
+     * @brief Get or create cached statement for a precomputed key
+     * @param connection Connection to use for preparation
+     * @param key Key built once by the caller (SQL text, flags and hash)
+     * @return Shared pointer to cached statement
+     */
+    std::shared_ptr<Statement> get(Connection* connection, const SqlKey& key);
+
+    /**
+     * @brief Check out a cached statement as a StatementLease
+     *
+     * Same lookup as get(), without the per-checkout shared_ptr: a hit
+     * allocates nothing. The instance goes back to the idle pool when the
+     * lease is destroyed or reset.
+     */
+    StatementLease lease(Connection* connection,
+                         const std::string& sql,
+                         unsigned flags = Statement::PREPARE_DEFAULT);
+
+    /**
+     * @brief Check out a cached statement for a precomputed key as a StatementLease
+     */
+    StatementLease lease(Connection* connection, const SqlKey& key);
 
     /**
      * @brief Clear all cached statements
@@ -124,7 +323,7 @@ public:
      * @param flags Statement preparation flags
      * @return true if statement was found and removed
      */
-    bool remove(const std::string& sql, unsigned flags = 0);
+    bool remove(const std::string& sql, unsigned flags = Statement::PREPARE_DEFAULT);
 
     /**
      * @brief Get cache statistics
@@ -136,7 +335,7 @@ public:
      * @brief Check if cache is enabled
      * @return true if cache is enabled
      */
-    bool isEnabled() const { return config_.enabled; }
+    bool isEnabled() const { return enabled_.load(std::memory_order_relaxed); }
 
     /**
      * @brief Set cache enabled state
@@ -148,7 +347,7 @@ public:
      * @brief Get maximum cache size
      * @return Maximum number of statements in cache
      */
-    size_t getMaxSize() const { return config_.maxSize; }
+    size_t getMaxSize() const { return maxSize_.load(std::memory_order_relaxed); }
 
     /**
      * @brief Set maximum cache size
@@ -156,37 +355,263 @@ public:
      */
     void setMaxSize(size_t maxSize);
 
+    /**
+     * @brief Set the idle instance budget (StatementCacheConfig::maxIdleStatements)
+     *
+     * A lower budget trims pools as their instances are checked out and
+     * returned, not at once.
+     */
+    void setMaxIdleStatements(size_t maxIdle);
+
+    /**
+     * @brief Get time-to-live for unused statements
+     * @return TTL in minutes (0 = no expiration)
+     */
+    size_t getTtlMinutes() const { return ttlMinutes_.load(std::memory_order_relaxed); }
+
     /**
      * @brief Set time-to-live for unused statements
      * @param ttlMinutes New TTL in minutes (0 disables expiration)
      */
     void setTtlMinutes(size_t ttlMinutes);
 
+    /**
+     * @brief Get active eviction policy
+     */
+    StatementCachePolicy getPolicy() const { return policy_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Switch eviction policy; cached entries are kept
+     */
+    void setPolicy(StatementCachePolicy policy);
+
+    /**
+     * @brief Whether per-key metrics are being collected
+     */
+    bool isCollectingMetrics() const { return collectMetrics_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Start / stop collecting per-key metrics
+     *
+     * Takes effect for instances checked out afterwards; metrics recorded
+     * so far stay readable through getMetrics().
+     */
+    void setCollectMetrics(bool collect);
+
+    /**
+     * @brief Whether metrics include server counter deltas
+     *        (StatementCacheConfig::captureServerCounters)
+     */
+    bool isCapturingServerCounters() const {
+        return captureServerCounters_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Start / stop capturing server counters; applies to the
+     *        metrics of every cached key right away
+     */
+    void setCaptureServerCounters(bool capture);
+
+    /**
+     * @brief Whether metrics split calls into phases
+     *        (StatementCacheConfig::profilePhases)
+     */
+    bool isProfilingPhases() const {
+        return profilePhases_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Start / stop the phase timers; applies to the metrics of
+     *        every cached key right away
+     */
+    void setProfilePhases(bool profile);
+
+    /**
+     * @brief Metrics of the cached keys, most total server time first
+     *        (execute + openCursor + fetch)
+     * @param limit Maximum number of entries (0 = all)
+     */
+    std::vector<StatementMetricsSnapshot> getMetrics(size_t limit = 0) const;
+
+    /**
+     * @brief Write getMetrics(limit) to the trace sink, one message per key
+     *        (component "StatementMetrics", latencies in microseconds)
+     */
+    void traceMetrics(fbpp::util::TraceLevel level = fbpp::util::TraceLevel::info,
+                      size_t limit = 0) const;
+
+    /**
+     * @brief Zero the metrics of every cached key
+     */
+    void resetMetrics();
+
+    /**
+     * @brief Estimated client bytes of the cached keys and their idle
+     *        instances (texts, parameter metadata, message buffers)
+     */
+    size_t estimateMemory() const;
+
+    /**
+     * @brief Shrink the cache towards `targetBytes` of estimateMemory()
+     *
+     * Drops idle instances beyond the first of each key, then evicts keys
+     * in the active policy's order until the estimate fits.
+     * @return The estimate afterwards
+     */
+    size_t shrinkTo(size_t targetBytes);
+
     /**
      * @brief Remove expired statements based on TTL
      * @return Number of statements removed
      */
     size_t removeExpired();
 
+    /**
+     * @brief Snapshot of the cached keys, most used first
+     * @param limit Maximum number of entries (0 = all)
+     */
+    std::vector<HotEntry> getHotSet(size_t limit = 0) const;
+
+    /**
+     * @brief Write getHotSet(limit) to a JSON file read by loadHotSet()
+     * @throws FirebirdException if the file cannot be written
+     */
+    void saveHotSet(const std::string& path, size_t limit = 0) const;
+
+    /**
+     * @brief Read a hot-set file, most used first
+     * @throws FirebirdException if the file cannot be read or parsed
+     */
+    static std::vector<HotEntry> loadHotSet(const std::string& path);
+
+    /**
+     * @brief Prepare and pool the given entries ahead of their first use
+     *
+     * Entries that fail to prepare (schema changed since the export) are
+     * traced and skipped.
+     * @param cancel Checked between entries; warm-up stops once it is true
+     * @return Number of entries now cached
+     */
+    size_t warmUp(Connection* connection, const std::vector<HotEntry>& entries,
+                  const std::atomic<bool>* cancel = nullptr);
+
 private:
+    struct Shard;
+    class FrequencySketch;
+
     /**
-     * @brief Generate cache key from SQL and flags
-     * @param sql SQL query text
-     * @param flags Statement preparation flags
-     * @return Cache key string
+     * @brief Eviction candidate chosen by selectVictim()
+     */
+    struct Victim {
+        Shard* shard = nullptr;
+        uint64_t hash = 0;
+        uint64_t id = 0;
+        uint64_t score = 0;       // 0 under Lru; frequency x cost otherwise
+        uint64_t lruTick = 0;     // Tie-breaker: older goes first
+    };
+
+    /**
+     * @brief A checked-out instance before it is wrapped for the caller
+     *
+     * `pooled` is false for an unpooled instance (cache disabled): the
+     * caller owns it outright and nothing is returned.
+     */
+    struct Checkout {
+        uint64_t hash = 0;
+        uint64_t entryId = 0;
+        std::shared_ptr<Statement> inner;
+        bool pooled = false;
+    };
+
+    /**
+     * @brief Shared implementation of the get() and lease() overloads
+     * @param hash SqlKey::hashOf(sql, flags)
+     * @param parsed NamedParamParser::parse(sql) if known, else null
+     */
+    Checkout lookup(
+        Connection* connection,
+        const std::string& sql,
+        unsigned flags,
+        uint64_t hash,
+        const std::shared_ptr<const NamedParamParser::ParseResult>& parsed = nullptr);
+
+    /**
+     * @brief Shard owning the given key hash
      */
-    std::string generateKey(const std::string& sql, unsigned flags) const;
+    Shard& shardFor(uint64_t hash);
 
     /**
-     * @brief Move statement to front of LRU list
-     * @param key Cache key
+     * @brief Find the entry for (sql, flags) among the entries with `hash`
+     *
+     * Identical text is accepted with one comparison; otherwise the texts
+     * are compared token-wise to rule out a hash collision.
+     * @note Must be called with the shard mutex held.
+     * @return Pointer to the entry or nullptr
      */
-    void touchEntry(const std::string& key);
+    static CachedStatement* findEntry(Shard& shard, const std::string& sql,
+                                      unsigned flags, uint64_t hash);
 
     /**
-     * @brief Evict least recently used statement
+     * @brief Lock a shard, counting the acquisition as contended if it blocks
      */
-    void evictLRU();
+    std::unique_lock<std::mutex> lockShard(Shard& shard) const;
+
+    /**
+     * @brief Mark an entry as most recently used
+     * @note Must be called with the entry's shard mutex held.
+     */
+    void touchEntry(CachedStatement& entry);
+
+    /**
+     * @brief Count one more checked-out instance of the entry
+     * @note Must be called with the entry's shard mutex held, after touchEntry().
+     */
+    static void beginCheckout(CachedStatement& entry);
+
+    /**
+     * @brief Idle instances the entry may keep under its demand
+     */
+    static size_t idleLimit(const CachedStatement& entry);
+
+    /**
+     * @brief Cache-wide idle budget in effect
+     */
+    size_t idleBudget() const;
+
+    /**
+     * @brief Retention score of a key under the active policy
+     */
+    uint64_t scoreOf(uint64_t hash, uint64_t prepareMicros) const;
+
+    /**
+     * @brief Find the entry the active policy evicts next: lowest score,
+     *        then smallest lruTick (pure LRU when every score is 0)
+     * @return false if the cache is empty
+     * @note Must be called with structureMutex_ held.
+     */
+    bool selectVictim(Victim& victim);
+
+    /**
+     * @brief Remove the entry picked by selectVictim()
+     * @param[out] victims Receives the evicted entry so its statements are
+     *             freed after the caller has released the cache locks
+     * @note Must be called with structureMutex_ held.
+     */
+    bool evictVictim(const Victim& victim,
+                     std::vector<std::unique_ptr<CachedStatement>>& victims);
+
+    /**
+     * @brief selectVictim() + evictVictim()
+     * @return false if there was nothing to evict
+     * @note Must be called with structureMutex_ held.
+     */
+    bool evictOne(std::vector<std::unique_ptr<CachedStatement>>& victims);
+
+    /**
+     * @brief Drop every entry of every shard into victims
+     * @note Must be called with structureMutex_ held.
+     */
+    void drainAll(std::vector<std::unique_ptr<CachedStatement>>& victims);
 
     /**
      * @brief Extract metadata from statement
@@ -208,8 +633,7 @@ private:
 
     /**
      * @brief Prepare a fresh Statement instance for the given (converted) SQL
-     * @note Must be called with core_->mutex held (prepare happens under the
-     *       cache lock, same as the original implementation).
+     * @note Called without any cache lock held.
      */
     std::shared_ptr<Statement> prepareInstance(
         Connection* connection,
@@ -221,56 +645,195 @@ private:
      * @brief Wrap an instance into a checkout handle whose deleter returns
      *        the instance to the idle pool on last release.
      */
-    std::shared_ptr<Statement> makeCheckout(std::string key,
-                                            std::shared_ptr<Statement> inner);
+    std::shared_ptr<Statement> makeCheckout(Checkout checkout);
 
     /**
      * @brief Return a checked-out instance to the idle pool.
-     * @note Must be called with core_->mutex held. Drops the instance if the
-     *       cache entry is gone, the cache is disabled, the instance was
-     *       free()d by the user, or the idle pool is full.
+     * @note Must be called with core_->mutex held shared; locks the key's
+     *       shard. Ends the checkout in the entry's demand count (also for a
+     *       null `inner`: a checkout whose prepare failed). Leaves `inner`
+     *       untouched (for the caller to destroy outside the shard lock) if
+     *       the cache entry is gone (evicted or replaced: ids differ), the
+     *       cache is disabled, the instance was free()d by the user, it is
+     *       still referenced elsewhere (a cursor opened through a lease), or
+     *       the key's pool or the idle budget is full.
      */
-    void returnToPool(const std::string& key, std::shared_ptr<Statement> inner);
+    void returnToPool(uint64_t hash, uint64_t entryId, std::shared_ptr<Statement>& inner);
 
 private:
+    friend class StatementLease;
+
     /**
      * @brief State shared between the cache and outstanding checkout deleters
      *
-     * The deleters keep a weak_ptr to this core; ~StatementCache marks it
-     * closed under the mutex, so late returns from user code safely degrade
-     * to plain destruction instead of touching a dead cache.
+     * The deleters keep a weak_ptr to this core and hold its mutex shared
+     * while returning (returns never contend with each other here);
+     * ~StatementCache marks it closed under the exclusive lock, so late
+     * returns from user code safely degrade to plain destruction instead of
+     * touching a dead cache.
      */
     struct PoolCore {
-        mutable std::mutex mutex;
+        mutable std::shared_mutex mutex;
         bool closed = false;
     };
 
-    // Cap of idle instances kept per SQL key; concurrency beyond this just
-    // re-prepares on demand.
-    static constexpr size_t kMaxIdlePerKey = 8;
+    /**
+     * @brief Prepare in progress for a key (single-flight marker)
+     */
+    struct InFlight {
+        std::string sql;            // For collision checks by waiters
+        unsigned flags = 0;
+        bool done = false;
+        std::exception_ptr error;   // Set when the leader's prepare failed
+    };
 
-    // Cache configuration
-    CacheConfig config_;
+    /**
+     * @brief One lock domain of the cache
+     */
+    struct Shard {
+        mutable std::mutex mutex;
+        std::condition_variable prepared;   // Signalled when an InFlight completes
+        // Keyed by SqlKey hash; a bucket holds more than one entry only on
+        // a genuine 64-bit collision, told apart by findEntry().
+        std::unordered_multimap<uint64_t, std::unique_ptr<CachedStatement>> entries;
+        std::unordered_multimap<uint64_t, std::shared_ptr<InFlight>> inFlight;
+    };
 
-    // Cache storage - map of key to cached statement
-    std::unordered_map<std::string, std::unique_ptr<CachedStatement>> cache_;
+    static constexpr size_t kPolicyCount = 2;
 
-    // LRU tracking - list of keys in order of use (front = most recent)
-    std::list<std::string> lruList_;
+    /**
+     * @brief Lock-free statistics counters
+     */
+    struct Counters {
+        std::atomic<size_t> hits{0};
+        std::atomic<size_t> misses{0};
+        std::atomic<size_t> evictions{0};
+        std::atomic<size_t> lockContention{0};
+        std::atomic<size_t> singleFlightWaits{0};
+        std::atomic<size_t> concurrentPrepares{0};
+        std::atomic<size_t> idleDrops{0};
+        std::atomic<size_t> warmups{0};
+        std::atomic<size_t> admissionRejects{0};
+        std::atomic<uint64_t> prepareMicrosSaved{0};
+        std::array<std::atomic<size_t>, kPolicyCount> policyHits{};
+        std::array<std::atomic<size_t>, kPolicyCount> policyMisses{};
+    };
 
-    // Map from key to position in LRU list for O(1) updates
-    std::unordered_map<std::string, std::list<std::string>::iterator> lruMap_;
+    static constexpr size_t kShardCount = 16;
+
+    // Lookups (cache-wide LRU clock ticks) per demand window; a key's pool
+    // follows the larger peak of the current and the previous window.
+    static constexpr uint64_t kDemandWindow = 4096;
+
+    // Cache configuration (read on the hot path without locks)
+    std::atomic<bool> enabled_;
+    std::atomic<size_t> maxSize_;
+    std::atomic<size_t> maxIdle_;        // 0 = 2 x maxSize_
+    std::atomic<size_t> ttlMinutes_;
+    const bool sharedTemplates_;
+    std::atomic<StatementCachePolicy> policy_;
+    std::atomic<bool> collectMetrics_;
+    std::atomic<bool> captureServerCounters_;
+    std::atomic<bool> profilePhases_;
+
+    // Cache storage - hash -> entry, spread over shards by hash
+    std::array<Shard, kShardCount> shards_;
+
+    // Serialises inserts/evictions/removals so size_ never overshoots
+    // maxSize_. Lock order: structureMutex_ before any shard mutex.
+    std::mutex structureMutex_;
+    std::atomic<size_t> size_{0};
+    std::atomic<size_t> idle_{0};        // Idle instances across all entries
+    uint64_t nextEntryId_ = 0;   // Guarded by structureMutex_
+
+    // LRU clock: entries record the value at last use; eviction picks the
+    // smallest. Replaces a global LRU list that every hit had to relink.
+    std::atomic<uint64_t> clock_{0};
+
+    // Access frequencies for CostAwareLfu (fed on every lookup while that
+    // policy is active; sized from the initial maxSize)
+    std::unique_ptr<FrequencySketch> sketch_;
 
     // Thread safety + checkout-deleter handshake
     std::shared_ptr<PoolCore> core_;
 
     // Statistics
-    mutable Statistics stats_;
+    mutable Counters counters_;
 
     // Disable copy
     StatementCache(const StatementCache&) = delete;
     StatementCache& operator=(const StatementCache&) = delete;
 };
 
+/**
+ * @brief Move-only checkout of a cached statement
+ *
+ * The allocation-free counterpart of the shared_ptr handed out by
+ * StatementCache::get(): it carries the pooled instance itself plus its
+ * key hash and entry id, and puts the instance back into the key's idle
+ * pool when destroyed or reset(). A cache hit creates no control block.
+ *
+ * Use it for statements executed in place (Transaction::execute takes it
+ * through statement()). An instance still referenced when the lease ends —
+ * a cursor opened from it keeps its statement — is not pooled again; it is
+ * freed with its last holder. Like the shared_ptr checkout it may outlive
+ * the cache: the return then degrades to plain destruction.
+ */
+class StatementLease {
+public:
+    StatementLease() = default;
+    ~StatementLease() { reset(); }
+
+    StatementLease(StatementLease&& other) noexcept
+        : cache_(std::exchange(other.cache_, nullptr)),
+          core_(std::move(other.core_)),
+          hash_(other.hash_),
+          entryId_(other.entryId_),
+          statement_(std::move(other.statement_)) {}
+
+    StatementLease& operator=(StatementLease&& other) noexcept {
+        if (this != &other) {
+            reset();
+            cache_ = std::exchange(other.cache_, nullptr);
+            core_ = std::move(other.core_);
+            hash_ = other.hash_;
+            entryId_ = other.entryId_;
+            statement_ = std::move(other.statement_);
+        }
+        return *this;
+    }
+
+    StatementLease(const StatementLease&) = delete;
+    StatementLease& operator=(const StatementLease&) = delete;
+
+    Statement* get() const noexcept { return statement_.get(); }
+    Statement* operator->() const noexcept { return statement_.get(); }
+    Statement& operator*() const noexcept { return *statement_; }
+    explicit operator bool() const noexcept { return statement_ != nullptr; }
+
+    // The pooled instance, for APIs taking a shared_ptr<Statement>; no copy
+    const std::shared_ptr<Statement>& statement() const noexcept { return statement_; }
+
+    // End the checkout now: return the instance to the pool (or free it)
+    void reset() noexcept;
+
+private:
+    friend class StatementCache;
+
+    StatementLease(StatementCache* cache, std::weak_ptr<StatementCache::PoolCore> core,
+                   StatementCache::Checkout checkout) noexcept
+        : cache_(checkout.pooled ? cache : nullptr),
+          core_(std::move(core)),
+          hash_(checkout.hash),
+          entryId_(checkout.entryId),
+          statement_(std::move(checkout.inner)) {}
+
+    StatementCache* cache_ = nullptr;   // Null: unpooled, nothing to return
+    std::weak_ptr<StatementCache::PoolCore> core_;
+    uint64_t hash_ = 0;
+    uint64_t entryId_ = 0;
+    std::shared_ptr<Statement> statement_;
+};
+
 } // namespace core
 } // namespace fbpp
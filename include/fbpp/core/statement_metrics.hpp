@@ -0,0 +1,382 @@
+#pragma once
+
+// Per-statement execution metrics, collected by StatementCache when
+// StatementCacheConfig::collectMetrics is on.
+//
+// One StatementMetrics object belongs to one cache key and is shared by
+// every Statement instance prepared for it (pooled or extra). Statement
+// times its server calls into it, the cursors it opens take a reference
+// and time their fetches; BLOB reads are attributed while a cursor of the
+// statement is the last one served on the thread (see BlobMetricsScope).
+// Recording is a pair of clock reads and a few relaxed atomic adds; with
+// metrics off the hot paths test one null pointer.
+//
+//   config.collectMetrics = true;
+//   ...
+//   for (const auto& m : conn.getStatementMetrics()) {
+//       std::cout << m.sql << " p99=" << m.execute.p99Micros << "us\n";
+//   }
+//   conn.traceStatementMetrics();    // one line per key to the trace sink
+//
+// With StatementCacheConfig::captureServerCounters as well, every execute
+// and every cursor (open to close) is bracketed by two attachment info
+// requests and the server's page / record counter deltas are added to the
+// key (ServerCounters). Each request is a round trip: this is a diagnosis
+// mode, not one to leave on in production.
+//
+// Built with FBPP_PROFILE (the CMake option of that name) and with
+// StatementCacheConfig::profilePhases on, every call is also split into
+// its phases: packing the input message, the Firebird call itself and
+// unpacking rows or RETURNING values, for Statement::execute(), cursors
+// and Batch. Each phase adds its nanoseconds and call count to the key
+// (PhaseBreakdown), which says whether a slow statement is slow on the
+// server or in conversion. Without FBPP_PROFILE the timers compile to
+// nothing.
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace fbpp {
+namespace core {
+
+/**
+ * @brief Summary of a LatencyHistogram (microseconds)
+ *
+ * Percentiles are bucket upper bounds (capped at the maximum seen), so
+ * they over-report by at most one bucket width: 1/8 of the value's power
+ * of two.
+ */
+struct LatencySnapshot {
+    uint64_t count = 0;
+    uint64_t totalMicros = 0;
+    uint64_t maxMicros = 0;
+    uint64_t p50Micros = 0;
+    uint64_t p90Micros = 0;
+    uint64_t p99Micros = 0;
+    uint64_t p999Micros = 0;
+
+    double meanMicros() const noexcept {
+        return count ? static_cast<double>(totalMicros) / static_cast<double>(count) : 0.0;
+    }
+};
+
+/**
+ * @brief Log-linear latency histogram (HDR-style), lock-free
+ *
+ * Values below 8 us land in exact buckets; above that every power of two
+ * is split into 8 linear sub-buckets (12.5 % resolution) up to 2^36 us
+ * (about 19 hours), larger values go to the last bucket. record() is a
+ * handful of relaxed atomic adds and safe from any thread; snapshots taken
+ * concurrently may be off by the records in flight.
+ */
+class LatencyHistogram {
+public:
+    static constexpr unsigned kSubBucketBits = 3;
+    static constexpr unsigned kSubBuckets = 1u << kSubBucketBits;
+    static constexpr unsigned kMaxExponent = 36;
+    static constexpr size_t kBucketCount = (kMaxExponent - kSubBucketBits + 2) * kSubBuckets;
+
+    void record(uint64_t micros) noexcept;
+
+    void record(std::chrono::steady_clock::duration elapsed) noexcept {
+        const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+        record(static_cast<uint64_t>(micros < 0 ? 0 : micros));
+    }
+
+    /**
+     * @brief Smallest bucket upper bound covering fraction q (0..1) of the
+     *        recorded values; 0 when empty
+     */
+    uint64_t percentile(double q) const noexcept;
+
+    uint64_t count() const noexcept { return count_.load(std::memory_order_relaxed); }
+
+    LatencySnapshot snapshot() const noexcept;
+
+    void reset() noexcept;
+
+    /// Bucket of a value and the largest value it holds (exposed for tests)
+    static size_t bucketOf(uint64_t micros) noexcept;
+    static uint64_t bucketUpperBound(size_t bucket) noexcept;
+
+private:
+    std::array<std::atomic<uint64_t>, kBucketCount> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> total_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+/**
+ * @brief Record-level counters of one table (isc_info_*_count items)
+ */
+struct TableRecordCounters {
+    uint16_t relationId = 0;      // RDB$RELATIONS.RDB$RELATION_ID
+    uint64_t seqReads = 0;        // Records read by natural (full scan) access
+    uint64_t idxReads = 0;        // Records read through an index
+    uint64_t inserts = 0;
+    uint64_t updates = 0;
+    uint64_t deletes = 0;
+    uint64_t backouts = 0;
+    uint64_t purges = 0;
+    uint64_t expunges = 0;
+
+    TableRecordCounters& operator+=(const TableRecordCounters& other) noexcept;
+};
+
+/**
+ * @brief Attachment performance counters (Connection::getServerCounters)
+ *
+ * Page-level counters of the attachment plus the record counters of every
+ * table it has touched, sorted by relation id. Absolute values grow for
+ * the attachment's lifetime; delta() turns two readings into the work
+ * done in between.
+ */
+struct ServerCounters {
+    uint64_t reads = 0;           // Pages read from disk
+    uint64_t writes = 0;          // Pages written to disk
+    uint64_t fetches = 0;         // Pages fetched from the page cache
+    uint64_t marks = 0;           // Pages marked dirty in the cache
+    std::vector<TableRecordCounters> tables;
+
+    /// Record counters summed over all tables (relationId 0)
+    TableRecordCounters totals() const noexcept;
+
+    /// after - before, keeping only tables with a non-zero difference
+    static ServerCounters delta(const ServerCounters& after, const ServerCounters& before);
+
+    ServerCounters& operator+=(const ServerCounters& other);
+};
+
+/// Parts of a call timed under FBPP_PROFILE (see the file comment)
+enum class Phase : uint8_t {
+    Pack,     // Parameters into the input message
+    Wire,     // The Firebird call: execute, open, fetch round, IBatch add / execute
+    Unpack,   // Output message into the caller's row type
+};
+
+inline constexpr size_t kPhaseCount = 3;
+
+/// Time spent in one Phase
+struct PhaseTotals {
+    uint64_t calls = 0;
+    uint64_t totalNanos = 0;
+
+    double meanNanos() const noexcept {
+        return calls ? static_cast<double>(totalNanos) / static_cast<double>(calls) : 0.0;
+    }
+};
+
+/// Per-phase totals of one key, indexed by Phase
+struct PhaseBreakdown {
+    std::array<PhaseTotals, kPhaseCount> phases{};
+
+    const PhaseTotals& operator[](Phase phase) const noexcept {
+        return phases[static_cast<size_t>(phase)];
+    }
+
+    uint64_t totalNanos() const noexcept {
+        uint64_t total = 0;
+        for (const auto& phase : phases) {
+            total += phase.totalNanos;
+        }
+        return total;
+    }
+
+    bool empty() const noexcept { return totalNanos() == 0; }
+};
+
+/**
+ * @brief Metrics of one cached statement key (see the file comment)
+ */
+class StatementMetrics {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void recordPrepare(Clock::duration elapsed) noexcept { prepare_.record(elapsed); }
+
+    void recordExecute(Clock::duration elapsed, uint64_t inBytes, uint64_t outBytes,
+                       uint64_t affectedRows) noexcept {
+        execute_.record(elapsed);
+        add(messageBytesIn_, inBytes);
+        add(messageBytesOut_, outBytes);
+        add(rowsAffected_, affectedRows);
+    }
+
+    void recordOpenCursor(Clock::duration elapsed, uint64_t inBytes) noexcept {
+        openCursor_.record(elapsed);
+        add(messageBytesIn_, inBytes);
+    }
+
+    /// One server fetch round (a single row, or a prefetch window refill)
+    void recordFetch(Clock::duration elapsed, uint64_t rows, uint64_t bytes) noexcept {
+        fetch_.record(elapsed);
+        add(rowsFetched_, rows);
+        add(messageBytesOut_, bytes);
+    }
+
+    void recordBlobBytes(uint64_t bytes) noexcept { add(blobBytes_, bytes); }
+
+    /// Whether Statement / ResultSet bracket their server calls with
+    /// attachment counter readings (StatementCache keeps this in sync
+    /// with StatementCacheConfig::captureServerCounters)
+    bool capturesServerCounters() const noexcept {
+        return captureServerCounters_.load(std::memory_order_relaxed);
+    }
+    void setCaptureServerCounters(bool capture) noexcept {
+        captureServerCounters_.store(capture, std::memory_order_relaxed);
+    }
+
+    /// Whether the phase timers record (StatementCache keeps this in sync
+    /// with StatementCacheConfig::profilePhases; no effect without FBPP_PROFILE)
+    bool profilesPhases() const noexcept {
+        return profilePhases_.load(std::memory_order_relaxed);
+    }
+    void setProfilePhases(bool profile) noexcept {
+        profilePhases_.store(profile, std::memory_order_relaxed);
+    }
+
+    void recordPhase(Phase phase, Clock::duration elapsed) noexcept {
+        const auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        auto& totals = phases_[static_cast<size_t>(phase)];
+        totals.calls.fetch_add(1, std::memory_order_relaxed);
+        add(totals.nanos, static_cast<uint64_t>(nanos < 0 ? 0 : nanos));
+    }
+
+    PhaseBreakdown phases() const noexcept;
+
+    /// Add the counter delta of one execute or cursor
+    void recordServerCounters(const ServerCounters& delta);
+
+    /// Accumulated deltas and the number of calls they cover
+    ServerCounters serverCounters() const;
+    uint64_t serverSamples() const noexcept { return serverSamples_.load(std::memory_order_relaxed); }
+
+    const LatencyHistogram& prepare() const noexcept { return prepare_; }
+    const LatencyHistogram& execute() const noexcept { return execute_; }
+    const LatencyHistogram& openCursor() const noexcept { return openCursor_; }
+    const LatencyHistogram& fetch() const noexcept { return fetch_; }
+
+    uint64_t rowsFetched() const noexcept { return rowsFetched_.load(std::memory_order_relaxed); }
+    uint64_t rowsAffected() const noexcept { return rowsAffected_.load(std::memory_order_relaxed); }
+    uint64_t messageBytesIn() const noexcept { return messageBytesIn_.load(std::memory_order_relaxed); }
+    uint64_t messageBytesOut() const noexcept { return messageBytesOut_.load(std::memory_order_relaxed); }
+    uint64_t blobBytes() const noexcept { return blobBytes_.load(std::memory_order_relaxed); }
+
+    void reset() noexcept;
+
+private:
+    static void add(std::atomic<uint64_t>& counter, uint64_t value) noexcept {
+        if (value) {
+            counter.fetch_add(value, std::memory_order_relaxed);
+        }
+    }
+
+    LatencyHistogram prepare_;
+    LatencyHistogram execute_;
+    LatencyHistogram openCursor_;
+    LatencyHistogram fetch_;
+    std::atomic<uint64_t> rowsFetched_{0};
+    std::atomic<uint64_t> rowsAffected_{0};
+    std::atomic<uint64_t> messageBytesIn_{0};    // Input messages sent
+    std::atomic<uint64_t> messageBytesOut_{0};   // Output messages received (rows, RETURNING)
+    std::atomic<uint64_t> blobBytes_{0};         // BLOB content read
+    std::atomic<bool> captureServerCounters_{false};
+    std::atomic<bool> profilePhases_{false};
+    struct PhaseCounters {
+        std::atomic<uint64_t> calls{0};
+        std::atomic<uint64_t> nanos{0};
+    };
+    std::array<PhaseCounters, kPhaseCount> phases_{};
+    std::atomic<uint64_t> serverSamples_{0};
+    mutable std::mutex serverMutex_;             // Guards server_ (opt-in path only)
+    ServerCounters server_;
+};
+
+/**
+ * @brief Point-in-time copy of one key's metrics (StatementCache::getMetrics)
+ */
+struct StatementMetricsSnapshot {
+    std::string sql;
+    unsigned flags = 0;
+    size_t useCount = 0;          // Cache checkouts of the key
+    LatencySnapshot prepare;      // Every prepare of the key, extra instances included
+    LatencySnapshot execute;
+    LatencySnapshot openCursor;
+    LatencySnapshot fetch;        // Per server fetch round
+    uint64_t rowsFetched = 0;
+    uint64_t rowsAffected = 0;    // As counted by execute() (0 where not requested)
+    uint64_t messageBytesIn = 0;
+    uint64_t messageBytesOut = 0;
+    uint64_t blobBytes = 0;
+    uint64_t serverSamples = 0;   // Executes / cursors covered by `server`
+    ServerCounters server;        // Summed deltas (captureServerCounters)
+    PhaseBreakdown phases;        // FBPP_PROFILE with profilePhases; empty otherwise
+
+    static StatementMetricsSnapshot of(const StatementMetrics& metrics);
+};
+
+namespace detail {
+
+/**
+ * @brief Adds the time until the end of its scope to one Phase of
+ *        `metrics`, when FBPP_PROFILE is defined and the key profiles
+ *
+ * Without FBPP_PROFILE an empty object the compiler drops; with it, a
+ * disabled timer costs a null test and one relaxed load.
+ */
+class PhaseTimer {
+public:
+#if defined(FBPP_PROFILE)
+    PhaseTimer(StatementMetrics* metrics, Phase phase) noexcept
+        : metrics_(metrics && metrics->profilesPhases() ? metrics : nullptr),
+          phase_(phase),
+          started_(metrics_ ? StatementMetrics::Clock::now()
+                            : StatementMetrics::Clock::time_point{}) {}
+
+    ~PhaseTimer() {
+        if (metrics_) {
+            metrics_->recordPhase(phase_, StatementMetrics::Clock::now() - started_);
+        }
+    }
+#else
+    constexpr PhaseTimer(StatementMetrics*, Phase) noexcept {}
+#endif
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+#if defined(FBPP_PROFILE)
+    StatementMetrics* metrics_;
+    Phase phase_;
+    StatementMetrics::Clock::time_point started_;
+#endif
+};
+
+/**
+ * @brief Thread-local BLOB byte attribution target
+ *
+ * ResultSet makes its statement's metrics current whenever it serves a
+ * row, and clears them again on close(); Transaction::loadBlob() reports
+ * the bytes it reads to whatever is current on the calling thread.
+ * BLOBs read through BlobReader / openBlob() directly are not attributed.
+ */
+struct BlobMetricsScope {
+    /// Held weakly: a cursor finished on another thread leaves no dangling target
+    static void set(const std::shared_ptr<StatementMetrics>& metrics) noexcept;
+    /// Clear only if `metrics` is still the current target
+    static void release(const StatementMetrics* metrics) noexcept;
+    static void noteBytes(uint64_t bytes) noexcept;
+};
+
+} // namespace detail
+
+} // namespace core
+} // namespace fbpp
@@ -0,0 +1,252 @@
+#pragma once
+
+// StatementPipeline — queue the DML steps of one business transaction and
+// run them with as few round trips as the wire allows.
+//
+// Every Transaction::execute() is its own round trip. StatementPipeline
+// collects steps (prepared statement + parameters) and, on flush(), runs
+// each run of consecutive steps on the same statement as one Batch (one
+// IBatch execute for the whole run); steps that cannot be batched
+// (RETURNING, lone steps) are executed directly. Results and errors come
+// back per step, in queue order.
+//
+//   StatementPipeline pipe(tx);
+//   pipe.add(insertLine, std::make_tuple(order, 1, "pen"));
+//   pipe.add(insertLine, std::make_tuple(order, 2, "ink"));   // same run
+//   pipe.add(updateTotal, std::make_tuple(total, order));
+//   auto result = pipe.flush();                               // 2 round trips
+//
+// Firebird has no API to send different statements in one packet, so
+// order dependent steps on different statements still cost a round trip
+// each; group same-statement steps together where the logic allows.
+// Parameters are copied when queued. One pipeline belongs to one thread.
+
+#include "fbpp/core/batch.hpp"
+#include "fbpp/core/batch_impl.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/transaction_impl.hpp"
+#include "fbpp/core/exception.hpp"
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fbpp::core {
+
+/**
+ * @brief Error and batching policy of a StatementPipeline
+ */
+struct StatementPipelineOptions {
+    // Stop at the first failed step; later steps are reported Skipped.
+    // false runs every step (batches with TAG_MULTIERROR).
+    bool stopOnError = true;
+    // Consecutive same-statement steps needed to use a Batch; shorter
+    // runs execute directly. 0 never batches.
+    size_t minBatchRun = 2;
+};
+
+enum class PipelineStepStatus {
+    Ok,
+    Failed,
+    Skipped     // Not run: an earlier step failed under stopOnError
+};
+
+struct PipelineStepResult {
+    PipelineStepStatus status = PipelineStepStatus::Skipped;
+    // Rows affected; -1 when the server did not report a count
+    long long affected = 0;
+    std::string error;
+};
+
+struct PipelineResult {
+    std::vector<PipelineStepResult> steps;   // Queue order
+    size_t failedCount = 0;
+    size_t batches = 0;                      // Batch executes issued
+    size_t directExecutes = 0;               // Transaction::execute() calls
+
+    bool ok() const { return failedCount == 0 && skippedCount() == 0; }
+
+    size_t skippedCount() const {
+        size_t skipped = 0;
+        for (const auto& step : steps) {
+            skipped += step.status == PipelineStepStatus::Skipped;
+        }
+        return skipped;
+    }
+};
+
+/**
+ * @brief Queue of statement executions inside one Transaction
+ */
+class StatementPipeline {
+public:
+    explicit StatementPipeline(std::shared_ptr<Transaction> transaction,
+                               StatementPipelineOptions options = {})
+        : transaction_(std::move(transaction)), options_(options) {
+        if (!transaction_) {
+            throw FirebirdException("StatementPipeline: transaction required");
+        }
+    }
+
+    /**
+     * @brief Queue `statement` with `params` (tuple, JSON or described struct)
+     */
+    template<typename Params>
+    void add(std::shared_ptr<Statement> statement, Params params) {
+        if (!statement) {
+            throw FirebirdException("StatementPipeline: statement required");
+        }
+        auto shared = std::make_shared<Params>(std::move(params));
+        Step step;
+        step.statement = std::move(statement);
+        step.addTo = [shared](Batch& batch) { batch.add(*shared); };
+        step.execute = [shared](Transaction& tx, const std::shared_ptr<Statement>& stmt) {
+            return tx.execute(stmt, *shared);
+        };
+        steps_.push_back(std::move(step));
+    }
+
+    /**
+     * @brief Queue `statement` without parameters
+     *
+     * Never batched: IBatch needs an input message.
+     */
+    void add(std::shared_ptr<Statement> statement) {
+        if (!statement) {
+            throw FirebirdException("StatementPipeline: statement required");
+        }
+        Step step;
+        step.statement = std::move(statement);
+        step.execute = [](Transaction& tx, const std::shared_ptr<Statement>& stmt) {
+            return tx.execute(stmt);
+        };
+        steps_.push_back(std::move(step));
+    }
+
+    size_t size() const { return steps_.size(); }
+    bool empty() const { return steps_.empty(); }
+
+    /// Drop queued steps without running them
+    void clear() { steps_.clear(); }
+
+    /**
+     * @brief Run every queued step and empty the queue
+     *
+     * Failed steps do not end the transaction; commit or roll back is up
+     * to the caller.
+     */
+    PipelineResult flush() {
+        std::vector<Step> steps;
+        steps.swap(steps_);
+
+        PipelineResult result;
+        result.steps.resize(steps.size());
+        bool stopped = false;
+
+        for (size_t first = 0; first < steps.size() && !stopped;) {
+            size_t last = first + 1;
+            while (last < steps.size() && steps[last].statement == steps[first].statement &&
+                   steps[last].addTo) {
+                ++last;
+            }
+
+            const bool batchable = steps[first].addTo && options_.minBatchRun != 0 &&
+                                   last - first >= options_.minBatchRun &&
+                                   !steps[first].statement->hasOutput();
+            if (batchable) {
+                stopped = runBatch(steps, first, last, result);
+            } else {
+                for (size_t i = first; i < last && !stopped; ++i) {
+                    stopped = runDirect(steps[i], result.steps[i], result);
+                }
+            }
+            first = last;
+        }
+        return result;
+    }
+
+    const StatementPipelineOptions& options() const { return options_; }
+
+private:
+    struct Step {
+        std::shared_ptr<Statement> statement;
+        std::function<void(Batch&)> addTo;   // Empty: no parameters, never batched
+        std::function<unsigned(Transaction&, const std::shared_ptr<Statement>&)> execute;
+    };
+
+    // Returns true when the pipeline must stop.
+    bool runDirect(Step& step, PipelineStepResult& out, PipelineResult& result) {
+        ++result.directExecutes;
+        try {
+            out.affected = step.execute(*transaction_, step.statement);
+            out.status = PipelineStepStatus::Ok;
+            return false;
+        } catch (const std::exception& e) {
+            out.status = PipelineStepStatus::Failed;
+            out.error = e.what();
+            ++result.failedCount;
+            return options_.stopOnError;
+        }
+    }
+
+    bool runBatch(std::vector<Step>& steps, size_t first, size_t last, PipelineResult& result) {
+        ++result.batches;
+        BatchResult batchResult;
+        try {
+            BatchOptions batchOptions;
+            batchOptions.continueOnError = !options_.stopOnError;
+            auto batch = steps[first].statement->createBatch(transaction_.get(), batchOptions);
+            for (size_t i = first; i < last; ++i) {
+                steps[i].addTo(*batch);
+            }
+            batchResult = batch->execute(transaction_.get());
+        } catch (const std::exception& e) {
+            // The batch never ran: the whole run failed as one.
+            for (size_t i = first; i < last; ++i) {
+                auto& out = result.steps[i];
+                out.status = PipelineStepStatus::Failed;
+                out.error = e.what();
+                ++result.failedCount;
+            }
+            return options_.stopOnError;
+        }
+
+        const auto& states = batchResult.perMessageStatus;
+        bool failed = false;
+        for (size_t i = first; i < last; ++i) {
+            const size_t message = i - first;
+            auto& out = result.steps[i];
+            if (message >= states.size()) {
+                continue;   // Not reached: the batch stopped at an earlier failure
+            }
+            const int state = states[message];
+            if (state == Firebird::IBatchCompletionState::EXECUTE_FAILED) {
+                out.status = PipelineStepStatus::Failed;
+                out.error = "execute failed";
+                ++result.failedCount;
+                failed = true;
+            } else {
+                out.status = PipelineStepStatus::Ok;
+                out.affected = state == Firebird::IBatchCompletionState::SUCCESS_NO_INFO ? -1 : state;
+            }
+        }
+        for (size_t e = 0; e < batchResult.errors.size() && e < batchResult.errorIndices.size(); ++e) {
+            const size_t i = first + batchResult.errorIndices[e];
+            if (i < last) {
+                result.steps[i].error = batchResult.errors[e];
+            }
+        }
+        return failed && options_.stopOnError;
+    }
+
+    std::shared_ptr<Transaction> transaction_;
+    StatementPipelineOptions options_;
+    std::vector<Step> steps_;
+};
+
+} // namespace fbpp::core
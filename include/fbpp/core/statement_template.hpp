@@ -0,0 +1,190 @@
+#pragma once
+
+// Process-wide registry of connection-independent prepare work.
+//
+// A StatementCache is per Connection, so N connections running the same
+// SQL each parse its named parameters and decode the same input/output
+// message layouts N times. A StatementTemplate holds that work once for a
+// (database scope, SQL, flags) key; per-connection caches then only do the
+// final IAttachment::prepare and hand the shared layouts to the new
+// Statement (MessageMetadata re-checks the binary shape before adopting).
+//
+// Scope is Connection::getTemplateScope() — database, connection charset
+// and dialect, the inputs that change the metadata Firebird describes for
+// the same text. The registry holds templates weakly: a template lives as
+// long as some connection's cache entry references it.
+//
+// Enabled per cache via StatementCacheConfig::sharedTemplates.
+//
+// The registry also numbers schema changes per scope (invalidate()):
+// connections compare the epoch with the one their statement cache was
+// filled under and start over when it moved (see
+// StatementCacheConfig::followSchemaChanges), whether or not they share
+// templates.
+
+#include "fbpp/core/message_metadata.hpp"
+#include "fbpp/core/named_param_parser.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fbpp {
+namespace core {
+
+class Statement;
+
+/**
+ * @brief Connection-independent part of a prepared statement
+ *
+ * The parse results are fixed at construction. The metadata layouts are
+ * published by the first connection that prepares the SQL and may be
+ * dropped again by StatementTemplateRegistry::invalidate().
+ */
+class StatementTemplate {
+public:
+    /// `parsed`: NamedParamParser::parse(sql) if the caller has it, else null
+    StatementTemplate(std::string scope, std::string sql, unsigned flags, uint64_t hash,
+                      const NamedParamParser::ParseResult* parsed = nullptr);
+
+    StatementTemplate(const StatementTemplate&) = delete;
+    StatementTemplate& operator=(const StatementTemplate&) = delete;
+
+    const std::string& scope() const noexcept { return scope_; }
+    const std::string& sql() const noexcept { return sql_; }
+    unsigned flags() const noexcept { return flags_; }
+    uint64_t hash() const noexcept { return hash_; }
+
+    /// SQL sent to IAttachment::prepare (named parameters replaced by '?')
+    const std::string& actualSql() const noexcept { return hasNamedParams_ ? actualSql_ : sql_; }
+    bool hasNamedParams() const noexcept { return hasNamedParams_; }
+    const std::unordered_map<std::string, std::vector<size_t>>& nameToPositions() const noexcept {
+        return nameToPositions_;
+    }
+
+    /**
+     * @brief Seed a fresh statement with the published layouts, if any
+     * @return true if layouts were published and handed to the statement
+     */
+    bool applyLayouts(Statement& statement) const;
+
+    /**
+     * @brief Publish the statement's decoded layouts unless already present
+     */
+    void publishLayouts(const Statement& statement);
+
+    /**
+     * @brief Forget published layouts and stop sharing new ones
+     *
+     * The schema may have changed; statements prepared from this template
+     * afterwards decode their own metadata.
+     */
+    void dropLayouts();
+
+    /**
+     * @brief true once layouts have been published
+     */
+    bool hasLayouts() const;
+
+private:
+    std::string scope_;
+    std::string sql_;
+    unsigned flags_;
+    uint64_t hash_;
+
+    std::string actualSql_;
+    std::unordered_map<std::string, std::vector<size_t>> nameToPositions_;
+    bool hasNamedParams_ = false;
+
+    mutable std::mutex mutex_;   // Guards the layouts below
+    bool published_ = false;
+    bool retired_ = false;
+    std::shared_ptr<const MetadataLayout> inputLayout_;
+    std::shared_ptr<const MetadataLayout> outputLayout_;
+};
+
+/**
+ * @brief Process-wide (scope, SQL, flags) -> StatementTemplate map
+ *
+ * Consulted only when a per-connection cache prepares; cache hits never
+ * touch it, so one mutex is enough.
+ */
+class StatementTemplateRegistry {
+public:
+    struct Statistics {
+        size_t templateCount = 0;   // Live templates
+        size_t hitCount = 0;        // acquire() found a live template
+        size_t missCount = 0;       // acquire() created a template
+        size_t layoutReuseCount = 0; // Prepares seeded with published layouts
+    };
+
+    static StatementTemplateRegistry& instance();
+
+    /**
+     * @brief Find or create the template for a key
+     * @param hash SqlKey::hashOf(sql, flags)
+     * @param parsed NamedParamParser::parse(sql) if known, else null
+     */
+    std::shared_ptr<StatementTemplate> acquire(
+        const std::string& scope,
+        const std::string& sql,
+        unsigned flags,
+        uint64_t hash,
+        const NamedParamParser::ParseResult* parsed = nullptr);
+
+    /**
+     * @brief Drop layouts of every template of a scope and unregister them
+     *
+     * Called after DDL; connections already holding such a template keep
+     * its parse results but re-decode metadata on their next prepare.
+     * @return The scope's new schema epoch
+     */
+    uint64_t invalidate(const std::string& scope);
+
+    /**
+     * @brief invalidate() calls of `scope` so far
+     */
+    uint64_t schemaEpoch(const std::string& scope) const;
+
+    /**
+     * @brief invalidate() calls of every scope so far
+     *
+     * One atomic load: connections check it before each cached prepare and
+     * look up their scope's epoch only when it moved.
+     */
+    uint64_t schemaChanges() const noexcept { return changes_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Unregister every template
+     */
+    void clear();
+
+    Statistics getStatistics() const;
+
+    /// Counted by StatementCache when a prepare adopts published layouts
+    void noteLayoutReuse();
+
+private:
+    StatementTemplateRegistry() = default;
+
+    /// Remove expired weak entries. @note Must be called with mutex_ held.
+    void purgeExpired();
+
+    mutable std::mutex mutex_;
+    // Keyed by SqlKey hash; scope/flags/text are checked on lookup.
+    std::unordered_multimap<uint64_t, std::weak_ptr<StatementTemplate>> templates_;
+    size_t purgeThreshold_ = 64;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+    size_t layoutReuses_ = 0;
+    std::unordered_map<std::string, uint64_t> epochs_;   // By scope
+    std::atomic<uint64_t> changes_{0};
+};
+
+} // namespace core
+} // namespace fbpp
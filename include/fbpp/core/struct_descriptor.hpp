@@ -1,7 +1,9 @@
 #pragma once
 
 #include "fbpp/core/detail/sql_value_codec.hpp"
+#include "fbpp/core/detail/text_scan.hpp"
 #include "fbpp/core/exception.hpp"
+#include "fbpp/core/message_builder.hpp"
 #include "fbpp/core/message_metadata.hpp"
 #include "fbpp/core/firebird_compat.hpp"
 #include "fbpp/core/transaction.hpp"
@@ -11,7 +13,9 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <memory>
 #include <type_traits>
+#include <typeindex>
 #include <tuple>
 #include <utility>
 #include <optional>
@@ -41,6 +45,12 @@ struct is_optional<std::optional<T>> : std::true_type {};
 template<typename T>
 inline constexpr bool is_optional_v = is_optional<T>::value;
 
+template<typename T>
+struct unwrap_optional { using type = T; };
+
+template<typename T>
+struct unwrap_optional<std::optional<T>> { using type = T; };
+
 // ============================================================================
 // FieldDescriptor Implementation
 // ============================================================================
@@ -212,7 +222,7 @@ void packField(
     const FieldDescriptor<T, FieldType>& descriptor,
     std::size_t index
 ) {
-    const FieldInfo& fieldInfo = metadata->getField(static_cast<unsigned>(index));
+    const FieldInfo& fieldInfo = metadata->getFieldRef(static_cast<unsigned>(index));
 
     // Validate SQL type match
     if (descriptor.sqlType != fieldInfo.type) {
@@ -258,7 +268,7 @@ void unpackField(
     const FieldDescriptor<T, FieldType>& descriptor,
     std::size_t index
 ) {
-    const FieldInfo& fieldInfo = metadata->getField(static_cast<unsigned>(index));
+    const FieldInfo& fieldInfo = metadata->getFieldRef(static_cast<unsigned>(index));
 
     // Validate SQL type match
     if (descriptor.sqlType != fieldInfo.type) {
@@ -323,6 +333,361 @@ void unpackStructImpl(
                  std::get<Indexes>(fields), Indexes), ...);
 }
 
+// ============================================================================
+// Pinned Decoding
+// ============================================================================
+
+// A descriptor that declares `static constexpr bool pinned_decode = true`
+// (query_generator output does) promises that each field's sqlType and scale
+// are exactly what the server will describe. Its fields are then read by a
+// decoder picked at compile time from (C++ type, sqlType, scale): a typed
+// load with no per-row type check and no codec switch. The promise is
+// checked once per MessageMetadata; if any column differs, rows go through
+// unpackField as before.
+
+template<typename T>
+inline constexpr bool pinned_decode_v = [] {
+    if constexpr (requires { StructDescriptor<T>::pinned_decode; }) {
+        return static_cast<bool>(StructDescriptor<T>::pinned_decode);
+    } else {
+        return false;
+    }
+}();
+
+// A descriptor may also carry the layout of its message as described when
+// it was generated (query_generator emits these next to pinned_decode):
+//
+//   static constexpr std::uint64_t layout_hash = ...;          // messageLayoutHash()
+//   static constexpr std::array<unsigned, N> offsets = {...};
+//   static constexpr std::array<unsigned, N> null_offsets = {...};
+//
+// When layout_hash equals the live metadata's MetadataLayout::layoutHash
+// (one compare per MessageMetadata), the offsets are compile-time constants
+// as well, and PinnedLayout / PackPlan read and write rows as straight-line
+// code. Any other hash falls back to the checks above.
+
+template<typename T>
+inline constexpr bool exact_layout_v = requires {
+    StructDescriptor<T>::layout_hash;
+    StructDescriptor<T>::offsets;
+    StructDescriptor<T>::null_offsets;
+};
+
+/**
+ * @brief True if V has a direct reader for columns of SqlType at Scale
+ *
+ * Only pairs for which the read is lossless and matches sql_value_codec:
+ * integers from same-or-narrower columns at scale 0, floats from
+ * FLOAT/DOUBLE, bool from BOOLEAN, std::string / FixedString from CHAR/VARCHAR. Other
+ * types are read by the codec, which already resolves them at compile time.
+ */
+template<typename V, unsigned SqlType, int Scale>
+constexpr bool has_pinned_reader() {
+    if constexpr (has_type_adapter_v<V>) {
+        return false;
+    } else if constexpr (std::is_integral_v<V> && std::is_signed_v<V> && !std::is_same_v<V, bool>) {
+        return Scale == 0 &&
+               ((SqlType == SQL_SHORT && sizeof(V) >= sizeof(int16_t)) ||
+                (SqlType == SQL_LONG && sizeof(V) >= sizeof(int32_t)) ||
+                (SqlType == SQL_INT64 && sizeof(V) >= sizeof(int64_t)));
+    } else if constexpr (std::is_floating_point_v<V>) {
+        return Scale == 0 && (SqlType == SQL_FLOAT || SqlType == SQL_DOUBLE);
+    } else if constexpr (std::is_same_v<V, bool>) {
+        return SqlType == SQL_BOOLEAN;
+    } else if constexpr (std::is_same_v<V, std::string> || is_fixed_string_v<V>) {
+        return SqlType == SQL_TEXT || SqlType == SQL_VARYING;
+    } else {
+        return false;
+    }
+}
+
+template<typename V, unsigned SqlType>
+inline void pinned_read(const uint8_t* dataPtr, const FieldInfo& field, V& value) {
+    if constexpr (std::is_same_v<V, std::string> || is_fixed_string_v<V>) {
+        const auto* chars = reinterpret_cast<const char*>(dataPtr);
+        std::size_t length = 0;
+        if constexpr (SqlType == SQL_VARYING) {
+            uint16_t prefix = 0;
+            std::memcpy(&prefix, dataPtr, sizeof(prefix));
+            length = prefix;
+            chars += sizeof(uint16_t);
+        } else {
+            length = trimmedLength(chars, field.length);
+        }
+        if constexpr (is_fixed_string_v<V>) {
+            if (length > value.capacity()) {
+                throw FirebirdException(
+                    "String value too long for FixedString<" + std::to_string(value.capacity()) +
+                    "> from field " + field.name + ": " + std::to_string(length) + " bytes");
+            }
+        }
+        value.assign(chars, length);
+    } else if constexpr (std::is_same_v<V, bool>) {
+        uint8_t raw = 0;
+        std::memcpy(&raw, dataPtr, sizeof(raw));
+        value = raw != 0;
+    } else {
+        using Wire = std::conditional_t<SqlType == SQL_SHORT, int16_t,
+                     std::conditional_t<SqlType == SQL_LONG, int32_t,
+                     std::conditional_t<SqlType == SQL_INT64, int64_t,
+                     std::conditional_t<SqlType == SQL_FLOAT, float, double>>>>;
+        Wire raw{};
+        std::memcpy(&raw, dataPtr, sizeof(raw));
+        value = static_cast<V>(raw);
+    }
+}
+
+/**
+ * @brief Offsets of a pinned descriptor's columns in one message format
+ *
+ * Built once per MessageMetadata (of()) and immutable afterwards; matches()
+ * tells whether the descriptor's pinned types hold for that format, exact()
+ * whether its build-time layout (exact_layout_v) does.
+ */
+template<typename T>
+class PinnedLayout {
+    using Fields = std::decay_t<decltype(StructDescriptor<T>::fields)>;
+    static constexpr std::size_t kFields = std::tuple_size_v<Fields>;
+
+public:
+    explicit PinnedLayout(const MessageMetadata& metadata)
+        : layout_(metadata.getLayout()) {
+        if constexpr (exact_layout_v<T>) {
+            static_assert(StructDescriptor<T>::offsets.size() == kFields &&
+                          StructDescriptor<T>::null_offsets.size() == kFields,
+                          "StructDescriptor offsets must have one entry per field");
+            exact_ = layout_->columnPlan.size() == kFields &&
+                     layout_->layoutHash == StructDescriptor<T>::layout_hash;
+        }
+        matches_ = exact_ ||
+                   (layout_->columnPlan.size() == kFields &&
+                    check(std::make_index_sequence<kFields>{}));
+    }
+
+    bool matches() const noexcept { return matches_; }
+    bool exact() const noexcept { return exact_; }
+
+    void unpack(T& value, const uint8_t* buffer, Transaction* transaction) const {
+        if constexpr (exact_layout_v<T>) {
+            if (exact_) {
+                unpackColumns<true>(value, buffer, transaction, std::make_index_sequence<kFields>{});
+                return;
+            }
+        }
+        unpackColumns<false>(value, buffer, transaction, std::make_index_sequence<kFields>{});
+    }
+
+    static const PinnedLayout& of(const MessageMetadata& metadata) {
+        const std::type_index key(typeid(PinnedLayout));
+        if (auto cached = metadata.findPlan(key)) {
+            return *static_cast<const PinnedLayout*>(cached.get());
+        }
+        auto plan = std::make_shared<const PinnedLayout>(metadata);
+        const PinnedLayout& ref = *plan;
+        metadata.storePlan(key, std::move(plan));
+        return ref;
+    }
+
+private:
+    template<std::size_t... I>
+    bool check(std::index_sequence<I...>) const {
+        return ((std::get<I>(StructDescriptor<T>::fields).sqlType ==
+                     layout_->columnPlan[I].field->type &&
+                 std::get<I>(StructDescriptor<T>::fields).scale ==
+                     layout_->columnPlan[I].field->scale) && ...);
+    }
+
+    // Exact: offsets from the descriptor (constants), else from the plan
+    template<std::size_t I, bool Exact>
+    void unpackColumn(T& value, const uint8_t* buffer, Transaction* transaction) const {
+        constexpr auto& descriptor = std::get<I>(StructDescriptor<T>::fields);
+        using FieldType = typename std::decay_t<decltype(descriptor)>::field_type;
+        using U = typename unwrap_optional<FieldType>::type;
+
+        const ColumnPlan& column = layout_->columnPlan[I];
+        const uint8_t* dataPtr;
+        const int16_t* nullPtr;
+        if constexpr (Exact) {
+            dataPtr = buffer + StructDescriptor<T>::offsets[I];
+            nullPtr = reinterpret_cast<const int16_t*>(buffer + StructDescriptor<T>::null_offsets[I]);
+        } else {
+            dataPtr = buffer + column.offset;
+            nullPtr = reinterpret_cast<const int16_t*>(buffer + column.nullOffset);
+        }
+        auto& fieldRef = descriptor.access(value);
+
+        if constexpr (has_pinned_reader<U, descriptor.sqlType, descriptor.scale>()) {
+            if (sql_value_codec::isNull(nullPtr)) {
+                if constexpr (is_optional_v<FieldType>) {
+                    fieldRef.reset();
+                    return;
+                } else {
+                    throw FirebirdException("NULL value for non-nullable field: " +
+                                            column.field->name);
+                }
+            }
+            if constexpr (is_optional_v<FieldType>) {
+                // Reuse a present value (a string keeps its capacity)
+                pinned_read<U, descriptor.sqlType>(dataPtr, *column.field,
+                                                   fieldRef ? *fieldRef : fieldRef.emplace());
+            } else {
+                pinned_read<U, descriptor.sqlType>(dataPtr, *column.field, fieldRef);
+            }
+        } else {
+            sql_value_codec::SqlReadContext ctx{column.field, transaction, nullPtr};
+            sql_value_codec::read_sql_value(ctx, dataPtr, fieldRef);
+        }
+    }
+
+    template<bool Exact, std::size_t... I>
+    void unpackColumns(T& value, const uint8_t* buffer, Transaction* transaction,
+                       std::index_sequence<I...>) const {
+        (unpackColumn<I, Exact>(value, buffer, transaction), ...);
+    }
+
+    std::shared_ptr<const MetadataLayout> layout_;   // Owns the FieldInfo
+    bool matches_ = false;
+    bool exact_ = false;
+};
+
+// ============================================================================
+// Message Layout
+// ============================================================================
+
+// A descriptor that also lists one null indicator member per field
+//
+//   static constexpr auto null_indicators = std::make_tuple(&Row::idNull, ...);
+//
+// describes a struct that is itself a Firebird message: each field at the
+// offset Firebird gives it, its int16_t null indicator right after it, as
+// when the members are declared value, indicator, value, indicator... in
+// field order. MessageRowFormat<T> builds that message format once (with
+// MessageBuilder, so nothing depends on an attachment) and checks it against
+// the struct's member offsets. A cursor opened with it (messageFormat<T>())
+// fetches rows with no per-field decode: one memcpy into the struct, or
+// ResultSet::fetchAll() fetching straight into the vector's elements.
+//
+// Fields must be fixed-size and non-optional: int16_t, int32_t, int64_t
+// (NUMERIC columns keep their scaled integer), float, double, bool, Date,
+// Time, Timestamp, or std::array<char, N> for CHAR(N) bytes.
+
+template<typename T>
+inline constexpr bool message_layout_v = requires { StructDescriptor<T>::null_indicators; };
+
+template<typename>
+struct is_char_array : std::false_type {};
+
+template<std::size_t N>
+struct is_char_array<std::array<char, N>> : std::true_type {};
+
+template<typename V, unsigned SqlType>
+constexpr bool is_message_scalar() {
+    if constexpr (is_char_array<V>::value) {
+        return SqlType == SQL_TEXT;
+    } else {
+        return (SqlType == SQL_SHORT && std::is_same_v<V, int16_t>) ||
+               (SqlType == SQL_LONG && std::is_same_v<V, int32_t>) ||
+               (SqlType == SQL_INT64 && std::is_same_v<V, int64_t>) ||
+               (SqlType == SQL_FLOAT && std::is_same_v<V, float>) ||
+               (SqlType == SQL_DOUBLE && std::is_same_v<V, double>) ||
+               (SqlType == SQL_BOOLEAN && std::is_same_v<V, bool>) ||
+               (SqlType == SQL_TYPE_DATE && std::is_same_v<V, Date>) ||
+               (SqlType == SQL_TYPE_TIME && std::is_same_v<V, Time>) ||
+               (SqlType == SQL_TIMESTAMP && std::is_same_v<V, Timestamp>);
+    }
+}
+
+/**
+ * @brief The message format a message-layout struct T is, built once
+ */
+template<typename T>
+class MessageRowFormat {
+    using Fields = std::decay_t<decltype(StructDescriptor<T>::fields)>;
+    using Nulls = std::decay_t<decltype(StructDescriptor<T>::null_indicators)>;
+    static constexpr std::size_t kFields = std::tuple_size_v<Fields>;
+
+    static_assert(std::tuple_size_v<Nulls> == kFields,
+                  "null_indicators must have one member per field");
+    static_assert(std::is_trivially_copyable_v<T> && std::is_standard_layout_v<T> &&
+                  std::is_default_constructible_v<T>,
+                  "A message-layout struct must be a trivially copyable standard-layout type");
+
+public:
+    /// Shared by every cursor of T; throws if T's layout is not the message's
+    static const std::shared_ptr<const MessageMetadata>& get() {
+        static const std::shared_ptr<const MessageMetadata> format = build();
+        return format;
+    }
+
+    /// True if `metadata` is get() or has the same binary layout
+    static bool describes(const MessageMetadata& metadata) {
+        const auto& format = get();
+        return &metadata == format.get() ||
+               metadata.getLayout()->layoutHash == format->getLayout()->layoutHash;
+    }
+
+private:
+    template<typename M>
+    static std::size_t offsetOf(M T::* member) {
+        static const T probe{};
+        return static_cast<std::size_t>(reinterpret_cast<const char*>(&(probe.*member)) -
+                                        reinterpret_cast<const char*>(&probe));
+    }
+
+    template<std::size_t I>
+    static void describe(MessageBuilder& builder) {
+        constexpr auto& descriptor = std::get<I>(StructDescriptor<T>::fields);
+        using V = typename std::decay_t<decltype(descriptor)>::field_type;
+        using N = typename member_pointer_traits<
+            std::decay_t<decltype(std::get<I>(StructDescriptor<T>::null_indicators))>>::field_type;
+        static_assert(is_message_scalar<V, descriptor.sqlType>(),
+                      "Message-layout field type does not match its fixed-size SQL type");
+        static_assert(std::is_same_v<N, int16_t>, "Null indicators must be int16_t members");
+        builder.setField(static_cast<unsigned>(I), descriptor.sqlName,
+                         static_cast<int>(descriptor.sqlType), static_cast<unsigned>(sizeof(V)),
+                         descriptor.scale);
+    }
+
+    template<std::size_t I>
+    static void check(const MessageMetadata& metadata) {
+        constexpr auto& descriptor = std::get<I>(StructDescriptor<T>::fields);
+        const FieldInfo& field = metadata.getFieldRef(static_cast<unsigned>(I));
+        const std::size_t value = offsetOf(descriptor.memberPtr);
+        const std::size_t null = offsetOf(std::get<I>(StructDescriptor<T>::null_indicators));
+        if (field.offset != value || field.nullOffset != null) {
+            throw FirebirdException(
+                std::string(descriptor_name<T>()) + ": field '" + descriptor.sqlName +
+                "' is at " + std::to_string(value) + "/" + std::to_string(null) +
+                " (value/null) in the struct but at " + std::to_string(field.offset) + "/" +
+                std::to_string(field.nullOffset) + " in its message");
+        }
+    }
+
+    template<std::size_t... I>
+    static std::shared_ptr<const MessageMetadata> build(std::index_sequence<I...>) {
+        std::unique_ptr<MessageMetadata> metadata;
+        try {
+            MessageBuilder builder(static_cast<unsigned>(kFields));
+            (describe<I>(builder), ...);
+            metadata = builder.build();
+        } catch (const Firebird::FbException& e) {
+            throw FirebirdException(e);
+        }
+        (check<I>(*metadata), ...);
+        if (metadata->getMessageLength() > sizeof(T)) {
+            throw FirebirdException(std::string(descriptor_name<T>()) + ": message of " +
+                                    std::to_string(metadata->getMessageLength()) +
+                                    " bytes does not fit the struct's " +
+                                    std::to_string(sizeof(T)));
+        }
+        return metadata;
+    }
+
+    static std::shared_ptr<const MessageMetadata> build() {
+        return build(std::make_index_sequence<kFields>{});
+    }
+};
+
 } // namespace detail
 
 // ============================================================================
@@ -473,6 +838,15 @@ void packStruct(
         );
     }
 
+    // A message-layout struct whose format this is: copied as it stands,
+    // null indicators included
+    if constexpr (detail::message_layout_v<T>) {
+        if (detail::MessageRowFormat<T>::describes(*metadata)) {
+            std::memcpy(buffer, static_cast<const void*>(&value), metadata->getMessageLength());
+            return;
+        }
+    }
+
     // Zero buffer
     std::memset(buffer, 0, metadata->getMessageLength());
 
@@ -484,19 +858,23 @@ void packStruct(
 }
 
 /**
- * @brief Unpack struct from Firebird message buffer
+ * @brief Unpack struct from Firebird message buffer into an existing value
+ *
+ * Every field is overwritten; strings (also inside optionals) are assigned,
+ * so they keep their capacity across rows.
  *
  * @tparam T Struct type with StructDescriptor specialization
+ * @param result Struct to overwrite
  * @param buffer Input buffer containing packed data
  * @param metadata Message metadata describing buffer layout
  * @param transaction Transaction for BLOB operations (optional)
- * @return Unpacked struct instance
  *
  * @throws FirebirdException on validation errors or type mismatches
  */
 template<typename T>
     requires StructPackable<T>
-T unpackStruct(
+void unpackStructInto(
+    T& result,
     const uint8_t* buffer,
     const MessageMetadata* metadata,
     Transaction* transaction = nullptr
@@ -525,15 +903,65 @@ T unpackStruct(
         );
     }
 
-    // Create result
-    T result{};
+    // A message-layout struct is its own row: one copy, no decode
+    if constexpr (detail::message_layout_v<T>) {
+        if (detail::MessageRowFormat<T>::describes(*metadata)) {
+            std::memcpy(static_cast<void*>(&result), buffer, metadata->getMessageLength());
+            return;
+        }
+    }
+
+    // Pinned descriptors skip the per-field checks when the format matches
+    if constexpr (detail::pinned_decode_v<T>) {
+        const auto& pinned = detail::PinnedLayout<T>::of(*metadata);
+        if (pinned.matches()) {
+            pinned.unpack(result, buffer, transaction);
+            return;
+        }
+    }
 
     // Unpack all fields
     detail::unpackStructImpl(
         result, buffer, metadata, transaction,
         fields, std::make_index_sequence<fieldCount>{}
     );
+}
 
+/**
+ * @brief Message format of a message-layout struct (see null_indicators)
+ *
+ * Pass it as the output format of a cursor to fetch rows of T with no
+ * per-field decode, or as the input format of Transaction::executeMessage()
+ * / openCursorMessage() with &row as the message.
+ *
+ * @throws FirebirdException if T's member offsets are not the message's
+ */
+template<typename T>
+    requires (StructPackable<T> && detail::message_layout_v<T>)
+const std::shared_ptr<const MessageMetadata>& messageFormat() {
+    return detail::MessageRowFormat<T>::get();
+}
+
+/**
+ * @brief Unpack struct from Firebird message buffer
+ *
+ * @tparam T Struct type with StructDescriptor specialization
+ * @param buffer Input buffer containing packed data
+ * @param metadata Message metadata describing buffer layout
+ * @param transaction Transaction for BLOB operations (optional)
+ * @return Unpacked struct instance
+ *
+ * @throws FirebirdException on validation errors or type mismatches
+ */
+template<typename T>
+    requires StructPackable<T>
+T unpackStruct(
+    const uint8_t* buffer,
+    const MessageMetadata* metadata,
+    Transaction* transaction = nullptr
+) {
+    T result{};
+    unpackStructInto(result, buffer, metadata, transaction);
     return result;
 }
 
@@ -0,0 +1,143 @@
+#pragma once
+
+// Bulk text validation and transcoding for column values.
+//
+// Values fetched over a UTF8 attachment are UTF-8; columns read over a
+// NONE attachment (or OCTETS-cast) from legacy tables arrive in their
+// single-byte code page. These helpers convert whole values at once with
+// an ASCII fast path (16 bytes per step on SSE2 / NEON) instead of the
+// per-character or per-temporary conversions of the platform string
+// classes, and write into caller-provided buffers where possible.
+//
+// TextTranscoder converts text that arrives in pieces (BLOB segments, file
+// reads) between UTF-8 and those code pages, one piece at a time.
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace fbpp {
+namespace core {
+
+/**
+ * @brief How malformed UTF-8 is handled
+ */
+enum class Utf8Errors {
+    Throw,     // FirebirdException naming the byte offset
+    Replace    // Each invalid byte becomes U+FFFD
+};
+
+/**
+ * @brief Single-byte code pages with a built-in table
+ */
+enum class SingleByteCharset {
+    Latin1,    // ISO8859_1
+    Win1250,
+    Win1251,
+    Win1252,
+    Koi8R,
+    Koi8U
+};
+
+/// Map a Firebird character set id (FieldInfo::charSet) to a table, if any
+std::optional<SingleByteCharset> singleByteCharsetForId(unsigned charSetId) noexcept;
+
+/// True iff `text` is well-formed UTF-8 (no overlongs, surrogates or > U+10FFFF)
+bool isValidUtf8(std::string_view text) noexcept;
+
+/// Number of UTF-16 code units utf8ToUtf16() writes for `text`
+std::size_t utf16Length(std::string_view text, Utf8Errors errors = Utf8Errors::Throw);
+
+/**
+ * @brief Decode UTF-8 into `out`, which must hold utf16Length(text) units
+ * @return Code units written
+ */
+std::size_t utf8ToUtf16(std::string_view text, char16_t* out,
+                        Utf8Errors errors = Utf8Errors::Throw);
+
+std::u16string utf8ToUtf16(std::string_view text, Utf8Errors errors = Utf8Errors::Throw);
+
+/// Single-byte text to UTF-16; always exactly `bytes.size()` units into `out`
+void singleByteToUtf16(std::string_view bytes, SingleByteCharset charset, char16_t* out) noexcept;
+
+/// Append single-byte text to `out` as UTF-8
+void appendSingleByteAsUtf8(std::string_view bytes, SingleByteCharset charset, std::string& out);
+
+std::string singleByteToUtf8(std::string_view bytes, SingleByteCharset charset);
+
+/**
+ * @brief Streaming conversion between UTF-8 and the single-byte code pages
+ *
+ * feed() converts one chunk and appends the result. A UTF-8 sequence cut
+ * by the end of a chunk is held back (at most 3 bytes) and completed by the
+ * next one, so the output equals converting the whole text at once while
+ * memory stays bounded by the chunk size. finish() ends the text: a
+ * sequence still incomplete then is malformed.
+ *
+ *   TextTranscoder toWin1251(std::nullopt, SingleByteCharset::Win1251);
+ *   std::string out;
+ *   while (std::size_t n = read(buffer, sizeof buffer)) {
+ *       out.clear();
+ *       toWin1251.feed({buffer, n}, out);
+ *       sink(out);
+ *   }
+ *   out.clear();
+ *   toWin1251.finish(out);
+ *
+ * std::nullopt stands for UTF-8 on either side; UTF-8 to UTF-8 validates
+ * the text (and with Utf8Errors::Replace repairs it). With Utf8Errors::Throw
+ * malformed UTF-8 and characters the target code page lacks throw
+ * FirebirdException naming the byte offset in the whole text; with Replace
+ * they become U+FFFD, or '?' in a single-byte target.
+ */
+class TextTranscoder {
+public:
+    TextTranscoder(std::optional<SingleByteCharset> from, std::optional<SingleByteCharset> to,
+                   Utf8Errors errors = Utf8Errors::Throw) noexcept;
+
+    /**
+     * @brief Between Firebird character set ids (FieldInfo::charSet, a text
+     *        BLOB's character set)
+     *
+     * UTF8 and UNICODE_FSS are UTF-8; equal ids pass bytes through.
+     * @throws FirebirdException for other multi-byte or unknown ids
+     */
+    static TextTranscoder forCharsetIds(unsigned from, unsigned to,
+                                        Utf8Errors errors = Utf8Errors::Throw);
+
+    /// Convert `chunk`, appending to `out`
+    void feed(std::string_view chunk, std::string& out);
+
+    /// End of the text: convert what is held back, then start over
+    void finish(std::string& out);
+
+    /// Start a new text, dropping anything held back
+    void reset() noexcept;
+
+    /// Bytes come out as they went in (same code page on both sides)
+    bool passThrough() const noexcept { return passThrough_; }
+
+    /// Bytes of an incomplete UTF-8 sequence waiting for the next chunk
+    std::size_t pending() const noexcept { return pendingSize_; }
+
+    uint64_t bytesIn() const noexcept { return bytesIn_; }
+
+private:
+    // Convert whole characters [p, p + n); `offset` is p's offset in the text
+    void convert(const uint8_t* p, std::size_t n, uint64_t offset, std::string& out);
+    void emitCodePoint(char32_t codePoint, uint64_t offset, std::string& out);
+    void emitInvalid(uint64_t offset, std::string& out);
+
+    std::optional<SingleByteCharset> from_;
+    std::optional<SingleByteCharset> to_;
+    Utf8Errors errors_;
+    bool passThrough_ = false;
+    uint8_t pendingBytes_[4] = {};
+    std::size_t pendingSize_ = 0;
+    uint64_t bytesIn_ = 0;
+};
+
+} // namespace core
+} // namespace fbpp
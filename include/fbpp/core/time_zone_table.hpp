@@ -0,0 +1,92 @@
+#pragma once
+
+// Firebird time zone ids, resolved once per process.
+//
+// TIME / TIMESTAMP WITH TIME ZONE values carry a 16-bit zone id beside the
+// UTC value. Offset zones ("+05:00") encode the displacement in the id and
+// are decoded arithmetically. Region zones ("Europe/Moscow") are named by
+// one IUtil call per distinct id and then resolved through the C++ tz
+// database; the offset interval last used for each zone is kept, so a
+// column of values from the same period costs one add per value.
+//
+// The C++ tz database is the system's, not the one bundled with the
+// Firebird client; both follow IANA, but a client with outdated tzdata can
+// disagree for recent rule changes. Where <chrono> has no tz database
+// (Embarcadero bcc64x) region offsets fall back to IUtil per value.
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace fbpp {
+namespace core {
+
+/**
+ * @brief Process-wide cache of Firebird time zone ids, names and offsets
+ *
+ * All members are thread-safe.
+ */
+class TimeZoneTable {
+public:
+    static TimeZoneTable& instance();
+
+    TimeZoneTable(const TimeZoneTable&) = delete;
+    TimeZoneTable& operator=(const TimeZoneTable&) = delete;
+
+    /// True for "+hh:mm" zones (ids 0..2878), whose offset is in the id itself
+    static bool isOffsetZone(uint16_t zoneId) noexcept;
+
+    /// Name Firebird uses for `zoneId`: "+05:00", "-03:30" or an IANA region.
+    /// The reference stays valid for the life of the process.
+    const std::string& name(uint16_t zoneId);
+
+    /// Zone id for a name accepted by Firebird; throws FirebirdException if unknown
+    uint16_t zoneId(std::string_view name);
+
+#if !defined(__BORLANDC__)
+    /// System tz database zone of a region `zoneId`; nullptr for offset
+    /// zones and regions the system database does not know
+    const std::chrono::time_zone* timeZone(uint16_t zoneId);
+
+    /// Zone id of a tz database zone, without formatting its name per call
+    uint16_t zoneId(const std::chrono::time_zone* zone);
+#endif
+
+    /// Offset from UTC in minutes of `zoneId` at `utcMicros` (Unix epoch)
+    int32_t offsetMinutes(uint16_t zoneId, int64_t utcMicros);
+
+    /**
+     * @brief out[i] = utcMicros[i] + offset of zoneIds[i] at that instant
+     *
+     * Converts a WITH TIME ZONE column (ColumnVector values + zoneIds) to
+     * wall-clock microseconds; `out` may alias `utcMicros`.
+     */
+    void toLocalMicros(const int64_t* utcMicros, const uint16_t* zoneIds, std::size_t count,
+                       int64_t* out);
+
+private:
+    struct Region;
+
+    TimeZoneTable();
+    ~TimeZoneTable();
+
+    // Both with mutex_ held
+    Region& region(uint16_t zoneId);
+    int32_t regionOffset(Region& region, uint16_t zoneId, int64_t utcMicros);
+
+    std::mutex mutex_;
+    std::unordered_map<uint16_t, std::unique_ptr<Region>> regions_;
+    std::unordered_map<std::string, uint16_t> ids_;
+    std::unordered_map<uint16_t, std::string> offsetNames_;
+#if !defined(__BORLANDC__)
+    std::unordered_map<const std::chrono::time_zone*, uint16_t> zoneIds_;
+#endif
+};
+
+} // namespace core
+} // namespace fbpp
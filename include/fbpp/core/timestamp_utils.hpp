@@ -2,6 +2,7 @@
 
 #include <chrono>
 #include <utility>
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <sstream>
@@ -122,6 +123,152 @@ inline uint32_t current_time_of_day() {
     return to_firebird_time(time_since_midnight);
 }
 
+// ----------------------------------------------------------------------------
+// Calendar fields without IUtil
+//
+// Integer-only replacements for IUtil::decodeDate / encodeDate /
+// decodeTime / encodeTime (proleptic Gregorian calendar, days-from-civil
+// algorithm). ISC_DATE is a signed day number; it is taken as uint32_t
+// here like elsewhere in this file and reinterpreted as int32_t.
+// ----------------------------------------------------------------------------
+
+// Day 0 of the days-from-civil algorithm (0000-03-01) relative to 1970-01-01
+constexpr int64_t CIVIL_EPOCH_SHIFT = 719468;
+
+/**
+ * Декодирует ISC_DATE в год, месяц, день (как IUtil::decodeDate)
+ */
+inline void decode_firebird_date(uint32_t fb_date, unsigned& year, unsigned& month,
+                                 unsigned& day) noexcept {
+    const int64_t z = static_cast<int64_t>(static_cast<int32_t>(fb_date)) -
+                      FIREBIRD_EPOCH_DIFF + CIVIL_EPOCH_SHIFT;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const auto doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    day = doy - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = static_cast<unsigned>(static_cast<int64_t>(yoe) + era * 400 + (month <= 2 ? 1 : 0));
+}
+
+/**
+ * Кодирует год, месяц, день в ISC_DATE (как IUtil::encodeDate)
+ */
+inline uint32_t encode_firebird_date(unsigned year, unsigned month, unsigned day) noexcept {
+    const int64_t y = static_cast<int64_t>(year) - (month <= 2 ? 1 : 0);
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const auto yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return static_cast<uint32_t>(static_cast<int32_t>(
+        era * 146097 + static_cast<int64_t>(doe) - CIVIL_EPOCH_SHIFT + FIREBIRD_EPOCH_DIFF));
+}
+
+/**
+ * Декодирует ISC_TIME в часы, минуты, секунды, доли (1/10000 с)
+ */
+inline void decode_firebird_time(uint32_t fb_time, unsigned& hours, unsigned& minutes,
+                                 unsigned& seconds, unsigned& fractions) noexcept {
+    fractions = fb_time % 10000;
+    const uint32_t total_seconds = fb_time / 10000;
+    seconds = total_seconds % 60;
+    minutes = (total_seconds / 60) % 60;
+    hours = total_seconds / 3600;
+}
+
+/**
+ * Кодирует часы, минуты, секунды, доли (1/10000 с) в ISC_TIME
+ */
+inline uint32_t encode_firebird_time(unsigned hours, unsigned minutes, unsigned seconds,
+                                     unsigned fractions) noexcept {
+    return ((hours * 60 + minutes) * 60 + seconds) * 10000 + fractions;
+}
+
+// ----------------------------------------------------------------------------
+// Batch kernels for columnar fetch
+//
+// Plain loops over contiguous arrays with integer arithmetic only, so
+// compilers vectorize them at -O3: no calls, no branches on values (the
+// TIMESTAMP kernel needs SSE4.1, AVX2 or NEON for its widening multiply).
+// `date_time` is an array of ISC_TIMESTAMP laid out as (date, time) word
+// pairs, i.e. exactly the first 8 bytes of TIMESTAMP [WITH TIME ZONE]
+// values. The UTC instant of a WITH TIME ZONE value needs no zone lookup.
+// ----------------------------------------------------------------------------
+
+/**
+ * ISC_TIMESTAMP[count] -> микросекунды от Unix epoch
+ */
+inline void firebird_timestamps_to_unix_micros(const uint32_t* date_time, std::size_t count,
+                                               int64_t* out) noexcept {
+    // MICROS_PER_DAY = 42187500 << 11, so both products are 32 x 32 -> 64
+    // bit multiplies, which SSE4.1 / AVX2 have (a full 64-bit vector
+    // multiply needs AVX-512).
+    constexpr int32_t day_factor = 42187500;
+    static_assert((static_cast<int64_t>(day_factor) << 11) == MICROS_PER_DAY);
+    for (std::size_t i = 0; i < count; ++i) {
+        const int32_t days = static_cast<int32_t>(date_time[2 * i]) - FIREBIRD_EPOCH_DIFF;
+        const int64_t scaled = static_cast<int64_t>(days) * day_factor;
+        out[i] = (scaled << 11) + static_cast<int64_t>(date_time[2 * i + 1]) * 100;
+    }
+}
+
+/**
+ * Микросекунды от Unix epoch -> ISC_TIMESTAMP[count] (с округлением вниз до 100 мкс)
+ */
+inline void unix_micros_to_firebird_timestamps(const int64_t* micros, std::size_t count,
+                                               uint32_t* date_time) noexcept {
+    for (std::size_t i = 0; i < count; ++i) {
+        int64_t days = micros[i] / MICROS_PER_DAY;
+        int64_t rest = micros[i] % MICROS_PER_DAY;
+        const int64_t borrow = rest < 0 ? 1 : 0;
+        days -= borrow;
+        rest += borrow * MICROS_PER_DAY;
+        date_time[2 * i] = static_cast<uint32_t>(static_cast<int32_t>(days + FIREBIRD_EPOCH_DIFF));
+        date_time[2 * i + 1] = static_cast<uint32_t>(rest / 100);
+    }
+}
+
+/**
+ * ISC_DATE[count] -> дни от Unix epoch
+ */
+inline void firebird_dates_to_unix_days(const uint32_t* dates, std::size_t count,
+                                        int32_t* out) noexcept {
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = static_cast<int32_t>(dates[i]) - FIREBIRD_EPOCH_DIFF;
+    }
+}
+
+/**
+ * ISC_TIME[count] -> микросекунды от полуночи
+ */
+inline void firebird_times_to_micros(const uint32_t* times, std::size_t count,
+                                     int64_t* out) noexcept {
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = static_cast<int64_t>(times[i]) * 100;
+    }
+}
+
+/**
+ * Дни от Unix epoch -> ISC_DATE[count]
+ */
+inline void unix_days_to_firebird_dates(const int32_t* days, std::size_t count,
+                                        uint32_t* dates) noexcept {
+    for (std::size_t i = 0; i < count; ++i) {
+        dates[i] = static_cast<uint32_t>(days[i] + FIREBIRD_EPOCH_DIFF);
+    }
+}
+
+/**
+ * Микросекунды от полуночи -> ISC_TIME[count] (с округлением вниз до 100 мкс)
+ */
+inline void micros_to_firebird_times(const int64_t* micros, std::size_t count,
+                                     uint32_t* times) noexcept {
+    for (std::size_t i = 0; i < count; ++i) {
+        times[i] = static_cast<uint32_t>(micros[i] / 100);
+    }
+}
+
 #if FBPP_EFFECTIVE_CPLUSPLUS >= 202002L
 // C++20 enhanced date/time functions
 
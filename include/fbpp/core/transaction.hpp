@@ -1,9 +1,14 @@
 #pragma once
 
 #include "fbpp/core/environment.hpp"
+#include "fbpp/core/blob.hpp"
 #include "fbpp/core/exception.hpp"
+#include "fbpp/core/expected.hpp"
 #include "fbpp/core/firebird_compat.hpp"
+#include <cstddef>
 #include <memory>
+#include <span>
+#include <string_view>
 #include <vector>
 
 namespace fbpp {
@@ -15,6 +20,9 @@ class Statement;
 class ResultSet;
 class Batch;
 class ParamBinder;
+class MessageMetadata;
+struct OutputCoercion;
+struct RowLimit;
 
 /**
  * Transaction handle bound to a single Connection attachment.
@@ -43,6 +51,22 @@ public:
     
     // Rollback retaining - keeps transaction active
     void RollbackRetaining();
+
+    // Two-phase commit, phase 1 (ITransaction::prepare). Afterwards the
+    // transaction can only be committed or rolled back, and a crash of
+    // either side leaves it in limbo instead of undoing it. `message` is
+    // stored with it (RDB$TRANSACTIONS.RDB$TRANSACTION_DESCRIPTION) for
+    // whoever recovers it.
+    void Prepare(std::string_view message = {});
+
+    // Give up the handle of a prepared transaction without resolving it:
+    // it stays in limbo until recovered (Connection::reconnectTransaction)
+    void Disconnect();
+
+    bool isPrepared() const { return prepared_; }
+
+    // Server transaction number (isc_info_tra_id)
+    uint64_t getId() const;
     
     // Check if transaction is active
     bool isActive() const;
@@ -63,8 +87,15 @@ public:
     }
     
     // BLOB operations
+    // Whole BLOB into memory; the vector is sized once from the BLOB's
+    // total length (see BlobReader::readAll()).
     std::vector<uint8_t> loadBlob(ISC_QUAD* blobId);
 
+    // Open a BLOB for streaming reads. The reader keeps this transaction
+    // alive when it is owned by a shared_ptr. readSize 0 = the connection's
+    // TransferTuning::blobReadBytes.
+    BlobReader openBlob(const ISC_QUAD& blobId, size_t readSize = 0);
+
     // Create a new BLOB and write data into it. The optional subType tags
     // the BLOB with a Firebird sub-type (0 = binary, 1 = text; negative
     // values reserved for system subtypes). When subType == 0 (default),
@@ -72,6 +103,16 @@ public:
     // overload. For text BLOB columns pass subType = 1 so Firebird knows
     // to treat bytes as text on subsequent reads / transliteration.
     ISC_QUAD createBlob(const std::vector<uint8_t>& data, int subType = 0);
+
+    // Same, written straight from caller memory (a network frame, a
+    // mapped file) in segment-sized pieces, with no staging copy
+    ISC_QUAD createBlob(std::span<const std::byte> data, int subType = 0);
+
+    // Create a BLOB for incremental writes (see BlobWriter). streamType
+    // sends isc_bpb_type_stream; subType as in createBlob(). With
+    // subType == 0 and a segmented BLOB no BPB is sent.
+    BlobWriter createBlobStream(int subType = 0, bool streamType = true,
+                                size_t segmentSize = BlobWriter::kMaxSegmentBytes);
     
     // Execute operations with Statement (for INSERT/UPDATE/DELETE)
     unsigned execute(const std::unique_ptr<Statement>& statement);
@@ -86,6 +127,18 @@ public:
     unsigned execute(const std::shared_ptr<Statement>& statement,
                     const ParamsType& params);
 
+    // execute() that returns the FirebirdException instead of throwing it,
+    // for expected failures (update conflicts, constraint checks); takes
+    // the arguments of any execute() overload
+    template<typename... Args>
+    auto tryExecute(const Args&... args) -> Expected<decltype(this->execute(args...))> {
+        try {
+            return execute(args...);
+        } catch (const FirebirdException& e) {
+            return e;
+        }
+    }
+
     // Execute with RETURNING clause
     template<typename InParams, typename OutParams>
     std::pair<unsigned, OutParams> execute(const std::unique_ptr<Statement>& statement,
@@ -109,6 +162,52 @@ public:
     std::unique_ptr<ResultSet> openCursor(const std::shared_ptr<Statement>& statement,
                                           const ParamsType& params);
 
+    // At most `limit.rows` rows; the SELECT runs as "... ROWS n" where it
+    // takes the clause (see Statement::openCursor(transaction, limit))
+    std::unique_ptr<ResultSet> openCursor(const std::shared_ptr<Statement>& statement,
+                                          RowLimit limit);
+
+    template<typename ParamsType>
+    std::unique_ptr<ResultSet> openCursor(const std::shared_ptr<Statement>& statement,
+                                          const ParamsType& params,
+                                          RowLimit limit);
+
+    // Rows converted server-side by `coercion` (see fbpp/core/output_coercion.hpp)
+    std::unique_ptr<ResultSet> openCursor(const std::shared_ptr<Statement>& statement,
+                                          const OutputCoercion& coercion);
+
+    template<typename ParamsType>
+    std::unique_ptr<ResultSet> openCursor(const std::shared_ptr<Statement>& statement,
+                                          const ParamsType& params,
+                                          const OutputCoercion& coercion);
+
+    // Rows converted server-side to `outFormat`, e.g. messageFormat<T>() of a
+    // message-layout struct (see fbpp/core/struct_descriptor.hpp)
+    std::unique_ptr<ResultSet> openCursor(
+        const std::shared_ptr<Statement>& statement,
+        const std::shared_ptr<const MessageMetadata>& outFormat);
+
+    template<typename ParamsType>
+    std::unique_ptr<ResultSet> openCursor(
+        const std::shared_ptr<Statement>& statement,
+        const ParamsType& params,
+        const std::shared_ptr<const MessageMetadata>& outFormat);
+
+    // Scrollable cursor (Statement::CURSOR_TYPE_SCROLLABLE) for
+    // ResultSet::fetchAbsolute() / fetchPage() and the other scroll moves
+    std::unique_ptr<ResultSet> openScrollableCursor(const std::shared_ptr<Statement>& statement);
+
+    // Cursor holding no reference to this transaction or `statement`, for
+    // hot paths whose scope outlives both (see Statement::openBorrowedCursor)
+    std::unique_ptr<ResultSet> openBorrowedCursor(Statement& statement);
+
+    template<typename ParamsType>
+    std::unique_ptr<ResultSet> openBorrowedCursor(Statement& statement, const ParamsType& params);
+
+    template<typename ParamsType>
+    std::unique_ptr<ResultSet> openScrollableCursor(const std::shared_ptr<Statement>& statement,
+                                                    const ParamsType& params);
+
     // Execute / openCursor with ParamBinder (named-parameter binding without JSON).
     // Implementations are inline in fbpp/core/param_binder.hpp (included by it).
     unsigned execute(const std::shared_ptr<Statement>& statement, const ParamBinder& binder);
@@ -120,6 +219,18 @@ public:
                                           const ParamBinder& binder,
                                           unsigned flags = 0);
 
+    // Execute / openCursor with an input message packed earlier (kept from
+    // Statement::packInput, or recorded, see fbpp_util/workload.hpp).
+    // `inMetadata` describes the message; nullptr for a statement without
+    // parameters. Firebird converts it to the statement's own input format.
+    unsigned executeMessage(const std::shared_ptr<Statement>& statement,
+                            Firebird::IMessageMetadata* inMetadata,
+                            const void* message);
+    std::unique_ptr<ResultSet> openCursorMessage(const std::shared_ptr<Statement>& statement,
+                                                 Firebird::IMessageMetadata* inMetadata,
+                                                 const void* message,
+                                                 unsigned flags = 0);
+
     // Batch operations
     std::unique_ptr<Batch> createBatch(const std::unique_ptr<Statement>& statement,
                                        bool recordCounts = true,
@@ -150,6 +261,7 @@ private:
     Firebird::IStatus* status_;
     mutable Firebird::ThrowStatusWrapper statusWrapper_{nullptr};
     bool active_;
+    bool prepared_ = false;
 };
 
 } // namespace core
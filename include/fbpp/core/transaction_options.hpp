@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+namespace fbpp {
+namespace core {
+
+/**
+ * @brief Transaction isolation level (isc_tpb_* isolation items)
+ */
+enum class TxIsolation {
+    Concurrency,                    // SNAPSHOT (Firebird default)
+    Consistency,                    // SNAPSHOT TABLE STABILITY
+    ReadCommittedRecordVersion,     // READ COMMITTED RECORD_VERSION
+    ReadCommittedNoRecordVersion,   // READ COMMITTED NO RECORD_VERSION
+    ReadCommittedReadConsistency    // READ COMMITTED READ CONSISTENCY (Firebird 4+)
+};
+
+/**
+ * @brief Parameters of Connection::StartTransaction(const TransactionOptions&)
+ *
+ * The default value is Firebird's default transaction (concurrency,
+ * read-write, wait), i.e. the same as StartTransaction().
+ */
+struct TransactionOptions {
+    TxIsolation isolation = TxIsolation::Concurrency;
+    bool readOnly = false;
+    bool wait = true;
+    // Give up on a lock conflict after this many seconds; wait only
+    std::optional<uint32_t> lockTimeoutSeconds;
+    // isc_tpb_no_auto_undo: no undo log for large write transactions
+    bool noAutoUndo = false;
+    // isc_tpb_at_snapshot_number (Firebird 4+, Concurrency only): see the
+    // same snapshot as the still active transaction that reported this
+    // number (RDB$GET_CONTEXT('SYSTEM', 'SNAPSHOT_NUMBER'))
+    std::optional<uint64_t> atSnapshotNumber;
+
+    bool operator==(const TransactionOptions&) const = default;
+
+    /**
+     * @brief READ COMMITTED READ CONSISTENCY READ ONLY
+     *
+     * For reporting reads: read-only read committed transactions do not
+     * hold back garbage collection the way a snapshot does, however long
+     * they stay open.
+     */
+    static TransactionOptions readOnlyReadCommitted() {
+        TransactionOptions options;
+        options.isolation = TxIsolation::ReadCommittedReadConsistency;
+        options.readOnly = true;
+        return options;
+    }
+
+    /// Fail immediately on a lock conflict instead of waiting
+    static TransactionOptions noWait(TxIsolation isolation = TxIsolation::Concurrency) {
+        TransactionOptions options;
+        options.isolation = isolation;
+        options.wait = false;
+        return options;
+    }
+
+    /// Wait at most `seconds` on a lock conflict
+    static TransactionOptions lockTimeout(uint32_t seconds,
+                                          TxIsolation isolation = TxIsolation::Concurrency) {
+        TransactionOptions options;
+        options.isolation = isolation;
+        options.lockTimeoutSeconds = seconds;
+        return options;
+    }
+};
+
+} // namespace core
+} // namespace fbpp
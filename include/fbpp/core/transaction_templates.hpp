@@ -103,5 +103,81 @@ std::unique_ptr<ResultSet> Transaction::openCursor(const std::shared_ptr<Stateme
     return rs;
 }
 
+template<typename ParamsType>
+std::unique_ptr<ResultSet> Transaction::openCursor(const std::shared_ptr<Statement>& statement,
+                                                   const ParamsType& params,
+                                                   RowLimit limit) {
+    if (!statement) {
+        throw FirebirdException("Invalid statement pointer");
+    }
+
+    // Retains whichever statement the cursor runs on
+    const std::shared_ptr<Statement> limited = statement->limitedTo(limit.rows);
+    auto rs = openCursor(limited ? limited : statement, params);
+    rs->setRowLimit(limit.rows);
+    return rs;
+}
+
+template<typename ParamsType>
+std::unique_ptr<ResultSet> Transaction::openCursor(const std::shared_ptr<Statement>& statement,
+                                                   const ParamsType& params,
+                                                   const OutputCoercion& coercion) {
+    if (!statement) {
+        throw FirebirdException("Invalid statement pointer");
+    }
+
+    if (!isActive()) {
+        throw FirebirdException("Transaction is not active");
+    }
+
+    auto rs = statement->openCursor(this, params, coercion);
+    rs->retainStatement(statement);
+    return rs;
+}
+
+template<typename ParamsType>
+std::unique_ptr<ResultSet> Transaction::openCursor(
+    const std::shared_ptr<Statement>& statement,
+    const ParamsType& params,
+    const std::shared_ptr<const MessageMetadata>& outFormat) {
+    if (!statement) {
+        throw FirebirdException("Invalid statement pointer");
+    }
+
+    if (!isActive()) {
+        throw FirebirdException("Transaction is not active");
+    }
+
+    auto rs = statement->openCursor(this, params, outFormat);
+    rs->retainStatement(statement);
+    return rs;
+}
+
+template<typename ParamsType>
+std::unique_ptr<ResultSet> Transaction::openScrollableCursor(const std::shared_ptr<Statement>& statement,
+                                                             const ParamsType& params) {
+    if (!statement) {
+        throw FirebirdException("Invalid statement pointer");
+    }
+
+    if (!isActive()) {
+        throw FirebirdException("Transaction is not active");
+    }
+
+    auto rs = statement->openCursor(this, params,
+                                    static_cast<unsigned>(Statement::CURSOR_TYPE_SCROLLABLE));
+    rs->retainStatement(statement);
+    return rs;
+}
+
+template<typename ParamsType>
+std::unique_ptr<ResultSet> Transaction::openBorrowedCursor(Statement& statement,
+                                                           const ParamsType& params) {
+    if (!isActive()) {
+        throw FirebirdException("Transaction is not active");
+    }
+    return statement.openBorrowedCursor(*this, params, 0);
+}
+
 } // namespace core
 } // namespace fbpp
\ No newline at end of file
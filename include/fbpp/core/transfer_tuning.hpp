@@ -0,0 +1,84 @@
+#pragma once
+
+// Transfer sizes chosen per connection from what the attachment reports.
+//
+// BLOB reads, Batch stream chunks and cursor prefetch windows each have a
+// fixed library default that suits a remote server with an 8 KB or 16 KB
+// page. Connection::transferTuning() replaces them with figures derived
+// from Connection::getDatabaseInfo() — page size, wire protocol (remote or
+// embedded) and wire compression — and, for cursors, the length of the
+// output message:
+//
+//   BLOB read size      remote: 64 KB - 1, the largest segment the wire
+//                       carries; local: 4 pages, 16 KB .. 64 KB - 1
+//   Batch stream chunk  128 pages, 256 KB .. 4 MB
+//   Prefetch window     remote: rows of 64 KB (128 KB with compression),
+//                       16 .. 1024 rows; embedded: 1 (no round trip to save)
+//
+// Statements of the connection apply them to what they create: Transaction
+// ::openBlob() / loadBlob(), Statement::createBatch() and forward-only,
+// non-FOR UPDATE cursors. A value set in TransferOptions always wins; a
+// later setReadSize() / setStreamChunkBytes() / setPrefetch() on the object
+// itself does too.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace fbpp {
+namespace core {
+
+/**
+ * @brief What the attachment says about itself (Connection::getDatabaseInfo())
+ *
+ * Zero / empty where the server did not answer an item.
+ */
+struct DatabaseInfo {
+    unsigned pageSize = 0;           // isc_info_page_size
+    unsigned odsMajor = 0;           // isc_info_ods_version
+    unsigned odsMinor = 0;           // isc_info_ods_minor_version
+    std::string serverVersion;       // isc_info_firebird_version ("LI-V5.0.1.1469 Firebird 5.0")
+    unsigned protocolVersion = 0;    // fb_info_protocol_version; 0 = embedded
+    bool compressed = false;         // fb_info_conn_flags: wire compression on
+    bool encrypted = false;          // fb_info_conn_flags: wire encryption on
+
+    // Requests cross a network (or loopback) wire protocol
+    bool remote() const noexcept { return protocolVersion != 0; }
+};
+
+/**
+ * @brief Transfer sizes requested by the caller (ConnectionOptions::transfer)
+ *
+ * 0 = chosen per connection (or the library default with autoTune off).
+ */
+struct TransferOptions {
+    size_t blobReadBytes = 0;        // Transaction::openBlob() / loadBlob() reads
+    size_t batchChunkBytes = 0;      // Batch::setStreamChunkBytes() of new batches
+    unsigned prefetchRows = 0;       // ResultSet::setPrefetch() of new cursors
+    // false: keep the fixed library defaults for the sizes left at 0
+    bool autoTune = true;
+};
+
+/**
+ * @brief Transfer sizes in effect for one connection (Connection::transferTuning())
+ */
+struct TransferTuning {
+    // The library defaults (BlobReader::kDefaultReadSize, Batch::kDefaultStreamChunkBytes)
+    static constexpr size_t kDefaultBlobReadBytes = 64 * 1024 - 1;
+    static constexpr size_t kDefaultBatchChunkBytes = 4 * 1024 * 1024;
+
+    size_t blobReadBytes = kDefaultBlobReadBytes;
+    size_t batchChunkBytes = kDefaultBatchChunkBytes;
+    // Bytes of output messages per prefetch window; 0 = fixed row count
+    size_t prefetchBytes = 0;
+    unsigned prefetchRows = 1;       // Rows per window while prefetchBytes is 0
+
+    /// Prefetch window for a cursor whose output message aligns to `rowBytes`
+    unsigned prefetchFor(unsigned rowBytes) const noexcept;
+
+    /// Sizes for an attachment described by `info`, with `options` applied
+    static TransferTuning choose(const DatabaseInfo& info, const TransferOptions& options) noexcept;
+};
+
+} // namespace core
+} // namespace fbpp
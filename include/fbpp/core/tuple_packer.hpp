@@ -31,24 +31,19 @@ void packValueWithCodec(const T& value,
 // Helper to recursively pack tuple elements
 template<size_t Index, typename... Args>
 struct TuplePackHelper {
-    static void pack(const std::tuple<Args...>& tuple, uint8_t* buffer, const MessageMetadata* metadata, ::fbpp::core::Transaction* transaction = nullptr) {
+    static void pack(const std::tuple<Args...>& tuple, uint8_t* buffer, const ColumnPlan* plan, ::fbpp::core::Transaction* transaction = nullptr) {
         constexpr size_t idx = sizeof...(Args) - Index;
+        const ColumnPlan& column = plan[idx];
         
-        // Get field info and offsets from metadata
-        FieldInfo fieldInfo = metadata->getField(idx);
-        unsigned data_offset = metadata->getOffset(idx);
-        unsigned null_offset = metadata->getNullOffset(idx);
-        
-        
-        uint8_t* data_ptr = buffer + data_offset;
-        int16_t* null_ptr = reinterpret_cast<int16_t*>(buffer + null_offset);
+        uint8_t* data_ptr = buffer + column.offset;
+        int16_t* null_ptr = reinterpret_cast<int16_t*>(buffer + column.nullOffset);
         
         // Pack this element using shared SQL codec
-        packValueWithCodec(std::get<idx>(tuple), data_ptr, null_ptr, &fieldInfo, transaction);
+        packValueWithCodec(std::get<idx>(tuple), data_ptr, null_ptr, column.field, transaction);
         
         // Recursively pack remaining elements
         if constexpr (Index > 1) {
-            TuplePackHelper<Index - 1, Args...>::pack(tuple, buffer, metadata, transaction);
+            TuplePackHelper<Index - 1, Args...>::pack(tuple, buffer, plan, transaction);
         }
     }
     
@@ -61,7 +56,8 @@ struct TuplePackHelper {
         
         try {
             // Add field based on type
-            if constexpr (std::is_same_v<ElemType, std::string> || std::is_same_v<ElemType, const char*>) {
+            if constexpr (std::is_same_v<ElemType, std::string> || is_text_view_v<ElemType> ||
+                          is_byte_span_v<ElemType>) {
                 // For strings, use a reasonable default length
                 builder.addFieldWithLength<std::string>(field_name, 255);
             } else {
@@ -83,7 +79,7 @@ struct TuplePackHelper {
 // Base case specialization
 template<typename... Args>
 struct TuplePackHelper<0, Args...> {
-    static void pack(const std::tuple<Args...>&, uint8_t*, const MessageMetadata*, ::fbpp::core::Transaction* = nullptr) {}
+    static void pack(const std::tuple<Args...>&, uint8_t*, const ColumnPlan*, ::fbpp::core::Transaction* = nullptr) {}
     static void buildMetadata(MessageBuilder&, unsigned&) {}
 };
 
@@ -103,11 +99,13 @@ public:
             throw FirebirdException("Invalid parameters for pack");
         }
         
+        const auto& plan = metadata->getColumnPlan();
+
         // Validate tuple arity matches metadata
-        if (sizeof...(Args) != metadata->getCount()) {
+        if (sizeof...(Args) != plan.size()) {
             throw FirebirdException(
                 "Tuple arity mismatch: tuple has " + std::to_string(sizeof...(Args)) +
-                " elements, but query expects " + std::to_string(metadata->getCount()) + " parameters"
+                " elements, but query expects " + std::to_string(plan.size()) + " parameters"
             );
         }
         
@@ -119,7 +117,7 @@ public:
         
         // Pack all tuple elements
         if constexpr (sizeof...(Args) > 0) {
-            detail::TuplePackHelper<sizeof...(Args), Args...>::pack(tuple, buffer, metadata, transaction);
+            detail::TuplePackHelper<sizeof...(Args), Args...>::pack(tuple, buffer, plan.data(), transaction);
         }
     }
     
@@ -29,27 +29,24 @@ void unpackValueWithCodec(T& value,
     sql_value_codec::read_sql_value(ctx, dataPtr, value);
 }
 
-// Helper to recursively unpack tuple elements
+// Helper to recursively unpack tuple elements. Reads offsets and type info
+// from the precompiled column plan — no FieldInfo copies per row.
 template<size_t Index, typename... Args>
 struct TupleUnpackHelper {
-    static void unpack(std::tuple<Args...>& tuple, const uint8_t* buffer, const MessageMetadata* metadata, 
+    static void unpack(std::tuple<Args...>& tuple, const uint8_t* buffer, const ColumnPlan* plan,
                       ::fbpp::core::Transaction* transaction = nullptr) {
         constexpr size_t idx = sizeof...(Args) - Index;
+        const ColumnPlan& column = plan[idx];
         
-        // Get field info and offsets from metadata
-        FieldInfo fieldInfo = metadata->getField(idx);
-        unsigned data_offset = metadata->getOffset(idx);
-        unsigned null_offset = metadata->getNullOffset(idx);
-        
-        const uint8_t* data_ptr = buffer + data_offset;
-        const int16_t* null_ptr = reinterpret_cast<const int16_t*>(buffer + null_offset);
+        const uint8_t* data_ptr = buffer + column.offset;
+        const int16_t* null_ptr = reinterpret_cast<const int16_t*>(buffer + column.nullOffset);
         
         // Unpack this element using shared SQL codec
-        unpackValueWithCodec(std::get<idx>(tuple), data_ptr, null_ptr, &fieldInfo, transaction);
+        unpackValueWithCodec(std::get<idx>(tuple), data_ptr, null_ptr, column.field, transaction);
         
         // Recursively unpack remaining elements
         if constexpr (Index > 1) {
-            TupleUnpackHelper<Index - 1, Args...>::unpack(tuple, buffer, metadata, transaction);
+            TupleUnpackHelper<Index - 1, Args...>::unpack(tuple, buffer, plan, transaction);
         }
     }
 };
@@ -57,7 +54,7 @@ struct TupleUnpackHelper {
 // Base case specialization
 template<typename... Args>
 struct TupleUnpackHelper<0, Args...> {
-    static void unpack(std::tuple<Args...>&, const uint8_t*, const MessageMetadata*, ::fbpp::core::Transaction* = nullptr) {}
+    static void unpack(std::tuple<Args...>&, const uint8_t*, const ColumnPlan*, ::fbpp::core::Transaction* = nullptr) {}
 };
 
 } // namespace detail
@@ -76,17 +73,19 @@ public:
             throw FirebirdException("Invalid parameters for unpack");
         }
         
+        const auto& plan = metadata->getColumnPlan();
+
         // Verify field count matches
-        if (metadata->getCount() != sizeof...(Args)) {
+        if (plan.size() != sizeof...(Args)) {
             throw FirebirdException(
                 "Field count mismatch: expected " + std::to_string(sizeof...(Args)) +
-                ", got " + std::to_string(metadata->getCount())
+                ", got " + std::to_string(plan.size())
             );
         }
         
         // Unpack all tuple elements
         if constexpr (sizeof...(Args) > 0) {
-            detail::TupleUnpackHelper<sizeof...(Args), Args...>::unpack(result, buffer, metadata, transaction);
+            detail::TupleUnpackHelper<sizeof...(Args), Args...>::unpack(result, buffer, plan.data(), transaction);
         }
     }
     
@@ -3,8 +3,11 @@
 #include "fbpp/core/extended_types.hpp"
 #include "fbpp/core/type_adapter.hpp"
 #include "fbpp/core/firebird_compat.hpp"  // Firebird header compatibility layer
+#include <cstddef>
 #include <cstdint>
+#include <span>
 #include <string>
+#include <string_view>
 #include <optional>
 #include <type_traits>
 #include <tuple>
@@ -118,6 +121,61 @@ struct FirebirdTypeTraits<const char*> {
     static constexpr bool is_varying = true;
 };
 
+// Specialization for std::string_view (VARCHAR, parameters only: packed
+// straight from the viewed memory, never unpacked into)
+template<>
+struct FirebirdTypeTraits<std::string_view> {
+    static constexpr int sql_type = SQL_VARYING;
+    static constexpr size_t size = 0; // Variable size
+    static constexpr bool is_nullable = false;
+    static constexpr const char* type_name = "VARCHAR";
+    static constexpr int scale = 0;
+    using native_type = std::string_view;
+
+    static constexpr size_t default_length = 255;
+    static constexpr bool is_varying = true;
+};
+
+// Specialization for std::span<const std::byte> (binary VARCHAR / CHAR
+// OCTETS or BLOB; parameters only, like std::string_view)
+template<>
+struct FirebirdTypeTraits<std::span<const std::byte>> {
+    static constexpr int sql_type = SQL_VARYING;
+    static constexpr size_t size = 0; // Variable size
+    static constexpr bool is_nullable = false;
+    static constexpr const char* type_name = "VARCHAR";
+    static constexpr int scale = 0;
+    using native_type = std::span<const std::byte>;
+
+    static constexpr size_t default_length = 255;
+    static constexpr bool is_varying = true;
+};
+
+// Parameter values that view caller memory: text (std::string_view, C
+// strings) and bytes (std::span<const std::byte>). They are written into
+// the message, or streamed into a BLOB, without an intermediate copy.
+template<typename T>
+inline constexpr bool is_text_view_v =
+    std::is_same_v<T, std::string_view> || std::is_same_v<T, const char*> ||
+    std::is_same_v<T, char*>;
+
+template<typename T>
+inline constexpr bool is_byte_span_v = std::is_same_v<T, std::span<const std::byte>>;
+
+// Specialization for FixedString<N> (VARCHAR of at most N bytes, inline)
+template<std::size_t N>
+struct FirebirdTypeTraits<FixedString<N>> {
+    static constexpr int sql_type = SQL_VARYING;
+    static constexpr size_t size = N;
+    static constexpr bool is_nullable = false;
+    static constexpr const char* type_name = "VARCHAR";
+    static constexpr int scale = 0;
+    using native_type = FixedString<N>;
+
+    static constexpr size_t default_length = N;
+    static constexpr bool is_varying = true;
+};
+
 // Specialization for Int128
 template<>
 struct FirebirdTypeTraits<Int128> {
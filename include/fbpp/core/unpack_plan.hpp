@@ -0,0 +1,226 @@
+#pragma once
+
+// UnpackPlan<T> — tuple/struct unpacking resolved once per message format.
+//
+// The read-side counterpart of PackPlan<T>. unpack() of a tuple or
+// described struct used to let sql_value_codec normalize the SQL type and
+// walk its (C++ type, SQL type) branches for every value of every row, and
+// a struct re-checked each descriptor type per row. An UnpackPlan does the
+// matching once: it validates arity (and descriptor types for structs),
+// copies offsets and picks a reader per column — a typed load for the
+// cases pinned descriptors already decode directly (integers from
+// same-or-narrower columns at scale 0, floats from FLOAT/DOUBLE, bool from
+// BOOLEAN, std::string / FixedString from CHAR/VARCHAR), the codec for
+// everything else. Unpacking a row is then one indirect call per column.
+//
+// Descriptors with their own fast paths (message-layout structs, pinned
+// descriptors) keep going through unpackStructInto().
+//
+// Plans are cached per MessageMetadata (UnpackPlan<T>::of), so every
+// cursor of a statement shares them through its output metadata. Like
+// MessageMetadata itself, a plan cache is not thread-safe; a plan that has
+// been obtained is immutable.
+
+#include "fbpp/core/message_metadata.hpp"
+#include "fbpp/core/pack_plan.hpp"
+#include "fbpp/core/struct_descriptor.hpp"
+#include "fbpp/core/type_traits.hpp"
+#include "fbpp/core/detail/sql_value_codec.hpp"
+#include "fbpp/core/exception.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <typeindex>
+#include <utility>
+
+namespace fbpp::core {
+
+class Transaction;
+
+namespace detail {
+
+/// Reads one column value (`value` points at the C++ field)
+using UnpackReadFn = void (*)(void* value, const uint8_t* data, const int16_t* nullPtr,
+                              const FieldInfo* field, Transaction* transaction);
+
+template<typename V>
+void readCodecColumn(void* value, const uint8_t* data, const int16_t* nullPtr,
+                     const FieldInfo* field, Transaction* transaction) {
+    sql_value_codec::SqlReadContext ctx{field, transaction, nullPtr};
+    sql_value_codec::read_sql_value(ctx, data, *static_cast<V*>(value));
+}
+
+// pinned_read() of a column whose SQL type was matched at plan time; NULL
+// handling as in the codec
+template<typename V, unsigned SqlType>
+void readTypedColumn(void* value, const uint8_t* data, const int16_t* nullPtr,
+                     const FieldInfo* field, Transaction*) {
+    using U = typename unwrap_optional<V>::type;
+    V& typed = *static_cast<V*>(value);
+    if (sql_value_codec::isNull(nullPtr)) {
+        if constexpr (is_optional_v<V>) {
+            typed.reset();
+            return;
+        } else {
+            throw FirebirdException("NULL value for non-nullable field: " + field->name);
+        }
+    }
+    if constexpr (is_optional_v<V>) {
+        // Reuse a present value (a string keeps its capacity)
+        pinned_read<U, SqlType>(data, *field, typed ? *typed : typed.emplace());
+    } else {
+        pinned_read<U, SqlType>(data, *field, typed);
+    }
+}
+
+template<typename V, unsigned SqlType>
+constexpr UnpackReadFn typedReader() {
+    if constexpr (has_pinned_reader<typename unwrap_optional<V>::type, SqlType, 0>()) {
+        return &readTypedColumn<V, SqlType>;
+    } else {
+        return nullptr;
+    }
+}
+
+/**
+ * @brief Pick the reader for a C++ type V coming from `field`
+ */
+template<typename V>
+UnpackReadFn selectUnpackReader(const FieldInfo& field) {
+    UnpackReadFn typed = nullptr;
+    if (field.scale == 0) {
+        switch (sql_value_codec::normalize_sql_type(field.type)) {
+            case SQL_SHORT:   typed = typedReader<V, SQL_SHORT>(); break;
+            case SQL_LONG:    typed = typedReader<V, SQL_LONG>(); break;
+            case SQL_INT64:   typed = typedReader<V, SQL_INT64>(); break;
+            case SQL_FLOAT:   typed = typedReader<V, SQL_FLOAT>(); break;
+            case SQL_DOUBLE:
+            case SQL_D_FLOAT: typed = typedReader<V, SQL_DOUBLE>(); break;
+            case SQL_BOOLEAN: typed = typedReader<V, SQL_BOOLEAN>(); break;
+            default: break;
+        }
+        // Text as in the codec (un-normalized type)
+        if (field.type == SQL_VARYING) typed = typedReader<V, SQL_VARYING>();
+        if (field.type == SQL_TEXT) typed = typedReader<V, SQL_TEXT>();
+    }
+    return typed ? typed : &readCodecColumn<V>;
+}
+
+} // namespace detail
+
+/**
+ * @brief Column-by-column unpacking program for T against one message format
+ *
+ * T is a std::tuple or a type with a StructDescriptor. Construction
+ * validates T against the metadata and throws FirebirdException with the
+ * same messages unpack() always used.
+ */
+template<typename T>
+class UnpackPlan {
+    using Traits = detail::pack_plan_traits<T>;
+    static constexpr size_t kColumns = Traits::size;
+
+public:
+    explicit UnpackPlan(const MessageMetadata& metadata)
+        : layout_(metadata.getLayout()) {
+        const auto& plan = layout_->columnPlan;
+
+        if (kColumns != plan.size()) {
+            if constexpr (is_tuple_v<T>) {
+                throw FirebirdException(
+                    "Field count mismatch: expected " + std::to_string(kColumns) +
+                    ", got " + std::to_string(plan.size())
+                );
+            } else {
+                throw FirebirdException(
+                    std::string("Field count mismatch for ") +
+                    detail::descriptor_name<T>() +
+                    ": expected " + std::to_string(kColumns) +
+                    ", got " + std::to_string(plan.size())
+                );
+            }
+        }
+        if constexpr (!is_tuple_v<T>) {
+            checkDescriptor(std::make_index_sequence<kColumns>{});
+        }
+
+        build(std::make_index_sequence<kColumns>{});
+    }
+
+    /**
+     * @brief Overwrite `row` with the message in `buffer`
+     * @param transaction Transaction for BLOB columns (optional)
+     */
+    void unpack(const uint8_t* buffer, T& row, Transaction* transaction = nullptr) const {
+        unpackColumns(row, buffer, transaction, std::make_index_sequence<kColumns>{});
+    }
+
+    /**
+     * @brief Plan for `metadata`, built on first use and cached on it
+     */
+    static const UnpackPlan& of(const MessageMetadata& metadata) {
+        const std::type_index key(typeid(UnpackPlan));
+        if (auto cached = metadata.findPlan(key)) {
+            return *static_cast<const UnpackPlan*>(cached.get());
+        }
+        auto plan = std::make_shared<const UnpackPlan>(metadata);
+        const UnpackPlan& ref = *plan;
+        metadata.storePlan(key, std::move(plan));
+        return ref;
+    }
+
+private:
+    struct Column {
+        unsigned offset = 0;
+        unsigned nullOffset = 0;
+        const FieldInfo* field = nullptr;
+        detail::UnpackReadFn read = nullptr;
+    };
+
+    template<size_t... I>
+    void build(std::index_sequence<I...>) {
+        ((columns_[I] = Column{
+            layout_->columnPlan[I].offset,
+            layout_->columnPlan[I].nullOffset,
+            layout_->columnPlan[I].field,
+            detail::selectUnpackReader<typename Traits::template value_type<I>>(
+                *layout_->columnPlan[I].field)
+        }), ...);
+    }
+
+    // unpackField()'s per-row check, done once
+    template<size_t... I>
+    void checkDescriptor(std::index_sequence<I...>) const {
+        (checkField(std::get<I>(StructDescriptor<T>::fields), *layout_->columnPlan[I].field), ...);
+    }
+
+    template<typename Descriptor>
+    static void checkField(const Descriptor& descriptor, const FieldInfo& fieldInfo) {
+        if (descriptor.sqlType != fieldInfo.type) {
+            throw FirebirdException(
+                std::string("SQL type mismatch for field '") + descriptor.sqlName +
+                "': expected " + std::to_string(descriptor.sqlType) +
+                ", got " + std::to_string(fieldInfo.type)
+            );
+        }
+    }
+
+    template<size_t... I>
+    void unpackColumns(T& row, const uint8_t* buffer, Transaction* transaction,
+                       std::index_sequence<I...>) const {
+        (columns_[I].read(Traits::template address<I>(row),
+                          buffer + columns_[I].offset,
+                          reinterpret_cast<const int16_t*>(buffer + columns_[I].nullOffset),
+                          columns_[I].field,
+                          transaction), ...);
+    }
+
+    std::shared_ptr<const MetadataLayout> layout_;   // Owns the FieldInfo
+    std::array<Column, kColumns> columns_{};
+};
+
+} // namespace fbpp::core
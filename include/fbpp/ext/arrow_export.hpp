@@ -0,0 +1,81 @@
+#pragma once
+
+// Apache Arrow export: stream a ResultSet as arrow::RecordBatch blocks.
+//
+// Built on ResultSet::fetchColumns — every batch is decoded column-at-a-time
+// into a ColumnBatch and its buffers are *moved* into Arrow (no second copy
+// for fixed-width, String and Binary columns; the ColumnBatch layout is
+// already Arrow's: LSB-first validity, int32 offsets + byte payload).
+//
+// Type mapping (ColumnBatch physical type -> Arrow logical type):
+//   BOOLEAN                       -> boolean            (bit-packed on export)
+//   SMALLINT / INTEGER / BIGINT   -> int16 / int32 / int64
+//   NUMERIC / DECIMAL (scale < 0) -> decimal128(p, -scale), p = 5 / 10 / 19
+//                                    (storage digits: precision is not enforced)
+//   INT128, NUMERIC(38,x)         -> decimal128(38, -scale); a 39-digit value
+//                                    fails the batch (ReadNext returns IOError)
+//   FLOAT / DOUBLE PRECISION      -> float32 / float64
+//   DATE                          -> date32
+//   TIME [WITH TIME ZONE]         -> time64[us]    (UTC for TZ)
+//   TIMESTAMP                     -> timestamp[us]
+//   TIMESTAMP WITH TIME ZONE      -> timestamp[us, "UTC"]
+//   CHAR / VARCHAR, BLOB TEXT     -> utf8 (binary for CHARACTER SET OCTETS)
+//   DECFLOAT(16/34)               -> utf8 (exact decimal text)
+//   other BLOB                    -> binary
+//
+// Arrow carries one time zone per column, so per-row zone ids of
+// TIMESTAMP WITH TIME ZONE are normalised to UTC instants.
+//
+// Available only when fbpp is configured with -DFBPP_WITH_ARROW=ON; link
+// against fbpp::fbpp_arrow.
+
+#include "fbpp/core/column_batch.hpp"
+#include "fbpp/core/message_metadata.hpp"
+#include "fbpp/core/result_set.hpp"
+
+#ifdef FBPP_WITH_ARROW
+
+#include <arrow/api.h>
+
+#include <cstddef>
+#include <memory>
+
+namespace fbpp::ext {
+
+/// Arrow schema describing the rows of a statement's output metadata.
+/// Throws FirebirdException for columns without an Arrow mapping (ARRAY).
+std::shared_ptr<arrow::Schema>
+makeArrowSchema(const fbpp::core::MessageMetadata& metadata);
+
+/// Turn a decoded ColumnBatch into a RecordBatch bound to `schema`.
+/// The batch's buffers are moved into Arrow; `batch` is left empty.
+std::shared_ptr<arrow::RecordBatch>
+toRecordBatch(fbpp::core::ColumnBatch&& batch,
+              const std::shared_ptr<arrow::Schema>& schema);
+
+/// arrow::RecordBatchReader over an open cursor. The cursor must outlive
+/// the reader; each ReadNext() fetches up to batchSize rows. Firebird errors
+/// are reported as arrow::Status::IOError per the Arrow reader contract.
+class ResultSetRecordBatchReader final : public arrow::RecordBatchReader {
+public:
+    ResultSetRecordBatchReader(fbpp::core::ResultSet& resultSet,
+                               std::size_t batchSize = 65536);
+
+    std::shared_ptr<arrow::Schema> schema() const override { return schema_; }
+    arrow::Status ReadNext(std::shared_ptr<arrow::RecordBatch>* batch) override;
+
+private:
+    fbpp::core::ResultSet& resultSet_;
+    std::size_t batchSize_;
+    std::shared_ptr<arrow::Schema> schema_;
+};
+
+/// Convenience factory returning the reader as the Arrow base interface.
+inline std::shared_ptr<arrow::RecordBatchReader>
+makeRecordBatchReader(fbpp::core::ResultSet& resultSet, std::size_t batchSize = 65536) {
+    return std::make_shared<ResultSetRecordBatchReader>(resultSet, batchSize);
+}
+
+} // namespace fbpp::ext
+
+#endif // FBPP_WITH_ARROW
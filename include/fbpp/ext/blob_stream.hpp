@@ -2,18 +2,18 @@
 
 // PR-06: VCL TStream-friendly BLOB encode/decode helpers.
 //
-// Wraps Transaction::loadBlob and Transaction::createBlob(data, subType)
-// to/from System::Classes::TStream — the legacy contract of HiTek's
-// IDbAdapter (DsqlGetBlob / DsqlSetBlobParam) and any code that already
-// has a TMemoryStream / TFileStream payload.
+// Streams BLOBs to/from System::Classes::TStream through BlobReader /
+// BlobWriter — the legacy contract of HiTek's IDbAdapter (DsqlGetBlob /
+// DsqlSetBlobParam) and any code that already has a TMemoryStream /
+// TFileStream payload.
 //
-// Reading goes through Transaction::loadBlob which buffers the whole
-// BLOB into memory before writing to the stream. For very large BLOBs
-// a true segment-streaming variant (IBlob exposed) is a future PR.
+// Both directions move one segment-sized chunk at a time, so a BLOB is
+// never held in memory as a whole.
 
 #include "fbpp/core/firebird_compat.hpp"
 #include "fbpp/core/exception.hpp"
 #include "fbpp/core/extended_types.hpp"
+#include "fbpp/core/blob.hpp"
 #include "fbpp/core/transaction.hpp"
 #include "fbpp/ext/rad_variant_decoder.hpp"   // ColumnDecodePlan, RadColumnKind
 
@@ -21,8 +21,11 @@
 
 #include <System.Classes.hpp>
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <span>
 #include <vector>
 
 namespace fbpp::ext {
@@ -66,16 +69,18 @@ decodeBlobToStream(const ColumnDecodePlan& plan,
 
     ISC_QUAD blobRef{};
     std::memcpy(&blobRef, blobId.getId(), sizeof(blobRef));
-    auto bytes = txn->loadBlob(&blobRef);
+    auto reader = txn->openBlob(blobRef);
 
     // Reset target stream BEFORE writing — legacy DsqlGetBlob caller
     // typically passes a TMemoryStream that may already hold the
     // previous row's payload; appending or leaving a tail corrupts data.
+    // Pre-size from BLOB info so a TMemoryStream grows once.
     outStream->Position = 0;
-    outStream->Size     = 0;
-    if (!bytes.empty()) {
-        outStream->WriteBuffer(bytes.data(), static_cast<int>(bytes.size()));
-    }
+    outStream->Size     = static_cast<std::int64_t>(reader.info().totalLength);
+    reader.readAll([&](std::span<const std::byte> chunk) {
+        outStream->WriteBuffer(chunk.data(), static_cast<int>(chunk.size()));
+    });
+    outStream->Size     = outStream->Position;
     outStream->Position = 0;
     return true;
 }
@@ -102,13 +107,17 @@ encodeStreamToBlob(fbpp::core::Transaction* txn,
     }
 
     in->Position = 0;
-    const auto sz = in->Size;
-    std::vector<std::uint8_t> bytes(static_cast<std::size_t>(sz));
-    if (sz > 0) {
-        in->ReadBuffer(bytes.data(), static_cast<int>(sz));
+    auto writer = txn->createBlobStream(subType, false);
+    std::vector<std::uint8_t> chunk(fbpp::core::BlobWriter::kMaxSegmentBytes);
+    for (std::int64_t left = in->Size; left > 0;) {
+        const int n = static_cast<int>(
+            std::min<std::int64_t>(left, static_cast<std::int64_t>(chunk.size())));
+        in->ReadBuffer(chunk.data(), n);
+        writer.write(chunk.data(), static_cast<std::size_t>(n));
+        left -= n;
     }
 
-    ISC_QUAD blobId = txn->createBlob(bytes, subType);
+    ISC_QUAD blobId = writer.finish();
     *outBlob = fbpp::core::Blob(reinterpret_cast<const std::uint8_t*>(&blobId));
 }
 
@@ -8,8 +8,11 @@
 #ifdef FBPP_WITH_RAD_DATASET
 
 #include <fbpp/core/extended_types.hpp>
+#include <fbpp/core/scaled_numeric.hpp>
 #include <fbpp/core/timestamp_utils.hpp>
+#include <fbpp/core/detail/text_scan.hpp>
 #include <fbpp/ext/rad_variant_decoder.hpp>
+#include <fbpp/ext/lazy_blob.hpp>
 
 #include <Data.DB.hpp>
 #include <System.Classes.hpp>
@@ -97,30 +100,21 @@ inline std::vector<Data::Db::TDataSet*>& datasetStack() {
     return stack;
 }
 
-inline System::UnicodeString Utf8ToWide(const std::string& value) {
-    return System::UnicodeString(System::UTF8String(value.c_str()));
-}
-
 inline std::string TrimTrailingSpaces(std::string value) {
-    const auto it = std::find_if(value.rbegin(), value.rend(), [](unsigned char ch) {
-        return ch != ' ';
-    });
-    value.erase(it.base(), value.end());
+    value.resize(fbpp::core::detail::trimmedLength(value.data(), value.size()));
     return value;
 }
 
 inline double ApplyScale(int64_t value, int scale) {
     if (scale < 0) {
-        const double factor = std::pow(10.0, static_cast<double>(-scale));
-        return static_cast<double>(value) / factor;
+        return fbpp::core::scaledToDouble(value, scale);
     }
     return static_cast<double>(value);
 }
 
 inline double ApplyScale(double value, int scale) {
     if (scale < 0) {
-        const double factor = std::pow(10.0, static_cast<double>(-scale));
-        return value / factor;
+        return value / fbpp::core::pow10Double(-scale);
     }
     return value;
 }
@@ -169,7 +163,7 @@ private:
 };
 
 inline void AssignBlobField(Data::Db::TField* field,
-                            const fbpp::core::FieldInfo& info,
+                            const fbpp::ext::ColumnFieldInfo& info,
                             const unsigned char* dataPtr,
                             fbpp::core::Transaction* txn) {
     if (!field || !field->IsBlob() || !txn) {
@@ -192,8 +186,9 @@ inline void AssignBlobField(Data::Db::TField* field,
     }
 
     if (info.subType == 1) {
-        std::string text(blobData.begin(), blobData.end());
-        blobField->AsWideString = Utf8ToWide(text);
+        blobField->AsWideString = detail::TextToWide(
+            std::string_view(reinterpret_cast<const char*>(blobData.data()), blobData.size()),
+            info.charSet);
     } else {
         std::unique_ptr<System::Classes::TMemoryStream> stream(new System::Classes::TMemoryStream());
         if (!blobData.empty()) {
@@ -205,7 +200,7 @@ inline void AssignBlobField(Data::Db::TField* field,
 }
 
 inline void AssignField(Data::Db::TField* field,
-                        const fbpp::core::FieldInfo& info,
+                        const fbpp::ext::ColumnFieldInfo& info,
                         const unsigned char* dataPtr,
                         fbpp::core::Transaction* txn) {
     if (!field) {
@@ -235,6 +230,90 @@ inline void AssignField(Data::Db::TField* field,
     field->Value = value;
 }
 
+// Typed TField setters by RadColumnKind. Field->Value = v goes through
+// TField::SetAsVariant, which switches on VarType and ends in the same
+// SetAsInteger / SetAsFloat / ... call; here the row bytes go straight to
+// that setter with no Variant built or cleared per cell. Values are the
+// ones decodeFieldToVariant() produces (exactCurrency = true). Lossy and
+// unsupported kinds keep the Variant path, BLOBs keep AssignBlobField.
+inline void AssignPlannedField(Data::Db::TField* field,
+                               const fbpp::ext::ColumnDecodePlan& plan,
+                               const unsigned char* rowBase,
+                               fbpp::core::Transaction* txn) {
+    using namespace fbpp::core;
+    if (!field) {
+        return;
+    }
+    const auto* dataPtr = reinterpret_cast<const uint8_t*>(rowBase + plan.offset);
+    const auto& info = plan.info;
+
+    auto readScaled = [&]() -> int64_t {
+        switch (info.type) {
+            case SQL_SHORT: { int16_t raw; std::memcpy(&raw, dataPtr, 2); return raw; }
+            case SQL_LONG:  { int32_t raw; std::memcpy(&raw, dataPtr, 4); return raw; }
+            default:        { int64_t raw; std::memcpy(&raw, dataPtr, 8); return raw; }
+        }
+    };
+
+    if (!plan.lossy && !field->IsBlob()) {
+        switch (plan.kind) {
+            case RadColumnKind::Int32:
+                field->AsInteger = static_cast<int>(readScaled());
+                return;
+            case RadColumnKind::Int64:
+                field->AsLargeInt = static_cast<__int64>(readScaled());
+                return;
+            case RadColumnKind::Bool: {
+                uint8_t b = 0; std::memcpy(&b, dataPtr, 1);
+                field->AsBoolean = b != 0;
+                return;
+            }
+            case RadColumnKind::Currency: {
+                Currency value;
+                value.Val = readScaled() * pow10Int64(4 + info.scale);
+                field->AsCurrency = value;
+                return;
+            }
+            case RadColumnKind::Double:
+                if (info.type == SQL_FLOAT) {
+                    float raw = 0.f; std::memcpy(&raw, dataPtr, 4);
+                    field->AsFloat = raw;
+                } else {
+                    double raw = 0.0; std::memcpy(&raw, dataPtr, 8);
+                    field->AsFloat = raw;
+                }
+                return;
+            case RadColumnKind::Date: {
+                uint32_t fbDate = 0; std::memcpy(&fbDate, dataPtr, 4);
+                field->AsDateTime = System::TDateTime(fbpp::util::tdatetime_from_chrono(
+                    timestamp_utils::from_firebird_timestamp(fbDate, 0)));
+                return;
+            }
+            case RadColumnKind::Time: {
+                uint32_t fbTime = 0; std::memcpy(&fbTime, dataPtr, 4);
+                const auto micros = timestamp_utils::from_firebird_time(fbTime);
+                field->AsDateTime = System::TDateTime((double)micros.count() / 86400000000.0);
+                return;
+            }
+            case RadColumnKind::DateTime: {
+                uint32_t fbDate = 0, fbTime = 0;
+                std::memcpy(&fbDate, dataPtr, 4);
+                std::memcpy(&fbTime, dataPtr + 4, 4);
+                field->AsDateTime = System::TDateTime(fbpp::util::tdatetime_from_chrono(
+                    timestamp_utils::from_firebird_timestamp(fbDate, fbTime)));
+                return;
+            }
+            case RadColumnKind::WideString:
+                field->AsWideString = detail::TextToWide(
+                    fbpp::core::detail::textView(info.type, info.length, dataPtr), info.charSet);
+                return;
+            default:
+                break;
+        }
+    }
+    AssignField(field, info, rowBase + plan.offset, txn);
+}
+
 } // namespace
 
 DatasetScope::DatasetScope(Data::Db::TDataSet* dataset)
@@ -302,6 +381,22 @@ inline bool callDatasetProc(Data::Db::TDataSet* dataset, const wchar_t* name) {
     return true;
 }
 
+inline void clearDatasetRows(Data::Db::TDataSet* dataset) {
+#if defined(FBPP_WITH_EHLIB)
+    if (auto* mem = dynamic_cast<Memtableeh::TMemTableEh*>(dataset)) {
+        mem->EmptyTable();
+        return;
+    }
+#endif
+    if (!callDatasetProc(dataset, L"EmptyTable") &&
+        !callDatasetProc(dataset, L"EmptyDataSet")) {
+        dataset->First();
+        while (!dataset->Eof) {
+            dataset->Delete();
+        }
+    }
+}
+
 inline void ensureDatasetReady(Data::Db::TDataSet* dataset,
                                const fbpp::core::MessageMetadata& meta,
                                bool clearExisting) {
@@ -311,14 +406,22 @@ inline void ensureDatasetReady(Data::Db::TDataSet* dataset,
 
 	ControlGuard guard(dataset);
 
+    // Plans are shared per metadata layout; configures TFieldDefs through plan-based API.
+    const auto plans = fbpp::ext::cachedColumnPlans(meta);
+    if (dataset->Active && fieldDefsMatch(dataset->FieldDefs, *plans)) {
+        // Same shape as the current structure (a refresh of the same
+        // query): keep fields and storage, replace only the rows.
+        if (clearExisting) {
+            clearDatasetRows(dataset);
+        }
+        return;
+    }
+
     const bool wasActive = dataset->Active;
     if (wasActive) {
         dataset->Close();
     }
-
-    // Builds plans once and configures TFieldDefs through plan-based API.
-    auto plans = fbpp::ext::buildColumnPlans(meta);
-    configureFieldDefs(dataset->FieldDefs, plans);
+    configureFieldDefs(dataset->FieldDefs, *plans);
 
 #if defined(FBPP_WITH_EHLIB)
     if (auto* mem = dynamic_cast<Memtableeh::TMemTableEh*>(dataset)) {
@@ -345,20 +448,15 @@ inline void ensureDatasetReady(Data::Db::TDataSet* dataset,
     }
 
     if (clearExisting) {
-        if (!callDatasetProc(dataset, L"EmptyTable") &&
-            !callDatasetProc(dataset, L"EmptyDataSet")) {
-            dataset->First();
-            while (!dataset->Eof) {
-                dataset->Delete();
-            }
-        }
+        clearDatasetRows(dataset);
     }
 }
 
 inline void assignRow(Data::Db::TDataSet* dataset,
-                      const fbpp::core::MessageMetadata& meta,
+                      const std::vector<fbpp::ext::ColumnDecodePlan>& plans,
                       const unsigned char* buffer,
-                      fbpp::core::Transaction* txn) {
+                      fbpp::core::Transaction* txn,
+                      LazyBlobSource* lazyBlobs = nullptr) {
     if (!dataset) {
         throw std::invalid_argument("Dataset pointer must not be null");
     }
@@ -369,22 +467,53 @@ inline void assignRow(Data::Db::TDataSet* dataset,
         throw std::runtime_error("Dataset must be active before loading data");
     }
 
-    const auto fieldCount = meta.getCount();
-    const auto fields = meta.getFields();
+    const auto fieldCount = static_cast<unsigned>(plans.size());
+    bool deferredBlobs = false;
 
     dataset->Append();
     for (unsigned index = 0; index < fieldCount; ++index) {
         auto* field = dataset->Fields->Fields[index];
-        const auto nullPtr = reinterpret_cast<const std::int16_t*>(
-            buffer + meta.getNullOffset(index));
-        if (nullPtr && *nullPtr == -1) {
+        std::int16_t nullFlag = 0;
+        std::memcpy(&nullFlag, buffer + plans[index].nullOffset, sizeof(nullFlag));
+        if (nullFlag == -1) {
             field->Clear();
             continue;
         }
-        const auto* dataPtr = buffer + meta.getOffset(index);
-        AssignField(field, fields[index], dataPtr, txn);
+        if (lazyBlobs && plans[index].kind == RadColumnKind::Blob) {
+            field->Clear();   // Loaded by fetchLazyBlob(s) once the row is viewed
+            deferredBlobs = true;
+            continue;
+        }
+        AssignPlannedField(field, plans[index], buffer, txn);
     }
     dataset->Post();
+
+    if (deferredBlobs) {
+        // Keyed by the posted record, see lazyBlobRowKey()
+        const auto rowKey = detail::lazyBlobRowKey(dataset);
+        for (unsigned index = 0; index < fieldCount; ++index) {
+            if (plans[index].kind == RadColumnKind::Blob) {
+                lazyBlobs->remember(rowKey, index, buffer + plans[index].offset);
+            }
+        }
+    }
+}
+
+// Row-at-a-time entry (DatasetRow unpack): the plans for the last layout
+// seen on this thread are kept, so a fetch loop looks them up once.
+inline void assignRow(Data::Db::TDataSet* dataset,
+                      const fbpp::core::MessageMetadata& meta,
+                      const unsigned char* buffer,
+                      fbpp::core::Transaction* txn) {
+    thread_local std::shared_ptr<const fbpp::core::MetadataLayout> lastLayout;
+    thread_local std::shared_ptr<const std::vector<fbpp::ext::ColumnDecodePlan>> lastPlans;
+
+    auto layout = meta.getLayout();
+    if (!layout || layout != lastLayout || !lastPlans) {
+        lastPlans = fbpp::ext::cachedColumnPlans(meta);
+        lastLayout = layout;
+    }
+    assignRow(dataset, *lastPlans, buffer, txn);
 }
 
 } // namespace detail
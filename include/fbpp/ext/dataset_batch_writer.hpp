@@ -0,0 +1,483 @@
+#pragma once
+
+// Apply TDataSet / TMemTableEh edits through IBatch: one batch per DML
+// statement type instead of one UPDATE round trip per edited row.
+//
+//   DatasetBatchWriter writer(conn, "ORDERS", {"ID"});
+//   DatasetDelta delta;
+//   writer.prepare(delta);                   // Old key values are kept from here on
+//   // BeforeDelete: delta.markDeleted(ds);  (deleted rows are not visible later)
+//   delta.collect(mem);                      // usInserted / usModified records
+//   auto result = writer.apply(*tx, delta);
+//   if (result.ok()) tx->Commit();
+//   else for (auto& e : result.errors) gotoChange(mem, delta, e.change);
+//
+// Changes are snapshots (field values, old key values, bookmark) taken by
+// collect() or the mark*() calls, so the dataset can keep changing while
+// a delta is built. apply() runs deletes, then updates, then inserts —
+// each as one prepared statement and one Batch with continueOnError; the
+// per-message BatchResult statuses are mapped back to change indexes.
+//
+// Column names are the dataset field names (FieldName, quoted as is):
+// DatasetLoader names fields after the query's columns, so a dataset
+// loaded from "SELECT * FROM ORDERS" writes back to ORDERS unchanged.
+// Only fkData fields are written. BLOB parameters travel with the batch
+// (BatchBlobPolicy::IdEngine), no Transaction::createBlob per row. The
+// transaction is neither committed nor rolled back here.
+
+#include "fbpp/core/batch.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/extended_types.hpp"
+#include "fbpp/core/message_metadata.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/detail/sql_value_codec.hpp"
+#include "fbpp_util/tdatetime.hpp"
+
+#ifdef FBPP_WITH_RAD_DATASET
+
+#include <Data.DB.hpp>
+#include <System.SysUtils.hpp>
+#include <System.Variants.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fbpp::ext {
+
+enum class DatasetChangeKind { Insert, Update, Delete };
+
+struct DatasetChange {
+    DatasetChangeKind kind = DatasetChangeKind::Insert;
+    std::vector<System::Variant> values;      // Per DatasetDelta::fieldNames()
+    std::vector<System::Variant> oldKeys;     // Key values before the edit
+    Data::Db::TBookmark bookmark;             // Empty for deleted records
+};
+
+/// Changed records of one dataset, in the order they were taken.
+class DatasetDelta {
+public:
+    /// Snapshot every usInserted / usModified record (cached-updates
+    /// datasets). Returns the number of records taken. The current record
+    /// and controls are restored.
+    std::size_t collect(Data::Db::TDataSet* dataset) {
+        requireActive(dataset);
+        std::size_t taken = 0;
+        dataset->DisableControls();
+        const Data::Db::TBookmark current = dataset->Bookmark;
+        try {
+            for (dataset->First(); !dataset->Eof; dataset->Next()) {
+                switch (dataset->UpdateStatus()) {
+                    case Data::Db::usInserted: markInserted(dataset); ++taken; break;
+                    case Data::Db::usModified: markModified(dataset); ++taken; break;
+                    default: break;
+                }
+            }
+        } catch (...) {
+            restore(dataset, current);
+            throw;
+        }
+        restore(dataset, current);
+        return taken;
+    }
+
+    void markInserted(Data::Db::TDataSet* dataset) { take(dataset, DatasetChangeKind::Insert); }
+    void markModified(Data::Db::TDataSet* dataset) { take(dataset, DatasetChangeKind::Update); }
+    /// Call before the record is deleted (TDataSet::BeforeDelete).
+    void markDeleted(Data::Db::TDataSet* dataset) { take(dataset, DatasetChangeKind::Delete); }
+
+    const std::vector<DatasetChange>& changes() const noexcept { return changes_; }
+    const std::vector<System::UnicodeString>& fieldNames() const noexcept { return names_; }
+    bool empty() const noexcept { return changes_.empty(); }
+    void clear() { changes_.clear(); }
+
+    /// Key fields whose old values are kept (set by DatasetBatchWriter).
+    void setKeyFields(std::vector<System::UnicodeString> keys) { keys_ = std::move(keys); }
+
+private:
+    static void requireActive(Data::Db::TDataSet* dataset) {
+        if (!dataset || !dataset->Active) {
+            throw fbpp::core::FirebirdException("DatasetDelta: dataset is not active");
+        }
+    }
+
+    static void restore(Data::Db::TDataSet* dataset, const Data::Db::TBookmark& bookmark) {
+        if (bookmark.Length > 0 && dataset->BookmarkValid(bookmark)) {
+            dataset->GotoBookmark(bookmark);
+        }
+        dataset->EnableControls();
+    }
+
+    void take(Data::Db::TDataSet* dataset, DatasetChangeKind kind) {
+        requireActive(dataset);
+        if (names_.empty()) {
+            for (int i = 0; i < dataset->Fields->Count; ++i) {
+                auto* field = dataset->Fields->Fields[i];
+                if (field->FieldKind == Data::Db::fkData) {
+                    names_.push_back(field->FieldName);
+                }
+            }
+        }
+        DatasetChange change;
+        change.kind = kind;
+        change.values.reserve(names_.size());
+        for (const auto& name : names_) {
+            change.values.push_back(dataset->FieldByName(name)->Value);
+        }
+        for (const auto& key : keys_) {
+            auto* field = dataset->FieldByName(key);
+            // OldValue is the value before the pending edit (Null for inserts)
+            System::Variant old = kind == DatasetChangeKind::Insert ? field->Value : field->OldValue;
+            change.oldKeys.push_back(System::Variants::VarIsNull(old) ? field->Value : old);
+        }
+        if (kind != DatasetChangeKind::Delete) {
+            change.bookmark = dataset->Bookmark;
+        }
+        changes_.push_back(std::move(change));
+    }
+
+    std::vector<System::UnicodeString> names_;
+    std::vector<System::UnicodeString> keys_;
+    std::vector<DatasetChange> changes_;
+};
+
+struct DatasetApplyError {
+    DatasetChangeKind kind;
+    std::size_t change;     // Index into DatasetDelta::changes()
+    std::string message;
+};
+
+struct DatasetApplyResult {
+    unsigned inserted = 0;
+    unsigned updated = 0;
+    unsigned deleted = 0;
+    std::vector<DatasetApplyError> errors;
+
+    bool ok() const noexcept { return errors.empty(); }
+};
+
+/// Move to the record of a change (no-op for deleted records).
+inline bool gotoChange(Data::Db::TDataSet* dataset, const DatasetDelta& delta, std::size_t change) {
+    const auto& bookmark = delta.changes().at(change).bookmark;
+    if (!dataset || bookmark.Length == 0 || !dataset->BookmarkValid(bookmark)) {
+        return false;
+    }
+    dataset->GotoBookmark(bookmark);
+    return true;
+}
+
+namespace detail {
+
+inline std::string WideToUtf8(const System::UnicodeString& text) {
+    const System::UTF8String utf8(text);
+    return std::string(utf8.c_str(), static_cast<std::size_t>(utf8.Length()));
+}
+
+inline std::string QuoteIdentifier(const std::string& id) {
+    std::string quoted = "\"";
+    for (char ch : id) {
+        quoted += ch;
+        if (ch == '"') quoted += '"';
+    }
+    return quoted + "\"";
+}
+
+inline std::string QuoteIdentifier(const System::UnicodeString& name) {
+    return QuoteIdentifier(WideToUtf8(name));
+}
+
+inline std::vector<std::uint8_t> VariantBytes(const System::Variant& value, bool text) {
+    if (System::Variants::VarIsArray(value)) {
+        const int n = System::Variants::VarArrayHighBound(value, 1) -
+                      System::Variants::VarArrayLowBound(value, 1) + 1;
+        std::vector<std::uint8_t> bytes(n > 0 ? n : 0);
+        if (n > 0) {
+            void* p = System::Variants::VarArrayLock(value);
+            std::memcpy(bytes.data(), p, n);
+            System::Variants::VarArrayUnlock(value);
+        }
+        return bytes;
+    }
+    // Memo text goes out as UTF-8; a binary BLOB held as a string keeps its bytes
+    const std::string s = text ? WideToUtf8(System::UnicodeString(value))
+                               : std::string(System::AnsiString(value).c_str(),
+                                             System::AnsiString(value).Length());
+    return std::vector<std::uint8_t>(s.begin(), s.end());
+}
+
+// Write one Variant into parameter `param` of `message`.
+inline void EncodeVariantParam(const System::Variant& value,
+                               const fbpp::core::FieldInfo& param,
+                               std::uint8_t* message,
+                               fbpp::core::Batch& batch,
+                               fbpp::core::Transaction* txn) {
+    namespace codec = fbpp::core::detail::sql_value_codec;
+    auto* nullPtr = reinterpret_cast<std::int16_t*>(message + param.nullOffset);
+    std::uint8_t* data = message + param.offset;
+    if (System::Variants::VarIsNull(value) || System::Variants::VarIsEmpty(value)) {
+        codec::setNull(nullPtr);
+        return;
+    }
+    const codec::SqlWriteContext ctx{&param, txn, nullPtr};
+    const unsigned sqlType = param.type & ~1u;
+
+    if (sqlType == SQL_BLOB) {
+        const auto bytes = VariantBytes(value, param.subType == 1);
+        const fbpp::core::Blob id = batch.addBlob(bytes.data(), bytes.size());
+        std::memcpy(data, id.getId(), sizeof(ISC_QUAD));
+        codec::setNotNull(nullPtr);
+        return;
+    }
+
+    switch (System::Variants::VarType(value) & System::varTypeMask) {
+        case System::varSmallint:
+        case System::varShortInt:
+        case System::varByte:
+        case System::varWord:
+        case System::varInteger:
+        case System::varLongWord:
+        case System::varInt64:
+            codec::write_sql_value(ctx, static_cast<std::int64_t>(static_cast<__int64>(value)), data);
+            return;
+        case System::varUInt64:
+            codec::write_sql_value(ctx, static_cast<std::uint64_t>(static_cast<unsigned __int64>(value)), data);
+            return;
+        case System::varBoolean:
+            codec::write_sql_value(ctx, static_cast<bool>(value), data);
+            return;
+        case System::varSingle:
+        case System::varDouble:
+            codec::write_sql_value(ctx, static_cast<double>(value), data);
+            return;
+        case System::varCurrency: {
+            // Exact: raw ×10⁻⁴ as decimal text, parsed against the parameter scale
+            const System::Currency c = value;
+            const std::int64_t raw = c.Val;
+            const std::uint64_t mag = raw < 0 ? 0 - static_cast<std::uint64_t>(raw)
+                                              : static_cast<std::uint64_t>(raw);
+            std::string frac = std::to_string(mag % 10000);
+            frac.insert(0, 4 - frac.size(), '0');
+            codec::write_sql_value(ctx, std::string(raw < 0 ? "-" : "") +
+                                            std::to_string(mag / 10000) + "." + frac, data);
+            return;
+        }
+        case System::varDate: {
+            const double dt = static_cast<double>(static_cast<System::TDateTime>(value));
+            const fbpp::core::Timestamp ts(fbpp::util::chrono_from_tdatetime(dt));
+            const std::uint32_t date = ts.getDate();
+            const std::uint32_t time = ts.getTime();
+            switch (sqlType) {
+                case SQL_TYPE_DATE:
+                    std::memcpy(data, &date, 4);
+                    break;
+                case SQL_TYPE_TIME:
+                    std::memcpy(data, &time, 4);
+                    break;
+                case SQL_TIMESTAMP:
+                    std::memcpy(data, &date, 4);
+                    std::memcpy(data + 4, &time, 4);
+                    break;
+                default:
+                    codec::write_sql_value(ctx, WideToUtf8(System::Sysutils::FormatDateTime(
+                                                    L"yyyy-mm-dd hh:nn:ss.zzz", dt)), data);
+                    return;
+            }
+            codec::setNotNull(nullPtr);
+            return;
+        }
+        default:
+            codec::write_sql_value(ctx, WideToUtf8(System::Variants::VarToStr(value)), data);
+            return;
+    }
+}
+
+} // namespace detail
+
+/// INSERT / UPDATE / DELETE of DatasetDelta changes against one table,
+/// keyed by `keyFields` (dataset field names).
+class DatasetBatchWriter {
+public:
+    DatasetBatchWriter(fbpp::core::Connection& connection,
+                       std::string table,
+                       std::vector<System::UnicodeString> keyFields)
+        : connection_(connection), table_(std::move(table)), keys_(std::move(keyFields)) {
+        if (keys_.empty()) {
+            throw fbpp::core::FirebirdException("DatasetBatchWriter: no key fields for " + table_);
+        }
+    }
+
+    /// Key fields the delta must keep old values of; call before taking
+    /// changes (DatasetDelta::setKeyFields).
+    void prepare(DatasetDelta& delta) const { delta.setKeyFields(keys_); }
+
+    /// Run the delta's changes in `transaction`: deletes, updates, inserts.
+    /// Failed rows are reported in DatasetApplyResult::errors; the others
+    /// are applied (commit / rollback is the caller's decision).
+    DatasetApplyResult apply(fbpp::core::Transaction& transaction, const DatasetDelta& delta) {
+        DatasetApplyResult result;
+        if (delta.empty()) {
+            return result;
+        }
+        const auto& names = delta.fieldNames();
+        for (const auto& key : keys_) {
+            auto it = std::find_if(names.begin(), names.end(), [&](const System::UnicodeString& n) {
+                return System::Sysutils::SameText(n, key);
+            });
+            if (it == names.end()) {
+                throw fbpp::core::FirebirdException("DatasetBatchWriter: key field " +
+                                                    detail::WideToUtf8(key) + " is not in the dataset");
+            }
+        }
+        for (const auto& change : delta.changes()) {
+            if (change.oldKeys.size() != keys_.size()) {
+                throw fbpp::core::FirebirdException(
+                    "DatasetBatchWriter: delta was not prepared for the keys of " + table_);
+            }
+        }
+
+        result.deleted = run(transaction, delta, DatasetChangeKind::Delete, result.errors);
+        result.updated = run(transaction, delta, DatasetChangeKind::Update, result.errors);
+        result.inserted = run(transaction, delta, DatasetChangeKind::Insert, result.errors);
+        return result;
+    }
+
+    const std::string& table() const noexcept { return table_; }
+
+private:
+    bool isKey(const System::UnicodeString& name) const {
+        return std::any_of(keys_.begin(), keys_.end(), [&](const System::UnicodeString& k) {
+            return System::Sysutils::SameText(k, name);
+        });
+    }
+
+    // SQL of `kind` and, per parameter, where its value comes from: index
+    // into change.values, or (key) index into change.oldKeys.
+    struct Source { bool oldKey; std::size_t index; };
+
+    std::string renderSql(DatasetChangeKind kind, const std::vector<System::UnicodeString>& names,
+                          std::vector<Source>& sources) const {
+        const std::string table = detail::QuoteIdentifier(table_);
+        auto where = [&]() {
+            std::string sql = " WHERE ";
+            for (std::size_t k = 0; k < keys_.size(); ++k) {
+                if (k > 0) sql += " AND ";
+                sql += detail::QuoteIdentifier(keys_[k]) + " = ?";
+                sources.push_back(Source{true, k});
+            }
+            return sql;
+        };
+
+        if (kind == DatasetChangeKind::Delete) {
+            return "DELETE FROM " + table + where();
+        }
+        if (kind == DatasetChangeKind::Update) {
+            std::string sql = "UPDATE " + table + " SET ";
+            bool first = true;
+            for (std::size_t i = 0; i < names.size(); ++i) {
+                if (isKey(names[i])) continue;
+                if (!first) sql += ", ";
+                first = false;
+                sql += detail::QuoteIdentifier(names[i]) + " = ?";
+                sources.push_back(Source{false, i});
+            }
+            // Keys may be edited too: SET them from the new values
+            for (std::size_t i = 0; i < names.size(); ++i) {
+                if (!isKey(names[i])) continue;
+                if (!first) sql += ", ";
+                first = false;
+                sql += detail::QuoteIdentifier(names[i]) + " = ?";
+                sources.push_back(Source{false, i});
+            }
+            return sql + where();
+        }
+        std::string columns;
+        std::string marks;
+        for (std::size_t i = 0; i < names.size(); ++i) {
+            columns += (i > 0 ? ", " : "") + detail::QuoteIdentifier(names[i]);
+            marks += i > 0 ? ", ?" : "?";
+            sources.push_back(Source{false, i});
+        }
+        return "INSERT INTO " + table + " (" + columns + ") VALUES (" + marks + ")";
+    }
+
+    unsigned run(fbpp::core::Transaction& transaction, const DatasetDelta& delta,
+                 DatasetChangeKind kind, std::vector<DatasetApplyError>& errors) {
+        std::vector<std::size_t> rows;   // Change indexes, in batch message order
+        for (std::size_t i = 0; i < delta.changes().size(); ++i) {
+            if (delta.changes()[i].kind == kind) rows.push_back(i);
+        }
+        if (rows.empty()) {
+            return 0;
+        }
+
+        std::vector<Source> sources;
+        const std::string sql = renderSql(kind, delta.fieldNames(), sources);
+        auto statement = connection_.prepareStatement(sql);
+        const auto meta = statement->getInputMetadata();
+        if (!meta || meta->getCount() != sources.size()) {
+            throw fbpp::core::FirebirdException("DatasetBatchWriter: unexpected parameters for " + sql);
+        }
+        const auto params = meta->getFields();
+
+        fbpp::core::BatchOptions options;
+        options.recordCounts = true;
+        options.continueOnError = true;
+        options.detailedErrors = static_cast<unsigned>(std::min<std::size_t>(rows.size(), 1000));
+        if (std::any_of(params.begin(), params.end(),
+                        [](const fbpp::core::FieldInfo& f) { return (f.type & ~1u) == SQL_BLOB; })) {
+            options.blobPolicy = fbpp::core::BatchBlobPolicy::IdEngine;
+        }
+        auto batch = statement->createBatch(&transaction, options);
+
+        std::vector<std::uint8_t> message(std::max<std::size_t>(meta->getMessageLength(),
+                                                                batch->getMessageBytes()));
+        for (std::size_t row : rows) {
+            const auto& change = delta.changes()[row];
+            std::fill(message.begin(), message.end(), std::uint8_t{0});
+            for (std::size_t p = 0; p < sources.size(); ++p) {
+                const auto& src = sources[p];
+                const System::Variant& value = src.oldKey ? change.oldKeys.at(src.index)
+                                                          : change.values.at(src.index);
+                detail::EncodeVariantParam(value, params[p], message.data(), *batch, &transaction);
+            }
+            batch->addPacked(message.data(), 1);
+        }
+
+        const fbpp::core::BatchResult outcome = batch->execute(&transaction);
+        unsigned applied = 0;
+        for (std::size_t m = 0; m < rows.size(); ++m) {
+            const int status = m < outcome.perMessageStatus.size() ? outcome.perMessageStatus[m] : -2;
+            if (status == -1) {
+                std::string text = "execute failed";
+                for (std::size_t e = 0; e < outcome.errorIndices.size(); ++e) {
+                    if (outcome.errorIndices[e] == m && e < outcome.errors.size()) {
+                        text = outcome.errors[e];
+                        break;
+                    }
+                }
+                errors.push_back(DatasetApplyError{kind, rows[m], std::move(text)});
+            } else if (status == 0 && kind != DatasetChangeKind::Insert) {
+                // The keyed row is gone or its key changed on the server
+                errors.push_back(DatasetApplyError{kind, rows[m], "no record matched the key"});
+            } else {
+                ++applied;
+            }
+        }
+        return applied;
+    }
+
+    fbpp::core::Connection& connection_;
+    std::string table_;
+    std::vector<System::UnicodeString> keys_;
+};
+
+} // namespace fbpp::ext
+
+#endif // FBPP_WITH_RAD_DATASET
@@ -21,6 +21,7 @@ public:
             throw std::invalid_argument("DatasetLoader requires non-null dataset");
         }
         detail::ensureDatasetReady(dataSet_, metadata, clearExisting);
+        plans_ = cachedColumnPlans(metadata);
     }
 
     void loadRow(const unsigned char* buffer,
@@ -30,13 +31,27 @@ public:
             throw std::runtime_error("DatasetLoader not initialized with dataset");
         }
         DatasetScope scope(dataSet_);
-        detail::assignRow(dataSet_, metadata, buffer, txn);
+        if (!plans_ || metadata.getCount() != plans_->size()) {
+            throw std::runtime_error("DatasetLoader: row metadata does not match the dataset structure");
+        }
+        detail::assignRow(dataSet_, *plans_, buffer, txn, lazyBlobs_.get());
+    }
+
+    /// Keep BLOB ids instead of loading BLOB content per row; the content
+    /// is loaded by fetchLazyBlob(s) (lazy_blob.hpp). Null restores eager
+    /// loading.
+    void setLazyBlobs(std::shared_ptr<LazyBlobSource> source) {
+        lazyBlobs_ = std::move(source);
     }
 
+    const std::vector<ColumnDecodePlan>& plans() const noexcept { return *plans_; }
     Data::Db::TDataSet* dataset() const { return dataSet_; }
 
 private:
     Data::Db::TDataSet* dataSet_ = nullptr;
+    // Set by resetStructure(); shared with every load of the same layout
+    std::shared_ptr<const std::vector<ColumnDecodePlan>> plans_;
+    std::shared_ptr<LazyBlobSource> lazyBlobs_;
 };
 
 } // namespace fbpp::ext
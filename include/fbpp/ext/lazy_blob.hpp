@@ -0,0 +1,276 @@
+#pragma once
+
+// Lazy (on-demand) BLOB columns for DatasetLoader and loadIntoMemTable.
+//
+// opts.loadBlobs is all-or-nothing: every row pulls its BLOB content, or
+// BLOB cells stay empty. With a LazyBlobSource the sinks keep the BLOB id
+// of each non-null cell instead, leave the cell NULL, and the content is
+// loaded when the row is looked at:
+//
+//   auto blobs = std::make_shared<LazyBlobSource>(*tx, plans);
+//   loadIntoMemTable(mt, *rs, plans, opts, 0, blobs.get());
+//   ...
+//   void __fastcall TForm1::MemAfterScroll(TDataSet* ds) { fetchLazyBlobs(ds, *blobs); }
+//   // or per field, from TField::OnGetText: fetchLazyBlob(ds, Sender, *blobs)
+//
+// The source retains the transaction the rows were read in (BLOB ids are
+// read through it), so a cursor over a snapshot stays readable after the
+// ResultSet is gone. Loaded contents go through a small byte-bounded LRU
+// keyed by BLOB id: rows reloaded in the same transaction (screen refresh)
+// do not fetch the same BLOB twice.
+//
+// A cell is written once, on first fetch: TMemTableEh records directly
+// (no dataset state change), other datasets through Edit / Post. Row keys
+// are TMemoryRecordEh* for TMemTableEh and RecNo otherwise, so a generic
+// dataset must not be re-sorted while ids are pending. Not thread-safe;
+// used from the UI thread like the dataset itself.
+
+#include "fbpp/core/firebird_compat.hpp"
+#include "fbpp/core/blob.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/ext/rad_variant_decoder.hpp"
+
+#ifdef FBPP_WITH_RAD_DATASET
+
+#include <Data.DB.hpp>
+#include <System.Classes.hpp>
+#include <System.Variants.hpp>
+
+#if defined(FBPP_WITH_EHLIB)
+#include <MemTableEh.hpp>
+#include <MemTableDataEh.hpp>
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace fbpp::ext {
+
+class LazyBlobSource {
+public:
+    static constexpr std::size_t kDefaultCacheBytes = 16u * 1024u * 1024u;
+
+    /// `plans` are the column plans of the rows that will be remembered
+    /// (the charset / sub_type of each BLOB column decides text vs bytes).
+    LazyBlobSource(fbpp::core::Transaction& transaction,
+                   std::vector<ColumnDecodePlan> plans,
+                   std::size_t cacheBytes = kDefaultCacheBytes)
+        : transaction_(transaction.shared_from_this()),
+          plans_(std::move(plans)),
+          cacheLimit_(cacheBytes) {}
+
+    /// Keep the BLOB id at blobIdPtr for (rowKey, column); null ids are
+    /// not kept (the cell is simply NULL).
+    void remember(std::uintptr_t rowKey, unsigned column, const std::uint8_t* blobIdPtr) {
+        fbpp::core::Blob blob(blobIdPtr);
+        if (blob.isNull()) {
+            return;
+        }
+        ISC_QUAD id{};
+        std::memcpy(&id, blob.getId(), sizeof(id));
+        pending_[cellKey(rowKey, column)] = id;
+    }
+
+    bool pending(std::uintptr_t rowKey, unsigned column) const {
+        return pending_.count(cellKey(rowKey, column)) != 0;
+    }
+
+    std::size_t pendingCount() const noexcept { return pending_.size(); }
+    std::size_t cachedBytes() const noexcept { return cachedBytes_; }
+    const std::vector<ColumnDecodePlan>& plans() const noexcept { return plans_; }
+    const std::shared_ptr<fbpp::core::Transaction>& transaction() const noexcept {
+        return transaction_;
+    }
+
+    /// Content of the pending cell as the Variant decodeFieldToVariant()
+    /// would give with loadBlobs (UnicodeString or varArray of varByte);
+    /// empty Variant if nothing is pending. The cell is no longer pending.
+    System::Variant take(std::uintptr_t rowKey, unsigned column) {
+        auto it = pending_.find(cellKey(rowKey, column));
+        if (it == pending_.end()) {
+            return System::Variant();
+        }
+        const ISC_QUAD id = it->second;
+        pending_.erase(it);
+
+        const auto data = load(id);
+        const auto& info = plans_.at(column).info;
+        if (info.subType == 1) {
+            return System::Variant(detail::TextToWide(
+                std::string_view(reinterpret_cast<const char*>(data->data()), data->size()),
+                info.charSet));
+        }
+        const int n = static_cast<int>(data->size());
+        System::Variant arr = System::Variants::VarArrayCreate(
+            OPENARRAY(int, (0, n - 1)), System::varByte);
+        if (n > 0) {
+            void* p = System::Variants::VarArrayLock(arr);
+            std::memcpy(p, data->data(), n);
+            System::Variants::VarArrayUnlock(arr);
+        }
+        return arr;
+    }
+
+    /// BLOB content through the LRU; loads via the retained transaction on
+    /// a miss. A BLOB larger than the whole budget is returned uncached.
+    std::shared_ptr<const std::vector<std::uint8_t>> load(const ISC_QUAD& id) {
+        const std::uint64_t key = blobKey(id);
+        if (auto it = cache_.find(key); it != cache_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            return it->second->data;
+        }
+
+        ISC_QUAD ref = id;
+        auto data = std::make_shared<const std::vector<std::uint8_t>>(transaction_->loadBlob(&ref));
+        if (data->size() > cacheLimit_) {
+            return data;
+        }
+        lru_.push_front(Entry{key, data});
+        cache_[key] = lru_.begin();
+        cachedBytes_ += data->size();
+        while (cachedBytes_ > cacheLimit_ && !lru_.empty()) {
+            cachedBytes_ -= lru_.back().data->size();
+            cache_.erase(lru_.back().key);
+            lru_.pop_back();
+        }
+        return data;
+    }
+
+    /// Forget pending ids and cached contents (e.g. before a reload into
+    /// the same dataset). The transaction stays retained.
+    void clear() {
+        pending_.clear();
+        cache_.clear();
+        lru_.clear();
+        cachedBytes_ = 0;
+    }
+
+private:
+    struct Entry {
+        std::uint64_t key;
+        std::shared_ptr<const std::vector<std::uint8_t>> data;
+    };
+
+    struct CellKey {
+        std::uintptr_t row;
+        unsigned column;
+        bool operator==(const CellKey& other) const noexcept {
+            return row == other.row && column == other.column;
+        }
+    };
+
+    struct CellKeyHash {
+        std::size_t operator()(const CellKey& key) const noexcept {
+            return std::hash<std::uintptr_t>{}(key.row) * 31u + key.column;
+        }
+    };
+
+    static CellKey cellKey(std::uintptr_t row, unsigned column) noexcept {
+        return CellKey{row, column};
+    }
+
+    static std::uint64_t blobKey(const ISC_QUAD& id) noexcept {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(id.gds_quad_high)) << 32) |
+               id.gds_quad_low;
+    }
+
+    std::shared_ptr<fbpp::core::Transaction> transaction_;
+    std::vector<ColumnDecodePlan> plans_;
+    std::unordered_map<CellKey, ISC_QUAD, CellKeyHash> pending_;
+    std::list<Entry> lru_;   // Most recently used first
+    std::unordered_map<std::uint64_t, std::list<Entry>::iterator> cache_;
+    std::size_t cachedBytes_ = 0;
+    std::size_t cacheLimit_;
+};
+
+namespace detail {
+
+// Row key the sinks remember ids under for the dataset's current record.
+inline std::uintptr_t lazyBlobRowKey(Data::Db::TDataSet* dataset) {
+#if defined(FBPP_WITH_EHLIB)
+    if (auto* mem = dynamic_cast<Memtableeh::TMemTableEh*>(dataset)) {
+        return reinterpret_cast<std::uintptr_t>(mem->Rec);
+    }
+#endif
+    return static_cast<std::uintptr_t>(dataset->RecNo);
+}
+
+} // namespace detail
+
+/// Load the pending BLOB of `field` on the current record into its cell.
+/// Returns false if nothing was pending (already loaded, NULL, or not a
+/// lazily loaded column).
+inline bool fetchLazyBlob(Data::Db::TDataSet* dataset,
+                          Data::Db::TField* field,
+                          LazyBlobSource& source) {
+    if (!dataset || !field || !dataset->Active || dataset->IsEmpty()) {
+        return false;
+    }
+    const unsigned column = static_cast<unsigned>(field->Index);
+    const std::uintptr_t rowKey = detail::lazyBlobRowKey(dataset);
+    if (!source.pending(rowKey, column)) {
+        return false;
+    }
+    System::Variant value = source.take(rowKey, column);
+
+#if defined(FBPP_WITH_EHLIB)
+    if (auto* mem = dynamic_cast<Memtableeh::TMemTableEh*>(dataset)) {
+        mem->Rec->Value[static_cast<int>(column)][Memtabledataeh::dvvValueEh] = value;
+        mem->Resync(Data::Db::TResyncMode());
+        return true;
+    }
+#endif
+
+    auto* blobField = dynamic_cast<Data::Db::TBlobField*>(field);
+    if (!blobField) {
+        return false;
+    }
+    dataset->Edit();
+    if (source.plans().at(column).info.subType == 1) {
+        blobField->AsWideString = System::UnicodeString(value);
+    } else {
+        std::unique_ptr<System::Classes::TMemoryStream> stream(new System::Classes::TMemoryStream());
+        const int n = System::Variants::VarArrayHighBound(value, 1) + 1;
+        if (n > 0) {
+            void* p = System::Variants::VarArrayLock(value);
+            stream->WriteBuffer(p, n);
+            System::Variants::VarArrayUnlock(value);
+            stream->Position = 0;
+        }
+        blobField->LoadFromStream(stream.get());
+    }
+    dataset->Post();
+    return true;
+}
+
+/// Load every pending BLOB of the current record (typically from
+/// AfterScroll). Returns the number of cells loaded.
+inline int fetchLazyBlobs(Data::Db::TDataSet* dataset, LazyBlobSource& source) {
+    if (!dataset || !dataset->Active || dataset->IsEmpty()) {
+        return 0;
+    }
+    int loaded = 0;
+    const auto& plans = source.plans();
+    const int count = std::min<int>(dataset->Fields->Count, static_cast<int>(plans.size()));
+    for (int i = 0; i < count; ++i) {
+        if (plans[i].kind == RadColumnKind::Blob &&
+            fetchLazyBlob(dataset, dataset->Fields->Fields[i], source)) {
+            ++loaded;
+        }
+    }
+    return loaded;
+}
+
+} // namespace fbpp::ext
+
+#endif // FBPP_WITH_RAD_DATASET
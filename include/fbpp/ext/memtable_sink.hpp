@@ -15,12 +15,21 @@
 // touch FieldDefs.
 //
 // rowLimit == 0 means no limit. opts.loadBlobs defaults to false so a
-// mass load does not pull BLOB content for every row.
+// mass load does not pull BLOB content for every row; with a
+// LazyBlobSource (lazy_blob.hpp) BLOB ids are kept and the content is
+// loaded when the row is looked at.
+//
+// MemTableBackgroundLoad is the same load with fetch and Variant decode on
+// a worker thread: decoded chunks queue up and the UI thread appends them
+// with pump() (from a TTimer / OnIdle, or scheduled via onChunkReady),
+// each pump under one MemTableUpdateGuard.
 
 #include "fbpp/core/firebird_compat.hpp"
+#include "fbpp/core/connection.hpp"
 #include "fbpp/core/exception.hpp"
 #include "fbpp/core/result_set.hpp"
 #include "fbpp/core/row.hpp"
+#include "fbpp/ext/lazy_blob.hpp"
 #include "fbpp/ext/rad_variant_decoder.hpp"
 
 #if defined(FBPP_WITH_RAD_DATASET) && defined(FBPP_WITH_EHLIB)
@@ -30,8 +39,16 @@
 #include <MemTableDataEh.hpp>
 #include <System.Variants.hpp>
 
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
 #include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
 #include <vector>
 
 namespace fbpp::ext {
@@ -63,7 +80,8 @@ loadIntoMemTable(Memtableeh::TMemTableEh* mt,
                  fbpp::core::ResultSet& cursor,
                  const std::vector<ColumnDecodePlan>& plans,
                  const VariantDecodeOptions& opts = {},
-                 int rowLimit = 0) {
+                 int rowLimit = 0,
+                 LazyBlobSource* lazyBlobs = nullptr) {
     if (!mt) {
         throw fbpp::core::FirebirdException("loadIntoMemTable: null TMemTableEh");
     }
@@ -94,6 +112,11 @@ loadIntoMemTable(Memtableeh::TMemTableEh* mt,
             std::memcpy(&nullFlag, view.data() + plans[i].nullOffset,
                         sizeof(int16_t));
             if (nullFlag == -1) continue;   // freshly-created cell is NULL
+            if (lazyBlobs && plans[i].kind == RadColumnKind::Blob) {
+                lazyBlobs->remember(reinterpret_cast<std::uintptr_t>(rec), i,
+                                    view.data() + plans[i].offset);
+                continue;
+            }
             System::Variant val = decodeColumnToVariant(
                 plans[i], view.data(), view.transaction(), opts);
             rec->Value[i][Memtabledataeh::dvvValueEh] = val;
@@ -104,6 +127,220 @@ loadIntoMemTable(Memtableeh::TMemTableEh* mt,
     return n;
 }
 
+struct MemTableLoadOptions {
+    int rowLimit = 0;                 // 0 = no limit
+    int chunkRows = 4096;             // Rows decoded per handoff
+    unsigned maxQueuedChunks = 4;     // Worker waits when this many are pending
+    // UI thread, after each appended chunk: rows appended so far
+    std::function<void(int)> onProgress;
+    // Worker thread, when a chunk is ready (e.g. TThread::Queue or
+    // PostMessage to get pump() called); may be empty for polling callers
+    std::function<void()> onChunkReady;
+};
+
+/// loadIntoMemTable() with the fetch and decode on a worker thread.
+///
+/// The worker owns `cursor` (and its transaction) until finished(): the
+/// caller must not touch either meanwhile. cancel() stops the worker and
+/// interrupts a fetch in progress with Connection::cancelOperation(RAISE);
+/// chunks already appended stay in the table. A fetch or decode error is
+/// rethrown by the next pump() / wait(). The destructor cancels and joins.
+///
+/// Cells are decoded to Variants exactly as loadIntoMemTable() does; the
+/// UI thread only creates records and assigns them.
+class MemTableBackgroundLoad {
+public:
+    MemTableBackgroundLoad(Memtableeh::TMemTableEh* mt,
+                           fbpp::core::Connection& connection,
+                           fbpp::core::ResultSet& cursor,
+                           std::vector<ColumnDecodePlan> plans,
+                           VariantDecodeOptions opts = {},
+                           MemTableLoadOptions loadOpts = {})
+        : mt_(mt), connection_(connection), cursor_(cursor),
+          plans_(std::move(plans)), opts_(opts), loadOpts_(std::move(loadOpts)) {
+        if (!mt_) {
+            throw fbpp::core::FirebirdException("MemTableBackgroundLoad: null TMemTableEh");
+        }
+        if (!cursor_.isValid()) {
+            throw fbpp::core::FirebirdException("MemTableBackgroundLoad: cursor closed");
+        }
+        auto* meta = cursor_.getMetadata();
+        if (!meta || meta->getCount() != plans_.size()) {
+            throw fbpp::core::FirebirdException(
+                "MemTableBackgroundLoad: plans / metadata column count mismatch");
+        }
+        if (loadOpts_.chunkRows <= 0) loadOpts_.chunkRows = 1;
+        if (loadOpts_.maxQueuedChunks == 0) loadOpts_.maxQueuedChunks = 1;
+        worker_ = std::thread([this] { run(); });
+    }
+
+    ~MemTableBackgroundLoad() {
+        cancel();
+        if (worker_.joinable()) worker_.join();
+    }
+
+    MemTableBackgroundLoad(const MemTableBackgroundLoad&) = delete;
+    MemTableBackgroundLoad& operator=(const MemTableBackgroundLoad&) = delete;
+
+    /// UI thread: append up to maxChunks ready chunks (0 = all that are
+    /// ready) without blocking. Returns false once everything has been
+    /// appended or the load was cancelled.
+    bool pump(unsigned maxChunks = 0) {
+        std::deque<Chunk> ready;
+        bool done = false;
+        std::exception_ptr failure;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            while (!chunks_.empty() && (maxChunks == 0 || ready.size() < maxChunks)) {
+                ready.push_back(std::move(chunks_.front()));
+                chunks_.pop_front();
+            }
+            done = workerDone_ && chunks_.empty();
+            failure = std::exchange(error_, nullptr);
+        }
+        spaceFree_.notify_one();
+
+        if (!ready.empty() && !cancelled()) {
+            append(ready);
+        }
+        if (failure) std::rethrow_exception(failure);
+        return !(done || cancelled());
+    }
+
+    /// Block until the load ends, appending chunks as they arrive (for
+    /// callers without a message loop). Returns rowsAppended().
+    int wait() {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                chunkReady_.wait(lock, [this] { return !chunks_.empty() || workerDone_; });
+            }
+            if (!pump()) break;
+        }
+        return rowsAppended();
+    }
+
+    void cancel() {
+        if (cancelled_.exchange(true)) return;
+        bool fetching = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            fetching = !workerDone_;
+            chunks_.clear();
+        }
+        spaceFree_.notify_one();
+        if (fetching) {
+            // Interrupts a blocked fetch; the worker reports it as cancelled
+            try { connection_.cancelOperation(fbpp::core::CancelOperation::RAISE); } catch (...) {}
+        }
+    }
+
+    bool cancelled() const noexcept { return cancelled_.load(); }
+
+    bool finished() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return workerDone_ && chunks_.empty();
+    }
+
+    int rowsAppended() const noexcept { return appended_; }
+
+private:
+    // Row-major decoded cells; an unassigned Variant is a NULL cell
+    struct Chunk {
+        std::vector<System::Variant> cells;
+        int rows = 0;
+    };
+
+    void run() {
+        const int nFields = static_cast<int>(plans_.size());
+        try {
+            Chunk chunk;
+            int fetched = 0;
+            for (const auto& view : cursor_.rows()) {
+                if (cancelled()) break;
+                if (loadOpts_.rowLimit > 0 && fetched >= loadOpts_.rowLimit) break;
+                if (chunk.cells.empty()) {
+                    chunk.cells.reserve(static_cast<size_t>(loadOpts_.chunkRows) * nFields);
+                }
+                for (int i = 0; i < nFields; ++i) {
+                    chunk.cells.push_back(decodeColumnToVariant(
+                        plans_[i], view.data(), view.transaction(), opts_));
+                }
+                ++chunk.rows;
+                ++fetched;
+                if (chunk.rows == loadOpts_.chunkRows && !hand(std::move(chunk))) break;
+            }
+            if (chunk.rows > 0) hand(std::move(chunk));
+        } catch (...) {
+            if (!cancelled()) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                error_ = std::current_exception();
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            workerDone_ = true;
+        }
+        chunkReady_.notify_all();
+        if (loadOpts_.onChunkReady) loadOpts_.onChunkReady();
+    }
+
+    // Queue a chunk, waiting for room; false when cancelled meanwhile
+    bool hand(Chunk&& chunk) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            spaceFree_.wait(lock, [this] {
+                return cancelled() || chunks_.size() < loadOpts_.maxQueuedChunks;
+            });
+            if (cancelled()) return false;
+            chunks_.push_back(std::move(chunk));
+        }
+        chunk = Chunk{};
+        chunkReady_.notify_all();
+        if (loadOpts_.onChunkReady) loadOpts_.onChunkReady();
+        return true;
+    }
+
+    void append(std::deque<Chunk>& ready) {
+        auto* recList = mt_->RecordsView->MemTableData->RecordsList;
+        const int nFields = static_cast<int>(plans_.size());
+        {
+            detail::MemTableUpdateGuard guard(recList);
+            for (auto& chunk : ready) {
+                const System::Variant* cell = chunk.cells.data();
+                for (int r = 0; r < chunk.rows; ++r) {
+                    Memtabledataeh::TMemoryRecordEh* rec = recList->NewRecord();
+                    for (int i = 0; i < nFields; ++i, ++cell) {
+                        if (!System::Variants::VarIsEmpty(*cell)) {
+                            rec->Value[i][Memtabledataeh::dvvValueEh] = *cell;
+                        }
+                    }
+                    recList->FetchRecord(rec);
+                }
+                appended_ += chunk.rows;
+            }
+        }
+        if (loadOpts_.onProgress) loadOpts_.onProgress(appended_);
+    }
+
+    Memtableeh::TMemTableEh* mt_;
+    fbpp::core::Connection& connection_;
+    fbpp::core::ResultSet& cursor_;
+    const std::vector<ColumnDecodePlan> plans_;
+    const VariantDecodeOptions opts_;
+    MemTableLoadOptions loadOpts_;
+
+    mutable std::mutex mutex_;              // chunks_, workerDone_, error_
+    std::condition_variable chunkReady_;
+    std::condition_variable spaceFree_;
+    std::deque<Chunk> chunks_;
+    bool workerDone_ = false;
+    std::exception_ptr error_;
+    std::atomic<bool> cancelled_{false};
+    int appended_ = 0;                      // UI thread only
+    std::thread worker_;                    // Last: started once the rest is set up
+};
+
 // NOTE on attempted typed fast path (2026-05-15, reverted):
 //
 // We attempted a `loadIntoMemTableTyped` variant that bypassed the
@@ -0,0 +1,151 @@
+#pragma once
+
+// MemTableWindow: a TMemTableEh showing a window of a RowStore.
+//
+// TMemTableEh keeps every cell as a Variant, and its own Filter /
+// IndexFieldNames re-sort and re-filter those Variant records
+// (RefreshFilteredRecsList, see memtable_sink.hpp). Over a million loaded
+// rows that is seconds per key stroke. MemTableWindow keeps the rows in a
+// compact RowStore instead, filters and sorts them with a RowStoreView
+// (indexed equality filters, text filters, multi-key order on the encoded
+// bytes) and puts only the visible window into the memtable:
+//
+//   MemTableWindow grid(MemTable1, RowStore::fromResultSet(*cursor), 200);
+//   grid.view().addIndex(grid.store().column("REGION"));
+//
+//   void __fastcall TForm1::EditFilterChange(TObject*) {
+//       grid.view().clearFilters();
+//       grid.view().whereText(grid.store().column("NAME"), AnsiString(EditFilter->Text).c_str());
+//       grid.refresh();                          // Back to the first window
+//   }
+//   void __fastcall TForm1::MemTable1AfterScroll(TDataSet* ds) { grid.scrollIfNear(ds->RecNo); }
+//
+// The memtable's FieldDefs are set up from the store's metadata by the
+// constructor. show() replaces the memtable's records (through the
+// RecordsList fast path, as loadIntoMemTable) with view positions
+// [first, first + windowRows); filters and ordering belong to view(), not
+// to the memtable, whose own Filtered / IndexFieldNames should stay off.
+// BLOB columns are decoded as VariantDecodeOptions says, with the store's
+// transaction.
+
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/row_store.hpp"
+#include "fbpp/core/row_store_view.hpp"
+#include "fbpp/ext/dataset_adapter.hpp"
+#include "fbpp/ext/memtable_sink.hpp"
+#include "fbpp/ext/rad_variant_decoder.hpp"
+
+#if defined(FBPP_WITH_RAD_DATASET) && defined(FBPP_WITH_EHLIB)
+
+#include <MemTableEh.hpp>
+#include <MemTableDataEh.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace fbpp::ext {
+
+class MemTableWindow {
+public:
+    /// Take `store` over and show its first window in `mt`
+    MemTableWindow(Memtableeh::TMemTableEh* mt,
+                   fbpp::core::RowStore store,
+                   int windowRows = 500,
+                   VariantDecodeOptions opts = {})
+        : mt_(mt), store_(std::move(store)), view_(store_),
+          windowRows_(std::max(1, windowRows)), opts_(opts) {
+        if (!mt_) {
+            throw fbpp::core::FirebirdException("MemTableWindow: null TMemTableEh");
+        }
+        detail::ensureDatasetReady(mt_, store_.metadata(), true);
+        plans_ = cachedColumnPlans(store_.metadata());
+        show(0);
+    }
+
+    MemTableWindow(const MemTableWindow&) = delete;
+    MemTableWindow& operator=(const MemTableWindow&) = delete;
+
+    /// Filters and ordering; call refresh() / show() after changing them
+    fbpp::core::RowStoreView& view() noexcept { return view_; }
+    const fbpp::core::RowStore& store() const noexcept { return store_; }
+
+    /// Replace the memtable's rows with the window at view position
+    /// `first` (clamped to the last full window). Returns the rows shown.
+    int show(std::size_t first) {
+        const std::size_t rows = static_cast<std::size_t>(windowRows_);
+        const std::size_t total = view_.size();
+        first_ = total > rows ? std::min(first, total - rows) : 0;
+
+        ControlGuard controls(mt_);
+        mt_->EmptyTable();
+        auto* recList = mt_->RecordsView->MemTableData->RecordsList;
+        const int nFields = static_cast<int>(plans_->size());
+        int shown = 0;
+        {
+            detail::MemTableUpdateGuard guard(recList);
+            for (std::size_t row : view_.window(first_, rows)) {
+                const fbpp::core::RowView source = store_.view(row);
+                Memtabledataeh::TMemoryRecordEh* rec = recList->NewRecord();
+                for (int i = 0; i < nFields; ++i) {
+                    System::Variant value = decodeColumnToVariant(
+                        (*plans_)[i], source.data(), store_.transaction(), opts_);
+                    if (!System::Variants::VarIsEmpty(value)) {
+                        rec->Value[i][Memtabledataeh::dvvValueEh] = value;
+                    }
+                }
+                recList->FetchRecord(rec);
+                ++shown;
+            }
+        }
+        mt_->First();
+        return shown;
+    }
+
+    /// The first window again, after the view's filters or order changed
+    int refresh() { return show(0); }
+
+    /// Move the window by half its size when `recNo` (1-based, as
+    /// TDataSet::RecNo) is at either end of it; keeps the same record
+    /// current. Returns true when the window moved.
+    bool scrollIfNear(int recNo) {
+        const int step = std::max(1, windowRows_ / 2);
+        const std::size_t before = first_;
+        if (recNo >= windowRows_ && first_ + windowRows_ < view_.size()) {
+            show(first_ + step);
+        } else if (recNo <= 1 && first_ > 0) {
+            show(first_ > static_cast<std::size_t>(step) ? first_ - step : 0);
+        } else {
+            return false;
+        }
+        const std::size_t position = before + static_cast<std::size_t>(recNo - 1);
+        mt_->RecNo = static_cast<int>(position - first_) + 1;
+        return true;
+    }
+
+    /// View position of the memtable's first record
+    std::size_t first() const noexcept { return first_; }
+
+    /// Rows in the view (all windows)
+    std::size_t total() const noexcept { return view_.size(); }
+
+    /// Store row behind memtable record `recNo` (1-based)
+    std::size_t storeRow(int recNo) const {
+        return view_.row(first_ + static_cast<std::size_t>(recNo - 1));
+    }
+
+private:
+    Memtableeh::TMemTableEh* mt_;
+    fbpp::core::RowStore store_;
+    fbpp::core::RowStoreView view_;       // Refers to store_: the window does not move
+    int windowRows_;
+    VariantDecodeOptions opts_;
+    std::shared_ptr<const std::vector<ColumnDecodePlan>> plans_;
+    std::size_t first_ = 0;
+};
+
+} // namespace fbpp::ext
+
+#endif // FBPP_WITH_RAD_DATASET && FBPP_WITH_EHLIB
@@ -0,0 +1,130 @@
+#pragma once
+
+// OpenTelemetry export: fbpp spans and client metrics through the
+// process's global OpenTelemetry providers.
+//
+// OtelSpanObserver is a core::SpanObserver (see span_observer.hpp). Each
+// fbpp span becomes a CLIENT span, a child of whatever span is active on
+// the calling thread, so database time shows up under the service request
+// that caused it:
+//
+//   name        connect / prepare / execute / fetch / commit / rollback
+//   attributes  db.system = "firebird", db.operation.name,
+//               db.namespace (connect), fbpp.query.fingerprint (16 hex
+//               digits, stable across case / whitespace / comments),
+//               db.query.text (only with recordSqlText: literals in the
+//               SQL would be exported), db.response.returned_rows (fetch),
+//               fbpp.rows_affected (execute)
+//   status      ERROR with the exception text when the call failed
+//
+// The same measurements are recorded into two histograms, grouped by
+// operation and fingerprint, i.e. per statement:
+//   db.client.operation.duration       (s)
+//   db.client.response.returned_rows   (fetch loops only)
+//
+//   auto otel = fbpp::ext::installOpenTelemetry();   // after the SDK setup
+//   ...                                              // use fbpp as usual
+//   otel.reset();                                    // uninstalls
+//
+// Nothing is recorded while no observer is installed; fbpp then pays one
+// atomic load per instrumented call.
+//
+// OtelPoolMetrics publishes a ConnectionPool's stats() as asynchronous
+// instruments, read at each collection, with db.client.connection.pool.name
+// on every point:
+//
+//   db.client.connection.count            state = idle / used
+//   db.client.connection.max              the concurrency limit now
+//   db.client.connection.pending_requests fbpp.pool.priority = lane
+//   db.client.connection.timeouts         checkouts that gave up
+//   fbpp.pool.connection.creating         attachments being opened
+//   fbpp.pool.connection.created / validation_failures / reaped
+//   fbpp.pool.utilization                 leased / limit now (ratio)
+//   fbpp.pool.statement_cache.hits / misses, summed over the connections
+//   db.client.connection.wait_time        quantile = p50 / p90 / p99 / max (s)
+//   db.client.connection.use_time         likewise, lease durations (s)
+//   fbpp.pool.utilization.checkout        likewise, percent at checkout
+//
+// The pool keeps its own histograms, so wait and use times go out as
+// quantile gauges over the pool's lifetime rather than as OTel histograms.
+//
+//   fbpp::ext::OtelPoolMetrics poolMetrics(pool, "orders");   // pool outlives it
+//
+// Available only when fbpp is configured with -DFBPP_WITH_OTEL=ON; link
+// against fbpp::fbpp_otel.
+
+#include "fbpp/core/span_observer.hpp"
+
+#ifdef FBPP_WITH_OTEL
+
+#include <memory>
+#include <string>
+
+namespace fbpp::pool {
+class ConnectionPool;
+}
+
+namespace fbpp::ext {
+
+struct OtelOptions {
+    std::string instrumentationName = "fbpp";   // Tracer / meter name
+    bool spans = true;                          // Emit spans
+    bool metrics = true;                        // Record the histograms
+    bool recordSqlText = false;                 // db.query.text on spans
+};
+
+class OtelSpanObserver final : public fbpp::core::SpanObserver {
+public:
+    /// Takes the tracer and meter from the global providers now: set up
+    /// the SDK first.
+    explicit OtelSpanObserver(OtelOptions options = {});
+
+    /// Uninstalls itself if it is still the installed observer
+    ~OtelSpanObserver() override;
+
+    OtelSpanObserver(const OtelSpanObserver&) = delete;
+    OtelSpanObserver& operator=(const OtelSpanObserver&) = delete;
+
+    void* startSpan(const fbpp::core::SpanStart& start) override;
+    void endSpan(void* span, const fbpp::core::SpanEnd& end) noexcept override;
+
+    const OtelOptions& options() const noexcept { return options_; }
+
+private:
+    struct Impl;
+    OtelOptions options_;
+    std::unique_ptr<Impl> impl_;
+};
+
+/// Create an observer and install it with core::setSpanObserver(). Keep
+/// the result alive until the last fbpp span has ended.
+std::unique_ptr<OtelSpanObserver> installOpenTelemetry(OtelOptions options = {});
+
+/**
+ * @brief ConnectionPool metrics as OpenTelemetry asynchronous instruments
+ *
+ * Registers its callbacks with the global meter provider on construction
+ * and removes them on destruction; each collection takes one stats()
+ * snapshot per instrument. The pool must outlive this object.
+ */
+class OtelPoolMetrics {
+public:
+    OtelPoolMetrics(const fbpp::pool::ConnectionPool& pool, std::string poolName,
+                    OtelOptions options = {});
+    ~OtelPoolMetrics();
+
+    OtelPoolMetrics(const OtelPoolMetrics&) = delete;
+    OtelPoolMetrics& operator=(const OtelPoolMetrics&) = delete;
+
+    const std::string& poolName() const noexcept { return poolName_; }
+
+private:
+    struct Impl;
+    const fbpp::pool::ConnectionPool& pool_;
+    std::string poolName_;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace fbpp::ext
+
+#endif // FBPP_WITH_OTEL
@@ -0,0 +1,258 @@
+#pragma once
+
+// Paged dataset loads: the first page is shown immediately, further pages
+// are appended on demand (typically from AfterScroll) instead of loading
+// everything up front or stopping at a row limit.
+//
+// PagedDatasetLoader keeps the cursor open between pages (and with it the
+// transaction and its snapshot). KeysetDatasetLoader<Key> holds nothing
+// between pages: each page re-runs a query ordered by a declared key with
+// the last key seen bound as its parameter, through the connection's
+// shared read transaction — for long-lived views where an open cursor per
+// screen is too much.
+//
+//   PagedDatasetLoader pager(mem, tx->openCursor(stmt), {.pageRows = 200});
+//   void __fastcall TForm1::MemAfterScroll(TDataSet* ds) { pager.fetchIfNear(ds->RecNo); }
+//
+//   KeysetDatasetLoader<int64_t> view(mem, conn,
+//       "SELECT id, title FROM doc ORDER BY id",
+//       "SELECT id, title FROM doc WHERE id > ? ORDER BY id", 0);
+//
+// DatasetPageOptions::maxRows keeps the dataset memory-bounded: once that
+// many rows are loaded no more pages are fetched.
+
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/row.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+#include <fbpp/ext/dataset_loader.hpp>
+
+#ifdef FBPP_WITH_RAD_DATASET
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <utility>
+
+namespace fbpp::ext {
+
+struct DatasetPageOptions {
+    int pageRows = 500;      // Rows appended per page
+    int maxRows = 0;         // Stop paging at this many rows (0 = no limit)
+    int prefetchMargin = 0;  // fetchIfNear() margin (0 = pageRows / 4)
+};
+
+namespace detail {
+
+// Append up to `limit` rows of cursor through loader; `onRow` sees each
+// appended RowView (the keyset loader takes its key from it).
+template<typename OnRow>
+int appendPage(DatasetLoader& loader, fbpp::core::ResultSet& cursor, int limit, OnRow&& onRow) {
+    const auto* meta = cursor.getMetadata();
+    if (!meta) {
+        throw fbpp::core::FirebirdException("Paged dataset load: cursor has no output columns");
+    }
+    ControlGuard guard(loader.dataset());
+    int appended = 0;
+    for (const auto& view : cursor.rows()) {
+        loader.loadRow(view.data(), *meta, view.transaction());
+        onRow(view);
+        if (++appended >= limit) {
+            break;
+        }
+    }
+    return appended;
+}
+
+inline int pageLimit(const DatasetPageOptions& options, int loaded) {
+    int limit = options.pageRows > 0 ? options.pageRows : 1;
+    if (options.maxRows > 0) {
+        limit = std::min(limit, options.maxRows - loaded);
+    }
+    return limit;
+}
+
+inline bool nearEnd(const DatasetPageOptions& options, int recNo, int loaded) {
+    const int margin = options.prefetchMargin > 0 ? options.prefetchMargin
+                                                  : std::max(1, options.pageRows / 4);
+    return recNo + margin >= loaded;
+}
+
+} // namespace detail
+
+/// Pages over one open cursor. The first page is loaded by the constructor.
+class PagedDatasetLoader {
+public:
+    PagedDatasetLoader(Data::Db::TDataSet* dataset,
+                       std::unique_ptr<fbpp::core::ResultSet> cursor,
+                       DatasetPageOptions options = {})
+        : cursor_(std::move(cursor)),
+          options_(options),
+          loader_(dataset, checkedMetadata(cursor_)) {
+        cursor_->setPrefetch(static_cast<unsigned>(std::max(1, options_.pageRows)));
+        fetchPage();
+    }
+
+    /// Append the next page; returns the rows appended (0 once exhausted).
+    /// The cursor is closed as soon as it runs out or maxRows is reached.
+    int fetchPage() {
+        if (exhausted()) {
+            return 0;
+        }
+        const int limit = detail::pageLimit(options_, loaded_);
+        const int appended = detail::appendPage(loader_, *cursor_, limit,
+                                                [](const fbpp::core::RowView&) {});
+        loaded_ += appended;
+        if (appended < limit || cursor_->isEof() ||
+            (options_.maxRows > 0 && loaded_ >= options_.maxRows)) {
+            close();
+        }
+        return appended;
+    }
+
+    /// fetchPage() when recNo (1-based, as TDataSet::RecNo) is within the
+    /// prefetch margin of the last loaded row.
+    int fetchIfNear(int recNo) {
+        if (exhausted() || !detail::nearEnd(options_, recNo, loaded_)) {
+            return 0;
+        }
+        return fetchPage();
+    }
+
+    /// Load the remaining rows (up to maxRows).
+    int fetchAll() {
+        int total = 0;
+        while (int appended = fetchPage()) {
+            total += appended;
+        }
+        return total;
+    }
+
+    /// Release the cursor (and the transaction it holds); no more pages.
+    void close() {
+        if (cursor_) {
+            cursor_->close();
+            cursor_.reset();
+        }
+    }
+
+    bool exhausted() const noexcept { return !cursor_; }
+    int rowsLoaded() const noexcept { return loaded_; }
+    DatasetLoader& loader() noexcept { return loader_; }
+
+private:
+    static const fbpp::core::MessageMetadata&
+    checkedMetadata(const std::unique_ptr<fbpp::core::ResultSet>& cursor) {
+        if (!cursor || !cursor->isValid() || !cursor->getMetadata()) {
+            throw fbpp::core::FirebirdException("PagedDatasetLoader: cursor is not open");
+        }
+        return *cursor->getMetadata();
+    }
+
+    std::unique_ptr<fbpp::core::ResultSet> cursor_;
+    DatasetPageOptions options_;
+    int loaded_ = 0;
+    DatasetLoader loader_;
+};
+
+/// Keyset pagination over a declared key column. `firstSql` selects the
+/// first rows in key order; `nextSql` is the same query with one parameter,
+/// the last key loaded (e.g. "... WHERE id > ? ORDER BY id"). Key is the
+/// C++ type of output column `keyColumn` and must be unique and NOT NULL.
+template<typename Key>
+class KeysetDatasetLoader {
+public:
+    KeysetDatasetLoader(Data::Db::TDataSet* dataset,
+                        fbpp::core::Connection& connection,
+                        const std::string& firstSql,
+                        const std::string& nextSql,
+                        unsigned keyColumn,
+                        DatasetPageOptions options = {})
+        : connection_(connection),
+          first_(connection.prepareStatement(firstSql)),
+          next_(connection.prepareStatement(nextSql)),
+          keyColumn_(keyColumn),
+          options_(options),
+          loader_(dataset, checkedMetadata(*first_, keyColumn)) {
+        if (next_->getInputMetadata() == nullptr || next_->getInputMetadata()->getCount() != 1) {
+            throw fbpp::core::FirebirdException(
+                "KeysetDatasetLoader: next-page query must take exactly one key parameter");
+        }
+        fetchPage();
+    }
+
+    /// Append the next page (one short query); returns the rows appended.
+    int fetchPage() {
+        if (exhausted_) {
+            return 0;
+        }
+        const int limit = detail::pageLimit(options_, loaded_);
+        auto txn = connection_.readTransaction();
+        auto cursor = lastKey_ ? txn->openCursor(next_, std::make_tuple(*lastKey_))
+                               : txn->openCursor(first_);
+        cursor->setPrefetch(static_cast<unsigned>(std::max(1, limit)));
+        const int appended = detail::appendPage(
+            loader_, *cursor, limit, [this](const fbpp::core::RowView& view) {
+                auto key = view.get<Key>(keyColumn_);
+                if (!key) {
+                    throw fbpp::core::FirebirdException("KeysetDatasetLoader: NULL key");
+                }
+                lastKey_ = std::move(*key);
+            });
+        cursor->close();
+        loaded_ += appended;
+        if (appended < limit || (options_.maxRows > 0 && loaded_ >= options_.maxRows)) {
+            exhausted_ = true;
+        }
+        return appended;
+    }
+
+    int fetchIfNear(int recNo) {
+        if (exhausted_ || !detail::nearEnd(options_, recNo, loaded_)) {
+            return 0;
+        }
+        return fetchPage();
+    }
+
+    /// Start over from the first page into the cleared dataset.
+    void reload() {
+        loader_.resetStructure(*first_->getOutputMetadata(), true);
+        lastKey_.reset();
+        loaded_ = 0;
+        exhausted_ = false;
+        fetchPage();
+    }
+
+    bool exhausted() const noexcept { return exhausted_; }
+    int rowsLoaded() const noexcept { return loaded_; }
+    const std::optional<Key>& lastKey() const noexcept { return lastKey_; }
+    DatasetLoader& loader() noexcept { return loader_; }
+
+private:
+    static const fbpp::core::MessageMetadata&
+    checkedMetadata(const fbpp::core::Statement& statement, unsigned keyColumn) {
+        const auto meta = statement.getOutputMetadata();
+        if (!meta || keyColumn >= meta->getCount()) {
+            throw fbpp::core::FirebirdException("KeysetDatasetLoader: key column out of range");
+        }
+        return *meta;
+    }
+
+    fbpp::core::Connection& connection_;
+    std::shared_ptr<fbpp::core::Statement> first_;
+    std::shared_ptr<fbpp::core::Statement> next_;
+    unsigned keyColumn_;
+    DatasetPageOptions options_;
+    std::optional<Key> lastKey_;
+    int loaded_ = 0;
+    bool exhausted_ = false;
+    DatasetLoader loader_;
+};
+
+} // namespace fbpp::ext
+
+#endif // FBPP_WITH_RAD_DATASET
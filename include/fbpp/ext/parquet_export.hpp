@@ -0,0 +1,60 @@
+#pragma once
+
+// Apache Parquet export: write a ResultSet to a Parquet file.
+//
+// Rows are fetched with ResultSet::fetchColumns, turned into RecordBatches
+// with the Arrow mapping of arrow_export.hpp and appended to the buffered
+// row group of a parquet::arrow::FileWriter. A row group is closed every
+// rowGroupRows rows, so memory stays bounded by one decoded ColumnBatch
+// plus one encoded row group, whatever the size of the result set.
+//
+// The Arrow schema is stored in the file metadata, so readers get the same
+// logical types back (timestamp time zones, decimal precision).
+//
+// Available only when fbpp is configured with -DFBPP_WITH_PARQUET=ON
+// (which requires FBPP_WITH_ARROW); link against fbpp::fbpp_parquet.
+
+#include "fbpp/ext/arrow_export.hpp"
+
+#ifdef FBPP_WITH_PARQUET
+
+#include <arrow/io/interfaces.h>
+#include <arrow/util/compression.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace fbpp::ext {
+
+/// Row-group layout and codec of a Parquet export.
+struct ParquetExportOptions {
+    std::size_t rowGroupRows = 1024 * 1024;   // Rows per row group
+    std::size_t batchSize = 65536;            // Rows per fetchColumns() call
+    arrow::Compression::type compression = arrow::Compression::ZSTD;
+    int compressionLevel = arrow::util::kUseDefaultCompressionLevel;
+    bool dictionary = true;                   // Dictionary-encode columns
+};
+
+/// Outcome of a Parquet export.
+struct ParquetExportResult {
+    std::size_t rows = 0;
+    std::size_t rowGroups = 0;
+};
+
+/// Write the remaining rows of an open cursor to `sink` as one Parquet
+/// file; on return the footer has been written. Throws FirebirdException
+/// for invalid options, columns without an Arrow mapping and Arrow/Parquet
+/// errors; fetch errors propagate as is.
+ParquetExportResult writeParquet(fbpp::core::ResultSet& resultSet,
+                                 const std::shared_ptr<arrow::io::OutputStream>& sink,
+                                 const ParquetExportOptions& options = {});
+
+/// Same, into a file at `path` (created or truncated).
+ParquetExportResult writeParquet(fbpp::core::ResultSet& resultSet,
+                                 const std::string& path,
+                                 const ParquetExportOptions& options = {});
+
+} // namespace fbpp::ext
+
+#endif // FBPP_WITH_PARQUET
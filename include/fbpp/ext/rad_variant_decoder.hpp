@@ -17,7 +17,10 @@
 #include "fbpp/core/firebird_compat.hpp"
 #include "fbpp/core/message_metadata.hpp"
 #include "fbpp/core/extended_types.hpp"
+#include "fbpp/core/scaled_numeric.hpp"
 #include "fbpp/core/timestamp_utils.hpp"
+#include "fbpp/core/detail/text_scan.hpp"
+#include "fbpp/core/text_codec.hpp"
 #include "fbpp_util/tdatetime.hpp"
 
 #ifdef FBPP_WITH_RAD_DATASET
@@ -36,8 +39,13 @@
 #include <cmath>
 #include <cstdint>
 #include <cstring>
+#include <iterator>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace fbpp::ext {
@@ -74,11 +82,32 @@ enum class RadColumnKind {
     Unsupported
 };
 
+// Numeric part of FieldInfo — what a decode reads. Member names match
+// FieldInfo, and a FieldInfo converts implicitly, so decodeFieldToVariant()
+// takes either without the four std::string copies.
+struct ColumnFieldInfo {
+    unsigned type = 0;
+    bool nullable = false;
+    unsigned subType = 0;
+    unsigned length = 0;
+    int scale = 0;
+    unsigned charSet = 0;
+    unsigned offset = 0;
+    unsigned nullOffset = 0;
+
+    ColumnFieldInfo() = default;
+    ColumnFieldInfo(const fbpp::core::FieldInfo& f) noexcept
+        : type(f.type), nullable(f.nullable), subType(f.subType), length(f.length),
+          scale(f.scale), charSet(f.charSet), offset(f.offset), nullOffset(f.nullOffset) {}
+};
+
 // План декодирования одного столбца. Строится через makeColumnPlan() из FieldInfo
 // + offsets из MessageMetadata. Хранится cached в FbppAdapter::DsqlEntry::outputPlans
-// и используется и для memtable, и для DsqlGetValue.
+// и используется и для memtable, и для DsqlGetValue. Без std::string: имя
+// столбца — ref-counted UnicodeString, копия плана не аллоцирует.
 struct ColumnDecodePlan {
-    fbpp::core::FieldInfo info{};
+    ColumnFieldInfo info{};
+    System::UnicodeString displayName;   // displayName(FieldInfo), для FieldDefs
     unsigned offset = 0;
     unsigned nullOffset = 0;
     Data::Db::TFieldType fieldType = Data::Db::ftUnknown;
@@ -90,12 +119,37 @@ struct ColumnDecodePlan {
 namespace detail {
 
 inline std::string TrimTrailingSpaces(std::string s) {
-    while (!s.empty() && s.back() == ' ') s.pop_back();
+    s.resize(fbpp::core::detail::trimmedLength(s.data(), s.size()));
     return s;
 }
 
-inline System::UnicodeString Utf8ToWide(const std::string& s) {
-    return System::UnicodeString(System::UTF8String(s.c_str()));
+// Decodes straight into the UnicodeString buffer (no UTF8String temporary).
+// Malformed bytes become U+FFFD, as the UTF8String conversion did.
+inline System::UnicodeString Utf8ToWide(std::string_view s) {
+    static_assert(sizeof(System::WideChar) == sizeof(char16_t), "UnicodeString is UTF-16");
+    using fbpp::core::Utf8Errors;
+    System::UnicodeString result;
+    const size_t units = fbpp::core::utf16Length(s, Utf8Errors::Replace);
+    if (units != 0) {
+        result.SetLength(static_cast<int>(units));
+        fbpp::core::utf8ToUtf16(s, reinterpret_cast<char16_t*>(result.c_str()), Utf8Errors::Replace);
+    }
+    return result;
+}
+
+// Column text in its declared charset: single-byte code pages (legacy
+// tables read over a NONE attachment) go through their table, the rest is UTF-8.
+inline System::UnicodeString TextToWide(std::string_view bytes, unsigned charSet) {
+    const auto singleByte = fbpp::core::singleByteCharsetForId(charSet);
+    if (!singleByte) {
+        return Utf8ToWide(bytes);
+    }
+    System::UnicodeString result;
+    if (!bytes.empty()) {
+        result.SetLength(static_cast<int>(bytes.size()));
+        fbpp::core::singleByteToUtf16(bytes, *singleByte, reinterpret_cast<char16_t*>(result.c_str()));
+    }
+    return result;
 }
 
 // Same algorithm as AssignField: lossy but consistent для INT128 → double.
@@ -123,19 +177,17 @@ makeScaledNumericVariant(int64_t raw, int scale, const VariantDecodeOptions& opt
     using System::Variant;
     if (scale == 0) return Variant((__int64)raw);
     if (opts.exactCurrency && scale >= -4 && scale < 0) {
-        int64_t mult = 1;
-        for (int i = 0; i < (4 + scale); ++i) mult *= 10;
-        int64_t curRaw = raw * mult;
+        int64_t curRaw = raw * fbpp::core::pow10Int64(4 + scale);
         // CurrencyBase::Val — public __int64 (см. syscurr.h). Не UB.
         Currency c;
         c.Val = curRaw;
         return Variant(c);
     }
-    return Variant((double)raw / std::pow(10.0, -scale));
+    return Variant(fbpp::core::scaledToDouble(raw, scale));
 }
 
 inline System::Variant
-decodeFieldToVariant(const fbpp::core::FieldInfo& info,
+decodeFieldToVariant(const ColumnFieldInfo& info,
                      const uint8_t* dataPtr,
                      fbpp::core::Transaction* txn = nullptr,
                      const VariantDecodeOptions& opts = {})
@@ -152,16 +204,11 @@ decodeFieldToVariant(const fbpp::core::FieldInfo& info,
     };
 
     switch (info.type) {
-        case SQL_TEXT: {
-            std::string text((const char*)dataPtr, info.length);
-            return Variant(detail::Utf8ToWide(detail::TrimTrailingSpaces(std::move(text))));
-        }
-        case SQL_VARYING: {
-            uint16_t len = 0;
-            std::memcpy(&len, dataPtr, sizeof(uint16_t));
-            std::string text((const char*)(dataPtr + 2), len);
-            return Variant(detail::Utf8ToWide(text));
-        }
+        case SQL_TEXT:
+        case SQL_VARYING:
+            // Decoded in place from the fetch buffer; CHAR padding trimmed.
+            return Variant(detail::TextToWide(
+                fbpp::core::detail::textView(info.type, info.length, dataPtr), info.charSet));
         case SQL_BOOLEAN: {
             uint8_t b = 0; std::memcpy(&b, dataPtr, 1);
             return Variant((bool)(b != 0));
@@ -248,8 +295,10 @@ decodeFieldToVariant(const fbpp::core::FieldInfo& info,
                 auto blobData = txn->loadBlob(&blobRef);
                 if (info.subType == 1) {
                     // Text BLOB → UnicodeString
-                    std::string text(blobData.begin(), blobData.end());
-                    return Variant(detail::Utf8ToWide(text));
+                    return Variant(detail::TextToWide(
+                        std::string_view(reinterpret_cast<const char*>(blobData.data()),
+                                         blobData.size()),
+                        info.charSet));
                 }
                 // Binary BLOB → varArray of varByte.
                 int n = (int)blobData.size();
@@ -280,6 +329,7 @@ inline ColumnDecodePlan makeColumnPlan(const fbpp::core::FieldInfo& info) {
 
     ColumnDecodePlan p;
     p.info = info;
+    p.displayName = detail::Utf8ToWide(fbpp::core::displayName(info));
     p.offset = info.offset;
     p.nullOffset = info.nullOffset;
     p.fieldType = TFieldType::ftUnknown;
@@ -400,6 +450,46 @@ buildColumnPlans(const fbpp::core::MessageMetadata& md) {
     return plans;
 }
 
+// Plans per metadata layout, shared by every load of the same statement
+// (a cached Statement keeps its MessageMetadata, and equal formats share
+// one MetadataLayout). Entries die with their layout.
+inline std::shared_ptr<const std::vector<ColumnDecodePlan>>
+cachedColumnPlans(const fbpp::core::MessageMetadata& md) {
+    struct Entry {
+        std::weak_ptr<const fbpp::core::MetadataLayout> layout;
+        std::shared_ptr<const std::vector<ColumnDecodePlan>> plans;
+    };
+    static std::mutex mutex;
+    static std::unordered_map<const fbpp::core::MetadataLayout*, Entry> cache;
+
+    auto layout = md.getLayout();
+    if (!layout) {
+        return std::make_shared<const std::vector<ColumnDecodePlan>>(buildColumnPlans(md));
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = cache.find(layout.get());
+        if (it != cache.end() && it->second.layout.lock() == layout) {
+            return it->second.plans;
+        }
+    }
+    auto plans = std::make_shared<const std::vector<ColumnDecodePlan>>(buildColumnPlans(md));
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = cache.begin(); it != cache.end();) {
+        it = it->second.layout.expired() ? cache.erase(it) : std::next(it);
+    }
+    cache[layout.get()] = Entry{layout, plans};
+    return plans;
+}
+
+inline int fieldDefSize(const ColumnDecodePlan& p) {
+    if (p.fieldType == Data::Db::ftWideString ||
+        p.fieldType == Data::Db::ftString) {
+        return p.info.length > 0 ? (int)p.info.length : 1;
+    }
+    return 0;
+}
+
 inline void configureFieldDefs(Data::Db::TFieldDefs* defs,
                                const std::vector<ColumnDecodePlan>& plans)
 {
@@ -407,19 +497,29 @@ inline void configureFieldDefs(Data::Db::TFieldDefs* defs,
     defs->Clear();
     defs->Capacity = (int)plans.size();
     for (const auto& p : plans) {
-        int size = 0;
-        if (p.fieldType == Data::Db::ftWideString ||
-            p.fieldType == Data::Db::ftString) {
-            size = (int)p.info.length;
-            if (size <= 0) size = 1;
-        }
         // User-facing identifier via shared identity helper (alias-then-name).
         // Для literal columns ('0 as flag, 0 as new_item_id') Firebird возвращает
         // name="CONSTANT" для обоих — displayName берёт alias и избегает
         // "Duplicate name" в TFieldDefs.
-        defs->Add(detail::Utf8ToWide(fbpp::core::displayName(p.info)),
-                  p.fieldType, size, !p.info.nullable);
+        defs->Add(p.displayName, p.fieldType, fieldDefSize(p), !p.info.nullable);
+    }
+}
+
+// True when defs already describe `plans` (a refresh of the same query):
+// the dataset structure can be kept and only its rows replaced.
+inline bool fieldDefsMatch(Data::Db::TFieldDefs* defs,
+                           const std::vector<ColumnDecodePlan>& plans)
+{
+    if (!defs || defs->Count != (int)plans.size()) return false;
+    for (int i = 0; i < defs->Count; ++i) {
+        const auto* def = defs->Items[i];
+        const auto& p = plans[i];
+        if (def->DataType != p.fieldType || def->Size != fieldDefSize(p) ||
+            def->Name != p.displayName) {
+            return false;
+        }
     }
+    return true;
 }
 
 // Тонкий wrapper: проверка null + delegate в decodeFieldToVariant.
@@ -71,7 +71,7 @@ toVariant(const fbpp::core::Row& row, unsigned index,
 inline System::Variant
 toVariant(const fbpp::core::RowView& view, std::string_view name,
           const VariantDecodeOptions& opts = {}) {
-    auto idx = view.metadata().getIndex(std::string(name));
+    auto idx = view.metadata().getIndex(name);
     if (!idx) {
         throw fbpp::core::FirebirdException(
             std::string("toVariant: column not found: '") +
@@ -83,7 +83,7 @@ toVariant(const fbpp::core::RowView& view, std::string_view name,
 inline System::Variant
 toVariant(const fbpp::core::Row& row, std::string_view name,
           const VariantDecodeOptions& opts = {}) {
-    auto idx = row.metadata().getIndex(std::string(name));
+    auto idx = row.metadata().getIndex(name);
     if (!idx) {
         throw fbpp::core::FirebirdException(
             std::string("toVariant: column not found: '") +
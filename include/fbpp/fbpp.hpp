@@ -23,6 +23,7 @@
 #include "fbpp/core/environment.hpp"
 #include "fbpp/core/connection.hpp"
 #include "fbpp/core/transaction.hpp"
+#include "fbpp/core/transaction_options.hpp"
 #include "fbpp/core/statement.hpp"
 #include "fbpp/core/result_set.hpp"
 #include "fbpp/core/exception.hpp"
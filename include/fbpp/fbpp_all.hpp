@@ -20,6 +20,38 @@
 // Batch operations
 #include "fbpp/core/batch.hpp"
 #include "fbpp/core/batch_impl.hpp"
+#include "fbpp/core/bulk_loader.hpp"
+#include "fbpp/core/parallel_bulk_loader.hpp"
+#include "fbpp/core/statement_pipeline.hpp"
+#include "fbpp/core/procedure_call.hpp"
+
+// Deadline / stop_token bounded execution
+#include "fbpp/core/cancel_scope.hpp"
+
+// One query over several shard databases, merged
+#include "fbpp/core/sharded_executor.hpp"
+#include "fbpp/core/monitoring_sampler.hpp"
+#include "fbpp/core/distributed_transaction.hpp"
+#include "fbpp/core/multiplexed_connection.hpp"
+#include "fbpp/core/output_coercion.hpp"
+
+// Compile-time parsed SQL literals: sql<"...">
+#include "fbpp/core/sql_literal.hpp"
+
+// Generated column / parameter indexes: get<Col::X>(view), set<Param::X>(binder, v)
+#include "fbpp/core/query_fields.hpp"
+
+// Update-conflict retry with backoff
+#include "fbpp/core/retrying_transaction_runner.hpp"
+
+// BLOB streaming
+#include "fbpp/core/blob.hpp"
+
+// UTF-8 validation / charset transcoding
+#include "fbpp/core/text_codec.hpp"
+
+// WITH TIME ZONE zone id / offset cache
+#include "fbpp/core/time_zone_table.hpp"
 
 // Data packers
 #include "fbpp/core/json_packer.hpp"
@@ -14,4 +14,6 @@
 
 // Extended types support
 #include "fbpp/core/extended_types.hpp"
+#include "fbpp/core/decfloat_chars.hpp"
+#include "fbpp/core/int128_chars.hpp"
 #include "fbpp/core/timestamp_utils.hpp"
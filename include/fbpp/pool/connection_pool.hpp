@@ -0,0 +1,290 @@
+#pragma once
+
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/statement_metrics.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <thread>
+
+namespace fbpp::pool {
+
+/**
+ * @brief Lane of a checkout: who gets a connection first
+ *
+ * Waiting checkouts of a higher lane are served before lower ones, and
+ * the lower lanes stop short of the concurrency limit by the capacity
+ * reserved for the ones above (ConnectionPoolOptions::reservedInteractive,
+ * reservedNormal).
+ */
+enum class PoolPriority {
+    Interactive,   // Short request-path statements
+    Normal,        // acquire() without a priority
+    Batch          // Scans, exports, nightly jobs
+};
+
+inline constexpr std::size_t kPoolPriorities = 3;
+
+/**
+ * @brief AIMD concurrency limit driven by observed lease latency
+ *
+ * Each returned lease is a sample: its hold time, or the latency given to
+ * ConnectionLease::reportLatency(). A sample above latencyTarget cuts the
+ * limit by `backoff` (at most once per limit-many samples, so one slow
+ * burst backs off once); samples within it while at least half the limit
+ * is in use add one connection per limit-many samples. The limit stays
+ * between minLimit and maxSize; checkouts above it wait as for an
+ * exhausted pool.
+ */
+struct AdaptiveLimitOptions {
+    bool enabled = false;
+    std::chrono::milliseconds latencyTarget{100};
+    double backoff = 0.9;
+    size_t minLimit = 1;
+};
+
+/**
+ * @brief Checkout, validation and reaping policy of a ConnectionPool
+ */
+struct ConnectionPoolOptions {
+    // acquire() gives up (FirebirdException) after waiting this long
+    std::chrono::milliseconds acquireTimeout{std::chrono::seconds(30)};
+    // Idle connections above the minimum are closed after this long; 0 keeps them
+    std::chrono::milliseconds idleTimeout{std::chrono::minutes(5)};
+    // Period of the background reaper; 0 runs no thread (call reapIdle())
+    std::chrono::milliseconds reapInterval{std::chrono::seconds(30)};
+    // On checkout, ping only connections idle for at least this long
+    // (one op_ping round trip, no query); 0 pings every checkout
+    std::chrono::milliseconds validateAfterIdle{std::chrono::seconds(1)};
+    // Prefer the idle connection the calling thread returned last, so a
+    // thread keeps hitting its own warm StatementCache
+    bool threadAffinity = true;
+    // Capacity only Interactive checkouts use: Normal and Batch leases stop
+    // this many short of the limit
+    size_t reservedInteractive = 0;
+    // Further capacity Batch checkouts leave to Normal and Interactive
+    size_t reservedNormal = 0;
+    AdaptiveLimitOptions adaptiveLimit;
+};
+
+/**
+ * @brief Counters of one PoolPriority lane
+ */
+struct PoolLaneStats {
+    size_t leased = 0;
+    size_t waiting = 0;               // Checkouts queued right now
+    uint64_t acquired = 0;
+    uint64_t timeouts = 0;
+    core::LatencySnapshot queueWait;  // Time from acquire() to the lease
+};
+
+/**
+ * @brief Counters of a ConnectionPool
+ *
+ * A point-in-time copy (ConnectionPool::stats()); counters are cumulative
+ * since construction, so rates and interval percentages come from the
+ * difference of two snapshots. The same figures are exported to
+ * OpenTelemetry by fbpp::ext::OtelPoolMetrics (fbpp/ext/otel.hpp).
+ */
+struct ConnectionPoolStats {
+    size_t total = 0;                 // Open connections (idle + leased)
+    size_t idle = 0;
+    size_t leased = 0;                // Leases out, attachments being opened for one included
+    size_t creating = 0;              // Attachments being opened right now
+    size_t peakLeased = 0;            // Most leases out at once
+    uint64_t created = 0;             // Attachments opened
+    uint64_t reused = 0;              // Checkouts served from the idle list
+    uint64_t affinityHits = 0;        // ... with the caller's own connection
+    uint64_t validationFailures = 0;  // Idle connections found dead on checkout
+    uint64_t reaped = 0;              // Idle connections closed by reaping
+    uint64_t timeouts = 0;            // acquire() calls that gave up
+    size_t limit = 0;                 // Concurrency limit now (maxSize unless adaptive)
+    uint64_t limitDecreases = 0;      // Adaptive backoffs
+    uint64_t resizes = 0;             // resize() calls
+    uint64_t optionsUpdates = 0;      // setConnectionOptions() calls
+    uint64_t optionsApplied = 0;      // Reused connections brought up to date on checkout
+
+    core::LatencySnapshot checkoutWait;   // Time from acquire() to the lease, every lane
+    core::LatencySnapshot leaseDuration;  // Checkout to release() / discard()
+    // leased / limit at every checkout, in percent (the *Micros fields of
+    // this snapshot hold percent, not microseconds)
+    core::LatencySnapshot utilization;
+
+    // StatementCache hits and misses of the pooled connections, summed as
+    // each lease ends (connections still leased count up to their checkout)
+    uint64_t statementCacheHits = 0;
+    uint64_t statementCacheMisses = 0;
+
+    std::array<PoolLaneStats, kPoolPriorities> lanes;   // By PoolPriority
+
+    /// Statement cache hit rate (0..1) over every lease so far
+    double statementCacheHitRate() const noexcept {
+        const uint64_t lookups = statementCacheHits + statementCacheMisses;
+        return lookups ? static_cast<double>(statementCacheHits) / static_cast<double>(lookups)
+                       : 0.0;
+    }
+
+    /// Leases in use as a fraction of the limit now
+    double utilizationNow() const noexcept {
+        return limit ? static_cast<double>(leased) / static_cast<double>(limit) : 0.0;
+    }
+};
+
+namespace detail {
+struct PoolState;
+
+// StatementCache counters of a connection as of its last return
+struct CacheCounters {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+};
+} // namespace detail
+
+/**
+ * @brief RAII checkout of one pooled Connection
+ *
+ * Returns the connection on destruction. Finish (commit / roll back) its
+ * transactions before that: the next holder gets the attachment as is.
+ * A lease may outlive its pool; the connection is then closed instead.
+ */
+class ConnectionLease {
+public:
+    ConnectionLease() = default;
+    ~ConnectionLease();
+
+    ConnectionLease(ConnectionLease&& other) noexcept = default;
+    ConnectionLease& operator=(ConnectionLease&& other) noexcept;
+    ConnectionLease(const ConnectionLease&) = delete;
+    ConnectionLease& operator=(const ConnectionLease&) = delete;
+
+    core::Connection* get() const noexcept { return connection_.get(); }
+    core::Connection* operator->() const noexcept { return connection_.get(); }
+    core::Connection& operator*() const noexcept { return *connection_; }
+    explicit operator bool() const noexcept { return connection_ != nullptr; }
+
+    /// Return the connection to the pool now
+    void release();
+
+    /// Close the connection instead of returning it (e.g. after a fatal error)
+    void discard();
+
+    /// Latency the adaptive limit samples on release, instead of the hold time
+    void reportLatency(std::chrono::steady_clock::duration latency) noexcept {
+        latency_ = latency;
+    }
+
+    PoolPriority priority() const noexcept { return priority_; }
+
+private:
+    friend class ConnectionPool;
+    ConnectionLease(std::shared_ptr<detail::PoolState> state,
+                    std::unique_ptr<core::Connection> connection, PoolPriority priority,
+                    uint64_t generation, detail::CacheCounters cacheSeen);
+
+    // Cache counters the connection gained during the lease; updates cacheSeen_
+    detail::CacheCounters takeCacheDelta() noexcept;
+
+    std::shared_ptr<detail::PoolState> state_;
+    std::unique_ptr<core::Connection> connection_;
+    PoolPriority priority_ = PoolPriority::Normal;
+    std::chrono::steady_clock::time_point since_{};
+    std::optional<std::chrono::steady_clock::duration> latency_;
+    uint64_t generation_ = 0;          // Pool options the connection has
+    detail::CacheCounters cacheSeen_;  // Its cache counters at checkout
+};
+
+/**
+ * @brief Bounded pool of Connections to one database
+ *
+ * Opens `minSize` connections up front and at most `maxSize` in total.
+ * acquire() hands out the caller thread's previous connection when
+ * threadAffinity is on, otherwise the most recently returned one; new
+ * attachments are opened only when nothing is idle. The pool itself is
+ * thread-safe; each leased Connection keeps its usual one-thread-at-a-time
+ * contract.
+ *
+ * Checkouts carry a PoolPriority. Interactive calls sharing the database
+ * with batch jobs get a lane of their own:
+ *
+ *   ConnectionPoolOptions options;
+ *   options.reservedInteractive = 4;          // Batch never takes the last 4
+ *   options.adaptiveLimit.enabled = true;     // Back off when leases slow down
+ *   ConnectionPool pool(params, 2, 32, options);
+ *   auto lease = pool.acquire(PoolPriority::Interactive);
+ *
+ * stats().lanes has per-lane queue-wait histograms; stats() as a whole
+ * has the checkout wait, lease duration and utilization histograms and the
+ * statement cache hit rate of the pooled connections.
+ *
+ * Sizes and connection options can be changed while the pool is in use
+ * (resize(), setConnectionOptions()), e.g. from a watched configuration
+ * file (fbpp_util/config_watcher.h).
+ */
+class ConnectionPool {
+public:
+    ConnectionPool(core::ConnectionParams params, size_t minSize, size_t maxSize,
+                   ConnectionPoolOptions options = {});
+    ~ConnectionPool();
+
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    /// Check out a connection, waiting up to options().acquireTimeout
+    ConnectionLease acquire();
+    ConnectionLease acquire(std::chrono::milliseconds timeout);
+    ConnectionLease acquire(PoolPriority priority);
+    ConnectionLease acquire(PoolPriority priority, std::chrono::milliseconds timeout);
+
+    /// Check out a connection only if one is idle or may be opened; empty otherwise
+    ConnectionLease tryAcquire();
+    ConnectionLease tryAcquire(PoolPriority priority);
+
+    /**
+     * @brief Close connections idle longer than idleTimeout (keeping minSize)
+     * @return Connections closed
+     */
+    size_t reapIdle();
+
+    /**
+     * @brief Change the pool bounds while it is in use
+     *
+     * Idle connections above the new maximum are closed at once, longest
+     * idle first; leased ones when they come back. A higher minimum is
+     * opened before returning. The adaptive limit is capped at the new
+     * maximum and grows into a larger one by itself.
+     * @return Connections closed
+     * @throws FirebirdException for bounds the constructor would reject
+     */
+    size_t resize(size_t minSize, size_t maxSize);
+
+    /**
+     * @brief Options of the pooled Connections from now on
+     *
+     * New attachments are opened with them; connections already open get
+     * them (Connection::setOptions) at their next checkout, so a leased
+     * connection is never changed under its holder.
+     */
+    void setConnectionOptions(const core::ConnectionOptions& options);
+
+    size_t minSize() const;
+    size_t maxSize() const;
+    core::ConnectionOptions connectionOptions() const;
+
+    ConnectionPoolStats stats() const;
+    const ConnectionPoolOptions& options() const noexcept { return options_; }
+
+private:
+    ConnectionLease checkout(PoolPriority priority, std::chrono::milliseconds timeout, bool wait);
+    void fillToMinimum();
+    void reaperLoop();
+
+    std::shared_ptr<detail::PoolState> state_;
+    ConnectionPoolOptions options_;
+    std::thread reaper_;
+};
+
+} // namespace fbpp::pool
@@ -0,0 +1,166 @@
+#pragma once
+
+// ReplicaRouter — connection pools for a primary and its read replicas.
+//
+// One ConnectionPool per node. acquire(TransactionOptions) sends read-only
+// work (options.readOnly) to a replica and everything else to the primary:
+//
+//   ReplicaRouter router(primaryParams, {replica1, replica2}, 2, 16);
+//   auto lease = router.acquire(TransactionOptions::readOnlyReadCommitted());
+//   auto tx = lease->StartTransaction(TransactionOptions::readOnlyReadCommitted());
+//
+// Among the healthy replicas the one with the fewest outstanding leases
+// wins (ties rotate). A replica is unhealthy while it cannot be reached or
+// lags more than maxLag; with no healthy replica, reads go to the primary
+// (primaryFallback) or fail.
+//
+// Lag is measured with a heartbeat row, without comparing server clocks:
+// every check writes an increasing number into heartbeatTable on the
+// primary and reads it back from each replica. A replica that shows beat M
+// lags by the time since the router wrote beat M + 1 (zero when it shows
+// the latest). The table (ID SMALLINT, BEAT BIGINT) is created on the
+// primary when missing and must be replicated like any other table. An
+// empty heartbeatTable turns lag checks into reachability checks.
+//
+// Checks run every checkInterval on a thread of the router's, or on
+// request (checkReplicas()) when the interval is 0.
+
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/transaction_options.hpp"
+#include "fbpp/pool/connection_pool.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fbpp::pool {
+
+/**
+ * @brief Routing, health check and per-node pool policy of a ReplicaRouter
+ */
+struct ReplicaRouterOptions {
+    // Applied to the pool of every node
+    ConnectionPoolOptions pool;
+    // Replicas lagging more than this get no reads
+    std::chrono::milliseconds maxLag{std::chrono::seconds(5)};
+    // Period of the background check; 0 runs no thread (call checkReplicas())
+    std::chrono::milliseconds checkInterval{std::chrono::seconds(1)};
+    // Heartbeat table on the primary; empty = no lag measurement
+    std::string heartbeatTable = "FBPP_HEARTBEAT";
+    // Send reads to the primary when no replica is healthy; false throws
+    bool primaryFallback = true;
+};
+
+/**
+ * @brief State of one node of a ReplicaRouter
+ */
+struct ReplicaNodeStats {
+    bool healthy = true;
+    size_t outstanding = 0;                    // Leases out now
+    uint64_t routed = 0;                       // Leases handed out so far
+    std::optional<std::chrono::milliseconds> lag;   // Last measured; primary: none
+};
+
+/**
+ * @brief Counters of a ReplicaRouter
+ */
+struct ReplicaRouterStats {
+    ReplicaNodeStats primary;
+    std::vector<ReplicaNodeStats> replicas;
+    uint64_t primaryFallbacks = 0;   // Reads sent to the primary for want of a replica
+    uint64_t checks = 0;             // checkReplicas() runs
+};
+
+namespace detail {
+struct RouteNode;
+struct RouterState;
+}
+
+/**
+ * @brief Lease of a ReplicaRouter: a ConnectionLease that counts as outstanding
+ *
+ * Same contract as ConnectionLease.
+ */
+class RoutedLease {
+public:
+    RoutedLease() = default;
+    ~RoutedLease();
+
+    RoutedLease(RoutedLease&& other) noexcept = default;
+    RoutedLease& operator=(RoutedLease&& other) noexcept;
+    RoutedLease(const RoutedLease&) = delete;
+    RoutedLease& operator=(const RoutedLease&) = delete;
+
+    core::Connection* get() const noexcept { return lease_.get(); }
+    core::Connection* operator->() const noexcept { return lease_.get(); }
+    core::Connection& operator*() const noexcept { return *lease_; }
+    explicit operator bool() const noexcept { return static_cast<bool>(lease_); }
+
+    /// Replica the lease is on (0-based), or std::nullopt for the primary
+    std::optional<size_t> replica() const noexcept { return replica_; }
+
+    void release();
+    void discard();
+
+private:
+    friend class ReplicaRouter;
+    RoutedLease(ConnectionLease lease, std::shared_ptr<detail::RouteNode> node,
+                std::optional<size_t> replica);
+
+    void finish() noexcept;
+
+    ConnectionLease lease_;
+    std::shared_ptr<detail::RouteNode> node_;
+    std::optional<size_t> replica_;
+};
+
+/**
+ * @brief Routes read-only checkouts to replicas and the rest to the primary
+ *
+ * Thread-safe like ConnectionPool. Every node's pool is sized
+ * minSize..maxSize; a replica that cannot be reached at construction
+ * starts empty and unhealthy instead of failing the router.
+ */
+class ReplicaRouter {
+public:
+    ReplicaRouter(core::ConnectionParams primary, std::vector<core::ConnectionParams> replicas,
+                  size_t minSize, size_t maxSize, ReplicaRouterOptions options = {});
+    ~ReplicaRouter();
+
+    ReplicaRouter(const ReplicaRouter&) = delete;
+    ReplicaRouter& operator=(const ReplicaRouter&) = delete;
+
+    /// Checkout for a transaction started with `options`: replica if readOnly
+    RoutedLease acquire(const core::TransactionOptions& options);
+
+    /// Checkout from the primary
+    RoutedLease acquirePrimary();
+
+    /// Checkout from a healthy replica, or per primaryFallback
+    RoutedLease acquireReplica();
+
+    /**
+     * @brief Write a heartbeat and re-measure every replica now
+     *
+     * @return Healthy replicas afterwards
+     */
+    size_t checkReplicas();
+
+    size_t replicaCount() const noexcept;
+    ReplicaRouterStats stats() const;
+    const ReplicaRouterOptions& options() const noexcept { return options_; }
+
+private:
+    void checkLoop();
+
+    std::shared_ptr<detail::RouterState> state_;
+    ReplicaRouterOptions options_;
+    std::thread checker_;
+};
+
+} // namespace fbpp::pool
@@ -6,9 +6,13 @@
 #include "fbpp/schema/query_analysis.hpp"
 #include "fbpp/schema/type_mapper.hpp"
 
+#include <cstddef>
+#include <cstdint>
+#include <map>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 namespace fbpp::core {
@@ -37,14 +41,75 @@ struct QuerySpec {
     bool hasNamedParameters = false;
     std::string positionalSql;
     fbpp::schema::QueryKind kind = fbpp::schema::QueryKind::unknown;
+    std::string plan;                                  ///< Detailed plan (not for DDL)
+    std::vector<fbpp::schema::PlanScan> naturalScans;  ///< Full scans in `plan`
+    std::string outputCoercion;   ///< Canonical OutputCoercion `outputs` were built with
+};
+
+struct QuerySpecCacheStats {
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    bool warm = false;   ///< Loaded from disk with a matching fingerprint
+};
+
+/// On-disk cache of QuerySpec results between query_generator runs.
+///
+/// Entries are keyed by the exact SQL text plus configHash() of the adapter
+/// configuration they were mapped with; the query name is not part of the
+/// key. The whole file is tied to a fingerprint (see fingerprintOf()), so
+/// any schema change, or another database / charset, starts it cold.
+/// save() keeps only the entries used by this run. Not thread-safe.
+class QuerySpecCache {
+public:
+    /// Loads `path` when it exists and was written for `fingerprint`; a
+    /// missing, damaged or stale file just means an empty cache.
+    QuerySpecCache(std::string path, std::string fingerprint);
+
+    bool contains(const QueryDefinition& definition, const AdapterConfig& config) const;
+    std::optional<QuerySpec> find(const QueryDefinition& definition, const AdapterConfig& config);
+    void store(const QuerySpec& spec, const AdapterConfig& config);
+
+    /// Write the file (temporary file, then rename) unless its contents
+    /// would not change. Returns true when it was written.
+    bool save();
+
+    QuerySpecCacheStats stats() const noexcept { return stats_; }
+
+    /// Connection::getTemplateScope() plus MetadataCache::schemaFingerprint().
+    static std::string fingerprintOf(Connection& connection);
+    static std::uint64_t configHash(const AdapterConfig& config) noexcept;
+
+private:
+    struct Entry {
+        QuerySpec spec;
+        bool used = false;
+    };
+
+    std::string path_;
+    std::string fingerprint_;
+    bool dirty_ = false;
+    QuerySpecCacheStats stats_;
+    std::map<std::pair<std::uint64_t, std::string>, Entry> entries_;   // (config hash, SQL)
 };
 
 class QueryGeneratorService {
 public:
     explicit QueryGeneratorService(Connection& connection);
 
+    /// Prepare every definition (or take it from `cache`) and return the
+    /// specs sorted by name. New results are stored into `cache`.
     std::vector<QuerySpec> buildQuerySpecs(const std::vector<QueryDefinition>& definitions,
-                                           const AdapterConfig& config = {}) const;
+                                           const AdapterConfig& config = {},
+                                           QuerySpecCache* cache = nullptr) const;
+
+    /// Same, with the definitions not found in `cache` prepared concurrently,
+    /// one thread per connection, each taking the next pending definition.
+    /// All connections must be attached to the same database and be idle for
+    /// the duration of the call.
+    static std::vector<QuerySpec> buildQuerySpecs(const std::vector<Connection*>& connections,
+                                                  const std::vector<QueryDefinition>& definitions,
+                                                  const AdapterConfig& config = {},
+                                                  QuerySpecCache* cache = nullptr);
 
 private:
     Connection& connection_;
@@ -56,4 +121,15 @@ std::string renderQueryGeneratorMainHeader(const std::vector<QuerySpec>& specs,
 std::string renderQueryGeneratorSupportHeader(const std::vector<QuerySpec>& specs,
                                               const AdapterConfig& config = {});
 
+/// Text report of every query's plan, by name, meant to be committed next to
+/// the generated headers so that plan changes show up as a diff. A NATURAL
+/// scan of a table estimated at `largeTableRows` rows or more gets a marker
+/// line; estimates themselves are left out so statistics drift is not noise.
+std::string renderQueryPlanReport(const std::vector<QuerySpec>& specs,
+                                  std::uint64_t largeTableRows = 10000);
+
+/// NATURAL scans in `spec` on tables of at least `largeTableRows` rows.
+std::vector<fbpp::schema::PlanScan> largeNaturalScans(const QuerySpec& spec,
+                                                      std::uint64_t largeTableRows = 10000);
+
 } // namespace fbpp::core
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+
 namespace fbpp::schema {
 
 struct AdapterConfig {
@@ -9,6 +11,12 @@ struct AdapterConfig {
     bool useCppDecimalDecFloat = false;
     bool useStringForTextBlob = false;
     bool generateAliases = true;
+    // CHAR/VARCHAR of up to this many bytes map to fbpp::core::FixedString<N>
+    // (inline, no allocation per fetched value); 0 keeps std::string
+    unsigned inlineStringBytes = 0;
+    // fbpp::core::OutputCoercion spec (e.g. "NUMERIC=DOUBLE;DECFLOAT=VARCHAR")
+    // applied to the columns of cursor queries; empty keeps native types
+    std::string outputCoercion;
 };
 
 } // namespace fbpp::schema
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/firebird_compat.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/row.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace fbpp::schema {
+
+struct BlobFetchOptions {
+    unsigned connections = 4;         ///< Connections and worker threads
+    /// Start every worker at the source transaction's snapshot number
+    /// (isc_tpb_at_snapshot_number, Firebird 4+). Without server support,
+    /// or for a source that is not a snapshot, each worker reads its own.
+    bool shareSnapshot = true;
+};
+
+struct BlobFetchWorker {
+    std::uint64_t blobs = 0;
+    std::uint64_t bytes = 0;
+    std::string error;                ///< Connect / read / sink failure
+    std::chrono::steady_clock::duration elapsed{};
+};
+
+struct BlobFetchResult {
+    std::uint64_t blobs = 0;          ///< BLOBs delivered to the sink
+    std::uint64_t nulls = 0;          ///< NULL ids skipped
+    std::uint64_t bytes = 0;
+    std::vector<BlobFetchWorker> workers;
+    /// Snapshot every worker read; nullopt = independent snapshots
+    std::optional<std::uint64_t> snapshotNumber;
+    std::chrono::steady_clock::duration elapsed{};
+
+    bool ok() const;
+
+    double bytesPerSecond() const {
+        const double seconds = std::chrono::duration<double>(elapsed).count();
+        return seconds > 0 ? static_cast<double>(bytes) / seconds : 0.0;
+    }
+};
+
+/// Loads many BLOBs concurrently over several connections.
+///
+/// Reading BLOBs one after another through Transaction::loadBlob() costs
+/// a round trip per segment batch and per open, so exports of document
+/// tables are latency-bound. BlobFetcher takes the ids a cursor of the
+/// source transaction returned and spreads them over `connections`
+/// workers, each on its own connection and thread. Workers take the next
+/// id as they finish one, so large and small BLOBs balance out. With
+/// shareSnapshot the workers' read-only transactions start at the source
+/// transaction's snapshot number, so they see the records the ids came
+/// from.
+///
+///   auto tx = conn.StartTransaction(snapshotOptions);
+///   auto ids = fbpp::schema::BlobFetcher::collectIds(*tx->openCursor(stmt), 1);
+///   fbpp::schema::BlobFetcher fetcher(params);
+///   fetcher.fetch(*tx, ids, [&](std::size_t row, std::vector<uint8_t>&& bytes) {
+///       files[row].write(bytes);                 // concurrent, any order
+///   });
+///
+/// The source transaction must stay open during fetch(). A failed worker
+/// stops the others; its error is in the result.
+class BlobFetcher {
+public:
+    /// Opens one connection; called once per worker
+    using ConnectionFactory = std::function<std::unique_ptr<fbpp::core::Connection>()>;
+    /// Concurrent sink: called on the worker's thread with the id's position
+    using Sink = std::function<void(std::size_t row, std::vector<std::uint8_t>&& bytes)>;
+
+    explicit BlobFetcher(ConnectionFactory factory, BlobFetchOptions options = {});
+    explicit BlobFetcher(const fbpp::core::ConnectionParams& params, BlobFetchOptions options = {});
+
+    /// BLOB id of column `index` in `row`; nullopt for NULL. Throws if the
+    /// column is not a BLOB.
+    static std::optional<ISC_QUAD> blobId(const fbpp::core::RowView& row, unsigned index);
+
+    /// Ids of column `index` in every remaining row of `cursor`, in order
+    static std::vector<std::optional<ISC_QUAD>> collectIds(fbpp::core::ResultSet& cursor,
+                                                           unsigned index);
+
+    /// Load every non-NULL id, calling `sink(position, bytes)` from the workers
+    BlobFetchResult fetch(fbpp::core::Transaction& source,
+                          std::span<const std::optional<ISC_QUAD>> ids, const Sink& sink);
+
+private:
+    ConnectionFactory factory_;
+    BlobFetchOptions options_;
+};
+
+} // namespace fbpp::schema
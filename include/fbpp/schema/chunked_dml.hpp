@@ -0,0 +1,152 @@
+#pragma once
+
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/statement_metrics.hpp"
+#include "fbpp/core/transaction_options.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace fbpp::schema {
+
+/// How ChunkedDml ends the work of each chunk.
+enum class ChunkCommit {
+    commit,          ///< Commit and start a new transaction per chunk
+    commitRetaining  ///< CommitRetaining one transaction per worker; Commit at the end
+};
+
+struct ChunkedDmlOptions {
+    /// Range column. The single-column SMALLINT / INTEGER / BIGINT primary
+    /// key is used when empty.
+    std::string keyColumn;
+    /// Key values per chunk (the first chunk; see targetChunkTime)
+    std::uint64_t chunkKeys = 10000;
+    std::uint64_t minChunkKeys = 100;
+    std::uint64_t maxChunkKeys = 1000000;
+    /// Halve the chunk when one takes longer, double it when one takes
+    /// less than half of it; zero keeps chunkKeys fixed
+    std::chrono::milliseconds targetChunkTime{0};
+    /// After every chunk sleep its duration times this (0.5 = at most about
+    /// two thirds of the time spent in the database), capped at maxPause
+    double pauseRatio = 0.0;
+    std::chrono::milliseconds maxPause{2000};
+    ChunkCommit commitMode = ChunkCommit::commit;
+    /// TPB of every worker transaction
+    fbpp::core::TransactionOptions transaction =
+        fbpp::core::TransactionOptions::lockTimeout(10,
+            fbpp::core::TxIsolation::ReadCommittedRecordVersion);
+    unsigned connections = 1;         ///< Workers, each on its own connection and thread
+    /// Key range to cover; MIN / MAX of the key when unset (resume with
+    /// ChunkedDmlResult::resumeFrom)
+    std::optional<std::int64_t> fromKey;
+    std::optional<std::int64_t> toKey;
+};
+
+/// One committed chunk, as passed to the progress callback
+struct ChunkedDmlChunk {
+    unsigned worker = 0;
+    std::int64_t firstKey = 0;
+    std::int64_t lastKey = 0;
+    std::uint64_t rows = 0;
+    std::chrono::steady_clock::duration elapsed{};
+};
+
+/// A chunk whose statement or commit failed; its changes were rolled back
+struct ChunkedDmlFailure {
+    unsigned worker = 0;
+    /// The chunk's range; unset when the worker failed outside a chunk
+    /// (connecting, or the final commit)
+    std::optional<std::int64_t> firstKey;
+    std::optional<std::int64_t> lastKey;
+    std::string error;
+};
+
+struct ChunkedDmlResult {
+    std::uint64_t rows = 0;           ///< Rows changed by committed chunks
+    std::uint64_t chunks = 0;         ///< Committed chunks
+    std::string keyColumn;
+    std::optional<std::int64_t> firstKey;   ///< Range walked; unset for an empty table
+    std::optional<std::int64_t> lastKey;
+    /// First key no worker took, after a failure or a stop; unset when the
+    /// whole range was handed out
+    std::optional<std::int64_t> resumeFrom;
+    std::vector<ChunkedDmlFailure> failures;
+    fbpp::core::LatencySnapshot chunkLatency;   ///< Statement plus commit, per chunk
+    std::chrono::steady_clock::duration paused{};   ///< Throttle sleeps, all workers
+    std::chrono::steady_clock::duration elapsed{};
+    bool stopped = false;             ///< The progress callback returned false
+
+    bool ok() const { return failures.empty() && !stopped; }
+};
+
+/// Mass UPDATE / DELETE split into key-range chunks of bounded size.
+///
+/// One `DELETE FROM big WHERE ...` over fifty million rows is one
+/// transaction: its undo log grows with every row, and the back versions it
+/// leaves are collected in one long tail that slows every reader behind
+/// it. ChunkedDml reads the key range (the integer primary key found via
+/// SchemaInspector, or keyColumn), cuts it into consecutive ranges of
+/// chunkKeys values and runs the statement once per range, each in its own
+/// short transaction:
+///
+///   fbpp::schema::ChunkedDmlOptions options;
+///   options.targetChunkTime = std::chrono::milliseconds(200);
+///   options.pauseRatio = 1.0;                     // half the time for OLTP
+///   fbpp::schema::ChunkedDml dml(params, "EVENTS", options);
+///   auto result = dml.deleteWhere("CREATED_AT < DATE '2024-01-01'");
+///   if (!result.ok()) { ... options.fromKey = result.resumeFrom ... }
+///
+/// Ranges are handed out in key order from a shared counter, so with
+/// connections > 1 the workers walk the range together on their own
+/// connections and threads. The chunk size adapts to targetChunkTime and
+/// pauseRatio sleeps in proportion to the latency observed; both react to
+/// a loaded server by backing off.
+///
+/// The where condition is AND-ed to the range and evaluated per chunk in
+/// each chunk's transaction, so the run as a whole is not atomic: rows
+/// inserted behind the walk, or changed by others meanwhile, are judged
+/// on what they are when their chunk runs. A failed chunk rolls back and
+/// stops every worker after its current chunk; earlier chunks stay
+/// committed. ChunkCommit::commitRetaining saves a transaction start per
+/// chunk but keeps each worker's transaction alive until the end, which
+/// holds back garbage collection behind it: prefer commit for big runs.
+/// Keep the statement idempotent by range so a rerun from resumeFrom (or
+/// from a failure's firstKey) is safe.
+class ChunkedDml {
+public:
+    /// Opens one connection; called for the coordinator and once per worker
+    using ConnectionFactory = std::function<std::unique_ptr<fbpp::core::Connection>()>;
+    /// Called after every committed chunk, one call at a time, on the
+    /// worker's thread; returning false stops all workers
+    using ProgressCallback = std::function<bool(const ChunkedDmlChunk& chunk)>;
+
+    ChunkedDml(ConnectionFactory factory, std::string table, ChunkedDmlOptions options = {});
+    ChunkedDml(const fbpp::core::ConnectionParams& params, std::string table,
+               ChunkedDmlOptions options = {});
+
+    void onProgress(ProgressCallback callback) { progress_ = std::move(callback); }
+
+    /// DELETE FROM table WHERE <range> [AND (where)], chunk by chunk
+    ChunkedDmlResult deleteWhere(std::string_view where = {});
+
+    /// UPDATE table SET <set> WHERE <range> [AND (where)], chunk by chunk.
+    /// Do not assign the key column itself.
+    ChunkedDmlResult update(std::string_view set, std::string_view where = {});
+
+private:
+    ChunkedDmlResult run(const std::string& head, std::string_view where);
+
+    ConnectionFactory factory_;
+    std::string table_;
+    ChunkedDmlOptions options_;
+    ProgressCallback progress_;
+};
+
+} // namespace fbpp::schema
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fbpp::core {
+class Connection;
+}
+
+namespace fbpp::schema {
+
+/// Index upkeep around bulk loads, driven by SchemaInspector metadata.
+///
+///   auto parked = fbpp::schema::deactivateIndexes(conn, "EVENTS");
+///   load(conn);                                  // no index maintenance per row
+///   fbpp::schema::activateIndexes(conn, parked); // one rebuild per index
+///   fbpp::schema::refreshIndexStatistics(conn, {"EVENTS"});
+///
+/// ALTER INDEX ... ACTIVE rebuilds the index; on Firebird 5 the rebuild is
+/// spread over the attachment's parallel workers, so attach with
+/// ConnectionParams::parallelWorkers set to the cores to use. Each
+/// statement runs and commits on its own (Connection::ExecuteDDL).
+
+/// Deactivate the active indexes of `table` that back no constraint
+/// (constraint indexes cannot be deactivated). Returns their names.
+std::vector<std::string> deactivateIndexes(fbpp::core::Connection& connection,
+                                           std::string_view table);
+
+/// ALTER INDEX ... ACTIVE each of `indexes` (names as stored), in order.
+void activateIndexes(fbpp::core::Connection& connection, const std::vector<std::string>& indexes);
+
+/// SET STATISTICS INDEX for every active index of `tables` (every user
+/// table when empty), so the optimizer sees current selectivity.
+/// Returns the indexes refreshed.
+std::vector<std::string> refreshIndexStatistics(fbpp::core::Connection& connection,
+                                                const std::vector<std::string>& tables = {});
+
+} // namespace fbpp::schema
@@ -0,0 +1,238 @@
+#pragma once
+
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/pack_utils.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace fbpp::schema {
+
+struct KeysetPagerOptions {
+    /// Select list; the key columns must be among its output columns
+    std::string select = "*";
+    /// Extra filter without parameters, ANDed with the key predicate
+    std::string where;
+    /// Ordering key, NOT NULL and unique together; empty = the table's
+    /// primary key
+    std::vector<std::string> key;
+    unsigned pageRows = 100;
+};
+
+/// Statements of one keyset-paged query, built from SchemaInspector metadata.
+///
+/// A page after key (a, b) is
+///
+///   SELECT ... FROM t WHERE (filter) AND K1 >= ? AND (K1 > ? OR (K1 = ? AND K2 > ?))
+///   ORDER BY K1, K2 ROWS n
+///
+/// Firebird has no row value comparison; the leading K1 >= ? gives the
+/// optimizer an index range, so a page costs the same at any depth. A page
+/// before a key is the same with < and ORDER BY ... DESC. The statements
+/// come from the connection's statement cache and are held for the plan's
+/// lifetime.
+class KeysetPlan {
+public:
+    KeysetPlan(fbpp::core::Connection& connection, std::string table,
+               const KeysetPagerOptions& options);
+
+    const std::string& table() const noexcept { return table_; }
+    const std::vector<std::string>& key() const noexcept { return key_; }
+    unsigned pageRows() const noexcept { return pageRows_; }
+    /// Output column of each key column
+    const std::vector<unsigned>& keyColumns() const noexcept { return keyColumns_; }
+
+    const std::string& firstSql() const noexcept { return firstSql_; }
+    const std::string& afterSql() const noexcept { return afterSql_; }
+    const std::string& beforeSql() const noexcept { return beforeSql_; }
+    /// The last page, read backwards
+    const std::string& lastSql() const noexcept { return lastSql_; }
+
+    const std::shared_ptr<fbpp::core::Statement>& first() const noexcept { return first_; }
+    const std::shared_ptr<fbpp::core::Statement>& after() const noexcept { return after_; }
+    const std::shared_ptr<fbpp::core::Statement>& before() const noexcept { return before_; }
+    const std::shared_ptr<fbpp::core::Statement>& last() const noexcept { return last_; }
+
+private:
+    std::string table_;
+    std::vector<std::string> key_;
+    unsigned pageRows_;
+    std::vector<unsigned> keyColumns_;
+    std::string firstSql_;
+    std::string afterSql_;
+    std::string beforeSql_;
+    std::string lastSql_;
+    std::shared_ptr<fbpp::core::Statement> first_;
+    std::shared_ptr<fbpp::core::Statement> after_;
+    std::shared_ptr<fbpp::core::Statement> before_;
+    std::shared_ptr<fbpp::core::Statement> last_;
+};
+
+namespace detail {
+
+// Key element bound to each '?' of KeysetPlan's key predicate: K1 for the
+// leading range, then K1..Ki for the i-th disjunct
+template<std::size_t N>
+constexpr auto keysetParameterOrder() {
+    std::array<std::size_t, 1 + N * (N + 1) / 2> order{};
+    std::size_t next = 0;
+    order[next++] = 0;
+    for (std::size_t i = 0; i < N; ++i) {
+        for (std::size_t j = 0; j <= i; ++j) {
+            order[next++] = j;
+        }
+    }
+    return order;
+}
+
+template<typename Key, std::size_t... I>
+auto keysetParameters(const Key& key, std::index_sequence<I...>) {
+    constexpr auto order = keysetParameterOrder<std::tuple_size_v<Key>>();
+    return std::make_tuple(std::get<order[I]>(key)...);
+}
+
+} // namespace detail
+
+/// Keyset (seek) pagination over a table: each page continues from the key
+/// of the last row seen instead of skipping rows, so deep pages cost no more
+/// than the first one.
+///
+///   fbpp::schema::KeysetPager<std::tuple<int64_t, std::string>, std::tuple<int64_t>>
+///       pager(conn, "DOC", {.select = "ID, TITLE"});
+///   auto tx = conn.StartTransaction();
+///   for (auto page = pager.first(*tx); !page.empty(); page = pager.next(*tx)) { ... }
+///
+/// Row is anything ResultSet::fetch() unpacks; Key is a tuple of the key
+/// columns' types in KeysetPlan::key() order. The pager remembers the keys
+/// of the first and the last row of the current page; next() and prev()
+/// move from them and leave them as they are when there is no such page.
+/// Rows inserted or deleted between calls shift nothing: every page is
+/// anchored to a key, not to a row number.
+template<typename Row, typename Key>
+class KeysetPager {
+public:
+    KeysetPager(fbpp::core::Connection& connection, std::string table,
+                KeysetPagerOptions options = {})
+        : plan_(connection, std::move(table), options) {
+        if (plan_.key().size() != std::tuple_size_v<Key>) {
+            throw fbpp::core::FirebirdException(
+                "KeysetPager: Key has " + std::to_string(std::tuple_size_v<Key>) +
+                " elements, the key of " + plan_.table() + " has " +
+                std::to_string(plan_.key().size()) + " columns");
+        }
+    }
+
+    std::vector<Row> first(fbpp::core::Transaction& transaction) {
+        return page(transaction, plan_.first(), std::nullopt, false);
+    }
+
+    std::vector<Row> last(fbpp::core::Transaction& transaction) {
+        return page(transaction, plan_.last(), std::nullopt, true);
+    }
+
+    /// The page after the current one; first() before any page was read
+    std::vector<Row> next(fbpp::core::Transaction& transaction) {
+        if (!lastKey_) {
+            return first(transaction);
+        }
+        return after(transaction, *lastKey_);
+    }
+
+    /// The page before the current one; last() before any page was read
+    std::vector<Row> prev(fbpp::core::Transaction& transaction) {
+        if (!firstKey_) {
+            return last(transaction);
+        }
+        return before(transaction, *firstKey_);
+    }
+
+    /// Rows with a key greater than `key`, ascending
+    std::vector<Row> after(fbpp::core::Transaction& transaction, const Key& key) {
+        return page(transaction, plan_.after(), key, false);
+    }
+
+    /// Rows with a key less than `key`, still in ascending order
+    std::vector<Row> before(fbpp::core::Transaction& transaction, const Key& key) {
+        return page(transaction, plan_.before(), key, true);
+    }
+
+    /// Keys of the first and last row of the current page
+    const std::optional<Key>& firstKey() const noexcept { return firstKey_; }
+    const std::optional<Key>& lastKey() const noexcept { return lastKey_; }
+
+    const KeysetPlan& plan() const noexcept { return plan_; }
+
+private:
+    static constexpr std::size_t kParameters = 1 + std::tuple_size_v<Key> *
+                                                       (std::tuple_size_v<Key> + 1) / 2;
+
+    std::vector<Row> page(fbpp::core::Transaction& transaction,
+                          const std::shared_ptr<fbpp::core::Statement>& statement,
+                          const std::optional<Key>& from, bool backwards) {
+        std::unique_ptr<fbpp::core::ResultSet> cursor;
+        if (from) {
+            cursor = transaction.openCursor(
+                statement,
+                detail::keysetParameters(*from, std::make_index_sequence<kParameters>{}));
+        } else {
+            cursor = transaction.openCursor(statement);
+        }
+
+        std::vector<Row> rows;
+        rows.reserve(plan_.pageRows());
+        std::optional<Key> firstKey;
+        std::optional<Key> lastKey;
+        for (const auto& view : cursor->rows()) {
+            rows.push_back(fbpp::core::unpack<Row>(view.data(), &view.metadata(),
+                                                   view.transaction()));
+            lastKey = keyOf(view, std::make_index_sequence<std::tuple_size_v<Key>>{});
+            if (!firstKey) {
+                firstKey = lastKey;
+            }
+        }
+        cursor->close();
+
+        if (rows.empty()) {
+            return rows;
+        }
+        if (backwards) {
+            std::reverse(rows.begin(), rows.end());
+            std::swap(firstKey, lastKey);
+        }
+        firstKey_ = std::move(firstKey);
+        lastKey_ = std::move(lastKey);
+        return rows;
+    }
+
+    template<std::size_t... I>
+    Key keyOf(const fbpp::core::RowView& view, std::index_sequence<I...>) const {
+        return Key{keyValue<std::tuple_element_t<I, Key>>(view, plan_.keyColumns()[I])...};
+    }
+
+    template<typename T>
+    static T keyValue(const fbpp::core::RowView& view, unsigned column) {
+        auto value = view.get<T>(column);
+        if (!value) {
+            throw fbpp::core::FirebirdException("KeysetPager: key column " +
+                                                view.columnName(column) + " is NULL");
+        }
+        return std::move(*value);
+    }
+
+    KeysetPlan plan_;
+    std::optional<Key> firstKey_;
+    std::optional<Key> lastKey_;
+};
+
+} // namespace fbpp::schema
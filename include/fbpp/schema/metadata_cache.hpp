@@ -0,0 +1,86 @@
+#pragma once
+
+#include "fbpp/core/connection.hpp"
+#include "fbpp/schema/schema_types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fbpp::schema {
+
+struct MetadataCacheStats {
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    bool warm = false;   ///< Loaded from disk with a matching fingerprint
+};
+
+/// On-disk cache of schema and query metadata for warm service starts.
+///
+/// Serves Connection::describeQuery(), listProcedures(), describeProcedure()
+/// and SchemaInspector::getAllTables() from a JSON file written by an
+/// earlier run, as long as the database, connection charset / dialect
+/// (Connection::getTemplateScope()) and schema fingerprint are unchanged.
+/// Opening costs one single-row query; a warm start prepares nothing.
+/// Misses go to the server and are kept; save() writes them back.
+///
+/// The fingerprint hashes, server-side, the metadata that shapes these
+/// results: relation formats, relation fields, user domains, indices,
+/// constraints, procedures and functions with their parameters. Procedure
+/// and function bodies are not part of it (they do not change a describe).
+///
+/// describeQuery() entries are keyed by normalized SQL (SqlKey: case,
+/// whitespace and comments do not matter). Not thread-safe, like the
+/// Connection it uses.
+class MetadataCache {
+public:
+    MetadataCache(fbpp::core::Connection& connection, std::string path);
+
+    fbpp::core::Connection::QueryMetadataInfo describeQuery(const std::string& sql);
+    std::vector<fbpp::core::ProcedureInfo> listProcedures();
+    fbpp::core::ProcedureInfo describeProcedure(const std::string& name,
+                                                const std::string& packageName = std::string());
+    std::vector<TableInfo> getAllTables();
+
+    /// Write the file if anything changed since it was loaded (written to a
+    /// temporary file first, then renamed over `path`).
+    void save();
+
+    /// Recompute the fingerprint, e.g. after DDL; drops every entry when it
+    /// changed. Returns true in that case.
+    bool revalidate();
+
+    /// Drop every entry (the file is rewritten by the next save()).
+    void clear();
+
+    const std::string& fingerprint() const noexcept { return fingerprint_; }
+    MetadataCacheStats stats() const noexcept { return stats_; }
+
+    /// One-row query over RDB$* (no prepare of user SQL); equal values mean
+    /// the cached metadata is still valid.
+    static std::string schemaFingerprint(fbpp::core::Connection& connection);
+
+private:
+    struct QueryEntry {
+        std::string sql;
+        fbpp::core::Connection::QueryMetadataInfo info;
+    };
+
+    void load();
+
+    fbpp::core::Connection& connection_;
+    std::string path_;
+    std::string fingerprint_;
+    bool dirty_ = false;
+    MetadataCacheStats stats_;
+
+    std::unordered_multimap<std::uint64_t, QueryEntry> queries_;   // By SqlKey hash
+    std::optional<std::vector<fbpp::core::ProcedureInfo>> procedures_;
+    std::unordered_map<std::string, fbpp::core::ProcedureInfo> described_;   // "PACKAGE.NAME"
+    std::optional<std::vector<TableInfo>> tables_;
+};
+
+} // namespace fbpp::schema
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/row.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace fbpp::schema {
+
+/// How ParallelScan splits the rows.
+enum class ScanPartitioning {
+    automatic,   ///< Integer single-column primary key if there is one, else DB_KEY
+    key,         ///< Integer ranges of ParallelScanOptions::keyColumn (or the PK)
+    dbKey        ///< RDB$DB_KEY ranges by pointer page (Firebird 4+, tables only)
+};
+
+struct ParallelScanOptions {
+    unsigned partitions = 4;          ///< Connections and worker threads
+    ScanPartitioning partitioning = ScanPartitioning::automatic;
+    /// Range column. Required for a query source; for a table source the
+    /// single-column SMALLINT / INTEGER / BIGINT primary key is used when empty.
+    std::string keyColumn;
+    std::string columns = "*";        ///< Select list of every partition
+    std::string where;                ///< Extra condition AND-ed to every partition
+    unsigned prefetch = 256;          ///< ResultSet::setPrefetch() per partition
+    /// Start every partition at the coordinator's snapshot number
+    /// (isc_tpb_at_snapshot_number, Firebird 4+). Without server support
+    /// each partition reads its own snapshot and the result says so.
+    bool shareSnapshot = true;
+    std::size_t mergeBlockRows = 256; ///< runMerged(): rows per block handed over
+};
+
+struct ParallelScanPartition {
+    std::string predicate;            ///< Range condition of the partition
+    std::uint64_t rows = 0;
+    std::string error;                ///< Connect / prepare / fetch / sink failure
+    std::chrono::steady_clock::duration elapsed{};
+};
+
+struct ParallelScanResult {
+    std::uint64_t rows = 0;
+    std::vector<ParallelScanPartition> partitions;
+    /// Snapshot every partition read; nullopt = independent snapshots
+    std::optional<std::uint64_t> snapshotNumber;
+    std::chrono::steady_clock::duration elapsed{};
+
+    bool ok() const;
+
+    double rowsPerSecond() const {
+        const double seconds = std::chrono::duration<double>(elapsed).count();
+        return seconds > 0 ? static_cast<double>(rows) / seconds : 0.0;
+    }
+};
+
+/// Full scan of one table or query split into key ranges read concurrently.
+///
+/// A coordinator connection starts a read-only snapshot, reads its
+/// snapshot number and the key bounds, and cuts the range into
+/// `partitions` predicates: equal integer ranges of the partition key, or
+/// equal runs of pointer pages via MAKE_DBKEY for RDB$DB_KEY. Each
+/// partition then runs on its own connection and thread, in a read-only
+/// snapshot transaction started at the coordinator's snapshot number, so
+/// all partitions together see one consistent state of the database. The
+/// coordinator transaction stays open until the scan ends.
+///
+///   fbpp::schema::ParallelScan scan(params, "ORDERS");
+///   auto result = scan.run([&](unsigned part, const fbpp::core::RowView& row) {
+///       writers[part].write(row);                // concurrent, one thread per part
+///   });
+///   scan.runMerged([&](const fbpp::core::RowView& row) { out.write(row); });
+///
+/// A query source ("SELECT ...") is wrapped as a derived table and needs
+/// an explicit keyColumn of that query's output. Rows arrive in no global
+/// order.
+class ParallelScan {
+public:
+    /// Opens one connection; called for the coordinator and once per partition
+    using ConnectionFactory = std::function<std::unique_ptr<fbpp::core::Connection>()>;
+    /// Concurrent sink: called on the partition's thread
+    using PartitionSink = std::function<void(unsigned partition, const fbpp::core::RowView& row)>;
+    /// Merged sink: called on the thread of runMerged()
+    using RowSink = std::function<void(const fbpp::core::RowView& row)>;
+
+    ParallelScan(ConnectionFactory factory, std::string source, ParallelScanOptions options = {});
+    ParallelScan(const fbpp::core::ConnectionParams& params, std::string source,
+                 ParallelScanOptions options = {});
+
+    /// Partition predicates the next run would use (opens the coordinator)
+    std::vector<std::string> plan();
+
+    /// Scan with `sink` called concurrently from every partition thread
+    ParallelScanResult run(const PartitionSink& sink);
+
+    /// Scan with every row handed to `sink` on the calling thread.
+    /// Rows are copied in blocks; the RowView has no transaction, so
+    /// BLOB contents cannot be read from it. A sink exception stops the
+    /// scan and is rethrown.
+    ParallelScanResult runMerged(const RowSink& sink);
+
+private:
+    struct Plan;
+
+    Plan makePlan(fbpp::core::Connection& coordinator);
+    ParallelScanResult execute(const PartitionSink& sink);
+
+    ConnectionFactory factory_;
+    std::string source_;
+    ParallelScanOptions options_;
+};
+
+} // namespace fbpp::schema
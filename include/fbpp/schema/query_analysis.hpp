@@ -3,6 +3,8 @@
 #include "fbpp/core/message_metadata.hpp"
 
 #include <cstddef>
+#include <cstdint>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -34,6 +36,23 @@ struct QueryResultFieldInfo {
     std::size_t ordinal = 0;
 };
 
+/// A full table scan (NATURAL) found in a statement plan.
+struct PlanScan {
+    std::string table;
+    /// Row estimate from the relation's unique index selectivity
+    /// (1 / RDB$STATISTICS); empty when there is no such index or its
+    /// statistics were never computed.
+    std::optional<std::uint64_t> estimatedRows;
+    bool large = false;   ///< estimatedRows >= QueryAnalysisOptions::largeTableRows
+};
+
+struct QueryAnalysisOptions {
+    /// Fetch the detailed plan (Statement::getPlan(true)) and list its
+    /// full table scans.
+    bool capturePlan = false;
+    std::uint64_t largeTableRows = 10000;
+};
+
 struct QueryAnalysis {
     std::string originalSql;
     std::string positionalSql;
@@ -41,6 +60,8 @@ struct QueryAnalysis {
     bool hasNamedParameters = false;
     std::vector<QueryParameterInfo> inputParams;
     std::vector<QueryResultFieldInfo> outputFields;
+    std::string plan;                     ///< With QueryAnalysisOptions::capturePlan
+    std::vector<PlanScan> naturalScans;   ///< Likewise, in plan order, one per table
 };
 
 } // namespace fbpp::schema
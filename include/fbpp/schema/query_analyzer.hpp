@@ -3,7 +3,11 @@
 #include "fbpp/schema/query_analysis.hpp"
 #include "fbpp/core/connection.hpp"
 
+#include <cstdint>
+#include <optional>
+#include <string>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace fbpp::schema {
@@ -15,6 +19,11 @@ public:
     /// Full analysis: kind, named-param substitution, input params, output fields.
     QueryAnalysis analyze(std::string_view sql) const;
 
+    /// Same, plus the detailed plan and its NATURAL scans when
+    /// options.capturePlan is set. Row estimates are looked up once per
+    /// table for the lifetime of the analyzer.
+    QueryAnalysis analyze(std::string_view sql, const QueryAnalysisOptions& options) const;
+
     /// Convenience: input params only (calls analyze internally).
     std::vector<QueryParameterInfo> analyzeInputParams(std::string_view sql) const;
 
@@ -25,8 +34,16 @@ public:
     /// Public and static so callers can use it without a connection.
     static QueryKind classifyQuery(std::string_view sql);
 
+    /// Tables read by a full scan in a plan, in order and without repeats:
+    /// `Table "X" ... Full Scan` lines of a detailed plan, or `X NATURAL`
+    /// items of a legacy one (which name the alias, if any).
+    static std::vector<std::string> naturalScanTables(std::string_view plan);
+
 private:
+    std::optional<std::uint64_t> estimatedRows(const std::string& table) const;
+
     fbpp::core::Connection& connection_;
+    mutable std::unordered_map<std::string, std::optional<std::uint64_t>> rowEstimates_;
 };
 
 } // namespace fbpp::schema
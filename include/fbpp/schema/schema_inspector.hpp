@@ -13,7 +13,8 @@ namespace fbpp::schema {
 
 /// Read-only schema introspection via Firebird RDB$* system tables.
 ///
-/// Each method opens its own transaction internally (StartTransaction / Commit).
+/// Each method opens its own transaction internally (StartTransaction / Commit);
+/// getAllTables() reads everything in one read-only transaction instead.
 /// The SchemaInspector holds only a reference to the Connection and does not
 /// cache or hold any Firebird resources between calls.
 ///
@@ -47,6 +48,19 @@ public:
     /// relationType == RelationType::unknown and empty collections.
     TableInfo getTableInfo(std::string_view name) const;
 
+    /// Returns getTableInfo() for every user table and view, sorted by name.
+    /// One read-only snapshot transaction and four set-based queries
+    /// (relations, columns, indexes with segments, constraints with their
+    /// columns and FK targets), however many relations there are.
+    std::vector<TableInfo> getAllTables() const;
+
+    /// Same, with the relations split into contiguous name ranges, one per
+    /// connection, loaded concurrently on a thread per connection. All
+    /// connections must be attached to the same database and idle for the
+    /// duration of the call. Each range is read in its own snapshot, so
+    /// run it while the schema is not being changed.
+    static std::vector<TableInfo> getAllTables(const std::vector<fbpp::core::Connection*>& connections);
+
     // ---- Stored procedures -----------------------------------------------
 
     /// Returns names of all user stored procedures, sorted alphabetically.
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "fbpp/core/connection.hpp"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace fbpp::schema {
+
+struct SequenceAllocatorOptions {
+    /// IDs reserved per GEN_ID round trip
+    std::uint32_t blockSize = 1000;
+    /// Start reserving the next block when this many IDs are left in the
+    /// current one; 0 = blockSize / 4
+    std::uint32_t lowWater = 0;
+    /// Reserve ahead on a background thread; false = the caller that runs
+    /// out reserves the next block itself
+    bool asyncRefill = true;
+};
+
+struct SequenceAllocatorStats {
+    std::uint64_t issued = 0;       ///< IDs handed out
+    std::uint64_t blocks = 0;       ///< GEN_ID round trips
+    std::uint64_t stalls = 0;       ///< next() calls that waited for a block
+    std::uint64_t skipped = 0;      ///< IDs given up to a lapped reader (gaps)
+};
+
+/// Hands out values of one sequence from blocks reserved with a single
+/// GEN_ID(seq, blockSize * increment).
+///
+///   fbpp::schema::SequenceAllocator ids(params, "EVENT_SEQ");
+///   rows.emplace_back(ids.next(), payload);          // any thread
+///
+/// The sequence is looked up once with SchemaInspector::getSequences();
+/// its increment is the step between IDs, so next() returns what NEXT
+/// VALUE FOR would have, only not necessarily in the same order across
+/// clients. The allocator owns one connection for its round trips.
+///
+/// next() is one atomic increment and a seqlock read of the block it lands
+/// in; no lock unless the block is not reserved yet. When the current block
+/// reaches lowWater, the next one is reserved on a background thread, so
+/// steady callers never wait on the server. IDs are unique but not gap-free:
+/// unused values of the blocks still held at destruction are lost, as they
+/// would be after a rollback.
+class SequenceAllocator {
+public:
+    using ConnectionFactory = std::function<std::unique_ptr<fbpp::core::Connection>()>;
+
+    SequenceAllocator(ConnectionFactory factory, std::string sequence,
+                      SequenceAllocatorOptions options = {});
+    SequenceAllocator(const fbpp::core::ConnectionParams& params, std::string sequence,
+                      SequenceAllocatorOptions options = {});
+    ~SequenceAllocator();
+
+    SequenceAllocator(const SequenceAllocator&) = delete;
+    SequenceAllocator& operator=(const SequenceAllocator&) = delete;
+
+    /// Next unused value; thread-safe. Throws FirebirdException if a block
+    /// has to be reserved and that fails.
+    std::int64_t next();
+
+    /// `count` values into `out`
+    void next(std::int64_t* out, std::size_t count);
+
+    const std::string& sequence() const noexcept { return sequence_; }
+    std::int64_t increment() const noexcept { return increment_; }
+    SequenceAllocatorStats stats() const noexcept;
+
+private:
+    // Block k lives in slot k % kSlots; `block` is its number, published
+    // after `base` (seqlock), kNoBlock while the slot is rewritten
+    static constexpr std::size_t kSlots = 64;
+    static constexpr std::uint64_t kNoBlock = ~std::uint64_t{0};
+
+    struct Slot {
+        std::atomic<std::uint64_t> block{kNoBlock};
+        std::atomic<std::int64_t> base{0};
+    };
+
+    // Reserve and publish blocks until `through` is; with mutex_ held
+    void reserveThrough(std::uint64_t through);
+    void refillLoop();
+
+    std::unique_ptr<fbpp::core::Connection> connection_;
+    std::string sequence_;
+    SequenceAllocatorOptions options_;
+    std::int64_t increment_ = 1;
+
+    std::array<Slot, kSlots> slots_;
+    std::atomic<std::uint64_t> ticket_{0};
+    std::uint64_t published_ = 0;                 // Blocks reserved so far (mutex_)
+    std::atomic<std::uint64_t> wanted_{0};        // Background target: publish through this
+
+    std::atomic<std::uint64_t> stalls_{0};
+    std::atomic<std::uint64_t> skipped_{0};
+    std::atomic<std::uint64_t> blocks_{0};
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stop_ = false;
+    std::thread refiller_;
+};
+
+} // namespace fbpp::schema
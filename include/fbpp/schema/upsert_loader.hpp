@@ -0,0 +1,173 @@
+#pragma once
+
+#include "fbpp/core/bulk_loader.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/staging_table.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fbpp::schema {
+
+/// How UpsertLoader writes the rows.
+enum class UpsertMode {
+    /// Batch into a global temporary staging table, then one MERGE per
+    /// flush; reports inserted and updated rows separately
+    merge,
+    /// Batch `UPDATE OR INSERT ... MATCHING` straight into the table;
+    /// one round trip less per flush, but only the total is known
+    updateOrInsert
+};
+
+struct UpsertOptions {
+    UpsertMode mode = UpsertMode::merge;
+    /// Row columns, in the order of the row's fields; empty = every
+    /// non-computed column of the table by position
+    std::vector<std::string> columns;
+    /// Columns identifying a row; empty = the table's primary key
+    std::vector<std::string> matching;
+    /// merge: staging table name; empty = the StagingTable default, named
+    /// after the column types, so an altered table gets a new one
+    std::string stagingTable;
+    /// Flush / commit policy of the underlying BulkLoader (onFlush is taken)
+    fbpp::core::BulkLoaderOptions load;
+};
+
+/// Running totals of an UpsertLoader.
+struct UpsertStats {
+    std::uint64_t rows = 0;       ///< Rows sent, failed ones included
+    std::uint64_t failed = 0;     ///< Rows rejected by the batch
+    std::uint64_t affected = 0;   ///< Target rows inserted or updated
+    std::optional<std::uint64_t> inserted;   ///< merge mode only
+    std::optional<std::uint64_t> updated;    ///< merge mode only
+    unsigned flushes = 0;
+};
+
+/// Statements of one upsert target, built from SchemaInspector metadata.
+///
+/// updateOrInsert batches `UPDATE OR INSERT INTO t (cols) VALUES (?, ...)
+/// MATCHING (keys)`. merge batches plain INSERTs into a StagingTable (a
+/// GTT created on first use with the target's column types) and,
+/// after every flush, counts the staged keys already in the target, runs
+/// `MERGE INTO t USING staging` and empties the staging table. A key given
+/// twice within one flush makes that MERGE fail; updateOrInsert applies
+/// such rows in order.
+class UpsertPlan {
+public:
+    UpsertPlan(fbpp::core::Connection& connection, std::string table,
+               const UpsertOptions& options);
+
+    const std::string& table() const noexcept { return table_; }
+    const std::vector<std::string>& columns() const noexcept { return columns_; }
+    const std::vector<std::string>& matching() const noexcept { return matching_; }
+    UpsertMode mode() const noexcept { return mode_; }
+    /// Empty in updateOrInsert mode
+    const std::string& stagingTable() const noexcept { return staging_; }
+
+    /// The statement rows are batched into
+    const std::shared_ptr<fbpp::core::Statement>& loadStatement() const noexcept { return load_; }
+    const std::string& loadSql() const noexcept { return loadSql_; }
+    /// merge: the MERGE run after each flush; empty in updateOrInsert mode
+    const std::string& mergeSql() const noexcept { return mergeSql_; }
+
+    /// Account for one executed batch; in merge mode apply it to the table
+    void apply(fbpp::core::Transaction& transaction, const fbpp::core::BatchResult& flushed,
+               UpsertStats& stats) const;
+
+private:
+    void prepareMerge(fbpp::core::Connection& connection,
+                      std::vector<fbpp::core::StagingColumn> staged, const std::string& stagingName);
+
+    std::string table_;
+    std::vector<std::string> columns_;
+    std::vector<std::string> matching_;
+    UpsertMode mode_;
+    bool updates_ = false;           // Some column outside `matching` to update
+    std::string staging_;
+    std::string loadSql_;
+    std::string mergeSql_;
+    std::shared_ptr<fbpp::core::Statement> load_;
+    std::shared_ptr<fbpp::core::Statement> matched_;   // merge: COUNT of staged keys in the table
+    std::shared_ptr<fbpp::core::Statement> merge_;
+    std::shared_ptr<fbpp::core::Statement> clear_;
+};
+
+/// Bulk upsert of rows of type T, streamed through a BulkLoader.
+///
+///   fbpp::schema::UpsertLoader<std::tuple<int64_t, std::string>> up(conn, tx, "PRODUCT");
+///   up.addMany(rows);                // flushed in chunks as BulkLoader does
+///   auto stats = up.finish();        // stats.inserted / stats.updated
+///   tx->Commit();
+///
+/// T is anything Batch::addMany() packs, with its fields in the order of
+/// UpsertPlan::columns(). The loader uses `transaction` for every
+/// statement and never commits beyond load.commitEveryFlushes.
+template<typename T>
+class UpsertLoader {
+public:
+    UpsertLoader(fbpp::core::Connection& connection,
+                 std::shared_ptr<fbpp::core::Transaction> transaction,
+                 std::string table, UpsertOptions options = {})
+        : plan_(connection, std::move(table), options),
+          transaction_(std::move(transaction)),
+          loader_(plan_.loadStatement(), transaction_, hooked(std::move(options.load))) {
+        if (plan_.mode() == UpsertMode::merge) {
+            stats_.inserted = 0;
+            stats_.updated = 0;
+        }
+    }
+
+    // The BulkLoader's flush hook points at this object
+    UpsertLoader(const UpsertLoader&) = delete;
+    UpsertLoader& operator=(const UpsertLoader&) = delete;
+
+    void add(const T& row) { loader_.add(row); }
+
+    template<std::input_iterator It, std::sentinel_for<It> Sentinel>
+    void addMany(It first, Sentinel last) {
+        loader_.addMany(std::move(first), std::move(last));
+    }
+
+    template<std::ranges::input_range Range>
+    void addMany(Range&& rows) {
+        loader_.addMany(std::forward<Range>(rows));
+    }
+
+    /// Execute and apply the rows added since the last flush
+    void flush() { loader_.flush(); }
+
+    /// Flush the remaining rows and return the totals; committing is up
+    /// to the caller
+    const UpsertStats& finish() {
+        loader_.finish();
+        return stats_;
+    }
+
+    const UpsertStats& stats() const noexcept { return stats_; }
+    const UpsertPlan& plan() const noexcept { return plan_; }
+    /// Merged batch result: per-row status and errors of the loaded rows
+    const fbpp::core::BatchResult& result() const { return loader_.result(); }
+
+private:
+    fbpp::core::BulkLoaderOptions hooked(fbpp::core::BulkLoaderOptions options) {
+        options.onFlush = [this](const fbpp::core::BatchResult& flushed) {
+            plan_.apply(*transaction_, flushed, stats_);
+        };
+        return options;
+    }
+
+    UpsertPlan plan_;
+    std::shared_ptr<fbpp::core::Transaction> transaction_;
+    UpsertStats stats_;
+    fbpp::core::BulkLoader<T> loader_;
+};
+
+} // namespace fbpp::schema
@@ -0,0 +1,204 @@
+#pragma once
+
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/pack_utils.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/transaction_options.hpp"
+#include "fbpp/schema/upsert_loader.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace fbpp::schema {
+
+struct WatermarkSyncOptions {
+    /// Column that grows with every change (CHANGED_AT, a version number)
+    std::string watermarkColumn;
+    /// Copied columns, in the order of the row's fields; empty = every
+    /// non-computed column of the source table by position. Must include
+    /// the watermark column.
+    std::vector<std::string> columns;
+    /// Table written on the target; empty = the source table's name
+    std::string targetTable;
+    /// Key of the sync's row in the state table; empty = the table name
+    std::string name;
+    /// Target table holding one watermark per sync, created on first use
+    std::string stateTable = "FBPP_SYNC_WATERMARK";
+    /// Rows per target commit; a run of equal watermarks is never split
+    std::size_t chunkRows = 10000;
+    /// ResultSet::setPrefetch() of the source cursor
+    unsigned prefetchRows = 512;
+    /// How rows are written to the target (columns is taken)
+    UpsertOptions apply;
+};
+
+/// Totals of one WatermarkSync::run().
+struct WatermarkSyncStats {
+    std::uint64_t rows = 0;       ///< Changed rows read from the source
+    std::uint64_t affected = 0;   ///< Target rows inserted or updated
+    unsigned chunks = 0;          ///< Target commits, each with its watermark
+};
+
+/// Statements of one watermark sync.
+///
+/// The source query is `SELECT cols FROM t WHERE wm > ? ORDER BY wm` (the
+/// first run copies every row whose watermark is not NULL). The watermark
+/// is kept in the target's state table as text, cast through the
+/// column's own type (`TYPE OF COLUMN t.wm`) in the target table.
+class WatermarkSyncPlan {
+public:
+    WatermarkSyncPlan(fbpp::core::Connection& source, fbpp::core::Connection& target,
+                      std::string table, const WatermarkSyncOptions& options);
+
+    const std::string& table() const noexcept { return table_; }
+    const std::string& targetTable() const noexcept { return targetTable_; }
+    const std::string& name() const noexcept { return name_; }
+    const std::vector<std::string>& columns() const noexcept { return columns_; }
+    /// Output column of the watermark
+    unsigned watermarkIndex() const noexcept { return watermarkIndex_; }
+
+    const std::string& changedSql() const noexcept { return changedSql_; }
+    const std::shared_ptr<fbpp::core::Statement>& everything() const noexcept { return all_; }
+    const std::shared_ptr<fbpp::core::Statement>& changed() const noexcept { return changed_; }
+    /// Target: the stored watermark of name(), one row or none
+    const std::shared_ptr<fbpp::core::Statement>& load() const noexcept { return load_; }
+    /// Target: store (name, watermark)
+    const std::shared_ptr<fbpp::core::Statement>& save() const noexcept { return save_; }
+
+    /// Raw bytes of the watermark in `view`; equal values give equal bytes
+    std::string watermarkBytes(const fbpp::core::RowView& view) const;
+
+private:
+    std::string table_;
+    std::string targetTable_;
+    std::string name_;
+    std::vector<std::string> columns_;
+    unsigned watermarkIndex_ = 0;
+    std::string changedSql_;
+    std::shared_ptr<fbpp::core::Statement> all_;
+    std::shared_ptr<fbpp::core::Statement> changed_;
+    std::shared_ptr<fbpp::core::Statement> load_;
+    std::shared_ptr<fbpp::core::Statement> save_;
+};
+
+/// Incremental copy of one table by a watermark column.
+///
+///   fbpp::schema::WatermarkSyncOptions options;
+///   options.watermarkColumn = "CHANGED_AT";
+///   fbpp::schema::WatermarkSync<std::tuple<int64_t, std::string, Timestamp>, Timestamp>
+///       sync(oltp, reporting, "ACCOUNT", options);
+///   sync.run();   // on every poll
+///
+/// run() reads the rows changed since the stored watermark through one
+/// prefetching cursor in a read-only snapshot of the source, and upserts
+/// them into the target table with an UpsertLoader, chunkRows at a time.
+/// Each chunk is committed on the target together with its last
+/// watermark, so a failed run resumes after the last committed chunk and
+/// never skips or loses a row, only writes some again. Work is
+/// proportional to the rows changed, not to the table.
+///
+/// Row is anything ResultSet::fetch() unpacks, with its fields in the order
+/// of WatermarkSyncPlan::columns(); Watermark is the watermark column's
+/// type. A row committed on the source with a watermark below one already
+/// synced (a long transaction stamped before it committed) is missed, as
+/// with any watermark poll.
+template<typename Row, typename Watermark>
+class WatermarkSync {
+public:
+    WatermarkSync(fbpp::core::Connection& source, fbpp::core::Connection& target,
+                  std::string table, WatermarkSyncOptions options)
+        : source_(source),
+          target_(target),
+          options_(std::move(options)),
+          plan_(source, target, std::move(table), options_) {
+        options_.apply.columns = plan_.columns();
+    }
+
+    /// Copy what changed since the last run
+    WatermarkSyncStats run() {
+        WatermarkSyncStats stats;
+        auto targetTx = target_.StartTransaction();
+        const std::optional<Watermark> from = stored(*targetTx);
+
+        fbpp::core::TransactionOptions snapshot;
+        snapshot.readOnly = true;
+        auto sourceTx = source_.StartTransaction(snapshot);
+        std::unique_ptr<fbpp::core::ResultSet> cursor =
+            from ? sourceTx->openCursor(plan_.changed(), std::make_tuple(*from))
+                 : sourceTx->openCursor(plan_.everything());
+        cursor->setPrefetch(options_.prefetchRows);
+
+        UpsertLoader<Row> loader(target_, targetTx, plan_.targetTable(), options_.apply);
+        const std::size_t chunkRows = options_.chunkRows > 0 ? options_.chunkRows : 1;
+        std::vector<Row> chunk;
+        chunk.reserve(chunkRows);
+        std::optional<Watermark> last;
+        std::string lastBytes;
+        for (const auto& view : cursor->rows()) {
+            std::string bytes = plan_.watermarkBytes(view);
+            if (chunk.size() >= chunkRows && bytes != lastBytes) {
+                commitChunk(loader, *targetTx, chunk, *last, stats);
+            }
+            chunk.push_back(fbpp::core::unpack<Row>(view.data(), &view.metadata(),
+                                                    view.transaction()));
+            last = view.get<Watermark>(plan_.watermarkIndex());
+            lastBytes = std::move(bytes);
+        }
+        cursor->close();
+        sourceTx->Commit();
+
+        if (!chunk.empty()) {
+            commitChunk(loader, *targetTx, chunk, *last, stats);
+        }
+        stats.affected = loader.finish().affected;
+        targetTx->Commit();
+        return stats;
+    }
+
+    /// The watermark of the last committed chunk; nullopt before the first
+    std::optional<Watermark> watermark() {
+        auto tx = target_.StartTransaction();
+        auto result = stored(*tx);
+        tx->Commit();
+        return result;
+    }
+
+    const WatermarkSyncPlan& plan() const noexcept { return plan_; }
+
+private:
+    std::optional<Watermark> stored(fbpp::core::Transaction& transaction) {
+        auto rs = transaction.openCursor(plan_.load(), std::make_tuple(plan_.name()));
+        std::tuple<std::optional<Watermark>> row;
+        const bool found = rs->fetch(row);
+        rs->close();
+        return found ? std::get<0>(row) : std::nullopt;
+    }
+
+    void commitChunk(UpsertLoader<Row>& loader, fbpp::core::Transaction& transaction,
+                     std::vector<Row>& chunk, const Watermark& watermark,
+                     WatermarkSyncStats& stats) {
+        loader.addMany(chunk);
+        loader.flush();
+        transaction.execute(plan_.save(), std::make_tuple(plan_.name(), watermark));
+        transaction.CommitRetaining();
+        stats.rows += chunk.size();
+        ++stats.chunks;
+        chunk.clear();
+    }
+
+    fbpp::core::Connection& source_;
+    fbpp::core::Connection& target_;
+    WatermarkSyncOptions options_;
+    WatermarkSyncPlan plan_;
+};
+
+} // namespace fbpp::schema
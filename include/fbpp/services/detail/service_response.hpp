@@ -0,0 +1,58 @@
+#pragma once
+
+#include "fbpp/core/exception.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace fbpp::services::detail {
+
+// Cursor over an IService::query() response: a tag byte per item, then a
+// 2-byte length and bytes (text and data items), a 4-byte integer
+// (isc_info_svc_stdin) or nothing (isc_info_end and the status tags).
+// Integers are little-endian regardless of the platform.
+class ServiceResponse {
+public:
+    ServiceResponse(const unsigned char* data, size_t size) noexcept
+        : pos_(data), end_(data + size) {}
+
+    bool atEnd() const noexcept { return pos_ >= end_; }
+
+    unsigned char tag() {
+        need(1);
+        return *pos_++;
+    }
+
+    std::string_view bytes() {
+        const size_t length = integer(2);
+        need(length);
+        std::string_view value(reinterpret_cast<const char*>(pos_), length);
+        pos_ += length;
+        return value;
+    }
+
+    uint32_t int4() { return static_cast<uint32_t>(integer(4)); }
+
+private:
+    size_t integer(size_t width) {
+        need(width);
+        size_t value = 0;
+        for (size_t i = 0; i < width; ++i) {
+            value |= static_cast<size_t>(pos_[i]) << (8 * i);
+        }
+        pos_ += width;
+        return value;
+    }
+
+    void need(size_t count) const {
+        if (static_cast<size_t>(end_ - pos_) < count) {
+            throw core::FirebirdException("Malformed service query response");
+        }
+    }
+
+    const unsigned char* pos_;
+    const unsigned char* end_;
+};
+
+} // namespace fbpp::services::detail
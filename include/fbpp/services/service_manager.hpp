@@ -0,0 +1,132 @@
+#pragma once
+
+// ServiceManager — RAII over a Firebird service manager attachment.
+//
+// Runs gbak and gfix-style maintenance (sweep, sweep interval) on the
+// server. gbak runs either between server-side files or streamed
+// over the service connection itself, so the backup never needs space or
+// a share on the database host:
+//
+//   ServiceManager svc({"dbhost", "SYSDBA", password});
+//   BackupOptions options;
+//   options.parallelWorkers = 4;                 // Firebird 5
+//   svc.backupToFile("/data/app.fdb", "app.fbk", options);
+//   svc.restoreFromFile("app.fbk", "/data/app_copy.fdb");
+//
+// A streamed backup is gbak writing to "stdout" and the client draining it
+// with isc_info_svc_to_eof; a streamed restore is gbak reading "stdin",
+// with the client answering each isc_info_svc_stdin request. Neither adds
+// round trips of its own: progress is counted from the chunks and lines
+// that already travel, and reported through a callback per chunk or line.
+//
+// One ServiceManager runs one action at a time and is not thread-safe.
+
+#include "fbpp/core/detail/firebird_raii.hpp"
+#include "fbpp/core/firebird_compat.hpp"
+#include "fbpp/services/types.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace fbpp::services {
+
+class ServiceManager {
+public:
+    /**
+     * @brief Attach the service manager of params.server
+     * @throws core::FirebirdException if the attach fails
+     */
+    explicit ServiceManager(const ServiceConnectParams& params);
+    ~ServiceManager();
+
+    ServiceManager(const ServiceManager&) = delete;
+    ServiceManager& operator=(const ServiceManager&) = delete;
+
+    /// Server version string, e.g. "LI-V5.0.1.1469 Firebird 5.0"
+    std::string getServerVersion();
+
+    /**
+     * @brief Back up `database` into `backupFile`, both paths on the server
+     *
+     * With options.verbose every line gbak reports goes to `onLine`.
+     */
+    void backup(const std::string& database, const std::string& backupFile,
+                const BackupOptions& options = {}, const LineCallback& onLine = {});
+
+    /// Restore server-side `backupFile` into `database`
+    void restore(const std::string& backupFile, const std::string& database,
+                 const RestoreOptions& options = {}, const LineCallback& onLine = {});
+
+    /**
+     * @brief Back up `database` (server path) streaming the backup to `sink`
+     *
+     * options.verbose is ignored (the output channel carries the data).
+     *
+     * @return Backup bytes received
+     */
+    uint64_t backupTo(const std::string& database, const BackupSink& sink,
+                      const BackupOptions& options = {}, const ProgressCallback& progress = {});
+
+    /**
+     * @brief Restore a backup read from `source` into `database` (server path)
+     *
+     * Verbose lines, when enabled, reach `progress` interleaved with data.
+     *
+     * @return Backup bytes sent
+     */
+    uint64_t restoreFrom(const BackupSource& source, const std::string& database,
+                         const RestoreOptions& options = {}, const ProgressCallback& progress = {});
+
+    /// backupTo() into a client-side file (created or truncated)
+    uint64_t backupToFile(const std::string& database, const std::filesystem::path& localFile,
+                          const BackupOptions& options = {}, const ProgressCallback& progress = {});
+
+    /// restoreFrom() a client-side backup file
+    uint64_t restoreFromFile(const std::filesystem::path& localFile, const std::string& database,
+                             const RestoreOptions& options = {},
+                             const ProgressCallback& progress = {});
+
+    /**
+     * @brief Sweep `database` (server path) now, as gfix -sweep
+     *
+     * @param parallelWorkers Sweep workers (isc_spb_rpr_par_workers,
+     *        Firebird 5); 0 = server ParallelWorkers
+     */
+    void sweep(const std::string& database, unsigned parallelWorkers = 0);
+
+    /// Transactions between automatic sweeps of `database`; 0 turns them off
+    void setSweepInterval(const std::string& database, unsigned interval);
+
+private:
+    Firebird::ThrowStatusWrapper& status() {
+        statusWrapper_.init();
+        return statusWrapper_;
+    }
+
+    // Builders of the backup and restore SPBs (SPB_START)
+    core::detail::XpbBuilderGuard backupSpb(const std::string& database,
+                                            const std::string& backupFile,
+                                            const BackupOptions& options, bool verbose);
+    core::detail::XpbBuilderGuard restoreSpb(const std::string& backupFile,
+                                             const std::string& database,
+                                             const RestoreOptions& options);
+
+    void start(Firebird::IXpbBuilder* spb);
+
+    // One query round trip; the response lands in response_
+    void query(const std::vector<unsigned char>& send,
+               std::initializer_list<unsigned char> receive);
+
+    // Relay output lines until the running action ends
+    void drainLines(const LineCallback& onLine);
+
+    Firebird::IService* service_ = nullptr;
+    Firebird::IStatus* status_;
+    Firebird::ThrowStatusWrapper statusWrapper_{nullptr};
+    std::vector<unsigned char> response_;
+};
+
+} // namespace fbpp::services
@@ -0,0 +1,71 @@
+#pragma once
+
+// Parameters, options and callbacks of the Services API layer (fbpp_services).
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace fbpp::services {
+
+/**
+ * @brief Where and as whom to attach the service manager
+ */
+struct ServiceConnectParams {
+    std::string server;              // host[/port]; empty = local service manager
+    std::string user = "SYSDBA";
+    std::string password;
+    std::string role;
+};
+
+/// One line of a service's text output (gbak -v); valid during the call only
+using LineCallback = std::function<void(std::string_view line)>;
+
+/// Receives a streamed backup chunk by chunk, in order
+using BackupSink = std::function<void(const uint8_t* data, size_t size)>;
+
+/// Fills up to `capacity` bytes of the backup to restore; returns 0 at the end
+using BackupSource = std::function<size_t(uint8_t* buffer, size_t capacity)>;
+
+/**
+ * @brief gbak backup switches
+ */
+struct BackupOptions {
+    // Report every object backed up. Server-side files only: a streamed
+    // backup's output channel carries the data itself
+    bool verbose = false;
+    bool metadataOnly = false;
+    bool noGarbageCollect = false;
+    // isc_spb_bkp_parallel_workers (Firebird 5); 0 = server default (ParallelWorkers)
+    unsigned parallelWorkers = 0;
+};
+
+/**
+ * @brief gbak restore switches
+ */
+struct RestoreOptions {
+    bool verbose = false;
+    // isc_spb_verbint: one progress line per this many records instead of a
+    // line per object (cheaper to relay). Takes precedence over verbose
+    unsigned verboseInterval = 0;
+    bool replace = false;            // Overwrite an existing database; false = create only
+    unsigned pageSize = 0;           // 0 = page size of the backup
+    // isc_spb_res_parallel_workers (Firebird 5); 0 = server default
+    unsigned parallelWorkers = 0;
+};
+
+/**
+ * @brief Progress of a streamed backup or restore
+ */
+struct ServiceProgress {
+    uint64_t bytes = 0;              // Backup bytes transferred so far
+    uint64_t lines = 0;              // Verbose lines received so far
+    std::string_view line;           // Line that triggered this report; empty for data
+};
+
+/// Called once per transferred chunk and once per verbose line
+using ProgressCallback = std::function<void(const ServiceProgress& progress)>;
+
+} // namespace fbpp::services
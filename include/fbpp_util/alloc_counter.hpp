@@ -0,0 +1,46 @@
+#pragma once
+
+// Heap allocation counting, for tests and benchmarks of the hot paths.
+//
+// alloc_counter.cpp replaces the global operator new / delete (every
+// form, sized and aligned included) with versions that count the calls on
+// the calling thread and forward to malloc / free. The replacement is
+// linked into a program only when the program uses AllocationCounter, so
+// the other test executables keep the default allocator:
+//
+//   AllocationCounter allocations;
+//   for (const auto& view : cursor->rows()) { ... }
+//   EXPECT_EQ(allocations.allocations(), 0u);
+//
+// Only the thread that created the counter is counted: work handed to a
+// pool thread is not seen. Memory taken with malloc directly (the client
+// library's own buffers, for one) is not counted either.
+
+#include <cstddef>
+
+namespace fbpp::util {
+
+/**
+ * @brief Allocations made by the current thread since construction or reset()
+ */
+class AllocationCounter {
+public:
+    AllocationCounter() noexcept { reset(); }
+
+    /// Start counting again from now
+    void reset() noexcept;
+
+    /// operator new calls (any form) since the start
+    std::size_t allocations() const noexcept;
+    /// operator delete calls with a non-null pointer since the start
+    std::size_t deallocations() const noexcept;
+    /// Bytes asked for by those operator new calls
+    std::size_t bytes() const noexcept;
+
+private:
+    std::size_t allocations_ = 0;
+    std::size_t deallocations_ = 0;
+    std::size_t bytes_ = 0;
+};
+
+} // namespace fbpp::util
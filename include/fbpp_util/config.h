@@ -38,11 +38,30 @@ public:
         size_t ttlMinutes = 60;          // Time-to-live for unused statements
     };
 
+    struct PoolConfig {
+        size_t minSize = 1;              // Connections kept open
+        size_t maxSize = 10;             // Connections open at most
+        unsigned prefetchRows = 0;       // Rows per prefetch window, 0 = chosen per connection
+    };
+
+    // The sections ConfigWatcher applies to running caches and pools
+    struct Tunables {
+        CacheConfig cache;
+        PoolConfig pool;
+    };
+
     static bool load(const std::string& jsonPath);
     static DbConfig& db() { return instance().db_; }
     static LoggingConfig& logging() { return instance().logging_; }
     static TestsConfig& tests() { return instance().tests_; }
     static CacheConfig& cache() { return instance().cache_; }
+    static PoolConfig& pool() { return instance().pool_; }
+
+    // Cache and pool sections of `jsonPath` over the defaults, then the
+    // environment, as load() reads them; the loaded configuration is left
+    // alone. Throws std::runtime_error for a missing file, bad JSON or a
+    // value of the wrong type.
+    static Tunables readTunables(const std::string& jsonPath);
     
 private:
     Config() = default;
@@ -54,6 +73,7 @@ private:
     DbConfig db_;
     LoggingConfig logging_;
     TestsConfig tests_;
+    PoolConfig pool_;
     CacheConfig cache_;
 };
 
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <fbpp_util/config.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fbpp::core {
+class StatementCache;
+}
+
+namespace fbpp::pool {
+class ConnectionPool;
+}
+
+namespace fbpp::util {
+
+/**
+ * Counters and last outcome of a ConfigWatcher
+ */
+struct ConfigWatcherStats {
+    uint64_t checks = 0;              // Times the file's stamp was looked at
+    uint64_t reloads = 0;             // Changed settings applied to every target
+    uint64_t unchanged = 0;           // File rewritten with the settings in effect
+    uint64_t failures = 0;            // Unreadable or rejected files; nothing applied
+    size_t caches = 0;                // Targets registered now
+    size_t pools = 0;
+    uint64_t statementsEvicted = 0;   // Dropped by lower cache sizes, all reloads
+    uint64_t connectionsClosed = 0;   // Idle connections closed by lower pool maximums
+    std::string lastError;            // Of the last failure; cleared by the next reload
+    std::chrono::system_clock::time_point lastReload{};
+    Config::Tunables applied;         // Settings in effect
+};
+
+/**
+ * Watched-config mode: edits of the "cache" and "pool" sections of a
+ * config file reach running StatementCaches and ConnectionPools without a
+ * restart.
+ *
+ *   ConfigWatcher watcher(ConfigLoader::findConfigFile("app_config.json"));
+ *   watcher.watch(pool);          // ConnectionPool
+ *   watcher.watch(cache);         // A StatementCache of your own
+ *   watcher.start(std::chrono::seconds(5));
+ *
+ * A check compares the file's modification time and size with the last
+ * ones seen. A changed file is read (Config::readTunables) and validated
+ * as a whole before anything is applied, so a half-written or invalid file
+ * changes nothing; it is counted in stats() and traced, and the next edit
+ * is tried again. Valid settings are applied to every target under one
+ * lock:
+ *
+ *   StatementCache   setEnabled / setMaxSize / setTtlMinutes
+ *   ConnectionPool   resize(min_size, max_size), and setConnectionOptions()
+ *                    with the cache section and prefetch_rows over the
+ *                    pool's current options (reaching each pooled
+ *                    connection's cache at its next checkout)
+ *
+ * Only values that differ are set. watch() applies the settings in effect
+ * to the new target, so all targets agree. Targets must stay alive until
+ * unwatch() or the watcher's destruction.
+ */
+class ConfigWatcher {
+public:
+    /// Reads `jsonPath` for the initial settings; throws as Config::readTunables
+    explicit ConfigWatcher(std::string jsonPath);
+    ~ConfigWatcher();
+
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+    void watch(core::StatementCache& cache);
+    void watch(pool::ConnectionPool& pool);
+    void unwatch(core::StatementCache& cache);
+    void unwatch(pool::ConnectionPool& pool);
+
+    /// Check the file every `interval` on a thread of the watcher's own
+    void start(std::chrono::milliseconds interval);
+    void stop();
+
+    /**
+     * Check the file now (what the thread does every interval)
+     * @return true if changed settings were applied
+     */
+    bool checkNow();
+
+    ConfigWatcherStats stats() const;
+    const std::string& path() const noexcept { return path_; }
+
+private:
+    struct Stamp {
+        bool exists = false;
+        std::filesystem::file_time_type modified{};
+        std::uintmax_t size = 0;
+
+        bool operator==(const Stamp& other) const {
+            return exists == other.exists && modified == other.modified && size == other.size;
+        }
+    };
+
+    Stamp readStamp() const;
+    // Throws std::runtime_error naming the first rejected value
+    void validate(const Config::Tunables& tunables) const;
+    void apply(core::StatementCache& cache);
+    void apply(pool::ConnectionPool& pool);
+    void run(std::chrono::milliseconds interval);
+
+    const std::string path_;
+
+    mutable std::mutex mutex_;    // Targets, stamp_ and stats_
+    std::vector<core::StatementCache*> caches_;
+    std::vector<pool::ConnectionPool*> pools_;
+    Stamp stamp_;
+    ConfigWatcherStats stats_;
+
+    std::mutex threadMutex_;
+    std::condition_variable stopping_;
+    bool stop_ = false;
+    std::thread thread_;
+};
+
+}  // namespace fbpp::util
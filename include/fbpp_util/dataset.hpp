@@ -0,0 +1,109 @@
+#pragma once
+
+// Synthetic TABLE_TEST_1 data at benchmark scale.
+//
+// The test fixtures create a handful of rows, too few to show how a cache,
+// a fetch path or an index behaves once the data outgrows memory.
+// generateDataset() fills TABLE_TEST_1 (the schema of the test fixtures,
+// every extended type included) to millions of rows through BulkLoader:
+//
+//   fbpp::util::DatasetOptions options;
+//   options.rows = 10'000'000;
+//   options.seed = 42;
+//   options.blobRatio = 0.25;           // BLOB-heavy fetches
+//   fbpp::util::generateDataset(connection, options);
+//
+// Row `index` is a pure function of (seed, index): F_INTEGER is index + 1
+// and every other column comes from a counter-based generator keyed by
+// both. The same seed therefore gives the same table whatever the chunk
+// size or the number of runs it took, and a load continues where it
+// stopped with firstRow = the rows already there. The fbpp_datagen tool
+// wraps it; fbpp_loadgen seeds its table the same way.
+//
+// BLOB contents are created per row with Transaction::createBlob (batch
+// BLOBs do not survive a flush boundary), so BLOB rows cost a round trip
+// each: blobRatio trades load speed for BLOB volume.
+
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/extended_types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <tuple>
+
+namespace fbpp::util {
+
+/// Columns of TABLE_TEST_1 in the order of kDatasetInsertSql
+using DatasetRow = std::tuple<
+    int32_t,                                       // F_INTEGER = index + 1
+    std::optional<int64_t>,                        // F_BIGINT
+    std::optional<bool>,                           // F_BOOLEAN
+    std::optional<std::string>,                    // F_CHAR
+    std::optional<fbpp::core::Date>,               // F_DATE
+    std::optional<fbpp::core::DecFloat34>,         // F_DECFLOAT
+    std::optional<fbpp::core::Int128>,             // F_DECIMAL (raw, scale 8)
+    std::optional<double>,                         // F_DOUBLE_PRECISION
+    std::optional<float>,                          // F_FLOAT
+    std::optional<fbpp::core::Int128>,             // F_INT128
+    std::optional<double>,                         // F_NUMERIC
+    std::optional<int16_t>,                        // F_SMALINT
+    std::optional<fbpp::core::Time>,               // F_TIME
+    std::optional<fbpp::core::TimeTz>,             // F_TIME_TZ
+    std::optional<fbpp::core::Timestamp>,          // F_TIMESHTAMP
+    std::optional<fbpp::core::TimestampTz>,        // F_TIMESHTAMP_TZ
+    std::optional<std::string>,                    // F_VARCHAR
+    std::optional<fbpp::core::Blob>,               // F_BLOB_B
+    std::optional<fbpp::core::Blob>>;              // F_BLOB_T
+
+/// INSERT taking a DatasetRow (ID comes from the identity, F_NULL stays NULL)
+extern const char* const kDatasetInsertSql;
+
+struct DatasetOptions {
+    uint64_t rows = 1'000'000;     // Rows to add
+    uint64_t seed = 1;
+    uint64_t firstRow = 0;         // Index of the first row added
+    double nullRatio = 0.05;       // Share of NULLs in each nullable column
+    double blobRatio = 0.1;        // Share of rows with both BLOBs set
+    size_t blobBytes = 1024;       // Mean BLOB size; each is 0.5x..1.5x
+    size_t chunkRows = 10'000;     // Rows generated, loaded and committed at once
+    size_t flushBytes = 8 * 1024 * 1024;   // BulkLoaderOptions::flushBytes
+    bool pipelined = true;         // BulkLoaderOptions::pipelined
+    // Called after each committed chunk with the rows added so far
+    std::function<void(uint64_t)> progress;
+};
+
+/**
+ * @brief Create TABLE_TEST_1 with the columns of the test fixtures unless
+ *        it exists
+ * @return true if the table was created
+ */
+bool ensureDatasetTable(fbpp::core::Connection& connection);
+
+/**
+ * @brief Row `index` of the dataset, BLOB columns left NULL
+ *
+ * Deterministic in (options.seed, index); only seed, nullRatio and
+ * blobRatio are read.
+ */
+DatasetRow datasetRow(uint64_t index, const DatasetOptions& options);
+
+/// Whether row `index` carries BLOBs (see DatasetOptions::blobRatio)
+bool datasetRowHasBlobs(uint64_t index, const DatasetOptions& options);
+
+/// Contents of a BLOB of row `index`: printable text or arbitrary bytes
+std::string datasetBlob(uint64_t index, const DatasetOptions& options, bool text);
+
+/**
+ * @brief Add options.rows dataset rows to TABLE_TEST_1, creating it if missing
+ *
+ * Each chunk of options.chunkRows rows goes through one BulkLoader in its
+ * own transaction and is committed before the next is generated.
+ * @return Rows added
+ * @throws FirebirdException / std::runtime_error on the first failed row
+ */
+uint64_t generateDataset(fbpp::core::Connection& connection, const DatasetOptions& options);
+
+} // namespace fbpp::util
@@ -0,0 +1,151 @@
+#pragma once
+
+// In-memory replay of recorded Firebird messages, for benchmarks and
+// fuzzing of the codec paths without a server.
+//
+// The replay objects implement the part of IMessageMetadata, IStatement,
+// IResultSet, ITransaction and IBatch that fbpp calls, and are handed to
+// the ordinary core wrappers. Everything above the OO API (ResultSet
+// fetch / rows() / fetchRowView, the tuple, struct and JSON decoders, Batch
+// packing, BulkLoader, CsvImporter, ...) runs unchanged:
+//
+//   auto rows = RecordedMessages::fromSnapshot(ResultSnapshot::open("t.fbsnap"));
+//   ReplaySession session;
+//   auto stmt = session.prepare(rows, /*repeat=*/1000);
+//   auto rs = stmt->openCursor(session.transaction());
+//   std::tuple<int, std::string> row;
+//   while (rs->fetch(row)) { ... }
+//
+// A cursor serves the recorded rows in order, `repeat` times over. A batch
+// or an execute() counts the input messages it is given (and keeps them
+// when asked to), so packing can be measured and checked byte for byte.
+//
+// BLOB ids in the recorded rows are returned as recorded but cannot be
+// opened: the session has no attachment. fbclient is still needed (the
+// core wrappers use its master interface), a server is not.
+
+#include "fbpp/core/message_metadata.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace fbpp::core {
+class ResultSnapshot;
+}
+
+namespace fbpp::util {
+
+/**
+ * @brief Raw messages of one layout: the recording a replay cursor serves
+ *
+ * Rows are stored back to back, getMessageLength() bytes each. Nothing
+ * checks that a row decodes; hand-made or mutated bytes are allowed, which
+ * is what fuzzing the decoders needs (a VARCHAR length prefix beyond the
+ * declared length, for instance, is the decoder's problem to reject).
+ */
+class RecordedMessages {
+public:
+    /// Layout with no fields (a statement without parameters or output)
+    RecordedMessages() = default;
+
+    /// Empty recording with the layout of `metadata` (names, types,
+    /// offsets, lengths)
+    explicit RecordedMessages(const fbpp::core::MessageMetadata& metadata);
+
+    /// Copy of a snapshot's layout and rows
+    static std::shared_ptr<RecordedMessages> fromSnapshot(const fbpp::core::ResultSnapshot& snapshot);
+
+    /// Append one message of messageLength() bytes
+    void add(const void* message);
+
+    const std::vector<fbpp::core::FieldInfo>& fields() const noexcept { return fields_; }
+    unsigned messageLength() const noexcept { return messageLength_; }
+    unsigned alignment() const noexcept { return alignment_; }
+    unsigned alignedLength() const noexcept { return alignedLength_; }
+
+    std::size_t rowCount() const noexcept { return messageLength_ ? data_.size() / messageLength_ : 0; }
+    const uint8_t* row(std::size_t index) const noexcept { return data_.data() + index * messageLength_; }
+
+private:
+    std::vector<fbpp::core::FieldInfo> fields_;
+    unsigned messageLength_ = 0;
+    unsigned alignment_ = 1;
+    unsigned alignedLength_ = 0;
+    std::vector<uint8_t> data_;
+};
+
+/**
+ * @brief Input messages received by a replay statement
+ *
+ * Filled by execute() and by every batch of the statement. Thread-safe; a
+ * statement is normally used from one thread anyway.
+ */
+class ReplayCapture {
+public:
+    /// Keep copies of the messages (off by default: counting only)
+    explicit ReplayCapture(bool keepMessages = false) : keep_(keepMessages) {}
+
+    std::size_t messages() const;
+    std::size_t bytes() const;
+
+    /// Kept messages, back to back (empty unless keepMessages)
+    std::vector<uint8_t> data() const;
+
+    void reset();
+
+    /// Add `count` messages of `length` bytes found every `stride` bytes
+    /// (called by the replay objects)
+    void record(const void* messages, unsigned count, unsigned length, unsigned stride);
+
+private:
+    mutable std::mutex mutex_;
+    const bool keep_;
+    std::size_t messages_ = 0;
+    std::size_t bytes_ = 0;
+    std::vector<uint8_t> data_;
+};
+
+/**
+ * @brief Source of replay statements and of the transaction to run them in
+ *
+ * The transaction is a core::Transaction without a connection: commit and
+ * rollback succeed, BLOB access throws. Keep the session alive while its
+ * statements and cursors are in use.
+ */
+class ReplaySession {
+public:
+    ReplaySession();
+
+    const std::shared_ptr<fbpp::core::Transaction>& transaction() const noexcept { return transaction_; }
+
+    /**
+     * @brief Statement whose cursors serve `output`
+     *
+     * @param output Rows served by openCursor(); execute() with an output
+     *        message runs as a singleton SELECT: one row served is copied,
+     *        none or several fail as on the server
+     * @param repeat Times the recording is served per cursor (at least 1)
+     * @param input Parameter layout, used by execute() with input and by
+     *        createBatch(); nullptr for a statement without parameters
+     * @param capture Receives the input messages; may be nullptr
+     */
+    std::shared_ptr<fbpp::core::Statement> prepare(
+        std::shared_ptr<const RecordedMessages> output, std::size_t repeat = 1,
+        std::shared_ptr<const RecordedMessages> input = nullptr,
+        std::shared_ptr<ReplayCapture> capture = nullptr);
+
+    /// DML-like statement: no output, input messages go to `capture`
+    std::shared_ptr<fbpp::core::Statement> prepareInsert(
+        std::shared_ptr<const RecordedMessages> input,
+        std::shared_ptr<ReplayCapture> capture);
+
+private:
+    std::shared_ptr<fbpp::core::Transaction> transaction_;
+};
+
+} // namespace fbpp::util
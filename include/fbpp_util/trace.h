@@ -1,5 +1,9 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <string_view>
@@ -7,6 +11,8 @@
 namespace fbpp::util {
 
 enum class TraceLevel {
+    trace,   // Per execute / fetch detail
+    debug,
     info,
     warn,
     error
@@ -30,6 +36,17 @@ public:
 void setTraceSink(TraceSink* sink);
 TraceSink* getTraceSink();
 
+/**
+ * Lowest level passed to the sink (default info: trace and debug are off).
+ * Checked before any formatting, so disabled hot-path tracing costs two
+ * relaxed atomic loads.
+ */
+void setTraceLevel(TraceLevel level);
+TraceLevel getTraceLevel();
+
+/// True when a sink is installed and `level` is at or above the trace level.
+bool traceEnabled(TraceLevel level);
+
 void traceMessage(TraceLevel level,
                   std::string_view component,
                   std::string_view message);
@@ -38,6 +55,9 @@ template<typename Formatter>
 inline void trace(TraceLevel level,
                   std::string_view component,
                   Formatter&& formatter) {
+    if (!traceEnabled(level)) {
+        return;
+    }
     if (auto* sink = getTraceSink()) {
         std::ostringstream oss;
         formatter(oss);
@@ -45,4 +65,44 @@ inline void trace(TraceLevel level,
     }
 }
 
+/**
+ * Sink that hands entries to a background thread.
+ *
+ * log() moves the entry into a bounded lock-free multi-producer ring
+ * buffer and returns; a worker thread drains it into `target`, so target
+ * is called from one thread only and needs no locking of its own. When
+ * the ring is full the entry is dropped and counted (the caller never
+ * blocks). flush() waits until everything logged so far was delivered;
+ * the destructor flushes and stops the worker.
+ *
+ *   AsyncTraceSink async(fileSink);
+ *   setTraceSink(&async);
+ *   setTraceLevel(TraceLevel::trace);
+ */
+class AsyncTraceSink : public TraceSink {
+public:
+    /// `capacity` is rounded up to a power of two (at least 2).
+    explicit AsyncTraceSink(TraceSink& target, std::size_t capacity = 8192);
+    ~AsyncTraceSink() override;
+
+    AsyncTraceSink(const AsyncTraceSink&) = delete;
+    AsyncTraceSink& operator=(const AsyncTraceSink&) = delete;
+
+    void log(TraceLevel level,
+             std::string_view component,
+             std::string_view message) override;
+
+    /// Block until every entry logged before the call reached the target.
+    void flush();
+
+    /// Entries dropped because the ring was full.
+    std::uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+    std::size_t capacity() const noexcept;
+
+private:
+    struct State;
+    std::unique_ptr<State> state_;
+    std::atomic<std::uint64_t> dropped_{0};
+};
+
 } // namespace fbpp::util
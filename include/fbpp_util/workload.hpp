@@ -0,0 +1,166 @@
+#pragma once
+
+// Workload record / replay for performance regression checks.
+//
+// WorkloadRecorder is a core::SpanObserver: installed in a real
+// application it writes every execute, cursor (open to close), commit and
+// rollback to a JSON-lines file, with the SQL, the packed input message
+// and its layout, the row count and the duration. replayWorkload() runs
+// such a file against a test database and times every statement;
+// compareToBaseline() then lists the statements that got slower than a
+// stored run by more than a threshold. The fbpp_replay tool wraps the
+// three:
+//
+//   fbpp::util::WorkloadRecorder recorder("orders.workload");
+//   fbpp::core::setSpanObserver(&recorder);
+//   ...                                      // the real workload
+//   fbpp::core::setSpanObserver(nullptr);
+//
+//   fbpp_replay --workload orders.workload --write-baseline base.json
+//   fbpp_replay --workload orders.workload --baseline base.json --threshold 0.10
+//
+// Replay is sequential on one attachment: each recorded thread gets its
+// own transaction, ended where the thread committed or rolled back. Cursors
+// are drained without decoding. Batches and BLOB contents are not
+// recorded; a recorded BLOB id replays as whatever it names in the test
+// database (usually an error, counted as a failure).
+
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/span_observer.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <iosfwd>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace fbpp::util {
+
+/// One column of a recorded input message
+struct WorkloadField {
+    unsigned type = 0;          // SQL type code, nullable bit included
+    unsigned subType = 0;
+    unsigned length = 0;
+    int scale = 0;
+    unsigned charSet = 0;
+};
+
+struct WorkloadStatement {
+    uint64_t fingerprint = 0;
+    std::string sql;
+    std::vector<WorkloadField> input;   // Empty without parameters
+    unsigned inputLength = 0;           // Message length of `input`
+};
+
+struct WorkloadCall {
+    enum class Kind { Execute, Cursor, Commit, Rollback };
+
+    Kind kind = Kind::Execute;
+    unsigned thread = 0;                // Recording thread, numbered from 0
+    uint64_t fingerprint = 0;           // 0 for Commit / Rollback
+    std::vector<uint8_t> input;         // Packed input message, may be empty
+    uint64_t rows = 0;
+    uint64_t micros = 0;
+    bool failed = false;
+};
+
+struct Workload {
+    std::map<uint64_t, WorkloadStatement> statements;
+    std::vector<WorkloadCall> calls;
+};
+
+/**
+ * @brief Span observer writing the workload it sees to a file
+ *
+ * Writes are serialized under a mutex, so the recorded order is the order
+ * in which spans ended. The statement line (SQL and input layout) is
+ * written the first time a fingerprint is seen.
+ */
+class WorkloadRecorder final : public fbpp::core::SpanObserver {
+public:
+    /// @throws std::runtime_error if `path` cannot be created
+    explicit WorkloadRecorder(const std::string& path);
+
+    /// Write to a caller-owned stream instead of a file
+    explicit WorkloadRecorder(std::ostream& out);
+
+    /// Uninstalls itself if it is still the installed observer
+    ~WorkloadRecorder() override;
+
+    WorkloadRecorder(const WorkloadRecorder&) = delete;
+    WorkloadRecorder& operator=(const WorkloadRecorder&) = delete;
+
+    void* startSpan(const fbpp::core::SpanStart& start) override;
+    void endSpan(void* span, const fbpp::core::SpanEnd& end) noexcept override;
+
+    /// Calls written so far
+    uint64_t calls() const;
+
+private:
+    void writeStatement(const WorkloadStatement& statement);
+    unsigned threadIndex();
+
+    std::ofstream file_;
+    std::ostream& out_;
+    mutable std::mutex mutex_;
+    std::unordered_map<uint64_t, unsigned> written_;   // fingerprint -> input length
+    std::unordered_map<std::thread::id, unsigned> threads_;
+    uint64_t calls_ = 0;
+};
+
+/// Parse a recorded workload
+/// @throws std::runtime_error on a malformed line
+Workload readWorkload(std::istream& in);
+Workload readWorkload(const std::string& path);
+
+/// Replay timings of one statement (successful calls only)
+struct StatementTiming {
+    uint64_t fingerprint = 0;
+    std::string sql;
+    uint64_t calls = 0;
+    uint64_t failures = 0;
+    uint64_t rows = 0;
+    double meanMicros = 0;
+    double p50Micros = 0;
+    double p99Micros = 0;
+    double recordedMeanMicros = 0;   // Mean duration in the recording
+};
+
+struct ReplayOptions {
+    unsigned iterations = 1;   // Times the whole workload is replayed
+    unsigned warmup = 0;       // Untimed passes before the first timed one
+};
+
+/// Replay the workload on `connection`; timings by fingerprint
+std::map<uint64_t, StatementTiming> replayWorkload(fbpp::core::Connection& connection,
+                                                    const Workload& workload,
+                                                    const ReplayOptions& options = {});
+
+/// Baseline file contents of a replay run
+nlohmann::json timingsToJson(const std::map<uint64_t, StatementTiming>& timings);
+
+struct Regression {
+    uint64_t fingerprint = 0;
+    std::string sql;
+    double baselineMicros = 0;   // p50
+    double currentMicros = 0;    // p50
+    double change = 0;           // current / baseline - 1
+};
+
+/**
+ * @brief Statements whose p50 grew by more than `threshold` (0.10 = 10%)
+ *
+ * Statements missing from either side, or with fewer than `minCalls`
+ * timed calls in the current run, are not compared.
+ */
+std::vector<Regression> compareToBaseline(const std::map<uint64_t, StatementTiming>& current,
+                                          const nlohmann::json& baseline,
+                                          double threshold, uint64_t minCalls = 5);
+
+} // namespace fbpp::util
@@ -1,19 +1,109 @@
 #include "fbpp/core/batch.hpp"
 #include "fbpp/core/batch_impl.hpp"
+#include "fbpp/core/column_batch.hpp"
 #include "fbpp/core/transaction.hpp"
 #include "fbpp/core/environment.hpp"
 #include "fbpp/core/exception.hpp"
+#include "fbpp/core/extended_types.hpp"
+#include "fbpp/core/param_binder.hpp"
 #include "fbpp_util/trace.h"
+#include <algorithm>
+#include <istream>
 #include <sstream>
 
 namespace fbpp::core {
 
+void BatchResult::merge(const BatchResult& next) {
+    const unsigned base = totalMessages;
+
+    totalMessages += next.totalMessages;
+    successCount += next.successCount;
+    failedCount += next.failedCount;
+    perMessageStatus.insert(perMessageStatus.end(),
+                            next.perMessageStatus.begin(), next.perMessageStatus.end());
+
+    for (size_t i = 0; i < next.errors.size(); ++i) {
+        if (i < next.errorIndices.size()) {
+            // Re-number "Message <local>: ..." to the merged position.
+            const unsigned index = base + next.errorIndices[i];
+            const auto colon = next.errors[i].find(": ");
+            errors.push_back(std::string("Message ") + std::to_string(index) +
+                             (colon == std::string::npos ? ": " + next.errors[i]
+                                                         : next.errors[i].substr(colon)));
+            errorIndices.push_back(index);
+        } else {
+            errors.push_back(next.errors[i]);
+        }
+    }
+}
+
 // BatchImpl implementation
-Batch::BatchImpl::BatchImpl(Firebird::IBatch* batch, std::shared_ptr<MessageMetadata> metadata)
+Batch::BatchImpl::BatchImpl(Firebird::IBatch* batch, std::shared_ptr<const MessageMetadata> metadata)
     : batch_(batch), metadata_(metadata), messageCount_(0) {
     auto& env = Environment::getInstance();
-    status_ = env.getMaster()->getStatus();
+    status_ = env.acquireStatus();
     statusWrapper_ = Firebird::ThrowStatusWrapper(status_);
+
+    if (metadata_) {
+        messageLength_ = metadata_->getMessageLength();
+        const size_t align = std::max<size_t>(metadata_->getAlignment(), 1);
+        alignedLength_ = ((messageLength_ + align - 1) / align) * align;
+    }
+}
+
+size_t Batch::BatchImpl::prepareStream() {
+    const size_t perChunk = std::max<size_t>(chunkBytes_ / std::max<size_t>(alignedLength_, 1), 1);
+    // Alignment padding between messages stays zero: only the message
+    // bytes are cleared before each pack.
+    if (stream_.size() < perChunk * alignedLength_) {
+        stream_.assign(perChunk * alignedLength_, 0);
+        chargeBuffers();
+    }
+    return perChunk;
+}
+
+void Batch::BatchImpl::addStream(size_t count) {
+    try {
+        detail::PhaseTimer wire(metrics_.get(), Phase::Wire);
+        batch_->add(&status(), static_cast<unsigned>(count), stream_.data());
+        messageCount_ += static_cast<unsigned>(count);
+    } catch (const Firebird::FbException& e) {
+        throw FirebirdException(e);
+    }
+}
+
+void Batch::BatchImpl::requireBlobIds(const char* operation) const {
+    if (blobPolicy_ != BatchBlobPolicy::IdEngine && blobPolicy_ != BatchBlobPolicy::IdUser) {
+        throw FirebirdException(std::string("Batch::") + operation +
+                                " requires BatchBlobPolicy::IdEngine or IdUser");
+    }
+}
+
+ISC_QUAD Batch::BatchImpl::beginBlob(const void* data, size_t length) {
+    ISC_QUAD id{};
+    if (blobPolicy_ == BatchBlobPolicy::IdUser) {
+        // Any id unique within the batch will do
+        id.gds_quad_low = ++lastUserBlobId_;
+    }
+    try {
+        batch_->addBlob(&status(), static_cast<unsigned>(length), data, &id, 0, nullptr);
+    } catch (const Firebird::FbException& e) {
+        throw FirebirdException(e);
+    }
+    return id;
+}
+
+void Batch::BatchImpl::appendBlob(const uint8_t* data, size_t length) {
+    try {
+        while (length > 0) {
+            const size_t piece = std::min(length, Batch::kBlobSegmentBytes);
+            batch_->appendBlobData(&status(), static_cast<unsigned>(piece), data);
+            data += piece;
+            length -= piece;
+        }
+    } catch (const Firebird::FbException& e) {
+        throw FirebirdException(e);
+    }
 }
 
 Batch::BatchImpl::~BatchImpl() {
@@ -25,12 +115,13 @@ Batch::BatchImpl::~BatchImpl() {
         }
     }
     if (status_) {
-        status_->dispose();
+        Environment::getInstance().releaseStatus(status_);
     }
 }
 
 // Batch implementation
-Batch::Batch(Firebird::IBatch* batch, std::shared_ptr<MessageMetadata> metadata)
+Batch::Batch(Firebird::IBatch* batch, std::shared_ptr<const MessageMetadata> metadata,
+             BatchBlobPolicy blobPolicy, const JsonTextPacker* jsonTextPacker)
     : impl_(std::make_unique<BatchImpl>(batch, metadata)) {
     if (!batch) {
         throw FirebirdException("Invalid batch pointer");
@@ -38,6 +129,8 @@ Batch::Batch(Firebird::IBatch* batch, std::shared_ptr<MessageMetadata> metadata)
     if (!metadata) {
         throw FirebirdException("Invalid metadata for batch");
     }
+    impl_->blobPolicy_ = blobPolicy;
+    impl_->jsonTextPacker_ = jsonTextPacker;
 }
 
 Batch::~Batch() {
@@ -52,9 +145,44 @@ Batch::~Batch() {
 }
 
 Batch::Batch(Batch&& other) noexcept = default;
+
+void Batch::trackMemory(std::shared_ptr<detail::MemoryAccount> account) {
+    impl_->memory_.attach(std::move(account), detail::MemoryAccount::batches, 0);
+    impl_->chargeBuffers();
+}
 Batch& Batch::operator=(Batch&& other) noexcept = default;
 
+void Batch::applyOptions(const BatchOptions& options) {
+    impl_->recordCounts_ = options.recordCounts;
+    impl_->continueOnError_ = options.continueOnError;
+}
+
+void Batch::setMetrics(std::shared_ptr<StatementMetrics> metrics) {
+    impl_->metrics_ = std::move(metrics);
+}
+
 BatchResult Batch::execute(Transaction* transaction) {
+    return execute(transaction, BatchCompletion::kAllErrors);
+}
+
+BatchResult Batch::execute(Transaction* transaction, size_t maxErrors) {
+    auto completion = executeDeferred(transaction);
+    // Without record counts every success reads SUCCESS_NO_INFO: skip the
+    // per-message vector and, without multi-error, the walk as well
+    auto result = impl_->recordCounts_
+        ? completion.toResult(maxErrors)
+        : completion.toSummary(maxErrors, !impl_->continueOnError_);
+
+    fbpp::util::trace(fbpp::util::TraceLevel::info, "Batch",
+                [&](auto& oss) {
+                    oss << "Batch execution complete: success=" << result.successCount
+                        << " failed=" << result.failedCount
+                        << " total=" << result.totalMessages;
+                });
+    return result;
+}
+
+BatchCompletion Batch::executeDeferred(Transaction* transaction) {
     if (!impl_ || !impl_->batch_) {
         throw FirebirdException("Invalid batch");
     }
@@ -68,97 +196,212 @@ BatchResult Batch::execute(Transaction* transaction) {
                     oss << "Executing batch with " << impl_->messageCount_ << " messages";
                 });
 
-    BatchResult result;
-    result.totalMessages = impl_->messageCount_;
-    
     try {
-        // Execute batch
         auto& st = impl_->status();
-        Firebird::IBatchCompletionState* cs = impl_->batch_->execute(&st, 
-                                                                      transaction->getRawTransaction());
+        Firebird::IBatchCompletionState* cs = nullptr;
+        {
+            detail::PhaseTimer wire(impl_->metrics_.get(), Phase::Wire);
+            cs = impl_->batch_->execute(&st, transaction->getRawTransaction());
+        }
         
         if (!cs) {
             throw FirebirdException("Batch execution failed - no completion state returned");
         }
-        
-        // Process results
-        unsigned messageCount = cs->getSize(&st);
-        result.totalMessages = messageCount;
-        
-        auto& env = Environment::getInstance();
-        auto util = env.getMaster()->getUtilInterface();
-        Firebird::IStatus* errorStatus = env.getMaster()->getStatus();
-        
-        try {
-            // Collect per-message status
-            for (unsigned i = 0; i < messageCount; ++i) {
-                int state = cs->getState(&st, i);
-                result.perMessageStatus.push_back(state);
-                
-                if (state == Firebird::IBatchCompletionState::EXECUTE_FAILED) {
-                    result.failedCount++;
-                    
-                    // Get error details
-                    cs->getStatus(&st, errorStatus, i);
-                    char errorBuf[1024];
-                    util->formatStatus(errorBuf, sizeof(errorBuf) - 1, errorStatus);
-                    errorBuf[sizeof(errorBuf) - 1] = 0;
-                    result.errors.push_back(std::string("Message ") + std::to_string(i) + ": " + errorBuf);
-
-                    fbpp::util::trace(fbpp::util::TraceLevel::error, "Batch",
-                                [&](auto& oss) {
-                                    oss << "Batch message " << i << " failed: " << errorBuf;
-                                });
-                    
-                } else if (state >= 0) {
-                    result.successCount++;
-                } else {
-                    // SUCCESS_NO_INFO
-                    result.successCount++;
-                }
-            }
-            
-            // Find all errors for detailed reporting
-            unsigned errorPos = 0;
-            while ((errorPos = cs->findError(&st, errorPos)) != Firebird::IBatchCompletionState::NO_MORE_ERRORS) {
-                // Error already processed above
-                errorPos++;
-            }
-            
-        } catch (...) {
-            if (errorStatus) {
-                errorStatus->dispose();
-            }
-            throw;
-        }
-        
-        if (errorStatus) {
-            errorStatus->dispose();
-        }
-        
-        // Release completion state
-        cs->dispose();
+        BatchCompletion completion(cs);
         
         // Release batch after successful execution
         impl_->batch_->release();
         impl_->batch_ = nullptr;
-
-        fbpp::util::trace(fbpp::util::TraceLevel::info, "Batch",
-                    [&](auto& oss) {
-                        oss << "Batch execution complete: success=" << result.successCount
-                            << " failed=" << result.failedCount
-                            << " total=" << result.totalMessages;
-                    });
+        return completion;
         
     } catch (const Firebird::FbException& e) {
         fbpp::util::trace(fbpp::util::TraceLevel::error, "Batch",
                     [](auto& oss) { oss << "Batch execution failed (Firebird exception)"; });
         throw FirebirdException(e);
     }
+}
     
+// BatchCompletion implementation
+BatchCompletion::BatchCompletion(Firebird::IBatchCompletionState* state)
+    : state_(state) {
+    if (!state_) {
+        throw FirebirdException("Invalid batch completion state");
+    }
+    status_ = Environment::getInstance().acquireStatus();
+    statusWrapper_ = Firebird::ThrowStatusWrapper(status_);
+}
+
+BatchCompletion::~BatchCompletion() {
+    reset();
+}
+
+BatchCompletion::BatchCompletion(BatchCompletion&& other) noexcept
+    : state_(other.state_),
+      status_(other.status_),
+      statusWrapper_(other.status_),
+      errorStatus_(other.errorStatus_),
+      size_(other.size_),
+      failed_(other.failed_) {
+    other.state_ = nullptr;
+    other.status_ = nullptr;
+    other.errorStatus_ = nullptr;
+}
+
+BatchCompletion& BatchCompletion::operator=(BatchCompletion&& other) noexcept {
+    if (this != &other) {
+        reset();
+        state_ = other.state_;
+        status_ = other.status_;
+        statusWrapper_ = Firebird::ThrowStatusWrapper(status_);
+        errorStatus_ = other.errorStatus_;
+        size_ = other.size_;
+        failed_ = other.failed_;
+        other.state_ = nullptr;
+        other.status_ = nullptr;
+        other.errorStatus_ = nullptr;
+    }
+    return *this;
+}
+
+void BatchCompletion::reset() noexcept {
+    if (state_) {
+        state_->dispose();
+        state_ = nullptr;
+    }
+    if (errorStatus_) {
+        errorStatus_->dispose();
+        errorStatus_ = nullptr;
+    }
+    if (status_) {
+        Environment::getInstance().releaseStatus(status_);
+        status_ = nullptr;
+    }
+}
+
+Firebird::ThrowStatusWrapper& BatchCompletion::status() const {
+    if (!state_) {
+        throw FirebirdException("Batch completion state was moved from");
+    }
+    statusWrapper_.init();
+    return statusWrapper_;
+}
+
+unsigned BatchCompletion::size() const {
+    if (size_ == npos) {
+        try {
+            size_ = state_ ? state_->getSize(&status()) : 0;
+        } catch (const Firebird::FbException& e) {
+            throw FirebirdException(e);
+        }
+    }
+    return size_;
+}
+
+int BatchCompletion::state(unsigned index) const {
+    try {
+        return state_->getState(&status(), index);
+    } catch (const Firebird::FbException& e) {
+        throw FirebirdException(e);
+    }
+}
+
+unsigned BatchCompletion::failedCount() const {
+    if (failed_ == npos) {
+        unsigned failed = 0;
+        for (unsigned i = nextError(0); i != npos; i = nextError(i + 1)) {
+            ++failed;
+        }
+        failed_ = failed;
+    }
+    return failed_;
+}
+
+unsigned BatchCompletion::nextError(unsigned from) const {
+    // States rather than IBatchCompletionState::findError(): the latter
+    // only visits messages with a stored status (TAG_DETAILED_ERRORS).
+    const unsigned count = size();
+    for (unsigned i = from; i < count; ++i) {
+        if (state(i) == Firebird::IBatchCompletionState::EXECUTE_FAILED) {
+            return i;
+        }
+    }
+    return npos;
+}
+
+std::string BatchCompletion::errorMessage(unsigned index) const {
+    if (!failed(index)) {
+        return {};
+    }
+
+    auto& master = *Environment::getInstance().getMaster();
+    if (!errorStatus_) {
+        errorStatus_ = master.getStatus();
+    }
+    try {
+        errorStatus_->init();
+        state_->getStatus(&status(), errorStatus_, index);
+    } catch (const Firebird::FbException& e) {
+        throw FirebirdException(e);
+    }
+    if (!(errorStatus_->getState() & Firebird::IStatus::STATE_ERRORS)) {
+        return {};
+    }
+
+    char errorBuf[1024];
+    master.getUtilInterface()->formatStatus(errorBuf, sizeof(errorBuf) - 1, errorStatus_);
+    errorBuf[sizeof(errorBuf) - 1] = 0;
+    return errorBuf;
+}
+
+BatchResult BatchCompletion::toResult(size_t maxErrors) const {
+    BatchResult result;
+    result.totalMessages = size();
+    result.perMessageStatus.reserve(result.totalMessages);
+
+    for (unsigned i = 0; i < result.totalMessages; ++i) {
+        const int state = this->state(i);
+        result.perMessageStatus.push_back(state);
+
+        if (state != Firebird::IBatchCompletionState::EXECUTE_FAILED) {
+            // Records affected or SUCCESS_NO_INFO
+            result.successCount++;
+            continue;
+        }
+
+        addFailure(result, i, maxErrors);
+    }
+    failed_ = result.failedCount;
     return result;
 }
 
+BatchResult BatchCompletion::toSummary(size_t maxErrors, bool stoppedAtError) const {
+    BatchResult result;
+    result.totalMessages = size();
+    const unsigned from =
+        stoppedAtError && result.totalMessages > 0 ? result.totalMessages - 1 : 0;
+    for (unsigned i = nextError(from); i != npos; i = nextError(i + 1)) {
+        addFailure(result, i, maxErrors);
+    }
+    result.successCount = result.totalMessages - result.failedCount;
+    failed_ = result.failedCount;
+    return result;
+}
+
+void BatchCompletion::addFailure(BatchResult& result, unsigned index, size_t maxErrors) const {
+    result.failedCount++;
+    if (result.errors.size() >= maxErrors) {
+        return;
+    }
+    const std::string message = errorMessage(index);
+    result.errors.push_back(std::string("Message ") + std::to_string(index) + ": " + message);
+    result.errorIndices.push_back(index);
+
+    fbpp::util::trace(fbpp::util::TraceLevel::error, "Batch",
+                [&](auto& oss) {
+                    oss << "Batch message " << index << " failed: " << message;
+                });
+}
+
 void Batch::cancel() {
     if (!impl_ || !impl_->batch_) {
         return; // Already cancelled or executed
@@ -180,6 +423,216 @@ unsigned Batch::getMessageCount() const {
     return impl_ ? impl_->messageCount_ : 0;
 }
 
+size_t Batch::getBufferedBytes() const {
+    return impl_ ? static_cast<size_t>(impl_->messageCount_) * impl_->alignedLength_ : 0;
+}
+
+void Batch::addPacked(const uint8_t* messages, size_t count) {
+    if (!impl_ || !impl_->batch_) {
+        throw FirebirdException("Invalid batch");
+    }
+    if (count == 0) {
+        return;
+    }
+
+    try {
+        detail::PhaseTimer wire(impl_->metrics_.get(), Phase::Wire);
+        impl_->batch_->add(&impl_->status(), static_cast<unsigned>(count), messages);
+        impl_->messageCount_ += static_cast<unsigned>(count);
+    } catch (const Firebird::FbException& e) {
+        throw FirebirdException(e);
+    }
+}
+
+void Batch::addColumns(const ColumnBatch& columns) {
+    if (!impl_ || !impl_->batch_) {
+        throw FirebirdException("Invalid batch");
+    }
+    detail::checkColumnEncoding(*impl_->metadata_, columns);
+    const auto& plan = impl_->metadata_->getColumnPlan();
+    for (size_t c = 0; c < plan.size(); ++c) {
+        const ColumnVector& col = columns.columns[c];
+        if ((plan[c].type & ~1u) == SQL_BLOB && col.nullCount < col.length) {
+            impl_->requireBlobIds("addColumns");
+        }
+    }
+    if (columns.rowCount == 0) {
+        return;
+    }
+
+    BatchImpl& impl = *impl_;
+    const std::function<ISC_QUAD(std::string_view)> blobId = [&impl](std::string_view bytes) {
+        const auto* data = reinterpret_cast<const uint8_t*>(bytes.data());
+        const size_t first = std::min(bytes.size(), kBlobSegmentBytes);
+        const ISC_QUAD id = impl.beginBlob(data, first);
+        impl.appendBlob(data + first, bytes.size() - first);
+        return id;
+    };
+
+    const size_t perChunk = impl.prepareStream();
+    for (size_t first = 0; first < columns.rowCount; first += perChunk) {
+        const size_t count = std::min(perChunk, columns.rowCount - first);
+        {
+            detail::PhaseTimer packing(impl.metrics_.get(), Phase::Pack);
+            for (size_t i = 0; i < count; ++i) {
+                std::memset(impl.stream_.data() + i * impl.alignedLength_, 0,
+                            impl.messageLength_);
+            }
+            detail::encodeColumnBatch(*impl.metadata_, columns, first, count,
+                                      impl.stream_.data(), impl.alignedLength_, blobId);
+        }
+        impl.addStream(count);
+    }
+}
+
+void Batch::add(const ParamBinder& binder) {
+    if (!impl_ || !impl_->batch_) {
+        throw FirebirdException("Invalid batch");
+    }
+    const auto& layout = binder.sharedMetadata();
+    if (layout != impl_->binderLayout_ && layout != impl_->metadata_) {
+        const MessageMetadata* own = impl_->metadata_.get();
+        bool same = layout && own && layout->getCount() == own->getCount() &&
+                    layout->getMessageLength() == own->getMessageLength();
+        for (unsigned i = 0; same && i < own->getCount(); ++i) {
+            const FieldInfo& a = layout->getFieldRef(i);
+            const FieldInfo& b = own->getFieldRef(i);
+            same = a.type == b.type && a.subType == b.subType && a.length == b.length &&
+                   a.scale == b.scale && a.charSet == b.charSet && a.offset == b.offset &&
+                   a.nullOffset == b.nullOffset;
+        }
+        if (!same) {
+            throw FirebirdException(
+                "Batch::add(ParamBinder): the binder's parameters differ from the batch's");
+        }
+        impl_->binderLayout_ = layout;
+    }
+
+    try {
+        detail::PhaseTimer wire(impl_->metrics_.get(), Phase::Wire);
+        impl_->batch_->add(&impl_->status(), 1, binder.buffer());
+        impl_->messageCount_++;
+    } catch (const Firebird::FbException& e) {
+        throw FirebirdException(e);
+    }
+}
+
+Blob Batch::addBlob(const void* data, size_t length) {
+    if (!impl_ || !impl_->batch_) {
+        throw FirebirdException("Invalid batch");
+    }
+    impl_->requireBlobIds("addBlob");
+
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    const size_t first = std::min(length, kBlobSegmentBytes);
+    ISC_QUAD id = impl_->beginBlob(bytes, first);
+    impl_->appendBlob(bytes + first, length - first);
+    return Blob(reinterpret_cast<const uint8_t*>(&id));
+}
+
+Blob Batch::addBlob(std::istream& in) {
+    return addBlob([&in](uint8_t* buffer, size_t capacity) -> size_t {
+        in.read(reinterpret_cast<char*>(buffer), static_cast<std::streamsize>(capacity));
+        if (in.bad()) {
+            throw FirebirdException("Batch::addBlob: stream read failed");
+        }
+        return static_cast<size_t>(in.gcount());
+    });
+}
+
+Blob Batch::addBlob(const std::function<size_t(uint8_t* buffer, size_t capacity)>& source) {
+    if (!impl_ || !impl_->batch_) {
+        throw FirebirdException("Invalid batch");
+    }
+    impl_->requireBlobIds("addBlob");
+
+    // One segment in memory at a time, whatever the BLOB size
+    auto& chunk = impl_->blobChunk_;
+    chunk.resize(kBlobSegmentBytes);
+    impl_->chargeBuffers();
+
+    auto next = [&]() {
+        const size_t n = source(chunk.data(), chunk.size());
+        if (n > chunk.size()) {
+            throw FirebirdException("Batch::addBlob: source returned more bytes than requested");
+        }
+        return n;
+    };
+
+    ISC_QUAD id = impl_->beginBlob(chunk.data(), next());
+    for (size_t n = next(); n > 0; n = next()) {
+        impl_->appendBlob(chunk.data(), n);
+    }
+    return Blob(reinterpret_cast<const uint8_t*>(&id));
+}
+
+Blob Batch::registerBlob(const Blob& existing) {
+    if (!impl_ || !impl_->batch_) {
+        throw FirebirdException("Invalid batch");
+    }
+    if (impl_->blobPolicy_ == BatchBlobPolicy::None) {
+        throw FirebirdException("Batch::registerBlob requires a BLOB policy other than None");
+    }
+
+    ISC_QUAD existingId;
+    std::memcpy(&existingId, existing.getId(), sizeof(existingId));
+    ISC_QUAD id{};
+    if (impl_->blobPolicy_ == BatchBlobPolicy::IdUser) {
+        id.gds_quad_low = ++impl_->lastUserBlobId_;
+    }
+    try {
+        impl_->batch_->registerBlob(&impl_->status(), &existingId, &id);
+    } catch (const Firebird::FbException& e) {
+        throw FirebirdException(e);
+    }
+    return Blob(reinterpret_cast<const uint8_t*>(&id));
+}
+
+void Batch::addBlobStream(const void* data, size_t length) {
+    if (!impl_ || !impl_->batch_) {
+        throw FirebirdException("Invalid batch");
+    }
+    if (impl_->blobPolicy_ != BatchBlobPolicy::Stream) {
+        throw FirebirdException("Batch::addBlobStream requires BatchBlobPolicy::Stream");
+    }
+    try {
+        impl_->batch_->addBlobStream(&impl_->status(), static_cast<unsigned>(length), data);
+    } catch (const Firebird::FbException& e) {
+        throw FirebirdException(e);
+    }
+}
+
+unsigned Batch::getBlobAlignment() const {
+    if (!impl_ || !impl_->batch_) {
+        throw FirebirdException("Invalid batch");
+    }
+    try {
+        return impl_->batch_->getBlobAlignment(&impl_->status());
+    } catch (const Firebird::FbException& e) {
+        throw FirebirdException(e);
+    }
+}
+
+BatchBlobPolicy Batch::getBlobPolicy() const {
+    return impl_ ? impl_->blobPolicy_ : BatchBlobPolicy::None;
+}
+
+size_t Batch::getMessageBytes() const {
+    return impl_ ? impl_->alignedLength_ : 0;
+}
+
+size_t Batch::getStreamChunkBytes() const {
+    return impl_ ? impl_->chunkBytes_ : kDefaultStreamChunkBytes;
+}
+
+void Batch::setStreamChunkBytes(size_t bytes) {
+    if (!impl_) {
+        throw FirebirdException("Invalid batch");
+    }
+    impl_->chunkBytes_ = bytes;
+    // A smaller chunk keeps using the already allocated arena.
+}
+
 bool Batch::isValid() const {
     return impl_ && impl_->batch_ != nullptr;
 }
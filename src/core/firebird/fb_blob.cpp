@@ -0,0 +1,572 @@
+#include "fbpp/core/blob.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/detail/mapped_file.hpp"
+#include "fbpp_util/trace.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <limits>
+#include <string>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fbpp {
+namespace core {
+
+namespace {
+
+// Info buffers carry little-endian integers of the clumplet's own length.
+uint64_t readInfoInt(const unsigned char* p, unsigned length) {
+    uint64_t value = 0;
+    for (unsigned i = 0; i < length && i < sizeof(value); ++i) {
+        value |= static_cast<uint64_t>(p[i]) << (8 * i);
+    }
+    return value;
+}
+
+// getSegment() lengths are unsigned short on the wire.
+constexpr size_t kMaxSegmentRequest = std::numeric_limits<uint16_t>::max();
+
+// First read of readAll(), before asking for the total length
+constexpr size_t kSmallBlobBytes = 16 * 1024;
+
+#ifndef _WIN32
+void writeAllFd(int fd, const void* data, size_t bytes) {
+    const auto* p = static_cast<const char*>(data);
+    while (bytes > 0) {
+        const ssize_t n = ::write(fd, p, bytes);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw FirebirdException(std::string("BLOB target write failed: ") + std::strerror(errno));
+        }
+        p += n;
+        bytes -= static_cast<size_t>(n);
+    }
+}
+#endif
+
+} // namespace
+
+BlobReader::BlobReader(Firebird::IBlob* blob, std::shared_ptr<Transaction> transaction,
+                       size_t readSize)
+    : blob_(blob),
+      transaction_(std::move(transaction)),
+      status_(Environment::getInstance().acquireStatus()),
+      statusWrapper_(status_) {
+    if (!blob_) {
+        release();
+        throw FirebirdException("Invalid BLOB handle");
+    }
+    setReadSize(readSize);
+}
+
+BlobReader::BlobReader(BlobReader&& other) noexcept
+    : blob_(other.blob_),
+      transaction_(std::move(other.transaction_)),
+      status_(other.status_),
+      statusWrapper_(other.status_),
+      readSize_(other.readSize_),
+      chunk_(std::move(other.chunk_)),
+      eof_(other.eof_) {
+    other.blob_ = nullptr;
+    other.status_ = nullptr;
+}
+
+BlobReader& BlobReader::operator=(BlobReader&& other) noexcept {
+    if (this != &other) {
+        release();
+        blob_ = other.blob_;
+        transaction_ = std::move(other.transaction_);
+        status_ = other.status_;
+        statusWrapper_ = Firebird::ThrowStatusWrapper(status_);
+        readSize_ = other.readSize_;
+        chunk_ = std::move(other.chunk_);
+        eof_ = other.eof_;
+        other.blob_ = nullptr;
+        other.status_ = nullptr;
+    }
+    return *this;
+}
+
+BlobReader::~BlobReader() {
+    release();
+}
+
+void BlobReader::release() noexcept {
+    if (blob_) {
+        try { blob_->close(&status()); } catch (...) { /* swallow */ }
+        try { blob_->release(); }         catch (...) { /* swallow */ }
+        blob_ = nullptr;
+    }
+    if (status_) {
+        Environment::getInstance().releaseStatus(status_);
+        status_ = nullptr;
+    }
+}
+
+void BlobReader::close() {
+    if (!blob_) {
+        return;
+    }
+    // Release and null the handle on all paths, as ResultSet::close() does.
+    Firebird::IBlob* blob = blob_;
+    blob_ = nullptr;
+    eof_ = true;
+    try {
+        blob->close(&status());
+    } catch (const Firebird::FbException& e) {
+        blob->release();
+        throw FirebirdException(e);
+    }
+    blob->release();
+}
+
+void BlobReader::setReadSize(size_t bytes) {
+    if (bytes == 0) {
+        throw FirebirdException("BLOB read size must be positive");
+    }
+    readSize_ = bytes;
+    chunk_.clear();
+}
+
+size_t BlobReader::read(void* buffer, size_t maxBytes) {
+    if (!blob_) {
+        throw FirebirdException("BLOB is not open");
+    }
+
+    auto* out = static_cast<unsigned char*>(buffer);
+    size_t filled = 0;
+
+    try {
+        auto& st = status();
+        while (filled < maxBytes && !eof_) {
+            const unsigned request = static_cast<unsigned>(
+                std::min(maxBytes - filled, kMaxSegmentRequest));
+            unsigned length = 0;
+            const int result = blob_->getSegment(&st, request, out + filled, &length);
+            filled += length;
+
+            // RESULT_SEGMENT: the buffer ended inside a segment — more data
+            // follows, it is not EOF.
+            if (result == Firebird::IStatus::RESULT_NO_DATA) {
+                eof_ = true;
+            } else if (result != Firebird::IStatus::RESULT_OK &&
+                       result != Firebird::IStatus::RESULT_SEGMENT) {
+                throw FirebirdException("BLOB read failed");
+            }
+        }
+    } catch (const Firebird::FbException& e) {
+        fbpp::util::trace(fbpp::util::TraceLevel::error, "Blob",
+                    [](auto& oss) { oss << "Failed to read BLOB (Firebird exception)"; });
+        throw FirebirdException(e);
+    }
+    return filled;
+}
+
+uint64_t BlobReader::readAll(const std::function<void(std::span<const std::byte>)>& sink) {
+    if (chunk_.size() != readSize_) {
+        chunk_.resize(readSize_);
+    }
+
+    uint64_t total = 0;
+    while (const size_t n = read(chunk_.data(), chunk_.size())) {
+        sink(std::span<const std::byte>(chunk_.data(), n));
+        total += n;
+    }
+    return total;
+}
+
+std::vector<uint8_t> BlobReader::readAll() {
+    // Small BLOBs (short text in memo columns) end within the first read:
+    // no getInfo() round trip for them. Inline BLOBs need none anyway.
+    std::vector<uint8_t> data(std::min(readSize_, kSmallBlobBytes));
+    size_t filled = read(data.data(), data.size());
+    data.resize(filled);
+    if (eof_) {
+        return data;
+    }
+
+    // Larger: size from info, one more allocation, filled in place.
+    const size_t total = static_cast<size_t>(info().totalLength);
+    if (total > data.size()) {
+        data.resize(total);
+        filled += read(data.data() + filled, total - filled);
+        data.resize(filled);
+    }
+
+    // The length is a hint; keep reading if the BLOB turned out longer.
+    while (!eof_) {
+        const size_t base = data.size();
+        data.resize(base + readSize_);
+        filled = read(data.data() + base, readSize_);
+        data.resize(base + filled);
+    }
+    return data;
+}
+
+uint64_t BlobReader::readAllText(TextTranscoder& transcoder,
+                                 const std::function<void(std::string_view)>& sink) {
+    if (chunk_.size() != readSize_) {
+        chunk_.resize(readSize_);
+    }
+
+    std::string text;
+    uint64_t total = 0;
+    while (const size_t n = read(chunk_.data(), chunk_.size())) {
+        text.clear();
+        transcoder.feed(std::string_view(reinterpret_cast<const char*>(chunk_.data()), n), text);
+        if (!text.empty()) {
+            sink(text);
+            total += text.size();
+        }
+    }
+    text.clear();
+    transcoder.finish(text);
+    if (!text.empty()) {
+        sink(text);
+        total += text.size();
+    }
+    return total;
+}
+
+uint64_t BlobReader::readToFile(const std::string& path) {
+#ifndef _WIN32
+    detail::MappedFile file(path, O_RDWR | O_CREAT | O_TRUNC);
+    auto toFd = [&](std::span<const std::byte> chunk) {
+        writeAllFd(file.fd(), chunk.data(), chunk.size());
+    };
+
+    const uint64_t total = info().totalLength;
+    if (total == 0 || ::ftruncate(file.fd(), static_cast<off_t>(total)) != 0) {
+        return readAll(toFd);
+    }
+    auto* out = static_cast<unsigned char*>(file.map(static_cast<size_t>(total), true));
+    if (!out) {
+        return readAll(toFd);
+    }
+
+    // getSegment() writes straight into the page cache of the target file.
+    const size_t filled = read(out, static_cast<size_t>(total));
+    file.unmap();
+    if (filled < total && ::ftruncate(file.fd(), static_cast<off_t>(filled)) != 0) {
+        throw FirebirdException("Cannot truncate " + path + ": " + std::strerror(errno));
+    }
+    // The length is a hint; append anything past it.
+    ::lseek(file.fd(), static_cast<off_t>(filled), SEEK_SET);
+    return filled + readAll(toFd);
+#else
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw FirebirdException("Cannot open " + path);
+    }
+    const uint64_t total = readAll([&](std::span<const std::byte> chunk) {
+        out.write(reinterpret_cast<const char*>(chunk.data()),
+                  static_cast<std::streamsize>(chunk.size()));
+    });
+    if (!out.flush()) {
+        throw FirebirdException("BLOB target write failed: " + path);
+    }
+    return total;
+#endif
+}
+
+BlobInfo BlobReader::info() const {
+    if (!blob_) {
+        throw FirebirdException("BLOB is not open");
+    }
+
+    static const unsigned char items[] = {
+        isc_info_blob_num_segments,
+        isc_info_blob_max_segment,
+        isc_info_blob_total_length,
+        isc_info_blob_type
+    };
+    unsigned char buffer[64];
+
+    try {
+        blob_->getInfo(&status(), sizeof(items), items, sizeof(buffer), buffer);
+    } catch (const Firebird::FbException& e) {
+        throw FirebirdException(e);
+    }
+
+    BlobInfo info;
+    const unsigned char* p = buffer;
+    const unsigned char* end = buffer + sizeof(buffer);
+    while (p + 3 <= end && *p != isc_info_end) {
+        const unsigned char item = *p;
+        if (item == isc_info_truncated || item == isc_info_error) {
+            throw FirebirdException("BLOB info request failed");
+        }
+        const unsigned length = static_cast<unsigned>(readInfoInt(p + 1, 2));
+        p += 3;
+        if (p + length > end) {
+            break;
+        }
+        const uint64_t value = readInfoInt(p, length);
+        switch (item) {
+            case isc_info_blob_num_segments: info.numSegments = static_cast<uint32_t>(value); break;
+            case isc_info_blob_max_segment:  info.maxSegmentSize = static_cast<uint32_t>(value); break;
+            case isc_info_blob_total_length: info.totalLength = value; break;
+            case isc_info_blob_type:         info.isStream = value == isc_bpb_type_stream; break;
+            default: break;
+        }
+        p += length;
+    }
+    return info;
+}
+
+uint64_t BlobReader::seek(int64_t offset, BlobSeekOrigin origin) {
+    if (!blob_) {
+        throw FirebirdException("BLOB is not open");
+    }
+    if (!info().isStream) {
+        throw FirebirdException("seek() requires a stream BLOB (isc_bpb_type_stream)");
+    }
+    if (offset < std::numeric_limits<int>::min() || offset > std::numeric_limits<int>::max()) {
+        throw FirebirdException("BLOB seek offset out of range: " + std::to_string(offset));
+    }
+
+    try {
+        const int position = blob_->seek(&status(), static_cast<int>(origin),
+                                         static_cast<int>(offset));
+        eof_ = false;
+        return static_cast<uint64_t>(static_cast<unsigned>(position));
+    } catch (const Firebird::FbException& e) {
+        throw FirebirdException(e);
+    }
+}
+
+BlobWriter::BlobWriter(Firebird::IBlob* blob, const ISC_QUAD& blobId,
+                       std::shared_ptr<Transaction> transaction, size_t segmentSize)
+    : blob_(blob),
+      blobId_(blobId),
+      transaction_(std::move(transaction)),
+      status_(Environment::getInstance().acquireStatus()),
+      statusWrapper_(status_),
+      segmentSize_(std::clamp<size_t>(segmentSize, 1, kMaxSegmentBytes)) {
+    if (!blob_) {
+        release();
+        throw FirebirdException("Invalid BLOB handle");
+    }
+}
+
+BlobWriter::BlobWriter(BlobWriter&& other) noexcept
+    : blob_(other.blob_),
+      blobId_(other.blobId_),
+      transaction_(std::move(other.transaction_)),
+      status_(other.status_),
+      statusWrapper_(other.status_),
+      segmentSize_(other.segmentSize_),
+      written_(other.written_),
+      buffer_(std::move(other.buffer_)) {
+    other.blob_ = nullptr;
+    other.status_ = nullptr;
+}
+
+BlobWriter& BlobWriter::operator=(BlobWriter&& other) noexcept {
+    if (this != &other) {
+        release();
+        blob_ = other.blob_;
+        blobId_ = other.blobId_;
+        transaction_ = std::move(other.transaction_);
+        status_ = other.status_;
+        statusWrapper_ = Firebird::ThrowStatusWrapper(status_);
+        segmentSize_ = other.segmentSize_;
+        written_ = other.written_;
+        buffer_ = std::move(other.buffer_);
+        other.blob_ = nullptr;
+        other.status_ = nullptr;
+    }
+    return *this;
+}
+
+BlobWriter::~BlobWriter() {
+    release();
+}
+
+void BlobWriter::release() noexcept {
+    if (blob_) {
+        // Never finished: the BLOB must not become visible half-written.
+        try { blob_->cancel(&status()); } catch (...) { /* swallow */ }
+        try { blob_->release(); }          catch (...) { /* swallow */ }
+        blob_ = nullptr;
+    }
+    if (status_) {
+        Environment::getInstance().releaseStatus(status_);
+        status_ = nullptr;
+    }
+}
+
+std::vector<std::byte>& BlobWriter::buffer() {
+    if (buffer_.size() != segmentSize_) {
+        buffer_.resize(segmentSize_);
+    }
+    return buffer_;
+}
+
+void BlobWriter::write(const void* data, size_t bytes) {
+    if (!blob_) {
+        throw FirebirdException("BLOB is not open for writing");
+    }
+
+    const auto* in = static_cast<const unsigned char*>(data);
+    try {
+        auto& st = status();
+        for (size_t offset = 0; offset < bytes;) {
+            const size_t length = std::min(segmentSize_, bytes - offset);
+            blob_->putSegment(&st, static_cast<unsigned>(length), in + offset);
+            offset += length;
+            written_ += length;
+        }
+    } catch (const Firebird::FbException& e) {
+        fbpp::util::trace(fbpp::util::TraceLevel::error, "Blob",
+                    [](auto& oss) { oss << "Failed to write BLOB (Firebird exception)"; });
+        throw FirebirdException(e);
+    }
+}
+
+uint64_t BlobWriter::writeFrom(std::istream& in) {
+    auto& chunk = buffer();
+    uint64_t total = 0;
+    while (in) {
+        in.read(reinterpret_cast<char*>(chunk.data()), static_cast<std::streamsize>(chunk.size()));
+        const auto n = static_cast<size_t>(in.gcount());
+        if (n == 0) {
+            break;
+        }
+        write(chunk.data(), n);
+        total += n;
+    }
+    if (in.bad()) {
+        throw FirebirdException("BLOB source stream read failed");
+    }
+    return total;
+}
+
+void BlobWriter::writeText(std::string_view text, TextTranscoder& transcoder) {
+    std::string converted;
+    converted.reserve(text.size());
+    transcoder.feed(text, converted);
+    write(converted.data(), converted.size());
+}
+
+void BlobWriter::flushText(TextTranscoder& transcoder) {
+    std::string tail;
+    transcoder.finish(tail);
+    write(tail.data(), tail.size());
+}
+
+uint64_t BlobWriter::writeTextFrom(std::istream& in, TextTranscoder& transcoder) {
+    auto& chunk = buffer();
+    const uint64_t before = written_;
+    std::string converted;
+    while (in) {
+        in.read(reinterpret_cast<char*>(chunk.data()), static_cast<std::streamsize>(chunk.size()));
+        const auto n = static_cast<size_t>(in.gcount());
+        if (n == 0) {
+            break;
+        }
+        converted.clear();
+        transcoder.feed(std::string_view(reinterpret_cast<const char*>(chunk.data()), n),
+                        converted);
+        write(converted.data(), converted.size());
+    }
+    if (in.bad()) {
+        throw FirebirdException("BLOB source stream read failed");
+    }
+    flushText(transcoder);
+    return written_ - before;
+}
+
+uint64_t BlobWriter::writeFromFd(int fd) {
+    auto& chunk = buffer();
+    uint64_t total = 0;
+    while (true) {
+#ifdef _WIN32
+        const int n = ::_read(fd, chunk.data(), static_cast<unsigned>(chunk.size()));
+#else
+        const ssize_t n = ::read(fd, chunk.data(), chunk.size());
+#endif
+        if (n == 0) {
+            break;
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw FirebirdException(std::string("BLOB source read failed: ") + std::strerror(errno));
+        }
+        write(chunk.data(), static_cast<size_t>(n));
+        total += static_cast<uint64_t>(n);
+    }
+    return total;
+}
+
+uint64_t BlobWriter::writeFile(const std::string& path) {
+#ifndef _WIN32
+    detail::MappedFile file(path, O_RDONLY);
+    if (const size_t size = file.regularSize()) {
+        if (const void* mapped = file.map(size, false)) {
+            write(mapped, size);
+            return size;
+        }
+    }
+    // Pipes, empty or unmappable files
+    return writeFromFd(file.fd());
+#else
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw FirebirdException("Cannot open " + path);
+    }
+    return writeFrom(in);
+#endif
+}
+
+ISC_QUAD BlobWriter::finish() {
+    if (!blob_) {
+        throw FirebirdException("BLOB is not open for writing");
+    }
+
+    // Release and null the handle on all paths, as BlobReader::close() does.
+    Firebird::IBlob* blob = blob_;
+    blob_ = nullptr;
+    try {
+        blob->close(&status());
+    } catch (const Firebird::FbException& e) {
+        blob->release();
+        throw FirebirdException(e);
+    }
+    blob->release();
+    return blobId_;
+}
+
+void BlobWriter::cancel() {
+    if (!blob_) {
+        return;
+    }
+
+    Firebird::IBlob* blob = blob_;
+    blob_ = nullptr;
+    try {
+        blob->cancel(&status());
+    } catch (const Firebird::FbException& e) {
+        blob->release();
+        throw FirebirdException(e);
+    }
+    blob->release();
+}
+
+} // namespace core
+} // namespace fbpp
@@ -0,0 +1,153 @@
+#include "fbpp/core/cancel_scope.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp_util/trace.h"
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace fbpp {
+namespace core {
+
+namespace {
+
+void raiseCancel(Connection& connection, std::atomic<bool>& fired) noexcept {
+    fired.store(true, std::memory_order_release);
+    try {
+        connection.cancelOperation(CancelOperation::RAISE);
+    } catch (const std::exception& e) {
+        fbpp::util::trace(fbpp::util::TraceLevel::warn, "CancelScope",
+                    [&](auto& oss) { oss << "cancelOperation failed: " << e.what(); });
+    } catch (...) {
+    }
+}
+
+/**
+ * One thread for the deadlines of every CancelScope in the process.
+ *
+ * Entries are keyed by (deadline, id). A deadline fires outside the lock;
+ * cancel() waits for a firing entry, so once it returns the connection is
+ * no longer touched by the timer.
+ */
+class CancelTimer {
+public:
+    static CancelTimer& instance() {
+        static CancelTimer timer;
+        return timer;
+    }
+
+    uint64_t arm(CancelScope::Clock::time_point deadline, Connection& connection,
+                 std::shared_ptr<std::atomic<bool>> fired) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const uint64_t id = ++lastId_;
+        const bool earliest = entries_.empty() || deadline < entries_.begin()->first.first;
+        entries_.emplace(Key{deadline, id}, Entry{&connection, std::move(fired)});
+        if (!thread_.joinable()) {
+            thread_ = std::thread([this] { run(); });
+        } else if (earliest) {
+            wake_.notify_one();
+        }
+        return id;
+    }
+
+    void cancel(CancelScope::Clock::time_point deadline, uint64_t id) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        entries_.erase(Key{deadline, id});
+        fired_.wait(lock, [&] { return firing_ != id; });
+    }
+
+    ~CancelTimer() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_one();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+private:
+    using Key = std::pair<CancelScope::Clock::time_point, uint64_t>;
+    struct Entry {
+        Connection* connection;
+        std::shared_ptr<std::atomic<bool>> fired;
+    };
+
+    CancelTimer() = default;
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopping_) {
+            if (entries_.empty()) {
+                wake_.wait(lock);
+                continue;
+            }
+            auto next = entries_.begin();
+            if (CancelScope::Clock::now() < next->first.first) {
+                wake_.wait_until(lock, next->first.first);
+                continue;
+            }
+
+            Entry entry = next->second;
+            firing_ = next->first.second;
+            entries_.erase(next);
+            lock.unlock();
+            raiseCancel(*entry.connection, *entry.fired);
+            lock.lock();
+            firing_ = 0;
+            fired_.notify_all();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable wake_;    // Earlier deadline armed or stopping
+    std::condition_variable fired_;   // An entry finished firing
+    std::map<Key, Entry> entries_;
+    uint64_t lastId_ = 0;
+    uint64_t firing_ = 0;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+} // namespace
+
+CancelScope::CancelScope(Connection& connection, Clock::time_point deadline)
+    : CancelScope(connection, std::optional<Clock::time_point>(deadline), std::stop_token{}) {}
+
+CancelScope::CancelScope(Connection& connection, std::stop_token stop)
+    : CancelScope(connection, std::nullopt, std::move(stop)) {}
+
+CancelScope::CancelScope(Connection& connection, std::optional<Clock::time_point> deadline,
+                         std::stop_token stop)
+    : connection_(connection)
+    , fired_(std::make_shared<std::atomic<bool>>(false)) {
+    // A cancel sent while nothing runs would not stop the call that follows.
+    if (stop.stop_requested()) {
+        throw FirebirdException("Operation cancelled before it started");
+    }
+    if (deadline && *deadline <= Clock::now()) {
+        throw FirebirdException("Operation deadline passed before it started");
+    }
+
+    if (deadline) {
+        deadline_ = *deadline;
+        timerId_ = CancelTimer::instance().arm(*deadline, connection_, fired_);
+    }
+    if (stop.stop_possible()) {
+        stopCallback_.emplace(std::move(stop), std::function<void()>(
+            [&connection = connection_, fired = fired_] { raiseCancel(connection, *fired); }));
+    }
+}
+
+CancelScope::~CancelScope() {
+    // stop_callback's destructor waits for a running callback.
+    stopCallback_.reset();
+    if (timerId_ != 0) {
+        CancelTimer::instance().cancel(deadline_, timerId_);
+    }
+}
+
+} // namespace core
+} // namespace fbpp
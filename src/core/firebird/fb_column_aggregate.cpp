@@ -0,0 +1,445 @@
+#include "fbpp/core/column_aggregate.hpp"
+#include "fbpp/core/decfloat_chars.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/int128_chars.hpp"
+
+extern "C" {
+#include "decQuad.h"
+}
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace fbpp {
+namespace core {
+
+namespace {
+
+static_assert(sizeof(decQuad) == sizeof(DecFloat34), "decQuad must match FB_DEC34");
+
+const Int128 kInt128Max = Int128::fromParts(std::numeric_limits<int64_t>::max(),
+                                            std::numeric_limits<uint64_t>::max());
+const Int128 kInt128Min = Int128::fromParts(std::numeric_limits<int64_t>::min(), 0);
+
+// No more than this many int64 halves are summed in one int64 lane: each
+// half is below 2^32 in magnitude, so 2^30 of them stay below 2^62
+constexpr std::size_t kLaneChunk = std::size_t{1} << 30;
+
+Int128 shiftedLeft32(int64_t value) noexcept {
+    return Int128::fromParts(value >> 32, static_cast<uint64_t>(value) << 32);
+}
+
+// Sum of `count` integers of at most 64 bits, exactly: as signed high
+// and unsigned low 32-bit halves, each summed in int64 lanes
+template<typename Raw>
+Int128 sumIntegers(const Raw* raw, std::size_t count) noexcept {
+    Int128 total;
+    for (std::size_t start = 0; start < count; start += kLaneChunk) {
+        const std::size_t end = std::min(count, start + kLaneChunk);
+        int64_t high = 0;
+        int64_t low = 0;
+        for (std::size_t i = start; i < end; ++i) {
+            const int64_t v = static_cast<int64_t>(raw[i]);
+            high += v >> 32;
+            low += static_cast<int64_t>(static_cast<uint64_t>(v) & 0xFFFFFFFFu);
+        }
+        total += shiftedLeft32(high) + Int128(low);
+    }
+    return total;
+}
+
+// Smallest and largest present value; NULL slots are skipped
+template<typename Raw>
+void integerExtremes(const Raw* raw, const ColumnVector& column, Raw& lo, Raw& hi) noexcept {
+    lo = std::numeric_limits<Raw>::max();
+    hi = std::numeric_limits<Raw>::min();
+    const std::size_t count = column.length;
+    if (column.nullCount == 0) {
+        for (std::size_t i = 0; i < count; ++i) {
+            lo = std::min(lo, raw[i]);
+            hi = std::max(hi, raw[i]);
+        }
+        return;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        const bool present = !column.isNull(i);
+        lo = present && raw[i] < lo ? raw[i] : lo;
+        hi = present && raw[i] > hi ? raw[i] : hi;
+    }
+}
+
+// acc += value, counting the signed carries out of 128 bits
+inline void addWithCarry(Int128& acc, const Int128& value, int64_t& carries) noexcept {
+    const bool negative = acc.isNegative();
+    const Int128 next = acc + value;
+    if (negative == value.isNegative() && next.isNegative() != negative) {
+        carries += negative ? -1 : 1;
+    }
+    acc = next;
+}
+
+struct FixedBlock {
+    Int128 sum;
+    int64_t carries = 0;
+    Int128 min = kInt128Max;
+    Int128 max = kInt128Min;
+};
+
+FixedBlock foldInt128(const Int128* values, const ColumnVector& column) noexcept {
+    FixedBlock block;
+    for (std::size_t i = 0; i < column.length; ++i) {
+        addWithCarry(block.sum, values[i], block.carries);
+    }
+    for (std::size_t i = 0; i < column.length; ++i) {
+        if (column.nullCount != 0 && column.isNull(i)) {
+            continue;
+        }
+        if (values[i] < block.min) {
+            block.min = values[i];
+        }
+        if (block.max < values[i]) {
+            block.max = values[i];
+        }
+    }
+    return block;
+}
+
+template<typename Raw>
+FixedBlock foldIntegers(const ColumnVector& column) {
+    const Raw* raw = column.view<Raw>().data();
+    FixedBlock block;
+    block.sum = sumIntegers(raw, column.length);
+    Raw lo;
+    Raw hi;
+    integerExtremes(raw, column, lo, hi);
+    block.min = Int128(static_cast<int64_t>(lo));
+    block.max = Int128(static_cast<int64_t>(hi));
+    return block;
+}
+
+// The column's values widened to INT128 (NULL slots stay 0)
+std::vector<Int128> widened(const ColumnVector& column) {
+    std::vector<Int128> values(column.length);
+    auto widen = [&](const auto* raw) {
+        for (std::size_t i = 0; i < column.length; ++i) {
+            values[i] = Int128(static_cast<int64_t>(raw[i]));
+        }
+    };
+    switch (column.type) {
+        case ColumnType::Int16: widen(column.view<int16_t>().data()); break;
+        case ColumnType::Int32: widen(column.view<int32_t>().data()); break;
+        case ColumnType::Int64: widen(column.view<int64_t>().data()); break;
+        default:
+            std::memcpy(values.data(), column.values.data(), column.length * sizeof(Int128));
+            break;
+    }
+    return values;
+}
+
+bool isFixedPoint(ColumnType type) noexcept {
+    return type == ColumnType::Int16 || type == ColumnType::Int32 ||
+           type == ColumnType::Int64 || type == ColumnType::Int128;
+}
+
+bool isDecFloat(const ColumnVector& column) noexcept {
+    return column.type == ColumnType::String &&
+           (column.sqlType == SQL_DEC16 || column.sqlType == SQL_DEC34);
+}
+
+// Firebird's DECFLOAT(34) context (see decfloat_chars.hpp)
+decContext quadContext() noexcept {
+    decContext context;
+    decContextDefault(&context, DEC_INIT_DECIMAL128);
+    context.round = DEC_ROUND_HALF_UP;
+    return context;
+}
+
+decQuad toQuad(const DecFloat34& value) noexcept {
+    decQuad quad;
+    std::memcpy(&quad, value.data(), sizeof(quad));
+    return quad;
+}
+
+DecFloat34 fromQuad(const decQuad& quad) noexcept {
+    return DecFloat34(reinterpret_cast<const uint8_t*>(&quad));
+}
+
+std::string decText(const DecFloat34& value) {
+    char buffer[kDecFloat34MaxChars];
+    const auto result = toChars(buffer, buffer + sizeof(buffer), value);
+    return std::string(buffer, result.ptr);
+}
+
+const char* domainName(ExactAggregate::Domain domain) noexcept {
+    return domain == ExactAggregate::Domain::DecFloat ? "DECFLOAT" : "fixed point";
+}
+
+} // namespace
+
+void ExactAggregate::add(const ColumnVector& column) {
+    if (isFixedPoint(column.type)) {
+        enter(Domain::FixedPoint, column.name);
+        addFixed(column);
+    } else if (isDecFloat(column)) {
+        enter(Domain::DecFloat, column.name);
+        addDecFloat(column);
+    } else {
+        throw FirebirdException("ExactAggregate: column '" + column.name +
+                                "' is not an integer, NUMERIC or DECFLOAT column");
+    }
+}
+
+void ExactAggregate::enter(Domain domain, const std::string& column) {
+    if (domain_ == Domain::None) {
+        domain_ = domain;
+        return;
+    }
+    if (domain_ != domain) {
+        throw FirebirdException(std::string("ExactAggregate: '") + column + "' is " +
+                                domainName(domain) + ", earlier values were " +
+                                domainName(domain_));
+    }
+}
+
+void ExactAggregate::refine(int scale) {
+    if (count_ != 0) {
+        if (carries_ != 0) {
+            throw FirebirdException("ExactAggregate: SUM is outside INT128 range");
+        }
+        rescaleInt128(&sum_, 1, scale_, scale, &sum_);
+        rescaleInt128(&min_, 1, scale_, scale, &min_);
+        rescaleInt128(&max_, 1, scale_, scale, &max_);
+    }
+    scale_ = scale;
+}
+
+void ExactAggregate::addFixed(const ColumnVector& column) {
+    if (count_ == 0) {
+        scale_ = column.scale;   // Nothing to carry over yet
+    }
+    if (column.scale < scale_) {
+        refine(column.scale);
+    }
+    const uint64_t present = column.length - column.nullCount;
+    if (present == 0) {
+        return;
+    }
+
+    FixedBlock block;
+    if (column.scale == scale_) {
+        switch (column.type) {
+            case ColumnType::Int16: block = foldIntegers<int16_t>(column); break;
+            case ColumnType::Int32: block = foldIntegers<int32_t>(column); break;
+            case ColumnType::Int64: block = foldIntegers<int64_t>(column); break;
+            default:
+                block = foldInt128(reinterpret_cast<const Int128*>(column.values.data()),
+                                   column);
+                break;
+        }
+    } else {
+        // Coarser than what was folded so far: bring the values down to scale_
+        std::vector<Int128> values = widened(column);
+        rescaleInt128(values.data(), values.size(), column.scale, scale_, values.data());
+        block = foldInt128(values.data(), column);
+    }
+    foldFixed(block.sum, block.carries, block.min, block.max, present);
+}
+
+void ExactAggregate::foldFixed(const Int128& sum, int64_t carries, const Int128& min,
+                               const Int128& max, uint64_t count) {
+    if (count == 0) {
+        return;
+    }
+    if (count_ == 0) {
+        sum_ = sum;
+        carries_ = carries;
+        min_ = min;
+        max_ = max;
+    } else {
+        addWithCarry(sum_, sum, carries_);
+        carries_ += carries;
+        min_ = std::min(min_, min);
+        max_ = std::max(max_, max);
+    }
+    count_ += count;
+}
+
+void ExactAggregate::addDecFloat(const ColumnVector& column) {
+    decContext parse = quadContext();
+    decContext arithmetic = quadContext();
+    decQuad sum;
+    decQuad lo;
+    decQuad hi;
+    decQuadZero(&sum);
+    uint64_t present = 0;
+    std::string text;
+
+    for (std::size_t i = 0; i < column.length; ++i) {
+        if (column.isNull(i)) {
+            continue;
+        }
+        text.assign(column.stringAt(i));
+        decQuad value;
+        decQuadFromString(&value, text.c_str(), &parse);
+        if (parse.status & DEC_IEEE_754_Invalid_operation) {
+            throw FirebirdException("ExactAggregate: invalid DECFLOAT value in '" + column.name +
+                                    "': '" + text + "'");
+        }
+        decQuadAdd(&sum, &sum, &value, &arithmetic);
+        if (present++ == 0) {
+            lo = value;
+            hi = value;
+        } else {
+            decQuadMin(&lo, &lo, &value, &arithmetic);
+            decQuadMax(&hi, &hi, &value, &arithmetic);
+        }
+    }
+    if (present == 0) {
+        return;
+    }
+    if (count_ == 0) {
+        decSum_ = fromQuad(sum);
+        decMin_ = fromQuad(lo);
+        decMax_ = fromQuad(hi);
+    } else {
+        decQuad total = toQuad(decSum_);
+        decQuad min = toQuad(decMin_);
+        decQuad max = toQuad(decMax_);
+        decQuadAdd(&total, &total, &sum, &arithmetic);
+        decQuadMin(&min, &min, &lo, &arithmetic);
+        decQuadMax(&max, &max, &hi, &arithmetic);
+        decSum_ = fromQuad(total);
+        decMin_ = fromQuad(min);
+        decMax_ = fromQuad(max);
+    }
+    decOverflow_ = decOverflow_ || (arithmetic.status & DEC_Overflow) != 0;
+    count_ += present;
+}
+
+void ExactAggregate::merge(const ExactAggregate& other) {
+    if (other.domain_ == Domain::None) {
+        return;
+    }
+    enter(other.domain_, "partial aggregate");
+
+    if (domain_ == Domain::DecFloat) {
+        if (other.count_ == 0) {
+            return;
+        }
+        decOverflow_ = decOverflow_ || other.decOverflow_;
+        if (count_ == 0) {
+            decSum_ = other.decSum_;
+            decMin_ = other.decMin_;
+            decMax_ = other.decMax_;
+            count_ = other.count_;
+            return;
+        }
+        decContext arithmetic = quadContext();
+        decQuad total = toQuad(decSum_);
+        decQuad min = toQuad(decMin_);
+        decQuad max = toQuad(decMax_);
+        const decQuad otherSum = toQuad(other.decSum_);
+        const decQuad otherMin = toQuad(other.decMin_);
+        const decQuad otherMax = toQuad(other.decMax_);
+        decQuadAdd(&total, &total, &otherSum, &arithmetic);
+        decQuadMin(&min, &min, &otherMin, &arithmetic);
+        decQuadMax(&max, &max, &otherMax, &arithmetic);
+        decSum_ = fromQuad(total);
+        decMin_ = fromQuad(min);
+        decMax_ = fromQuad(max);
+        decOverflow_ = decOverflow_ || (arithmetic.status & DEC_Overflow) != 0;
+        count_ += other.count_;
+        return;
+    }
+
+    if (count_ == 0) {
+        scale_ = other.scale_;
+    }
+    if (other.scale_ < scale_) {
+        refine(other.scale_);
+    }
+    if (other.scale_ == scale_) {
+        foldFixed(other.sum_, other.carries_, other.min_, other.max_, other.count_);
+        return;
+    }
+    ExactAggregate aligned = other;
+    aligned.refine(scale_);
+    foldFixed(aligned.sum_, aligned.carries_, aligned.min_, aligned.max_, aligned.count_);
+}
+
+void ExactAggregate::checkDomain(Domain domain, const char* what) const {
+    if (domain_ != Domain::None && domain_ != domain) {
+        throw FirebirdException(std::string("ExactAggregate::") + what + ": values are " +
+                                domainName(domain_));
+    }
+}
+
+std::optional<Int128> ExactAggregate::sum() const {
+    checkDomain(Domain::FixedPoint, "sum");
+    if (count_ == 0) {
+        return std::nullopt;
+    }
+    if (carries_ != 0) {
+        throw FirebirdException("ExactAggregate: SUM is outside INT128 range");
+    }
+    return sum_;
+}
+
+std::optional<Int128> ExactAggregate::min() const {
+    checkDomain(Domain::FixedPoint, "min");
+    return count_ == 0 ? std::nullopt : std::optional<Int128>(min_);
+}
+
+std::optional<Int128> ExactAggregate::max() const {
+    checkDomain(Domain::FixedPoint, "max");
+    return count_ == 0 ? std::nullopt : std::optional<Int128>(max_);
+}
+
+std::optional<DecFloat34> ExactAggregate::decSum() const {
+    checkDomain(Domain::DecFloat, "decSum");
+    if (count_ == 0) {
+        return std::nullopt;
+    }
+    if (decOverflow_) {
+        throw FirebirdException("ExactAggregate: SUM is outside DECFLOAT(34) range");
+    }
+    return decSum_;
+}
+
+std::optional<DecFloat34> ExactAggregate::decMin() const {
+    checkDomain(Domain::DecFloat, "decMin");
+    return count_ == 0 ? std::nullopt : std::optional<DecFloat34>(decMin_);
+}
+
+std::optional<DecFloat34> ExactAggregate::decMax() const {
+    checkDomain(Domain::DecFloat, "decMax");
+    return count_ == 0 ? std::nullopt : std::optional<DecFloat34>(decMax_);
+}
+
+std::optional<std::string> ExactAggregate::sumText() const {
+    if (domain_ == Domain::DecFloat) {
+        const auto value = decSum();
+        return value ? std::optional<std::string>(decText(*value)) : std::nullopt;
+    }
+    const auto value = sum();
+    return value ? std::optional<std::string>(int128ToString(*value, scale_)) : std::nullopt;
+}
+
+std::optional<std::string> ExactAggregate::minText() const {
+    if (domain_ == Domain::DecFloat) {
+        return count_ == 0 ? std::nullopt : std::optional<std::string>(decText(decMin_));
+    }
+    return count_ == 0 ? std::nullopt : std::optional<std::string>(int128ToString(min_, scale_));
+}
+
+std::optional<std::string> ExactAggregate::maxText() const {
+    if (domain_ == Domain::DecFloat) {
+        return count_ == 0 ? std::nullopt : std::optional<std::string>(decText(decMax_));
+    }
+    return count_ == 0 ? std::nullopt : std::optional<std::string>(int128ToString(max_, scale_));
+}
+
+} // namespace core
+} // namespace fbpp
@@ -0,0 +1,642 @@
+#include "fbpp/core/column_batch.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/detail/sql_value_codec.hpp"
+#include "fbpp/core/detail/text_scan.hpp"
+#include "fbpp/core/scaled_numeric.hpp"
+#include "fbpp/core/timestamp_utils.hpp"
+
+#include <cctype>
+#include <cstring>
+#include <limits>
+
+namespace fbpp {
+namespace core {
+
+namespace {
+
+inline bool isNullAt(const uint8_t* msg, const ColumnPlan& column) {
+    int16_t flag = 0;
+    std::memcpy(&flag, msg + column.nullOffset, sizeof(flag));
+    return flag == -1;
+}
+
+inline void setValid(ColumnVector& col, std::size_t row) {
+    col.validity[row >> 3] = static_cast<uint8_t>(col.validity[row >> 3] | (1u << (row & 7)));
+}
+
+// Fixed-width columns whose wire format already is the columnar format:
+// one memcpy per present value, zero for NULL slots.
+void decodeRaw(ColumnVector& col, const ColumnPlan& column, std::size_t width,
+               const uint8_t* rows, std::size_t stride, std::size_t rowCount) {
+    col.values.assign(rowCount * width, uint8_t{0});
+    uint8_t* out = col.values.data();
+    for (std::size_t i = 0; i < rowCount; ++i) {
+        const uint8_t* msg = rows + i * stride;
+        if (isNullAt(msg, column)) {
+            ++col.nullCount;
+            continue;
+        }
+        std::memcpy(out + i * width, msg + column.offset, width);
+        setValid(col, i);
+    }
+}
+
+// First pass of the date/time decoders: copy the leading `words` 32-bit
+// words of every value (NULL slots too, their bytes are ignored) into a
+// contiguous array and fill the validity bitmap. The conversion itself
+// then runs as one vectorizable kernel over the whole block.
+void gatherWords(ColumnVector& col, const ColumnPlan& column, std::size_t words,
+                 const uint8_t* rows, std::size_t stride, std::size_t rowCount,
+                 std::vector<uint32_t>& scratch) {
+    scratch.resize(rowCount * words);
+    uint32_t* out = scratch.data();
+    for (std::size_t i = 0; i < rowCount; ++i) {
+        const uint8_t* msg = rows + i * stride;
+        std::memcpy(out + i * words, msg + column.offset, words * sizeof(uint32_t));
+        if (isNullAt(msg, column)) {
+            ++col.nullCount;
+        } else {
+            setValid(col, i);
+        }
+    }
+}
+
+// Null slots hold zero; the kernels converted whatever bytes were there.
+template<typename T>
+void clearNullSlots(ColumnVector& col, T* values, std::size_t rowCount) {
+    if (col.nullCount == 0) {
+        return;
+    }
+    for (std::size_t i = 0; i < rowCount; ++i) {
+        if (col.isNull(i)) {
+            values[i] = T{};
+        }
+    }
+}
+
+// WITH TIME ZONE values keep their Firebird zone id next to the UTC value.
+void gatherZoneIds(ColumnVector& col, const ColumnPlan& column, std::size_t zoneOffset,
+                   const uint8_t* rows, std::size_t stride, std::size_t rowCount) {
+    col.zoneIds.assign(rowCount, uint16_t{0});
+    for (std::size_t i = 0; i < rowCount; ++i) {
+        const uint8_t* msg = rows + i * stride;
+        if (!col.isNull(i)) {
+            std::memcpy(&col.zoneIds[i], msg + column.offset + zoneOffset, sizeof(uint16_t));
+        }
+    }
+}
+
+void decodeDate(ColumnVector& col, const ColumnPlan& column,
+                const uint8_t* rows, std::size_t stride, std::size_t rowCount,
+                std::vector<uint32_t>& scratch) {
+    gatherWords(col, column, 1, rows, stride, rowCount, scratch);
+    col.values.resize(rowCount * sizeof(int32_t));
+    auto* out = reinterpret_cast<int32_t*>(col.values.data());
+    timestamp_utils::firebird_dates_to_unix_days(scratch.data(), rowCount, out);
+    clearNullSlots(col, out, rowCount);
+}
+
+// TIME and TIME WITH TIME ZONE: the first 4 bytes are the (UTC) ISC_TIME.
+void decodeTime(ColumnVector& col, const ColumnPlan& column,
+                const uint8_t* rows, std::size_t stride, std::size_t rowCount,
+                std::vector<uint32_t>& scratch) {
+    gatherWords(col, column, 1, rows, stride, rowCount, scratch);
+    col.values.resize(rowCount * sizeof(int64_t));
+    auto* out = reinterpret_cast<int64_t*>(col.values.data());
+    timestamp_utils::firebird_times_to_micros(scratch.data(), rowCount, out);
+    clearNullSlots(col, out, rowCount);
+    if (col.sqlType == SQL_TIME_TZ) {
+        gatherZoneIds(col, column, 4, rows, stride, rowCount);
+    }
+}
+
+// TIMESTAMP and TIMESTAMP WITH TIME ZONE: the first 8 bytes are the (UTC)
+// ISC_DATE + ISC_TIME pair.
+void decodeTimestamp(ColumnVector& col, const ColumnPlan& column,
+                     const uint8_t* rows, std::size_t stride, std::size_t rowCount,
+                     std::vector<uint32_t>& scratch) {
+    gatherWords(col, column, 2, rows, stride, rowCount, scratch);
+    col.values.resize(rowCount * sizeof(int64_t));
+    auto* out = reinterpret_cast<int64_t*>(col.values.data());
+    timestamp_utils::firebird_timestamps_to_unix_micros(scratch.data(), rowCount, out);
+    clearNullSlots(col, out, rowCount);
+    if (col.sqlType == SQL_TIMESTAMP_TZ) {
+        gatherZoneIds(col, column, 8, rows, stride, rowCount);
+    }
+}
+
+// CHAR / VARCHAR: bytes are copied straight out of the fetch buffers. A
+// first pass sizes the column so the copy pass appends without regrowing.
+void decodeText(ColumnVector& col, const ColumnPlan& column,
+                const uint8_t* rows, std::size_t stride, std::size_t rowCount) {
+    col.values.clear();
+    col.offsets.assign(rowCount + 1, 0);
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < rowCount; ++i) {
+        const uint8_t* msg = rows + i * stride;
+        if (!isNullAt(msg, column)) {
+            total += detail::textView(*column.field, msg + column.offset).size();
+        }
+    }
+    if (total > static_cast<std::size_t>(std::numeric_limits<int32_t>::max())) {
+        throw FirebirdException("Column '" + col.name +
+                                "' exceeds 2 GiB in a single batch; use a smaller batchSize");
+    }
+    col.values.reserve(total);
+    for (std::size_t i = 0; i < rowCount; ++i) {
+        const uint8_t* msg = rows + i * stride;
+        if (isNullAt(msg, column)) {
+            ++col.nullCount;
+        } else {
+            const std::string_view text = detail::textView(*column.field, msg + column.offset);
+            col.values.insert(col.values.end(), text.begin(), text.end());
+            setValid(col, i);
+        }
+        col.offsets[i + 1] = static_cast<int32_t>(col.values.size());
+    }
+}
+
+// Variable-width columns with no bytes to view in place (DECFLOAT text,
+// BLOB contents) go through the shared codec; CHAR / VARCHAR never get here
+// (decodeText). The scratch string is reused across rows, so steady-state
+// decoding does not allocate per value.
+void decodeVariable(ColumnVector& col, const ColumnPlan& column,
+                    const uint8_t* rows, std::size_t stride, std::size_t rowCount,
+                    Transaction* transaction) {
+    col.values.clear();
+    col.offsets.assign(rowCount + 1, 0);
+    std::string scratch;
+    for (std::size_t i = 0; i < rowCount; ++i) {
+        const uint8_t* msg = rows + i * stride;
+        const auto* nullPtr = reinterpret_cast<const int16_t*>(msg + column.nullOffset);
+        if (isNullAt(msg, column)) {
+            ++col.nullCount;
+        } else {
+            detail::sql_value_codec::SqlReadContext ctx{column.field, transaction, nullPtr};
+            detail::sql_value_codec::read_sql_value(ctx, msg + column.offset, scratch);
+            col.values.insert(col.values.end(), scratch.begin(), scratch.end());
+            setValid(col, i);
+        }
+        if (col.values.size() > static_cast<std::size_t>(std::numeric_limits<int32_t>::max())) {
+            throw FirebirdException("Column '" + col.name +
+                                    "' exceeds 2 GiB in a single batch; use a smaller batchSize");
+        }
+        col.offsets[i + 1] = static_cast<int32_t>(col.values.size());
+    }
+}
+
+// Run fn(const T*) over an integer column's values
+template<typename Fn>
+void withIntegerValues(const ColumnVector& col, const char* what, Fn&& fn) {
+    switch (col.type) {
+        case ColumnType::Int16: fn(reinterpret_cast<const int16_t*>(col.values.data())); return;
+        case ColumnType::Int32: fn(reinterpret_cast<const int32_t*>(col.values.data())); return;
+        case ColumnType::Int64: fn(reinterpret_cast<const int64_t*>(col.values.data())); return;
+        default:
+            throw FirebirdException(std::string(what) + ": column '" + col.name +
+                                    "' is not an integer / NUMERIC column");
+    }
+}
+
+// Encoding (Batch::addColumns): the decoders above, run backwards.
+
+constexpr uint16_t kUtcZoneId = 23 * 60 + 59;   // "+00:00"
+
+inline unsigned fieldType(const ColumnPlan& column) noexcept {
+    return column.type & ~1u;
+}
+
+inline bool isIntegerColumn(ColumnType type) noexcept {
+    return type == ColumnType::Int16 || type == ColumnType::Int32 || type == ColumnType::Int64;
+}
+
+inline bool isIntegerField(const ColumnPlan& column) noexcept {
+    const unsigned type = fieldType(column);
+    return type == SQL_SHORT || type == SQL_LONG || type == SQL_INT64;
+}
+
+inline void setNullFlag(uint8_t* msg, const ColumnPlan& column, bool null) {
+    const int16_t flag = null ? -1 : 0;
+    std::memcpy(msg + column.nullOffset, &flag, sizeof(flag));
+}
+
+// Columns whose columnar format already is the wire format: one memcpy
+// per present value.
+void encodeRaw(const ColumnVector& col, const ColumnPlan& column, std::size_t width,
+               std::size_t first, uint8_t* rows, std::size_t stride, std::size_t count) {
+    const uint8_t* in = col.values.data() + first * width;
+    for (std::size_t i = 0; i < count; ++i) {
+        uint8_t* msg = rows + i * stride;
+        const bool null = col.isNull(first + i);
+        setNullFlag(msg, column, null);
+        if (!null) {
+            std::memcpy(msg + column.offset, in + i * width, width);
+        }
+    }
+}
+
+// Last pass of the date/time encoders: the kernel has converted the whole
+// block into `scratch`; copy `words` 32-bit words per present row.
+void scatterWords(const ColumnVector& col, const ColumnPlan& column, std::size_t words,
+                  const std::vector<uint32_t>& scratch, std::size_t first,
+                  uint8_t* rows, std::size_t stride, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        uint8_t* msg = rows + i * stride;
+        const bool null = col.isNull(first + i);
+        setNullFlag(msg, column, null);
+        if (!null) {
+            std::memcpy(msg + column.offset, scratch.data() + i * words,
+                        words * sizeof(uint32_t));
+        }
+    }
+}
+
+// WITH TIME ZONE fields: the zone id follows the UTC value.
+void scatterZoneIds(const ColumnVector& col, const ColumnPlan& column, std::size_t zoneOffset,
+                    std::size_t first, uint8_t* rows, std::size_t stride, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        if (!col.isNull(first + i)) {
+            const uint16_t zone = col.zoneIds.empty() ? kUtcZoneId : col.zoneIds[first + i];
+            std::memcpy(rows + i * stride + column.offset + zoneOffset, &zone, sizeof(zone));
+        }
+    }
+}
+
+void encodeDate(const ColumnVector& col, const ColumnPlan& column, std::size_t first,
+                uint8_t* rows, std::size_t stride, std::size_t count,
+                std::vector<uint32_t>& scratch) {
+    scratch.resize(count);
+    const auto* days = reinterpret_cast<const int32_t*>(col.values.data()) + first;
+    timestamp_utils::unix_days_to_firebird_dates(days, count, scratch.data());
+    scatterWords(col, column, 1, scratch, first, rows, stride, count);
+}
+
+void encodeTime(const ColumnVector& col, const ColumnPlan& column, std::size_t first,
+                uint8_t* rows, std::size_t stride, std::size_t count,
+                std::vector<uint32_t>& scratch) {
+    scratch.resize(count);
+    const auto* micros = reinterpret_cast<const int64_t*>(col.values.data()) + first;
+    timestamp_utils::micros_to_firebird_times(micros, count, scratch.data());
+    scatterWords(col, column, 1, scratch, first, rows, stride, count);
+    if (fieldType(column) == SQL_TIME_TZ) {
+        scatterZoneIds(col, column, 4, first, rows, stride, count);
+    }
+}
+
+void encodeTimestamp(const ColumnVector& col, const ColumnPlan& column, std::size_t first,
+                     uint8_t* rows, std::size_t stride, std::size_t count,
+                     std::vector<uint32_t>& scratch) {
+    scratch.resize(count * 2);
+    const auto* micros = reinterpret_cast<const int64_t*>(col.values.data()) + first;
+    timestamp_utils::unix_micros_to_firebird_timestamps(micros, count, scratch.data());
+    scatterWords(col, column, 2, scratch, first, rows, stride, count);
+    if (fieldType(column) == SQL_TIMESTAMP_TZ) {
+        scatterZoneIds(col, column, 8, first, rows, stride, count);
+    }
+}
+
+template<typename T>
+void storeNarrowed(const ColumnVector& col, const ColumnPlan& column, const int64_t* values,
+                   const char* sqlTypeName, std::size_t first, uint8_t* rows,
+                   std::size_t stride, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        uint8_t* msg = rows + i * stride;
+        const bool null = col.isNull(first + i);
+        setNullFlag(msg, column, null);
+        if (null) {
+            continue;
+        }
+        if constexpr (sizeof(T) < sizeof(int64_t)) {
+            if (values[i] < std::numeric_limits<T>::min() ||
+                values[i] > std::numeric_limits<T>::max()) {
+                throw FirebirdException("Column '" + col.name + "': value out of range for " +
+                                        sqlTypeName);
+            }
+        }
+        const T value = static_cast<T>(values[i]);
+        std::memcpy(msg + column.offset, &value, sizeof(value));
+    }
+}
+
+// Integer / NUMERIC columns of another width or scale than the field:
+// one exact rescale over the block, then a range-checked store.
+void encodeInteger(const ColumnVector& col, const ColumnPlan& column, std::size_t first,
+                   uint8_t* rows, std::size_t stride, std::size_t count,
+                   std::vector<int64_t>& scratch) {
+    scratch.resize(count);
+    withIntegerValues(col, "Batch::addColumns", [&](const auto* raw) {
+        rescaleNumeric(raw + first, count, col.scale, column.scale, scratch.data());
+    });
+    switch (fieldType(column)) {
+        case SQL_SHORT:
+            storeNarrowed<int16_t>(col, column, scratch.data(), "SMALLINT", first, rows, stride,
+                                   count);
+            return;
+        case SQL_LONG:
+            storeNarrowed<int32_t>(col, column, scratch.data(), "INTEGER", first, rows, stride,
+                                   count);
+            return;
+        default:
+            storeNarrowed<int64_t>(col, column, scratch.data(), "BIGINT", first, rows, stride,
+                                   count);
+            return;
+    }
+}
+
+inline std::string_view bytesAt(const ColumnVector& col, std::size_t row) noexcept {
+    const auto begin = static_cast<std::size_t>(col.offsets[row]);
+    const auto end = static_cast<std::size_t>(col.offsets[row + 1]);
+    return {reinterpret_cast<const char*>(col.values.data()) + begin, end - begin};
+}
+
+// CHAR / VARCHAR: bytes straight into the message, CHAR padded with spaces.
+void encodeText(const ColumnVector& col, const ColumnPlan& column, std::size_t first,
+                uint8_t* rows, std::size_t stride, std::size_t count) {
+    const FieldInfo& field = *column.field;
+    for (std::size_t i = 0; i < count; ++i) {
+        uint8_t* msg = rows + i * stride;
+        const bool null = col.isNull(first + i);
+        setNullFlag(msg, column, null);
+        if (null) {
+            continue;
+        }
+        const std::string_view text = bytesAt(col, first + i);
+        if (text.size() > field.length) {
+            throw FirebirdException("String value too long for field " + field.name + ": " +
+                                    std::to_string(text.size()) + " bytes, field holds " +
+                                    std::to_string(field.length) + " bytes");
+        }
+        uint8_t* out = msg + column.offset;
+        if (field.type == SQL_TEXT) {
+            std::memcpy(out, text.data(), text.size());
+            std::memset(out + text.size(), ' ', field.length - text.size());
+        } else {
+            const auto used = static_cast<uint16_t>(text.size());
+            std::memcpy(out, &used, sizeof(used));
+            std::memcpy(out + sizeof(used), text.data(), text.size());
+        }
+    }
+}
+
+// Other String fields (DECFLOAT) parse through the shared codec; the
+// scratch string is reused across rows.
+void encodeVariable(const ColumnVector& col, const ColumnPlan& column, std::size_t first,
+                    uint8_t* rows, std::size_t stride, std::size_t count) {
+    std::string scratch;
+    for (std::size_t i = 0; i < count; ++i) {
+        uint8_t* msg = rows + i * stride;
+        const bool null = col.isNull(first + i);
+        setNullFlag(msg, column, null);
+        if (null) {
+            continue;
+        }
+        scratch.assign(bytesAt(col, first + i));
+        auto* nullPtr = reinterpret_cast<int16_t*>(msg + column.nullOffset);
+        detail::sql_value_codec::SqlWriteContext ctx{column.field, nullptr, nullPtr};
+        detail::sql_value_codec::write_sql_value(ctx, scratch, msg + column.offset);
+    }
+}
+
+void encodeBlob(const ColumnVector& col, const ColumnPlan& column, std::size_t first,
+                uint8_t* rows, std::size_t stride, std::size_t count,
+                const std::function<ISC_QUAD(std::string_view)>& blobId) {
+    for (std::size_t i = 0; i < count; ++i) {
+        uint8_t* msg = rows + i * stride;
+        const bool null = col.isNull(first + i);
+        setNullFlag(msg, column, null);
+        if (null) {
+            continue;
+        }
+        if (!blobId) {
+            throw FirebirdException("Column '" + col.name + "': BLOB values need a BLOB writer");
+        }
+        const ISC_QUAD id = blobId(bytesAt(col, first + i));
+        std::memcpy(msg + column.offset, &id, sizeof(id));
+    }
+}
+
+bool asciiEqualsNoCase(std::string_view a, std::string_view b) noexcept {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (std::toupper(static_cast<unsigned char>(a[i])) !=
+            std::toupper(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+ColumnType columnTypeFor(const ColumnPlan& column) {
+    switch (column.type & ~1u) {
+        case SQL_BOOLEAN:      return ColumnType::Boolean;
+        case SQL_SHORT:        return ColumnType::Int16;
+        case SQL_LONG:         return ColumnType::Int32;
+        case SQL_INT64:        return ColumnType::Int64;
+        case SQL_INT128:       return ColumnType::Int128;
+        case SQL_FLOAT:        return ColumnType::Float;
+        case SQL_DOUBLE:
+        case SQL_D_FLOAT:      return ColumnType::Double;
+        case SQL_TYPE_DATE:    return ColumnType::Date;
+        case SQL_TYPE_TIME:
+        case SQL_TIME_TZ:      return ColumnType::Time;
+        case SQL_TIMESTAMP:
+        case SQL_TIMESTAMP_TZ: return ColumnType::Timestamp;
+        case SQL_TEXT:
+        case SQL_VARYING:
+        case SQL_DEC16:
+        case SQL_DEC34:        return ColumnType::String;
+        case SQL_BLOB:
+            return column.subType == 1 ? ColumnType::String : ColumnType::Binary;
+        default:
+            throw FirebirdException("No columnar mapping for SQL type " +
+                                    std::to_string(column.type));
+    }
+}
+
+std::size_t columnValueWidth(ColumnType type) noexcept {
+    switch (type) {
+        case ColumnType::Boolean:   return 1;
+        case ColumnType::Int16:     return 2;
+        case ColumnType::Int32:     return 4;
+        case ColumnType::Int64:     return 8;
+        case ColumnType::Int128:    return 16;
+        case ColumnType::Float:     return 4;
+        case ColumnType::Double:    return 8;
+        case ColumnType::Date:      return 4;
+        case ColumnType::Time:      return 8;
+        case ColumnType::Timestamp: return 8;
+        case ColumnType::String:
+        case ColumnType::Binary:    return 0;
+    }
+    return 0;
+}
+
+const ColumnVector* ColumnBatch::find(std::string_view name) const noexcept {
+    for (const auto& col : columns) {
+        if (asciiEqualsNoCase(col.name, name)) {
+            return &col;
+        }
+    }
+    return nullptr;
+}
+
+void numericToDouble(const ColumnVector& col, double* out) {
+    withIntegerValues(col, "numericToDouble", [&](const auto* raw) {
+        scaledToDouble(raw, col.length, col.scale, out);
+    });
+}
+
+void numericToInt64(const ColumnVector& col, int scale, int64_t* out) {
+    withIntegerValues(col, "numericToInt64", [&](const auto* raw) {
+        rescaleNumeric(raw, col.length, col.scale, scale, out);
+    });
+}
+
+namespace detail {
+
+void decodeColumnBatch(const MessageMetadata& metadata,
+                       const uint8_t* rows,
+                       std::size_t stride,
+                       std::size_t rowCount,
+                       Transaction* transaction,
+                       ColumnBatch& batch) {
+    const auto& plan = metadata.getColumnPlan();
+
+    batch.rowCount = rowCount;
+    batch.columns.resize(plan.size());
+    std::vector<uint32_t> scratch;   // Date/time gather buffer, shared by all columns
+
+    for (std::size_t c = 0; c < plan.size(); ++c) {
+        const ColumnPlan& column = plan[c];
+        ColumnVector& col = batch.columns[c];
+
+        col.name = displayName(*column.field);
+        col.type = columnTypeFor(column);
+        col.sqlType = column.type & ~1u;
+        col.scale = column.scale;
+        col.length = rowCount;
+        col.nullCount = 0;
+        col.validity.assign((rowCount + 7) / 8, uint8_t{0});
+        if (columnValueWidth(col.type) != 0) {
+            col.offsets.clear();
+        }
+        col.zoneIds.clear();
+
+        switch (col.type) {
+            case ColumnType::Date:
+                decodeDate(col, column, rows, stride, rowCount, scratch);
+                break;
+            case ColumnType::Time:
+                decodeTime(col, column, rows, stride, rowCount, scratch);
+                break;
+            case ColumnType::Timestamp:
+                decodeTimestamp(col, column, rows, stride, rowCount, scratch);
+                break;
+            case ColumnType::String:
+            case ColumnType::Binary:
+                if (detail::isTextField(*column.field)) {
+                    decodeText(col, column, rows, stride, rowCount);
+                    break;
+                }
+                decodeVariable(col, column, rows, stride, rowCount, transaction);
+                break;
+            default:
+                decodeRaw(col, column, columnValueWidth(col.type), rows, stride, rowCount);
+                break;
+        }
+    }
+}
+
+void checkColumnEncoding(const MessageMetadata& metadata, const ColumnBatch& batch) {
+    const auto& plan = metadata.getColumnPlan();
+    if (batch.columns.size() != plan.size()) {
+        throw FirebirdException("Batch::addColumns: " + std::to_string(batch.columns.size()) +
+                                " columns for " + std::to_string(plan.size()) + " parameters");
+    }
+
+    for (std::size_t c = 0; c < plan.size(); ++c) {
+        const ColumnPlan& column = plan[c];
+        const ColumnVector& col = batch.columns[c];
+        const ColumnType expected = columnTypeFor(column);
+        const std::size_t width = columnValueWidth(col.type);
+
+        const bool sameScale = expected != ColumnType::Int128 || col.scale == column.scale;
+        const bool fits =
+            (col.type == expected && sameScale) ||
+            (isIntegerColumn(col.type) && isIntegerField(column)) ||
+            (width == 0 && fieldType(column) == SQL_BLOB);
+        if (!fits) {
+            throw FirebirdException("Batch::addColumns: column '" + col.name +
+                                    "' does not fit parameter " + std::to_string(c + 1) +
+                                    " (SQL type " + std::to_string(fieldType(column)) + ")");
+        }
+
+        const bool sized =
+            col.length == batch.rowCount && col.validity.size() >= (col.length + 7) / 8 &&
+            (width != 0 ? col.values.size() >= col.length * width
+                        : col.offsets.size() == col.length + 1 &&
+                              static_cast<std::size_t>(col.offsets.back()) <= col.values.size()) &&
+            (col.zoneIds.empty() || col.zoneIds.size() >= col.length);
+        if (!sized) {
+            throw FirebirdException("Batch::addColumns: buffers of column '" + col.name +
+                                    "' do not hold " + std::to_string(batch.rowCount) + " rows");
+        }
+    }
+}
+
+void encodeColumnBatch(const MessageMetadata& metadata,
+                       const ColumnBatch& batch,
+                       std::size_t firstRow,
+                       std::size_t rowCount,
+                       uint8_t* rows,
+                       std::size_t stride,
+                       const std::function<ISC_QUAD(std::string_view)>& blobId) {
+    const auto& plan = metadata.getColumnPlan();
+    std::vector<uint32_t> words;     // Date/time kernel output, shared by all columns
+    std::vector<int64_t> scaled;     // Rescaled integers, shared by all columns
+
+    for (std::size_t c = 0; c < plan.size(); ++c) {
+        const ColumnPlan& column = plan[c];
+        const ColumnVector& col = batch.columns[c];
+
+        switch (col.type) {
+            case ColumnType::Date:
+                encodeDate(col, column, firstRow, rows, stride, rowCount, words);
+                break;
+            case ColumnType::Time:
+                encodeTime(col, column, firstRow, rows, stride, rowCount, words);
+                break;
+            case ColumnType::Timestamp:
+                encodeTimestamp(col, column, firstRow, rows, stride, rowCount, words);
+                break;
+            case ColumnType::String:
+            case ColumnType::Binary:
+                if (fieldType(column) == SQL_BLOB) {
+                    encodeBlob(col, column, firstRow, rows, stride, rowCount, blobId);
+                } else if (detail::isTextField(*column.field)) {
+                    encodeText(col, column, firstRow, rows, stride, rowCount);
+                } else {
+                    encodeVariable(col, column, firstRow, rows, stride, rowCount);
+                }
+                break;
+            default:
+                if (isIntegerColumn(col.type) &&
+                    (col.type != columnTypeFor(column) || col.scale != column.scale)) {
+                    encodeInteger(col, column, firstRow, rows, stride, rowCount, scaled);
+                    break;
+                }
+                encodeRaw(col, column, columnValueWidth(col.type), firstRow, rows, stride,
+                          rowCount);
+                break;
+        }
+    }
+}
+
+} // namespace detail
+
+} // namespace core
+} // namespace fbpp
@@ -1,17 +1,132 @@
 #include "fbpp/core/connection.hpp"
 #include "fbpp/core/statement.hpp"
 #include "fbpp/core/statement_cache.hpp"
+#include "fbpp/core/statement_template.hpp"
 #include "fbpp/core/named_param_parser.hpp"
+#include "fbpp/core/procedure_call.hpp"
 #include "fbpp/core/exception.hpp"
+#include "fbpp/core/executor.hpp"
+#include "fbpp/core/span_observer.hpp"
+#include "fbpp/core/startup_profile.hpp"
 #include "fbpp/core/status_utils.hpp"
+#include "fbpp/core/detail/deferred_release.hpp"
+#include "fbpp/core/detail/event_hub.hpp"
 #include "fbpp/core/detail/firebird_raii.hpp"
+#include "fbpp/core/detail/inline_blob.hpp"
 #include "fbpp_util/trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <map>
 #include <stdexcept>
 #include <tuple>
 
 namespace fbpp {
 namespace core {
 
+namespace {
+
+// Upper bound for the attachment counters info buffer (see getServerCounters)
+constexpr size_t kMaxServerCountersInfo = 1024 * 1024;
+
+// GDS codes of an attachment that is gone (see iberror.h)
+constexpr int kConnectionLostCodes[] = {
+    335544344,   // isc_bad_db_handle
+    335544528,   // isc_shutdown
+    335544648,   // isc_conn_lost
+    335544721,   // isc_network_error
+    335544726,   // isc_net_read_err
+    335544727,   // isc_net_write_err
+    335544741,   // isc_lost_db_connection
+    335544856    // isc_att_shutdown
+};
+
+// A statement prepared before a schema change ran into it
+constexpr int kMetadataChangedCodes[] = {
+    335544351,   // isc_no_meta_update
+    335544395,   // isc_relnotdef
+    335544396,   // isc_fldnotdef
+    335544453,   // isc_obj_in_use
+    335544578,   // isc_dsql_field_err
+    335544580,   // isc_dsql_relation_err
+    335544581    // isc_dsql_procedure_err
+};
+
+template<std::size_t N>
+bool hasAnyCode(const FirebirdException& error, const int (&codes)[N]) {
+    const auto first = std::begin(codes);
+    const auto last = std::end(codes);
+    for (const auto& entry : error.getStatusVector()) {
+        if (entry.tag == isc_arg_gds &&
+            std::find(first, last, static_cast<int>(entry.numericValue)) != last) {
+            return true;
+        }
+    }
+    return std::find(first, last, error.getErrorCode()) != last;
+}
+
+// Info buffers carry little-endian integers of the clumplet's own length.
+uint64_t readInfoInt(const unsigned char* p, unsigned length) {
+    uint64_t value = 0;
+    for (unsigned i = 0; i < length && i < sizeof(value); ++i) {
+        value |= static_cast<uint64_t>(p[i]) << (8 * i);
+    }
+    return value;
+}
+
+// DPB items shared by attach and create: providers, wire protocol, page
+// cache and parallel workers.
+void insertWireOptions(Firebird::IXpbBuilder* dpb, Firebird::ThrowStatusWrapper& st,
+                       const ConnectionParams& params) {
+    const auto& wire = params.wire;
+    std::string config;
+    if (!params.providers.empty()) {
+        config += "Providers = " + params.providers + "\n";
+    }
+    if (wire.compression) {
+        config += "WireCompression = true\n";
+    }
+    switch (wire.crypt) {
+        case WireCrypt::Default:
+            break;
+        case WireCrypt::Disabled:
+            config += "WireCrypt = Disabled\n";
+            break;
+        case WireCrypt::Enabled:
+            config += "WireCrypt = Enabled\n";
+            break;
+        case WireCrypt::Required:
+            config += "WireCrypt = Required\n";
+            break;
+    }
+    if (wire.remoteBufferSize != 0) {
+        config += "TcpRemoteBufferSize = " + std::to_string(wire.remoteBufferSize) + "\n";
+    }
+    if (!wire.config.empty()) {
+        config += wire.config;
+    }
+    if (!config.empty()) {
+        dpb->insertString(&st, isc_dpb_config, config.c_str());
+    }
+
+    if (wire.connectTimeoutSeconds != 0) {
+        dpb->insertInt(&st, isc_dpb_connect_timeout, static_cast<int>(wire.connectTimeoutSeconds));
+    }
+    if (wire.keepAliveSeconds != 0) {
+        dpb->insertInt(&st, isc_dpb_dummy_packet_interval, static_cast<int>(wire.keepAliveSeconds));
+    }
+    if (params.pageBuffers != 0) {
+        dpb->insertInt(&st, isc_dpb_num_buffers, static_cast<int>(params.pageBuffers));
+    }
+    if (params.parallelWorkers != 0) {
+        dpb->insertInt(&st, isc_dpb_parallel_workers, static_cast<int>(params.parallelWorkers));
+    }
+}
+
+} // namespace
+
 Connection::Connection(const std::string& database)
     : env_(Environment::getInstance())
     , status_(env_.getMaster()->getStatus())
@@ -19,6 +134,7 @@ Connection::Connection(const std::string& database)
     ConnectionParams params;
     params.database = database;
     connect(params);
+    startWarmup();
 }
 
 Connection::Connection(const ConnectionParams& params)
@@ -27,13 +143,41 @@ Connection::Connection(const ConnectionParams& params)
     , statusWrapper_(status_)
     , options_(params.options) {
     connect(params);
+    startWarmup();
 }
 
 Connection::~Connection() {
+    // The warm-up task uses the cache and the attachment.
+    warmupCancel_.store(true, std::memory_order_relaxed);
+    waitForWarmup();
+
+    // Event registrations live on the attachment; the dispatcher calls it.
+    if (events_) {
+        events_->shutdown();
+    }
+
+    // A read-only transaction has nothing to undo: commit is the cheap end.
+    if (readTransaction_) {
+        try {
+            if (readTransaction_->isActive()) {
+                readTransaction_->Commit();
+            }
+        } catch (...) {
+            // Ignore errors during destructor
+        }
+        readTransaction_.reset();
+    }
+
+    // Queued handles go first; statements freed from here on free at once.
+    if (releases_) {
+        releases_->close();
+    }
+
     // Free cached statements while the attachment is still alive —
     // statementCache_ is a member and would otherwise be destroyed AFTER
     // the destructor body, calling IStatement::free() on a detached
     // attachment.
+    dropStatementSlots();
     if (statementCache_) {
         try {
             statementCache_->clear();
@@ -49,6 +193,15 @@ Connection::~Connection() {
 void Connection::connect(const ConnectionParams& params) {
     fbpp::util::trace(fbpp::util::TraceLevel::info, "Connection",
                 [&](auto& oss) { oss << "Connecting to " << params.database; });
+    params_ = params;
+    templateScope_ = params.database + '\n' + params.charset + '\n' +
+                     std::to_string(params.sql_dialect);
+    // The counter first: a change landing in between is then seen again
+    schemaChanges_ = StatementTemplateRegistry::instance().schemaChanges();
+    schemaEpoch_ = StatementTemplateRegistry::instance().schemaEpoch(templateScope_);
+    detail::SpanScope span(SpanKind::Connect);
+    span.start({}, 0, params.database);
+    const auto started = std::chrono::steady_clock::now();
     try {
         auto& st = status();
 
@@ -81,7 +234,11 @@ void Connection::connect(const ConnectionParams& params) {
             dpb->insertInt(&st, isc_dpb_sql_dialect, params.sql_dialect);
         }
 
+        insertWireOptions(dpb.get(), st, params);
+
         // Attach to database
+        databaseInfo_.reset();
+        tuning_.reset();
         attachment_ = env_.getProvider()->attachDatabase(
             &st,
             params.database.c_str(),
@@ -94,8 +251,23 @@ void Connection::connect(const ConnectionParams& params) {
             throw FirebirdException("Failed to attach to database: " + params.database);
         }
 
+        if (params.options.maxInlineBlobSize != 0 &&
+            !detail::trySetMaxInlineBlobSize(attachment_, st, params.options.maxInlineBlobSize)) {
+            fbpp::util::trace(fbpp::util::TraceLevel::info, "Connection",
+                        [](auto& oss) { oss << "Inline BLOBs not supported by client library"; });
+        }
+
+        releases_ = std::make_shared<detail::DeferredRelease>();
+        applyHandleRelease();
+        detail::recordStartupPhase(StartupPhase::FirstAttach, started);
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - started);
         fbpp::util::trace(fbpp::util::TraceLevel::info, "Connection",
-                    [&](auto& oss) { oss << "Connected to " << params.database; });
+                    [&](auto& oss) {
+                        oss << "Connected to " << params.database << " in "
+                            << elapsed.count() / 1000.0 << " ms";
+                    });
     }
     catch (const Firebird::FbException& e) {
         fbpp::util::trace(fbpp::util::TraceLevel::error, "Connection",
@@ -106,6 +278,315 @@ void Connection::connect(const ConnectionParams& params) {
     }
 }
 
+std::future<std::unique_ptr<Connection>> Connection::connectAsync(ConnectionParams params) {
+    auto promise = std::make_shared<std::promise<std::unique_ptr<Connection>>>();
+    auto future = promise->get_future();
+    Executor::shared()->post([promise, params = std::move(params)] {
+        try {
+            promise->set_value(std::make_unique<Connection>(params));
+        } catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+    });
+    return future;
+}
+
+std::vector<std::unique_ptr<Connection>> Connection::connectMany(const ConnectionParams& params,
+                                                                 size_t count,
+                                                                 size_t parallelism) {
+    std::vector<std::unique_ptr<Connection>> connections(count);
+    if (count == 0) {
+        return connections;
+    }
+    const size_t workers = parallelism == 0 ? count : std::min(parallelism, count);
+    if (workers == 1) {
+        for (auto& connection : connections) {
+            connection = std::make_unique<Connection>(params);
+        }
+        return connections;
+    }
+
+    const auto started = std::chrono::steady_clock::now();
+    std::vector<std::exception_ptr> errors(count);
+    std::atomic<size_t> next{0};
+    {
+        std::vector<std::thread> threads;
+        threads.reserve(workers);
+        for (size_t w = 0; w < workers; ++w) {
+            threads.emplace_back([&] {
+                for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+                    try {
+                        connections[i] = std::make_unique<Connection>(params);
+                    } catch (...) {
+                        errors[i] = std::current_exception();
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    for (auto& error : errors) {
+        if (error) {
+            connections.clear();
+            std::rethrow_exception(error);
+        }
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started);
+    fbpp::util::trace(fbpp::util::TraceLevel::info, "Connection",
+                [&](auto& oss) {
+                    oss << "Opened " << count << " connections to " << params.database
+                        << " (" << workers << " in parallel) in "
+                        << elapsed.count() / 1000.0 << " ms";
+                });
+    return connections;
+}
+
+void Connection::startWarmup() {
+    const auto& config = options_.statementCache;
+    if (config.warmupFile.empty() || config.warmupTopN == 0 || !config.enabled) {
+        return;
+    }
+
+    std::vector<StatementCache::HotEntry> entries;
+    try {
+        if (!std::filesystem::exists(config.warmupFile)) {
+            // First start: nothing exported yet.
+            fbpp::util::trace(fbpp::util::TraceLevel::info, "Connection",
+                        [&](auto& oss) { oss << "No statement hot-set file " << config.warmupFile; });
+            return;
+        }
+        entries = StatementCache::loadHotSet(config.warmupFile);
+    } catch (const std::exception& e) {
+        // A stale or damaged hot-set file must not prevent connecting.
+        fbpp::util::trace(fbpp::util::TraceLevel::warn, "Connection",
+                    [&](auto& oss) { oss << "Statement warm-up disabled: " << e.what(); });
+        return;
+    }
+    if (entries.size() > config.warmupTopN) {
+        entries.resize(config.warmupTopN);
+    }
+    if (entries.empty()) {
+        return;
+    }
+
+    // Created here, before a second thread exists: the lazy initialization
+    // in prepareStatement() is not synchronized.
+    if (!statementCache_) {
+        statementCache_ = std::make_unique<StatementCache>(config);
+    }
+    startWarmupThread(std::move(entries), config.warmupInBackground);
+}
+
+void Connection::startWarmupThread(std::vector<StatementCache::HotEntry> entries,
+                                   bool background) {
+    if (!background) {
+        statementCache_->warmUp(this, entries);
+        return;
+    }
+
+    auto warmup = std::make_unique<TaskGroup>(*Executor::shared());
+    warmup->run([this, entries = std::move(entries)] {
+        try {
+            statementCache_->warmUp(this, entries, &warmupCancel_);
+        } catch (...) {
+            // warmUp() skips failing entries; nothing may escape the task.
+        }
+    });
+    warmup_ = std::move(warmup);
+}
+
+void Connection::waitForWarmup() {
+    if (warmup_) {
+        warmup_->wait();
+        warmup_.reset();
+    }
+}
+
+void Connection::saveStatementHotSet(const std::string& path, size_t limit) const {
+    if (statementCache_) {
+        statementCache_->saveHotSet(path, limit);
+    } else {
+        StatementCache().saveHotSet(path, limit);
+    }
+}
+
+bool Connection::isConnectionLost(const FirebirdException& error) {
+    return hasAnyCode(error, kConnectionLostCodes);
+}
+
+bool Connection::isMetadataChanged(const FirebirdException& error) {
+    return hasAnyCode(error, kMetadataChangedCodes);
+}
+
+void Connection::noteRequestFailure(const FirebirdException& error) noexcept {
+    if (isConnectionLost(error)) {
+        lost_.store(true, std::memory_order_relaxed);
+    }
+}
+
+void Connection::noteSchemaError(const FirebirdException& error) noexcept {
+    if (!options_.statementCache.followSchemaChanges || !isMetadataChanged(error)) {
+        return;
+    }
+    try {
+        auto& registry = StatementTemplateRegistry::instance();
+        // One change, many failing statements: only a failure under the
+        // current epoch announces a new one; the others catch up below.
+        if (registry.schemaEpoch(templateScope_) == schemaEpoch_) {
+            registry.invalidate(templateScope_);
+            fbpp::util::trace(fbpp::util::TraceLevel::warn, "Connection",
+                        [&](auto& oss) {
+                            oss << "Schema change detected (" << error.getErrorCode()
+                                << "); cached statements of " << params_.database
+                                << " will be prepared again";
+                        });
+        }
+    } catch (...) {
+        // Reporting the request's own error matters more
+    }
+}
+
+void Connection::syncSchema() {
+    auto& registry = StatementTemplateRegistry::instance();
+    const uint64_t changes = registry.schemaChanges();
+    if (changes == schemaChanges_) {
+        return;
+    }
+    schemaChanges_ = changes;
+    if (!options_.statementCache.followSchemaChanges) {
+        return;
+    }
+    const uint64_t epoch = registry.schemaEpoch(templateScope_);
+    if (epoch != schemaEpoch_) {
+        invalidateStatements(epoch);
+    }
+}
+
+void Connection::invalidateStatements(uint64_t epoch) {
+    schemaEpoch_ = epoch;
+    // A warm-up still running prepares against the old schema
+    warmupCancel_.store(true, std::memory_order_relaxed);
+    waitForWarmup();
+    warmupCancel_.store(false, std::memory_order_relaxed);
+
+    dropStatementSlots();
+    if (!statementCache_) {
+        return;
+    }
+    const StatementCacheConfig& config = options_.statementCache;
+    std::vector<StatementCache::HotEntry> hot;
+    if (config.followSchemaChanges && config.schemaReprepareTopN != 0) {
+        hot = statementCache_->getHotSet(config.schemaReprepareTopN);
+    }
+    statementCache_->clear();
+    fbpp::util::trace(fbpp::util::TraceLevel::info, "Connection",
+                [&](auto& oss) {
+                    oss << "Schema epoch " << epoch << ": statement cache emptied; preparing "
+                        << hot.size() << " hot statement(s) again";
+                });
+    if (!hot.empty() && config.enabled) {
+        // Foreground prepares of the same keys single-flight with these
+        startWarmupThread(std::move(hot), true);
+    }
+}
+
+void Connection::reconnectIfLost() {
+    if (options_.reconnect.enabled && lost_.load(std::memory_order_relaxed)) {
+        reconnect();
+    }
+}
+
+template<typename Fn>
+auto Connection::withReconnect(Fn&& fn) -> decltype(fn()) {
+    reconnectIfLost();
+    try {
+        return fn();
+    } catch (const FirebirdException& e) {
+        noteRequestFailure(e);
+        if (!options_.reconnect.enabled || !lost_.load(std::memory_order_relaxed)) {
+            throw;
+        }
+    }
+    reconnect();
+    return fn();
+}
+
+void Connection::reconnect() {
+    const ReconnectPolicy& policy = options_.reconnect;
+    lost_.store(true, std::memory_order_relaxed);
+
+    // A warm-up or re-prepare still running uses the old attachment
+    warmupCancel_.store(true, std::memory_order_relaxed);
+    waitForWarmup();
+    warmupCancel_.store(false, std::memory_order_relaxed);
+
+    // Everything bound to the old attachment goes with it
+    if (events_) {
+        events_->shutdown();
+        events_.reset();
+    }
+    readTransaction_.reset();
+    readTransactionUses_ = 0;
+    if (releases_) {
+        releases_->close();
+    }
+    disconnect();
+
+    ConnectionParams params = params_;
+    params.options = options_;
+    const unsigned attempts = std::max(policy.maxAttempts, 1u);
+    std::chrono::milliseconds backoff = policy.initialBackoff;
+    const auto started = std::chrono::steady_clock::now();
+    for (unsigned attempt = 1;; ++attempt) {
+        try {
+            connect(params);
+            break;
+        } catch (const FirebirdException& e) {
+            if (attempt >= attempts || !isConnectionLost(e)) {
+                fbpp::util::trace(fbpp::util::TraceLevel::error, "Connection",
+                            [&](auto& oss) {
+                                oss << "Reconnect to " << params.database << " gave up after "
+                                    << attempt << " attempt(s): " << e.what();
+                            });
+                throw;
+            }
+        }
+        if (backoff.count() > 0) {
+            std::this_thread::sleep_for(backoff);
+        }
+        backoff = std::min(backoff * 2, std::max(policy.maxBackoff, policy.initialBackoff));
+    }
+
+    // Handles still out re-prepare on their next use (Statement::revalidate)
+    generation_.fetch_add(1, std::memory_order_acq_rel);
+    lost_.store(false, std::memory_order_relaxed);
+
+    std::vector<StatementCache::HotEntry> hot;
+    dropStatementSlots();
+    if (statementCache_) {
+        if (policy.reprepareTopN != 0) {
+            hot = statementCache_->getHotSet(policy.reprepareTopN);
+        }
+        statementCache_->clear();
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started);
+    fbpp::util::trace(fbpp::util::TraceLevel::warn, "Connection",
+                [&](auto& oss) {
+                    oss << "Reconnected to " << params.database << " in "
+                        << elapsed.count() / 1000.0 << " ms; preparing " << hot.size()
+                        << " hot statement(s) again";
+                });
+    if (!hot.empty() && options_.statementCache.enabled) {
+        startWarmupThread(std::move(hot), policy.reprepareInBackground);
+    }
+}
+
 void Connection::disconnect() {
     if (attachment_) {
         try {
@@ -125,82 +606,142 @@ void Connection::disconnect() {
 }
 
 std::shared_ptr<Transaction> Connection::Execute(const std::string& sql) {
-    if (!attachment_) {
-        fbpp::util::trace(fbpp::util::TraceLevel::error, "Connection",
-                    [&](auto& oss) {
-                        oss << "Cannot execute SQL (not connected): "
-                            << sql.substr(0, 100);
-                    });
-        throw FirebirdException("Not connected to database");
-    }
-
-    try {
-        auto& st = status();
-
-        // Start transaction
-        Firebird::ITransaction* tra = attachment_->startTransaction(&st, 0, nullptr);
-        if (!tra) {
-            throw FirebirdException("Failed to start transaction");
+    return withReconnect([&] {
+        if (!attachment_) {
+            fbpp::util::trace(fbpp::util::TraceLevel::error, "Connection",
+                        [&](auto& oss) {
+                            oss << "Cannot execute SQL (not connected): "
+                                << sql.substr(0, 100);
+                        });
+            throw FirebirdException("Not connected to database");
         }
 
-        // From here on the started transaction must not leak: prepare()
-        // and execute() THROW on failure (ThrowStatusWrapper), they do not
-        // return null — so cleanup has to live in a catch block, not in
-        // null checks.
         try {
-            Firebird::IStatement* stmt = attachment_->prepare(
-                &st, tra, 0, sql.c_str(), 3, 0);
+            auto& st = status();
 
-            if (!stmt) {
-                fbpp::util::trace(fbpp::util::TraceLevel::error, "Connection",
-                            [&](auto& oss) {
-                                oss << "Failed to prepare SQL statement: "
-                                    << sql.substr(0, 100);
-                            });
-                throw FirebirdException("Failed to prepare SQL statement");
+            // Start transaction
+            Firebird::ITransaction* tra = attachment_->startTransaction(&st, 0, nullptr);
+            if (!tra) {
+                throw FirebirdException("Failed to start transaction");
             }
 
+            // From here on the started transaction must not leak: prepare()
+            // and execute() THROW on failure (ThrowStatusWrapper), they do not
+            // return null — so cleanup has to live in a catch block, not in
+            // null checks.
             try {
-                stmt->execute(&st, tra, nullptr, nullptr, nullptr, nullptr);
-                stmt->free(&st);
-                stmt->release();
+                Firebird::IStatement* stmt = attachment_->prepare(
+                    &st, tra, 0, sql.c_str(), 3, 0);
+
+                if (!stmt) {
+                    fbpp::util::trace(fbpp::util::TraceLevel::error, "Connection",
+                                [&](auto& oss) {
+                                    oss << "Failed to prepare SQL statement: "
+                                        << sql.substr(0, 100);
+                                });
+                    throw FirebirdException("Failed to prepare SQL statement");
+                }
+
+                try {
+                    stmt->execute(&st, tra, nullptr, nullptr, nullptr, nullptr);
+                    stmt->free(&st);
+                    stmt->release();
+                }
+                catch (...) {
+                    stmt->release();
+                    throw;
+                }
+
+                // Return transaction for commit/rollback
+                return std::make_shared<Transaction>(this, tra);
             }
             catch (...) {
-                stmt->release();
+                // Roll back and release the otherwise-leaked transaction
+                // (server-side it would hold locks until detach).
+                try {
+                    tra->rollback(&st);
+                } catch (...) { /* best effort */ }
+                tra->release();
                 throw;
             }
+        }
+        catch (const Firebird::FbException& e) {
+            throw FirebirdException(e);
+        }
+    });
+}
+
+std::shared_ptr<Transaction> Connection::StartTransaction() {
+    return withReconnect([&] {
+        if (!attachment_) {
+            throw FirebirdException("Not connected to database");
+        }
+
+        try {
+            releaseDeferredHandles();
+            auto& st = status();
+
+            Firebird::ITransaction* tra = attachment_->startTransaction(&st, 0, nullptr);
+            if (!tra) {
+                throw FirebirdException("Failed to start transaction");
+            }
 
-            // Return transaction for commit/rollback
             return std::make_shared<Transaction>(this, tra);
         }
-        catch (...) {
-            // Roll back and release the otherwise-leaked transaction
-            // (server-side it would hold locks until detach).
-            try {
-                tra->rollback(&st);
-            } catch (...) { /* best effort */ }
-            tra->release();
-            throw;
+        catch (const Firebird::FbException& e) {
+            throw FirebirdException(e);
         }
-    }
-    catch (const Firebird::FbException& e) {
-        throw FirebirdException(e);
-    }
+    });
 }
 
-std::shared_ptr<Transaction> Connection::StartTransaction() {
+std::shared_ptr<Transaction> Connection::StartTransaction(const TransactionOptions& options) {
+    return withReconnect([&] {
+        if (!attachment_) {
+            throw FirebirdException("Not connected to database");
+        }
+
+        try {
+            releaseDeferredHandles();
+            const auto& tpb = transactionParameters(options);
+            auto& st = status();
+
+            Firebird::ITransaction* tra = attachment_->startTransaction(
+                &st, static_cast<unsigned>(tpb.size()), tpb.data());
+            if (!tra) {
+                throw FirebirdException("Failed to start transaction");
+            }
+
+            return std::make_shared<Transaction>(this, tra);
+        }
+        catch (const Firebird::FbException& e) {
+            throw FirebirdException(e);
+        }
+    });
+}
+
+std::shared_ptr<Transaction> Connection::reconnectTransaction(uint64_t id) {
     if (!attachment_) {
         throw FirebirdException("Not connected to database");
     }
 
+    // The engine reads the id in native byte order, 4 bytes while it fits
+    unsigned char buffer[sizeof(uint64_t)];
+    unsigned length = sizeof(uint64_t);
+    if (id <= UINT32_MAX) {
+        const uint32_t narrow = static_cast<uint32_t>(id);
+        std::memcpy(buffer, &narrow, sizeof(narrow));
+        length = sizeof(narrow);
+    } else {
+        std::memcpy(buffer, &id, sizeof(id));
+    }
+
     try {
+        releaseDeferredHandles();
         auto& st = status();
-
-        Firebird::ITransaction* tra = attachment_->startTransaction(&st, 0, nullptr);
+        Firebird::ITransaction* tra = attachment_->reconnectTransaction(&st, length, buffer);
         if (!tra) {
-            throw FirebirdException("Failed to start transaction");
+            throw FirebirdException("Failed to reconnect transaction " + std::to_string(id));
         }
-
         return std::make_shared<Transaction>(this, tra);
     }
     catch (const Firebird::FbException& e) {
@@ -208,6 +749,94 @@ std::shared_ptr<Transaction> Connection::StartTransaction() {
     }
 }
 
+std::shared_ptr<Transaction> Connection::readTransaction() {
+    reconnectIfLost();
+    if (readTransaction_ && readTransaction_->isActive()) {
+        const unsigned refresh = options_.readTransactionRefresh;
+        if (refresh != 0 && ++readTransactionUses_ >= refresh) {
+            readTransactionUses_ = 0;
+            readTransaction_->CommitRetaining();
+        }
+        return readTransaction_;
+    }
+
+    TransactionOptions options = TransactionOptions::readOnlyReadCommitted();
+    if (getEngineMajorVersion() < 4) {
+        options.isolation = TxIsolation::ReadCommittedRecordVersion;
+    }
+    readTransaction_ = StartTransaction(options);
+    readTransactionUses_ = 0;
+    fbpp::util::trace(fbpp::util::TraceLevel::info, "Connection",
+                [](auto& oss) { oss << "Started shared read transaction"; });
+    return readTransaction_;
+}
+
+const std::vector<unsigned char>& Connection::transactionParameters(const TransactionOptions& options) {
+    for (const auto& [cached, tpb] : tpbCache_) {
+        if (cached == options) {
+            return tpb;
+        }
+    }
+
+    if (options.lockTimeoutSeconds && !options.wait) {
+        throw FirebirdException("TransactionOptions: lockTimeoutSeconds requires wait");
+    }
+    if (options.atSnapshotNumber && options.isolation != TxIsolation::Concurrency) {
+        throw FirebirdException("TransactionOptions: atSnapshotNumber requires Concurrency isolation");
+    }
+
+    auto& st = status();
+    detail::XpbBuilderGuard tpb(env_.getUtil()->getXpbBuilder(
+        &st, Firebird::IXpbBuilder::TPB, nullptr, 0));
+
+    switch (options.isolation) {
+        case TxIsolation::Concurrency:
+            tpb->insertTag(&st, isc_tpb_concurrency);
+            break;
+        case TxIsolation::Consistency:
+            tpb->insertTag(&st, isc_tpb_consistency);
+            break;
+        case TxIsolation::ReadCommittedRecordVersion:
+            tpb->insertTag(&st, isc_tpb_read_committed);
+            tpb->insertTag(&st, isc_tpb_rec_version);
+            break;
+        case TxIsolation::ReadCommittedNoRecordVersion:
+            tpb->insertTag(&st, isc_tpb_read_committed);
+            tpb->insertTag(&st, isc_tpb_no_rec_version);
+            break;
+        case TxIsolation::ReadCommittedReadConsistency:
+            tpb->insertTag(&st, isc_tpb_read_committed);
+#ifdef isc_tpb_read_consistency
+            tpb->insertTag(&st, isc_tpb_read_consistency);
+#else
+            tpb->insertTag(&st, 22);   // isc_tpb_read_consistency, pre-4.0 headers
+#endif
+            break;
+    }
+
+    tpb->insertTag(&st, options.readOnly ? isc_tpb_read : isc_tpb_write);
+    tpb->insertTag(&st, options.wait ? isc_tpb_wait : isc_tpb_nowait);
+    if (options.lockTimeoutSeconds) {
+        tpb->insertInt(&st, isc_tpb_lock_timeout, static_cast<int>(*options.lockTimeoutSeconds));
+    }
+    if (options.noAutoUndo) {
+        tpb->insertTag(&st, isc_tpb_no_auto_undo);
+    }
+    if (options.atSnapshotNumber) {
+#ifdef isc_tpb_at_snapshot_number
+        const unsigned char tag = isc_tpb_at_snapshot_number;
+#else
+        const unsigned char tag = 23;   // isc_tpb_at_snapshot_number, pre-4.0 headers
+#endif
+        tpb->insertBigInt(&st, tag, static_cast<ISC_INT64>(*options.atSnapshotNumber));
+    }
+
+    const auto* buffer = tpb->getBuffer(&st);
+    tpbCache_.emplace_back(options, std::vector<unsigned char>(
+        buffer, buffer + tpb->getBufferLength(&st)));
+    return tpbCache_.back().second;
+}
+
 void Connection::ExecuteInTransaction(Transaction* tra, const std::string& sql) {
     if (!attachment_) {
         throw FirebirdException("Not connected to database");
@@ -228,6 +857,82 @@ void Connection::ExecuteInTransaction(Transaction* tra, const std::string& sql)
     }
 }
 
+void Connection::executeOnce(Transaction* transaction, const std::string& sql) {
+    executeOnceMessage(transaction, sql, nullptr, nullptr);
+}
+
+std::unique_ptr<ResultSet> Connection::openCursorOnce(
+    const std::shared_ptr<Transaction>& transaction, const std::string& sql) {
+    return openCursorOnceMessage(transaction, sql, nullptr, nullptr);
+}
+
+void Connection::executeOnceMessage(Transaction* transaction, const std::string& sql,
+                                    const MessageMetadata* input, const uint8_t* buffer) {
+    if (!attachment_) {
+        throw FirebirdException("Not connected to database");
+    }
+    if (!transaction || !transaction->isActive()) {
+        throw FirebirdException("Transaction is not active");
+    }
+
+    releaseDeferredHandles();
+    try {
+        // No IStatement: one round trip, nothing enters the statement cache
+        attachment_->execute(&status(), transaction->getTransaction(), 0, sql.c_str(), 3,
+                             input ? input->getRawMetadata() : nullptr,
+                             const_cast<uint8_t*>(buffer), nullptr, nullptr);
+    } catch (const Firebird::FbException& e) {
+        FirebirdException error(e);
+        noteRequestFailure(error);
+        throw error;
+    }
+}
+
+std::unique_ptr<ResultSet> Connection::openCursorOnceMessage(
+    const std::shared_ptr<Transaction>& transaction, const std::string& sql,
+    const MessageMetadata* input, const uint8_t* buffer) {
+    if (!attachment_) {
+        throw FirebirdException("Not connected to database");
+    }
+    if (!transaction || !transaction->isActive()) {
+        throw FirebirdException("Transaction is not active");
+    }
+
+    releaseDeferredHandles();
+    Firebird::IResultSet* cursor = nullptr;
+    try {
+        auto& st = status();
+        cursor = attachment_->openCursor(&st, transaction->getTransaction(), 0, sql.c_str(), 3,
+                                         input ? input->getRawMetadata() : nullptr,
+                                         const_cast<uint8_t*>(buffer), nullptr, nullptr, 0);
+        if (!cursor) {
+            throw FirebirdException("Failed to open cursor");
+        }
+        // The row format comes with the cursor, as the server described it
+        auto metadata = std::make_shared<MessageMetadata>(cursor->getMetadata(&st));
+        unsigned prefetch = transferTuning().prefetchFor(metadata->getAlignedLength());
+        auto resultSet = std::make_unique<ResultSet>(cursor, std::move(metadata), transaction);
+        cursor = nullptr;
+        if (prefetch > 1) {
+            resultSet->setPrefetch(prefetch);
+        }
+        resultSet->trackMemory(memory_);
+        return resultSet;
+    } catch (...) {
+        if (cursor) {
+            try { cursor->close(&status()); } catch (...) { /* best effort */ }
+            cursor->release();
+        }
+        try {
+            throw;
+        } catch (const Firebird::FbException& e) {
+            FirebirdException error(e);
+            noteRequestFailure(error);
+            throw error;
+        }
+    }
+}
+
 bool Connection::isConnected() const {
     if (!attachment_) {
         return false;
@@ -288,6 +993,41 @@ void Connection::cancelOperation(CancelOperation option) {
     }
 }
 
+std::unique_ptr<EventSubscription> Connection::subscribeEvents(std::vector<std::string> names,
+                                                           EventSubscription::Callback callback) {
+    if (!callback) {
+        throw FirebirdException("subscribeEvents: empty callback");
+    }
+    return subscribeEventBatches(std::move(names),
+        [callback = std::move(callback)](const std::vector<EventNotification>& events) {
+            for (const auto& event : events) {
+                callback(event.name, event.count);
+            }
+        });
+}
+
+std::unique_ptr<EventSubscription> Connection::subscribeEventBatches(std::vector<std::string> names,
+                                                                 EventSubscription::BatchCallback callback) {
+    if (!attachment_) {
+        throw FirebirdException("Cannot subscribe to events: not connected");
+    }
+    if (!callback) {
+        throw FirebirdException("subscribeEvents: empty callback");
+    }
+    if (!events_) {
+        events_ = std::make_shared<detail::EventHub>(env_, attachment_, options_.eventBatchWindow,
+                                                     options_.eventNamesPerRegistration);
+    }
+    const std::uint64_t id = events_->subscribe(names, std::move(callback));
+    fbpp::util::trace(fbpp::util::TraceLevel::info, "Connection",
+                [&](auto& oss) { oss << "Subscribed to " << names.size() << " event name(s)"; });
+    return std::unique_ptr<EventSubscription>(new EventSubscription(events_, id, std::move(names)));
+}
+
+EventStatistics Connection::getEventStatistics() const {
+    return events_ ? events_->statistics() : EventStatistics{};
+}
+
 void Connection::ExecuteDDL(const std::string& ddl) {
     auto tra = StartTransaction();
     ExecuteInTransaction(tra.get(), ddl);
@@ -295,9 +1035,10 @@ void Connection::ExecuteDDL(const std::string& ddl) {
 
     // Schema may have changed: cached statements keep stale formats and
     // metadata after ALTER/DROP, producing obscure engine errors on reuse.
-    if (statementCache_) {
-        statementCache_->clear();
-    }
+    // Other connections to this database must stop reusing layouts
+    // decoded before the change, and empty their caches on their next
+    // prepare (StatementCacheConfig::followSchemaChanges).
+    invalidateStatements(StatementTemplateRegistry::instance().invalidate(templateScope_));
 }
 
 // Static methods for database management
@@ -344,6 +1085,7 @@ void Connection::createDatabase(const ConnectionParams& params) {
         }
 
         dpb->insertInt(&st, isc_dpb_page_size, 8192);
+        insertWireOptions(dpb.get(), st, params);
 
         // Create database
         Firebird::IAttachment* att = env.getProvider()->createDatabase(
@@ -473,17 +1215,98 @@ bool Connection::databaseExists(const std::string& database, const ConnectionPar
 
 // prepareStatement now uses cache by default for better performance
 std::shared_ptr<Statement> Connection::prepareStatement(const std::string& sql, unsigned flags) {
-    if (!attachment_) {
-        throw FirebirdException("Not connected to database");
-    }
+    return withReconnect([&] {
+        if (!attachment_) {
+            throw FirebirdException("Not connected to database");
+        }
 
-    // Lazy initialization of cache
-    if (!statementCache_) {
-        statementCache_ = std::make_unique<StatementCache>(options_.statementCache);
+        // Lazy initialization of cache
+        if (!statementCache_) {
+            statementCache_ = std::make_unique<StatementCache>(options_.statementCache);
+        }
+
+        releaseDeferredHandles();
+        syncSchema();
+        checkMemoryLimit();
+        // Get or create cached statement
+        return statementCache_->get(this, sql, flags);
+    });
+}
+
+std::shared_ptr<Statement> Connection::prepareStatement(const SqlKey& key) {
+    return withReconnect([&] {
+        if (!attachment_) {
+            throw FirebirdException("Not connected to database");
+        }
+
+        if (!statementCache_) {
+            statementCache_ = std::make_unique<StatementCache>(options_.statementCache);
+        }
+
+        releaseDeferredHandles();
+        syncSchema();
+        checkMemoryLimit();
+        return statementCache_->get(this, key);
+    });
+}
+
+std::shared_ptr<Statement> Connection::prepareStatement(const SqlKey& key, size_t slot) {
+    if (!options_.statementCache.enabled) {
+        return prepareStatement(key);
+    }
+    if (slot < statementSlots_.size()) {
+        // Only the slot holds it: nobody is executing it or fetching from it
+        const auto& held = statementSlots_[slot];
+        if (held && held.use_count() == 1 && held->isValid() && attachment_ &&
+            !lost_.load(std::memory_order_relaxed) &&
+            StatementTemplateRegistry::instance().schemaChanges() == schemaChanges_) {
+            releaseDeferredHandles();
+            return held;
+        }
+    }
+    auto statement = prepareStatement(key);
+    if (slot >= statementSlots_.size()) {
+        statementSlots_.resize(slot + 1);
     }
+    auto& held = statementSlots_[slot];
+    if (!held || !held->isValid()) {
+        held = statement;
+    }
+    return statement;
+}
+
+StatementLease Connection::leaseStatement(const std::string& sql, unsigned flags) {
+    return withReconnect([&] {
+        if (!attachment_) {
+            throw FirebirdException("Not connected to database");
+        }
 
-    // Get or create cached statement
-    return statementCache_->get(this, sql, flags);
+        if (!statementCache_) {
+            statementCache_ = std::make_unique<StatementCache>(options_.statementCache);
+        }
+
+        releaseDeferredHandles();
+        syncSchema();
+        checkMemoryLimit();
+        return statementCache_->lease(this, sql, flags);
+    });
+}
+
+StatementLease Connection::leaseStatement(const SqlKey& key) {
+    return withReconnect([&] {
+        if (!attachment_) {
+            throw FirebirdException("Not connected to database");
+        }
+
+        if (!statementCache_) {
+            statementCache_ = std::make_unique<StatementCache>(options_.statementCache);
+        }
+
+        releaseDeferredHandles();
+        syncSchema();
+        checkMemoryLimit();
+        return statementCache_->lease(this, key);
+    });
 }
 
 std::shared_ptr<Statement> Connection::prepareStatementUncached(
@@ -492,10 +1315,17 @@ std::shared_ptr<Statement> Connection::prepareStatementUncached(
         throw FirebirdException("Not connected to database");
     }
 
-    auto parseResult = NamedParamParser::parse(sql);
+    const auto parsed = NamedParamParser::parseCached(sql);
+    const auto& parseResult = *parsed;
     const std::string& actualSql =
         parseResult.hasNamedParams ? parseResult.convertedSql : sql;
 
+    releaseDeferredHandles();
+    detail::SpanScope span(SpanKind::Prepare);
+    if (span.active()) {
+        span.start(actualSql, SqlKey::hashOf(actualSql, 0));
+    }
+    const auto startupStarted = detail::startupClock(StartupPhase::FirstPrepare);
     auto tra = StartTransaction();
     Firebird::IStatement* rawStmt = nullptr;
     try {
@@ -505,7 +1335,7 @@ std::shared_ptr<Statement> Connection::prepareStatementUncached(
             0,
             actualSql.c_str(),
             3,
-            flags);
+            prepareFlags(flags));
     } catch (const Firebird::FbException& e) {
         throw FirebirdException(e);
     }
@@ -516,9 +1346,11 @@ std::shared_ptr<Statement> Connection::prepareStatementUncached(
     }
 
     auto stmt = std::make_shared<Statement>(rawStmt, this);
+    stmt->setSql(actualSql, flags);
     if (parseResult.hasNamedParams) {
         stmt->setNamedParamMapping(parseResult.nameToPositions, true);
     }
+    detail::recordStartupPhase(StartupPhase::FirstPrepare, startupStarted);
     return stmt;
 }
 
@@ -590,6 +1422,90 @@ int Connection::getEngineMajorVersion() const {
     return engineMajor_;
 }
 
+DatabaseInfo Connection::getDatabaseInfo() const {
+    if (!attachment_) {
+        throw FirebirdException("Not connected to database");
+    }
+
+    static const unsigned char items[] = {
+        isc_info_page_size, isc_info_ods_version, isc_info_ods_minor_version,
+        isc_info_firebird_version, fb_info_protocol_version, fb_info_conn_flags
+    };
+    unsigned char buffer[512] = {};
+    try {
+        attachment_->getInfo(&status(), sizeof(items), items, sizeof(buffer), buffer);
+    } catch (const Firebird::FbException& e) {
+        throw FirebirdException(e);
+    }
+
+    // Items an older server does not know come back as isc_info_error;
+    // they stay at their defaults
+    DatabaseInfo info;
+    const unsigned char* p = buffer;
+    const unsigned char* end = buffer + sizeof(buffer);
+    while (p + 3 <= end && *p != isc_info_end) {
+        const unsigned char item = *p;
+        if (item == isc_info_truncated || item == isc_info_error) {
+            break;
+        }
+        const unsigned length = static_cast<unsigned>(readInfoInt(p + 1, 2));
+        p += 3;
+        if (p + length > end) {
+            break;
+        }
+        switch (item) {
+            case isc_info_page_size:
+                info.pageSize = static_cast<unsigned>(readInfoInt(p, length));
+                break;
+            case isc_info_ods_version:
+                info.odsMajor = static_cast<unsigned>(readInfoInt(p, length));
+                break;
+            case isc_info_ods_minor_version:
+                info.odsMinor = static_cast<unsigned>(readInfoInt(p, length));
+                break;
+            case isc_info_firebird_version:
+                // (count, then length + text per layer); the first is the server's
+                if (length >= 2 && p[0] > 0 && 2u + p[1] <= length) {
+                    info.serverVersion.assign(reinterpret_cast<const char*>(p + 2), p[1]);
+                }
+                break;
+            case fb_info_protocol_version:
+                info.protocolVersion = static_cast<unsigned>(readInfoInt(p, length));
+                break;
+            case fb_info_conn_flags: {
+                const auto flags = readInfoInt(p, length);
+                info.compressed = (flags & isc_dpb_addr_flag_conn_compressed) != 0;
+                info.encrypted = (flags & isc_dpb_addr_flag_conn_encrypted) != 0;
+                break;
+            }
+            default:
+                break;
+        }
+        p += length;
+    }
+    return info;
+}
+
+const TransferTuning& Connection::transferTuning() const {
+    if (!tuning_) {
+        const TransferOptions& options = options_.transfer;
+        const bool needsInfo = options.autoTune &&
+            (!options.blobReadBytes || !options.batchChunkBytes || !options.prefetchRows);
+        if (needsInfo && !databaseInfo_ && attachment_) {
+            try {
+                databaseInfo_ = getDatabaseInfo();
+            } catch (const FirebirdException& e) {
+                // Nothing known: choose() keeps the library defaults
+                fbpp::util::trace(fbpp::util::TraceLevel::warn, "Connection",
+                            [&](auto& oss) { oss << "Database info unavailable: " << e.what(); });
+                databaseInfo_ = DatabaseInfo{};
+            }
+        }
+        tuning_ = TransferTuning::choose(databaseInfo_.value_or(DatabaseInfo{}), options);
+    }
+    return *tuning_;
+}
+
 // ---------------------------------------------------------------------------
 // Procedure metadata
 // ---------------------------------------------------------------------------
@@ -612,34 +1528,6 @@ std::string trimAscii(std::string s) {
     return s.substr(b);
 }
 
-std::string renderProbeSql(const ProcedureInfo& info, unsigned inputCount) {
-    // Quote identifiers so case-sensitive procedure names round-trip.
-    auto quote = [](const std::string& id) {
-        return "\"" + id + "\"";
-    };
-    std::string qualified;
-    if (!info.packageName.empty()) {
-        qualified = quote(info.packageName) + "." + quote(info.name);
-    } else {
-        qualified = quote(info.name);
-    }
-
-    std::string args;
-    if (inputCount > 0) {
-        args = "(";
-        for (unsigned i = 0; i < inputCount; ++i) {
-            if (i > 0) args += ',';
-            args += '?';
-        }
-        args += ")";
-    }
-
-    if (info.kind == ProcedureKind::Selectable) {
-        return "SELECT * FROM " + qualified + args;
-    }
-    return "EXECUTE PROCEDURE " + qualified + args;
-}
-
 } // namespace
 
 std::vector<ProcedureInfo> Connection::listProcedures() {
@@ -760,7 +1648,7 @@ ProcedureInfo Connection::describeProcedure(const std::string& name,
     // unsafe. Callers that genuinely want soft-mode should catch
     // FirebirdException themselves and fall back to listProcedures().
     QueryMetadataInfo probe = describeQuery(
-        renderProbeSql(info, static_cast<unsigned>(inputCount)));
+        renderProcedureCallSql(info, static_cast<unsigned>(inputCount)));
 
     info.params.reserve(probe.inputFields.size() + probe.outputFields.size());
     for (size_t i = 0; i < probe.inputFields.size(); ++i) {
@@ -787,6 +1675,7 @@ ProcedureInfo Connection::describeProcedure(const std::string& name,
 }
 
 void Connection::clearStatementCache() {
+    dropStatementSlots();
     if (statementCache_) {
         statementCache_->clear();
     }
@@ -801,12 +1690,207 @@ StatementCache::Statistics Connection::getCacheStatistics() const {
     return StatementCache::Statistics{};
 }
 
+std::vector<StatementMetricsSnapshot> Connection::getStatementMetrics(size_t limit) const {
+    if (statementCache_) {
+        return statementCache_->getMetrics(limit);
+    }
+    return {};
+}
+
+void Connection::traceStatementMetrics(fbpp::util::TraceLevel level, size_t limit) const {
+    if (statementCache_) {
+        statementCache_->traceMetrics(level, limit);
+    }
+}
+
+ServerCounters Connection::getServerCounters() const {
+    if (!attachment_) {
+        throw FirebirdException("Not connected to database");
+    }
+
+    static const unsigned char items[] = {
+        isc_info_reads, isc_info_writes, isc_info_fetches, isc_info_marks,
+        isc_info_read_seq_count, isc_info_read_idx_count, isc_info_insert_count,
+        isc_info_update_count, isc_info_delete_count, isc_info_backout_count,
+        isc_info_purge_count, isc_info_expunge_count
+    };
+
+    // Per-table items carry 6 bytes per touched table: grow the buffer
+    // until the answer fits.
+    std::vector<unsigned char> buffer(1024);
+    for (;;) {
+        try {
+            attachment_->getInfo(&status(), sizeof(items), items,
+                                 static_cast<unsigned>(buffer.size()), buffer.data());
+        } catch (const Firebird::FbException& e) {
+            throw FirebirdException(e);
+        }
+        if (buffer[0] != isc_info_truncated) {
+            break;
+        }
+        if (buffer.size() >= kMaxServerCountersInfo) {
+            throw FirebirdException("Attachment counters do not fit the info buffer");
+        }
+        buffer.resize(buffer.size() * 4);
+    }
+
+    ServerCounters counters;
+    std::map<uint16_t, TableRecordCounters> tables;
+    const unsigned char* p = buffer.data();
+    const unsigned char* end = p + buffer.size();
+    while (p + 3 <= end && *p != isc_info_end) {
+        const unsigned char item = *p;
+        if (item == isc_info_truncated || item == isc_info_error) {
+            throw FirebirdException("Attachment counters info request failed");
+        }
+        const unsigned length = static_cast<unsigned>(readInfoInt(p + 1, 2));
+        p += 3;
+        if (p + length > end) {
+            break;
+        }
+
+        uint64_t TableRecordCounters::*field = nullptr;
+        switch (item) {
+            case isc_info_reads:   counters.reads = readInfoInt(p, length); break;
+            case isc_info_writes:  counters.writes = readInfoInt(p, length); break;
+            case isc_info_fetches: counters.fetches = readInfoInt(p, length); break;
+            case isc_info_marks:   counters.marks = readInfoInt(p, length); break;
+            case isc_info_read_seq_count: field = &TableRecordCounters::seqReads; break;
+            case isc_info_read_idx_count: field = &TableRecordCounters::idxReads; break;
+            case isc_info_insert_count:   field = &TableRecordCounters::inserts; break;
+            case isc_info_update_count:   field = &TableRecordCounters::updates; break;
+            case isc_info_delete_count:   field = &TableRecordCounters::deletes; break;
+            case isc_info_backout_count:  field = &TableRecordCounters::backouts; break;
+            case isc_info_purge_count:    field = &TableRecordCounters::purges; break;
+            case isc_info_expunge_count:  field = &TableRecordCounters::expunges; break;
+            default: break;
+        }
+        if (field) {
+            // (relation id: 2 bytes, count: 4 bytes) per table
+            for (unsigned i = 0; i + 6 <= length; i += 6) {
+                const auto relationId = static_cast<uint16_t>(readInfoInt(p + i, 2));
+                auto& table = tables[relationId];
+                table.relationId = relationId;
+                table.*field = readInfoInt(p + i + 2, 4);
+            }
+        }
+        p += length;
+    }
+
+    counters.tables.reserve(tables.size());
+    for (const auto& [id, table] : tables) {
+        counters.tables.push_back(table);
+    }
+    return counters;
+}
+
+MemoryUsage Connection::memoryUsage(bool includeServer) const {
+    MemoryUsage usage;
+    if (statementCache_) {
+        const auto stats = statementCache_->getStatistics();
+        usage.cachedStatements = stats.cacheSize;
+        usage.idleStatements = stats.idleCount;
+        usage.statementCacheBytes = statementCache_->estimateMemory();
+    }
+    usage.resultSets = memory_->objects(detail::MemoryAccount::resultSets);
+    usage.resultSetBytes = memory_->bytes(detail::MemoryAccount::resultSets);
+    usage.batches = memory_->objects(detail::MemoryAccount::batches);
+    usage.batchBytes = memory_->bytes(detail::MemoryAccount::batches);
+    usage.arenas = memory_->objects(detail::MemoryAccount::arenas);
+    usage.arenaBytes = memory_->bytes(detail::MemoryAccount::arenas);
+    usage.softLimitShrinks = softLimitShrinks_;
+
+    if (includeServer && attachment_) {
+        static const unsigned char items[] = {isc_info_current_memory, isc_info_max_memory};
+        unsigned char buffer[64] = {};
+        try {
+            attachment_->getInfo(&status(), sizeof(items), items, sizeof(buffer), buffer);
+            const unsigned char* p = buffer;
+            const unsigned char* end = buffer + sizeof(buffer);
+            while (p + 3 <= end && *p != isc_info_end) {
+                const unsigned char item = *p;
+                const unsigned length = static_cast<unsigned>(readInfoInt(p + 1, 2));
+                p += 3;
+                if (item == isc_info_truncated || item == isc_info_error || p + length > end) {
+                    break;
+                }
+                if (item == isc_info_current_memory) {
+                    usage.serverCurrentMemory = readInfoInt(p, length);
+                } else if (item == isc_info_max_memory) {
+                    usage.serverMaxMemory = readInfoInt(p, length);
+                }
+                p += length;
+            }
+        } catch (const Firebird::FbException&) {
+            // Reported as unknown: the client figures still stand
+        }
+    }
+    return usage;
+}
+
+void Connection::checkMemoryLimit() {
+    if (options_.memorySoftLimit == 0 || !statementCache_) {
+        return;
+    }
+    // The cache estimate walks every entry; amortise it over prepares
+    if (memoryCheckCountdown_ > 0) {
+        --memoryCheckCountdown_;
+        return;
+    }
+    memoryCheckCountdown_ = 63;
+
+    const MemoryUsage usage = memoryUsage(false);
+    if (usage.clientBytes() <= options_.memorySoftLimit) {
+        return;
+    }
+    const size_t live = usage.clientBytes() - usage.statementCacheBytes;
+    const size_t target = live < options_.memorySoftLimit ? options_.memorySoftLimit - live : 0;
+    dropStatementSlots();
+    const size_t after = statementCache_->shrinkTo(target);
+    ++softLimitShrinks_;
+    fbpp::util::trace(fbpp::util::TraceLevel::info, "Connection",
+                [&](auto& oss) {
+                    oss << "Memory soft limit " << options_.memorySoftLimit << " exceeded ("
+                        << usage.clientBytes() << " bytes): statement cache "
+                        << usage.statementCacheBytes << " -> " << after << " bytes";
+                });
+}
+
+size_t Connection::releaseDeferredHandles() {
+    return releases_ && releases_->pending() ? releases_->drain() : 0;
+}
+
+uint64_t Connection::deferredHandlesReleased() const {
+    return releases_ ? releases_->released() : 0;
+}
+
+void Connection::applyHandleRelease() {
+    if (options_.handleRelease == HandleRelease::immediate) {
+        releases_->disable();
+        releases_->drain();
+    } else {
+        releases_->enable(options_.handleRelease == HandleRelease::background);
+    }
+}
+
 void Connection::setOptions(const ConnectionOptions& options) {
     options_ = options;
+    tuning_.reset();
+    if (releases_) {
+        applyHandleRelease();
+    }
+    if (!options_.statementCache.enabled) {
+        dropStatementSlots();
+    }
     if (statementCache_) {
         statementCache_->setEnabled(options_.statementCache.enabled);
         statementCache_->setMaxSize(options_.statementCache.maxSize);
+        statementCache_->setMaxIdleStatements(options_.statementCache.maxIdleStatements);
         statementCache_->setTtlMinutes(options_.statementCache.ttlMinutes);
+        statementCache_->setPolicy(options_.statementCache.policy);
+        statementCache_->setCollectMetrics(options_.statementCache.collectMetrics);
+        statementCache_->setCaptureServerCounters(options_.statementCache.captureServerCounters);
+        statementCache_->setProfilePhases(options_.statementCache.profilePhases);
     }
 }
 
@@ -0,0 +1,616 @@
+#include "fbpp/core/csv_importer.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/detail/mapped_file.hpp"
+#include "fbpp/core/detail/sql_value_codec.hpp"
+#include "fbpp_util/trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <charconv>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+namespace fbpp::core {
+
+namespace {
+
+// How a field's text reaches its column
+enum class ColumnKind {
+    Text,        // CHAR: copied, blank-padded
+    Varying,     // VARCHAR: copied with its length prefix
+    Integer,     // SMALLINT / INTEGER / BIGINT without scale: from_chars
+    Float,
+    Double,
+    Boolean,
+    Timestamp,   // Codec, ' ' accepted as the date/time separator
+    Codec        // Everything else: the codec's string path
+};
+
+struct Column {
+    unsigned offset = 0;
+    unsigned nullOffset = 0;
+    const FieldInfo* field = nullptr;
+    ColumnKind kind = ColumnKind::Codec;
+};
+
+std::vector<Column> planColumns(const MetadataLayout& layout) {
+    std::vector<Column> columns;
+    columns.reserve(layout.columnPlan.size());
+    for (const ColumnPlan& plan : layout.columnPlan) {
+        Column column{plan.offset, plan.nullOffset, plan.field, ColumnKind::Codec};
+        switch (plan.field->type) {
+            case SQL_TEXT: column.kind = ColumnKind::Text; break;
+            case SQL_VARYING: column.kind = ColumnKind::Varying; break;
+            case SQL_SHORT:
+            case SQL_LONG:
+            case SQL_INT64:
+                if (plan.field->scale == 0) column.kind = ColumnKind::Integer;
+                break;
+            case SQL_FLOAT: column.kind = ColumnKind::Float; break;
+            case SQL_DOUBLE:
+            case SQL_D_FLOAT: column.kind = ColumnKind::Double; break;
+            case SQL_BOOLEAN: column.kind = ColumnKind::Boolean; break;
+            case SQL_TIMESTAMP: column.kind = ColumnKind::Timestamp; break;
+            case SQL_BLOB:
+                throw FirebirdException("CsvImporter: BLOB parameter " +
+                                        std::to_string(columns.size() + 1) + " is not supported");
+            default: break;
+        }
+        columns.push_back(column);
+    }
+    return columns;
+}
+
+/**
+ * @brief End of the record starting at `p`
+ *
+ * Returns its terminating '\n' (or `end`). A '\n' inside quotes does not
+ * end the record: quote parity is tracked per line with memchr, which
+ * also balances the doubled quotes of escapes. `lines` counts the line
+ * breaks crossed inside the record.
+ */
+const char* recordEnd(const char* p, const char* end, char quote, bool inQuotes, size_t& lines) {
+    for (;;) {
+        const auto* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        const char* stop = nl ? nl : end;
+        if (quote != '\0') {
+            for (const char* q = p;
+                 (q = static_cast<const char*>(std::memchr(q, quote, static_cast<size_t>(stop - q))));
+                 ++q) {
+                inQuotes = !inQuotes;
+            }
+        }
+        if (!inQuotes || !nl) {
+            return stop;
+        }
+        ++lines;
+        p = nl + 1;
+    }
+}
+
+// [begin, end) pieces of about `segmentBytes`, each ending after a record
+std::vector<std::pair<size_t, size_t>> splitSegments(std::string_view text, size_t begin,
+                                                     size_t segmentBytes, char quote) {
+    std::vector<std::pair<size_t, size_t>> segments;
+    const char* data = text.data();
+    const size_t size = text.size();
+    segmentBytes = std::max<size_t>(segmentBytes, 1);
+    while (begin < size) {
+        if (size - begin <= segmentBytes) {
+            segments.emplace_back(begin, size);
+            break;
+        }
+        // Quote parity at the cut decides whether it falls inside a field
+        const size_t cut = begin + segmentBytes;
+        bool inQuotes = false;
+        if (quote != '\0') {
+            for (const char* q = data + begin;
+                 (q = static_cast<const char*>(std::memchr(q, quote, static_cast<size_t>(data + cut - q))));
+                 ++q) {
+                inQuotes = !inQuotes;
+            }
+        }
+        size_t ignored = 0;
+        const char* stop = recordEnd(data + cut, data + size, quote, inQuotes, ignored);
+        const size_t next = stop == data + size ? size : static_cast<size_t>(stop - data) + 1;
+        segments.emplace_back(begin, next);
+        begin = next;
+    }
+    return segments;
+}
+
+/**
+ * @brief One parse task and its packed output
+ */
+struct Segment {
+    size_t begin = 0;
+    size_t end = 0;
+    std::vector<uint8_t> messages;   // `count` messages, messageBytes apart
+    size_t count = 0;
+    size_t records = 0;
+    size_t lines = 0;                // Line breaks in [begin, end)
+    std::vector<CsvLineError> errors;   // Lines relative to the segment
+    std::exception_ptr failure;
+    bool ready = false;
+};
+
+/**
+ * @brief Parses records into messages for one input metadata layout
+ */
+class RecordPacker {
+public:
+    RecordPacker(const std::vector<Column>& columns, const CsvImportOptions& options,
+                 size_t messageLength, size_t messageBytes)
+        : columns_(columns), options_(options),
+          messageLength_(messageLength), messageBytes_(messageBytes) {}
+
+    void parse(const char* p, const char* end, Segment& segment) {
+        size_t line = 0;
+        while (p < end) {
+            size_t recordLines = 1;
+            const char* stop = recordEnd(p, end, options_.quote, false, recordLines);
+            const char* next = stop < end ? stop + 1 : end;
+            const char* last = stop;
+            if (last > p && last[-1] == '\r') {
+                --last;
+            }
+
+            if (last != p) {
+                ++segment.records;
+                const size_t used = segment.count * messageBytes_;
+                if (segment.messages.size() < used + messageBytes_) {
+                    segment.messages.resize(std::max(segment.messages.size() * 2, used + messageBytes_));
+                }
+                uint8_t* message = segment.messages.data() + used;
+                std::memset(message, 0, messageLength_);
+                try {
+                    packRecord(p, last, message);
+                    ++segment.count;
+                } catch (const std::exception& e) {
+                    segment.errors.push_back(CsvLineError{line, e.what()});
+                }
+            }
+            line += recordLines;
+            p = next;
+        }
+        segment.lines = line;
+        segment.messages.resize(segment.count * messageBytes_);
+    }
+
+private:
+    void packRecord(const char* p, const char* end, uint8_t* message) {
+        const char delimiter = options_.delimiter;
+        const char quote = options_.quote;
+        size_t index = 0;
+        for (;;) {
+            std::string_view value;
+            bool quoted = false;
+            if (quote != '\0' && p < end && *p == quote) {
+                quoted = true;
+                value = quotedField(p, end);
+                if (p < end && *p != delimiter) {
+                    throw FirebirdException("Field " + std::to_string(index + 1) +
+                                            ": unexpected character after closing quote");
+                }
+            } else {
+                const auto* d = static_cast<const char*>(
+                    std::memchr(p, delimiter, static_cast<size_t>(end - p)));
+                const char* stop = d ? d : end;
+                value = std::string_view(p, static_cast<size_t>(stop - p));
+                p = stop;
+            }
+
+            if (index >= columns_.size()) {
+                throw FirebirdException("Record has more than " + std::to_string(columns_.size()) +
+                                        " fields");
+            }
+            try {
+                write(columns_[index], value, quoted, message);
+            } catch (const std::exception& e) {
+                throw FirebirdException("Field " + std::to_string(index + 1) + ": " + e.what());
+            }
+            ++index;
+
+            if (p == end) {
+                break;
+            }
+            ++p;   // Delimiter; a trailing one yields an empty last field
+        }
+        if (index != columns_.size()) {
+            throw FirebirdException("Record has " + std::to_string(index) + " fields, statement expects " +
+                                    std::to_string(columns_.size()));
+        }
+    }
+
+    // `p` is at the opening quote; leaves it after the closing one
+    std::string_view quotedField(const char*& p, const char* end) {
+        const char quote = options_.quote;
+        const char* run = ++p;
+        bool escaped = false;
+        for (;;) {
+            const auto* q = static_cast<const char*>(std::memchr(p, quote, static_cast<size_t>(end - p)));
+            if (!q) {
+                throw FirebirdException("Unterminated quoted field");
+            }
+            if (q + 1 < end && q[1] == quote) {
+                if (!escaped) {
+                    field_.clear();
+                    escaped = true;
+                }
+                field_.append(run, q + 1);   // Keep one quote of the pair
+                p = run = q + 2;
+                continue;
+            }
+            p = q + 1;
+            if (!escaped) {
+                return std::string_view(run, static_cast<size_t>(q - run));
+            }
+            field_.append(run, q);
+            return field_;
+        }
+    }
+
+    void write(const Column& column, std::string_view value, bool quoted, uint8_t* message) {
+        auto* nullPtr = reinterpret_cast<int16_t*>(message + column.nullOffset);
+        if (!quoted && value == options_.nullText) {
+            *nullPtr = -1;
+            return;
+        }
+        *nullPtr = 0;
+        uint8_t* data = message + column.offset;
+        const FieldInfo& field = *column.field;
+
+        switch (column.kind) {
+            case ColumnKind::Text:
+            case ColumnKind::Varying: {
+                if (value.size() > field.length) {
+                    throw FirebirdException("String value too long for field " + field.name + ": " +
+                                            std::to_string(value.size()) + " bytes, field holds " +
+                                            std::to_string(field.length) + " bytes");
+                }
+                if (column.kind == ColumnKind::Text) {
+                    std::memcpy(data, value.data(), value.size());
+                    std::memset(data + value.size(), ' ', field.length - value.size());
+                } else {
+                    const auto length = static_cast<uint16_t>(value.size());
+                    std::memcpy(data, &length, sizeof(length));
+                    std::memcpy(data + sizeof(length), value.data(), value.size());
+                }
+                return;
+            }
+            case ColumnKind::Integer: {
+                int64_t parsed = 0;
+                if (!fullParse(value, parsed)) {
+                    throw FirebirdException("Invalid integer '" + std::string(value) + "'");
+                }
+                if (field.type == SQL_SHORT) {
+                    storeNarrow<int16_t>(parsed, data, "SMALLINT");
+                } else if (field.type == SQL_LONG) {
+                    storeNarrow<int32_t>(parsed, data, "INTEGER");
+                } else {
+                    std::memcpy(data, &parsed, sizeof(parsed));
+                }
+                return;
+            }
+            case ColumnKind::Float: {
+                float parsed = 0.0f;
+                if (!fullParse(value, parsed)) {
+                    throw FirebirdException("Invalid number '" + std::string(value) + "'");
+                }
+                std::memcpy(data, &parsed, sizeof(parsed));
+                return;
+            }
+            case ColumnKind::Double: {
+                double parsed = 0.0;
+                if (!fullParse(value, parsed)) {
+                    throw FirebirdException("Invalid number '" + std::string(value) + "'");
+                }
+                std::memcpy(data, &parsed, sizeof(parsed));
+                return;
+            }
+            case ColumnKind::Boolean: {
+                uint8_t flag = 0;
+                if (equalsNoCase(value, "true") || value == "1") {
+                    flag = 1;
+                } else if (!equalsNoCase(value, "false") && value != "0") {
+                    throw FirebirdException("Invalid boolean '" + std::string(value) + "'");
+                }
+                std::memcpy(data, &flag, sizeof(flag));
+                return;
+            }
+            case ColumnKind::Timestamp:
+            case ColumnKind::Codec: {
+                text_.assign(value);
+                if (column.kind == ColumnKind::Timestamp && text_.size() > 10 && text_[10] == ' ') {
+                    text_[10] = 'T';
+                }
+                detail::sql_value_codec::SqlWriteContext ctx{&field, nullptr, nullPtr};
+                detail::sql_value_codec::write_sql_value(ctx, text_, data);
+                return;
+            }
+        }
+    }
+
+    template<typename T>
+    static bool fullParse(std::string_view text, T& value) {
+        const char* first = text.data();
+        const char* last = first + text.size();
+        if (first != last && *first == '+') {
+            ++first;
+        }
+        const auto result = std::from_chars(first, last, value);
+        return result.ec == std::errc{} && result.ptr == last && first != last;
+    }
+
+    template<typename Narrow>
+    static void storeNarrow(int64_t value, uint8_t* data, const char* sqlTypeName) {
+        if (value < std::numeric_limits<Narrow>::min() || value > std::numeric_limits<Narrow>::max()) {
+            throw FirebirdException(std::string("Value out of range for ") + sqlTypeName);
+        }
+        const auto narrow = static_cast<Narrow>(value);
+        std::memcpy(data, &narrow, sizeof(narrow));
+    }
+
+    static bool equalsNoCase(std::string_view text, std::string_view lower) {
+        return text.size() == lower.size() &&
+               std::equal(text.begin(), text.end(), lower.begin(), [](char a, char b) {
+                   return (a >= 'A' && a <= 'Z' ? static_cast<char>(a - 'A' + 'a') : a) == b;
+               });
+    }
+
+    const std::vector<Column>& columns_;
+    const CsvImportOptions& options_;
+    size_t messageLength_;
+    size_t messageBytes_;
+    std::string field_;   // Unescaped quoted field
+    std::string text_;    // Codec input
+};
+
+/**
+ * @brief Batches fed with packed messages, flushed by size (as BulkLoader)
+ */
+class BatchFeed {
+public:
+    BatchFeed(Statement& statement, Transaction& transaction, const BulkLoaderOptions& options,
+              CsvImportResult& result)
+        : statement_(statement), transaction_(transaction), options_(options), result_(result) {}
+
+    size_t messageBytes() { return std::max<size_t>(current().getMessageBytes(), 1); }
+
+    void add(const uint8_t* messages, size_t count) {
+        const size_t stride = messageBytes();
+        while (count > 0) {
+            Batch& batch = current();
+            const size_t perAdd = std::max<size_t>(batch.getStreamChunkBytes() / stride, 1);
+            const size_t n = std::min({roomIn(batch), perAdd, count});
+            batch.addPacked(messages, n);
+            messages += n * stride;
+            count -= n;
+            if (batch.getBufferedBytes() >= options_.flushBytes) {
+                flush();
+            }
+        }
+    }
+
+    void flush() {
+        if (!batch_ || batch_->getMessageCount() == 0) {
+            return;
+        }
+        auto result = batch_->execute(&transaction_, options_.maxErrorMessages);
+        batch_.reset();
+        result_.batch.merge(result);
+        ++result_.flushes;
+        if (options_.commitEveryFlushes != 0 && result_.flushes % options_.commitEveryFlushes == 0) {
+            transaction_.CommitRetaining();
+        }
+    }
+
+private:
+    size_t roomIn(const Batch& batch) const {
+        const size_t messageBytes = std::max<size_t>(batch.getMessageBytes(), 1);
+        const size_t buffered = batch.getBufferedBytes();
+        return buffered >= options_.flushBytes
+            ? 1 : std::max<size_t>((options_.flushBytes - buffered) / messageBytes, 1);
+    }
+
+    Batch& current() {
+        if (!batch_) {
+            batch_ = statement_.createBatch(&transaction_, options_.recordCounts, options_.continueOnError);
+        }
+        return *batch_;
+    }
+
+    Statement& statement_;
+    Transaction& transaction_;
+    const BulkLoaderOptions& options_;
+    CsvImportResult& result_;
+    std::unique_ptr<Batch> batch_;
+};
+
+} // namespace
+
+CsvImporter::CsvImporter(std::shared_ptr<Statement> statement,
+                         std::shared_ptr<Transaction> transaction,
+                         CsvImportOptions options)
+    : statement_(std::move(statement)),
+      transaction_(std::move(transaction)),
+      options_(std::move(options)) {
+    if (!statement_ || !statement_->isValid()) {
+        throw FirebirdException("CsvImporter: statement is not valid");
+    }
+    if (!transaction_ || !transaction_->isActive()) {
+        throw FirebirdException("CsvImporter: valid active transaction required");
+    }
+    auto metadata = statement_->getInputMetadata();
+    if (!metadata || metadata->getCount() == 0) {
+        throw FirebirdException("CsvImporter: statement has no input parameters");
+    }
+    planColumns(*metadata->getLayout());   // Reject BLOB parameters up front
+    if (options_.delimiter == '\n' || options_.delimiter == '\r' ||
+        (options_.quote != '\0' && options_.quote == options_.delimiter)) {
+        throw FirebirdException("CsvImporter: invalid delimiter / quote combination");
+    }
+}
+
+CsvImportResult CsvImporter::importFile(const std::string& path) {
+#ifndef _WIN32
+    detail::MappedFile file(path, O_RDONLY);
+    if (const size_t size = file.regularSize()) {
+        if (const void* mapped = file.map(size, false)) {
+            return importText(std::string_view(static_cast<const char*>(mapped), size));
+        }
+    }
+#endif
+    // Pipes, empty or unmappable files
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw FirebirdException("Cannot open " + path);
+    }
+    const std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return importText(text);
+}
+
+CsvImportResult CsvImporter::importText(std::string_view text) {
+    const auto started = std::chrono::steady_clock::now();
+    CsvImportResult result;
+    result.bytes = text.size();
+
+    const auto layout = statement_->getInputMetadata()->getLayout();
+    const std::vector<Column> columns = planColumns(*layout);
+
+    // Header record, then line numbers continue after it
+    size_t begin = 0;
+    size_t baseLine = 1;
+    if (options_.header && !text.empty()) {
+        const char* stop = recordEnd(text.data(), text.data() + text.size(), options_.quote, false, baseLine);
+        begin = std::min(static_cast<size_t>(stop - text.data()) + 1, text.size());
+        ++baseLine;
+    }
+
+    BatchFeed feed(*statement_, *transaction_, options_.loader, result);
+    const size_t messageBytes = feed.messageBytes();
+    std::vector<Segment> segments;
+    for (const auto& [first, last] : splitSegments(text, begin, options_.segmentBytes, options_.quote)) {
+        segments.emplace_back();
+        segments.back().begin = first;
+        segments.back().end = last;
+    }
+
+    unsigned threads = options_.threads ? options_.threads
+                                        : std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<size_t>(threads, segments.size()));
+    // Parsed-but-unsent segments are bounded, so memory does not follow the input size
+    const size_t window = static_cast<size_t>(threads) * 2;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t nextTask = 0;
+    size_t consumed = 0;
+    bool stopped = false;
+
+    auto worker = [&] {
+        RecordPacker packer(columns, options_, layout->messageLength, messageBytes);
+        for (;;) {
+            size_t index = 0;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&] {
+                    return stopped || nextTask >= segments.size() || nextTask < consumed + window;
+                });
+                if (stopped || nextTask >= segments.size()) {
+                    return;
+                }
+                index = nextTask++;
+            }
+            Segment& segment = segments[index];
+            try {
+                packer.parse(text.data() + segment.begin, text.data() + segment.end, segment);
+            } catch (...) {
+                segment.failure = std::current_exception();
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                segment.ready = true;
+            }
+            cv.notify_all();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    auto stopWorkers = [&] {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopped = true;
+        }
+        cv.notify_all();
+        for (auto& t : workers) {
+            t.join();
+        }
+        workers.clear();
+    };
+
+    try {
+        for (unsigned i = 0; i < threads; ++i) {
+            workers.emplace_back(worker);
+        }
+
+        for (Segment& segment : segments) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&] { return segment.ready; });
+            }
+            if (segment.failure) {
+                std::rethrow_exception(segment.failure);
+            }
+            for (auto& error : segment.errors) {
+                error.line += baseLine;
+                result.lineErrors.push_back(std::move(error));
+            }
+            if (result.lineErrors.size() > options_.maxLineErrors) {
+                const CsvLineError& first = result.lineErrors.front();
+                throw FirebirdException("CsvImporter: more than " + std::to_string(options_.maxLineErrors) +
+                                        " lines failed; first at line " + std::to_string(first.line) +
+                                        ": " + first.message);
+            }
+
+            feed.add(segment.messages.data(), segment.count);
+            result.rowsAdded += segment.count;
+            result.records += segment.records;
+            baseLine += segment.lines;
+            std::vector<uint8_t>().swap(segment.messages);
+            segment.errors.clear();
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ++consumed;
+            }
+            cv.notify_all();
+        }
+        stopWorkers();
+        feed.flush();
+    } catch (...) {
+        stopWorkers();
+        throw;
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    fbpp::util::trace(fbpp::util::TraceLevel::info, "CsvImporter",
+                [&](auto& oss) {
+                    oss << "CSV import complete: rows=" << result.rowsAdded
+                        << " bad_lines=" << result.lineErrors.size()
+                        << " batches=" << result.flushes
+                        << " MB/s=" << result.megabytesPerSecond()
+                        << " threads=" << threads;
+                });
+    return result;
+}
+
+} // namespace fbpp::core
@@ -0,0 +1,281 @@
+#include "fbpp/core/csv_stream_writer.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/int128_chars.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/detail/sql_value_codec.hpp"
+#include "fbpp/core/detail/text_scan.hpp"
+
+#include <charconv>
+#include <cstring>
+#include <ostream>
+
+namespace fbpp::core {
+
+namespace {
+
+template<typename Number>
+void appendNumber(std::string& out, Number value) {
+    char buffer[32];
+    out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value).ptr);
+}
+
+void appendDecimal(std::string& out, const Int128& value, int scale) {
+    char buffer[kInt128MaxChars];
+    out.append(buffer, toChars(buffer, buffer + sizeof(buffer), value, scale).ptr);
+}
+
+template<typename Int>
+void appendIntegerColumn(std::string& out, const detail::sql_value_codec::SqlReadContext& ctx,
+                         const uint8_t* data) {
+    Int raw;
+    std::memcpy(&raw, data, sizeof(raw));
+    if (ctx.field->scale < 0) {
+        appendDecimal(out, Int128(static_cast<int64_t>(raw)), ctx.field->scale);
+    } else {
+        appendNumber(out, raw);
+    }
+}
+
+} // namespace
+
+CsvStreamWriter::CsvStreamWriter(Sink sink, CsvWriteOptions options)
+    : sink_(std::move(sink)), options_(std::move(options)) {
+    if (!sink_) {
+        throw FirebirdException("CsvStreamWriter: empty sink");
+    }
+    if (options_.chunkBytes == 0) {
+        options_.chunkBytes = 1;
+    }
+    out_.reserve(options_.chunkBytes + 256);
+    if (options_.background) {
+        thread_ = std::thread([this] { run(); });
+    }
+}
+
+CsvStreamWriter::CsvStreamWriter(std::ostream& out, CsvWriteOptions options)
+    : CsvStreamWriter([&out](std::string_view chunk) {
+          out.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+      }, std::move(options)) {}
+
+CsvStreamWriter::~CsvStreamWriter() {
+    if (thread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+    }
+}
+
+void CsvStreamWriter::writeHeader(const MessageMetadata& metadata) {
+    if (headerWritten_) {
+        return;
+    }
+    headerWritten_ = true;
+    if (!options_.header) {
+        return;
+    }
+    const auto& plan = metadata.getColumnPlan();
+    for (std::size_t i = 0; i < plan.size(); ++i) {
+        if (i != 0) {
+            out_ += options_.delimiter;
+        }
+        const std::string& name = displayName(*plan[i].field);
+        if (name.empty()) {
+            out_ += "FIELD_";
+            appendNumber(out_, i);
+        } else {
+            writeField(name);
+        }
+    }
+    out_ += options_.lineEnd;
+}
+
+void CsvStreamWriter::writeRow(const uint8_t* buffer, const MessageMetadata& metadata,
+                               Transaction* transaction) {
+    if (finished_) {
+        throw FirebirdException("CsvStreamWriter: row written after finish()");
+    }
+    if (!buffer) {
+        throw FirebirdException("Invalid parameters for CSV unpack");
+    }
+    if (!headerWritten_) {
+        writeHeader(metadata);
+    }
+
+    const auto& plan = metadata.getColumnPlan();
+    for (std::size_t i = 0; i < plan.size(); ++i) {
+        if (i != 0) {
+            out_ += options_.delimiter;
+        }
+        writeValue(plan[i], buffer, transaction);
+    }
+    out_ += options_.lineEnd;
+    ++rows_;
+
+    if (out_.size() >= options_.chunkBytes) {
+        flush();
+    }
+}
+
+void CsvStreamWriter::finish() {
+    if (finished_) {
+        return;
+    }
+    finished_ = true;
+    flush();
+    if (thread_.joinable()) {
+        drain();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+}
+
+void CsvStreamWriter::writeValue(const ColumnPlan& column, const uint8_t* buffer,
+                                 Transaction* transaction) {
+    const uint8_t* data = buffer + column.offset;
+    const auto* nullPtr = reinterpret_cast<const int16_t*>(buffer + column.nullOffset);
+    if (*nullPtr == -1) {
+        out_ += options_.nullText;
+        return;
+    }
+
+    const FieldInfo* field = column.field;
+    detail::sql_value_codec::SqlReadContext ctx{field, transaction, nullPtr};
+    switch (field->type) {
+        case SQL_TEXT:
+        case SQL_VARYING:
+            writeField(detail::textView(*field, data));
+            return;
+        case SQL_BOOLEAN:
+            out_ += *data != 0 ? "true" : "false";
+            return;
+        case SQL_SHORT:
+            appendIntegerColumn<int16_t>(out_, ctx, data);
+            return;
+        case SQL_LONG:
+            appendIntegerColumn<int32_t>(out_, ctx, data);
+            return;
+        case SQL_INT64:
+            appendIntegerColumn<int64_t>(out_, ctx, data);
+            return;
+        case SQL_INT128:
+            appendDecimal(out_, Int128(data), field->scale);
+            return;
+        case SQL_FLOAT: {
+            float value = 0.0f;
+            std::memcpy(&value, data, sizeof(value));
+            appendNumber(out_, value);
+            return;
+        }
+        case SQL_DOUBLE:
+        case SQL_D_FLOAT: {
+            double value = 0.0;
+            std::memcpy(&value, data, sizeof(value));
+            appendNumber(out_, value);
+            return;
+        }
+        case SQL_BLOB:
+        case SQL_DEC16:
+        case SQL_DEC34:
+        case SQL_TIMESTAMP:
+        case SQL_TIMESTAMP_TZ:
+        case SQL_TYPE_TIME:
+        case SQL_TIME_TZ:
+        case SQL_TYPE_DATE:
+            // Codec text, as JsonUnpacker produces; scratch_ keeps its capacity
+            detail::sql_value_codec::read_sql_value(ctx, data, scratch_);
+            writeField(scratch_);
+            return;
+        default:
+            throw FirebirdException("Unsupported SQL type for CSV unpacking: " +
+                                    std::to_string(field->type));
+    }
+}
+
+void CsvStreamWriter::writeField(std::string_view text) {
+    const char quote = options_.quote;
+    const std::size_t special = quote == '\0'
+        ? text.size() : detail::findCsvSpecial(text.data(), text.size(), options_.delimiter, quote);
+    if (special == text.size()) {
+        out_.append(text);   // Common case: nothing to quote
+        return;
+    }
+
+    out_ += quote;
+    std::size_t run = 0;   // Start of the pending run; quotes are doubled
+    for (std::size_t i = special; i < text.size(); ++i) {
+        if (text[i] == quote) {
+            out_.append(text.data() + run, i + 1 - run);
+            out_ += quote;
+            run = i + 1;
+        }
+    }
+    out_.append(text.data() + run, text.size() - run);
+    out_ += quote;
+}
+
+void CsvStreamWriter::flush() {
+    if (out_.empty()) {
+        return;
+    }
+    if (!thread_.joinable()) {
+        sink_(out_);
+        out_.clear();
+        return;
+    }
+
+    // Hand the chunk over and keep filling a recycled one
+    drain();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+        out_.swap(pending_);
+        hasPending_ = true;
+    }
+    cv_.notify_all();
+    out_.clear();
+}
+
+void CsvStreamWriter::drain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return !hasPending_; });
+}
+
+void CsvStreamWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        cv_.wait(lock, [this] { return hasPending_ || stop_; });
+        if (!hasPending_) {
+            return;   // stop_ with nothing left to write
+        }
+        lock.unlock();
+        std::exception_ptr error;
+        try {
+            if (!error_) {
+                sink_(pending_);
+            }
+        } catch (...) {
+            error = std::current_exception();
+        }
+        lock.lock();
+        if (error && !error_) {
+            error_ = error;
+        }
+        pending_.clear();
+        hasPending_ = false;
+        cv_.notify_all();
+    }
+}
+
+} // namespace fbpp::core
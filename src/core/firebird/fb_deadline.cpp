@@ -0,0 +1,75 @@
+#include "fbpp/core/deadline.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace fbpp {
+namespace core {
+
+namespace {
+
+// What a cancelOperation(RAISE) or an expired statement timeout fails
+// with; the timeout adds isc_req_stmt_timeout & co. after it (iberror.h)
+constexpr intptr_t kCancelledCode = 335544794;   // isc_cancelled
+
+constexpr char kExceededPrefix[] = "Deadline exceeded: ";
+
+thread_local const Deadline* currentDeadline = nullptr;
+
+} // namespace
+
+std::chrono::milliseconds Deadline::remaining() const {
+    const auto left = at_ - Clock::now();
+    if (left <= Clock::duration::zero()) {
+        return std::chrono::milliseconds(0);
+    }
+    return std::chrono::ceil<std::chrono::milliseconds>(left);
+}
+
+void Deadline::check(const char* stage) const {
+    if (expired()) {
+        throw FirebirdException(std::string(kExceededPrefix) + stage);
+    }
+}
+
+const Deadline* Deadline::current() noexcept {
+    return currentDeadline;
+}
+
+bool Deadline::isExceeded(const FirebirdException& error) {
+    if (error.getErrorCode() == kCancelledCode) {
+        return true;
+    }
+    for (const auto& entry : error.getStatusVector()) {
+        if (entry.tag == isc_arg_gds && entry.numericValue == kCancelledCode) {
+            return true;
+        }
+    }
+    // Status-less: thrown by check() before a call
+    return error.getStatusVector().empty() &&
+           std::strncmp(error.what(), kExceededPrefix, sizeof(kExceededPrefix) - 1) == 0;
+}
+
+DeadlineScope::DeadlineScope(Deadline deadline)
+    : deadline_(currentDeadline ? Deadline(std::min(currentDeadline->at(), deadline.at()))
+                                : deadline),
+      previous_(currentDeadline) {
+    currentDeadline = &deadline_;
+}
+
+DeadlineScope::~DeadlineScope() {
+    currentDeadline = previous_;
+}
+
+DeadlineScope::Suspend::Suspend() noexcept
+    : previous_(currentDeadline) {
+    currentDeadline = nullptr;
+}
+
+DeadlineScope::Suspend::~Suspend() {
+    currentDeadline = previous_;
+}
+
+} // namespace core
+} // namespace fbpp
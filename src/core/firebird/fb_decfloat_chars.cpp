@@ -0,0 +1,134 @@
+#include "fbpp/core/decfloat_chars.hpp"
+#include "fbpp/core/exception.hpp"
+
+extern "C" {
+#include "decDouble.h"
+#include "decQuad.h"
+}
+
+#include <cstdlib>
+#include <cstring>
+
+namespace fbpp::core {
+
+namespace {
+
+static_assert(sizeof(decDouble) == 8 && sizeof(decQuad) == 16,
+              "decNumber layout must match FB_DEC16 / FB_DEC34");
+static_assert(kDecFloat16MaxChars + 1 >= DECDOUBLE_String, "kDecFloat16MaxChars too small");
+static_assert(kDecFloat34MaxChars + 1 >= DECQUAD_String, "kDecFloat34MaxChars too small");
+
+// Firebird's default DECFLOAT behaviour: HALF_UP, traps on invalid
+// operation (which includes conversion syntax) and overflow.
+constexpr uint32_t kTraps = DEC_IEEE_754_Invalid_operation | DEC_Overflow;
+
+decContext makeContext(int32_t kind) noexcept {
+    decContext context;
+    decContextDefault(&context, kind);
+    context.round = DEC_ROUND_HALF_UP;
+    return context;
+}
+
+void checkStatus(const decContext& context, std::string_view text, const char* type) {
+    if ((context.status & kTraps) == 0) {
+        return;
+    }
+    const char* what = (context.status & DEC_Overflow) ? "out of range for " : "Invalid value for ";
+    throw FirebirdException(std::string(what) + type + ": '" + std::string(text) + "'");
+}
+
+// decNumber wants a NUL-terminated string; values are short, so copy to the stack
+template<std::size_t N>
+const char* terminated(std::string_view text, char (&buffer)[N], std::string& heap) {
+    if (text.size() < N) {
+        std::memcpy(buffer, text.data(), text.size());
+        buffer[text.size()] = '\0';
+        return buffer;
+    }
+    heap.assign(text);
+    return heap.c_str();
+}
+
+std::to_chars_result copyOut(char* first, char* last, const char* text) noexcept {
+    const std::size_t length = std::strlen(text);
+    if (static_cast<std::size_t>(last - first) < length) {
+        return {last, std::errc::value_too_large};
+    }
+    std::memcpy(first, text, length);
+    return {first + length, std::errc{}};
+}
+
+double parseDouble(const char* text) {
+    // decNumber spells specials "Infinity" / "-Infinity" / "NaN" / "sNaN",
+    // all of which strtod accepts (sNaN reads as NaN after the leading 's').
+    if (text[0] == 's' || (text[0] == '-' && text[1] == 's')) {
+        return std::strtod(text[0] == '-' ? "-nan" : "nan", nullptr);
+    }
+    return std::strtod(text, nullptr);
+}
+
+} // namespace
+
+std::to_chars_result toChars(char* first, char* last, const DecFloat16& value) noexcept {
+    char buffer[DECDOUBLE_String];
+    decDouble dec;
+    std::memcpy(&dec, value.data(), sizeof(dec));
+    return copyOut(first, last, decDoubleToString(&dec, buffer));
+}
+
+std::to_chars_result toChars(char* first, char* last, const DecFloat34& value) noexcept {
+    char buffer[DECQUAD_String];
+    decQuad dec;
+    std::memcpy(&dec, value.data(), sizeof(dec));
+    return copyOut(first, last, decQuadToString(&dec, buffer));
+}
+
+DecFloat16 decFloat16FromString(std::string_view text) {
+    char buffer[64];
+    std::string heap;
+    decContext context = makeContext(DEC_INIT_DECIMAL64);
+    decDouble dec;
+    decDoubleFromString(&dec, terminated(text, buffer, heap), &context);
+    checkStatus(context, text, "DECFLOAT(16)");
+    return DecFloat16(reinterpret_cast<const uint8_t*>(&dec));
+}
+
+DecFloat34 decFloat34FromString(std::string_view text) {
+    char buffer[64];
+    std::string heap;
+    decContext context = makeContext(DEC_INIT_DECIMAL128);
+    decQuad dec;
+    decQuadFromString(&dec, terminated(text, buffer, heap), &context);
+    checkStatus(context, text, "DECFLOAT(34)");
+    return DecFloat34(reinterpret_cast<const uint8_t*>(&dec));
+}
+
+double toDouble(const DecFloat16& value) {
+    char buffer[DECDOUBLE_String];
+    decDouble dec;
+    std::memcpy(&dec, value.data(), sizeof(dec));
+    return parseDouble(decDoubleToString(&dec, buffer));
+}
+
+double toDouble(const DecFloat34& value) {
+    char buffer[DECQUAD_String];
+    decQuad dec;
+    std::memcpy(&dec, value.data(), sizeof(dec));
+    return parseDouble(decQuadToString(&dec, buffer));
+}
+
+// Shortest round-trip text, the rule of the DECFLOAT parameter path
+// (sql_value_codec floating_to_string): 0.1 binds as 0.1 either way
+DecFloat16 decFloat16FromDouble(double value) {
+    char buffer[32];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    return decFloat16FromString(std::string_view(buffer, result.ptr - buffer));
+}
+
+DecFloat34 decFloat34FromDouble(double value) {
+    char buffer[32];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    return decFloat34FromString(std::string_view(buffer, result.ptr - buffer));
+}
+
+} // namespace fbpp::core
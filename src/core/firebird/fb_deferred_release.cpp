@@ -0,0 +1,138 @@
+#include "fbpp/core/detail/deferred_release.hpp"
+
+#include "fbpp/core/environment.hpp"
+#include "fbpp/core/executor.hpp"
+
+namespace fbpp::core::detail {
+
+bool DeferredRelease::push(Firebird::IStatement* statement) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!accepting_ || closed_) {
+        return false;
+    }
+    statements_.push_back(statement);
+    pending_.fetch_add(1, std::memory_order_release);
+    schedule();
+    return true;
+}
+
+bool DeferredRelease::push(Firebird::IResultSet* cursor, std::shared_ptr<void> keepAlive) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!accepting_ || closed_) {
+        return false;
+    }
+    cursors_.push_back(Cursor{cursor, std::move(keepAlive)});
+    pending_.fetch_add(1, std::memory_order_release);
+    schedule();
+    return true;
+}
+
+std::size_t DeferredRelease::drain() noexcept {
+    std::lock_guard<std::mutex> draining(drainMutex_);
+    std::vector<Cursor> cursors;
+    std::vector<Firebird::IStatement*> statements;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cursors.swap(cursors_);
+        statements.swap(statements_);
+    }
+    if (cursors.empty() && statements.empty()) {
+        return 0;
+    }
+
+    // A status of our own: the drain may run beside the connection's thread
+    Firebird::IStatus* raw = Environment::getInstance().acquireStatus();
+    Firebird::ThrowStatusWrapper st(raw);
+
+    // Cursors first: their statements may be among the statements below
+    for (auto& item : cursors) {
+        try {
+            item.cursor->close(&st);
+        } catch (...) {
+            // Already closed by its transaction's end, or the attachment is gone
+        }
+        item.cursor->release();
+        item.keepAlive.reset();   // May return the statement to its cache
+    }
+    for (auto* statement : statements) {
+        try {
+            statement->free(&st);
+        } catch (...) {
+            // The attachment may be gone; release the interface regardless
+        }
+        statement->release();
+    }
+    Environment::getInstance().releaseStatus(raw);
+
+    const std::size_t freed = cursors.size() + statements.size();
+    released_.fetch_add(freed, std::memory_order_relaxed);
+    pending_.fetch_sub(freed, std::memory_order_release);
+    return freed;
+}
+
+void DeferredRelease::enable(bool background) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (closed_) {
+        return;
+    }
+    accepting_ = true;
+    background_ = background;
+    if (background) {
+        if (!cursors_.empty() || !statements_.empty()) {
+            schedule();
+        }
+    } else {
+        waitUnscheduled(lock);
+    }
+}
+
+void DeferredRelease::disable() noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    accepting_ = false;
+}
+
+void DeferredRelease::close() noexcept {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        closed_ = true;
+        accepting_ = false;
+        background_ = false;
+        waitUnscheduled(lock);
+    }
+    drain();
+}
+
+void DeferredRelease::schedule() {
+    if (!background_ || scheduled_) {
+        return;
+    }
+    try {
+        Executor::shared()->post([this] { run(); });
+        scheduled_ = true;
+    } catch (...) {
+        // Left queued for the next push or the owner's drain()
+    }
+}
+
+void DeferredRelease::waitUnscheduled(std::unique_lock<std::mutex>& lock) {
+    if (!scheduled_) {
+        return;   // Never touch (or start) the executor needlessly
+    }
+    // A helping wait: the drain task may sit behind the caller's worker
+    Executor::shared()->waitHelping(lock, idle_, [this] { return !scheduled_; });
+}
+
+void DeferredRelease::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (background_ && (!cursors_.empty() || !statements_.empty())) {
+        lock.unlock();
+        drain();
+        lock.lock();
+    }
+    // Notify under the lock: close() may destroy the queue as soon as it
+    // can take the mutex.
+    scheduled_ = false;
+    idle_.notify_all();
+}
+
+} // namespace fbpp::core::detail
@@ -0,0 +1,370 @@
+#include "fbpp/core/distributed_transaction.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/extended_types.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp_util/trace.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <tuple>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace fbpp {
+namespace core {
+
+namespace {
+
+// Prepare messages: "fbpp-2pc <coordinator> <global id> <participant>/<count>"
+constexpr std::string_view kMessagePrefix = "fbpp-2pc ";
+
+// Coordinator of transactions prepared without a decision log
+constexpr std::string_view kNoLogCoordinator = "-";
+
+constexpr int16_t kLimboState = 1;   // RDB$TRANSACTIONS.RDB$TRANSACTION_STATE
+
+uint64_t randomWord() {
+    std::random_device device;
+    return (static_cast<uint64_t>(device()) << 32) ^ device() ^
+           static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
+}
+
+std::string newGlobalId() {
+    static std::atomic<uint64_t> counter{0};
+    static const uint64_t process = randomWord();
+    std::ostringstream oss;
+    oss << std::hex << process << '-' << std::dec << ++counter;
+    return oss.str();
+}
+
+// Append one line and sync it to disk before returning
+void appendDurably(const std::filesystem::path& path, const std::string& line) {
+#ifdef _WIN32
+    std::FILE* file = ::_wfopen(path.c_str(), L"ab");
+#else
+    std::FILE* file = std::fopen(path.c_str(), "ab");
+#endif
+    if (!file) {
+        throw FirebirdException("Cannot open 2PC log " + path.string());
+    }
+    bool ok = std::fwrite(line.data(), 1, line.size(), file) == line.size() &&
+              std::fflush(file) == 0;
+#ifdef _WIN32
+    ok = ok && ::_commit(::_fileno(file)) == 0;
+#else
+    ok = ok && ::fsync(::fileno(file)) == 0;
+#endif
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        throw FirebirdException("Cannot write 2PC log " + path.string());
+    }
+}
+
+// Coordinator id of a decision log (its first COORDINATOR record, normally
+// line 1); empty if it has none yet
+std::string loggedCoordinator(const std::filesystem::path& path) {
+    std::ifstream in(path);
+    std::string verb;
+    std::string id;
+    while (in >> verb >> id) {
+        if (verb == "COORDINATOR") {
+            return id;
+        }
+    }
+    return {};
+}
+
+// Coordinator id of a decision log, written on first use. Processes that
+// race to start the same log both end up with the record appended first.
+std::string logCoordinator(const std::filesystem::path& path) {
+    std::string coordinator = loggedCoordinator(path);
+    if (coordinator.empty()) {
+        std::ostringstream oss;
+        oss << std::hex << randomWord() << randomWord();
+        appendDurably(path, "COORDINATOR " + oss.str() + '\n');
+        coordinator = loggedCoordinator(path);
+    }
+    return coordinator;
+}
+
+// Global ids with a logged commit decision
+std::set<std::string> loggedCommits(const std::filesystem::path& path) {
+    std::set<std::string> commits;
+    std::ifstream in(path);
+    std::string verb;
+    std::string id;
+    while (in >> verb >> id) {
+        if (verb == "COMMIT") {
+            commits.insert(id);
+        }
+    }
+    return commits;
+}
+
+FirebirdException participantError(const char* phase, size_t participant,
+                                   const std::exception_ptr& error) {
+    std::string message;
+    try {
+        std::rethrow_exception(error);
+    } catch (const std::exception& e) {
+        message = e.what();
+    } catch (...) {
+        message = "unknown exception";
+    }
+    return FirebirdException(std::string("DistributedTransaction ") + phase +
+                             " failed on participant " + std::to_string(participant) + ": " +
+                             message);
+}
+
+} // namespace
+
+DistributedTransaction::DistributedTransaction(std::vector<Connection*> participants,
+                                               DistributedTransactionOptions options)
+    : participants_(std::move(participants))
+    , options_(std::move(options))
+    , id_(newGlobalId()) {
+    if (participants_.empty()) {
+        throw FirebirdException("DistributedTransaction needs at least one participant");
+    }
+    for (size_t i = 0; i < participants_.size(); ++i) {
+        if (!participants_[i]) {
+            throw FirebirdException("DistributedTransaction: participant " + std::to_string(i) +
+                                    " has no connection");
+        }
+        for (size_t j = 0; j < i; ++j) {
+            if (participants_[j] == participants_[i]) {
+                throw FirebirdException("DistributedTransaction: participant " +
+                                        std::to_string(i) + " repeats participant " +
+                                        std::to_string(j));
+            }
+        }
+    }
+    transactions_.reserve(participants_.size());
+    try {
+        for (Connection* connection : participants_) {
+            transactions_.push_back(connection->StartTransaction(options_.transaction));
+        }
+    } catch (...) {
+        rollbackQuietly();
+        throw;
+    }
+}
+
+DistributedTransaction::~DistributedTransaction() {
+    if (state_ == State::Active || state_ == State::Prepared) {
+        fbpp::util::trace(fbpp::util::TraceLevel::warn, "DistributedTransaction",
+                          [&](auto& oss) { oss << id_ << " destroyed unresolved; rolling back"; });
+        rollbackQuietly();
+    }
+}
+
+template<typename Fn>
+std::vector<std::exception_ptr> DistributedTransaction::forEach(Fn&& fn) {
+    std::vector<std::exception_ptr> errors(transactions_.size());
+    auto run = [&](size_t i) {
+        try {
+            fn(i, *transactions_[i]);
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> threads;
+    if (options_.parallel && transactions_.size() > 1) {
+        threads.reserve(transactions_.size() - 1);
+        for (size_t i = 1; i < transactions_.size(); ++i) {
+            try {
+                threads.emplace_back(run, i);
+            } catch (...) {
+                run(i);   // No thread: this one runs here
+            }
+        }
+        run(0);
+    } else {
+        for (size_t i = 0; i < transactions_.size(); ++i) {
+            run(i);
+        }
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return errors;
+}
+
+void DistributedTransaction::rollbackQuietly() noexcept {
+    for (auto& transaction : transactions_) {
+        try {
+            if (transaction && transaction->isActive()) {
+                transaction->Rollback();
+            }
+        } catch (...) {
+            // Best effort: an unreachable participant rolls back when its attachment dies
+        }
+    }
+    state_ = State::RolledBack;
+}
+
+void DistributedTransaction::prepare() {
+    if (state_ == State::Prepared) {
+        return;
+    }
+    if (state_ != State::Active) {
+        throw FirebirdException("DistributedTransaction " + id_ + " is not active");
+    }
+    std::string message(kMessagePrefix);
+    try {
+        message += options_.logFile.empty() ? std::string(kNoLogCoordinator)
+                                            : logCoordinator(options_.logFile);
+    } catch (...) {
+        rollbackQuietly();   // No identity for recover(): abort
+        throw;
+    }
+    message += ' ' + id_ + ' ';
+    const std::string count = std::to_string(transactions_.size());
+    const auto errors = forEach([&](size_t i, Transaction& transaction) {
+        transaction.Prepare(message + std::to_string(i) + '/' + count);
+    });
+    for (size_t i = 0; i < errors.size(); ++i) {
+        if (errors[i]) {
+            rollbackQuietly();
+            throw participantError("prepare", i, errors[i]);
+        }
+    }
+    state_ = State::Prepared;
+}
+
+void DistributedTransaction::commit() {
+    prepare();
+
+    if (!options_.logFile.empty()) {
+        try {
+            appendDurably(options_.logFile, "COMMIT " + id_ + '\n');
+        } catch (...) {
+            rollbackQuietly();   // No decision on disk: abort
+            throw;
+        }
+    }
+
+    const auto errors = forEach([](size_t, Transaction& transaction) { transaction.Commit(); });
+    std::exception_ptr first;
+    size_t failed = 0;
+    for (size_t i = 0; i < errors.size(); ++i) {
+        if (!errors[i]) {
+            continue;
+        }
+        if (!first) {
+            first = errors[i];
+            failed = i;
+        }
+        // Committed elsewhere: this one must not roll back
+        try {
+            if (transactions_[i]->isActive()) {
+                transactions_[i]->Disconnect();
+            }
+        } catch (...) {
+        }
+    }
+    if (first) {
+        state_ = State::InDoubt;
+        throw participantError("commit", failed, first);
+    }
+    state_ = State::Committed;
+
+    if (!options_.logFile.empty()) {
+        try {
+            appendDurably(options_.logFile, "DONE " + id_ + '\n');
+        } catch (...) {
+            // The commit stands; recovery just finds nothing to resolve
+        }
+    }
+}
+
+void DistributedTransaction::rollback() {
+    if (state_ != State::Active && state_ != State::Prepared) {
+        throw FirebirdException("DistributedTransaction " + id_ + " is not active");
+    }
+    const auto errors = forEach([](size_t, Transaction& transaction) {
+        if (transaction.isActive()) {
+            transaction.Rollback();
+        }
+    });
+    state_ = State::RolledBack;
+    for (size_t i = 0; i < errors.size(); ++i) {
+        if (errors[i]) {
+            throw participantError("rollback", i, errors[i]);
+        }
+    }
+}
+
+DistributedRecovery DistributedTransaction::recover(const std::vector<Connection*>& databases,
+                                                    const std::filesystem::path& logFile) {
+    const std::string coordinator =
+        logFile.empty() ? std::string(kNoLogCoordinator) : loggedCoordinator(logFile);
+    const std::set<std::string> commits =
+        logFile.empty() ? std::set<std::string>{} : loggedCommits(logFile);
+
+    DistributedRecovery result;
+    if (coordinator.empty()) {
+        return result;   // The log never prepared anything
+    }
+    for (Connection* connection : databases) {
+        if (!connection) {
+            continue;
+        }
+        // Our limbo transactions and whether to commit them
+        std::vector<std::pair<uint64_t, bool>> resolve;
+        {
+            auto tx = connection->StartTransaction(TransactionOptions::readOnlyReadCommitted());
+            auto cursor = tx->openCursor(connection->prepareStatement(
+                "SELECT RDB$TRANSACTION_ID, RDB$TRANSACTION_DESCRIPTION FROM RDB$TRANSACTIONS "
+                "WHERE RDB$TRANSACTION_STATE = ?"),
+                std::make_tuple(kLimboState));
+            std::tuple<int64_t, Blob> row;
+            while (cursor->fetch(row)) {
+                Blob& description = std::get<1>(row);
+                if (description.isNull()) {
+                    continue;
+                }
+                const auto bytes =
+                    tx->loadBlob(reinterpret_cast<ISC_QUAD*>(description.getId()));
+                const std::string message(bytes.begin(), bytes.end());
+                if (message.compare(0, kMessagePrefix.size(), kMessagePrefix) != 0) {
+                    continue;   // Not a DistributedTransaction
+                }
+                std::istringstream fields(message.substr(kMessagePrefix.size()));
+                std::string owner;
+                std::string globalId;
+                if (!(fields >> owner >> globalId) || owner != coordinator) {
+                    continue;   // Another coordinator's, possibly still running
+                }
+                resolve.emplace_back(static_cast<uint64_t>(std::get<0>(row)),
+                                     commits.count(globalId) != 0);
+            }
+            cursor->close();
+            tx->Commit();
+        }
+        for (const auto& [id, commit] : resolve) {
+            auto limbo = connection->reconnectTransaction(id);
+            if (commit) {
+                limbo->Commit();
+                ++result.committed;
+            } else {
+                limbo->Rollback();
+                ++result.rolledBack;
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace core
+} // namespace fbpp
@@ -0,0 +1,500 @@
+#include "fbpp/core/detail/event_hub.hpp"
+#include "fbpp/core/event_subscription.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp_util/trace.h"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+namespace fbpp::core {
+
+namespace detail {
+
+namespace {
+
+constexpr unsigned char kEpbVersion1 = 1;
+constexpr std::size_t kMaxEpbLength = 65535;    // queEvents takes a USHORT length
+constexpr std::size_t kMaxEventName = 255;      // One length byte per name
+
+std::size_t epbLength(const std::vector<std::string>& names) {
+    std::size_t length = 1;
+    for (const auto& name : names) {
+        length += 1 + name.size() + 4;
+    }
+    return length;
+}
+
+void addPosts(std::vector<EventNotification>& fired, const std::string& name, unsigned posts) {
+    for (auto& notification : fired) {
+        if (notification.name == name) {
+            notification.count += posts;
+            return;
+        }
+    }
+    fired.push_back({name, posts});
+}
+
+} // namespace
+
+// Runs on the fbclient thread: copies the counters and signals, nothing else.
+// Holds the inbox, not the hub, so a late answer after shutdown is harmless.
+class EventCallback final
+    : public Firebird::IEventCallbackImpl<EventCallback, Firebird::ThrowStatusWrapper> {
+public:
+    EventCallback(std::shared_ptr<EventHub::Inbox> inbox, std::uint64_t registration)
+        : inbox_(std::move(inbox)), registration_(registration) {}
+
+    void addRef() {
+        refs_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    int release() {
+        if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+            return 0;
+        }
+        return 1;
+    }
+
+    void eventCallbackFunction(unsigned length, const unsigned char* events) {
+        if (length == 0 || !events) {
+            return;   // Cancelled registration
+        }
+        {
+            std::lock_guard<std::mutex> lock(inbox_->mutex);
+            if (inbox_->closed) {
+                return;
+            }
+            inbox_->pending.push_back({registration_, std::vector<unsigned char>(events, events + length)});
+        }
+        inbox_->ready.notify_one();
+    }
+
+private:
+    std::shared_ptr<EventHub::Inbox> inbox_;
+    const std::uint64_t registration_;
+    std::atomic<int> refs_{1};
+};
+
+EventHub::EventHub(Environment& env, Firebird::IAttachment* attachment,
+                   std::chrono::milliseconds batchWindow, unsigned namesPerRegistration)
+    : env_(env)
+    , attachment_(attachment)
+    , batchWindow_(batchWindow)
+    , namesPerRegistration_(namesPerRegistration)
+    , inbox_(std::make_shared<Inbox>()) {}
+
+EventHub::~EventHub() {
+    shutdown();
+}
+
+std::uint64_t EventHub::subscribe(const std::vector<std::string>& names,
+                                  EventSubscription::BatchCallback callback) {
+    if (names.empty()) {
+        throw FirebirdException("subscribeEvents: no event names given");
+    }
+    for (const auto& name : names) {
+        if (name.empty()) {
+            throw FirebirdException("subscribeEvents: empty event name");
+        }
+        if (name.size() > kMaxEventName) {
+            throw FirebirdException("subscribeEvents: event name longer than 255 bytes: " +
+                                    name.substr(0, 32) + "...");
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (closed_.load(std::memory_order_acquire)) {
+        throw FirebirdException("subscribeEvents: connection is closed");
+    }
+
+    // Names already registered only gain a reference; the others go into
+    // the first block with room, and only those blocks are re-queued.
+    std::unordered_set<std::string> wanted;
+    std::vector<std::string> shared;
+    std::vector<std::string> added;
+    std::vector<std::size_t> touched;
+    for (const auto& name : names) {
+        if (!wanted.insert(name).second) {
+            continue;
+        }
+        auto it = names_.find(name);
+        if (it != names_.end()) {
+            ++it->second.refs;
+            shared.push_back(name);
+            continue;
+        }
+        const std::size_t index = blockFor(name.size());
+        Block& block = blocks_[index];
+        block.names.push_back(name);
+        block.counts.push_back(0);
+        block.primed.push_back(false);
+        names_.emplace(name, NameRef{index, 1});
+        added.push_back(name);
+        if (std::find(touched.begin(), touched.end(), index) == touched.end()) {
+            touched.push_back(index);
+        }
+    }
+
+    try {
+        for (std::size_t index : touched) {
+            requeue(blocks_[index]);
+        }
+    } catch (...) {
+        for (const auto& name : shared) {
+            --names_[name].refs;
+        }
+        for (const auto& name : added) {
+            removeName(name);
+        }
+        for (std::size_t index : touched) {
+            try {
+                requeue(blocks_[index]);
+            } catch (...) {
+                // The original error is the one to report
+            }
+        }
+        throw;
+    }
+
+    const std::uint64_t id = ++nextSubscriber_;
+    subscribers_.emplace(id, Subscriber{std::move(wanted),
+        std::make_shared<const EventSubscription::BatchCallback>(std::move(callback))});
+    if (!dispatcher_.joinable()) {
+        dispatcher_ = std::thread([this] { run(); });
+        dispatcherId_ = dispatcher_.get_id();
+    }
+    return id;
+}
+
+void EventHub::unsubscribe(std::uint64_t id) noexcept {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (std::this_thread::get_id() != dispatcherId_) {
+        idle_.wait(lock, [&] { return dispatching_ != id; });
+    }
+    auto it = subscribers_.find(id);
+    if (it == subscribers_.end()) {
+        return;
+    }
+    const auto names = std::move(it->second.names);
+    subscribers_.erase(it);
+
+    std::vector<std::size_t> touched;
+    for (const auto& name : names) {
+        auto ref = names_.find(name);
+        if (ref == names_.end() || --ref->second.refs != 0) {
+            continue;
+        }
+        if (std::find(touched.begin(), touched.end(), ref->second.block) == touched.end()) {
+            touched.push_back(ref->second.block);
+        }
+        removeName(name);
+    }
+    for (std::size_t index : touched) {
+        try {
+            requeue(blocks_[index]);
+        } catch (const std::exception& e) {
+            fbpp::util::trace(fbpp::util::TraceLevel::warn, "Events",
+                        [&](auto& oss) { oss << "Re-queue after unsubscribe failed: " << e.what(); });
+        }
+    }
+}
+
+void EventHub::shutdown() noexcept {
+    if (closed_.exchange(true, std::memory_order_acq_rel)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(inbox_->mutex);
+        inbox_->closed = true;
+        inbox_->pending.clear();
+    }
+    inbox_->ready.notify_all();
+
+    std::thread worker;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        worker = std::move(dispatcher_);
+    }
+    if (worker.joinable()) {
+        if (worker.get_id() == std::this_thread::get_id()) {
+            worker.detach();   // Connection destroyed from a callback
+        } else {
+            worker.join();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& block : blocks_) {
+        dequeue(block, true);
+    }
+    subscribers_.clear();
+    names_.clear();
+}
+
+EventStatistics EventHub::statistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    EventStatistics stats = stats_;
+    stats.subscriptions = subscribers_.size();
+    stats.names = names_.size();
+    stats.registrations = static_cast<std::size_t>(std::count_if(blocks_.begin(), blocks_.end(),
+        [](const Block& block) { return block.registration != 0; }));
+    return stats;
+}
+
+void EventHub::run() {
+    for (;;) {
+        std::vector<Delivery> deliveries;
+        {
+            std::unique_lock<std::mutex> lock(inbox_->mutex);
+            inbox_->ready.wait(lock, [&] { return inbox_->closed || !inbox_->pending.empty(); });
+            if (inbox_->closed) {
+                return;
+            }
+            deliveries.swap(inbox_->pending);
+        }
+
+        std::vector<EventNotification> fired;
+        absorb(deliveries, fired);
+
+        // Posts from one burst of commits arrive as several answers (each
+        // re-queue is answered separately): let them join this batch.
+        if (!fired.empty() && batchWindow_.count() > 0) {
+            const auto deadline = std::chrono::steady_clock::now() + batchWindow_;
+            for (;;) {
+                {
+                    std::unique_lock<std::mutex> lock(inbox_->mutex);
+                    if (!inbox_->ready.wait_until(lock, deadline, [&] {
+                            return inbox_->closed || !inbox_->pending.empty();
+                        })) {
+                        break;
+                    }
+                    if (inbox_->closed) {
+                        return;
+                    }
+                    deliveries.clear();
+                    deliveries.swap(inbox_->pending);
+                }
+                absorb(deliveries, fired);
+            }
+        }
+
+        if (!fired.empty()) {
+            dispatch(fired);
+        }
+    }
+}
+
+void EventHub::absorb(std::vector<Delivery>& deliveries, std::vector<EventNotification>& fired) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& delivery : deliveries) {
+        auto block = std::find_if(blocks_.begin(), blocks_.end(), [&](const Block& b) {
+            return b.registration == delivery.registration;
+        });
+        if (block == blocks_.end()) {
+            continue;   // Answer to a registration replaced since
+        }
+        ++stats_.deliveries;
+
+        // Same layout as the queued EPB: len, name, count (4 bytes LE)
+        const auto& epb = delivery.counts;
+        std::size_t pos = 1;
+        std::size_t slot = 0;
+        while (pos < epb.size() && slot < block->names.size()) {
+            const std::size_t length = epb[pos++];
+            if (pos + length + 4 > epb.size()) {
+                break;
+            }
+            pos += length;
+            const std::uint32_t value = static_cast<std::uint32_t>(epb[pos]) |
+                                        static_cast<std::uint32_t>(epb[pos + 1]) << 8 |
+                                        static_cast<std::uint32_t>(epb[pos + 2]) << 16 |
+                                        static_cast<std::uint32_t>(epb[pos + 3]) << 24;
+            pos += 4;
+
+            if (!block->primed[slot]) {
+                block->primed[slot] = true;   // Baseline only
+            } else if (value != block->counts[slot]) {
+                addPosts(fired, block->names[slot], value - block->counts[slot]);
+            }
+            block->counts[slot] = value;
+            ++slot;
+        }
+
+        // Events fire once: arm again before anyone is told
+        dequeue(*block, false);
+        try {
+            queue(*block);
+        } catch (const std::exception& e) {
+            fbpp::util::trace(fbpp::util::TraceLevel::error, "Events",
+                        [&](auto& oss) { oss << "Re-queue of events failed: " << e.what(); });
+        }
+    }
+}
+
+void EventHub::dispatch(const std::vector<EventNotification>& fired) {
+    std::vector<std::uint64_t> ids;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ids.reserve(subscribers_.size());
+        for (const auto& entry : subscribers_) {
+            ids.push_back(entry.first);
+        }
+    }
+
+    for (std::uint64_t id : ids) {
+        std::shared_ptr<const EventSubscription::BatchCallback> callback;
+        std::vector<EventNotification> batch;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = subscribers_.find(id);
+            if (it == subscribers_.end()) {
+                continue;   // Cancelled by an earlier callback
+            }
+            for (const auto& notification : fired) {
+                if (it->second.names.count(notification.name) != 0) {
+                    batch.push_back(notification);
+                }
+            }
+            if (batch.empty() || !*it->second.callback) {
+                continue;
+            }
+            callback = it->second.callback;
+            dispatching_ = id;
+            ++stats_.batches;
+        }
+
+        try {
+            (*callback)(batch);
+        } catch (const std::exception& e) {
+            fbpp::util::trace(fbpp::util::TraceLevel::error, "Events",
+                        [&](auto& oss) { oss << "Event callback threw: " << e.what(); });
+        } catch (...) {
+            fbpp::util::trace(fbpp::util::TraceLevel::error, "Events",
+                        [](auto& oss) { oss << "Event callback threw a non-standard exception"; });
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            dispatching_ = 0;
+        }
+        idle_.notify_all();
+    }
+}
+
+std::size_t EventHub::blockFor(std::size_t nameBytes) {
+    for (std::size_t i = 0; i < blocks_.size(); ++i) {
+        const Block& block = blocks_[i];
+        if (namesPerRegistration_ != 0 && block.names.size() >= namesPerRegistration_) {
+            continue;
+        }
+        if (epbLength(block.names) + 1 + nameBytes + 4 <= kMaxEpbLength) {
+            return i;
+        }
+    }
+    blocks_.emplace_back();
+    return blocks_.size() - 1;
+}
+
+void EventHub::queue(Block& block) {
+    std::vector<unsigned char> epb;
+    epb.reserve(epbLength(block.names));
+    epb.push_back(kEpbVersion1);
+    for (std::size_t i = 0; i < block.names.size(); ++i) {
+        const auto& name = block.names[i];
+        epb.push_back(static_cast<unsigned char>(name.size()));
+        epb.insert(epb.end(), name.begin(), name.end());
+        const std::uint32_t count = block.counts[i];
+        epb.push_back(static_cast<unsigned char>(count));
+        epb.push_back(static_cast<unsigned char>(count >> 8));
+        epb.push_back(static_cast<unsigned char>(count >> 16));
+        epb.push_back(static_cast<unsigned char>(count >> 24));
+    }
+
+    const std::uint64_t registration = ++nextRegistration_;
+    auto* callback = new EventCallback(inbox_, registration);
+    Firebird::IStatus* raw = env_.getMaster()->getStatus();
+    Firebird::ThrowStatusWrapper st(raw);
+    try {
+        // The server may answer before queEvents returns: the delivery
+        // waits in the inbox until the dispatcher gets mutex_ after us.
+        block.events = attachment_->queEvents(&st, callback, static_cast<unsigned>(epb.size()), epb.data());
+        st.dispose();
+    }
+    catch (const Firebird::FbException& e) {
+        st.dispose();
+        callback->release();
+        throw FirebirdException(e);
+    }
+    block.callback = callback;
+    block.registration = registration;
+    ++stats_.queued;
+}
+
+void EventHub::dequeue(Block& block, bool cancel) noexcept {
+    if (block.events) {
+        if (cancel) {
+            Firebird::IStatus* raw = env_.getMaster()->getStatus();
+            Firebird::ThrowStatusWrapper st(raw);
+            try {
+                block.events->cancel(&st);
+            } catch (...) {
+                // Attachment already lost: nothing left to cancel
+            }
+            st.dispose();
+        }
+        block.events->release();
+        block.events = nullptr;
+    }
+    if (block.callback) {
+        block.callback->release();
+        block.callback = nullptr;
+    }
+    block.registration = 0;
+}
+
+void EventHub::requeue(Block& block) {
+    dequeue(block, true);
+    if (!block.names.empty()) {
+        queue(block);
+    }
+}
+
+void EventHub::removeName(const std::string& name) {
+    auto ref = names_.find(name);
+    if (ref == names_.end()) {
+        return;
+    }
+    Block& block = blocks_[ref->second.block];
+    auto pos = std::find(block.names.begin(), block.names.end(), name);
+    if (pos != block.names.end()) {
+        const auto slot = static_cast<std::size_t>(pos - block.names.begin());
+        block.names.erase(pos);
+        block.counts.erase(block.counts.begin() + static_cast<std::ptrdiff_t>(slot));
+        block.primed.erase(block.primed.begin() + static_cast<std::ptrdiff_t>(slot));
+    }
+    names_.erase(ref);
+}
+
+} // namespace detail
+
+EventSubscription::EventSubscription(std::shared_ptr<detail::EventHub> hub, std::uint64_t id,
+                                     std::vector<std::string> names)
+    : hub_(std::move(hub)), id_(id), names_(std::move(names)) {}
+
+EventSubscription::~EventSubscription() {
+    cancel();
+}
+
+void EventSubscription::cancel() {
+    if (active_.exchange(false) && hub_) {
+        hub_->unsubscribe(id_);
+    }
+}
+
+bool EventSubscription::isActive() const noexcept {
+    return active_.load() && hub_ && hub_->isOpen();
+}
+
+} // namespace fbpp::core
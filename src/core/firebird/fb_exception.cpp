@@ -97,25 +97,109 @@ FirebirdException::FirebirdException(std::string message)
 
 FirebirdException::FirebirdException(const Firebird::FbException& fb_ex)
     : error_code_(0)
-    , sql_code_(0) {
+    , sql_code_(0)
+    , formatted_(std::make_shared<Formatted>()) {
+    extractErrorDetails(fb_ex.getStatus());
+    if (sql_state_.empty()) sql_state_ = "HY000";
+}
 
-    Firebird::IStatus* status = fb_ex.getStatus();
-    extractErrorDetails(status);
+const char* FirebirdException::what() const noexcept {
+    const Formatted* text = formatted();
+    return text ? text->message.c_str() : message_.c_str();
+}
 
-    auto& env = Environment::getInstance();
-    char buffer[4096] = {0};
-    env.getUtil()->formatStatus(buffer, sizeof(buffer), status);
-    message_ = buffer;
+const std::vector<std::string>& FirebirdException::getErrorMessages() const noexcept {
+    static const std::vector<std::string> none;
+    const Formatted* text = formatted();
+    return text ? text->errorMessages : none;
+}
 
-    if (error_messages_.size() > 1) {
-        std::stringstream ss;
-        ss << message_ << "\nError chain:";
-        for (size_t i = 0; i < error_messages_.size(); ++i) {
-            ss << "\n  [" << i << "] " << error_messages_[i];
-        }
-        message_ = ss.str();
+const FirebirdException::Formatted* FirebirdException::formatted() const noexcept {
+    if (!formatted_) {
+        return nullptr;
     }
-    if (sql_state_.empty()) sql_state_ = "HY000";
+    try {
+        std::call_once(formatted_->once, [this] {
+            Formatted& out = *formatted_;
+            auto& env = Environment::getInstance();
+            Firebird::IStatus* tmp = env.getMaster()->getStatus();
+            struct Release {
+                Firebird::IStatus* status;
+                ~Release() { status->dispose(); }
+            } release{tmp};
+
+            // Per-entry texts: each GDS code formatted alone, its string /
+            // number arguments appended
+            for (const auto& entry : status_vector_) {
+                switch (entry.tag) {
+                    case isc_arg_gds: {
+                        char msg[1024] = {0};
+                        const intptr_t temp_vec[] = { isc_arg_gds, entry.numericValue, isc_arg_end };
+                        tmp->setErrors(temp_vec);
+                        env.getUtil()->formatStatus(msg, sizeof(msg), tmp);
+                        out.errorMessages.emplace_back(msg);
+                        break;
+                    }
+                    case isc_arg_string:
+                        if (!out.errorMessages.empty()) {
+                            out.errorMessages.back() += " - ";
+                            out.errorMessages.back() += entry.textValue;
+                        } else {
+                            out.errorMessages.push_back(entry.textValue);
+                        }
+                        break;
+                    case isc_arg_number:
+                        if (!out.errorMessages.empty()) {
+                            out.errorMessages.back() += " ";
+                            out.errorMessages.back() += std::to_string(entry.numericValue);
+                        }
+                        break;
+                    case isc_arg_interpreted:
+                    case isc_arg_cstring:
+                        out.errorMessages.push_back(entry.textValue);
+                        break;
+                    case isc_arg_warning:
+                        out.errorMessages.push_back("Warning: " + std::to_string(entry.numericValue));
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            // Whole message: the snapshot turned back into a status vector
+            std::vector<intptr_t> errors;
+            errors.reserve(status_vector_.size() * 3 + 1);
+            for (const auto& entry : status_vector_) {
+                errors.push_back(entry.tag);
+                if (entry.payloadKind == PayloadKind::integer) {
+                    errors.push_back(entry.numericValue);
+                } else if (entry.payloadKind == PayloadKind::text) {
+                    if (entry.tag == isc_arg_cstring) {
+                        errors.push_back(static_cast<intptr_t>(entry.textValue.size()));
+                    }
+                    errors.push_back(reinterpret_cast<intptr_t>(entry.textValue.c_str()));
+                }
+            }
+            errors.push_back(isc_arg_end);
+            char buffer[4096] = {0};
+            tmp->setErrors(errors.data());
+            env.getUtil()->formatStatus(buffer, sizeof(buffer), tmp);
+            out.message = buffer;
+
+            if (out.errorMessages.size() > 1) {
+                std::stringstream ss;
+                ss << out.message << "\nError chain:";
+                for (size_t i = 0; i < out.errorMessages.size(); ++i) {
+                    ss << "\n  [" << i << "] " << out.errorMessages[i];
+                }
+                out.message = ss.str();
+            }
+        });
+    } catch (...) {
+        // Formatting failed (out of memory, no client library): codes only
+        return nullptr;
+    }
+    return formatted_.get();
 }
 
 void FirebirdException::extractErrorDetails(Firebird::IStatus* status) {
@@ -125,7 +209,6 @@ void FirebirdException::extractErrorDetails(Firebird::IStatus* status) {
 
     error_code_ = 0;
     sql_state_.clear();
-    error_messages_.clear();
     status_vector_.clear();
     sql_code_ = static_cast<int>(isc_sqlcode(reinterpret_cast<const ISC_STATUS*>(errors)));
 
@@ -143,6 +226,7 @@ void FirebirdException::extractErrorDetails(Firebird::IStatus* status) {
         }
     }
 
+    // Snapshot only; message texts are formatted from it on first use
     size_t i = 0;
     while (errors[i] != isc_arg_end) {
         const intptr_t tag = errors[i++];
@@ -156,38 +240,18 @@ void FirebirdException::extractErrorDetails(Firebird::IStatus* status) {
                     // isc_arg_sql_state arrives later in the vector and must
                     // win; the code->state map is only a fallback (see below).
                 }
-
-                auto& env = Environment::getInstance();
-                char msg[1024] = {0};
-
-                Firebird::IStatus* tmp = env.getMaster()->getStatus();
-                const intptr_t temp_vec[] = { isc_arg_gds, code, isc_arg_end };
-                tmp->setErrors(temp_vec);
-                env.getUtil()->formatStatus(msg, sizeof(msg), tmp);
-                error_messages_.emplace_back(msg);
-                tmp->dispose();
                 break;
             }
-            case isc_arg_string: {
+            case isc_arg_string:
+            case isc_arg_interpreted: {
                 const char* s = reinterpret_cast<const char*>(errors[i++]);
                 status_vector_.push_back(makeTextEntry(tag, s));
-                if (s) {
-                    if (!error_messages_.empty()) {
-                        error_messages_.back() += " - ";
-                        error_messages_.back() += s;
-                    } else {
-                        error_messages_.emplace_back(s);
-                    }
-                }
                 break;
             }
-            case isc_arg_number: {
+            case isc_arg_number:
+            case isc_arg_warning: {
                 const intptr_t n = errors[i++];
                 status_vector_.push_back(makeIntegerEntry(tag, n));
-                if (!error_messages_.empty()) {
-                    error_messages_.back() += " ";
-                    error_messages_.back() += std::to_string(n);
-                }
                 break;
             }
             case isc_arg_sql_state: {
@@ -197,25 +261,10 @@ void FirebirdException::extractErrorDetails(Firebird::IStatus* status) {
                 if (st && *st) sql_state_ = st;
                 break;
             }
-            case isc_arg_interpreted: {
-                const char* s = reinterpret_cast<const char*>(errors[i++]);
-                status_vector_.push_back(makeTextEntry(tag, s));
-                if (s) error_messages_.emplace_back(s);
-                break;
-            }
             case isc_arg_cstring: {
                 const auto length = static_cast<size_t>(errors[i++]);
                 const char* s = reinterpret_cast<const char*>(errors[i++]);
                 status_vector_.push_back(makeTextEntry(tag, s, length));
-                if (s) error_messages_.emplace_back(std::string(s, length));
-                break;
-            }
-            case isc_arg_warning: {
-                const intptr_t w = errors[i++];
-                status_vector_.push_back(makeIntegerEntry(tag, w));
-                std::stringstream ss;
-                ss << "Warning: " << w;
-                error_messages_.emplace_back(ss.str());
                 break;
             }
 #ifdef _WIN32
@@ -0,0 +1,409 @@
+#include "fbpp/core/execute_block_batch.hpp"
+
+#include "fbpp/core/detail/sql_lexer.hpp"
+#include "fbpp/core/firebird_compat.hpp"
+
+#include <bit>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <utility>
+
+namespace fbpp {
+namespace core {
+
+namespace {
+
+// Firebird's input message limit
+constexpr std::size_t kMaxMessageBytes = 65535;
+
+struct CharsetName {
+    unsigned id;
+    const char* name;
+    unsigned bytesPerChar;
+};
+
+// RDB$CHARACTER_SETS ids of the character sets Firebird ships
+constexpr CharsetName kCharsets[] = {
+    {0, "NONE", 1},        {1, "OCTETS", 1},      {2, "ASCII", 1},
+    {3, "UNICODE_FSS", 3}, {4, "UTF8", 4},        {5, "SJIS_0208", 2},
+    {6, "EUCJ_0208", 2},   {9, "DOS737", 1},      {10, "DOS437", 1},
+    {11, "DOS850", 1},     {12, "DOS865", 1},     {13, "DOS860", 1},
+    {14, "DOS863", 1},     {15, "DOS775", 1},     {16, "DOS858", 1},
+    {17, "DOS862", 1},     {18, "DOS864", 1},     {19, "NEXT", 1},
+    {21, "ISO8859_1", 1},  {22, "ISO8859_2", 1},  {23, "ISO8859_3", 1},
+    {34, "ISO8859_4", 1},  {35, "ISO8859_5", 1},  {36, "ISO8859_6", 1},
+    {37, "ISO8859_7", 1},  {38, "ISO8859_8", 1},  {39, "ISO8859_9", 1},
+    {40, "ISO8859_13", 1}, {44, "KSC_5601", 2},   {45, "DOS852", 1},
+    {46, "DOS857", 1},     {47, "DOS861", 1},     {48, "DOS866", 1},
+    {49, "DOS869", 1},     {50, "CYRL", 1},       {51, "WIN1250", 1},
+    {52, "WIN1251", 1},    {53, "WIN1252", 1},    {54, "WIN1253", 1},
+    {55, "WIN1254", 1},    {56, "BIG_5", 2},      {57, "GB_2312", 2},
+    {58, "WIN1255", 1},    {59, "WIN1256", 1},    {60, "WIN1257", 1},
+    {63, "KOI8R", 1},      {64, "KOI8U", 1},      {65, "WIN1258", 1},
+    {66, "TIS620", 1},     {67, "GBK", 2},        {68, "CP943C", 2},
+    {69, "GB18030", 4},
+};
+
+const CharsetName& charsetOf(const FieldInfo& field) {
+    const unsigned id = field.charSet & 0xFFu;
+    for (const auto& charset : kCharsets) {
+        if (charset.id == id) {
+            return charset;
+        }
+    }
+    throw FirebirdException("ExecuteBlockBatch: unknown character set id " + std::to_string(id));
+}
+
+std::string textType(const char* type, const FieldInfo& field) {
+    const CharsetName& charset = charsetOf(field);
+    return std::string(type) + "(" + std::to_string(field.length / charset.bytesPerChar) +
+           ") CHARACTER SET " + charset.name;
+}
+
+std::string scaled(const char* plain, int precision, const FieldInfo& field) {
+    if (field.scale == 0 && field.subType == 0) {
+        return plain;
+    }
+    return std::string(field.subType == 2 ? "DECIMAL(" : "NUMERIC(") + std::to_string(precision) +
+           ", " + std::to_string(-field.scale) + ")";
+}
+
+// Declaration of a block parameter / output with the field's message format
+std::string declaredType(const FieldInfo& field, const std::string& what) {
+    switch (field.type & ~1u) {
+        case SQL_SHORT:          return scaled("SMALLINT", 4, field);
+        case SQL_LONG:           return scaled("INTEGER", 9, field);
+        case SQL_INT64:          return scaled("BIGINT", 18, field);
+        case SQL_INT128:         return scaled("INT128", 38, field);
+        case SQL_FLOAT:          return "FLOAT";
+        case SQL_DOUBLE:
+        case SQL_D_FLOAT:        return "DOUBLE PRECISION";
+        case SQL_TYPE_DATE:      return "DATE";
+        case SQL_TYPE_TIME:      return "TIME";
+        case SQL_TIMESTAMP:      return "TIMESTAMP";
+        case SQL_TIME_TZ:
+        case SQL_TIME_TZ_EX:     return "TIME WITH TIME ZONE";
+        case SQL_TIMESTAMP_TZ:
+        case SQL_TIMESTAMP_TZ_EX: return "TIMESTAMP WITH TIME ZONE";
+        case SQL_BOOLEAN:        return "BOOLEAN";
+        case SQL_DEC16:          return "DECFLOAT(16)";
+        case SQL_DEC34:          return "DECFLOAT(34)";
+        case SQL_TEXT:           return textType("CHAR", field);
+        case SQL_VARYING:        return textType("VARCHAR", field);
+        case SQL_BLOB:
+            return field.subType == 1
+                       ? std::string("BLOB SUB_TYPE TEXT CHARACTER SET ") + charsetOf(field).name
+                       : "BLOB SUB_TYPE " + std::to_string(field.subType);
+        default:
+            throw FirebirdException("ExecuteBlockBatch: " + what + " has no declarable type (" +
+                                    "sql_type=" + std::to_string(field.type) + ")");
+    }
+}
+
+// First words of the statement's code in UPPERCASE, single-spaced
+std::string leadingWords(const std::string& sql, std::size_t limit) {
+    std::string words;
+    detail::SqlLexer lexer(sql);
+    detail::SqlLexer::Span span;
+    while (words.size() < limit && lexer.next(span)) {
+        if (span.kind != detail::SqlLexer::Kind::Code) {
+            words += ' ';
+            continue;
+        }
+        for (std::size_t i = span.begin; i < span.end && words.size() < limit; ++i) {
+            const auto c = static_cast<unsigned char>(sql[i]);
+            if (std::isspace(c)) {
+                if (!words.empty() && words.back() != ' ') {
+                    words += ' ';
+                }
+            } else {
+                words += static_cast<char>(std::toupper(c));
+            }
+        }
+    }
+    return words;
+}
+
+// An output's name as a block variable: its own when a plain identifier
+std::string outputName(const FieldInfo& field, std::size_t index, std::set<std::string>& used) {
+    std::string name = displayName(field);
+    bool plain = !name.empty() && std::isupper(static_cast<unsigned char>(name.front())) &&
+                 name.rfind("FBPP_", 0) != 0;
+    for (char c : name) {
+        const auto u = static_cast<unsigned char>(c);
+        plain = plain && (std::isupper(u) || std::isdigit(u) || c == '_' || c == '$');
+    }
+    if (!plain || !used.insert(name).second) {
+        name = "FBPP_R" + std::to_string(index);
+        used.insert(name);
+    }
+    return name;
+}
+
+std::size_t floorPowerOfTwo(std::size_t n) {
+    return n == 0 ? 1 : std::bit_floor(n);
+}
+
+} // namespace
+
+ExecuteBlockBatch::ExecuteBlockBatch(Connection& connection, std::string sql,
+                                     ExecuteBlockOptions options)
+    : ExecuteBlockBatch(connection, connection.prepareStatement(sql), options) {}
+
+ExecuteBlockBatch::ExecuteBlockBatch(Connection& connection, std::shared_ptr<Statement> statement,
+                                     ExecuteBlockOptions options)
+    : connection_(connection),
+      statement_(std::move(statement)),
+      rowCounts_(options.rowCounts),
+      continueOnError_(options.continueOnError) {
+    if (!statement_ || !statement_->isValid()) {
+        throw FirebirdException("ExecuteBlockBatch: statement is not valid");
+    }
+    const std::string& positional = statement_->getSql();
+    const auto output = statement_->getOutputMetadata();
+    const bool returns = output && output->getCount() > 0;
+    if (rowCounts_) {
+        if (statement_->kind() != Statement::StatementKind::Dml || returns) {
+            throw FirebirdException("ExecuteBlockBatch: rowCounts takes DML without RETURNING: " +
+                                    positional);
+        }
+    } else {
+        const std::string head = leadingWords(positional, 16);
+        if (head.rfind("INSERT ", 0) != 0 && head.rfind("UPDATE OR INSERT ", 0) != 0) {
+            throw FirebirdException("ExecuteBlockBatch: statement is not an INSERT: " + positional);
+        }
+        if (!returns) {
+            throw FirebirdException("ExecuteBlockBatch: INSERT has no RETURNING clause: " +
+                                    positional);
+        }
+    }
+    rowInput_ = statement_->getInputMetadata();
+    const unsigned parameters = rowInput_ ? rowInput_->getCount() : 0;
+
+    // Split the text at its '?' markers; strip a trailing ';'
+    std::string text = positional;
+    while (!text.empty() && (std::isspace(static_cast<unsigned char>(text.back())) ||
+                             text.back() == ';')) {
+        text.pop_back();
+    }
+    pieces_.emplace_back();
+    detail::SqlLexer lexer(text);
+    detail::SqlLexer::Span span;
+    while (lexer.next(span)) {
+        for (std::size_t i = span.begin; i < span.end; ++i) {
+            if (span.kind == detail::SqlLexer::Kind::Code && text[i] == '?') {
+                pieces_.emplace_back();
+            } else {
+                pieces_.back() += text[i];
+            }
+        }
+    }
+    if (pieces_.size() != parameters + 1u) {
+        throw FirebirdException("ExecuteBlockBatch: statement has " +
+                                std::to_string(pieces_.size() - 1) + " '?' markers for " +
+                                std::to_string(parameters) + " parameters");
+    }
+
+    for (unsigned j = 0; j < parameters; ++j) {
+        parameterTypes_.push_back(
+            declaredType(rowInput_->getFieldRef(j), "parameter " + std::to_string(j + 1)));
+    }
+    std::set<std::string> used;
+    for (unsigned i = 0; returns && i < output->getCount(); ++i) {
+        const FieldInfo& field = output->getFieldRef(i);
+        outputNames_.push_back(outputName(field, i, used));
+        outputTypes_.push_back(declaredType(field, "output " + displayName(field)));
+    }
+
+    // Slots within maxRows and the message limit; null indicators and
+    // alignment take at most 8 bytes per parameter beyond the data
+    const std::size_t rowBytes =
+        (rowInput_ ? rowInput_->getMessageLength() : 0) + 8u * parameters;
+    const std::size_t fit = rowBytes == 0 ? options.maxRows : (kMaxMessageBytes - 16) / rowBytes;
+    rowsPerBlock_ = floorPowerOfTwo(std::min(std::max<std::size_t>(options.maxRows, 1),
+                                             std::max<std::size_t>(fit, 1)));
+    if (rowInput_) {
+        row_.resize(rowInput_->getMessageLength());
+    }
+}
+
+std::string ExecuteBlockBatch::blockSql(std::size_t slots) const {
+    std::string sql = "EXECUTE BLOCK (FBPP_N INTEGER = ?";
+    const std::size_t parameters = parameterTypes_.size();
+    for (std::size_t slot = 0; slot < slots; ++slot) {
+        for (std::size_t j = 0; j < parameters; ++j) {
+            sql += ", FBPP_P" + std::to_string(slot) + "_" + std::to_string(j) + " " +
+                   parameterTypes_[j] + " = ?";
+        }
+    }
+    if (rowCounts_) {
+        return sql + countedBody(slots);
+    }
+    sql += ")\nRETURNS (";
+    std::string into;
+    for (std::size_t i = 0; i < outputNames_.size(); ++i) {
+        sql += (i == 0 ? "" : ", ") + outputNames_[i] + " " + outputTypes_[i];
+        into += (i == 0 ? ":" : ", :") + outputNames_[i];
+    }
+    sql += ")\nAS\nBEGIN\n";
+    for (std::size_t slot = 0; slot < slots; ++slot) {
+        sql += "  IF (FBPP_N > " + std::to_string(slot) + ") THEN BEGIN\n    " +
+               slotStatement(slot);
+        // On its own line: the statement may end in a -- comment
+        sql += "\n    INTO " + into + ";\n    SUSPEND;\n  END\n";
+    }
+    return sql + "END";
+}
+
+std::string ExecuteBlockBatch::slotStatement(std::size_t slot) const {
+    std::string sql;
+    for (std::size_t j = 0; j < pieces_.size(); ++j) {
+        if (j > 0) {
+            sql += ":FBPP_P" + std::to_string(slot) + "_" + std::to_string(j - 1);
+        }
+        sql += pieces_[j];
+    }
+    return sql;
+}
+
+std::string ExecuteBlockBatch::countedBody(std::size_t slots) const {
+    // The inner block's savepoint undoes a failed row; FBPP_STOP skips the
+    // slots after it unless continueOnError
+    std::string sql = ")\nRETURNS (FBPP_COUNT INTEGER, FBPP_ERROR INTEGER, FBPP_STATE CHAR(5))\n"
+                      "AS\nDECLARE FBPP_STOP SMALLINT = 0;\nBEGIN\n";
+    for (std::size_t slot = 0; slot < slots; ++slot) {
+        sql += "  IF (FBPP_N > " + std::to_string(slot) +
+               " AND FBPP_STOP = 0) THEN BEGIN\n"
+               "    FBPP_ERROR = NULL;\n"
+               "    FBPP_STATE = NULL;\n"
+               "    BEGIN\n      " +
+               slotStatement(slot) +
+               "\n      ;\n"
+               "      FBPP_COUNT = ROW_COUNT;\n"
+               "      WHEN ANY DO BEGIN\n"
+               "        FBPP_COUNT = -1;\n"
+               "        FBPP_ERROR = GDSCODE;\n"
+               "        FBPP_STATE = SQLSTATE;\n" +
+               (continueOnError_ ? "" : "        FBPP_STOP = 1;\n") +
+               "      END\n"
+               "    END\n"
+               "    SUSPEND;\n"
+               "  END\n";
+    }
+    return sql + "END";
+}
+
+BatchResult ExecuteBlockBatch::execute(Transaction& transaction, const std::uint8_t* messages,
+                                       std::size_t count, std::size_t stride,
+                                       std::size_t maxErrors) {
+    if (!rowCounts_) {
+        throw FirebirdException(
+            "ExecuteBlockBatch: execute() needs ExecuteBlockOptions::rowCounts");
+    }
+    BatchResult result;
+    for (std::size_t begin = 0; begin < count; begin += rowsPerBlock_) {
+        const std::size_t rows = std::min(rowsPerBlock_, count - begin);
+        Shape& shape = shapeFor(rows);
+        reset(shape, rows);
+        for (std::size_t i = 0; rowInput_ && i < rows; ++i) {
+            place(shape, messages + (begin + i) * stride, i);
+        }
+
+        auto cursor = transaction.openCursorMessage(shape.statement,
+                                                    shape.input->getRawMetadata(),
+                                                    shape.message.data());
+        bool stopped = false;
+        for (const auto& view : cursor->rows()) {
+            const unsigned index = result.totalMessages++;
+            const auto error = view.get<int32_t>(1);
+            if (!error) {
+                result.perMessageStatus.push_back(view.get<int32_t>(0).value_or(
+                    Firebird::IBatchCompletionState::SUCCESS_NO_INFO));
+                ++result.successCount;
+                continue;
+            }
+            result.perMessageStatus.push_back(Firebird::IBatchCompletionState::EXECUTE_FAILED);
+            ++result.failedCount;
+            if (result.errors.size() < maxErrors) {
+                result.errors.push_back("Message " + std::to_string(index) + ": SQLSTATE " +
+                                        view.get<std::string>(2).value_or("") + ", gdscode " +
+                                        std::to_string(*error));
+                result.errorIndices.push_back(index);
+            }
+            stopped = !continueOnError_;
+        }
+        cursor->close();
+        if (stopped) {
+            break;
+        }
+        if (result.totalMessages != begin + rows) {
+            throw FirebirdException("ExecuteBlockBatch: " + std::to_string(rows) +
+                                    " rows ran " +
+                                    std::to_string(result.totalMessages - begin));
+        }
+    }
+    return result;
+}
+
+ExecuteBlockBatch::Shape& ExecuteBlockBatch::shapeFor(std::size_t rows) {
+    const std::size_t slots = std::bit_ceil(std::max<std::size_t>(rows, 1));
+    auto it = shapes_.find(slots);
+    if (it != shapes_.end()) {
+        return it->second;
+    }
+
+    Shape shape;
+    shape.statement = connection_.prepareStatement(blockSql(slots));
+    shape.input = shape.statement->getInputMetadata();
+    const std::size_t parameters = parameterTypes_.size();
+    if (!shape.input || shape.input->getCount() != 1 + slots * parameters) {
+        throw FirebirdException("ExecuteBlockBatch: block for " + std::to_string(slots) +
+                                " rows has an unexpected parameter count");
+    }
+    for (std::size_t j = 0; j < parameters; ++j) {
+        const FieldInfo& row = rowInput_->getFieldRef(static_cast<unsigned>(j));
+        const FieldInfo& block = shape.input->getFieldRef(static_cast<unsigned>(1 + j));
+        if ((row.type & ~1u) != (block.type & ~1u) || row.length != block.length ||
+            row.scale != block.scale) {
+            throw FirebirdException("ExecuteBlockBatch: parameter " + std::to_string(j + 1) +
+                                    " declared as " + parameterTypes_[j] +
+                                    " has another message format than the statement's");
+        }
+    }
+    shape.message.resize(shape.input->getMessageLength());
+    return shapes_.emplace(slots, std::move(shape)).first->second;
+}
+
+void ExecuteBlockBatch::reset(Shape& shape, std::size_t rows) const {
+    std::fill(shape.message.begin(), shape.message.end(), std::uint8_t{0});
+    const MessageMetadata& input = *shape.input;
+    for (unsigned i = 1; i < input.getCount(); ++i) {
+        const int16_t null = -1;
+        std::memcpy(shape.message.data() + input.getNullOffset(i), &null, sizeof(null));
+    }
+    const FieldInfo& count = input.getFieldRef(0);
+    const auto value = static_cast<int32_t>(rows);
+    std::memcpy(shape.message.data() + count.offset, &value, sizeof(value));
+}
+
+void ExecuteBlockBatch::place(Shape& shape, const std::uint8_t* row, std::size_t slot) const {
+    const std::size_t parameters = parameterTypes_.size();
+    for (std::size_t j = 0; j < parameters; ++j) {
+        const FieldInfo& from = rowInput_->getFieldRef(static_cast<unsigned>(j));
+        const FieldInfo& to =
+            shape.input->getFieldRef(static_cast<unsigned>(1 + slot * parameters + j));
+        std::memcpy(shape.message.data() + to.nullOffset, row + from.nullOffset, sizeof(int16_t));
+        std::size_t bytes = from.length;
+        if ((from.type & ~1u) == SQL_VARYING) {
+            uint16_t length = 0;
+            std::memcpy(&length, row + from.offset, sizeof(length));
+            bytes = sizeof(length) + std::min<std::size_t>(length, from.length);
+        }
+        std::memcpy(shape.message.data() + to.offset, row + from.offset, bytes);
+    }
+}
+
+} // namespace core
+} // namespace fbpp
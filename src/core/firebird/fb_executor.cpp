@@ -0,0 +1,332 @@
+#include "fbpp/core/executor.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp_util/trace.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+namespace fbpp {
+namespace core {
+
+namespace {
+
+// The worker the calling thread is, if any
+thread_local const Executor* tExecutor = nullptr;
+thread_local std::size_t tWorker = 0;
+
+// Tasks one Strand::drain() runs before yielding its worker to other strands
+constexpr std::size_t kStrandBurst = 16;
+
+std::mutex& sharedMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::size_t& sharedThreads() {
+    static std::size_t threads = 0;
+    return threads;
+}
+
+std::atomic<std::shared_ptr<Executor>*>& sharedInstance() {
+    static std::atomic<std::shared_ptr<Executor>*> instance{nullptr};
+    return instance;
+}
+
+std::size_t hardwareThreads() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+} // namespace
+
+// Executor
+
+Executor::Executor(std::size_t threads) {
+    threads = std::max<std::size_t>(threads, 1);
+    queues_.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+        queues_.push_back(std::make_unique<Worker>());
+    }
+    workers_.reserve(threads);
+    try {
+        for (std::size_t i = 0; i < threads; ++i) {
+            workers_.emplace_back([this, i] { workerLoop(i); });
+        }
+    } catch (...) {
+        stop();
+        throw;
+    }
+}
+
+Executor::~Executor() {
+    stop();
+}
+
+void Executor::stop() noexcept {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+}
+
+const std::shared_ptr<Executor>& Executor::shared() {
+    if (auto* instance = sharedInstance().load(std::memory_order_acquire)) {
+        return *instance;
+    }
+    std::lock_guard<std::mutex> lock(sharedMutex());
+    auto* instance = sharedInstance().load(std::memory_order_relaxed);
+    if (!instance) {
+        const std::size_t threads = sharedThreads() != 0 ? sharedThreads() : hardwareThreads();
+        // Never destroyed: tasks may still run while statics are torn down
+        instance = new std::shared_ptr<Executor>(std::make_shared<Executor>(threads));
+        sharedInstance().store(instance, std::memory_order_release);
+    }
+    return *instance;
+}
+
+void Executor::setSharedThreadCount(std::size_t threads) {
+    std::lock_guard<std::mutex> lock(sharedMutex());
+    if (auto* instance = sharedInstance().load(std::memory_order_relaxed)) {
+        const std::size_t wanted = threads != 0 ? threads : hardwareThreads();
+        if ((*instance)->threadCount() != wanted) {
+            throw FirebirdException("Executor::shared() already runs " +
+                                    std::to_string((*instance)->threadCount()) + " threads");
+        }
+        return;
+    }
+    sharedThreads() = threads;
+}
+
+void Executor::post(Task task) {
+    std::size_t index;
+    if (tExecutor == this) {
+        index = tWorker;
+    } else {
+        index = nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    }
+    {
+        // Accepted while stopping: workers drain the deques before exiting,
+        // so tasks posted by running tasks still run.
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    posted_.fetch_add(1, std::memory_order_relaxed);
+    pending_.fetch_add(1);
+    if (sleepers_.load() != 0) {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        wake_.notify_one();
+    }
+}
+
+bool Executor::onWorkerThread() const noexcept {
+    return tExecutor == this;
+}
+
+bool Executor::take(std::size_t index, Task& task) {
+    {
+        Worker& own = *queues_[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.front());
+            own.tasks.pop_front();
+            pending_.fetch_sub(1);
+            return true;
+        }
+    }
+    for (std::size_t step = 1; step < queues_.size(); ++step) {
+        Worker& victim = *queues_[(index + step) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.back());
+            victim.tasks.pop_back();
+            pending_.fetch_sub(1);
+            stolen_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void Executor::run(Task& task) noexcept {
+    try {
+        task();
+    } catch (const std::exception& e) {
+        // Tasks report their own errors; this one escaped.
+        fbpp::util::trace(fbpp::util::TraceLevel::error, "Executor",
+                    [&](auto& oss) { oss << "Task threw: " << e.what(); });
+    } catch (...) {
+        fbpp::util::trace(fbpp::util::TraceLevel::error, "Executor",
+                    [](auto& oss) { oss << "Task threw a non-std exception"; });
+    }
+    task = nullptr;   // Release captures before the next task
+    executed_.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool Executor::runPendingTask() {
+    if (tExecutor != this) {
+        return false;
+    }
+    Task task;
+    if (!take(tWorker, task)) {
+        return false;
+    }
+    helped_.fetch_add(1, std::memory_order_relaxed);
+    run(task);
+    return true;
+}
+
+void Executor::workerLoop(std::size_t index) {
+    tExecutor = this;
+    tWorker = index;
+    Task task;
+    for (;;) {
+        if (take(index, task)) {
+            run(task);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        sleepers_.fetch_add(1);
+        wake_.wait(lock, [this] { return stopping_ || pending_.load() > 0; });
+        sleepers_.fetch_sub(1);
+        if (stopping_ && pending_.load() <= 0) {
+            return;   // Stopping and drained
+        }
+    }
+}
+
+std::function<void(Executor::Task)> Executor::poster() {
+    return [this](Task task) { post(std::move(task)); };
+}
+
+ExecutorStats Executor::stats() const noexcept {
+    ExecutorStats stats;
+    stats.posted = posted_.load(std::memory_order_relaxed);
+    stats.executed = executed_.load(std::memory_order_relaxed);
+    stats.stolen = stolen_.load(std::memory_order_relaxed);
+    stats.helped = helped_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// TaskGroup
+
+TaskGroup::~TaskGroup() {
+    try {
+        wait();
+    } catch (...) {
+        // Reported by an explicit wait() only
+    }
+}
+
+void TaskGroup::run(Executor::Task task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++pending_;
+    }
+    try {
+        executor_.post([this, task = std::move(task)] {
+            std::exception_ptr error;
+            try {
+                task();
+            } catch (...) {
+                error = std::current_exception();
+            }
+            // Notify under the lock: the waiter may destroy the group as
+            // soon as it can take the mutex.
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (error && !error_) {
+                error_ = error;
+            }
+            if (--pending_ == 0) {
+                done_.notify_all();
+            }
+        });
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --pending_;
+        throw;
+    }
+}
+
+void TaskGroup::wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    executor_.waitHelping(lock, done_, [this] { return pending_ == 0; });
+    if (error_) {
+        std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+}
+
+// Strand
+
+Strand::Strand(std::shared_ptr<Executor> executor)
+    : executor_(std::move(executor)) {
+    if (!executor_) {
+        throw FirebirdException("Strand: Executor required");
+    }
+}
+
+Strand::~Strand() {
+    waitIdle();
+}
+
+void Strand::waitIdle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this] { return !running_; });
+}
+
+void Strand::post(Executor::Task task) {
+    bool schedule = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+        if (!running_) {
+            running_ = true;
+            schedule = true;
+        }
+    }
+    if (schedule) {
+        try {
+            executor_->post([this] { drain(); });
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.pop_back();
+            running_ = false;
+            idle_.notify_all();
+            throw;
+        }
+    }
+}
+
+void Strand::drain() {
+    for (std::size_t done = 0; done < kStrandBurst; ++done) {
+        Executor::Task task;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (tasks_.empty()) {
+                // Notify under the lock: a waiter may destroy the strand
+                // as soon as it can take the mutex.
+                running_ = false;
+                idle_.notify_all();
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        try {
+            task();
+        } catch (...) {
+            // Awaiters capture their own errors; never wedge the strand.
+            fbpp::util::trace(fbpp::util::TraceLevel::error, "Strand",
+                        [](auto& oss) { oss << "Strand task threw"; });
+        }
+    }
+    // More queued: let other strands run before continuing.
+    executor_->post([this] { drain(); });
+}
+
+} // namespace core
+} // namespace fbpp
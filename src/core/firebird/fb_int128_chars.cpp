@@ -0,0 +1,403 @@
+#include "fbpp/core/int128_chars.hpp"
+#include "fbpp/core/exception.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+namespace fbpp::core {
+
+namespace {
+
+constexpr uint64_t kPow10[20] = {1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull,
+                                 1000000ull, 10000000ull, 100000000ull, 1000000000ull,
+                                 10000000000ull, 100000000000ull, 1000000000000ull,
+                                 10000000000000ull, 100000000000000ull, 1000000000000000ull,
+                                 10000000000000000ull, 100000000000000000ull,
+                                 1000000000000000000ull, 10000000000000000000ull};
+
+#if defined(FBPP_NATIVE_INT128)
+
+// Unsigned 128-bit magnitude in a native unsigned __int128. Digits are
+// produced and consumed 19 at a time; below 2^64 the divisions are 64-bit.
+struct Magnitude {
+    static constexpr int kChunkDigits = 19;
+
+    NativeUInt128 v = 0;
+
+    static Magnitude fromParts(uint64_t lo, uint64_t hi) noexcept {
+        Magnitude m;
+        m.v = (static_cast<NativeUInt128>(hi) << 64) | lo;
+        return m;
+    }
+
+    void toParts(uint64_t& lo, uint64_t& hi) const noexcept {
+        lo = static_cast<uint64_t>(v);
+        hi = static_cast<uint64_t>(v >> 64);
+    }
+
+    bool isZero() const noexcept { return v == 0; }
+
+    // this /= divisor; returns the remainder
+    uint64_t divmod(uint64_t divisor) noexcept {
+        if ((v >> 64) == 0) {
+            const uint64_t lo = static_cast<uint64_t>(v);
+            v = lo / divisor;
+            return lo % divisor;
+        }
+        const auto rem = static_cast<uint64_t>(v % divisor);
+        v /= divisor;
+        return rem;
+    }
+
+    // this = this * mul + add; false on overflow past 128 bits
+    bool mulAdd(uint64_t mul, uint64_t add) noexcept {
+        NativeUInt128 product;
+        if (__builtin_mul_overflow(v, static_cast<NativeUInt128>(mul), &product)) {
+            return false;
+        }
+        return !__builtin_add_overflow(product, static_cast<NativeUInt128>(add), &v);
+    }
+};
+
+#else
+
+// Unsigned 128-bit magnitude as four 32-bit limbs, least significant
+// first. Division by up to 10^9 and multiply-add then stay within
+// uint64_t, so the code is the same on every compiler.
+struct Magnitude {
+    static constexpr int kChunkDigits = 9;
+
+    uint32_t limb[4] = {0, 0, 0, 0};
+
+    static Magnitude fromParts(uint64_t lo, uint64_t hi) noexcept {
+        Magnitude m;
+        m.limb[0] = static_cast<uint32_t>(lo);
+        m.limb[1] = static_cast<uint32_t>(lo >> 32);
+        m.limb[2] = static_cast<uint32_t>(hi);
+        m.limb[3] = static_cast<uint32_t>(hi >> 32);
+        return m;
+    }
+
+    void toParts(uint64_t& lo, uint64_t& hi) const noexcept {
+        lo = (static_cast<uint64_t>(limb[1]) << 32) | limb[0];
+        hi = (static_cast<uint64_t>(limb[3]) << 32) | limb[2];
+    }
+
+    bool isZero() const noexcept {
+        return (limb[0] | limb[1] | limb[2] | limb[3]) == 0;
+    }
+
+    // this /= divisor (at most 10^9); returns the remainder
+    uint64_t divmod(uint64_t divisor) noexcept {
+        uint64_t rem = 0;
+        for (int i = 3; i >= 0; --i) {
+            const uint64_t cur = (rem << 32) | limb[i];
+            limb[i] = static_cast<uint32_t>(cur / divisor);
+            rem = cur % divisor;
+        }
+        return rem;
+    }
+
+    // this = this * mul + add (both below 2^32); false on overflow past 128 bits
+    bool mulAdd(uint64_t mul, uint64_t add) noexcept {
+        uint64_t carry = add;
+        for (uint32_t& l : limb) {
+            const uint64_t cur = static_cast<uint64_t>(l) * mul + carry;
+            l = static_cast<uint32_t>(cur);
+            carry = cur >> 32;
+        }
+        return carry == 0;
+    }
+};
+
+#endif
+
+constexpr int kChunkDigits = Magnitude::kChunkDigits;
+
+Magnitude magnitudeOf(const Int128& value, bool& negative) noexcept {
+    uint64_t lo = value.low();
+    uint64_t hi = static_cast<uint64_t>(value.high());
+    negative = (hi >> 63) != 0;
+    if (negative) {
+        // Two's complement negate; INT128 min maps to 2^127, still unsigned-representable.
+        lo = ~lo + 1;
+        hi = ~hi + (lo == 0 ? 1 : 0);
+    }
+    return Magnitude::fromParts(lo, hi);
+}
+
+// Store sign * m into value; false if it does not fit INT128
+bool storeMagnitude(const Magnitude& m, bool negative, Int128& value) noexcept {
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+    m.toParts(lo, hi);
+    const uint64_t top = uint64_t{1} << 63;
+    if (hi > top || (hi == top && !(negative && lo == 0))) {   // Only -2^127 has bit 127 set
+        return false;
+    }
+    if (negative) {
+        lo = ~lo + 1;
+        hi = ~hi + (lo == 0 ? 1 : 0);
+    }
+    value = Int128::fromParts(static_cast<int64_t>(hi), lo);
+    return true;
+}
+
+// Decimal digits of m, most significant first, into the end of buf[40];
+// returns the first digit position. "0" for zero.
+char* writeDigits(Magnitude m, char* end) noexcept {
+    char* p = end;
+    if (m.isZero()) {
+        *--p = '0';
+        return p;
+    }
+    while (true) {
+        uint64_t chunk = m.divmod(kPow10[kChunkDigits]);
+        if (m.isZero()) {
+            while (chunk != 0) {
+                *--p = static_cast<char>('0' + chunk % 10);
+                chunk /= 10;
+            }
+            return p;
+        }
+        for (int i = 0; i < kChunkDigits; ++i) {
+            *--p = static_cast<char>('0' + chunk % 10);
+            chunk /= 10;
+        }
+    }
+}
+
+// m *= 10^n; false on overflow
+bool mulPow10(Magnitude& m, int n) noexcept {
+    for (; n > 0 && !m.isZero(); n -= kChunkDigits) {
+        if (!m.mulAdd(kPow10[n >= kChunkDigits ? kChunkDigits : n], 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline bool isDigit(char c) noexcept {
+    return c >= '0' && c <= '9';
+}
+
+} // namespace
+
+std::to_chars_result toChars(char* first, char* last, const Int128& value, int scale) noexcept {
+    bool negative = false;
+    char digitBuf[40];
+    char* const digitsEnd = digitBuf + sizeof(digitBuf);
+    const char* digits = writeDigits(magnitudeOf(value, negative), digitsEnd);
+    const std::size_t digitCount = static_cast<std::size_t>(digitsEnd - digits);
+
+    // Same layout rules as Firebird's Int128::toString.
+    char* out = first;
+    auto room = [&](std::size_t n) { return static_cast<std::size_t>(last - out) >= n; };
+    auto overflow = [&] { return std::to_chars_result{last, std::errc::value_too_large}; };
+
+    if (negative) {
+        if (!room(1)) return overflow();
+        *out++ = '-';
+    }
+    if (scale < -38 || scale > 4) {
+        if (!room(digitCount)) return overflow();
+        std::memcpy(out, digits, digitCount);
+        out += digitCount;
+        if (!room(1)) return overflow();
+        *out++ = 'E';
+        return std::to_chars(out, last, scale);
+    }
+    if (scale >= 0) {
+        const auto zeros = static_cast<std::size_t>(scale);
+        if (!room(digitCount + zeros)) return overflow();
+        std::memcpy(out, digits, digitCount);
+        out += digitCount;
+        std::memset(out, '0', zeros);
+        return {out + zeros, std::errc{}};
+    }
+
+    const auto fraction = static_cast<std::size_t>(-scale);
+    if (fraction >= digitCount) {
+        // 0.000ddd
+        const std::size_t pad = fraction - digitCount;
+        if (!room(2 + pad + digitCount)) return overflow();
+        *out++ = '0';
+        *out++ = '.';
+        std::memset(out, '0', pad);
+        out += pad;
+        std::memcpy(out, digits, digitCount);
+        return {out + digitCount, std::errc{}};
+    }
+    const std::size_t whole = digitCount - fraction;
+    if (!room(digitCount + 1)) return overflow();
+    std::memcpy(out, digits, whole);
+    out += whole;
+    *out++ = '.';
+    std::memcpy(out, digits + whole, fraction);
+    return {out + fraction, std::errc{}};
+}
+
+std::from_chars_result fromChars(const char* first, const char* last, Int128& value,
+                                 int scale) noexcept {
+    const char* p = first;
+    bool negative = false;
+    if (p != last && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        ++p;
+    }
+
+    // First pass: locate the mantissa digits and the exponent.
+    const char* intBegin = p;
+    while (p != last && isDigit(*p)) ++p;
+    const char* intEnd = p;
+    const char* fracBegin = p;
+    const char* fracEnd = p;
+    if (p != last && *p == '.') {
+        fracBegin = ++p;
+        while (p != last && isDigit(*p)) ++p;
+        fracEnd = p;
+    }
+    if (intBegin == intEnd && fracBegin == fracEnd) {
+        return {first, std::errc::invalid_argument};
+    }
+
+    long exponent = 0;
+    if (p != last && (*p == 'e' || *p == 'E')) {
+        const char* e = p + 1;
+        bool expNegative = false;
+        if (e != last && (*e == '-' || *e == '+')) {
+            expNegative = (*e == '-');
+            ++e;
+        }
+        if (e != last && isDigit(*e)) {
+            while (e != last && isDigit(*e)) {
+                if (exponent < 100000) {
+                    exponent = exponent * 10 + (*e - '0');
+                }
+                ++e;
+            }
+            exponent = expNegative ? -exponent : exponent;
+            p = e;
+        }
+        // "1e" / "1e+" : the exponent part is not consumed
+    }
+    const char* const end = p;
+
+    // value * 10^-scale = mantissa * 10^(exponent - fracDigits - scale)
+    const long fracDigits = static_cast<long>(fracEnd - fracBegin);
+    const long shift = exponent - fracDigits - static_cast<long>(scale);
+    const long totalDigits = static_cast<long>(intEnd - intBegin) + fracDigits;
+    long keep = totalDigits + (shift < 0 ? shift : 0);   // Digits that survive rounding
+
+    Magnitude m;
+    bool ok = true;
+    long index = 0;
+    int roundDigit = 0;
+    uint64_t chunk = 0;
+    int chunkLen = 0;
+    auto consume = [&](char c) {
+        const int digit = c - '0';
+        if (index < keep) {
+            chunk = chunk * 10 + static_cast<uint64_t>(digit);
+            if (++chunkLen == kChunkDigits) {
+                ok = ok && m.mulAdd(kPow10[kChunkDigits], chunk);
+                chunk = 0;
+                chunkLen = 0;
+            }
+        } else if (index == keep) {
+            roundDigit = digit;
+        }
+        ++index;
+    };
+    for (const char* d = intBegin; d != intEnd; ++d) consume(*d);
+    for (const char* d = fracBegin; d != fracEnd; ++d) consume(*d);
+    if (chunkLen != 0) {
+        ok = ok && m.mulAdd(kPow10[chunkLen], chunk);
+    }
+    if (keep >= 0 && roundDigit >= 5) {
+        ok = ok && m.mulAdd(1, 1);
+    }
+    if (ok && shift > 0) {
+        ok = mulPow10(m, static_cast<int>(shift));   // Stops at the first overflow
+    }
+
+    if (!ok || !storeMagnitude(m, negative, value)) {
+        return {end, std::errc::result_out_of_range};
+    }
+    return {end, std::errc{}};
+}
+
+void rescaleInt128(const Int128* raw, std::size_t count, int fromScale, int toScale,
+                   Int128* out) {
+    const int shift = fromScale - toScale;
+    bool overflow = false;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (shift == 0) {
+            out[i] = raw[i];
+            continue;
+        }
+#if defined(FBPP_NATIVE_INT128)
+        if (shift > 0 && shift <= 38) {
+            // 10^38 < 2^127: one checked native multiply
+            const NativeInt128 factor = shift <= 19
+                ? static_cast<NativeInt128>(kPow10[shift])
+                : static_cast<NativeInt128>(kPow10[19]) * static_cast<NativeInt128>(kPow10[shift - 19]);
+            NativeInt128 scaled = 0;
+            overflow |= __builtin_mul_overflow(raw[i].toNative(), factor, &scaled);
+            out[i] = Int128(scaled);
+            continue;
+        }
+#endif
+        bool negative = false;
+        Magnitude m = magnitudeOf(raw[i], negative);
+        if (shift > 0) {
+            overflow |= !mulPow10(m, shift);
+        } else {
+            // Chained truncating divisions equal one; the first dropped
+            // digit decides rounding half away from zero
+            int n = -shift - 1;
+            for (; n > 0 && !m.isZero(); n -= kChunkDigits) {
+                m.divmod(kPow10[n >= kChunkDigits ? kChunkDigits : n]);
+            }
+            if (m.divmod(10) >= 5) {
+                m.mulAdd(1, 1);
+            }
+        }
+        overflow |= !storeMagnitude(m, negative, out[i]);
+    }
+    if (overflow) {
+        throw FirebirdException("Scaled value out of range for INT128");
+    }
+}
+
+std::string int128ToString(const Int128& value, int scale) {
+    char buffer[kInt128MaxChars];
+    auto result = toChars(buffer, buffer + sizeof(buffer), value, scale);
+    if (result.ec == std::errc{}) {
+        return std::string(buffer, result.ptr);
+    }
+    // Only scales far outside NUMERIC range get here.
+    std::string wide(64 + static_cast<std::size_t>(scale > 0 ? scale : -scale), '\0');
+    result = toChars(wide.data(), wide.data() + wide.size(), value, scale);
+    wide.resize(static_cast<std::size_t>(result.ptr - wide.data()));
+    return wide;
+}
+
+Int128 int128FromString(std::string_view text, int scale) {
+    const char* first = text.data();
+    const char* last = text.data() + text.size();
+    while (first != last && *first == ' ') ++first;
+    while (last != first && *(last - 1) == ' ') --last;
+
+    Int128 value;
+    const auto result = fromChars(first, last, value, scale);
+    if (result.ec == std::errc::result_out_of_range) {
+        throw FirebirdException("Value out of range for INT128: '" + std::string(text) + "'");
+    }
+    if (result.ec != std::errc{} || result.ptr != last) {
+        throw FirebirdException("Invalid numeric value for INT128: '" + std::string(text) + "'");
+    }
+    return value;
+}
+
+} // namespace fbpp::core
@@ -0,0 +1,198 @@
+#include "fbpp/core/json_nest_writer.hpp"
+#include "fbpp/core/exception.hpp"
+
+#include <cstring>
+
+namespace fbpp::core {
+
+namespace {
+
+bool isNull(const ColumnPlan& column, const uint8_t* buffer) noexcept {
+    int16_t indicator = 0;
+    std::memcpy(&indicator, buffer + column.nullOffset, sizeof(indicator));
+    return indicator == -1;
+}
+
+// Bytes of a non-NULL value: the used part of a VARCHAR, the field otherwise
+std::size_t valueBytes(const ColumnPlan& column, const uint8_t* buffer) noexcept {
+    if (column.field->type != SQL_VARYING) {
+        return column.length;
+    }
+    uint16_t length = 0;
+    std::memcpy(&length, buffer + column.offset, sizeof(length));
+    return sizeof(length) + length;
+}
+
+} // namespace
+
+JsonNestWriter::JsonNestWriter(JsonStreamWriter& writer, std::vector<JsonNestLevel> levels)
+    : writer_(writer) {
+    if (levels.empty()) {
+        throw FirebirdException("JsonNestWriter: no levels");
+    }
+    levels_.reserve(levels.size());
+    for (std::size_t i = 0; i < levels.size(); ++i) {
+        auto& spec = levels[i];
+        const bool innermost = i + 1 == levels.size();
+        if (spec.columns.empty()) {
+            throw FirebirdException("JsonNestWriter: level " + std::to_string(i) +
+                                    " has no columns");
+        }
+        if (spec.keyColumns > spec.columns.size()) {
+            throw FirebirdException("JsonNestWriter: level " + std::to_string(i) +
+                                    " has more key columns than columns");
+        }
+        if (!innermost && (spec.keyColumns == 0 || spec.children.empty())) {
+            throw FirebirdException("JsonNestWriter: level " + std::to_string(i) +
+                                    " needs key columns and a children member");
+        }
+        Level level;
+        level.spec = std::move(spec);
+        levels_.push_back(std::move(level));
+    }
+}
+
+void JsonNestWriter::resolve(const MessageMetadata& metadata) {
+    const auto& plan = metadata.getColumnPlan();
+    for (auto& level : levels_) {
+        level.columns.clear();
+        for (const auto& name : level.spec.columns) {
+            const ColumnPlan* found = nullptr;
+            for (const auto& column : plan) {
+                if (displayName(*column.field) == name) {
+                    found = &column;
+                    break;
+                }
+            }
+            if (!found) {
+                throw FirebirdException("JsonNestWriter: no column " + name);
+            }
+            level.columns.push_back(found);
+        }
+    }
+    metadata_ = &metadata;
+}
+
+std::size_t JsonNestWriter::identityColumns(const Level& level) const noexcept {
+    return level.spec.keyColumns == 0 ? level.columns.size() : level.spec.keyColumns;
+}
+
+bool JsonNestWriter::sameKey(const Level& level, const uint8_t* buffer) const noexcept {
+    // Stored as, per key column, a NULL flag byte and then the value bytes
+    const uint8_t* stored = level.key.data();
+    const uint8_t* end = stored + level.key.size();
+    for (std::size_t i = 0; i < level.spec.keyColumns; ++i) {
+        const ColumnPlan& column = *level.columns[i];
+        if (stored == end) {
+            return false;
+        }
+        const bool null = isNull(column, buffer);
+        if (*stored++ != static_cast<uint8_t>(null)) {
+            return false;
+        }
+        if (null) {
+            continue;
+        }
+        const std::size_t bytes = valueBytes(column, buffer);
+        if (static_cast<std::size_t>(end - stored) < bytes ||
+            std::memcmp(stored, buffer + column.offset, bytes) != 0) {
+            return false;
+        }
+        stored += bytes;
+    }
+    return true;
+}
+
+bool JsonNestWriter::nullKey(const Level& level, const uint8_t* buffer) const noexcept {
+    const std::size_t count = identityColumns(level);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (!isNull(*level.columns[i], buffer)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void JsonNestWriter::storeKey(Level& level, const uint8_t* buffer) {
+    level.key.clear();
+    for (std::size_t i = 0; i < level.spec.keyColumns; ++i) {
+        const ColumnPlan& column = *level.columns[i];
+        const bool null = isNull(column, buffer);
+        level.key.push_back(static_cast<uint8_t>(null));
+        if (!null) {
+            const uint8_t* value = buffer + column.offset;
+            level.key.insert(level.key.end(), value, value + valueBytes(column, buffer));
+        }
+    }
+}
+
+void JsonNestWriter::writeRow(const uint8_t* buffer, const MessageMetadata& metadata,
+                              Transaction* transaction) {
+    if (!buffer) {
+        throw FirebirdException("Invalid parameters for JSON unpack");
+    }
+    if (metadata_ != &metadata) {
+        resolve(metadata);
+    }
+
+    // The first level whose open object this row does not continue
+    std::size_t depth = 0;
+    while (depth < levels_.size() && levels_[depth].open && levels_[depth].spec.keyColumns != 0 &&
+           sameKey(levels_[depth], buffer)) {
+        ++depth;
+    }
+    close(depth);
+    open(depth, buffer, transaction);
+    ++rows_;
+}
+
+void JsonNestWriter::open(std::size_t depth, const uint8_t* buffer, Transaction* transaction) {
+    for (std::size_t i = depth; i < levels_.size(); ++i) {
+        Level& level = levels_[i];
+        if (i != 0 && nullKey(level, buffer)) {
+            return;   // No child here (LEFT JOIN), nor below it
+        }
+        if (i == 0) {
+            writer_.beginRow();
+            writer_.writeRaw("{");
+        } else {
+            writer_.writeRaw(level.written == 0 ? "{" : ",{");
+        }
+        ++level.written;
+        for (std::size_t c = 0; c < level.columns.size(); ++c) {
+            if (c != 0) {
+                writer_.writeRaw(",");
+            }
+            writer_.writeKey(level.spec.columns[c]);
+            writer_.writeColumn(*level.columns[c], buffer, transaction);
+        }
+        if (i + 1 < levels_.size()) {
+            writer_.writeRaw(",");
+            writer_.writeKey(level.spec.children);
+            writer_.writeRaw("[");
+            levels_[i + 1].written = 0;
+        }
+        storeKey(level, buffer);
+        level.open = true;
+    }
+}
+
+void JsonNestWriter::close(std::size_t depth) {
+    for (std::size_t i = levels_.size(); i-- > depth;) {
+        Level& level = levels_[i];
+        if (!level.open) {
+            continue;
+        }
+        writer_.writeRaw(i + 1 < levels_.size() ? "]}" : "}");
+        level.open = false;
+        if (i == 0) {
+            writer_.endRow();
+        }
+    }
+}
+
+void JsonNestWriter::finish() {
+    close(0);
+}
+
+} // namespace fbpp::core
@@ -0,0 +1,268 @@
+#include "fbpp/core/json_stream_writer.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/int128_chars.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/detail/sql_value_codec.hpp"
+#include "fbpp/core/detail/text_scan.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <ostream>
+
+namespace fbpp::core {
+
+namespace {
+
+constexpr char kHex[] = "0123456789abcdef";
+
+inline bool needsEscape(unsigned char c) noexcept {
+    return c < 0x20 || c == '"' || c == '\\';
+}
+
+template<typename Int>
+void appendInteger(std::string& out, Int value) {
+    char buffer[24];
+    out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value).ptr);
+}
+
+// Shortest round-trip text; integral values keep a ".0" and non-finite
+// values become null, as nlohmann::json::dump() writes floats.
+void appendFloating(std::string& out, double value) {
+    if (!std::isfinite(value)) {
+        out += "null";
+        return;
+    }
+    char buffer[32];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+    if (std::memchr(buffer, '.', static_cast<std::size_t>(result.ptr - buffer)) == nullptr &&
+        std::memchr(buffer, 'e', static_cast<std::size_t>(result.ptr - buffer)) == nullptr) {
+        out += ".0";
+    }
+}
+
+// Scaled integer as a quoted decimal string; same text as the codec
+void appendScaled(std::string& out, int64_t value, int scale) {
+    char buffer[kInt128MaxChars];
+    const auto result = toChars(buffer, buffer + sizeof(buffer), Int128(value), scale);
+    out += '"';
+    out.append(buffer, result.ptr);
+    out += '"';
+}
+
+template<typename Int>
+void appendIntegerColumn(std::string& out, const detail::sql_value_codec::SqlReadContext& ctx,
+                         const uint8_t* data) {
+    if (ctx.field->scale < 0) {
+        Int raw;
+        std::memcpy(&raw, data, sizeof(raw));
+        appendScaled(out, raw, ctx.field->scale);
+        return;
+    }
+    Int value;
+    detail::sql_value_codec::read_sql_value(ctx, data, value);
+    appendInteger(out, value);
+}
+
+} // namespace
+
+JsonStreamWriter::JsonStreamWriter(Sink sink, JsonRowShape shape, std::size_t chunkBytes)
+    : sink_(std::move(sink)), shape_(shape), chunkBytes_(chunkBytes == 0 ? 1 : chunkBytes) {
+    if (!sink_) {
+        throw FirebirdException("JsonStreamWriter: empty sink");
+    }
+    out_.reserve(chunkBytes_ + 256);
+}
+
+JsonStreamWriter::JsonStreamWriter(std::ostream& out, JsonRowShape shape, std::size_t chunkBytes)
+    : JsonStreamWriter([&out](std::string_view chunk) {
+          out.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+      }, shape, chunkBytes) {}
+
+void JsonStreamWriter::writeRow(const uint8_t* buffer, const MessageMetadata& metadata,
+                                Transaction* transaction) {
+    if (finished_) {
+        throw FirebirdException("JsonStreamWriter: row written after finish()");
+    }
+    if (!buffer) {
+        throw FirebirdException("Invalid parameters for JSON unpack");
+    }
+
+    out_ += rows_ == 0 ? '[' : ',';
+    const auto& plan = metadata.getColumnPlan();
+    const bool object = shape_ == JsonRowShape::Object;
+    out_ += object ? '{' : '[';
+    for (std::size_t i = 0; i < plan.size(); ++i) {
+        if (i != 0) {
+            out_ += ',';
+        }
+        if (object) {
+            const std::string& name = displayName(*plan[i].field);
+            if (name.empty()) {
+                out_ += "\"FIELD_";
+                appendInteger(out_, i);
+                out_ += '"';
+            } else {
+                writeString(name);
+            }
+            out_ += ':';
+        }
+        writeValue(plan[i], buffer, transaction);
+    }
+    out_ += object ? '}' : ']';
+    ++rows_;
+
+    if (out_.size() >= chunkBytes_) {
+        flush();
+    }
+}
+
+void JsonStreamWriter::finish() {
+    if (finished_) {
+        return;
+    }
+    out_ += rows_ == 0 ? "[]" : "]";
+    finished_ = true;
+    flush();
+}
+
+void JsonStreamWriter::beginRow() {
+    if (finished_) {
+        throw FirebirdException("JsonStreamWriter: row written after finish()");
+    }
+    out_ += rows_ == 0 ? '[' : ',';
+    ++rows_;
+}
+
+void JsonStreamWriter::endRow() {
+    if (out_.size() >= chunkBytes_) {
+        flush();
+    }
+}
+
+void JsonStreamWriter::writeKey(std::string_view name) {
+    writeString(name);
+    out_ += ':';
+}
+
+void JsonStreamWriter::writeColumn(const ColumnPlan& column, const uint8_t* buffer,
+                                   Transaction* transaction) {
+    writeValue(column, buffer, transaction);
+}
+
+void JsonStreamWriter::writeValue(const ColumnPlan& column, const uint8_t* buffer,
+                                  Transaction* transaction) {
+    const uint8_t* data = buffer + column.offset;
+    const auto* nullPtr = reinterpret_cast<const int16_t*>(buffer + column.nullOffset);
+    if (*nullPtr == -1) {
+        out_ += "null";
+        return;
+    }
+
+    const FieldInfo* field = column.field;
+    detail::sql_value_codec::SqlReadContext ctx{field, transaction, nullPtr};
+    switch (field->type) {
+        case SQL_TEXT: {
+            const auto* text = reinterpret_cast<const char*>(data);
+            writeString(std::string_view(text, detail::trimmedLength(text, field->length)));
+            return;
+        }
+        case SQL_VARYING: {
+            uint16_t length = 0;
+            std::memcpy(&length, data, sizeof(length));
+            writeString(std::string_view(reinterpret_cast<const char*>(data) + sizeof(length), length));
+            return;
+        }
+        case SQL_BOOLEAN: {
+            bool value = false;
+            detail::sql_value_codec::read_sql_value(ctx, data, value);
+            out_ += value ? "true" : "false";
+            return;
+        }
+        case SQL_SHORT:
+            appendIntegerColumn<int16_t>(out_, ctx, data);
+            return;
+        case SQL_LONG:
+            appendIntegerColumn<int32_t>(out_, ctx, data);
+            return;
+        case SQL_INT64:
+            appendIntegerColumn<int64_t>(out_, ctx, data);
+            return;
+        case SQL_INT128: {
+            char text[kInt128MaxChars];
+            const auto result = toChars(text, text + sizeof(text), Int128(data), field->scale);
+            out_ += '"';
+            out_.append(text, result.ptr);
+            out_ += '"';
+            return;
+        }
+        case SQL_FLOAT: {
+            float value = 0.0f;
+            detail::sql_value_codec::read_sql_value(ctx, data, value);
+            appendFloating(out_, value);
+            return;
+        }
+        case SQL_DOUBLE:
+        case SQL_D_FLOAT: {
+            double value = 0.0;
+            detail::sql_value_codec::read_sql_value(ctx, data, value);
+            appendFloating(out_, value);
+            return;
+        }
+        case SQL_BLOB:
+        case SQL_DEC16:
+        case SQL_DEC34:
+        case SQL_TIMESTAMP:
+        case SQL_TIMESTAMP_TZ:
+        case SQL_TYPE_TIME:
+        case SQL_TIME_TZ:
+        case SQL_TYPE_DATE:
+            // Codec text, as JsonUnpacker produces; scratch_ keeps its capacity
+            detail::sql_value_codec::read_sql_value(ctx, data, scratch_);
+            writeString(scratch_);
+            return;
+        default:
+            throw FirebirdException("Unsupported SQL type for JSON unpacking: " +
+                                    std::to_string(field->type));
+    }
+}
+
+void JsonStreamWriter::writeString(std::string_view text) {
+    out_ += '"';
+    std::size_t run = 0;   // Start of the pending unescaped run
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        const auto c = static_cast<unsigned char>(text[i]);
+        if (!needsEscape(c)) {
+            continue;
+        }
+        out_.append(text.data() + run, i - run);
+        run = i + 1;
+        switch (c) {
+            case '"':  out_ += "\\\""; break;
+            case '\\': out_ += "\\\\"; break;
+            case '\b': out_ += "\\b"; break;
+            case '\f': out_ += "\\f"; break;
+            case '\n': out_ += "\\n"; break;
+            case '\r': out_ += "\\r"; break;
+            case '\t': out_ += "\\t"; break;
+            default: {
+                const char escape[6] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0x0F]};
+                out_.append(escape, sizeof(escape));
+                break;
+            }
+        }
+    }
+    out_.append(text.data() + run, text.size() - run);
+    out_ += '"';
+}
+
+void JsonStreamWriter::flush() {
+    if (out_.empty()) {
+        return;
+    }
+    sink_(out_);
+    out_.clear();
+}
+
+} // namespace fbpp::core
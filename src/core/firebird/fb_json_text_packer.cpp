@@ -0,0 +1,392 @@
+#include "fbpp/core/json_text_packer.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/detail/sql_value_codec.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <typeindex>
+
+namespace fbpp::core {
+
+namespace {
+
+// Plan-cache tag for of(metadata, names); of(metadata) uses JsonTextPacker.
+struct NamedJsonTextPacker {};
+
+/**
+ * @brief Pull scanner over one JSON document
+ *
+ * Only what packing needs: one level of object or array whose members
+ * are scalars. Strings without escapes are returned as views into the
+ * input; escaped ones are decoded into `scratch`.
+ */
+class JsonScanner {
+public:
+    enum class Kind { Null, False, True, Number, String, Nested };
+
+    explicit JsonScanner(std::string_view text) noexcept
+        : begin_(text.data()), p_(text.data()), end_(text.data() + text.size()) {}
+
+    void skipSpace() noexcept {
+        while (p_ != end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) ++p_;
+    }
+
+    bool atEnd() noexcept {
+        skipSpace();
+        return p_ == end_;
+    }
+
+    char peek() noexcept {
+        skipSpace();
+        return p_ == end_ ? '\0' : *p_;
+    }
+
+    void expect(char c) {
+        if (peek() != c) {
+            fail(std::string("expected '") + c + "'");
+        }
+        ++p_;
+    }
+
+    bool consume(char c) noexcept {
+        if (peek() != c) return false;
+        ++p_;
+        return true;
+    }
+
+    // Scalar value; `text` is the number text or the (decoded) string
+    Kind value(std::string_view& text, std::string& scratch) {
+        switch (peek()) {
+            case '"':
+                text = string(scratch);
+                return Kind::String;
+            case 'n': word("null"); return Kind::Null;
+            case 't': word("true"); return Kind::True;
+            case 'f': word("false"); return Kind::False;
+            case '{':
+            case '[':
+                skipNested();
+                return Kind::Nested;
+            default:
+                text = number();
+                return Kind::Number;
+        }
+    }
+
+    std::string_view string(std::string& scratch) {
+        expect('"');
+        const char* start = p_;
+        while (p_ != end_ && *p_ != '"' && *p_ != '\\') {
+            if (static_cast<unsigned char>(*p_) < 0x20) fail("control character in string");
+            ++p_;
+        }
+        if (p_ != end_ && *p_ == '"') {
+            return std::string_view(start, static_cast<size_t>(p_++ - start));
+        }
+        scratch.assign(start, p_);
+        while (p_ != end_ && *p_ != '"') {
+            const char c = *p_++;
+            if (static_cast<unsigned char>(c) < 0x20) fail("control character in string");
+            if (c != '\\') {
+                scratch += c;
+                continue;
+            }
+            if (p_ == end_) break;
+            switch (*p_++) {
+                case '"': scratch += '"'; break;
+                case '\\': scratch += '\\'; break;
+                case '/': scratch += '/'; break;
+                case 'b': scratch += '\b'; break;
+                case 'f': scratch += '\f'; break;
+                case 'n': scratch += '\n'; break;
+                case 'r': scratch += '\r'; break;
+                case 't': scratch += '\t'; break;
+                case 'u': appendUtf8(scratch, codePoint()); break;
+                default: fail("invalid escape");
+            }
+        }
+        if (p_ == end_) fail("unterminated string");
+        ++p_;
+        return scratch;
+    }
+
+    [[noreturn]] void fail(const std::string& what) const {
+        throw FirebirdException("Invalid JSON at offset " + std::to_string(p_ - begin_) + ": " + what);
+    }
+
+private:
+    void word(const char* literal) {
+        const size_t n = std::strlen(literal);
+        if (static_cast<size_t>(end_ - p_) < n || std::memcmp(p_, literal, n) != 0) {
+            fail("unexpected token");
+        }
+        p_ += n;
+    }
+
+    std::string_view number() {
+        const char* start = p_;
+        if (p_ != end_ && *p_ == '-') ++p_;
+        const char* digits = p_;
+        while (p_ != end_ && (std::isdigit(static_cast<unsigned char>(*p_)) || *p_ == '.' ||
+                              *p_ == 'e' || *p_ == 'E' || *p_ == '+' || *p_ == '-')) {
+            ++p_;
+        }
+        if (p_ == digits || !std::isdigit(static_cast<unsigned char>(*digits))) {
+            fail("unexpected token");
+        }
+        return std::string_view(start, static_cast<size_t>(p_ - start));
+    }
+
+    unsigned hex4() {
+        if (end_ - p_ < 4) fail("truncated \\u escape");
+        unsigned value = 0;
+        const auto result = std::from_chars(p_, p_ + 4, value, 16);
+        if (result.ptr != p_ + 4) fail("invalid \\u escape");
+        p_ += 4;
+        return value;
+    }
+
+    unsigned codePoint() {
+        unsigned cp = hex4();
+        if (cp >= 0xD800 && cp < 0xDC00) {
+            if (end_ - p_ < 2 || p_[0] != '\\' || p_[1] != 'u') fail("unpaired surrogate");
+            p_ += 2;
+            const unsigned low = hex4();
+            if (low < 0xDC00 || low >= 0xE000) fail("unpaired surrogate");
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+        } else if (cp >= 0xDC00 && cp < 0xE000) {
+            fail("unpaired surrogate");
+        }
+        return cp;
+    }
+
+    static void appendUtf8(std::string& out, unsigned cp) {
+        if (cp < 0x80) {
+            out += static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            out += static_cast<char>(0xC0 | (cp >> 6));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            out += static_cast<char>(0xE0 | (cp >> 12));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (cp >> 18));
+            out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+    }
+
+    // Skip a nested object/array (reported as unsupported by the caller)
+    void skipNested() {
+        int depth = 0;
+        std::string ignored;
+        do {
+            const char c = peek();
+            if (c == '"') {
+                string(ignored);
+                continue;
+            }
+            if (c == '\0') fail("unterminated value");
+            if (c == '{' || c == '[') ++depth;
+            if (c == '}' || c == ']') --depth;
+            ++p_;
+        } while (depth > 0);
+    }
+
+    const char* begin_;
+    const char* p_;
+    const char* end_;
+};
+
+void packScalar(JsonScanner::Kind kind, std::string_view text, uint8_t* buffer,
+                const ColumnPlan& column, Transaction* transaction) {
+    uint8_t* data = buffer + column.offset;
+    auto* nullPtr = reinterpret_cast<int16_t*>(buffer + column.nullOffset);
+    const FieldInfo& field = *column.field;
+    if (kind == JsonScanner::Kind::Null) {
+        *nullPtr = -1;
+        return;
+    }
+    detail::sql_value_codec::SqlWriteContext ctx{&field, transaction, nullPtr};
+    switch (kind) {
+        case JsonScanner::Kind::String:
+            detail::sql_value_codec::write_sql_value(ctx, std::string(text), data);
+            return;
+        case JsonScanner::Kind::True:
+        case JsonScanner::Kind::False:
+            detail::sql_value_codec::write_sql_value(ctx, kind == JsonScanner::Kind::True, data);
+            return;
+        case JsonScanner::Kind::Number: {
+            const bool integral = text.find_first_of(".eE") == std::string_view::npos;
+            if (integral && field.type != SQL_INT128 && field.type != SQL_DEC16 &&
+                field.type != SQL_DEC34) {
+                int64_t value = 0;
+                const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+                if (result.ec == std::errc{} && result.ptr == text.data() + text.size()) {
+                    detail::sql_value_codec::write_sql_value(ctx, value, data);
+                    return;
+                }
+                // Beyond int64: exact text, so the column reports the range
+            } else if (!integral) {
+                double value = 0.0;
+                const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+                if (result.ptr != text.data() + text.size()) {
+                    throw FirebirdException("Invalid JSON number '" + std::string(text) + "'");
+                }
+                detail::sql_value_codec::write_sql_value(ctx, value, data);
+                return;
+            }
+            detail::sql_value_codec::write_sql_value(ctx, std::string(text), data);
+            return;
+        }
+        default:
+            throw FirebirdException("Unsupported JSON type for field " + field.name);
+    }
+}
+
+} // namespace
+
+std::vector<JsonText> splitJsonLines(std::string_view ndjson) {
+    std::vector<JsonText> lines;
+    size_t start = 0;
+    while (start < ndjson.size()) {
+        size_t end = ndjson.find('\n', start);
+        if (end == std::string_view::npos) end = ndjson.size();
+        std::string_view line = ndjson.substr(start, end - start);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (line.find_first_not_of(" \t") != std::string_view::npos) {
+            lines.push_back(JsonText{line});
+        }
+        start = end + 1;
+    }
+    return lines;
+}
+
+JsonTextPacker::JsonTextPacker(const MessageMetadata& metadata, const NameMap* nameToPositions)
+    : layout_(metadata.getLayout()), named_(nameToPositions && !nameToPositions->empty()) {
+    const auto count = static_cast<unsigned>(layout_->columnPlan.size());
+    keys_.reserve(count + (named_ ? nameToPositions->size() : 0));
+    for (unsigned i = 0; i < count; ++i) {
+        keys_.push_back(Key{std::to_string(i), {i}});
+    }
+    if (named_) {
+        for (const auto& [name, positions] : *nameToPositions) {
+            Key key{name, {}};
+            for (size_t pos : positions) {
+                if (pos < count) key.positions.push_back(static_cast<unsigned>(pos));
+            }
+            keys_.push_back(std::move(key));
+        }
+    }
+    std::sort(keys_.begin(), keys_.end(),
+              [](const Key& a, const Key& b) { return a.text < b.text; });
+}
+
+const JsonTextPacker::Key* JsonTextPacker::find(std::string_view key) const noexcept {
+    auto it = std::lower_bound(keys_.begin(), keys_.end(), key,
+                               [](const Key& k, std::string_view v) { return k.text < v; });
+    return it != keys_.end() && it->text == key ? &*it : nullptr;
+}
+
+void JsonTextPacker::pack(std::string_view json, uint8_t* buffer, Transaction* transaction) const {
+    if (!buffer) {
+        throw FirebirdException("Invalid parameters for JSON pack");
+    }
+    const auto& plan = layout_->columnPlan;
+    std::memset(buffer, 0, layout_->messageLength);
+    for (const ColumnPlan& column : plan) {
+        *reinterpret_cast<int16_t*>(buffer + column.nullOffset) = -1;   // Missing -> NULL
+    }
+
+    thread_local std::string scratch;
+    thread_local std::string keyScratch;
+    JsonScanner in(json);
+    std::string_view text;
+
+    if (in.consume('[')) {
+        size_t index = 0;
+        if (!in.consume(']')) {
+            do {
+                const auto kind = in.value(text, scratch);
+                if (index < plan.size()) {
+                    packScalar(kind, text, buffer, plan[index], transaction);
+                }
+                ++index;
+            } while (in.consume(','));
+            in.expect(']');
+        }
+        if (index != plan.size()) {
+            throw FirebirdException(
+                "JSON array size mismatch: array has " + std::to_string(index) +
+                " elements, but query expects " + std::to_string(plan.size()) + " parameters");
+        }
+    } else if (in.consume('{')) {
+        if (!in.consume('}')) {
+            do {
+                std::string_view key = in.string(keyScratch);
+                if (key.data() != keyScratch.data()) {
+                    keyScratch.assign(key);
+                }
+                for (char& ch : keyScratch) {
+                    ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+                }
+                in.expect(':');
+                const Key* target = find(keyScratch);
+                if (!target) {
+                    if (named_) {
+                        throw FirebirdException(
+                            "Unknown named parameter '" + keyScratch + "' (no such :name in the query)");
+                    }
+                    throw FirebirdException(
+                        "Invalid parameter key '" + keyScratch + "': query has " +
+                        std::to_string(plan.size()) +
+                        " positional parameters (use indexes \"0\"..\"" +
+                        std::to_string(plan.size() - 1) +
+                        "\" or named parameters in the SQL)");
+                }
+                const auto kind = in.value(text, scratch);
+                for (unsigned pos : target->positions) {
+                    packScalar(kind, text, buffer, plan[pos], transaction);
+                }
+            } while (in.consume(','));
+            in.expect('}');
+        }
+    } else {
+        throw FirebirdException("JSON data must be array or object");
+    }
+
+    if (!in.atEnd()) {
+        in.fail("trailing characters");
+    }
+}
+
+const JsonTextPacker& JsonTextPacker::of(const MessageMetadata& metadata) {
+    const std::type_index key(typeid(JsonTextPacker));
+    if (auto cached = metadata.findPlan(key)) {
+        return *static_cast<const JsonTextPacker*>(cached.get());
+    }
+    auto packer = std::make_shared<const JsonTextPacker>(metadata);
+    const JsonTextPacker& ref = *packer;
+    metadata.storePlan(key, std::move(packer));
+    return ref;
+}
+
+const JsonTextPacker& JsonTextPacker::of(const MessageMetadata& metadata,
+                                         const NameMap& nameToPositions) {
+    const std::type_index key(typeid(NamedJsonTextPacker));
+    if (auto cached = metadata.findPlan(key)) {
+        return *static_cast<const JsonTextPacker*>(cached.get());
+    }
+    auto packer = std::make_shared<const JsonTextPacker>(metadata, &nameToPositions);
+    const JsonTextPacker& ref = *packer;
+    metadata.storePlan(key, std::move(packer));
+    return ref;
+}
+
+} // namespace fbpp::core
@@ -8,7 +8,7 @@ namespace fbpp::core {
 MessageBuilder::MessageBuilder(unsigned field_count)
     : env_(Environment::getInstance())
     , builder_(nullptr)
-    , status_(env_.getMaster()->getStatus())
+    , status_(env_.acquireStatus())
     , statusWrapper_(status_)
     , field_count_(field_count)
     , current_index_(0)
@@ -31,13 +31,13 @@ MessageBuilder::~MessageBuilder() {
         builder_->release();
         builder_ = nullptr;
     }
-    statusWrapper_.dispose();
+    env_.releaseStatus(status_);
 }
 
 MessageBuilder::MessageBuilder(MessageBuilder&& other) noexcept
     : env_(Environment::getInstance())
     , builder_(other.builder_)
-    , status_(env_.getMaster()->getStatus())
+    , status_(env_.acquireStatus())
     , statusWrapper_(status_)
     , field_count_(other.field_count_)
     , current_index_(other.current_index_)
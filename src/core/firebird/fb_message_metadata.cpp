@@ -1,6 +1,7 @@
 #include "fbpp/core/message_metadata.hpp"
 #include "fbpp/core/environment.hpp"
 #include "fbpp/core/exception.hpp"
+#include <algorithm>
 #include <cctype>
 #include <cstring>
 #include <string_view>
@@ -37,27 +38,48 @@ std::string asciiUpper(std::string_view s) {
     return out;
 }
 
+using NameTable = std::vector<std::pair<std::string_view, unsigned>>;
+
+void sortNames(NameTable& table) {
+    std::sort(table.begin(), table.end());
+}
+
+std::optional<unsigned> findName(const NameTable& table, std::string_view key) {
+    auto it = std::lower_bound(table.begin(), table.end(), key,
+                               [](const auto& entry, std::string_view k) { return entry.first < k; });
+    if (it != table.end() && it->first == key) {
+        return it->second;   // Lowest index among equal keys
+    }
+    return std::nullopt;
+}
+
 } // namespace
 
 MessageMetadata::MessageMetadata(Firebird::IMessageMetadata* metadata)
     : env_(Environment::getInstance()),
       metadata_(metadata),
-      status_(env_.getMaster()->getStatus()),
+      status_(env_.acquireStatus()),
       statusWrapper_(status_) {
     if (!metadata_) {
         throw FirebirdException("Invalid metadata pointer");
     }
 }
 
+MessageMetadata::MessageMetadata(Firebird::IMessageMetadata* metadata,
+                                 std::shared_ptr<const MetadataLayout> layout)
+    : MessageMetadata(metadata) {
+    if (layout && describes(*layout)) {
+        layout_ = std::move(layout);
+    }
+}
+
 MessageMetadata::MessageMetadata(MessageMetadata&& other) noexcept
     : env_(Environment::getInstance()),
       metadata_(other.metadata_),
-      status_(env_.getMaster()->getStatus()),
+      status_(env_.acquireStatus()),
       statusWrapper_(status_),
-      fields_(std::move(other.fields_)),
-      name_upper_(std::move(other.name_upper_)),
-      alias_upper_(std::move(other.alias_upper_)),
-      fieldsLoaded_(other.fieldsLoaded_) {
+      layout_(std::move(other.layout_)),
+      plans_(std::move(other.plans_)) {
     other.metadata_ = nullptr;
 }
 
@@ -65,10 +87,8 @@ MessageMetadata& MessageMetadata::operator=(MessageMetadata&& other) noexcept {
     if (this != &other) {
         cleanup();
         metadata_ = other.metadata_;
-        fields_ = std::move(other.fields_);
-        name_upper_ = std::move(other.name_upper_);
-        alias_upper_ = std::move(other.alias_upper_);
-        fieldsLoaded_ = other.fieldsLoaded_;
+        layout_ = std::move(other.layout_);
+        plans_ = std::move(other.plans_);
         other.metadata_ = nullptr;
     }
     return *this;
@@ -76,7 +96,7 @@ MessageMetadata& MessageMetadata::operator=(MessageMetadata&& other) noexcept {
 
 MessageMetadata::~MessageMetadata() {
     cleanup();
-    statusWrapper_.dispose();
+    env_.releaseStatus(status_);
 }
 
 void MessageMetadata::cleanup() {
@@ -97,19 +117,17 @@ unsigned MessageMetadata::getCount() const {
 }
 
 void MessageMetadata::loadFields() const {
-    if (fieldsLoaded_ || !metadata_) {
+    if (layout_ || !metadata_) {
         return;
     }
 
     auto& st = status();
 
     unsigned count = getCount();
-    fields_.clear();
-    fields_.reserve(count);
-    name_upper_.clear();
-    name_upper_.reserve(count);
-    alias_upper_.clear();
-    alias_upper_.reserve(count);
+    auto layout = std::make_shared<MetadataLayout>();
+    layout->fields.reserve(count);
+    layout->nameUpper.reserve(count);
+    layout->aliasUpper.reserve(count);
 
     for (unsigned i = 0; i < count; ++i) {
         FieldInfo field;
@@ -140,12 +158,76 @@ void MessageMetadata::loadFields() const {
         field.offset = metadata_->getOffset(&st, i);
         field.nullOffset = metadata_->getNullOffset(&st, i);
 
-        name_upper_.push_back(asciiUpper(field.name));
-        alias_upper_.push_back(asciiUpper(field.alias));
-        fields_.push_back(std::move(field));
+        layout->nameUpper.push_back(asciiUpper(field.name));
+        layout->aliasUpper.push_back(asciiUpper(field.alias));
+        layout->fields.push_back(std::move(field));
     }
 
-    fieldsLoaded_ = true;
+    // fields is complete and never reallocated again, so the plan and the
+    // name tables can safely point into it.
+    layout->exactNames.reserve(2 * count);
+    layout->upperNames.reserve(2 * count);
+    auto addName = [](NameTable& table, std::string_view key, unsigned index) {
+        if (!key.empty()) {   // An empty lookup never matches
+            table.emplace_back(key, index);
+        }
+    };
+    for (unsigned i = 0; i < count; ++i) {
+        addName(layout->exactNames, layout->fields[i].name, i);
+        addName(layout->exactNames, layout->fields[i].alias, i);
+        addName(layout->upperNames, layout->nameUpper[i], i);
+        addName(layout->upperNames, layout->aliasUpper[i], i);
+    }
+    sortNames(layout->exactNames);
+    sortNames(layout->upperNames);
+
+    layout->columnPlan.reserve(count);
+    for (const auto& field : layout->fields) {
+        layout->columnPlan.push_back(ColumnPlan{
+            field.type,
+            field.subType,
+            field.length,
+            field.scale,
+            field.charSet,
+            field.offset,
+            field.nullOffset,
+            field.nullable,
+            &field
+        });
+    }
+    layout->messageLength = metadata_->getMessageLength(&st);
+    layout->layoutHash = messageLayoutHash(layout->fields);
+
+    layout_ = std::move(layout);
+}
+
+const MetadataLayout& MessageMetadata::layout() const {
+    loadFields();
+    return *layout_;
+}
+
+bool MessageMetadata::describes(const MetadataLayout& layout) const {
+    auto& st = status();
+
+    const unsigned count = metadata_->getCount(&st);
+    if (count != layout.fields.size() ||
+        metadata_->getMessageLength(&st) != layout.messageLength) {
+        return false;
+    }
+    // Only the binary shape is compared; names come from the same SQL text.
+    for (unsigned i = 0; i < count; ++i) {
+        const auto& field = layout.fields[i];
+        if (metadata_->getType(&st, i) != field.type ||
+            metadata_->getSubType(&st, i) != field.subType ||
+            metadata_->getLength(&st, i) != field.length ||
+            metadata_->getScale(&st, i) != field.scale ||
+            metadata_->getCharSet(&st, i) != field.charSet ||
+            metadata_->getOffset(&st, i) != field.offset ||
+            metadata_->getNullOffset(&st, i) != field.nullOffset) {
+            return false;
+        }
+    }
+    return true;
 }
 
 FieldInfo MessageMetadata::getField(unsigned index) const {
@@ -153,41 +235,77 @@ FieldInfo MessageMetadata::getField(unsigned index) const {
         throw FirebirdException("Metadata is not initialized");
     }
     
-    loadFields();
+    const auto& fields = layout().fields;
     
-    if (index >= fields_.size()) {
+    if (index >= fields.size()) {
         throw FirebirdException("Field index out of range");
     }
     
-    return fields_[index];
+    return fields[index];
+}
+
+const FieldInfo& MessageMetadata::getFieldRef(unsigned index) const {
+    if (!metadata_) {
+        throw FirebirdException("Metadata is not initialized");
+    }
+
+    const auto& fields = layout().fields;
+
+    if (index >= fields.size()) {
+        throw FirebirdException("Field index out of range");
+    }
+
+    return fields[index];
 }
 
-std::optional<FieldInfo> MessageMetadata::getField(const std::string& name) const {
+const std::vector<ColumnPlan>& MessageMetadata::getColumnPlan() const {
+    if (!metadata_) {
+        throw FirebirdException("Metadata is not initialized");
+    }
+
+    return layout().columnPlan;
+}
+
+std::shared_ptr<const MetadataLayout> MessageMetadata::getLayout() const {
     if (!metadata_) {
         throw FirebirdException("Metadata is not initialized");
     }
 
     loadFields();
+    return layout_;
+}
 
-    // Pass 1: exact match (preserves quoted-identifier semantics).
-    for (const auto& field : fields_) {
-        if (field.name == name || field.alias == name) {
-            return field;
+std::shared_ptr<const void> MessageMetadata::findPlan(std::type_index key) const {
+    for (const auto& [type, plan] : plans_) {
+        if (type == key) {
+            return plan;
         }
     }
+    return nullptr;
+}
 
-    // Pass 2: case-insensitive ASCII match with whitespace trim on lookup.
-    const std::string lookup = asciiUpperTrim(name);
-    if (lookup.empty()) {
-        return std::nullopt;
-    }
-    for (size_t i = 0; i < fields_.size(); ++i) {
-        if (name_upper_[i] == lookup || alias_upper_[i] == lookup) {
-            return fields_[i];
+void MessageMetadata::storePlan(std::type_index key, std::shared_ptr<const void> plan) const {
+    for (auto& [type, existing] : plans_) {
+        if (type == key) {
+            existing = std::move(plan);
+            return;
         }
     }
+    plans_.emplace_back(key, std::move(plan));
+}
 
-    return std::nullopt;
+std::shared_ptr<MessageMetadata> MessageMetadata::clone() const {
+    auto layout = getLayout();
+    metadata_->addRef();   // Released by the clone's cleanup()
+    return std::make_shared<MessageMetadata>(metadata_, std::move(layout));
+}
+
+std::optional<FieldInfo> MessageMetadata::getField(std::string_view name) const {
+    auto index = getIndex(name);
+    if (!index) {
+        return std::nullopt;
+    }
+    return layout().fields[*index];
 }
 
 std::vector<FieldInfo> MessageMetadata::getFields() const {
@@ -195,38 +313,40 @@ std::vector<FieldInfo> MessageMetadata::getFields() const {
         throw FirebirdException("Metadata is not initialized");
     }
     
-    loadFields();
-    return fields_;
+    return layout().fields;
 }
 
-std::optional<unsigned> MessageMetadata::getIndex(const std::string& name) const {
+std::optional<unsigned> MessageMetadata::getIndex(std::string_view name) const {
     if (!metadata_) {
         throw FirebirdException("Metadata is not initialized");
     }
 
-    // IMessageMetadata has no by-name lookup — we search manually using the
-    // same two-pass semantics as getField(name).
-    loadFields();
+    // IMessageMetadata has no by-name lookup; the layout carries sorted
+    // name tables for the two passes described in the header.
+    const auto& cached = layout();
 
-    // Pass 1: exact match.
-    for (unsigned i = 0; i < fields_.size(); ++i) {
-        if (fields_[i].name == name || fields_[i].alias == name) {
-            return i;
-        }
+    // Pass 1: exact match (preserves quoted-identifier semantics).
+    if (auto index = findName(cached.exactNames, name)) {
+        return index;
     }
 
     // Pass 2: case-insensitive ASCII match with whitespace trim on lookup.
-    const std::string lookup = asciiUpperTrim(name);
-    if (lookup.empty()) {
+    size_t b = 0;
+    size_t e = name.size();
+    while (b < e && std::isspace(static_cast<unsigned char>(name[b]))) ++b;
+    while (e > b && std::isspace(static_cast<unsigned char>(name[e - 1]))) --e;
+    if (b == e) {
         return std::nullopt;
     }
-    for (unsigned i = 0; i < fields_.size(); ++i) {
-        if (name_upper_[i] == lookup || alias_upper_[i] == lookup) {
-            return i;
+    char stackBuf[64];
+    if (e - b <= sizeof(stackBuf)) {
+        for (size_t i = b; i < e; ++i) {
+            stackBuf[i - b] = static_cast<char>(
+                std::toupper(static_cast<unsigned char>(name[i])));
         }
+        return findName(cached.upperNames, std::string_view(stackBuf, e - b));
     }
-
-    return std::nullopt;
+    return findName(cached.upperNames, asciiUpperTrim(name));
 }
 
 std::string MessageMetadata::getFieldName(unsigned index) const {
@@ -358,13 +478,13 @@ std::string MessageMetadata::getDisplayName(unsigned index) const {
         throw FirebirdException("Metadata is not initialized");
     }
 
-    loadFields();
+    const auto& fields = layout().fields;
 
-    if (index >= fields_.size()) {
+    if (index >= fields.size()) {
         throw FirebirdException("Field index out of range");
     }
 
-    return displayName(fields_[index]);
+    return displayName(fields[index]);
 }
 
 unsigned MessageMetadata::getMessageLength() const {
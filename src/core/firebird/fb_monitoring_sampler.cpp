@@ -0,0 +1,262 @@
+#include "fbpp/core/monitoring_sampler.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement_cache.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+namespace fbpp {
+namespace core {
+
+namespace {
+
+// One snapshot, one join: counters of every other attachment's statements
+constexpr const char* kStatementsSql =
+    "SELECT s.MON$STATEMENT_ID, s.MON$STATE,"
+    "       CAST(DATEDIFF(MILLISECOND FROM s.MON$TIMESTAMP TO CURRENT_TIMESTAMP) AS BIGINT),"
+    "       COALESCE(io.MON$PAGE_READS, 0), COALESCE(io.MON$PAGE_WRITES, 0),"
+    "       COALESCE(io.MON$PAGE_FETCHES, 0), COALESCE(io.MON$PAGE_MARKS, 0),"
+    "       COALESCE(r.MON$RECORD_SEQ_READS, 0), COALESCE(r.MON$RECORD_IDX_READS, 0),"
+    "       s.MON$SQL_TEXT"
+    " FROM MON$STATEMENTS s"
+    " LEFT JOIN MON$IO_STATS io ON io.MON$STAT_ID = s.MON$STAT_ID"
+    " LEFT JOIN MON$RECORD_STATS r ON r.MON$STAT_ID = s.MON$STAT_ID"
+    " WHERE s.MON$ATTACHMENT_ID <> CURRENT_CONNECTION AND s.MON$SQL_TEXT IS NOT NULL";
+
+constexpr const char* kAttachmentsSql =
+    "SELECT COUNT(*) FROM MON$ATTACHMENTS"
+    " WHERE MON$ATTACHMENT_ID <> CURRENT_CONNECTION AND MON$SYSTEM_FLAG = 0";
+
+constexpr int16_t kStateActive = 1;   // MON$STATE: 0 idle, 1 active, 2 stalled
+
+using StatementRow = std::tuple<int64_t, int16_t, std::optional<int64_t>, int64_t, int64_t,
+                                int64_t, int64_t, int64_t, int64_t, TextBlob>;
+
+// Growth of a cumulative counter; a smaller value means the row restarted
+uint64_t grown(uint64_t now, uint64_t& last) {
+    const uint64_t delta = now >= last ? now - last : now;
+    last = now;
+    return delta;
+}
+
+uint64_t counter(int64_t value) {
+    return value < 0 ? 0 : static_cast<uint64_t>(value);
+}
+
+} // namespace
+
+MonitoringSampler::MonitoringSampler(ConnectionParams params, MonitoringSamplerOptions options)
+    : options_(std::move(options))
+    , connection_(std::make_unique<Connection>(params)) {
+    if (options_.interval.count() > 0) {
+        thread_ = std::thread([this] { run(); });
+    }
+}
+
+MonitoringSampler::~MonitoringSampler() {
+    stop();
+}
+
+void MonitoringSampler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        shutdown_ = true;
+    }
+    stopping_.notify_all();
+    if (thread_.joinable() && thread_.get_id() != std::this_thread::get_id()) {
+        thread_.join();
+    }
+}
+
+void MonitoringSampler::addMetricsSource(const Connection& connection) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (std::find(sources_.begin(), sources_.end(), &connection) == sources_.end()) {
+        sources_.push_back(&connection);
+    }
+}
+
+void MonitoringSampler::removeMetricsSource(const Connection& connection) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sources_.erase(std::remove(sources_.begin(), sources_.end(), &connection), sources_.end());
+}
+
+std::optional<MonitoringSample> MonitoringSampler::latest() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return latest_;
+}
+
+void MonitoringSampler::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!shutdown_) {
+        stopping_.wait_for(lock, options_.interval, [&] { return shutdown_; });
+        if (shutdown_) {
+            break;
+        }
+        lock.unlock();
+        try {
+            sample();
+        } catch (const std::exception& e) {
+            fbpp::util::trace(fbpp::util::TraceLevel::warn, "MonitoringSampler",
+                              [&](auto& oss) { oss << "Sample failed: " << e.what(); });
+        }
+        lock.lock();
+    }
+}
+
+MonitoringSample MonitoringSampler::sample() {
+    std::lock_guard<std::mutex> sampling(sampleMutex_);
+    const auto started = std::chrono::steady_clock::now();
+    MonitoringSample result;
+    result.taken = std::chrono::system_clock::now();
+    const uint64_t sampleNo = ++samples_;
+
+    std::map<uint64_t, MonitoredStatement> byFingerprint;
+    TransactionOptions snapshot;
+    snapshot.readOnly = true;   // Concurrency: the MON$ snapshot lives as long as the transaction
+    auto tx = connection_->StartTransaction(snapshot);
+    {
+        auto cursor = tx->openCursor(connection_->prepareStatement(kStatementsSql));
+        StatementRow row;
+        while (cursor->fetch(row)) {
+            const int64_t id = std::get<0>(row);
+            auto it = tracked_.find(id);
+            if (it == tracked_.end()) {
+                // New statement: its text is read once, while the cursor's transaction lives
+                const std::string& text = std::get<9>(row).getText();
+                Tracked fresh;
+                fresh.fingerprint = SqlKey::hashOf(text, 0);
+                texts_.try_emplace(fresh.fingerprint, text);
+                it = tracked_.emplace(id, fresh).first;
+            }
+            Tracked& tracked = it->second;
+            tracked.seenInSample = sampleNo;
+
+            MonitoredStatement& entry = byFingerprint[tracked.fingerprint];
+            entry.fingerprint = tracked.fingerprint;
+            ++entry.instances;
+            entry.pageReads += grown(counter(std::get<3>(row)), tracked.reads);
+            entry.pageWrites += grown(counter(std::get<4>(row)), tracked.writes);
+            entry.pageFetches += grown(counter(std::get<5>(row)), tracked.fetches);
+            entry.pageMarks += grown(counter(std::get<6>(row)), tracked.marks);
+            entry.seqReads += grown(counter(std::get<7>(row)), tracked.seqReads);
+            entry.idxReads += grown(counter(std::get<8>(row)), tracked.idxReads);
+            if (std::get<1>(row) == kStateActive) {
+                ++entry.active;
+                entry.running += std::chrono::milliseconds(
+                    std::max<int64_t>(0, std::get<2>(row).value_or(0)));
+            }
+            ++result.statements;
+        }
+    }
+    {
+        auto cursor = tx->openCursor(connection_->prepareStatement(kAttachmentsSql));
+        std::tuple<int64_t> count{0};
+        cursor->fetch(count);
+        result.attachments = static_cast<std::size_t>(std::get<0>(count));
+    }
+    tx->Commit();
+
+    // Forget statements that have been freed
+    for (auto it = tracked_.begin(); it != tracked_.end();) {
+        it = it->second.seenInSample == sampleNo ? std::next(it) : tracked_.erase(it);
+    }
+    if (texts_.size() > 2 * tracked_.size() + 1024) {
+        std::erase_if(texts_, [&](const auto& text) { return !byFingerprint.count(text.first); });
+    }
+
+    std::vector<MonitoredStatement> entries;
+    entries.reserve(byFingerprint.size());
+    for (auto& [fingerprint, entry] : byFingerprint) {
+        entry.sql = texts_[fingerprint];
+        entries.push_back(std::move(entry));
+    }
+    auto top = [&](auto keep, auto before) {
+        std::vector<MonitoredStatement> list;
+        for (const auto& entry : entries) {
+            if (keep(entry)) {
+                list.push_back(entry);
+            }
+        }
+        std::sort(list.begin(), list.end(), before);
+        if (list.size() > options_.topN) {
+            list.resize(options_.topN);
+        }
+        return list;
+    };
+    result.topByReads = top(
+        [](const MonitoredStatement& s) { return s.pageReads > 0 || s.pageFetches > 0; },
+        [](const MonitoredStatement& a, const MonitoredStatement& b) {
+            return std::tie(a.pageReads, a.pageFetches) > std::tie(b.pageReads, b.pageFetches);
+        });
+    result.topByTime = top([](const MonitoredStatement& s) { return s.active > 0; },
+                           [](const MonitoredStatement& a, const MonitoredStatement& b) {
+                               return a.running > b.running;
+                           });
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!sources_.empty() && (!result.topByReads.empty() || !result.topByTime.empty())) {
+            std::unordered_map<uint64_t, StatementMetricsSnapshot> client;
+            for (const Connection* source : sources_) {
+                for (auto& metrics : source->getStatementMetrics()) {
+                    const uint64_t fingerprint = SqlKey::hashOf(metrics.sql, 0);
+                    client.try_emplace(fingerprint, std::move(metrics));
+                }
+            }
+            for (auto* list : {&result.topByReads, &result.topByTime}) {
+                for (auto& entry : *list) {
+                    if (auto found = client.find(entry.fingerprint); found != client.end()) {
+                        entry.client = found->second;
+                    }
+                }
+            }
+        }
+    }
+    result.cost = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started);
+
+    publish(result);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        latest_ = result;
+    }
+    return result;
+}
+
+void MonitoringSampler::publish(const MonitoringSample& sample) const {
+    if (!options_.traceLevel || !fbpp::util::traceEnabled(*options_.traceLevel)) {
+        return;
+    }
+    const auto level = *options_.traceLevel;
+    fbpp::util::trace(level, "MonitoringSampler", [&](auto& oss) {
+        oss << "sample attachments=" << sample.attachments << " statements=" << sample.statements
+            << " cost=" << sample.cost.count() << "us";
+    });
+    auto line = [&](const char* list, std::size_t rank, const MonitoredStatement& s) {
+        fbpp::util::trace(level, "MonitoringSampler", [&](auto& oss) {
+            oss << list << '#' << rank << " reads=" << s.pageReads << " fetches=" << s.pageFetches
+                << " writes=" << s.pageWrites << " marks=" << s.pageMarks
+                << " seq=" << s.seqReads << " idx=" << s.idxReads << " active=" << s.active << '/'
+                << s.instances << " running=" << s.running.count() << "ms";
+            if (s.client) {
+                oss << " client{uses=" << s.client->useCount
+                    << " execute.p99=" << s.client->execute.p99Micros
+                    << " open.p99=" << s.client->openCursor.p99Micros
+                    << " rows=" << s.client->rowsFetched << '}';
+            }
+            oss << " sql=" << s.sql;
+        });
+    };
+    for (std::size_t i = 0; i < sample.topByReads.size(); ++i) {
+        line("reads", i + 1, sample.topByReads[i]);
+    }
+    for (std::size_t i = 0; i < sample.topByTime.size(); ++i) {
+        line("time", i + 1, sample.topByTime[i]);
+    }
+}
+
+} // namespace core
+} // namespace fbpp
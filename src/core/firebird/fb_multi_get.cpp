@@ -0,0 +1,80 @@
+#include "fbpp/core/multi_get.hpp"
+
+#include <atomic>
+
+namespace fbpp {
+namespace core {
+
+namespace {
+
+// Parameter carrying the batch id in the keyTable query
+constexpr std::string_view kBatchParam = "fbpp_multiget_batch";
+
+// Unique per process; the key table's rows are private to one transaction
+std::atomic<std::int64_t> lastBatchId{0};
+
+} // namespace
+
+MultiGet::MultiGet(Connection& connection, std::string sql, std::string listName,
+                   MultiGetOptions options)
+    : connection_(connection),
+      sql_(std::move(sql)),
+      listName_(std::move(listName)),
+      options_(std::move(options)) {
+    if (listName_.empty()) {
+        throw FirebirdException("MultiGet: list parameter name is empty");
+    }
+}
+
+unsigned MultiGet::keyColumnOf(const ResultSet& cursor) const {
+    if (!options_.keyColumn.empty()) {
+        return cursor.column(options_.keyColumn).index();
+    }
+    const auto* meta = cursor.getMetadata();
+    if (!meta || meta->getCount() == 0) {
+        throw FirebirdException("MultiGet: query has no output columns");
+    }
+    return 0;
+}
+
+StagingTable& MultiGet::ensureKeyTable(bool integerKeys) {
+    auto& table = keyTable_[integerKeys ? 1 : 0];
+    if (!table) {
+        const std::string type = !options_.keyType.empty() ? options_.keyType
+                                 : integerKeys            ? "BIGINT"
+                                                          : "VARCHAR(200)";
+        StagingTableOptions staging;
+        staging.name = !options_.keyTable.empty() ? options_.keyTable
+                       : integerKeys              ? "FBPP_MULTIGET_KEYS_I"
+                                                  : "FBPP_MULTIGET_KEYS_S";
+        staging.primaryKey = {"BATCH_ID", "K"};
+        table = std::make_unique<StagingTable>(
+            connection_, std::vector<StagingColumn>{{"BATCH_ID", "BIGINT NOT NULL"},
+                                                    {"K", type + " NOT NULL"}},
+            std::move(staging));
+    }
+    return *table;
+}
+
+std::int64_t MultiGet::nextBatchId() {
+    return ++lastBatchId;
+}
+
+std::unique_ptr<ResultSet> MultiGet::openKeyTable(Transaction& transaction,
+                                                  const StagingTable& table,
+                                                  std::int64_t batchId) {
+    const std::string subquery = "SELECT K FROM " + table.name() + " WHERE BATCH_ID = :" +
+                                 std::string(kBatchParam);
+    auto query = connection_.prepareStatement(
+        NamedParamParser::replaceParam(sql_, listName_, subquery));
+    ParamBinder binder(query, &transaction);
+    if (!binder.set(kBatchParam, batchId)) {
+        throw FirebirdException("MultiGet: SQL has no list parameter ':" + listName_ + "'");
+    }
+    auto cursor = transaction.openCursor(query, binder);
+    ++stats_.roundTrips;
+    return cursor;
+}
+
+} // namespace core
+} // namespace fbpp
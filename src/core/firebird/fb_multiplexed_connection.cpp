@@ -0,0 +1,163 @@
+#include "fbpp/core/multiplexed_connection.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp_util/trace.h"
+
+#include <algorithm>
+
+namespace fbpp {
+namespace core {
+
+namespace {
+
+void rollbackQuietly(Transaction& transaction) noexcept {
+    if (transaction.isActive()) {
+        try {
+            transaction.Rollback();
+        } catch (...) {
+            // The request failed already; its error is what the caller sees
+        }
+    }
+}
+
+} // namespace
+
+MultiplexedConnection::MultiplexedConnection(ConnectionParams params,
+                                             MultiplexedConnectionOptions options)
+    : options_(std::move(options))
+    , connection_(std::make_unique<Connection>(params)) {
+    options_.maxGroup = std::max<size_t>(options_.maxGroup, 1);
+    // From here on only the I/O thread touches the connection
+    thread_ = std::thread([this] { run(); });
+}
+
+MultiplexedConnection::~MultiplexedConnection() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void MultiplexedConnection::enqueue(Request request) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            throw FirebirdException("MultiplexedConnection is shutting down");
+        }
+        queue_.push_back(std::move(request));
+        ++stats_.requests;
+        stats_.maxQueued = std::max(stats_.maxQueued, queue_.size());
+    }
+    wake_.notify_one();
+}
+
+MultiplexStats MultiplexedConnection::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void MultiplexedConnection::run() {
+    std::deque<Request> batch;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                break;   // Stopping, and nothing left to run
+            }
+            batch.swap(queue_);
+            ++stats_.wakeups;
+        }
+
+        for (size_t i = 0; i < batch.size();) {
+            if (!batch[i].grouped) {
+                runOne(batch[i]);
+                ++i;
+                continue;
+            }
+            size_t count = 1;
+            while (i + count < batch.size() && batch[i + count].grouped &&
+                   count < options_.maxGroup) {
+                ++count;
+            }
+            runGroup(&batch[i], count);
+            i += count;
+        }
+        batch.clear();
+    }
+}
+
+void MultiplexedConnection::runOne(Request& request) {
+    std::exception_ptr error;
+    try {
+        request.work(*connection_, nullptr);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    request.finish(error);
+}
+
+void MultiplexedConnection::runWrite(Request& request) {
+    std::exception_ptr error;
+    std::shared_ptr<Transaction> transaction;
+    try {
+        transaction = connection_->StartTransaction();
+        request.work(*connection_, transaction.get());
+        transaction->Commit();
+    } catch (...) {
+        error = std::current_exception();
+        if (transaction) {
+            rollbackQuietly(*transaction);
+        }
+    }
+    request.finish(error);
+}
+
+void MultiplexedConnection::runGroup(Request* first, size_t count) {
+    if (count == 1) {
+        runWrite(*first);
+        return;
+    }
+
+    std::shared_ptr<Transaction> transaction;
+    try {
+        transaction = connection_->StartTransaction();
+        for (size_t i = 0; i < count; ++i) {
+            first[i].work(*connection_, transaction.get());
+        }
+        transaction->Commit();
+    } catch (const std::exception& e) {
+        if (transaction) {
+            rollbackQuietly(*transaction);
+        }
+        fbpp::util::trace(fbpp::util::TraceLevel::info, "MultiplexedConnection",
+                    [&](auto& oss) {
+                        oss << "Group of " << count << " writes failed, running them one by one: "
+                            << e.what();
+                    });
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++stats_.groupRetries;
+        }
+        // Nothing of the group was committed: each write again, alone
+        for (size_t i = 0; i < count; ++i) {
+            runWrite(first[i]);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.groups;
+        stats_.groupedWrites += count;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        first[i].finish(nullptr);
+    }
+}
+
+} // namespace core
+} // namespace fbpp
@@ -1,238 +1,178 @@
 #include "fbpp/core/named_param_parser.hpp"
-#include <algorithm>
+#include "fbpp/core/detail/sql_lexer.hpp"
 #include <cctype>
+#include <charconv>
+#include <mutex>
+#include <shared_mutex>
 
 namespace fbpp {
 namespace core {
 
+namespace {
+
+inline bool isNameStart(char ch) {
+    return std::isalpha(static_cast<unsigned char>(ch)) || ch == '_';
+}
+
+inline bool isNameChar(char ch) {
+    return std::isalnum(static_cast<unsigned char>(ch)) || ch == '_';
+}
+
+} // namespace
+
 NamedParamParser::ParseResult NamedParamParser::parse(const std::string& sql) {
     ParseResult result;
     result.convertedSql.reserve(sql.size());
 
     size_t paramPosition = 0;
-    char currentQuote = '\0';
-    bool inSingleLineComment = false;
-    bool inMultiLineComment = false;
-
-    for (size_t i = 0; i < sql.size(); ++i) {
-        char ch = sql[i];
-        char nextCh = (i + 1 < sql.size()) ? sql[i + 1] : '\0';
-
-        // Handle string literals
-        if (currentQuote != '\0') {
-            result.convertedSql += ch;
-            // Check for quote escape (doubled quote)
-            if (ch == currentQuote) {
-                if (nextCh == currentQuote) {
-                    result.convertedSql += nextCh;
-                    ++i; // Skip next quote
-                } else {
-                    currentQuote = '\0'; // End of string
-                }
-            }
+    detail::SqlLexer lexer(sql);
+    detail::SqlLexer::Span span;
+    while (lexer.next(span)) {
+        // String literals and comments are copied verbatim; an apostrophe
+        // in a comment or a ':name' in a literal never reaches the scan.
+        if (span.kind != detail::SqlLexer::Kind::Code) {
+            result.convertedSql.append(sql, span.begin, span.end - span.begin);
             continue;
         }
 
-        // Inside a single-line comment: copy verbatim until end of line.
-        // Must be checked before quote handling so an apostrophe inside a
-        // comment (e.g. "-- don't") doesn't open a phantom string literal.
-        if (inSingleLineComment) {
-            if (ch == '\n' || ch == '\r') {
-                inSingleLineComment = false;
-            }
-            result.convertedSql += ch;
-            continue;
-        }
+        size_t copied = span.begin;   // Start of the not yet copied code
+        for (size_t i = span.begin; i < span.end; ++i) {
+            const char ch = sql[i];
 
-        // Inside a multi-line comment: copy verbatim until "*/".
-        if (inMultiLineComment) {
-            if (ch == '*' && nextCh == '/') {
-                inMultiLineComment = false;
-                result.convertedSql += ch;
-                result.convertedSql += nextCh;
-                ++i; // Skip '/'
-            } else {
-                result.convertedSql += ch;
+            // Existing positional parameter
+            if (ch == '?') {
+                paramPosition++;
+                continue;
             }
-            continue;
-        }
-
-        // Start of single-line comment
-        if (ch == '-' && nextCh == '-') {
-            inSingleLineComment = true;
-            result.convertedSql += ch;
-            result.convertedSql += nextCh;
-            ++i; // Skip second '-'
-            continue;
-        }
-
-        // Start of multi-line comment. Consume both opener chars so the
-        // opener's '*' can't be matched as part of a closing "*/" (the
-        // "/*/" case must NOT terminate the comment).
-        if (ch == '/' && nextCh == '*') {
-            inMultiLineComment = true;
-            result.convertedSql += ch;
-            result.convertedSql += nextCh;
-            ++i; // Skip '*'
-            continue;
-        }
-
-        // Start of string literal
-        if (ch == '\'' || ch == '"') {
-            currentQuote = ch;
-            result.convertedSql += ch;
-            continue;
-        }
 
-        // Check for named parameter (: or @)
-        if ((ch == ':' || ch == '@') && i + 1 < sql.size()) {
-            // Check if next character starts an identifier
-            char next = sql[i + 1];
-            if (std::isalpha(static_cast<unsigned char>(next)) || next == '_') {
-                // Extract parameter name
-                size_t nameStart = i + 1;
-                size_t nameEnd = nameStart;
-
-                while (nameEnd < sql.size()) {
-                    char c = sql[nameEnd];
-                    if (std::isalnum(static_cast<unsigned char>(c)) || c == '_') {
-                        nameEnd++;
-                    } else {
-                        break;
-                    }
-                }
-
-                std::string paramName = sql.substr(nameStart, nameEnd - nameStart);
-                std::string paramNameLower = toLower(paramName);
-
-                // Add parameter info
-                NamedParamInfo info;
-                info.name = paramNameLower;
-                info.position = paramPosition;
-                info.sqlOffset = i;
-                result.parameters.push_back(info);
-
-                // Update name-to-positions map
-                result.nameToPositions[paramNameLower].push_back(paramPosition);
-
-                // Replace with ?
-                result.convertedSql += '?';
-                i = nameEnd - 1; // Skip parameter name
-                paramPosition++;
-                result.hasNamedParams = true;
+            // Named parameter (: or @) followed by an identifier
+            if ((ch != ':' && ch != '@') || i + 1 >= span.end || !isNameStart(sql[i + 1])) {
                 continue;
             }
-        }
+            size_t nameEnd = i + 2;
+            while (nameEnd < span.end && isNameChar(sql[nameEnd])) {
+                nameEnd++;
+            }
 
-        // Check for existing positional parameter
-        if (ch == '?') {
+            NamedParamInfo& info = result.parameters.emplace_back();
+            info.name.assign(sql, i + 1, nameEnd - i - 1);
+            for (char& c : info.name) {
+                c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            }
+            info.position = paramPosition;
+            info.sqlOffset = i;
+            result.nameToPositions[info.name].push_back(paramPosition);
+
+            // Replace with ?
+            result.convertedSql.append(sql, copied, i - copied);
+            result.convertedSql += '?';
+            copied = nameEnd;
+            i = nameEnd - 1; // Skip parameter name
             paramPosition++;
+            result.hasNamedParams = true;
         }
-
-        // Copy character as-is
-        result.convertedSql += ch;
+        result.convertedSql.append(sql, copied, span.end - copied);
     }
 
     return result;
 }
 
-bool NamedParamParser::isInString(const std::string& sql, size_t pos, char& quoteChar) {
-    quoteChar = '\0';
-    bool inString = false;
-    char currentQuote = '\0';
-
-    for (size_t i = 0; i < pos && i < sql.size(); ++i) {
-        char ch = sql[i];
-        char nextCh = (i + 1 < sql.size()) ? sql[i + 1] : '\0';
-
-        if (currentQuote != '\0') {
-            // We're in a string
-            if (ch == currentQuote) {
-                if (nextCh == currentQuote) {
-                    // Escaped quote, skip it
-                    ++i;
-                } else {
-                    // End of string
-                    currentQuote = '\0';
-                    inString = false;
-                }
-            }
-        } else {
-            // Not in a string
-            if (ch == '\'' || ch == '"') {
-                currentQuote = ch;
-                inString = true;
-            }
+std::shared_ptr<const NamedParamParser::ParseResult> NamedParamParser::parseCached(
+        const std::string& sql) {
+    static std::shared_mutex mutex;
+    static std::unordered_map<std::string, std::shared_ptr<const ParseResult>> cache;
+
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = cache.find(sql);
+        if (it != cache.end()) {
+            return it->second;
         }
     }
 
-    quoteChar = currentQuote;
-    return inString;
+    // Parse outside the lock; a concurrent parse of the same text just
+    // loses the insert race.
+    auto parsed = std::make_shared<const ParseResult>(parse(sql));
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    if (cache.size() >= kCacheCapacity && cache.find(sql) == cache.end()) {
+        cache.erase(cache.begin());   // Any victim: hot texts come straight back
+    }
+    return cache.emplace(sql, std::move(parsed)).first->second;
 }
 
-bool NamedParamParser::isInComment(const std::string& sql, size_t pos) {
-    bool inSingleLine = false;
-    bool inMultiLine = false;
-
-    for (size_t i = 0; i < pos && i < sql.size(); ++i) {
-        char ch = sql[i];
-        char nextCh = (i + 1 < sql.size()) ? sql[i + 1] : '\0';
+size_t NamedParamParser::listBucket(size_t count) noexcept {
+    size_t bucket = 1;
+    while (bucket < count) {
+        bucket <<= 1;
+    }
+    return bucket;
+}
 
-        // Skip strings
-        char quoteChar;
-        if (isInString(sql, i, quoteChar)) {
-            continue;
+std::string NamedParamParser::expandList(const std::string& sql, std::string_view name,
+                                         size_t count) {
+    // ":name__0, :name__1, ..." built once, pasted at every occurrence
+    std::string lowered(name);
+    for (char& ch : lowered) {
+        ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+    }
+    std::string placeholders;
+    const size_t bucket = listBucket(count);
+    for (size_t k = 0; k < bucket; ++k) {
+        if (k != 0) {
+            placeholders += ", ";
         }
+        placeholders += ':';
+        placeholders += lowered;
+        placeholders += kListElementSeparator;
+        char digits[24];
+        placeholders.append(digits, std::to_chars(digits, digits + sizeof(digits), k).ptr);
+    }
+    return replaceParam(sql, name, placeholders);
+}
 
-        if (!inSingleLine && !inMultiLine) {
-            if (ch == '-' && nextCh == '-') {
-                inSingleLine = true;
-                ++i;
-            } else if (ch == '/' && nextCh == '*') {
-                inMultiLine = true;
-                ++i;
+std::string NamedParamParser::replaceParam(const std::string& sql, std::string_view name,
+                                           std::string_view text) {
+    auto sameName = [&](size_t begin, size_t end) {
+        if (end - begin != name.size()) {
+            return false;
+        }
+        for (size_t k = 0; k < name.size(); ++k) {
+            if (std::tolower(static_cast<unsigned char>(sql[begin + k])) !=
+                std::tolower(static_cast<unsigned char>(name[k]))) {
+                return false;
             }
         }
-
-        if (inSingleLine && (ch == '\n' || ch == '\r')) {
-            inSingleLine = false;
+        return true;
+    };
+
+    std::string result;
+    result.reserve(sql.size() + text.size());
+    detail::SqlLexer lexer(sql);
+    detail::SqlLexer::Span span;
+    while (lexer.next(span)) {
+        if (span.kind != detail::SqlLexer::Kind::Code) {
+            result.append(sql, span.begin, span.end - span.begin);
+            continue;
         }
-
-        if (inMultiLine && ch == '*' && nextCh == '/') {
-            inMultiLine = false;
-            ++i;
+        size_t copied = span.begin;
+        for (size_t i = span.begin; i < span.end; ++i) {
+            const char ch = sql[i];
+            if ((ch != ':' && ch != '@') || i + 1 >= span.end || !isNameStart(sql[i + 1])) {
+                continue;
+            }
+            size_t nameEnd = i + 2;
+            while (nameEnd < span.end && isNameChar(sql[nameEnd])) {
+                nameEnd++;
+            }
+            if (sameName(i + 1, nameEnd)) {
+                result.append(sql, copied, i - copied);
+                result += text;
+                copied = nameEnd;
+            }
+            i = nameEnd - 1;
         }
+        result.append(sql, copied, span.end - copied);
     }
-
-    return inSingleLine || inMultiLine;
-}
-
-std::string NamedParamParser::extractParamName(const std::string& sql, size_t& pos) {
-    if (pos >= sql.size() || (sql[pos] != ':' && sql[pos] != '@')) {
-        return "";
-    }
-
-    size_t start = pos + 1;
-    size_t end = start;
-
-    // Parameter name must start with letter or underscore
-    if (start >= sql.size() || (!std::isalpha(sql[start]) && sql[start] != '_')) {
-        return "";
-    }
-
-    // Continue while we have alphanumeric or underscore
-    while (end < sql.size() && (std::isalnum(sql[end]) || sql[end] == '_')) {
-        ++end;
-    }
-
-    pos = end;
-    return sql.substr(start, end - start);
-}
-
-std::string NamedParamParser::toLower(const std::string& str) {
-    std::string result = str;
-    std::transform(result.begin(), result.end(), result.begin(),
-                   [](unsigned char c) { return std::tolower(c); });
     return result;
 }
 
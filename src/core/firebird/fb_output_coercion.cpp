@@ -0,0 +1,307 @@
+#include "fbpp/core/output_coercion.hpp"
+#include "fbpp/core/environment.hpp"
+#include "fbpp/core/exception.hpp"
+
+#include <cctype>
+
+namespace fbpp {
+namespace core {
+
+namespace {
+
+constexpr unsigned kAsciiCharSet = 2;   // CS_ASCII: digits, signs and zone names
+
+std::string upper(std::string_view text) {
+    std::string result(text);
+    for (char& c : result) {
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    return result;
+}
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+const char* targetName(CoerceTo target) {
+    switch (target) {
+        case CoerceTo::Native:    return "NATIVE";
+        case CoerceTo::Double:    return "DOUBLE";
+        case CoerceTo::BigInt:    return "BIGINT";
+        case CoerceTo::Varchar:   return "VARCHAR";
+        case CoerceTo::Timestamp: return "TIMESTAMP";
+    }
+    return "NATIVE";
+}
+
+CoerceTo parseTarget(std::string_view text) {
+    const std::string name = upper(trim(text));
+    for (CoerceTo target : {CoerceTo::Native, CoerceTo::Double, CoerceTo::BigInt,
+                            CoerceTo::Varchar, CoerceTo::Timestamp}) {
+        if (name == targetName(target)) {
+            return target;
+        }
+    }
+    throw FirebirdException("OutputCoercion: unknown target '" + std::string(text) + "'");
+}
+
+bool isScaledOrWide(const FieldInfo& field) {
+    switch (field.type) {
+        case SQL_SHORT:
+        case SQL_LONG:
+        case SQL_INT64:
+            return field.scale < 0;
+        case SQL_INT128:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool isDecFloat(unsigned type) {
+    return type == SQL_DEC16 || type == SQL_DEC34;
+}
+
+bool isTimeZone(unsigned type) {
+    return type == SQL_TIME_TZ || type == SQL_TIME_TZ_EX || type == SQL_TIMESTAMP_TZ ||
+           type == SQL_TIMESTAMP_TZ_EX;
+}
+
+// Longest text form of a value of `field`, in bytes
+unsigned textLength(const FieldInfo& field) {
+    switch (field.type) {
+        case SQL_TEXT:
+        case SQL_VARYING:
+            return field.length;
+        case SQL_INT128:   return 42;   // 39 digits, sign, point and a spare
+        case SQL_DEC16:    return 24;
+        case SQL_DEC34:    return 43;
+        case SQL_TIME_TZ:
+        case SQL_TIME_TZ_EX:
+        case SQL_TIMESTAMP_TZ:
+        case SQL_TIMESTAMP_TZ_EX:
+            return 64;     // Timestamp plus the longest region name
+        default:
+            return 32;
+    }
+}
+
+// Target of `field`: a column rule first, then the rule of its type class
+CoerceTo targetOf(const FieldInfo& field, const OutputCoercion& coercion) {
+    if (!coercion.columns.empty()) {
+        const auto it = coercion.columns.find(upper(displayName(field)));
+        if (it != coercion.columns.end()) {
+            return it->second;
+        }
+    }
+    if (isScaledOrWide(field)) {
+        return coercion.numerics;
+    }
+    if (isDecFloat(field.type)) {
+        return coercion.decfloats;
+    }
+    if (isTimeZone(field.type)) {
+        return coercion.timeZones;
+    }
+    return CoerceTo::Native;
+}
+
+[[noreturn]] void cannotCoerce(const FieldInfo& field, CoerceTo target) {
+    throw FirebirdException("OutputCoercion: column " + displayName(field) + " (type " +
+                            std::to_string(field.type) + ") cannot be coerced to " +
+                            targetName(target));
+}
+
+// Rewrite type, length, scale and character set; false when nothing changes
+bool coerceField(FieldInfo& field, const OutputCoercion& coercion) {
+    const CoerceTo target = targetOf(field, coercion);
+    if (target == CoerceTo::Native) {
+        return false;
+    }
+    if (field.type == SQL_BLOB || field.type == SQL_ARRAY || field.type == SQL_BOOLEAN) {
+        cannotCoerce(field, target);
+    }
+    const FieldInfo before = field;
+    switch (target) {
+        case CoerceTo::Native:
+            break;
+        case CoerceTo::Double:
+            field.type = SQL_DOUBLE;
+            field.length = sizeof(double);
+            field.scale = 0;
+            break;
+        case CoerceTo::BigInt:
+            field.type = SQL_INT64;
+            field.length = sizeof(int64_t);
+            if (isDecFloat(before.type)) {
+                field.scale = 0;
+            }
+            break;
+        case CoerceTo::Varchar:
+            if (before.type != SQL_TEXT && before.type != SQL_VARYING) {
+                field.charSet = kAsciiCharSet;
+            }
+            field.type = SQL_VARYING;
+            field.length = textLength(before);
+            field.scale = 0;
+            break;
+        case CoerceTo::Timestamp:
+            if (before.type == SQL_TIME_TZ || before.type == SQL_TIME_TZ_EX) {
+                field.type = SQL_TYPE_TIME;
+                field.length = sizeof(ISC_TIME);
+            } else if (before.type == SQL_TIMESTAMP_TZ || before.type == SQL_TIMESTAMP_TZ_EX ||
+                       before.type == SQL_TYPE_DATE) {
+                field.type = SQL_TIMESTAMP;
+                field.length = sizeof(ISC_TIMESTAMP);
+            } else if (before.type != SQL_TIMESTAMP && before.type != SQL_TYPE_TIME) {
+                cannotCoerce(field, target);
+            }
+            field.scale = 0;
+            break;
+    }
+    if (field.type != SQL_TEXT && field.type != SQL_VARYING) {
+        field.subType = 0;
+        field.charSet = 0;
+    }
+    return field.type != before.type || field.length != before.length ||
+           field.scale != before.scale || field.charSet != before.charSet;
+}
+
+} // namespace
+
+bool OutputCoercion::empty() const noexcept {
+    if (numerics != CoerceTo::Native || decfloats != CoerceTo::Native ||
+        timeZones != CoerceTo::Native) {
+        return false;
+    }
+    for (const auto& [name, target] : columns) {
+        if (target != CoerceTo::Native) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string OutputCoercion::toString() const {
+    if (empty()) {
+        return {};
+    }
+    std::string text;
+    auto add = [&](const std::string& key, CoerceTo target) {
+        if (!text.empty()) {
+            text += ';';
+        }
+        text += key + '=' + targetName(target);
+    };
+    if (numerics != CoerceTo::Native) {
+        add("NUMERIC", numerics);
+    }
+    if (decfloats != CoerceTo::Native) {
+        add("DECFLOAT", decfloats);
+    }
+    if (timeZones != CoerceTo::Native) {
+        add("TIMEZONE", timeZones);
+    }
+    for (const auto& [name, target] : columns) {
+        add("column:" + name, target);
+    }
+    return text;
+}
+
+OutputCoercion OutputCoercion::parse(std::string_view spec) {
+    OutputCoercion coercion;
+    while (!spec.empty()) {
+        const size_t end = spec.find_first_of(";,");
+        const std::string_view rule = trim(spec.substr(0, end));
+        spec = end == std::string_view::npos ? std::string_view{} : spec.substr(end + 1);
+        if (rule.empty()) {
+            continue;
+        }
+        const size_t eq = rule.find('=');
+        if (eq == std::string_view::npos) {
+            throw FirebirdException("OutputCoercion: expected KEY=TARGET in '" +
+                                    std::string(rule) + "'");
+        }
+        const std::string_view key = trim(rule.substr(0, eq));
+        const CoerceTo target = parseTarget(rule.substr(eq + 1));
+        const std::string name = upper(key);
+        if (name == "NUMERIC") {
+            coercion.numerics = target;
+        } else if (name == "DECFLOAT") {
+            coercion.decfloats = target;
+        } else if (name == "TIMEZONE") {
+            coercion.timeZones = target;
+        } else if (name.compare(0, 7, "COLUMN:") == 0 && trim(key.substr(7)).size() > 0) {
+            coercion.columns[upper(trim(key.substr(7)))] = target;
+        } else {
+            throw FirebirdException("OutputCoercion: unknown key '" + std::string(key) + "'");
+        }
+    }
+    return coercion;
+}
+
+std::shared_ptr<const MessageMetadata> coerceOutput(const std::vector<FieldInfo>& fields,
+                                                    const OutputCoercion& coercion) {
+    if (coercion.empty()) {
+        return nullptr;
+    }
+    std::vector<FieldInfo> coerced = fields;
+    bool changed = false;
+    for (auto& field : coerced) {
+        changed = coerceField(field, coercion) || changed;
+    }
+    if (!changed) {
+        return nullptr;
+    }
+
+    auto& env = Environment::getInstance();
+    Firebird::IStatus* raw = env.acquireStatus();
+    Firebird::ThrowStatusWrapper st(raw);
+    Firebird::IMetadataBuilder* builder = nullptr;
+    Firebird::IMessageMetadata* metadata = nullptr;
+    try {
+        builder = env.getMaster()->getMetadataBuilder(&st, static_cast<unsigned>(coerced.size()));
+        for (unsigned i = 0; i < coerced.size(); ++i) {
+            const FieldInfo& field = coerced[i];
+            builder->setType(&st, i, field.type | (field.nullable ? 1u : 0u));
+            builder->setSubType(&st, i, static_cast<int>(field.subType));
+            builder->setLength(&st, i, field.length);
+            builder->setScale(&st, i, field.scale);
+            builder->setCharSet(&st, i, field.charSet);
+            builder->setField(&st, i, field.name.c_str());
+            builder->setRelation(&st, i, field.relation.c_str());
+            builder->setOwner(&st, i, field.owner.c_str());
+            builder->setAlias(&st, i, field.alias.c_str());
+        }
+        metadata = builder->getMetadata(&st);
+        builder->release();
+    } catch (const Firebird::FbException& e) {
+        if (builder) {
+            builder->release();
+        }
+        env.releaseStatus(raw);
+        throw FirebirdException(e);
+    }
+    env.releaseStatus(raw);
+    if (!metadata) {
+        throw FirebirdException("OutputCoercion: metadata builder returned no format");
+    }
+    return std::make_shared<MessageMetadata>(metadata);
+}
+
+std::shared_ptr<const MessageMetadata> coerceOutput(const MessageMetadata& native,
+                                                    const OutputCoercion& coercion) {
+    if (coercion.empty()) {
+        return nullptr;
+    }
+    return coerceOutput(native.getFields(), coercion);
+}
+
+} // namespace core
+} // namespace fbpp
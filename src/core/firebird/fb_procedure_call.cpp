@@ -0,0 +1,93 @@
+#include "fbpp/core/procedure_call.hpp"
+
+#include <string>
+#include <utility>
+
+namespace fbpp {
+namespace core {
+
+std::string renderProcedureCallSql(const ProcedureInfo& info, unsigned inputCount) {
+    // Quote identifiers so case-sensitive procedure names round-trip.
+    auto quote = [](const std::string& id) {
+        return "\"" + id + "\"";
+    };
+    std::string qualified;
+    if (!info.packageName.empty()) {
+        qualified = quote(info.packageName) + "." + quote(info.name);
+    } else {
+        qualified = quote(info.name);
+    }
+
+    std::string args;
+    if (inputCount > 0) {
+        args = "(";
+        for (unsigned i = 0; i < inputCount; ++i) {
+            if (i > 0) args += ',';
+            args += '?';
+        }
+        args += ")";
+    }
+
+    if (info.kind == ProcedureKind::Selectable) {
+        return "SELECT * FROM " + qualified + args;
+    }
+    return "EXECUTE PROCEDURE " + qualified + args;
+}
+
+ProcedureCall::ProcedureCall(Connection& connection, const std::string& name,
+                             const std::string& packageName)
+    : ProcedureCall(connection, connection.describeProcedure(name, packageName)) {}
+
+ProcedureCall::ProcedureCall(Connection& connection, ProcedureInfo info)
+    : info_(std::move(info)) {
+    for (const auto& param : info_.params) {
+        ++(param.direction == ParamDirection::Input ? inputCount_ : outputCount_);
+    }
+    sql_ = renderProcedureCallSql(info_, inputCount_);
+    statement_ = connection.prepareStatementUncached(sql_);
+
+    inputMetadata_ = statement_->getInputMetadata();
+    outputMetadata_ = statement_->getOutputMetadata();
+    const unsigned inputs = inputMetadata_ ? inputMetadata_->getCount() : 0;
+    const unsigned outputs = outputMetadata_ ? outputMetadata_->getCount() : 0;
+    if (inputs != inputCount_ || outputs != outputCount_) {
+        // The ProcedureInfo came from an earlier schema (e.g. a stale cache)
+        throw FirebirdException(
+            "ProcedureCall: " + qualifiedName() + " has " + std::to_string(inputs) + " input / " +
+            std::to_string(outputs) + " output parameters, ProcedureInfo lists " +
+            std::to_string(inputCount_) + " / " + std::to_string(outputCount_));
+    }
+
+    if (inputMetadata_) {
+        inBuffer_.resize(inputMetadata_->getMessageLength());
+    }
+    if (outputMetadata_ && info_.kind != ProcedureKind::Selectable) {
+        outBuffer_.resize(outputMetadata_->getMessageLength());
+    }
+}
+
+void ProcedureCall::executePacked(Transaction& transaction) {
+    const bool hasOutput = !outBuffer_.empty();
+    statement_->execute(&transaction,
+                        inputMetadata_ ? inputMetadata_->getRawMetadata() : nullptr,
+                        inputMetadata_ ? inBuffer_.data() : nullptr,
+                        hasOutput ? outputMetadata_->getRawMetadata() : nullptr,
+                        hasOutput ? outBuffer_.data() : nullptr,
+                        false);
+}
+
+void ProcedureCall::requireKind(ProcedureKind kind) const {
+    const bool selectable = info_.kind == ProcedureKind::Selectable;
+    if (selectable != (kind == ProcedureKind::Selectable)) {
+        throw FirebirdException(
+            "Procedure " + qualifiedName() +
+            (selectable ? " is selectable: use open()" : " is executable: use call() / execute()"));
+    }
+}
+
+std::string ProcedureCall::qualifiedName() const {
+    return info_.packageName.empty() ? info_.name : info_.packageName + "." + info_.name;
+}
+
+} // namespace core
+} // namespace fbpp
@@ -0,0 +1,131 @@
+#include "fbpp/core/query_coalescer.hpp"
+#include "fbpp/core/exception.hpp"
+
+#include <sstream>
+#include <utility>
+
+namespace fbpp::core {
+
+namespace {
+
+// FNV-1a over the input message, folded into the SQL hash
+std::uint64_t keyHash(const SqlKey& key, const std::vector<uint8_t>& input) {
+    std::uint64_t h = 14695981039346656037ull;
+    for (uint8_t byte : input) {
+        h = (h ^ byte) * 1099511628211ull;
+    }
+    return key.hash() ^ (h + 0x9e3779b97f4a7c15ull + (key.hash() << 6) + (key.hash() >> 2));
+}
+
+} // namespace
+
+QueryCoalescer::QueryCoalescer(QueryCoalescerOptions options) : options_(std::move(options)) {}
+
+std::shared_ptr<const ResultSnapshot> QueryCoalescer::query(Connection& connection,
+                                                            Transaction& transaction,
+                                                            const std::string& sql) {
+    SqlKey key(sql);
+    return run(key, {}, [&] {
+        return transaction.openCursor(connection.prepareStatement(key));
+    });
+}
+
+std::shared_ptr<const ResultSnapshot> QueryCoalescer::run(const SqlKey& key,
+                                                          std::vector<uint8_t> input,
+                                                          const OpenCursor& open) {
+    const std::uint64_t hash = keyHash(key, input);
+    std::shared_ptr<Flight> flight;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto [first, last] = flights_.equal_range(hash);
+        for (auto it = first; it != last; ++it) {
+            if (it->second->input == input && SqlKey::equivalent(it->second->sql, key.sql())) {
+                flight = it->second;
+                break;
+            }
+        }
+        if (flight) {
+            // Join: wait for the leader, then share its result or its error
+            auto done = [&] { return flight->done; };
+            ++stats_.waiting;
+            if (options_.maxWait.count() > 0) {
+                if (!finished_.wait_for(lock, options_.maxWait, done)) {
+                    --stats_.waiting;
+                    ++stats_.waitTimeouts;
+                    lock.unlock();
+                    return capture(open);   // On its own, outside the flight
+                }
+            } else {
+                finished_.wait(lock, done);
+            }
+            --stats_.waiting;
+            ++stats_.joined;
+            if (flight->error) {
+                std::rethrow_exception(flight->error);
+            }
+            return flight->result;
+        }
+
+        flight = std::make_shared<Flight>();
+        flight->sql = key.sql();
+        flight->input = std::move(input);
+        flights_.emplace(hash, flight);
+        ++stats_.runs;
+        ++stats_.inFlight;
+    }
+
+    // Lead: run outside the lock, then hand the outcome to the joiners
+    std::shared_ptr<const ResultSnapshot> result;
+    std::exception_ptr error;
+    try {
+        result = capture(open);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto [first, last] = flights_.equal_range(hash);
+        for (auto it = first; it != last; ++it) {
+            if (it->second == flight) {
+                flights_.erase(it);
+                break;
+            }
+        }
+        flight->done = true;
+        flight->result = result;
+        flight->error = error;
+        --stats_.inFlight;
+        if (error) {
+            ++stats_.failures;
+        }
+    }
+    finished_.notify_all();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return result;
+}
+
+std::shared_ptr<const ResultSnapshot> QueryCoalescer::capture(const OpenCursor& open) const {
+    std::unique_ptr<ResultSet> cursor = open();
+    const MessageMetadata* metadata = cursor->getMetadata();
+    if (!metadata) {
+        throw FirebirdException("QueryCoalescer: statement returns no rows");
+    }
+    std::ostringstream out;
+    ResultSnapshotWriter writer(out, *metadata, options_.snapshot);
+    cursor->writeSnapshot(writer);
+    writer.finish();
+    cursor->close();
+
+    const std::string bytes = out.str();
+    return std::make_shared<const ResultSnapshot>(
+        ResultSnapshot::fromBytes(std::vector<uint8_t>(bytes.begin(), bytes.end())));
+}
+
+QueryCoalescerStats QueryCoalescer::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+} // namespace fbpp::core
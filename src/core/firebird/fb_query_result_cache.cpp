@@ -0,0 +1,203 @@
+#include "fbpp/core/query_result_cache.hpp"
+#include "fbpp/core/exception.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+namespace fbpp::core {
+
+namespace {
+
+std::string upperTrim(std::string_view text) {
+    std::size_t b = 0;
+    std::size_t e = text.size();
+    while (b < e && std::isspace(static_cast<unsigned char>(text[b]))) ++b;
+    while (e > b && std::isspace(static_cast<unsigned char>(text[e - 1]))) --e;
+    std::string out;
+    out.reserve(e - b);
+    for (std::size_t i = b; i < e; ++i) {
+        out.push_back(static_cast<char>(std::toupper(static_cast<unsigned char>(text[i]))));
+    }
+    return out;
+}
+
+// FNV-1a over the input message, folded into the SQL hash
+std::uint64_t keyHash(const SqlKey& key, const std::vector<uint8_t>& input) {
+    std::uint64_t h = 14695981039346656037ull;
+    for (uint8_t byte : input) {
+        h = (h ^ byte) * 1099511628211ull;
+    }
+    return key.hash() ^ (h + 0x9e3779b97f4a7c15ull + (key.hash() << 6) + (key.hash() >> 2));
+}
+
+} // namespace
+
+QueryResultCache::QueryResultCache(QueryResultCacheOptions options)
+    : options_(std::move(options)) {}
+
+std::shared_ptr<const ResultSnapshot> QueryResultCache::query(Connection& connection,
+                                                              Transaction& transaction,
+                                                              const std::string& sql,
+                                                              const QueryCacheHints& hints) {
+    SqlKey key(sql);
+    return lookup(key, {}, hints, [&] {
+        return transaction.openCursor(connection.prepareStatement(key));
+    });
+}
+
+std::shared_ptr<const ResultSnapshot> QueryResultCache::lookup(const SqlKey& key,
+                                                               std::vector<uint8_t> input,
+                                                               const QueryCacheHints& hints,
+                                                               const OpenCursor& open) {
+    const std::uint64_t hash = keyHash(key, input);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = find(hash, key.sql(), input);
+        if (it != entries_.end()) {
+            if (!it->expires || Clock::now() < *it->expires) {
+                entries_.splice(entries_.begin(), entries_, it);
+                ++stats_.hits;
+                return it->snapshot;
+            }
+            ++stats_.expirations;
+            erase(it);
+        }
+        ++stats_.misses;
+    }
+
+    // Miss: run the query and keep its raw messages
+    std::unique_ptr<ResultSet> cursor = open();
+    const MessageMetadata* metadata = cursor->getMetadata();
+    if (!metadata) {
+        throw FirebirdException("QueryResultCache: statement returns no rows");
+    }
+    std::ostringstream out;
+    ResultSnapshotWriter writer(out, *metadata, options_.snapshot);
+    cursor->writeSnapshot(writer);
+    writer.finish();
+
+    Entry entry;
+    for (const auto& column : metadata->getColumnPlan()) {
+        if (!column.field->relation.empty()) {
+            entry.tables.push_back(upperTrim(column.field->relation));
+        }
+    }
+    cursor->close();
+
+    const std::string bytes = out.str();
+    auto snapshot = std::make_shared<const ResultSnapshot>(
+        ResultSnapshot::fromBytes(std::vector<uint8_t>(bytes.begin(), bytes.end())));
+    if (bytes.size() > options_.maxEntryBytes || bytes.size() > options_.maxBytes) {
+        return snapshot;
+    }
+
+    for (const auto& table : hints.tables) {
+        entry.tables.push_back(upperTrim(table));
+    }
+    std::sort(entry.tables.begin(), entry.tables.end());
+    entry.tables.erase(std::unique(entry.tables.begin(), entry.tables.end()), entry.tables.end());
+
+    const auto ttl = hints.ttl.value_or(options_.ttl);
+    entry.hash = hash;
+    entry.sql = key.sql();
+    entry.input = std::move(input);
+    entry.snapshot = snapshot;
+    entry.bytes = bytes.size();
+    if (ttl.count() > 0) {
+        entry.expires = Clock::now() + ttl;
+    }
+    store(std::move(entry));
+    return snapshot;
+}
+
+std::size_t QueryResultCache::invalidateTable(std::string_view table) {
+    const std::string name = upperTrim(table);
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::size_t dropped = 0;
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        auto next = std::next(it);
+        if (std::binary_search(it->tables.begin(), it->tables.end(), name)) {
+            erase(it);
+            ++dropped;
+        }
+        it = next;
+    }
+    stats_.invalidations += dropped;
+    return dropped;
+}
+
+std::unique_ptr<EventSubscription> QueryResultCache::invalidateOnEvents(Connection& connection,
+                                                                        const std::vector<std::string>& tables,
+                                                                        std::string_view prefix) {
+    std::vector<std::string> names;
+    names.reserve(tables.size());
+    for (const auto& table : tables) {
+        names.push_back(std::string(prefix) + upperTrim(table));
+    }
+    const std::size_t skip = prefix.size();
+    return connection.subscribeEventBatches(std::move(names),
+        [this, skip](const std::vector<EventNotification>& events) {
+            for (const auto& event : events) {
+                invalidateTable(std::string_view(event.name).substr(skip));
+            }
+        });
+}
+
+void QueryResultCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.invalidations += entries_.size();
+    entries_.clear();
+    index_.clear();
+    stats_.entries = 0;
+    stats_.bytes = 0;
+}
+
+QueryResultCacheStats QueryResultCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+QueryResultCache::EntryList::iterator QueryResultCache::find(std::uint64_t hash, std::string_view sql,
+                                                             const std::vector<uint8_t>& input) {
+    auto [first, last] = index_.equal_range(hash);
+    for (auto it = first; it != last; ++it) {
+        const Entry& entry = *it->second;
+        if (entry.input == input && SqlKey::equivalent(entry.sql, sql)) {
+            return it->second;
+        }
+    }
+    return entries_.end();
+}
+
+void QueryResultCache::erase(EntryList::iterator it) {
+    auto [first, last] = index_.equal_range(it->hash);
+    for (auto pos = first; pos != last; ++pos) {
+        if (pos->second == it) {
+            index_.erase(pos);
+            break;
+        }
+    }
+    stats_.bytes -= it->bytes;
+    --stats_.entries;
+    entries_.erase(it);
+}
+
+void QueryResultCache::store(Entry entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto existing = find(entry.hash, entry.sql, entry.input);
+    if (existing != entries_.end()) {
+        erase(existing);   // A concurrent miss stored it first
+    }
+    while (!entries_.empty() && stats_.bytes + entry.bytes > options_.maxBytes) {
+        erase(std::prev(entries_.end()));
+        ++stats_.evictions;
+    }
+    stats_.bytes += entry.bytes;
+    ++stats_.entries;
+    const std::uint64_t hash = entry.hash;
+    entries_.push_front(std::move(entry));
+    index_.emplace(hash, entries_.begin());
+}
+
+} // namespace fbpp::core
@@ -0,0 +1,157 @@
+#include "fbpp/core/result_arena.hpp"
+
+#include "fbpp/core/exception.hpp"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <filesystem>
+#include <utility>
+
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace fbpp {
+namespace core {
+
+#ifndef _WIN32
+// Unlinked temporary file whose pieces back the spilled blocks
+class ResultArena::SpillFile {
+public:
+    explicit SpillFile(const std::string& directory) {
+        std::string path = (directory.empty() ? std::filesystem::temp_directory_path().string()
+                                              : directory) +
+                           "/fbpp-arena-XXXXXX";
+        fd_ = ::mkstemp(path.data());
+        if (fd_ < 0) {
+            throw FirebirdException("ResultArena: cannot create spill file in " + path + ": " +
+                                    std::strerror(errno));
+        }
+        ::unlink(path.c_str());   // Gone with the last descriptor
+        pageSize_ = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    }
+
+    ~SpillFile() {
+        for (const auto& [data, size] : maps_) {
+            ::munmap(data, size);
+        }
+        ::close(fd_);
+    }
+
+    SpillFile(const SpillFile&) = delete;
+    SpillFile& operator=(const SpillFile&) = delete;
+
+    /// Map `size` more bytes of the file; the blocks mapped before are
+    /// filled and leave the resident set (their pages stay in the file)
+    std::uint8_t* map(std::size_t size) {
+        for (; released_ < maps_.size(); ++released_) {
+            auto [data, length] = maps_[released_];
+            ::msync(data, length, MS_ASYNC);
+            ::madvise(data, length, MADV_DONTNEED);
+        }
+        const std::size_t length = (size + pageSize_ - 1) / pageSize_ * pageSize_;
+        if (::ftruncate(fd_, static_cast<off_t>(fileSize_ + length)) != 0) {
+            throw FirebirdException(std::string("ResultArena: cannot grow spill file: ") +
+                                    std::strerror(errno));
+        }
+        void* data = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd_,
+                            static_cast<off_t>(fileSize_));
+        if (data == MAP_FAILED) {
+            throw FirebirdException(std::string("ResultArena: cannot map spill file: ") +
+                                    std::strerror(errno));
+        }
+        fileSize_ += length;
+        maps_.emplace_back(data, length);
+        return static_cast<std::uint8_t*>(data);
+    }
+
+private:
+    int fd_ = -1;
+    std::size_t pageSize_ = 4096;
+    std::size_t fileSize_ = 0;
+    std::vector<std::pair<void*, std::size_t>> maps_;
+    std::size_t released_ = 0;   // maps_[0, released_) are out of the resident set
+};
+#else
+class ResultArena::SpillFile {};   // No spilling on Windows
+#endif
+
+ResultArena::ResultArena(std::size_t blockSize)
+    : nextBlockSize_(std::max<std::size_t>(blockSize, 256)) {
+}
+
+ResultArena::~ResultArena() = default;
+ResultArena::ResultArena(ResultArena&&) noexcept = default;
+ResultArena& ResultArena::operator=(ResultArena&&) noexcept = default;
+
+void ResultArena::spillTo(std::size_t memoryBudget, std::string directory) {
+#ifndef _WIN32
+    memoryBudget_ = memoryBudget;
+    spillDirectory_ = std::move(directory);
+#else
+    (void)memoryBudget;
+    (void)directory;
+#endif
+}
+
+void* ResultArena::allocateSlow(std::size_t bytes, std::size_t alignment) {
+    // new[] only guarantees the default new alignment; pad for stricter ones
+    const std::size_t needed = bytes + (alignment > alignof(std::max_align_t) ? alignment : 0);
+    const bool dedicated = needed > nextBlockSize_;
+    const std::size_t size = dedicated ? needed : nextBlockSize_;
+
+    std::uint8_t* data = nullptr;
+#ifndef _WIN32
+    if (memoryBudget_ != 0 && bytesReserved_ - bytesSpilled_ + size > memoryBudget_) {
+        if (!spill_) {
+            spill_ = std::make_unique<SpillFile>(spillDirectory_);
+        }
+        data = spill_->map(size);
+        bytesSpilled_ += size;
+    }
+#endif
+    if (!data) {
+        // Not make_unique: its value-initialization would zero the whole block
+        blocks_.push_back(Block{std::unique_ptr<std::uint8_t[]>(new std::uint8_t[size]), size});
+        data = blocks_.back().data.get();
+    }
+    bytesReserved_ += size;
+    bytesUsed_ += bytes;
+    memory_.set(bytesReserved_ - bytesSpilled_);
+
+    auto* at = reinterpret_cast<std::uint8_t*>(alignUp(data, alignment));
+    if (dedicated) {
+        // The big allocation stands alone; keep filling the current block
+        return at;
+    }
+    cursor_ = at + bytes;
+    end_ = data + size;
+    nextBlockSize_ = std::max(nextBlockSize_, std::min(nextBlockSize_ * 2, kMaxBlockSize));
+    return at;
+}
+
+void ResultArena::clear() noexcept {
+    bytesUsed_ = 0;
+    if (spill_) {
+        spill_.reset();   // Spilled blocks are never the one kept
+        bytesReserved_ -= bytesSpilled_;
+        bytesSpilled_ = 0;
+        cursor_ = end_ = nullptr;
+        memory_.set(bytesReserved_);
+    }
+    if (blocks_.empty()) {
+        return;
+    }
+    auto largest = std::max_element(blocks_.begin(), blocks_.end(),
+                                    [](const Block& a, const Block& b) { return a.size < b.size; });
+    Block keep = std::move(*largest);
+    blocks_.clear();
+    cursor_ = keep.data.get();
+    end_ = cursor_ + keep.size;
+    bytesReserved_ = keep.size;
+    blocks_.push_back(std::move(keep));
+    memory_.set(bytesReserved_);
+}
+
+} // namespace core
+} // namespace fbpp
@@ -1,19 +1,31 @@
 #include "fbpp/core/result_set.hpp"
+#include "fbpp/core/connection.hpp"
 #include "fbpp/core/transaction.hpp"
+#include "fbpp/core/deadline.hpp"
 #include "fbpp/core/environment.hpp"
 #include "fbpp/core/exception.hpp"
+#include "fbpp/core/json_stream_writer.hpp"
+#include "fbpp/core/json_nest_writer.hpp"
+#include "fbpp/core/csv_stream_writer.hpp"
+#include "fbpp/core/result_snapshot.hpp"
+#include "fbpp/core/statement_metrics.hpp"
+#include "fbpp/core/span_observer.hpp"
+#include "fbpp/core/slow_query_log.hpp"
+#include "fbpp/core/detail/deferred_release.hpp"
+#include "fbpp/core/detail/fetch_buffers.hpp"
+#include <chrono>
 #include <cstring>
 
 namespace fbpp {
 namespace core {
 
 ResultSet::ResultSet(Firebird::IResultSet* resultSet,
-                    std::unique_ptr<MessageMetadata> metadata)
+                    std::shared_ptr<const MessageMetadata> metadata)
     : env_(Environment::getInstance()),
       resultSet_(resultSet),
       metadata_(std::move(metadata)),
       transaction_(),  // No owning transaction (caller manages lifetimes)
-      status_(env_.getMaster()->getStatus()),
+      status_(env_.acquireStatus()),
       statusWrapper_(status_) {
     if (!resultSet_) {
         throw FirebirdException("Invalid result set pointer");
@@ -21,16 +33,19 @@ ResultSet::ResultSet(Firebird::IResultSet* resultSet,
     if (!metadata_) {
         throw FirebirdException("Invalid metadata for result set");
     }
+    // Build the column plan while the cursor opens so the per-row unpack
+    // paths only read the immutable cache.
+    metadata_->getColumnPlan();
 }
 
 ResultSet::ResultSet(Firebird::IResultSet* resultSet,
-                    std::unique_ptr<MessageMetadata> metadata,
+                    std::shared_ptr<const MessageMetadata> metadata,
                     std::shared_ptr<Transaction> transaction)
     : env_(Environment::getInstance()),
       resultSet_(resultSet),
       metadata_(std::move(metadata)),
       transaction_(std::move(transaction)),
-      status_(env_.getMaster()->getStatus()),
+      status_(env_.acquireStatus()),
       statusWrapper_(status_) {
     if (!resultSet_) {
         throw FirebirdException("Invalid result set pointer");
@@ -38,6 +53,9 @@ ResultSet::ResultSet(Firebird::IResultSet* resultSet,
     if (!metadata_) {
         throw FirebirdException("Invalid metadata for result set");
     }
+    // Build the column plan while the cursor opens so the per-row unpack
+    // paths only read the immutable cache.
+    metadata_->getColumnPlan();
 }
 
 ResultSet::ResultSet(ResultSet&& other) noexcept
@@ -46,12 +64,35 @@ ResultSet::ResultSet(ResultSet&& other) noexcept
       metadata_(std::move(other.metadata_)),
       transaction_(std::move(other.transaction_)),
       statement_(std::move(other.statement_)),
-      status_(env_.getMaster()->getStatus()),
+      metrics_(std::move(other.metrics_)),
+      serverBaseline_(std::move(other.serverBaseline_)),
+      spanObserver_(other.spanObserver_),
+      span_(other.span_),
+      spanRows_(other.spanRows_),
+      rowLimit_(other.rowLimit_),
+      slowQuery_(std::move(other.slowQuery_)),
+      status_(env_.acquireStatus()),
       statusWrapper_(status_),
       eof_(other.eof_),
       buffer_(std::move(other.buffer_)),
-      generation_(other.generation_) {
+      generation_(other.generation_),
+      prefetch_(other.prefetch_),
+      window_(std::move(other.window_)),
+      windowStride_(other.windowStride_),
+      windowCount_(other.windowCount_),
+      windowPos_(other.windowPos_),
+      windowDrained_(other.windowDrained_),
+      recycler_(std::move(other.recycler_)),
+      arena_(std::move(other.arena_)),
+      rowOwnership_(other.rowOwnership_),
+      memoryAccount_(std::move(other.memoryAccount_)),
+      memory_(std::move(other.memory_)) {
+    chargeBuffers();   // The staging block stays with `other`
     other.resultSet_ = nullptr;
+    other.windowCount_ = 0;
+    other.windowPos_ = 0;
+    other.spanObserver_ = nullptr;
+    other.span_ = nullptr;
 }
 
 ResultSet& ResultSet::operator=(ResultSet&& other) noexcept {
@@ -61,21 +102,95 @@ ResultSet& ResultSet::operator=(ResultSet&& other) noexcept {
         metadata_ = std::move(other.metadata_);
         transaction_ = std::move(other.transaction_);
         statement_ = std::move(other.statement_);
+        metrics_ = std::move(other.metrics_);
+        serverBaseline_ = std::move(other.serverBaseline_);
+        spanObserver_ = other.spanObserver_;
+        span_ = other.span_;
+        spanRows_ = other.spanRows_;
+        rowLimit_ = other.rowLimit_;
+        slowQuery_ = std::move(other.slowQuery_);
+        other.spanObserver_ = nullptr;
+        other.span_ = nullptr;
         eof_ = other.eof_;
         buffer_ = std::move(other.buffer_);
         generation_ = other.generation_;
+        prefetch_ = other.prefetch_;
+        window_ = std::move(other.window_);
+        windowStride_ = other.windowStride_;
+        windowCount_ = other.windowCount_;
+        windowPos_ = other.windowPos_;
+        windowDrained_ = other.windowDrained_;
+        recycler_ = std::move(other.recycler_);
+        arena_ = std::move(other.arena_);
+        rowOwnership_ = other.rowOwnership_;
+        memoryAccount_ = std::move(other.memoryAccount_);
+        memory_ = std::move(other.memory_);
+        chargeBuffers();   // Our buffers, not the moved-from one's
         other.resultSet_ = nullptr;
+        other.windowCount_ = 0;
+        other.windowPos_ = 0;
     }
     return *this;
 }
 
+void ResultSet::trackMemory(std::shared_ptr<detail::MemoryAccount> account) {
+    memoryAccount_ = std::move(account);
+    memory_.attach(memoryAccount_, detail::MemoryAccount::resultSets, 0);
+    chargeBuffers();
+    if (arena_ && memoryAccount_) {
+        arena_->trackIn(memoryAccount_);
+    }
+}
+
+void ResultSet::recycleBuffers(std::shared_ptr<detail::FetchBufferStash> stash) {
+    recycler_ = std::move(stash);
+    if (!recycler_) {
+        return;
+    }
+    auto buffers = recycler_->take();
+    buffer_ = std::move(buffers.row);
+    window_ = std::move(buffers.window);
+    columnStage_ = std::move(buffers.columns);
+    chargeBuffers();
+}
+
+void ResultSet::returnBuffers() noexcept {
+    if (auto stash = std::move(recycler_)) {
+        detail::FetchBuffers buffers{std::move(buffer_), std::move(window_),
+                                     std::move(columnStage_)};
+        stash->put(buffers);
+        buffer_.clear();
+        window_.clear();
+        columnStage_.clear();
+        chargeBuffers();
+    }
+}
+
 ResultSet::~ResultSet() {
     cleanup();
-    statusWrapper_.dispose();
+    env_.releaseStatus(status_);
 }
 
 void ResultSet::cleanup() {
     if (resultSet_) {
+        // Dropped without close(): the queue closes it, holding the
+        // statement until then. Its server counters are not recorded.
+        if (auto queue = statement_ ? statement_->releaseQueue() : nullptr;
+            queue && queue->push(resultSet_, statement_)) {
+            resultSet_ = nullptr;
+            eof_ = true;
+            windowCount_ = 0;
+            windowPos_ = 0;
+            ++generation_;
+            returnBuffers();
+            finishSlowQuery(false);
+            statement_.reset();
+            transaction_.reset();
+            serverBaseline_.reset();
+            releaseMetrics();
+            endSpan(false);
+            return;
+        }
         try {
             close();
         } catch (...) {
@@ -91,11 +206,28 @@ int ResultSet::fetchNext(void* buffer) {
     if (eof_) {
         return RESULT_NO_DATA;
     }
+    if (const Deadline* deadline = Deadline::current()) {
+        deadline->check("fetch");
+    }
 
     try {
         auto& st = status();
 
-        int result = resultSet_->fetchNext(&st, buffer);
+        const auto started = metrics_ || slowQuery_ ? std::chrono::steady_clock::now()
+                                                    : std::chrono::steady_clock::time_point{};
+        int result = RESULT_NO_DATA;
+        {
+            detail::PhaseTimer wire(metrics_.get(), Phase::Wire);
+            result = resultSet_->fetchNext(&st, buffer);
+        }
+        if (metrics_) {
+            const bool ok = result == RESULT_OK;
+            metrics_->recordFetch(std::chrono::steady_clock::now() - started, ok ? 1 : 0,
+                                  ok ? metadata_->getMessageLength() : 0);
+        }
+        if (slowQuery_) {
+            slowQuery_->timings.fetch += std::chrono::steady_clock::now() - started;
+        }
 
         if (result == RESULT_NO_DATA) {
             eof_ = true;
@@ -110,6 +242,353 @@ int ResultSet::fetchNext(void* buffer) {
     }
 }
 
+void ResultSet::setPrefetch(unsigned rows) {
+    prefetch_ = rows == 0 ? 1 : rows;
+}
+
+const uint8_t* ResultSet::nextRow() {
+    if (rowLimit_ != 0 && spanRows_ >= rowLimit_) {
+        // Limit served: the rest of the result is never asked for
+        eof_ = true;
+        return nullptr;
+    }
+    // Buffered rows too: a request past its deadline stops consuming
+    if (const Deadline* deadline = Deadline::current()) {
+        deadline->check("fetch");
+    }
+    if (metrics_) {
+        // BLOBs of the row about to be served are read on its behalf
+        detail::BlobMetricsScope::set(metrics_);
+    }
+    // Serve buffered rows first, even if the window was shrunk meanwhile.
+    if (windowPos_ < windowCount_ || (prefetch_ > 1 && refillWindow() > 0)) {
+        const uint8_t* row = window_.data() +
+            static_cast<size_t>(windowPos_) * windowStride_;
+        ++windowPos_;
+        ++spanRows_;
+        // Each served row invalidates outstanding RowView snapshots, the
+        // same contract as in unbuffered mode.
+        ++generation_;
+        return row;
+    }
+    if (prefetch_ > 1 || windowDrained_) {
+        eof_ = true;
+        return nullptr;
+    }
+
+    if (buffer_.empty()) {
+        buffer_.resize(getBufferSize());
+        chargeBuffers();
+    }
+    if (fetchNext(buffer_.data()) != RESULT_OK) {
+        return nullptr;
+    }
+    ++spanRows_;
+    return buffer_.data();
+}
+
+bool ResultSet::fetchMessage(void* target) {
+    if (!isValid() || eof_) {
+        return false;
+    }
+    if (prefetch_ > 1 || windowPos_ < windowCount_ || windowDrained_ || rowLimit_ != 0) {
+        const uint8_t* row = nextRow();
+        if (!row) {
+            eof_ = true;
+            return false;
+        }
+        std::memcpy(target, row, metadata_->getMessageLength());
+        return true;
+    }
+    if (fetchNext(target) != RESULT_OK) {
+        return false;
+    }
+    ++spanRows_;
+    return true;
+}
+
+unsigned ResultSet::refillWindow() {
+    windowPos_ = 0;
+    windowCount_ = 0;
+    if (!resultSet_ || windowDrained_) {
+        return 0;
+    }
+
+    if (windowStride_ == 0) {
+        // Aligned length keeps every slot correctly aligned for the
+        // message's widest field, so slots can be laid out back to back.
+        windowStride_ = metadata_->getAlignedLength();
+    }
+    const size_t needed = static_cast<size_t>(prefetch_) * windowStride_;
+    if (window_.size() < needed) {
+        window_.resize(needed);
+        chargeBuffers();
+    }
+
+    // No more rows than the limit leaves (nextRow() stops at it)
+    unsigned wanted = prefetch_;
+    if (rowLimit_ != 0) {
+        const uint64_t left = spanRows_ < rowLimit_ ? rowLimit_ - spanRows_ : 0;
+        wanted = left < wanted ? static_cast<unsigned>(left) : wanted;
+    }
+
+    try {
+        auto& st = status();
+        const auto started = metrics_ || slowQuery_ ? std::chrono::steady_clock::now()
+                                                    : std::chrono::steady_clock::time_point{};
+        {
+            detail::PhaseTimer wire(metrics_.get(), Phase::Wire);   // The refill as one round
+            while (windowCount_ < wanted) {
+                uint8_t* slot = window_.data() +
+                    static_cast<size_t>(windowCount_) * windowStride_;
+                int result = resultSet_->fetchNext(&st, slot);
+                if (result != RESULT_OK) {
+                    windowDrained_ = true;
+                    break;
+                }
+                ++windowCount_;
+            }
+        }
+        if (metrics_) {
+            // A window refill is timed as one fetch round
+            metrics_->recordFetch(std::chrono::steady_clock::now() - started, windowCount_,
+                                  static_cast<uint64_t>(windowCount_) * metadata_->getMessageLength());
+        }
+        if (slowQuery_) {
+            slowQuery_->timings.fetch += std::chrono::steady_clock::now() - started;
+        }
+    } catch (const Firebird::FbException& e) {
+        throw FirebirdException(e);
+    }
+
+    return windowCount_;
+}
+
+std::size_t ResultSet::writeJson(JsonStreamWriter& writer, std::size_t maxRows) {
+    if (!resultSet_) {
+        throw FirebirdException("ResultSet::writeJson called on closed cursor");
+    }
+    std::size_t rows = 0;
+    while ((maxRows == 0 || rows < maxRows) && !eof_) {
+        const uint8_t* row = nextRow();
+        if (!row) {
+            eof_ = true;
+            break;
+        }
+        writer.writeRow(row, *metadata_, transaction_.get());
+        ++rows;
+    }
+    return rows;
+}
+
+std::size_t ResultSet::writeJson(JsonNestWriter& writer, std::size_t maxRows) {
+    if (!resultSet_) {
+        throw FirebirdException("ResultSet::writeJson called on closed cursor");
+    }
+    std::size_t rows = 0;
+    while ((maxRows == 0 || rows < maxRows) && !eof_) {
+        const uint8_t* row = nextRow();
+        if (!row) {
+            eof_ = true;
+            break;
+        }
+        writer.writeRow(row, *metadata_, transaction_.get());
+        ++rows;
+    }
+    return rows;
+}
+
+std::size_t ResultSet::writeCsv(CsvStreamWriter& writer, std::size_t maxRows) {
+    if (!resultSet_) {
+        throw FirebirdException("ResultSet::writeCsv called on closed cursor");
+    }
+    writer.writeHeader(*metadata_);
+    std::size_t rows = 0;
+    while ((maxRows == 0 || rows < maxRows) && !eof_) {
+        const uint8_t* row = nextRow();
+        if (!row) {
+            eof_ = true;
+            break;
+        }
+        writer.writeRow(row, *metadata_, transaction_.get());
+        ++rows;
+    }
+    return rows;
+}
+
+std::size_t ResultSet::writeSnapshot(ResultSnapshotWriter& writer, std::size_t maxRows) {
+    if (!resultSet_) {
+        throw FirebirdException("ResultSet::writeSnapshot called on closed cursor");
+    }
+    std::size_t rows = 0;
+    while ((maxRows == 0 || rows < maxRows) && !eof_) {
+        const uint8_t* row = nextRow();
+        if (!row) {
+            eof_ = true;
+            break;
+        }
+        writer.writeRow(row);
+        ++rows;
+    }
+    return rows;
+}
+
+bool ResultSet::fetchColumns(ColumnBatch& batch, std::size_t batchSize) {
+    if (!resultSet_) {
+        throw FirebirdException("ResultSet::fetchColumns called on closed cursor");
+    }
+    if (batchSize == 0) {
+        throw FirebirdException("ResultSet::fetchColumns: batchSize must be positive");
+    }
+    // No more rows than the limit leaves, as in refillWindow()
+    if (rowLimit_ != 0) {
+        const uint64_t left = spanRows_ < rowLimit_ ? rowLimit_ - spanRows_ : 0;
+        if (left < batchSize) {
+            batchSize = static_cast<std::size_t>(left);
+        }
+        if (batchSize == 0) {
+            eof_ = true;
+        }
+    }
+
+    const std::size_t stride = metadata_->getAlignedLength();
+    const std::size_t messageLength = metadata_->getMessageLength();
+    if (columnStage_.size() < batchSize * stride) {
+        columnStage_.resize(batchSize * stride);
+        chargeBuffers();
+    }
+
+    if (metrics_) {
+        detail::BlobMetricsScope::set(metrics_);
+    }
+    std::size_t rows = 0;
+    while (rows < batchSize) {
+        uint8_t* slot = columnStage_.data() + rows * stride;
+        if (windowPos_ < windowCount_) {
+            std::memcpy(slot,
+                        window_.data() + static_cast<size_t>(windowPos_) * windowStride_,
+                        messageLength);
+            ++windowPos_;
+            ++generation_;
+        } else if (eof_ || windowDrained_) {
+            eof_ = true;
+            break;
+        } else if (fetchNext(slot) != RESULT_OK) {
+            break;
+        }
+        ++rows;
+    }
+
+    spanRows_ += rows;
+    detail::SlowQueryTimer timer(unpackClock());
+    detail::decodeColumnBatch(*metadata_, columnStage_.data(), stride, rows,
+                              transaction_.get(), batch);
+    return rows > 0;
+}
+
+const uint8_t* ResultSet::scrollRow(ScrollMove move, int offset, uint8_t* buffer) {
+    if (!resultSet_) {
+        throw FirebirdException("ResultSet scroll called on closed cursor");
+    }
+    if (metrics_) {
+        detail::BlobMetricsScope::set(metrics_);
+    }
+
+    // The server cursor is ahead of the row last returned by the rows the
+    // window still holds, plus one when it already ran past the last row.
+    const int ahead = static_cast<int>(windowCount_ - windowPos_) +
+                      (windowDrained_ && !eof_ ? 1 : 0);
+    if (ahead > 0 && move == ScrollMove::prior) {
+        move = ScrollMove::relative;
+        offset = -1;
+    }
+    if (move == ScrollMove::relative) {
+        offset -= ahead;
+    }
+    windowPos_ = 0;
+    windowCount_ = 0;
+    windowDrained_ = false;
+    eof_ = false;
+
+    try {
+        auto& st = status();
+        const auto started = metrics_ || slowQuery_ ? std::chrono::steady_clock::now()
+                                                    : std::chrono::steady_clock::time_point{};
+        int result = RESULT_NO_DATA;
+        {
+            detail::PhaseTimer wire(metrics_.get(), Phase::Wire);
+            switch (move) {
+            case ScrollMove::first:
+                result = resultSet_->fetchFirst(&st, buffer);
+                break;
+            case ScrollMove::last:
+                result = resultSet_->fetchLast(&st, buffer);
+                break;
+            case ScrollMove::prior:
+                result = resultSet_->fetchPrior(&st, buffer);
+                break;
+            case ScrollMove::absolute:
+                result = resultSet_->fetchAbsolute(&st, offset, buffer);
+                break;
+            case ScrollMove::relative:
+                result = resultSet_->fetchRelative(&st, offset, buffer);
+                break;
+            }
+        }
+        const bool ok = result == RESULT_OK;
+        if (metrics_) {
+            metrics_->recordFetch(std::chrono::steady_clock::now() - started, ok ? 1 : 0,
+                                  ok ? metadata_->getMessageLength() : 0);
+        }
+        if (slowQuery_) {
+            slowQuery_->timings.fetch += std::chrono::steady_clock::now() - started;
+        }
+        if (!ok) {
+            return nullptr;
+        }
+        ++generation_;
+        ++spanRows_;
+        return buffer;
+    } catch (const Firebird::FbException& e) {
+        throw FirebirdException(e);
+    }
+}
+
+bool ResultSet::fetchPage(int position, std::size_t rows, ColumnBatch& batch) {
+    if (!resultSet_) {
+        throw FirebirdException("ResultSet::fetchPage called on closed cursor");
+    }
+    if (rows == 0) {
+        throw FirebirdException("ResultSet::fetchPage: rows must be positive");
+    }
+    // A page never holds more rows than the limit allows
+    if (rowLimit_ != 0 && rowLimit_ < rows) {
+        rows = static_cast<std::size_t>(rowLimit_);
+    }
+
+    const std::size_t stride = metadata_->getAlignedLength();
+    if (columnStage_.size() < rows * stride) {
+        columnStage_.resize(rows * stride);
+        chargeBuffers();
+    }
+
+    std::size_t count = 0;
+    if (scrollRow(ScrollMove::absolute, position, columnStage_.data())) {
+        count = 1;
+        while (count < rows && fetchNext(columnStage_.data() + count * stride) == RESULT_OK) {
+            ++count;
+        }
+    }
+
+    if (count > 1) {
+        spanRows_ += count - 1;
+    }
+    detail::SlowQueryTimer timer(unpackClock());
+    detail::decodeColumnBatch(*metadata_, columnStage_.data(), stride, count,
+                              transaction_.get(), batch);
+    return count > 0;
+}
+
 unsigned ResultSet::getBufferSize() const {
     if (!metadata_) {
         throw FirebirdException("Metadata is not available");
@@ -131,19 +610,78 @@ void ResultSet::close() {
             resultSet_ = nullptr;
             eof_ = true;
             ++generation_;
+            windowCount_ = 0;
+            windowPos_ = 0;
+            returnBuffers();
+            finishSlowQuery(true);
             statement_.reset();
             transaction_.reset();
+            serverBaseline_.reset();
+            releaseMetrics();
+            endSpan(true);
             throw FirebirdException(e);
         }
         resultSet_->release();
         resultSet_ = nullptr;
         eof_ = true;
+        windowCount_ = 0;
+        windowPos_ = 0;
         // Invalidate any outstanding RowView snapshots.
         ++generation_;
+        returnBuffers();
+        // Counters are read once the cursor is closed server-side
+        recordServerCounters();
+        finishSlowQuery(false);
         // Cursor is gone — stop keeping the producing statement and the
         // transaction alive on its behalf.
         statement_.reset();
         transaction_.reset();
+        releaseMetrics();
+        endSpan(false);
+    }
+}
+
+void ResultSet::endSpan(bool failed) noexcept {
+    if (spanObserver_) {
+        SpanEnd end;
+        end.rows = spanRows_;
+        end.failed = failed;
+        spanObserver_->endSpan(span_, end);
+        spanObserver_ = nullptr;
+        span_ = nullptr;
+    }
+}
+
+void ResultSet::finishSlowQuery(bool failed) noexcept {
+    if (auto probe = std::move(slowQuery_)) {
+        const Statement* statement = statement_ ? statement_.get() : probe->statement;
+        probe->log->report(SlowQueryKind::Cursor, probe->fingerprint, statement, probe->timings,
+                           spanRows_, failed, probe->inputLayout.get(),
+                           probe->input.empty() ? nullptr : probe->input.data());
+    }
+}
+
+void ResultSet::setServerCountersBaseline(ServerCounters before) {
+    serverBaseline_ = std::make_unique<ServerCounters>(std::move(before));
+}
+
+void ResultSet::recordServerCounters() noexcept {
+    auto baseline = std::move(serverBaseline_);
+    if (!baseline || !metrics_ || !transaction_ || !transaction_->getConnection()) {
+        return;
+    }
+    try {
+        const auto after = transaction_->getConnection()->getServerCounters();
+        metrics_->recordServerCounters(ServerCounters::delta(after, *baseline));
+    } catch (...) {
+        // Metrics only; never fail close() over them
+    }
+}
+
+void ResultSet::releaseMetrics() noexcept {
+    if (metrics_) {
+        detail::BlobMetricsScope::release(metrics_.get());
+        metrics_.reset();
     }
 }
 
@@ -154,15 +692,29 @@ std::optional<Row> ResultSet::fetchOne() {
     if (eof_) {
         return std::nullopt;
     }
-    if (buffer_.empty()) {
-        buffer_.resize(getBufferSize());
-    }
-    int result = fetchNext(buffer_.data());
-    if (result != RESULT_OK) {
+    const uint8_t* row = nextRow();
+    if (!row) {
         return std::nullopt;
     }
-    RowView view(metadata_, buffer_.data(), transaction_.get(), this, generation_);
-    return Row(view);
+    RowView view(metadata_, row, transaction_.get(), this, generation_);
+    return Row(view, arena_, rowOwnership_);
+}
+
+std::size_t ResultSet::fetchRows(std::vector<Row>& rows, std::size_t maxRows) {
+    if (!resultSet_) {
+        throw FirebirdException("ResultSet::fetchRows called on closed cursor");
+    }
+    std::size_t count = 0;
+    while (!eof_ && (maxRows == 0 || count < maxRows)) {
+        const uint8_t* row = nextRow();
+        if (!row) {
+            break;
+        }
+        RowView view(metadata_, row, transaction_.get(), this, generation_);
+        rows.emplace_back(view, arena_, rowOwnership_);
+        ++count;
+    }
+    return count;
 }
 
 ResultSet::RowsRange ResultSet::rows() {
@@ -184,17 +736,14 @@ void ResultSet::RowsRange::Iterator::advance() {
         end_ = true;
         return;
     }
-    if (rs_->buffer_.empty()) {
-        rs_->buffer_.resize(rs_->getBufferSize());
-    }
-    int result = rs_->fetchNext(rs_->buffer_.data());
-    if (result != RESULT_OK) {
+    const uint8_t* row = rs_->nextRow();
+    if (!row) {
         current_.reset();
         end_ = true;
         return;
     }
     current_.emplace(rs_->metadata_,
-                     rs_->buffer_.data(),
+                     row,
                      rs_->transaction_.get(),
                      rs_,
                      rs_->generation_);
@@ -0,0 +1,400 @@
+#include "fbpp/core/result_snapshot.hpp"
+#include "fbpp/core/environment.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/detail/mapped_file.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <ostream>
+
+#ifdef FBPP_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+#ifndef _WIN32
+#include <fcntl.h>
+#endif
+
+namespace fbpp::core {
+
+#ifdef _WIN32
+namespace detail {
+class MappedFile {};   // Snapshots are read into memory on Windows
+}
+#endif
+
+namespace {
+
+constexpr char kMagic[8] = {'F', 'B', 'P', 'P', 'S', 'N', 'A', 'P'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::size_t kAlign = 8;
+
+std::size_t alignUp(std::size_t n) {
+    return (n + kAlign - 1) & ~(kAlign - 1);
+}
+
+void putU32(std::string& out, std::uint32_t value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void putU64(std::string& out, std::uint64_t value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void putString(std::string& out, const std::string& text) {
+    putU32(out, static_cast<std::uint32_t>(text.size()));
+    out.append(text);
+}
+
+void pad(std::string& out) {
+    out.append(alignUp(out.size()) - out.size(), '\0');
+}
+
+[[noreturn]] void invalid(const std::string& what) {
+    throw FirebirdException("Invalid result snapshot: " + what);
+}
+
+// Bounds-checked little cursor over the snapshot bytes
+struct Reader {
+    const uint8_t* data;
+    std::size_t size;
+    std::size_t pos = 0;
+
+    const uint8_t* take(std::size_t n, const char* what) {
+        if (n > size - pos) {
+            invalid(std::string("truncated ") + what);
+        }
+        const uint8_t* p = data + pos;
+        pos += n;
+        return p;
+    }
+
+    template<typename T>
+    T get(const char* what) {
+        T value;
+        std::memcpy(&value, take(sizeof(T), what), sizeof(T));
+        return value;
+    }
+
+    std::string string(const char* what) {
+        const auto length = get<std::uint32_t>(what);
+        const auto* p = take(length, what);
+        return std::string(reinterpret_cast<const char*>(p), length);
+    }
+
+    void align() {
+        pos = std::min(alignUp(pos), size);
+    }
+};
+
+bool compressionSupported(SnapshotCompression compression) {
+    switch (compression) {
+        case SnapshotCompression::none:
+            return true;
+        case SnapshotCompression::zstd:
+#ifdef FBPP_WITH_ZSTD
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+// IMessageMetadata with the stored types and names; Firebird recomputes the
+// offsets, which parse() checks against the stored ones.
+std::shared_ptr<const MessageMetadata> buildMetadata(const std::vector<FieldInfo>& fields) {
+    auto* master = Environment::getInstance().getMaster();
+    Firebird::ThrowStatusWrapper st(master->getStatus());
+    Firebird::IMetadataBuilder* builder = nullptr;
+    Firebird::IMessageMetadata* raw = nullptr;
+    try {
+        builder = master->getMetadataBuilder(&st, static_cast<unsigned>(fields.size()));
+        for (unsigned i = 0; i < fields.size(); ++i) {
+            const FieldInfo& field = fields[i];
+            builder->setType(&st, i, field.type | (field.nullable ? 1u : 0u));
+            builder->setSubType(&st, i, static_cast<int>(field.subType));
+            builder->setLength(&st, i, field.length);
+            builder->setCharSet(&st, i, field.charSet);
+            builder->setScale(&st, i, field.scale);
+            builder->setField(&st, i, field.name.c_str());
+            builder->setRelation(&st, i, field.relation.c_str());
+            builder->setOwner(&st, i, field.owner.c_str());
+            builder->setAlias(&st, i, field.alias.c_str());
+        }
+        raw = builder->getMetadata(&st);
+    } catch (const Firebird::FbException& e) {
+        FirebirdException error(e);
+        if (builder) {
+            builder->release();
+        }
+        st.dispose();
+        throw error;
+    }
+    builder->release();
+    st.dispose();
+    return std::make_shared<MessageMetadata>(raw);   // Takes the reference
+}
+
+std::vector<uint8_t> readWhole(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw FirebirdException("Cannot open " + path);
+    }
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+} // namespace
+
+ResultSnapshotWriter::ResultSnapshotWriter(std::ostream& out, const MessageMetadata& metadata,
+                                           SnapshotWriteOptions options)
+    : out_(out),
+      options_(options),
+      messageLength_(metadata.getMessageLength()),
+      stride_(metadata.getAlignedLength()) {
+    if (!compressionSupported(options_.compression)) {
+        throw FirebirdException("ResultSnapshotWriter: zstd compression needs FBPP_WITH_ZSTD");
+    }
+    if (options_.blockRows == 0) {
+        options_.blockRows = 1;
+    }
+
+    const unsigned count = metadata.getCount();
+    std::string header(kMagic, sizeof(kMagic));
+    putU32(header, kVersion);
+    putU32(header, static_cast<std::uint32_t>(options_.compression));
+    putU32(header, count);
+    putU32(header, static_cast<std::uint32_t>(messageLength_));
+    putU32(header, static_cast<std::uint32_t>(stride_));
+    putU32(header, 0);
+    for (unsigned i = 0; i < count; ++i) {
+        const FieldInfo& field = metadata.getFieldRef(i);
+        const unsigned type = field.type & ~1u;
+        if (type == SQL_BLOB || type == SQL_ARRAY) {
+            throw FirebirdException("ResultSnapshotWriter: column '" + displayName(field) +
+                                    "' is a BLOB or ARRAY; its id cannot outlive the transaction");
+        }
+        putU32(header, type);
+        putU32(header, field.subType);
+        putU32(header, field.length);
+        putU32(header, static_cast<std::uint32_t>(field.scale));
+        putU32(header, field.charSet);
+        putU32(header, field.offset);
+        putU32(header, field.nullOffset);
+        header.push_back(field.nullable ? '\1' : '\0');
+        putString(header, field.name);
+        putString(header, field.relation);
+        putString(header, field.owner);
+        putString(header, field.alias);
+    }
+    pad(header);
+    out_.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+    block_.assign(options_.blockRows * stride_, 0);
+}
+
+void ResultSnapshotWriter::writeRow(const uint8_t* message) {
+    if (finished_) {
+        throw FirebirdException("ResultSnapshotWriter: row written after finish()");
+    }
+    if (!message) {
+        throw FirebirdException("ResultSnapshotWriter: null message");
+    }
+    // Padding between messages stays zero from the initial assign()
+    std::memcpy(block_.data() + blockCount_ * stride_, message, messageLength_);
+    ++rows_;
+    if (++blockCount_ == options_.blockRows) {
+        writeBlock();
+    }
+}
+
+void ResultSnapshotWriter::finish() {
+    if (finished_) {
+        return;
+    }
+    finished_ = true;
+    writeBlock();
+
+    std::string trailer;
+    putU32(trailer, 0);   // End-of-data block
+    putU32(trailer, 0);
+    putU64(trailer, 0);
+    putU64(trailer, rows_);
+    out_.write(trailer.data(), static_cast<std::streamsize>(trailer.size()));
+    out_.flush();
+    if (!out_) {
+        throw FirebirdException("ResultSnapshotWriter: write failed");
+    }
+}
+
+void ResultSnapshotWriter::writeBlock() {
+    if (blockCount_ == 0) {
+        return;
+    }
+    const std::size_t raw = blockCount_ * stride_;
+    const uint8_t* payload = block_.data();
+    std::size_t stored = raw;
+
+#ifdef FBPP_WITH_ZSTD
+    if (options_.compression == SnapshotCompression::zstd) {
+        compressed_.resize(ZSTD_compressBound(raw));
+        const std::size_t n = ZSTD_compress(compressed_.data(), compressed_.size(), block_.data(), raw,
+                                            options_.compressionLevel);
+        if (ZSTD_isError(n)) {
+            throw FirebirdException(std::string("ResultSnapshotWriter: ") + ZSTD_getErrorName(n));
+        }
+        payload = compressed_.data();
+        stored = n;
+    }
+#endif
+
+    std::string header;
+    putU32(header, static_cast<std::uint32_t>(blockCount_));
+    putU32(header, 0);
+    putU64(header, stored);
+    out_.write(header.data(), static_cast<std::streamsize>(header.size()));
+    out_.write(reinterpret_cast<const char*>(payload), static_cast<std::streamsize>(stored));
+    static constexpr char zeros[kAlign] = {};
+    out_.write(zeros, static_cast<std::streamsize>(alignUp(stored) - stored));
+    if (!out_) {
+        throw FirebirdException("ResultSnapshotWriter: write failed");
+    }
+    blockCount_ = 0;
+}
+
+ResultSnapshot::ResultSnapshot(ResultSnapshot&&) noexcept = default;
+ResultSnapshot& ResultSnapshot::operator=(ResultSnapshot&&) noexcept = default;
+ResultSnapshot::~ResultSnapshot() = default;
+
+ResultSnapshot ResultSnapshot::open(const std::string& path) {
+    ResultSnapshot snapshot;
+#ifndef _WIN32
+    auto file = std::make_unique<detail::MappedFile>(path, O_RDONLY);
+    const std::size_t size = file->regularSize();
+    if (const void* data = size == 0 ? nullptr : file->map(size, false)) {
+        snapshot.parse(static_cast<const uint8_t*>(data), size);
+        snapshot.file_ = std::move(file);
+        return snapshot;
+    }
+#endif
+    snapshot.bytes_ = readWhole(path);
+    snapshot.parse(snapshot.bytes_.data(), snapshot.bytes_.size());
+    return snapshot;
+}
+
+ResultSnapshot ResultSnapshot::fromBytes(std::vector<uint8_t> bytes) {
+    ResultSnapshot snapshot;
+    snapshot.bytes_ = std::move(bytes);
+    snapshot.parse(snapshot.bytes_.data(), snapshot.bytes_.size());
+    return snapshot;
+}
+
+void ResultSnapshot::parse(const uint8_t* data, std::size_t size) {
+    Reader in{data, size};
+    if (std::memcmp(in.take(sizeof(kMagic), "header"), kMagic, sizeof(kMagic)) != 0) {
+        invalid("bad magic");
+    }
+    if (in.get<std::uint32_t>("header") != kVersion) {
+        invalid("unsupported version");
+    }
+    const auto compression = static_cast<SnapshotCompression>(in.get<std::uint32_t>("header"));
+    if (compression != SnapshotCompression::none && compression != SnapshotCompression::zstd) {
+        invalid("unknown compression");
+    }
+    if (!compressionSupported(compression)) {
+        throw FirebirdException("ResultSnapshot: zstd-compressed snapshot needs FBPP_WITH_ZSTD");
+    }
+    const auto count = in.get<std::uint32_t>("header");
+    const auto messageLength = in.get<std::uint32_t>("header");
+    stride_ = in.get<std::uint32_t>("header");
+    in.get<std::uint32_t>("header");
+    if (stride_ < messageLength || stride_ == 0) {
+        invalid("bad message stride");
+    }
+
+    std::vector<FieldInfo> fields(count);
+    for (auto& field : fields) {
+        field.type = in.get<std::uint32_t>("field");
+        field.subType = in.get<std::uint32_t>("field");
+        field.length = in.get<std::uint32_t>("field");
+        field.scale = static_cast<int>(in.get<std::uint32_t>("field"));
+        field.charSet = in.get<std::uint32_t>("field");
+        field.offset = in.get<std::uint32_t>("field");
+        field.nullOffset = in.get<std::uint32_t>("field");
+        field.nullable = in.get<uint8_t>("field") != 0;
+        field.name = in.string("field");
+        field.relation = in.string("field");
+        field.owner = in.string("field");
+        field.alias = in.string("field");
+    }
+    in.align();
+
+    auto metadata = buildMetadata(fields);
+    bool same = metadata->getCount() == count &&
+                metadata->getMessageLength() == messageLength &&
+                metadata->getAlignedLength() == stride_;
+    for (unsigned i = 0; same && i < count; ++i) {
+        const FieldInfo& rebuilt = metadata->getFieldRef(i);
+        same = rebuilt.offset == fields[i].offset && rebuilt.nullOffset == fields[i].nullOffset;
+    }
+    if (!same) {
+        throw FirebirdException("ResultSnapshot: layout does not match this client's message format");
+    }
+    metadata_ = std::move(metadata);
+
+    // Compressed blocks are inflated after the scan so inflated_ is sized once
+    std::vector<std::pair<const uint8_t*, std::size_t>> packed;
+    std::size_t rows = 0;
+    for (;;) {
+        const auto blockRows = in.get<std::uint32_t>("block");
+        in.get<std::uint32_t>("block");
+        const auto stored = in.get<std::uint64_t>("block");
+        if (blockRows == 0) {
+            if (in.get<std::uint64_t>("trailer") != rows) {
+                invalid("row count mismatch");
+            }
+            break;
+        }
+        const uint8_t* payload = in.take(stored, "block");
+        in.align();
+        if (compression == SnapshotCompression::none) {
+            if (stored != static_cast<std::uint64_t>(blockRows) * stride_) {
+                invalid("bad block size");
+            }
+        } else {
+            packed.emplace_back(payload, static_cast<std::size_t>(stored));
+        }
+        blocks_.push_back(Block{rows, blockRows, payload});
+        rows += blockRows;
+    }
+    rowCount_ = rows;
+
+#ifdef FBPP_WITH_ZSTD
+    if (compression == SnapshotCompression::zstd) {
+        inflated_.resize(rows * stride_);
+        for (std::size_t b = 0; b < blocks_.size(); ++b) {
+            uint8_t* target = inflated_.data() + blocks_[b].firstRow * stride_;
+            const std::size_t raw = blocks_[b].rows * stride_;
+            const std::size_t n = ZSTD_decompress(target, raw, packed[b].first, packed[b].second);
+            if (ZSTD_isError(n) || n != raw) {
+                invalid("corrupt zstd block");
+            }
+            blocks_[b].data = target;
+        }
+    }
+#endif
+}
+
+const uint8_t* ResultSnapshot::rowData(std::size_t index) const {
+    if (index >= rowCount_) {
+        throw FirebirdException("ResultSnapshot: row index out of range");
+    }
+    auto it = std::upper_bound(blocks_.begin(), blocks_.end(), index,
+                               [](std::size_t row, const Block& block) { return row < block.firstRow; });
+    --it;
+    return it->data + (index - it->firstRow) * stride_;
+}
+
+} // namespace fbpp::core
@@ -0,0 +1,123 @@
+#include "fbpp/core/retrying_transaction_runner.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <thread>
+
+namespace fbpp {
+namespace core {
+
+namespace {
+
+// GDS codes of losing a concurrency conflict (see iberror.h)
+constexpr int kConflictCodes[] = {
+    335544336,   // isc_deadlock
+    335544345,   // isc_lock_conflict
+    335544510,   // isc_lock_timeout
+    335544856    // isc_update_conflict
+};
+
+bool hasCode(const FirebirdException& error, const int* first, const int* last) {
+    for (const auto& entry : error.getStatusVector()) {
+        if (entry.tag == isc_arg_gds && std::find(first, last, static_cast<int>(entry.numericValue)) != last) {
+            return true;
+        }
+    }
+    return std::find(first, last, error.getErrorCode()) != last;
+}
+
+std::chrono::microseconds jitteredBackoff(const RetryPolicy& policy, unsigned attempt) {
+    const double initial = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::microseconds>(policy.initialBackoff).count());
+    const double cap = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::microseconds>(policy.maxBackoff).count());
+    const double ceiling = std::min(cap, initial * std::pow(std::max(policy.multiplier, 1.0),
+                                                            static_cast<double>(attempt - 1)));
+    if (ceiling <= 0) {
+        return std::chrono::microseconds(0);
+    }
+    thread_local std::minstd_rand rng(std::random_device{}());
+    std::uniform_real_distribution<double> spread(0.0, ceiling);
+    return std::chrono::microseconds(static_cast<int64_t>(spread(rng)));
+}
+
+void rollbackQuietly(Transaction* transaction) noexcept {
+    if (transaction && transaction->isActive()) {
+        try {
+            transaction->Rollback();
+        } catch (...) {
+            // The attempt failed already; the connection reports any lasting problem
+        }
+    }
+}
+
+} // namespace
+
+RetryingTransactionRunner::RetryingTransactionRunner(Connection& connection, RetryPolicy policy)
+    : connection_(connection), policy_(std::move(policy)) {
+    policy_.maxAttempts = std::max(policy_.maxAttempts, 1u);
+}
+
+bool RetryingTransactionRunner::isConflict(const FirebirdException& error) {
+    return hasCode(error, std::begin(kConflictCodes), std::end(kConflictCodes));
+}
+
+bool RetryingTransactionRunner::isRetryable(const FirebirdException& error) const {
+    const auto& extra = policy_.extraRetryableCodes;
+    return isConflict(error) || hasCode(error, extra.data(), extra.data() + extra.size());
+}
+
+std::shared_ptr<Transaction> RetryingTransactionRunner::begin() {
+    attempts_.fetch_add(1, std::memory_order_relaxed);
+    return connection_.StartTransaction(policy_.transaction);
+}
+
+bool RetryingTransactionRunner::handleFailure(Transaction* transaction, unsigned attempt,
+                                              const FirebirdException& error) {
+    rollbackQuietly(transaction);
+    if (!isRetryable(error)) {
+        failures_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    conflicts_.fetch_add(1, std::memory_order_relaxed);
+    if (attempt >= policy_.maxAttempts) {
+        exhausted_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (policy_.onRetry) {
+        policy_.onRetry(attempt, error);
+    }
+    const auto wait = jitteredBackoff(policy_, attempt);
+    backoff_.record(static_cast<uint64_t>(wait.count()));
+    if (wait.count() > 0) {
+        std::this_thread::sleep_for(wait);
+    }
+    return true;
+}
+
+void RetryingTransactionRunner::handleOtherFailure(Transaction* transaction) noexcept {
+    rollbackQuietly(transaction);
+    failures_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void RetryingTransactionRunner::recordSuccess(std::chrono::steady_clock::time_point started) noexcept {
+    commits_.fetch_add(1, std::memory_order_relaxed);
+    runLatency_.record(std::chrono::steady_clock::now() - started);
+}
+
+RetryStats RetryingTransactionRunner::stats() const {
+    RetryStats stats;
+    stats.runs = runs_.load(std::memory_order_relaxed);
+    stats.attempts = attempts_.load(std::memory_order_relaxed);
+    stats.commits = commits_.load(std::memory_order_relaxed);
+    stats.conflicts = conflicts_.load(std::memory_order_relaxed);
+    stats.exhausted = exhausted_.load(std::memory_order_relaxed);
+    stats.failures = failures_.load(std::memory_order_relaxed);
+    stats.backoff = backoff_.snapshot();
+    stats.runLatency = runLatency_.snapshot();
+    return stats;
+}
+
+} // namespace core
+} // namespace fbpp
@@ -2,6 +2,10 @@
 #include "fbpp/core/result_set.hpp"
 #include "fbpp/core/transaction.hpp"
 #include "fbpp/core/exception.hpp"
+#include "fbpp/core/blob.hpp"
+
+#include <algorithm>
+#include <cstring>
 
 namespace fbpp {
 namespace core {
@@ -31,7 +35,29 @@ Row::Row(const RowView& view)
     : meta_(view.sharedMetadata())
     , buf_(view.data(),
            view.data() + view.metadata().getMessageLength()) {
-    if (auto* tx = view.transaction()) {
+    data_ = buf_.data();
+    captureTransaction(view.transaction(), RowOwnership::shared);
+}
+
+Row::Row(const RowView& view, std::shared_ptr<ResultArena> arena, RowOwnership ownership)
+    : meta_(view.sharedMetadata())
+    , arena_(std::move(arena)) {
+    const unsigned length = view.metadata().getMessageLength();
+    if (arena_) {
+        data_ = arena_->copy(view.data(), length);
+    } else {
+        buf_.assign(view.data(), view.data() + length);
+        data_ = buf_.data();
+    }
+    captureTransaction(view.transaction(), ownership);
+}
+
+void Row::captureTransaction(Transaction* tx, RowOwnership ownership) {
+    if (tx && ownership == RowOwnership::borrowed) {
+        // Aliasing an empty shared_ptr: copies and destruction never touch
+        // a reference count
+        tx_ = std::shared_ptr<Transaction>(std::shared_ptr<Transaction>{}, tx);
+    } else if (tx) {
         try {
             tx_ = tx->shared_from_this();
         } catch (const std::bad_weak_ptr&) {
@@ -52,6 +78,40 @@ Row::Row(std::shared_ptr<const MessageMetadata> meta,
     if (!meta_) {
         throw FirebirdException("Row: null metadata");
     }
+    data_ = buf_.data();
+}
+
+std::optional<std::span<const std::byte>> Row::getBlobBytes(unsigned index) const {
+    const FieldInfo& fi = meta_->getFieldRef(index);
+    if (fi.type != SQL_BLOB) {
+        throw FirebirdException(
+            std::string("Column '") + std::string(displayName(fi)) + "' is not a BLOB");
+    }
+    if (isNull(index)) {
+        return std::nullopt;
+    }
+    if (!tx_) {
+        throw FirebirdException("Row has no transaction for BLOB access");
+    }
+
+    ISC_QUAD blobId;
+    std::memcpy(&blobId, data_ + fi.offset, sizeof(blobId));
+    auto reader = tx_->openBlob(blobId);
+    const auto expected = static_cast<std::size_t>(reader.info().totalLength);
+    if (!arena_) {
+        arena_ = std::make_shared<ResultArena>(std::max<std::size_t>(expected, 256));
+    }
+
+    auto* out = static_cast<std::byte*>(arena_->allocate(expected, 1));
+    std::size_t got = 0;
+    while (got < expected) {
+        const std::size_t n = reader.read(out + got, expected - got);
+        if (n == 0) {
+            break;
+        }
+        got += n;
+    }
+    return std::span<const std::byte>(out, got);
 }
 
 } // namespace core
@@ -0,0 +1,343 @@
+#include "fbpp/core/row_store.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <cstring>
+
+namespace fbpp {
+namespace core {
+
+namespace {
+
+template<typename T>
+T load(const uint8_t* p) {
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+uint32_t loadEnd(const uint8_t* r, int slot) {
+    return slot < 0 ? 0 : load<uint32_t>(r + slot);
+}
+
+// -1 / 0 / 1 for two non-NULL fixed slots of SQL type `type`
+template<typename T>
+int compareAs(const uint8_t* a, const uint8_t* b) {
+    const T x = load<T>(a);
+    const T y = load<T>(b);
+    return x < y ? -1 : (y < x ? 1 : 0);
+}
+
+using SlotCompare = int (*)(const uint8_t*, const uint8_t*);
+
+int compareTimestamp(const uint8_t* a, const uint8_t* b) {
+    if (int c = compareAs<int32_t>(a, b)) {            // ISC_DATE
+        return c;
+    }
+    return compareAs<uint32_t>(a + 4, b + 4);          // ISC_TIME
+}
+
+int compareInt128(const uint8_t* a, const uint8_t* b) {
+    // Two 64-bit words, low word first (little-endian FB_I128)
+    if (int c = compareAs<int64_t>(a + 8, b + 8)) {
+        return c;
+    }
+    return compareAs<uint64_t>(a, b);
+}
+
+SlotCompare fixedComparator(unsigned sqlType) {
+    switch (sqlType) {
+        case SQL_SHORT:     return &compareAs<int16_t>;
+        case SQL_LONG:      return &compareAs<int32_t>;
+        case SQL_INT64:     return &compareAs<int64_t>;
+        case SQL_FLOAT:     return &compareAs<float>;
+        case SQL_DOUBLE:
+        case SQL_D_FLOAT:   return &compareAs<double>;
+        case SQL_BOOLEAN:   return &compareAs<uint8_t>;
+        case SQL_TYPE_DATE: return &compareAs<int32_t>;
+        case SQL_TYPE_TIME: return &compareAs<uint32_t>;
+        case SQL_TIMESTAMP: return &compareTimestamp;
+        case SQL_INT128:    return &compareInt128;
+        default:            return nullptr;
+    }
+}
+
+} // namespace
+
+RowStore::RowStore(std::shared_ptr<const MessageMetadata> metadata,
+                   std::shared_ptr<Transaction> transaction,
+                   std::shared_ptr<ResultArena> arena)
+    : meta_(std::move(metadata))
+    , tx_(std::move(transaction))
+    , arena_(arena ? std::move(arena) : std::make_shared<ResultArena>()) {
+    if (!meta_) {
+        throw FirebirdException("RowStore: null metadata");
+    }
+    const unsigned count = meta_->getCount();
+    bitmapBytes_ = (count + 7) / 8;
+    messageLength_ = meta_->getMessageLength();
+    scratch_.assign(messageLength_, 0);
+
+    unsigned slot = bitmapBytes_;
+    columns_.reserve(count);
+    for (unsigned i = 0; i < count; ++i) {
+        const FieldInfo& fi = meta_->getFieldRef(i);
+        Column c;
+        c.sqlType = fi.type & ~1u;
+        c.offset = fi.offset;
+        c.nullOffset = fi.nullOffset;
+        c.length = fi.length;
+        c.slot = slot;
+        if (c.sqlType == SQL_TEXT || c.sqlType == SQL_VARYING) {
+            c.kind = c.sqlType == SQL_TEXT ? Slot::Char : Slot::Varying;
+            c.pad = fi.charSet == 1 ? 0 : ' ';        // OCTETS pads with NULs
+            c.previousVar = lastVarSlot_;
+            lastVarSlot_ = static_cast<int>(slot);
+            slot += sizeof(uint32_t);
+        } else {
+            slot += fi.length;
+        }
+        columns_.push_back(c);
+    }
+    fixedBytes_ = slot;
+}
+
+RowStore::SlotCompare RowStore::slotComparator(unsigned sqlType) {
+    return fixedComparator(sqlType);
+}
+
+RowStore RowStore::fromResultSet(ResultSet& resultSet, std::size_t maxRows) {
+    RowStore store(resultSet.getSharedMetadata(), resultSet.getTransaction());
+    store.append(resultSet, maxRows);
+    return store;
+}
+
+RowStore RowStore::emptyCopy() const {
+    RowStore out;
+    out.meta_ = meta_;
+    out.tx_ = tx_;
+    out.arena_ = arena_;
+    out.columns_ = columns_;
+    out.bitmapBytes_ = bitmapBytes_;
+    out.fixedBytes_ = fixedBytes_;
+    out.lastVarSlot_ = lastVarSlot_;
+    out.messageLength_ = messageLength_;
+    out.scratch_.assign(messageLength_, 0);
+    return out;
+}
+
+void RowStore::append(const uint8_t* message) {
+    if (!meta_) {
+        throw FirebirdException("RowStore::append on a store without metadata");
+    }
+    // Variable parts first: their total sizes the allocation
+    std::size_t varBytesTotal = 0;
+    for (const Column& c : columns_) {
+        if (c.kind == Slot::Fixed || load<int16_t>(message + c.nullOffset) == -1) {
+            continue;
+        }
+        if (c.kind == Slot::Varying) {
+            varBytesTotal += load<uint16_t>(message + c.offset);
+        } else {
+            std::size_t n = c.length;
+            while (n > 0 && message[c.offset + n - 1] == c.pad) {
+                --n;
+            }
+            varBytesTotal += n;
+        }
+    }
+
+    const std::size_t size = fixedBytes_ + varBytesTotal;
+    auto* r = static_cast<uint8_t*>(arena_->allocate(size, 1));
+    std::memset(r, 0, bitmapBytes_);
+    uint8_t* var = r + fixedBytes_;
+    uint32_t end = 0;
+    for (unsigned i = 0; i < columns_.size(); ++i) {
+        const Column& c = columns_[i];
+        const bool isNull = load<int16_t>(message + c.nullOffset) == -1;
+        if (isNull) {
+            r[i >> 3] |= static_cast<uint8_t>(1u << (i & 7));
+        }
+        if (c.kind == Slot::Fixed) {
+            if (isNull) {
+                std::memset(r + c.slot, 0, c.length);
+            } else {
+                std::memcpy(r + c.slot, message + c.offset, c.length);
+            }
+            continue;
+        }
+        if (!isNull) {
+            const uint8_t* src = message + c.offset;
+            std::size_t n;
+            if (c.kind == Slot::Varying) {
+                n = load<uint16_t>(src);
+                src += sizeof(uint16_t);
+            } else {
+                n = c.length;
+                while (n > 0 && src[n - 1] == c.pad) {
+                    --n;
+                }
+            }
+            std::memcpy(var + end, src, n);
+            end += static_cast<uint32_t>(n);
+        }
+        std::memcpy(r + c.slot, &end, sizeof(end));
+    }
+    rows_.push_back(r);
+    encodedBytes_ += size;
+    ++revision_;
+}
+
+std::size_t RowStore::append(ResultSet& resultSet, std::size_t maxRows) {
+    const MessageMetadata* meta = resultSet.getMetadata();
+    if (!meta || !meta_ || meta->getMessageLength() != messageLength_ ||
+        meta->getCount() != columns_.size()) {
+        throw FirebirdException("RowStore::append: result set columns differ from the store's");
+    }
+    if (!tx_) {
+        tx_ = resultSet.getTransaction();
+    }
+    std::size_t count = 0;
+    for (const auto& view : resultSet.rows()) {
+        append(view.data());
+        if (++count == maxRows) {
+            break;
+        }
+    }
+    return count;
+}
+
+std::size_t RowStore::encodedSize(const uint8_t* r) const {
+    return fixedBytes_ + loadEnd(r, lastVarSlot_);
+}
+
+std::string_view RowStore::varBytes(const uint8_t* r, const Column& c) const {
+    const uint32_t begin = loadEnd(r, c.previousVar);
+    const uint32_t end = load<uint32_t>(r + c.slot);
+    return {reinterpret_cast<const char*>(r + fixedBytes_ + begin), end - begin};
+}
+
+std::optional<std::string_view> RowStore::getView(std::size_t row, unsigned column) const {
+    const uint8_t* r = encoded(row);
+    checkColumn(column);
+    const Column& c = columns_[column];
+    if (c.kind == Slot::Fixed) {
+        const FieldInfo& fi = meta_->getFieldRef(column);
+        throw FirebirdException(
+            std::string("getView() needs a CHAR/VARCHAR column; '") +
+            std::string(displayName(fi)) + "' has sql_type=" + std::to_string(fi.type));
+    }
+    if ((r[column >> 3] >> (column & 7)) & 1) {
+        return std::nullopt;
+    }
+    return varBytes(r, c);  // CHAR padding was dropped on encode
+}
+
+std::optional<std::string_view> RowStore::valueBytes(std::size_t row, unsigned column) const {
+    const uint8_t* r = encoded(row);
+    checkColumn(column);
+    if ((r[column >> 3] >> (column & 7)) & 1) {
+        return std::nullopt;
+    }
+    const Column& c = columns_[column];
+    if (c.kind != Slot::Fixed) {
+        return varBytes(r, c);
+    }
+    return std::string_view(reinterpret_cast<const char*>(r + c.slot), c.length);
+}
+
+void RowStore::expandEncoded(const uint8_t* r, uint8_t* message) const {
+    for (unsigned i = 0; i < columns_.size(); ++i) {
+        const Column& c = columns_[i];
+        const bool isNull = (r[i >> 3] >> (i & 7)) & 1;
+        const int16_t indicator = isNull ? -1 : 0;
+        std::memcpy(message + c.nullOffset, &indicator, sizeof(indicator));
+        if (c.kind == Slot::Fixed) {
+            std::memcpy(message + c.offset, r + c.slot, c.length);
+            continue;
+        }
+        const auto bytes = isNull ? std::string_view{} : varBytes(r, c);
+        if (c.kind == Slot::Varying) {
+            const auto n = static_cast<uint16_t>(bytes.size());
+            std::memcpy(message + c.offset, &n, sizeof(n));
+            std::memcpy(message + c.offset + sizeof(n), bytes.data(), bytes.size());
+        } else {
+            std::memcpy(message + c.offset, bytes.data(), bytes.size());
+            std::memset(message + c.offset + bytes.size(), c.pad, c.length - bytes.size());
+        }
+    }
+}
+
+void RowStore::expandColumn(std::size_t row, unsigned column) const {
+    const uint8_t* r = encoded(row);
+    checkColumn(column);
+    const Column& c = columns_[column];
+    uint8_t* message = scratch_.data();
+    const bool isNull = (r[column >> 3] >> (column & 7)) & 1;
+    const int16_t indicator = isNull ? -1 : 0;
+    std::memcpy(message + c.nullOffset, &indicator, sizeof(indicator));
+    if (isNull) {
+        return;
+    }
+    if (c.kind == Slot::Fixed) {
+        std::memcpy(message + c.offset, r + c.slot, c.length);
+        return;
+    }
+    const auto bytes = varBytes(r, c);
+    if (c.kind == Slot::Varying) {
+        const auto n = static_cast<uint16_t>(bytes.size());
+        std::memcpy(message + c.offset, &n, sizeof(n));
+        std::memcpy(message + c.offset + sizeof(n), bytes.data(), bytes.size());
+    } else {
+        std::memcpy(message + c.offset, bytes.data(), bytes.size());
+        std::memset(message + c.offset + bytes.size(), c.pad, c.length - bytes.size());
+    }
+}
+
+RowView RowStore::view(std::size_t row) const {
+    expandEncoded(encoded(row), scratch_.data());
+    return RowView(meta_, scratch_.data(), tx_.get());
+}
+
+void RowStore::expand(std::size_t row, uint8_t* message) const {
+    expandEncoded(encoded(row), message);
+}
+
+Row RowStore::toRow(std::size_t row) const {
+    std::vector<uint8_t> buffer(messageLength_);
+    expandEncoded(encoded(row), buffer.data());
+    return Row(meta_, std::move(buffer), tx_);
+}
+
+void RowStore::sortBy(unsigned column, bool descending) {
+    checkColumn(column);
+    const Column& c = columns_[column];
+    const SlotCompare fixed = c.kind == Slot::Fixed ? fixedComparator(c.sqlType) : nullptr;
+    if (c.kind == Slot::Fixed && !fixed) {
+        throw FirebirdException("RowStore::sortBy: sql_type=" + std::to_string(c.sqlType) +
+                                " has no direct ordering; use sort() with a comparator");
+    }
+    const unsigned byte = column >> 3;
+    const uint8_t bit = static_cast<uint8_t>(1u << (column & 7));
+    ++revision_;
+    std::stable_sort(rows_.begin(), rows_.end(), [&](const uint8_t* a, const uint8_t* b) {
+        const bool nullA = a[byte] & bit;
+        const bool nullB = b[byte] & bit;
+        int cmp;
+        if (nullA || nullB) {
+            cmp = nullA == nullB ? 0 : (nullA ? -1 : 1);
+        } else if (fixed) {
+            cmp = fixed(a + c.slot, b + c.slot);
+        } else {
+            cmp = varBytes(a, c).compare(varBytes(b, c));
+        }
+        return descending ? cmp > 0 : cmp < 0;
+    });
+}
+
+std::size_t RowStore::bytesUsed() const noexcept {
+    return encodedBytes_ + rows_.capacity() * sizeof(const uint8_t*);
+}
+
+} // namespace core
+} // namespace fbpp
@@ -0,0 +1,241 @@
+#include "fbpp/core/row_store_index.hpp"
+
+#include <cstring>
+
+namespace fbpp {
+namespace core {
+
+namespace {
+
+uint64_t mix(uint64_t x) noexcept {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+// Eight bytes at a time; keys are short and already in memory
+uint64_t hashBytes(const uint8_t* p, std::size_t n) noexcept {
+    uint64_t h = 0x9e3779b97f4a7c15ULL ^ n;
+    for (; n >= 8; p += 8, n -= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        h = mix(h ^ word);
+    }
+    if (n != 0) {
+        uint64_t word = 0;
+        std::memcpy(&word, p, n);
+        h = mix(h ^ word);
+    }
+    return h;
+}
+
+template<typename T>
+int64_t loadInteger(const char* p) {
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+uint32_t toLink(std::size_t row) {
+    return static_cast<uint32_t>(row + 1);
+}
+
+} // namespace
+
+RowStoreIndex::RowStoreIndex(const RowStore& store, unsigned column)
+    : store_(&store)
+    , column_(column)
+    , type_(keyType(store, column))
+    , revision_(store.revision_) {
+    const std::size_t count = store.size();
+    if (count >= UINT32_MAX) {
+        throw FirebirdException("RowStoreIndex: " + std::to_string(count) +
+                                " rows exceed the index's row numbers");
+    }
+    std::size_t capacity = 16;
+    while (capacity < 2 * count) {
+        capacity <<= 1;
+    }
+    slots_.resize(capacity);
+    next_.assign(count, 0);
+    const std::size_t mask = capacity - 1;
+
+    Key key;
+    Key other;
+    for (std::size_t row = 0; row < count; ++row) {
+        if (!keyOf(store, row, column, type_, key)) {
+            continue;
+        }
+        ++rows_;
+        const uint64_t hash = hashBytes(key.data, key.size);
+        const uint32_t tag = static_cast<uint32_t>(hash >> 32);
+        for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+            Slot& slot = slots_[i];
+            if (slot.head == 0) {
+                slot.tag = tag;
+                slot.head = slot.tail = toLink(row);
+                ++keys_;
+                break;
+            }
+            if (slot.tag == tag) {
+                keyOf(store, slot.head - 1, column, type_, other);
+                if (other.size == key.size && std::memcmp(other.data, key.data, key.size) == 0) {
+                    next_[slot.tail - 1] = toLink(row);
+                    slot.tail = toLink(row);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+RowStoreIndex::KeyType RowStoreIndex::keyType(const RowStore& store, unsigned column) {
+    store.checkColumn(column);
+    const FieldInfo& fi = store.metadata().getFieldRef(column);
+    KeyType type;
+    type.sqlType = fi.type & ~1u;
+    type.scale = fi.scale;
+    switch (type.sqlType) {
+        case SQL_SHORT:
+        case SQL_LONG:
+        case SQL_INT64:
+        case SQL_INT128:
+            type.keyClass = KeyClass::Integer;
+            break;
+        case SQL_TEXT:
+        case SQL_VARYING:
+            type.keyClass = KeyClass::Text;
+            type.scale = 0;
+            break;
+        case SQL_BOOLEAN:
+        case SQL_TYPE_DATE:
+        case SQL_TYPE_TIME:
+        case SQL_TIMESTAMP:
+            type.keyClass = KeyClass::Value;
+            type.scale = 0;
+            break;
+        default:
+            throw FirebirdException("RowStoreIndex: column '" + std::string(displayName(fi)) +
+                                    "' has sql_type=" + std::to_string(fi.type) +
+                                    ", which has no canonical key bytes");
+    }
+    return type;
+}
+
+bool RowStoreIndex::keyOf(const RowStore& store, std::size_t row, unsigned column,
+                          const KeyType& type, Key& key) {
+    const std::optional<std::string_view> bytes = store.valueBytes(row, column);
+    if (!bytes) {
+        return false;
+    }
+    if (type.keyClass != KeyClass::Integer) {
+        key.data = reinterpret_cast<const uint8_t*>(bytes->data());
+        key.size = bytes->size();
+        return true;
+    }
+    // Every integer width as the two 64-bit halves of an INT128
+    if (type.sqlType == SQL_INT128) {
+        std::memcpy(key.buffer, bytes->data(), sizeof(key.buffer));
+    } else {
+        int64_t value;
+        switch (type.sqlType) {
+            case SQL_SHORT: value = loadInteger<int16_t>(bytes->data()); break;
+            case SQL_LONG:  value = loadInteger<int32_t>(bytes->data()); break;
+            default:        value = loadInteger<int64_t>(bytes->data()); break;
+        }
+        key.buffer[0] = static_cast<uint64_t>(value);
+        key.buffer[1] = value < 0 ? ~0ULL : 0;
+    }
+    key.data = reinterpret_cast<const uint8_t*>(key.buffer);
+    key.size = sizeof(key.buffer);
+    return true;
+}
+
+void RowStoreIndex::checkFresh() const {
+    if (stale()) {
+        throw FirebirdException("RowStoreIndex: the store changed since the index was built");
+    }
+}
+
+RowStoreIndex::Matches RowStoreIndex::lookup(const Key& key) const {
+    const uint64_t hash = hashBytes(key.data, key.size);
+    const uint32_t tag = static_cast<uint32_t>(hash >> 32);
+    const std::size_t mask = slots_.size() - 1;
+    Key other;
+    for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+        const Slot& slot = slots_[i];
+        if (slot.head == 0) {
+            return Matches(next_.data(), 0);
+        }
+        if (slot.tag == tag) {
+            keyOf(*store_, slot.head - 1, column_, type_, other);
+            if (other.size == key.size && std::memcmp(other.data, key.data, key.size) == 0) {
+                return Matches(next_.data(), slot.head);
+            }
+        }
+    }
+}
+
+RowStoreIndex::Matches RowStoreIndex::find(int64_t value) const {
+    checkFresh();
+    if (type_.keyClass != KeyClass::Integer) {
+        throw FirebirdException("RowStoreIndex::find(int64_t) on a non-integer column");
+    }
+    Key key;
+    key.buffer[0] = static_cast<uint64_t>(value);
+    key.buffer[1] = value < 0 ? ~0ULL : 0;
+    key.data = reinterpret_cast<const uint8_t*>(key.buffer);
+    key.size = sizeof(key.buffer);
+    return lookup(key);
+}
+
+RowStoreIndex::Matches RowStoreIndex::find(std::string_view value) const {
+    checkFresh();
+    if (type_.keyClass != KeyClass::Text) {
+        throw FirebirdException("RowStoreIndex::find(string_view) on a non-CHAR/VARCHAR column");
+    }
+    Key key;
+    key.data = reinterpret_cast<const uint8_t*>(value.data());
+    key.size = value.size();
+    return lookup(key);
+}
+
+RowStoreIndex::Matches RowStoreIndex::find(const RowStore& other, std::size_t row,
+                                           unsigned column) const {
+    checkFresh();
+    if (!joinable(other, column)) {
+        throw FirebirdException("RowStoreIndex::find: column " + std::to_string(column) +
+                                " cannot join the indexed column " + std::to_string(column_));
+    }
+    const KeyType type = keyType(other, column);
+    Key key;
+    if (!keyOf(other, row, column, type, key)) {
+        return Matches(next_.data(), 0);
+    }
+    return lookup(key);
+}
+
+bool RowStoreIndex::joinable(const RowStore& other, unsigned column) const {
+    if (column >= other.columnCount()) {
+        return false;
+    }
+    const FieldInfo& fi = other.metadata().getFieldRef(column);
+    const unsigned sqlType = fi.type & ~1u;
+    switch (type_.keyClass) {
+        case KeyClass::Integer:
+            return (sqlType == SQL_SHORT || sqlType == SQL_LONG || sqlType == SQL_INT64 ||
+                    sqlType == SQL_INT128) &&
+                   fi.scale == type_.scale;
+        case KeyClass::Text:
+            return sqlType == SQL_TEXT || sqlType == SQL_VARYING;
+        case KeyClass::Value:
+            return sqlType == type_.sqlType;
+    }
+    return false;
+}
+
+} // namespace core
+} // namespace fbpp
@@ -0,0 +1,255 @@
+#include "fbpp/core/row_store_sort.hpp"
+#include "fbpp/core/executor.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <queue>
+#include <string>
+#include <string_view>
+
+namespace fbpp {
+namespace core {
+
+namespace {
+
+uint8_t foldAscii(uint8_t c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<uint8_t>(c + ('a' - 'A')) : c;
+}
+
+int compareText(std::string_view x, std::string_view y, bool fold) {
+    const std::size_t n = std::min(x.size(), y.size());
+    for (std::size_t i = 0; i < n; ++i) {
+        uint8_t a = static_cast<uint8_t>(x[i]);
+        uint8_t b = static_cast<uint8_t>(y[i]);
+        if (fold) {
+            a = foldAscii(a);
+            b = foldAscii(b);
+        }
+        if (a != b) {
+            return a < b ? -1 : 1;
+        }
+    }
+    return x.size() < y.size() ? -1 : (y.size() < x.size() ? 1 : 0);
+}
+
+} // namespace
+
+struct RowSorter::CompiledKey {
+    const RowStore::Column* column = nullptr;
+    RowStore::SlotCompare fixed = nullptr;   // Null for CHAR / VARCHAR
+    unsigned byte = 0;                       // Null bitmap byte and bit
+    uint8_t bit = 0;
+    bool descending = false;
+    bool nullsFirst = true;
+    bool fold = false;
+};
+
+RowSorter::RowSorter(std::vector<SortKey> keys, RowSortOptions options)
+    : keys_(std::move(keys)), options_(options) {
+    if (keys_.empty()) {
+        throw FirebirdException("RowSorter: at least one sort key required");
+    }
+}
+
+std::vector<RowSorter::CompiledKey> RowSorter::compile(const RowStore& store) const {
+    std::vector<CompiledKey> compiled;
+    compiled.reserve(keys_.size());
+    for (const SortKey& key : keys_) {
+        store.checkColumn(key.column);
+        const RowStore::Column& c = store.columns_[key.column];
+        CompiledKey k;
+        k.column = &c;
+        k.byte = key.column >> 3;
+        k.bit = static_cast<uint8_t>(1u << (key.column & 7));
+        k.descending = key.descending;
+        k.nullsFirst = key.nulls == NullOrder::Default ? !key.descending
+                                                       : key.nulls == NullOrder::First;
+        if (c.kind == RowStore::Slot::Fixed) {
+            k.fixed = RowStore::slotComparator(c.sqlType);
+            if (!k.fixed) {
+                throw FirebirdException("RowSorter: column " + std::to_string(key.column) +
+                                        " sql_type=" + std::to_string(c.sqlType) +
+                                        " has no direct ordering");
+            }
+            if (key.caseInsensitive) {
+                throw FirebirdException("RowSorter: caseInsensitive needs a CHAR/VARCHAR column; "
+                                        "column " + std::to_string(key.column) + " is not");
+            }
+        }
+        k.fold = key.caseInsensitive;
+        compiled.push_back(k);
+    }
+    return compiled;
+}
+
+int RowSorter::compareRows(const RowStore& store, const std::vector<CompiledKey>& keys,
+                           const uint8_t* a, const uint8_t* b) {
+    for (const CompiledKey& k : keys) {
+        const bool nullA = a[k.byte] & k.bit;
+        const bool nullB = b[k.byte] & k.bit;
+        if (nullA || nullB) {
+            if (nullA == nullB) {
+                continue;
+            }
+            // NULL placement does not flip with descending
+            return nullA == k.nullsFirst ? -1 : 1;
+        }
+        int cmp;
+        if (k.fixed) {
+            cmp = k.fixed(a + k.column->slot, b + k.column->slot);
+        } else {
+            cmp = compareText(store.varBytes(a, *k.column), store.varBytes(b, *k.column), k.fold);
+        }
+        if (cmp != 0) {
+            return k.descending ? -cmp : cmp;
+        }
+    }
+    return 0;
+}
+
+void RowSorter::checkSameColumns(const RowStore& first, const RowStore& other) {
+    bool same = first.fixedBytes_ == other.fixedBytes_ &&
+                first.messageLength_ == other.messageLength_ &&
+                first.columns_.size() == other.columns_.size();
+    for (std::size_t i = 0; same && i < first.columns_.size(); ++i) {
+        const RowStore::Column& x = first.columns_[i];
+        const RowStore::Column& y = other.columns_[i];
+        same = x.kind == y.kind && x.sqlType == y.sqlType && x.length == y.length &&
+               x.slot == y.slot && x.previousVar == y.previousVar;
+    }
+    if (!same) {
+        throw FirebirdException("RowSorter: stores with different columns");
+    }
+}
+
+int RowSorter::compare(const RowStore& left, std::size_t a, const RowStore& right,
+                       std::size_t b) const {
+    if (&left != &right) {
+        checkSameColumns(left, right);
+    }
+    return compareRows(left, compile(left), left.encoded(a), right.encoded(b));
+}
+
+std::size_t RowSorter::sort(RowStore& store) const {
+    const std::vector<CompiledKey> keys = compile(store);
+    std::vector<const uint8_t*>& rows = store.rows_;
+    const std::size_t n = rows.size();
+    if (n == 0) {
+        return 0;
+    }
+    auto less = [&](const uint8_t* a, const uint8_t* b) {
+        return compareRows(store, keys, a, b) < 0;
+    };
+    ++store.revision_;
+
+    const std::size_t runRows = std::max<std::size_t>(options_.runRows, 1);
+    const std::size_t runs = (n + runRows - 1) / runRows;
+    if (runs == 1) {
+        std::stable_sort(rows.begin(), rows.end(), less);
+        return 1;
+    }
+
+    // Runs are disjoint slices of the index, sorted on the shared executor
+    // (the caller included)
+    Executor::shared()->parallelFor(runs, [&](std::size_t run) {
+        const std::size_t begin = run * runRows;
+        const std::size_t end = std::min(n, begin + runRows);
+        std::stable_sort(rows.begin() + static_cast<std::ptrdiff_t>(begin),
+                         rows.begin() + static_cast<std::ptrdiff_t>(end), less);
+    }, options_.threads);
+
+    struct Cursor {
+        std::size_t run;
+        std::size_t next;
+        std::size_t end;
+    };
+    // Heap top: the smallest next row, the lower run on ties
+    auto after = [&](const Cursor& a, const Cursor& b) {
+        const int cmp = compareRows(store, keys, rows[a.next], rows[b.next]);
+        return cmp > 0 || (cmp == 0 && a.run > b.run);
+    };
+    std::priority_queue<Cursor, std::vector<Cursor>, decltype(after)> heap(after);
+    for (std::size_t run = 0; run < runs; ++run) {
+        heap.push(Cursor{run, run * runRows, std::min(n, (run + 1) * runRows)});
+    }
+    std::vector<const uint8_t*> merged;
+    merged.reserve(n);
+    while (!heap.empty()) {
+        Cursor top = heap.top();
+        heap.pop();
+        merged.push_back(rows[top.next]);
+        if (++top.next < top.end) {
+            heap.push(top);
+        }
+    }
+    rows.swap(merged);
+    return runs;
+}
+
+void RowSorter::sortRows(const RowStore& store, std::span<std::size_t> rows) const {
+    const std::vector<CompiledKey> keys = compile(store);
+    for (std::size_t row : rows) {
+        store.encoded(row);   // Range check once, not per comparison
+    }
+    std::stable_sort(rows.begin(), rows.end(), [&](std::size_t a, std::size_t b) {
+        return compareRows(store, keys, store.rows_[a], store.rows_[b]) < 0;
+    });
+}
+
+RowStore RowSorter::merge(std::span<const RowStore* const> sorted,
+                          std::shared_ptr<ResultArena> arena) const {
+    if (sorted.empty()) {
+        throw FirebirdException("RowSorter::merge: no stores");
+    }
+    for (const RowStore* store : sorted) {
+        if (!store || !store->meta_) {
+            throw FirebirdException("RowSorter::merge: null or column-less store");
+        }
+    }
+    const RowStore& first = *sorted.front();
+    for (const RowStore* store : sorted.subspan(1)) {
+        checkSameColumns(first, *store);
+    }
+    const std::vector<CompiledKey> keys = compile(first);
+
+    RowStore out = first.emptyCopy();
+    out.arena_ = arena ? std::move(arena) : std::make_shared<ResultArena>();
+
+    struct Cursor {
+        std::size_t input;
+        std::size_t next;
+    };
+    auto rowOf = [&](const Cursor& c) { return sorted[c.input]->rows_[c.next]; };
+    // Heap top: the smallest next row, the earlier input on ties
+    auto after = [&](const Cursor& a, const Cursor& b) {
+        const int cmp = compareRows(first, keys, rowOf(a), rowOf(b));
+        return cmp > 0 || (cmp == 0 && a.input > b.input);
+    };
+    std::priority_queue<Cursor, std::vector<Cursor>, decltype(after)> heap(after);
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < sorted.size(); ++i) {
+        total += sorted[i]->size();
+        if (!sorted[i]->empty()) {
+            heap.push(Cursor{i, 0});
+        }
+    }
+    out.rows_.reserve(total);
+    while (!heap.empty()) {
+        Cursor top = heap.top();
+        heap.pop();
+        const uint8_t* r = rowOf(top);
+        const std::size_t size = first.encodedSize(r);
+        auto* copy = static_cast<uint8_t*>(out.arena_->allocate(size, 1));
+        std::memcpy(copy, r, size);
+        out.rows_.push_back(copy);
+        out.encodedBytes_ += size;
+        if (++top.next < sorted[top.input]->size()) {
+            heap.push(top);
+        }
+    }
+    ++out.revision_;
+    return out;
+}
+
+} // namespace core
+} // namespace fbpp
@@ -0,0 +1,217 @@
+#include "fbpp/core/row_store_view.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <string>
+
+namespace fbpp {
+namespace core {
+
+namespace {
+
+template<typename T>
+T load(const uint8_t* p) {
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+uint8_t foldAscii(uint8_t c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<uint8_t>(c + ('a' - 'A')) : c;
+}
+
+bool sameText(std::string_view x, std::string_view y, bool fold) {
+    if (!fold) {
+        return x == y;
+    }
+    return std::equal(x.begin(), x.end(), y.begin(), y.end(), [](char a, char b) {
+        return foldAscii(static_cast<uint8_t>(a)) == foldAscii(static_cast<uint8_t>(b));
+    });
+}
+
+bool matchesText(std::string_view value, std::string_view text, TextMatch match, bool fold) {
+    switch (match) {
+        case TextMatch::Exact:
+            return sameText(value, text, fold);
+        case TextMatch::Prefix:
+            return value.size() >= text.size() &&
+                   sameText(value.substr(0, text.size()), text, fold);
+        case TextMatch::Contains:
+            break;
+    }
+    if (text.size() > value.size()) {
+        return false;
+    }
+    if (!fold) {
+        return value.find(text) != std::string_view::npos;
+    }
+    for (std::size_t at = 0; at + text.size() <= value.size(); ++at) {
+        if (sameText(value.substr(at, text.size()), text, true)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Unscaled value of a non-NULL integer slot equals `key`
+bool slotEquals(const uint8_t* slot, unsigned sqlType, int64_t key) {
+    switch (sqlType) {
+        case SQL_SHORT: return load<int16_t>(slot) == key;
+        case SQL_LONG:  return load<int32_t>(slot) == key;
+        case SQL_INT64: return load<int64_t>(slot) == key;
+        case SQL_INT128:
+            // Low word first; the high word must be the key's sign extension
+            return load<int64_t>(slot) == key && load<int64_t>(slot + 8) == (key < 0 ? -1 : 0);
+        default:        return false;
+    }
+}
+
+bool integerSlot(unsigned sqlType) {
+    return sqlType == SQL_SHORT || sqlType == SQL_LONG || sqlType == SQL_INT64 ||
+           sqlType == SQL_INT128;
+}
+
+} // namespace
+
+RowStoreView::RowStoreView(const RowStore& store)
+    : store_(&store)
+    , revision_(store.revision_) {
+    selectAll();
+}
+
+void RowStoreView::checkFresh() const {
+    if (stale()) {
+        throw FirebirdException("RowStoreView: the store changed since the view was built");
+    }
+}
+
+void RowStoreView::addIndex(unsigned column) {
+    checkFresh();
+    if (!indexed(column)) {
+        indexes_.emplace_back(*store_, column);
+    }
+}
+
+bool RowStoreView::indexed(unsigned column) const noexcept {
+    return indexFor(column) != nullptr;
+}
+
+const RowStoreIndex* RowStoreView::indexFor(unsigned column) const noexcept {
+    for (const RowStoreIndex& index : indexes_) {
+        if (index.column() == column) {
+            return &index;
+        }
+    }
+    return nullptr;
+}
+
+void RowStoreView::selectAll() {
+    if (order_.empty()) {
+        selection_.resize(store_->size());
+        std::iota(selection_.begin(), selection_.end(), std::size_t{0});
+    } else {
+        selection_ = order_;
+    }
+    filtered_ = false;
+}
+
+void RowStoreView::orderBy(std::vector<SortKey> keys) {
+    checkFresh();
+    std::vector<std::size_t> order;
+    std::vector<std::size_t> rank;
+    if (!keys.empty()) {
+        order.resize(store_->size());
+        std::iota(order.begin(), order.end(), std::size_t{0});
+        RowSorter(keys).sortRows(*store_, order);
+        rank.resize(order.size());
+        for (std::size_t position = 0; position < order.size(); ++position) {
+            rank[order[position]] = position;
+        }
+    }
+    keys_ = std::move(keys);
+    order_ = std::move(order);
+    rank_ = std::move(rank);
+
+    if (!filtered_) {
+        selectAll();
+    } else if (order_.empty()) {
+        std::sort(selection_.begin(), selection_.end());
+    } else {
+        std::sort(selection_.begin(), selection_.end(),
+                  [&](std::size_t a, std::size_t b) { return rank_[a] < rank_[b]; });
+    }
+}
+
+void RowStoreView::keepMatches(const RowStoreIndex::Matches& matches) {
+    if (!filtered_) {
+        // Matches come in row order; put them in view order
+        selection_.assign(matches.begin(), matches.end());
+        if (!order_.empty()) {
+            std::sort(selection_.begin(), selection_.end(),
+                      [&](std::size_t a, std::size_t b) { return rank_[a] < rank_[b]; });
+        }
+        filtered_ = true;
+        return;
+    }
+    std::vector<bool> hit(store_->size());
+    for (std::size_t row : matches) {
+        hit[row] = true;
+    }
+    keep([&](std::size_t row) { return hit[row]; });
+}
+
+void RowStoreView::whereEquals(unsigned column, int64_t key) {
+    checkFresh();
+    if (const RowStoreIndex* index = indexFor(column)) {
+        keepMatches(index->find(key));
+        return;
+    }
+    store_->checkColumn(column);
+    const RowStore::Column& c = store_->columns_[column];
+    if (c.kind != RowStore::Slot::Fixed || !integerSlot(c.sqlType)) {
+        throw FirebirdException("RowStoreView::whereEquals(int64_t): column " +
+                                std::to_string(column) + " is not an integer column");
+    }
+    const unsigned byte = column >> 3;
+    const uint8_t bit = static_cast<uint8_t>(1u << (column & 7));
+    keep([&](std::size_t row) {
+        const uint8_t* r = store_->rows_[row];
+        return !(r[byte] & bit) && slotEquals(r + c.slot, c.sqlType, key);
+    });
+}
+
+void RowStoreView::whereEquals(unsigned column, std::string_view key) {
+    checkFresh();
+    if (const RowStoreIndex* index = indexFor(column)) {
+        keepMatches(index->find(key));
+        return;
+    }
+    whereText(column, key, TextMatch::Exact, false);
+}
+
+void RowStoreView::whereText(unsigned column, std::string_view text, TextMatch match,
+                             bool caseInsensitive) {
+    checkFresh();
+    store_->checkColumn(column);
+    const RowStore::Column& c = store_->columns_[column];
+    if (c.kind == RowStore::Slot::Fixed) {
+        throw FirebirdException("RowStoreView: column " + std::to_string(column) +
+                                " is not a CHAR/VARCHAR column");
+    }
+    const unsigned byte = column >> 3;
+    const uint8_t bit = static_cast<uint8_t>(1u << (column & 7));
+    keep([&](std::size_t row) {
+        const uint8_t* r = store_->rows_[row];
+        return !(r[byte] & bit) &&
+               matchesText(store_->varBytes(r, c), text, match, caseInsensitive);
+    });
+}
+
+void RowStoreView::clearFilters() {
+    checkFresh();
+    selectAll();
+}
+
+} // namespace core
+} // namespace fbpp
@@ -0,0 +1,138 @@
+#include "fbpp/core/sharded_executor.hpp"
+#include "fbpp/core/cancel_scope.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/executor.hpp"
+
+#include <condition_variable>
+#include <mutex>
+
+namespace fbpp {
+namespace core {
+
+namespace {
+
+std::string describe(const std::exception_ptr& error) {
+    try {
+        std::rethrow_exception(error);
+    } catch (const std::exception& e) {
+        return e.what();
+    } catch (...) {
+        return "unknown exception";
+    }
+}
+
+} // namespace
+
+ShardedExecutor::ShardedExecutor(std::vector<Connection*> shards) : shards_(std::move(shards)) {
+    for (std::size_t i = 0; i < shards_.size(); ++i) {
+        if (!shards_[i]) {
+            throw FirebirdException("ShardedExecutor: shard " + std::to_string(i) +
+                                    " has no connection");
+        }
+    }
+}
+
+ShardedExecutor::ShardedExecutor(const std::vector<ConnectionParams>& shards) {
+    owned_.reserve(shards.size());
+    shards_.reserve(shards.size());
+    for (const ConnectionParams& params : shards) {
+        owned_.push_back(std::make_unique<Connection>(params));
+        shards_.push_back(owned_.back().get());
+    }
+}
+
+ShardedExecutor::~ShardedExecutor() = default;
+
+Connection& ShardedExecutor::shard(std::size_t index) const {
+    if (index >= shards_.size()) {
+        throw FirebirdException("ShardedExecutor shard " + std::to_string(index) +
+                                " out of range (" + std::to_string(shards_.size()) + " shards)");
+    }
+    return *shards_[index];
+}
+
+std::vector<ShardError> ShardedExecutor::forEach(
+    const std::function<void(Connection&, std::size_t)>& fn, const ShardOptions& options) {
+    const std::size_t count = shards_.size();
+    std::optional<CancelScope::Clock::time_point> deadline;
+    if (options.timeout) {
+        deadline = CancelScope::Clock::now() + *options.timeout;
+    }
+    // One stop for every shard: the caller's stop or a failFast failure
+    std::stop_source cancelAll;
+    std::optional<std::stop_callback<std::function<void()>>> forwardStop;
+    if (options.stop.stop_possible()) {
+        forwardStop.emplace(options.stop, std::function<void()>([&cancelAll] {
+                                cancelAll.request_stop();
+                            }));
+    }
+
+    struct Outcome {
+        std::exception_ptr error;
+        bool cancelled = false;
+    };
+    std::vector<Outcome> outcomes(count);
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::size_t running = count;
+
+    auto run = [&](std::size_t shard) {
+        Outcome& outcome = outcomes[shard];
+        bool started = false;
+        try {
+            CancelScope scope(*shards_[shard], deadline, cancelAll.get_token());
+            started = true;
+            try {
+                fn(*shards_[shard], shard);
+            } catch (...) {
+                outcome.cancelled = scope.fired();
+                throw;
+            }
+        } catch (...) {
+            outcome.error = std::current_exception();
+            if (!started) {
+                outcome.cancelled = true;   // Deadline passed or stop requested before the start
+            }
+        }
+        if (outcome.error && options.failFast) {
+            cancelAll.request_stop();
+        }
+        // Notify under the lock: the caller returns (and drops these
+        // locals) as soon as it can take the mutex.
+        std::lock_guard<std::mutex> lock(mutex);
+        --running;
+        finished.notify_all();
+    };
+
+    Executor& shared = *Executor::shared();
+    for (std::size_t shard = 0; shard < count; ++shard) {
+        try {
+            if (options.executor) {
+                options.executor([&run, shard] { run(shard); });
+            } else {
+                shared.post([&run, shard] { run(shard); });
+            }
+        } catch (...) {
+            // A refusing executor: run that shard here
+            run(shard);
+        }
+    }
+    {
+        // Helping on a worker of the shared executor: a forEach() nested in
+        // a task must not wait for shards queued behind it
+        std::unique_lock<std::mutex> lock(mutex);
+        shared.waitHelping(lock, finished, [&] { return running == 0; });
+    }
+
+    std::vector<ShardError> errors;
+    for (std::size_t shard = 0; shard < count; ++shard) {
+        if (outcomes[shard].error) {
+            errors.push_back(ShardError{shard, outcomes[shard].error, outcomes[shard].cancelled,
+                                        describe(outcomes[shard].error)});
+        }
+    }
+    return errors;
+}
+
+} // namespace core
+} // namespace fbpp
@@ -0,0 +1,200 @@
+#include "fbpp/core/slow_query_log.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/json_unpacker.hpp"
+#include "fbpp/core/statement.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <sstream>
+#include <thread>
+
+namespace fbpp {
+namespace core {
+
+namespace {
+
+std::atomic<SlowQueryLog*> g_slowQueryLog{nullptr};
+
+constexpr std::size_t kMaxValueChars = 64;
+
+// splitmix64; one stream per thread, so drawing takes no lock
+uint64_t nextDraw() noexcept {
+    thread_local uint64_t state =
+        std::hash<std::thread::id>{}(std::this_thread::get_id()) ^ 0x9e3779b97f4a7c15ull;
+    uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+void writeMillis(std::ostream& out, std::chrono::steady_clock::duration d) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.3f",
+                  std::chrono::duration<double, std::milli>(d).count());
+    out << text;
+}
+
+std::string valueText(const ColumnPlan& column, const uint8_t* data, const int16_t* null) {
+    const unsigned type = column.type & ~1u;
+    if (type == SQL_BLOB || type == SQL_ARRAY) {
+        return type == SQL_BLOB ? "BLOB" : "ARRAY";
+    }
+    try {
+        nlohmann::json value;
+        detail::unpackValueToJson(value, data, null, column.field, nullptr);
+        std::string text = value.dump();
+        if (text.size() > kMaxValueChars) {
+            text.resize(kMaxValueChars);
+            text += "...";
+        }
+        return text;
+    } catch (...) {
+        return "?";
+    }
+}
+
+} // namespace
+
+SlowQueryLog::SlowQueryLog(SlowQueryLogOptions options) : options_(options) {
+    if (!(options_.sampleRate >= 0.0 && options_.sampleRate <= 1.0)) {
+        throw FirebirdException("SlowQueryLog: sampleRate must be between 0 and 1");
+    }
+    if (options_.threshold.count() < 0) {
+        throw FirebirdException("SlowQueryLog: threshold must not be negative");
+    }
+    // 2^64 * rate; rate 1 does not fit and is tested apart by sample()
+    if (options_.sampleRate < 1.0) {
+        sampleBelow_ = static_cast<uint64_t>(options_.sampleRate * 18446744073709551616.0L);
+    }
+}
+
+SlowQueryLogStats SlowQueryLog::stats() const noexcept {
+    SlowQueryLogStats stats;
+    stats.sampled = sampled_.load(std::memory_order_relaxed);
+    stats.logged = logged_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool SlowQueryLog::sample() noexcept {
+    if (options_.sampleRate < 1.0 && nextDraw() >= sampleBelow_) {
+        return false;
+    }
+    sampled_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void SlowQueryLog::report(SlowQueryKind kind, uint64_t fingerprint, const Statement* statement,
+                          const SlowQueryTimings& timings, uint64_t rows, bool failed,
+                          const MessageMetadata* inputLayout, const void* input) noexcept {
+    if (timings.total() < options_.threshold) {
+        return;
+    }
+    try {
+        SlowQueryEntry entry;
+        entry.kind = kind;
+        entry.fingerprint = fingerprint;
+        entry.timings = timings;
+        entry.rows = rows;
+        entry.failed = failed;
+        if (inputLayout && input) {
+            entry.parameters = describeParameters(*inputLayout, input);
+        }
+        if (statement) {
+            entry.sql = statement->getSql();
+            if (options_.capturePlan) {
+                try {
+                    entry.plan = statement->getPlan(true);
+                } catch (const std::exception& e) {
+                    entry.plan = std::string("(unavailable: ") + e.what() + ")";
+                }
+            }
+        }
+        write(entry);
+        logged_.fetch_add(1, std::memory_order_relaxed);
+    } catch (...) {
+        // Diagnostics only; never fail the statement over them
+    }
+}
+
+std::string SlowQueryLog::describeParameters(const MessageMetadata& layout,
+                                             const void* message) const {
+    const auto* bytes = static_cast<const uint8_t*>(message);
+    std::ostringstream out;
+    const auto& plan = layout.getColumnPlan();
+    for (std::size_t i = 0; i < plan.size(); ++i) {
+        const ColumnPlan& column = plan[i];
+        const uint8_t* data = bytes + column.offset;
+        const auto* null = reinterpret_cast<const int16_t*>(bytes + column.nullOffset);
+        out << (i ? " $" : "$") << (i + 1) << '=';
+        if (*null == -1) {
+            out << "NULL";
+            continue;
+        }
+        if (options_.parameterValues) {
+            out << valueText(column, data, null);
+            continue;
+        }
+        switch (column.type & ~1u) {
+        case SQL_VARYING: {
+            uint16_t length;
+            std::memcpy(&length, data, sizeof(length));
+            out << length << 'B';
+            break;
+        }
+        case SQL_BLOB:
+            out << "BLOB";
+            break;
+        case SQL_ARRAY:
+            out << "ARRAY";
+            break;
+        default:
+            out << column.length << 'B';
+        }
+    }
+    return out.str();
+}
+
+std::string SlowQueryLog::format(const SlowQueryEntry& entry) {
+    std::ostringstream out;
+    out << (entry.kind == SlowQueryKind::Execute ? "execute " : "cursor ");
+    writeMillis(out, entry.timings.total());
+    out << " ms (pack ";
+    writeMillis(out, entry.timings.pack);
+    out << ", execute ";
+    writeMillis(out, entry.timings.execute);
+    out << ", fetch ";
+    writeMillis(out, entry.timings.fetch);
+    out << ", unpack ";
+    writeMillis(out, entry.timings.unpack);
+    out << ") rows=" << entry.rows << " fingerprint=" << std::hex << entry.fingerprint
+        << std::dec;
+    if (entry.failed) {
+        out << " failed";
+    }
+    if (!entry.sql.empty()) {
+        out << "\n  sql: " << entry.sql;
+    }
+    if (!entry.parameters.empty()) {
+        out << "\n  params: " << entry.parameters;
+    }
+    if (!entry.plan.empty()) {
+        out << "\n  plan:\n" << entry.plan;
+    }
+    return out.str();
+}
+
+void SlowQueryLog::write(const SlowQueryEntry& entry) {
+    fbpp::util::trace(options_.level, "SlowQuery", [&](auto& oss) { oss << format(entry); });
+}
+
+void setSlowQueryLog(SlowQueryLog* log) {
+    g_slowQueryLog.store(log, std::memory_order_release);
+}
+
+SlowQueryLog* getSlowQueryLog() noexcept {
+    return g_slowQueryLog.load(std::memory_order_acquire);
+}
+
+} // namespace core
+} // namespace fbpp
@@ -0,0 +1,31 @@
+#include "fbpp/core/span_observer.hpp"
+
+namespace fbpp {
+namespace core {
+
+namespace {
+std::atomic<SpanObserver*> g_spanObserver{nullptr};
+} // namespace
+
+const char* spanKindName(SpanKind kind) noexcept {
+    switch (kind) {
+        case SpanKind::Connect:   return "connect";
+        case SpanKind::Prepare:   return "prepare";
+        case SpanKind::Execute:   return "execute";
+        case SpanKind::FetchLoop: return "fetch";
+        case SpanKind::Commit:    return "commit";
+        case SpanKind::Rollback:  return "rollback";
+    }
+    return "unknown";
+}
+
+void setSpanObserver(SpanObserver* observer) {
+    g_spanObserver.store(observer, std::memory_order_release);
+}
+
+SpanObserver* getSpanObserver() noexcept {
+    return g_spanObserver.load(std::memory_order_acquire);
+}
+
+} // namespace core
+} // namespace fbpp
@@ -0,0 +1,106 @@
+#include "fbpp/core/staging_table.hpp"
+
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/result_set.hpp"
+
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <tuple>
+
+namespace fbpp {
+namespace core {
+
+namespace {
+
+std::string upper(std::string text) {
+    for (char& ch : text) {
+        ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+    }
+    return text;
+}
+
+bool relationExists(Connection& connection, const std::string& name) {
+    auto transaction = connection.StartTransaction();
+    auto stmt = connection.prepareStatement(
+        "SELECT COUNT(*) FROM RDB$RELATIONS WHERE TRIM(RDB$RELATION_NAME) = ?");
+    auto rs = transaction->openCursor(stmt, std::make_tuple(name));
+    std::tuple<int64_t> row{0};
+    rs->fetch(row);
+    rs->close();
+    transaction->Commit();
+    return std::get<0>(row) > 0;
+}
+
+// FNV-1a of the definition, for the default name
+std::string definitionHash(const std::string& definition) {
+    std::uint32_t hash = 2166136261u;
+    for (unsigned char c : definition) {
+        hash = (hash ^ c) * 16777619u;
+    }
+    char text[9];
+    std::snprintf(text, sizeof(text), "%08X", static_cast<unsigned>(hash));
+    return text;
+}
+
+} // namespace
+
+StagingTable::StagingTable(Connection& connection, std::vector<StagingColumn> columns,
+                           StagingTableOptions options)
+    : connection_(connection),
+      columns_(std::move(columns)),
+      options_(std::move(options)) {
+    if (columns_.empty()) {
+        throw FirebirdException("StagingTable: no columns");
+    }
+
+    std::string definition;
+    std::string names;
+    std::string marks;
+    for (auto& column : columns_) {
+        column.name = upper(column.name);
+        definition += (definition.empty() ? "" : ", ") + column.name + " " + column.type;
+        names += (names.empty() ? "" : ", ") + column.name;
+        marks += marks.empty() ? "?" : ", ?";
+    }
+    if (!options_.primaryKey.empty()) {
+        std::string key;
+        for (const auto& column : options_.primaryKey) {
+            key += (key.empty() ? "" : ", ") + upper(column);
+        }
+        definition += ", PRIMARY KEY (" + key + ")";
+    }
+
+    name_ = upper(!options_.name.empty() ? options_.name
+                                         : "FBPP_STAGE_" + definitionHash(definition));
+    insertSql_ = "INSERT INTO " + name_ + " (" + names + ") VALUES (" + marks + ")";
+
+    if (!relationExists(connection_, name_)) {
+        try {
+            connection_.ExecuteDDL("CREATE GLOBAL TEMPORARY TABLE " + name_ + " (" + definition +
+                                   ") ON COMMIT DELETE ROWS");
+        } catch (const FirebirdException&) {
+            // Another connection may have created it meanwhile
+            if (!relationExists(connection_, name_)) {
+                throw;
+            }
+        }
+    }
+}
+
+void StagingTable::clear(Transaction& transaction) {
+    transaction.execute(connection_.prepareStatement("DELETE FROM " + name_));
+}
+
+std::size_t StagingTable::execute(Batch& batch, Transaction& transaction) {
+    const auto result = batch.execute(&transaction, 1);
+    if (result.failedCount != 0) {
+        throw FirebirdException("StagingTable " + name_ + ": " +
+                                (result.errors.empty() ? std::string("row rejected")
+                                                       : result.errors.front()));
+    }
+    return result.successCount;
+}
+
+} // namespace core
+} // namespace fbpp
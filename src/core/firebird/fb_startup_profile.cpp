@@ -0,0 +1,153 @@
+#include "fbpp/core/startup_profile.hpp"
+#include "fbpp_util/trace.h"
+
+#include <array>
+#include <atomic>
+#include <cstdio>
+
+namespace fbpp {
+namespace core {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kPhases = 4;
+
+// Pending -> Recording (one thread wins) -> Done
+constexpr int kPending = 0;
+constexpr int kRecording = 1;
+constexpr int kDone = 2;
+
+struct PhaseSlot {
+    std::atomic<int> state{kPending};
+    int64_t tookMicros = 0;   // Written before state becomes kDone
+    int64_t atMicros = 0;
+};
+
+std::array<PhaseSlot, kPhases>& slots() noexcept {
+    static std::array<PhaseSlot, kPhases> table;
+    return table;
+}
+
+// First use wins: the dynamic initializer below runs it at load time
+// unless another initializer reached fbpp before that
+Clock::time_point origin() noexcept {
+    static const Clock::time_point loaded = Clock::now();
+    return loaded;
+}
+
+[[maybe_unused]] const Clock::time_point g_loaded = origin();
+
+int64_t micros(Clock::duration d) noexcept {
+    return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+}
+
+template<typename Profile>
+auto& timingOf(Profile& profile, StartupPhase phase) noexcept {
+    switch (phase) {
+        case StartupPhase::MasterInit:   return profile.masterInit;
+        case StartupPhase::ProviderLoad: return profile.providerLoad;
+        case StartupPhase::FirstAttach:  return profile.firstAttach;
+        case StartupPhase::FirstPrepare: break;
+    }
+    return profile.firstPrepare;
+}
+
+void writeMillis(std::string& out, std::chrono::microseconds value) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.3f", static_cast<double>(value.count()) / 1000.0);
+    out += text;
+}
+
+} // namespace
+
+const char* startupPhaseName(StartupPhase phase) noexcept {
+    switch (phase) {
+        case StartupPhase::MasterInit:   return "master init";
+        case StartupPhase::ProviderLoad: return "provider load";
+        case StartupPhase::FirstAttach:  return "first attach";
+        case StartupPhase::FirstPrepare: return "first prepare";
+    }
+    return "unknown";
+}
+
+const StartupPhaseTiming& StartupProfile::operator[](StartupPhase phase) const noexcept {
+    return timingOf(*this, phase);
+}
+
+std::string StartupProfile::describe() const {
+    std::string out;
+    for (std::size_t i = 0; i < kPhases; ++i) {
+        const auto phase = static_cast<StartupPhase>(i);
+        const StartupPhaseTiming& timing = (*this)[phase];
+        if (i) {
+            out += '\n';
+        }
+        out += startupPhaseName(phase);
+        if (!timing.reached) {
+            out += " not reached";
+            continue;
+        }
+        out += ' ';
+        writeMillis(out, timing.took);
+        out += " ms (at ";
+        writeMillis(out, timing.at);
+        out += " ms)";
+    }
+    return out;
+}
+
+StartupProfile startupProfile() noexcept {
+    StartupProfile profile;
+    for (std::size_t i = 0; i < kPhases; ++i) {
+        const PhaseSlot& slot = slots()[i];
+        if (slot.state.load(std::memory_order_acquire) != kDone) {
+            continue;
+        }
+        StartupPhaseTiming& timing = timingOf(profile, static_cast<StartupPhase>(i));
+        timing.reached = true;
+        timing.took = std::chrono::microseconds(slot.tookMicros);
+        timing.at = std::chrono::microseconds(slot.atMicros);
+    }
+    return profile;
+}
+
+namespace detail {
+
+Clock::time_point startupClock(StartupPhase phase) noexcept {
+    const PhaseSlot& slot = slots()[static_cast<std::size_t>(phase)];
+    if (slot.state.load(std::memory_order_relaxed) != kPending) {
+        return {};
+    }
+    return Clock::now();
+}
+
+void recordStartupPhase(StartupPhase phase, Clock::time_point started) noexcept {
+    if (started == Clock::time_point{}) {
+        return;
+    }
+    PhaseSlot& slot = slots()[static_cast<std::size_t>(phase)];
+    int expected = kPending;
+    if (!slot.state.compare_exchange_strong(expected, kRecording, std::memory_order_acq_rel)) {
+        return;
+    }
+    const auto ended = Clock::now();
+    slot.tookMicros = micros(ended - started);
+    slot.atMicros = micros(ended - origin());
+    slot.state.store(kDone, std::memory_order_release);
+
+    try {
+        fbpp::util::trace(fbpp::util::TraceLevel::info, "Startup", [&](auto& oss) {
+            oss << startupPhaseName(phase) << ' ' << slot.tookMicros / 1000.0 << " ms (at "
+                << slot.atMicros / 1000.0 << " ms)";
+        });
+    } catch (...) {
+        // The profile keeps the timing; only the trace line is lost
+    }
+}
+
+} // namespace detail
+
+} // namespace core
+} // namespace fbpp
@@ -4,39 +4,139 @@
 #include "fbpp/core/message_metadata.hpp"
 #include "fbpp/core/result_set.hpp"
 #include "fbpp/core/batch.hpp"
+#include "fbpp/core/cancel_scope.hpp"
+#include "fbpp/core/deadline.hpp"
+#include "fbpp/core/param_binder.hpp"
 #include "fbpp/core/exception.hpp"
+#include "fbpp/core/statement_cache.hpp"
+#include "fbpp/core/statement_metrics.hpp"
+#include "fbpp/core/span_observer.hpp"
+#include "fbpp/core/slow_query_log.hpp"
+#include "fbpp/core/detail/deferred_release.hpp"
+#include "fbpp/core/detail/fetch_buffers.hpp"
 #include "fbpp/core/detail/firebird_raii.hpp"
+#include "fbpp/core/detail/inline_blob.hpp"
+#include "fbpp/core/detail/sql_row_limit.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <cstring>
+#include <limits>
+#include <optional>
+#include <utility>
 
 namespace fbpp {
 namespace core {
 
+namespace {
+
+// What a singleton SELECT without a row fails with
+bool isStreamEof(const Firebird::FbException& error) {
+    const ISC_STATUS* errors = error.getStatus()->getErrors();
+    return errors[0] == isc_arg_gds && errors[1] == isc_stream_eof;
+}
+
+// Spends the thread's Deadline on one execute / openCursor. Firebird 4+
+// gets it as the statement timeout, which the server also applies to the
+// cursor's fetches; the previous timeout is restored afterwards (a cursor
+// keeps the timer it was opened with). Older servers get a CancelScope
+// around the call.
+class DeadlineBound {
+public:
+    DeadlineBound(Statement& statement, Connection* connection, const char* stage) {
+        const Deadline* deadline = Deadline::current();
+        if (!deadline) {
+            return;
+        }
+        deadline->check(stage);
+        if (!connection) {
+            return;
+        }
+        int engine = 0;
+        {
+            // The version probe is a query itself: keep it out of the budget
+            DeadlineScope::Suspend unbounded;
+            engine = connection->getEngineMajorVersion();
+        }
+        if (engine < 4) {
+            cancel_.emplace(*connection, deadline->at());
+            return;
+        }
+        const auto left = std::clamp<int64_t>(deadline->remaining().count(), 1,
+                                              std::numeric_limits<unsigned>::max());
+        const unsigned saved = statement.getTimeout();
+        if (saved == 0 || static_cast<unsigned>(left) < saved) {
+            statement.setTimeout(static_cast<unsigned>(left));
+            statement_ = &statement;
+            saved_ = saved;
+        }
+    }
+
+    ~DeadlineBound() {
+        if (statement_) {
+            try {
+                statement_->setTimeout(saved_);
+            } catch (...) {
+            }
+        }
+    }
+
+    DeadlineBound(const DeadlineBound&) = delete;
+    DeadlineBound& operator=(const DeadlineBound&) = delete;
+
+private:
+    Statement* statement_ = nullptr;    // Set while its timeout is ours
+    unsigned saved_ = 0;
+    std::optional<CancelScope> cancel_;
+};
+
+} // namespace
+
 Statement::Statement(Firebird::IStatement* stmt, Connection* connection)
     : env_(Environment::getInstance()),
-      status_(env_.getMaster()->getStatus()),
+      status_(env_.acquireStatus()),
       statusWrapper_(status_),
       statement_(stmt), connection_(connection) {
     if (!statement_) {
         throw FirebirdException("Invalid statement pointer");
     }
+    if (connection_) {
+        releases_ = connection_->deferredRelease();
+        generation_ = connection_->generation();
+    }
 }
 
 Statement::Statement(Statement&& other) noexcept
     : env_(Environment::getInstance()),
-      status_(env_.getMaster()->getStatus()),
+      status_(env_.acquireStatus()),
       statusWrapper_(status_),
       statement_(other.statement_),
       connection_(other.connection_),
+      releases_(std::move(other.releases_)),
       inputMetadata_(std::move(other.inputMetadata_)),
       outputMetadata_(std::move(other.outputMetadata_)),
+      inputMetadataLoaded_(other.inputMetadataLoaded_),
+      outputMetadataLoaded_(other.outputMetadataLoaded_),
+      inputLayout_(std::move(other.inputLayout_)),
+      outputLayout_(std::move(other.outputLayout_)),
       type_(other.type_),
       flags_(other.flags_),
-      metadataLoaded_(other.metadataLoaded_),
+      typeLoaded_(other.typeLoaded_),
+      flagsLoaded_(other.flagsLoaded_),
+      plans_{std::move(other.plans_[0]), std::move(other.plans_[1])},
       namedParamMapping_(std::move(other.namedParamMapping_)),
-      hasNamedParams_(other.hasNamedParams_) {
+      hasNamedParams_(other.hasNamedParams_),
+      metrics_(std::move(other.metrics_)),
+      fetchBuffers_(std::move(other.fetchBuffers_)),
+      sql_(std::move(other.sql_)),
+      fingerprint_(other.fingerprint_),
+      prepareFlags_(other.prepareFlags_),
+      generation_(other.generation_) {
     other.statement_ = nullptr;
     other.connection_ = nullptr;
     other.hasNamedParams_ = false;
+    other.inputMetadataLoaded_ = false;
+    other.outputMetadataLoaded_ = false;
 }
 
 Statement& Statement::operator=(Statement&& other) noexcept {
@@ -44,28 +144,53 @@ Statement& Statement::operator=(Statement&& other) noexcept {
         cleanup();
         statement_ = other.statement_;
         connection_ = other.connection_;
+        releases_ = std::move(other.releases_);
         inputMetadata_ = std::move(other.inputMetadata_);
         outputMetadata_ = std::move(other.outputMetadata_);
+        inputMetadataLoaded_ = other.inputMetadataLoaded_;
+        outputMetadataLoaded_ = other.outputMetadataLoaded_;
+        inputLayout_ = std::move(other.inputLayout_);
+        outputLayout_ = std::move(other.outputLayout_);
         type_ = other.type_;
         flags_ = other.flags_;
-        metadataLoaded_ = other.metadataLoaded_;
+        typeLoaded_ = other.typeLoaded_;
+        flagsLoaded_ = other.flagsLoaded_;
+        plans_[0] = std::move(other.plans_[0]);
+        plans_[1] = std::move(other.plans_[1]);
         namedParamMapping_ = std::move(other.namedParamMapping_);
         hasNamedParams_ = other.hasNamedParams_;
+        metrics_ = std::move(other.metrics_);
+        fetchBuffers_ = std::move(other.fetchBuffers_);
+        sql_ = std::move(other.sql_);
+        fingerprint_ = other.fingerprint_;
+        prepareFlags_ = other.prepareFlags_;
+        generation_ = other.generation_;
+        limitRows_ = 0;
+        limitKey_.reset();
+        binder_.reset();   // Bound to the statement it was built for
 
         other.statement_ = nullptr;
         other.connection_ = nullptr;
         other.hasNamedParams_ = false;
+        other.inputMetadataLoaded_ = false;
+        other.outputMetadataLoaded_ = false;
     }
     return *this;
 }
 
 Statement::~Statement() {
     cleanup();
-    statusWrapper_.dispose();
+    env_.releaseStatus(status_);
 }
 
 void Statement::cleanup() {
     if (statement_) {
+        // Evictions and last owners going away hand the handle over to the
+        // connection's queue rather than wait for the free round trip
+        if (auto queue = releases_.lock(); queue && queue->push(statement_)) {
+            statement_ = nullptr;
+            return;
+        }
         try {
             auto& st = status();
             statement_->free(&st);
@@ -80,6 +205,60 @@ void Statement::cleanup() {
     }
 }
 
+void Statement::revalidate(Transaction& transaction) {
+    if (!connection_ || generation_ == connection_->generation() || sql_.empty()) {
+        return;
+    }
+    Firebird::IAttachment* attachment = connection_->getAttachment();
+    if (!attachment) {
+        throw FirebirdException("Not connected to database");
+    }
+
+    Firebird::IStatement* fresh = nullptr;
+    try {
+        auto& st = status();
+        fresh = attachment->prepare(&st, transaction.getRawTransaction(), 0, sql_.c_str(), 3,
+                                    connection_->prepareFlags(prepareFlags_));
+    } catch (const Firebird::FbException& e) {
+        throw FirebirdException(e);
+    }
+    if (!fresh) {
+        throw FirebirdException("Failed to prepare statement");
+    }
+
+    // The old handle died with its attachment: nothing to free server-side
+    statement_->release();
+    statement_ = fresh;
+    generation_ = connection_->generation();
+    releases_ = connection_->deferredRelease();
+
+    // Formats are read from the new handle; the binder follows on its next use
+    inputMetadata_.reset();
+    outputMetadata_.reset();
+    coercionKey_.reset();
+    coercedOutput_.reset();
+    inputMetadataLoaded_ = false;
+    outputMetadataLoaded_ = false;
+    inputLayout_.reset();
+    outputLayout_.reset();
+    typeLoaded_ = false;
+    flagsLoaded_ = false;
+    plans_[0].reset();
+    plans_[1].reset();
+
+    fbpp::util::trace(fbpp::util::TraceLevel::info, "Statement",
+                [&](auto& oss) { oss << "Prepared again after reconnect: " << sql_.substr(0, 100); });
+}
+
+FirebirdException Statement::requestFailed(const Firebird::FbException& error) const {
+    FirebirdException converted(error);
+    if (connection_) {
+        connection_->noteRequestFailure(converted);
+        connection_->noteSchemaError(converted);
+    }
+    return converted;
+}
+
 unsigned Statement::execute(Transaction* transaction) {
     return execute(transaction, nullptr, nullptr, nullptr, nullptr);
 }
@@ -88,30 +267,99 @@ unsigned Statement::execute(Transaction* transaction,
                            Firebird::IMessageMetadata* inMetadata,
                            const void* inBuffer,
                            Firebird::IMessageMetadata* outMetadata,
-                           void* outBuffer) {
+                           void* outBuffer,
+                           bool countRecords,
+                           bool* rowFound) {
     if (!statement_) {
         throw FirebirdException("Statement is not prepared");
     }
     if (!transaction || !transaction->isActive()) {
         throw FirebirdException("Invalid or inactive transaction");
     }
+    revalidate(*transaction);
+    if (connection_) {
+        connection_->releaseDeferredHandles();
+    }
+    DeadlineBound bound(*this, connection_, "execute");
+    
+    detail::SpanScope span(SpanKind::Execute);
+    if (span.active()) {
+        span.setInput(inMetadata, inBuffer);
+        span.start(sql_, getFingerprint());
+    }
+
+    // A call drawn by the slow-query log is timed with the packing before it
+    SlowQueryLog* slowLog = getSlowQueryLog();
+    if (slowLog && !slowLog->sample()) {
+        slowLog = nullptr;
+    }
+    SlowQueryTimings timings;
+    timings.pack = std::exchange(packTime_, {});
+    std::chrono::steady_clock::time_point started{};
+    auto reportSlow = [&](uint64_t rows, bool failed) {
+        timings.execute = std::chrono::steady_clock::now() - started;
+        slowLog->report(SlowQueryKind::Execute, getFingerprint(), this, timings, rows, failed,
+                        inputLayoutOf(inMetadata).get(), inBuffer);
+    };
     
     try {
         auto& st = status();
         
         auto tra = transaction->getRawTransaction();
-        // Cast away const for Firebird API (it doesn't modify the input buffer)
-        statement_->execute(&st, tra, inMetadata, const_cast<void*>(inBuffer), outMetadata, outBuffer);
+        // Read before the clock starts so the info request is not timed
+        std::optional<ServerCounters> countersBefore = readServerCounters();
+        if (metrics_ || slowLog) {
+            started = std::chrono::steady_clock::now();
+        }
+        {
+            detail::PhaseTimer wire(metrics_.get(), Phase::Wire);
+            if (rowFound) {
+                *rowFound = true;
+            }
+            try {
+                // Cast away const for Firebird API (it doesn't modify the input buffer)
+                statement_->execute(&st, tra, inMetadata, const_cast<void*>(inBuffer),
+                                    outMetadata, outBuffer);
+            } catch (const Firebird::FbException& e) {
+                if (!rowFound || !isStreamEof(e)) {
+                    throw;
+                }
+                *rowFound = false;
+            }
+        }
         
-        // Get affected records count
-        try {
-            return static_cast<unsigned>(getAffectedRecords());
-        } catch (...) {
-            return 0;  // If we can't get affected records, return 0
+        unsigned affected = 0;
+        if (countRecords) {
+            // Get affected records count
+            try {
+                affected = static_cast<unsigned>(getAffectedRecords());
+            } catch (...) {
+                affected = 0;  // If we can't get affected records, return 0
+            }
         }
+        if (metrics_) {
+            // The affected-records info request is part of the call's cost
+            metrics_->recordExecute(std::chrono::steady_clock::now() - started,
+                                    inBuffer ? messageBytes(inMetadata, true) : 0,
+                                    outBuffer ? messageBytes(outMetadata, false) : 0,
+                                    affected);
+            if (countersBefore) {
+                if (auto after = readServerCounters()) {
+                    metrics_->recordServerCounters(ServerCounters::delta(*after, *countersBefore));
+                }
+            }
+        }
+        if (slowLog) {
+            reportSlow(affected, false);
+        }
+        span.setRows(affected);
+        return affected;
     } catch (const Firebird::FbException& e) {
+        if (slowLog) {
+            reportSlow(0, true);
+        }
         // Convert Firebird exception to our exception type
-        throw FirebirdException(e);
+        throw requestFailed(e);
     } catch (const FirebirdException& e) {
         throw;  // Re-throw our own exceptions
     } catch (const std::exception& e) {
@@ -125,6 +373,51 @@ std::unique_ptr<ResultSet> Statement::openCursor(Transaction* transaction, unsig
     return openCursor(transaction, nullptr, nullptr, nullptr, flags);
 }
 
+std::unique_ptr<ResultSet> Statement::openCursor(Transaction* transaction, RowLimit limit) {
+    std::shared_ptr<Statement> limited = limitedTo(limit.rows);
+    auto rs = limited ? limited->openCursor(transaction, 0u) : openCursor(transaction, 0u);
+    if (limited) {
+        rs->retainStatement(std::move(limited));
+    }
+    rs->setRowLimit(limit.rows);
+    return rs;
+}
+
+std::shared_ptr<Statement> Statement::limitedTo(uint64_t rows) {
+    // A prepare per call would cost more than the rows it saves
+    if (rows == 0 || !connection_ || sql_.empty() ||
+        !connection_->getOptions().statementCache.enabled) {
+        return nullptr;
+    }
+    if (rows != limitRows_) {
+        limitRows_ = rows;
+        limitKey_.reset();
+        if (auto text = detail::limitRowsSql(sql_, rows)) {
+            limitKey_ = std::make_shared<const SqlKey>(std::move(*text), prepareFlags_);
+        }
+    }
+    if (!limitKey_) {
+        return nullptr;
+    }
+    std::shared_ptr<Statement> limited;
+    try {
+        limited = connection_->prepareStatement(*limitKey_);
+    } catch (const FirebirdException&) {
+        // Lost attachments surface on the unlimited cursor; any other
+        // failure only means the text does not take the clause after all
+        if (!connection_->isConnected()) {
+            throw;
+        }
+        limitKey_.reset();
+        return nullptr;
+    }
+    if (hasNamedParams_ && !limited->hasNamedParameters()) {
+        // The clause adds no parameters: the names keep their positions
+        limited->setNamedParamMapping(namedParamMapping_, true);
+    }
+    return limited;
+}
+
 std::unique_ptr<ResultSet> Statement::openCursor(std::shared_ptr<Transaction> transaction) {
     if (!transaction) {
         throw FirebirdException("Invalid or inactive transaction");
@@ -138,67 +431,220 @@ std::unique_ptr<ResultSet> Statement::openCursor(Transaction* transaction,
                                                  const void* inBuffer,
                                                  Firebird::IMessageMetadata* outMetadata,
                                                  unsigned flags) {
+    return openCursorImpl(transaction, inMetadata, inBuffer, outMetadata, flags, false);
+}
+
+std::unique_ptr<ResultSet> Statement::openBorrowedCursor(Transaction& transaction, unsigned flags) {
+    return openCursorImpl(&transaction, nullptr, nullptr, nullptr, flags, true);
+}
+
+std::unique_ptr<ResultSet> Statement::openCursor(Transaction* transaction,
+                                                 const OutputCoercion& coercion,
+                                                 unsigned flags) {
+    return openCursorImpl(transaction, nullptr, nullptr, nullptr, flags, false, &coercion);
+}
+
+std::unique_ptr<ResultSet> Statement::openCursor(
+    Transaction* transaction,
+    const std::shared_ptr<const MessageMetadata>& outFormat,
+    unsigned flags) {
+    return openCursorImpl(transaction, nullptr, nullptr, nullptr, flags, false, nullptr,
+                          outFormat);
+}
+
+std::shared_ptr<const MessageMetadata>
+Statement::getCoercedOutputMetadata(const OutputCoercion& coercion) const {
+    std::string key = coercion.toString();
+    if (!coercionKey_ || *coercionKey_ != key) {
+        auto native = getOutputMetadata();
+        coercedOutput_ = native ? coerceOutput(*native, coercion) : nullptr;
+        coercionKey_ = std::move(key);
+    }
+    return coercedOutput_;
+}
+
+std::unique_ptr<ResultSet> Statement::openCursorImpl(Transaction* transaction,
+                                                     Firebird::IMessageMetadata* inMetadata,
+                                                     const void* inBuffer,
+                                                     Firebird::IMessageMetadata* outMetadata,
+                                                     unsigned flags,
+                                                     bool borrowed,
+                                                     const OutputCoercion* coercion,
+                                                     std::shared_ptr<const MessageMetadata> format) {
     if (!statement_) {
         throw FirebirdException("Statement is not prepared");
     }
     if (!transaction || !transaction->isActive()) {
         throw FirebirdException("Invalid or inactive transaction");
     }
+    revalidate(*transaction);
+    // After revalidate(): a new handle may describe its output differently
+    if (!format && coercion) {
+        format = getCoercedOutputMetadata(*coercion);
+    }
+    if (format) {
+        outMetadata = format->getRawMetadata();
+    }
+    // Also closes a dropped cursor of this statement before it is reopened
+    if (connection_) {
+        connection_->releaseDeferredHandles();
+    }
+    DeadlineBound bound(*this, connection_, "openCursor");
+    
+    // The fetch-loop span runs from here to ResultSet::close()
+    detail::SpanScope span(SpanKind::FetchLoop);
+    if (span.active()) {
+        span.setInput(inMetadata, inBuffer);
+        span.start(sql_, getFingerprint());
+    }
+
+    // A cursor drawn by the slow-query log is timed until ResultSet::close()
+    SlowQueryLog* slowLog = getSlowQueryLog();
+    if (slowLog && !slowLog->sample()) {
+        slowLog = nullptr;
+    }
+    SlowQueryTimings timings;
+    timings.pack = std::exchange(packTime_, {});
     
     try {
         auto& st = status();
 
         auto tra = transaction->getRawTransaction();
-        // Cast away const for Firebird API (it doesn't modify the buffer)
-        auto cursor = statement_->openCursor(&st, tra, inMetadata, const_cast<void*>(inBuffer), outMetadata, flags);
+        std::optional<ServerCounters> countersBefore = readServerCounters();
+        const auto started = metrics_ || slowLog ? std::chrono::steady_clock::now()
+                                                 : std::chrono::steady_clock::time_point{};
+        Firebird::IResultSet* cursor = nullptr;
+        try {
+            detail::PhaseTimer wire(metrics_.get(), Phase::Wire);
+            // Cast away const for Firebird API (it doesn't modify the buffer)
+            cursor = statement_->openCursor(&st, tra, inMetadata, const_cast<void*>(inBuffer),
+                                            outMetadata, flags);
+        } catch (const Firebird::FbException&) {
+            if (slowLog) {
+                timings.execute = std::chrono::steady_clock::now() - started;
+                slowLog->report(SlowQueryKind::Cursor, getFingerprint(), this, timings, 0, true,
+                                inputLayoutOf(inMetadata).get(), inBuffer);
+            }
+            throw;
+        }
+        if (slowLog) {
+            timings.execute = std::chrono::steady_clock::now() - started;
+        }
 
         if (!cursor) {
             throw FirebirdException("Failed to open cursor");
         }
+        if (metrics_) {
+            metrics_->recordOpenCursor(std::chrono::steady_clock::now() - started,
+                                       inBuffer ? messageBytes(inMetadata, true) : 0);
+        }
 
         // Anything failing past this point must close+release the cursor,
         // or it stays open server-side on the transaction.
         try {
-            auto meta = outMetadata ? outMetadata : statement_->getOutputMetadata(&st);
-            auto metadataWrapper = std::make_unique<MessageMetadata>(meta);
+            // Default output format: share the statement's cached metadata.
+            // An explicit outMetadata gets its own wrapper.
+            std::shared_ptr<const MessageMetadata> metadataWrapper =
+                format        ? std::move(format)
+                : outMetadata ? std::make_shared<MessageMetadata>(outMetadata)
+                              : getOutputMetadata();
 
             // The cursor owns its transaction (a server-side cursor is only
             // usable while the transaction lives). Every public API hands
             // out Transactions via shared_ptr; a non-shared Transaction
             // used to silently produce a cursor that could not load BLOBs.
+            // A borrowed cursor aliases an empty shared_ptr instead: BLOB
+            // reads work, and no reference count is touched.
             std::shared_ptr<Transaction> transactionShared;
-            try {
-                transactionShared = transaction->shared_from_this();
-            } catch (const std::bad_weak_ptr&) {
-                throw FirebirdException(
-                    "openCursor requires a shared_ptr-managed Transaction "
-                    "(use Connection::StartTransaction)");
+            if (borrowed) {
+                transactionShared = std::shared_ptr<Transaction>(std::shared_ptr<Transaction>{},
+                                                                 transaction);
+            } else {
+                try {
+                    transactionShared = transaction->shared_from_this();
+                } catch (const std::bad_weak_ptr&) {
+                    throw FirebirdException(
+                        "openCursor requires a shared_ptr-managed Transaction "
+                        "(use Connection::StartTransaction)");
+                }
+            }
+            // Forward-only, and not positioned on by WHERE CURRENT OF: the
+            // connection's prefetch window applies
+            unsigned prefetch = 1;
+            if (connection_ && metadataWrapper && !(flags & CURSOR_TYPE_SCROLLABLE) &&
+                getType() != isc_info_sql_stmt_select_for_upd) {
+                prefetch = connection_->transferTuning().prefetchFor(
+                    metadataWrapper->getAlignedLength());
+            }
+            auto resultSet = std::make_unique<ResultSet>(cursor, std::move(metadataWrapper),
+                                                         std::move(transactionShared));
+            if (borrowed) {
+                resultSet->setRowOwnership(RowOwnership::borrowed);
+            }
+            if (prefetch > 1) {
+                resultSet->setPrefetch(prefetch);
+            }
+            // A borrowed cursor refers to the stash without a reference, as
+            // it does to the statement
+            if (!fetchBuffers_) {
+                fetchBuffers_ = std::make_shared<detail::FetchBufferStash>();
+            }
+            resultSet->recycleBuffers(
+                borrowed ? std::shared_ptr<detail::FetchBufferStash>(
+                               std::shared_ptr<detail::FetchBufferStash>{}, fetchBuffers_.get())
+                         : fetchBuffers_);
+            if (connection_) {
+                resultSet->trackMemory(connection_->memoryAccount());
+            }
+            if (metrics_) {
+                resultSet->setMetrics(metrics_);
+                if (countersBefore) {
+                    resultSet->setServerCountersBaseline(std::move(*countersBefore));
+                }
             }
-            return std::make_unique<ResultSet>(cursor, std::move(metadataWrapper),
-                                               std::move(transactionShared));
+            if (span.started()) {
+                resultSet->attachSpan(span.observer(), span.release());
+            }
+            if (slowLog) {
+                auto probe = std::make_unique<detail::SlowQueryProbe>();
+                probe->log = slowLog;
+                probe->fingerprint = getFingerprint();
+                probe->statement = borrowed ? this : nullptr;
+                probe->timings = timings;
+                // The input message is gone by close(): keep a copy to describe
+                if (inBuffer && (probe->inputLayout = inputLayoutOf(inMetadata))) {
+                    const auto* bytes = static_cast<const uint8_t*>(inBuffer);
+                    probe->input.assign(bytes, bytes + probe->inputLayout->getMessageLength());
+                }
+                resultSet->attachSlowQuery(std::move(probe));
+            }
+            return resultSet;
         } catch (...) {
             try { cursor->close(&st); } catch (...) { /* best effort */ }
             cursor->release();
             throw;
         }
     } catch (const Firebird::FbException& e) {
-        throw FirebirdException(e);
+        throw requestFailed(e);
     }
 }
 
+size_t Statement::recycledFetchBytes() const noexcept {
+    return fetchBuffers_ ? fetchBuffers_->capacity() : 0;
+}
+
 unsigned Statement::getType() const {
     if (!statement_) {
         throw FirebirdException("Statement is not prepared");
     }
 
-    // type_ and flags_ share metadataLoaded_, so both must be loaded
-    // together — otherwise whichever getter runs second returns 0 forever.
-    if (!metadataLoaded_) {
+    // Separate from flags_: the default prepare prefetches the type only,
+    // so asking for the flags here would cost a round trip
+    if (!typeLoaded_) {
         try {
             auto& st = status();
             type_ = statement_->getType(&st);
-            flags_ = statement_->getFlags(&st);
-            metadataLoaded_ = true;
+            typeLoaded_ = true;
         } catch (const Firebird::FbException& e) {
             throw FirebirdException(e);
         }
@@ -244,13 +690,11 @@ unsigned Statement::getFlags() const {
         throw FirebirdException("Statement is not prepared");
     }
     
-    // Loads both fields — see getType().
-    if (!metadataLoaded_) {
+    if (!flagsLoaded_) {
         try {
             auto& st = status();
-            type_ = statement_->getType(&st);
             flags_ = statement_->getFlags(&st);
-            metadataLoaded_ = true;
+            flagsLoaded_ = true;
         } catch (const Firebird::FbException& e) {
             throw FirebirdException(e);
         }
@@ -264,14 +708,18 @@ std::string Statement::getPlan(bool detailed) const {
         throw FirebirdException("Statement is not prepared");
     }
     
-    try {
-        auto& st = status();
+    auto& cached = plans_[detailed ? 1 : 0];
+    if (!cached) {
+        try {
+            auto& st = status();
 
-        const char* plan = statement_->getPlan(&st, detailed);
-        return plan ? std::string(plan) : std::string();
-    } catch (const Firebird::FbException& e) {
-        throw FirebirdException(e);
+            const char* plan = statement_->getPlan(&st, detailed);
+            cached = plan ? std::string(plan) : std::string();
+        } catch (const Firebird::FbException& e) {
+            throw FirebirdException(e);
+        }
     }
+    return *cached;
 }
 
 uint64_t Statement::getAffectedRecords() const {
@@ -288,7 +736,7 @@ uint64_t Statement::getAffectedRecords() const {
     }
 }
 
-std::unique_ptr<MessageMetadata> Statement::getInputMetadata() const {
+std::shared_ptr<const MessageMetadata> Statement::loadMetadata(bool input) const {
     if (!statement_) {
         throw FirebirdException("Statement is not prepared");
     }
@@ -296,34 +744,76 @@ std::unique_ptr<MessageMetadata> Statement::getInputMetadata() const {
     try {
         auto& st = status();
         
-        auto meta = statement_->getInputMetadata(&st);
-        if (meta) {
-            return std::make_unique<MessageMetadata>(meta);
+        auto meta = input ? statement_->getInputMetadata(&st)
+                          : statement_->getOutputMetadata(&st);
+        if (!meta) {
+            return nullptr;
         }
         
-        return nullptr;
+        auto wrapper = std::make_shared<MessageMetadata>(
+            meta, input ? inputLayout_ : outputLayout_);
+        // Fields, upper-case name index and column plan are built here,
+        // once per prepare, instead of on the first execute/fetch.
+        wrapper->getColumnPlan();
+        return wrapper;
     } catch (const Firebird::FbException& e) {
         throw FirebirdException(e);
     }
 }
 
-std::unique_ptr<MessageMetadata> Statement::getOutputMetadata() const {
-    if (!statement_) {
-        throw FirebirdException("Statement is not prepared");
+uint64_t Statement::getFingerprint() const {
+    if (fingerprint_ == 0 && !sql_.empty()) {
+        fingerprint_ = SqlKey::hashOf(sql_, 0);
     }
+    return fingerprint_;
+}
     
+unsigned Statement::messageBytes(Firebird::IMessageMetadata* raw, bool input) const {
+    if (!raw) {
+        return 0;
+    }
+    const auto& cached = input ? inputMetadata_ : outputMetadata_;
+    if (cached && cached->getRawMetadata() == raw) {
+        return cached->getMessageLength();
+    }
     try {
-        auto& st = status();
+        return raw->getMessageLength(&status());
+    } catch (const Firebird::FbException&) {
+        return 0;   // Metrics only; never fail the call over them
+    }
+}
 
-        auto meta = statement_->getOutputMetadata(&st);
-        if (meta) {
-            return std::make_unique<MessageMetadata>(meta);
-        }
+std::optional<ServerCounters> Statement::readServerCounters() const {
+    if (!metrics_ || !metrics_->capturesServerCounters() || !connection_) {
+        return std::nullopt;
+    }
+    try {
+        return connection_->getServerCounters();
+    } catch (...) {
+        return std::nullopt;
+    }
+}
 
-        return nullptr;
-    } catch (const Firebird::FbException& e) {
-        throw FirebirdException(e);
+std::shared_ptr<const MessageMetadata>
+Statement::inputLayoutOf(Firebird::IMessageMetadata* raw) const {
+    auto cached = raw ? getInputMetadata() : nullptr;
+    return cached && cached->getRawMetadata() == raw ? cached : nullptr;
+}
+
+std::shared_ptr<const MessageMetadata> Statement::getInputMetadata() const {
+    if (!inputMetadataLoaded_) {
+        inputMetadata_ = loadMetadata(true);
+        inputMetadataLoaded_ = true;
     }
+    return inputMetadata_;
+}
+
+std::shared_ptr<const MessageMetadata> Statement::getOutputMetadata() const {
+    if (!outputMetadataLoaded_) {
+        outputMetadata_ = loadMetadata(false);
+        outputMetadataLoaded_ = true;
+    }
+    return outputMetadata_;
 }
 
 unsigned Statement::getTimeout() const {
@@ -354,6 +844,20 @@ void Statement::setTimeout(unsigned timeout) {
     }
 }
 
+bool Statement::setMaxInlineBlobSize(unsigned bytes) {
+    if (!statement_) {
+        throw FirebirdException("Statement is not prepared");
+    }
+    return detail::trySetMaxInlineBlobSize(statement_, status(), bytes);
+}
+
+unsigned Statement::getMaxInlineBlobSize() const {
+    if (!statement_) {
+        throw FirebirdException("Statement is not prepared");
+    }
+    return detail::tryGetMaxInlineBlobSize(statement_, status());
+}
+
 Firebird::IBatch* Statement::createBatch(Firebird::IMessageMetadata* inMetadata,
                                          unsigned parLength,
                                          const unsigned char* par) {
@@ -385,13 +889,28 @@ void Statement::free() {
         // Clear cached metadata
         inputMetadata_.reset();
         outputMetadata_.reset();
-        metadataLoaded_ = false;
+        coercionKey_.reset();
+        coercedOutput_.reset();
+        inputMetadataLoaded_ = false;
+        outputMetadataLoaded_ = false;
+        typeLoaded_ = false;
+        flagsLoaded_ = false;
+        plans_[0].reset();
+        plans_[1].reset();
     }
 }
 
 std::unique_ptr<Batch> Statement::createBatch(Transaction* transaction,
                                               bool recordCounts,
                                               bool continueOnError) {
+    BatchOptions options;
+    options.recordCounts = recordCounts;
+    options.continueOnError = continueOnError;
+    return createBatch(transaction, options);
+}
+
+std::unique_ptr<Batch> Statement::createBatch(Transaction* transaction,
+                                              const BatchOptions& options) {
     if (!isValid()) {
         throw FirebirdException("Statement is not valid");
     }
@@ -399,6 +918,7 @@ std::unique_ptr<Batch> Statement::createBatch(Transaction* transaction,
     if (!transaction || !transaction->isActive()) {
         throw FirebirdException("Valid active transaction required for batch creation");
     }
+    revalidate(*transaction);
     
     try {
         // Get attachment through statement
@@ -419,14 +939,29 @@ std::unique_ptr<Batch> Statement::createBatch(Transaction* transaction,
             util->getXpbBuilder(&st, Firebird::IXpbBuilder::BATCH, nullptr, 0));
 
         // Set batch options
-        if (recordCounts) {
+        if (options.recordCounts) {
             pb->insertInt(&st, Firebird::IBatch::TAG_RECORD_COUNTS, 1);
         }
 
-        if (continueOnError) {
+        if (options.continueOnError) {
             pb->insertInt(&st, Firebird::IBatch::TAG_MULTIERROR, 1);
         }
 
+        if (options.blobPolicy != BatchBlobPolicy::None) {
+            pb->insertInt(&st, Firebird::IBatch::TAG_BLOB_POLICY,
+                          static_cast<int>(options.blobPolicy));
+        }
+
+        if (options.detailedErrors != 0) {
+            pb->insertInt(&st, Firebird::IBatch::TAG_DETAILED_ERRORS,
+                          static_cast<int>(options.detailedErrors));
+        }
+
+        if (options.bufferBytes != 0) {
+            pb->insertInt(&st, Firebird::IBatch::TAG_BUFFER_BYTES_SIZE,
+                          static_cast<int>(std::min<size_t>(options.bufferBytes, INT32_MAX)));
+        }
+
         // Create Firebird batch through statement
         auto fbBatch = statement_->createBatch(&st,
                                                inMeta->getRawMetadata(),
@@ -438,7 +973,21 @@ std::unique_ptr<Batch> Statement::createBatch(Transaction* transaction,
         }
         
         // Create and return our Batch wrapper
-        return std::make_unique<Batch>(fbBatch, std::move(inMeta));
+        // JsonText rows keep the statement's :name keys
+        const JsonTextPacker* textPacker =
+            hasNamedParams_ && !namedParamMapping_.empty()
+                ? &JsonTextPacker::of(*inMeta, namedParamMapping_) : nullptr;
+        auto batch = std::make_unique<Batch>(fbBatch, std::move(inMeta), options.blobPolicy,
+                                             textPacker);
+        batch->applyOptions(options);
+        if (metrics_) {
+            batch->setMetrics(metrics_);
+        }
+        if (connection_) {
+            batch->setStreamChunkBytes(connection_->transferTuning().batchChunkBytes);
+            batch->trackMemory(connection_->memoryAccount());
+        }
+        return batch;
         
     } catch (const Firebird::FbException& e) {
         throw FirebirdException(e);
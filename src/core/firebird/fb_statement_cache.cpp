@@ -1,119 +1,429 @@
 #include "fbpp/core/statement_cache.hpp"
 #include "fbpp/core/statement.hpp"
+#include "fbpp/core/statement_template.hpp"
+#include "fbpp/core/cancel_scope.hpp"
 #include "fbpp/core/connection.hpp"
+#include "fbpp/core/deadline.hpp"
 #include "fbpp/core/environment.hpp"
 #include "fbpp/core/exception.hpp"
 #include "fbpp/core/message_metadata.hpp"
 #include "fbpp/core/named_param_parser.hpp"
+#include "fbpp/core/detail/sql_token_stream.hpp"
+#include "fbpp/core/param_binder.hpp"
+#include "fbpp/core/span_observer.hpp"
+#include "fbpp/core/startup_profile.hpp"
 #include "fbpp_util/trace.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <fstream>
+#include <optional>
 #include <sstream>
-#include <cctype>
 
 namespace fbpp {
 namespace core {
 
+namespace {
+
+using detail::SqlTokenStream;
+
+size_t policyIndex(StatementCachePolicy policy) noexcept {
+    return policy == StatementCachePolicy::CostAwareLfu ? 1 : 0;
+}
+
+} // namespace
+
+// Count-min sketch with four rows of saturating 4-bit-range counters.
+// Every `sampleSize_` increments all counters are halved, so frequencies
+// describe recent traffic rather than the whole process lifetime. Updates
+// are relaxed atomics: lost increments or a racing halving only make the
+// estimate approximate, which the policy tolerates.
+class StatementCache::FrequencySketch {
+public:
+    explicit FrequencySketch(size_t capacity) {
+        size_t width = 64;
+        while (width < capacity) {
+            width <<= 1;
+        }
+        mask_ = width - 1;
+        sampleSize_ = width * 10;
+        counters_ = std::make_unique<std::atomic<uint8_t>[]>(width * kRows);
+    }
+
+    void increment(uint64_t hash) noexcept {
+        for (size_t row = 0; row < kRows; ++row) {
+            auto& counter = counters_[slot(hash, row)];
+            uint8_t value = counter.load(std::memory_order_relaxed);
+            while (value < kMaxCount &&
+                   !counter.compare_exchange_weak(value, static_cast<uint8_t>(value + 1),
+                                                  std::memory_order_relaxed)) {
+            }
+        }
+        if (additions_.fetch_add(1, std::memory_order_relaxed) + 1 >= sampleSize_) {
+            additions_.store(0, std::memory_order_relaxed);
+            for (size_t i = 0; i < (mask_ + 1) * kRows; ++i) {
+                counters_[i].store(static_cast<uint8_t>(counters_[i].load(std::memory_order_relaxed) >> 1),
+                                   std::memory_order_relaxed);
+            }
+        }
+    }
+
+    uint32_t estimate(uint64_t hash) const noexcept {
+        uint32_t best = kMaxCount;
+        for (size_t row = 0; row < kRows; ++row) {
+            best = std::min<uint32_t>(best, counters_[slot(hash, row)].load(std::memory_order_relaxed));
+        }
+        return best;
+    }
+
+private:
+    static constexpr size_t kRows = 4;
+    static constexpr uint8_t kMaxCount = 15;
+
+    size_t slot(uint64_t hash, size_t row) const noexcept {
+        // One independent-ish index per row from the (already mixed) key hash.
+        const uint64_t h = (hash + row * 0x9e3779b97f4a7c15ULL) * 0xbf58476d1ce4e5b9ULL;
+        return row * (mask_ + 1) + static_cast<size_t>((h >> 32) & mask_);
+    }
+
+    std::unique_ptr<std::atomic<uint8_t>[]> counters_;
+    size_t mask_ = 0;
+    size_t sampleSize_ = 0;
+    std::atomic<size_t> additions_{0};
+};
+
 StatementCache::StatementCache(const CacheConfig& config)
-    : config_(config), core_(std::make_shared<PoolCore>()) {}
+    : enabled_(config.enabled),
+      maxSize_(config.maxSize),
+      maxIdle_(config.maxIdleStatements),
+      ttlMinutes_(config.ttlMinutes),
+      sharedTemplates_(config.sharedTemplates),
+      policy_(config.policy),
+      collectMetrics_(config.collectMetrics),
+      captureServerCounters_(config.captureServerCounters),
+      profilePhases_(config.profilePhases),
+      sketch_(std::make_unique<FrequencySketch>(config.maxSize)),
+      core_(std::make_shared<PoolCore>()) {}
 
 StatementCache::~StatementCache() {
-    // Mark the pool closed first (under the shared mutex): outstanding
-    // checkout deleters on other threads then destroy their instances
-    // instead of returning them into a dying cache.
+    // Mark the pool closed first (exclusive lock): outstanding checkout
+    // deleters on other threads then destroy their instances instead of
+    // returning them into a dying cache.
     {
-        std::lock_guard<std::mutex> lock(core_->mutex);
+        std::unique_lock<std::shared_mutex> lock(core_->mutex);
         core_->closed = true;
     }
     clear();
 }
 
+StatementCache::Shard& StatementCache::shardFor(uint64_t hash) {
+    return shards_[hash % kShardCount];
+}
+
+std::unique_lock<std::mutex> StatementCache::lockShard(Shard& shard) const {
+    std::unique_lock<std::mutex> lock(shard.mutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        counters_.lockContention.fetch_add(1, std::memory_order_relaxed);
+        lock.lock();
+    }
+    return lock;
+}
+
 std::shared_ptr<Statement> StatementCache::get(Connection* connection,
                                                const std::string& sql,
                                                unsigned flags) {
-    // Parse named parameters
-    auto parseResult = NamedParamParser::parse(sql);
-    std::string actualSql = parseResult.hasNamedParams ? parseResult.convertedSql : sql;
+    return makeCheckout(lookup(connection, sql, flags, SqlKey::hashOf(sql, flags)));
+}
+
+std::shared_ptr<Statement> StatementCache::get(Connection* connection, const SqlKey& key) {
+    return makeCheckout(lookup(connection, key.sql(), key.flags(), key.hash(), key.parsed()));
+}
 
-    if (!config_.enabled) {
+StatementLease StatementCache::lease(Connection* connection,
+                                     const std::string& sql,
+                                     unsigned flags) {
+    return StatementLease(this, core_,
+                          lookup(connection, sql, flags, SqlKey::hashOf(sql, flags)));
+}
+
+StatementLease StatementCache::lease(Connection* connection, const SqlKey& key) {
+    return StatementLease(this, core_,
+                          lookup(connection, key.sql(), key.flags(), key.hash(), key.parsed()));
+}
+
+StatementCache::CachedStatement* StatementCache::findEntry(Shard& shard,
+                                                           const std::string& sql,
+                                                           unsigned flags,
+                                                           uint64_t hash) {
+    auto [first, last] = shard.entries.equal_range(hash);
+    for (auto it = first; it != last; ++it) {
+        CachedStatement& entry = *it->second;
+        if (entry.flags == flags &&
+            (entry.sql == sql || SqlKey::equivalent(entry.sql, sql))) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+StatementCache::Checkout StatementCache::lookup(
+    Connection* connection,
+    const std::string& sql,
+    unsigned flags,
+    uint64_t hash,
+    const std::shared_ptr<const NamedParamParser::ParseResult>& preparsed) {
+    // Named parameters are parsed only when an instance is actually
+    // prepared; hits never look at the SQL beyond the key match. With a
+    // shared template the parse (and metadata decode) was done once for
+    // the whole process. Each instance gets its binder built here, so
+    // checkouts hand out a ready Statement::binder(). A key that comes
+    // with its parse (sql<"..."> literals) is never parsed at all.
+    auto prepare = [&](const std::shared_ptr<StatementTemplate>& tmpl) {
+        std::shared_ptr<Statement> stmt;
+        if (tmpl) {
+            stmt = prepareInstance(
+                connection,
+                tmpl->actualSql(),
+                tmpl->hasNamedParams() ? &tmpl->nameToPositions() : nullptr,
+                flags);
+            if (tmpl->applyLayouts(*stmt)) {
+                StatementTemplateRegistry::instance().noteLayoutReuse();
+            } else {
+                tmpl->publishLayouts(*stmt);
+            }
+        } else {
+            const auto parsed = preparsed ? preparsed : NamedParamParser::parseCached(sql);
+            const auto& parseResult = *parsed;
+            stmt = prepareInstance(
+                connection,
+                parseResult.hasNamedParams ? parseResult.convertedSql : sql,
+                parseResult.hasNamedParams ? &parseResult.nameToPositions : nullptr,
+                flags);
+        }
+        stmt->binder();
+        return stmt;
+    };
+
+    if (!isEnabled()) {
         // Cache disabled: hand out an unpooled instance (the caller fully
         // owns it; no checkout/return bookkeeping).
-        return prepareInstance(
-            connection, actualSql,
-            parseResult.hasNamedParams ? &parseResult.nameToPositions : nullptr,
-            flags);
+        return Checkout{hash, 0, prepare(nullptr), false};
     }
 
-    std::lock_guard<std::mutex> lock(core_->mutex);
+    Shard& shard = shardFor(hash);
+    const auto policy = getPolicy();
+    if (policy == StatementCachePolicy::CostAwareLfu) {
+        // Record every access, including ones that end up not admitted:
+        // that is how a rejected key earns its place.
+        sketch_->increment(hash);
+    }
 
-    // Use original SQL for cache key (with named parameters)
-    std::string key = generateKey(sql, flags);
+    std::shared_ptr<InFlight> leader;
+    std::shared_ptr<StatementTemplate> tmpl;
+    std::shared_ptr<StatementMetrics> metrics;
+    uint64_t entryId = 0;
+    {
+        // Invalidated idle instances are destroyed after the shard unlocks
+        // (Statement::~Statement talks to the server).
+        std::vector<std::shared_ptr<Statement>> stale;
+        auto lock = lockShard(shard);
+
+        for (;;) {
+            if (CachedStatement* entry = findEntry(shard, sql, flags, hash)) {
+                // Key-level cache hit
+                counters_.hits.fetch_add(1, std::memory_order_relaxed);
+                counters_.policyHits[policyIndex(policy)].fetch_add(1, std::memory_order_relaxed);
+                counters_.prepareMicrosSaved.fetch_add(entry->prepareMicros, std::memory_order_relaxed);
+                touchEntry(*entry);
+                beginCheckout(*entry);
+                entryId = entry->id;
+                tmpl = entry->tmpl;
+                if (isCollectingMetrics()) {
+                    if (!entry->metrics) {
+                        // Cached before collection was switched on
+                        entry->metrics = std::make_shared<StatementMetrics>();
+                        entry->metrics->setCaptureServerCounters(isCapturingServerCounters());
+                        entry->metrics->setProfilePhases(isProfilingPhases());
+                    }
+                    metrics = entry->metrics;
+                }
 
-    // Check if statement exists in cache
-    auto it = cache_.find(key);
-    if (it != cache_.end()) {
-        // Key-level cache hit
-        stats_.hitCount++;
+                // Pop an idle instance; skip ones the user invalidated via free().
+                // Instances past a shrunken demand are dropped on the way.
+                auto& idle = entry->idle;
+                const size_t keep = idleLimit(*entry);
+                while (idle.size() > keep) {
+                    stale.push_back(std::move(idle.front()));
+                    idle.erase(idle.begin());
+                    idle_.fetch_sub(1, std::memory_order_relaxed);
+                }
+                while (!idle.empty()) {
+                    auto inner = std::move(idle.back());
+                    idle.pop_back();
+                    idle_.fetch_sub(1, std::memory_order_relaxed);
+                    if (inner && inner->isValid()) {
+                        if (inner->getMetrics() != metrics) {
+                            inner->setMetrics(metrics);
+                        }
+                        lock.unlock();
+                        return Checkout{hash, entryId, std::move(inner), true};
+                    }
+                    stale.push_back(std::move(inner));
+                }
+                break;
+            }
 
-        // Update LRU position
-        touchEntry(key);
+            std::shared_ptr<InFlight> flight;
+            auto [first, last] = shard.inFlight.equal_range(hash);
+            for (auto it = first; it != last; ++it) {
+                if (it->second->flags == flags &&
+                    (it->second->sql == sql || SqlKey::equivalent(it->second->sql, sql))) {
+                    flight = it->second;
+                    break;
+                }
+            }
 
-        // Update usage statistics
-        it->second->lastUsed = std::chrono::steady_clock::now();
-        it->second->useCount++;
+            if (!flight) {
+                // Cache miss: this caller prepares, concurrent ones wait.
+                counters_.misses.fetch_add(1, std::memory_order_relaxed);
+                counters_.policyMisses[policyIndex(policy)].fetch_add(1, std::memory_order_relaxed);
+                leader = std::make_shared<InFlight>();
+                leader->sql = sql;
+                leader->flags = flags;
+                shard.inFlight.emplace(hash, leader);
+                break;
+            }
 
-        // Pop an idle instance; skip ones the user invalidated via free().
-        auto& idle = it->second->idle;
-        while (!idle.empty()) {
-            auto inner = std::move(idle.back());
-            idle.pop_back();
-            if (inner && inner->isValid()) {
-                return makeCheckout(key, std::move(inner));
+            // Another thread is preparing this key; wait for its entry.
+            counters_.singleFlightWaits.fetch_add(1, std::memory_order_relaxed);
+            if (const Deadline* deadline = Deadline::current()) {
+                if (!shard.prepared.wait_until(lock, deadline->at(),
+                                               [&] { return flight->done; })) {
+                    deadline->check("StatementCache prepare");
+                    continue;
+                }
+            } else {
+                shard.prepared.wait(lock, [&] { return flight->done; });
+            }
+            if (flight->error) {
+                std::rethrow_exception(flight->error);
             }
+            // Re-check: the entry may already be evicted or removed again.
         }
+    }
 
+    if (!leader) {
         // All instances are checked out (or were invalidated): prepare an
         // additional instance for the same key. Still a hit — the key and
         // its metadata are cached; only the IStatement is new.
-        auto inner = prepareInstance(
-            connection, actualSql,
-            parseResult.hasNamedParams ? &parseResult.nameToPositions : nullptr,
-            flags);
-        return makeCheckout(key, std::move(inner));
-    }
-
-    // Cache miss
-    stats_.missCount++;
-
-    // Check if cache is full
-    if (cache_.size() >= config_.maxSize) {
-        evictLRU();
+        counters_.concurrentPrepares.fetch_add(1, std::memory_order_relaxed);
+        const auto started = std::chrono::steady_clock::now();
+        std::shared_ptr<Statement> extra;
+        try {
+            extra = prepare(tmpl);
+        } catch (...) {
+            std::shared_ptr<Statement> none;
+            returnToPool(hash, entryId, none);
+            throw;
+        }
+        if (metrics) {
+            metrics->recordPrepare(std::chrono::steady_clock::now() - started);
+            extra->setMetrics(std::move(metrics));
+        }
+        return Checkout{hash, entryId, std::move(extra), true};
     }
 
-    auto stmt = prepareInstance(
-        connection, actualSql,
-        parseResult.hasNamedParams ? &parseResult.nameToPositions : nullptr,
-        flags);
-
-    // Create cache entry (the instance itself is checked out to the caller
-    // and joins the idle pool when the caller releases it)
-    auto entry = std::make_unique<CachedStatement>();
-    entry->sql = sql;
-    entry->flags = flags;
-    entry->lastUsed = std::chrono::steady_clock::now();
-    entry->useCount = 1;
-
-    // Extract metadata
-    extractMetadata(stmt.get(), *entry);
+    auto finishFlight = [&](std::exception_ptr error) {
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto [first, last] = shard.inFlight.equal_range(hash);
+            for (auto it = first; it != last; ++it) {
+                if (it->second == leader) {
+                    shard.inFlight.erase(it);
+                    break;
+                }
+            }
+            leader->error = error;
+            leader->done = true;
+        }
+        shard.prepared.notify_all();
+    };
 
-    // Add to cache
-    cache_[key] = std::move(entry);
+    std::shared_ptr<Statement> stmt;
+    std::unique_ptr<CachedStatement> entry;
+    try {
+        if (sharedTemplates_) {
+            tmpl = StatementTemplateRegistry::instance().acquire(
+                connection->getTemplateScope(), sql, flags, hash, preparsed.get());
+        }
+        const auto started = std::chrono::steady_clock::now();
+        stmt = prepare(tmpl);
+        const auto prepareTime = std::chrono::steady_clock::now() - started;
+        const auto prepareMicros = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(prepareTime).count());
+
+        // Create cache entry (the instance itself is checked out to the caller
+        // and joins the idle pool when the caller releases it)
+        entry = std::make_unique<CachedStatement>();
+        entry->sql = sql;
+        entry->flags = flags;
+        entry->hash = hash;
+        entry->tmpl = std::move(tmpl);
+        entry->prepareMicros = prepareMicros;
+        entry->useCount = 0;
+        if (isCollectingMetrics()) {
+            entry->metrics = std::make_shared<StatementMetrics>();
+            entry->metrics->setCaptureServerCounters(isCapturingServerCounters());
+            entry->metrics->setProfilePhases(isProfilingPhases());
+            entry->metrics->recordPrepare(prepareTime);
+            stmt->setMetrics(entry->metrics);
+        }
 
-    // Add to LRU list (front = most recent)
-    lruList_.push_front(key);
-    lruMap_[key] = lruList_.begin();
+        // Extract metadata
+        extractMetadata(stmt.get(), *entry);
+    } catch (...) {
+        finishFlight(std::current_exception());
+        throw;
+    }
 
-    stats_.cacheSize = cache_.size();
+    std::vector<std::unique_ptr<CachedStatement>> victims;
+    {
+        std::lock_guard<std::mutex> structure(structureMutex_);
+        bool admit = isEnabled();
+        if (admit) {
+            // Check if cache is full
+            const uint64_t candidateScore = scoreOf(hash, entry->prepareMicros);
+            Victim victim;
+            while (size_.load(std::memory_order_relaxed) >= getMaxSize() &&
+                   selectVictim(victim)) {
+                if (candidateScore < victim.score) {
+                    // CostAwareLfu: the newcomer is worth less than anything
+                    // cached. Under Lru both scores are 0 and this never fires.
+                    admit = false;
+                    counters_.admissionRejects.fetch_add(1, std::memory_order_relaxed);
+                    break;
+                }
+                if (!evictVictim(victim, victims)) {
+                    break;
+                }
+            }
+        }
+        if (admit) {
+            entry->id = ++nextEntryId_;
+            entryId = entry->id;
+
+            auto lock = lockShard(shard);
+            touchEntry(*entry);
+            entry->windowStart = entry->lruTick;
+            beginCheckout(*entry);
+            shard.entries.emplace(hash, std::move(entry));
+            size_.fetch_add(1, std::memory_order_relaxed);
+        }
+        // Disabled while preparing, or not admitted: the entry is dropped
+        // and the instance is not pooled on return (entryId 0 never matches).
+    }
+    finishFlight(nullptr);
 
-    return makeCheckout(key, std::move(stmt));
+    return Checkout{hash, entryId, std::move(stmt), true};
 }
 
 std::shared_ptr<Statement> StatementCache::prepareInstance(
@@ -126,32 +436,56 @@ std::shared_ptr<Statement> StatementCache::prepareInstance(
     if (!attachment) {
         throw FirebirdException("Not connected to database");
     }
+    // Under a DeadlineScope the prepare is cancelled when the budget runs out
+    std::optional<CancelScope> cancel;
+    if (const Deadline* deadline = Deadline::current()) {
+        deadline->check("StatementCache prepare");
+        cancel.emplace(*connection, deadline->at());
+    }
 
-    Firebird::IStatus* raw = env.getMaster()->getStatus();
+    Firebird::IStatus* raw = env.acquireStatus();
     Firebird::ThrowStatusWrapper st(raw);
 
+    detail::SpanScope span(SpanKind::Prepare);
+    if (span.active()) {
+        span.start(actualSql, SqlKey::hashOf(actualSql, 0));
+    }
+
+    const auto startupStarted = detail::startupClock(StartupPhase::FirstPrepare);
     try {
-        // Prepare against a short-lived probe transaction. Commit it
-        // explicitly — letting the destructor roll it back emitted a
-        // spurious "Transaction destroyed while still active" warning on
-        // every prepare.
-        auto tra = connection->StartTransaction();
-        Firebird::IStatement* fbStmt = attachment->prepare(
-            &st, tra->getTransaction(), 0, actualSql.c_str(), 3, flags);
+        // Prepare against a short-lived probe transaction, started on the
+        // local status rather than via Connection::StartTransaction(): the
+        // connection's status wrapper is shared, and prepares now run
+        // concurrently outside the cache locks. Commit it explicitly — a
+        // rollback on every prepare is pointless server work.
+        Firebird::ITransaction* tra = attachment->startTransaction(&st, 0, nullptr);
+        std::shared_ptr<Statement> stmt;
+        try {
+            Firebird::IStatement* fbStmt = attachment->prepare(
+                &st, tra, 0, actualSql.c_str(), 3, connection->prepareFlags(flags));
+
+            if (!fbStmt) {
+                throw FirebirdException("prepare() returned nullptr");
+            }
 
-        if (!fbStmt) {
-            throw FirebirdException("prepare() returned nullptr");
+            stmt = std::make_shared<Statement>(fbStmt, connection);
+            stmt->setSql(actualSql, flags);
+            tra->commit(&st);
+        } catch (...) {
+            try { tra->rollback(&st); } catch (...) { /* best effort */ }
+            tra->release();
+            throw;
         }
-
-        auto stmt = std::make_shared<Statement>(fbStmt, connection);
-        tra->Commit();
+        // FB5 client: commit() does not release the interface.
+        tra->release();
 
         // Set named parameter mapping if any
         if (nameToPositions) {
             stmt->setNamedParamMapping(*nameToPositions, true);
         }
 
-        st.dispose();
+        env.releaseStatus(raw);
+        detail::recordStartupPhase(StartupPhase::FirstPrepare, startupStarted);
         return stmt;
 
     } catch (const Firebird::FbException& e) {
@@ -165,313 +499,639 @@ std::shared_ptr<Statement> StatementCache::prepareInstance(
                             << "SQLState: " << fbppEx.getSQLState();
                     });
 
-        st.dispose();
+        env.releaseStatus(raw);
         throw fbppEx;
     } catch (...) {
-        // e.g. FirebirdException from StartTransaction()/Commit(); the raw
-        // IStatus must still be disposed.
-        st.dispose();
+        // e.g. FirebirdException from prepare() returning nullptr; the raw
+        // IStatus must still be returned.
+        env.releaseStatus(raw);
         throw;
     }
 }
 
-std::shared_ptr<Statement> StatementCache::makeCheckout(std::string key,
-                                                        std::shared_ptr<Statement> inner) {
+std::shared_ptr<Statement> StatementCache::makeCheckout(Checkout checkout) {
+    if (!checkout.pooled) {
+        return std::move(checkout.inner);
+    }
+    const uint64_t hash = checkout.hash;
+    const uint64_t entryId = checkout.entryId;
+    std::shared_ptr<Statement> inner = std::move(checkout.inner);
     Statement* rawPtr = inner.get();
     std::weak_ptr<PoolCore> coreWeak = core_;
     // While checked out, the deleter owns the only strong reference to the
-    // instance. `this` is touched only under the core mutex with the closed
-    // flag false — ~StatementCache sets closed before any member is torn
-    // down, so a late return degrades to plain destruction.
+    // instance. `this` is touched only under the core mutex (shared) with
+    // the closed flag false — ~StatementCache sets closed before any member
+    // is torn down, so a late return degrades to plain destruction.
     return std::shared_ptr<Statement>(
         rawPtr,
-        [coreWeak, self = this, key = std::move(key),
+        [coreWeak, self = this, hash, entryId,
          inner = std::move(inner)](Statement*) mutable {
             if (auto core = coreWeak.lock()) {
-                std::lock_guard<std::mutex> lock(core->mutex);
+                std::shared_lock<std::shared_mutex> lock(core->mutex);
                 if (!core->closed) {
-                    self->returnToPool(key, std::move(inner));
-                    return;
+                    self->returnToPool(hash, entryId, inner);
                 }
             }
-            inner.reset();  // Pool is gone: destroy the instance.
+            inner.reset();  // Not pooled (or pool is gone): destroy the instance.
         });
 }
 
-void StatementCache::returnToPool(const std::string& key,
-                                  std::shared_ptr<Statement> inner) {
-    if (!config_.enabled || !inner || !inner->isValid()) {
-        // Disabled cache, or the user called free() on the instance — a
-        // poisoned instance must not re-enter the pool.
+void StatementCache::returnToPool(uint64_t hash, uint64_t entryId,
+                                  std::shared_ptr<Statement>& inner) {
+    if (entryId == 0) {
+        return;   // Never admitted: not pooled, not counted
+    }
+
+    Shard& shard = shardFor(hash);
+    auto lock = lockShard(shard);
+
+    auto [first, last] = shard.entries.equal_range(hash);
+    for (auto it = first; it != last; ++it) {
+        CachedStatement& entry = *it->second;
+        if (entry.id != entryId) {
+            continue;
+        }
+        if (entry.checkedOut > 0) {
+            --entry.checkedOut;
+        }
+        if (!isEnabled() || !inner || !inner->isValid()) {
+            // Disabled cache, or the user called free() on the instance — a
+            // poisoned instance must not re-enter the pool.
+            return;
+        }
+        if (inner.use_count() > 1) {
+            // A lease ended while a cursor still holds the instance: it is
+            // busy, and is freed by its last holder instead.
+            return;
+        }
+        // The first idle instance of a key is always kept: without it
+        // every hit would prepare again
+        if (entry.idle.empty() ||
+            (entry.idle.size() < idleLimit(entry) &&
+             idle_.load(std::memory_order_relaxed) < idleBudget())) {
+            entry.idle.push_back(std::move(inner));
+            idle_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            // Pool or budget full — the caller drops the surplus instance.
+            counters_.idleDrops.fetch_add(1, std::memory_order_relaxed);
+        }
         return;
     }
+    // Entry evicted/cleared while the instance was checked out.
+}
 
-    auto it = cache_.find(key);
-    if (it == cache_.end()) {
-        return;  // Entry evicted/cleared while the instance was checked out.
+void StatementLease::reset() noexcept {
+    if (cache_) {
+        if (auto core = core_.lock()) {
+            std::shared_lock<std::shared_mutex> lock(core->mutex);
+            if (!core->closed) {
+                cache_->returnToPool(hash_, entryId_, statement_);
+            }
+        }
+        cache_ = nullptr;
+        core_.reset();
     }
+    statement_.reset();  // Not pooled (or pool is gone): destroy the instance.
+}
 
-    if (it->second->idle.size() < kMaxIdlePerKey) {
-        it->second->idle.push_back(std::move(inner));
+void StatementCache::beginCheckout(CachedStatement& entry) {
+    if (entry.lruTick - entry.windowStart >= kDemandWindow) {
+        entry.previousPeak = entry.peakCheckedOut;
+        entry.peakCheckedOut = entry.checkedOut;
+        entry.windowStart = entry.lruTick;
     }
-    // Else: pool for this key is full — drop the surplus instance.
+    ++entry.checkedOut;
+    entry.peakCheckedOut = std::max(entry.peakCheckedOut, entry.checkedOut);
 }
 
-void StatementCache::clear() {
-    std::lock_guard<std::mutex> lock(core_->mutex);
+size_t StatementCache::idleLimit(const CachedStatement& entry) {
+    return std::max<size_t>({entry.peakCheckedOut, entry.previousPeak, 1});
+}
 
-    // Statements will be freed automatically via unique_ptr destructors
-    cache_.clear();
-    lruList_.clear();
-    lruMap_.clear();
+size_t StatementCache::idleBudget() const {
+    const size_t budget = maxIdle_.load(std::memory_order_relaxed);
+    return budget != 0 ? budget : 2 * getMaxSize();
+}
 
-    stats_.cacheSize = 0;
+void StatementCache::clear() {
+    std::vector<std::unique_ptr<CachedStatement>> victims;
+    {
+        std::lock_guard<std::mutex> structure(structureMutex_);
+        drainAll(victims);
+    }
+    // Statements are freed here, outside the cache locks.
 }
 
 bool StatementCache::remove(const std::string& sql, unsigned flags) {
-    std::lock_guard<std::mutex> lock(core_->mutex);
+    const uint64_t hash = SqlKey::hashOf(sql, flags);
+    Shard& shard = shardFor(hash);
 
-    std::string key = generateKey(sql, flags);
-    auto it = cache_.find(key);
-
-    if (it != cache_.end()) {
-        // Remove from LRU tracking
-        auto lruIt = lruMap_.find(key);
-        if (lruIt != lruMap_.end()) {
-            lruList_.erase(lruIt->second);
-            lruMap_.erase(lruIt);
+    std::unique_ptr<CachedStatement> victim;
+    {
+        std::lock_guard<std::mutex> structure(structureMutex_);
+        auto lock = lockShard(shard);
+
+        auto [first, last] = shard.entries.equal_range(hash);
+        for (auto it = first; it != last; ++it) {
+            if (it->second->flags == flags && SqlKey::equivalent(it->second->sql, sql)) {
+                // Remove from cache (statement is freed once the locks are released)
+                victim = std::move(it->second);
+                shard.entries.erase(it);
+                size_.fetch_sub(1, std::memory_order_relaxed);
+                idle_.fetch_sub(victim->idle.size(), std::memory_order_relaxed);
+                break;
+            }
         }
-
-        // Remove from cache (statement will be freed)
-        cache_.erase(it);
-
-        stats_.cacheSize = cache_.size();
-
-        return true;
     }
-
-    return false;
+    return victim != nullptr;
 }
 
 StatementCache::Statistics StatementCache::getStatistics() const {
-    std::lock_guard<std::mutex> lock(core_->mutex);
-
-    stats_.cacheSize = cache_.size();
+    Statistics stats;
+    stats.cacheSize = size_.load(std::memory_order_relaxed);
+    stats.hitCount = counters_.hits.load(std::memory_order_relaxed);
+    stats.missCount = counters_.misses.load(std::memory_order_relaxed);
+    stats.evictionCount = counters_.evictions.load(std::memory_order_relaxed);
+    stats.lockContentionCount = counters_.lockContention.load(std::memory_order_relaxed);
+    stats.singleFlightWaitCount = counters_.singleFlightWaits.load(std::memory_order_relaxed);
+    stats.concurrentPrepareCount = counters_.concurrentPrepares.load(std::memory_order_relaxed);
+    stats.idleCount = idle_.load(std::memory_order_relaxed);
+    stats.idleDropCount = counters_.idleDrops.load(std::memory_order_relaxed);
+    stats.warmupCount = counters_.warmups.load(std::memory_order_relaxed);
+    stats.policy = getPolicy();
+    stats.admissionRejectCount = counters_.admissionRejects.load(std::memory_order_relaxed);
+    stats.prepareMicrosSaved = counters_.prepareMicrosSaved.load(std::memory_order_relaxed);
+
+    for (auto policy : {StatementCachePolicy::Lru, StatementCachePolicy::CostAwareLfu}) {
+        Statistics::PolicyStatistics byPolicy;
+        byPolicy.policy = policy;
+        byPolicy.hitCount = counters_.policyHits[policyIndex(policy)].load(std::memory_order_relaxed);
+        byPolicy.missCount = counters_.policyMisses[policyIndex(policy)].load(std::memory_order_relaxed);
+        const size_t lookups = byPolicy.hitCount + byPolicy.missCount;
+        if (lookups > 0) {
+            byPolicy.hitRate = (static_cast<double>(byPolicy.hitCount) / lookups) * 100.0;
+        }
+        stats.byPolicy.push_back(byPolicy);
+    }
 
     // Calculate hit rate
-    size_t total = stats_.hitCount + stats_.missCount;
+    size_t total = stats.hitCount + stats.missCount;
     if (total > 0) {
-        stats_.hitRate = (static_cast<double>(stats_.hitCount) / total) * 100.0;
+        stats.hitRate = (static_cast<double>(stats.hitCount) / total) * 100.0;
     }
 
-    return stats_;
+    return stats;
 }
 
 void StatementCache::setEnabled(bool enabled) {
-    std::lock_guard<std::mutex> lock(core_->mutex);
+    std::vector<std::unique_ptr<CachedStatement>> victims;
+    {
+        std::lock_guard<std::mutex> structure(structureMutex_);
 
-    if (!enabled && config_.enabled) {
-        cache_.clear();
-        lruList_.clear();
-        lruMap_.clear();
-        stats_.cacheSize = 0;
-    }
+        if (!enabled && isEnabled()) {
+            drainAll(victims);
+        }
 
-    config_.enabled = enabled;
+        enabled_.store(enabled, std::memory_order_relaxed);
+    }
     fbpp::util::trace(fbpp::util::TraceLevel::info, "StatementCache",
                 [&](auto& oss) { oss << "Cache " << (enabled ? "enabled" : "disabled"); });
 }
 
 void StatementCache::setMaxSize(size_t maxSize) {
-    std::lock_guard<std::mutex> lock(core_->mutex);
+    std::vector<std::unique_ptr<CachedStatement>> victims;
+    {
+        std::lock_guard<std::mutex> structure(structureMutex_);
 
-    config_.maxSize = maxSize;
+        maxSize_.store(maxSize, std::memory_order_relaxed);
 
-    // Evict entries if new size is smaller
-    while (cache_.size() > config_.maxSize) {
-        evictLRU();
+        // Evict entries if new size is smaller
+        while (size_.load(std::memory_order_relaxed) > maxSize && evictOne(victims)) {
+        }
     }
 
     fbpp::util::trace(fbpp::util::TraceLevel::info, "StatementCache",
                 [&](auto& oss) { oss << "Cache max size set to " << maxSize; });
 }
 
+void StatementCache::setMaxIdleStatements(size_t maxIdle) {
+    maxIdle_.store(maxIdle, std::memory_order_relaxed);
+    fbpp::util::trace(fbpp::util::TraceLevel::info, "StatementCache",
+                [&](auto& oss) { oss << "Cache idle budget set to " << idleBudget(); });
+}
+
+void StatementCache::setPolicy(StatementCachePolicy policy) {
+    {
+        // Eviction decisions run under the structure mutex; switching there
+        // keeps one admission loop from mixing two scoring rules.
+        std::lock_guard<std::mutex> structure(structureMutex_);
+        policy_.store(policy, std::memory_order_relaxed);
+    }
+    fbpp::util::trace(fbpp::util::TraceLevel::info, "StatementCache",
+                [&](auto& oss) {
+                    oss << "Cache policy set to "
+                        << (policy == StatementCachePolicy::CostAwareLfu ? "CostAwareLfu" : "Lru");
+                });
+}
+
 void StatementCache::setTtlMinutes(size_t ttlMinutes) {
-    std::lock_guard<std::mutex> lock(core_->mutex);
-    config_.ttlMinutes = ttlMinutes;
+    ttlMinutes_.store(ttlMinutes, std::memory_order_relaxed);
     fbpp::util::trace(fbpp::util::TraceLevel::info, "StatementCache",
                 [&](auto& oss) { oss << "Cache TTL set to " << ttlMinutes << " minutes"; });
 }
 
-size_t StatementCache::removeExpired() {
-    std::lock_guard<std::mutex> lock(core_->mutex);
-
-    if (config_.ttlMinutes == 0) {
-        // No TTL configured
-        return 0;
+namespace {
+
+// Client bytes of one cache entry: its texts and parameter descriptions,
+// plus per pooled instance the Statement and a message buffer pair
+size_t entryBytes(const StatementCache::CachedStatement& entry) {
+    size_t messages = 0;
+    size_t bytes = sizeof(entry) + entry.sql.capacity();
+    for (const auto* params : {&entry.inputParams, &entry.outputParams}) {
+        bytes += params->capacity() * sizeof(StatementCache::ParamInfo);
+        for (const auto& param : *params) {
+            bytes += param.name.capacity();
+            messages += param.length;
+        }
     }
+    for (const auto& statement : entry.idle) {
+        bytes += sizeof(Statement) + messages + statement->recycledFetchBytes();
+    }
+    return bytes;
+}
 
-    auto now = std::chrono::steady_clock::now();
-    auto ttl = std::chrono::minutes(config_.ttlMinutes);
-    size_t removed = 0;
+} // namespace
 
-    // Find expired entries
-    std::vector<std::string> toRemove;
-    for (const auto& pair : cache_) {
-        if (now - pair.second->lastUsed > ttl) {
-            toRemove.push_back(pair.first);
+size_t StatementCache::estimateMemory() const {
+    size_t bytes = 0;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const auto& [hash, entry] : shard.entries) {
+            bytes += entryBytes(*entry);
         }
     }
+    return bytes;
+}
 
-    // Remove expired entries
-    for (const auto& key : toRemove) {
-        // Remove from LRU tracking
-        auto lruIt = lruMap_.find(key);
-        if (lruIt != lruMap_.end()) {
-            lruList_.erase(lruIt->second);
-            lruMap_.erase(lruIt);
+size_t StatementCache::shrinkTo(size_t targetBytes) {
+    // Freed after the cache locks are released
+    std::vector<std::shared_ptr<Statement>> dropped;
+    std::vector<std::unique_ptr<CachedStatement>> victims;
+    std::lock_guard<std::mutex> structure(structureMutex_);
+
+    // Pooled surplus first: re-prepared on demand if the demand returns
+    size_t bytes = 0;
+    for (auto& shard : shards_) {
+        auto lock = lockShard(shard);
+        for (auto& [hash, entry] : shard.entries) {
+            while (entry->idle.size() > 1) {
+                dropped.push_back(std::move(entry->idle.back()));
+                entry->idle.pop_back();
+                idle_.fetch_sub(1, std::memory_order_relaxed);
+            }
+            bytes += entryBytes(*entry);
         }
+    }
 
-        // Remove from cache
-        cache_.erase(key);
-        removed++;
+    while (bytes > targetBytes) {
+        Victim victim;
+        if (!selectVictim(victim) || !evictVictim(victim, victims)) {
+            break;
+        }
+        bytes -= std::min(bytes, entryBytes(*victims.back()));
     }
+    return bytes;
+}
 
-    stats_.cacheSize = cache_.size();
+size_t StatementCache::removeExpired() {
+    const size_t ttlMinutes = ttlMinutes_.load(std::memory_order_relaxed);
+    if (ttlMinutes == 0) {
+        // No TTL configured
+        return 0;
+    }
 
-    return removed;
-}
+    auto now = std::chrono::steady_clock::now();
+    auto ttl = std::chrono::minutes(ttlMinutes);
+    size_t removed = 0;
 
-std::string StatementCache::generateKey(const std::string& sql, unsigned flags) const {
-    // Normalize SQL for consistent key generation
-    std::string normalized;
-    normalized.reserve(sql.size());
+    std::vector<std::unique_ptr<CachedStatement>> victims;
+    {
+        std::lock_guard<std::mutex> structure(structureMutex_);
+
+        for (auto& shard : shards_) {
+            auto lock = lockShard(shard);
+            for (auto it = shard.entries.begin(); it != shard.entries.end();) {
+                if (now - it->second->lastUsed > ttl) {
+                    idle_.fetch_sub(it->second->idle.size(), std::memory_order_relaxed);
+                    victims.push_back(std::move(it->second));
+                    it = shard.entries.erase(it);
+                    size_.fetch_sub(1, std::memory_order_relaxed);
+                    removed++;
+                } else {
+                    ++it;
+                }
+            }
+        }
+    }
 
-    bool inString = false;
-    bool inComment = false;
-    bool lastWasSpace = false;
-    char stringDelimiter = 0;
+    return removed;
+}
 
-    for (size_t i = 0; i < sql.size(); ++i) {
-        char c = sql[i];
-        char next = (i + 1 < sql.size()) ? sql[i + 1] : '\0';
+void StatementCache::setCollectMetrics(bool collect) {
+    collectMetrics_.store(collect, std::memory_order_relaxed);
+    fbpp::util::trace(fbpp::util::TraceLevel::info, "StatementCache",
+                [&](auto& oss) { oss << "Metrics collection " << (collect ? "enabled" : "disabled"); });
+}
 
-        // Handle string literals (preserve case and spaces inside strings)
-        if (!inComment) {
-            if (!inString && (c == '\'' || c == '"')) {
-                inString = true;
-                stringDelimiter = c;
-                normalized += c;
-                continue;
-            }
-            if (inString && c == stringDelimiter) {
-                // Check for escaped quote
-                if (next == stringDelimiter) {
-                    normalized += c;
-                    normalized += next;
-                    ++i; // Skip next character
-                    continue;
-                }
-                inString = false;
-                stringDelimiter = 0;
-                normalized += c;
-                continue;
+void StatementCache::setCaptureServerCounters(bool capture) {
+    captureServerCounters_.store(capture, std::memory_order_relaxed);
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (auto& [hash, entry] : shard.entries) {
+            if (entry->metrics) {
+                entry->metrics->setCaptureServerCounters(capture);
             }
         }
+    }
+    fbpp::util::trace(fbpp::util::TraceLevel::info, "StatementCache",
+                [&](auto& oss) { oss << "Server counter capture " << (capture ? "enabled" : "disabled"); });
+}
 
-        // Inside string - preserve everything
-        if (inString) {
-            normalized += c;
-            continue;
+void StatementCache::setProfilePhases(bool profile) {
+    profilePhases_.store(profile, std::memory_order_relaxed);
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (auto& [hash, entry] : shard.entries) {
+            if (entry->metrics) {
+                entry->metrics->setProfilePhases(profile);
+            }
         }
+    }
+    fbpp::util::trace(fbpp::util::TraceLevel::info, "StatementCache",
+                [&](auto& oss) { oss << "Phase profiling " << (profile ? "enabled" : "disabled"); });
+}
 
-        // Handle comments
-        if (!inString) {
-            // Single line comment
-            if (c == '-' && next == '-') {
-                inComment = true;
-                i++; // Skip next dash
+std::vector<StatementMetricsSnapshot> StatementCache::getMetrics(size_t limit) const {
+    std::vector<StatementMetricsSnapshot> result;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const auto& [hash, entry] : shard.entries) {
+            if (!entry->metrics) {
                 continue;
             }
-            // Multi-line comment start
-            if (c == '/' && next == '*') {
-                inComment = true;
-                i++; // Skip asterisk
-                continue;
+            auto snap = StatementMetricsSnapshot::of(*entry->metrics);
+            snap.sql = entry->sql;
+            snap.flags = entry->flags;
+            snap.useCount = entry->useCount;
+            result.push_back(std::move(snap));
+        }
+    }
+
+    auto serverMicros = [](const StatementMetricsSnapshot& m) {
+        return m.execute.totalMicros + m.openCursor.totalMicros + m.fetch.totalMicros;
+    };
+    std::stable_sort(result.begin(), result.end(),
+                     [&](const StatementMetricsSnapshot& a, const StatementMetricsSnapshot& b) {
+                         return serverMicros(a) > serverMicros(b);
+                     });
+    if (limit != 0 && result.size() > limit) {
+        result.resize(limit);
+    }
+    return result;
+}
+
+void StatementCache::traceMetrics(fbpp::util::TraceLevel level, size_t limit) const {
+    if (!fbpp::util::traceEnabled(level)) {
+        return;
+    }
+    auto latency = [](std::ostringstream& oss, const char* name, const LatencySnapshot& l) {
+        oss << ' ' << name << "{n=" << l.count << " mean=" << static_cast<uint64_t>(l.meanMicros())
+            << " p50=" << l.p50Micros << " p99=" << l.p99Micros << " max=" << l.maxMicros << '}';
+    };
+    for (const auto& m : getMetrics(limit)) {
+        fbpp::util::trace(level, "StatementMetrics", [&](auto& oss) {
+            oss << "uses=" << m.useCount;
+            latency(oss, "prepare", m.prepare);
+            latency(oss, "execute", m.execute);
+            latency(oss, "open", m.openCursor);
+            latency(oss, "fetch", m.fetch);
+            oss << " rows=" << m.rowsFetched << " affected=" << m.rowsAffected
+                << " bytesIn=" << m.messageBytesIn << " bytesOut=" << m.messageBytesOut
+                << " blobBytes=" << m.blobBytes;
+            if (m.serverSamples) {
+                const auto records = m.server.totals();
+                oss << " server{n=" << m.serverSamples << " reads=" << m.server.reads
+                    << " writes=" << m.server.writes << " fetches=" << m.server.fetches
+                    << " marks=" << m.server.marks << " seq=" << records.seqReads
+                    << " idx=" << records.idxReads << '}';
             }
-            // Multi-line comment end
-            if (inComment && c == '*' && next == '/') {
-                inComment = false;
-                i++; // Skip slash
-                continue;
+            if (!m.phases.empty()) {
+                oss << " phases{pack=" << m.phases[Phase::Pack].totalNanos
+                    << " wire=" << m.phases[Phase::Wire].totalNanos
+                    << " unpack=" << m.phases[Phase::Unpack].totalNanos << "ns}";
             }
-            // End of single line comment
-            if (inComment && c == '\n') {
-                inComment = false;
-                continue;
+            oss << " sql=" << m.sql;
+        });
+    }
+}
+
+void StatementCache::resetMetrics() {
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (auto& [hash, entry] : shard.entries) {
+            if (entry->metrics) {
+                entry->metrics->reset();
             }
         }
+    }
+}
 
-        // Skip everything in comments
-        if (inComment) {
-            continue;
+std::vector<StatementCache::HotEntry> StatementCache::getHotSet(size_t limit) const {
+    std::vector<HotEntry> hot;
+    hot.reserve(size_.load(std::memory_order_relaxed));
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const auto& [hash, entry] : shard.entries) {
+            hot.push_back(HotEntry{entry->sql, entry->flags, entry->useCount});
         }
+    }
 
-        // Normalize whitespace (not in strings)
-        if (std::isspace(c)) {
-            if (!lastWasSpace) {
-                normalized += ' ';
-                lastWasSpace = true;
-            }
-            continue;
-        }
+    std::stable_sort(hot.begin(), hot.end(), [](const HotEntry& a, const HotEntry& b) {
+        return a.useCount > b.useCount;
+    });
+    if (limit != 0 && hot.size() > limit) {
+        hot.resize(limit);
+    }
+    return hot;
+}
+
+void StatementCache::saveHotSet(const std::string& path, size_t limit) const {
+    nlohmann::json statements = nlohmann::json::array();
+    for (const auto& entry : getHotSet(limit)) {
+        statements.push_back({
+            {"sql", entry.sql},
+            {"flags", entry.flags},
+            {"uses", entry.useCount}
+        });
+    }
+    const nlohmann::json doc = {{"version", 1}, {"statements", std::move(statements)}};
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw FirebirdException("Cannot open statement hot-set file for writing: " + path);
+    }
+    out << doc.dump(2) << '\n';
+    if (!out) {
+        throw FirebirdException("Failed to write statement hot-set file: " + path);
+    }
+}
 
-        // Convert to uppercase (not in strings)
-        normalized += std::toupper(c);
-        lastWasSpace = false;
+std::vector<StatementCache::HotEntry> StatementCache::loadHotSet(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw FirebirdException("Cannot open statement hot-set file: " + path);
     }
 
-    // Trim trailing whitespace
-    while (!normalized.empty() && std::isspace(normalized.back())) {
-        normalized.pop_back();
+    std::vector<HotEntry> hot;
+    try {
+        const auto doc = nlohmann::json::parse(in);
+        for (const auto& item : doc.at("statements")) {
+            HotEntry entry;
+            entry.sql = item.at("sql").get<std::string>();
+            entry.flags = item.value("flags", static_cast<unsigned>(Statement::PREPARE_DEFAULT));
+            entry.useCount = item.value("uses", size_t{0});
+            hot.push_back(std::move(entry));
+        }
+    } catch (const nlohmann::json::exception& e) {
+        throw FirebirdException("Invalid statement hot-set file " + path + ": " + e.what());
     }
 
-    // Create final key with flags
-    std::stringstream ss;
-    ss << normalized << "|" << flags;
-    return ss.str();
+    std::stable_sort(hot.begin(), hot.end(), [](const HotEntry& a, const HotEntry& b) {
+        return a.useCount > b.useCount;
+    });
+    return hot;
 }
 
-void StatementCache::touchEntry(const std::string& key) {
-    // Move to front of LRU list
-    auto it = lruMap_.find(key);
-    if (it != lruMap_.end()) {
-        // Remove from current position
-        lruList_.erase(it->second);
+size_t StatementCache::warmUp(Connection* connection, const std::vector<HotEntry>& entries,
+                              const std::atomic<bool>* cancel) {
+    size_t warmed = 0;
+    for (const auto& entry : entries) {
+        if (cancel && cancel->load(std::memory_order_relaxed)) {
+            break;
+        }
+        if (!isEnabled()) {
+            break;
+        }
+        try {
+            // The checkout is dropped right away: the instance goes to the
+            // idle pool and the first real get() is a hit.
+            get(connection, entry.sql, entry.flags);
+            counters_.warmups.fetch_add(1, std::memory_order_relaxed);
+            ++warmed;
+        } catch (const std::exception& e) {
+            fbpp::util::trace(fbpp::util::TraceLevel::warn, "StatementCache",
+                        [&](auto& oss) {
+                            oss << "Warm-up skipped statement: " << e.what();
+                        });
+        }
+    }
 
-        // Add to front
-        lruList_.push_front(key);
-        it->second = lruList_.begin();
+    fbpp::util::trace(fbpp::util::TraceLevel::info, "StatementCache",
+                [&](auto& oss) {
+                    oss << "Warm-up prepared " << warmed << " of " << entries.size()
+                        << " statements";
+                });
+    return warmed;
+}
+
+uint64_t SqlKey::hashOf(std::string_view sql, unsigned flags) noexcept {
+    return detail::sqlKeyHash(sql, flags);
+}
+
+bool SqlKey::equivalent(std::string_view a, std::string_view b) noexcept {
+    SqlTokenStream lhs(a);
+    SqlTokenStream rhs(b);
+    for (;;) {
+        const int x = lhs.next();
+        const int y = rhs.next();
+        if (x != y) {
+            return false;
+        }
+        if (x < 0) {
+            return true;
+        }
     }
 }
 
-void StatementCache::evictLRU() {
-    if (lruList_.empty()) {
-        return;
+void StatementCache::touchEntry(CachedStatement& entry) {
+    entry.lastUsed = std::chrono::steady_clock::now();
+    entry.useCount++;
+    entry.lruTick = clock_.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+uint64_t StatementCache::scoreOf(uint64_t hash, uint64_t prepareMicros) const {
+    if (getPolicy() != StatementCachePolicy::CostAwareLfu) {
+        return 0;
     }
+    // Sub-microsecond prepares still count as cost 1 so frequency decides.
+    return static_cast<uint64_t>(sketch_->estimate(hash)) * std::max<uint64_t>(prepareMicros, 1);
+}
 
-    // Get least recently used key (back of list)
-    std::string key = lruList_.back();
+bool StatementCache::selectVictim(Victim& victim) {
+    // O(entries) scan, only on the miss/resize path — the hit path just
+    // stamps lruTick under its shard lock instead of relinking a list.
+    victim = Victim{};
+    bool found = false;
+
+    for (auto& shard : shards_) {
+        auto lock = lockShard(shard);
+        for (const auto& [hash, entry] : shard.entries) {
+            const uint64_t score = scoreOf(hash, entry->prepareMicros);
+            if (!found || score < victim.score ||
+                (score == victim.score && entry->lruTick < victim.lruTick)) {
+                victim = Victim{&shard, hash, entry->id, score, entry->lruTick};
+                found = true;
+            }
+        }
+    }
+    return found;
+}
 
-    // Remove from LRU tracking
-    lruList_.pop_back();
-    lruMap_.erase(key);
+bool StatementCache::evictVictim(const Victim& victim,
+                                 std::vector<std::unique_ptr<CachedStatement>>& victims) {
+    // structureMutex_ is held, so the entry cannot disappear in between;
+    // a concurrent hit may have refreshed it, which only makes the choice
+    // approximate, never wrong.
+    auto lock = lockShard(*victim.shard);
+    auto [first, last] = victim.shard->entries.equal_range(victim.hash);
+    for (auto it = first; it != last; ++it) {
+        if (it->second->id == victim.id) {
+            idle_.fetch_sub(it->second->idle.size(), std::memory_order_relaxed);
+            victims.push_back(std::move(it->second));
+            victim.shard->entries.erase(it);
+            size_.fetch_sub(1, std::memory_order_relaxed);
+            counters_.evictions.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
 
-    // Remove from cache (statement will be freed)
-    cache_.erase(key);
+bool StatementCache::evictOne(std::vector<std::unique_ptr<CachedStatement>>& victims) {
+    Victim victim;
+    return selectVictim(victim) && evictVictim(victim, victims);
+}
 
-    stats_.evictionCount++;
-    stats_.cacheSize = cache_.size();
+void StatementCache::drainAll(std::vector<std::unique_ptr<CachedStatement>>& victims) {
+    for (auto& shard : shards_) {
+        auto lock = lockShard(shard);
+        for (auto& [hash, entry] : shard.entries) {
+            victims.push_back(std::move(entry));
+        }
+        shard.entries.clear();
+    }
+    size_.store(0, std::memory_order_relaxed);
+    idle_.store(0, std::memory_order_relaxed);
 }
 
 void StatementCache::extractMetadata(Statement* statement, CachedStatement& entry) {
@@ -0,0 +1,264 @@
+#include "fbpp/core/statement_metrics.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace fbpp {
+namespace core {
+
+size_t LatencyHistogram::bucketOf(uint64_t micros) noexcept {
+    if (micros < kSubBuckets) {
+        return static_cast<size_t>(micros);
+    }
+    const unsigned exponent = static_cast<unsigned>(std::bit_width(micros)) - 1;
+    if (exponent > kMaxExponent) {
+        return kBucketCount - 1;
+    }
+    const unsigned shift = exponent - kSubBucketBits;
+    const size_t sub = static_cast<size_t>(micros >> shift) & (kSubBuckets - 1);
+    return static_cast<size_t>(shift + 1) * kSubBuckets + sub;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t bucket) noexcept {
+    if (bucket < kSubBuckets) {
+        return bucket;
+    }
+    const unsigned shift = static_cast<unsigned>(bucket / kSubBuckets) - 1;
+    const uint64_t sub = bucket % kSubBuckets;
+    const uint64_t lower = (kSubBuckets + sub) << shift;
+    return lower + ((uint64_t{1} << shift) - 1);
+}
+
+void LatencyHistogram::record(uint64_t micros) noexcept {
+    buckets_[bucketOf(micros)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    total_.fetch_add(micros, std::memory_order_relaxed);
+    uint64_t seen = max_.load(std::memory_order_relaxed);
+    while (micros > seen &&
+           !max_.compare_exchange_weak(seen, micros, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t LatencyHistogram::percentile(double q) const noexcept {
+    // Sum the buckets rather than trusting count_: a concurrent record()
+    // may have bumped one but not yet the other.
+    uint64_t total = 0;
+    for (const auto& bucket : buckets_) {
+        total += bucket.load(std::memory_order_relaxed);
+    }
+    if (total == 0) {
+        return 0;
+    }
+    q = std::clamp(q, 0.0, 1.0);
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * static_cast<double>(total))));
+    const uint64_t maxSeen = max_.load(std::memory_order_relaxed);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return std::min(bucketUpperBound(i), maxSeen);
+        }
+    }
+    return maxSeen;
+}
+
+LatencySnapshot LatencyHistogram::snapshot() const noexcept {
+    LatencySnapshot snap;
+    snap.count = count_.load(std::memory_order_relaxed);
+    snap.totalMicros = total_.load(std::memory_order_relaxed);
+    snap.maxMicros = max_.load(std::memory_order_relaxed);
+    snap.p50Micros = percentile(0.50);
+    snap.p90Micros = percentile(0.90);
+    snap.p99Micros = percentile(0.99);
+    snap.p999Micros = percentile(0.999);
+    return snap;
+}
+
+void LatencyHistogram::reset() noexcept {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    total_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+TableRecordCounters& TableRecordCounters::operator+=(const TableRecordCounters& other) noexcept {
+    seqReads += other.seqReads;
+    idxReads += other.idxReads;
+    inserts += other.inserts;
+    updates += other.updates;
+    deletes += other.deletes;
+    backouts += other.backouts;
+    purges += other.purges;
+    expunges += other.expunges;
+    return *this;
+}
+
+TableRecordCounters ServerCounters::totals() const noexcept {
+    TableRecordCounters sum;
+    for (const auto& table : tables) {
+        sum += table;
+    }
+    return sum;
+}
+
+ServerCounters ServerCounters::delta(const ServerCounters& after, const ServerCounters& before) {
+    // Counters only grow; clamp anyway so a reading taken across a
+    // reconnect cannot wrap around.
+    auto diff = [](uint64_t a, uint64_t b) { return a > b ? a - b : 0; };
+
+    ServerCounters result;
+    result.reads = diff(after.reads, before.reads);
+    result.writes = diff(after.writes, before.writes);
+    result.fetches = diff(after.fetches, before.fetches);
+    result.marks = diff(after.marks, before.marks);
+
+    // Both table lists are sorted by relation id
+    auto prev = before.tables.begin();
+    for (const auto& table : after.tables) {
+        while (prev != before.tables.end() && prev->relationId < table.relationId) {
+            ++prev;
+        }
+        TableRecordCounters d;
+        d.relationId = table.relationId;
+        const bool seen = prev != before.tables.end() && prev->relationId == table.relationId;
+        const TableRecordCounters zero;
+        const TableRecordCounters& base = seen ? *prev : zero;
+        d.seqReads = diff(table.seqReads, base.seqReads);
+        d.idxReads = diff(table.idxReads, base.idxReads);
+        d.inserts = diff(table.inserts, base.inserts);
+        d.updates = diff(table.updates, base.updates);
+        d.deletes = diff(table.deletes, base.deletes);
+        d.backouts = diff(table.backouts, base.backouts);
+        d.purges = diff(table.purges, base.purges);
+        d.expunges = diff(table.expunges, base.expunges);
+        if (d.seqReads || d.idxReads || d.inserts || d.updates || d.deletes ||
+            d.backouts || d.purges || d.expunges) {
+            result.tables.push_back(d);
+        }
+    }
+    return result;
+}
+
+ServerCounters& ServerCounters::operator+=(const ServerCounters& other) {
+    reads += other.reads;
+    writes += other.writes;
+    fetches += other.fetches;
+    marks += other.marks;
+    for (const auto& table : other.tables) {
+        auto it = std::lower_bound(tables.begin(), tables.end(), table.relationId,
+                                   [](const TableRecordCounters& t, uint16_t id) {
+                                       return t.relationId < id;
+                                   });
+        if (it == tables.end() || it->relationId != table.relationId) {
+            it = tables.insert(it, TableRecordCounters{table.relationId});
+        }
+        *it += table;
+    }
+    return *this;
+}
+
+void StatementMetrics::recordServerCounters(const ServerCounters& delta) {
+    std::lock_guard<std::mutex> lock(serverMutex_);
+    server_ += delta;
+    serverSamples_.fetch_add(1, std::memory_order_relaxed);
+}
+
+ServerCounters StatementMetrics::serverCounters() const {
+    std::lock_guard<std::mutex> lock(serverMutex_);
+    return server_;
+}
+
+void StatementMetrics::reset() noexcept {
+    prepare_.reset();
+    execute_.reset();
+    openCursor_.reset();
+    fetch_.reset();
+    for (auto* counter : {&rowsFetched_, &rowsAffected_, &messageBytesIn_,
+                          &messageBytesOut_, &blobBytes_}) {
+        counter->store(0, std::memory_order_relaxed);
+    }
+    for (auto& phase : phases_) {
+        phase.calls.store(0, std::memory_order_relaxed);
+        phase.nanos.store(0, std::memory_order_relaxed);
+    }
+    std::lock_guard<std::mutex> lock(serverMutex_);
+    server_ = ServerCounters{};
+    serverSamples_.store(0, std::memory_order_relaxed);
+}
+
+PhaseBreakdown StatementMetrics::phases() const noexcept {
+    PhaseBreakdown breakdown;
+    for (size_t i = 0; i < kPhaseCount; ++i) {
+        breakdown.phases[i].calls = phases_[i].calls.load(std::memory_order_relaxed);
+        breakdown.phases[i].totalNanos = phases_[i].nanos.load(std::memory_order_relaxed);
+    }
+    return breakdown;
+}
+
+StatementMetricsSnapshot StatementMetricsSnapshot::of(const StatementMetrics& metrics) {
+    StatementMetricsSnapshot snap;
+    snap.prepare = metrics.prepare().snapshot();
+    snap.execute = metrics.execute().snapshot();
+    snap.openCursor = metrics.openCursor().snapshot();
+    snap.fetch = metrics.fetch().snapshot();
+    snap.rowsFetched = metrics.rowsFetched();
+    snap.rowsAffected = metrics.rowsAffected();
+    snap.messageBytesIn = metrics.messageBytesIn();
+    snap.messageBytesOut = metrics.messageBytesOut();
+    snap.blobBytes = metrics.blobBytes();
+    snap.serverSamples = metrics.serverSamples();
+    if (snap.serverSamples) {
+        snap.server = metrics.serverCounters();
+    }
+    snap.phases = metrics.phases();
+    return snap;
+}
+
+namespace detail {
+
+namespace {
+
+// Raw pointer for the cheap "already current" test on every served row,
+// weak reference for the actual attribution.
+struct BlobMetricsTarget {
+    const StatementMetrics* raw = nullptr;
+    std::weak_ptr<StatementMetrics> weak;
+};
+
+thread_local BlobMetricsTarget blobMetricsTarget;
+
+} // namespace
+
+void BlobMetricsScope::set(const std::shared_ptr<StatementMetrics>& metrics) noexcept {
+    auto& target = blobMetricsTarget;
+    if (target.raw != metrics.get() || target.weak.expired()) {
+        target.raw = metrics.get();
+        target.weak = metrics;
+    }
+}
+
+void BlobMetricsScope::release(const StatementMetrics* metrics) noexcept {
+    auto& target = blobMetricsTarget;
+    if (metrics && target.raw == metrics) {
+        target.raw = nullptr;
+        target.weak.reset();
+    }
+}
+
+void BlobMetricsScope::noteBytes(uint64_t bytes) noexcept {
+    auto& target = blobMetricsTarget;
+    if (bytes == 0 || !target.raw) {
+        return;
+    }
+    if (auto metrics = target.weak.lock()) {
+        metrics->recordBlobBytes(bytes);
+    }
+}
+
+} // namespace detail
+
+} // namespace core
+} // namespace fbpp
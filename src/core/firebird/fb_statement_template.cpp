@@ -0,0 +1,170 @@
+#include "fbpp/core/statement_template.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/statement_cache.hpp"
+#include "fbpp/core/named_param_parser.hpp"
+
+#include <utility>
+
+namespace fbpp {
+namespace core {
+
+StatementTemplate::StatementTemplate(std::string scope, std::string sql,
+                                     unsigned flags, uint64_t hash,
+                                     const NamedParamParser::ParseResult* parsed)
+    : scope_(std::move(scope)), sql_(std::move(sql)), flags_(flags), hash_(hash) {
+    auto parseResult = parsed ? *parsed : NamedParamParser::parse(sql_);
+    if (parseResult.hasNamedParams) {
+        actualSql_ = std::move(parseResult.convertedSql);
+        nameToPositions_ = std::move(parseResult.nameToPositions);
+        hasNamedParams_ = true;
+    }
+}
+
+bool StatementTemplate::applyLayouts(Statement& statement) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!published_) {
+        return false;
+    }
+    statement.setMetadataLayouts(inputLayout_, outputLayout_);
+    return true;
+}
+
+void StatementTemplate::publishLayouts(const Statement& statement) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (published_ || retired_) {
+            return;
+        }
+    }
+
+    // Decoding happens outside the lock; it talks to the statement's own
+    // IMessageMetadata and is done once per Statement anyway.
+    auto inMeta = statement.getInputMetadata();
+    auto outMeta = statement.getOutputMetadata();
+    auto inLayout = inMeta ? inMeta->getLayout() : nullptr;
+    auto outLayout = outMeta ? outMeta->getLayout() : nullptr;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (published_ || retired_) {
+        return;
+    }
+    inputLayout_ = std::move(inLayout);
+    outputLayout_ = std::move(outLayout);
+    published_ = true;
+}
+
+void StatementTemplate::dropLayouts() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    inputLayout_.reset();
+    outputLayout_.reset();
+    published_ = false;
+    retired_ = true;
+}
+
+bool StatementTemplate::hasLayouts() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return published_;
+}
+
+StatementTemplateRegistry& StatementTemplateRegistry::instance() {
+    static StatementTemplateRegistry registry;
+    return registry;
+}
+
+std::shared_ptr<StatementTemplate> StatementTemplateRegistry::acquire(
+        const std::string& scope, const std::string& sql, unsigned flags, uint64_t hash,
+        const NamedParamParser::ParseResult* parsed) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto [first, last] = templates_.equal_range(hash);
+    for (auto it = first; it != last; ++it) {
+        auto tmpl = it->second.lock();
+        if (tmpl && tmpl->flags() == flags && tmpl->scope() == scope &&
+            (tmpl->sql() == sql || SqlKey::equivalent(tmpl->sql(), sql))) {
+            ++hits_;
+            return tmpl;
+        }
+    }
+
+    // Templates die with the last cache entry using them; sweep their
+    // expired slots once the map has grown well past the last live count.
+    if (templates_.size() >= purgeThreshold_) {
+        purgeExpired();
+    }
+
+    ++misses_;
+    auto tmpl = std::make_shared<StatementTemplate>(scope, sql, flags, hash, parsed);
+    templates_.emplace(hash, tmpl);
+    return tmpl;
+}
+
+uint64_t StatementTemplateRegistry::invalidate(const std::string& scope) {
+    std::vector<std::shared_ptr<StatementTemplate>> retired;
+    uint64_t epoch = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        epoch = ++epochs_[scope];
+        changes_.fetch_add(1, std::memory_order_acq_rel);
+        for (auto it = templates_.begin(); it != templates_.end();) {
+            auto tmpl = it->second.lock();
+            if (!tmpl || tmpl->scope() == scope) {
+                if (tmpl) {
+                    retired.push_back(std::move(tmpl));
+                }
+                it = templates_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    // Templates take their own mutex; do it after releasing ours.
+    for (auto& tmpl : retired) {
+        tmpl->dropLayouts();
+    }
+    return epoch;
+}
+
+uint64_t StatementTemplateRegistry::schemaEpoch(const std::string& scope) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = epochs_.find(scope);
+    return it != epochs_.end() ? it->second : 0;
+}
+
+void StatementTemplateRegistry::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    templates_.clear();
+    purgeThreshold_ = 64;
+}
+
+StatementTemplateRegistry::Statistics StatementTemplateRegistry::getStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Statistics stats;
+    for (const auto& [hash, weak] : templates_) {
+        if (!weak.expired()) {
+            ++stats.templateCount;
+        }
+    }
+    stats.hitCount = hits_;
+    stats.missCount = misses_;
+    stats.layoutReuseCount = layoutReuses_;
+    return stats;
+}
+
+void StatementTemplateRegistry::noteLayoutReuse() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++layoutReuses_;
+}
+
+void StatementTemplateRegistry::purgeExpired() {
+    for (auto it = templates_.begin(); it != templates_.end();) {
+        if (it->second.expired()) {
+            it = templates_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    purgeThreshold_ = templates_.size() * 2 + 64;
+}
+
+} // namespace core
+} // namespace fbpp
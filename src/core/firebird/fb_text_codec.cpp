@@ -0,0 +1,605 @@
+#include "fbpp/core/text_codec.hpp"
+#include "fbpp/core/exception.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FBPP_TEXT_CODEC_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define FBPP_TEXT_CODEC_NEON 1
+#endif
+
+namespace fbpp {
+namespace core {
+
+namespace {
+
+constexpr char16_t kReplacement = 0xFFFD;
+
+// Upper halves (0x80..0xFF) of the single-byte code pages; undefined
+// positions map to U+FFFD.
+constexpr char16_t kWin1250[128] = {
+    0x20AC, 0xFFFD, 0x201A, 0xFFFD, 0x201E, 0x2026, 0x2020, 0x2021,
+    0xFFFD, 0x2030, 0x0160, 0x2039, 0x015A, 0x0164, 0x017D, 0x0179,
+    0xFFFD, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+    0xFFFD, 0x2122, 0x0161, 0x203A, 0x015B, 0x0165, 0x017E, 0x017A,
+    0x00A0, 0x02C7, 0x02D8, 0x0141, 0x00A4, 0x0104, 0x00A6, 0x00A7,
+    0x00A8, 0x00A9, 0x015E, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x017B,
+    0x00B0, 0x00B1, 0x02DB, 0x0142, 0x00B4, 0x00B5, 0x00B6, 0x00B7,
+    0x00B8, 0x0105, 0x015F, 0x00BB, 0x013D, 0x02DD, 0x013E, 0x017C,
+    0x0154, 0x00C1, 0x00C2, 0x0102, 0x00C4, 0x0139, 0x0106, 0x00C7,
+    0x010C, 0x00C9, 0x0118, 0x00CB, 0x011A, 0x00CD, 0x00CE, 0x010E,
+    0x0110, 0x0143, 0x0147, 0x00D3, 0x00D4, 0x0150, 0x00D6, 0x00D7,
+    0x0158, 0x016E, 0x00DA, 0x0170, 0x00DC, 0x00DD, 0x0162, 0x00DF,
+    0x0155, 0x00E1, 0x00E2, 0x0103, 0x00E4, 0x013A, 0x0107, 0x00E7,
+    0x010D, 0x00E9, 0x0119, 0x00EB, 0x011B, 0x00ED, 0x00EE, 0x010F,
+    0x0111, 0x0144, 0x0148, 0x00F3, 0x00F4, 0x0151, 0x00F6, 0x00F7,
+    0x0159, 0x016F, 0x00FA, 0x0171, 0x00FC, 0x00FD, 0x0163, 0x02D9,
+};
+
+constexpr char16_t kWin1251[128] = {
+    0x0402, 0x0403, 0x201A, 0x0453, 0x201E, 0x2026, 0x2020, 0x2021,
+    0x20AC, 0x2030, 0x0409, 0x2039, 0x040A, 0x040C, 0x040B, 0x040F,
+    0x0452, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+    0xFFFD, 0x2122, 0x0459, 0x203A, 0x045A, 0x045C, 0x045B, 0x045F,
+    0x00A0, 0x040E, 0x045E, 0x0408, 0x00A4, 0x0490, 0x00A6, 0x00A7,
+    0x0401, 0x00A9, 0x0404, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x0407,
+    0x00B0, 0x00B1, 0x0406, 0x0456, 0x0491, 0x00B5, 0x00B6, 0x00B7,
+    0x0451, 0x2116, 0x0454, 0x00BB, 0x0458, 0x0405, 0x0455, 0x0457,
+    0x0410, 0x0411, 0x0412, 0x0413, 0x0414, 0x0415, 0x0416, 0x0417,
+    0x0418, 0x0419, 0x041A, 0x041B, 0x041C, 0x041D, 0x041E, 0x041F,
+    0x0420, 0x0421, 0x0422, 0x0423, 0x0424, 0x0425, 0x0426, 0x0427,
+    0x0428, 0x0429, 0x042A, 0x042B, 0x042C, 0x042D, 0x042E, 0x042F,
+    0x0430, 0x0431, 0x0432, 0x0433, 0x0434, 0x0435, 0x0436, 0x0437,
+    0x0438, 0x0439, 0x043A, 0x043B, 0x043C, 0x043D, 0x043E, 0x043F,
+    0x0440, 0x0441, 0x0442, 0x0443, 0x0444, 0x0445, 0x0446, 0x0447,
+    0x0448, 0x0449, 0x044A, 0x044B, 0x044C, 0x044D, 0x044E, 0x044F,
+};
+
+constexpr char16_t kWin1252[128] = {
+    0x20AC, 0xFFFD, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+    0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0xFFFD, 0x017D, 0xFFFD,
+    0xFFFD, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+    0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0xFFFD, 0x017E, 0x0178,
+    0x00A0, 0x00A1, 0x00A2, 0x00A3, 0x00A4, 0x00A5, 0x00A6, 0x00A7,
+    0x00A8, 0x00A9, 0x00AA, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x00AF,
+    0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x00B4, 0x00B5, 0x00B6, 0x00B7,
+    0x00B8, 0x00B9, 0x00BA, 0x00BB, 0x00BC, 0x00BD, 0x00BE, 0x00BF,
+    0x00C0, 0x00C1, 0x00C2, 0x00C3, 0x00C4, 0x00C5, 0x00C6, 0x00C7,
+    0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF,
+    0x00D0, 0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x00D5, 0x00D6, 0x00D7,
+    0x00D8, 0x00D9, 0x00DA, 0x00DB, 0x00DC, 0x00DD, 0x00DE, 0x00DF,
+    0x00E0, 0x00E1, 0x00E2, 0x00E3, 0x00E4, 0x00E5, 0x00E6, 0x00E7,
+    0x00E8, 0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE, 0x00EF,
+    0x00F0, 0x00F1, 0x00F2, 0x00F3, 0x00F4, 0x00F5, 0x00F6, 0x00F7,
+    0x00F8, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x00FD, 0x00FE, 0x00FF,
+};
+
+constexpr char16_t kKoi8R[128] = {
+    0x2500, 0x2502, 0x250C, 0x2510, 0x2514, 0x2518, 0x251C, 0x2524,
+    0x252C, 0x2534, 0x253C, 0x2580, 0x2584, 0x2588, 0x258C, 0x2590,
+    0x2591, 0x2592, 0x2593, 0x2320, 0x25A0, 0x2219, 0x221A, 0x2248,
+    0x2264, 0x2265, 0x00A0, 0x2321, 0x00B0, 0x00B2, 0x00B7, 0x00F7,
+    0x2550, 0x2551, 0x2552, 0x0451, 0x2553, 0x2554, 0x2555, 0x2556,
+    0x2557, 0x2558, 0x2559, 0x255A, 0x255B, 0x255C, 0x255D, 0x255E,
+    0x255F, 0x2560, 0x2561, 0x0401, 0x2562, 0x2563, 0x2564, 0x2565,
+    0x2566, 0x2567, 0x2568, 0x2569, 0x256A, 0x256B, 0x256C, 0x00A9,
+    0x044E, 0x0430, 0x0431, 0x0446, 0x0434, 0x0435, 0x0444, 0x0433,
+    0x0445, 0x0438, 0x0439, 0x043A, 0x043B, 0x043C, 0x043D, 0x043E,
+    0x043F, 0x044F, 0x0440, 0x0441, 0x0442, 0x0443, 0x0436, 0x0432,
+    0x044C, 0x044B, 0x0437, 0x0448, 0x044D, 0x0449, 0x0447, 0x044A,
+    0x042E, 0x0410, 0x0411, 0x0426, 0x0414, 0x0415, 0x0424, 0x0413,
+    0x0425, 0x0418, 0x0419, 0x041A, 0x041B, 0x041C, 0x041D, 0x041E,
+    0x041F, 0x042F, 0x0420, 0x0421, 0x0422, 0x0423, 0x0416, 0x0412,
+    0x042C, 0x042B, 0x0417, 0x0428, 0x042D, 0x0429, 0x0427, 0x042A,
+};
+
+constexpr char16_t kKoi8U[128] = {
+    0x2500, 0x2502, 0x250C, 0x2510, 0x2514, 0x2518, 0x251C, 0x2524,
+    0x252C, 0x2534, 0x253C, 0x2580, 0x2584, 0x2588, 0x258C, 0x2590,
+    0x2591, 0x2592, 0x2593, 0x2320, 0x25A0, 0x2219, 0x221A, 0x2248,
+    0x2264, 0x2265, 0x00A0, 0x2321, 0x00B0, 0x00B2, 0x00B7, 0x00F7,
+    0x2550, 0x2551, 0x2552, 0x0451, 0x0454, 0x2554, 0x0456, 0x0457,
+    0x2557, 0x2558, 0x2559, 0x255A, 0x255B, 0x0491, 0x255D, 0x255E,
+    0x255F, 0x2560, 0x2561, 0x0401, 0x0404, 0x2563, 0x0406, 0x0407,
+    0x2566, 0x2567, 0x2568, 0x2569, 0x256A, 0x0490, 0x256C, 0x00A9,
+    0x044E, 0x0430, 0x0431, 0x0446, 0x0434, 0x0435, 0x0444, 0x0433,
+    0x0445, 0x0438, 0x0439, 0x043A, 0x043B, 0x043C, 0x043D, 0x043E,
+    0x043F, 0x044F, 0x0440, 0x0441, 0x0442, 0x0443, 0x0436, 0x0432,
+    0x044C, 0x044B, 0x0437, 0x0448, 0x044D, 0x0449, 0x0447, 0x044A,
+    0x042E, 0x0410, 0x0411, 0x0426, 0x0414, 0x0415, 0x0424, 0x0413,
+    0x0425, 0x0418, 0x0419, 0x041A, 0x041B, 0x041C, 0x041D, 0x041E,
+    0x041F, 0x042F, 0x0420, 0x0421, 0x0422, 0x0423, 0x0416, 0x0412,
+    0x042C, 0x042B, 0x0417, 0x0428, 0x042D, 0x0429, 0x0427, 0x042A,
+};
+
+const char16_t* upperHalf(SingleByteCharset charset) noexcept {
+    switch (charset) {
+        case SingleByteCharset::Win1250: return kWin1250;
+        case SingleByteCharset::Win1251: return kWin1251;
+        case SingleByteCharset::Win1252: return kWin1252;
+        case SingleByteCharset::Koi8R:   return kKoi8R;
+        case SingleByteCharset::Koi8U:   return kKoi8U;
+        case SingleByteCharset::Latin1:  break;
+    }
+    return nullptr;   // Latin1: byte value == code point
+}
+
+inline char16_t singleByteUnit(const char16_t* upper, uint8_t byte) noexcept {
+    return (byte < 0x80 || !upper) ? static_cast<char16_t>(byte) : upper[byte - 0x80];
+}
+
+// Length of the leading ASCII run of [p, p + n)
+std::size_t asciiPrefix(const uint8_t* p, std::size_t n) noexcept {
+    std::size_t i = 0;
+#if defined(FBPP_TEXT_CODEC_SSE2)
+    while (i + 16 <= n) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        if (_mm_movemask_epi8(block) != 0) {
+            break;
+        }
+        i += 16;
+    }
+#elif defined(FBPP_TEXT_CODEC_NEON)
+    while (i + 16 <= n) {
+        if (vmaxvq_u8(vld1q_u8(p + i)) >= 0x80) {
+            break;
+        }
+        i += 16;
+    }
+#endif
+    while (i < n && p[i] < 0x80) {
+        ++i;
+    }
+    return i;
+}
+
+// Widen an ASCII run to UTF-16
+void widenAscii(const uint8_t* p, std::size_t n, char16_t* out) noexcept {
+    std::size_t i = 0;
+#if defined(FBPP_TEXT_CODEC_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_unpacklo_epi8(block, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 8), _mm_unpackhi_epi8(block, zero));
+    }
+#elif defined(FBPP_TEXT_CODEC_NEON)
+    for (; i + 16 <= n; i += 16) {
+        const uint8x16_t block = vld1q_u8(p + i);
+        vst1q_u16(reinterpret_cast<uint16_t*>(out + i), vmovl_u8(vget_low_u8(block)));
+        vst1q_u16(reinterpret_cast<uint16_t*>(out + i + 8), vmovl_u8(vget_high_u8(block)));
+    }
+#endif
+    for (; i < n; ++i) {
+        out[i] = static_cast<char16_t>(p[i]);
+    }
+}
+
+inline bool isContinuation(uint8_t byte) noexcept {
+    return (byte & 0xC0) == 0x80;
+}
+
+// Decode one multi-byte sequence at p (p[0] >= 0x80). Returns its length,
+// or 0 if it is malformed.
+std::size_t decodeSequence(const uint8_t* p, std::size_t remaining, char32_t& codePoint) noexcept {
+    const uint8_t lead = p[0];
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        if (remaining < 2 || !isContinuation(p[1])) {
+            return 0;
+        }
+        codePoint = (static_cast<char32_t>(lead & 0x1F) << 6) | (p[1] & 0x3F);
+        return 2;
+    }
+    if (lead >= 0xE0 && lead <= 0xEF) {
+        if (remaining < 3 || !isContinuation(p[1]) || !isContinuation(p[2])) {
+            return 0;
+        }
+        if ((lead == 0xE0 && p[1] < 0xA0) || (lead == 0xED && p[1] > 0x9F)) {
+            return 0;   // Overlong / UTF-16 surrogate
+        }
+        codePoint = (static_cast<char32_t>(lead & 0x0F) << 12) |
+                    (static_cast<char32_t>(p[1] & 0x3F) << 6) | (p[2] & 0x3F);
+        return 3;
+    }
+    if (lead >= 0xF0 && lead <= 0xF4) {
+        if (remaining < 4 || !isContinuation(p[1]) || !isContinuation(p[2]) ||
+            !isContinuation(p[3])) {
+            return 0;
+        }
+        if ((lead == 0xF0 && p[1] < 0x90) || (lead == 0xF4 && p[1] > 0x8F)) {
+            return 0;   // Overlong / above U+10FFFF
+        }
+        codePoint = (static_cast<char32_t>(lead & 0x07) << 18) |
+                    (static_cast<char32_t>(p[1] & 0x3F) << 12) |
+                    (static_cast<char32_t>(p[2] & 0x3F) << 6) | (p[3] & 0x3F);
+        return 4;
+    }
+    return 0;
+}
+
+// Bytes of the sequence led by `lead` (1 for ASCII and bytes that lead none)
+std::size_t sequenceLength(uint8_t lead) noexcept {
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        return 2;
+    }
+    if (lead >= 0xE0 && lead <= 0xEF) {
+        return 3;
+    }
+    if (lead >= 0xF0 && lead <= 0xF4) {
+        return 4;
+    }
+    return 1;
+}
+
+struct ReverseEntry {
+    char16_t unit;
+    uint8_t byte;
+};
+
+// Upper-half code points of a table, sorted for lookup; undefined positions left out
+std::vector<ReverseEntry> buildReverse(const char16_t* upper) {
+    std::vector<ReverseEntry> entries;
+    for (unsigned i = 0; i < 128; ++i) {
+        if (upper[i] != kReplacement) {
+            entries.push_back({upper[i], static_cast<uint8_t>(0x80 + i)});
+        }
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const ReverseEntry& a, const ReverseEntry& b) { return a.unit < b.unit; });
+    return entries;
+}
+
+const std::vector<ReverseEntry>& reverseTable(SingleByteCharset charset) {
+    static const std::vector<ReverseEntry> win1250 = buildReverse(kWin1250);
+    static const std::vector<ReverseEntry> win1251 = buildReverse(kWin1251);
+    static const std::vector<ReverseEntry> win1252 = buildReverse(kWin1252);
+    static const std::vector<ReverseEntry> koi8r = buildReverse(kKoi8R);
+    static const std::vector<ReverseEntry> koi8u = buildReverse(kKoi8U);
+    switch (charset) {
+        case SingleByteCharset::Win1250: return win1250;
+        case SingleByteCharset::Win1251: return win1251;
+        case SingleByteCharset::Win1252: return win1252;
+        case SingleByteCharset::Koi8R:   return koi8r;
+        case SingleByteCharset::Koi8U:
+        case SingleByteCharset::Latin1:  break;
+    }
+    return koi8u;
+}
+
+// Byte for `codePoint` in `charset`, or -1 when the code page has none
+int encodeSingleByte(SingleByteCharset charset, char32_t codePoint) {
+    if (codePoint < 0x80) {
+        return static_cast<int>(codePoint);
+    }
+    if (charset == SingleByteCharset::Latin1) {
+        return codePoint <= 0xFF ? static_cast<int>(codePoint) : -1;
+    }
+    const auto& table = reverseTable(charset);
+    const auto it = std::lower_bound(
+        table.begin(), table.end(), codePoint,
+        [](const ReverseEntry& entry, char32_t value) { return entry.unit < value; });
+    return it != table.end() && it->unit == codePoint ? it->byte : -1;
+}
+
+void appendUtf8(char32_t codePoint, std::string& out) {
+    if (codePoint < 0x80) {
+        out.push_back(static_cast<char>(codePoint));
+    } else if (codePoint < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else if (codePoint < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+}
+
+[[noreturn]] void throwInvalidUtf8(std::size_t offset) {
+    throw FirebirdException("Invalid UTF-8 sequence at byte " + std::to_string(offset));
+}
+
+// Shared walk for utf16Length() / utf8ToUtf16(); `out` may be null (count only).
+std::size_t transcodeUtf8(std::string_view text, char16_t* out, Utf8Errors errors) {
+    const auto* p = reinterpret_cast<const uint8_t*>(text.data());
+    const std::size_t n = text.size();
+    std::size_t i = 0;
+    std::size_t units = 0;
+    while (i < n) {
+        const std::size_t ascii = asciiPrefix(p + i, n - i);
+        if (ascii != 0) {
+            if (out) {
+                widenAscii(p + i, ascii, out + units);
+            }
+            i += ascii;
+            units += ascii;
+            continue;
+        }
+
+        char32_t codePoint = 0;
+        const std::size_t length = decodeSequence(p + i, n - i, codePoint);
+        if (length == 0) {
+            if (errors == Utf8Errors::Throw) {
+                throwInvalidUtf8(i);
+            }
+            if (out) {
+                out[units] = kReplacement;
+            }
+            ++units;
+            ++i;
+            continue;
+        }
+        if (codePoint >= 0x10000) {
+            if (out) {
+                const char32_t v = codePoint - 0x10000;
+                out[units] = static_cast<char16_t>(0xD800 + (v >> 10));
+                out[units + 1] = static_cast<char16_t>(0xDC00 + (v & 0x3FF));
+            }
+            units += 2;
+        } else {
+            if (out) {
+                out[units] = static_cast<char16_t>(codePoint);
+            }
+            ++units;
+        }
+        i += length;
+    }
+    return units;
+}
+
+} // namespace
+
+std::optional<SingleByteCharset> singleByteCharsetForId(unsigned charSetId) noexcept {
+    switch (charSetId) {
+        case 21: return SingleByteCharset::Latin1;    // ISO8859_1
+        case 51: return SingleByteCharset::Win1250;
+        case 52: return SingleByteCharset::Win1251;
+        case 53: return SingleByteCharset::Win1252;
+        case 63: return SingleByteCharset::Koi8R;
+        case 64: return SingleByteCharset::Koi8U;
+        default: return std::nullopt;
+    }
+}
+
+bool isValidUtf8(std::string_view text) noexcept {
+    const auto* p = reinterpret_cast<const uint8_t*>(text.data());
+    const std::size_t n = text.size();
+    std::size_t i = 0;
+    while (i < n) {
+        i += asciiPrefix(p + i, n - i);
+        if (i == n) {
+            break;
+        }
+        char32_t codePoint = 0;
+        const std::size_t length = decodeSequence(p + i, n - i, codePoint);
+        if (length == 0) {
+            return false;
+        }
+        i += length;
+    }
+    return true;
+}
+
+std::size_t utf16Length(std::string_view text, Utf8Errors errors) {
+    return transcodeUtf8(text, nullptr, errors);
+}
+
+std::size_t utf8ToUtf16(std::string_view text, char16_t* out, Utf8Errors errors) {
+    return transcodeUtf8(text, out, errors);
+}
+
+std::u16string utf8ToUtf16(std::string_view text, Utf8Errors errors) {
+    // UTF-16 never needs more units than UTF-8 has bytes: size once, trim.
+    std::u16string result(text.size(), u'\0');
+    result.resize(transcodeUtf8(text, result.data(), errors));
+    return result;
+}
+
+void singleByteToUtf16(std::string_view bytes, SingleByteCharset charset, char16_t* out) noexcept {
+    const auto* p = reinterpret_cast<const uint8_t*>(bytes.data());
+    const char16_t* upper = upperHalf(charset);
+    std::size_t i = 0;
+    while (i < bytes.size()) {
+        const std::size_t ascii = asciiPrefix(p + i, bytes.size() - i);
+        widenAscii(p + i, ascii, out + i);
+        i += ascii;
+        while (i < bytes.size() && p[i] >= 0x80) {
+            out[i] = singleByteUnit(upper, p[i]);
+            ++i;
+        }
+    }
+}
+
+void appendSingleByteAsUtf8(std::string_view bytes, SingleByteCharset charset, std::string& out) {
+    const auto* p = reinterpret_cast<const uint8_t*>(bytes.data());
+    const char16_t* upper = upperHalf(charset);
+    std::size_t i = 0;
+    while (i < bytes.size()) {
+        const std::size_t ascii = asciiPrefix(p + i, bytes.size() - i);
+        out.append(bytes.data() + i, ascii);
+        i += ascii;
+        while (i < bytes.size() && p[i] >= 0x80) {
+            const char16_t unit = singleByteUnit(upper, p[i]);
+            if (unit < 0x800) {
+                out.push_back(static_cast<char>(0xC0 | (unit >> 6)));
+                out.push_back(static_cast<char>(0x80 | (unit & 0x3F)));
+            } else {
+                out.push_back(static_cast<char>(0xE0 | (unit >> 12)));
+                out.push_back(static_cast<char>(0x80 | ((unit >> 6) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | (unit & 0x3F)));
+            }
+            ++i;
+        }
+    }
+}
+
+std::string singleByteToUtf8(std::string_view bytes, SingleByteCharset charset) {
+    std::string result;
+    result.reserve(bytes.size() * 2);   // Upper-half chars take 2..3 bytes
+    appendSingleByteAsUtf8(bytes, charset, result);
+    return result;
+}
+
+TextTranscoder::TextTranscoder(std::optional<SingleByteCharset> from,
+                               std::optional<SingleByteCharset> to, Utf8Errors errors) noexcept
+    : from_(from), to_(to), errors_(errors), passThrough_(from && to && *from == *to) {}
+
+TextTranscoder TextTranscoder::forCharsetIds(unsigned from, unsigned to, Utf8Errors errors) {
+    if (from == to) {
+        TextTranscoder same(std::nullopt, std::nullopt, errors);
+        same.passThrough_ = true;
+        return same;
+    }
+    auto side = [](unsigned id) -> std::optional<SingleByteCharset> {
+        if (id == 3 || id == 4) {   // UNICODE_FSS, UTF8
+            return std::nullopt;
+        }
+        if (auto charset = singleByteCharsetForId(id)) {
+            return charset;
+        }
+        throw FirebirdException("TextTranscoder: no conversion for character set id " +
+                                std::to_string(id));
+    };
+    return TextTranscoder(side(from), side(to), errors);
+}
+
+void TextTranscoder::reset() noexcept {
+    pendingSize_ = 0;
+    bytesIn_ = 0;
+}
+
+void TextTranscoder::feed(std::string_view chunk, std::string& out) {
+    const auto* p = reinterpret_cast<const uint8_t*>(chunk.data());
+    const std::size_t n = chunk.size();
+    const uint64_t start = bytesIn_;
+    bytesIn_ += n;
+    if (passThrough_) {
+        out.append(chunk);
+        return;
+    }
+    if (from_) {
+        // Single-byte source: every byte is a whole character
+        if (!to_) {
+            appendSingleByteAsUtf8(chunk, *from_, out);
+        } else {
+            convert(p, n, start, out);
+        }
+        return;
+    }
+
+    std::size_t i = 0;
+    if (pendingSize_ != 0) {
+        const std::size_t need = sequenceLength(pendingBytes_[0]);
+        while (pendingSize_ < need && i < n && isContinuation(p[i])) {
+            pendingBytes_[pendingSize_++] = p[i++];
+        }
+        if (pendingSize_ < need && i == n) {
+            return;   // Still incomplete: a chunk of continuation bytes only
+        }
+        // Complete, or cut short by a byte that continues nothing: malformed then
+        const std::size_t held = std::exchange(pendingSize_, 0);
+        convert(pendingBytes_, held, start + i - held, out);
+    }
+
+    // Hold back a sequence the chunk ends inside
+    std::size_t end = n;
+    for (std::size_t k = 1; k <= 3 && k <= n - i; ++k) {
+        const uint8_t byte = p[n - k];
+        if (isContinuation(byte)) {
+            continue;
+        }
+        if (sequenceLength(byte) > k) {
+            end = n - k;
+        }
+        break;
+    }
+    convert(p + i, end - i, start + i, out);
+    for (std::size_t j = end; j < n; ++j) {
+        pendingBytes_[pendingSize_++] = p[j];
+    }
+}
+
+void TextTranscoder::finish(std::string& out) {
+    const std::size_t held = std::exchange(pendingSize_, 0);
+    const uint64_t offset = bytesIn_ - held;
+    bytesIn_ = 0;
+    if (held != 0) {
+        convert(pendingBytes_, held, offset, out);   // Truncated: reported as malformed
+    }
+}
+
+void TextTranscoder::convert(const uint8_t* p, std::size_t n, uint64_t offset, std::string& out) {
+    const char16_t* upper = from_ ? upperHalf(*from_) : nullptr;
+    std::size_t i = 0;
+    while (i < n) {
+        const std::size_t ascii = asciiPrefix(p + i, n - i);
+        out.append(reinterpret_cast<const char*>(p + i), ascii);
+        i += ascii;
+        if (i == n) {
+            break;
+        }
+        if (from_) {
+            emitCodePoint(singleByteUnit(upper, p[i]), offset + i, out);
+            ++i;
+            continue;
+        }
+        char32_t codePoint = 0;
+        const std::size_t length = decodeSequence(p + i, n - i, codePoint);
+        if (length == 0) {
+            emitInvalid(offset + i, out);
+            ++i;
+            continue;
+        }
+        if (to_) {
+            emitCodePoint(codePoint, offset + i, out);
+        } else {
+            out.append(reinterpret_cast<const char*>(p + i), length);   // Already valid UTF-8
+        }
+        i += length;
+    }
+}
+
+void TextTranscoder::emitCodePoint(char32_t codePoint, uint64_t offset, std::string& out) {
+    if (!to_) {
+        appendUtf8(codePoint, out);
+        return;
+    }
+    const int byte = encodeSingleByte(*to_, codePoint);
+    if (byte >= 0) {
+        out.push_back(static_cast<char>(byte));
+        return;
+    }
+    if (errors_ == Utf8Errors::Throw) {
+        char hex[16];
+        std::snprintf(hex, sizeof hex, "U+%04X", static_cast<unsigned>(codePoint));
+        throw FirebirdException(std::string("Character ") + hex + " at byte " +
+                                std::to_string(offset) + " has no mapping in the target code page");
+    }
+    out.push_back('?');
+}
+
+void TextTranscoder::emitInvalid(uint64_t offset, std::string& out) {
+    if (errors_ == Utf8Errors::Throw) {
+        throwInvalidUtf8(static_cast<std::size_t>(offset));
+    }
+    if (to_) {
+        out.push_back('?');
+    } else {
+        out.append("\xEF\xBF\xBD");   // U+FFFD
+    }
+}
+
+} // namespace core
+} // namespace fbpp
@@ -0,0 +1,232 @@
+#include "fbpp/core/time_zone_table.hpp"
+#include "fbpp/core/environment.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/firebird_compat.hpp"
+#include "fbpp/core/timestamp_utils.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+
+namespace fbpp {
+namespace core {
+
+namespace {
+
+// Firebird encodes "+hh:mm" zones as displacement-in-minutes + 1439.
+constexpr int32_t kOffsetZoneBias = 23 * 60 + 59;
+constexpr uint16_t kMaxOffsetZoneId = 2 * kOffsetZoneBias;
+
+constexpr int64_t kMicrosPerMinute = 60LL * 1000000LL;
+
+// Any date works for name <-> id lookups; the zone id does not depend on it.
+constexpr unsigned kProbeYear = 2000;
+
+#if !defined(__BORLANDC__)
+int64_t secondsToMicrosClamped(std::chrono::sys_seconds tp) noexcept {
+    constexpr int64_t limit = std::numeric_limits<int64_t>::max() / 1000000;
+    const int64_t seconds = tp.time_since_epoch().count();
+    if (seconds >= limit) return std::numeric_limits<int64_t>::max();
+    if (seconds <= -limit) return std::numeric_limits<int64_t>::min();
+    return seconds * 1000000;
+}
+#endif
+
+} // namespace
+
+struct TimeZoneTable::Region {
+    std::string name;
+#if !defined(__BORLANDC__)
+    const std::chrono::time_zone* zone = nullptr;   // nullptr: not in the system tz database
+#endif
+    // Cached offset and the UTC interval [begin, end) it is valid for
+    int64_t begin = 0;
+    int64_t end = 0;
+    int32_t offset = 0;
+};
+
+TimeZoneTable::TimeZoneTable() = default;
+TimeZoneTable::~TimeZoneTable() = default;
+
+TimeZoneTable& TimeZoneTable::instance() {
+    static TimeZoneTable table;
+    return table;
+}
+
+bool TimeZoneTable::isOffsetZone(uint16_t zoneId) noexcept {
+    return zoneId <= kMaxOffsetZoneId;
+}
+
+const std::string& TimeZoneTable::name(uint16_t zoneId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (isOffsetZone(zoneId)) {
+        auto [it, added] = offsetNames_.try_emplace(zoneId);
+        if (added) {
+            const int32_t minutes = static_cast<int32_t>(zoneId) - kOffsetZoneBias;
+            const int32_t magnitude = minutes < 0 ? -minutes : minutes;
+            char buffer[8];
+            std::snprintf(buffer, sizeof(buffer), "%c%02d:%02d", minutes < 0 ? '-' : '+',
+                          magnitude / 60, magnitude % 60);
+            it->second = buffer;
+        }
+        return it->second;
+    }
+    return region(zoneId).name;
+}
+
+uint16_t TimeZoneTable::zoneId(std::string_view name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string key(name);
+    if (auto it = ids_.find(key); it != ids_.end()) {
+        return it->second;
+    }
+    try {
+        auto& env = Environment::getInstance();
+        Firebird::ThrowStatusWrapper status(env.getMaster()->getStatus());
+        ISC_TIMESTAMP_TZ raw{};
+        env.getUtil()->encodeTimeStampTz(&status, &raw, kProbeYear, 1, 1, 0, 0, 0, 0,
+                                         key.c_str());
+        const auto id = static_cast<uint16_t>(raw.time_zone);
+        ids_.emplace(std::move(key), id);
+        return id;
+    } catch (const Firebird::FbException& e) {
+        throw FirebirdException(e);
+    }
+}
+
+#if !defined(__BORLANDC__)
+const std::chrono::time_zone* TimeZoneTable::timeZone(uint16_t zoneId) {
+    if (isOffsetZone(zoneId)) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return region(zoneId).zone;
+}
+
+uint16_t TimeZoneTable::zoneId(const std::chrono::time_zone* zone) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (auto it = zoneIds_.find(zone); it != zoneIds_.end()) {
+            return it->second;
+        }
+    }
+    const uint16_t id = zoneId(zone->name());
+    std::lock_guard<std::mutex> lock(mutex_);
+    zoneIds_.emplace(zone, id);
+    return id;
+}
+#endif
+
+int32_t TimeZoneTable::offsetMinutes(uint16_t zoneId, int64_t utcMicros) {
+    if (isOffsetZone(zoneId)) {
+        return static_cast<int32_t>(zoneId) - kOffsetZoneBias;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return regionOffset(region(zoneId), zoneId, utcMicros);
+}
+
+void TimeZoneTable::toLocalMicros(const int64_t* utcMicros, const uint16_t* zoneIds,
+                                  std::size_t count, int64_t* out) {
+    std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+    uint16_t lastId = 0;
+    Region* last = nullptr;
+    for (std::size_t i = 0; i < count; ++i) {
+        const uint16_t id = zoneIds[i];
+        int32_t offset = 0;
+        if (isOffsetZone(id)) {
+            offset = static_cast<int32_t>(id) - kOffsetZoneBias;
+        } else {
+            if (!lock.owns_lock()) {
+                lock.lock();   // Once per call, and only if a region zone shows up
+            }
+            if (last == nullptr || lastId != id) {
+                last = &region(id);
+                lastId = id;
+            }
+            offset = regionOffset(*last, id, utcMicros[i]);
+        }
+        out[i] = utcMicros[i] + offset * kMicrosPerMinute;
+    }
+}
+
+TimeZoneTable::Region& TimeZoneTable::region(uint16_t zoneId) {
+    if (auto it = regions_.find(zoneId); it != regions_.end()) {
+        return *it->second;
+    }
+    auto entry = std::make_unique<Region>();
+    try {
+        auto& env = Environment::getInstance();
+        Firebird::ThrowStatusWrapper status(env.getMaster()->getStatus());
+        ISC_TIMESTAMP_TZ raw{};
+        raw.utc_timestamp.timestamp_date =
+            static_cast<ISC_DATE>(timestamp_utils::encode_firebird_date(kProbeYear, 1, 1));
+        raw.time_zone = zoneId;
+        unsigned year, month, day, hours, minutes, seconds, fractions;
+        std::array<char, 128> buffer{};
+        env.getUtil()->decodeTimeStampTz(&status, &raw, &year, &month, &day, &hours, &minutes,
+                                         &seconds, &fractions,
+                                         static_cast<unsigned>(buffer.size()), buffer.data());
+        entry->name = buffer.data();
+    } catch (const Firebird::FbException& e) {
+        throw FirebirdException(e);
+    }
+#if !defined(__BORLANDC__)
+    try {
+        entry->zone = std::chrono::locate_zone(entry->name);
+    } catch (const std::runtime_error&) {
+        entry->zone = nullptr;   // Firebird knows it, the system tz database does not
+    }
+#endif
+    ids_.emplace(entry->name, zoneId);
+    auto& stored = *entry;
+    regions_.emplace(zoneId, std::move(entry));
+    return stored;
+}
+
+int32_t TimeZoneTable::regionOffset(Region& region, uint16_t zoneId, int64_t utcMicros) {
+    if (utcMicros >= region.begin && utcMicros < region.end) {
+        return region.offset;
+    }
+#if !defined(__BORLANDC__)
+    if (region.zone != nullptr) {
+        const std::chrono::sys_time<std::chrono::microseconds> instant{
+            std::chrono::microseconds(utcMicros)};
+        const auto info = region.zone->get_info(instant);
+        region.begin = secondsToMicrosClamped(info.begin);
+        region.end = secondsToMicrosClamped(info.end);
+        region.offset = static_cast<int32_t>(
+            std::chrono::duration_cast<std::chrono::minutes>(info.offset).count());
+        return region.offset;
+    }
+#endif
+    // No tz database: let the client library convert this one value.
+    try {
+        auto& env = Environment::getInstance();
+        Firebird::ThrowStatusWrapper status(env.getMaster()->getStatus());
+        uint32_t dateTime[2];
+        timestamp_utils::unix_micros_to_firebird_timestamps(&utcMicros, 1, dateTime);
+        ISC_TIMESTAMP_TZ raw{};
+        raw.utc_timestamp.timestamp_date = static_cast<ISC_DATE>(dateTime[0]);
+        raw.utc_timestamp.timestamp_time = static_cast<ISC_TIME>(dateTime[1]);
+        raw.time_zone = zoneId;
+        unsigned year, month, day, hours, minutes, seconds, fractions;
+        std::array<char, 128> buffer{};
+        env.getUtil()->decodeTimeStampTz(&status, &raw, &year, &month, &day, &hours, &minutes,
+                                         &seconds, &fractions,
+                                         static_cast<unsigned>(buffer.size()), buffer.data());
+        const uint32_t local[2] = {
+            timestamp_utils::encode_firebird_date(year, month, day),
+            timestamp_utils::encode_firebird_time(hours, minutes, seconds, fractions)};
+        int64_t localMicros = 0;
+        timestamp_utils::firebird_timestamps_to_unix_micros(local, 1, &localMicros);
+        // Both sides are floored to 100 us, so the difference is whole minutes.
+        const int64_t utcFloored = utcMicros - ((utcMicros % 100) + 100) % 100;
+        return static_cast<int32_t>((localMicros - utcFloored) / kMicrosPerMinute);
+    } catch (const Firebird::FbException& e) {
+        throw FirebirdException(e);
+    }
+}
+
+} // namespace core
+} // namespace fbpp
@@ -3,10 +3,14 @@
 #include "fbpp/core/statement.hpp"
 #include "fbpp/core/result_set.hpp"
 #include "fbpp/core/batch.hpp"
+#include "fbpp/core/cancel_scope.hpp"
+#include "fbpp/core/deadline.hpp"
 #include "fbpp/core/exception.hpp"
-#include "fbpp/core/detail/firebird_raii.hpp"
+#include "fbpp/core/span_observer.hpp"
+#include "fbpp/core/statement_metrics.hpp"
 #include "fbpp_util/trace.h"
 #include <cstring>
+#include <optional>
 
 namespace fbpp {
 namespace core {
@@ -15,7 +19,7 @@ Transaction::Transaction(Connection* connection, Firebird::ITransaction* transac
     : env_(Environment::getInstance())
     , connection_(connection)
     , transaction_(transaction)
-    , status_(env_.getMaster()->getStatus())
+    , status_(env_.acquireStatus())
     , statusWrapper_(status_)
     , active_(true) {
     if (!transaction_) {
@@ -43,19 +47,21 @@ Transaction::~Transaction() {
             }
         }
     }
-    statusWrapper_.dispose();
+    env_.releaseStatus(status_);
 }
 
 Transaction::Transaction(Transaction&& other) noexcept
     : env_(Environment::getInstance())
     , connection_(other.connection_)
     , transaction_(other.transaction_)
-    , status_(env_.getMaster()->getStatus())
+    , status_(env_.acquireStatus())
     , statusWrapper_(status_)
-    , active_(other.active_) {
+    , active_(other.active_)
+    , prepared_(other.prepared_) {
     other.connection_ = nullptr;
     other.transaction_ = nullptr;
     other.active_ = false;
+    other.prepared_ = false;
 }
 
 Transaction& Transaction::operator=(Transaction&& other) noexcept {
@@ -78,10 +84,12 @@ Transaction& Transaction::operator=(Transaction&& other) noexcept {
         connection_ = other.connection_;
         transaction_ = other.transaction_;
         active_ = other.active_;
+        prepared_ = other.prepared_;
         
         other.connection_ = nullptr;
         other.transaction_ = nullptr;
         other.active_ = false;
+        other.prepared_ = false;
     }
     return *this;
 }
@@ -93,6 +101,9 @@ void Transaction::Commit() {
         throw FirebirdException("Transaction is not active");
     }
 
+    detail::SpanScope span(SpanKind::Commit);
+    span.start();
+
     try {
         auto& st = status();
 
@@ -103,6 +114,7 @@ void Transaction::Commit() {
         transaction_->release();
         transaction_ = nullptr;
         active_ = false;
+        prepared_ = false;
 
         fbpp::util::trace(fbpp::util::TraceLevel::info, "Transaction",
                     [](auto& oss) { oss << "Transaction committed"; });
@@ -121,6 +133,9 @@ void Transaction::Rollback() {
         throw FirebirdException("Transaction is not active");
     }
 
+    detail::SpanScope span(SpanKind::Rollback);
+    span.start();
+
     try {
         auto& st = status();
 
@@ -129,6 +144,7 @@ void Transaction::Rollback() {
         transaction_->release();
         transaction_ = nullptr;
         active_ = false;
+        prepared_ = false;
 
         fbpp::util::trace(fbpp::util::TraceLevel::info, "Transaction",
                     [](auto& oss) { oss << "Transaction rolled back"; });
@@ -172,6 +188,71 @@ void Transaction::RollbackRetaining() {
     }
 }
 
+void Transaction::Prepare(std::string_view message) {
+    if (!active_ || !transaction_) {
+        throw FirebirdException("Transaction is not active");
+    }
+    if (prepared_) {
+        throw FirebirdException("Transaction is already prepared");
+    }
+
+    try {
+        auto& st = status();
+        transaction_->prepare(&st, static_cast<unsigned>(message.size()),
+                              reinterpret_cast<const unsigned char*>(message.data()));
+        prepared_ = true;
+    }
+    catch (const Firebird::FbException& e) {
+        throw FirebirdException(e);
+    }
+}
+
+void Transaction::Disconnect() {
+    if (!active_ || !transaction_) {
+        throw FirebirdException("Transaction is not active");
+    }
+    if (!prepared_) {
+        throw FirebirdException("Only a prepared transaction can be left in limbo");
+    }
+
+    try {
+        auto& st = status();
+        transaction_->disconnect(&st);
+    }
+    catch (const Firebird::FbException&) {
+        // The handle goes either way; the server keeps the transaction in limbo
+        fbpp::util::trace(fbpp::util::TraceLevel::warn, "Transaction",
+                    [](auto& oss) { oss << "Disconnect of a prepared transaction failed"; });
+    }
+    transaction_->release();
+    transaction_ = nullptr;
+    active_ = false;
+}
+
+uint64_t Transaction::getId() const {
+    if (!transaction_) {
+        throw FirebirdException("Transaction is not active");
+    }
+
+    static const unsigned char items[] = {isc_info_tra_id};
+    unsigned char buffer[32] = {};
+    try {
+        transaction_->getInfo(&status(), sizeof(items), items, sizeof(buffer), buffer);
+    }
+    catch (const Firebird::FbException& e) {
+        throw FirebirdException(e);
+    }
+    if (buffer[0] != isc_info_tra_id) {
+        throw FirebirdException("Transaction id not reported");
+    }
+    const unsigned length = buffer[1] | (buffer[2] << 8);
+    uint64_t id = 0;
+    for (unsigned i = 0; i < length && i < sizeof(id); ++i) {
+        id |= static_cast<uint64_t>(buffer[3 + i]) << (8 * i);
+    }
+    return id;
+}
+
 bool Transaction::isActive() const {
     return active_ && transaction_ != nullptr;
 }
@@ -190,56 +271,66 @@ std::vector<uint8_t> Transaction::loadBlob(ISC_QUAD* blobId) {
         return std::vector<uint8_t>();
     }
 
+    // A large BLOB is many round trips: bounded as a whole by the deadline
+    std::optional<CancelScope> cancel;
+    if (const Deadline* deadline = Deadline::current()) {
+        deadline->check("loadBlob");
+        if (connection_) {
+            cancel.emplace(*connection_, deadline->at());
+        }
+    }
+    auto data = openBlob(*blobId).readAll();
+    detail::BlobMetricsScope::noteBytes(data.size());
+    return data;
+}
+
+BlobReader Transaction::openBlob(const ISC_QUAD& blobId, size_t readSize) {
+    if (!active_ || !transaction_) {
+        throw FirebirdException("Transaction is not active");
+    }
+    if (!connection_) {
+        throw FirebirdException("Transaction has no connection for BLOB access");
+    }
+
     try {
         auto& st = status();
         auto attachment = connection_->getAttachment();
 
-        // Open BLOB for reading. RAII guard ensures close()+release() on any throw path.
-        detail::BlobGuard blob(
-            attachment->openBlob(&st, transaction_, blobId, 0, nullptr),
-            &st);
+        ISC_QUAD id = blobId;
+        Firebird::IBlob* blob = attachment->openBlob(&st, transaction_, &id, 0, nullptr);
         if (!blob) {
             throw FirebirdException("Failed to open BLOB");
         }
-
-        // Read BLOB data in segments
-        std::vector<uint8_t> data;
-        const unsigned segmentSize = 32768; // 32KB segments
-        std::vector<uint8_t> segment(segmentSize);
-
-        while (true) {
-            unsigned actualLength = 0;
-            int result = blob->getSegment(&st, segmentSize, segment.data(), &actualLength);
-
-            if (result == Firebird::IStatus::RESULT_OK ||
-                result == Firebird::IStatus::RESULT_SEGMENT) {
-                // Append segment to data
-                data.insert(data.end(), segment.begin(), segment.begin() + actualLength);
-
-                if (result == Firebird::IStatus::RESULT_OK) {
-                    // Last segment read successfully
-                    break;
-                }
-            } else {
-                // No more data or error
-                break;
-            }
+        if (readSize == 0) {
+            readSize = connection_->transferTuning().blobReadBytes;
         }
-
-        // BlobGuard's destructor will close() and release() on scope exit.
-        return data;
+        // The reader owns the handle from here on, including on throw.
+        return BlobReader(blob, weak_from_this().lock(), readSize);
     }
     catch (const Firebird::FbException& e) {
         fbpp::util::trace(fbpp::util::TraceLevel::error, "Transaction",
-                    [](auto& oss) { oss << "Failed to load BLOB (Firebird exception)"; });
+                    [](auto& oss) { oss << "Failed to open BLOB (Firebird exception)"; });
         throw FirebirdException(e);
     }
 }
 
 ISC_QUAD Transaction::createBlob(const std::vector<uint8_t>& data, int subType) {
+    return createBlob(std::as_bytes(std::span<const uint8_t>(data)), subType);
+}
+
+ISC_QUAD Transaction::createBlob(std::span<const std::byte> data, int subType) {
+    auto writer = createBlobStream(subType, false);
+    writer.write(data);
+    return writer.finish();
+}
+
+BlobWriter Transaction::createBlobStream(int subType, bool streamType, size_t segmentSize) {
     if (!active_ || !transaction_) {
         throw FirebirdException("Transaction is not active");
     }
+    if (!connection_) {
+        throw FirebirdException("Transaction has no connection for BLOB access");
+    }
 
     try {
         auto& st = status();
@@ -248,41 +339,35 @@ ISC_QUAD Transaction::createBlob(const std::vector<uint8_t>& data, int subType)
         ISC_QUAD blobId;
         std::memset(&blobId, 0, sizeof(ISC_QUAD));
 
-        // Build BPB only when caller wants a non-default subType. Layout
-        // (per Firebird docs): version byte, then tag/length/value triplets.
-        // For target_type we use a 2-byte little-endian value, which covers
-        // the full int16_t range Firebird uses for sub-types.
-        unsigned char bpb[5];
+        // Build BPB only when caller wants a non-default subType or a
+        // stream BLOB. Layout (per Firebird docs): version byte, then
+        // tag/length/value triplets. For target_type we use a 2-byte
+        // little-endian value, which covers the full int16_t range
+        // Firebird uses for sub-types.
+        unsigned char bpb[8];
         unsigned bpbLen = 0;
+        if (subType != 0 || streamType) {
+            bpb[bpbLen++] = isc_bpb_version1;
+        }
         if (subType != 0) {
-            bpb[0] = isc_bpb_version1;
-            bpb[1] = isc_bpb_target_type;
-            bpb[2] = 2;
-            bpb[3] = static_cast<unsigned char>(subType & 0xFF);
-            bpb[4] = static_cast<unsigned char>((subType >> 8) & 0xFF);
-            bpbLen = 5;
+            bpb[bpbLen++] = isc_bpb_target_type;
+            bpb[bpbLen++] = 2;
+            bpb[bpbLen++] = static_cast<unsigned char>(subType & 0xFF);
+            bpb[bpbLen++] = static_cast<unsigned char>((subType >> 8) & 0xFF);
+        }
+        if (streamType) {
+            bpb[bpbLen++] = isc_bpb_type;
+            bpb[bpbLen++] = 1;
+            bpb[bpbLen++] = isc_bpb_type_stream;
         }
 
-        // Create new BLOB. RAII guard ensures close()+release() on any throw path.
-        detail::BlobGuard blob(
-            attachment->createBlob(&st, transaction_, &blobId, bpbLen, bpbLen ? bpb : nullptr),
-            &st);
+        Firebird::IBlob* blob =
+            attachment->createBlob(&st, transaction_, &blobId, bpbLen, bpbLen ? bpb : nullptr);
         if (!blob) {
             throw FirebirdException("Failed to create BLOB");
         }
-
-        // Write data in segments
-        const unsigned segmentSize = 32768; // 32KB segments
-        size_t offset = 0;
-
-        while (offset < data.size()) {
-            size_t chunkSize = std::min(static_cast<size_t>(segmentSize), data.size() - offset);
-            blob->putSegment(&st, chunkSize, data.data() + offset);
-            offset += chunkSize;
-        }
-
-        // BlobGuard's destructor will close() and release() on scope exit.
-        return blobId;
+        // The writer owns the handle from here on; it cancels unless finished.
+        return BlobWriter(blob, blobId, weak_from_this().lock(), segmentSize);
     }
     catch (const Firebird::FbException& e) {
         fbpp::util::trace(fbpp::util::TraceLevel::error, "Transaction",
@@ -372,6 +457,102 @@ std::unique_ptr<ResultSet> Transaction::openCursor(const std::shared_ptr<Stateme
     return rs;
 }
 
+std::unique_ptr<ResultSet> Transaction::openCursor(const std::shared_ptr<Statement>& statement,
+                                                   RowLimit limit) {
+    if (!statement) {
+        throw FirebirdException("Invalid statement pointer");
+    }
+
+    // Retains whichever statement the cursor runs on
+    const std::shared_ptr<Statement> limited = statement->limitedTo(limit.rows);
+    auto rs = openCursor(limited ? limited : statement);
+    rs->setRowLimit(limit.rows);
+    return rs;
+}
+
+std::unique_ptr<ResultSet> Transaction::openCursor(const std::shared_ptr<Statement>& statement,
+                                                   const OutputCoercion& coercion) {
+    if (!statement) {
+        throw FirebirdException("Invalid statement pointer");
+    }
+
+    if (!isActive()) {
+        throw FirebirdException("Transaction is not active");
+    }
+
+    auto rs = statement->openCursor(this, coercion);
+    rs->retainStatement(statement);
+    return rs;
+}
+
+std::unique_ptr<ResultSet> Transaction::openCursor(
+    const std::shared_ptr<Statement>& statement,
+    const std::shared_ptr<const MessageMetadata>& outFormat) {
+    if (!statement) {
+        throw FirebirdException("Invalid statement pointer");
+    }
+
+    if (!isActive()) {
+        throw FirebirdException("Transaction is not active");
+    }
+
+    auto rs = statement->openCursor(this, outFormat);
+    rs->retainStatement(statement);
+    return rs;
+}
+
+std::unique_ptr<ResultSet> Transaction::openScrollableCursor(const std::shared_ptr<Statement>& statement) {
+    if (!statement) {
+        throw FirebirdException("Invalid statement pointer");
+    }
+
+    if (!isActive()) {
+        throw FirebirdException("Transaction is not active");
+    }
+
+    auto rs = statement->openCursor(this, static_cast<unsigned>(Statement::CURSOR_TYPE_SCROLLABLE));
+    rs->retainStatement(statement);
+    return rs;
+}
+
+std::unique_ptr<ResultSet> Transaction::openBorrowedCursor(Statement& statement) {
+    if (!isActive()) {
+        throw FirebirdException("Transaction is not active");
+    }
+    return statement.openBorrowedCursor(*this, static_cast<unsigned>(0));
+}
+
+unsigned Transaction::executeMessage(const std::shared_ptr<Statement>& statement,
+                                     Firebird::IMessageMetadata* inMetadata,
+                                     const void* message) {
+    if (!statement) {
+        throw FirebirdException("Invalid statement pointer");
+    }
+
+    if (!isActive()) {
+        throw FirebirdException("Transaction is not active");
+    }
+
+    return statement->execute(this, inMetadata, message);
+}
+
+std::unique_ptr<ResultSet> Transaction::openCursorMessage(const std::shared_ptr<Statement>& statement,
+                                                          Firebird::IMessageMetadata* inMetadata,
+                                                          const void* message,
+                                                          unsigned flags) {
+    if (!statement) {
+        throw FirebirdException("Invalid statement pointer");
+    }
+
+    if (!isActive()) {
+        throw FirebirdException("Transaction is not active");
+    }
+
+    auto rs = statement->openCursor(this, inMetadata, message, nullptr, flags);
+    rs->retainStatement(statement);
+    return rs;
+}
+
 // createBatch for shared_ptr
 std::unique_ptr<Batch> Transaction::createBatch(const std::shared_ptr<Statement>& statement,
                                                bool recordCounts,
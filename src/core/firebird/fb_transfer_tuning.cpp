@@ -0,0 +1,66 @@
+#include "fbpp/core/transfer_tuning.hpp"
+
+#include <algorithm>
+
+namespace fbpp {
+namespace core {
+
+namespace {
+
+constexpr size_t kMinLocalBlobReadBytes = 16 * 1024;
+constexpr size_t kBlobReadPages = 4;
+
+constexpr size_t kMinBatchChunkBytes = 256 * 1024;
+constexpr size_t kBatchChunkPages = 128;
+
+// Rows per remote fetch round trip: a window of about one wire buffer
+// burst, more when zlib shrinks what actually crosses the link
+constexpr size_t kPrefetchWindowBytes = 64 * 1024;
+constexpr size_t kCompressedPrefetchWindowBytes = 128 * 1024;
+constexpr unsigned kMinPrefetchRows = 16;
+constexpr unsigned kMaxPrefetchRows = 1024;
+
+} // namespace
+
+unsigned TransferTuning::prefetchFor(unsigned rowBytes) const noexcept {
+    if (prefetchBytes == 0) {
+        return prefetchRows;
+    }
+    const size_t rows = prefetchBytes / std::max(rowBytes, 1u);
+    return static_cast<unsigned>(std::clamp<size_t>(rows, kMinPrefetchRows, kMaxPrefetchRows));
+}
+
+TransferTuning TransferTuning::choose(const DatabaseInfo& info,
+                                      const TransferOptions& options) noexcept {
+    TransferTuning tuning;
+    if (options.autoTune) {
+        if (info.pageSize != 0 && !info.remote()) {
+            // In-process reads cost a copy, not a packet: a few pages each
+            tuning.blobReadBytes = std::clamp(info.pageSize * kBlobReadPages,
+                                              kMinLocalBlobReadBytes, kDefaultBlobReadBytes);
+        }
+        if (info.pageSize != 0) {
+            tuning.batchChunkBytes = std::clamp(info.pageSize * kBatchChunkPages,
+                                                kMinBatchChunkBytes, kDefaultBatchChunkBytes);
+        }
+        if (info.remote()) {
+            tuning.prefetchBytes = info.compressed ? kCompressedPrefetchWindowBytes
+                                                   : kPrefetchWindowBytes;
+        }
+    }
+
+    if (options.blobReadBytes != 0) {
+        tuning.blobReadBytes = options.blobReadBytes;
+    }
+    if (options.batchChunkBytes != 0) {
+        tuning.batchChunkBytes = options.batchChunkBytes;
+    }
+    if (options.prefetchRows != 0) {
+        tuning.prefetchBytes = 0;
+        tuning.prefetchRows = options.prefetchRows;
+    }
+    return tuning;
+}
+
+} // namespace core
+} // namespace fbpp
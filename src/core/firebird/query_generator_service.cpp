@@ -1,12 +1,27 @@
 #include "fbpp/query_generator_service.hpp"
 
+#include "fbpp/core/column_batch.hpp"
 #include "fbpp/core/firebird_compat.hpp"
+#include "fbpp/core/output_coercion.hpp"
+#include "fbpp/core/statement_cache.hpp"
+#include "fbpp/schema/metadata_cache.hpp"
 #include "fbpp/schema/type_mapper.hpp"
 #include "fbpp/schema/query_analyzer.hpp"
+#include "fbpp_util/trace.h"
+
+#include <nlohmann/json.hpp>
 
 #include <algorithm>
+#include <atomic>
+#include <cctype>
 #include <cstdint>
+#include <exception>
+#include <filesystem>
 #include <format>
+#include <fstream>
+#include <future>
+#include <map>
+#include <optional>
 #include <set>
 #include <sstream>
 #include <stdexcept>
@@ -48,6 +63,180 @@ std::string escapeBracesForFormat(std::string_view text) {
     return result;
 }
 
+using nlohmann::json;
+
+constexpr int kCacheFileVersion = 2;
+
+// ---- Spec cache JSON mapping ---------------------------------------------
+
+json toJson(const FieldInfo& f) {
+    return {{"name", f.name}, {"relation", f.relation}, {"owner", f.owner}, {"alias", f.alias},
+            {"type", f.type}, {"nullable", f.nullable}, {"subType", f.subType},
+            {"length", f.length}, {"scale", f.scale}, {"charSet", f.charSet},
+            {"offset", f.offset}, {"nullOffset", f.nullOffset}};
+}
+
+FieldInfo fieldFromJson(const json& j) {
+    FieldInfo f;
+    f.name       = j.at("name").get<std::string>();
+    f.relation   = j.at("relation").get<std::string>();
+    f.owner      = j.at("owner").get<std::string>();
+    f.alias      = j.at("alias").get<std::string>();
+    f.type       = j.at("type").get<unsigned>();
+    f.nullable   = j.at("nullable").get<bool>();
+    f.subType    = j.at("subType").get<unsigned>();
+    f.length     = j.at("length").get<unsigned>();
+    f.scale      = j.at("scale").get<int>();
+    f.charSet    = j.at("charSet").get<unsigned>();
+    f.offset     = j.at("offset").get<unsigned>();
+    f.nullOffset = j.at("nullOffset").get<unsigned>();
+    return f;
+}
+
+json toJson(const TypeMapping& t) {
+    json out = {{"cppType", t.cppType}, {"optional", t.needsOptional}, {"string", t.needsString},
+                {"extended", t.needsExtendedTypes}, {"ttmath", t.needsTTMath},
+                {"chrono", t.needsChrono}, {"cppdecimal", t.needsCppDecimal}};
+    if (t.scaledInfo) {
+        out["scaled"] = {t.scaledInfo->intWords, t.scaledInfo->scale};
+    }
+    return out;
+}
+
+TypeMapping typeFromJson(const json& j) {
+    TypeMapping t;
+    t.cppType            = j.at("cppType").get<std::string>();
+    t.needsOptional      = j.at("optional").get<bool>();
+    t.needsString        = j.at("string").get<bool>();
+    t.needsExtendedTypes = j.at("extended").get<bool>();
+    t.needsTTMath        = j.at("ttmath").get<bool>();
+    t.needsChrono        = j.at("chrono").get<bool>();
+    t.needsCppDecimal    = j.at("cppdecimal").get<bool>();
+    if (j.contains("scaled")) {
+        const auto& scaled = j.at("scaled");
+        t.scaledInfo = TypeMapping::ScaledNumericInfo{scaled.at(0).get<int>(),
+                                                      scaled.at(1).get<std::int16_t>()};
+    }
+    return t;
+}
+
+json toJson(const std::vector<FieldSpec>& fields) {
+    json out = json::array();
+    for (const auto& f : fields) {
+        out.push_back({{"sqlName", f.sqlName}, {"memberName", f.memberName},
+                       {"type", toJson(f.type)}, {"info", toJson(f.info)}});
+    }
+    return out;
+}
+
+std::vector<FieldSpec> fieldSpecsFromJson(const json& j) {
+    std::vector<FieldSpec> fields;
+    for (const auto& item : j) {
+        FieldSpec f;
+        f.sqlName    = item.at("sqlName").get<std::string>();
+        f.memberName = item.at("memberName").get<std::string>();
+        f.type       = typeFromJson(item.at("type"));
+        f.info       = fieldFromJson(item.at("info"));
+        fields.push_back(std::move(f));
+    }
+    return fields;
+}
+
+// Everything but the name, which comes from the definition on a hit
+json toJson(const QuerySpec& spec, std::uint64_t configHash) {
+    json scans = json::array();
+    for (const auto& scan : spec.naturalScans) {
+        scans.push_back({{"table", scan.table}, {"large", scan.large},
+                         {"rows", scan.estimatedRows ? json(*scan.estimatedRows) : json(nullptr)}});
+    }
+    return {{"sql", spec.originalSql}, {"config", configHash},
+            {"positionalSql", spec.positionalSql}, {"named", spec.hasNamedParameters},
+            {"kind", static_cast<int>(spec.kind)},
+            {"in", toJson(spec.inputs)}, {"out", toJson(spec.outputs)},
+            {"plan", spec.plan}, {"scans", std::move(scans)},
+            {"coercion", spec.outputCoercion}};
+}
+
+QuerySpec specFromJson(const json& j) {
+    QuerySpec spec;
+    spec.originalSql        = j.at("sql").get<std::string>();
+    spec.positionalSql      = j.at("positionalSql").get<std::string>();
+    spec.hasNamedParameters = j.at("named").get<bool>();
+    spec.kind               = static_cast<fbpp::schema::QueryKind>(j.at("kind").get<int>());
+    spec.inputs             = fieldSpecsFromJson(j.at("in"));
+    spec.outputs            = fieldSpecsFromJson(j.at("out"));
+    spec.plan               = j.at("plan").get<std::string>();
+    spec.outputCoercion     = j.value("coercion", std::string{});
+    for (const auto& item : j.at("scans")) {
+        fbpp::schema::PlanScan scan;
+        scan.table = item.at("table").get<std::string>();
+        scan.large = item.at("large").get<bool>();
+        if (!item.at("rows").is_null()) {
+            scan.estimatedRows = item.at("rows").get<std::uint64_t>();
+        }
+        spec.naturalScans.push_back(std::move(scan));
+    }
+    return spec;
+}
+
+std::string_view queryModeFor(fbpp::schema::QueryKind kind, bool hasOutput);
+
+QuerySpec analyzeDefinition(const fbpp::schema::QueryAnalyzer& analyzer,
+                            const QueryDefinition& definition,
+                            const AdapterConfig& config) {
+    QuerySpec spec;
+    spec.name = definition.name;
+    spec.originalSql = definition.sql;
+
+    fbpp::schema::QueryAnalysisOptions options;
+    options.capturePlan = true;   // Same prepare; lets callers diff plans
+    auto analysis = analyzer.analyze(definition.sql, options);
+    spec.positionalSql = analysis.positionalSql;
+    spec.hasNamedParameters = analysis.hasNamedParameters;
+    spec.kind = analysis.kind;
+    spec.plan = std::move(analysis.plan);
+    spec.naturalScans = std::move(analysis.naturalScans);
+
+    spec.inputs.reserve(analysis.inputParams.size());
+    for (const auto& p : analysis.inputParams) {
+        FieldSpec fs;
+        fs.info = p.field;
+        fs.sqlName = p.sqlName;
+        fs.memberName = p.memberName;
+        fs.type = fbpp::schema::TypeMapper::mapField(p.field, false, config);
+        spec.inputs.push_back(std::move(fs));
+    }
+
+    // Cursor rows can arrive converted (OutputCoercion); the Out struct then
+    // describes the coerced format, which the descriptor names as well
+    std::vector<FieldInfo> outputInfos;
+    outputInfos.reserve(analysis.outputFields.size());
+    for (const auto& f : analysis.outputFields) {
+        outputInfos.push_back(f.field);
+    }
+    if (!config.outputCoercion.empty() &&
+        queryModeFor(spec.kind, !outputInfos.empty()) == "Select") {
+        const auto coercion = OutputCoercion::parse(config.outputCoercion);
+        if (auto coerced = coerceOutput(outputInfos, coercion)) {
+            outputInfos = coerced->getFields();
+            spec.outputCoercion = coercion.toString();
+        }
+    }
+
+    spec.outputs.reserve(analysis.outputFields.size());
+    for (std::size_t i = 0; i < analysis.outputFields.size(); ++i) {
+        const auto& f = analysis.outputFields[i];
+        FieldSpec fs;
+        fs.info = outputInfos[i];
+        fs.sqlName = f.sqlName;
+        fs.memberName = f.memberName;
+        fs.type = fbpp::schema::TypeMapper::mapField(fs.info, true, config);
+        spec.outputs.push_back(std::move(fs));
+    }
+
+    return spec;
+}
+
 std::string makeStructName(const std::string& queryName, bool isInput) {
     return queryName + (isInput ? "In" : "Out");
 }
@@ -79,6 +268,230 @@ std::string_view queryModeFor(fbpp::schema::QueryKind kind, bool hasOutput) {
     }
 }
 
+std::string makeColumnsName(const std::string& queryName) {
+    return queryName + "Columns";
+}
+
+// Physical column types of a Select query's rows, as fetchColumns() decodes
+// them; nullopt when the query gets no columnar result (not a Select, no
+// output, or a column without a columnar mapping such as ARRAY)
+std::optional<std::vector<ColumnType>> columnarTypes(const QuerySpec& q) {
+    if (q.outputs.empty() || queryModeFor(q.kind, true) != "Select") {
+        return std::nullopt;
+    }
+    std::vector<ColumnType> types;
+    for (const auto& f : q.outputs) {
+        ColumnPlan plan{};
+        plan.type = f.info.type;
+        plan.subType = f.info.subType;
+        plan.length = f.info.length;
+        plan.scale = f.info.scale;
+        plan.charSet = f.info.charSet;
+        plan.nullable = f.info.nullable;
+        plan.field = &f.info;
+        try {
+            types.push_back(columnTypeFor(plan));
+        } catch (const FirebirdException&) {
+            return std::nullopt;
+        }
+    }
+    return types;
+}
+
+const char* columnTypeName(ColumnType type) {
+    switch (type) {
+        case ColumnType::Boolean:   return "Boolean";
+        case ColumnType::Int16:     return "Int16";
+        case ColumnType::Int32:     return "Int32";
+        case ColumnType::Int64:     return "Int64";
+        case ColumnType::Int128:    return "Int128";
+        case ColumnType::Float:     return "Float";
+        case ColumnType::Double:    return "Double";
+        case ColumnType::Date:      return "Date";
+        case ColumnType::Time:      return "Time";
+        case ColumnType::Timestamp: return "Timestamp";
+        case ColumnType::String:    return "String";
+        case ColumnType::Binary:    return "Binary";
+    }
+    return "Binary";
+}
+
+// ColumnArray element type; see column_batch.hpp for the units
+const char* columnElementType(ColumnType type) {
+    switch (type) {
+        case ColumnType::Boolean:   return "std::uint8_t";
+        case ColumnType::Int16:     return "std::int16_t";
+        case ColumnType::Int32:     return "std::int32_t";
+        case ColumnType::Int64:     return "std::int64_t";
+        case ColumnType::Int128:    return "std::array<std::uint8_t, 16>";
+        case ColumnType::Float:     return "float";
+        case ColumnType::Double:    return "double";
+        case ColumnType::Date:      return "std::int32_t";
+        case ColumnType::Time:
+        case ColumnType::Timestamp: return "std::int64_t";
+        case ColumnType::String:
+        case ColumnType::Binary:    return "std::string";
+    }
+    return "std::string";
+}
+
+// Columnar result of `q`: one ColumnArray per output column and append()
+void writeColumnsStruct(std::ostringstream& out, const QuerySpec& q,
+                        const std::vector<ColumnType>& types) {
+    out << std::format("struct {} {{\n", makeColumnsName(q.name));
+    out << std::format("    static constexpr std::array<fbpp::core::ColumnType, {}> columnTypes = {{\n",
+                       types.size());
+    for (std::size_t i = 0; i < types.size(); ++i) {
+        out << std::format("        fbpp::core::ColumnType::{}{}\n", columnTypeName(types[i]),
+                           i + 1 != types.size() ? "," : "");
+    }
+    out << "    };\n\n";
+    out << "    std::size_t rowCount = 0;\n";
+
+    static const std::set<std::string> reserved = {"columnTypes", "rowCount", "append", "clear"};
+    std::vector<std::string> members;
+    for (std::size_t i = 0; i < types.size(); ++i) {
+        const auto& f = q.outputs[i];
+        std::string member = f.memberName + (reserved.count(f.memberName) ? "_" : "");
+        out << std::format("    fbpp::core::ColumnArray<{}> {};\n", columnElementType(types[i]),
+                           member);
+        const bool scaled = types[i] == ColumnType::Int16 || types[i] == ColumnType::Int32 ||
+                            types[i] == ColumnType::Int64 || types[i] == ColumnType::Int128;
+        if (scaled && f.info.scale != 0) {
+            out << std::format("    static constexpr int {}Scale = {};   // Values are unscaled\n",
+                               member, f.info.scale);
+        }
+        members.push_back(std::move(member));
+    }
+
+    out << "\n    void append(const fbpp::core::ColumnBatch& batch) {\n";
+    out << std::format("        fbpp::core::checkColumnTypes(batch, columnTypes, \"{}\");\n",
+                       escapeBracesForFormat(q.name));
+    for (std::size_t i = 0; i < members.size(); ++i) {
+        out << std::format("        {}.append(batch.columns[{}]);\n", members[i], i);
+    }
+    out << "        rowCount += batch.rowCount;\n";
+    out << "    }\n\n";
+    out << "    void clear() noexcept {\n";
+    for (const auto& member : members) {
+        out << std::format("        {}.clear();\n", member);
+    }
+    out << "        rowCount = 0;\n";
+    out << "    }\n";
+    out << "};\n\n";
+}
+
+std::string makeEnumName(const std::string& queryName, bool isInput) {
+    return queryName + (isInput ? "Param" : "Col");
+}
+
+// Enumerator for a column / parameter: the SQL name in UPPERCASE, other
+// characters as '_', numbered on a repeat (two ID columns: ID, ID_2)
+std::string makeEnumerator(const std::string& sqlName, std::string_view fallback,
+                           std::set<std::string>& used) {
+    std::string base;
+    for (char c : sqlName) {
+        const auto u = static_cast<unsigned char>(c);
+        base += std::isalnum(u) ? static_cast<char>(std::toupper(u)) : '_';
+    }
+    if (base.empty() || std::isdigit(static_cast<unsigned char>(base.front()))) {
+        base = std::string(fallback) + base;
+    }
+    std::string name = base;
+    for (int n = 2; !used.insert(name).second; ++n) {
+        name = base + "_" + std::to_string(n);
+    }
+    return name;
+}
+
+// A Col / Param enumerator: its positions in the message (one for a column;
+// every '?' a repeated named parameter expands to)
+struct FieldEnumerator {
+    std::string name;
+    std::vector<std::size_t> positions;
+};
+
+std::vector<FieldEnumerator> fieldEnumerators(const QuerySpec& q, bool isInput) {
+    const auto& fields = isInput ? q.inputs : q.outputs;
+    std::vector<FieldEnumerator> result;
+    std::set<std::string> used;
+    std::map<std::string, std::size_t> named;   // sqlName -> result index
+    for (std::size_t i = 0; i < fields.size(); ++i) {
+        if (isInput && q.hasNamedParameters) {
+            const auto [it, added] = named.emplace(fields[i].sqlName, result.size());
+            if (!added) {
+                result[it->second].positions.push_back(i);
+                continue;
+            }
+        }
+        const std::string_view fallback = isInput ? "PARAM_" : "COL_";
+        result.push_back({makeEnumerator(fields[i].sqlName, fallback, used), {i}});
+    }
+    return result;
+}
+
+// enum class <Q>Col / <Q>Param, for fbpp::core::get<Col::X>() / set<Param::X>()
+void writeFieldEnum(std::ostringstream& out, const QuerySpec& q, bool isInput) {
+    const auto enumerators = fieldEnumerators(q, isInput);
+    if (enumerators.empty()) {
+        return;
+    }
+    out << std::format("enum class {} : unsigned {{\n", makeEnumName(q.name, isInput));
+    for (std::size_t i = 0; i < enumerators.size(); ++i) {
+        out << std::format("    {}{}\n", enumerators[i].name,
+                           i + 1 != enumerators.size() ? "," : "");
+    }
+    out << "};\n\n";
+}
+
+// Value type of a column read (get<Col::X>() wraps it in std::optional itself)
+std::string columnValueType(const FieldSpec& f) {
+    const std::string& type = f.type.cppType;
+    constexpr std::string_view optional = "std::optional<";
+    if (f.type.needsOptional && type.starts_with(optional) && type.ends_with('>')) {
+        return type.substr(optional.size(), type.size() - optional.size() - 1);
+    }
+    return type;
+}
+
+// QueryFields<Enum> and one QueryField<Id> per enumerator (query_fields.hpp)
+void writeFieldSpecs(std::ostringstream& out, const QuerySpec& q, bool isInput) {
+    const auto& fields = isInput ? q.inputs : q.outputs;
+    const auto enumerators = fieldEnumerators(q, isInput);
+    if (enumerators.empty()) {
+        return;
+    }
+    const std::string enumName = "generated::queries::" + makeEnumName(q.name, isInput);
+    out << std::format("template<>\nstruct QueryFields<{}> {{\n", enumName);
+    out << std::format("    static constexpr std::array<QueryFieldInfo, {}> fields = {{{{\n",
+                       fields.size());
+    for (std::size_t i = 0; i < fields.size(); ++i) {
+        out << std::format("        {{\"{}\", {}, {}}}{}\n",
+                           escapeString(fields[i].sqlName), fields[i].info.type & ~1u,
+                           fields[i].info.scale, i + 1 != fields.size() ? "," : "");
+    }
+    out << "    }};\n";
+    out << "};\n\n";
+
+    for (const auto& e : enumerators) {
+        const auto& f = fields[e.positions.front()];
+        out << std::format("template<>\nstruct QueryField<{}::{}> {{\n", enumName, e.name);
+        if (isInput) {
+            std::string positions;
+            for (std::size_t pos : e.positions) {
+                positions += (positions.empty() ? "" : ", ") + std::to_string(pos);
+            }
+            out << std::format("    using type = {};\n", f.type.cppType);
+            out << std::format("    static constexpr std::array<std::size_t, {}> positions = {{{}}};\n",
+                               e.positions.size(), positions);
+        } else {
+            out << std::format("    using type = {};\n", columnValueType(f));
+            out << std::format("    static constexpr unsigned index = {};\n", e.positions.front());
+        }
+        out << "};\n\n";
+    }
+}
+
 std::string renderMainHeader(const std::vector<QuerySpec>& queries,
                              std::string_view supportHeaderName,
                              const AdapterConfig& config) {
@@ -119,9 +532,17 @@ std::string renderMainHeader(const std::vector<QuerySpec>& queries,
         }
     }
 
+    const bool needsColumnar = std::any_of(queries.begin(), queries.end(), [](const QuerySpec& q) {
+        return columnarTypes(q).has_value();
+    });
+
     std::ostringstream out;
 
     out << "#pragma once\n\n";
+    if (needsColumnar) {
+        out << "#include <array>\n";
+        out << "#include <cstddef>\n";
+    }
     out << "#include <cstdint>\n";
     out << "#include <string>\n";
     out << "#include <string_view>\n";
@@ -193,8 +614,13 @@ std::string renderMainHeader(const std::vector<QuerySpec>& queries,
             out << "};\n\n";
         };
 
+        writeFieldEnum(out, q, true);
+        writeFieldEnum(out, q, false);
         writeStruct(true);
         writeStruct(false);
+        if (const auto types = columnarTypes(q)) {
+            writeColumnsStruct(out, q, *types);
+        }
     }
 
     for (const auto& q : queries) {
@@ -207,10 +633,23 @@ std::string renderMainHeader(const std::vector<QuerySpec>& queries,
         out << std::format("    static constexpr std::string_view sql = \"{}\";\n", escapedOriginal);
         out << std::format("    static constexpr std::string_view positionalSql = \"{}\";\n", escapedPrepared);
         out << std::format("    static constexpr bool hasNamedParameters = {};\n", q.hasNamedParameters ? "true" : "false");
+        if (!q.outputCoercion.empty()) {
+            out << std::format("    static constexpr std::string_view outputCoercion = \"{}\";\n",
+                               escapeString(q.outputCoercion));
+        }
         out << std::format("    static constexpr fbpp::core::QueryMode mode = fbpp::core::QueryMode::{};\n",
                            queryModeFor(q.kind, !q.outputs.empty()));
         out << "    using Input = " << makeStructName(q.name, true) << ";\n";
         out << "    using Output = " << makeStructName(q.name, false) << ";\n";
+        if (!q.inputs.empty()) {
+            out << "    using Param = " << makeEnumName(q.name, true) << ";\n";
+        }
+        if (!q.outputs.empty()) {
+            out << "    using Col = " << makeEnumName(q.name, false) << ";\n";
+        }
+        if (columnarTypes(q)) {
+            out << "    using Columns = " << makeColumnsName(q.name) << ";\n";
+        }
         out << "};\n\n";
     }
 
@@ -223,8 +662,13 @@ std::string renderMainHeader(const std::vector<QuerySpec>& queries,
 std::string renderSupportHeader(const std::vector<QuerySpec>& queries) {
     std::ostringstream out;
     out << "#pragma once\n\n";
+    out << "#include <array>\n";
+    out << "#include <cstdint>\n";
+    out << "#include <span>\n";
     out << "#include <tuple>\n";
     out << "#include <utility>\n";
+    out << "#include \"fbpp/core/query_executor.hpp\"\n";
+    out << "#include \"fbpp/core/query_fields.hpp\"\n";
     out << "#include \"fbpp/core/struct_pack.hpp\"\n";
     out << "#include \"fbpp/core/firebird_compat.hpp\"\n";
 
@@ -235,6 +679,8 @@ std::string renderSupportHeader(const std::vector<QuerySpec>& queries) {
             const auto& fields = isInput ? q.inputs : q.outputs;
             std::string structName = "generated::queries::" + makeStructName(q.name, isInput);
             out << "template<>\nstruct StructDescriptor<" << structName << "> {\n";
+            // Types and scales come from the prepared statement itself
+            out << "    static constexpr bool pinned_decode = true;\n";
             if (fields.empty()) {
                 out << "    static constexpr auto fields = std::make_tuple();\n";
             } else {
@@ -258,61 +704,288 @@ std::string renderSupportHeader(const std::vector<QuerySpec>& queries) {
                     }
                 }
                 out << "    );\n";
+
+                // The described layout, checked once against the live one
+                std::vector<FieldInfo> infos;
+                std::string offsets;
+                std::string nullOffsets;
+                for (const auto& f : fields) {
+                    infos.push_back(f.info);
+                    offsets += (offsets.empty() ? "" : ", ") + std::to_string(f.info.offset);
+                    nullOffsets += (nullOffsets.empty() ? "" : ", ") + std::to_string(f.info.nullOffset);
+                }
+                out << std::format("    static constexpr std::uint64_t layout_hash = 0x{:016x}ull;\n",
+                                   messageLayoutHash(infos));
+                out << std::format("    static constexpr std::array<unsigned, {}> offsets = {{{}}};\n",
+                                   fields.size(), offsets);
+                out << std::format("    static constexpr std::array<unsigned, {}> null_offsets = {{{}}};\n",
+                                   fields.size(), nullOffsets);
             }
             out << "};\n\n";
         };
 
         writeDescriptor(true);
         writeDescriptor(false);
+        writeFieldSpecs(out, q, true);
+        writeFieldSpecs(out, q, false);
     }
 
     out << "} // namespace fbpp::core\n";
 
+    // Bulk helpers, overloaded on the query's Input struct: executeMany()
+    // for plain DML (one IBatch round trip), stream() for SELECTs (lazy
+    // rows through a prefetching cursor)
+    std::ostringstream helpers;
+    for (const auto& q : queries) {
+        const auto mode = queryModeFor(q.kind, !q.outputs.empty());
+        const auto descriptor = std::format("QueryDescriptor<QueryId::{}>", q.name);
+        const auto input = makeStructName(q.name, true);
+        if (mode == "Modify" && !q.inputs.empty()) {
+            helpers << std::format(
+                "inline fbpp::core::BatchResult executeMany(\n"
+                "        fbpp::core::Connection& connection,\n"
+                "        fbpp::core::Transaction& transaction,\n"
+                "        std::span<const {}> rows,\n"
+                "        const fbpp::core::BatchOptions& options = {{}}) {{\n"
+                "    return fbpp::core::executeBatch<{}>(connection, transaction, rows, options);\n"
+                "}}\n\n",
+                input, descriptor);
+        } else if (mode == "Select") {
+            helpers << std::format(
+                "inline fbpp::core::QueryStream<{}> stream(\n"
+                "        fbpp::core::Connection& connection,\n"
+                "        fbpp::core::Transaction& transaction,\n"
+                "        const {}& params,\n"
+                "        unsigned prefetch = fbpp::core::kDefaultStreamPrefetch,\n"
+                "        fbpp::core::RowLimit limit = {{}}) {{\n"
+                "    return fbpp::core::streamQuery<{}>(connection, transaction, params, prefetch,\n"
+                "                                       limit);\n"
+                "}}\n\n",
+                makeStructName(q.name, false), input, descriptor);
+            if (columnarTypes(q)) {
+                helpers << std::format(
+                    "inline {} fetchColumns(\n"
+                    "        fbpp::core::Connection& connection,\n"
+                    "        fbpp::core::Transaction& transaction,\n"
+                    "        const {}& params,\n"
+                    "        std::size_t batchRows = fbpp::core::kDefaultColumnarBatch) {{\n"
+                    "    return fbpp::core::fetchColumnar<{}>(connection, transaction, params, batchRows);\n"
+                    "}}\n\n",
+                    makeColumnsName(q.name), input, descriptor);
+            }
+        }
+    }
+    if (helpers.tellp() > 0) {
+        out << "\nnamespace generated::queries {\n\n";
+        out << helpers.str();
+        out << "} // namespace generated::queries\n";
+    }
+
     return out.str();
 }
 
 } // namespace
 
+// ---- QuerySpecCache ------------------------------------------------------
+
+QuerySpecCache::QuerySpecCache(std::string path, std::string fingerprint)
+    : path_(std::move(path)), fingerprint_(std::move(fingerprint)) {
+    std::error_code ec;
+    if (!std::filesystem::exists(path_, ec)) {
+        dirty_ = true;   // First run: nothing saved yet
+        return;
+    }
+
+    try {
+        std::ifstream in(path_, std::ios::binary);
+        const auto doc = json::parse(in);
+        if (doc.at("version").get<int>() != kCacheFileVersion ||
+            doc.at("fingerprint").get<std::string>() != fingerprint_) {
+            fbpp::util::trace(fbpp::util::TraceLevel::info, "QuerySpecCache",
+                        [&](auto& oss) { oss << "Schema changed since " << path_ << " was written"; });
+            dirty_ = true;
+            return;
+        }
+        for (const auto& item : doc.at("specs")) {
+            auto spec = specFromJson(item);
+            std::pair<std::uint64_t, std::string> key{item.at("config").get<std::uint64_t>(),
+                                                      spec.originalSql};
+            entries_.emplace(std::move(key), Entry{std::move(spec)});
+        }
+        stats_.warm = true;
+    } catch (const std::exception& e) {
+        // A damaged cache only costs a cold run
+        fbpp::util::trace(fbpp::util::TraceLevel::warn, "QuerySpecCache",
+                    [&](auto& oss) { oss << "Ignoring query spec cache " << path_ << ": " << e.what(); });
+        entries_.clear();
+        dirty_ = true;
+    }
+}
+
+bool QuerySpecCache::contains(const QueryDefinition& definition, const AdapterConfig& config) const {
+    return entries_.count({configHash(config), definition.sql}) != 0;
+}
+
+std::optional<QuerySpec> QuerySpecCache::find(const QueryDefinition& definition,
+                                              const AdapterConfig& config) {
+    const auto it = entries_.find({configHash(config), definition.sql});
+    if (it == entries_.end()) {
+        ++stats_.misses;
+        return std::nullopt;
+    }
+    ++stats_.hits;
+    it->second.used = true;
+    QuerySpec spec = it->second.spec;
+    spec.name = definition.name;
+    return spec;
+}
+
+void QuerySpecCache::store(const QuerySpec& spec, const AdapterConfig& config) {
+    auto& entry = entries_[{configHash(config), spec.originalSql}];
+    entry.spec = spec;
+    entry.spec.name.clear();
+    entry.used = true;
+    dirty_ = true;
+}
+
+bool QuerySpecCache::save() {
+    const bool unused = std::any_of(entries_.begin(), entries_.end(),
+                                    [](const auto& item) { return !item.second.used; });
+    if (!dirty_ && !unused) {
+        return false;
+    }
+
+    json specs = json::array();
+    for (const auto& [key, entry] : entries_) {
+        if (entry.used) {
+            specs.push_back(toJson(entry.spec, key.first));
+        }
+    }
+    const json doc = {{"version", kCacheFileVersion},
+                      {"fingerprint", fingerprint_},
+                      {"specs", std::move(specs)}};
+
+    // Readers of `path` see the old file or the new one, never a torn write
+    const std::string temp = path_ + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Cannot open query spec cache file for writing: " + temp);
+        }
+        out << doc.dump() << '\n';
+        if (!out) {
+            throw std::runtime_error("Failed to write query spec cache file: " + temp);
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp, path_, ec);
+    if (ec) {
+        std::filesystem::remove(temp, ec);
+        throw std::runtime_error("Failed to replace query spec cache file: " + path_);
+    }
+    std::erase_if(entries_, [](const auto& item) { return !item.second.used; });
+    dirty_ = false;
+    return true;
+}
+
+std::string QuerySpecCache::fingerprintOf(Connection& connection) {
+    return connection.getTemplateScope() + "|" +
+           fbpp::schema::MetadataCache::schemaFingerprint(connection);
+}
+
+std::uint64_t QuerySpecCache::configHash(const AdapterConfig& config) noexcept {
+    // One bit per flag; a new flag takes the next bit
+    return (config.useTTMathNumeric      ? 1u  : 0u) |
+           (config.useTTMathInt128       ? 2u  : 0u) |
+           (config.useChronoDatetime     ? 4u  : 0u) |
+           (config.useCppDecimalDecFloat ? 8u  : 0u) |
+           (config.useStringForTextBlob  ? 16u : 0u) |
+           (config.generateAliases       ? 32u : 0u) |
+           (std::uint64_t{config.inlineStringBytes} << 8) ^
+           (config.outputCoercion.empty()
+                ? 0
+                : SqlKey::hashOf(config.outputCoercion, 0) << 40);
+}
+
+// ---- QueryGeneratorService -----------------------------------------------
+
 QueryGeneratorService::QueryGeneratorService(Connection& connection)
     : connection_(connection) {}
 
 std::vector<QuerySpec> QueryGeneratorService::buildQuerySpecs(const std::vector<QueryDefinition>& definitions,
-                                                              const AdapterConfig& config) const {
-    std::vector<QuerySpec> querySpecs;
-    querySpecs.reserve(definitions.size());
+                                                              const AdapterConfig& config,
+                                                              QuerySpecCache* cache) const {
+    return buildQuerySpecs(std::vector<Connection*>{&connection_}, definitions, config, cache);
+}
 
-    for (const auto& definition : definitions) {
-        QuerySpec spec;
-        spec.name = definition.name;
-        spec.originalSql = definition.sql;
+std::vector<QuerySpec> QueryGeneratorService::buildQuerySpecs(const std::vector<Connection*>& connections,
+                                                              const std::vector<QueryDefinition>& definitions,
+                                                              const AdapterConfig& config,
+                                                              QuerySpecCache* cache) {
+    if (connections.empty() ||
+        std::find(connections.begin(), connections.end(), nullptr) != connections.end()) {
+        throw std::invalid_argument("QueryGeneratorService::buildQuerySpecs: null or no connections");
+    }
 
-        fbpp::schema::QueryAnalyzer analyzer(connection_);
-        auto analysis = analyzer.analyze(definition.sql);
-        spec.positionalSql = analysis.positionalSql;
-        spec.hasNamedParameters = analysis.hasNamedParameters;
-        spec.kind = analysis.kind;
+    std::vector<QuerySpec> querySpecs(definitions.size());
+    std::vector<std::size_t> pending;
+    for (std::size_t i = 0; i < definitions.size(); ++i) {
+        auto cached = cache ? cache->find(definitions[i], config) : std::nullopt;
+        if (cached) {
+            querySpecs[i] = std::move(*cached);
+        } else {
+            pending.push_back(i);
+        }
+    }
 
-        spec.inputs.reserve(analysis.inputParams.size());
-        for (const auto& p : analysis.inputParams) {
-            FieldSpec fs;
-            fs.info = p.field;
-            fs.sqlName = p.sqlName;
-            fs.memberName = p.memberName;
-            fs.type = fbpp::schema::TypeMapper::mapField(p.field, false, config);
-            spec.inputs.push_back(std::move(fs));
+    // Prepare times vary a lot per statement, so workers pull the next
+    // pending definition rather than take fixed slices
+    std::atomic<std::size_t> next{0};
+    std::atomic<bool> failed{false};
+    auto work = [&](Connection* connection) {
+        fbpp::schema::QueryAnalyzer analyzer(*connection);
+        for (std::size_t n = next++; n < pending.size() && !failed.load(); n = next++) {
+            try {
+                const auto index = pending[n];
+                querySpecs[index] = analyzeDefinition(analyzer, definitions[index], config);
+            } catch (...) {
+                failed = true;
+                throw;
+            }
         }
+    };
 
-        spec.outputs.reserve(analysis.outputFields.size());
-        for (const auto& f : analysis.outputFields) {
-            FieldSpec fs;
-            fs.info = f.field;
-            fs.sqlName = f.sqlName;
-            fs.memberName = f.memberName;
-            fs.type = fbpp::schema::TypeMapper::mapField(f.field, true, config);
-            spec.outputs.push_back(std::move(fs));
+    const std::size_t parts = std::min(connections.size(), pending.size());
+    std::vector<std::future<void>> workers;
+    if (parts > 1) {
+        workers.reserve(parts - 1);
+        for (std::size_t i = 1; i < parts; ++i) {
+            workers.push_back(std::async(std::launch::async, work, connections[i]));
         }
+    }
+    std::exception_ptr failure;
+    try {
+        work(connections.front());
+    } catch (...) {
+        failure = std::current_exception();
+    }
+    for (auto& worker : workers) {
+        try {
+            worker.get();
+        } catch (...) {
+            if (!failure) {
+                failure = std::current_exception();
+            }
+        }
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
 
-        querySpecs.push_back(std::move(spec));
+    if (cache) {
+        for (const auto index : pending) {
+            cache->store(querySpecs[index], config);
+        }
     }
 
     std::sort(querySpecs.begin(), querySpecs.end(),
@@ -332,4 +1005,44 @@ std::string renderQueryGeneratorSupportHeader(const std::vector<QuerySpec>& spec
     return renderSupportHeader(specs);
 }
 
+std::vector<fbpp::schema::PlanScan> largeNaturalScans(const QuerySpec& spec,
+                                                      std::uint64_t largeTableRows) {
+    std::vector<fbpp::schema::PlanScan> large;
+    for (const auto& scan : spec.naturalScans) {
+        if (scan.estimatedRows && *scan.estimatedRows >= largeTableRows) {
+            large.push_back(scan);
+        }
+    }
+    return large;
+}
+
+std::string renderQueryPlanReport(const std::vector<QuerySpec>& specs,
+                                  std::uint64_t largeTableRows) {
+    std::vector<const QuerySpec*> sorted;
+    sorted.reserve(specs.size());
+    for (const auto& spec : specs) {
+        sorted.push_back(&spec);
+    }
+    std::sort(sorted.begin(), sorted.end(),
+              [](const QuerySpec* a, const QuerySpec* b) { return a->name < b->name; });
+
+    std::ostringstream out;
+    for (const auto* spec : sorted) {
+        out << "== " << spec->name << "\n";
+        std::string_view plan = spec->plan;
+        while (!plan.empty() && (plan.front() == '\n' || plan.front() == '\r')) {
+            plan.remove_prefix(1);
+        }
+        while (!plan.empty() && std::isspace(static_cast<unsigned char>(plan.back()))) {
+            plan.remove_suffix(1);
+        }
+        out << (plan.empty() ? std::string_view("(no plan)") : plan) << "\n";
+        for (const auto& scan : largeNaturalScans(*spec, largeTableRows)) {
+            out << "!! NATURAL scan of large table " << scan.table << "\n";
+        }
+        out << "\n";
+    }
+    return out.str();
+}
+
 } // namespace fbpp::core
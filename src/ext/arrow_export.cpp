@@ -0,0 +1,224 @@
+#include "fbpp/ext/arrow_export.hpp"
+#include "fbpp/core/exception.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fbpp::ext {
+
+namespace {
+
+using fbpp::core::ColumnBatch;
+using fbpp::core::ColumnPlan;
+using fbpp::core::ColumnType;
+using fbpp::core::ColumnVector;
+
+constexpr unsigned kCharsetOctets = 1;
+
+// arrow::Buffer that owns the std::vector it points into, so ColumnVector
+// storage can be handed to Arrow without copying. The holder base is
+// initialised first, before arrow::Buffer captures data()/size().
+template<typename T>
+struct VectorHolder {
+    std::vector<T> storage;
+};
+
+template<typename T>
+class VectorBuffer final : private VectorHolder<T>, public arrow::Buffer {
+public:
+    explicit VectorBuffer(std::vector<T>&& storage)
+        : VectorHolder<T>{std::move(storage)},
+          arrow::Buffer(reinterpret_cast<const uint8_t*>(this->VectorHolder<T>::storage.data()),
+                        static_cast<int64_t>(this->VectorHolder<T>::storage.size() * sizeof(T))) {}
+};
+
+template<typename T>
+std::shared_ptr<arrow::Buffer> adopt(std::vector<T>&& storage) {
+    return std::make_shared<VectorBuffer<T>>(std::move(storage));
+}
+
+// Firebird does not enforce NUMERIC precision: a scaled column holds any
+// value of its storage type, so the declared precision is the storage's
+// digit count (SMALLINT 5, INTEGER 10, BIGINT 19). INT128 reaches 39
+// digits, one past Decimal128; such values are rejected in toArray().
+std::shared_ptr<arrow::DataType> arrowTypeFor(const ColumnPlan& column) {
+    const unsigned sqlType = column.type & ~1u;
+    switch (fbpp::core::columnTypeFor(column)) {
+        case ColumnType::Boolean: return arrow::boolean();
+        case ColumnType::Int16:
+            return column.scale < 0 ? arrow::decimal128(5, -column.scale) : arrow::int16();
+        case ColumnType::Int32:
+            return column.scale < 0 ? arrow::decimal128(10, -column.scale) : arrow::int32();
+        case ColumnType::Int64:
+            return column.scale < 0 ? arrow::decimal128(19, -column.scale) : arrow::int64();
+        case ColumnType::Int128:  return arrow::decimal128(38, -column.scale);
+        case ColumnType::Float:   return arrow::float32();
+        case ColumnType::Double:  return arrow::float64();
+        case ColumnType::Date:    return arrow::date32();
+        case ColumnType::Time:    return arrow::time64(arrow::TimeUnit::MICRO);
+        case ColumnType::Timestamp:
+            return sqlType == SQL_TIMESTAMP_TZ
+                ? arrow::timestamp(arrow::TimeUnit::MICRO, "UTC")
+                : arrow::timestamp(arrow::TimeUnit::MICRO);
+        case ColumnType::String:
+            if ((sqlType == SQL_TEXT || sqlType == SQL_VARYING) &&
+                (column.charSet & 0xFFu) == kCharsetOctets) {
+                return arrow::binary();
+            }
+            return arrow::utf8();
+        case ColumnType::Binary:  return arrow::binary();
+    }
+    throw fbpp::core::FirebirdException("makeArrowSchema: unmapped column type");
+}
+
+// Arrow booleans are bit-packed; ColumnVector keeps one byte per value.
+std::shared_ptr<arrow::Buffer> packBooleans(const ColumnVector& col) {
+    std::vector<uint8_t> bits((col.length + 7) / 8, uint8_t{0});
+    for (std::size_t i = 0; i < col.length; ++i) {
+        if (col.values[i] != 0) {
+            bits[i >> 3] = static_cast<uint8_t>(bits[i >> 3] | (1u << (i & 7)));
+        }
+    }
+    return adopt(std::move(bits));
+}
+
+// Scaled SMALLINT / INTEGER / BIGINT widened to 16-byte little-endian
+// two's complement — the Arrow Decimal128 value layout.
+template<typename T>
+std::shared_ptr<arrow::Buffer> widenToDecimal128(const ColumnVector& col) {
+    std::vector<uint8_t> wide(col.length * 16, uint8_t{0});
+    const auto values = col.view<T>();
+    for (std::size_t i = 0; i < col.length; ++i) {
+        const int64_t low = static_cast<int64_t>(values[i]);
+        const int64_t high = low < 0 ? -1 : 0;
+        std::memcpy(wide.data() + i * 16, &low, sizeof(low));
+        std::memcpy(wide.data() + i * 16 + 8, &high, sizeof(high));
+    }
+    return adopt(std::move(wide));
+}
+
+// INT128 values are already in the Decimal128 layout; only the 39-digit
+// ones past decimal128(38) need catching.
+void checkDecimal128Range(const ColumnVector& col) {
+    for (std::size_t i = 0; i < col.length; ++i) {
+        if (col.nullCount != 0 && col.isNull(i)) {
+            continue;
+        }
+        uint64_t low = 0;
+        int64_t high = 0;
+        std::memcpy(&low, col.values.data() + i * 16, sizeof(low));
+        std::memcpy(&high, col.values.data() + i * 16 + 8, sizeof(high));
+        if (!arrow::Decimal128(high, low).FitsInPrecision(38)) {
+            throw fbpp::core::FirebirdException(
+                "toRecordBatch: " + col.name + " value " +
+                arrow::Decimal128(high, low).ToIntegerString() +
+                " has 39 digits, more than Arrow decimal128 holds");
+        }
+    }
+}
+
+std::shared_ptr<arrow::Array> toArray(ColumnVector&& col,
+                                      const std::shared_ptr<arrow::DataType>& type) {
+    if (col.type == ColumnType::Int128) {
+        checkDecimal128Range(col);
+    }
+    const auto length = static_cast<int64_t>(col.length);
+    const auto nullCount = static_cast<int64_t>(col.nullCount);
+    std::shared_ptr<arrow::Buffer> validity =
+        col.nullCount == 0 ? nullptr : adopt(std::move(col.validity));
+
+    std::vector<std::shared_ptr<arrow::Buffer>> buffers;
+    const bool decimal = type->id() == arrow::Type::DECIMAL128;
+
+    switch (col.type) {
+        case ColumnType::Boolean:
+            buffers = {validity, packBooleans(col)};
+            break;
+        case ColumnType::Int16:
+            buffers = {validity, decimal ? widenToDecimal128<int16_t>(col) : adopt(std::move(col.values))};
+            break;
+        case ColumnType::Int32:
+            buffers = {validity, decimal ? widenToDecimal128<int32_t>(col) : adopt(std::move(col.values))};
+            break;
+        case ColumnType::Int64:
+            buffers = {validity, decimal ? widenToDecimal128<int64_t>(col) : adopt(std::move(col.values))};
+            break;
+        case ColumnType::String:
+        case ColumnType::Binary:
+            buffers = {validity, adopt(std::move(col.offsets)), adopt(std::move(col.values))};
+            break;
+        default:
+            buffers = {validity, adopt(std::move(col.values))};
+            break;
+    }
+
+    return arrow::MakeArray(arrow::ArrayData::Make(type, length, std::move(buffers), nullCount));
+}
+
+} // namespace
+
+std::shared_ptr<arrow::Schema>
+makeArrowSchema(const fbpp::core::MessageMetadata& metadata) {
+    const auto& plan = metadata.getColumnPlan();
+    arrow::FieldVector fields;
+    fields.reserve(plan.size());
+    for (const auto& column : plan) {
+        fields.push_back(arrow::field(fbpp::core::displayName(*column.field),
+                                      arrowTypeFor(column),
+                                      column.nullable));
+    }
+    return arrow::schema(std::move(fields));
+}
+
+std::shared_ptr<arrow::RecordBatch>
+toRecordBatch(ColumnBatch&& batch, const std::shared_ptr<arrow::Schema>& schema) {
+    if (static_cast<std::size_t>(schema->num_fields()) != batch.columns.size()) {
+        throw fbpp::core::FirebirdException(
+            "toRecordBatch: schema has " + std::to_string(schema->num_fields()) +
+            " fields, batch has " + std::to_string(batch.columns.size()) + " columns");
+    }
+
+    std::vector<std::shared_ptr<arrow::Array>> arrays;
+    arrays.reserve(batch.columns.size());
+    for (std::size_t c = 0; c < batch.columns.size(); ++c) {
+        arrays.push_back(toArray(std::move(batch.columns[c]),
+                                 schema->field(static_cast<int>(c))->type()));
+    }
+
+    const auto rows = static_cast<int64_t>(batch.rowCount);
+    batch.columns.clear();
+    batch.rowCount = 0;
+    return arrow::RecordBatch::Make(schema, rows, std::move(arrays));
+}
+
+ResultSetRecordBatchReader::ResultSetRecordBatchReader(fbpp::core::ResultSet& resultSet,
+                                                       std::size_t batchSize)
+    : resultSet_(resultSet), batchSize_(batchSize) {
+    if (batchSize_ == 0) {
+        throw fbpp::core::FirebirdException("ResultSetRecordBatchReader: batchSize must be > 0");
+    }
+    if (!resultSet_.getMetadata()) {
+        throw fbpp::core::FirebirdException("ResultSetRecordBatchReader: cursor has no metadata");
+    }
+    schema_ = makeArrowSchema(*resultSet_.getMetadata());
+}
+
+arrow::Status ResultSetRecordBatchReader::ReadNext(std::shared_ptr<arrow::RecordBatch>* batch) {
+    try {
+        // A fresh ColumnBatch per call: its buffers are moved into Arrow.
+        ColumnBatch columns;
+        if (!resultSet_.fetchColumns(columns, batchSize_)) {
+            batch->reset();
+            return arrow::Status::OK();
+        }
+        *batch = toRecordBatch(std::move(columns), schema_);
+        return arrow::Status::OK();
+    } catch (const std::exception& e) {
+        return arrow::Status::IOError(e.what());
+    }
+}
+
+} // namespace fbpp::ext
@@ -0,0 +1,164 @@
+#include "fbpp/ext/otel.hpp"
+#include "fbpp/fbpp.hpp"
+
+#include <opentelemetry/common/key_value_iterable_view.h>
+#include <opentelemetry/context/runtime_context.h>
+#include <opentelemetry/metrics/meter.h>
+#include <opentelemetry/metrics/provider.h>
+#include <opentelemetry/metrics/sync_instruments.h>
+#include <opentelemetry/nostd/shared_ptr.h>
+#include <opentelemetry/nostd/unique_ptr.h>
+#include <opentelemetry/trace/provider.h>
+#include <opentelemetry/trace/span.h>
+#include <opentelemetry/trace/tracer.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace fbpp::ext {
+
+namespace {
+
+namespace otel = opentelemetry;
+using fbpp::core::SpanKind;
+
+constexpr const char* kDbSystem = "firebird";
+
+std::string versionString() {
+    return std::to_string(FBPP_VERSION_MAJOR) + "." + std::to_string(FBPP_VERSION_MINOR) + "." +
+           std::to_string(FBPP_VERSION_PATCH);
+}
+
+// One started fbpp span: the OTel span (if spans are on) plus what the
+// histograms need at the end.
+struct OtelSpan {
+    otel::nostd::shared_ptr<otel::trace::Span> span;
+    std::chrono::steady_clock::time_point started;
+    SpanKind kind;
+    char fingerprint[17] = {};   // Empty when the span has no SQL
+};
+
+otel::nostd::string_view view(std::string_view text) {
+    return otel::nostd::string_view(text.data(), text.size());
+}
+
+} // namespace
+
+struct OtelSpanObserver::Impl {
+    otel::nostd::shared_ptr<otel::trace::Tracer> tracer;
+    otel::nostd::unique_ptr<otel::metrics::Histogram<double>> duration;
+    otel::nostd::unique_ptr<otel::metrics::Histogram<uint64_t>> returnedRows;
+};
+
+OtelSpanObserver::OtelSpanObserver(OtelOptions options)
+    : options_(std::move(options)), impl_(std::make_unique<Impl>()) {
+    const std::string version = versionString();
+    if (options_.spans) {
+        impl_->tracer = otel::trace::Provider::GetTracerProvider()->GetTracer(
+            options_.instrumentationName, version);
+    }
+    if (options_.metrics) {
+        auto meter = otel::metrics::Provider::GetMeterProvider()->GetMeter(
+            options_.instrumentationName, version);
+        impl_->duration = meter->CreateDoubleHistogram(
+            "db.client.operation.duration", "Duration of database client operations", "s");
+        impl_->returnedRows = meter->CreateUInt64Histogram(
+            "db.client.response.returned_rows", "Rows returned by a cursor", "{row}");
+    }
+}
+
+OtelSpanObserver::~OtelSpanObserver() {
+    if (fbpp::core::getSpanObserver() == this) {
+        fbpp::core::setSpanObserver(nullptr);
+    }
+}
+
+void* OtelSpanObserver::startSpan(const fbpp::core::SpanStart& start) {
+    auto span = std::make_unique<OtelSpan>();
+    span->started = std::chrono::steady_clock::now();
+    span->kind = start.kind;
+    if (start.fingerprint != 0) {
+        std::snprintf(span->fingerprint, sizeof(span->fingerprint), "%016llx",
+                      static_cast<unsigned long long>(start.fingerprint));
+    }
+
+    if (impl_->tracer) {
+        otel::trace::StartSpanOptions spanOptions;
+        spanOptions.kind = otel::trace::SpanKind::kClient;
+        const char* operation = fbpp::core::spanKindName(start.kind);
+        span->span = impl_->tracer->StartSpan(
+            operation,
+            {{"db.system", kDbSystem}, {"db.operation.name", operation}},
+            spanOptions);
+        if (!start.database.empty()) {
+            span->span->SetAttribute("db.namespace", view(start.database));
+        }
+        if (span->fingerprint[0] != '\0') {
+            span->span->SetAttribute("fbpp.query.fingerprint",
+                                     otel::nostd::string_view(span->fingerprint));
+        }
+        if (options_.recordSqlText && !start.sql.empty()) {
+            span->span->SetAttribute("db.query.text", view(start.sql));
+        }
+    }
+    return span.release();
+}
+
+void OtelSpanObserver::endSpan(void* handle, const fbpp::core::SpanEnd& end) noexcept {
+    std::unique_ptr<OtelSpan> span(static_cast<OtelSpan*>(handle));
+    if (!span) {
+        return;
+    }
+    try {
+        if (span->span) {
+            if (span->kind == SpanKind::FetchLoop) {
+                span->span->SetAttribute("db.response.returned_rows",
+                                         static_cast<int64_t>(end.rows));
+            } else if (span->kind == SpanKind::Execute) {
+                span->span->SetAttribute("fbpp.rows_affected", static_cast<int64_t>(end.rows));
+            }
+            if (end.failed) {
+                span->span->SetStatus(otel::trace::StatusCode::kError, view(end.error));
+            }
+            span->span->End();
+        }
+
+        if (impl_->duration) {
+            const double seconds = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - span->started).count();
+            std::map<std::string, std::string> attributes{
+                {"db.system", kDbSystem},
+                {"db.operation.name", fbpp::core::spanKindName(span->kind)}};
+            if (span->fingerprint[0] != '\0') {
+                attributes.emplace("fbpp.query.fingerprint", span->fingerprint);
+            }
+            const auto context = otel::context::RuntimeContext::GetCurrent();
+            if (span->kind == SpanKind::FetchLoop && impl_->returnedRows) {
+                impl_->returnedRows->Record(
+                    end.rows, otel::common::KeyValueIterableView<decltype(attributes)>{attributes},
+                    context);
+            }
+            if (end.failed) {
+                attributes.emplace("error.type", "fbpp.error");
+            }
+            impl_->duration->Record(
+                seconds, otel::common::KeyValueIterableView<decltype(attributes)>{attributes},
+                context);
+        }
+    } catch (...) {
+        // Telemetry must never fail the database call it describes
+    }
+}
+
+std::unique_ptr<OtelSpanObserver> installOpenTelemetry(OtelOptions options) {
+    auto observer = std::make_unique<OtelSpanObserver>(std::move(options));
+    fbpp::core::setSpanObserver(observer.get());
+    return observer;
+}
+
+} // namespace fbpp::ext
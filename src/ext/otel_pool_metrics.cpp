@@ -0,0 +1,208 @@
+#include "fbpp/ext/otel.hpp"
+#include "fbpp/fbpp.hpp"
+#include "fbpp/pool/connection_pool.hpp"
+
+#include <opentelemetry/common/key_value_iterable_view.h>
+#include <opentelemetry/metrics/async_instruments.h>
+#include <opentelemetry/metrics/meter.h>
+#include <opentelemetry/metrics/observer_result.h>
+#include <opentelemetry/metrics/provider.h>
+#include <opentelemetry/nostd/shared_ptr.h>
+#include <opentelemetry/nostd/variant.h>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fbpp::ext {
+
+namespace {
+
+namespace otel = opentelemetry;
+using fbpp::pool::ConnectionPoolStats;
+using Attributes = std::map<std::string, std::string>;
+
+constexpr const char* kPoolName = "db.client.connection.pool.name";
+
+// By PoolPriority
+constexpr const char* kLaneNames[fbpp::pool::kPoolPriorities] = {"interactive", "normal",
+                                                                  "batch"};
+
+std::string versionString() {
+    return std::to_string(FBPP_VERSION_MAJOR) + "." + std::to_string(FBPP_VERSION_MINOR) + "." +
+           std::to_string(FBPP_VERSION_PATCH);
+}
+
+template<typename T>
+void observe(otel::metrics::ObserverResult& result, T value, const Attributes& attributes) {
+    using Typed = otel::nostd::shared_ptr<otel::metrics::ObserverResultT<T>>;
+    if (otel::nostd::holds_alternative<Typed>(result)) {
+        otel::nostd::get<Typed>(result)->Observe(
+            value, otel::common::KeyValueIterableView<Attributes>{attributes});
+    }
+}
+
+} // namespace
+
+struct OtelPoolMetrics::Impl {
+    using Callback = void (*)(otel::metrics::ObserverResult, void*);
+    using Instrument = otel::nostd::shared_ptr<otel::metrics::ObservableInstrument>;
+
+    const OtelPoolMetrics& owner;
+    std::vector<std::pair<Instrument, Callback>> instruments;
+
+    explicit Impl(const OtelPoolMetrics& metrics) : owner(metrics) {}
+
+    static Impl& of(void* state) { return *static_cast<Impl*>(state); }
+
+    ConnectionPoolStats stats() const { return owner.pool_.stats(); }
+
+    Attributes attributes() const { return {{kPoolName, owner.poolName_}}; }
+
+    Attributes attributes(const char* key, std::string value) const {
+        Attributes result = attributes();
+        result.emplace(key, std::move(value));
+        return result;
+    }
+
+    void add(Instrument instrument, Callback callback) {
+        instrument->AddCallback(callback, this);
+        instruments.emplace_back(std::move(instrument), callback);
+    }
+
+    // p50 / p90 / p99 / max of a snapshot, microseconds scaled by `factor`
+    void observeQuantiles(otel::metrics::ObserverResult& result,
+                          const core::LatencySnapshot& snapshot, double factor) const {
+        const std::pair<const char*, uint64_t> quantiles[] = {{"p50", snapshot.p50Micros},
+                                                              {"p90", snapshot.p90Micros},
+                                                              {"p99", snapshot.p99Micros},
+                                                              {"max", snapshot.maxMicros}};
+        for (const auto& [name, value] : quantiles) {
+            observe(result, static_cast<double>(value) * factor, attributes("quantile", name));
+        }
+    }
+};
+
+OtelPoolMetrics::OtelPoolMetrics(const fbpp::pool::ConnectionPool& pool, std::string poolName,
+                                 OtelOptions options)
+    : pool_(pool), poolName_(std::move(poolName)), impl_(std::make_unique<Impl>(*this)) {
+    if (!options.metrics) {
+        return;
+    }
+    auto meter = otel::metrics::Provider::GetMeterProvider()->GetMeter(
+        options.instrumentationName, versionString());
+    Impl& impl = *impl_;
+
+    impl.add(meter->CreateInt64ObservableUpDownCounter(
+                 "db.client.connection.count", "Open connections by state", "{connection}"),
+             +[](otel::metrics::ObserverResult result, void* state) {
+                 const Impl& self = Impl::of(state);
+                 const auto stats = self.stats();
+                 observe(result, static_cast<int64_t>(stats.idle), self.attributes("state", "idle"));
+                 observe(result, static_cast<int64_t>(stats.leased),
+                         self.attributes("state", "used"));
+             });
+    impl.add(meter->CreateInt64ObservableUpDownCounter(
+                 "db.client.connection.max", "Concurrency limit of the pool", "{connection}"),
+             +[](otel::metrics::ObserverResult result, void* state) {
+                 const Impl& self = Impl::of(state);
+                 observe(result, static_cast<int64_t>(self.stats().limit), self.attributes());
+             });
+    impl.add(meter->CreateInt64ObservableUpDownCounter(
+                 "db.client.connection.pending_requests", "Checkouts waiting for a connection",
+                 "{request}"),
+             +[](otel::metrics::ObserverResult result, void* state) {
+                 const Impl& self = Impl::of(state);
+                 const auto stats = self.stats();
+                 for (size_t lane = 0; lane < fbpp::pool::kPoolPriorities; ++lane) {
+                     observe(result, static_cast<int64_t>(stats.lanes[lane].waiting),
+                             self.attributes("fbpp.pool.priority", kLaneNames[lane]));
+                 }
+             });
+    impl.add(meter->CreateInt64ObservableCounter(
+                 "db.client.connection.timeouts", "Checkouts that gave up waiting", "{timeout}"),
+             +[](otel::metrics::ObserverResult result, void* state) {
+                 const Impl& self = Impl::of(state);
+                 observe(result, static_cast<int64_t>(self.stats().timeouts), self.attributes());
+             });
+    impl.add(meter->CreateInt64ObservableUpDownCounter(
+                 "fbpp.pool.connection.creating", "Attachments being opened", "{connection}"),
+             +[](otel::metrics::ObserverResult result, void* state) {
+                 const Impl& self = Impl::of(state);
+                 observe(result, static_cast<int64_t>(self.stats().creating), self.attributes());
+             });
+    impl.add(meter->CreateInt64ObservableCounter(
+                 "fbpp.pool.connection.created", "Attachments opened", "{connection}"),
+             +[](otel::metrics::ObserverResult result, void* state) {
+                 const Impl& self = Impl::of(state);
+                 observe(result, static_cast<int64_t>(self.stats().created), self.attributes());
+             });
+    impl.add(meter->CreateInt64ObservableCounter(
+                 "fbpp.pool.connection.validation_failures",
+                 "Idle connections found dead on checkout", "{connection}"),
+             +[](otel::metrics::ObserverResult result, void* state) {
+                 const Impl& self = Impl::of(state);
+                 observe(result, static_cast<int64_t>(self.stats().validationFailures),
+                         self.attributes());
+             });
+    impl.add(meter->CreateInt64ObservableCounter(
+                 "fbpp.pool.connection.reaped", "Idle connections closed by reaping",
+                 "{connection}"),
+             +[](otel::metrics::ObserverResult result, void* state) {
+                 const Impl& self = Impl::of(state);
+                 observe(result, static_cast<int64_t>(self.stats().reaped), self.attributes());
+             });
+    impl.add(meter->CreateDoubleObservableGauge(
+                 "fbpp.pool.utilization", "Leased connections over the limit", "1"),
+             +[](otel::metrics::ObserverResult result, void* state) {
+                 const Impl& self = Impl::of(state);
+                 observe(result, self.stats().utilizationNow(), self.attributes());
+             });
+    impl.add(meter->CreateInt64ObservableCounter(
+                 "fbpp.pool.statement_cache.hits", "Statement cache hits of pooled connections",
+                 "{hit}"),
+             +[](otel::metrics::ObserverResult result, void* state) {
+                 const Impl& self = Impl::of(state);
+                 observe(result, static_cast<int64_t>(self.stats().statementCacheHits),
+                         self.attributes());
+             });
+    impl.add(meter->CreateInt64ObservableCounter(
+                 "fbpp.pool.statement_cache.misses",
+                 "Statement cache misses of pooled connections", "{miss}"),
+             +[](otel::metrics::ObserverResult result, void* state) {
+                 const Impl& self = Impl::of(state);
+                 observe(result, static_cast<int64_t>(self.stats().statementCacheMisses),
+                         self.attributes());
+             });
+    impl.add(meter->CreateDoubleObservableGauge(
+                 "db.client.connection.wait_time", "Time to obtain a connection, by quantile",
+                 "s"),
+             +[](otel::metrics::ObserverResult result, void* state) {
+                 const Impl& self = Impl::of(state);
+                 self.observeQuantiles(result, self.stats().checkoutWait, 1e-6);
+             });
+    impl.add(meter->CreateDoubleObservableGauge(
+                 "db.client.connection.use_time", "Time a connection was leased, by quantile",
+                 "s"),
+             +[](otel::metrics::ObserverResult result, void* state) {
+                 const Impl& self = Impl::of(state);
+                 self.observeQuantiles(result, self.stats().leaseDuration, 1e-6);
+             });
+    impl.add(meter->CreateDoubleObservableGauge(
+                 "fbpp.pool.utilization.checkout",
+                 "Percent of the limit in use at checkout, by quantile", "%"),
+             +[](otel::metrics::ObserverResult result, void* state) {
+                 const Impl& self = Impl::of(state);
+                 self.observeQuantiles(result, self.stats().utilization, 1.0);
+             });
+}
+
+OtelPoolMetrics::~OtelPoolMetrics() {
+    for (auto& [instrument, callback] : impl_->instruments) {
+        instrument->RemoveCallback(callback, impl_.get());
+    }
+}
+
+} // namespace fbpp::ext
@@ -0,0 +1,87 @@
+#include "fbpp/ext/parquet_export.hpp"
+#include "fbpp/core/exception.hpp"
+
+#include <arrow/io/file.h>
+#include <parquet/arrow/writer.h>
+#include <parquet/properties.h>
+
+#include <string>
+#include <utility>
+
+namespace fbpp::ext {
+
+namespace {
+
+void check(const arrow::Status& status, const char* what) {
+    if (!status.ok()) {
+        throw fbpp::core::FirebirdException(std::string("writeParquet: ") + what + ": " +
+                                            status.ToString());
+    }
+}
+
+std::shared_ptr<parquet::WriterProperties> writerProperties(const ParquetExportOptions& options) {
+    parquet::WriterProperties::Builder builder;
+    builder.max_row_group_length(static_cast<int64_t>(options.rowGroupRows));
+    builder.compression(options.compression);
+    if (options.compressionLevel != arrow::util::kUseDefaultCompressionLevel) {
+        builder.compression_level(options.compressionLevel);
+    }
+    if (options.dictionary) {
+        builder.enable_dictionary();
+    } else {
+        builder.disable_dictionary();
+    }
+    return builder.build();
+}
+
+} // namespace
+
+ParquetExportResult writeParquet(fbpp::core::ResultSet& resultSet,
+                                 const std::shared_ptr<arrow::io::OutputStream>& sink,
+                                 const ParquetExportOptions& options) {
+    if (!sink) {
+        throw fbpp::core::FirebirdException("writeParquet: null output stream");
+    }
+    if (options.rowGroupRows == 0 || options.batchSize == 0) {
+        throw fbpp::core::FirebirdException("writeParquet: rowGroupRows and batchSize must be > 0");
+    }
+    if (!resultSet.getMetadata()) {
+        throw fbpp::core::FirebirdException("writeParquet: cursor has no metadata");
+    }
+
+    const auto schema = makeArrowSchema(*resultSet.getMetadata());
+    auto arrowProperties = parquet::ArrowWriterProperties::Builder().store_schema()->build();
+    auto opened = parquet::arrow::FileWriter::Open(*schema, arrow::default_memory_pool(), sink,
+                                                   writerProperties(options),
+                                                   std::move(arrowProperties));
+    check(opened.status(), "open");
+    std::unique_ptr<parquet::arrow::FileWriter> writer = std::move(opened).ValueOrDie();
+
+    // WriteRecordBatch appends to the buffered row group and starts a new
+    // one at max_row_group_length, so row groups are exactly rowGroupRows.
+    ParquetExportResult result;
+    fbpp::core::ColumnBatch columns;
+    while (resultSet.fetchColumns(columns, options.batchSize)) {
+        result.rows += columns.rowCount;
+        const auto batch = toRecordBatch(std::move(columns), schema);
+        check(writer->WriteRecordBatch(*batch), "write");
+        columns = fbpp::core::ColumnBatch{};   // Buffers were moved into Arrow
+    }
+    check(writer->Close(), "close");
+
+    result.rowGroups = static_cast<std::size_t>(writer->metadata()->num_row_groups());
+    return result;
+}
+
+ParquetExportResult writeParquet(fbpp::core::ResultSet& resultSet,
+                                 const std::string& path,
+                                 const ParquetExportOptions& options) {
+    auto file = arrow::io::FileOutputStream::Open(path);
+    check(file.status(), "open file");
+    auto sink = std::move(file).ValueOrDie();
+    auto result = writeParquet(resultSet, sink, options);
+    check(sink->Close(), "close file");
+    return result;
+}
+
+} // namespace fbpp::ext
@@ -0,0 +1,635 @@
+#include "fbpp/pool/connection_pool.hpp"
+#include "fbpp/core/deadline.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp_util/trace.h"
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fbpp::pool {
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+void checkBounds(size_t minSize, size_t maxSize, const ConnectionPoolOptions& options) {
+    if (maxSize == 0) {
+        throw core::FirebirdException("ConnectionPool: maxSize must be positive");
+    }
+    if (minSize > maxSize) {
+        throw core::FirebirdException("ConnectionPool: minSize exceeds maxSize");
+    }
+    if (options.reservedInteractive + options.reservedNormal >= maxSize) {
+        throw core::FirebirdException(
+            "ConnectionPool: reserved capacity leaves no connection for Batch checkouts");
+    }
+}
+
+} // namespace
+
+namespace detail {
+
+struct IdleConnection {
+    std::unique_ptr<core::Connection> connection;
+    std::thread::id owner;            // Thread that returned it
+    Clock::time_point since;
+    uint64_t generation = 0;          // PoolState::generation of its options
+    CacheCounters cache;              // Its StatementCache counters when returned
+};
+
+struct PoolState {
+    core::ConnectionParams params;       // params.options: see generation
+    size_t minSize = 0;
+    size_t maxSize = 0;
+    ConnectionPoolOptions options;
+
+    mutable std::mutex mutex;
+    std::condition_variable available;   // idle grew, total shrank or shutdown
+    std::condition_variable stopping;    // Wakes the reaper on shutdown only
+    std::deque<IdleConnection> idle;     // Returned order: front is oldest
+    size_t total = 0;                    // Idle + leased + being opened
+    size_t creating = 0;                 // Being opened (checkout or refill)
+    bool shutdown = false;
+    uint64_t generation = 0;             // Bumped by each setConnectionOptions()
+    ConnectionPoolStats stats;
+
+    // Admission: leases (and attachments being opened for one) per lane
+    std::array<size_t, kPoolPriorities> leased{};
+    std::array<size_t, kPoolPriorities> waiting{};
+    size_t leasedTotal = 0;
+    double limit = 0;                    // Adaptive limit; maxSize when not adaptive
+    size_t samplesSinceBackoff = 0;
+    std::array<core::LatencyHistogram, kPoolPriorities> queueWait;
+    core::LatencyHistogram checkoutWait;
+    core::LatencyHistogram leaseDuration;
+    core::LatencyHistogram utilization;  // Percent of the limit in use, per checkout
+
+    size_t currentLimit() const {
+        return std::clamp<size_t>(static_cast<size_t>(limit), 1, maxSize);
+    }
+
+    // Leases lane `lane` may hold in total: the limit less the capacity
+    // reserved for the lanes above it
+    size_t ceiling(size_t lane) const {
+        size_t reserved = 0;
+        if (lane > static_cast<size_t>(PoolPriority::Interactive)) {
+            reserved += options.reservedInteractive;
+        }
+        if (lane > static_cast<size_t>(PoolPriority::Normal)) {
+            reserved += options.reservedNormal;
+        }
+        const size_t cap = currentLimit();
+        return cap > reserved ? cap - reserved : 0;
+    }
+
+    // A checkout of `lane` may take a connection now: within its ceiling,
+    // and no checkout of a higher lane is waiting
+    bool admits(size_t lane) const {
+        for (size_t higher = 0; higher < lane; ++higher) {
+            if (waiting[higher] != 0) {
+                return false;
+            }
+        }
+        return leasedTotal < ceiling(lane);
+    }
+
+    void admit(size_t lane) {
+        ++leased[lane];
+        ++leasedTotal;
+        stats.peakLeased = std::max(stats.peakLeased, leasedTotal);
+    }
+
+    void unadmit(size_t lane) {
+        --leased[lane];
+        --leasedTotal;
+        available.notify_all();
+    }
+
+    // A lease of `lane` held for `held` ended; `sample` feeds the adaptive
+    // limit, `cache` is what the connection's StatementCache counted meanwhile
+    void endLease(size_t lane, Clock::duration held, std::optional<Clock::duration> sample,
+                  CacheCounters cache) {
+        const size_t inFlight = leasedTotal;
+        unadmit(lane);
+        leaseDuration.record(held);
+        stats.statementCacheHits += cache.hits;
+        stats.statementCacheMisses += cache.misses;
+        const AdaptiveLimitOptions& adaptive = options.adaptiveLimit;
+        if (!adaptive.enabled || !sample) {
+            return;
+        }
+        const double floor = static_cast<double>(std::max<size_t>(adaptive.minLimit, 1));
+        const double ceil = static_cast<double>(maxSize);
+        ++samplesSinceBackoff;
+        if (*sample > adaptive.latencyTarget) {
+            if (samplesSinceBackoff >= currentLimit()) {
+                limit = std::max(floor, limit * adaptive.backoff);
+                samplesSinceBackoff = 0;
+                ++stats.limitDecreases;
+            }
+        } else if (2 * inFlight >= currentLimit()) {
+            limit = std::min(ceil, limit + 1.0 / limit);
+        }
+    }
+
+    // Called with the lock held; the connection (if any) is destroyed by the
+    // caller after unlocking, since closing an attachment is a round trip.
+    std::unique_ptr<core::Connection> giveBack(std::unique_ptr<core::Connection> connection,
+                                               bool keep, uint64_t connectionGeneration,
+                                               CacheCounters cache = {}) {
+        if (!connection) {
+            return nullptr;
+        }
+        // Every waiter rechecks: the one to serve depends on the lanes.
+        // Above maxSize only after a resize(): the surplus closes on return.
+        if (!keep || shutdown || total > maxSize) {
+            --total;
+            available.notify_all();
+            return connection;
+        }
+        idle.push_back({std::move(connection), std::this_thread::get_id(), Clock::now(),
+                        connectionGeneration, cache});
+        available.notify_all();
+        return nullptr;
+    }
+};
+
+} // namespace detail
+
+// ConnectionLease
+
+ConnectionLease::ConnectionLease(std::shared_ptr<detail::PoolState> state,
+                                 std::unique_ptr<core::Connection> connection,
+                                 PoolPriority priority, uint64_t generation,
+                                 detail::CacheCounters cacheSeen)
+    : state_(std::move(state)),
+      connection_(std::move(connection)),
+      priority_(priority),
+      since_(Clock::now()),
+      generation_(generation),
+      cacheSeen_(cacheSeen) {}
+
+ConnectionLease::~ConnectionLease() {
+    try {
+        release();
+    } catch (...) {
+        // Suppress exceptions in destructor
+    }
+}
+
+ConnectionLease& ConnectionLease::operator=(ConnectionLease&& other) noexcept {
+    if (this != &other) {
+        try {
+            release();
+        } catch (...) {
+        }
+        state_ = std::move(other.state_);
+        connection_ = std::move(other.connection_);
+        priority_ = other.priority_;
+        since_ = other.since_;
+        latency_ = other.latency_;
+        generation_ = other.generation_;
+        cacheSeen_ = other.cacheSeen_;
+    }
+    return *this;
+}
+
+detail::CacheCounters ConnectionLease::takeCacheDelta() noexcept {
+    detail::CacheCounters delta;
+    try {
+        // On the holder's thread, before the connection goes back
+        const auto statistics = connection_->getCacheStatistics();
+        const detail::CacheCounters now{statistics.hitCount, statistics.missCount};
+        // Counters below the last return: the cache was recreated since
+        delta.hits = now.hits >= cacheSeen_.hits ? now.hits - cacheSeen_.hits : now.hits;
+        delta.misses =
+            now.misses >= cacheSeen_.misses ? now.misses - cacheSeen_.misses : now.misses;
+        cacheSeen_ = now;
+    } catch (...) {
+        // Statistics are best effort; the return must not fail
+    }
+    return delta;
+}
+
+void ConnectionLease::release() {
+    if (!connection_ || !state_) {
+        connection_.reset();
+        return;
+    }
+    const Clock::duration held = Clock::now() - since_;
+    const Clock::duration sample = latency_ ? *latency_ : held;
+    const detail::CacheCounters cache = takeCacheDelta();
+    std::unique_ptr<core::Connection> closing;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->endLease(static_cast<size_t>(priority_), held, sample, cache);
+        closing = state_->giveBack(std::move(connection_), true, generation_, cacheSeen_);
+    }
+    state_.reset();
+}
+
+void ConnectionLease::discard() {
+    if (!connection_ || !state_) {
+        connection_.reset();
+        return;
+    }
+    const Clock::duration held = Clock::now() - since_;
+    const detail::CacheCounters cache = takeCacheDelta();
+    std::unique_ptr<core::Connection> closing;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->endLease(static_cast<size_t>(priority_), held, std::nullopt, cache);
+        closing = state_->giveBack(std::move(connection_), false, generation_);
+    }
+    state_.reset();
+}
+
+// ConnectionPool
+
+ConnectionPool::ConnectionPool(core::ConnectionParams params, size_t minSize, size_t maxSize,
+                               ConnectionPoolOptions options)
+    : state_(std::make_shared<detail::PoolState>()),
+      options_(options) {
+    checkBounds(minSize, maxSize, options_);
+    if (options_.adaptiveLimit.enabled &&
+        !(options_.adaptiveLimit.backoff > 0 && options_.adaptiveLimit.backoff < 1)) {
+        throw core::FirebirdException("ConnectionPool: adaptive backoff must be in (0, 1)");
+    }
+    state_->params = std::move(params);
+    state_->minSize = minSize;
+    state_->maxSize = maxSize;
+    state_->options = options_;
+    state_->limit = static_cast<double>(maxSize);
+
+    fillToMinimum();
+
+    if (options_.reapInterval.count() > 0) {
+        reaper_ = std::thread([this] { reaperLoop(); });
+    }
+}
+
+ConnectionPool::~ConnectionPool() {
+    std::deque<detail::IdleConnection> closing;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->shutdown = true;
+        state_->total -= state_->idle.size();
+        closing.swap(state_->idle);
+        state_->available.notify_all();
+        state_->stopping.notify_all();
+    }
+    if (reaper_.joinable()) {
+        reaper_.join();
+    }
+    // Leased connections are closed when their leases end.
+}
+
+ConnectionLease ConnectionPool::acquire() {
+    return checkout(PoolPriority::Normal, options_.acquireTimeout, true);
+}
+
+ConnectionLease ConnectionPool::acquire(std::chrono::milliseconds timeout) {
+    return checkout(PoolPriority::Normal, timeout, true);
+}
+
+ConnectionLease ConnectionPool::acquire(PoolPriority priority) {
+    return checkout(priority, options_.acquireTimeout, true);
+}
+
+ConnectionLease ConnectionPool::acquire(PoolPriority priority, std::chrono::milliseconds timeout) {
+    return checkout(priority, timeout, true);
+}
+
+ConnectionLease ConnectionPool::tryAcquire() {
+    return checkout(PoolPriority::Normal, std::chrono::milliseconds::zero(), false);
+}
+
+ConnectionLease ConnectionPool::tryAcquire(PoolPriority priority) {
+    return checkout(priority, std::chrono::milliseconds::zero(), false);
+}
+
+ConnectionLease ConnectionPool::checkout(PoolPriority priority, std::chrono::milliseconds timeout,
+                                         bool wait) {
+    auto& state = *state_;
+    const auto lane = static_cast<size_t>(priority);
+    const auto started = Clock::now();
+    auto deadline = started + timeout;
+    // The request's DeadlineScope caps the wait as well
+    const core::Deadline* budget = wait ? core::Deadline::current() : nullptr;
+    if (budget) {
+        budget->check("ConnectionPool::acquire");
+        deadline = std::min(deadline, budget->at());
+    }
+
+    std::unique_lock<std::mutex> lock(state.mutex);
+    // Queued in state.waiting[lane]; lower lanes hold back while it is
+    bool queued = false;
+    auto dequeue = [&] {
+        if (queued) {
+            queued = false;
+            if (--state.waiting[lane] == 0) {
+                state.available.notify_all();
+            }
+        }
+    };
+    auto leased = [&](std::unique_ptr<core::Connection> connection, uint64_t generation,
+                      detail::CacheCounters cache) {
+        const auto waited = Clock::now() - started;
+        ++state.stats.lanes[lane].acquired;
+        state.queueWait[lane].record(waited);
+        state.checkoutWait.record(waited);
+        state.utilization.record(static_cast<uint64_t>(100 * state.leasedTotal /
+                                                       state.currentLimit()));
+        return ConnectionLease(state_, std::move(connection), priority, generation, cache);
+    };
+
+    while (true) {
+        if (state.shutdown) {
+            dequeue();
+            throw core::FirebirdException("ConnectionPool is shut down");
+        }
+
+        if (state.admits(lane)) {
+            dequeue();
+            // Counted as leased from here; unadmit() if no lease comes of it
+            state.admit(lane);
+
+            if (!state.idle.empty()) {
+                // Most recently returned first: its pages and caches are warmest.
+                auto it = std::prev(state.idle.end());
+                bool ownConnection = false;
+                if (options_.threadAffinity) {
+                    const auto self = std::this_thread::get_id();
+                    auto mine =
+                        std::find_if(state.idle.rbegin(), state.idle.rend(),
+                                     [&](const auto& entry) { return entry.owner == self; });
+                    if (mine != state.idle.rend()) {
+                        it = std::prev(mine.base());
+                        ownConnection = true;
+                    }
+                }
+                auto connection = std::move(it->connection);
+                const auto idleFor = Clock::now() - it->since;
+                const uint64_t generation = it->generation;
+                const detail::CacheCounters cache = it->cache;
+                state.idle.erase(it);
+
+                // Validate outside the lock: ping is a round trip.
+                lock.unlock();
+                const bool alive =
+                    idleFor < options_.validateAfterIdle || connection->isConnected();
+                if (alive) {
+                    lock.lock();
+                    ++state.stats.reused;
+                    if (ownConnection) {
+                        ++state.stats.affinityHits;
+                    }
+                    if (generation == state.generation) {
+                        return leased(std::move(connection), generation, cache);
+                    }
+                    // setConnectionOptions() since it was last leased
+                    const core::ConnectionOptions options = state.params.options;
+                    const uint64_t current = state.generation;
+                    lock.unlock();
+                    try {
+                        connection->setOptions(options);
+                    } catch (...) {
+                        connection.reset();
+                        lock.lock();
+                        --state.total;
+                        state.unadmit(lane);
+                        throw;
+                    }
+                    lock.lock();
+                    ++state.stats.optionsApplied;
+                    return leased(std::move(connection), current, cache);
+                }
+                connection.reset();
+                lock.lock();
+                --state.total;
+                state.unadmit(lane);
+                ++state.stats.validationFailures;
+                fbpp::util::trace(fbpp::util::TraceLevel::info, "ConnectionPool",
+                            [](auto& oss) { oss << "Dropped dead idle connection"; });
+                continue;
+            }
+
+            if (state.total < state.maxSize) {
+                ++state.total;
+                ++state.creating;
+                const core::ConnectionParams params = state.params;
+                const uint64_t generation = state.generation;
+                lock.unlock();
+                try {
+                    auto connection = std::make_unique<core::Connection>(params);
+                    lock.lock();
+                    --state.creating;
+                    ++state.stats.created;
+                    return leased(std::move(connection), generation, {});
+                } catch (...) {
+                    lock.lock();
+                    --state.creating;
+                    --state.total;
+                    state.unadmit(lane);
+                    throw;
+                }
+            }
+            state.unadmit(lane);
+        }
+
+        if (!wait) {
+            return ConnectionLease();
+        }
+        if (!queued) {
+            queued = true;
+            ++state.waiting[lane];
+        }
+        if (state.available.wait_until(lock, deadline) == std::cv_status::timeout) {
+            // Something may have come back right at the deadline.
+            if (!state.shutdown && !state.admits(lane)) {
+                dequeue();
+                ++state.stats.timeouts;
+                ++state.stats.lanes[lane].timeouts;
+                if (budget) {
+                    budget->check("ConnectionPool::acquire");
+                }
+                throw core::FirebirdException(
+                    "ConnectionPool: no connection available within " +
+                    std::to_string(timeout.count()) + " ms (maxSize " +
+                    std::to_string(state.maxSize) + ", limit " +
+                    std::to_string(state.currentLimit()) + ")");
+            }
+        }
+    }
+}
+
+size_t ConnectionPool::reapIdle() {
+    auto& state = *state_;
+    if (options_.idleTimeout.count() <= 0) {
+        return 0;
+    }
+
+    std::vector<std::unique_ptr<core::Connection>> closing;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        const auto cutoff = Clock::now() - options_.idleTimeout;
+        // Front is the longest idle.
+        while (!state.idle.empty() && state.total > state.minSize &&
+               state.idle.front().since <= cutoff) {
+            closing.push_back(std::move(state.idle.front().connection));
+            state.idle.pop_front();
+            --state.total;
+            ++state.stats.reaped;
+        }
+        if (!closing.empty()) {
+            state.available.notify_all();
+        }
+    }
+    return closing.size();
+}
+
+void ConnectionPool::fillToMinimum() {
+    auto& state = *state_;
+    size_t missing = 0;
+    core::ConnectionParams params;
+    uint64_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (state.shutdown || state.total >= state.minSize) {
+            return;
+        }
+        missing = state.minSize - state.total;
+        state.total += missing;
+        state.creating += missing;
+        params = state.params;
+        generation = state.generation;
+    }
+
+    // Attach the missing connections side by side, not one round trip each.
+    std::vector<std::unique_ptr<core::Connection>> opened;
+    try {
+        opened = core::Connection::connectMany(params, missing);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.total -= missing;
+        state.creating -= missing;
+        state.available.notify_all();
+        throw;
+    }
+
+    std::vector<std::unique_ptr<core::Connection>> closing;
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.creating -= missing;
+    for (auto& connection : opened) {
+        ++state.stats.created;
+        if (auto dropped = state.giveBack(std::move(connection), true, generation)) {
+            closing.push_back(std::move(dropped));
+        }
+    }
+}
+
+void ConnectionPool::reaperLoop() {
+    auto& state = *state_;
+    std::unique_lock<std::mutex> lock(state.mutex);
+    while (!state.shutdown) {
+        state.stopping.wait_for(lock, options_.reapInterval, [&] { return state.shutdown; });
+        if (state.shutdown) {
+            break;
+        }
+        lock.unlock();
+        reapIdle();
+        try {
+            // Replace connections lost to failed validation or discard().
+            fillToMinimum();
+        } catch (const std::exception& e) {
+            fbpp::util::trace(fbpp::util::TraceLevel::error, "ConnectionPool",
+                        [&](auto& oss) { oss << "Refill failed: " << e.what(); });
+        }
+        lock.lock();
+    }
+}
+
+size_t ConnectionPool::resize(size_t minSize, size_t maxSize) {
+    checkBounds(minSize, maxSize, options_);
+
+    auto& state = *state_;
+    std::vector<std::unique_ptr<core::Connection>> closing;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (state.shutdown) {
+            throw core::FirebirdException("ConnectionPool is shut down");
+        }
+        state.minSize = minSize;
+        state.maxSize = maxSize;
+        state.limit = options_.adaptiveLimit.enabled
+                          ? std::min(state.limit, static_cast<double>(maxSize))
+                          : static_cast<double>(maxSize);
+        // Front is the longest idle.
+        while (!state.idle.empty() && state.total > maxSize) {
+            closing.push_back(std::move(state.idle.front().connection));
+            state.idle.pop_front();
+            --state.total;
+        }
+        ++state.stats.resizes;
+        state.available.notify_all();
+    }
+    const size_t closed = closing.size();
+    closing.clear();
+    fbpp::util::trace(fbpp::util::TraceLevel::info, "ConnectionPool",
+                [&](auto& oss) {
+                    oss << "Resized to " << minSize << ".." << maxSize << ", closed " << closed
+                        << " idle";
+                });
+
+    fillToMinimum();
+    return closed;
+}
+
+void ConnectionPool::setConnectionOptions(const core::ConnectionOptions& options) {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->params.options = options;
+    ++state_->generation;
+    ++state_->stats.optionsUpdates;
+}
+
+size_t ConnectionPool::minSize() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->minSize;
+}
+
+size_t ConnectionPool::maxSize() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->maxSize;
+}
+
+core::ConnectionOptions ConnectionPool::connectionOptions() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->params.options;
+}
+
+ConnectionPoolStats ConnectionPool::stats() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    ConnectionPoolStats stats = state_->stats;
+    stats.total = state_->total;
+    stats.idle = state_->idle.size();
+    stats.leased = state_->total - state_->idle.size();
+    stats.creating = state_->creating;
+    stats.limit = state_->currentLimit();
+    stats.checkoutWait = state_->checkoutWait.snapshot();
+    stats.leaseDuration = state_->leaseDuration.snapshot();
+    stats.utilization = state_->utilization.snapshot();
+    for (size_t lane = 0; lane < kPoolPriorities; ++lane) {
+        stats.lanes[lane].leased = state_->leased[lane];
+        stats.lanes[lane].waiting = state_->waiting[lane];
+        stats.lanes[lane].queueWait = state_->queueWait[lane].snapshot();
+    }
+    return stats;
+}
+
+} // namespace fbpp::pool
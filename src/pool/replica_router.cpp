@@ -0,0 +1,352 @@
+#include "fbpp/pool/replica_router.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp_util/trace.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <tuple>
+#include <utility>
+
+namespace fbpp::pool {
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// Beats remembered for lag lookups; older ones count as the oldest kept
+constexpr size_t kBeatHistory = 1024;
+
+} // namespace
+
+namespace detail {
+
+// Counters of one node; shared with its leases
+struct RouteNode {
+    std::atomic<size_t> outstanding{0};
+    std::atomic<uint64_t> routed{0};
+    std::atomic<bool> healthy{true};
+    std::atomic<int64_t> lagMs{-1};   // -1 = not measured
+};
+
+struct RouterState {
+    size_t maxSize = 0;
+    std::unique_ptr<ConnectionPool> primaryPool;
+    std::shared_ptr<RouteNode> primary = std::make_shared<RouteNode>();
+    std::vector<std::unique_ptr<ConnectionPool>> replicaPools;
+    std::vector<std::shared_ptr<RouteNode>> replicas;
+    std::atomic<size_t> rotation{0};
+    std::atomic<uint64_t> primaryFallbacks{0};
+    std::atomic<uint64_t> checks{0};
+
+    // One check at a time; guards the heartbeat fields
+    std::mutex checkMutex;
+    bool heartbeatReady = false;
+    int64_t lastBeat = 0;
+    std::deque<std::pair<int64_t, Clock::time_point>> beats;   // Ascending
+
+    std::mutex mutex;
+    std::condition_variable stopping;   // Wakes the checker on shutdown only
+    bool shutdown = false;
+};
+
+} // namespace detail
+
+// RoutedLease
+
+RoutedLease::RoutedLease(ConnectionLease lease, std::shared_ptr<detail::RouteNode> node,
+                         std::optional<size_t> replica)
+    : lease_(std::move(lease)), node_(std::move(node)), replica_(replica) {}
+
+RoutedLease::~RoutedLease() {
+    try {
+        release();
+    } catch (...) {
+        // Suppress exceptions in destructor
+    }
+}
+
+RoutedLease& RoutedLease::operator=(RoutedLease&& other) noexcept {
+    if (this != &other) {
+        try {
+            release();
+        } catch (...) {
+        }
+        lease_ = std::move(other.lease_);
+        node_ = std::move(other.node_);
+        replica_ = other.replica_;
+    }
+    return *this;
+}
+
+void RoutedLease::release() {
+    lease_.release();
+    finish();
+}
+
+void RoutedLease::discard() {
+    lease_.discard();
+    finish();
+}
+
+void RoutedLease::finish() noexcept {
+    if (node_) {
+        node_->outstanding.fetch_sub(1, std::memory_order_relaxed);
+        node_.reset();
+    }
+}
+
+// ReplicaRouter
+
+ReplicaRouter::ReplicaRouter(core::ConnectionParams primary,
+                             std::vector<core::ConnectionParams> replicas, size_t minSize,
+                             size_t maxSize, ReplicaRouterOptions options)
+    : state_(std::make_shared<detail::RouterState>()), options_(std::move(options)) {
+    auto& state = *state_;
+    state.maxSize = maxSize;
+    state.primaryPool =
+        std::make_unique<ConnectionPool>(std::move(primary), minSize, maxSize, options_.pool);
+    for (size_t i = 0; i < replicas.size(); ++i) {
+        auto node = std::make_shared<detail::RouteNode>();
+        std::unique_ptr<ConnectionPool> pool;
+        try {
+            pool = std::make_unique<ConnectionPool>(replicas[i], minSize, maxSize, options_.pool);
+        } catch (const std::exception& e) {
+            // Down for now: an empty pool, retried by the checks
+            fbpp::util::trace(fbpp::util::TraceLevel::warn, "ReplicaRouter", [&](auto& oss) {
+                oss << "Replica " << i << " unavailable: " << e.what();
+            });
+            pool = std::make_unique<ConnectionPool>(replicas[i], 0, maxSize, options_.pool);
+            node->healthy.store(false, std::memory_order_relaxed);
+        }
+        state.replicaPools.push_back(std::move(pool));
+        state.replicas.push_back(std::move(node));
+    }
+
+    if (!state.replicas.empty()) {
+        checkReplicas();
+        if (options_.checkInterval.count() > 0) {
+            checker_ = std::thread([this] { checkLoop(); });
+        }
+    }
+}
+
+ReplicaRouter::~ReplicaRouter() {
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->shutdown = true;
+        state_->stopping.notify_all();
+    }
+    if (checker_.joinable()) {
+        checker_.join();
+    }
+    // Outstanding leases outlive their pools like ConnectionLease does.
+}
+
+RoutedLease ReplicaRouter::acquire(const core::TransactionOptions& options) {
+    return options.readOnly ? acquireReplica() : acquirePrimary();
+}
+
+RoutedLease ReplicaRouter::acquirePrimary() {
+    auto& state = *state_;
+    ConnectionLease lease = state.primaryPool->acquire();
+    state.primary->outstanding.fetch_add(1, std::memory_order_relaxed);
+    state.primary->routed.fetch_add(1, std::memory_order_relaxed);
+    return RoutedLease(std::move(lease), state.primary, std::nullopt);
+}
+
+RoutedLease ReplicaRouter::acquireReplica() {
+    auto& state = *state_;
+    const size_t count = state.replicas.size();
+    std::vector<bool> tried(count, false);
+    for (size_t attempt = 0; attempt < count; ++attempt) {
+        // Least outstanding among the healthy ones; the rotating start breaks ties
+        const size_t start = state.rotation.fetch_add(1, std::memory_order_relaxed);
+        size_t best = count;
+        size_t bestLoad = 0;
+        for (size_t k = 0; k < count; ++k) {
+            const size_t i = (start + k) % count;
+            const auto& node = *state.replicas[i];
+            if (tried[i] || !node.healthy.load(std::memory_order_relaxed)) {
+                continue;
+            }
+            const size_t load = node.outstanding.load(std::memory_order_relaxed);
+            if (best == count || load < bestLoad) {
+                best = i;
+                bestLoad = load;
+            }
+        }
+        if (best == count) {
+            break;
+        }
+        tried[best] = true;
+
+        auto& node = state.replicas[best];
+        // Counted before the checkout so concurrent callers spread out
+        node->outstanding.fetch_add(1, std::memory_order_relaxed);
+        try {
+            ConnectionLease lease = state.replicaPools[best]->acquire();
+            node->routed.fetch_add(1, std::memory_order_relaxed);
+            return RoutedLease(std::move(lease), node, best);
+        } catch (const std::exception& e) {
+            node->outstanding.fetch_sub(1, std::memory_order_relaxed);
+            // A full pool is busy, not broken
+            if (state.replicaPools[best]->stats().total < state.maxSize) {
+                node->healthy.store(false, std::memory_order_relaxed);
+                fbpp::util::trace(fbpp::util::TraceLevel::warn, "ReplicaRouter", [&](auto& oss) {
+                    oss << "Replica " << best << " failed: " << e.what();
+                });
+            }
+        }
+    }
+
+    if (!options_.primaryFallback) {
+        throw core::FirebirdException("ReplicaRouter: no healthy replica among " +
+                                      std::to_string(count));
+    }
+    state.primaryFallbacks.fetch_add(1, std::memory_order_relaxed);
+    return acquirePrimary();
+}
+
+size_t ReplicaRouter::checkReplicas() {
+    auto& state = *state_;
+    std::lock_guard<std::mutex> lock(state.checkMutex);
+    state.checks.fetch_add(1, std::memory_order_relaxed);
+
+    const std::string& table = options_.heartbeatTable;
+    const std::string readBeat = "SELECT BEAT FROM " + table + " WHERE ID = 1";
+    auto beatOf = [&](core::Connection& connection) {
+        auto tx = connection.StartTransaction(core::TransactionOptions::readOnlyReadCommitted());
+        auto cursor = tx->openCursor(connection.prepareStatement(readBeat));
+        std::tuple<int64_t> row{0};
+        cursor->fetch(row);
+        cursor->close();
+        tx->Commit();
+        return std::get<0>(row);
+    };
+
+    // Heartbeat on the primary; without one, replicas are only pinged
+    bool measure = false;
+    if (!table.empty()) {
+        try {
+            auto lease = state.primaryPool->acquire();
+            if (!state.heartbeatReady) {
+                auto tx = lease->StartTransaction();
+                auto cursor = tx->openCursor(lease->prepareStatement(
+                    "SELECT 1 FROM RDB$RELATIONS WHERE RDB$RELATION_NAME = '" + table + "'"));
+                std::tuple<int32_t> exists;
+                const bool found = cursor->fetch(exists);
+                cursor->close();
+                tx->Commit();
+                if (!found) {
+                    lease->ExecuteDDL("CREATE TABLE " + table +
+                                      " (ID SMALLINT NOT NULL PRIMARY KEY, BEAT BIGINT NOT NULL)");
+                }
+                state.lastBeat = beatOf(*lease);
+                state.heartbeatReady = true;
+            }
+            const int64_t beat = state.lastBeat + 1;
+            auto tx = lease->StartTransaction();
+            tx->execute(lease->prepareStatement("UPDATE OR INSERT INTO " + table +
+                                                " (ID, BEAT) VALUES (1, ?) MATCHING (ID)"),
+                        std::make_tuple(beat));
+            tx->Commit();
+            state.lastBeat = beat;
+            state.beats.emplace_back(beat, Clock::now());
+            if (state.beats.size() > kBeatHistory) {
+                state.beats.pop_front();
+            }
+            measure = true;
+        } catch (const std::exception& e) {
+            fbpp::util::trace(fbpp::util::TraceLevel::warn, "ReplicaRouter",
+                              [&](auto& oss) { oss << "Heartbeat failed: " << e.what(); });
+        }
+    }
+
+    size_t healthy = 0;
+    for (size_t i = 0; i < state.replicas.size(); ++i) {
+        auto& node = *state.replicas[i];
+        try {
+            auto lease = state.replicaPools[i]->tryAcquire();
+            if (!lease) {
+                // Every connection leased: busy, keep the last verdict
+                healthy += node.healthy.load(std::memory_order_relaxed) ? 1 : 0;
+                continue;
+            }
+            bool ok = lease->isConnected();
+            if (ok && measure) {
+                const int64_t seen = beatOf(*lease);
+                const auto now = Clock::now();
+                auto lag = Clock::duration::zero();
+                if (seen < state.lastBeat) {
+                    // Time since the first beat the replica has not shown
+                    auto first = state.beats.begin();
+                    while (first != state.beats.end() && first->first <= seen) {
+                        ++first;
+                    }
+                    lag = now - (first != state.beats.end() ? first->second
+                                                            : state.beats.front().second);
+                }
+                const auto lagMs = std::chrono::duration_cast<std::chrono::milliseconds>(lag);
+                node.lagMs.store(lagMs.count(), std::memory_order_relaxed);
+                ok = lagMs <= options_.maxLag;
+            }
+            node.healthy.store(ok, std::memory_order_relaxed);
+        } catch (const std::exception& e) {
+            node.healthy.store(false, std::memory_order_relaxed);
+            fbpp::util::trace(fbpp::util::TraceLevel::warn, "ReplicaRouter", [&](auto& oss) {
+                oss << "Replica " << i << " check failed: " << e.what();
+            });
+        }
+        if (node.healthy.load(std::memory_order_relaxed)) {
+            ++healthy;
+        }
+    }
+    return healthy;
+}
+
+void ReplicaRouter::checkLoop() {
+    auto& state = *state_;
+    std::unique_lock<std::mutex> lock(state.mutex);
+    while (!state.shutdown) {
+        state.stopping.wait_for(lock, options_.checkInterval, [&] { return state.shutdown; });
+        if (state.shutdown) {
+            break;
+        }
+        lock.unlock();
+        checkReplicas();
+        lock.lock();
+    }
+}
+
+size_t ReplicaRouter::replicaCount() const noexcept {
+    return state_->replicas.size();
+}
+
+ReplicaRouterStats ReplicaRouter::stats() const {
+    auto snapshot = [](const detail::RouteNode& node) {
+        ReplicaNodeStats stats;
+        stats.healthy = node.healthy.load(std::memory_order_relaxed);
+        stats.outstanding = node.outstanding.load(std::memory_order_relaxed);
+        stats.routed = node.routed.load(std::memory_order_relaxed);
+        const int64_t lag = node.lagMs.load(std::memory_order_relaxed);
+        if (lag >= 0) {
+            stats.lag = std::chrono::milliseconds(lag);
+        }
+        return stats;
+    };
+    ReplicaRouterStats stats;
+    stats.primary = snapshot(*state_->primary);
+    for (const auto& node : state_->replicas) {
+        stats.replicas.push_back(snapshot(*node));
+    }
+    stats.primaryFallbacks = state_->primaryFallbacks.load(std::memory_order_relaxed);
+    stats.checks = state_->checks.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace fbpp::pool
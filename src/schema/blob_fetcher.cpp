@@ -0,0 +1,166 @@
+#include "fbpp/schema/blob_fetcher.hpp"
+
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/message_metadata.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction_options.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+
+namespace fbpp::schema {
+
+using fbpp::core::Connection;
+using fbpp::core::FirebirdException;
+using fbpp::core::RowView;
+using fbpp::core::Transaction;
+using fbpp::core::TransactionOptions;
+using fbpp::core::TxIsolation;
+
+namespace {
+
+// Snapshot number of `source`, if the server reports one
+std::optional<std::uint64_t> snapshotOf(Transaction& source) {
+    Connection* connection = source.getConnection();
+    if (!connection || connection->getEngineMajorVersion() < 4) {
+        return std::nullopt;
+    }
+    try {
+        auto cursor = source.openCursor(connection->prepareStatement(
+            "SELECT RDB$GET_CONTEXT('SYSTEM', 'SNAPSHOT_NUMBER') FROM RDB$DATABASE"));
+        std::tuple<std::optional<std::string>> row;
+        std::optional<std::uint64_t> number;
+        if (cursor->fetch(row) && std::get<0>(row) && !std::get<0>(row)->empty()) {
+            number = std::stoull(*std::get<0>(row));
+        }
+        cursor->close();
+        return number;
+    } catch (const std::exception&) {
+        return std::nullopt;   // Independent snapshots; reported through snapshotNumber
+    }
+}
+
+} // namespace
+
+bool BlobFetchResult::ok() const {
+    return std::all_of(workers.begin(), workers.end(),
+                       [](const BlobFetchWorker& w) { return w.error.empty(); });
+}
+
+BlobFetcher::BlobFetcher(ConnectionFactory factory, BlobFetchOptions options)
+    : factory_(std::move(factory)), options_(options) {
+    if (!factory_) {
+        throw FirebirdException("BlobFetcher: connection factory required");
+    }
+    if (options_.connections == 0) {
+        throw FirebirdException("BlobFetcher: at least one connection required");
+    }
+}
+
+BlobFetcher::BlobFetcher(const fbpp::core::ConnectionParams& params, BlobFetchOptions options)
+    : BlobFetcher([params] { return std::make_unique<Connection>(params); }, options) {}
+
+std::optional<ISC_QUAD> BlobFetcher::blobId(const RowView& row, unsigned index) {
+    const auto& metadata = row.metadata();
+    if (index >= metadata.getCount()) {
+        throw FirebirdException("BlobFetcher: column " + std::to_string(index) + " out of range");
+    }
+    const auto& field = metadata.getFieldRef(index);
+    if ((field.type & ~1u) != SQL_BLOB) {
+        throw FirebirdException("BlobFetcher: column " + row.columnName(index) + " is not a BLOB");
+    }
+    int16_t null = 0;
+    std::memcpy(&null, row.data() + field.nullOffset, sizeof(null));
+    if (null != 0) {
+        return std::nullopt;
+    }
+    ISC_QUAD id;
+    std::memcpy(&id, row.data() + field.offset, sizeof(id));
+    return id;
+}
+
+std::vector<std::optional<ISC_QUAD>> BlobFetcher::collectIds(fbpp::core::ResultSet& cursor,
+                                                             unsigned index) {
+    std::vector<std::optional<ISC_QUAD>> ids;
+    for (const auto& view : cursor.rows()) {
+        ids.push_back(blobId(view, index));
+    }
+    return ids;
+}
+
+BlobFetchResult BlobFetcher::fetch(Transaction& source,
+                                   std::span<const std::optional<ISC_QUAD>> ids,
+                                   const Sink& sink) {
+    if (!sink) {
+        throw FirebirdException("BlobFetcher::fetch: sink required");
+    }
+    if (!source.isActive()) {
+        throw FirebirdException("BlobFetcher::fetch: source transaction is not active");
+    }
+
+    const auto started = std::chrono::steady_clock::now();
+    BlobFetchResult result;
+    result.nulls = static_cast<std::uint64_t>(
+        std::count_if(ids.begin(), ids.end(), [](const auto& id) { return !id; }));
+    if (options_.shareSnapshot) {
+        result.snapshotNumber = snapshotOf(source);
+    }
+
+    TransactionOptions txOptions;
+    txOptions.isolation = TxIsolation::Concurrency;
+    txOptions.readOnly = true;
+    txOptions.atSnapshotNumber = result.snapshotNumber;
+
+    // No more workers than BLOBs to read
+    const std::size_t pending = ids.size() - static_cast<std::size_t>(result.nulls);
+    const std::size_t count = std::min<std::size_t>(options_.connections, pending);
+    result.workers.resize(count);
+
+    std::atomic<std::size_t> next{0};
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> threads;
+    threads.reserve(count);
+    for (std::size_t w = 0; w < count; ++w) {
+        threads.emplace_back([&, w] {
+            auto& worker = result.workers[w];
+            const auto workerStarted = std::chrono::steady_clock::now();
+            try {
+                auto connection = factory_();
+                auto tx = connection->StartTransaction(txOptions);
+                for (std::size_t i = next++; i < ids.size() && !stop; i = next++) {
+                    if (!ids[i]) {
+                        continue;
+                    }
+                    ISC_QUAD id = *ids[i];
+                    auto bytes = tx->loadBlob(&id);
+                    worker.bytes += bytes.size();
+                    sink(i, std::move(bytes));
+                    ++worker.blobs;
+                }
+                tx->Commit();
+            } catch (const std::exception& e) {
+                worker.error = e.what();
+                stop = true;
+            }
+            worker.elapsed = std::chrono::steady_clock::now() - workerStarted;
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    for (const auto& worker : result.workers) {
+        result.blobs += worker.blobs;
+        result.bytes += worker.bytes;
+    }
+    result.elapsed = std::chrono::steady_clock::now() - started;
+    return result;
+}
+
+} // namespace fbpp::schema
@@ -0,0 +1,274 @@
+#include "fbpp/schema/chunked_dml.hpp"
+
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/firebird_compat.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/schema/schema_inspector.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <tuple>
+
+namespace fbpp::schema {
+
+using fbpp::core::Connection;
+using fbpp::core::FirebirdException;
+using fbpp::core::Transaction;
+using fbpp::core::TransactionOptions;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::string toUpper(std::string_view s) {
+    std::string result(s);
+    std::transform(result.begin(), result.end(), result.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    return result;
+}
+
+bool isIntegerKey(const ColumnInfo& column) {
+    return column.scale == 0 &&
+           (column.sqlType == SQL_SHORT || column.sqlType == SQL_LONG || column.sqlType == SQL_INT64);
+}
+
+// Single-column integer primary key of `table`, or empty
+std::string primaryKey(Connection& connection, const std::string& table) {
+    const auto info = SchemaInspector(connection).getTableInfo(toUpper(table));
+    if (info.relationType == RelationType::unknown) {
+        throw FirebirdException("ChunkedDml: table not found: " + table);
+    }
+    for (const auto& constraint : info.constraints) {
+        if (constraint.type != ConstraintType::primary_key || constraint.columns.size() != 1) {
+            continue;
+        }
+        auto column = std::find_if(info.columns.begin(), info.columns.end(),
+                                   [&](const ColumnInfo& c) { return c.name == constraint.columns[0]; });
+        if (column != info.columns.end() && isIntegerKey(*column)) {
+            return column->name;
+        }
+    }
+    return {};
+}
+
+std::uint64_t clampKeys(std::uint64_t keys, const ChunkedDmlOptions& options) {
+    const std::uint64_t lo = std::max<std::uint64_t>(options.minChunkKeys, 1);
+    const std::uint64_t hi = std::max(options.maxChunkKeys, lo);
+    return std::clamp(keys, lo, hi);
+}
+
+} // namespace
+
+ChunkedDml::ChunkedDml(ConnectionFactory factory, std::string table, ChunkedDmlOptions options)
+    : factory_(std::move(factory)), table_(std::move(table)), options_(std::move(options)) {
+    if (!factory_) {
+        throw FirebirdException("ChunkedDml: connection factory required");
+    }
+    if (options_.connections == 0) {
+        throw FirebirdException("ChunkedDml: at least one connection required");
+    }
+    if (table_.empty()) {
+        throw FirebirdException("ChunkedDml: table required");
+    }
+    if (options_.pauseRatio < 0) {
+        throw FirebirdException("ChunkedDml: pauseRatio must not be negative");
+    }
+}
+
+ChunkedDml::ChunkedDml(const fbpp::core::ConnectionParams& params, std::string table,
+                       ChunkedDmlOptions options)
+    : ChunkedDml([params] { return std::make_unique<Connection>(params); },
+                 std::move(table), std::move(options)) {}
+
+ChunkedDmlResult ChunkedDml::deleteWhere(std::string_view where) {
+    return run("DELETE FROM " + table_, where);
+}
+
+ChunkedDmlResult ChunkedDml::update(std::string_view set, std::string_view where) {
+    if (set.empty()) {
+        throw FirebirdException("ChunkedDml::update: SET list required");
+    }
+    return run("UPDATE " + table_ + " SET " + std::string(set), where);
+}
+
+ChunkedDmlResult ChunkedDml::run(const std::string& head, std::string_view where) {
+    const auto started = Clock::now();
+    ChunkedDmlResult result;
+
+    // Key column, bounds and a test prepare on the coordinator
+    auto coordinator = factory_();
+    result.keyColumn = options_.keyColumn.empty() ? primaryKey(*coordinator, table_)
+                                                  : options_.keyColumn;
+    if (result.keyColumn.empty()) {
+        throw FirebirdException("ChunkedDml: " + table_ +
+                                " has no single-column integer primary key; set keyColumn");
+    }
+    const std::string& key = result.keyColumn;
+    std::string sql = head + " WHERE " + key + " BETWEEN CAST(? AS BIGINT) AND CAST(? AS BIGINT)";
+    if (!where.empty()) {
+        sql += " AND (" + std::string(where) + ")";
+    }
+    coordinator->prepareStatement(sql);
+
+    std::optional<std::int64_t> lo = options_.fromKey;
+    std::optional<std::int64_t> hi = options_.toKey;
+    if (!lo || !hi) {
+        auto tx = coordinator->StartTransaction(TransactionOptions::readOnlyReadCommitted());
+        auto cursor = tx->openCursor(coordinator->prepareStatement(
+            "SELECT CAST(MIN(" + key + ") AS BIGINT), CAST(MAX(" + key + ") AS BIGINT) FROM " +
+            table_));
+        std::tuple<std::optional<std::int64_t>, std::optional<std::int64_t>> bounds;
+        cursor->fetch(bounds);
+        cursor->close();
+        tx->Commit();
+        lo = lo ? lo : std::get<0>(bounds);
+        hi = hi ? hi : std::get<1>(bounds);
+    }
+    coordinator.reset();
+    if (!lo || !hi || *lo > *hi) {
+        result.elapsed = Clock::now() - started;
+        return result;   // No rows: nothing to do
+    }
+    result.firstKey = lo;
+    result.lastKey = hi;
+
+    // Consecutive ranges from a shared cursor; unset once all are handed out
+    std::mutex mutex;
+    std::optional<std::int64_t> next = lo;
+    bool stop = false;
+    fbpp::core::LatencyHistogram latency;
+
+    auto claim = [&](std::uint64_t keys) -> std::optional<std::pair<std::int64_t, std::int64_t>> {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stop || !next) {
+            return std::nullopt;
+        }
+        const std::int64_t first = *next;
+        const std::uint64_t left =
+            static_cast<std::uint64_t>(*hi) - static_cast<std::uint64_t>(first);
+        if (keys - 1 >= left) {
+            next.reset();
+            return std::make_pair(first, *hi);
+        }
+        const auto last = static_cast<std::int64_t>(static_cast<std::uint64_t>(first) + keys - 1);
+        next = last + 1;
+        return std::make_pair(first, last);
+    };
+
+    auto fail = [&](ChunkedDmlFailure failure) {
+        std::lock_guard<std::mutex> lock(mutex);
+        result.failures.push_back(std::move(failure));
+        stop = true;
+    };
+
+    const std::uint64_t firstKeys = clampKeys(options_.chunkKeys, options_);
+    const std::uint64_t span = static_cast<std::uint64_t>(*hi) - static_cast<std::uint64_t>(*lo);
+    const std::uint64_t chunksAtFirstSize = span / firstKeys + 1;
+    const unsigned workerCount =
+        static_cast<unsigned>(std::min<std::uint64_t>(options_.connections, chunksAtFirstSize));
+    const bool retaining = options_.commitMode == ChunkCommit::commitRetaining;
+
+    std::vector<std::thread> workers;
+    workers.reserve(workerCount);
+    for (unsigned w = 0; w < workerCount; ++w) {
+        workers.emplace_back([&, w] {
+            std::unique_ptr<Connection> connection;
+            std::shared_ptr<fbpp::core::Statement> statement;
+            try {
+                connection = factory_();
+                statement = connection->prepareStatement(sql);
+            } catch (const std::exception& e) {
+                fail({w, std::nullopt, std::nullopt, e.what()});
+                return;
+            }
+
+            std::shared_ptr<Transaction> tx;
+            std::uint64_t keys = firstKeys;
+            while (const auto range = claim(keys)) {
+                const auto chunkStarted = Clock::now();
+                ChunkedDmlChunk chunk{w, range->first, range->second, 0, {}};
+                try {
+                    if (!tx) {
+                        tx = connection->StartTransaction(options_.transaction);
+                    }
+                    chunk.rows =
+                        tx->execute(statement, std::make_tuple(range->first, range->second));
+                    if (retaining) {
+                        tx->CommitRetaining();
+                    } else {
+                        tx->Commit();
+                        tx.reset();
+                    }
+                } catch (const std::exception& e) {
+                    if (tx) {
+                        try {
+                            tx->Rollback();
+                        } catch (const std::exception&) {
+                            // The chunk's error is the one to report
+                        }
+                        tx.reset();
+                    }
+                    fail({w, range->first, range->second, e.what()});
+                    break;
+                }
+                chunk.elapsed = Clock::now() - chunkStarted;
+                latency.record(chunk.elapsed);
+
+                Clock::duration pause{};
+                if (options_.pauseRatio > 0) {
+                    pause = std::min<Clock::duration>(
+                        std::chrono::duration_cast<Clock::duration>(chunk.elapsed *
+                                                                    options_.pauseRatio),
+                        options_.maxPause);
+                }
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    result.rows += chunk.rows;
+                    ++result.chunks;
+                    result.paused += pause;
+                    if (progress_ && !stop && !progress_(chunk)) {
+                        result.stopped = true;
+                        stop = true;
+                    }
+                    if (stop) {
+                        break;
+                    }
+                }
+
+                if (options_.targetChunkTime.count() > 0) {
+                    if (chunk.elapsed > options_.targetChunkTime) {
+                        keys = clampKeys(keys / 2, options_);
+                    } else if (chunk.elapsed * 2 < options_.targetChunkTime) {
+                        keys = clampKeys(keys > UINT64_MAX / 2 ? UINT64_MAX : keys * 2, options_);
+                    }
+                }
+                if (pause.count() > 0) {
+                    std::this_thread::sleep_for(pause);
+                }
+            }
+
+            if (tx) {
+                try {
+                    tx->Commit();   // Ends the retained transaction; its chunks are committed
+                } catch (const std::exception& e) {
+                    fail({w, std::nullopt, std::nullopt, e.what()});
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    result.resumeFrom = next;
+    result.chunkLatency = latency.snapshot();
+    result.elapsed = Clock::now() - started;
+    return result;
+}
+
+} // namespace fbpp::schema
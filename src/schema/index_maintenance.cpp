@@ -0,0 +1,80 @@
+#include "fbpp/schema/index_maintenance.hpp"
+
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/schema/schema_inspector.hpp"
+
+#include <algorithm>
+
+namespace fbpp::schema {
+
+using fbpp::core::FirebirdException;
+
+namespace {
+
+// Names come from RDB$ tables as stored, so quote them verbatim
+std::string quoted(const std::string& name) {
+    std::string out = "\"";
+    for (char c : name) {
+        out += c;
+        if (c == '"') {
+            out += '"';
+        }
+    }
+    return out + "\"";
+}
+
+} // namespace
+
+std::vector<std::string> deactivateIndexes(fbpp::core::Connection& connection,
+                                           std::string_view table) {
+    const TableInfo info = SchemaInspector(connection).getTableInfo(table);
+    if (info.relationType == RelationType::unknown) {
+        throw FirebirdException("deactivateIndexes: no table " + std::string(table));
+    }
+    std::vector<std::string> parked;
+    for (const IndexInfo& index : info.indexes) {
+        const bool backsConstraint =
+            std::any_of(info.constraints.begin(), info.constraints.end(),
+                        [&](const ConstraintInfo& c) { return c.indexName == index.name; });
+        if (!index.active || backsConstraint) {
+            continue;
+        }
+        connection.ExecuteDDL("ALTER INDEX " + quoted(index.name) + " INACTIVE");
+        parked.push_back(index.name);
+    }
+    return parked;
+}
+
+void activateIndexes(fbpp::core::Connection& connection, const std::vector<std::string>& indexes) {
+    for (const std::string& index : indexes) {
+        connection.ExecuteDDL("ALTER INDEX " + quoted(index) + " ACTIVE");
+    }
+}
+
+std::vector<std::string> refreshIndexStatistics(fbpp::core::Connection& connection,
+                                                const std::vector<std::string>& tables) {
+    SchemaInspector inspector(connection);
+    std::vector<TableInfo> infos;
+    if (tables.empty()) {
+        infos = inspector.getAllTables();
+    } else {
+        for (const std::string& table : tables) {
+            infos.push_back(inspector.getTableInfo(table));
+        }
+    }
+
+    std::vector<std::string> refreshed;
+    for (const TableInfo& info : infos) {
+        for (const IndexInfo& index : info.indexes) {
+            if (!index.active) {
+                continue;   // Inactive indexes keep no statistics
+            }
+            connection.ExecuteDDL("SET STATISTICS INDEX " + quoted(index.name));
+            refreshed.push_back(index.name);
+        }
+    }
+    return refreshed;
+}
+
+} // namespace fbpp::schema
@@ -0,0 +1,103 @@
+#include "fbpp/schema/keyset_pager.hpp"
+
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/message_metadata.hpp"
+#include "fbpp/schema/schema_inspector.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <optional>
+#include <string>
+
+namespace fbpp::schema {
+
+using fbpp::core::FirebirdException;
+
+namespace {
+
+std::string toUpper(std::string_view s) {
+    std::string result(s);
+    std::transform(result.begin(), result.end(), result.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    return result;
+}
+
+// K1 >= ? AND (K1 > ? OR (K1 = ? AND K2 > ?) OR ...), `op` '>' or '<'
+std::string keyPredicate(const std::vector<std::string>& key, char op) {
+    std::string predicate = key.front() + ' ' + op + "= ? AND (";
+    for (std::size_t i = 0; i < key.size(); ++i) {
+        predicate += i == 0 ? "" : " OR ";
+        std::string term;
+        for (std::size_t j = 0; j < i; ++j) {
+            term += key[j] + " = ? AND ";
+        }
+        term += key[i] + ' ' + op + " ?";
+        predicate += i == 0 ? term : "(" + term + ")";
+    }
+    return predicate + ")";
+}
+
+std::string orderBy(const std::vector<std::string>& key, bool descending) {
+    std::string order;
+    for (const auto& column : key) {
+        order += (order.empty() ? "" : ", ") + column + (descending ? " DESC" : "");
+    }
+    return " ORDER BY " + order;
+}
+
+} // namespace
+
+KeysetPlan::KeysetPlan(fbpp::core::Connection& connection, std::string table,
+                       const KeysetPagerOptions& options)
+    : table_(toUpper(table)),
+      pageRows_(options.pageRows > 0 ? options.pageRows : 1) {
+    for (const auto& column : options.key) {
+        key_.push_back(toUpper(column));
+    }
+    if (key_.empty()) {
+        const TableInfo info = SchemaInspector(connection).getTableInfo(table_);
+        if (info.relationType == RelationType::unknown) {
+            throw FirebirdException("KeysetPager: table " + table_ + " does not exist");
+        }
+        for (const auto& constraint : info.constraints) {
+            if (constraint.type == ConstraintType::primary_key) {
+                key_ = constraint.columns;
+            }
+        }
+        if (key_.empty()) {
+            throw FirebirdException("KeysetPager: table " + table_ +
+                                    " has no primary key; set KeysetPagerOptions::key");
+        }
+    }
+
+    const std::string select =
+        "SELECT " + (options.select.empty() ? "*" : options.select) + " FROM " + table_;
+    const std::string filter = options.where.empty() ? "" : "(" + options.where + ") AND ";
+    const std::string rows = " ROWS " + std::to_string(pageRows_);
+
+    const std::string all = options.where.empty() ? select : select + " WHERE " + options.where;
+    firstSql_ = all + orderBy(key_, false) + rows;
+    lastSql_ = all + orderBy(key_, true) + rows;
+    afterSql_ = select + " WHERE " + filter + keyPredicate(key_, '>') + orderBy(key_, false) +
+                rows;
+    beforeSql_ = select + " WHERE " + filter + keyPredicate(key_, '<') + orderBy(key_, true) +
+                 rows;
+
+    first_ = connection.prepareStatement(firstSql_);
+    last_ = connection.prepareStatement(lastSql_);
+    after_ = connection.prepareStatement(afterSql_);
+    before_ = connection.prepareStatement(beforeSql_);
+
+    const auto output = first_->getOutputMetadata();
+    for (const auto& column : key_) {
+        const std::optional<unsigned> index =
+            output ? output->getIndex(column) : std::nullopt;
+        if (!index) {
+            throw FirebirdException("KeysetPager: key column " + column +
+                                    " is not in the select list");
+        }
+        keyColumns_.push_back(*index);
+    }
+}
+
+} // namespace fbpp::schema
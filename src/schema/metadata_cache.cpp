@@ -0,0 +1,448 @@
+#include "fbpp/schema/metadata_cache.hpp"
+
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement_cache.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/transaction_options.hpp"
+#include "fbpp/schema/schema_inspector.hpp"
+#include "fbpp_util/trace.h"
+
+#include <nlohmann/json.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <tuple>
+
+namespace fbpp::schema {
+
+namespace {
+
+using nlohmann::json;
+namespace core = fbpp::core;
+
+constexpr int kFileVersion = 1;
+
+// The user relation count, then per system table a sum of row hashes over
+// user rows, so adds, drops and changes of the listed columns all show. MOD
+// keeps the sums far from BIGINT overflow; NULLs are folded to ''/0
+// because || with NULL yields NULL.
+constexpr const char* kFingerprintSql =
+    "SELECT"
+    " (SELECT COUNT(*) FROM RDB$RELATIONS WHERE RDB$SYSTEM_FLAG = 0),"
+    " (SELECT CAST(COALESCE(SUM(MOD(HASH(RDB$RELATION_NAME || ':' || COALESCE(RDB$FORMAT, 0)"
+    "     || ':' || COALESCE(RDB$RELATION_TYPE, 0)), 2147483647)), 0) AS BIGINT)"
+    "   FROM RDB$RELATIONS WHERE RDB$SYSTEM_FLAG = 0),"
+    " (SELECT CAST(COALESCE(SUM(MOD(HASH(RDB$RELATION_NAME || ':' || RDB$FIELD_NAME"
+    "     || ':' || COALESCE(RDB$FIELD_POSITION, 0) || ':' || COALESCE(RDB$FIELD_SOURCE, '')"
+    "     || ':' || COALESCE(RDB$NULL_FLAG, 0)), 2147483647)), 0) AS BIGINT)"
+    "   FROM RDB$RELATION_FIELDS WHERE COALESCE(RDB$SYSTEM_FLAG, 0) = 0),"
+    " (SELECT CAST(COALESCE(SUM(MOD(HASH(RDB$FIELD_NAME || ':' || COALESCE(RDB$FIELD_TYPE, 0)"
+    "     || ':' || COALESCE(RDB$FIELD_LENGTH, 0) || ':' || COALESCE(RDB$FIELD_SCALE, 0)"
+    "     || ':' || COALESCE(RDB$FIELD_SUB_TYPE, 0) || ':' || COALESCE(RDB$CHARACTER_SET_ID, 0)"
+    "     || ':' || COALESCE(RDB$NULL_FLAG, 0)), 2147483647)), 0) AS BIGINT)"
+    "   FROM RDB$FIELDS WHERE COALESCE(RDB$SYSTEM_FLAG, 0) = 0),"
+    " (SELECT CAST(COALESCE(SUM(MOD(HASH(RDB$INDEX_NAME || ':' || COALESCE(RDB$RELATION_NAME, '')"
+    "     || ':' || COALESCE(RDB$UNIQUE_FLAG, 0) || ':' || COALESCE(RDB$INDEX_INACTIVE, 0)"
+    "     || ':' || COALESCE(RDB$INDEX_TYPE, 0) || ':' || COALESCE(RDB$SEGMENT_COUNT, 0)),"
+    "     2147483647)), 0) AS BIGINT)"
+    "   FROM RDB$INDICES WHERE COALESCE(RDB$SYSTEM_FLAG, 0) = 0),"
+    " (SELECT CAST(COALESCE(SUM(MOD(HASH(RDB$CONSTRAINT_NAME || ':' || COALESCE(RDB$CONSTRAINT_TYPE, '')"
+    "     || ':' || COALESCE(RDB$RELATION_NAME, '') || ':' || COALESCE(RDB$INDEX_NAME, '')),"
+    "     2147483647)), 0) AS BIGINT)"
+    "   FROM RDB$RELATION_CONSTRAINTS),"
+    " (SELECT CAST(COALESCE(SUM(MOD(HASH(RDB$PROCEDURE_NAME || ':' || COALESCE(RDB$PACKAGE_NAME, '')"
+    "     || ':' || COALESCE(RDB$PROCEDURE_TYPE, 0)), 2147483647)), 0) AS BIGINT)"
+    "   FROM RDB$PROCEDURES WHERE COALESCE(RDB$SYSTEM_FLAG, 0) = 0),"
+    " (SELECT CAST(COALESCE(SUM(MOD(HASH(RDB$PROCEDURE_NAME || ':' || COALESCE(RDB$PACKAGE_NAME, '')"
+    "     || ':' || RDB$PARAMETER_NAME || ':' || COALESCE(RDB$PARAMETER_NUMBER, 0)"
+    "     || ':' || COALESCE(RDB$PARAMETER_TYPE, 0) || ':' || COALESCE(RDB$FIELD_SOURCE, '')"
+    "     || ':' || COALESCE(RDB$NULL_FLAG, 0)), 2147483647)), 0) AS BIGINT)"
+    "   FROM RDB$PROCEDURE_PARAMETERS WHERE COALESCE(RDB$SYSTEM_FLAG, 0) = 0),"
+    " (SELECT CAST(COALESCE(SUM(MOD(HASH(RDB$FUNCTION_NAME || ':' || COALESCE(RDB$PACKAGE_NAME, '')"
+    "     || ':' || COALESCE(RDB$ARGUMENT_POSITION, 0) || ':' || COALESCE(RDB$FIELD_SOURCE, '')"
+    "     || ':' || COALESCE(RDB$FIELD_TYPE, 0) || ':' || COALESCE(RDB$NULL_FLAG, 0)),"
+    "     2147483647)), 0) AS BIGINT)"
+    "   FROM RDB$FUNCTION_ARGUMENTS WHERE COALESCE(RDB$SYSTEM_FLAG, 0) = 0)"
+    " FROM RDB$DATABASE";
+
+std::string procedureKey(const std::string& name, const std::string& packageName) {
+    return packageName.empty() ? name : packageName + "." + name;
+}
+
+// ---- JSON mapping --------------------------------------------------------
+
+json toJson(const core::FieldInfo& f) {
+    return {{"name", f.name}, {"relation", f.relation}, {"owner", f.owner}, {"alias", f.alias},
+            {"type", f.type}, {"nullable", f.nullable}, {"subType", f.subType},
+            {"length", f.length}, {"scale", f.scale}, {"charSet", f.charSet},
+            {"offset", f.offset}, {"nullOffset", f.nullOffset}};
+}
+
+core::FieldInfo fieldFromJson(const json& j) {
+    core::FieldInfo f;
+    f.name       = j.at("name").get<std::string>();
+    f.relation   = j.at("relation").get<std::string>();
+    f.owner      = j.at("owner").get<std::string>();
+    f.alias      = j.at("alias").get<std::string>();
+    f.type       = j.at("type").get<unsigned>();
+    f.nullable   = j.at("nullable").get<bool>();
+    f.subType    = j.at("subType").get<unsigned>();
+    f.length     = j.at("length").get<unsigned>();
+    f.scale      = j.at("scale").get<int>();
+    f.charSet    = j.at("charSet").get<unsigned>();
+    f.offset     = j.at("offset").get<unsigned>();
+    f.nullOffset = j.at("nullOffset").get<unsigned>();
+    return f;
+}
+
+json toJson(const std::vector<core::FieldInfo>& fields) {
+    json out = json::array();
+    for (const auto& field : fields) {
+        out.push_back(toJson(field));
+    }
+    return out;
+}
+
+std::vector<core::FieldInfo> fieldsFromJson(const json& j) {
+    std::vector<core::FieldInfo> fields;
+    for (const auto& item : j) {
+        fields.push_back(fieldFromJson(item));
+    }
+    return fields;
+}
+
+json toJson(const core::ProcedureInfo& p) {
+    json params = json::array();
+    for (const auto& param : p.params) {
+        params.push_back({{"name", param.name},
+                          {"output", param.direction == core::ParamDirection::Output},
+                          {"position", param.position},
+                          {"field", toJson(param.field)}});
+    }
+    return {{"name", p.name}, {"package", p.packageName}, {"kind", static_cast<int>(p.kind)},
+            {"params", std::move(params)}};
+}
+
+core::ProcedureInfo procedureFromJson(const json& j) {
+    core::ProcedureInfo p;
+    p.name        = j.at("name").get<std::string>();
+    p.packageName = j.at("package").get<std::string>();
+    p.kind        = static_cast<core::ProcedureKind>(j.at("kind").get<int>());
+    for (const auto& item : j.at("params")) {
+        core::ProcedureParamInfo param;
+        param.procedureName = p.name;
+        param.packageName   = p.packageName;
+        param.name          = item.at("name").get<std::string>();
+        param.direction     = item.at("output").get<bool>() ? core::ParamDirection::Output
+                                                            : core::ParamDirection::Input;
+        param.position      = item.at("position").get<unsigned>();
+        param.field         = fieldFromJson(item.at("field"));
+        p.params.push_back(std::move(param));
+    }
+    return p;
+}
+
+json toJson(const TableInfo& t) {
+    json columns = json::array();
+    for (const auto& c : t.columns) {
+        columns.push_back({{"name", c.name}, {"position", c.position}, {"sqlType", c.sqlType},
+                           {"scale", c.scale}, {"length", c.length}, {"charsetId", c.charsetId},
+                           {"subType", c.subType}, {"notNull", c.notNull}, {"computed", c.computed}});
+    }
+    json indexes = json::array();
+    for (const auto& i : t.indexes) {
+        json segments = json::array();
+        for (const auto& s : i.segments) {
+            segments.push_back({{"column", s.columnName}, {"position", s.position}});
+        }
+        indexes.push_back({{"name", i.name}, {"unique", i.unique}, {"active", i.active},
+                           {"descending", i.sortOrder == SortOrder::descending},
+                           {"segments", std::move(segments)}});
+    }
+    json constraints = json::array();
+    for (const auto& c : t.constraints) {
+        json item = {{"name", c.name}, {"type", static_cast<int>(c.type)},
+                     {"index", c.indexName}, {"columns", c.columns}};
+        if (c.foreignKey) {
+            item["foreignKey"] = {{"table", c.foreignKey->referencedTable},
+                                  {"index", c.foreignKey->referencedIndex},
+                                  {"update", c.foreignKey->updateRule},
+                                  {"delete", c.foreignKey->deleteRule}};
+        }
+        constraints.push_back(std::move(item));
+    }
+    return {{"name", t.name}, {"relationType", static_cast<int>(t.relationType)},
+            {"columns", std::move(columns)}, {"indexes", std::move(indexes)},
+            {"constraints", std::move(constraints)}};
+}
+
+TableInfo tableFromJson(const json& j) {
+    TableInfo t;
+    t.name         = j.at("name").get<std::string>();
+    t.relationType = static_cast<RelationType>(j.at("relationType").get<int>());
+    for (const auto& item : j.at("columns")) {
+        ColumnInfo c;
+        c.name      = item.at("name").get<std::string>();
+        c.position  = item.at("position").get<int>();
+        c.sqlType   = item.at("sqlType").get<int16_t>();
+        c.scale     = item.at("scale").get<int>();
+        c.length    = item.at("length").get<int>();
+        c.charsetId = item.at("charsetId").get<int>();
+        c.subType   = item.at("subType").get<int>();
+        c.notNull   = item.at("notNull").get<bool>();
+        c.computed  = item.at("computed").get<bool>();
+        t.columns.push_back(std::move(c));
+    }
+    for (const auto& item : j.at("indexes")) {
+        IndexInfo i;
+        i.name      = item.at("name").get<std::string>();
+        i.unique    = item.at("unique").get<bool>();
+        i.active    = item.at("active").get<bool>();
+        i.sortOrder = item.at("descending").get<bool>() ? SortOrder::descending : SortOrder::ascending;
+        for (const auto& segment : item.at("segments")) {
+            i.segments.push_back({segment.at("column").get<std::string>(),
+                                  segment.at("position").get<int>()});
+        }
+        t.indexes.push_back(std::move(i));
+    }
+    for (const auto& item : j.at("constraints")) {
+        ConstraintInfo c;
+        c.name      = item.at("name").get<std::string>();
+        c.type      = static_cast<ConstraintType>(item.at("type").get<int>());
+        c.indexName = item.at("index").get<std::string>();
+        c.columns   = item.at("columns").get<std::vector<std::string>>();
+        if (item.contains("foreignKey")) {
+            const auto& fk = item.at("foreignKey");
+            c.foreignKey = ForeignKeyInfo{fk.at("table").get<std::string>(),
+                                          fk.at("index").get<std::string>(),
+                                          fk.at("update").get<std::string>(),
+                                          fk.at("delete").get<std::string>()};
+        }
+        t.constraints.push_back(std::move(c));
+    }
+    return t;
+}
+
+} // namespace
+
+MetadataCache::MetadataCache(fbpp::core::Connection& connection, std::string path)
+    : connection_(connection)
+    , path_(std::move(path))
+    , fingerprint_(schemaFingerprint(connection)) {
+    load();
+}
+
+std::string MetadataCache::schemaFingerprint(fbpp::core::Connection& connection) {
+    core::TransactionOptions options;
+    options.readOnly = true;
+    auto transaction = connection.StartTransaction(options);
+    auto stmt = connection.prepareStatementUncached(kFingerprintSql);
+    auto rs = transaction->openCursor(stmt);
+
+    std::tuple<int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t> row{};
+    const bool found = rs->fetch(row);
+    rs->close();
+    transaction->Commit();
+    if (!found) {
+        throw std::runtime_error("MetadataCache: schema fingerprint query returned no row");
+    }
+
+    std::string out = "v1";
+    std::apply([&](auto... values) {
+        char buffer[24];
+        ((std::snprintf(buffer, sizeof(buffer), "-%llx",
+                        static_cast<unsigned long long>(values)), out += buffer), ...);
+    }, row);
+    return out;
+}
+
+void MetadataCache::load() {
+    std::error_code ec;
+    if (!std::filesystem::exists(path_, ec)) {
+        dirty_ = true;   // First start: nothing saved yet
+        return;
+    }
+
+    try {
+        std::ifstream in(path_, std::ios::binary);
+        const auto doc = json::parse(in);
+        if (doc.at("version").get<int>() != kFileVersion ||
+            doc.at("scope").get<std::string>() != connection_.getTemplateScope() ||
+            doc.at("fingerprint").get<std::string>() != fingerprint_) {
+            fbpp::util::trace(fbpp::util::TraceLevel::info, "MetadataCache",
+                        [&](auto& oss) { oss << "Schema changed since " << path_ << " was written"; });
+            dirty_ = true;
+            return;
+        }
+
+        for (const auto& item : doc.at("queries")) {
+            QueryEntry entry;
+            entry.sql = item.at("sql").get<std::string>();
+            entry.info.inputFields = fieldsFromJson(item.at("in"));
+            entry.info.outputFields = fieldsFromJson(item.at("out"));
+            const auto hash = core::SqlKey::hashOf(entry.sql, 0);
+            queries_.emplace(hash, std::move(entry));
+        }
+        if (doc.contains("procedures")) {
+            std::vector<core::ProcedureInfo> procedures;
+            for (const auto& item : doc.at("procedures")) {
+                procedures.push_back(procedureFromJson(item));
+            }
+            procedures_ = std::move(procedures);
+        }
+        for (const auto& item : doc.at("described")) {
+            auto info = procedureFromJson(item);
+            described_.emplace(procedureKey(info.name, info.packageName), std::move(info));
+        }
+        if (doc.contains("tables")) {
+            std::vector<TableInfo> tables;
+            for (const auto& item : doc.at("tables")) {
+                tables.push_back(tableFromJson(item));
+            }
+            tables_ = std::move(tables);
+        }
+        stats_.warm = true;
+    } catch (const std::exception& e) {
+        // A damaged cache only costs a cold start
+        fbpp::util::trace(fbpp::util::TraceLevel::warn, "MetadataCache",
+                    [&](auto& oss) { oss << "Ignoring metadata cache " << path_ << ": " << e.what(); });
+        queries_.clear();
+        procedures_.reset();
+        described_.clear();
+        tables_.reset();
+        dirty_ = true;
+    }
+}
+
+fbpp::core::Connection::QueryMetadataInfo MetadataCache::describeQuery(const std::string& sql) {
+    const auto hash = core::SqlKey::hashOf(sql, 0);
+    auto [first, last] = queries_.equal_range(hash);
+    for (auto it = first; it != last; ++it) {
+        if (core::SqlKey::equivalent(it->second.sql, sql)) {
+            ++stats_.hits;
+            return it->second.info;
+        }
+    }
+    ++stats_.misses;
+    QueryEntry entry{sql, connection_.describeQuery(sql)};
+    auto info = entry.info;
+    queries_.emplace(hash, std::move(entry));
+    dirty_ = true;
+    return info;
+}
+
+std::vector<fbpp::core::ProcedureInfo> MetadataCache::listProcedures() {
+    if (procedures_) {
+        ++stats_.hits;
+        return *procedures_;
+    }
+    ++stats_.misses;
+    procedures_ = connection_.listProcedures();
+    dirty_ = true;
+    return *procedures_;
+}
+
+fbpp::core::ProcedureInfo MetadataCache::describeProcedure(const std::string& name,
+                                                           const std::string& packageName) {
+    const std::string key = procedureKey(name, packageName);
+    auto it = described_.find(key);
+    if (it != described_.end()) {
+        ++stats_.hits;
+        return it->second;
+    }
+    ++stats_.misses;
+    auto info = connection_.describeProcedure(name, packageName);
+    described_.emplace(key, info);
+    dirty_ = true;
+    return info;
+}
+
+std::vector<TableInfo> MetadataCache::getAllTables() {
+    if (tables_) {
+        ++stats_.hits;
+        return *tables_;
+    }
+    ++stats_.misses;
+    tables_ = SchemaInspector(connection_).getAllTables();
+    dirty_ = true;
+    return *tables_;
+}
+
+void MetadataCache::save() {
+    if (!dirty_) {
+        return;
+    }
+
+    json queries = json::array();
+    for (const auto& [hash, entry] : queries_) {
+        queries.push_back({{"sql", entry.sql},
+                           {"in", toJson(entry.info.inputFields)},
+                           {"out", toJson(entry.info.outputFields)}});
+    }
+    json described = json::array();
+    for (const auto& [key, info] : described_) {
+        described.push_back(toJson(info));
+    }
+    json doc = {{"version", kFileVersion},
+                {"scope", connection_.getTemplateScope()},
+                {"fingerprint", fingerprint_},
+                {"queries", std::move(queries)},
+                {"described", std::move(described)}};
+    if (procedures_) {
+        json procedures = json::array();
+        for (const auto& info : *procedures_) {
+            procedures.push_back(toJson(info));
+        }
+        doc["procedures"] = std::move(procedures);
+    }
+    if (tables_) {
+        json tables = json::array();
+        for (const auto& info : *tables_) {
+            tables.push_back(toJson(info));
+        }
+        doc["tables"] = std::move(tables);
+    }
+
+    // Readers of `path` see the old file or the new one, never a torn write
+    const std::string temp = path_ + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Cannot open metadata cache file for writing: " + temp);
+        }
+        out << doc.dump() << '\n';
+        if (!out) {
+            throw std::runtime_error("Failed to write metadata cache file: " + temp);
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp, path_, ec);
+    if (ec) {
+        std::filesystem::remove(temp, ec);
+        throw std::runtime_error("Failed to replace metadata cache file: " + path_);
+    }
+    dirty_ = false;
+}
+
+bool MetadataCache::revalidate() {
+    std::string current = schemaFingerprint(connection_);
+    if (current == fingerprint_) {
+        return false;
+    }
+    fingerprint_ = std::move(current);
+    clear();
+    return true;
+}
+
+void MetadataCache::clear() {
+    queries_.clear();
+    procedures_.reset();
+    described_.clear();
+    tables_.reset();
+    stats_.warm = false;
+    dirty_ = true;
+}
+
+} // namespace fbpp::schema
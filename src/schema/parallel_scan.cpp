@@ -0,0 +1,407 @@
+#include "fbpp/schema/parallel_scan.hpp"
+
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/firebird_compat.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/transaction_options.hpp"
+#include "fbpp/schema/schema_inspector.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <tuple>
+
+namespace fbpp::schema {
+
+using fbpp::core::Connection;
+using fbpp::core::FirebirdException;
+using fbpp::core::RowView;
+using fbpp::core::Transaction;
+using fbpp::core::TransactionOptions;
+using fbpp::core::TxIsolation;
+
+namespace {
+
+std::string toUpper(std::string_view s) {
+    std::string result(s);
+    std::transform(result.begin(), result.end(), result.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    return result;
+}
+
+bool isQuery(std::string_view source) {
+    const auto start = source.find_first_not_of(" \t\r\n(");
+    if (start == std::string_view::npos) {
+        return false;
+    }
+    const auto word = toUpper(source.substr(start, 6));
+    return word == "SELECT" || word.rfind("WITH", 0) == 0;
+}
+
+std::string quoteLiteral(std::string_view text) {
+    std::string out = "'";
+    for (char c : text) {
+        out += c;
+        if (c == '\'') {
+            out += '\'';
+        }
+    }
+    return out + "'";
+}
+
+template<typename T>
+std::optional<T> scalar(Connection& connection, Transaction& tx, const std::string& sql) {
+    auto cursor = tx.openCursor(connection.prepareStatement(sql));
+    std::tuple<std::optional<T>> row;
+    std::optional<T> value;
+    if (cursor->fetch(row)) {
+        value = std::get<0>(row);
+    }
+    cursor->close();
+    return value;
+}
+
+// floor(count * i / parts) without overflowing 64 bits
+std::uint64_t splitPoint(std::uint64_t count, std::uint64_t i, std::uint64_t parts) {
+    return count / parts * i + count % parts * i / parts;
+}
+
+bool isIntegerKey(const ColumnInfo& column) {
+    return column.scale == 0 &&
+           (column.sqlType == SQL_SHORT || column.sqlType == SQL_LONG || column.sqlType == SQL_INT64);
+}
+
+} // namespace
+
+bool ParallelScanResult::ok() const {
+    return std::all_of(partitions.begin(), partitions.end(),
+                       [](const ParallelScanPartition& p) { return p.error.empty(); });
+}
+
+struct ParallelScan::Plan {
+    std::shared_ptr<Transaction> transaction;   // Coordinator snapshot, open for the scan
+    std::optional<std::uint64_t> snapshotNumber;
+    std::vector<std::string> predicates;        // Empty string = whole source
+    std::string from;                           // FROM clause body
+};
+
+ParallelScan::ParallelScan(ConnectionFactory factory, std::string source, ParallelScanOptions options)
+    : factory_(std::move(factory)), source_(std::move(source)), options_(std::move(options)) {
+    if (!factory_) {
+        throw FirebirdException("ParallelScan: connection factory required");
+    }
+    if (options_.partitions == 0) {
+        throw FirebirdException("ParallelScan: at least one partition required");
+    }
+    if (source_.empty()) {
+        throw FirebirdException("ParallelScan: table or query required");
+    }
+}
+
+ParallelScan::ParallelScan(const fbpp::core::ConnectionParams& params, std::string source,
+                           ParallelScanOptions options)
+    : ParallelScan([params] { return std::make_unique<Connection>(params); },
+                   std::move(source), std::move(options)) {}
+
+ParallelScan::Plan ParallelScan::makePlan(Connection& coordinator) {
+    Plan plan;
+    const bool query = isQuery(source_);
+    plan.from = query ? "(" + source_ + ") FBPP_SCAN" : source_;
+
+    TransactionOptions snapshot;
+    snapshot.isolation = TxIsolation::Concurrency;
+    snapshot.readOnly = true;
+    plan.transaction = coordinator.StartTransaction(snapshot);
+
+    const int engine = coordinator.getEngineMajorVersion();
+    if (options_.shareSnapshot && engine >= 4) {
+        try {
+            const auto number = scalar<std::string>(coordinator, *plan.transaction,
+                "SELECT RDB$GET_CONTEXT('SYSTEM', 'SNAPSHOT_NUMBER') FROM RDB$DATABASE");
+            if (number && !number->empty()) {
+                plan.snapshotNumber = std::stoull(*number);
+            }
+        } catch (const std::exception&) {
+            // Independent snapshots; reported through snapshotNumber
+        }
+    }
+
+    ScanPartitioning mode = options_.partitioning;
+    std::string key = options_.keyColumn;
+    if (query && mode == ScanPartitioning::dbKey) {
+        throw FirebirdException("ParallelScan: DB_KEY partitioning needs a table source");
+    }
+    if (key.empty() && mode != ScanPartitioning::dbKey) {
+        if (query) {
+            throw FirebirdException("ParallelScan: a query source needs keyColumn");
+        }
+        const auto info = SchemaInspector(coordinator).getTableInfo(toUpper(source_));
+        if (info.relationType == RelationType::unknown) {
+            throw FirebirdException("ParallelScan: table not found: " + source_);
+        }
+        for (const auto& constraint : info.constraints) {
+            if (constraint.type != ConstraintType::primary_key || constraint.columns.size() != 1) {
+                continue;
+            }
+            auto column = std::find_if(info.columns.begin(), info.columns.end(),
+                                       [&](const ColumnInfo& c) { return c.name == constraint.columns[0]; });
+            if (column != info.columns.end() && isIntegerKey(*column)) {
+                key = column->name;
+            }
+        }
+        if (key.empty()) {
+            if (mode == ScanPartitioning::key) {
+                throw FirebirdException("ParallelScan: " + source_ +
+                                        " has no single-column integer primary key; set keyColumn");
+            }
+            mode = ScanPartitioning::dbKey;
+        }
+    }
+    if (mode == ScanPartitioning::dbKey && engine < 4) {
+        throw FirebirdException("ParallelScan: DB_KEY partitioning needs Firebird 4 or later");
+    }
+
+    const auto where = options_.where.empty() ? std::string() : " WHERE " + options_.where;
+    if (mode != ScanPartitioning::dbKey) {
+        const auto bounds = [&] {
+            auto cursor = plan.transaction->openCursor(coordinator.prepareStatement(
+                "SELECT CAST(MIN(" + key + ") AS BIGINT), CAST(MAX(" + key + ") AS BIGINT) FROM " + plan.from + where));
+            std::tuple<std::optional<int64_t>, std::optional<int64_t>> row;
+            cursor->fetch(row);
+            cursor->close();
+            return row;
+        }();
+        const auto& [lo, hi] = bounds;
+        if (!lo || !hi) {
+            return plan;   // No rows: nothing to scan
+        }
+        const std::uint64_t span = static_cast<std::uint64_t>(*hi) - static_cast<std::uint64_t>(*lo);
+        const std::uint64_t count = span == UINT64_MAX ? span : span + 1;
+        const std::uint64_t parts = std::min<std::uint64_t>(options_.partitions, count);
+        for (std::uint64_t i = 0; i < parts; ++i) {
+            const auto first = static_cast<int64_t>(static_cast<std::uint64_t>(*lo) + splitPoint(count, i, parts));
+            const auto last = i + 1 == parts
+                ? *hi
+                : static_cast<int64_t>(static_cast<std::uint64_t>(*lo) + splitPoint(count, i + 1, parts) - 1);
+            plan.predicates.push_back(key + " >= " + std::to_string(first) + " AND " + key +
+                                      " <= " + std::to_string(last));
+        }
+        return plan;
+    }
+
+    // Equal runs of pointer pages; MAKE_DBKEY(rel, 0, 0, pp) is the first
+    // record slot of pointer page pp
+    const auto relation = toUpper(source_);
+    const auto pointerPages = scalar<int64_t>(coordinator, *plan.transaction,
+        "SELECT COUNT(*) FROM RDB$PAGES P JOIN RDB$RELATIONS R ON R.RDB$RELATION_ID = P.RDB$RELATION_ID "
+        "WHERE R.RDB$RELATION_NAME = " + quoteLiteral(relation) + " AND P.RDB$PAGE_TYPE = 4").value_or(0);
+    const std::uint64_t pages = static_cast<std::uint64_t>(std::max<int64_t>(pointerPages, 1));
+    const std::uint64_t parts = std::min<std::uint64_t>(options_.partitions, pages);
+    auto dbKey = [&](std::uint64_t page) {
+        return "MAKE_DBKEY(" + quoteLiteral(relation) + ", 0, 0, " + std::to_string(page) + ")";
+    };
+    for (std::uint64_t i = 0; i < parts; ++i) {
+        std::string predicate;
+        if (i > 0) {
+            predicate = "RDB$DB_KEY >= " + dbKey(splitPoint(pages, i, parts));
+        }
+        if (i + 1 < parts) {
+            predicate += (predicate.empty() ? "" : " AND ");
+            predicate += "RDB$DB_KEY < " + dbKey(splitPoint(pages, i + 1, parts));
+        }
+        plan.predicates.push_back(std::move(predicate));
+    }
+    return plan;
+}
+
+std::vector<std::string> ParallelScan::plan() {
+    auto coordinator = factory_();
+    auto plan = makePlan(*coordinator);
+    plan.transaction->Commit();
+    return plan.predicates;
+}
+
+ParallelScanResult ParallelScan::run(const PartitionSink& sink) {
+    if (!sink) {
+        throw FirebirdException("ParallelScan::run: sink required");
+    }
+    return execute(sink);
+}
+
+ParallelScanResult ParallelScan::execute(const PartitionSink& sink) {
+    const auto started = std::chrono::steady_clock::now();
+    auto coordinator = factory_();
+    auto plan = makePlan(*coordinator);
+
+    ParallelScanResult result;
+    result.snapshotNumber = plan.snapshotNumber;
+    result.partitions.resize(plan.predicates.size());
+
+    TransactionOptions txOptions;
+    txOptions.isolation = TxIsolation::Concurrency;
+    txOptions.readOnly = true;
+    txOptions.atSnapshotNumber = plan.snapshotNumber;
+
+    std::vector<std::thread> workers;
+    workers.reserve(plan.predicates.size());
+    for (unsigned p = 0; p < plan.predicates.size(); ++p) {
+        auto& part = result.partitions[p];
+        part.predicate = plan.predicates[p];
+        std::string sql = "SELECT " + options_.columns + " FROM " + plan.from;
+        if (!part.predicate.empty() || !options_.where.empty()) {
+            sql += " WHERE ";
+            sql += part.predicate.empty() ? "" : "(" + part.predicate + ")";
+            sql += (!part.predicate.empty() && !options_.where.empty()) ? " AND " : "";
+            sql += options_.where.empty() ? "" : "(" + options_.where + ")";
+        }
+        workers.emplace_back([this, &sink, &part, &txOptions, p, sql = std::move(sql)] {
+            const auto partStarted = std::chrono::steady_clock::now();
+            try {
+                auto connection = factory_();
+                auto tx = connection->StartTransaction(txOptions);
+                auto cursor = tx->openCursor(connection->prepareStatement(sql));
+                cursor->setPrefetch(options_.prefetch);
+                for (const auto& view : cursor->rows()) {
+                    sink(p, view);
+                    ++part.rows;
+                }
+                cursor->close();
+                tx->Commit();
+            } catch (const std::exception& e) {
+                part.error = e.what();
+            }
+            part.elapsed = std::chrono::steady_clock::now() - partStarted;
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    plan.transaction->Commit();
+
+    for (const auto& part : result.partitions) {
+        result.rows += part.rows;
+    }
+    result.elapsed = std::chrono::steady_clock::now() - started;
+    return result;
+}
+
+ParallelScanResult ParallelScan::runMerged(const RowSink& sink) {
+    if (!sink) {
+        throw FirebirdException("ParallelScan::runMerged: sink required");
+    }
+
+    struct Block {
+        std::shared_ptr<const fbpp::core::MessageMetadata> metadata;
+        std::vector<uint8_t> data;
+        std::size_t stride = 0;
+        std::size_t rows = 0;
+    };
+
+    const std::size_t blockRows = std::max<std::size_t>(options_.mergeBlockRows, 1);
+    const std::size_t capacity = 2 * static_cast<std::size_t>(options_.partitions);
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::deque<Block> queue;
+    bool aborted = false;
+    std::exception_ptr sinkError;
+    std::vector<Block> filling(options_.partitions);
+
+    auto push = [&](Block& block) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [&] { return aborted || queue.size() < capacity; });
+        if (aborted) {
+            throw FirebirdException("ParallelScan::runMerged: stopped by the sink");
+        }
+        queue.push_back(std::move(block));
+        lock.unlock();
+        notEmpty.notify_one();
+        block = Block{};
+    };
+
+    auto copyRow = [&](unsigned p, const RowView& view) {
+        Block& block = filling[p];
+        if (block.rows == 0 && block.data.empty()) {
+            block.metadata = view.sharedMetadata();
+            const std::size_t length = block.metadata->getMessageLength();
+            block.stride = (length + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) *
+                           alignof(std::max_align_t);
+            block.data.resize(block.stride * blockRows);
+        }
+        std::memcpy(block.data.data() + block.rows * block.stride, view.data(),
+                    block.metadata->getMessageLength());
+        if (++block.rows == blockRows) {
+            push(block);
+        }
+    };
+
+    // The partitions run on their own threads inside execute(); the merge
+    // loop needs this thread, so execute() itself runs on a helper
+    bool running = true;
+    ParallelScanResult result;
+    std::exception_ptr scanError;
+    std::thread scanner([&] {
+        try {
+            result = execute([&](unsigned p, const RowView& view) { copyRow(p, view); });
+            for (unsigned p = 0; p < filling.size(); ++p) {
+                if (filling[p].rows != 0) {
+                    push(filling[p]);
+                }
+            }
+        } catch (...) {
+            scanError = std::current_exception();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running = false;
+        }
+        notEmpty.notify_one();
+    });
+
+    for (;;) {
+        Block block;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            notEmpty.wait(lock, [&] { return !queue.empty() || !running; });
+            if (queue.empty()) {
+                break;
+            }
+            block = std::move(queue.front());
+            queue.pop_front();
+        }
+        notFull.notify_one();
+        if (sinkError) {
+            continue;   // Drain so the scanner can finish
+        }
+        try {
+            for (std::size_t r = 0; r < block.rows; ++r) {
+                sink(RowView(block.metadata, block.data.data() + r * block.stride, nullptr));
+            }
+        } catch (...) {
+            sinkError = std::current_exception();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                aborted = true;
+            }
+            notFull.notify_all();
+        }
+    }
+    scanner.join();
+
+    if (sinkError) {
+        std::rethrow_exception(sinkError);
+    }
+    if (scanError) {
+        std::rethrow_exception(scanError);
+    }
+    return result;
+}
+
+} // namespace fbpp::schema
@@ -1,10 +1,15 @@
 #include "fbpp/schema/query_analyzer.hpp"
 
 #include "fbpp/core/named_param_parser.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
 
 #include <algorithm>
 #include <cctype>
+#include <cmath>
 #include <string>
+#include <tuple>
 #include <unordered_map>
 
 namespace fbpp::schema {
@@ -87,6 +92,10 @@ QueryKind QueryAnalyzer::classifyQuery(std::string_view sql) {
 }
 
 QueryAnalysis QueryAnalyzer::analyze(std::string_view sql) const {
+    return analyze(sql, QueryAnalysisOptions{});
+}
+
+QueryAnalysis QueryAnalyzer::analyze(std::string_view sql, const QueryAnalysisOptions& options) const {
     QueryAnalysis analysis;
     analysis.originalSql = std::string(sql);
     analysis.kind = classifyQuery(sql);
@@ -97,7 +106,31 @@ QueryAnalysis QueryAnalyzer::analyze(std::string_view sql) const {
                                  ? parseResult.convertedSql
                                  : analysis.originalSql;
 
-    auto meta = connection_.describeQuery(analysis.positionalSql);
+    fbpp::core::Connection::QueryMetadataInfo meta;
+    if (options.capturePlan && analysis.kind != QueryKind::ddl) {
+        // One prepare for both the metadata and the plan
+        auto stmt = connection_.prepareStatementUncached(analysis.positionalSql);
+        if (auto inMeta = stmt->getInputMetadata()) {
+            for (unsigned i = 0; i < inMeta->getCount(); ++i) {
+                meta.inputFields.emplace_back(inMeta->getField(i));
+            }
+        }
+        if (auto outMeta = stmt->getOutputMetadata()) {
+            for (unsigned i = 0; i < outMeta->getCount(); ++i) {
+                meta.outputFields.emplace_back(outMeta->getField(i));
+            }
+        }
+        analysis.plan = stmt->getPlan(true);
+        for (auto& table : naturalScanTables(analysis.plan)) {
+            PlanScan scan;
+            scan.estimatedRows = estimatedRows(table);
+            scan.large = scan.estimatedRows && *scan.estimatedRows >= options.largeTableRows;
+            scan.table = std::move(table);
+            analysis.naturalScans.push_back(std::move(scan));
+        }
+    } else {
+        meta = connection_.describeQuery(analysis.positionalSql);
+    }
 
     // Build inputParams with camelCase deduplication.
     analysis.inputParams.reserve(meta.inputFields.size());
@@ -140,6 +173,81 @@ QueryAnalysis QueryAnalyzer::analyze(std::string_view sql) const {
     return analysis;
 }
 
+std::vector<std::string> QueryAnalyzer::naturalScanTables(std::string_view plan) {
+    std::vector<std::string> tables;
+    auto add = [&tables](std::string name) {
+        if (!name.empty() && std::find(tables.begin(), tables.end(), name) == tables.end()) {
+            tables.push_back(std::move(name));
+        }
+    };
+
+    // Detailed: -> Table "NAME" [as "ALIAS"] Full Scan
+    constexpr std::string_view kTable = "Table \"";
+    constexpr std::string_view kFullScan = "Full Scan";
+    bool detailed = false;
+    for (std::size_t lineStart = 0; lineStart < plan.size();) {
+        std::size_t lineEnd = plan.find('\n', lineStart);
+        if (lineEnd == std::string_view::npos) {
+            lineEnd = plan.size();
+        }
+        const auto line = plan.substr(lineStart, lineEnd - lineStart);
+        const auto at = line.find(kTable);
+        if (at != std::string_view::npos) {
+            detailed = true;
+            const auto nameStart = at + kTable.size();
+            const auto nameEnd = line.find('"', nameStart);
+            if (nameEnd != std::string_view::npos &&
+                line.find(kFullScan, nameEnd) != std::string_view::npos) {
+                add(std::string(line.substr(nameStart, nameEnd - nameStart)));
+            }
+        }
+        lineStart = lineEnd + 1;
+    }
+    if (detailed) {
+        return tables;
+    }
+
+    // Legacy: PLAN (NAME NATURAL, ...)
+    constexpr std::string_view kNatural = " NATURAL";
+    for (std::size_t at = plan.find(kNatural); at != std::string_view::npos;
+         at = plan.find(kNatural, at + kNatural.size())) {
+        std::size_t start = at;
+        while (start > 0) {
+            const auto ch = static_cast<unsigned char>(plan[start - 1]);
+            if (std::isspace(ch) || ch == '(' || ch == ',') {
+                break;
+            }
+            --start;
+        }
+        add(std::string(plan.substr(start, at - start)));
+    }
+    return tables;
+}
+
+std::optional<std::uint64_t> QueryAnalyzer::estimatedRows(const std::string& table) const {
+    if (auto it = rowEstimates_.find(table); it != rowEstimates_.end()) {
+        return it->second;
+    }
+
+    // A unique index has one key per row: selectivity is 1 / rows
+    auto transaction = connection_.StartTransaction();
+    auto stmt = connection_.prepareStatement(
+        "SELECT MIN(RDB$STATISTICS) FROM RDB$INDICES"
+        " WHERE TRIM(RDB$RELATION_NAME) = ? AND RDB$UNIQUE_FLAG = 1"
+        " AND RDB$STATISTICS > 0");
+    auto rs = transaction->openCursor(stmt, std::make_tuple(table));
+    std::tuple<std::optional<double>> row;
+    std::optional<std::uint64_t> rows;
+    if (rs->fetch(row) && std::get<0>(row)) {
+        rows = static_cast<std::uint64_t>(std::llround(1.0 / *std::get<0>(row)));
+    }
+    rs->close();
+    transaction->Commit();
+
+    rowEstimates_.emplace(table, rows);
+    return rows;
+}
+
 std::vector<QueryParameterInfo> QueryAnalyzer::analyzeInputParams(std::string_view sql) const {
     return analyze(sql).inputParams;
 }
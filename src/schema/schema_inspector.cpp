@@ -4,11 +4,18 @@
 #include "fbpp/core/firebird_compat.hpp"
 #include "fbpp/core/result_set.hpp"
 #include "fbpp/core/transaction.hpp"
+#include "fbpp/core/transaction_options.hpp"
 
 #include <algorithm>
 #include <cctype>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <stdexcept>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 
 namespace fbpp::schema {
 
@@ -47,6 +54,223 @@ int16_t rdbFieldTypeToSqlType(int32_t rdbType) {
     }
 }
 
+RelationType relationTypeFromCode(int32_t code) {
+    switch (code) {
+        case 0: return RelationType::table;
+        case 1: return RelationType::view;
+        case 2: return RelationType::external_table;
+        case 3: return RelationType::monitoring_table;
+        case 4: return RelationType::global_temp_delete;
+        case 5: return RelationType::global_temp_preserve;
+        case 6: return RelationType::virtual_table;
+        default: return RelationType::unknown;
+    }
+}
+
+ConstraintType constraintTypeFromString(const std::string& type) {
+    if (type == "PRIMARY KEY") return ConstraintType::primary_key;
+    if (type == "UNIQUE")      return ConstraintType::unique_key;
+    if (type == "FOREIGN KEY") return ConstraintType::foreign_key;
+    if (type == "CHECK")       return ConstraintType::check_constraint;
+    return ConstraintType::not_null_constraint;
+}
+
+// Column select list shared by getTableInfo() and the bulk load
+constexpr const char* kColumnFields =
+    "CAST(rf.RDB$FIELD_POSITION AS INTEGER),"
+    "       CAST(f.RDB$FIELD_TYPE AS INTEGER),"
+    "       CAST(f.RDB$FIELD_SCALE AS INTEGER),"
+    "       CAST(f.RDB$FIELD_LENGTH AS INTEGER),"
+    "       CAST(COALESCE(f.RDB$CHARACTER_SET_ID, 0) AS INTEGER),"
+    "       CAST(COALESCE(f.RDB$FIELD_SUB_TYPE, 0) AS INTEGER),"
+    "       CASE WHEN rf.RDB$NULL_FLAG = 1 THEN 1 ELSE 0 END,"
+    "       CASE WHEN f.RDB$COMPUTED_BLR IS NOT NULL THEN 1 ELSE 0 END";
+
+ColumnInfo makeColumn(std::string name, int32_t position, int32_t rdbType, int32_t scale,
+                      int32_t length, int32_t charsetId, int32_t subType,
+                      int32_t notNull, int32_t computed) {
+    ColumnInfo col;
+    col.name      = std::move(name);
+    col.position  = position;
+    col.sqlType   = rdbFieldTypeToSqlType(rdbType);
+    col.scale     = scale;
+    col.length    = length;
+    col.charsetId = charsetId;
+    col.subType   = subType;
+    col.notNull   = (notNull != 0);
+    col.computed  = (computed != 0);
+    return col;
+}
+
+// ---- Bulk load -----------------------------------------------------------
+
+fbpp::core::TransactionOptions snapshotReadOnly() {
+    fbpp::core::TransactionOptions options;
+    options.readOnly = true;   // Concurrency: one consistent view of RDB$*
+    return options;
+}
+
+// User tables and views, sorted by name, with name and type only
+std::vector<TableInfo> listRelations(fbpp::core::Connection& connection,
+                                     fbpp::core::Transaction& transaction) {
+    auto stmt = connection.prepareStatement(
+        "SELECT TRIM(RDB$RELATION_NAME), CAST(COALESCE(RDB$RELATION_TYPE, 0) AS INTEGER)"
+        " FROM RDB$RELATIONS WHERE RDB$SYSTEM_FLAG = 0"
+        " ORDER BY RDB$RELATION_NAME");
+    auto rs = transaction.openCursor(stmt);
+
+    std::vector<TableInfo> tables;
+    std::tuple<std::string, int32_t> row;
+    while (rs->fetch(row)) {
+        TableInfo info;
+        info.name = std::get<0>(row);
+        info.relationType = relationTypeFromCode(std::get<1>(row));
+        tables.push_back(std::move(info));
+    }
+    return tables;
+}
+
+// Fill columns, indexes and constraints of `tables` (a sorted, contiguous
+// slice of listRelations()) with one query per kind over its name range.
+// System relations sorting inside the range are skipped by the lookup.
+void loadTables(fbpp::core::Connection& connection, fbpp::core::Transaction& transaction,
+                std::vector<TableInfo>& tables) {
+    if (tables.empty()) {
+        return;
+    }
+    std::unordered_map<std::string, TableInfo*> byName;
+    byName.reserve(tables.size());
+    for (auto& table : tables) {
+        byName.emplace(table.name, &table);
+    }
+    const auto range = std::make_tuple(tables.front().name, tables.back().name);
+
+    // Rows arrive grouped by relation: look the name up once per group
+    TableInfo* current = nullptr;
+    std::string currentName;
+    auto tableOf = [&](const std::string& name) {
+        if (!current || name != currentName) {
+            auto it = byName.find(name);
+            current = it != byName.end() ? it->second : nullptr;
+            currentName = name;
+        }
+        return current;
+    };
+
+    // 1. Columns
+    {
+        auto stmt = connection.prepareStatement(
+            std::string("SELECT TRIM(rf.RDB$RELATION_NAME), TRIM(rf.RDB$FIELD_NAME),"
+                        "       ") + kColumnFields +
+            " FROM RDB$RELATION_FIELDS rf"
+            " JOIN RDB$FIELDS f ON f.RDB$FIELD_NAME = rf.RDB$FIELD_SOURCE"
+            " WHERE rf.RDB$RELATION_NAME BETWEEN ? AND ?"
+            " ORDER BY rf.RDB$RELATION_NAME, rf.RDB$FIELD_POSITION");
+        auto rs = transaction.openCursor(stmt, range);
+
+        using ColRow = std::tuple<std::string, std::string, int32_t, int32_t, int32_t,
+                                  int32_t, int32_t, int32_t, int32_t, int32_t>;
+        ColRow row;
+        while (rs->fetch(row)) {
+            if (TableInfo* table = tableOf(std::get<0>(row))) {
+                table->columns.push_back(makeColumn(
+                    std::move(std::get<1>(row)), std::get<2>(row), std::get<3>(row),
+                    std::get<4>(row), std::get<5>(row), std::get<6>(row), std::get<7>(row),
+                    std::get<8>(row), std::get<9>(row)));
+            }
+        }
+    }
+
+    // 2. Indexes with their segments (expression indexes have none)
+    {
+        auto stmt = connection.prepareStatement(
+            "SELECT TRIM(i.RDB$RELATION_NAME),"
+            "       TRIM(i.RDB$INDEX_NAME),"
+            "       CAST(COALESCE(i.RDB$UNIQUE_FLAG, 0) AS INTEGER),"
+            "       CAST(COALESCE(i.RDB$INDEX_INACTIVE, 0) AS INTEGER),"
+            "       CAST(COALESCE(i.RDB$INDEX_TYPE, 0) AS INTEGER),"
+            "       COALESCE(TRIM(s.RDB$FIELD_NAME), ''),"
+            "       CAST(COALESCE(s.RDB$FIELD_POSITION, -1) AS INTEGER)"
+            " FROM RDB$INDICES i"
+            " LEFT JOIN RDB$INDEX_SEGMENTS s ON s.RDB$INDEX_NAME = i.RDB$INDEX_NAME"
+            " WHERE i.RDB$RELATION_NAME BETWEEN ? AND ?"
+            " ORDER BY i.RDB$RELATION_NAME, i.RDB$INDEX_NAME, s.RDB$FIELD_POSITION");
+        auto rs = transaction.openCursor(stmt, range);
+
+        using IdxRow = std::tuple<std::string, std::string, int32_t, int32_t, int32_t,
+                                  std::string, int32_t>;
+        IdxRow row;
+        while (rs->fetch(row)) {
+            TableInfo* table = tableOf(std::get<0>(row));
+            if (!table) {
+                continue;
+            }
+            if (table->indexes.empty() || table->indexes.back().name != std::get<1>(row)) {
+                IndexInfo idx;
+                idx.name      = std::get<1>(row);
+                idx.unique    = std::get<2>(row) != 0;
+                idx.active    = std::get<3>(row) == 0;  // RDB$INDEX_INACTIVE: 0 = active
+                idx.sortOrder = std::get<4>(row) == 1 ? SortOrder::descending : SortOrder::ascending;
+                table->indexes.push_back(std::move(idx));
+            }
+            if (std::get<6>(row) >= 0) {
+                table->indexes.back().segments.push_back({std::move(std::get<5>(row)), std::get<6>(row)});
+            }
+        }
+    }
+
+    // 3. Constraints with their columns and FK targets
+    {
+        auto stmt = connection.prepareStatement(
+            "SELECT TRIM(c.RDB$RELATION_NAME),"
+            "       TRIM(c.RDB$CONSTRAINT_NAME),"
+            "       TRIM(c.RDB$CONSTRAINT_TYPE),"
+            "       COALESCE(TRIM(c.RDB$INDEX_NAME), ''),"
+            "       COALESCE(TRIM(rc.RDB$CONST_NAME_UQ), ''),"
+            "       COALESCE(TRIM(pk.RDB$RELATION_NAME), ''),"
+            "       COALESCE(TRIM(rc.RDB$UPDATE_RULE), ''),"
+            "       COALESCE(TRIM(rc.RDB$DELETE_RULE), ''),"
+            "       COALESCE(TRIM(s.RDB$FIELD_NAME), '')"
+            " FROM RDB$RELATION_CONSTRAINTS c"
+            " LEFT JOIN RDB$REF_CONSTRAINTS rc"
+            "   ON rc.RDB$CONSTRAINT_NAME = c.RDB$CONSTRAINT_NAME"
+            " LEFT JOIN RDB$RELATION_CONSTRAINTS pk"
+            "   ON pk.RDB$CONSTRAINT_NAME = rc.RDB$CONST_NAME_UQ"
+            " LEFT JOIN RDB$INDEX_SEGMENTS s ON s.RDB$INDEX_NAME = c.RDB$INDEX_NAME"
+            " WHERE c.RDB$RELATION_NAME BETWEEN ? AND ?"
+            " ORDER BY c.RDB$RELATION_NAME, c.RDB$CONSTRAINT_NAME, s.RDB$FIELD_POSITION");
+        auto rs = transaction.openCursor(stmt, range);
+
+        using ConRow = std::tuple<std::string, std::string, std::string, std::string, std::string,
+                                  std::string, std::string, std::string, std::string>;
+        ConRow row;
+        while (rs->fetch(row)) {
+            TableInfo* table = tableOf(std::get<0>(row));
+            if (!table) {
+                continue;
+            }
+            if (table->constraints.empty() || table->constraints.back().name != std::get<1>(row)) {
+                ConstraintInfo con;
+                con.name      = std::get<1>(row);
+                con.type      = constraintTypeFromString(std::get<2>(row));
+                con.indexName = std::get<3>(row);
+                if (con.type == ConstraintType::foreign_key) {
+                    ForeignKeyInfo fk;
+                    fk.referencedTable = std::get<5>(row);
+                    fk.referencedIndex = std::get<4>(row);
+                    fk.updateRule      = std::get<6>(row);
+                    fk.deleteRule      = std::get<7>(row);
+                    con.foreignKey     = std::move(fk);
+                }
+                table->constraints.push_back(std::move(con));
+            }
+            if (!std::get<8>(row).empty()) {
+                table->constraints.back().columns.push_back(std::move(std::get<8>(row)));
+            }
+        }
+    }
+}
+
 } // namespace
 
 SchemaInspector::SchemaInspector(fbpp::core::Connection& connection)
@@ -130,16 +354,7 @@ TableInfo SchemaInspector::getTableInfo(std::string_view name) const {
         auto rs = transaction->openCursor(stmt, std::make_tuple(upperName));
         std::tuple<int32_t> row;
         if (rs->fetch(row)) {
-            switch (std::get<0>(row)) {
-                case 0: info.relationType = RelationType::table; break;
-                case 1: info.relationType = RelationType::view; break;
-                case 2: info.relationType = RelationType::external_table; break;
-                case 3: info.relationType = RelationType::monitoring_table; break;
-                case 4: info.relationType = RelationType::global_temp_delete; break;
-                case 5: info.relationType = RelationType::global_temp_preserve; break;
-                case 6: info.relationType = RelationType::virtual_table; break;
-                default: info.relationType = RelationType::unknown; break;
-            }
+            info.relationType = relationTypeFromCode(std::get<0>(row));
         }
     }
 
@@ -151,15 +366,8 @@ TableInfo SchemaInspector::getTableInfo(std::string_view name) const {
     // 2. Columns
     {
         auto stmt = connection_.prepareStatement(
-            "SELECT TRIM(rf.RDB$FIELD_NAME),"
-            "       CAST(rf.RDB$FIELD_POSITION AS INTEGER),"
-            "       CAST(f.RDB$FIELD_TYPE AS INTEGER),"
-            "       CAST(f.RDB$FIELD_SCALE AS INTEGER),"
-            "       CAST(f.RDB$FIELD_LENGTH AS INTEGER),"
-            "       CAST(COALESCE(f.RDB$CHARACTER_SET_ID, 0) AS INTEGER),"
-            "       CAST(COALESCE(f.RDB$FIELD_SUB_TYPE, 0) AS INTEGER),"
-            "       CASE WHEN rf.RDB$NULL_FLAG = 1 THEN 1 ELSE 0 END,"
-            "       CASE WHEN f.RDB$COMPUTED_BLR IS NOT NULL THEN 1 ELSE 0 END"
+            std::string("SELECT TRIM(rf.RDB$FIELD_NAME),"
+                        "       ") + kColumnFields +
             " FROM RDB$RELATION_FIELDS rf"
             " JOIN RDB$FIELDS f ON f.RDB$FIELD_NAME = rf.RDB$FIELD_SOURCE"
             " WHERE TRIM(rf.RDB$RELATION_NAME) = ?"
@@ -170,17 +378,10 @@ TableInfo SchemaInspector::getTableInfo(std::string_view name) const {
                                   int32_t, int32_t, int32_t, int32_t, int32_t>;
         ColRow row;
         while (rs->fetch(row)) {
-            ColumnInfo col;
-            col.name      = std::get<0>(row);
-            col.position  = std::get<1>(row);
-            col.sqlType   = rdbFieldTypeToSqlType(std::get<2>(row));
-            col.scale     = std::get<3>(row);
-            col.length    = std::get<4>(row);
-            col.charsetId = std::get<5>(row);
-            col.subType   = std::get<6>(row);
-            col.notNull   = (std::get<7>(row) != 0);
-            col.computed  = (std::get<8>(row) != 0);
-            info.columns.push_back(std::move(col));
+            info.columns.push_back(makeColumn(
+                std::move(std::get<0>(row)), std::get<1>(row), std::get<2>(row), std::get<3>(row),
+                std::get<4>(row), std::get<5>(row), std::get<6>(row), std::get<7>(row),
+                std::get<8>(row)));
         }
     }
 
@@ -275,12 +476,7 @@ TableInfo SchemaInspector::getTableInfo(std::string_view name) const {
             ConstraintInfo con;
             con.name      = m.name;
             con.indexName = m.indexName;
-
-            if      (m.typeStr == "PRIMARY KEY") con.type = ConstraintType::primary_key;
-            else if (m.typeStr == "UNIQUE")      con.type = ConstraintType::unique_key;
-            else if (m.typeStr == "FOREIGN KEY") con.type = ConstraintType::foreign_key;
-            else if (m.typeStr == "CHECK")       con.type = ConstraintType::check_constraint;
-            else                                 con.type = ConstraintType::not_null_constraint;
+            con.type      = constraintTypeFromString(m.typeStr);
 
             if (con.type == ConstraintType::foreign_key) {
                 ForeignKeyInfo fk;
@@ -310,6 +506,77 @@ TableInfo SchemaInspector::getTableInfo(std::string_view name) const {
     return info;
 }
 
+std::vector<TableInfo> SchemaInspector::getAllTables() const {
+    auto transaction = connection_.StartTransaction(snapshotReadOnly());
+    auto tables = listRelations(connection_, *transaction);
+    loadTables(connection_, *transaction, tables);
+    transaction->Commit();
+    return tables;
+}
+
+std::vector<TableInfo> SchemaInspector::getAllTables(
+    const std::vector<fbpp::core::Connection*>& connections) {
+    if (connections.empty() ||
+        std::find(connections.begin(), connections.end(), nullptr) != connections.end()) {
+        throw std::invalid_argument("SchemaInspector::getAllTables: null or no connections");
+    }
+
+    std::vector<TableInfo> tables;
+    {
+        auto transaction = connections.front()->StartTransaction(snapshotReadOnly());
+        tables = listRelations(*connections.front(), *transaction);
+        transaction->Commit();
+    }
+    const size_t parts = std::min(connections.size(), tables.size());
+    if (parts <= 1) {
+        return SchemaInspector(*connections.front()).getAllTables();
+    }
+
+    // Contiguous, about equal slices so each range query stays narrow
+    std::vector<std::vector<TableInfo>> slices(parts);
+    for (size_t i = 0; i < parts; ++i) {
+        const size_t begin = tables.size() * i / parts;
+        const size_t end   = tables.size() * (i + 1) / parts;
+        slices[i].assign(std::make_move_iterator(tables.begin() + static_cast<std::ptrdiff_t>(begin)),
+                         std::make_move_iterator(tables.begin() + static_cast<std::ptrdiff_t>(end)));
+    }
+
+    auto load = [](fbpp::core::Connection* connection, std::vector<TableInfo>& slice) {
+        auto transaction = connection->StartTransaction(snapshotReadOnly());
+        loadTables(*connection, *transaction, slice);
+        transaction->Commit();
+    };
+    std::vector<std::future<void>> workers;
+    workers.reserve(parts - 1);
+    for (size_t i = 1; i < parts; ++i) {
+        workers.push_back(std::async(std::launch::async, load, connections[i], std::ref(slices[i])));
+    }
+    std::exception_ptr failure;
+    try {
+        load(connections.front(), slices.front());
+    } catch (...) {
+        failure = std::current_exception();
+    }
+    for (auto& worker : workers) {
+        try {
+            worker.get();
+        } catch (...) {
+            if (!failure) {
+                failure = std::current_exception();
+            }
+        }
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+
+    tables.clear();
+    for (auto& slice : slices) {
+        std::move(slice.begin(), slice.end(), std::back_inserter(tables));
+    }
+    return tables;
+}
+
 // ---- Stored procedures ---------------------------------------------------
 
 std::vector<std::string> SchemaInspector::getProcedureNames() const {
@@ -0,0 +1,192 @@
+#include "fbpp/schema/sequence_allocator.hpp"
+
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/schema/schema_inspector.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <limits>
+#include <tuple>
+
+namespace fbpp::schema {
+
+using fbpp::core::Connection;
+using fbpp::core::FirebirdException;
+
+namespace {
+
+std::string toUpper(std::string_view s) {
+    std::string result(s);
+    std::transform(result.begin(), result.end(), result.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    return result;
+}
+
+} // namespace
+
+SequenceAllocator::SequenceAllocator(ConnectionFactory factory, std::string sequence,
+                                     SequenceAllocatorOptions options)
+    : sequence_(toUpper(sequence)), options_(options) {
+    if (!factory) {
+        throw FirebirdException("SequenceAllocator: connection factory required");
+    }
+    if (options_.blockSize == 0) {
+        throw FirebirdException("SequenceAllocator: blockSize must be positive");
+    }
+    if (options_.lowWater == 0) {
+        options_.lowWater = std::max<std::uint32_t>(1, options_.blockSize / 4);
+    }
+    options_.lowWater = std::min(options_.lowWater, options_.blockSize);
+
+    connection_ = factory();
+    bool found = false;
+    for (const auto& info : SchemaInspector(*connection_).getSequences()) {
+        if (info.name == sequence_) {
+            increment_ = info.increment != 0 ? info.increment : 1;
+            found = true;
+            break;
+        }
+    }
+    if (!found) {
+        throw FirebirdException("SequenceAllocator: sequence " + sequence_ + " not found");
+    }
+    const auto limit = std::numeric_limits<std::int64_t>::max() / options_.blockSize;
+    if (increment_ > limit || increment_ < -limit) {
+        throw FirebirdException("SequenceAllocator: blockSize * increment overflows BIGINT");
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        reserveThrough(0);
+    }
+    if (options_.asyncRefill) {
+        refiller_ = std::thread([this] { refillLoop(); });
+    }
+}
+
+SequenceAllocator::SequenceAllocator(const fbpp::core::ConnectionParams& params, std::string sequence,
+                                     SequenceAllocatorOptions options)
+    : SequenceAllocator([params] { return std::make_unique<Connection>(params); },
+                        std::move(sequence), options) {}
+
+SequenceAllocator::~SequenceAllocator() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    if (refiller_.joinable()) {
+        refiller_.join();
+    }
+}
+
+std::int64_t SequenceAllocator::next() {
+    const std::uint64_t blockSize = options_.blockSize;
+    for (;;) {
+        const std::uint64_t ticket = ticket_.fetch_add(1, std::memory_order_relaxed);
+        const std::uint64_t block = ticket / blockSize;
+        const std::uint64_t offset = ticket % blockSize;
+
+        if (options_.asyncRefill && offset == blockSize - options_.lowWater) {
+            // Ask for the next block once per block; the background thread
+            // is woken without taking the lock on this path
+            std::uint64_t wanted = wanted_.load(std::memory_order_relaxed);
+            while (wanted < block + 1 &&
+                   !wanted_.compare_exchange_weak(wanted, block + 1, std::memory_order_relaxed)) {
+            }
+            wake_.notify_one();
+        }
+
+        for (;;) {
+            auto& slot = slots_[block % kSlots];
+            const std::uint64_t seen = slot.block.load(std::memory_order_acquire);
+            if (seen == block) {
+                const std::int64_t base = slot.base.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.block.load(std::memory_order_relaxed) == block) {
+                    return base + static_cast<std::int64_t>(offset) * increment_;
+                }
+            } else if (seen == kNoBlock || seen < block) {
+                // Not reserved yet (or its slot is being written): reserve it
+                stalls_.fetch_add(1, std::memory_order_relaxed);
+                std::lock_guard<std::mutex> lock(mutex_);
+                reserveThrough(block);
+                continue;
+            }
+            // The ring lapped this reader: the slot holds a later block.
+            // The ticket's value is unknown now; leave the gap, take another.
+            skipped_.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+    }
+}
+
+void SequenceAllocator::next(std::int64_t* out, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = next();
+    }
+}
+
+SequenceAllocatorStats SequenceAllocator::stats() const noexcept {
+    SequenceAllocatorStats stats;
+    stats.skipped = skipped_.load(std::memory_order_relaxed);
+    stats.issued = ticket_.load(std::memory_order_relaxed) - stats.skipped;
+    stats.blocks = blocks_.load(std::memory_order_relaxed);
+    stats.stalls = stalls_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void SequenceAllocator::reserveThrough(std::uint64_t through) {
+    const std::int64_t step = static_cast<std::int64_t>(options_.blockSize) * increment_;
+    // GEN_ID() needs the name as an identifier, not a parameter (see
+    // SchemaInspector::getSequences)
+    const std::string sql = "SELECT GEN_ID(" + sequence_ + ", " + std::to_string(step) +
+                            ") FROM RDB$DATABASE";
+    while (published_ <= through) {
+        auto transaction = connection_->StartTransaction();
+        auto cursor = transaction->openCursor(connection_->prepareStatement(sql));
+        std::tuple<std::int64_t> row;
+        if (!cursor->fetch(row)) {
+            throw FirebirdException("SequenceAllocator: GEN_ID returned no row");
+        }
+        cursor->close();
+        transaction->Commit();
+
+        // GEN_ID returns the last value of the block
+        const std::int64_t base = std::get<0>(row) - step + increment_;
+        auto& slot = slots_[published_ % kSlots];
+        slot.block.store(kNoBlock, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.base.store(base, std::memory_order_relaxed);
+        slot.block.store(published_, std::memory_order_release);
+        ++published_;
+        blocks_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void SequenceAllocator::refillLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    std::uint64_t failed = kNoBlock;
+    while (!stop_) {
+        const std::uint64_t wanted = wanted_.load(std::memory_order_relaxed);
+        if (wanted < published_ || wanted == failed) {
+            // next() notifies without the lock, so a wake-up can be missed;
+            // the timeout bounds how late the block is then reserved
+            wake_.wait_for(lock, std::chrono::milliseconds(50));
+            continue;
+        }
+        try {
+            reserveThrough(wanted);
+        } catch (const std::exception&) {
+            // Left to the caller that runs out: it reserves the block itself
+            // and gets the error
+            failed = wanted;
+        }
+    }
+}
+
+} // namespace fbpp::schema
@@ -61,8 +61,13 @@ CppTypeInfo TypeMapper::mapField(const fbpp::core::FieldInfo& field,
             break;
         case SQL_TEXT:
         case SQL_VARYING:
-            result.cppType = "std::string";
-            result.needsString = true;
+            if (field.length > 0 && field.length <= config.inlineStringBytes) {
+                result.cppType = std::format("fbpp::core::FixedString<{}>", field.length);
+                result.needsExtendedTypes = true;
+            } else {
+                result.cppType = "std::string";
+                result.needsString = true;
+            }
             break;
         case SQL_BOOLEAN:
             result.cppType = "bool";
@@ -0,0 +1,249 @@
+#include "fbpp/schema/upsert_loader.hpp"
+
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/staging_table.hpp"
+#include "fbpp/schema/schema_inspector.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+
+namespace fbpp::schema {
+
+using fbpp::core::FirebirdException;
+
+namespace {
+
+std::string toUpper(std::string_view s) {
+    std::string result(s);
+    std::transform(result.begin(), result.end(), result.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    return result;
+}
+
+std::string join(const std::vector<std::string>& items, const std::string& separator,
+                 const std::string& prefix = {}) {
+    std::string out;
+    for (const auto& item : items) {
+        if (!out.empty()) {
+            out += separator;
+        }
+        out += prefix + item;
+    }
+    return out;
+}
+
+bool contains(const std::vector<std::string>& items, const std::string& item) {
+    return std::find(items.begin(), items.end(), item) != items.end();
+}
+
+std::string numeric(const char* plain, int defaultPrecision, int precision, int scale,
+                    int subType) {
+    if (scale == 0 && subType == 0) {
+        return plain;
+    }
+    return std::string(subType == 2 ? "DECIMAL(" : "NUMERIC(") +
+           std::to_string(precision > 0 ? precision : defaultPrecision) + ", " +
+           std::to_string(-scale) + ")";
+}
+
+// Column type for the staging table's DDL, from RDB$FIELDS
+std::string sqlTypeOf(const std::string& column, int rdbType, int subType, int length,
+                      int scale, int precision, int charLength, const std::string& charset) {
+    const std::string chars = std::to_string(charLength > 0 ? charLength : length);
+    const std::string cs = charset.empty() ? "" : " CHARACTER SET " + charset;
+    switch (rdbType) {
+        case 7:   return numeric("SMALLINT", 4, precision, scale, subType);
+        case 8:   return numeric("INTEGER", 9, precision, scale, subType);
+        case 16:  return numeric("BIGINT", 18, precision, scale, subType);
+        case 26:  return numeric("INT128", 38, precision, scale, subType);
+        case 10:  return "FLOAT";
+        case 27:  return "DOUBLE PRECISION";
+        case 12:  return "DATE";
+        case 13:  return "TIME";
+        case 35:  return "TIMESTAMP";
+        case 28:  return "TIME WITH TIME ZONE";
+        case 29:  return "TIMESTAMP WITH TIME ZONE";
+        case 23:  return "BOOLEAN";
+        case 24:  return "DECFLOAT(16)";
+        case 25:  return "DECFLOAT(34)";
+        case 14:  return "CHAR(" + chars + ")" + cs;
+        case 37:  return "VARCHAR(" + chars + ")" + cs;
+        case 261: return "BLOB SUB_TYPE " + std::to_string(subType) + (subType == 1 ? cs : "");
+        default:
+            throw FirebirdException("UpsertLoader: column " + column +
+                                    " has unsupported field type " + std::to_string(rdbType));
+    }
+}
+
+// Declared type of every column of `table`
+std::unordered_map<std::string, std::string> columnTypes(fbpp::core::Connection& connection,
+                                                         const std::string& table) {
+    auto transaction = connection.StartTransaction();
+    auto stmt = connection.prepareStatement(
+        "SELECT TRIM(rf.RDB$FIELD_NAME),"
+        "       CAST(f.RDB$FIELD_TYPE AS INTEGER),"
+        "       CAST(COALESCE(f.RDB$FIELD_SUB_TYPE, 0) AS INTEGER),"
+        "       CAST(f.RDB$FIELD_LENGTH AS INTEGER),"
+        "       CAST(COALESCE(f.RDB$FIELD_SCALE, 0) AS INTEGER),"
+        "       CAST(COALESCE(f.RDB$FIELD_PRECISION, 0) AS INTEGER),"
+        "       CAST(COALESCE(f.RDB$CHARACTER_LENGTH, 0) AS INTEGER),"
+        "       COALESCE(TRIM(cs.RDB$CHARACTER_SET_NAME), '')"
+        " FROM RDB$RELATION_FIELDS rf"
+        " JOIN RDB$FIELDS f ON f.RDB$FIELD_NAME = rf.RDB$FIELD_SOURCE"
+        " LEFT JOIN RDB$CHARACTER_SETS cs ON cs.RDB$CHARACTER_SET_ID = f.RDB$CHARACTER_SET_ID"
+        " WHERE TRIM(rf.RDB$RELATION_NAME) = ?");
+    auto rs = transaction->openCursor(stmt, std::make_tuple(table));
+
+    std::unordered_map<std::string, std::string> types;
+    std::tuple<std::string, int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, std::string> row;
+    while (rs->fetch(row)) {
+        const auto& [name, type, subType, length, scale, precision, charLength, charset] = row;
+        types[name] = sqlTypeOf(name, type, subType, length, scale, precision, charLength, charset);
+    }
+    rs->close();
+    transaction->Commit();
+    return types;
+}
+
+} // namespace
+
+UpsertPlan::UpsertPlan(fbpp::core::Connection& connection, std::string table,
+                       const UpsertOptions& options)
+    : table_(toUpper(table)),
+      mode_(options.mode) {
+    const TableInfo info = SchemaInspector(connection).getTableInfo(table_);
+    if (info.relationType == RelationType::unknown) {
+        throw FirebirdException("UpsertLoader: table " + table_ + " does not exist");
+    }
+
+    for (const auto& column : options.columns) {
+        columns_.push_back(toUpper(column));
+    }
+    if (columns_.empty()) {
+        std::vector<ColumnInfo> ordered = info.columns;
+        std::sort(ordered.begin(), ordered.end(),
+                  [](const ColumnInfo& a, const ColumnInfo& b) { return a.position < b.position; });
+        for (const auto& column : ordered) {
+            if (!column.computed) {
+                columns_.push_back(column.name);
+            }
+        }
+    }
+
+    for (const auto& column : options.matching) {
+        matching_.push_back(toUpper(column));
+    }
+    if (matching_.empty()) {
+        for (const auto& constraint : info.constraints) {
+            if (constraint.type == ConstraintType::primary_key) {
+                matching_ = constraint.columns;
+            }
+        }
+    }
+    if (matching_.empty()) {
+        throw FirebirdException("UpsertLoader: table " + table_ +
+                                " has no primary key; set UpsertOptions::matching");
+    }
+
+    for (const auto& key : matching_) {
+        if (!contains(columns_, key)) {
+            throw FirebirdException("UpsertLoader: matching column " + key +
+                                    " is not one of the loaded columns");
+        }
+    }
+    updates_ = std::any_of(columns_.begin(), columns_.end(),
+                           [&](const std::string& column) { return !contains(matching_, column); });
+
+    if (mode_ == UpsertMode::updateOrInsert) {
+        std::string marks;
+        for (std::size_t i = 0; i < columns_.size(); ++i) {
+            marks += i == 0 ? "?" : ", ?";
+        }
+        loadSql_ = "UPDATE OR INSERT INTO " + table_ + " (" + join(columns_, ", ") +
+                   ") VALUES (" + marks + ") MATCHING (" + join(matching_, ", ") + ")";
+        load_ = connection.prepareStatement(loadSql_);
+        return;
+    }
+
+    const auto declared = columnTypes(connection, table_);
+    std::vector<fbpp::core::StagingColumn> staged;
+    for (const auto& column : columns_) {
+        auto it = declared.find(column);
+        if (it == declared.end()) {
+            throw FirebirdException("UpsertLoader: table " + table_ + " has no column " + column);
+        }
+        staged.push_back({column, it->second});
+    }
+    prepareMerge(connection, std::move(staged), options.stagingTable);
+}
+
+void UpsertPlan::prepareMerge(fbpp::core::Connection& connection,
+                              std::vector<fbpp::core::StagingColumn> staged,
+                              const std::string& stagingName) {
+    fbpp::core::StagingTableOptions stagingOptions;
+    stagingOptions.name = stagingName;
+    const fbpp::core::StagingTable staging(connection, std::move(staged), stagingOptions);
+    staging_ = staging.name();
+
+    std::string on;
+    for (const auto& key : matching_) {
+        on += (on.empty() ? "t." : " AND t.") + key + " = s." + key;
+    }
+
+    mergeSql_ = "MERGE INTO " + table_ + " t USING " + staging_ + " s ON (" + on + ")";
+    if (updates_) {
+        std::string set;
+        for (const auto& column : columns_) {
+            if (!contains(matching_, column)) {
+                set += (set.empty() ? "" : ", ") + column + " = s." + column;
+            }
+        }
+        mergeSql_ += " WHEN MATCHED THEN UPDATE SET " + set;
+    }
+    mergeSql_ += " WHEN NOT MATCHED THEN INSERT (" + join(columns_, ", ") + ") VALUES (" +
+                 join(columns_, ", ", "s.") + ")";
+
+    loadSql_ = staging.insertSql();
+
+    load_ = connection.prepareStatement(loadSql_);
+    matched_ = connection.prepareStatement(
+        "SELECT COUNT(*) FROM " + staging_ + " s WHERE EXISTS (SELECT 1 FROM " + table_ +
+        " t WHERE " + on + ")");
+    merge_ = connection.prepareStatement(mergeSql_);
+    clear_ = connection.prepareStatement("DELETE FROM " + staging_);
+}
+
+void UpsertPlan::apply(fbpp::core::Transaction& transaction,
+                       const fbpp::core::BatchResult& flushed, UpsertStats& stats) const {
+    ++stats.flushes;
+    stats.rows += flushed.totalMessages;
+    stats.failed += flushed.failedCount;
+    if (mode_ == UpsertMode::updateOrInsert) {
+        stats.affected += flushed.successCount;
+        return;
+    }
+    if (flushed.successCount == 0) {
+        return;
+    }
+
+    // Existing keys first: MERGE reports one count for both branches
+    std::tuple<int64_t> matched{0};
+    {
+        auto rs = transaction.openCursor(matched_);
+        rs->fetch(matched);
+        rs->close();
+    }
+    const std::uint64_t affected = transaction.execute(merge_);
+    transaction.execute(clear_);
+
+    const std::uint64_t updated = updates_ ? static_cast<std::uint64_t>(std::get<0>(matched)) : 0;
+    stats.affected += affected;
+    stats.updated = stats.updated.value_or(0) + updated;
+    stats.inserted = stats.inserted.value_or(0) + (affected > updated ? affected - updated : 0);
+}
+
+} // namespace fbpp::schema
@@ -0,0 +1,103 @@
+#include "fbpp/schema/watermark_sync.hpp"
+
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/message_metadata.hpp"
+#include "fbpp/schema/schema_inspector.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <string>
+
+namespace fbpp::schema {
+
+using fbpp::core::FirebirdException;
+
+namespace {
+
+std::string toUpper(std::string_view s) {
+    std::string result(s);
+    std::transform(result.begin(), result.end(), result.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    return result;
+}
+
+std::string join(const std::vector<std::string>& items, const std::string& separator) {
+    std::string out;
+    for (const auto& item : items) {
+        if (!out.empty()) {
+            out += separator;
+        }
+        out += item;
+    }
+    return out;
+}
+
+} // namespace
+
+WatermarkSyncPlan::WatermarkSyncPlan(fbpp::core::Connection& source,
+                                     fbpp::core::Connection& target, std::string table,
+                                     const WatermarkSyncOptions& options)
+    : table_(toUpper(table)),
+      targetTable_(options.targetTable.empty() ? table_ : toUpper(options.targetTable)),
+      name_(options.name.empty() ? table_ : options.name) {
+    const std::string watermark = toUpper(options.watermarkColumn);
+    if (watermark.empty()) {
+        throw FirebirdException("WatermarkSync: no watermark column for " + table_);
+    }
+
+    for (const auto& column : options.columns) {
+        columns_.push_back(toUpper(column));
+    }
+    if (columns_.empty()) {
+        const TableInfo info = SchemaInspector(source).getTableInfo(table_);
+        if (info.relationType == RelationType::unknown) {
+            throw FirebirdException("WatermarkSync: table " + table_ + " does not exist");
+        }
+        std::vector<ColumnInfo> ordered = info.columns;
+        std::sort(ordered.begin(), ordered.end(),
+                  [](const ColumnInfo& a, const ColumnInfo& b) { return a.position < b.position; });
+        for (const auto& column : ordered) {
+            if (!column.computed) {
+                columns_.push_back(column.name);
+            }
+        }
+    }
+    const auto it = std::find(columns_.begin(), columns_.end(), watermark);
+    if (it == columns_.end()) {
+        throw FirebirdException("WatermarkSync: watermark column " + watermark +
+                                " is not one of the copied columns");
+    }
+    watermarkIndex_ = static_cast<unsigned>(it - columns_.begin());
+
+    const std::string select = "SELECT " + join(columns_, ", ") + " FROM " + table_;
+    changedSql_ = select + " WHERE " + watermark + " > ? ORDER BY " + watermark;
+    all_ = source.prepareStatement(select + " WHERE " + watermark + " IS NOT NULL ORDER BY " +
+                                   watermark);
+    changed_ = source.prepareStatement(changedSql_);
+
+    const std::string state = toUpper(options.stateTable);
+    if (!SchemaInspector(target).tableExists(state)) {
+        target.ExecuteDDL("CREATE TABLE " + state +
+                          " (SYNC_NAME VARCHAR(63) NOT NULL PRIMARY KEY, WATERMARK VARCHAR(64))");
+    }
+    const std::string type = "TYPE OF COLUMN " + targetTable_ + "." + watermark;
+    load_ = target.prepareStatement("SELECT CAST(WATERMARK AS " + type + ") FROM " + state +
+                                    " WHERE SYNC_NAME = ?");
+    save_ = target.prepareStatement("UPDATE OR INSERT INTO " + state +
+                                    " (SYNC_NAME, WATERMARK) VALUES (?, CAST(CAST(? AS " + type +
+                                    ") AS VARCHAR(64))) MATCHING (SYNC_NAME)");
+}
+
+std::string WatermarkSyncPlan::watermarkBytes(const fbpp::core::RowView& view) const {
+    const fbpp::core::FieldInfo& field = view.metadata().getFieldRef(watermarkIndex_);
+    const auto* data = reinterpret_cast<const char*>(view.data() + field.offset);
+    if (field.type == SQL_VARYING) {
+        uint16_t length = 0;
+        std::memcpy(&length, data, sizeof(length));
+        return std::string(data + sizeof(length), length);
+    }
+    return std::string(data, field.length);
+}
+
+} // namespace fbpp::schema
@@ -0,0 +1,286 @@
+#include "fbpp/services/service_manager.hpp"
+#include "fbpp/services/detail/service_response.hpp"
+#include "fbpp/core/environment.hpp"
+#include "fbpp/core/exception.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+namespace fbpp::services {
+
+using core::Environment;
+using core::FirebirdException;
+using core::detail::XpbBuilderGuard;
+
+namespace {
+
+// Streaming through the service manager uses these gbak file names
+constexpr const char* kStdout = "stdout";
+constexpr const char* kStdin = "stdin";
+
+// An isc_info_svc_line item carries at most a 2-byte length of data
+constexpr size_t kMaxSendChunk = 0xFFFF;
+
+constexpr size_t kMaxIdleQueries = 100000;
+
+std::string_view expectOutput(detail::ServiceResponse& response, unsigned char item, bool& more) {
+    std::string_view value;
+    while (!response.atEnd()) {
+        switch (const unsigned char tag = response.tag()) {
+        case isc_info_truncated:
+        case isc_info_data_not_ready:
+        case isc_info_svc_timeout:
+            more = true;
+            break;
+        case isc_info_end:
+            return value;
+        default:
+            if (tag != item) {
+                throw FirebirdException("Unexpected item " + std::to_string(tag) +
+                                        " in a service output response");
+            }
+            value = response.bytes();
+        }
+    }
+    return value;
+}
+
+} // namespace
+
+XpbBuilderGuard ServiceManager::backupSpb(const std::string& database,
+                                          const std::string& backupFile,
+                                          const BackupOptions& options, bool verbose) {
+    try {
+        auto& st = status();
+        XpbBuilderGuard spb(Environment::getInstance().getUtil()->getXpbBuilder(
+            &st, Firebird::IXpbBuilder::SPB_START, nullptr, 0));
+        spb->insertTag(&st, isc_action_svc_backup);
+        spb->insertString(&st, isc_spb_dbname, database.c_str());
+        spb->insertString(&st, isc_spb_bkp_file, backupFile.c_str());
+        if (verbose) {
+            spb->insertTag(&st, isc_spb_verbose);
+        }
+        unsigned flags = 0;
+        if (options.metadataOnly) {
+            flags |= isc_spb_bkp_metadata_only;
+        }
+        if (options.noGarbageCollect) {
+            flags |= isc_spb_bkp_no_garbage_collect;
+        }
+        if (flags != 0) {
+            spb->insertInt(&st, isc_spb_options, static_cast<int>(flags));
+        }
+        if (options.parallelWorkers > 0) {
+            spb->insertInt(&st, isc_spb_bkp_parallel_workers,
+                           static_cast<int>(options.parallelWorkers));
+        }
+        return spb;
+    } catch (const Firebird::FbException& e) {
+        throw FirebirdException(e);
+    }
+}
+
+XpbBuilderGuard ServiceManager::restoreSpb(const std::string& backupFile,
+                                           const std::string& database,
+                                           const RestoreOptions& options) {
+    try {
+        auto& st = status();
+        XpbBuilderGuard spb(Environment::getInstance().getUtil()->getXpbBuilder(
+            &st, Firebird::IXpbBuilder::SPB_START, nullptr, 0));
+        spb->insertTag(&st, isc_action_svc_restore);
+        spb->insertString(&st, isc_spb_bkp_file, backupFile.c_str());
+        spb->insertString(&st, isc_spb_dbname, database.c_str());
+        if (options.verboseInterval > 0) {
+            spb->insertInt(&st, isc_spb_verbint, static_cast<int>(options.verboseInterval));
+        } else if (options.verbose) {
+            spb->insertTag(&st, isc_spb_verbose);
+        }
+        spb->insertInt(&st, isc_spb_options,
+                       options.replace ? isc_spb_res_replace : isc_spb_res_create);
+        if (options.pageSize > 0) {
+            spb->insertInt(&st, isc_spb_res_page_size, static_cast<int>(options.pageSize));
+        }
+        if (options.parallelWorkers > 0) {
+            spb->insertInt(&st, isc_spb_res_parallel_workers,
+                           static_cast<int>(options.parallelWorkers));
+        }
+        return spb;
+    } catch (const Firebird::FbException& e) {
+        throw FirebirdException(e);
+    }
+}
+
+void ServiceManager::backup(const std::string& database, const std::string& backupFile,
+                            const BackupOptions& options, const LineCallback& onLine) {
+    auto spb = backupSpb(database, backupFile, options, options.verbose);
+    start(spb.get());
+    drainLines(onLine);
+}
+
+void ServiceManager::restore(const std::string& backupFile, const std::string& database,
+                             const RestoreOptions& options, const LineCallback& onLine) {
+    auto spb = restoreSpb(backupFile, database, options);
+    start(spb.get());
+    drainLines(onLine);
+}
+
+uint64_t ServiceManager::backupTo(const std::string& database, const BackupSink& sink,
+                                  const BackupOptions& options, const ProgressCallback& progress) {
+    if (!sink) {
+        throw FirebirdException("ServiceManager::backupTo: no sink");
+    }
+    auto spb = backupSpb(database, kStdout, options, false);
+    start(spb.get());
+
+    ServiceProgress state;
+    for (size_t idle = 0; idle < kMaxIdleQueries;) {
+        query({}, {isc_info_svc_to_eof});
+        detail::ServiceResponse response(response_.data(), response_.size());
+        bool more = false;
+        const std::string_view data = expectOutput(response, isc_info_svc_to_eof, more);
+        if (!data.empty()) {
+            idle = 0;
+            sink(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+            state.bytes += data.size();
+            if (progress) {
+                progress(state);
+            }
+        } else if (!more) {
+            return state.bytes;   // gbak closed its output
+        } else {
+            ++idle;
+        }
+    }
+    throw FirebirdException("Streamed backup produced no data for too long");
+}
+
+uint64_t ServiceManager::restoreFrom(const BackupSource& source, const std::string& database,
+                                     const RestoreOptions& options,
+                                     const ProgressCallback& progress) {
+    if (!source) {
+        throw FirebirdException("ServiceManager::restoreFrom: no source");
+    }
+    auto spb = restoreSpb(kStdin, database, options);
+    start(spb.get());
+
+    ServiceProgress state;
+    std::vector<unsigned char> send;
+    uint32_t requested = 0;   // Bytes gbak asked for in the last response
+    bool exhausted = false;
+    for (size_t idle = 0; idle < kMaxIdleQueries;) {
+        // Answer the previous request; an empty item tells gbak the backup ended
+        size_t sent = 0;
+        send.clear();
+        if (requested > 0) {
+            const size_t want = std::min<size_t>(requested, kMaxSendChunk);
+            send.resize(3 + want);
+            if (!exhausted) {
+                sent = source(send.data() + 3, want);
+                if (sent > want) {
+                    throw FirebirdException(
+                        "ServiceManager::restoreFrom: source overran its buffer");
+                }
+                exhausted = (sent == 0);
+            }
+            send.resize(3 + sent);
+            send[0] = isc_info_svc_line;
+            send[1] = static_cast<unsigned char>(sent & 0xFF);
+            send[2] = static_cast<unsigned char>(sent >> 8);
+        }
+
+        query(send, {isc_info_svc_stdin, isc_info_svc_line});
+        detail::ServiceResponse response(response_.data(), response_.size());
+        std::string_view line;
+        bool more = false;
+        requested = 0;
+        for (bool parsing = true; parsing && !response.atEnd();) {
+            switch (const unsigned char tag = response.tag()) {
+            case isc_info_svc_stdin:
+                requested = response.int4();
+                break;
+            case isc_info_svc_line:
+                line = response.bytes();
+                break;
+            case isc_info_truncated:
+            case isc_info_data_not_ready:
+            case isc_info_svc_timeout:
+                more = true;
+                break;
+            case isc_info_end:
+                parsing = false;
+                break;
+            default:
+                throw FirebirdException("Unexpected item " + std::to_string(tag) +
+                                        " in a service restore response");
+            }
+        }
+
+        if (sent > 0) {
+            state.bytes += sent;
+            state.line = {};
+            if (progress) {
+                progress(state);
+            }
+        }
+        if (!line.empty()) {
+            ++state.lines;
+            state.line = line;
+            if (progress) {
+                progress(state);
+            }
+        }
+        if (sent > 0 || !line.empty()) {
+            idle = 0;
+        } else if (requested == 0 && !more) {
+            return state.bytes;   // Nothing asked, nothing said: the restore is over
+        } else {
+            ++idle;
+        }
+    }
+    throw FirebirdException("Streamed restore made no progress for too long");
+}
+
+uint64_t ServiceManager::backupToFile(const std::string& database,
+                                      const std::filesystem::path& localFile,
+                                      const BackupOptions& options,
+                                      const ProgressCallback& progress) {
+    std::ofstream out(localFile, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw FirebirdException("Cannot create backup file " + localFile.string());
+    }
+    const uint64_t bytes = backupTo(
+        database,
+        [&](const uint8_t* data, size_t size) {
+            out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+            if (!out) {
+                throw FirebirdException("Cannot write backup file " + localFile.string());
+            }
+        },
+        options, progress);
+    out.close();
+    if (!out) {
+        throw FirebirdException("Cannot write backup file " + localFile.string());
+    }
+    return bytes;
+}
+
+uint64_t ServiceManager::restoreFromFile(const std::filesystem::path& localFile,
+                                         const std::string& database,
+                                         const RestoreOptions& options,
+                                         const ProgressCallback& progress) {
+    std::ifstream in(localFile, std::ios::binary);
+    if (!in) {
+        throw FirebirdException("Cannot open backup file " + localFile.string());
+    }
+    return restoreFrom(
+        [&](uint8_t* buffer, size_t capacity) -> size_t {
+            in.read(reinterpret_cast<char*>(buffer), static_cast<std::streamsize>(capacity));
+            if (in.bad()) {
+                throw FirebirdException("Cannot read backup file " + localFile.string());
+            }
+            return static_cast<size_t>(in.gcount());
+        },
+        database, options, progress);
+}
+
+} // namespace fbpp::services
@@ -0,0 +1,46 @@
+#include "fbpp/services/service_manager.hpp"
+#include "fbpp/core/environment.hpp"
+#include "fbpp/core/exception.hpp"
+
+namespace fbpp::services {
+
+using core::Environment;
+using core::FirebirdException;
+using core::detail::XpbBuilderGuard;
+
+void ServiceManager::sweep(const std::string& database, unsigned parallelWorkers) {
+    XpbBuilderGuard spb;
+    try {
+        auto& st = status();
+        spb.reset(Environment::getInstance().getUtil()->getXpbBuilder(
+            &st, Firebird::IXpbBuilder::SPB_START, nullptr, 0));
+        spb->insertTag(&st, isc_action_svc_repair);
+        spb->insertString(&st, isc_spb_dbname, database.c_str());
+        spb->insertInt(&st, isc_spb_options, isc_spb_rpr_sweep_db);
+        if (parallelWorkers > 0) {
+            spb->insertInt(&st, isc_spb_rpr_par_workers, static_cast<int>(parallelWorkers));
+        }
+    } catch (const Firebird::FbException& e) {
+        throw FirebirdException(e);
+    }
+    start(spb.get());
+    drainLines({});
+}
+
+void ServiceManager::setSweepInterval(const std::string& database, unsigned interval) {
+    XpbBuilderGuard spb;
+    try {
+        auto& st = status();
+        spb.reset(Environment::getInstance().getUtil()->getXpbBuilder(
+            &st, Firebird::IXpbBuilder::SPB_START, nullptr, 0));
+        spb->insertTag(&st, isc_action_svc_properties);
+        spb->insertString(&st, isc_spb_dbname, database.c_str());
+        spb->insertInt(&st, isc_spb_prp_sweep_interval, static_cast<int>(interval));
+    } catch (const Firebird::FbException& e) {
+        throw FirebirdException(e);
+    }
+    start(spb.get());
+    drainLines({});
+}
+
+} // namespace fbpp::services
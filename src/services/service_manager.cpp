@@ -0,0 +1,144 @@
+#include "fbpp/services/service_manager.hpp"
+#include "fbpp/services/detail/service_response.hpp"
+#include "fbpp/core/detail/firebird_raii.hpp"
+#include "fbpp/core/environment.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp_util/trace.h"
+
+namespace fbpp::services {
+
+using core::Environment;
+using core::FirebirdException;
+using core::detail::XpbBuilderGuard;
+
+namespace {
+
+// A query response holds one line of text or one chunk of data at most
+constexpr size_t kResponseSize = 64 * 1024;
+
+// Guard against a server that keeps answering "not ready" forever
+constexpr size_t kMaxIdleQueries = 100000;
+
+} // namespace
+
+ServiceManager::ServiceManager(const ServiceConnectParams& params)
+    : status_(Environment::getInstance().getMaster()->getStatus())
+    , statusWrapper_(status_)
+    , response_(kResponseSize) {
+    auto& env = Environment::getInstance();
+    const std::string name =
+        params.server.empty() ? std::string("service_mgr") : params.server + ":service_mgr";
+    try {
+        auto& st = status();
+        XpbBuilderGuard spb(
+            env.getUtil()->getXpbBuilder(&st, Firebird::IXpbBuilder::SPB_ATTACH, nullptr, 0));
+        if (!params.user.empty()) {
+            spb->insertString(&st, isc_spb_user_name, params.user.c_str());
+        }
+        if (!params.password.empty()) {
+            spb->insertString(&st, isc_spb_password, params.password.c_str());
+        }
+        if (!params.role.empty()) {
+            spb->insertString(&st, isc_spb_sql_role_name, params.role.c_str());
+        }
+        service_ = env.getProvider()->attachServiceManager(
+            &st, name.c_str(), spb->getBufferLength(&st), spb->getBuffer(&st));
+    } catch (const Firebird::FbException& e) {
+        FirebirdException error(e);
+        statusWrapper_.dispose();
+        throw error;
+    }
+}
+
+ServiceManager::~ServiceManager() {
+    if (service_) {
+        try {
+            auto& st = status();
+            service_->detach(&st);
+            service_->release();
+        } catch (...) {
+            fbpp::util::trace(fbpp::util::TraceLevel::warn, "Services",
+                              [](auto& oss) { oss << "Error while detaching (ignored)"; });
+        }
+    }
+    statusWrapper_.dispose();
+}
+
+std::string ServiceManager::getServerVersion() {
+    query({}, {isc_info_svc_server_version});
+    detail::ServiceResponse response(response_.data(), response_.size());
+    while (!response.atEnd()) {
+        const unsigned char tag = response.tag();
+        if (tag == isc_info_svc_server_version) {
+            return std::string(response.bytes());
+        }
+        if (tag == isc_info_end) {
+            break;
+        }
+        throw FirebirdException("Unexpected item " + std::to_string(tag) +
+                                " in the server version response");
+    }
+    throw FirebirdException("Service manager returned no server version");
+}
+
+void ServiceManager::start(Firebird::IXpbBuilder* spb) {
+    try {
+        auto& st = status();
+        service_->start(&st, spb->getBufferLength(&st), spb->getBuffer(&st));
+    } catch (const Firebird::FbException& e) {
+        throw FirebirdException(e);
+    }
+}
+
+void ServiceManager::query(const std::vector<unsigned char>& send,
+                           std::initializer_list<unsigned char> receive) {
+    try {
+        auto& st = status();
+        service_->query(&st,
+                        static_cast<unsigned>(send.size()), send.empty() ? nullptr : send.data(),
+                        static_cast<unsigned>(receive.size()), receive.begin(),
+                        static_cast<unsigned>(response_.size()), response_.data());
+    } catch (const Firebird::FbException& e) {
+        throw FirebirdException(e);
+    }
+}
+
+void ServiceManager::drainLines(const LineCallback& onLine) {
+    for (size_t idle = 0; idle < kMaxIdleQueries;) {
+        query({}, {isc_info_svc_line});
+        detail::ServiceResponse response(response_.data(), response_.size());
+        std::string_view line;
+        bool more = false;
+        for (bool parsing = true; parsing && !response.atEnd();) {
+            switch (const unsigned char tag = response.tag()) {
+            case isc_info_svc_line:
+                line = response.bytes();
+                break;
+            case isc_info_truncated:
+            case isc_info_data_not_ready:
+            case isc_info_svc_timeout:
+                more = true;
+                break;
+            case isc_info_end:
+                parsing = false;
+                break;
+            default:
+                throw FirebirdException("Unexpected item " + std::to_string(tag) +
+                                        " in a service output response");
+            }
+        }
+        if (!line.empty()) {
+            idle = 0;
+            if (onLine) {
+                onLine(line);
+            }
+        } else if (!more) {
+            return;   // No more output: the action has finished
+        } else {
+            ++idle;
+        }
+    }
+    throw FirebirdException("Service action produced no output for too long");
+}
+
+} // namespace fbpp::services
@@ -0,0 +1,191 @@
+#include "fbpp_util/connection_helper.hpp"
+#include "fbpp_util/dataset.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <tuple>
+
+using fbpp::core::Connection;
+using fbpp::core::FirebirdException;
+
+namespace {
+
+struct Options {
+    std::string section = "db";
+    std::string dsn;
+    std::string user;
+    std::string password;
+    uint64_t rows = 1'000'000;
+    bool append = false;
+    fbpp::util::DatasetOptions dataset;
+};
+
+void printUsage() {
+    std::cout << R"(Usage: fbpp_datagen [options]
+
+Fills TABLE_TEST_1 (created when missing, same columns as the test fixtures)
+with deterministic synthetic rows of every column type, BLOBs and zoned
+timestamps included, through BulkLoader.
+
+Connection:
+  --section <name>          Config section of config/test_config.json
+                            (default: db; FIREBIRD_* variables override it)
+  --dsn <path>              Database path, overrides the section
+  --user <name>             Database user, overrides the section
+  --password <pass>         Database password, overrides the section
+
+Data:
+  --rows <n>                Rows the table is filled to (default: 1000000)
+  --append                  Add --rows rows instead of filling up to --rows
+  --seed <n>                Generator seed (default: 1)
+  --null-ratio <f>          Share of NULLs per nullable column (default: 0.05)
+  --blob-ratio <f>          Share of rows with BLOBs (default: 0.1)
+  --blob-bytes <n>          Mean BLOB size in bytes (default: 1024)
+  --chunk-rows <n>          Rows per transaction (default: 10000)
+
+Row i (F_INTEGER = i + 1) depends only on the seed and i, so an interrupted
+fill resumes where it stopped and reproduces the same table.
+)";
+}
+
+uint64_t parseCount(const std::string& arg, const std::string& value) {
+    try {
+        return std::stoull(value);
+    } catch (const std::exception&) {
+        throw std::runtime_error("Invalid value for " + arg + ": " + value);
+    }
+}
+
+double parseRatio(const std::string& arg, const std::string& value) {
+    double ratio = 0;
+    try {
+        ratio = std::stod(value);
+    } catch (const std::exception&) {
+        throw std::runtime_error("Invalid value for " + arg + ": " + value);
+    }
+    if (ratio < 0 || ratio > 1) {
+        throw std::runtime_error(arg + " must be between 0 and 1");
+    }
+    return ratio;
+}
+
+std::optional<Options> parseOptions(int argc, char** argv) {
+    Options opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::runtime_error("Missing value for argument " + arg);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--section") {
+            opts.section = next();
+        } else if (arg == "--dsn") {
+            opts.dsn = next();
+        } else if (arg == "--user") {
+            opts.user = next();
+        } else if (arg == "--password") {
+            opts.password = next();
+        } else if (arg == "--rows") {
+            opts.rows = parseCount(arg, next());
+        } else if (arg == "--append") {
+            opts.append = true;
+        } else if (arg == "--seed") {
+            opts.dataset.seed = parseCount(arg, next());
+        } else if (arg == "--null-ratio") {
+            opts.dataset.nullRatio = parseRatio(arg, next());
+        } else if (arg == "--blob-ratio") {
+            opts.dataset.blobRatio = parseRatio(arg, next());
+        } else if (arg == "--blob-bytes") {
+            opts.dataset.blobBytes = static_cast<size_t>(parseCount(arg, next()));
+        } else if (arg == "--chunk-rows") {
+            opts.dataset.chunkRows = static_cast<size_t>(parseCount(arg, next()));
+        } else if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return std::nullopt;
+        } else {
+            throw std::runtime_error("Unknown argument: " + arg);
+        }
+    }
+    if (opts.dataset.chunkRows == 0) {
+        throw std::runtime_error("--chunk-rows must be positive");
+    }
+    return opts;
+}
+
+int64_t scalar(Connection& connection, const std::string& sql) {
+    auto tx = connection.StartTransaction();
+    auto cursor = tx->openCursor(connection.prepareStatement(sql));
+    std::tuple<std::optional<int64_t>> row;
+    const bool found = cursor->fetch(row);
+    cursor->close();
+    tx->Commit();
+    return found && std::get<0>(row) ? *std::get<0>(row) : 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        auto optsOpt = parseOptions(argc, argv);
+        if (!optsOpt.has_value()) {
+            return 0;
+        }
+        auto& opts = optsOpt.value();
+
+        auto params = fbpp::util::getConnectionParams(opts.section);
+        if (!opts.dsn.empty()) {
+            params.database = opts.dsn;
+        }
+        if (!opts.user.empty()) {
+            params.user = opts.user;
+        }
+        if (!opts.password.empty()) {
+            params.password = opts.password;
+        }
+
+        Connection connection(params);
+        fbpp::util::ensureDatasetTable(connection);
+        // Rows continue after the highest F_INTEGER, so reruns resume
+        const auto present = static_cast<uint64_t>(
+            scalar(connection, "SELECT MAX(F_INTEGER) FROM TABLE_TEST_1"));
+        opts.dataset.firstRow = present;
+        opts.dataset.rows = opts.append ? opts.rows : (opts.rows > present ? opts.rows - present : 0);
+        if (opts.dataset.rows == 0) {
+            std::cout << "TABLE_TEST_1 already holds " << present << " rows\n";
+            return 0;
+        }
+
+        std::cout << "Adding " << opts.dataset.rows << " rows after F_INTEGER " << present
+                  << " (seed " << opts.dataset.seed << ")\n";
+        const auto started = std::chrono::steady_clock::now();
+        opts.dataset.progress = [&](uint64_t done) {
+            const double seconds =
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+            std::printf("\r%llu / %llu rows, %.0f rows/s", static_cast<unsigned long long>(done),
+                        static_cast<unsigned long long>(opts.dataset.rows),
+                        seconds > 0 ? static_cast<double>(done) / seconds : 0.0);
+            std::fflush(stdout);
+        };
+        const uint64_t added = fbpp::util::generateDataset(connection, opts.dataset);
+        std::printf("\nAdded %llu rows\n", static_cast<unsigned long long>(added));
+        return 0;
+    } catch (const FirebirdException& e) {
+        std::cerr << "\nFirebird exception: " << e.what() << "\n";
+        return 1;
+    } catch (const std::exception& e) {
+        std::cerr << "\nError: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,432 @@
+#include "fbpp_util/connection_helper.hpp"
+#include "fbpp_util/dataset.hpp"
+#include "fbpp/core/batch.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/statement_metrics.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/transaction_options.hpp"
+#include <nlohmann/json.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using fbpp::core::Connection;
+using fbpp::core::FirebirdException;
+using fbpp::core::LatencyHistogram;
+using fbpp::core::ServerCounters;
+
+namespace {
+
+// Operations of the mix, in report order
+enum Op { Select, Insert, Update, Procedure, kOpCount };
+constexpr std::array<const char*, kOpCount> kOpNames{"select", "insert", "update", "proc"};
+
+const std::string kSelectSql =
+    "SELECT ID, F_INTEGER, F_BIGINT, F_VARCHAR, F_DOUBLE_PRECISION, F_TIMESHTAMP "
+    "FROM TABLE_TEST_1 WHERE ID = ?";
+const std::string kInsertSql =
+    "INSERT INTO TABLE_TEST_1 (F_INTEGER, F_BIGINT, F_VARCHAR, F_DOUBLE_PRECISION, F_TIMESHTAMP) "
+    "VALUES (?, ?, ?, ?, LOCALTIMESTAMP)";
+const std::string kUpdateSql =
+    "UPDATE TABLE_TEST_1 SET F_BIGINT = COALESCE(F_BIGINT, 0) + 1 WHERE ID = ?";
+const std::string kProcedureSql = "EXECUTE PROCEDURE LOADGEN_TOUCH(?)";
+
+const char* kCreateProcedure =
+    "CREATE OR ALTER PROCEDURE LOADGEN_TOUCH (P_ID INTEGER) RETURNS (R_BIGINT BIGINT) AS "
+    "BEGIN "
+    "  UPDATE TABLE_TEST_1 SET F_BIGINT = COALESCE(F_BIGINT, 0) + 1 WHERE ID = :P_ID "
+    "  RETURNING F_BIGINT INTO :R_BIGINT; "
+    "END";
+
+struct Options {
+    std::string section = "db";
+    std::string dsn;
+    std::string user;
+    std::string password;
+    unsigned threads = 4;
+    unsigned connections = 1;          // Per thread
+    double seconds = 10;
+    std::array<unsigned, kOpCount> mix{70, 10, 15, 5};
+    unsigned batchSize = 100;
+    int32_t seedRows = 10000;
+    uint64_t seed = 1;                 // fbpp::util::DatasetOptions::seed
+    std::string jsonPath;
+};
+
+void printUsage() {
+    std::cout << R"(Usage: fbpp_loadgen [options]
+
+Runs a mix of point selects, Batch inserts, updates and procedure calls on
+TABLE_TEST_1 (created and seeded when missing) and reports throughput,
+latency percentiles and the attachments' server counters.
+
+Connection:
+  --section <name>          Config section of config/test_config.json
+                            (default: db; FIREBIRD_* variables override it)
+  --dsn <path>              Database path, overrides the section
+  --user <name>             Database user, overrides the section
+  --password <pass>         Database password, overrides the section
+
+Load:
+  --threads <n>             Worker threads (default: 4)
+  --connections <m>         Attachments per thread, used in turn (default: 1)
+  --duration <seconds>      Run time (default: 10)
+  --mix <s,i,u,p>           Weights of select, insert, update and procedure
+                            call (default: 70,10,15,5)
+  --batch-size <n>          Rows per Batch insert (default: 100)
+  --seed-rows <n>           Rows TABLE_TEST_1 is filled to first (default: 10000)
+  --seed <n>                Seed of those rows, as in fbpp_datagen (default: 1)
+  --json <file>             Also write the report as JSON
+
+Every operation runs in its own READ COMMITTED transaction. The load writes:
+point it at a scratch database.
+)";
+}
+
+unsigned parseUnsigned(const std::string& arg, const std::string& value) {
+    try {
+        return static_cast<unsigned>(std::stoul(value));
+    } catch (const std::exception&) {
+        throw std::runtime_error("Invalid value for " + arg + ": " + value);
+    }
+}
+
+std::optional<Options> parseOptions(int argc, char** argv) {
+    Options opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::runtime_error("Missing value for argument " + arg);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--section") {
+            opts.section = next();
+        } else if (arg == "--dsn") {
+            opts.dsn = next();
+        } else if (arg == "--user") {
+            opts.user = next();
+        } else if (arg == "--password") {
+            opts.password = next();
+        } else if (arg == "--threads") {
+            opts.threads = parseUnsigned(arg, next());
+        } else if (arg == "--connections") {
+            opts.connections = parseUnsigned(arg, next());
+        } else if (arg == "--duration") {
+            const auto value = next();
+            try {
+                opts.seconds = std::stod(value);
+            } catch (const std::exception&) {
+                throw std::runtime_error("Invalid value for --duration: " + value);
+            }
+        } else if (arg == "--mix") {
+            std::istringstream in(next());
+            std::string part;
+            for (unsigned op = 0; op < kOpCount; ++op) {
+                if (!std::getline(in, part, ',')) {
+                    throw std::runtime_error("--mix needs four comma-separated weights");
+                }
+                opts.mix[op] = parseUnsigned(arg, part);
+            }
+        } else if (arg == "--batch-size") {
+            opts.batchSize = parseUnsigned(arg, next());
+        } else if (arg == "--seed-rows") {
+            opts.seedRows = static_cast<int32_t>(parseUnsigned(arg, next()));
+        } else if (arg == "--seed") {
+            const auto value = next();
+            try {
+                opts.seed = std::stoull(value);
+            } catch (const std::exception&) {
+                throw std::runtime_error("Invalid value for --seed: " + value);
+            }
+        } else if (arg == "--json") {
+            opts.jsonPath = next();
+        } else if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return std::nullopt;
+        } else {
+            throw std::runtime_error("Unknown argument: " + arg);
+        }
+    }
+
+    if (opts.threads == 0 || opts.connections == 0 || opts.batchSize == 0 || opts.seedRows <= 0) {
+        throw std::runtime_error("--threads, --connections, --batch-size and --seed-rows must be positive");
+    }
+    unsigned total = 0;
+    for (unsigned weight : opts.mix) {
+        total += weight;
+    }
+    if (total == 0) {
+        throw std::runtime_error("--mix must give at least one operation a weight");
+    }
+    return opts;
+}
+
+using InsertRow = std::tuple<int32_t, int64_t, std::string, double>;
+
+InsertRow insertRow(int32_t key) {
+    return {key, key * 10LL, "loadgen " + std::to_string(key), key * 0.25};
+}
+
+template<typename T>
+T scalar(Connection& connection, const std::string& sql) {
+    auto tx = connection.StartTransaction();
+    auto cursor = tx->openCursor(connection.prepareStatement(sql));
+    std::tuple<std::optional<T>> row;
+    const bool found = cursor->fetch(row);
+    cursor->close();
+    tx->Commit();
+    return found && std::get<0>(row) ? *std::get<0>(row) : T{};
+}
+
+// Schema, procedure and seed rows; returns the first free F_INTEGER
+int32_t prepareSchema(Connection& connection, const Options& opts) {
+    fbpp::util::ensureDatasetTable(connection);
+    connection.ExecuteDDL(kCreateProcedure);
+
+    int32_t nextKey = scalar<int32_t>(connection, "SELECT MAX(F_INTEGER) FROM TABLE_TEST_1") + 1;
+    int64_t rows = scalar<int64_t>(connection, "SELECT COUNT(*) FROM TABLE_TEST_1");
+    if (rows < opts.seedRows) {
+        // The fbpp_datagen rows: every column type filled, BLOBs included
+        std::cout << "Seeding TABLE_TEST_1 with " << (opts.seedRows - rows) << " rows\n";
+        fbpp::util::DatasetOptions dataset;
+        dataset.seed = opts.seed;
+        dataset.firstRow = static_cast<uint64_t>(nextKey - 1);
+        dataset.rows = static_cast<uint64_t>(opts.seedRows - rows);
+        nextKey += static_cast<int32_t>(fbpp::util::generateDataset(connection, dataset));
+    }
+    return nextKey;
+}
+
+struct Shared {
+    std::array<LatencyHistogram, kOpCount> latency;
+    std::array<std::atomic<uint64_t>, kOpCount> errors{};
+    std::atomic<uint64_t> insertedRows{0};
+    std::atomic<int32_t> nextKey{0};
+    int32_t maxId = 0;
+    std::mutex mutex;
+    ServerCounters server;       // Summed over every attachment
+    std::string firstError;
+};
+
+void worker(const fbpp::core::ConnectionParams& params, const Options& opts, Shared& shared,
+            unsigned index, std::chrono::steady_clock::time_point deadline) {
+    struct Attachment {
+        std::unique_ptr<Connection> connection;
+        std::array<std::shared_ptr<fbpp::core::Statement>, kOpCount> statements;
+        ServerCounters before;
+    };
+    std::vector<Attachment> attachments(opts.connections);
+    for (auto& a : attachments) {
+        a.connection = std::make_unique<Connection>(params);
+        a.statements[Select] = a.connection->prepareStatement(kSelectSql);
+        a.statements[Insert] = a.connection->prepareStatement(kInsertSql);
+        a.statements[Update] = a.connection->prepareStatement(kUpdateSql);
+        a.statements[Procedure] = a.connection->prepareStatement(kProcedureSql);
+        a.before = a.connection->getServerCounters();
+    }
+
+    std::mt19937 rng(1000003u * (index + 1));
+    std::discrete_distribution<unsigned> pick(opts.mix.begin(), opts.mix.end());
+    std::uniform_int_distribution<int32_t> anyId(1, std::max(shared.maxId, 1));
+    const auto txOptions = fbpp::core::TransactionOptions{fbpp::core::TxIsolation::ReadCommittedRecordVersion};
+    std::vector<InsertRow> rows;
+
+    for (size_t turn = 0; std::chrono::steady_clock::now() < deadline; ++turn) {
+        auto& a = attachments[turn % attachments.size()];
+        const unsigned op = pick(rng);
+        const int32_t id = anyId(rng);
+        const auto started = std::chrono::steady_clock::now();
+        try {
+            auto tx = a.connection->StartTransaction(txOptions);
+            switch (op) {
+                case Select: {
+                    auto cursor = tx->openCursor(a.statements[Select], std::make_tuple(id));
+                    std::tuple<int32_t, std::optional<int32_t>, std::optional<int64_t>,
+                               std::optional<std::string>, std::optional<double>,
+                               std::optional<fbpp::core::Timestamp>> row;
+                    cursor->fetch(row);
+                    cursor->close();
+                    break;
+                }
+                case Insert: {
+                    rows.clear();
+                    const int32_t first = shared.nextKey.fetch_add(static_cast<int32_t>(opts.batchSize));
+                    for (unsigned i = 0; i < opts.batchSize; ++i) {
+                        rows.push_back(insertRow(first + static_cast<int32_t>(i)));
+                    }
+                    auto batch = a.statements[Insert]->createBatch(tx.get(), false);
+                    batch->addMany(rows);
+                    batch->execute(tx.get());
+                    break;
+                }
+                case Update:
+                    tx->execute(a.statements[Update], std::make_tuple(id));
+                    break;
+                case Procedure:
+                    tx->execute(a.statements[Procedure], std::make_tuple(id),
+                                std::tuple<std::optional<int64_t>>{});
+                    break;
+            }
+            tx->Commit();
+            shared.latency[op].record(std::chrono::steady_clock::now() - started);
+            if (op == Insert) {
+                shared.insertedRows.fetch_add(opts.batchSize, std::memory_order_relaxed);
+            }
+        } catch (const std::exception& e) {
+            shared.errors[op].fetch_add(1, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            if (shared.firstError.empty()) {
+                shared.firstError = std::string(kOpNames[op]) + ": " + e.what();
+            }
+        }
+    }
+
+    for (auto& a : attachments) {
+        const auto delta = ServerCounters::delta(a.connection->getServerCounters(), a.before);
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        shared.server += delta;
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        auto optsOpt = parseOptions(argc, argv);
+        if (!optsOpt.has_value()) {
+            return 0;
+        }
+        const auto& opts = optsOpt.value();
+
+        auto params = fbpp::util::getConnectionParams(opts.section);
+        if (!opts.dsn.empty()) {
+            params.database = opts.dsn;
+        }
+        if (!opts.user.empty()) {
+            params.user = opts.user;
+        }
+        if (!opts.password.empty()) {
+            params.password = opts.password;
+        }
+
+        Shared shared;
+        {
+            Connection setup(params);
+            shared.nextKey = prepareSchema(setup, opts);
+            shared.maxId = scalar<int32_t>(setup, "SELECT MAX(ID) FROM TABLE_TEST_1");
+        }
+
+        std::cout << "Running " << opts.threads << " threads x " << opts.connections
+                  << " connections for " << opts.seconds << " s\n";
+        const auto started = std::chrono::steady_clock::now();
+        const auto deadline = started + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                            std::chrono::duration<double>(opts.seconds));
+        std::vector<std::thread> threads;
+        std::vector<std::exception_ptr> failures(opts.threads);
+        for (unsigned t = 0; t < opts.threads; ++t) {
+            threads.emplace_back([&, t] {
+                try {
+                    worker(params, opts, shared, t, deadline);
+                } catch (...) {
+                    failures[t] = std::current_exception();
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        for (const auto& failure : failures) {
+            if (failure) {
+                std::rethrow_exception(failure);   // Could not connect / prepare
+            }
+        }
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+        nlohmann::json report{{"threads", opts.threads},
+                              {"connections", opts.connections},
+                              {"seconds", elapsed}};
+        std::printf("\n%-8s %10s %8s %10s %10s %10s %10s %10s\n", "op", "count", "errors",
+                    "ops/s", "mean_us", "p50_us", "p99_us", "p999_us");
+        uint64_t totalOps = 0;
+        for (unsigned op = 0; op < kOpCount; ++op) {
+            const auto snap = shared.latency[op].snapshot();
+            const uint64_t errors = shared.errors[op].load();
+            totalOps += snap.count;
+            std::printf("%-8s %10llu %8llu %10.1f %10.1f %10llu %10llu %10llu\n", kOpNames[op],
+                        static_cast<unsigned long long>(snap.count),
+                        static_cast<unsigned long long>(errors),
+                        static_cast<double>(snap.count) / elapsed, snap.meanMicros(),
+                        static_cast<unsigned long long>(snap.p50Micros),
+                        static_cast<unsigned long long>(snap.p99Micros),
+                        static_cast<unsigned long long>(snap.p999Micros));
+            report["ops"][kOpNames[op]] = {{"count", snap.count},
+                                           {"errors", errors},
+                                           {"ops_per_second", static_cast<double>(snap.count) / elapsed},
+                                           {"mean_us", snap.meanMicros()},
+                                           {"p50_us", snap.p50Micros},
+                                           {"p99_us", snap.p99Micros},
+                                           {"p999_us", snap.p999Micros}};
+        }
+        std::printf("total    %10llu operations, %.1f ops/s, %.1f inserted rows/s\n",
+                    static_cast<unsigned long long>(totalOps), static_cast<double>(totalOps) / elapsed,
+                    static_cast<double>(shared.insertedRows.load()) / elapsed);
+
+        const auto tables = shared.server.totals();
+        std::printf("server   reads=%llu writes=%llu fetches=%llu marks=%llu "
+                    "seq=%llu idx=%llu ins=%llu upd=%llu\n",
+                    static_cast<unsigned long long>(shared.server.reads),
+                    static_cast<unsigned long long>(shared.server.writes),
+                    static_cast<unsigned long long>(shared.server.fetches),
+                    static_cast<unsigned long long>(shared.server.marks),
+                    static_cast<unsigned long long>(tables.seqReads),
+                    static_cast<unsigned long long>(tables.idxReads),
+                    static_cast<unsigned long long>(tables.inserts),
+                    static_cast<unsigned long long>(tables.updates));
+        report["server"] = {{"reads", shared.server.reads},
+                            {"writes", shared.server.writes},
+                            {"fetches", shared.server.fetches},
+                            {"marks", shared.server.marks},
+                            {"seq_reads", tables.seqReads},
+                            {"idx_reads", tables.idxReads},
+                            {"inserts", tables.inserts},
+                            {"updates", tables.updates}};
+        if (!shared.firstError.empty()) {
+            std::printf("first error: %s\n", shared.firstError.c_str());
+        }
+
+        if (!opts.jsonPath.empty()) {
+            std::ofstream out(opts.jsonPath, std::ios::binary | std::ios::trunc);
+            if (!out) {
+                throw std::runtime_error("Failed to open report file: " + opts.jsonPath);
+            }
+            out << report.dump(2) << '\n';
+        }
+        return 0;
+    } catch (const FirebirdException& e) {
+        std::cerr << "Firebird exception: " << e.what() << "\n";
+        return 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -1,11 +1,16 @@
 #include "fbpp/query_generator_service.hpp"
 #include "fbpp/core/connection.hpp"
 #include "fbpp/core/exception.hpp"
+#include "fbpp/core/output_coercion.hpp"
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
@@ -13,10 +18,13 @@
 using fbpp::core::Connection;
 using fbpp::core::ConnectionParams;
 using fbpp::core::FirebirdException;
+using fbpp::core::OutputCoercion;
 using fbpp::core::QueryDefinition;
 using fbpp::core::QueryGeneratorService;
+using fbpp::core::QuerySpecCache;
 using fbpp::core::renderQueryGeneratorMainHeader;
 using fbpp::core::renderQueryGeneratorSupportHeader;
+using fbpp::core::renderQueryPlanReport;
 
 namespace {
 
@@ -28,6 +36,10 @@ struct Options {
     std::filesystem::path inputPath;
     std::filesystem::path outputHeader;
     std::filesystem::path supportHeader;
+    std::filesystem::path cachePath;
+    std::filesystem::path plansPath;
+    std::uint64_t largeTableRows = 10000;
+    unsigned jobs = 1;
 
     // Adapter configuration
     bool useTTMathNumeric = false;
@@ -36,6 +48,8 @@ struct Options {
     bool useCppDecimalDecFloat = false;
     bool useStringForTextBlob = false;
     bool generateAliases = true;
+    unsigned inlineStringBytes = 0;
+    std::string outputCoercion;
 };
 
 void printUsage() {
@@ -51,6 +65,14 @@ Optional arguments:
   --user <name>             Database user (default: SYSDBA)
   --password <pass>         Database password (default: planomer)
   --charset <charset>       Character set (default: UTF8)
+  --jobs <n>                Prepare queries over up to n connections (default: 1)
+  --cache <file.json>       Reuse query specs from an earlier run while the
+                            schema is unchanged; headers whose contents do not
+                            change are never rewritten
+  --plans <file.txt>        Write every query's plan to a text file meant to be
+                            committed, so plan changes show up as a diff
+  --large-table-rows <n>    Warn about NATURAL scans of tables with at least n
+                            rows (default: 10000)
 
 Adapter options:
   --use-ttmath-numeric      Use TTMath for NUMERIC(38,x) types
@@ -59,6 +81,12 @@ Adapter options:
   --use-cppdecimal          Use CppDecimal for DECFLOAT types
   --use-string-blob         Use std::string for text BLOB (SUB_TYPE 1)
   --no-aliases              Do not generate type aliases (using declarations)
+  --inline-strings <bytes>  Use fbpp::core::FixedString<N> for CHAR/VARCHAR of
+                            up to <bytes> bytes (no allocation per value)
+  --output-coercion <spec>  Have the server convert SELECT output columns, e.g.
+                            "NUMERIC=DOUBLE;DECFLOAT=VARCHAR;TIMEZONE=TIMESTAMP"
+                            or column:<name>=<target>; targets NATIVE, DOUBLE,
+                            BIGINT, VARCHAR, TIMESTAMP
 
 Examples:
   # Generate with core types only (default)
@@ -101,6 +129,27 @@ std::optional<Options> parseOptions(int argc, char** argv) {
             opts.outputHeader = next();
         } else if (arg == "--support") {
             opts.supportHeader = next();
+        } else if (arg == "--cache") {
+            opts.cachePath = next();
+        } else if (arg == "--plans") {
+            opts.plansPath = next();
+        } else if (arg == "--large-table-rows") {
+            const auto value = next();
+            try {
+                opts.largeTableRows = std::stoull(value);
+            } catch (const std::exception&) {
+                throw std::runtime_error("Invalid value for --large-table-rows: " + value);
+            }
+        } else if (arg == "--jobs") {
+            const auto value = next();
+            try {
+                opts.jobs = static_cast<unsigned>(std::stoul(value));
+            } catch (const std::exception&) {
+                opts.jobs = 0;
+            }
+            if (opts.jobs == 0) {
+                throw std::runtime_error("Invalid value for --jobs: " + value);
+            }
         } else if (arg == "--use-ttmath-numeric") {
             opts.useTTMathNumeric = true;
         } else if (arg == "--use-ttmath-int128") {
@@ -113,6 +162,21 @@ std::optional<Options> parseOptions(int argc, char** argv) {
             opts.useStringForTextBlob = true;
         } else if (arg == "--no-aliases") {
             opts.generateAliases = false;
+        } else if (arg == "--inline-strings") {
+            const auto value = next();
+            try {
+                opts.inlineStringBytes = static_cast<unsigned>(std::stoul(value));
+            } catch (const std::exception&) {
+                throw std::runtime_error("Invalid value for --inline-strings: " + value);
+            }
+        } else if (arg == "--output-coercion") {
+            const auto value = next();
+            try {
+                opts.outputCoercion = OutputCoercion::parse(value).toString();
+            } catch (const std::exception& e) {
+                throw std::runtime_error("Invalid value for --output-coercion: " +
+                                         std::string(e.what()));
+            }
         } else if (arg == "--help" || arg == "-h") {
             printUsage();
             return std::nullopt;
@@ -135,7 +199,14 @@ void ensureParentDir(const std::filesystem::path& filePath) {
     }
 }
 
-void writeToFile(const std::filesystem::path& filePath, const std::string& contents) {
+// Leave an up-to-date header alone so its mtime does not trigger rebuilds
+void writeIfChanged(const std::filesystem::path& filePath, const std::string& contents) {
+    {
+        std::ifstream in(filePath, std::ios::binary);
+        if (in && std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()) == contents) {
+            return;
+        }
+    }
     ensureParentDir(filePath);
     std::ofstream out(filePath, std::ios::binary);
     if (!out) {
@@ -171,7 +242,6 @@ int main(int argc, char** argv) {
         params.charset = opts.charset;
 
         Connection connection(params);
-        QueryGeneratorService service(connection);
 
         std::vector<QueryDefinition> definitions;
         definitions.reserve(jsonQueries.size());
@@ -194,15 +264,49 @@ int main(int argc, char** argv) {
         config.useCppDecimalDecFloat = opts.useCppDecimalDecFloat;
         config.useStringForTextBlob = opts.useStringForTextBlob;
         config.generateAliases = opts.generateAliases;
+        config.inlineStringBytes = opts.inlineStringBytes;
+        config.outputCoercion = opts.outputCoercion;
+
+        std::unique_ptr<QuerySpecCache> cache;
+        std::size_t pending = definitions.size();
+        if (!opts.cachePath.empty()) {
+            ensureParentDir(opts.cachePath);
+            cache = std::make_unique<QuerySpecCache>(opts.cachePath.string(),
+                                                     QuerySpecCache::fingerprintOf(connection));
+            pending = static_cast<std::size_t>(std::count_if(
+                definitions.begin(), definitions.end(),
+                [&](const QueryDefinition& d) { return !cache->contains(d, config); }));
+        }
 
-        const auto specs = service.buildQuerySpecs(definitions, config);
+        // Extra attachments only for the definitions that need a prepare
+        std::vector<std::unique_ptr<Connection>> extra;
+        std::vector<Connection*> connections{&connection};
+        while (connections.size() < std::min<std::size_t>(opts.jobs, pending)) {
+            extra.push_back(std::make_unique<Connection>(params));
+            connections.push_back(extra.back().get());
+        }
+
+        const auto specs = QueryGeneratorService::buildQuerySpecs(connections, definitions, config, cache.get());
+        if (cache) {
+            cache->save();
+        }
         const auto supportHeaderName = opts.supportHeader.filename().string();
 
         const auto mainHeader = renderQueryGeneratorMainHeader(specs, supportHeaderName, config);
         const auto supportHeader = renderQueryGeneratorSupportHeader(specs, config);
 
-        writeToFile(opts.outputHeader, mainHeader);
-        writeToFile(opts.supportHeader, supportHeader);
+        writeIfChanged(opts.outputHeader, mainHeader);
+        writeIfChanged(opts.supportHeader, supportHeader);
+
+        for (const auto& spec : specs) {
+            for (const auto& scan : fbpp::core::largeNaturalScans(spec, opts.largeTableRows)) {
+                std::cerr << "Warning: query '" << spec.name << "' reads large table "
+                          << scan.table << " (~" << *scan.estimatedRows << " rows) in NATURAL order\n";
+            }
+        }
+        if (!opts.plansPath.empty()) {
+            writeIfChanged(opts.plansPath, renderQueryPlanReport(specs, opts.largeTableRows));
+        }
 
         return 0;
     } catch (const FirebirdException& e) {
@@ -0,0 +1,209 @@
+#include "fbpp_util/connection_helper.hpp"
+#include "fbpp_util/workload.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/exception.hpp"
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+
+using fbpp::core::Connection;
+using fbpp::core::FirebirdException;
+
+namespace {
+
+struct Options {
+    std::string workloadPath;
+    std::string section = "db";
+    std::string dsn;
+    std::string user;
+    std::string password;
+    std::string baselinePath;
+    std::string writeBaselinePath;
+    double threshold = 0.10;
+    unsigned iterations = 1;
+    unsigned warmup = 1;
+    uint64_t minCalls = 5;
+};
+
+void printUsage() {
+    std::cout << R"(Usage: fbpp_replay --workload <file> [options]
+
+Replays a workload recorded with fbpp::util::WorkloadRecorder against a test
+database and reports per-statement latency.
+
+Connection:
+  --section <name>          Config section of config/test_config.json
+                            (default: db; FIREBIRD_* variables override it)
+  --dsn <path>              Database path, overrides the section
+  --user <name>             Database user, overrides the section
+  --password <pass>         Database password, overrides the section
+
+Replay:
+  --iterations <n>          Timed passes over the workload (default: 1)
+  --warmup <n>              Untimed passes before them (default: 1)
+
+Baseline:
+  --write-baseline <file>   Save this run's timings
+  --baseline <file>         Compare p50 per statement with a saved run
+  --threshold <fraction>    Allowed slowdown (default: 0.10 = 10%)
+  --min-calls <n>           Skip statements timed fewer times (default: 5)
+
+Exit status: 0 ok, 1 error, 2 a statement regressed beyond the threshold.
+Replaying writes: use a scratch copy of the database.
+)";
+}
+
+unsigned parseUnsigned(const std::string& arg, const std::string& value) {
+    try {
+        return static_cast<unsigned>(std::stoul(value));
+    } catch (const std::exception&) {
+        throw std::runtime_error("Invalid value for " + arg + ": " + value);
+    }
+}
+
+std::optional<Options> parseOptions(int argc, char** argv) {
+    Options opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::runtime_error("Missing value for argument " + arg);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--workload") {
+            opts.workloadPath = next();
+        } else if (arg == "--section") {
+            opts.section = next();
+        } else if (arg == "--dsn") {
+            opts.dsn = next();
+        } else if (arg == "--user") {
+            opts.user = next();
+        } else if (arg == "--password") {
+            opts.password = next();
+        } else if (arg == "--baseline") {
+            opts.baselinePath = next();
+        } else if (arg == "--write-baseline") {
+            opts.writeBaselinePath = next();
+        } else if (arg == "--threshold") {
+            const auto value = next();
+            try {
+                opts.threshold = std::stod(value);
+            } catch (const std::exception&) {
+                throw std::runtime_error("Invalid value for --threshold: " + value);
+            }
+        } else if (arg == "--iterations") {
+            opts.iterations = parseUnsigned(arg, next());
+        } else if (arg == "--warmup") {
+            opts.warmup = parseUnsigned(arg, next());
+        } else if (arg == "--min-calls") {
+            opts.minCalls = parseUnsigned(arg, next());
+        } else if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return std::nullopt;
+        } else {
+            throw std::runtime_error("Unknown argument: " + arg);
+        }
+    }
+
+    if (opts.workloadPath.empty()) {
+        throw std::runtime_error("Missing required argument --workload.");
+    }
+    return opts;
+}
+
+std::string shortSql(const std::string& sql) {
+    std::string text;
+    for (char c : sql) {
+        const bool space = c == '\n' || c == '\r' || c == '\t' || c == ' ';
+        if (space && (text.empty() || text.back() == ' ')) {
+            continue;
+        }
+        text.push_back(space ? ' ' : c);
+    }
+    return text.size() > 60 ? text.substr(0, 57) + "..." : text;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        auto optsOpt = parseOptions(argc, argv);
+        if (!optsOpt.has_value()) {
+            return 0;
+        }
+        const auto& opts = optsOpt.value();
+
+        auto params = fbpp::util::getConnectionParams(opts.section);
+        if (!opts.dsn.empty()) {
+            params.database = opts.dsn;
+        }
+        if (!opts.user.empty()) {
+            params.user = opts.user;
+        }
+        if (!opts.password.empty()) {
+            params.password = opts.password;
+        }
+
+        const auto workload = fbpp::util::readWorkload(opts.workloadPath);
+        Connection connection(params);
+
+        fbpp::util::ReplayOptions replay;
+        replay.iterations = opts.iterations;
+        replay.warmup = opts.warmup;
+        const auto timings = fbpp::util::replayWorkload(connection, workload, replay);
+
+        std::printf("%-16s %8s %6s %10s %10s %10s %10s  %s\n", "statement", "calls", "fail",
+                    "mean_us", "p50_us", "p99_us", "recorded", "sql");
+        for (const auto& [fingerprint, t] : timings) {
+            std::printf("%016llx %8llu %6llu %10.1f %10.1f %10.1f %10.1f  %s\n",
+                        static_cast<unsigned long long>(fingerprint),
+                        static_cast<unsigned long long>(t.calls),
+                        static_cast<unsigned long long>(t.failures),
+                        t.meanMicros, t.p50Micros, t.p99Micros, t.recordedMeanMicros,
+                        shortSql(t.sql).c_str());
+        }
+
+        if (!opts.writeBaselinePath.empty()) {
+            std::ofstream out(opts.writeBaselinePath, std::ios::binary | std::ios::trunc);
+            if (!out) {
+                throw std::runtime_error("Failed to open baseline file: " + opts.writeBaselinePath);
+            }
+            out << fbpp::util::timingsToJson(timings).dump(2) << '\n';
+        }
+
+        if (!opts.baselinePath.empty()) {
+            std::ifstream in(opts.baselinePath, std::ios::binary);
+            if (!in) {
+                throw std::runtime_error("Failed to open baseline file: " + opts.baselinePath);
+            }
+            const auto baseline = nlohmann::json::parse(in);
+            const auto regressions =
+                fbpp::util::compareToBaseline(timings, baseline, opts.threshold, opts.minCalls);
+            for (const auto& r : regressions) {
+                std::printf("REGRESSION %016llx p50 %.1f -> %.1f us (%+.1f%%)  %s\n",
+                            static_cast<unsigned long long>(r.fingerprint),
+                            r.baselineMicros, r.currentMicros, r.change * 100.0,
+                            shortSql(r.sql).c_str());
+            }
+            if (!regressions.empty()) {
+                return 2;
+            }
+            std::printf("No statement slower than the baseline by more than %.0f%%\n",
+                        opts.threshold * 100.0);
+        }
+        return 0;
+    } catch (const FirebirdException& e) {
+        std::cerr << "Firebird exception: " << e.what() << "\n";
+        return 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+}
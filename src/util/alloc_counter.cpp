@@ -0,0 +1,180 @@
+#include "fbpp_util/alloc_counter.hpp"
+
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace {
+
+// Plain integers: no constructor or destructor, so they are usable from
+// operator new at any point of a thread's life
+thread_local std::size_t t_allocations = 0;
+thread_local std::size_t t_deallocations = 0;
+thread_local std::size_t t_bytes = 0;
+
+void* allocateRaw(std::size_t size, std::size_t alignment) noexcept {
+    if (size == 0) {
+        size = 1;   // Every new returns a distinct pointer
+    }
+    if (alignment <= alignof(std::max_align_t)) {
+        return std::malloc(size);
+    }
+#ifdef _WIN32
+    return _aligned_malloc(size, alignment);
+#else
+    // aligned_alloc wants a multiple of the alignment
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+}
+
+void releaseRaw(void* ptr, std::size_t alignment) noexcept {
+    if (!ptr) {
+        return;
+    }
+    ++t_deallocations;
+#ifdef _WIN32
+    if (alignment > alignof(std::max_align_t)) {
+        _aligned_free(ptr);
+        return;
+    }
+#else
+    (void)alignment;
+#endif
+    std::free(ptr);
+}
+
+void* allocateCounted(std::size_t size, std::size_t alignment) noexcept {
+    ++t_allocations;
+    t_bytes += size;
+    return allocateRaw(size, alignment);
+}
+
+// Throwing forms: retry through the new-handler, as the default operator new does
+void* allocateOrThrow(std::size_t size, std::size_t alignment) {
+    ++t_allocations;
+    t_bytes += size;
+    for (;;) {
+        if (void* ptr = allocateRaw(size, alignment)) {
+            return ptr;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+constexpr std::size_t kDefaultAlignment = alignof(std::max_align_t);
+
+} // namespace
+
+namespace fbpp::util {
+
+void AllocationCounter::reset() noexcept {
+    allocations_ = t_allocations;
+    deallocations_ = t_deallocations;
+    bytes_ = t_bytes;
+}
+
+std::size_t AllocationCounter::allocations() const noexcept {
+    return t_allocations - allocations_;
+}
+
+std::size_t AllocationCounter::deallocations() const noexcept {
+    return t_deallocations - deallocations_;
+}
+
+std::size_t AllocationCounter::bytes() const noexcept {
+    return t_bytes - bytes_;
+}
+
+} // namespace fbpp::util
+
+// ============================================================================
+// Replacement global allocation functions
+// ============================================================================
+
+void* operator new(std::size_t size) {
+    return allocateOrThrow(size, kDefaultAlignment);
+}
+
+void* operator new[](std::size_t size) {
+    return allocateOrThrow(size, kDefaultAlignment);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return allocateCounted(size, kDefaultAlignment);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return allocateCounted(size, kDefaultAlignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return allocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return allocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocateCounted(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment,
+                     const std::nothrow_t&) noexcept {
+    return allocateCounted(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept {
+    releaseRaw(ptr, kDefaultAlignment);
+}
+
+void operator delete[](void* ptr) noexcept {
+    releaseRaw(ptr, kDefaultAlignment);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    releaseRaw(ptr, kDefaultAlignment);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    releaseRaw(ptr, kDefaultAlignment);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    releaseRaw(ptr, kDefaultAlignment);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    releaseRaw(ptr, kDefaultAlignment);
+}
+
+void operator delete(void* ptr, std::align_val_t alignment) noexcept {
+    releaseRaw(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept {
+    releaseRaw(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t alignment) noexcept {
+    releaseRaw(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t alignment) noexcept {
+    releaseRaw(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    releaseRaw(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    releaseRaw(ptr, static_cast<std::size_t>(alignment));
+}
@@ -1,6 +1,7 @@
 #include <fbpp_util/config.h>
 #include <fstream>
 #include <cstdlib>
+#include <stdexcept>
 
 namespace fbpp::util {
 
@@ -23,6 +24,23 @@ bool Config::load(const std::string& jsonPath) {
     return true;
 }
 
+Config::Tunables Config::readTunables(const std::string& jsonPath) {
+    std::ifstream file(jsonPath);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open config file: " + jsonPath);
+    }
+    Config cfg;
+    try {
+        nlohmann::json j;
+        file >> j;
+        cfg.loadFromJson(j);
+    } catch (const nlohmann::json::exception& e) {
+        throw std::runtime_error("Invalid config file " + jsonPath + ": " + e.what());
+    }
+    cfg.loadFromEnv();
+    return {cfg.cache_, cfg.pool_};
+}
+
 void Config::loadFromJson(const nlohmann::json& j) {
     if (j.contains("db")) {
         auto& jdb = j["db"];
@@ -58,6 +76,13 @@ void Config::loadFromJson(const nlohmann::json& j) {
         if (jcache.contains("max_statements")) cache_.maxStatements = jcache["max_statements"];
         if (jcache.contains("ttl_minutes")) cache_.ttlMinutes = jcache["ttl_minutes"];
     }
+
+    if (j.contains("pool")) {
+        auto& jpool = j["pool"];
+        if (jpool.contains("min_size")) pool_.minSize = jpool["min_size"];
+        if (jpool.contains("max_size")) pool_.maxSize = jpool["max_size"];
+        if (jpool.contains("prefetch_rows")) pool_.prefetchRows = jpool["prefetch_rows"];
+    }
 }
 
 void Config::loadFromEnv() {
@@ -78,6 +103,17 @@ void Config::loadFromEnv() {
     if (const char* val = std::getenv("FBLAB_CACHE_TTL_MINUTES")) {
         cache_.ttlMinutes = std::stoul(val);
     }
+
+    // Pool environment variables
+    if (const char* val = std::getenv("FBLAB_POOL_MIN_SIZE")) {
+        pool_.minSize = std::stoul(val);
+    }
+    if (const char* val = std::getenv("FBLAB_POOL_MAX_SIZE")) {
+        pool_.maxSize = std::stoul(val);
+    }
+    if (const char* val = std::getenv("FBLAB_POOL_PREFETCH_ROWS")) {
+        pool_.prefetchRows = static_cast<unsigned>(std::stoul(val));
+    }
 }
 
 }  // namespace fbpp::util
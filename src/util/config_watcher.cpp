@@ -0,0 +1,242 @@
+#include <fbpp_util/config_watcher.h>
+#include <fbpp_util/trace.h>
+
+#include "fbpp/core/statement_cache.hpp"
+#include "fbpp/pool/connection_pool.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+namespace fbpp::util {
+
+namespace {
+
+bool sameTunables(const Config::Tunables& a, const Config::Tunables& b) {
+    return a.cache.enabled == b.cache.enabled &&
+           a.cache.maxStatements == b.cache.maxStatements &&
+           a.cache.ttlMinutes == b.cache.ttlMinutes &&
+           a.pool.minSize == b.pool.minSize &&
+           a.pool.maxSize == b.pool.maxSize &&
+           a.pool.prefetchRows == b.pool.prefetchRows;
+}
+
+template<typename T>
+void addTarget(std::vector<T*>& targets, T* target) {
+    if (std::find(targets.begin(), targets.end(), target) == targets.end()) {
+        targets.push_back(target);
+    }
+}
+
+template<typename T>
+void removeTarget(std::vector<T*>& targets, T* target) {
+    targets.erase(std::remove(targets.begin(), targets.end(), target), targets.end());
+}
+
+} // namespace
+
+ConfigWatcher::ConfigWatcher(std::string jsonPath)
+    : path_(std::move(jsonPath)) {
+    stamp_ = readStamp();
+    stats_.applied = Config::readTunables(path_);
+    validate(stats_.applied);
+}
+
+ConfigWatcher::~ConfigWatcher() {
+    stop();
+}
+
+void ConfigWatcher::watch(core::StatementCache& cache) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    apply(cache);
+    addTarget(caches_, &cache);
+    stats_.caches = caches_.size();
+}
+
+void ConfigWatcher::watch(pool::ConnectionPool& pool) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Bounds this pool's reserved capacity rejects throw here, unregistered
+    apply(pool);
+    addTarget(pools_, &pool);
+    stats_.pools = pools_.size();
+}
+
+void ConfigWatcher::unwatch(core::StatementCache& cache) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    removeTarget(caches_, &cache);
+    stats_.caches = caches_.size();
+}
+
+void ConfigWatcher::unwatch(pool::ConnectionPool& pool) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    removeTarget(pools_, &pool);
+    stats_.pools = pools_.size();
+}
+
+void ConfigWatcher::start(std::chrono::milliseconds interval) {
+    stop();
+    if (interval.count() <= 0) {
+        throw std::invalid_argument("ConfigWatcher: interval must be positive");
+    }
+    {
+        std::lock_guard<std::mutex> lock(threadMutex_);
+        stop_ = false;
+    }
+    thread_ = std::thread([this, interval] { run(interval); });
+}
+
+void ConfigWatcher::stop() {
+    {
+        std::lock_guard<std::mutex> lock(threadMutex_);
+        stop_ = true;
+    }
+    stopping_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void ConfigWatcher::run(std::chrono::milliseconds interval) {
+    std::unique_lock<std::mutex> lock(threadMutex_);
+    while (!stopping_.wait_for(lock, interval, [this] { return stop_; })) {
+        lock.unlock();
+        try {
+            checkNow();
+        } catch (const std::exception& e) {
+            trace(TraceLevel::error, "ConfigWatcher",
+                  [&](auto& oss) { oss << "Check failed: " << e.what(); });
+        }
+        lock.lock();
+    }
+}
+
+bool ConfigWatcher::checkNow() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.checks;
+    const Stamp stamp = readStamp();
+    if (stamp == stamp_) {
+        return false;
+    }
+    stamp_ = stamp;
+
+    Config::Tunables next;
+    try {
+        next = Config::readTunables(path_);
+        validate(next);
+    } catch (const std::exception& e) {
+        ++stats_.failures;
+        stats_.lastError = e.what();
+        trace(TraceLevel::warn, "ConfigWatcher",
+              [&](auto& oss) { oss << "Settings left unchanged: " << e.what(); });
+        return false;
+    }
+    if (sameTunables(next, stats_.applied)) {
+        ++stats_.unchanged;
+        return false;
+    }
+
+    stats_.applied = next;
+    stats_.lastError.clear();
+    for (auto* cache : caches_) {
+        apply(*cache);
+    }
+    for (auto* pool : pools_) {
+        try {
+            apply(*pool);
+        } catch (const std::exception& e) {
+            // resize() took the bounds; only opening the new minimum failed,
+            // and the pool's reaper retries that
+            stats_.lastError = e.what();
+            trace(TraceLevel::error, "ConfigWatcher",
+                  [&](auto& oss) { oss << "Pool refill failed: " << e.what(); });
+        }
+    }
+    ++stats_.reloads;
+    stats_.lastReload = std::chrono::system_clock::now();
+
+    trace(TraceLevel::info, "ConfigWatcher", [&](auto& oss) {
+        oss << "Applied " << path_ << ": cache " << (next.cache.enabled ? "on" : "off")
+            << " max " << next.cache.maxStatements << " ttl " << next.cache.ttlMinutes
+            << " min, pool " << next.pool.minSize << ".." << next.pool.maxSize
+            << " prefetch " << next.pool.prefetchRows << " (" << caches_.size()
+            << " caches, " << pools_.size() << " pools)";
+    });
+    return true;
+}
+
+ConfigWatcherStats ConfigWatcher::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+ConfigWatcher::Stamp ConfigWatcher::readStamp() const {
+    Stamp stamp;
+    std::error_code ec;
+    stamp.modified = std::filesystem::last_write_time(path_, ec);
+    if (ec) {
+        return {};
+    }
+    stamp.size = std::filesystem::file_size(path_, ec);
+    stamp.exists = !ec;
+    return stamp;
+}
+
+void ConfigWatcher::validate(const Config::Tunables& tunables) const {
+    const auto& pool = tunables.pool;
+    if (pool.maxSize == 0) {
+        throw std::runtime_error("pool.max_size must be positive");
+    }
+    if (pool.minSize > pool.maxSize) {
+        throw std::runtime_error("pool.min_size exceeds pool.max_size");
+    }
+    // What resize() would reject, before any target is touched
+    for (const auto* target : pools_) {
+        const auto& options = target->options();
+        if (options.reservedInteractive + options.reservedNormal >= pool.maxSize) {
+            throw std::runtime_error(
+                "pool.max_size " + std::to_string(pool.maxSize) +
+                " leaves no connection beyond a pool's reserved capacity");
+        }
+    }
+}
+
+void ConfigWatcher::apply(core::StatementCache& cache) {
+    const auto& settings = stats_.applied.cache;
+    const size_t before = cache.getStatistics().cacheSize;
+    if (cache.isEnabled() != settings.enabled) {
+        cache.setEnabled(settings.enabled);
+    }
+    if (cache.getMaxSize() != settings.maxStatements) {
+        cache.setMaxSize(settings.maxStatements);
+    }
+    if (cache.getTtlMinutes() != settings.ttlMinutes) {
+        cache.setTtlMinutes(settings.ttlMinutes);
+    }
+    const size_t after = cache.getStatistics().cacheSize;
+    if (after < before) {
+        stats_.statementsEvicted += before - after;
+    }
+}
+
+void ConfigWatcher::apply(pool::ConnectionPool& pool) {
+    const auto& settings = stats_.applied;
+    core::ConnectionOptions options = pool.connectionOptions();
+    auto& cache = options.statementCache;
+    if (cache.enabled != settings.cache.enabled ||
+        cache.maxSize != settings.cache.maxStatements ||
+        cache.ttlMinutes != settings.cache.ttlMinutes ||
+        options.transfer.prefetchRows != settings.pool.prefetchRows) {
+        cache.enabled = settings.cache.enabled;
+        cache.maxSize = settings.cache.maxStatements;
+        cache.ttlMinutes = settings.cache.ttlMinutes;
+        options.transfer.prefetchRows = settings.pool.prefetchRows;
+        pool.setConnectionOptions(options);
+    }
+    if (pool.minSize() != settings.pool.minSize || pool.maxSize() != settings.pool.maxSize) {
+        stats_.connectionsClosed += pool.resize(settings.pool.minSize, settings.pool.maxSize);
+    }
+}
+
+}  // namespace fbpp::util
@@ -0,0 +1,281 @@
+#include "fbpp_util/dataset.hpp"
+#include "fbpp/core/bulk_loader.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace fbpp::util {
+
+const char* const kDatasetInsertSql =
+    "INSERT INTO TABLE_TEST_1 (F_INTEGER, F_BIGINT, F_BOOLEAN, F_CHAR, F_DATE, F_DECFLOAT, "
+    "F_DECIMAL, F_DOUBLE_PRECISION, F_FLOAT, F_INT128, F_NUMERIC, F_SMALINT, F_TIME, "
+    "F_TIME_TZ, F_TIMESHTAMP, F_TIMESHTAMP_TZ, F_VARCHAR, F_BLOB_B, F_BLOB_T) "
+    "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)";
+
+namespace {
+
+using fbpp::core::FirebirdException;
+
+// Same columns as the TABLE_TEST_1 of the test fixtures (tests/test_base.cpp)
+const char* kCreateTable =
+    "CREATE TABLE TABLE_TEST_1 ("
+    "    ID                  INTEGER GENERATED BY DEFAULT AS IDENTITY,"
+    "    F_BIGINT            BIGINT,"
+    "    F_BOOLEAN           BOOLEAN,"
+    "    F_CHAR              CHAR(10),"
+    "    F_DATE              DATE,"
+    "    F_DECFLOAT          DECFLOAT(34),"
+    "    F_DECIMAL           DECIMAL(34,8),"
+    "    F_DOUBLE_PRECISION  DOUBLE PRECISION,"
+    "    F_FLOAT             FLOAT,"
+    "    F_INT128            INT128,"
+    "    F_INTEGER           INTEGER,"
+    "    F_NUMERIC           NUMERIC(16,6),"
+    "    F_SMALINT           SMALLINT,"
+    "    F_TIME              TIME,"
+    "    F_TIME_TZ           TIME WITH TIME ZONE,"
+    "    F_TIMESHTAMP        TIMESTAMP,"
+    "    F_TIMESHTAMP_TZ     TIMESTAMP WITH TIME ZONE,"
+    "    F_VARCHAR           VARCHAR(64),"
+    "    F_BLOB_B            BLOB SUB_TYPE BINARY SEGMENT SIZE 1024,"
+    "    F_BLOB_T            BLOB SUB_TYPE TEXT SEGMENT SIZE 1024,"
+    "    F_NULL              INTEGER,"
+    "    CONSTRAINT PK_TABLE_TEST_1 PRIMARY KEY (ID),"
+    "    CONSTRAINT UNQ1_TABLE_TEST_F_INTEGER UNIQUE (F_INTEGER)"
+    ")";
+
+// Independent draw sequences of one row
+enum Stream : uint64_t { Columns = 0, BlobChoice = 1, BinaryBlob = 2, TextBlob = 3 };
+
+// UTC offsets (minutes) of the zoned columns; Firebird numbers an offset
+// zone as offset + 1439
+constexpr std::array<int16_t, 7> kZoneOffsets{0, 60, 180, -300, 330, 545, -600};
+constexpr uint32_t kTimeUnitsPerDay = 86400u * 10000u;   // ISC_TIME: 1/10000 s
+
+uint64_t splitMix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// Counter-based generator: the draws of (seed, index, stream) never depend
+// on any other row
+class RowRandom {
+public:
+    RowRandom(uint64_t seed, uint64_t index, Stream stream)
+        : state_(splitMix(splitMix(seed) ^ splitMix(index * 4 + stream))) {}
+
+    uint64_t next() {
+        state_ += 0x9E3779B97F4A7C15ull;
+        return splitMix(state_);
+    }
+
+    // [0, 1)
+    double unit() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+
+    uint64_t below(uint64_t bound) { return next() % bound; }
+
+    bool chance(double ratio) { return unit() < ratio; }
+
+private:
+    uint64_t state_;
+};
+
+template<typename T, typename Make>
+std::optional<T> maybe(RowRandom& random, double nullRatio, Make&& make) {
+    // The value is drawn either way, so nullRatio does not shift other columns
+    T value = make();
+    if (random.chance(nullRatio)) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+std::string randomText(RowRandom& random, size_t length) {
+    static constexpr char kLetters[] = "abcdefghijklmnopqrstuvwxyz";
+    std::string text(length, ' ');
+    for (char& c : text) {
+        const uint64_t draw = random.below(32);
+        c = draw < 26 ? kLetters[draw] : ' ';   // Roughly one space per six letters
+    }
+    return text;
+}
+
+template<typename T>
+T scalar(fbpp::core::Connection& connection, const std::string& sql) {
+    auto tx = connection.StartTransaction();
+    auto cursor = tx->openCursor(connection.prepareStatement(sql));
+    std::tuple<std::optional<T>> row;
+    const bool found = cursor->fetch(row);
+    cursor->close();
+    tx->Commit();
+    return found && std::get<0>(row) ? *std::get<0>(row) : T{};
+}
+
+fbpp::core::Blob toBlob(const ISC_QUAD& id) {
+    return fbpp::core::Blob(reinterpret_cast<const uint8_t*>(&id));
+}
+
+} // namespace
+
+bool ensureDatasetTable(fbpp::core::Connection& connection) {
+    if (scalar<int64_t>(connection,
+            "SELECT COUNT(*) FROM RDB$RELATIONS WHERE RDB$RELATION_NAME = 'TABLE_TEST_1'") != 0) {
+        return false;
+    }
+    connection.ExecuteDDL(kCreateTable);
+    return true;
+}
+
+DatasetRow datasetRow(uint64_t index, const DatasetOptions& options) {
+    using namespace fbpp::core;
+    RowRandom random(options.seed, index, Columns);
+    const double nulls = options.nullRatio;
+    DatasetRow row;
+
+    std::get<0>(row) = static_cast<int32_t>(index + 1);
+    std::get<1>(row) = maybe<int64_t>(random, nulls, [&] { return static_cast<int64_t>(random.next()); });
+    std::get<2>(row) = maybe<bool>(random, nulls, [&] { return (random.next() & 1) != 0; });
+    std::get<3>(row) = maybe<std::string>(random, nulls, [&] {
+        static constexpr char kCode[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+        std::string code(10, 'C');
+        for (size_t i = 1; i < code.size(); ++i) {
+            code[i] = kCode[random.below(36)];
+        }
+        return code;
+    });
+
+    // One date and time feed every temporal column of the row
+    static const uint32_t kFirstDay = Date(2000, 1, 1).getDate();
+    const uint32_t day = kFirstDay + static_cast<uint32_t>(random.below(9000));
+    const uint32_t time = static_cast<uint32_t>(random.below(kTimeUnitsPerDay));
+    const int16_t offset = kZoneOffsets[random.below(kZoneOffsets.size())];
+    const uint16_t zone = static_cast<uint16_t>(1439 + offset);
+
+    std::get<4>(row) = maybe<Date>(random, nulls, [&] { return Date(day); });
+    std::get<5>(row) = maybe<DecFloat34>(random, nulls, [&] {
+        const int64_t whole = static_cast<int64_t>(random.next()) >> 20;
+        const uint64_t fraction = random.below(10000);
+        std::string text = std::to_string(whole) + ".";
+        const std::string digits = std::to_string(fraction);
+        text.append(4 - digits.size(), '0').append(digits);
+        return DecFloat34(text);
+    });
+    std::get<6>(row) = maybe<Int128>(random, nulls, [&] {
+        return Int128(static_cast<int64_t>(random.next()));   // Scale 8: |value| < 9.3e10
+    });
+    std::get<7>(row) = maybe<double>(random, nulls, [&] { return (random.unit() - 0.5) * 1e9; });
+    std::get<8>(row) = maybe<float>(random, nulls, [&] {
+        return static_cast<float>((random.unit() - 0.5) * 1e4);
+    });
+    std::get<9>(row) = maybe<Int128>(random, nulls, [&] {
+        // 120 significant bits: at most 37 digits
+        return Int128::fromParts(static_cast<int64_t>(random.next()) >> 8, random.next());
+    });
+    std::get<10>(row) = maybe<double>(random, nulls, [&] {
+        // NUMERIC(16,6) with nine integer digits: still exact through a double
+        const int64_t micros = static_cast<int64_t>(random.below(2'000'000'000'000'000ull)) -
+                               1'000'000'000'000'000ll;
+        return static_cast<double>(micros) / 1e6;
+    });
+    std::get<11>(row) = maybe<int16_t>(random, nulls, [&] {
+        return static_cast<int16_t>(static_cast<uint16_t>(random.next()));
+    });
+    std::get<12>(row) = maybe<Time>(random, nulls, [&] { return Time(time); });
+    std::get<13>(row) = maybe<TimeTz>(random, nulls, [&] { return TimeTz(time, zone, offset); });
+    std::get<14>(row) = maybe<Timestamp>(random, nulls, [&] { return Timestamp(day, time); });
+    std::get<15>(row) = maybe<TimestampTz>(random, nulls, [&] {
+        return TimestampTz(day, time, zone, offset);
+    });
+    std::get<16>(row) = maybe<std::string>(random, nulls, [&] {
+        const std::string prefix = "row " + std::to_string(index) + " ";
+        return prefix + randomText(random, random.below(64 - prefix.size() + 1));
+    });
+    return row;
+}
+
+bool datasetRowHasBlobs(uint64_t index, const DatasetOptions& options) {
+    RowRandom random(options.seed, index, BlobChoice);
+    return random.chance(options.blobRatio);
+}
+
+std::string datasetBlob(uint64_t index, const DatasetOptions& options, bool text) {
+    RowRandom random(options.seed, index, text ? TextBlob : BinaryBlob);
+    const size_t size = options.blobBytes / 2 + static_cast<size_t>(random.below(options.blobBytes + 1));
+    if (text) {
+        return randomText(random, size);
+    }
+    std::string bytes(size, '\0');
+    for (size_t i = 0; i < size; i += 8) {
+        const uint64_t draw = random.next();
+        for (size_t b = 0; b < 8 && i + b < size; ++b) {
+            bytes[i + b] = static_cast<char>(draw >> (8 * b));
+        }
+    }
+    return bytes;
+}
+
+uint64_t generateDataset(fbpp::core::Connection& connection, const DatasetOptions& options) {
+    if (options.chunkRows == 0) {
+        throw std::runtime_error("DatasetOptions::chunkRows must be positive");
+    }
+    if (options.firstRow + options.rows >
+        static_cast<uint64_t>(std::numeric_limits<int32_t>::max())) {
+        throw std::runtime_error("Dataset rows past F_INTEGER's range (2^31 - 1)");
+    }
+    ensureDatasetTable(connection);
+    auto statement = connection.prepareStatement(kDatasetInsertSql);
+
+    fbpp::core::BulkLoaderOptions loaderOptions;
+    loaderOptions.flushBytes = options.flushBytes;
+    loaderOptions.pipelined = options.pipelined;
+    loaderOptions.recordCounts = false;
+    loaderOptions.maxErrorMessages = 1;
+
+    std::vector<DatasetRow> chunk;
+    chunk.reserve(static_cast<size_t>(std::min<uint64_t>(options.chunkRows, options.rows)));
+    uint64_t done = 0;
+    while (done < options.rows) {
+        const uint64_t count = std::min<uint64_t>(options.chunkRows, options.rows - done);
+        const uint64_t first = options.firstRow + done;
+        // BLOBs are created in the transaction that inserts them: a commit
+        // in between would drop the ones not attached to a row yet.
+        auto tx = connection.StartTransaction();
+        chunk.clear();
+        for (uint64_t index = first; index < first + count; ++index) {
+            DatasetRow& row = chunk.emplace_back(datasetRow(index, options));
+            if (datasetRowHasBlobs(index, options)) {
+                const std::string binary = datasetBlob(index, options, false);
+                const std::string text = datasetBlob(index, options, true);
+                std::get<17>(row) = toBlob(tx->createBlob(std::as_bytes(std::span(binary)), 0));
+                std::get<18>(row) = toBlob(tx->createBlob(std::as_bytes(std::span(text)), 1));
+            }
+        }
+
+        fbpp::core::BulkLoader<DatasetRow> loader(statement, tx, loaderOptions);
+        loader.addMany(chunk);
+        const auto result = loader.finish();
+        if (result.failedCount > 0) {
+            throw FirebirdException("Dataset chunk at row " + std::to_string(first) + " failed: " +
+                                    (result.errors.empty() ? std::string("unknown error")
+                                                           : result.errors.front()));
+        }
+        tx->Commit();
+        done += count;
+        if (options.progress) {
+            options.progress(done);
+        }
+    }
+    return done;
+}
+
+} // namespace fbpp::util
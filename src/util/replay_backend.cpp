@@ -0,0 +1,547 @@
+#include "fbpp_util/replay_backend.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/result_snapshot.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <utility>
+
+namespace fbpp::util {
+
+namespace {
+
+using fbpp::core::FieldInfo;
+using Status = Firebird::ThrowStatusWrapper;
+
+// Replay objects report errors the way the client library does: through
+// the status, which the caller's ThrowStatusWrapper turns into FbException.
+void fail(Status* status, const char* what) {
+    const intptr_t errors[] = {isc_arg_gds, isc_random,
+                               isc_arg_string, reinterpret_cast<intptr_t>(what),
+                               isc_arg_end};
+    status->setErrors(errors);
+}
+
+void fail(Status* status, ISC_STATUS code) {
+    const intptr_t errors[] = {isc_arg_gds, code, isc_arg_end};
+    status->setErrors(errors);
+}
+
+// Shared reference counting of the replay interfaces (cloop objects are
+// deleted by their last release())
+class RefCount {
+public:
+    void add() noexcept { refs_.fetch_add(1, std::memory_order_relaxed); }
+    bool drop() noexcept { return refs_.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+
+private:
+    std::atomic<int> refs_{1};
+};
+
+class ReplayMetadata final
+    : public Firebird::IMessageMetadataImpl<ReplayMetadata, Status> {
+public:
+    explicit ReplayMetadata(std::shared_ptr<const RecordedMessages> layout)
+        : layout_(std::move(layout)) {}
+
+    void addRef() { refs_.add(); }
+
+    int release() {
+        if (refs_.drop()) {
+            delete this;
+            return 0;
+        }
+        return 1;
+    }
+
+    unsigned getCount(Status*) {
+        return static_cast<unsigned>(layout_->fields().size());
+    }
+
+    const char* getField(Status* status, unsigned index) {
+        const FieldInfo* f = field(status, index);
+        return f ? f->name.c_str() : nullptr;
+    }
+
+    const char* getRelation(Status* status, unsigned index) {
+        const FieldInfo* f = field(status, index);
+        return f ? f->relation.c_str() : nullptr;
+    }
+
+    const char* getOwner(Status* status, unsigned index) {
+        const FieldInfo* f = field(status, index);
+        return f ? f->owner.c_str() : nullptr;
+    }
+
+    const char* getAlias(Status* status, unsigned index) {
+        const FieldInfo* f = field(status, index);
+        return f ? f->alias.c_str() : nullptr;
+    }
+
+    unsigned getType(Status* status, unsigned index) {
+        const FieldInfo* f = field(status, index);
+        return f ? f->type : 0;
+    }
+
+    FB_BOOLEAN isNullable(Status* status, unsigned index) {
+        const FieldInfo* f = field(status, index);
+        return f && f->nullable ? FB_TRUE : FB_FALSE;
+    }
+
+    int getSubType(Status* status, unsigned index) {
+        const FieldInfo* f = field(status, index);
+        return f ? static_cast<int>(f->subType) : 0;
+    }
+
+    unsigned getLength(Status* status, unsigned index) {
+        const FieldInfo* f = field(status, index);
+        return f ? f->length : 0;
+    }
+
+    int getScale(Status* status, unsigned index) {
+        const FieldInfo* f = field(status, index);
+        return f ? f->scale : 0;
+    }
+
+    unsigned getCharSet(Status* status, unsigned index) {
+        const FieldInfo* f = field(status, index);
+        return f ? f->charSet : 0;
+    }
+
+    unsigned getOffset(Status* status, unsigned index) {
+        const FieldInfo* f = field(status, index);
+        return f ? f->offset : 0;
+    }
+
+    unsigned getNullOffset(Status* status, unsigned index) {
+        const FieldInfo* f = field(status, index);
+        return f ? f->nullOffset : 0;
+    }
+
+    Firebird::IMetadataBuilder* getBuilder(Status* status) {
+        fail(status, "Replay metadata has no builder");
+        return nullptr;
+    }
+
+    unsigned getMessageLength(Status*) { return layout_->messageLength(); }
+    unsigned getAlignment(Status*) { return layout_->alignment(); }
+    unsigned getAlignedLength(Status*) { return layout_->alignedLength(); }
+
+private:
+    const FieldInfo* field(Status* status, unsigned index) {
+        if (index >= layout_->fields().size()) {
+            fail(status, "Replay metadata: field index out of range");
+            return nullptr;
+        }
+        return &layout_->fields()[index];
+    }
+
+    std::shared_ptr<const RecordedMessages> layout_;
+    RefCount refs_;
+};
+
+ReplayMetadata* newMetadata(const std::shared_ptr<const RecordedMessages>& layout) {
+    return new ReplayMetadata(layout);
+}
+
+// Layout of a statement without parameters / output: zero fields
+std::shared_ptr<const RecordedMessages> emptyLayout() {
+    static const auto layout = std::make_shared<const RecordedMessages>();
+    return layout;
+}
+
+class ReplayResultSet final
+    : public Firebird::IResultSetImpl<ReplayResultSet, Status> {
+public:
+    ReplayResultSet(std::shared_ptr<const RecordedMessages> rows, std::size_t repeat)
+        : rows_(std::move(rows)),
+          total_(rows_->rowCount() * std::max<std::size_t>(repeat, 1)) {}
+
+    void addRef() { refs_.add(); }
+
+    int release() {
+        if (refs_.drop()) {
+            delete this;
+            return 0;
+        }
+        return 1;
+    }
+
+    int fetchNext(Status*, void* message) {
+        if (closed_ || next_ >= total_) {
+            next_ = total_;
+            return Firebird::IStatus::RESULT_NO_DATA;
+        }
+        std::memcpy(message, rows_->row(next_ % rows_->rowCount()), rows_->messageLength());
+        ++next_;
+        return Firebird::IStatus::RESULT_OK;
+    }
+
+    // A replay cursor is forward-only, like the cursors fbpp opens
+    int fetchPrior(Status* status, void*) { return scrollable(status); }
+    int fetchFirst(Status* status, void*) { return scrollable(status); }
+    int fetchLast(Status* status, void*) { return scrollable(status); }
+    int fetchAbsolute(Status* status, int, void*) { return scrollable(status); }
+    int fetchRelative(Status* status, int, void*) { return scrollable(status); }
+
+    FB_BOOLEAN isEof(Status*) { return next_ >= total_ ? FB_TRUE : FB_FALSE; }
+    FB_BOOLEAN isBof(Status*) { return next_ == 0 ? FB_TRUE : FB_FALSE; }
+
+    Firebird::IMessageMetadata* getMetadata(Status*) { return newMetadata(rows_); }
+
+    void deprecatedClose(Status* status) { close(status); }
+    void close(Status*) { closed_ = true; }
+
+    void setDelayedOutputFormat(Status* status, Firebird::IMessageMetadata*) {
+        fail(status, "Replay cursor has a fixed output format");
+    }
+
+    void getInfo(Status* status, unsigned, const unsigned char*, unsigned, unsigned char*) {
+        fail(status, "Replay cursor has no info items");
+    }
+
+private:
+    int scrollable(Status* status) {
+        fail(status, "Replay cursor is not scrollable");
+        return Firebird::IStatus::RESULT_ERROR;
+    }
+
+    std::shared_ptr<const RecordedMessages> rows_;
+    const std::size_t total_;
+    std::size_t next_ = 0;
+    bool closed_ = false;
+    RefCount refs_;
+};
+
+class ReplayCompletionState final
+    : public Firebird::IBatchCompletionStateImpl<ReplayCompletionState, Status> {
+public:
+    explicit ReplayCompletionState(unsigned size) : size_(size) {}
+
+    void dispose() { delete this; }
+
+    unsigned getSize(Status*) { return size_; }
+
+    int getState(Status* status, unsigned pos) {
+        if (pos >= size_) {
+            fail(status, "Replay batch: message index out of range");
+            return EXECUTE_FAILED;
+        }
+        return SUCCESS_NO_INFO;
+    }
+
+    unsigned findError(Status*, unsigned) { return NO_MORE_ERRORS; }
+
+    void getStatus(Status*, Firebird::IStatus* to, unsigned) { to->init(); }
+
+private:
+    const unsigned size_;
+};
+
+class ReplayBatch final : public Firebird::IBatchImpl<ReplayBatch, Status> {
+public:
+    ReplayBatch(std::shared_ptr<const RecordedMessages> input,
+                std::shared_ptr<ReplayCapture> capture)
+        : input_(std::move(input)), capture_(std::move(capture)) {}
+
+    void addRef() { refs_.add(); }
+
+    int release() {
+        if (refs_.drop()) {
+            delete this;
+            return 0;
+        }
+        return 1;
+    }
+
+    void add(Status*, unsigned count, const void* inBuffer) {
+        if (capture_) {
+            capture_->record(inBuffer, count, input_->messageLength(), input_->alignedLength());
+        }
+        pending_ += count;
+    }
+
+    void addBlob(Status* status, unsigned, const void*, ISC_QUAD*, unsigned, const unsigned char*) {
+        noBlobs(status);
+    }
+    void appendBlobData(Status* status, unsigned, const void*) { noBlobs(status); }
+    void addBlobStream(Status* status, unsigned, const void*) { noBlobs(status); }
+    void registerBlob(Status* status, const ISC_QUAD*, ISC_QUAD*) { noBlobs(status); }
+    void setDefaultBpb(Status*, unsigned, const unsigned char*) {}
+
+    Firebird::IBatchCompletionState* execute(Status*, Firebird::ITransaction*) {
+        auto* state = new ReplayCompletionState(pending_);
+        pending_ = 0;
+        return state;
+    }
+
+    void cancel(Status*) { pending_ = 0; }
+
+    unsigned getBlobAlignment(Status*) { return 4; }
+
+    Firebird::IMessageMetadata* getMetadata(Status*) { return newMetadata(input_); }
+
+    void deprecatedClose(Status*) {}
+    void close(Status*) {}
+
+    void getInfo(Status* status, unsigned, const unsigned char*, unsigned, unsigned char*) {
+        fail(status, "Replay batch has no info items");
+    }
+
+private:
+    void noBlobs(Status* status) { fail(status, "Replay batch cannot store BLOBs"); }
+
+    std::shared_ptr<const RecordedMessages> input_;
+    std::shared_ptr<ReplayCapture> capture_;
+    unsigned pending_ = 0;
+    RefCount refs_;
+};
+
+class ReplayStatement final
+    : public Firebird::IStatementImpl<ReplayStatement, Status> {
+public:
+    ReplayStatement(unsigned type, std::shared_ptr<const RecordedMessages> output, std::size_t repeat,
+                    std::shared_ptr<const RecordedMessages> input,
+                    std::shared_ptr<ReplayCapture> capture)
+        : type_(type), output_(output ? std::move(output) : emptyLayout()), repeat_(repeat),
+          input_(input ? std::move(input) : emptyLayout()), capture_(std::move(capture)) {}
+
+    void addRef() { refs_.add(); }
+
+    int release() {
+        if (refs_.drop()) {
+            delete this;
+            return 0;
+        }
+        return 1;
+    }
+
+    void getInfo(Status* status, unsigned, const unsigned char*, unsigned, unsigned char*) {
+        fail(status, "Replay statement has no info items");
+    }
+
+    unsigned getType(Status*) { return type_; }
+
+    const char* getPlan(Status*, FB_BOOLEAN) { return "REPLAY"; }
+
+    ISC_UINT64 getAffectedRecords(Status*) { return affected_; }
+
+    Firebird::IMessageMetadata* getInputMetadata(Status*) { return newMetadata(input_); }
+    Firebird::IMessageMetadata* getOutputMetadata(Status*) { return newMetadata(output_); }
+
+    Firebird::ITransaction* execute(Status* status, Firebird::ITransaction* transaction,
+                                    Firebird::IMessageMetadata*, void* inBuffer,
+                                    Firebird::IMessageMetadata*, void* outBuffer) {
+        if (inBuffer && capture_) {
+            capture_->record(inBuffer, 1, input_->messageLength(), input_->messageLength());
+        }
+        // A singleton SELECT needs exactly one row, as on the server
+        if (outBuffer && type_ == isc_info_sql_stmt_select && output_->rowCount() * repeat_ != 1) {
+            fail(status, output_->rowCount() == 0 ? isc_stream_eof : isc_sing_select_err);
+            return nullptr;
+        }
+        if (outBuffer && output_->rowCount() > 0) {
+            std::memcpy(outBuffer, output_->row(0), output_->messageLength());
+        }
+        affected_ = type_ == isc_info_sql_stmt_select ? 0 : 1;
+        return transaction;
+    }
+
+    Firebird::IResultSet* openCursor(Status* status, Firebird::ITransaction*,
+                                     Firebird::IMessageMetadata*, void* inBuffer,
+                                     Firebird::IMessageMetadata*, unsigned) {
+        if (type_ != isc_info_sql_stmt_select) {
+            fail(status, "Replay statement has no cursor");
+            return nullptr;
+        }
+        if (inBuffer && capture_) {
+            capture_->record(inBuffer, 1, input_->messageLength(), input_->messageLength());
+        }
+        return new ReplayResultSet(output_, repeat_);
+    }
+
+    void setCursorName(Status*, const char*) {}
+
+    void deprecatedFree(Status*) {}
+    void free(Status*) {}
+
+    unsigned getFlags(Status*) {
+        return type_ == isc_info_sql_stmt_select ? Firebird::IStatement::FLAG_HAS_CURSOR : 0;
+    }
+
+    unsigned getTimeout(Status*) { return timeout_; }
+    void setTimeout(Status*, unsigned timeout) { timeout_ = timeout; }
+
+    Firebird::IBatch* createBatch(Status*, Firebird::IMessageMetadata*, unsigned, const unsigned char*) {
+        return new ReplayBatch(input_, capture_);
+    }
+
+    unsigned getMaxInlineBlobSize(Status*) { return 0; }
+    void setMaxInlineBlobSize(Status*, unsigned) {}
+
+private:
+    const unsigned type_;
+    std::shared_ptr<const RecordedMessages> output_;
+    const std::size_t repeat_;
+    std::shared_ptr<const RecordedMessages> input_;
+    std::shared_ptr<ReplayCapture> capture_;
+    ISC_UINT64 affected_ = 0;
+    unsigned timeout_ = 0;
+    RefCount refs_;
+};
+
+// Commit and rollback only end the transaction; there is nothing to keep
+class ReplayTransaction final
+    : public Firebird::ITransactionImpl<ReplayTransaction, Status> {
+public:
+    void addRef() { refs_.add(); }
+
+    int release() {
+        if (refs_.drop()) {
+            delete this;
+            return 0;
+        }
+        return 1;
+    }
+
+    void getInfo(Status* status, unsigned, const unsigned char*, unsigned, unsigned char*) {
+        fail(status, "Replay transaction has no info items");
+    }
+
+    void prepare(Status*, unsigned, const unsigned char*) {}
+    void commit(Status*) {}
+    void deprecatedCommit(Status*) {}
+    void commitRetaining(Status*) {}
+    void rollback(Status*) {}
+    void deprecatedRollback(Status*) {}
+    void rollbackRetaining(Status*) {}
+    void disconnect(Status*) {}
+    void deprecatedDisconnect(Status*) {}
+
+    Firebird::ITransaction* join(Status* status, Firebird::ITransaction*) {
+        fail(status, "Replay transaction cannot be joined");
+        return nullptr;
+    }
+
+    Firebird::ITransaction* validate(Status*, Firebird::IAttachment*) { return this; }
+
+    Firebird::ITransaction* enterDtc(Status* status) {
+        fail(status, "Replay transaction cannot enter a DTC");
+        return nullptr;
+    }
+
+private:
+    RefCount refs_;
+};
+
+} // namespace
+
+// --- RecordedMessages -------------------------------------------------------
+
+RecordedMessages::RecordedMessages(const fbpp::core::MessageMetadata& metadata) {
+    if (!metadata.getRawMetadata()) {
+        return;   // Zero fields
+    }
+    const unsigned count = metadata.getCount();
+    fields_.reserve(count);
+    for (unsigned i = 0; i < count; ++i) {
+        fields_.push_back(metadata.getField(i));
+    }
+    messageLength_ = metadata.getMessageLength();
+    alignment_ = std::max(metadata.getAlignment(), 1u);
+    alignedLength_ = metadata.getAlignedLength();
+}
+
+std::shared_ptr<RecordedMessages> RecordedMessages::fromSnapshot(const fbpp::core::ResultSnapshot& snapshot) {
+    auto recording = std::make_shared<RecordedMessages>(*snapshot.metadata());
+    recording->data_.reserve(snapshot.rowCount() * recording->messageLength_);
+    for (std::size_t i = 0; i < snapshot.rowCount(); ++i) {
+        recording->add(snapshot.rowData(i));
+    }
+    return recording;
+}
+
+void RecordedMessages::add(const void* message) {
+    const auto* bytes = static_cast<const uint8_t*>(message);
+    data_.insert(data_.end(), bytes, bytes + messageLength_);
+}
+
+// --- ReplayCapture ----------------------------------------------------------
+
+std::size_t ReplayCapture::messages() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return messages_;
+}
+
+std::size_t ReplayCapture::bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_;
+}
+
+std::vector<uint8_t> ReplayCapture::data() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return data_;
+}
+
+void ReplayCapture::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    messages_ = 0;
+    bytes_ = 0;
+    data_.clear();
+}
+
+void ReplayCapture::record(const void* messages, unsigned count, unsigned length, unsigned stride) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    messages_ += count;
+    bytes_ += static_cast<std::size_t>(count) * length;
+    if (!keep_) {
+        return;
+    }
+    const auto* bytes = static_cast<const uint8_t*>(messages);
+    for (unsigned i = 0; i < count; ++i) {
+        const uint8_t* message = bytes + static_cast<std::size_t>(i) * stride;
+        data_.insert(data_.end(), message, message + length);
+    }
+}
+
+// --- ReplaySession ----------------------------------------------------------
+
+namespace {
+
+std::shared_ptr<fbpp::core::Statement> wrap(ReplayStatement* statement) {
+    try {
+        return std::make_shared<fbpp::core::Statement>(statement, nullptr);
+    } catch (...) {
+        statement->release();
+        throw;
+    }
+}
+
+} // namespace
+
+ReplaySession::ReplaySession()
+    : transaction_(std::make_shared<fbpp::core::Transaction>(nullptr, new ReplayTransaction())) {}
+
+std::shared_ptr<fbpp::core::Statement> ReplaySession::prepare(
+    std::shared_ptr<const RecordedMessages> output, std::size_t repeat,
+    std::shared_ptr<const RecordedMessages> input, std::shared_ptr<ReplayCapture> capture) {
+    if (!output) {
+        throw fbpp::core::FirebirdException("ReplaySession: a select needs recorded output");
+    }
+    auto* statement = new ReplayStatement(isc_info_sql_stmt_select, std::move(output), repeat,
+                                          std::move(input), std::move(capture));
+    return wrap(statement);
+}
+
+std::shared_ptr<fbpp::core::Statement> ReplaySession::prepareInsert(
+    std::shared_ptr<const RecordedMessages> input, std::shared_ptr<ReplayCapture> capture) {
+    if (!input) {
+        throw fbpp::core::FirebirdException("ReplaySession: an insert needs a parameter layout");
+    }
+    auto* statement = new ReplayStatement(isc_info_sql_stmt_insert, nullptr, 1,
+                                          std::move(input), std::move(capture));
+    return wrap(statement);
+}
+
+} // namespace fbpp::util
@@ -1,10 +1,16 @@
 #include <fbpp_util/trace.h>
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace fbpp::util {
 namespace {
 std::atomic<TraceSink*> g_traceSink{nullptr};
+std::atomic<int> g_traceLevel{static_cast<int>(TraceLevel::info)};
 } // namespace
 
 void setTraceSink(TraceSink* sink) {
@@ -15,13 +21,167 @@ TraceSink* getTraceSink() {
     return g_traceSink.load(std::memory_order_relaxed);
 }
 
+void setTraceLevel(TraceLevel level) {
+    g_traceLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+TraceLevel getTraceLevel() {
+    return static_cast<TraceLevel>(g_traceLevel.load(std::memory_order_relaxed));
+}
+
+bool traceEnabled(TraceLevel level) {
+    return static_cast<int>(level) >= g_traceLevel.load(std::memory_order_relaxed) &&
+           g_traceSink.load(std::memory_order_relaxed) != nullptr;
+}
+
 void traceMessage(TraceLevel level,
                   std::string_view component,
                   std::string_view message) {
+    if (!traceEnabled(level)) {
+        return;
+    }
     if (auto* sink = getTraceSink()) {
         sink->log(level, component, message);
     }
 }
 
-} // namespace fbpp::util
+// Bounded MPMC queue after D. Vyukov, used with a single consumer: every
+// slot carries a sequence number telling producers and the consumer whose
+// turn it is, so a log() is one CAS on the tail plus the string copies
+// (into slot strings whose capacity is reused).
+struct AsyncTraceSink::State {
+    struct Slot {
+        std::atomic<std::size_t> sequence{0};
+        TraceLevel level = TraceLevel::info;
+        std::string component;
+        std::string message;
+    };
+
+    // Worker sleep when the ring is empty; producers never signal, so a
+    // log() costs no syscall.
+    static constexpr std::chrono::milliseconds kIdleWait{2};
+
+    TraceSink& target;
+    std::vector<Slot> slots;
+    std::size_t mask;
+    alignas(64) std::atomic<std::size_t> tail{0};   // Next slot to claim
+    alignas(64) std::atomic<std::size_t> head{0};   // Next slot to deliver (worker)
+
+    std::mutex mutex;
+    std::condition_variable wake;      // Worker: stop / flush requested
+    std::condition_variable drained;   // flush(): head moved
+    bool stop = false;
+    std::thread worker;
+
+    State(TraceSink& sink, std::size_t capacity) : target(sink), slots(capacity), mask(capacity - 1) {
+        for (std::size_t i = 0; i < capacity; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool push(TraceLevel level, std::string_view component, std::string_view message) {
+        std::size_t pos = tail.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+        for (;;) {
+            slot = &slots[pos & mask];
+            const std::size_t seq = slot->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;   // Full: the slot still holds an undelivered entry
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+        slot->level = level;
+        slot->component.assign(component);
+        slot->message.assign(message);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Deliver what is ready; returns the number of entries delivered.
+    std::size_t drain() {
+        std::size_t delivered = 0;
+        std::size_t pos = head.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots[pos & mask];
+            if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+                break;
+            }
+            try {
+                target.log(slot.level, slot.component, slot.message);
+            } catch (...) {
+                // A failing target must not stop the worker
+            }
+            slot.sequence.store(pos + slots.size(), std::memory_order_release);
+            ++pos;
+            ++delivered;
+            head.store(pos, std::memory_order_release);
+        }
+        return delivered;
+    }
 
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            lock.unlock();
+            const std::size_t delivered = drain();
+            lock.lock();
+            if (delivered != 0) {
+                drained.notify_all();
+                continue;
+            }
+            if (stop) {
+                break;
+            }
+            wake.wait_for(lock, kIdleWait);
+        }
+    }
+};
+
+AsyncTraceSink::AsyncTraceSink(TraceSink& target, std::size_t capacity) {
+    std::size_t rounded = 2;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    state_ = std::make_unique<State>(target, rounded);
+    state_->worker = std::thread([state = state_.get()] { state->run(); });
+}
+
+AsyncTraceSink::~AsyncTraceSink() {
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->stop = true;
+    }
+    state_->wake.notify_one();
+    state_->worker.join();
+    state_->drain();   // Entries published while the worker was stopping
+}
+
+void AsyncTraceSink::log(TraceLevel level,
+                         std::string_view component,
+                         std::string_view message) {
+    if (!state_->push(level, component, message)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void AsyncTraceSink::flush() {
+    // Claimed slots below `target` are published shortly by their producers
+    const std::size_t target = state_->tail.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->wake.notify_one();
+    state_->drained.wait(lock, [&] {
+        return state_->head.load(std::memory_order_acquire) >= target;
+    });
+}
+
+std::size_t AsyncTraceSink::capacity() const noexcept {
+    return state_->slots.size();
+}
+
+} // namespace fbpp::util
@@ -0,0 +1,485 @@
+#include "fbpp_util/workload.hpp"
+#include "fbpp/core/environment.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/message_metadata.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+
+namespace fbpp::util {
+
+namespace {
+
+using fbpp::core::SpanKind;
+using json = nlohmann::json;
+
+std::string hexId(uint64_t value) {
+    char text[17];
+    std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(value));
+    return text;
+}
+
+uint64_t parseId(const std::string& text) {
+    return std::stoull(text, nullptr, 16);
+}
+
+std::string toHex(const std::vector<uint8_t>& bytes) {
+    static const char digits[] = "0123456789abcdef";
+    std::string text;
+    text.reserve(bytes.size() * 2);
+    for (uint8_t b : bytes) {
+        text.push_back(digits[b >> 4]);
+        text.push_back(digits[b & 0x0f]);
+    }
+    return text;
+}
+
+std::vector<uint8_t> fromHex(const std::string& text) {
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        throw std::runtime_error("Workload: bad hex digit in input message");
+    };
+    if (text.size() % 2 != 0) {
+        throw std::runtime_error("Workload: odd-length input message");
+    }
+    std::vector<uint8_t> bytes(text.size() / 2);
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = static_cast<uint8_t>(nibble(text[2 * i]) << 4 | nibble(text[2 * i + 1]));
+    }
+    return bytes;
+}
+
+const char* kindName(WorkloadCall::Kind kind) {
+    switch (kind) {
+        case WorkloadCall::Kind::Execute:  return "execute";
+        case WorkloadCall::Kind::Cursor:   return "cursor";
+        case WorkloadCall::Kind::Commit:   return "commit";
+        case WorkloadCall::Kind::Rollback: return "rollback";
+    }
+    return "execute";
+}
+
+WorkloadCall::Kind kindOf(const std::string& name) {
+    if (name == "execute") return WorkloadCall::Kind::Execute;
+    if (name == "cursor") return WorkloadCall::Kind::Cursor;
+    if (name == "commit") return WorkloadCall::Kind::Commit;
+    if (name == "rollback") return WorkloadCall::Kind::Rollback;
+    throw std::runtime_error("Workload: unknown call kind '" + name + "'");
+}
+
+// One recorded span between startSpan() and endSpan()
+struct RecordedSpan {
+    WorkloadCall call;
+    std::chrono::steady_clock::time_point started;
+};
+
+// Layout of a raw input message; takes its own reference for the wrapper
+WorkloadStatement describeInput(uint64_t fingerprint, std::string_view sql,
+                                Firebird::IMessageMetadata* raw) {
+    WorkloadStatement statement;
+    statement.fingerprint = fingerprint;
+    statement.sql = std::string(sql);
+    raw->addRef();
+    const fbpp::core::MessageMetadata metadata(raw);
+    statement.inputLength = metadata.getMessageLength();
+    for (unsigned i = 0; i < metadata.getCount(); ++i) {
+        const auto& field = metadata.getFieldRef(i);
+        statement.input.push_back(WorkloadField{field.type | (field.nullable ? 1u : 0u),
+                                                field.subType, field.length, field.scale,
+                                                field.charSet});
+    }
+    return statement;
+}
+
+// IMessageMetadata for a recorded layout; offsets are recomputed by
+// Firebird the same way they were when the message was packed
+std::shared_ptr<const fbpp::core::MessageMetadata> buildInput(const WorkloadStatement& statement) {
+    auto* master = fbpp::core::Environment::getInstance().getMaster();
+    Firebird::ThrowStatusWrapper st(master->getStatus());
+    Firebird::IMetadataBuilder* builder = nullptr;
+    Firebird::IMessageMetadata* raw = nullptr;
+    try {
+        builder = master->getMetadataBuilder(&st, static_cast<unsigned>(statement.input.size()));
+        for (unsigned i = 0; i < statement.input.size(); ++i) {
+            const WorkloadField& field = statement.input[i];
+            builder->setType(&st, i, field.type);
+            builder->setSubType(&st, i, static_cast<int>(field.subType));
+            builder->setLength(&st, i, field.length);
+            builder->setCharSet(&st, i, field.charSet);
+            builder->setScale(&st, i, field.scale);
+        }
+        raw = builder->getMetadata(&st);
+    } catch (const Firebird::FbException& e) {
+        fbpp::core::FirebirdException error(e);
+        if (builder) {
+            builder->release();
+        }
+        st.dispose();
+        throw error;
+    }
+    builder->release();
+    st.dispose();
+    return std::make_shared<fbpp::core::MessageMetadata>(raw);   // Takes the reference
+}
+
+double percentile(const std::vector<double>& sorted, double q) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    const auto rank = static_cast<size_t>(std::ceil(q * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+} // namespace
+
+// --- WorkloadRecorder -------------------------------------------------------
+
+WorkloadRecorder::WorkloadRecorder(const std::string& path)
+    : file_(path, std::ios::binary | std::ios::trunc), out_(file_) {
+    if (!file_) {
+        throw std::runtime_error("WorkloadRecorder: cannot create " + path);
+    }
+}
+
+WorkloadRecorder::WorkloadRecorder(std::ostream& out) : out_(out) {}
+
+WorkloadRecorder::~WorkloadRecorder() {
+    if (fbpp::core::getSpanObserver() == this) {
+        fbpp::core::setSpanObserver(nullptr);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    out_.flush();
+}
+
+uint64_t WorkloadRecorder::calls() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return calls_;
+}
+
+unsigned WorkloadRecorder::threadIndex() {
+    const auto id = std::this_thread::get_id();
+    auto it = threads_.find(id);
+    if (it == threads_.end()) {
+        it = threads_.emplace(id, static_cast<unsigned>(threads_.size())).first;
+    }
+    return it->second;
+}
+
+void WorkloadRecorder::writeStatement(const WorkloadStatement& statement) {
+    json fields = json::array();
+    for (const auto& field : statement.input) {
+        fields.push_back({field.type, field.subType, field.length, field.scale, field.charSet});
+    }
+    out_ << json{{"statement", hexId(statement.fingerprint)},
+                 {"sql", statement.sql},
+                 {"input", std::move(fields)},
+                 {"length", statement.inputLength}}.dump()
+         << '\n';
+}
+
+void* WorkloadRecorder::startSpan(const fbpp::core::SpanStart& start) {
+    auto span = std::make_unique<RecordedSpan>();
+    switch (start.kind) {
+        case SpanKind::Execute:   span->call.kind = WorkloadCall::Kind::Execute; break;
+        case SpanKind::FetchLoop: span->call.kind = WorkloadCall::Kind::Cursor; break;
+        case SpanKind::Commit:    span->call.kind = WorkloadCall::Kind::Commit; break;
+        case SpanKind::Rollback:  span->call.kind = WorkloadCall::Kind::Rollback; break;
+        case SpanKind::Connect:
+        case SpanKind::Prepare:
+            return nullptr;   // Replay prepares on its own attachment
+    }
+    span->call.fingerprint = start.fingerprint;
+
+    const bool statement = span->call.kind == WorkloadCall::Kind::Execute ||
+                           span->call.kind == WorkloadCall::Kind::Cursor;
+    std::lock_guard<std::mutex> lock(mutex_);
+    span->call.thread = threadIndex();
+    if (statement) {
+        auto it = written_.find(start.fingerprint);
+        if (it == written_.end()) {
+            WorkloadStatement described;
+            if (start.input && start.inputMetadata) {
+                described = describeInput(start.fingerprint, start.sql, start.inputMetadata);
+            } else {
+                described.fingerprint = start.fingerprint;
+                described.sql = std::string(start.sql);
+            }
+            writeStatement(described);
+            it = written_.emplace(start.fingerprint, described.inputLength).first;
+        }
+        if (start.input && it->second > 0) {
+            const auto* bytes = static_cast<const uint8_t*>(start.input);
+            span->call.input.assign(bytes, bytes + it->second);
+        }
+    }
+    span->started = std::chrono::steady_clock::now();
+    return span.release();
+}
+
+void WorkloadRecorder::endSpan(void* handle, const fbpp::core::SpanEnd& end) noexcept {
+    std::unique_ptr<RecordedSpan> span(static_cast<RecordedSpan*>(handle));
+    if (!span) {
+        return;
+    }
+    try {
+        const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - span->started).count();
+        json line{{"call", kindName(span->call.kind)},
+                  {"thread", span->call.thread},
+                  {"us", micros}};
+        if (span->call.fingerprint != 0) {
+            line["fp"] = hexId(span->call.fingerprint);
+            line["rows"] = end.rows;
+        }
+        if (!span->call.input.empty()) {
+            line["input"] = toHex(span->call.input);
+        }
+        if (end.failed) {
+            line["failed"] = true;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        out_ << line.dump() << '\n';
+        ++calls_;
+    } catch (...) {
+        // Recording must never fail the database call it describes
+    }
+}
+
+// --- readWorkload -----------------------------------------------------------
+
+Workload readWorkload(std::istream& in) {
+    Workload workload;
+    std::string text;
+    size_t lineNo = 0;
+    while (std::getline(in, text)) {
+        ++lineNo;
+        if (text.empty()) {
+            continue;
+        }
+        try {
+            const json line = json::parse(text);
+            if (line.contains("statement")) {
+                WorkloadStatement statement;
+                statement.fingerprint = parseId(line.at("statement").get<std::string>());
+                statement.sql = line.at("sql").get<std::string>();
+                statement.inputLength = line.value("length", 0u);
+                for (const auto& field : line.value("input", json::array())) {
+                    statement.input.push_back(WorkloadField{
+                        field.at(0).get<unsigned>(), field.at(1).get<unsigned>(),
+                        field.at(2).get<unsigned>(), field.at(3).get<int>(),
+                        field.at(4).get<unsigned>()});
+                }
+                workload.statements[statement.fingerprint] = std::move(statement);
+                continue;
+            }
+            WorkloadCall call;
+            call.kind = kindOf(line.at("call").get<std::string>());
+            call.thread = line.value("thread", 0u);
+            call.micros = line.value("us", uint64_t{0});
+            call.rows = line.value("rows", uint64_t{0});
+            call.failed = line.value("failed", false);
+            if (line.contains("fp")) {
+                call.fingerprint = parseId(line.at("fp").get<std::string>());
+            }
+            if (line.contains("input")) {
+                call.input = fromHex(line.at("input").get<std::string>());
+            }
+            workload.calls.push_back(std::move(call));
+        } catch (const std::exception& e) {
+            throw std::runtime_error("Workload line " + std::to_string(lineNo) + ": " + e.what());
+        }
+    }
+    return workload;
+}
+
+Workload readWorkload(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open workload " + path);
+    }
+    return readWorkload(in);
+}
+
+// --- replayWorkload ---------------------------------------------------------
+
+std::map<uint64_t, StatementTiming> replayWorkload(fbpp::core::Connection& connection,
+                                                    const Workload& workload,
+                                                    const ReplayOptions& options) {
+    struct Prepared {
+        std::shared_ptr<fbpp::core::Statement> statement;
+        std::shared_ptr<const fbpp::core::MessageMetadata> input;   // Recorded layout
+        std::vector<double> micros;
+        uint64_t failures = 0;
+        uint64_t rows = 0;
+        double recordedMicros = 0;
+        uint64_t recordedCalls = 0;
+    };
+    std::map<uint64_t, Prepared> prepared;
+    for (const auto& [fingerprint, statement] : workload.statements) {
+        Prepared& p = prepared[fingerprint];
+        p.statement = connection.prepareStatement(statement.sql);
+        if (!statement.input.empty()) {
+            p.input = buildInput(statement);
+        }
+    }
+    for (const auto& call : workload.calls) {
+        auto it = prepared.find(call.fingerprint);
+        if (it != prepared.end() && !call.failed) {
+            it->second.recordedMicros += static_cast<double>(call.micros);
+            ++it->second.recordedCalls;
+        }
+    }
+
+    const unsigned passes = options.warmup + std::max(options.iterations, 1u);
+    for (unsigned pass = 0; pass < passes; ++pass) {
+        const bool timed = pass >= options.warmup;
+        std::map<unsigned, std::shared_ptr<fbpp::core::Transaction>> transactions;
+        auto transactionOf = [&](unsigned thread) -> fbpp::core::Transaction& {
+            auto& tx = transactions[thread];
+            if (!tx) {
+                tx = connection.StartTransaction();
+            }
+            return *tx;
+        };
+
+        for (const auto& call : workload.calls) {
+            if (call.kind == WorkloadCall::Kind::Commit || call.kind == WorkloadCall::Kind::Rollback) {
+                auto it = transactions.find(call.thread);
+                if (it != transactions.end()) {
+                    if (call.kind == WorkloadCall::Kind::Commit) {
+                        it->second->Commit();
+                    } else {
+                        it->second->Rollback();
+                    }
+                    transactions.erase(it);
+                }
+                continue;
+            }
+            auto found = prepared.find(call.fingerprint);
+            if (found == prepared.end()) {
+                continue;   // No statement line: truncated recording
+            }
+            Prepared& p = found->second;
+            Firebird::IMessageMetadata* input = nullptr;
+            const void* message = nullptr;
+            if (p.input && !call.input.empty()) {
+                if (call.input.size() != p.input->getMessageLength()) {
+                    if (timed) {
+                        ++p.failures;
+                    }
+                    continue;
+                }
+                input = p.input->getRawMetadata();
+                message = call.input.data();
+            }
+
+            auto& tx = transactionOf(call.thread);
+            uint64_t rows = 0;
+            const auto started = std::chrono::steady_clock::now();
+            try {
+                if (call.kind == WorkloadCall::Kind::Cursor) {
+                    auto cursor = tx.openCursorMessage(p.statement, input, message);
+                    for (const auto& row : cursor->rows()) {
+                        (void)row;
+                        ++rows;
+                    }
+                    cursor->close();
+                } else {
+                    rows = tx.executeMessage(p.statement, input, message);
+                }
+            } catch (const fbpp::core::FirebirdException&) {
+                if (timed) {
+                    ++p.failures;
+                }
+                continue;
+            }
+            if (timed) {
+                p.micros.push_back(std::chrono::duration<double, std::micro>(
+                    std::chrono::steady_clock::now() - started).count());
+                p.rows += rows;
+            }
+        }
+        // Transactions still open when the recording ended
+        for (auto& [thread, tx] : transactions) {
+            tx->Rollback();
+        }
+    }
+
+    std::map<uint64_t, StatementTiming> timings;
+    for (auto& [fingerprint, p] : prepared) {
+        StatementTiming timing;
+        timing.fingerprint = fingerprint;
+        timing.sql = workload.statements.at(fingerprint).sql;
+        timing.calls = p.micros.size();
+        timing.failures = p.failures;
+        timing.rows = p.rows;
+        std::sort(p.micros.begin(), p.micros.end());
+        if (!p.micros.empty()) {
+            double sum = 0;
+            for (double m : p.micros) {
+                sum += m;
+            }
+            timing.meanMicros = sum / static_cast<double>(p.micros.size());
+        }
+        timing.p50Micros = percentile(p.micros, 0.50);
+        timing.p99Micros = percentile(p.micros, 0.99);
+        if (p.recordedCalls) {
+            timing.recordedMeanMicros = p.recordedMicros / static_cast<double>(p.recordedCalls);
+        }
+        timings.emplace(fingerprint, std::move(timing));
+    }
+    return timings;
+}
+
+// --- Baselines --------------------------------------------------------------
+
+nlohmann::json timingsToJson(const std::map<uint64_t, StatementTiming>& timings) {
+    json statements = json::object();
+    for (const auto& [fingerprint, t] : timings) {
+        statements[hexId(fingerprint)] = {{"sql", t.sql},
+                                          {"calls", t.calls},
+                                          {"failures", t.failures},
+                                          {"rows", t.rows},
+                                          {"mean_us", t.meanMicros},
+                                          {"p50_us", t.p50Micros},
+                                          {"p99_us", t.p99Micros}};
+    }
+    return json{{"version", 1}, {"statements", std::move(statements)}};
+}
+
+std::vector<Regression> compareToBaseline(const std::map<uint64_t, StatementTiming>& current,
+                                          const nlohmann::json& baseline,
+                                          double threshold, uint64_t minCalls) {
+    std::vector<Regression> regressions;
+    const auto statements = baseline.value("statements", json::object());
+    for (const auto& [fingerprint, t] : current) {
+        const auto it = statements.find(hexId(fingerprint));
+        if (it == statements.end() || t.calls < std::max<uint64_t>(minCalls, 1)) {
+            continue;
+        }
+        const double before = it->value("p50_us", 0.0);
+        if (before <= 0) {
+            continue;
+        }
+        const double change = t.p50Micros / before - 1.0;
+        if (change > threshold) {
+            regressions.push_back(Regression{fingerprint, t.sql, before, t.p50Micros, change});
+        }
+    }
+    std::sort(regressions.begin(), regressions.end(),
+              [](const Regression& a, const Regression& b) { return a.change > b.change; });
+    return regressions;
+}
+
+} // namespace fbpp::util
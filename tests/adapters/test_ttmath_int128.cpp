@@ -133,4 +133,16 @@ TEST_F(TTMathInt128Test, Arithmetic) {
     auto fb_sum = adapt_to_firebird(sum);
     auto restored_sum = adapt_from_firebird<Int128>(fb_sum);
     EXPECT_EQ(restored_sum.ToString(), "3000000000000000000");
-}
\ No newline at end of file
+}
+
+TEST_F(TTMathInt128Test, DecimalStringLimits) {
+    const std::string max_str = "170141183460469231731687303715884105727";
+    const std::string min_str = "-170141183460469231731687303715884105728";
+    EXPECT_EQ(make_int128(max_str).ToString(), max_str);
+    EXPECT_EQ(make_int128(min_str).ToString(), min_str);
+    EXPECT_EQ(make_int128("-42").ToString(), "-42");
+    EXPECT_EQ(make_int128("+42").ToString(), "42");
+
+    Int128 sum = make_int128("99999999999999999999") + make_int128("1");
+    EXPECT_EQ(sum.ToString(), "100000000000000000000");
+}
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include "fbpp/adapters/ttmath_numeric.hpp"
 #include "fbpp/core/type_adapter.hpp"
+#include <cstring>
 #include <vector>
 #include <tuple>
 
@@ -433,4 +434,68 @@ TEST_F(TTMathScaleTest, IncrementDecrementWithDifferentScales) {
     EXPECT_EQ(very_precise.to_string(), "1.999999");
     --very_precise;
     EXPECT_EQ(very_precise.to_string(), "0.999999");
-}
\ No newline at end of file
+}
+
+TEST_F(TTMathScaleTest, WireConversionInt64AndInt128) {
+    // NUMERIC(18,4) on the wire: INT64 of 1234567 at scale -4 = 123.4567
+    const int64_t wire64 = -1234567;
+    auto fromInt64 = Scale2::from_wire(reinterpret_cast<const uint8_t*>(&wire64), 8, -4);
+    EXPECT_EQ(fromInt64.to_string(), "-123.45");   // Truncated toward zero
+
+    uint8_t out64[8];
+    Scale4("-123.4567").to_wire(out64, 8, -4);
+    int64_t back64 = 0;
+    std::memcpy(&back64, out64, 8);
+    EXPECT_EQ(back64, wire64);
+
+    // INT128 round trip of a value beyond 64 bits
+    Scale6 big("-12345678901234567890123.456789");
+    uint8_t out128[16];
+    big.to_wire(out128, 16, -6);
+    EXPECT_EQ(Scale6::from_wire(out128, 16, -6), big);
+    EXPECT_EQ(Scale2::from_wire(out128, 16, -6).to_string(), "-12345678901234567890123.45");
+}
+
+TEST_F(TTMathScaleTest, WireConversionRejectsOverflow) {
+    uint8_t out16[2];
+    EXPECT_THROW(Scale2("400.00").to_wire(out16, 2, -2), FirebirdException);   // 40000 > INT16
+    Scale2("-327.68").to_wire(out16, 2, -2);
+    int16_t back16 = 0;
+    std::memcpy(&back16, out16, 2);
+    EXPECT_EQ(back16, -32768);
+
+    // A one-word type cannot take a 128-bit value wider than the word
+    using Narrow = TTNumeric<1, -2>;
+    uint8_t wide[16] = {};
+    wide[12] = 1;
+    EXPECT_THROW(Narrow::from_wire(wide, 16, -2), FirebirdException);
+    const int64_t small = -5;
+    uint8_t wideSmall[16];
+    std::memset(wideSmall, 0xFF, sizeof(wideSmall));
+    std::memcpy(wideSmall, &small, sizeof(small));
+    EXPECT_EQ(Narrow::from_wire(wideSmall, 16, -2).to_string(), "-0.05");
+}
+
+TEST_F(TTMathScaleTest, TextConversionEdgeCases) {
+    EXPECT_EQ(Scale2("-0.05").to_string(), "-0.05");
+    EXPECT_EQ(Scale2("  +7.").to_string(), "7");
+    EXPECT_EQ(Scale2(".5").to_string(), "0.5");
+    EXPECT_EQ(Scale2("12.3456789").to_string(), "12.34");
+    EXPECT_EQ(Scale2("-12.3456789").to_string(), "-12.34");
+    EXPECT_EQ(Scale18("0.000000000000000001").to_string(), "0.000000000000000001");
+    EXPECT_EQ(Scale0("0").to_string(), "0");
+
+    // Digits agree with ttmath's own conversion across chunk boundaries
+    Scale0 v("1");
+    for (int i = 0; i < 38; ++i) {
+        v.raw_value().MulInt(10);
+        v.raw_value().AddInt(static_cast<ttmath::uint>(i % 10));
+        EXPECT_EQ(v.to_string(), v.raw_value().ToString());
+        EXPECT_EQ(Scale0(v.to_string()), v);
+    }
+
+    Scale2 minimum;
+    minimum.raw_value().SetMin();
+    EXPECT_EQ(minimum.to_string()[0], '-');
+    EXPECT_EQ(Scale2(minimum.to_string()), minimum);
+}
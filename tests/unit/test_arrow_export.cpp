@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/ext/arrow_export.hpp"
+
+#include <arrow/api.h>
+
+#include <memory>
+#include <string>
+
+// fbpp::ext::ResultSetRecordBatchReader — ResultSet as arrow::RecordBatch stream.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+class ArrowExportTest : public TempDatabaseTest {
+protected:
+    void createTestSchema() override {
+        TempDatabaseTest::createTestSchema();
+        connection_->ExecuteDDL(R"(
+            CREATE TABLE ax_t (
+                id       INTEGER NOT NULL PRIMARY KEY,
+                f_num    NUMERIC(18,2),
+                f_bool   BOOLEAN,
+                f_vc     VARCHAR(32),
+                f_date   DATE,
+                f_ts     TIMESTAMP,
+                f_i128   INT128,
+                f_n38    NUMERIC(38,4),
+                f_df     DECFLOAT(34),
+                f_ts_tz  TIMESTAMP WITH TIME ZONE
+            )
+        )");
+
+        auto tx = connection_->StartTransaction();
+        connection_->ExecuteInTransaction(tx.get(),
+            "INSERT INTO ax_t VALUES (1, -12.34, TRUE, 'abc', DATE '1970-01-02', "
+            "TIMESTAMP '1970-01-01 00:00:02', 42, 1.5, 2.75, "
+            "TIMESTAMP '1970-01-01 00:00:03 UTC')");
+        connection_->ExecuteInTransaction(tx.get(),
+            "INSERT INTO ax_t (id) VALUES (2)");
+        connection_->ExecuteInTransaction(tx.get(),
+            "INSERT INTO ax_t (id, f_bool, f_vc) VALUES (3, FALSE, 'xyz')");
+        tx->Commit();
+    }
+};
+
+TEST_F(ArrowExportTest, SchemaMapsExtendedTypes) {
+    auto stmt = connection_->prepareStatement("SELECT * FROM ax_t");
+    auto tx = connection_->StartTransaction();
+    auto cur = tx->openCursor(stmt);
+
+    auto schema = fbpp::ext::makeArrowSchema(*cur->getMetadata());
+    ASSERT_EQ(schema->num_fields(), 10);
+    EXPECT_TRUE(schema->field(0)->type()->Equals(arrow::int32()));
+    EXPECT_FALSE(schema->field(0)->nullable());
+    EXPECT_TRUE(schema->field(1)->type()->Equals(arrow::decimal128(19, 2)));
+    EXPECT_TRUE(schema->field(2)->type()->Equals(arrow::boolean()));
+    EXPECT_TRUE(schema->field(3)->type()->Equals(arrow::utf8()));
+    EXPECT_TRUE(schema->field(4)->type()->Equals(arrow::date32()));
+    EXPECT_TRUE(schema->field(5)->type()->Equals(arrow::timestamp(arrow::TimeUnit::MICRO)));
+    EXPECT_TRUE(schema->field(6)->type()->Equals(arrow::decimal128(38, 0)));
+    EXPECT_TRUE(schema->field(7)->type()->Equals(arrow::decimal128(38, 4)));
+    EXPECT_TRUE(schema->field(8)->type()->Equals(arrow::utf8()));
+    EXPECT_TRUE(schema->field(9)->type()->Equals(
+        arrow::timestamp(arrow::TimeUnit::MICRO, "UTC")));
+}
+
+TEST_F(ArrowExportTest, StreamsValuesAndNulls) {
+    auto stmt = connection_->prepareStatement("SELECT * FROM ax_t ORDER BY id");
+    auto tx = connection_->StartTransaction();
+    auto cur = tx->openCursor(stmt);
+
+    fbpp::ext::ResultSetRecordBatchReader reader(*cur, 2);
+
+    std::shared_ptr<arrow::RecordBatch> batch;
+    ASSERT_TRUE(reader.ReadNext(&batch).ok());
+    ASSERT_NE(batch, nullptr);
+    ASSERT_EQ(batch->num_rows(), 2);
+    ASSERT_TRUE(batch->ValidateFull().ok());
+
+    auto ids = std::static_pointer_cast<arrow::Int32Array>(batch->column(0));
+    EXPECT_EQ(ids->Value(0), 1);
+    EXPECT_EQ(ids->Value(1), 2);
+
+    auto num = std::static_pointer_cast<arrow::Decimal128Array>(batch->column(1));
+    EXPECT_EQ(num->FormatValue(0), "-12.34");
+    EXPECT_TRUE(num->IsNull(1));
+
+    auto flags = std::static_pointer_cast<arrow::BooleanArray>(batch->column(2));
+    EXPECT_TRUE(flags->Value(0));
+    EXPECT_TRUE(flags->IsNull(1));
+
+    auto vc = std::static_pointer_cast<arrow::StringArray>(batch->column(3));
+    EXPECT_EQ(vc->GetView(0), "abc");
+    EXPECT_TRUE(vc->IsNull(1));
+
+    EXPECT_EQ(std::static_pointer_cast<arrow::Date32Array>(batch->column(4))->Value(0), 1);
+    EXPECT_EQ(std::static_pointer_cast<arrow::TimestampArray>(batch->column(5))->Value(0), 2000000);
+    EXPECT_EQ(std::static_pointer_cast<arrow::Decimal128Array>(batch->column(6))->FormatValue(0), "42");
+    EXPECT_EQ(std::static_pointer_cast<arrow::Decimal128Array>(batch->column(7))->FormatValue(0), "1.5000");
+    EXPECT_EQ(std::static_pointer_cast<arrow::StringArray>(batch->column(8))->GetView(0), "2.75");
+    EXPECT_EQ(std::static_pointer_cast<arrow::TimestampArray>(batch->column(9))->Value(0), 3000000);
+
+    ASSERT_TRUE(reader.ReadNext(&batch).ok());
+    ASSERT_NE(batch, nullptr);
+    ASSERT_EQ(batch->num_rows(), 1);
+    auto flags2 = std::static_pointer_cast<arrow::BooleanArray>(batch->column(2));
+    EXPECT_FALSE(flags2->IsNull(0));
+    EXPECT_FALSE(flags2->Value(0));
+
+    ASSERT_TRUE(reader.ReadNext(&batch).ok());
+    EXPECT_EQ(batch, nullptr);
+}
+
+// Firebird stores past the declared NUMERIC precision; the Arrow precision
+// must cover the whole storage type or ValidateFull() rejects the batch.
+TEST_F(ArrowExportTest, StorageBoundaryValuesValidate) {
+    connection_->ExecuteDDL(R"(
+        CREATE TABLE ax_bounds (
+            f_n4    NUMERIC(4,2),
+            f_n9    NUMERIC(9,2),
+            f_n18   NUMERIC(18,2),
+            f_i128  INT128
+        )
+    )");
+    auto tx = connection_->StartTransaction();
+    connection_->ExecuteInTransaction(tx.get(),
+        "INSERT INTO ax_bounds VALUES (327.67, 21474836.47, 92233720368547758.07, "
+        "99999999999999999999999999999999999999)");
+    tx->Commit();
+
+    tx = connection_->StartTransaction();
+    auto cur = tx->openCursor(connection_->prepareStatement("SELECT * FROM ax_bounds"));
+    fbpp::ext::ResultSetRecordBatchReader reader(*cur, 16);
+    EXPECT_TRUE(reader.schema()->field(0)->type()->Equals(arrow::decimal128(5, 2)));
+    EXPECT_TRUE(reader.schema()->field(1)->type()->Equals(arrow::decimal128(10, 2)));
+    EXPECT_TRUE(reader.schema()->field(2)->type()->Equals(arrow::decimal128(19, 2)));
+
+    std::shared_ptr<arrow::RecordBatch> batch;
+    ASSERT_TRUE(reader.ReadNext(&batch).ok());
+    ASSERT_NE(batch, nullptr);
+    ASSERT_TRUE(batch->ValidateFull().ok());
+    auto decimal = [&](int column) {
+        return std::static_pointer_cast<arrow::Decimal128Array>(batch->column(column))->FormatValue(0);
+    };
+    EXPECT_EQ(decimal(0), "327.67");
+    EXPECT_EQ(decimal(1), "21474836.47");
+    EXPECT_EQ(decimal(2), "92233720368547758.07");
+    EXPECT_EQ(decimal(3), "99999999999999999999999999999999999999");
+    cur->close();
+    tx->Commit();
+
+    // INT128 max has 39 digits: no decimal128 holds it
+    tx = connection_->StartTransaction();
+    connection_->ExecuteInTransaction(tx.get(),
+        "UPDATE ax_bounds SET f_i128 = 170141183460469231731687303715884105727");
+    cur = tx->openCursor(connection_->prepareStatement("SELECT * FROM ax_bounds"));
+    fbpp::ext::ResultSetRecordBatchReader wide(*cur, 16);
+    const auto status = wide.ReadNext(&batch);
+    EXPECT_FALSE(status.ok());
+    EXPECT_NE(status.message().find("39 digits"), std::string::npos) << status.ToString();
+    cur->close();
+    tx->Rollback();
+}
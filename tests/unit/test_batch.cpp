@@ -0,0 +1,553 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/batch.hpp"
+#include "fbpp/core/batch_impl.hpp"
+#include "fbpp/core/json_text_packer.hpp"
+#include "fbpp/core/bulk_loader.hpp"
+#include "fbpp/core/parallel_bulk_loader.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Batch: chunked stream packing and range input for addMany();
+// BulkLoader: size-triggered flushes and merged results, EXECUTE BLOCK fallback.
+// ParallelBulkLoader: partitions over several connections.
+// Batch results: lazy BatchCompletion, capped error formatting.
+// Batch BLOBs: addBlob() from memory/stream/callback, registerBlob().
+
+namespace {
+
+struct BatchRow {
+    int32_t id;
+    std::string name;
+};
+
+} // namespace
+
+namespace fbpp::core {
+
+template<>
+struct StructDescriptor<BatchRow> {
+    static constexpr auto fields = std::make_tuple(
+        makeField<&BatchRow::id>("ID", SQL_LONG, 0, sizeof(int32_t), 0, false),
+        makeField<&BatchRow::name>("NAME", SQL_VARYING, 0, 32, 0, true)
+    );
+};
+
+} // namespace fbpp::core
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+class BatchTest : public TempDatabaseTest {
+protected:
+    void createTestSchema() override {
+        TempDatabaseTest::createTestSchema();
+        connection_->ExecuteDDL(R"(
+            CREATE TABLE batch_t (
+                id    INTEGER NOT NULL PRIMARY KEY,
+                name  VARCHAR(32)
+            )
+        )");
+    }
+
+    int64_t countRows() {
+        auto tx = connection_->StartTransaction();
+        auto stmt = connection_->prepareStatement("SELECT COUNT(*) FROM batch_t");
+        auto cur = tx->openCursor(stmt);
+        std::tuple<int64_t> row;
+        EXPECT_TRUE(cur->fetch(row));
+        tx->Commit();
+        return std::get<0>(row);
+    }
+};
+
+TEST_F(BatchTest, AddManyFromLazyRangeInSmallChunks) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement("INSERT INTO batch_t (id, name) VALUES (?, ?)");
+    auto batch = stmt->createBatch(tx.get());
+
+    // Force many IBatch::add() calls: a few messages per chunk.
+    batch->setStreamChunkBytes(256);
+    EXPECT_EQ(batch->getStreamChunkBytes(), 256u);
+
+    auto rows = std::views::iota(1, 1001) | std::views::transform([](int i) {
+        return std::make_tuple(i, std::string("row ") + std::to_string(i));
+    });
+    batch->addMany(rows);
+    EXPECT_EQ(batch->getMessageCount(), 1000u);
+
+    auto result = batch->execute(tx.get());
+    EXPECT_EQ(result.totalMessages, 1000u);
+    EXPECT_EQ(result.successCount, 1000u);
+    EXPECT_EQ(result.failedCount, 0u);
+    tx->Commit();
+
+    EXPECT_EQ(countRows(), 1000);
+}
+
+TEST_F(BatchTest, AddManyAppendsAcrossCallsAndInputKinds) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement("INSERT INTO batch_t (id, name) VALUES (?, ?)");
+    auto batch = stmt->createBatch(tx.get());
+
+    std::vector<std::tuple<int, std::string>> tuples = {{1, "a"}, {2, "b"}};
+    batch->addMany(tuples);
+
+    const std::vector<nlohmann::json> objects = {
+        nlohmann::json::array({3, "c"}),
+        nlohmann::json::array({4, "d"})
+    };
+    batch->addMany(objects);
+
+    std::vector<std::tuple<int, std::string>> more = {{5, "e"}};
+    batch->addMany(more.begin(), more.end());
+    batch->addMany(std::vector<std::tuple<int, std::string>>{});
+
+    EXPECT_EQ(batch->getMessageCount(), 5u);
+    auto result = batch->execute(tx.get());
+    EXPECT_EQ(result.successCount, 5u);
+    tx->Commit();
+
+    EXPECT_EQ(countRows(), 5);
+}
+
+TEST_F(BatchTest, AddsNdjsonWithNamedKeys) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement("INSERT INTO batch_t (id, name) VALUES (:id, :name)");
+    auto batch = stmt->createBatch(tx.get());
+    batch->setStreamChunkBytes(128);
+
+    std::string ndjson;
+    for (int i = 1; i <= 300; ++i) {
+        ndjson += "{\"ID\": " + std::to_string(i) + ", \"name\": \"r\\u00e9 " +
+                  std::to_string(i) + "\"}\r\n";
+    }
+    ndjson += "\n{\"id\": 301}\n";   // Blank line skipped; missing key -> NULL
+    batch->addMany(splitJsonLines(ndjson));
+    batch->add(JsonText{R"([302, "positional"])"});
+    EXPECT_THROW(batch->add(JsonText{R"({"id": 1, "nmae": "typo"})"}), FirebirdException);
+    EXPECT_THROW(batch->add(JsonText{R"({"id": 1, )"}), FirebirdException);
+
+    EXPECT_EQ(batch->getMessageCount(), 302u);
+    auto result = batch->execute(tx.get());
+    EXPECT_EQ(result.successCount, 302u);
+    tx->Commit();
+    EXPECT_EQ(countRows(), 302);
+
+    auto check = connection_->StartTransaction();
+    auto sel = connection_->prepareStatement(
+        "SELECT name FROM batch_t WHERE id IN (7, 301) ORDER BY id");
+    auto cur = check->openCursor(sel);
+    std::tuple<std::optional<std::string>> row;
+    ASSERT_TRUE(cur->fetch(row));
+    EXPECT_EQ(std::get<0>(row), std::optional<std::string>("r\xc3\xa9 7"));
+    ASSERT_TRUE(cur->fetch(row));
+    EXPECT_FALSE(std::get<0>(row).has_value());
+    cur->close();
+    check->Commit();
+}
+
+TEST_F(BatchTest, BulkLoaderFlushesBySizeAndMergesResults) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement("INSERT INTO batch_t (id, name) VALUES (?, ?)");
+
+    using Row = std::tuple<int, std::string>;
+    BulkLoaderOptions options;
+    options.flushBytes = 4096;          // a few dozen messages per batch
+    options.commitEveryFlushes = 2;
+    options.continueOnError = true;
+    BulkLoader<Row> loader(stmt, tx, options);
+
+    auto rows = std::views::iota(1, 501) | std::views::transform([](int i) {
+        return Row{i, std::string("row ") + std::to_string(i)};
+    });
+    loader.addMany(rows);
+    EXPECT_GT(loader.flushCount(), 1u);
+    EXPECT_LT(loader.bufferedBytes(), options.flushBytes);
+
+    // Duplicate key: its index must be load-wide, not per batch.
+    loader.add(Row{7, "dup"});
+    loader.add(Row{501, "last"});
+
+    auto result = loader.finish();
+    EXPECT_EQ(loader.bufferedBytes(), 0u);
+    EXPECT_EQ(result.totalMessages, 502u);
+    EXPECT_EQ(result.successCount, 501u);
+    EXPECT_EQ(result.failedCount, 1u);
+    ASSERT_EQ(result.errorIndices.size(), 1u);
+    EXPECT_EQ(result.errorIndices[0], 500u);
+    tx->Commit();
+
+    EXPECT_EQ(countRows(), 501);
+}
+
+TEST_F(BatchTest, BulkLoaderPipelinedKeepsPerFlushErrors) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement("INSERT INTO batch_t (id, name) VALUES (?, ?)");
+
+    using Row = std::tuple<int, std::string>;
+    BulkLoaderOptions options;
+    options.flushBytes = 4096;
+    options.continueOnError = true;
+    options.pipelined = true;
+    BulkLoader<Row> loader(stmt, tx, options);
+
+    // id 10 repeats at position 2000: the error lands in a late flush.
+    auto rows = std::views::iota(0, 2001) | std::views::transform([](int i) {
+        const int id = i == 2000 ? 10 : i + 1;
+        return Row{id, std::string("row ") + std::to_string(i)};
+    });
+    loader.addMany(rows);
+
+    auto result = loader.finish();
+    EXPECT_EQ(result.totalMessages, 2001u);
+    EXPECT_EQ(result.successCount, 2000u);
+    ASSERT_EQ(result.errorIndices.size(), 1u);
+    EXPECT_EQ(result.errorIndices[0], 2000u);
+
+    const auto& flushes = loader.flushes();
+    ASSERT_EQ(flushes.size(), loader.flushCount());
+    ASSERT_GT(flushes.size(), 2u);
+    unsigned next = 0;
+    for (const auto& flush : flushes) {
+        EXPECT_EQ(flush.firstMessage, next);
+        EXPECT_GT(flush.messageCount, 0u);
+        next += flush.messageCount;
+    }
+    EXPECT_EQ(next, 2001u);
+    EXPECT_EQ(flushes.back().failedCount, 1u);
+    tx->Commit();
+
+    EXPECT_EQ(countRows(), 2000);
+}
+
+TEST_F(BatchTest, BulkLoaderExecuteBlockMatchesBatchResults) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement("INSERT INTO batch_t (id, name) VALUES (?, ?)");
+
+    using Row = std::tuple<int, std::string>;
+    BulkLoaderOptions options;
+    options.flushBytes = 4096;
+    options.continueOnError = true;
+    options.method = BulkLoadMethod::ExecuteBlock;
+    options.blockRows = 16;
+    BulkLoader<Row> loader(stmt, tx, options);
+    EXPECT_TRUE(loader.usesExecuteBlock());
+
+    auto rows = std::views::iota(1, 301) | std::views::transform([](int i) {
+        return Row{i, std::string("row ") + std::to_string(i)};
+    });
+    loader.addMany(rows);
+    EXPECT_GT(loader.flushCount(), 1u);
+    EXPECT_LT(loader.bufferedBytes(), options.flushBytes);
+
+    loader.add(Row{7, "dup"});
+    loader.add(Row{301, "last"});
+
+    auto result = loader.finish();
+    EXPECT_EQ(loader.bufferedBytes(), 0u);
+    EXPECT_EQ(result.totalMessages, 302u);
+    EXPECT_EQ(result.successCount, 301u);
+    EXPECT_EQ(result.failedCount, 1u);
+    ASSERT_EQ(result.errorIndices.size(), 1u);
+    EXPECT_EQ(result.errorIndices[0], 300u);
+    EXPECT_EQ(result.errors[0].rfind("Message 300: SQLSTATE 23000", 0), 0u);
+    EXPECT_EQ(result.perMessageStatus[0], 1);
+    EXPECT_EQ(result.perMessageStatus[300], -1);
+    tx->Commit();
+
+    EXPECT_EQ(countRows(), 301);
+
+    // Without continueOnError the flush stops at the failed row
+    auto tx2 = connection_->StartTransaction();
+    options.continueOnError = false;
+    BulkLoader<Row> stopping(stmt, tx2, options);
+    stopping.add(Row{400, "a"});
+    stopping.add(Row{1, "dup"});
+    stopping.add(Row{401, "b"});
+    auto stopped = stopping.finish();
+    EXPECT_EQ(stopped.totalMessages, 2u);
+    EXPECT_EQ(stopped.failedCount, 1u);
+    tx2->Commit();
+
+    EXPECT_EQ(countRows(), 302);
+}
+
+TEST_F(BatchTest, ExecuteWithoutRecordCountsReportsOnlyFailures) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement("INSERT INTO batch_t (id, name) VALUES (?, ?)");
+
+    BatchOptions options;
+    options.recordCounts = false;
+    options.continueOnError = true;
+    options.bufferBytes = 1024 * 1024;
+    auto batch = stmt->createBatch(tx.get(), options);
+    for (int i = 1; i <= 100; ++i) {
+        batch->add(std::make_tuple(i % 40 == 0 ? 1 : i, std::string("row")));
+    }
+    auto result = batch->execute(tx.get());
+    EXPECT_TRUE(result.perMessageStatus.empty());
+    EXPECT_EQ(result.totalMessages, 100u);
+    EXPECT_EQ(result.failedCount, 2u);
+    EXPECT_EQ(result.successCount, 98u);
+    EXPECT_EQ(result.errorIndices, (std::vector<unsigned>{39, 79}));
+
+    // Without multi-error the batch stops at its first failure
+    options.continueOnError = false;
+    auto stopping = stmt->createBatch(tx.get(), options);
+    stopping->add(std::make_tuple(200, std::string("a")));
+    stopping->add(std::make_tuple(1, std::string("dup")));
+    stopping->add(std::make_tuple(201, std::string("b")));
+    auto stopped = stopping->execute(tx.get());
+    EXPECT_EQ(stopped.totalMessages, 2u);
+    EXPECT_EQ(stopped.failedCount, 1u);
+    EXPECT_EQ(stopped.errorIndices, (std::vector<unsigned>{1}));
+    tx->Commit();
+
+    EXPECT_EQ(countRows(), 99);
+}
+
+TEST_F(BatchTest, AddsDescribedStructsDirectly) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement("INSERT INTO batch_t (id, name) VALUES (?, ?)");
+    auto batch = stmt->createBatch(tx.get());
+
+    batch->add(BatchRow{1, "one"});
+
+    std::vector<BatchRow> rows;
+    for (int32_t i = 2; i <= 100; ++i) {
+        rows.push_back({i, "row " + std::to_string(i)});
+    }
+    batch->addMany(std::span<const BatchRow>(rows));
+    EXPECT_EQ(batch->getMessageCount(), 100u);
+
+    auto result = batch->execute(tx.get());
+    EXPECT_EQ(result.successCount, 100u);
+    tx->Commit();
+
+    EXPECT_EQ(countRows(), 100);
+
+    auto check = connection_->StartTransaction();
+    auto select = connection_->prepareStatement("SELECT name FROM batch_t WHERE id = 42");
+    auto cur = check->openCursor(select);
+    std::tuple<std::string> name;
+    ASSERT_TRUE(cur->fetch(name));
+    EXPECT_EQ(std::get<0>(name), "row 42");
+    check->Commit();
+}
+
+TEST_F(BatchTest, DeferredCompletionFormatsErrorsOnDemand) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement("INSERT INTO batch_t (id, name) VALUES (?, ?)");
+
+    // Every tenth message repeats an earlier key.
+    auto rows = std::views::iota(0, 100) | std::views::transform([](int i) {
+        const int id = i % 10 == 9 ? i - 5 : i + 1;
+        return std::make_tuple(id, std::string("row ") + std::to_string(i));
+    });
+
+    BatchOptions options;
+    options.continueOnError = true;
+    auto batch = stmt->createBatch(tx.get(), options);
+    batch->addMany(rows);
+
+    auto completion = batch->executeDeferred(tx.get());
+    EXPECT_EQ(completion.size(), 100u);
+    EXPECT_EQ(completion.failedCount(), 10u);
+    EXPECT_EQ(completion.successCount(), 90u);
+
+    const unsigned first = completion.nextError();
+    EXPECT_EQ(first, 9u);
+    EXPECT_EQ(completion.nextError(first + 1), 19u);
+    EXPECT_EQ(completion.nextError(100), BatchCompletion::npos);
+    EXPECT_TRUE(completion.failed(first));
+    EXPECT_FALSE(completion.errorMessage(first).empty());
+    EXPECT_TRUE(completion.errorMessage(0).empty());
+
+    // A moved-to completion still owns the state
+    BatchCompletion moved = std::move(completion);
+    auto result = moved.toResult(3);
+    EXPECT_EQ(result.totalMessages, 100u);
+    EXPECT_EQ(result.failedCount, 10u);
+    EXPECT_EQ(result.perMessageStatus.size(), 100u);
+    ASSERT_EQ(result.errors.size(), 3u);
+    EXPECT_EQ(result.errorIndices, (std::vector<unsigned>{9, 19, 29}));
+    tx->Rollback();
+
+    // Same cap through execute()
+    auto tx2 = connection_->StartTransaction();
+    auto capped = stmt->createBatch(tx2.get(), options);
+    capped->addMany(rows);
+    auto cappedResult = capped->execute(tx2.get(), 1);
+    EXPECT_EQ(cappedResult.failedCount, 10u);
+    EXPECT_EQ(cappedResult.errors.size(), 1u);
+    tx2->Commit();
+
+    EXPECT_EQ(countRows(), 90);
+}
+
+TEST_F(BatchTest, ParallelLoaderSplitsAcrossConnections) {
+    using Row = std::tuple<int, std::string>;
+    std::vector<Row> rows;
+    for (int i = 1; i <= 2000; ++i) {
+        rows.emplace_back(i, "row " + std::to_string(i));
+    }
+
+    ParallelLoadOptions options;
+    options.partitions = 3;
+    options.loader.flushBytes = 8192;
+    ParallelBulkLoader<Row> loader(db_params_, "INSERT INTO batch_t (id, name) VALUES (?, ?)", options);
+
+    auto report = loader.load(rows);
+    EXPECT_TRUE(report.ok());
+    ASSERT_EQ(report.partitions.size(), 3u);
+    size_t assigned = 0;
+    for (const auto& part : report.partitions) {
+        EXPECT_TRUE(part.committed) << part.error;
+        assigned += part.rows;
+    }
+    EXPECT_EQ(assigned, rows.size());
+    EXPECT_EQ(report.result.successCount, 2000u);
+    EXPECT_EQ(report.committedRows, 2000u);
+    EXPECT_GT(report.rowsPerSecond(), 0.0);
+
+    EXPECT_EQ(countRows(), 2000);
+}
+
+TEST_F(BatchTest, ParallelLoaderReportsSourceIndexesForKeyedPartitions) {
+    using Row = std::tuple<int, std::string>;
+    std::vector<Row> rows;
+    for (int i = 1; i <= 200; ++i) {
+        rows.emplace_back(i, "row");
+    }
+    rows.emplace_back(42, "dup");      // Source index 200, same key partition as 42
+
+    ParallelLoadOptions options;
+    options.partitions = 4;
+    options.loader.continueOnError = true;
+    ParallelBulkLoader<Row> loader(
+        [this] { return std::make_unique<Connection>(db_params_); },
+        "INSERT INTO batch_t (id, name) VALUES (?, ?)", options);
+
+    auto report = loader.load(rows, [](const Row& row) {
+        return static_cast<size_t>(std::get<0>(row));
+    });
+    EXPECT_FALSE(report.ok());
+    EXPECT_EQ(report.result.totalMessages, 201u);
+    EXPECT_EQ(report.result.failedCount, 1u);
+    ASSERT_EQ(report.result.errorIndices.size(), 1u);
+    EXPECT_EQ(report.result.errorIndices[0], 200u);
+    EXPECT_EQ(report.result.errors[0].rfind("Message 200: ", 0), 0u);
+    EXPECT_EQ(report.result.perMessageStatus[200], -1);
+    EXPECT_EQ(report.committedRows, 200u);
+
+    EXPECT_EQ(countRows(), 200);
+}
+
+class BatchBlobTest : public TempDatabaseTest {
+protected:
+    void createTestSchema() override {
+        TempDatabaseTest::createTestSchema();
+        connection_->ExecuteDDL(R"(
+            CREATE TABLE batch_blob_t (
+                id       INTEGER NOT NULL PRIMARY KEY,
+                payload  BLOB SUB_TYPE BINARY
+            )
+        )");
+    }
+
+    std::string readPayload(int32_t id) {
+        auto tx = connection_->StartTransaction();
+        auto stmt = connection_->prepareStatement("SELECT payload FROM batch_blob_t WHERE id = ?");
+        auto cur = tx->openCursor(stmt, std::make_tuple(id));
+        std::tuple<std::string> row;
+        EXPECT_TRUE(cur->fetch(row));
+        tx->Commit();
+        return std::get<0>(row);
+    }
+};
+
+TEST_F(BatchBlobTest, AddsBlobsFromMemoryStreamAndCallback) {
+    // Several segments each, the last one partial
+    std::string big(3 * Batch::kBlobSegmentBytes + 123, '\0');
+    for (size_t i = 0; i < big.size(); ++i) {
+        big[i] = static_cast<char>(i * 31 + 7);
+    }
+
+    int32_t base = 0;
+    for (auto policy : {BatchBlobPolicy::IdEngine, BatchBlobPolicy::IdUser}) {
+        auto tx = connection_->StartTransaction();
+        auto stmt = connection_->prepareStatement("INSERT INTO batch_blob_t (id, payload) VALUES (?, ?)");
+        BatchOptions options;
+        options.blobPolicy = policy;
+        auto batch = stmt->createBatch(tx.get(), options);
+        EXPECT_EQ(batch->getBlobPolicy(), policy);
+
+        batch->add(std::make_tuple(base + 1, batch->addBlob(big.data(), big.size())));
+
+        std::istringstream in(big);
+        batch->add(std::make_tuple(base + 2, batch->addBlob(in)));
+
+        size_t produced = 0;
+        auto blob = batch->addBlob([&](uint8_t* buffer, size_t capacity) {
+            const size_t n = std::min<size_t>(capacity, 1000 - produced);
+            std::memset(buffer, 'z', n);
+            produced += n;
+            return n;
+        });
+        batch->add(std::make_tuple(base + 3, blob));
+
+        batch->add(std::make_tuple(base + 4, batch->addBlob("", 0)));
+
+        auto result = batch->execute(tx.get());
+        EXPECT_EQ(result.successCount, 4u);
+        tx->Commit();
+
+        EXPECT_EQ(readPayload(base + 1), big);
+        EXPECT_EQ(readPayload(base + 2), big);
+        EXPECT_EQ(readPayload(base + 3), std::string(1000, 'z'));
+        EXPECT_EQ(readPayload(base + 4), "");
+        base += 10;
+    }
+}
+
+TEST_F(BatchBlobTest, RegistersExistingBlobAndChecksPolicy) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement("INSERT INTO batch_blob_t (id, payload) VALUES (?, ?)");
+
+    auto plain = stmt->createBatch(tx.get());
+    EXPECT_EQ(plain->getBlobPolicy(), BatchBlobPolicy::None);
+    EXPECT_THROW(plain->addBlob("x", 1), FirebirdException);
+    EXPECT_THROW(plain->addBlobStream("x", 1), FirebirdException);
+    plain->cancel();
+
+    BatchOptions options;
+    options.blobPolicy = BatchBlobPolicy::IdEngine;
+    auto batch = stmt->createBatch(tx.get(), options);
+
+    const std::vector<uint8_t> bytes = {1, 2, 3, 4, 5};
+    ISC_QUAD existing = tx->createBlob(bytes);
+    Blob registered = batch->registerBlob(Blob(reinterpret_cast<const uint8_t*>(&existing)));
+    batch->add(std::make_tuple(int32_t{1}, registered));
+
+    auto result = batch->execute(tx.get());
+    EXPECT_EQ(result.successCount, 1u);
+    tx->Commit();
+
+    EXPECT_EQ(readPayload(1), std::string("\x01\x02\x03\x04\x05"));
+}
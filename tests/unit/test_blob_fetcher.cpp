@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/extended_types.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/transaction_options.hpp"
+#include "fbpp/schema/blob_fetcher.hpp"
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+// BlobFetcher — BLOB ids of one cursor loaded concurrently in one snapshot.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+using fbpp::schema::BlobFetcher;
+using fbpp::schema::BlobFetchOptions;
+
+class BlobFetcherTest : public TempDatabaseTest {
+protected:
+    static constexpr int32_t kDocs = 60;
+
+    // Every 10th document has no body; the others 1..60 KB
+    static std::vector<uint8_t> body(int32_t id) {
+        std::vector<uint8_t> bytes(static_cast<std::size_t>(id) * 1024);
+        for (std::size_t i = 0; i < bytes.size(); ++i) {
+            bytes[i] = static_cast<uint8_t>(i * 31 + static_cast<std::size_t>(id));
+        }
+        return bytes;
+    }
+
+    void createTestSchema() override {
+        connection_->ExecuteDDL(
+            "CREATE TABLE doc (id INTEGER NOT NULL PRIMARY KEY, body BLOB SUB_TYPE BINARY)");
+        auto tx = connection_->StartTransaction();
+        auto insert = connection_->prepareStatement("INSERT INTO doc VALUES (?, ?)");
+        auto insertNull = connection_->prepareStatement("INSERT INTO doc (id) VALUES (?)");
+        for (int32_t id = 1; id <= kDocs; ++id) {
+            if (id % 10 == 0) {
+                tx->execute(insertNull, std::make_tuple(id));
+                continue;
+            }
+            ISC_QUAD blob = tx->createBlob(body(id));
+            tx->execute(insert,
+                        std::make_tuple(id, Blob(reinterpret_cast<const uint8_t*>(&blob))));
+        }
+        tx->Commit();
+    }
+
+    static TransactionOptions snapshot() {
+        TransactionOptions options;
+        options.isolation = TxIsolation::Concurrency;
+        options.readOnly = true;
+        return options;
+    }
+};
+
+TEST_F(BlobFetcherTest, LoadsEveryBlobOnceInTheSourceSnapshot) {
+    auto tx = connection_->StartTransaction(snapshot());
+    auto cursor =
+        tx->openCursor(connection_->prepareStatement("SELECT id, body FROM doc ORDER BY id"));
+    const auto ids = BlobFetcher::collectIds(*cursor, 1);
+    cursor->close();
+    ASSERT_EQ(ids.size(), static_cast<std::size_t>(kDocs));
+    EXPECT_FALSE(ids[9].has_value());
+
+    BlobFetchOptions options;
+    options.connections = 3;
+    BlobFetcher fetcher(db_params_, options);
+
+    std::mutex mutex;
+    std::map<std::size_t, std::vector<uint8_t>> loaded;
+    const auto result = fetcher.fetch(*tx, ids, [&](std::size_t row, std::vector<uint8_t>&& bytes) {
+        std::lock_guard<std::mutex> lock(mutex);
+        EXPECT_TRUE(loaded.emplace(row, std::move(bytes)).second);
+    });
+    ASSERT_TRUE(result.ok());
+    EXPECT_EQ(result.workers.size(), 3u);
+    EXPECT_EQ(result.blobs, static_cast<uint64_t>(kDocs - kDocs / 10));
+    EXPECT_EQ(result.nulls, static_cast<uint64_t>(kDocs / 10));
+    if (connection_->getEngineMajorVersion() >= 4) {
+        EXPECT_TRUE(result.snapshotNumber.has_value());
+    }
+
+    uint64_t bytes = 0;
+    ASSERT_EQ(loaded.size(), result.blobs);
+    for (const auto& [row, content] : loaded) {
+        EXPECT_EQ(content, body(static_cast<int32_t>(row) + 1));
+        bytes += content.size();
+    }
+    EXPECT_EQ(result.bytes, bytes);
+    tx->Commit();
+}
+
+TEST_F(BlobFetcherTest, SinkFailureStopsTheWorkers) {
+    auto tx = connection_->StartTransaction(snapshot());
+    auto cursor = tx->openCursor(connection_->prepareStatement("SELECT body FROM doc"));
+    const auto ids = BlobFetcher::collectIds(*cursor, 0);
+    cursor->close();
+
+    BlobFetcher fetcher(db_params_);
+    const auto result = fetcher.fetch(*tx, ids, [](std::size_t, std::vector<uint8_t>&&) {
+        throw FirebirdException("sink full");
+    });
+    EXPECT_FALSE(result.ok());
+    EXPECT_EQ(result.blobs, 0u);
+
+    auto idCursor = tx->openCursor(connection_->prepareStatement("SELECT id FROM doc"));
+    EXPECT_THROW(BlobFetcher::collectIds(*idCursor, 0), FirebirdException);
+    idCursor->close();
+    tx->Commit();
+}
@@ -0,0 +1,311 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/blob.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/exception.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// BlobReader: chunked reads into caller buffers, sink consumption, info()
+// and the stream-only seek().
+// BlobWriter: incremental writes, stream BLOBs, file/stream sources, cancel.
+// readToFile()/writeFile(): file round trip through mappings.
+// readAllText()/writeTextFrom(): charset conversion segment by segment.
+// Inline BLOBs: memo columns read the same with and without inlining.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+namespace {
+
+std::vector<uint8_t> pattern(size_t size) {
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<uint8_t>((i * 131) ^ (i >> 8));
+    }
+    return data;
+}
+
+} // namespace
+
+class BlobStreamTest : public TempDatabaseTest {};
+
+TEST_F(BlobStreamTest, ReadsInCallerSizedChunks) {
+    auto tx = connection_->StartTransaction();
+    const auto data = pattern(1024 * 1024 + 17);
+    const ISC_QUAD id = tx->createBlob(data);
+
+    for (size_t chunk : {size_t{7}, size_t{4096}, size_t{100000}}) {
+        auto reader = tx->openBlob(id);
+        std::vector<uint8_t> out;
+        std::vector<std::byte> buffer(chunk);
+        while (size_t n = reader.read(std::span<std::byte>(buffer))) {
+            // Short reads only at the end
+            if (!reader.eof()) {
+                EXPECT_EQ(n, chunk);
+            }
+            const auto* bytes = reinterpret_cast<const uint8_t*>(buffer.data());
+            out.insert(out.end(), bytes, bytes + n);
+        }
+        EXPECT_TRUE(reader.eof());
+        EXPECT_EQ(out, data) << "chunk " << chunk;
+    }
+    tx->Commit();
+}
+
+TEST_F(BlobStreamTest, SinkInfoAndLoadBlob) {
+    auto tx = connection_->StartTransaction();
+    const auto data = pattern(300000);
+    ISC_QUAD id = tx->createBlob(data);
+
+    auto reader = tx->openBlob(id, 10000);
+    const BlobInfo info = reader.info();
+    EXPECT_EQ(info.totalLength, data.size());
+    EXPECT_GT(info.numSegments, 0u);
+    EXPECT_FALSE(info.isStream);
+
+    std::vector<uint8_t> out;
+    size_t calls = 0;
+    const uint64_t total = reader.readAll([&](std::span<const std::byte> chunk) {
+        EXPECT_LE(chunk.size(), 10000u);
+        const auto* bytes = reinterpret_cast<const uint8_t*>(chunk.data());
+        out.insert(out.end(), bytes, bytes + chunk.size());
+        ++calls;
+    });
+    EXPECT_EQ(total, data.size());
+    EXPECT_EQ(calls, 30u);
+    EXPECT_EQ(out, data);
+    reader.close();
+    EXPECT_FALSE(reader.isOpen());
+
+    EXPECT_EQ(tx->loadBlob(&id), data);
+    tx->Commit();
+}
+
+TEST_F(BlobStreamTest, SeekNeedsStreamBlobAndReaderKeepsTransaction) {
+    BlobReader reader = [&] {
+        auto tx = connection_->StartTransaction();
+        const ISC_QUAD id = tx->createBlob(pattern(1000));
+        return tx->openBlob(id);
+    }();   // caller's handle is gone; the reader still owns the transaction
+
+    EXPECT_THROW(reader.seek(10), FirebirdException);
+
+    std::vector<uint8_t> out(2000);
+    EXPECT_EQ(reader.read(out.data(), out.size()), 1000u);
+    EXPECT_EQ(reader.read(out.data(), out.size()), 0u);
+}
+
+TEST_F(BlobStreamTest, WriterAppendsIncrementallyInLargeSegments) {
+    auto tx = connection_->StartTransaction();
+    const auto data = pattern(1024 * 1024 + 5);
+
+    auto writer = tx->createBlobStream(0, false);
+    EXPECT_EQ(writer.segmentSize(), BlobWriter::kMaxSegmentBytes);
+    const size_t pieces[] = {1, 65535, 65536, 200000};
+    size_t offset = 0;
+    for (size_t i = 0; offset < data.size(); ++i) {
+        const size_t n = std::min(pieces[i % 4], data.size() - offset);
+        writer.write(data.data() + offset, n);
+        offset += n;
+    }
+    EXPECT_EQ(writer.bytesWritten(), data.size());
+    ISC_QUAD id = writer.finish();
+    EXPECT_FALSE(writer.isOpen());
+    EXPECT_THROW(writer.write("x", 1), FirebirdException);
+
+    auto reader = tx->openBlob(id);
+    EXPECT_FALSE(reader.info().isStream);
+    // No segment above the putSegment() limit
+    EXPECT_LE(reader.info().maxSegmentSize, BlobWriter::kMaxSegmentBytes);
+    EXPECT_EQ(reader.readAll(), data);
+    tx->Commit();
+}
+
+TEST_F(BlobStreamTest, StreamBlobFromFileSupportsSeek) {
+    const auto data = pattern(500000);
+    const auto path = std::filesystem::temp_directory_path() / "fbpp_blob_stream_test.bin";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+
+    auto tx = connection_->StartTransaction();
+    auto writer = tx->createBlobStream();
+    EXPECT_EQ(writer.writeFile(path.string()), data.size());
+    const ISC_QUAD id = writer.finish();
+    std::filesystem::remove(path);
+
+    auto reader = tx->openBlob(id);
+    EXPECT_TRUE(reader.info().isStream);
+    EXPECT_EQ(reader.info().totalLength, data.size());
+    EXPECT_EQ(reader.seek(400000), 400000u);
+    std::vector<uint8_t> tail(200000);
+    ASSERT_EQ(reader.read(tail.data(), tail.size()), 100000u);
+    EXPECT_TRUE(std::equal(tail.begin(), tail.begin() + 100000, data.begin() + 400000));
+    tx->Commit();
+}
+
+TEST_F(BlobStreamTest, WriterFromIstreamAndCancel) {
+    auto tx = connection_->StartTransaction();
+
+    std::istringstream in(std::string(100000, 'q'));
+    auto writer = tx->createBlobStream(1, false, 4096);
+    EXPECT_EQ(writer.segmentSize(), 4096u);
+    EXPECT_EQ(writer.writeFrom(in), 100000u);
+    ISC_QUAD id = writer.finish();
+    const auto back = tx->loadBlob(&id);
+    EXPECT_EQ(std::string(back.begin(), back.end()), std::string(100000, 'q'));
+
+    auto discarded = tx->createBlobStream();
+    discarded.write("abc", 3);
+    discarded.cancel();
+    EXPECT_FALSE(discarded.isOpen());
+    EXPECT_THROW(discarded.finish(), FirebirdException);
+
+    {
+        // Destructor cancels an unfinished BLOB without throwing
+        auto abandoned = tx->createBlobStream();
+        abandoned.write("abc", 3);
+    }
+    tx->Commit();
+}
+
+TEST_F(BlobStreamTest, InlineBlobLimitKeepsMemoColumnsIntact) {
+    connection_->ExecuteDDL(
+        "CREATE TABLE memo_t (id INTEGER NOT NULL PRIMARY KEY, "
+        "a BLOB SUB_TYPE TEXT, b BLOB SUB_TYPE TEXT)");
+
+    auto tx = connection_->StartTransaction();
+    auto insert = connection_->prepareStatement("INSERT INTO memo_t (id, a, b) VALUES (?, ?, ?)");
+    const std::string big(100000, 'b');   // Above any inline limit: regular path
+    for (int32_t i = 0; i < 200; ++i) {
+        const std::string a = "memo " + std::to_string(i);
+        const std::string b = i % 50 == 0 ? big : "note " + std::to_string(i);
+        auto aId = tx->createBlob(std::vector<uint8_t>(a.begin(), a.end()), 1);
+        auto bId = tx->createBlob(std::vector<uint8_t>(b.begin(), b.end()), 1);
+        tx->execute(insert, std::make_tuple(i, Blob(reinterpret_cast<const uint8_t*>(&aId)),
+                                            Blob(reinterpret_cast<const uint8_t*>(&bId))));
+    }
+    tx->Commit();
+
+    auto select = connection_->prepareStatementUncached("SELECT id, a, b FROM memo_t ORDER BY id");
+    if (select->setMaxInlineBlobSize(16 * 1024)) {
+        EXPECT_EQ(select->getMaxInlineBlobSize(), 16u * 1024);
+    } else {
+        EXPECT_EQ(select->getMaxInlineBlobSize(), 0u);
+    }
+
+    auto read = connection_->StartTransaction();
+    auto cursor = read->openCursor(select);
+    cursor->setPrefetch(64);
+    std::tuple<int32_t, std::string, std::string> row;
+    int32_t expected = 0;
+    while (cursor->fetch(row)) {
+        EXPECT_EQ(std::get<0>(row), expected);
+        EXPECT_EQ(std::get<1>(row), "memo " + std::to_string(expected));
+        EXPECT_EQ(std::get<2>(row), expected % 50 == 0 ? big : "note " + std::to_string(expected));
+        ++expected;
+    }
+    EXPECT_EQ(expected, 200);
+    read->Commit();
+}
+
+TEST_F(BlobStreamTest, FileRoundTripThroughMappings) {
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto source = dir / "fbpp_blob_map_in.bin";
+    const auto target = dir / "fbpp_blob_map_out.bin";
+    const auto data = pattern(3 * 1024 * 1024 + 77);
+    {
+        std::ofstream out(source, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+
+    auto tx = connection_->StartTransaction();
+    auto writer = tx->createBlobStream(0, false);
+    ASSERT_EQ(writer.writeFile(source.string()), data.size());
+    const ISC_QUAD id = writer.finish();
+
+    // Target exists with stale, longer content: it must be truncated.
+    {
+        std::ofstream stale(target, std::ios::binary);
+        stale << std::string(4 * 1024 * 1024, 'x');
+    }
+    auto reader = tx->openBlob(id);
+    EXPECT_EQ(reader.readToFile(target.string()), data.size());
+    EXPECT_TRUE(reader.eof());
+    tx->Commit();
+
+    EXPECT_EQ(std::filesystem::file_size(target), data.size());
+    std::ifstream in(target, std::ios::binary);
+    std::vector<uint8_t> back(data.size());
+    in.read(reinterpret_cast<char*>(back.data()), static_cast<std::streamsize>(back.size()));
+    EXPECT_EQ(back, data);
+
+    std::filesystem::remove(source);
+    std::filesystem::remove(target);
+}
+
+TEST_F(BlobStreamTest, TranscodesTextSegmentBySegment) {
+    // Cyrillic and the euro sign: 2- and 3-byte UTF-8 sequences that odd
+    // segment sizes cut in the middle
+    std::string utf8;
+    std::string win1251;
+    for (int i = 0; i < 5000; ++i) {
+        utf8 += "\xD0\x9F\xD1\x80\xD0\xB8 \xE2\x82\xAC" + std::to_string(i) + "\n";
+        win1251 += "\xCF\xF0\xE8 \x88" + std::to_string(i) + "\n";
+    }
+
+    auto tx = connection_->StartTransaction();
+    auto writer = tx->createBlobStream(0, false, 333);
+    std::istringstream source(utf8);
+    TextTranscoder toWin1251(std::nullopt, SingleByteCharset::Win1251);
+    EXPECT_EQ(writer.writeTextFrom(source, toWin1251), win1251.size());
+    const ISC_QUAD id = writer.finish();
+
+    auto raw = tx->openBlob(id).readAll();
+    EXPECT_EQ(std::string(raw.begin(), raw.end()), win1251);
+
+    auto reader = tx->openBlob(id, 101);
+    auto fromWin1251 = TextTranscoder::forCharsetIds(52, 4);
+    std::string back;
+    std::size_t chunks = 0;
+    const uint64_t total = reader.readAllText(fromWin1251, [&](std::string_view text) {
+        EXPECT_LE(text.size(), 101u * 3);
+        back.append(text);
+        ++chunks;
+    });
+    EXPECT_EQ(total, utf8.size());
+    EXPECT_EQ(back, utf8);
+    EXPECT_GT(chunks, 100u);
+
+    // Pieces cut inside a character are completed by the next one
+    auto pieces = tx->createBlobStream(0, false);
+    TextTranscoder again(std::nullopt, SingleByteCharset::Win1251);
+    const std::size_t cut = utf8.find('\n', 1000) + 1;
+    for (std::size_t at = 0; at < cut; at += 7) {
+        pieces.writeText(std::string_view(utf8).substr(at, std::min<std::size_t>(7, cut - at)),
+                         again);
+    }
+    pieces.flushText(again);
+    auto prefix = tx->openBlob(pieces.finish()).readAll();
+    std::string expected;
+    TextTranscoder whole(std::nullopt, SingleByteCharset::Win1251);
+    whole.feed(std::string_view(utf8).substr(0, cut), expected);
+    EXPECT_EQ(std::string(prefix.begin(), prefix.end()), expected);
+    tx->Commit();
+}
@@ -381,4 +381,30 @@ TEST_F(CachedStatementsTest, CacheHitRate) {
     EXPECT_EQ(stats.missCount, 1);
     EXPECT_EQ(stats.hitCount, 9);
     EXPECT_DOUBLE_EQ(stats.hitRate, 90.0);  // 9 hits out of 10 total = 90%
-}
+}
+
+// Default prepares use ConnectionOptions::prepareFlags; the rest is lazy
+TEST_F(CachedStatementsTest, DefaultPrepareFlagsAreMinimal) {
+    EXPECT_EQ(connection_->prepareFlags(Statement::PREPARE_DEFAULT),
+              static_cast<unsigned>(Statement::PREPARE_PREFETCH_MINIMAL));
+    EXPECT_EQ(connection_->prepareFlags(Statement::PREPARE_PREFETCH_ALL),
+              static_cast<unsigned>(Statement::PREPARE_PREFETCH_ALL));
+
+    auto stmt = connection_->prepareStatement("SELECT id, name FROM test_cached WHERE id = ?");
+    EXPECT_EQ(stmt->kind(), Statement::StatementKind::Select);
+    EXPECT_EQ(stmt->getInputMetadata()->getCount(), 1u);
+    EXPECT_EQ(stmt->getOutputMetadata()->getCount(), 2u);
+    const std::string plan = stmt->getPlan();
+    EXPECT_NE(plan.find("TEST_CACHED"), std::string::npos);
+    EXPECT_EQ(stmt->getPlan(), plan);   // Kept after the first fetch
+    EXPECT_NE(stmt->getFlags() & Firebird::IStatement::FLAG_HAS_CURSOR, 0u);
+
+    // A connection-wide profile applies to later default prepares
+    ConnectionOptions options = connection_->getOptions();
+    options.prepareFlags = Statement::PREPARE_PREFETCH_ALL;
+    connection_->setOptions(options);
+    EXPECT_EQ(connection_->prepareFlags(Statement::PREPARE_DEFAULT),
+              static_cast<unsigned>(Statement::PREPARE_PREFETCH_ALL));
+    auto full = connection_->prepareStatementUncached("SELECT id FROM test_cached");
+    EXPECT_EQ(full->getOutputMetadata()->getCount(), 1u);
+}
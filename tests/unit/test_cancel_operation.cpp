@@ -2,11 +2,26 @@
 #include "../test_base.hpp"
 #include "fbpp/core/connection.hpp"
 #include "fbpp/core/exception.hpp"
+#include "fbpp/core/cancel_scope.hpp"
+#include "fbpp/core/deadline.hpp"
+
+#include <chrono>
+#include <stop_token>
+#include <thread>
+#include <tuple>
 
 using namespace fbpp::core;
 using namespace fbpp::test;
 
 class CancelOperationTest : public TempDatabaseTest {};
+
+namespace {
+
+// Runs for minutes unless cancelled
+constexpr const char* kSlowQuery =
+    "SELECT COUNT(*) FROM RDB$FIELDS a, RDB$FIELDS b, RDB$FIELDS c";
+
+} // namespace
 
 // Test basic enable/disable operations
 TEST_F(CancelOperationTest, EnableDisableCancelOperations) {
@@ -83,6 +98,141 @@ TEST_F(CancelOperationTest, CancelOperationOnDisconnected) {
 }
 
 
+TEST_F(CancelOperationTest, CancelScopeDeadlineInterruptsQuery) {
+    auto stmt = connection_->prepareStatement(kSlowQuery);
+    auto tx = connection_->StartTransaction();
+
+    const auto started = std::chrono::steady_clock::now();
+    bool fired = false;
+    try {
+        CancelScope scope(*connection_, std::chrono::milliseconds(300));
+        auto cursor = tx->openCursor(stmt);
+        std::tuple<int64_t> row;
+        cursor->fetch(row);
+        ADD_FAILURE() << "query was not cancelled";
+    } catch (const FirebirdException&) {
+        fired = true;
+    }
+    EXPECT_TRUE(fired);
+    EXPECT_LT(std::chrono::steady_clock::now() - started, std::chrono::seconds(10));
+
+    // The attachment and transaction stay usable.
+    EXPECT_TRUE(connection_->isConnected());
+    EXPECT_NO_THROW(tx->Rollback());
+}
+
+TEST_F(CancelOperationTest, CancelScopeDisarmedWhenCallFinishes) {
+    {
+        CancelScope scope(*connection_, std::chrono::milliseconds(100));
+        auto tx = connection_->Execute("DELETE FROM test_table WHERE id = -1");
+        tx->Commit();
+        EXPECT_FALSE(scope.fired());
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    auto tx = connection_->Execute("DELETE FROM test_table WHERE id = -1");
+    EXPECT_NO_THROW(tx->Commit());
+
+    EXPECT_THROW(CancelScope(*connection_, std::chrono::milliseconds(-1)), FirebirdException);
+}
+
+TEST_F(CancelOperationTest, OpenCursorAsyncStopsOnStopToken) {
+    auto stmt = connection_->prepareStatement(kSlowQuery);
+    auto tx = connection_->StartTransaction();
+
+    std::stop_source stop;
+    AsyncOptions options;
+    options.stop = stop.get_token();
+    auto pending = openCursorAsync(tx, stmt, std::tuple<>{}, options);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    stop.request_stop();
+    ASSERT_EQ(pending.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+    // Opening may already have returned; then the first fetch does the work.
+    try {
+        auto cursor = pending.get();
+        std::tuple<int64_t> row;
+        CancelScope scope(*connection_, std::chrono::milliseconds(200));
+        cursor->fetch(row);
+        ADD_FAILURE() << "query was not cancelled";
+    } catch (const FirebirdException&) {
+    }
+    EXPECT_TRUE(connection_->isConnected());
+    tx->Rollback();
+}
+
+TEST_F(CancelOperationTest, ExecuteAsyncCompletesWithinDeadline) {
+    auto stmt = connection_->prepareStatement(
+        "INSERT INTO test_table (id, name, amount) VALUES (?, ?, ?)");
+    auto tx = connection_->StartTransaction();
+    auto pending = executeAsync(tx, stmt, std::make_tuple(77, std::string("async"), 1.5),
+                                AsyncOptions::timeout(std::chrono::seconds(10)));
+    EXPECT_EQ(pending.get(), 1u);
+    tx->Commit();
+}
+
+TEST_F(CancelOperationTest, DeadlineScopesNest) {
+    EXPECT_EQ(Deadline::current(), nullptr);
+    {
+        DeadlineScope outer(std::chrono::seconds(10));
+        {
+            DeadlineScope inner(std::chrono::milliseconds(50));
+            EXPECT_LE(Deadline::current()->remaining(), std::chrono::milliseconds(50));
+            {
+                // A later deadline does not extend the budget
+                DeadlineScope later(std::chrono::seconds(60));
+                EXPECT_EQ(later.deadline().at(), inner.deadline().at());
+            }
+        }
+        EXPECT_EQ(Deadline::current(), &outer.deadline());
+        {
+            DeadlineScope::Suspend unbounded;
+            EXPECT_EQ(Deadline::current(), nullptr);
+        }
+        EXPECT_EQ(Deadline::current(), &outer.deadline());
+    }
+    EXPECT_EQ(Deadline::current(), nullptr);
+}
+
+TEST_F(CancelOperationTest, DeadlineStopsSlowQuery) {
+    auto stmt = connection_->prepareStatement(kSlowQuery);
+    auto tx = connection_->StartTransaction();
+    const auto started = std::chrono::steady_clock::now();
+    try {
+        DeadlineScope budget(std::chrono::milliseconds(300));
+        auto cursor = tx->openCursor(stmt);
+        std::tuple<int64_t> row;
+        cursor->fetch(row);
+        ADD_FAILURE() << "query outlived its deadline";
+    } catch (const FirebirdException& e) {
+        EXPECT_TRUE(Deadline::isExceeded(e)) << e.what();
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - started, std::chrono::seconds(10));
+    // The statement timeout set for the deadline is not left behind
+    EXPECT_EQ(stmt->getTimeout(), 0u);
+    EXPECT_TRUE(connection_->isConnected());
+    tx->Rollback();
+}
+
+TEST_F(CancelOperationTest, ExpiredDeadlineShedsBeforeExecute) {
+    auto stmt = connection_->prepareStatement(
+        "INSERT INTO test_table (id, name, amount) VALUES (?, ?, ?)");
+    auto tx = connection_->StartTransaction();
+    {
+        DeadlineScope budget(std::chrono::milliseconds(1));
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        try {
+            tx->execute(stmt, std::make_tuple(78, std::string("late"), 1.0));
+            ADD_FAILURE() << "execute ran past the deadline";
+        } catch (const FirebirdException& e) {
+            EXPECT_TRUE(Deadline::isExceeded(e)) << e.what();
+        }
+    }
+    // Outside the scope the same call goes through
+    EXPECT_EQ(tx->execute(stmt, std::make_tuple(78, std::string("late"), 1.0)), 1u);
+    tx->Commit();
+}
+
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/batch.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/schema/chunked_dml.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// ChunkedDml — key-range chunks, commit modes, parallel workers, stop and resume.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+using fbpp::schema::ChunkCommit;
+using fbpp::schema::ChunkedDml;
+using fbpp::schema::ChunkedDmlChunk;
+using fbpp::schema::ChunkedDmlOptions;
+
+class ChunkedDmlTest : public TempDatabaseTest {
+protected:
+    static constexpr int32_t kRows = 3000;
+
+    void createTestSchema() override {
+        connection_->ExecuteDDL(
+            "CREATE TABLE cd (id INTEGER NOT NULL PRIMARY KEY, grp INTEGER, flag INTEGER)");
+        connection_->ExecuteDDL("CREATE TABLE cd_nokey (code VARCHAR(10), val INTEGER)");
+        auto tx = connection_->StartTransaction();
+        std::vector<std::tuple<int32_t, int32_t, int32_t>> rows;
+        for (int32_t i = 1; i <= kRows; ++i) {
+            rows.emplace_back(i * 2, i % 5, 0);
+        }
+        auto batch = connection_->prepareStatement("INSERT INTO cd VALUES (?, ?, ?)")
+                         ->createBatch(tx.get(), false);
+        batch->addMany(rows);
+        batch->execute(tx.get());
+        tx->Commit();
+    }
+
+    int64_t count(const std::string& where) {
+        auto tx = connection_->StartTransaction();
+        auto cursor = tx->openCursor(
+            connection_->prepareStatement("SELECT COUNT(*) FROM cd WHERE " + where));
+        std::tuple<int64_t> row;
+        cursor->fetch(row);
+        cursor->close();
+        tx->Commit();
+        return std::get<0>(row);
+    }
+};
+
+TEST_F(ChunkedDmlTest, DeletesByPrimaryKeyChunks) {
+    ChunkedDmlOptions options;
+    options.chunkKeys = 500;
+    options.minChunkKeys = 1;
+    ChunkedDml dml(db_params_, "cd", options);
+    const auto result = dml.deleteWhere("grp = 1");
+
+    ASSERT_TRUE(result.ok());
+    EXPECT_EQ(result.keyColumn, "ID");
+    EXPECT_EQ(result.firstKey, 2);
+    EXPECT_EQ(result.lastKey, kRows * 2);
+    EXPECT_EQ(result.chunks, 12u);   // Keys 2..6000 in ranges of 500
+    EXPECT_EQ(result.chunkLatency.count, result.chunks);
+    EXPECT_EQ(result.rows, static_cast<uint64_t>(kRows / 5));
+    EXPECT_FALSE(result.resumeFrom.has_value());
+    EXPECT_EQ(count("grp = 1"), 0);
+    EXPECT_EQ(count("1 = 1"), kRows - kRows / 5);
+}
+
+TEST_F(ChunkedDmlTest, ParallelUpdateWithCommitRetaining) {
+    ChunkedDmlOptions options;
+    options.chunkKeys = 250;
+    options.minChunkKeys = 1;
+    options.connections = 3;
+    options.commitMode = ChunkCommit::commitRetaining;
+    options.targetChunkTime = std::chrono::milliseconds(1000);
+    ChunkedDml dml(db_params_, "cd", options);
+
+    std::atomic<uint64_t> seen{0};
+    dml.onProgress([&](const ChunkedDmlChunk& chunk) {
+        EXPECT_LE(chunk.firstKey, chunk.lastKey);
+        EXPECT_LT(chunk.worker, 3u);
+        seen += chunk.rows;
+        return true;
+    });
+    const auto result = dml.update("flag = 1", "grp <> 0");
+
+    ASSERT_TRUE(result.ok());
+    EXPECT_EQ(result.rows, seen.load());
+    EXPECT_EQ(result.rows, static_cast<uint64_t>(kRows - kRows / 5));
+    EXPECT_EQ(count("flag = 1"), kRows - kRows / 5);
+    EXPECT_EQ(count("flag = 1 AND grp = 0"), 0);
+}
+
+TEST_F(ChunkedDmlTest, StopsAndResumes) {
+    ChunkedDmlOptions options;
+    options.chunkKeys = 1000;
+    options.minChunkKeys = 1;
+    options.pauseRatio = 0.5;
+    ChunkedDml first(db_params_, "cd", options);
+    first.onProgress([](const ChunkedDmlChunk&) { return false; });   // One chunk only
+    const auto stopped = first.deleteWhere();
+
+    EXPECT_TRUE(stopped.stopped);
+    EXPECT_FALSE(stopped.ok());
+    EXPECT_EQ(stopped.chunks, 1u);
+    EXPECT_EQ(stopped.rows, 500u);   // Keys 2..1001, even ones
+    ASSERT_TRUE(stopped.resumeFrom.has_value());
+    EXPECT_EQ(*stopped.resumeFrom, 1002);
+
+    options.fromKey = stopped.resumeFrom;
+    ChunkedDml rest(db_params_, "cd", options);
+    const auto resumed = rest.deleteWhere();
+    ASSERT_TRUE(resumed.ok());
+    EXPECT_EQ(resumed.rows, static_cast<uint64_t>(kRows - 500));
+    EXPECT_EQ(count("1 = 1"), 0);
+}
+
+TEST_F(ChunkedDmlTest, ChunkFailureIsReported) {
+    ChunkedDmlOptions options;
+    options.chunkKeys = 1000;
+    options.minChunkKeys = 1;
+    ChunkedDml dml(db_params_, "cd", options);
+    // Division by zero in the chunk holding id 2000 only
+    const auto result = dml.update("flag = 1 + 0 * (1 / (id - 2000))");
+
+    EXPECT_FALSE(result.ok());
+    ASSERT_EQ(result.failures.size(), 1u);
+    EXPECT_EQ(result.failures[0].firstKey, std::optional<int64_t>(1002));
+    EXPECT_EQ(result.failures[0].lastKey, std::optional<int64_t>(2001));
+    EXPECT_EQ(result.chunks, 1u);
+    EXPECT_EQ(result.resumeFrom, std::optional<int64_t>(2002));
+    EXPECT_EQ(count("id <= 1001 AND flag = 0"), 0);
+    EXPECT_EQ(count("id > 1001 AND flag <> 0"), 0);
+}
+
+TEST_F(ChunkedDmlTest, RejectsTablesWithoutIntegerKey) {
+    ChunkedDml noKey(db_params_, "cd_nokey");
+    EXPECT_THROW(noKey.deleteWhere(), FirebirdException);
+
+    ChunkedDmlOptions options;
+    options.keyColumn = "val";
+    ChunkedDml withKey(db_params_, "cd_nokey", options);
+    const auto result = withKey.deleteWhere();
+    EXPECT_TRUE(result.ok());
+    EXPECT_FALSE(result.firstKey.has_value());   // Empty table
+
+    EXPECT_THROW(ChunkedDml(db_params_, "missing_table").deleteWhere(), FirebirdException);
+    EXPECT_THROW(ChunkedDml(db_params_, "cd").update(""), FirebirdException);
+}
@@ -0,0 +1,199 @@
+#include <gtest/gtest.h>
+
+#include "fbpp/core/column_aggregate.hpp"
+#include "fbpp/core/exception.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
+// ExactAggregate over hand-built ColumnVectors: fixed point (scale
+// alignment, carries beyond INT128) and DECFLOAT, folded and merged.
+
+using namespace fbpp::core;
+
+namespace {
+
+void setPresent(ColumnVector& column, std::size_t row) {
+    column.validity[row >> 3] = static_cast<uint8_t>(column.validity[row >> 3] | (1u << (row & 7)));
+}
+
+template<typename T>
+ColumnVector fixedColumn(ColumnType type, int scale, const std::vector<std::optional<T>>& rows) {
+    ColumnVector column;
+    column.name = "V";
+    column.type = type;
+    column.scale = scale;
+    column.length = rows.size();
+    column.values.assign(rows.size() * sizeof(T), 0);
+    column.validity.assign((rows.size() + 7) / 8, 0);
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        if (!rows[i]) {
+            ++column.nullCount;
+            continue;
+        }
+        std::memcpy(column.values.data() + i * sizeof(T), &*rows[i], sizeof(T));
+        setPresent(column, i);
+    }
+    return column;
+}
+
+ColumnVector int128Column(int scale, const std::vector<std::optional<Int128>>& rows) {
+    ColumnVector column;
+    column.name = "V";
+    column.type = ColumnType::Int128;
+    column.scale = scale;
+    column.length = rows.size();
+    column.values.assign(rows.size() * 16, 0);
+    column.validity.assign((rows.size() + 7) / 8, 0);
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        if (!rows[i]) {
+            ++column.nullCount;
+            continue;
+        }
+        std::memcpy(column.values.data() + i * 16, rows[i]->data(), 16);
+        setPresent(column, i);
+    }
+    return column;
+}
+
+ColumnVector decFloatColumn(const std::vector<std::optional<std::string>>& rows) {
+    ColumnVector column;
+    column.name = "D";
+    column.type = ColumnType::String;
+    column.sqlType = SQL_DEC34;
+    column.length = rows.size();
+    column.validity.assign((rows.size() + 7) / 8, 0);
+    column.offsets.push_back(0);
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        if (!rows[i]) {
+            ++column.nullCount;
+        } else {
+            column.values.insert(column.values.end(), rows[i]->begin(), rows[i]->end());
+            setPresent(column, i);
+        }
+        column.offsets.push_back(static_cast<int32_t>(column.values.size()));
+    }
+    return column;
+}
+
+const Int128 kMax = Int128::fromParts(std::numeric_limits<int64_t>::max(),
+                                      std::numeric_limits<uint64_t>::max());
+
+} // namespace
+
+TEST(ExactAggregateTest, Int64SumsAreNotBoundByInt64) {
+    constexpr int64_t big = std::numeric_limits<int64_t>::max();
+    ExactAggregate total;
+    total.add(fixedColumn<int64_t>(ColumnType::Int64, 0, {big, big, std::nullopt, -1}));
+
+    EXPECT_EQ(total.domain(), ExactAggregate::Domain::FixedPoint);
+    EXPECT_EQ(total.count(), 3u);
+    EXPECT_EQ(total.sumText(), "18446744073709551613");
+    EXPECT_EQ(total.minText(), "-1");
+    EXPECT_EQ(total.maxText(), std::to_string(big));
+}
+
+TEST(ExactAggregateTest, AlignsToTheFinestScale) {
+    ExactAggregate total;
+    total.add(fixedColumn<int32_t>(ColumnType::Int32, -2, {1234, 5}));        // 12.34, 0.05
+    total.add(fixedColumn<int64_t>(ColumnType::Int64, -4, {1, std::nullopt})); // 0.0001
+    total.add(fixedColumn<int16_t>(ColumnType::Int16, -1, {15}));              // 1.5
+
+    EXPECT_EQ(total.scale(), -4);
+    EXPECT_EQ(total.count(), 4u);
+    EXPECT_EQ(total.sumText(), "13.8901");
+    EXPECT_EQ(total.minText(), "0.0001");
+    EXPECT_EQ(total.maxText(), "12.3400");
+}
+
+TEST(ExactAggregateTest, Int128CarriesAreDetected) {
+    ExactAggregate total;
+    total.add(int128Column(-2, {kMax, Int128(int64_t{1})}));
+    EXPECT_THROW((void)total.sum(), FirebirdException);
+    EXPECT_EQ(total.max(), kMax);
+
+    // Back in range: the carry was kept, not lost
+    total.add(int128Column(-2, {Int128(int64_t{-1}), std::nullopt}));
+    EXPECT_EQ(total.sum(), kMax);
+
+    // Aligning a sum beyond INT128 to a finer scale cannot be exact
+    total.add(int128Column(-2, {kMax}));
+    EXPECT_THROW(total.add(fixedColumn<int32_t>(ColumnType::Int32, -3, {1})), FirebirdException);
+}
+
+TEST(ExactAggregateTest, MergedPartialsMatchOnePass) {
+    const auto a = fixedColumn<int64_t>(ColumnType::Int64, -2, {100, -250, std::nullopt, 7});
+    const auto b = int128Column(-3, {Int128(int64_t{1}), std::nullopt});
+    const auto c = fixedColumn<int32_t>(ColumnType::Int32, 0, {std::nullopt, -9});
+
+    ExactAggregate onePass;
+    onePass.add(a);
+    onePass.add(b);
+    onePass.add(c);
+
+    ExactAggregate left;
+    left.add(a);
+    ExactAggregate right;
+    right.add(c);
+    right.add(b);
+    ExactAggregate empty;
+    left.merge(empty);
+    left.merge(right);
+
+    EXPECT_EQ(left.count(), onePass.count());
+    EXPECT_EQ(left.scale(), -3);
+    EXPECT_EQ(left.sumText(), onePass.sumText());
+    EXPECT_EQ(left.sumText(), "-10.429");
+    EXPECT_EQ(left.minText(), "-9.000");
+    EXPECT_EQ(left.maxText(), onePass.maxText());
+}
+
+TEST(ExactAggregateTest, DecFloatStaysDecimal) {
+    ExactAggregate total;
+    total.add(decFloatColumn({"1.10", "2.205", std::nullopt, "-0.3"}));
+    EXPECT_EQ(total.domain(), ExactAggregate::Domain::DecFloat);
+    EXPECT_EQ(total.count(), 3u);
+    EXPECT_EQ(total.sumText(), "3.005");
+    EXPECT_EQ(total.minText(), "-0.3");
+    EXPECT_EQ(total.maxText(), "2.205");
+
+    // Ten times 0.1 is exactly 1.0 in decimal
+    ExactAggregate tenths;
+    ExactAggregate partial;
+    partial.add(decFloatColumn(std::vector<std::optional<std::string>>(5, std::string("0.1"))));
+    tenths.merge(partial);
+    tenths.merge(partial);
+    EXPECT_EQ(tenths.sumText(), "1.0");
+    EXPECT_EQ(tenths.count(), 10u);
+
+    EXPECT_THROW(total.add(decFloatColumn({"abc"})), FirebirdException);
+}
+
+TEST(ExactAggregateTest, RejectsOtherColumnsAndMixedDomains) {
+    ExactAggregate total;
+    EXPECT_THROW(total.add(fixedColumn<double>(ColumnType::Double, 0, {1.5})), FirebirdException);
+    EXPECT_EQ(total.domain(), ExactAggregate::Domain::None);
+
+    total.add(fixedColumn<int32_t>(ColumnType::Int32, 0, {1}));
+    EXPECT_THROW(total.add(decFloatColumn({"1"})), FirebirdException);
+    EXPECT_THROW((void)total.decSum(), FirebirdException);
+
+    ExactAggregate dec;
+    dec.add(decFloatColumn({"1"}));
+    EXPECT_THROW(total.merge(dec), FirebirdException);
+}
+
+TEST(ExactAggregateTest, NoValuesGiveNull) {
+    ExactAggregate total;
+    EXPECT_FALSE(total.sumText().has_value());
+
+    total.add(fixedColumn<int64_t>(ColumnType::Int64, -2, {std::nullopt, std::nullopt}));
+    EXPECT_EQ(total.count(), 0u);
+    EXPECT_FALSE(total.sum().has_value());
+    EXPECT_FALSE(total.min().has_value());
+    EXPECT_FALSE(total.maxText().has_value());
+}
@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/statement_cache.hpp"
+#include "fbpp/pool/connection_pool.hpp"
+#include <fbpp_util/config_watcher.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+// ConfigWatcher: cache and pool sections applied to running targets,
+// rejected files, unchanged rewrites and the polling thread.
+
+using namespace fbpp::core;
+using namespace fbpp::pool;
+using namespace fbpp::test;
+using namespace fbpp::util;
+using namespace std::chrono_literals;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+class WatchedFile {
+public:
+    explicit WatchedFile(std::string name) : path_(std::move(name)) {}
+    ~WatchedFile() {
+        std::error_code ec;
+        fs::remove(path_, ec);
+    }
+
+    // Each write gets a later modification time, whatever the clock's resolution
+    void write(const std::string& json) {
+        {
+            std::ofstream file(path_, std::ios::trunc);
+            file << json;
+        }
+        fs::last_write_time(path_, base_ + std::chrono::seconds(++writes_));
+    }
+
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+    fs::file_time_type base_ = fs::file_time_type::clock::now();
+    int writes_ = 0;
+};
+
+std::string tunables(size_t maxStatements, size_t ttl, size_t minSize, size_t maxSize,
+                     unsigned prefetch = 0) {
+    return R"({"cache": {"enabled": true, "max_statements": )" + std::to_string(maxStatements) +
+           R"(, "ttl_minutes": )" + std::to_string(ttl) +
+           R"(}, "pool": {"min_size": )" + std::to_string(minSize) +
+           R"(, "max_size": )" + std::to_string(maxSize) +
+           R"(, "prefetch_rows": )" + std::to_string(prefetch) + "}}";
+}
+
+ConnectionPoolOptions manualOptions() {
+    ConnectionPoolOptions options;
+    options.reapInterval = 0ms;
+    options.acquireTimeout = 200ms;
+    return options;
+}
+
+} // namespace
+
+TEST(ConfigWatcherTest, AppliesCacheSectionOnWatchAndReload) {
+    WatchedFile file("watch_cache.json");
+    file.write(tunables(50, 30, 1, 4));
+
+    StatementCache cache;
+    ConfigWatcher watcher(file.path());
+    watcher.watch(cache);
+    EXPECT_EQ(cache.getMaxSize(), 50u);
+    EXPECT_EQ(cache.getTtlMinutes(), 30u);
+
+    EXPECT_FALSE(watcher.checkNow());   // File not touched
+
+    file.write(tunables(20, 5, 1, 4));
+    EXPECT_TRUE(watcher.checkNow());
+    EXPECT_EQ(cache.getMaxSize(), 20u);
+    EXPECT_EQ(cache.getTtlMinutes(), 5u);
+
+    const auto stats = watcher.stats();
+    EXPECT_EQ(stats.checks, 2u);
+    EXPECT_EQ(stats.reloads, 1u);
+    EXPECT_EQ(stats.failures, 0u);
+    EXPECT_EQ(stats.caches, 1u);
+    EXPECT_EQ(stats.applied.cache.maxStatements, 20u);
+    EXPECT_TRUE(stats.lastError.empty());
+
+    // Unregistered caches keep their values
+    watcher.unwatch(cache);
+    file.write(tunables(10, 5, 1, 4));
+    EXPECT_TRUE(watcher.checkNow());
+    EXPECT_EQ(cache.getMaxSize(), 20u);
+    EXPECT_EQ(watcher.stats().caches, 0u);
+}
+
+TEST(ConfigWatcherTest, RejectedFileChangesNothing) {
+    WatchedFile file("watch_rejected.json");
+    file.write(tunables(50, 30, 1, 4));
+
+    StatementCache cache;
+    ConfigWatcher watcher(file.path());
+    watcher.watch(cache);
+
+    file.write(R"({"cache": {"max_statements": 5)");            // Half written
+    EXPECT_FALSE(watcher.checkNow());
+    file.write(tunables(5, 30, 3, 2));                          // min above max
+    EXPECT_FALSE(watcher.checkNow());
+    file.write(R"({"cache": {"max_statements": "many"}})");     // Wrong type
+    EXPECT_FALSE(watcher.checkNow());
+    EXPECT_EQ(cache.getMaxSize(), 50u);
+
+    auto stats = watcher.stats();
+    EXPECT_EQ(stats.failures, 3u);
+    EXPECT_EQ(stats.reloads, 0u);
+    EXPECT_FALSE(stats.lastError.empty());
+    EXPECT_EQ(stats.applied.cache.maxStatements, 50u);
+
+    file.write(tunables(5, 30, 1, 2));
+    EXPECT_TRUE(watcher.checkNow());
+    EXPECT_EQ(cache.getMaxSize(), 5u);
+    stats = watcher.stats();
+    EXPECT_EQ(stats.reloads, 1u);
+    EXPECT_TRUE(stats.lastError.empty());
+}
+
+TEST(ConfigWatcherTest, RewriteWithSameSettingsIsNotApplied) {
+    WatchedFile file("watch_same.json");
+    file.write(tunables(50, 30, 1, 4));
+
+    ConfigWatcher watcher(file.path());
+    file.write(" " + tunables(50, 30, 1, 4) + "\n");
+    EXPECT_FALSE(watcher.checkNow());
+
+    const auto stats = watcher.stats();
+    EXPECT_EQ(stats.unchanged, 1u);
+    EXPECT_EQ(stats.reloads, 0u);
+    EXPECT_EQ(stats.failures, 0u);
+}
+
+TEST(ConfigWatcherTest, ConstructionNeedsAValidFile) {
+    EXPECT_THROW(ConfigWatcher("watch_missing.json"), std::runtime_error);
+
+    WatchedFile file("watch_invalid.json");
+    file.write(tunables(50, 30, 0, 0));
+    EXPECT_THROW(ConfigWatcher(file.path()), std::runtime_error);
+}
+
+TEST(ConfigWatcherTest, PollingThreadPicksUpEdits) {
+    WatchedFile file("watch_thread.json");
+    file.write(tunables(50, 30, 1, 4));
+
+    StatementCache cache;
+    ConfigWatcher watcher(file.path());
+    watcher.watch(cache);
+    watcher.start(10ms);
+
+    file.write(tunables(8, 30, 1, 4));
+    const auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (watcher.stats().reloads == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(5ms);
+    }
+    watcher.stop();
+    EXPECT_EQ(watcher.stats().reloads, 1u);
+    EXPECT_EQ(cache.getMaxSize(), 8u);
+}
+
+class ConfigWatcherPoolTest : public TempDatabaseTest {};
+
+TEST_F(ConfigWatcherPoolTest, ResizesPoolAndRetunesItsConnections) {
+    WatchedFile file("watch_pool.json");
+    file.write(tunables(40, 30, 2, 3, 16));
+
+    ConnectionPool pool(db_params_, 1, 2, manualOptions());
+    ConfigWatcher watcher(file.path());
+    watcher.watch(pool);
+    EXPECT_EQ(pool.minSize(), 2u);
+    EXPECT_EQ(pool.maxSize(), 3u);
+    EXPECT_EQ(pool.stats().total, 2u);
+    {
+        auto lease = pool.acquire();
+        EXPECT_EQ(lease->getStatementCacheConfig().maxSize, 40u);
+        EXPECT_EQ(lease->getOptions().transfer.prefetchRows, 16u);
+    }
+
+    file.write(tunables(10, 30, 0, 1, 16));
+    EXPECT_TRUE(watcher.checkNow());
+    EXPECT_EQ(pool.maxSize(), 1u);
+    auto lease = pool.acquire();
+    EXPECT_EQ(lease->getStatementCacheConfig().maxSize, 10u);
+
+    const auto stats = watcher.stats();
+    EXPECT_EQ(stats.pools, 1u);
+    EXPECT_EQ(stats.connectionsClosed, 1u);
+    EXPECT_EQ(pool.stats().resizes, 2u);
+}
+
+TEST_F(ConfigWatcherPoolTest, MaximumWithinReservedCapacityIsRejected) {
+    WatchedFile file("watch_reserved.json");
+    file.write(tunables(40, 30, 0, 4));
+
+    auto options = manualOptions();
+    options.reservedInteractive = 2;
+    ConnectionPool pool(db_params_, 0, 4, options);
+    ConfigWatcher watcher(file.path());
+    watcher.watch(pool);
+
+    file.write(tunables(40, 30, 0, 2));
+    EXPECT_FALSE(watcher.checkNow());
+    EXPECT_EQ(pool.maxSize(), 4u);
+    EXPECT_EQ(watcher.stats().failures, 1u);
+}
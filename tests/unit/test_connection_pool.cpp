@@ -0,0 +1,400 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/pool/connection_pool.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/exception.hpp"
+
+#include <chrono>
+#include <future>
+#include <thread>
+#include <tuple>
+
+// ConnectionPool: reuse and stats, exhaustion (tryAcquire / timeout),
+// per-thread affinity, discard() and idle reaping.
+// Priority lanes, reserved capacity and the adaptive limit.
+// Connection::connectAsync() / connectMany(): concurrent attach.
+// resize() / setConnectionOptions() on a pool in use.
+// Checkout wait, lease duration, utilization and statement cache metrics.
+
+using namespace fbpp::core;
+using namespace fbpp::pool;
+using namespace fbpp::test;
+using namespace std::chrono_literals;
+
+namespace {
+
+ConnectionPoolOptions manualOptions() {
+    ConnectionPoolOptions options;
+    options.reapInterval = 0ms;       // No reaper thread: tests call reapIdle()
+    options.acquireTimeout = 200ms;
+    return options;
+}
+
+} // namespace
+
+class ConnectionPoolTest : public TempDatabaseTest {};
+
+TEST_F(ConnectionPoolTest, ReusesReturnedConnection) {
+    ConnectionPool pool(db_params_, 1, 2, manualOptions());
+    EXPECT_EQ(pool.stats().total, 1u);
+    EXPECT_EQ(pool.stats().idle, 1u);
+
+    Connection* first = nullptr;
+    {
+        auto lease = pool.acquire();
+        ASSERT_TRUE(lease);
+        first = lease.get();
+        EXPECT_EQ(pool.stats().leased, 1u);
+
+        auto tx = lease->StartTransaction();
+        auto cursor = tx->openCursor(lease->prepareStatement("SELECT 1 FROM RDB$DATABASE"));
+        std::tuple<int32_t> row;
+        EXPECT_TRUE(cursor->fetch(row));
+        cursor->close();
+        tx->Commit();
+    }
+
+    auto again = pool.acquire();
+    EXPECT_EQ(again.get(), first);
+
+    const auto stats = pool.stats();
+    EXPECT_EQ(stats.created, 1u);
+    EXPECT_EQ(stats.reused, 2u);
+    EXPECT_EQ(stats.affinityHits, 2u);
+    EXPECT_EQ(stats.total, 1u);
+}
+
+TEST_F(ConnectionPoolTest, ExhaustedPoolTimesOut) {
+    ConnectionPool pool(db_params_, 0, 1, manualOptions());
+
+    auto held = pool.acquire();
+    ASSERT_TRUE(held);
+    EXPECT_FALSE(pool.tryAcquire());
+    EXPECT_THROW(pool.acquire(50ms), FirebirdException);
+    EXPECT_EQ(pool.stats().timeouts, 1u);
+
+    // A waiter is woken by the release.
+    std::thread releaser([&] {
+        std::this_thread::sleep_for(50ms);
+        held.release();
+    });
+    auto next = pool.acquire(2s);
+    releaser.join();
+    EXPECT_TRUE(next);
+    EXPECT_EQ(pool.stats().created, 1u);
+}
+
+TEST_F(ConnectionPoolTest, PrefersCallingThreadsConnection) {
+    ConnectionPool pool(db_params_, 0, 2, manualOptions());
+
+    auto mine = pool.acquire();
+    Connection* own = mine.get();
+
+    std::promise<void> returned;
+    std::promise<void> resume;
+    Connection* theirs = nullptr;
+    Connection* served = nullptr;
+    std::thread other([&] {
+        {
+            auto lease = pool.acquire();
+            theirs = lease.get();
+        }
+        returned.set_value();
+        resume.get_future().wait();
+        auto lease = pool.acquire();
+        served = lease.get();
+    });
+
+    returned.get_future().wait();
+    mine.release();
+    // Ours was returned last, yet the other thread gets its own back.
+    resume.set_value();
+    other.join();
+    EXPECT_EQ(served, theirs);
+    EXPECT_NE(served, own);
+
+    auto again = pool.acquire();
+    EXPECT_EQ(again.get(), own);
+    EXPECT_EQ(pool.stats().affinityHits, 2u);
+    EXPECT_EQ(pool.stats().created, 2u);
+}
+
+TEST_F(ConnectionPoolTest, DiscardClosesConnection) {
+    ConnectionPool pool(db_params_, 0, 1, manualOptions());
+    {
+        auto lease = pool.acquire();
+        lease.discard();
+        EXPECT_FALSE(lease);
+    }
+    auto stats = pool.stats();
+    EXPECT_EQ(stats.total, 0u);
+    EXPECT_EQ(stats.idle, 0u);
+
+    auto fresh = pool.acquire();
+    EXPECT_TRUE(fresh);
+    EXPECT_EQ(pool.stats().created, 2u);
+}
+
+TEST_F(ConnectionPoolTest, ReapsIdleConnectionsAboveMinimum) {
+    auto options = manualOptions();
+    options.idleTimeout = 20ms;
+    ConnectionPool pool(db_params_, 1, 3, options);
+    {
+        auto a = pool.acquire();
+        auto b = pool.acquire();
+        auto c = pool.acquire();
+    }
+    EXPECT_EQ(pool.stats().idle, 3u);
+
+    std::this_thread::sleep_for(50ms);
+    EXPECT_EQ(pool.reapIdle(), 2u);
+
+    const auto stats = pool.stats();
+    EXPECT_EQ(stats.total, 1u);
+    EXPECT_EQ(stats.reaped, 2u);
+}
+
+TEST_F(ConnectionPoolTest, LeaseOutlivesPool) {
+    ConnectionLease lease;
+    {
+        ConnectionPool pool(db_params_, 0, 1, manualOptions());
+        lease = pool.acquire();
+        EXPECT_THROW(ConnectionPool(db_params_, 2, 1), FirebirdException);
+    }
+    ASSERT_TRUE(lease);
+    EXPECT_TRUE(lease->isConnected());
+    lease.release();
+    EXPECT_FALSE(lease);
+}
+
+TEST_F(ConnectionPoolTest, ConnectAsyncAndConnectMany) {
+    auto pending = Connection::connectAsync(db_params_);
+    auto many = Connection::connectMany(db_params_, 4, 2);
+    auto single = pending.get();
+
+    ASSERT_TRUE(single);
+    EXPECT_TRUE(single->isConnected());
+    ASSERT_EQ(many.size(), 4u);
+    for (const auto& connection : many) {
+        ASSERT_TRUE(connection);
+        EXPECT_TRUE(connection->isConnected());
+    }
+
+    auto bad = db_params_;
+    bad.database += ".missing";
+    EXPECT_THROW(Connection::connectAsync(bad).get(), FirebirdException);
+    EXPECT_THROW(Connection::connectMany(bad, 3), FirebirdException);
+}
+
+TEST_F(ConnectionPoolTest, MinimumIsOpenedUpFront) {
+    ConnectionPool pool(db_params_, 4, 4, manualOptions());
+    const auto stats = pool.stats();
+    EXPECT_EQ(stats.total, 4u);
+    EXPECT_EQ(stats.idle, 4u);
+    EXPECT_EQ(stats.created, 4u);
+}
+
+TEST_F(ConnectionPoolTest, BatchLeavesReservedCapacityToInteractive) {
+    auto options = manualOptions();
+    options.reservedInteractive = 1;
+    options.reservedNormal = 1;
+    ConnectionPool pool(db_params_, 0, 4, options);
+
+    auto batch1 = pool.acquire(PoolPriority::Batch);
+    auto batch2 = pool.acquire(PoolPriority::Batch);
+    EXPECT_FALSE(pool.tryAcquire(PoolPriority::Batch));
+    EXPECT_THROW(pool.acquire(PoolPriority::Batch, 30ms), FirebirdException);
+    auto normal = pool.acquire();
+    EXPECT_FALSE(pool.tryAcquire());
+    auto interactive = pool.tryAcquire(PoolPriority::Interactive);
+    ASSERT_TRUE(interactive);
+    EXPECT_EQ(interactive.priority(), PoolPriority::Interactive);
+
+    const auto stats = pool.stats();
+    const auto& batch = stats.lanes[static_cast<size_t>(PoolPriority::Batch)];
+    EXPECT_EQ(batch.leased, 2u);
+    EXPECT_EQ(batch.timeouts, 1u);
+    EXPECT_EQ(batch.queueWait.count, 2u);
+    EXPECT_EQ(stats.lanes[static_cast<size_t>(PoolPriority::Interactive)].leased, 1u);
+    EXPECT_EQ(stats.limit, 4u);
+
+    options.reservedNormal = 3;
+    EXPECT_THROW(ConnectionPool(db_params_, 0, 4, options), FirebirdException);
+}
+
+TEST_F(ConnectionPoolTest, WaitingInteractiveIsServedBeforeBatch) {
+    ConnectionPool pool(db_params_, 0, 1, manualOptions());
+    auto held = pool.acquire();
+
+    auto waitingIn = [&](PoolPriority priority) {
+        return pool.stats().lanes[static_cast<size_t>(priority)].waiting;
+    };
+    auto batch = std::async(std::launch::async, [&] {
+        auto lease = pool.acquire(PoolPriority::Batch, 5s);
+        return lease.priority();
+    });
+    while (waitingIn(PoolPriority::Batch) == 0) {
+        std::this_thread::sleep_for(1ms);
+    }
+    std::promise<void> done;
+    auto interactive = std::async(std::launch::async, [&] {
+        auto lease = pool.acquire(PoolPriority::Interactive, 5s);
+        done.get_future().wait();
+        return lease.priority();
+    });
+    while (waitingIn(PoolPriority::Interactive) == 0) {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    held.release();
+    while (pool.stats().lanes[static_cast<size_t>(PoolPriority::Interactive)].leased == 0) {
+        std::this_thread::sleep_for(1ms);
+    }
+    EXPECT_EQ(waitingIn(PoolPriority::Batch), 1u);   // Still queued behind it
+    done.set_value();
+    EXPECT_EQ(interactive.get(), PoolPriority::Interactive);
+    EXPECT_EQ(batch.get(), PoolPriority::Batch);
+}
+
+TEST_F(ConnectionPoolTest, AdaptiveLimitBacksOffAndRecovers) {
+    auto options = manualOptions();
+    options.adaptiveLimit.enabled = true;
+    options.adaptiveLimit.latencyTarget = 50ms;
+    ConnectionPool pool(db_params_, 0, 4, options);
+
+    // Slow samples: at most one backoff per limit-many of them
+    for (int i = 0; i < 20; ++i) {
+        auto lease = pool.acquire();
+        lease.reportLatency(1s);
+    }
+    auto stats = pool.stats();
+    EXPECT_EQ(stats.limit, 1u);
+    EXPECT_GE(stats.limitDecreases, 3u);
+    {
+        auto only = pool.acquire();
+        EXPECT_FALSE(pool.tryAcquire(PoolPriority::Interactive));   // Over the limit
+        only.reportLatency(1ms);
+    }
+
+    for (int i = 0; i < 10; ++i) {
+        auto lease = pool.acquire();
+        lease.reportLatency(1ms);
+    }
+    EXPECT_GE(pool.stats().limit, 2u);
+    EXPECT_EQ(pool.stats().total, 1u);   // Idle connections are not the limit
+}
+
+TEST_F(ConnectionPoolTest, ResizeWhileInUse) {
+    ConnectionPool pool(db_params_, 1, 3, manualOptions());
+    {
+        auto a = pool.acquire();
+        auto b = pool.acquire();
+        auto c = pool.acquire();
+    }
+    EXPECT_EQ(pool.stats().idle, 3u);
+
+    // Shrink: the idle surplus closes at once
+    EXPECT_EQ(pool.resize(0, 1), 2u);
+    EXPECT_EQ(pool.maxSize(), 1u);
+    auto held = pool.acquire();
+    EXPECT_FALSE(pool.tryAcquire());
+
+    // Grow: the new minimum is opened before resize() returns
+    EXPECT_EQ(pool.resize(2, 4), 0u);
+    auto stats = pool.stats();
+    EXPECT_EQ(stats.total, 2u);
+    EXPECT_EQ(stats.limit, 4u);
+    EXPECT_EQ(stats.resizes, 2u);
+    EXPECT_TRUE(pool.tryAcquire());
+
+    // Leases above a lowered maximum close when they come back
+    auto second = pool.acquire();
+    EXPECT_EQ(pool.resize(0, 1), 0u);
+    held.release();
+    second.release();
+    stats = pool.stats();
+    EXPECT_EQ(stats.total, 1u);
+    EXPECT_EQ(stats.idle, 1u);
+
+    EXPECT_THROW(pool.resize(2, 1), FirebirdException);
+    EXPECT_THROW(pool.resize(0, 0), FirebirdException);
+    EXPECT_EQ(pool.minSize(), 0u);
+    EXPECT_EQ(pool.maxSize(), 1u);
+}
+
+TEST_F(ConnectionPoolTest, ConnectionOptionsReachPooledConnectionsAtCheckout) {
+    ConnectionPool pool(db_params_, 1, 2, manualOptions());
+    auto held = pool.acquire();
+    Connection* leased = held.get();
+
+    auto options = pool.connectionOptions();
+    options.statementCache.maxSize = 7;
+    options.transfer.prefetchRows = 5;
+    pool.setConnectionOptions(options);
+
+    // Not changed under its holder
+    EXPECT_NE(leased->getStatementCacheConfig().maxSize, 7u);
+
+    // A new attachment opens with them
+    auto fresh = pool.acquire();
+    EXPECT_EQ(fresh->getStatementCacheConfig().maxSize, 7u);
+    EXPECT_EQ(fresh->getOptions().transfer.prefetchRows, 5u);
+
+    // The older one gets them on its next checkout, once
+    held.release();
+    fresh.release();
+    for (int i = 0; i < 2; ++i) {
+        auto a = pool.acquire();
+        auto b = pool.acquire();
+        EXPECT_EQ(a->getStatementCacheConfig().maxSize, 7u);
+        EXPECT_EQ(b->getStatementCacheConfig().maxSize, 7u);
+    }
+    const auto stats = pool.stats();
+    EXPECT_EQ(stats.optionsUpdates, 1u);
+    EXPECT_EQ(stats.optionsApplied, 1u);
+}
+
+TEST_F(ConnectionPoolTest, MetricsCoverWaitLeaseUtilizationAndCache) {
+    ConnectionPool pool(db_params_, 1, 2, manualOptions());
+    {
+        auto lease = pool.acquire();
+        auto tx = lease->StartTransaction();
+        for (int i = 0; i < 3; ++i) {   // One miss, then hits
+            auto cursor = tx->openCursor(lease->prepareStatement("SELECT 1 FROM RDB$DATABASE"));
+            std::tuple<int32_t> row;
+            EXPECT_TRUE(cursor->fetch(row));
+            cursor->close();
+        }
+        tx->Commit();
+        std::this_thread::sleep_for(20ms);
+    }
+
+    auto stats = pool.stats();
+    EXPECT_EQ(stats.checkoutWait.count, 1u);
+    EXPECT_EQ(stats.leaseDuration.count, 1u);
+    EXPECT_GE(stats.leaseDuration.maxMicros, 20000u);
+    EXPECT_GE(stats.statementCacheMisses, 1u);
+    EXPECT_GE(stats.statementCacheHits, 2u);
+    EXPECT_GT(stats.statementCacheHitRate(), 0.0);
+    EXPECT_LT(stats.statementCacheHitRate(), 1.0);
+    const uint64_t hits = stats.statementCacheHits;
+
+    {
+        auto a = pool.acquire();
+        auto b = pool.acquire();   // Opens the second attachment
+        stats = pool.stats();
+        EXPECT_EQ(stats.leased, 2u);
+        EXPECT_EQ(stats.creating, 0u);
+        EXPECT_DOUBLE_EQ(stats.utilizationNow(), 1.0);
+    }
+    stats = pool.stats();
+    EXPECT_EQ(stats.peakLeased, 2u);
+    EXPECT_EQ(stats.checkoutWait.count, 3u);
+    EXPECT_EQ(stats.leaseDuration.count, 3u);
+    EXPECT_EQ(stats.utilization.count, 3u);
+    EXPECT_EQ(stats.utilization.maxMicros, 100u);   // Percent: both of 2 leased
+    EXPECT_EQ(stats.statementCacheHits, hits);       // Nothing prepared meanwhile
+    EXPECT_DOUBLE_EQ(stats.utilizationNow(), 0.0);
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+
+// ReconnectPolicy: a connection whose attachment is killed from another
+// attachment (DELETE FROM MON$ATTACHMENTS) attaches again on its next
+// request, re-prepares its hot statements and revalidates handles out.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr const char* kWhoAmI = "SELECT CURRENT_CONNECTION FROM RDB$DATABASE";
+
+} // namespace
+
+class ConnectionReconnectTest : public TempDatabaseTest {
+protected:
+    ConnectionParams reconnectingParams(bool enabled) const {
+        ConnectionParams params = db_params_;
+        params.options.reconnect.enabled = enabled;
+        params.options.reconnect.initialBackoff = 10ms;
+        params.options.reconnect.reprepareInBackground = false;
+        return params;
+    }
+
+    static int64_t attachmentId(Connection& conn, const std::shared_ptr<Statement>& stmt) {
+        auto tx = conn.StartTransaction();
+        auto cursor = tx->openCursor(stmt);
+        std::tuple<int64_t> row{0};
+        EXPECT_TRUE(cursor->fetch(row));
+        cursor->close();
+        tx->Commit();
+        return std::get<0>(row);
+    }
+
+    // Shut the attachment down from the fixture's connection
+    void kill(int64_t id) {
+        auto tx = connection_->StartTransaction();
+        tx->execute(connection_->prepareStatement(
+                        "DELETE FROM MON$ATTACHMENTS WHERE MON$ATTACHMENT_ID = ?"),
+                    std::make_tuple(id));
+        tx->Commit();
+    }
+};
+
+TEST_F(ConnectionReconnectTest, ReattachesOnNextRequest) {
+    Connection conn(reconnectingParams(true));
+    auto stmt = conn.prepareStatement(kWhoAmI);
+    const int64_t before = attachmentId(conn, stmt);
+    EXPECT_EQ(conn.generation(), 0u);
+
+    kill(before);
+
+    // Held across the loss: prepared again on first use
+    const int64_t after = attachmentId(conn, stmt);
+    EXPECT_NE(after, before);
+    EXPECT_EQ(conn.generation(), 1u);
+    EXPECT_TRUE(conn.isConnected());
+}
+
+TEST_F(ConnectionReconnectTest, PreparesHotStatementsAgain) {
+    Connection conn(reconnectingParams(true));
+    const int64_t before = attachmentId(conn, conn.prepareStatement(kWhoAmI));
+    for (int i = 0; i < 3; ++i) {
+        attachmentId(conn, conn.prepareStatement(kWhoAmI));
+    }
+    kill(before);
+
+    auto tx = conn.StartTransaction();   // Reconnects
+    tx->Commit();
+    EXPECT_EQ(conn.generation(), 1u);
+    const auto stats = conn.getCacheStatistics();
+    EXPECT_EQ(stats.warmupCount, 1u);
+    EXPECT_EQ(stats.cacheSize, 1u);
+
+    const size_t hits = stats.hitCount;
+    EXPECT_NE(attachmentId(conn, conn.prepareStatement(kWhoAmI)), before);
+    EXPECT_EQ(conn.getCacheStatistics().hitCount, hits + 1);
+}
+
+TEST_F(ConnectionReconnectTest, DisabledPolicyReportsTheLoss) {
+    Connection conn(reconnectingParams(false));
+    auto stmt = conn.prepareStatement(kWhoAmI);
+    const int64_t before = attachmentId(conn, stmt);
+    kill(before);
+
+    try {
+        attachmentId(conn, stmt);
+        FAIL() << "request on a killed attachment succeeded";
+    } catch (const FirebirdException& e) {
+        EXPECT_TRUE(Connection::isConnectionLost(e)) << e.what();
+    }
+
+    conn.reconnect();
+    EXPECT_NE(attachmentId(conn, stmt), before);
+}
+
+TEST_F(ConnectionReconnectTest, OrdinaryErrorsAreNotLosses) {
+    Connection conn(reconnectingParams(true));
+    try {
+        conn.prepareStatement("SELECT * FROM NO_SUCH_TABLE");
+        FAIL() << "prepare of a missing table succeeded";
+    } catch (const FirebirdException& e) {
+        EXPECT_FALSE(Connection::isConnectionLost(e)) << e.what();
+    }
+    EXPECT_EQ(conn.generation(), 0u);
+}
@@ -26,6 +26,25 @@ TEST_F(CoreWrapperTest, EnvironmentInterfaces) {
     ASSERT_NE(env.getUtil(), nullptr);
 }
 
+TEST_F(CoreWrapperTest, StatusPoolReusesStatuses) {
+    Environment& env = Environment::getInstance();
+
+    Firebird::IStatus* first = env.acquireStatus();
+    ASSERT_NE(first, nullptr);
+    const intptr_t error[] = {isc_arg_gds, isc_random, isc_arg_string,
+                              reinterpret_cast<intptr_t>("pooled"), isc_arg_end};
+    first->setErrors(error);
+    ASSERT_NE(first->getState() & Firebird::IStatus::STATE_ERRORS, 0u);
+    env.releaseStatus(first);
+
+    // Same thread: the pooled status comes back, cleared
+    Firebird::IStatus* again = env.acquireStatus();
+    EXPECT_EQ(again, first);
+    EXPECT_EQ(again->getState() & Firebird::IStatus::STATE_ERRORS, 0u);
+    env.releaseStatus(again);
+    env.releaseStatus(nullptr);
+}
+
 TEST_F(CoreWrapperTest, ConnectionCreate) {
     // connection_ is already created by base class
     ASSERT_NE(connection_, nullptr);
@@ -139,3 +158,27 @@ TEST_F(CoreWrapperTest, IsConnectedCheck) {
         ASSERT_TRUE(connection_->isConnected());
     }
 }
+
+TEST_F(CoreWrapperTest, WireOptionsAttach) {
+    // Compression is negotiated: a server that disallows it still attaches.
+    ConnectionParams params = db_params_;
+    params.wire.compression = true;
+    params.wire.connectTimeoutSeconds = 15;
+    params.wire.keepAliveSeconds = 60;
+    params.pageBuffers = 512;
+    params.parallelWorkers = 2;
+
+    Connection conn(params);
+    ASSERT_TRUE(conn.isConnected());
+    auto tra = conn.Execute("DELETE FROM test_table WHERE id = 9999");
+    tra->Commit();
+}
+
+TEST_F(CoreWrapperTest, EmbeddedParamsAndLateRootDirectory) {
+    auto params = ConnectionParams::embedded("/var/db/local.fdb");
+    EXPECT_EQ(params.database, "/var/db/local.fdb");
+    EXPECT_EQ(params.providers, "Engine13");
+
+    // The client library is already loaded by the fixture.
+    EXPECT_THROW(Environment::setRootDirectory("/opt/firebird"), std::runtime_error);
+}
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/csv_importer.hpp"
+#include "fbpp/core/exception.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+// CsvImporter — segmented parallel parse of CSV / TSV into Batch.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+class CsvImporterTest : public TempDatabaseTest {
+protected:
+    void createTestSchema() override {
+        TempDatabaseTest::createTestSchema();
+        connection_->ExecuteDDL(R"(
+            CREATE TABLE csv_t (
+                id      INTEGER NOT NULL PRIMARY KEY,
+                name    VARCHAR(40),
+                big     INT128,
+                df      DECFLOAT(34),
+                amount  NUMERIC(38,4),
+                d       DATE,
+                ts      TIMESTAMP,
+                flag    BOOLEAN,
+                ratio   DOUBLE PRECISION
+            )
+        )");
+    }
+
+    std::shared_ptr<Statement> insert() {
+        return connection_->prepareStatement(
+            "INSERT INTO csv_t (id, name, big, df, amount, d, ts, flag, ratio) "
+            "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    }
+
+    nlohmann::json fetchAll() {
+        auto tx = connection_->StartTransaction();
+        auto stmt = connection_->prepareStatement("SELECT * FROM csv_t ORDER BY id");
+        auto cur = tx->openCursor(stmt);
+        nlohmann::json rows = nlohmann::json::array();
+        nlohmann::json row;
+        while (cur->fetch(row)) {
+            rows.push_back(row);
+        }
+        cur->close();
+        tx->Commit();
+        return rows;
+    }
+};
+
+TEST_F(CsvImporterTest, ParsesQuotedExtendedTypesAcrossSegments) {
+    std::string csv = "id,name,big,df,amount,d,ts,flag,ratio\n";
+    csv += "1,\"comma, \"\"quoted\"\"\",170141183460469231731687303715884105727,1.25E+2,"
+           "12345678901234567890123456789012.3456,2024-02-29,2024-02-29 13:45:01,true,1.5\r\n";
+    csv += "2,\"two\nlines\",-5,,0.0001,2000-01-01,2000-01-01T00:00:00,0,-2e3\n";
+    csv += "3,bad,1,1,1,yesterday,2024-01-01 00:00:00,1,1\n";     // Date
+    csv += "4,short,1\n";                                         // Field count
+    csv += "\n";
+    for (int i = 5; i <= 400; ++i) {
+        csv += std::to_string(i) + ",row " + std::to_string(i) +
+               ",1,1,1,2024-01-01,2024-01-01 00:00:00,false,0\n";
+    }
+
+    auto tx = connection_->StartTransaction();
+    CsvImportOptions options;
+    options.header = true;
+    options.threads = 4;
+    options.segmentBytes = 256;          // Many segments, some cut inside a quoted field
+    options.loader.flushBytes = 16 * 1024;
+    CsvImporter importer(insert(), tx, options);
+    auto result = importer.importText(csv);
+    tx->Commit();
+
+    EXPECT_EQ(result.records, 400u);
+    EXPECT_EQ(result.rowsAdded, 398u);
+    EXPECT_EQ(result.batch.successCount, 398u);
+    EXPECT_GT(result.flushes, 1u);
+    EXPECT_EQ(result.bytes, csv.size());
+    ASSERT_EQ(result.lineErrors.size(), 2u);
+    EXPECT_EQ(result.lineErrors[0].line, 5u);   // Header, row 1, two lines of row 2
+    EXPECT_EQ(result.lineErrors[1].line, 6u);
+    EXPECT_NE(result.lineErrors[1].message.find("fields"), std::string::npos);
+
+    const auto rows = fetchAll();
+    ASSERT_EQ(rows.size(), 398u);
+    EXPECT_EQ(rows[0]["NAME"], "comma, \"quoted\"");
+    EXPECT_EQ(rows[0]["BIG"], "170141183460469231731687303715884105727");
+    EXPECT_EQ(rows[0]["AMOUNT"], "12345678901234567890123456789012.3456");
+    EXPECT_EQ(rows[0]["FLAG"], true);
+    EXPECT_EQ(rows[1]["NAME"], "two\nlines");
+    EXPECT_TRUE(rows[1]["DF"].is_null());       // Empty unquoted field
+    EXPECT_EQ(rows[1]["RATIO"], -2000.0);
+    EXPECT_EQ(rows[397]["NAME"], "row 400");
+}
+
+TEST_F(CsvImporterTest, ImportsTsvFileWithoutQuoting) {
+    const auto path = std::filesystem::temp_directory_path() / "fbpp_csv_importer_test.tsv";
+    {
+        std::ofstream out(path, std::ios::binary);
+        for (int i = 1; i <= 1000; ++i) {
+            out << i << "\t\"as is\"\t" << i << "\t\\N\t" << i << ".5\t2024-01-01\t"
+                << "2024-01-01 10:00:00.5\tTRUE\t0.25\n";
+        }
+    }
+
+    auto tx = connection_->StartTransaction();
+    CsvImportOptions options;
+    options.delimiter = '\t';
+    options.quote = '\0';
+    options.nullText = "\\N";
+    options.segmentBytes = 4096;
+    CsvImporter importer(insert(), tx, options);
+    auto result = importer.importFile(path.string());
+    tx->Commit();
+    std::filesystem::remove(path);
+
+    EXPECT_TRUE(result.lineErrors.empty()) << result.lineErrors.front().message;
+    EXPECT_EQ(result.rowsAdded, 1000u);
+    EXPECT_GE(result.megabytesPerSecond(), 0.0);
+
+    const auto rows = fetchAll();
+    ASSERT_EQ(rows.size(), 1000u);
+    EXPECT_EQ(rows[0]["NAME"], "\"as is\"");
+    EXPECT_TRUE(rows[0]["DF"].is_null());
+    EXPECT_EQ(rows[999]["AMOUNT"], "1000.5000");
+}
+
+TEST_F(CsvImporterTest, StopsAfterTooManyBadLines) {
+    std::string csv;
+    for (int i = 1; i <= 50; ++i) {
+        csv += "x" + std::to_string(i) + ",a,1,1,1,2024-01-01,2024-01-01 00:00:00,1,1\n";
+    }
+    auto tx = connection_->StartTransaction();
+    CsvImportOptions options;
+    options.maxLineErrors = 10;
+    CsvImporter importer(insert(), tx, options);
+    EXPECT_THROW(importer.importText(csv), FirebirdException);
+    tx->Rollback();
+
+    auto tx2 = connection_->StartTransaction();
+    auto noParams = connection_->prepareStatement("SELECT 1 FROM RDB$DATABASE");
+    EXPECT_THROW(CsvImporter(noParams, tx2), FirebirdException);
+    tx2->Commit();
+}
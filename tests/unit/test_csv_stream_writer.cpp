@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/csv_stream_writer.hpp"
+#include "fbpp/core/exception.hpp"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+// CsvStreamWriter — CSV / TSV text straight from fetch buffers.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+class CsvStreamWriterTest : public TempDatabaseTest {};
+
+TEST_F(CsvStreamWriterTest, QuotesOnlyWhereNeeded) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement(R"(
+        SELECT CAST(7 AS INTEGER) AS i,
+               CAST(-12.34 AS NUMERIC(10,2)) AS amount,
+               CAST(12345678901234567890 AS INT128) AS big,
+               CAST('say "hi", ok' AS VARCHAR(32)) AS note,
+               CAST('two' || ASCII_CHAR(10) || 'lines' AS VARCHAR(32)) AS multi,
+               CAST('ab' AS CHAR(6)) AS fixed,
+               CAST(NULL AS INTEGER) AS missing,
+               TRUE AS flag,
+               CAST(1.5 AS DOUBLE PRECISION) AS ratio,
+               CAST(0.1 AS FLOAT) AS approx,
+               DATE '2024-02-29' AS d,
+               CAST('1.25' AS DECFLOAT(16)) AS df
+        FROM RDB$DATABASE
+    )");
+
+    std::ostringstream out;
+    CsvStreamWriter writer(out);
+    auto cur = tx->openCursor(stmt);
+    EXPECT_EQ(cur->writeCsv(writer), 1u);
+    cur->close();
+    writer.finish();
+    tx->Commit();
+
+    EXPECT_EQ(out.str(),
+              "I,AMOUNT,BIG,NOTE,MULTI,FIXED,MISSING,FLAG,RATIO,APPROX,D,DF\r\n"
+              "7,-12.34,12345678901234567890,\"say \"\"hi\"\", ok\",\"two\nlines\",ab,,"
+              "true,1.5,0.1,2024-02-29,1.25\r\n");
+}
+
+TEST_F(CsvStreamWriterTest, BackgroundSinkReceivesChunksInOrder) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement(R"(
+        WITH RECURSIVE r (n) AS (
+            SELECT 1 FROM RDB$DATABASE
+            UNION ALL
+            SELECT n + 1 FROM r WHERE n < 2000
+        )
+        SELECT n, 'row ' || n FROM r
+    )");
+
+    std::string text;
+    std::size_t chunks = 0;
+    const auto caller = std::this_thread::get_id();
+    bool offThread = true;
+    CsvWriteOptions options;
+    options.delimiter = '\t';
+    options.header = false;
+    options.lineEnd = "\n";
+    options.chunkBytes = 512;
+    options.background = true;
+    CsvStreamWriter writer(
+        [&](std::string_view chunk) {
+            offThread = offThread && std::this_thread::get_id() != caller;
+            ++chunks;
+            text.append(chunk);
+        },
+        options);
+
+    auto cur = tx->openCursor(stmt);
+    EXPECT_EQ(cur->writeCsv(writer, 500), 500u);
+    EXPECT_EQ(cur->writeCsv(writer), 1500u);
+    cur->close();
+    writer.finish();
+    tx->Commit();
+
+    EXPECT_TRUE(offThread);
+    EXPECT_GT(chunks, 10u);
+    EXPECT_EQ(writer.rowCount(), 2000u);
+    EXPECT_EQ(text.substr(0, 16), "1\trow 1\n2\trow 2\n");
+    EXPECT_EQ(text.size() - text.rfind("2000\trow 2000\n"), 14u);
+}
+
+TEST_F(CsvStreamWriterTest, BackgroundSinkErrorSurfaces) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement("SELECT 1 FROM RDB$DATABASE WHERE 1 = 0");
+
+    CsvWriteOptions options;
+    options.background = true;
+    CsvStreamWriter writer([](std::string_view) { throw std::runtime_error("disk full"); }, options);
+    auto cur = tx->openCursor(stmt);
+    EXPECT_EQ(cur->writeCsv(writer), 0u);   // Header only
+    cur->close();
+    EXPECT_THROW(writer.finish(), std::runtime_error);
+    tx->Commit();
+}
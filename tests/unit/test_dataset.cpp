@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp_util/dataset.hpp"
+
+#include <cstring>
+#include <optional>
+#include <string>
+#include <tuple>
+
+// Synthetic TABLE_TEST_1 data: determinism of the rows, the load through
+// BulkLoader and resuming a load.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+using fbpp::util::DatasetOptions;
+using fbpp::util::DatasetRow;
+
+class DatasetTest : public TempDatabaseTest {
+protected:
+    int64_t count(const std::string& sql) {
+        auto tx = connection_->StartTransaction();
+        auto cursor = tx->openCursor(connection_->prepareStatement(sql));
+        std::tuple<std::optional<int64_t>> row;
+        EXPECT_TRUE(cursor->fetch(row));
+        cursor->close();
+        tx->Commit();
+        return std::get<0>(row).value_or(0);
+    }
+};
+
+TEST_F(DatasetTest, RowsDependOnSeedAndIndexOnly) {
+    DatasetOptions options;
+    options.seed = 7;
+    options.nullRatio = 0;
+    const DatasetRow a = fbpp::util::datasetRow(123, options);
+    const DatasetRow b = fbpp::util::datasetRow(123, options);
+    EXPECT_EQ(std::get<0>(a), 124);
+    EXPECT_EQ(std::get<1>(a), std::get<1>(b));
+    EXPECT_EQ(std::get<16>(a), std::get<16>(b));
+    EXPECT_EQ(fbpp::util::datasetBlob(123, options, true),
+              fbpp::util::datasetBlob(123, options, true));
+
+    options.seed = 8;
+    const DatasetRow c = fbpp::util::datasetRow(123, options);
+    EXPECT_NE(std::get<16>(a), std::get<16>(c));
+}
+
+TEST_F(DatasetTest, LoadsAndResumes) {
+    DatasetOptions options;
+    options.rows = 300;
+    options.seed = 3;
+    options.blobRatio = 0.5;
+    options.blobBytes = 3000;   // Several segments per BLOB
+    options.chunkRows = 128;
+    uint64_t reported = 0;
+    options.progress = [&](uint64_t done) { reported = done; };
+
+    EXPECT_EQ(fbpp::util::generateDataset(*connection_, options), 300u);
+    EXPECT_EQ(reported, 300u);
+
+    options.firstRow = 300;
+    options.rows = 50;
+    EXPECT_EQ(fbpp::util::generateDataset(*connection_, options), 50u);
+    EXPECT_EQ(count("SELECT COUNT(*) FROM TABLE_TEST_1"), 350);
+    EXPECT_EQ(count("SELECT COUNT(DISTINCT F_INTEGER) FROM TABLE_TEST_1"), 350);
+
+    // BLOB rows are roughly blobRatio of the load
+    const int64_t blobs = count("SELECT COUNT(*) FROM TABLE_TEST_1 WHERE F_BLOB_T IS NOT NULL");
+    EXPECT_GT(blobs, 100);
+    EXPECT_LT(blobs, 250);
+
+    // A stored row reads back as generated
+    uint64_t index = 0;
+    while (!fbpp::util::datasetRowHasBlobs(index, options)) {
+        ++index;
+    }
+    const DatasetRow expected = fbpp::util::datasetRow(index, options);
+    auto tx = connection_->StartTransaction();
+    auto cursor = tx->openCursor(
+        connection_->prepareStatement(
+            "SELECT F_BIGINT, F_VARCHAR, F_TIMESHTAMP_TZ, F_BLOB_T FROM TABLE_TEST_1 "
+            "WHERE F_INTEGER = ?"),
+        std::make_tuple(static_cast<int32_t>(index + 1)));
+    std::tuple<std::optional<int64_t>, std::optional<std::string>,
+               std::optional<TimestampTz>, std::optional<TextBlob>> row;
+    ASSERT_TRUE(cursor->fetch(row));
+    EXPECT_EQ(std::get<0>(row), std::get<1>(expected));
+    EXPECT_EQ(std::get<1>(row), std::get<16>(expected));
+    ASSERT_EQ(std::get<2>(row).has_value(), std::get<15>(expected).has_value());
+    if (std::get<2>(row)) {
+        EXPECT_EQ(std::get<2>(row)->getDate(), std::get<15>(expected)->getDate());
+        EXPECT_EQ(std::get<2>(row)->getTime(), std::get<15>(expected)->getTime());
+        EXPECT_EQ(std::get<2>(row)->getZoneId(), std::get<15>(expected)->getZoneId());
+    }
+    ASSERT_TRUE(std::get<3>(row).has_value());
+    EXPECT_EQ(std::get<3>(row)->getText(), fbpp::util::datasetBlob(index, options, true));
+    cursor->close();
+    tx->Commit();
+}
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include "fbpp/core/decfloat_chars.hpp"
+#include "fbpp/core/environment.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/firebird_compat.hpp"
+#include "fbpp/core/detail/sql_value_codec.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <string>
+
+// Native DECFLOAT(16/34) conversion: decNumber text layout, Firebird's
+// rounding and error rules, and byte parity with IUtil's IDecFloat16/34.
+
+using namespace fbpp::core;
+
+namespace {
+
+std::string randomDecimal(std::mt19937_64& rng, int maxDigits, int maxExponent) {
+    std::string text = (rng() % 2) ? "-" : "";
+    const int digits = 1 + static_cast<int>(rng() % maxDigits);
+    for (int i = 0; i < digits; ++i) {
+        text += static_cast<char>('0' + rng() % 10);
+    }
+    const int exponent = static_cast<int>(rng() % (2 * maxExponent + 1)) - maxExponent;
+    return text + "E" + std::to_string(exponent);
+}
+
+} // namespace
+
+TEST(DecFloatCharsTest, FormatsLikeDecNumber) {
+    EXPECT_EQ(decFloat16FromString("1.25").to_string(), "1.25");
+    EXPECT_EQ(decFloat16FromString("-0.000").to_string(), "-0.000");
+    EXPECT_EQ(decFloat16FromString("1E+5").to_string(), "1E+5");
+    EXPECT_EQ(decFloat16FromString("123E-10").to_string(), "1.23E-8");
+    EXPECT_EQ(decFloat16FromString("inf").to_string(), "Infinity");
+    EXPECT_EQ(decFloat16FromString("-Infinity").to_string(), "-Infinity");
+    EXPECT_EQ(decFloat16FromString("NaN").to_string(), "NaN");
+    EXPECT_EQ(decFloat34FromString("3.1415926535897932384626433832795028").to_string(),
+              "3.141592653589793238462643383279503");   // 34 digits, half up
+    EXPECT_EQ(decFloat16FromString("1.0000000000000005").to_string(), "1.000000000000001");
+}
+
+TEST(DecFloatCharsTest, ToCharsReportsShortBuffer) {
+    const DecFloat16 value = decFloat16FromString("-123.45");
+    char small[4];
+    auto result = toChars(small, small + sizeof(small), value);
+    EXPECT_EQ(result.ec, std::errc::value_too_large);
+
+    char exact[7];
+    result = toChars(exact, exact + sizeof(exact), value);
+    ASSERT_EQ(result.ec, std::errc{});
+    EXPECT_EQ(std::string(exact, result.ptr), "-123.45");
+}
+
+TEST(DecFloatCharsTest, RejectsMalformedAndOverflow) {
+    EXPECT_THROW(decFloat16FromString(""), FirebirdException);
+    EXPECT_THROW(decFloat16FromString("12a"), FirebirdException);
+    EXPECT_THROW(decFloat34FromString("1..2"), FirebirdException);
+    EXPECT_THROW(decFloat16FromString("1E+385"), FirebirdException);
+    EXPECT_THROW(decFloat34FromString("1E+6145"), FirebirdException);
+    EXPECT_NO_THROW(decFloat16FromString("1E-400"));   // Underflow rounds to zero
+}
+
+TEST(DecFloatCharsTest, ConvertsToAndFromDouble) {
+    EXPECT_DOUBLE_EQ(toDouble(decFloat16FromString("1.25")), 1.25);
+    EXPECT_DOUBLE_EQ(toDouble(decFloat34FromString("-1E-300")), -1e-300);
+    EXPECT_TRUE(std::isinf(toDouble(decFloat16FromString("-Infinity"))));
+    EXPECT_TRUE(std::isnan(toDouble(decFloat34FromString("sNaN"))));
+
+    EXPECT_EQ(DecFloat16(0.1).to_string(), "0.1");   // Shortest round-trip digits
+    EXPECT_EQ(DecFloat34(0.1).to_string(), "0.1");
+    EXPECT_DOUBLE_EQ(toDouble(DecFloat34(2.5e-7)), 2.5e-7);
+}
+
+TEST(DecFloatCharsTest, DoubleGetsTheSameDigitsOnEveryPath) {
+    // DecFloat16/34(double) and a double bound to a DECFLOAT parameter
+    using fbpp::core::detail::sql_value_codec::floating_to_string;
+    const double values[] = {0.1, 1.0 / 3, 2.5e-7, 123456.789, -1e300, 5e-324, 0.0};
+    for (const double value : values) {
+        EXPECT_EQ(DecFloat16(value), decFloat16FromString(floating_to_string(value))) << value;
+        EXPECT_EQ(DecFloat34(value), decFloat34FromString(floating_to_string(value))) << value;
+        EXPECT_DOUBLE_EQ(toDouble(DecFloat34(value)), value);
+    }
+}
+
+TEST(DecFloatCharsTest, RoundTripsRandomValues) {
+    std::mt19937_64 rng(64);
+    for (int i = 0; i < 5000; ++i) {
+        const DecFloat16 d16 = decFloat16FromString(randomDecimal(rng, 16, 360));
+        EXPECT_EQ(decFloat16FromString(d16.to_string()), d16) << d16.to_string();
+
+        const DecFloat34 d34 = decFloat34FromString(randomDecimal(rng, 34, 6000));
+        EXPECT_EQ(decFloat34FromString(d34.to_string()), d34) << d34.to_string();
+    }
+}
+
+TEST(DecFloatCharsTest, MatchesFirebirdUtil) {
+    auto& env = Environment::getInstance();
+    Firebird::ThrowStatusWrapper status(env.getMaster()->getStatus());
+    auto* helper16 = env.getUtil()->getDecFloat16(&status);
+    auto* helper34 = env.getUtil()->getDecFloat34(&status);
+
+    std::mt19937_64 rng(34);
+    for (int i = 0; i < 2000; ++i) {
+        const std::string text16 = randomDecimal(rng, 20, 360);
+        FB_DEC16 raw16;
+        helper16->fromString(&status, text16.c_str(), &raw16);
+        const DecFloat16 native16 = decFloat16FromString(text16);
+        ASSERT_EQ(std::memcmp(&raw16, native16.data(), 8), 0) << text16;
+
+        char expected[64];
+        helper16->toString(&status, &raw16, sizeof(expected), expected);
+        EXPECT_EQ(native16.to_string(), expected);
+
+        const std::string text34 = randomDecimal(rng, 40, 6100);
+        FB_DEC34 raw34;
+        helper34->fromString(&status, text34.c_str(), &raw34);
+        const DecFloat34 native34 = decFloat34FromString(text34);
+        ASSERT_EQ(std::memcmp(&raw34, native34.data(), 16), 0) << text34;
+
+        helper34->toString(&status, &raw34, sizeof(expected), expected);
+        EXPECT_EQ(native34.to_string(), expected);
+    }
+    status.dispose();
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// ConnectionOptions::handleRelease — evicted statements and dropped cursors
+// freed off the caller's path.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+class DeferredReleaseTest : public TempDatabaseTest {
+protected:
+    void createTestSchema() override {
+        connection_->ExecuteDDL("CREATE TABLE item (id INTEGER NOT NULL PRIMARY KEY)");
+        auto tx = connection_->StartTransaction();
+        auto insert = connection_->prepareStatement("INSERT INTO item VALUES (?)");
+        for (int32_t i = 1; i <= 50; ++i) {
+            tx->execute(insert, std::make_tuple(i));
+        }
+        tx->Commit();
+    }
+
+    void setRelease(HandleRelease mode, size_t cacheSize = 100) {
+        ConnectionOptions options = connection_->getOptions();
+        options.handleRelease = mode;
+        options.statementCache.maxSize = cacheSize;
+        connection_->setOptions(options);
+    }
+
+    // Prepare `count` distinct statements and drop them
+    void churn(int count) {
+        for (int i = 0; i < count; ++i) {
+            connection_->prepareStatement("SELECT id FROM item WHERE id = " + std::to_string(i));
+        }
+    }
+
+    // Open a cursor, read one row and drop it unclosed
+    void dropCursor(const std::shared_ptr<Statement>& stmt, Transaction& tx) {
+        auto rs = tx.openCursor(stmt);
+        std::tuple<int32_t> row;
+        ASSERT_TRUE(rs->fetch(row));
+    }
+};
+
+TEST_F(DeferredReleaseTest, EvictedStatementsFreedByNextRequest) {
+    setRelease(HandleRelease::nextRequest, 2);
+    const uint64_t before = connection_->deferredHandlesReleased();
+
+    churn(6);
+    auto tx = connection_->StartTransaction();   // Drains what was queued
+    EXPECT_GE(connection_->deferredHandlesReleased() - before, 3u);
+    EXPECT_EQ(connection_->releaseDeferredHandles(), 0u);
+    tx->Commit();
+}
+
+TEST_F(DeferredReleaseTest, DroppedCursorClosedBeforeReopen) {
+    setRelease(HandleRelease::nextRequest);
+    auto stmt = connection_->prepareStatement("SELECT id FROM item ORDER BY id");
+    auto tx = connection_->StartTransaction();
+    const uint64_t before = connection_->deferredHandlesReleased();
+
+    dropCursor(stmt, *tx);
+    auto rs = tx->openCursor(stmt);   // Same statement: queued cursor closed first
+    EXPECT_EQ(connection_->deferredHandlesReleased() - before, 1u);
+
+    std::tuple<int32_t> row;
+    int rows = 0;
+    while (rs->fetch(row)) {
+        ++rows;
+    }
+    EXPECT_EQ(rows, 50);
+    rs->close();
+    tx->Commit();
+}
+
+TEST_F(DeferredReleaseTest, ImmediateFreesInDestructor) {
+    setRelease(HandleRelease::immediate, 2);
+    const uint64_t before = connection_->deferredHandlesReleased();
+
+    churn(6);
+    auto stmt = connection_->prepareStatement("SELECT id FROM item ORDER BY id");
+    auto tx = connection_->StartTransaction();
+    dropCursor(stmt, *tx);
+    EXPECT_EQ(connection_->releaseDeferredHandles(), 0u);
+    EXPECT_EQ(connection_->deferredHandlesReleased(), before);
+    tx->Commit();
+}
+
+TEST_F(DeferredReleaseTest, BackgroundDrainsWithoutRequests) {
+    setRelease(HandleRelease::background, 2);
+    const uint64_t before = connection_->deferredHandlesReleased();
+
+    churn(6);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (connection_->deferredHandlesReleased() - before < 3 &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_GE(connection_->deferredHandlesReleased() - before, 3u);
+
+    // Back to the request paths only
+    setRelease(HandleRelease::nextRequest);
+    auto stmt = connection_->prepareStatement("SELECT id FROM item ORDER BY id");
+    auto tx = connection_->StartTransaction();
+    dropCursor(stmt, *tx);
+    tx->Commit();
+}
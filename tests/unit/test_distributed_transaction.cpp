@@ -0,0 +1,216 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/distributed_transaction.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// DistributedTransaction — parallel two-phase commit over two databases and
+// recovery of limbo transactions from the decision log.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+class DistributedTransactionTest : public TempDatabaseTest {
+protected:
+    void SetUp() override {
+        TempDatabaseTest::SetUp();
+        secondParams_ = makeScopedTestDatabaseParams("dtx_2");
+        recreateTestDatabase(secondParams_);
+        second_ = std::make_unique<Connection>(secondParams_);
+        for (Connection* conn : participants()) {
+            conn->ExecuteDDL("CREATE TABLE dtx_item (id INTEGER NOT NULL PRIMARY KEY)");
+        }
+        logFile_ = std::filesystem::temp_directory_path() /
+                   ("fbpp_dtx_" + std::to_string(getCurrentProcessId()) + ".log");
+        std::filesystem::remove(logFile_);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(logFile_);
+        second_.reset();
+        dropTestDatabaseQuietly(secondParams_);
+        TempDatabaseTest::TearDown();
+    }
+
+    std::vector<Connection*> participants() { return {connection_.get(), second_.get()}; }
+
+    DistributedTransactionOptions loggedOptions() const {
+        DistributedTransactionOptions options;
+        options.logFile = logFile_;
+        return options;
+    }
+
+    static void insert(DistributedTransaction& dtx, int32_t id) {
+        for (size_t i = 0; i < dtx.size(); ++i) {
+            auto stmt = dtx[i].getConnection()->prepareStatement(
+                "INSERT INTO dtx_item (id) VALUES (?)");
+            dtx[i].execute(stmt, std::make_tuple(id));
+        }
+    }
+
+    static int64_t count(Connection& conn) {
+        auto tx = conn.StartTransaction();
+        auto cursor = tx->openCursor(conn.prepareStatement("SELECT COUNT(*) FROM dtx_item"));
+        std::tuple<int64_t> row{0};
+        cursor->fetch(row);
+        cursor->close();
+        tx->Commit();
+        return std::get<0>(row);
+    }
+
+    ConnectionParams secondParams_;
+    std::unique_ptr<Connection> second_;
+    std::filesystem::path logFile_;
+};
+
+TEST_F(DistributedTransactionTest, CommitsOnEveryParticipant) {
+    {
+        DistributedTransaction dtx(participants(), loggedOptions());
+        EXPECT_EQ(dtx.size(), 2u);
+        insert(dtx, 1);
+        dtx.commit();
+        EXPECT_EQ(dtx.state(), DistributedTransaction::State::Committed);
+        EXPECT_FALSE(dtx[0].isActive());
+        EXPECT_FALSE(dtx[1].isActive());
+    }
+    EXPECT_EQ(count(*connection_), 1);
+    EXPECT_EQ(count(*second_), 1);
+
+    // Coordinator id, then decision and completion
+    std::ifstream in(logFile_);
+    std::string verb;
+    std::string id;
+    in >> verb >> id;
+    EXPECT_EQ(verb, "COORDINATOR");
+    EXPECT_FALSE(id.empty());
+    in >> verb >> id;
+    EXPECT_EQ(verb, "COMMIT");
+    in >> verb >> id;
+    EXPECT_EQ(verb, "DONE");
+}
+
+TEST_F(DistributedTransactionTest, SerialPhasesCommitToo) {
+    auto options = loggedOptions();
+    options.parallel = false;
+    DistributedTransaction dtx(participants(), options);
+    insert(dtx, 2);
+    dtx.commit();
+    EXPECT_EQ(count(*connection_), 1);
+    EXPECT_EQ(count(*second_), 1);
+}
+
+TEST_F(DistributedTransactionTest, FailedPrepareRollsBackEveryone) {
+    DistributedTransaction dtx(participants(), loggedOptions());
+    insert(dtx, 3);
+    dtx[1].Rollback();   // Participant 1 can no longer prepare
+    EXPECT_THROW(dtx.commit(), FirebirdException);
+    EXPECT_EQ(dtx.state(), DistributedTransaction::State::RolledBack);
+    EXPECT_FALSE(dtx[0].isActive());
+    EXPECT_EQ(count(*connection_), 0);
+    // No decision was taken
+    std::ifstream in(logFile_);
+    std::string verb;
+    std::string id;
+    while (in >> verb >> id) {
+        EXPECT_NE(verb, "COMMIT");
+    }
+}
+
+TEST_F(DistributedTransactionTest, RollbackAfterPrepare) {
+    DistributedTransaction dtx(participants());
+    insert(dtx, 4);
+    dtx.prepare();
+    EXPECT_EQ(dtx.state(), DistributedTransaction::State::Prepared);
+    EXPECT_TRUE(dtx[0].isPrepared());
+    dtx.rollback();
+    EXPECT_EQ(count(*connection_), 0);
+    EXPECT_EQ(count(*second_), 0);
+    EXPECT_THROW(dtx.commit(), FirebirdException);
+}
+
+TEST_F(DistributedTransactionTest, RejectsRepeatedParticipant) {
+    EXPECT_THROW(DistributedTransaction({connection_.get(), connection_.get()}),
+                 FirebirdException);
+}
+
+TEST_F(DistributedTransactionTest, RecoverCommitsLoggedDecision) {
+    std::string id;
+    {
+        DistributedTransaction dtx(participants(), loggedOptions());
+        id = dtx.id();
+        insert(dtx, 5);
+        dtx.prepare();
+        // The coordinator "dies" after logging its decision
+        std::ofstream(logFile_, std::ios::app) << "COMMIT " << id << '\n';
+        dtx[0].Disconnect();
+        dtx[1].Disconnect();
+    }
+
+    const auto recovered = DistributedTransaction::recover(participants(), logFile_);
+    EXPECT_EQ(recovered.committed, 2u);
+    EXPECT_EQ(recovered.rolledBack, 0u);
+    EXPECT_EQ(count(*connection_), 1);
+    EXPECT_EQ(count(*second_), 1);
+
+    // Nothing left in limbo
+    const auto again = DistributedTransaction::recover(participants(), logFile_);
+    EXPECT_EQ(again.committed + again.rolledBack, 0u);
+}
+
+TEST_F(DistributedTransactionTest, RecoverPresumesAbortWithoutDecision) {
+    {
+        DistributedTransaction dtx(participants(), loggedOptions());
+        insert(dtx, 6);
+        dtx.prepare();
+        dtx[0].Disconnect();
+        dtx[1].Disconnect();
+    }
+
+    const auto recovered = DistributedTransaction::recover(participants(), logFile_);
+    EXPECT_EQ(recovered.committed, 0u);
+    EXPECT_EQ(recovered.rolledBack, 2u);
+    EXPECT_EQ(count(*connection_), 0);
+    EXPECT_EQ(count(*second_), 0);
+}
+
+TEST_F(DistributedTransactionTest, RecoverLeavesOtherCoordinatorsAlone) {
+    {
+        DistributedTransaction dead(participants(), loggedOptions());
+        insert(dead, 7);
+        dead.prepare();
+        dead[0].Disconnect();
+        dead[1].Disconnect();
+    }
+
+    // A live coordinator with a log of its own, prepared on other attachments
+    const auto otherLog = std::filesystem::path(logFile_).replace_extension(".other.log");
+    std::filesystem::remove(otherLog);
+    Connection first(db_params_);
+    Connection second(secondParams_);
+    DistributedTransactionOptions options;
+    options.logFile = otherLog;
+    DistributedTransaction live({&first, &second}, options);
+    insert(live, 8);
+    live.prepare();
+
+    const auto recovered = DistributedTransaction::recover(participants(), logFile_);
+    EXPECT_EQ(recovered.committed, 0u);
+    EXPECT_EQ(recovered.rolledBack, 2u);
+
+    // Its branches survived recovery and still commit
+    EXPECT_TRUE(live[0].isPrepared());
+    EXPECT_TRUE(live[1].isPrepared());
+    live.commit();
+    EXPECT_EQ(count(*connection_), 1);
+    EXPECT_EQ(count(*second_), 1);
+    std::filesystem::remove(otherLog);
+}
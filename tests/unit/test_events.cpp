@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/event_subscription.hpp"
+#include "fbpp/core/query_result_cache.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// Database events — one multiplexed queEvents registration per connection.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+namespace {
+
+constexpr auto kTimeout = std::chrono::seconds(10);
+constexpr const char* kAuxPortHint =
+    "no event delivered in time; remote events need the server's RemoteAuxPort reachable";
+
+// Counts posts per name as the dispatcher thread reports them
+class EventLog {
+public:
+    void add(const std::vector<EventNotification>& events) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const auto& event : events) {
+                counts_[event.name] += event.count;
+            }
+            ++batches_;
+        }
+        changed_.notify_all();
+    }
+
+    bool waitFor(const std::string& name, unsigned count) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return changed_.wait_for(lock, kTimeout, [&] { return counts_[name] >= count; });
+    }
+
+    unsigned count(const std::string& name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return counts_[name];
+    }
+
+    unsigned batches() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return batches_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::map<std::string, unsigned> counts_;
+    unsigned batches_ = 0;
+};
+
+} // namespace
+
+class EventsTest : public TempDatabaseTest {
+protected:
+    // POST_EVENT from a second attachment; delivered on commit only
+    void post(const std::vector<std::string>& names, bool commit = true) {
+        Connection other(db_params_);
+        auto tx = other.StartTransaction();
+        std::string sql = "EXECUTE BLOCK AS BEGIN ";
+        for (const auto& name : names) {
+            sql += "POST_EVENT '" + name + "'; ";
+        }
+        sql += "END";
+        other.ExecuteInTransaction(tx.get(), sql);
+        if (commit) {
+            tx->Commit();
+        } else {
+            tx->Rollback();
+        }
+    }
+
+    // The first answer to a registration only sets the baseline counters
+    bool waitForDeliveries(std::uint64_t count) {
+        const auto deadline = std::chrono::steady_clock::now() + kTimeout;
+        while (connection_->getEventStatistics().deliveries < count) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return true;
+    }
+};
+
+TEST_F(EventsTest, DeliversOnCommitNotOnRollback) {
+    EventLog log;
+    auto sub = connection_->subscribeEvents({"fbpp_evt_a"}, [&](const std::string& name, unsigned count) {
+        log.add({{name, count}});
+    });
+    ASSERT_TRUE(waitForDeliveries(1)) << kAuxPortHint;
+    EXPECT_TRUE(sub->isActive());
+
+    post({"fbpp_evt_a"}, false);
+    post({"fbpp_evt_a"});
+    ASSERT_TRUE(log.waitFor("fbpp_evt_a", 1)) << kAuxPortHint;
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_EQ(log.count("fbpp_evt_a"), 1u);    // The rolled back post never arrives
+}
+
+TEST_F(EventsTest, MultiplexesManyNamesOverOneRegistration) {
+    std::vector<std::string> tables;
+    for (int i = 0; i < 300; ++i) {
+        tables.push_back("CHG$T" + std::to_string(i));
+    }
+    EventLog all;
+    auto wide = connection_->subscribeEventBatches(tables, [&](const auto& events) { all.add(events); });
+    ASSERT_TRUE(waitForDeliveries(1)) << kAuxPortHint;
+
+    EventLog few;
+    auto narrow = connection_->subscribeEventBatches({"CHG$T7", "CHG$EXTRA"},
+                                                     [&](const auto& events) { few.add(events); });
+    ASSERT_TRUE(waitForDeliveries(2)) << kAuxPortHint;   // Re-queued once for CHG$EXTRA
+
+    auto stats = connection_->getEventStatistics();
+    EXPECT_EQ(stats.subscriptions, 2u);
+    EXPECT_EQ(stats.names, 301u);
+    EXPECT_EQ(stats.registrations, 1u);
+    EXPECT_EQ(stats.queued, 2u);
+
+    post({"CHG$T7", "CHG$T150", "CHG$T299", "CHG$EXTRA"});
+    ASSERT_TRUE(all.waitFor("CHG$T299", 1)) << kAuxPortHint;
+    ASSERT_TRUE(few.waitFor("CHG$EXTRA", 1)) << kAuxPortHint;
+    EXPECT_EQ(all.count("CHG$T7"), 1u);
+    EXPECT_EQ(all.count("CHG$T150"), 1u);
+    EXPECT_EQ(all.count("CHG$EXTRA"), 0u);
+    EXPECT_EQ(all.batches(), 1u);               // One commit, one callback
+    EXPECT_EQ(few.count("CHG$T7"), 1u);
+    EXPECT_EQ(few.count("CHG$T150"), 0u);
+
+    narrow->cancel();
+    stats = connection_->getEventStatistics();
+    EXPECT_EQ(stats.names, 300u);                // CHG$T7 is still wanted by `wide`
+    EXPECT_EQ(stats.registrations, 1u);
+}
+
+TEST_F(EventsTest, RequeuesAcrossCommitsAndStopsOnCancel) {
+    EventLog log;
+    auto sub = connection_->subscribeEventBatches({"fbpp_evt_b"}, [&](const auto& events) { log.add(events); });
+    ASSERT_TRUE(waitForDeliveries(1)) << kAuxPortHint;
+
+    post({"fbpp_evt_b"});
+    ASSERT_TRUE(log.waitFor("fbpp_evt_b", 1)) << kAuxPortHint;
+    post({"fbpp_evt_b"});
+    ASSERT_TRUE(log.waitFor("fbpp_evt_b", 2)) << kAuxPortHint;
+
+    sub->cancel();
+    sub->cancel();                               // Idempotent
+    EXPECT_FALSE(sub->isActive());
+    EXPECT_EQ(connection_->getEventStatistics().registrations, 0u);
+    post({"fbpp_evt_b"});
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_EQ(log.count("fbpp_evt_b"), 2u);
+
+    EXPECT_THROW(connection_->subscribeEvents({""}, [](const std::string&, unsigned) {}),
+                 FirebirdException);
+    EXPECT_THROW(connection_->subscribeEvents({std::string(256, 'x')}, [](const std::string&, unsigned) {}),
+                 FirebirdException);
+}
+
+TEST_F(EventsTest, InvalidatesQueryResultCacheOnEvent) {
+    connection_->ExecuteDDL("CREATE TABLE evt_ref (id INTEGER NOT NULL PRIMARY KEY, name VARCHAR(20))");
+    connection_->ExecuteDDL(
+        "CREATE TRIGGER evt_ref_changed FOR evt_ref AFTER INSERT OR UPDATE OR DELETE AS "
+        "BEGIN POST_EVENT 'CHG$EVT_REF'; END");
+
+    QueryResultCache cache;
+    auto listener = cache.invalidateOnEvents(*connection_, {"evt_ref"}, "CHG$");
+    ASSERT_TRUE(waitForDeliveries(1)) << kAuxPortHint;
+
+    auto tx = connection_->StartTransaction();
+    const QueryCacheHints dependsOnRef{std::nullopt, {"evt_ref"}};
+    auto before = cache.query(*connection_, *tx, "SELECT COUNT(*) FROM evt_ref", dependsOnRef);
+    tx->Commit();
+    EXPECT_EQ(cache.stats().entries, 1u);
+
+    {
+        Connection writer(db_params_);
+        auto wtx = writer.StartTransaction();
+        writer.ExecuteInTransaction(wtx.get(), "INSERT INTO evt_ref VALUES (1, 'one')");
+        wtx->Commit();
+    }
+    const auto deadline = std::chrono::steady_clock::now() + kTimeout;
+    while (cache.stats().invalidations == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ASSERT_EQ(cache.stats().invalidations, 1u) << kAuxPortHint;
+
+    tx = connection_->StartTransaction();
+    auto after = cache.query(*connection_, *tx, "SELECT COUNT(*) FROM evt_ref", dependsOnRef);
+    tx->Commit();
+    EXPECT_NE(after, before);
+    EXPECT_EQ(after->row(0).get<int64_t>(0), 1);
+}
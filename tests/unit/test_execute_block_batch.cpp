@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/execute_block_batch.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// ExecuteBlockBatch — INSERT ... RETURNING packed into bucketed EXECUTE BLOCKs;
+// rowCounts mode for DML without RETURNING.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+class ExecuteBlockBatchTest : public TempDatabaseTest {
+protected:
+    using Item = std::tuple<std::string, std::optional<int32_t>>;
+
+    void createTestSchema() override {
+        connection_->ExecuteDDL(
+            "CREATE TABLE eb_item (id INTEGER GENERATED BY DEFAULT AS IDENTITY PRIMARY KEY,"
+            " name VARCHAR(30) NOT NULL, qty INTEGER, price NUMERIC(10, 2) DEFAULT 1.25)");
+    }
+
+    static std::vector<Item> items(int32_t count) {
+        std::vector<Item> rows;
+        for (int32_t i = 0; i < count; ++i) {
+            rows.emplace_back("item " + std::to_string(i),
+                              i % 5 == 0 ? std::nullopt : std::optional<int32_t>(i));
+        }
+        return rows;
+    }
+
+    int64_t count(Transaction& tx) {
+        auto cur = tx.openCursor(connection_->prepareStatement("SELECT COUNT(*) FROM eb_item"));
+        std::tuple<int64_t> row;
+        EXPECT_TRUE(cur->fetch(row));
+        cur->close();
+        return std::get<0>(row);
+    }
+};
+
+TEST_F(ExecuteBlockBatchTest, ReturnsKeysInInputOrder) {
+    ExecuteBlockOptions options;
+    options.maxRows = 40;   // Rounded down to 32
+    ExecuteBlockBatch insert(*connection_,
+                             "INSERT INTO eb_item (name, qty) VALUES (:name, :qty)"
+                             " RETURNING id, name, price",
+                             options);
+    EXPECT_EQ(insert.rowsPerBlock(), 32u);
+
+    const auto rows = items(70);   // Blocks of 32, 32 and 6 (an 8-slot shape)
+    auto tx = connection_->StartTransaction();
+    const auto returned =
+        insert.returning<std::tuple<int32_t, std::string, double>>(*tx, rows);
+    ASSERT_EQ(returned.size(), rows.size());
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        EXPECT_EQ(std::get<1>(returned[i]), std::get<0>(rows[i]));
+        EXPECT_DOUBLE_EQ(std::get<2>(returned[i]), 1.25);
+        if (i > 0) {
+            EXPECT_GT(std::get<0>(returned[i]), std::get<0>(returned[i - 1]));
+        }
+    }
+    EXPECT_EQ(insert.shapes(), 2u);
+    EXPECT_EQ(count(*tx), 70);   // Unused slots insert nothing
+
+    // The NULL qty went through as NULL
+    auto cur = tx->openCursor(
+        connection_->prepareStatement("SELECT COUNT(*) FROM eb_item WHERE qty IS NULL"));
+    std::tuple<int64_t> nulls;
+    ASSERT_TRUE(cur->fetch(nulls));
+    cur->close();
+    EXPECT_EQ(std::get<0>(nulls), 14);
+
+    std::vector<std::size_t> indexes;
+    EXPECT_EQ(insert.each(*tx, std::span<const Item>(rows.data(), 3),
+                          [&](std::size_t index, const RowView& view) {
+                              indexes.push_back(index);
+                              EXPECT_EQ(view.get<std::string>("NAME"), std::get<0>(rows[index]));
+                          }),
+              3u);
+    EXPECT_EQ(indexes, (std::vector<std::size_t>{0, 1, 2}));
+    EXPECT_EQ(insert.shapes(), 3u);
+    tx->Commit();
+}
+
+TEST_F(ExecuteBlockBatchTest, BlockTextSkipsUnusedSlots) {
+    // '?' in a literal and a trailing comment are not parameters
+    ExecuteBlockBatch insert(*connection_,
+                             "INSERT INTO eb_item (name, qty) VALUES (?, CHAR_LENGTH('?'))"
+                             " RETURNING id -- ?");
+    const std::string sql = insert.blockSql(2);
+    EXPECT_NE(sql.find("FBPP_N INTEGER = ?, FBPP_P0_0 VARCHAR("), std::string::npos);
+    EXPECT_NE(sql.find("RETURNS (ID INTEGER)"), std::string::npos);
+    EXPECT_NE(sql.find("IF (FBPP_N > 1) THEN BEGIN"), std::string::npos);
+    EXPECT_NE(sql.find("VALUES (:FBPP_P1_0, CHAR_LENGTH('?')) RETURNING id -- ?\n    INTO :ID;"),
+              std::string::npos);
+
+    auto tx = connection_->StartTransaction();
+    const auto ids = insert.returning<std::tuple<int32_t>>(
+        *tx, std::vector<std::tuple<std::string>>{{"a"}});
+    ASSERT_EQ(ids.size(), 1u);
+    EXPECT_EQ(count(*tx), 1);
+    tx->Commit();
+}
+
+TEST_F(ExecuteBlockBatchTest, RejectsStatementsWithoutOneRowPerInput) {
+    EXPECT_THROW(ExecuteBlockBatch(*connection_, "INSERT INTO eb_item (name) VALUES (?)"),
+                 FirebirdException);
+    EXPECT_THROW(ExecuteBlockBatch(*connection_,
+                                   "UPDATE eb_item SET qty = ? WHERE id = ? RETURNING id"),
+                 FirebirdException);
+}
+
+TEST_F(ExecuteBlockBatchTest, RowCountsRunDmlWithoutReturning) {
+    ExecuteBlockOptions options;
+    options.rowCounts = true;
+    options.continueOnError = true;
+    ExecuteBlockBatch update(*connection_, "UPDATE eb_item SET qty = ? WHERE name = ?", options);
+    const std::string sql = update.blockSql(1);
+    EXPECT_NE(sql.find("RETURNS (FBPP_COUNT INTEGER, FBPP_ERROR INTEGER, FBPP_STATE CHAR(5))"),
+              std::string::npos);
+    EXPECT_NE(sql.find("WHEN ANY DO BEGIN"), std::string::npos);
+    EXPECT_EQ(sql.find("FBPP_STOP = 1"), std::string::npos);
+
+    auto tx = connection_->StartTransaction();
+    ExecuteBlockBatch insert(*connection_, "INSERT INTO eb_item (name, qty) VALUES (?, ?)"
+                             " RETURNING id");
+    insert.returning<std::tuple<int32_t>>(*tx, items(4));
+
+    // Packed as BulkLoader packs: one statement message per row
+    auto stmt = connection_->prepareStatement("UPDATE eb_item SET qty = ? WHERE name = ?");
+    auto input = stmt->getInputMetadata();
+    const std::size_t stride = input->getMessageLength();
+    const std::vector<std::tuple<int32_t, std::string>> rows{
+        {10, "item 0"}, {11, "missing"}, {12, "item 3"}};
+    std::vector<std::uint8_t> messages(rows.size() * stride, 0);
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        pack(rows[i], messages.data() + i * stride, input.get(), tx.get());
+    }
+    const auto result = update.execute(*tx, messages.data(), rows.size(), stride);
+    EXPECT_EQ(result.totalMessages, 3u);
+    EXPECT_EQ(result.perMessageStatus, (std::vector<int>{1, 0, 1}));
+    EXPECT_EQ(result.failedCount, 0u);
+    tx->Commit();
+
+    EXPECT_THROW(ExecuteBlockBatch(*connection_, "SELECT id FROM eb_item", options),
+                 FirebirdException);
+    EXPECT_THROW(insert.execute(*connection_->StartTransaction(), messages.data(), 0, stride),
+                 FirebirdException);
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/executor.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Executor — work stealing, task groups, nested waits, strands.
+
+using namespace fbpp::core;
+
+TEST(ExecutorTest, RunsEveryPostedTaskBeforeDestruction) {
+    std::atomic<int> ran{0};
+    {
+        Executor pool(3);
+        EXPECT_EQ(pool.threadCount(), 3u);
+        for (int i = 0; i < 1000; ++i) {
+            pool.post([&ran] { ran.fetch_add(1); });
+        }
+    }
+    EXPECT_EQ(ran.load(), 1000);
+}
+
+TEST(ExecutorTest, IdleWorkersStealFromABusyOne) {
+    Executor pool(4);
+    std::atomic<int> ran{0};
+    TaskGroup outer(pool);
+    // Everything posted from one worker lands in its deque; the others
+    // have to steal to help
+    outer.run([&] {
+        TaskGroup inner(pool);
+        for (int i = 0; i < 64; ++i) {
+            inner.run([&ran] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                ran.fetch_add(1);
+            });
+        }
+        inner.wait();
+    });
+    outer.wait();
+    EXPECT_EQ(ran.load(), 64);
+    EXPECT_GT(pool.stats().stolen, 0u);
+}
+
+TEST(ExecutorTest, ParallelForVisitsEachIndexOnce) {
+    Executor pool(4);
+    std::vector<std::atomic<int>> hits(5000);
+    pool.parallelFor(hits.size(), [&](std::size_t i) { hits[i].fetch_add(1); });
+    for (const auto& hit : hits) {
+        ASSERT_EQ(hit.load(), 1);
+    }
+
+    pool.parallelFor(0, [](std::size_t) { FAIL(); });
+}
+
+TEST(ExecutorTest, ParallelForRethrowsAndStopsClaiming) {
+    Executor pool(2);
+    std::atomic<std::size_t> calls{0};
+    EXPECT_THROW(pool.parallelFor(100000, [&](std::size_t i) {
+        calls.fetch_add(1);
+        if (i == 10) {
+            throw std::runtime_error("stop");
+        }
+    }), std::runtime_error);
+    EXPECT_LT(calls.load(), 100000u);
+}
+
+TEST(ExecutorTest, NestedWaitsDoNotDeadlockASingleWorker) {
+    Executor pool(1);
+    std::atomic<int> leaves{0};
+    TaskGroup group(pool);
+    group.run([&] {
+        pool.parallelFor(4, [&](std::size_t) {
+            pool.parallelFor(4, [&](std::size_t) { leaves.fetch_add(1); });
+        });
+    });
+    group.wait();
+    EXPECT_EQ(leaves.load(), 16);
+    EXPECT_GT(pool.stats().helped, 0u);
+}
+
+TEST(ExecutorTest, TaskGroupRethrowsTheFirstError) {
+    Executor pool(2);
+    TaskGroup group(pool);
+    std::atomic<int> ran{0};
+    for (int i = 0; i < 10; ++i) {
+        group.run([&ran, i] {
+            ran.fetch_add(1);
+            if (i == 3) {
+                throw FirebirdException("task failed");
+            }
+        });
+    }
+    EXPECT_THROW(group.wait(), FirebirdException);
+    EXPECT_EQ(ran.load(), 10);
+    EXPECT_NO_THROW(group.wait());   // Reported once
+}
+
+TEST(ExecutorTest, StrandsKeepOrderOnASharedPool) {
+    auto pool = std::make_shared<Executor>(4);
+    constexpr int kStrands = 8;
+    constexpr int kTasks = 200;
+    std::vector<std::vector<int>> order(kStrands);
+    {
+        std::vector<std::unique_ptr<Strand>> strands;
+        for (int s = 0; s < kStrands; ++s) {
+            strands.push_back(std::make_unique<Strand>(pool));
+        }
+        for (int i = 0; i < kTasks; ++i) {
+            for (int s = 0; s < kStrands; ++s) {
+                strands[s]->post([&order, s, i] { order[s].push_back(i); });
+            }
+        }
+    }
+    for (const auto& seen : order) {
+        std::vector<int> expected(kTasks);
+        std::iota(expected.begin(), expected.end(), 0);
+        EXPECT_EQ(seen, expected);
+    }
+}
+
+TEST(ExecutorTest, SharedExecutorIsConfiguredOnce) {
+    const auto& shared = Executor::shared();
+    ASSERT_TRUE(shared);
+    EXPECT_EQ(&Executor::shared(), &shared);
+    EXPECT_NO_THROW(Executor::setSharedThreadCount(shared->threadCount()));
+    EXPECT_THROW(Executor::setSharedThreadCount(shared->threadCount() + 1), FirebirdException);
+
+    std::atomic<bool> ran{false};
+    Strand strand;   // On the shared executor
+    strand.post([&ran] { ran = true; });
+    strand.waitIdle();
+    EXPECT_TRUE(ran.load());
+}
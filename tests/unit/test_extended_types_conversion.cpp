@@ -148,6 +148,29 @@ TEST_F(ExtendedTypesConversionTest, TimestampTzCrossCheckedWithEngine) {
     tx->Commit();
 }
 
+TEST_F(ExtendedTypesConversionTest, TimeZoneTextDecodedWithoutEngine) {
+    if (!connection_) GTEST_SKIP() << "Database not available";
+
+    // Wall-clock time and zone name come from TimeZoneTable; the expected
+    // strings are what the engine's decodeTimeStampTz produces.
+    auto tx = connection_->StartTransaction();
+    auto sel = connection_->prepareStatement(
+        "SELECT TIMESTAMP '2024-01-15 12:00:00.1234 Europe/Berlin', "
+        "TIMESTAMP '2024-07-15 12:00:00 Europe/Berlin', "
+        "TIMESTAMP '2000-01-01 00:30:00 -02:30', "
+        "TIME '23:59:59.9999 +01:00' "
+        "FROM RDB$DATABASE");
+    auto rs = tx->openCursor(sel);
+    std::tuple<std::string, std::string, std::string, std::string> row;
+    ASSERT_TRUE(rs->fetch(row));
+    EXPECT_EQ(std::get<0>(row), "2024-01-15T12:00:00.1234 Europe/Berlin");
+    EXPECT_EQ(std::get<1>(row), "2024-07-15T12:00:00.0000 Europe/Berlin");
+    EXPECT_EQ(std::get<2>(row), "2000-01-01T00:30:00.0000-02:30");
+    EXPECT_EQ(std::get<3>(row), "23:59:59.9999+01:00");
+    rs->close();
+    tx->Commit();
+}
+
 TEST_F(ExtendedTypesConversionTest, TuplePackUnpackExtendedTypesAsString) {
     if (!connection_) GTEST_SKIP() << "Database not available";
 
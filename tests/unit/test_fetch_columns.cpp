@@ -0,0 +1,347 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/batch.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/column_batch.hpp"
+#include "fbpp/core/time_zone_table.hpp"
+#include "fbpp/core/exception.hpp"
+
+#include <array>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// ResultSet::fetchColumns — struct-of-arrays decode with validity bitmaps,
+// and Batch::addColumns, its inverse.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+namespace {
+
+constexpr const char* kColumnsDdl = R"(
+                id       INTEGER NOT NULL PRIMARY KEY,
+                f_small  SMALLINT,
+                f_big    BIGINT,
+                f_num    NUMERIC(18,2),
+                f_dbl    DOUBLE PRECISION,
+                f_bool   BOOLEAN,
+                f_vc     VARCHAR(32),
+                f_ch     CHAR(8),
+                f_date   DATE,
+                f_time   TIME,
+                f_ts     TIMESTAMP,
+                f_i128   INT128,
+                f_df     DECFLOAT(34),
+                f_ts_tz  TIMESTAMP WITH TIME ZONE,
+                f_blob   BLOB SUB_TYPE TEXT
+            )";
+
+// Fixed-width column; rows with present[i] == false are NULL
+template<typename T>
+ColumnVector fixedColumn(std::string name, ColumnType type, const std::vector<T>& values,
+                         const std::vector<bool>& present, int scale = 0) {
+    ColumnVector col;
+    col.name = std::move(name);
+    col.type = type;
+    col.scale = scale;
+    col.length = values.size();
+    col.values.resize(values.size() * sizeof(T));
+    std::memcpy(col.values.data(), values.data(), col.values.size());
+    col.validity.assign((values.size() + 7) / 8, 0);
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        if (present[i]) {
+            col.validity[i >> 3] = static_cast<uint8_t>(col.validity[i >> 3] | (1u << (i & 7)));
+        } else {
+            ++col.nullCount;
+        }
+    }
+    return col;
+}
+
+} // namespace
+
+class FetchColumnsTest : public TempDatabaseTest {
+protected:
+    void createTestSchema() override {
+        TempDatabaseTest::createTestSchema();
+        connection_->ExecuteDDL(std::string("CREATE TABLE fc_copy (") + kColumnsDdl);
+        connection_->ExecuteDDL(std::string("CREATE TABLE fc_t (") + kColumnsDdl);
+
+        auto tx = connection_->StartTransaction();
+        connection_->ExecuteInTransaction(tx.get(),
+            "INSERT INTO fc_t VALUES (1, 7, 9000000000, 12.34, 2.5, TRUE, 'abc', 'xy', "
+            "DATE '1970-01-02', TIME '00:00:01', TIMESTAMP '1970-01-01 00:00:02', "
+            "170141183460469231731687303715884105727, 1.5, "
+            "TIMESTAMP '1970-01-01 00:00:03 UTC', 'blob text')");
+        connection_->ExecuteInTransaction(tx.get(),
+            "INSERT INTO fc_t (id) VALUES (2)");
+        connection_->ExecuteInTransaction(tx.get(),
+            "INSERT INTO fc_t (id, f_vc) VALUES (3, '')");
+        tx->Commit();
+    }
+};
+
+TEST_F(FetchColumnsTest, DecodesAllTypesIntoColumns) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement("SELECT * FROM fc_t ORDER BY id");
+    auto cur = tx->openCursor(stmt);
+
+    ColumnBatch batch;
+    ASSERT_TRUE(cur->fetchColumns(batch, 16));
+    ASSERT_EQ(batch.rowCount, 3u);
+    ASSERT_EQ(batch.columns.size(), 15u);
+
+    const auto* id = batch.find("id");
+    ASSERT_NE(id, nullptr);
+    EXPECT_EQ(id->type, ColumnType::Int32);
+    EXPECT_EQ(id->nullCount, 0u);
+    auto ids = id->view<int32_t>();
+    EXPECT_EQ(ids[0], 1);
+    EXPECT_EQ(ids[2], 3);
+
+    const auto* small = batch.find("F_SMALL");
+    EXPECT_EQ(small->type, ColumnType::Int16);
+    EXPECT_EQ(small->view<int16_t>()[0], 7);
+    EXPECT_TRUE(small->isNull(1));
+    EXPECT_EQ(small->nullCount, 2u);
+
+    EXPECT_EQ(batch.find("f_big")->view<int64_t>()[0], 9000000000LL);
+
+    const auto* num = batch.find("f_num");
+    EXPECT_EQ(num->type, ColumnType::Int64);
+    EXPECT_EQ(num->scale, -2);
+    EXPECT_EQ(num->view<int64_t>()[0], 1234);
+
+    EXPECT_DOUBLE_EQ(batch.find("f_dbl")->view<double>()[0], 2.5);
+    EXPECT_EQ(batch.find("f_bool")->view<uint8_t>()[0], 1);
+
+    const auto* vc = batch.find("f_vc");
+    EXPECT_EQ(vc->type, ColumnType::String);
+    EXPECT_EQ(vc->stringAt(0), "abc");
+    EXPECT_TRUE(vc->isNull(1));
+    EXPECT_EQ(vc->stringAt(1), "");
+    EXPECT_FALSE(vc->isNull(2));
+    EXPECT_EQ(vc->stringAt(2), "");
+
+    EXPECT_EQ(batch.find("f_ch")->stringAt(0), "xy");
+    EXPECT_EQ(batch.find("f_date")->view<int32_t>()[0], 1);
+    EXPECT_EQ(batch.find("f_time")->view<int64_t>()[0], 1000000);
+    EXPECT_EQ(batch.find("f_ts")->view<int64_t>()[0], 2000000);
+    EXPECT_EQ(batch.find("f_ts_tz")->view<int64_t>()[0], 3000000);
+
+    const auto* i128 = batch.find("f_i128");
+    EXPECT_EQ(i128->type, ColumnType::Int128);
+    uint64_t parts[2] = {};
+    std::memcpy(parts, i128->values.data(), 16);
+    EXPECT_EQ(parts[0], ~0ULL);
+    EXPECT_EQ(parts[1], 0x7FFFFFFFFFFFFFFFULL);
+
+    const auto* df = batch.find("f_df");
+    EXPECT_EQ(df->type, ColumnType::String);
+    EXPECT_EQ(df->stringAt(0), "1.5");
+
+    const auto* blob = batch.find("f_blob");
+    EXPECT_EQ(blob->type, ColumnType::String);
+    EXPECT_EQ(blob->stringAt(0), "blob text");
+    EXPECT_TRUE(blob->isNull(1));
+}
+
+TEST_F(FetchColumnsTest, KeepsZoneIdsForLocalTime) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement(
+        "SELECT TIMESTAMP '2024-07-01 12:00:00 +03:00' AS ts_offset, "
+        "TIMESTAMP '2024-01-15 12:00:00 Europe/Berlin' AS ts_region, "
+        "TIMESTAMP '2024-07-15 12:00:00 Europe/Berlin' AS ts_summer, "
+        "TIME '10:00:00 -02:30' AS t_offset, "
+        "CAST(NULL AS TIMESTAMP WITH TIME ZONE) AS ts_null, "
+        "f_ts FROM fc_t WHERE id = 1");
+    auto cur = tx->openCursor(stmt);
+
+    ColumnBatch batch;
+    ASSERT_TRUE(cur->fetchColumns(batch, 4));
+    ASSERT_EQ(batch.rowCount, 1u);
+
+    auto& zones = TimeZoneTable::instance();
+    auto wallClock = [&](const char* name) {
+        const auto* col = batch.find(name);
+        EXPECT_EQ(col->zoneIds.size(), 1u);
+        int64_t local = 0;
+        zones.toLocalMicros(col->view<int64_t>().data(), col->zoneIds.data(), 1, &local);
+        return local;
+    };
+    // 2024-07-01 is day 19905, 2024-01-15 day 19737, 2024-07-15 day 19919.
+    constexpr int64_t kDay = 86400000000LL;
+    constexpr int64_t kNoon = 12 * 3600000000LL;
+    EXPECT_EQ(wallClock("ts_offset"), 19905 * kDay + kNoon);
+    EXPECT_EQ(wallClock("ts_region"), 19737 * kDay + kNoon);
+    EXPECT_EQ(wallClock("ts_summer"), 19919 * kDay + kNoon);
+    EXPECT_EQ(wallClock("t_offset"), 10 * 3600000000LL);
+
+    EXPECT_EQ(batch.find("ts_offset")->view<int64_t>()[0], 19905 * kDay + 9 * 3600000000LL);
+    EXPECT_EQ(zones.name(batch.find("ts_offset")->zoneIds[0]), "+03:00");
+    EXPECT_EQ(zones.name(batch.find("ts_region")->zoneIds[0]), "Europe/Berlin");
+    EXPECT_EQ(batch.find("ts_null")->zoneIds[0], 0u);
+    EXPECT_TRUE(batch.find("f_ts")->zoneIds.empty());
+}
+
+TEST_F(FetchColumnsTest, BatchesUntilEndAndReusesBuffers) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement("SELECT id FROM fc_t ORDER BY id");
+    auto cur = tx->openCursor(stmt);
+
+    ColumnBatch batch;
+    ASSERT_TRUE(cur->fetchColumns(batch, 2));
+    EXPECT_EQ(batch.rowCount, 2u);
+    EXPECT_EQ(batch.columns[0].view<int32_t>()[1], 2);
+
+    ASSERT_TRUE(cur->fetchColumns(batch, 2));
+    EXPECT_EQ(batch.rowCount, 1u);
+    EXPECT_EQ(batch.columns[0].view<int32_t>()[0], 3);
+
+    EXPECT_FALSE(cur->fetchColumns(batch, 2));
+    EXPECT_EQ(batch.rowCount, 0u);
+    EXPECT_TRUE(cur->isEof());
+}
+
+TEST_F(FetchColumnsTest, ConsumesPrefetchedRowsFirst) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement("SELECT id FROM fc_t ORDER BY id");
+    auto cur = tx->openCursor(stmt);
+    cur->setPrefetch(2);
+
+    auto first = cur->fetchOne();   // window holds rows 1,2; row 1 served
+    ASSERT_TRUE(first.has_value());
+
+    auto batch = cur->fetchColumns(10);
+    ASSERT_EQ(batch.rowCount, 2u);
+    EXPECT_EQ(batch.columns[0].view<int32_t>()[0], 2);
+    EXPECT_EQ(batch.columns[0].view<int32_t>()[1], 3);
+}
+
+TEST_F(FetchColumnsTest, RejectsWrongViewWidthAndZeroBatch) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement("SELECT id, f_vc FROM fc_t ORDER BY id");
+    auto cur = tx->openCursor(stmt);
+
+    EXPECT_THROW(cur->fetchColumns(0), FirebirdException);
+
+    auto batch = cur->fetchColumns(4);
+    EXPECT_THROW(batch.columns[0].view<int64_t>(), FirebirdException);
+    EXPECT_THROW(batch.columns[0].stringAt(0), FirebirdException);
+    EXPECT_EQ(batch.find("missing"), nullptr);
+}
+
+TEST_F(FetchColumnsTest, ColumnArraysGatherBatches) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement("SELECT f_big, f_vc FROM fc_t ORDER BY id");
+    auto cur = tx->openCursor(stmt);
+
+    // Batches of one: every append after the first starts mid-byte
+    ColumnArray<int64_t> big;
+    ColumnArray<std::string> text;
+    const std::array<ColumnType, 2> layout = {ColumnType::Int64, ColumnType::String};
+    ColumnBatch batch;
+    while (cur->fetchColumns(batch, 1)) {
+        checkColumnTypes(batch, layout, "test");
+        big.append(batch.columns[0]);
+        text.append(batch.columns[1]);
+    }
+    ASSERT_EQ(big.size(), 3u);
+    EXPECT_EQ(big.values[0], 9000000000);
+    EXPECT_TRUE(big.isNull(1));
+    EXPECT_TRUE(big.isNull(2));
+    EXPECT_EQ(big.nullCount, 2u);
+    EXPECT_EQ(text.values[0], "abc");
+    EXPECT_TRUE(text.isNull(1));
+    EXPECT_FALSE(text.isNull(2));
+    EXPECT_EQ(text.values[2], "");
+
+    const std::array<ColumnType, 1> other = {ColumnType::Int64};
+    EXPECT_THROW(checkColumnTypes(batch, other, "test"), FirebirdException);
+}
+
+TEST_F(FetchColumnsTest, AddColumnsRoundTripsFetchedColumns) {
+    auto tx = connection_->StartTransaction();
+    ColumnBatch fetched;
+    {
+        auto cur = tx->openCursor(connection_->prepareStatement("SELECT * FROM fc_t ORDER BY id"));
+        ASSERT_TRUE(cur->fetchColumns(fetched, 16));
+    }
+
+    auto insert = connection_->prepareStatement(
+        "INSERT INTO fc_copy VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    BatchOptions options;
+    options.blobPolicy = BatchBlobPolicy::IdEngine;
+    auto batch = insert->createBatch(tx.get(), options);
+    batch->setStreamChunkBytes(1);   // One message per chunk
+    batch->addColumns(fetched);
+    EXPECT_EQ(batch->getMessageCount(), 3u);
+    const auto result = batch->execute(tx.get());
+    EXPECT_EQ(result.successCount, 3u);
+
+    ColumnBatch copied;
+    auto cur = tx->openCursor(connection_->prepareStatement("SELECT * FROM fc_copy ORDER BY id"));
+    ASSERT_TRUE(cur->fetchColumns(copied, 16));
+    ASSERT_EQ(copied.rowCount, fetched.rowCount);
+    ASSERT_EQ(copied.columns.size(), fetched.columns.size());
+    for (std::size_t c = 0; c < fetched.columns.size(); ++c) {
+        SCOPED_TRACE(fetched.columns[c].name);
+        EXPECT_EQ(copied.columns[c].type, fetched.columns[c].type);
+        EXPECT_EQ(copied.columns[c].validity, fetched.columns[c].validity);
+        EXPECT_EQ(copied.columns[c].values, fetched.columns[c].values);
+        EXPECT_EQ(copied.columns[c].offsets, fetched.columns[c].offsets);
+        EXPECT_EQ(copied.columns[c].zoneIds, fetched.columns[c].zoneIds);
+    }
+}
+
+TEST_F(FetchColumnsTest, AddColumnsRescalesIntegersAndChecksTheLayout) {
+    auto tx = connection_->StartTransaction();
+    auto insert = connection_->prepareStatement(
+        "INSERT INTO fc_copy (id, f_small, f_num) VALUES (?, ?, ?)");
+
+    // BIGINT ids into INTEGER, 4 decimals into NUMERIC(18,2): 12.3456 -> 12.35
+    ColumnBatch columns;
+    columns.rowCount = 2;
+    columns.columns.push_back(
+        fixedColumn<int64_t>("ID", ColumnType::Int64, {10, 11}, {true, true}));
+    columns.columns.push_back(
+        fixedColumn<int32_t>("F_SMALL", ColumnType::Int32, {5, 0}, {true, false}));
+    columns.columns.push_back(
+        fixedColumn<int64_t>("F_NUM", ColumnType::Int64, {123456, -20000}, {true, true}, -4));
+
+    auto batch = insert->createBatch(tx.get());
+    batch->addColumns(columns);
+    EXPECT_EQ(batch->execute(tx.get()).successCount, 2u);
+
+    auto cur = tx->openCursor(connection_->prepareStatement(
+        "SELECT f_small, f_num FROM fc_copy ORDER BY id"));
+    const auto back = cur->fetchColumns(4);
+    ASSERT_EQ(back.rowCount, 2u);
+    EXPECT_EQ(back.columns[0].view<int16_t>()[0], 5);
+    EXPECT_TRUE(back.columns[0].isNull(1));
+    EXPECT_EQ(back.columns[1].view<int64_t>()[0], 1235);
+    EXPECT_EQ(back.columns[1].view<int64_t>()[1], -200);
+
+    // Nothing reaches the batch when the layout is wrong
+    auto rejected = insert->createBatch(tx.get());
+    ColumnBatch wrongType = columns;
+    wrongType.columns[0] = fixedColumn<double>("ID", ColumnType::Double, {1.0, 2.0}, {true, true});
+    EXPECT_THROW(rejected->addColumns(wrongType), FirebirdException);
+    ColumnBatch missing = columns;
+    missing.columns.pop_back();
+    EXPECT_THROW(rejected->addColumns(missing), FirebirdException);
+    ColumnBatch tooFew = columns;
+    tooFew.rowCount = 3;
+    EXPECT_THROW(rejected->addColumns(tooFew), FirebirdException);
+    EXPECT_EQ(rejected->getMessageCount(), 0u);
+
+    ColumnBatch tooWide = columns;
+    tooWide.columns[1] = fixedColumn<int32_t>("F_SMALL", ColumnType::Int32, {70000, 1},
+                                              {true, true});
+    EXPECT_THROW(rejected->addColumns(tooWide), FirebirdException);
+}
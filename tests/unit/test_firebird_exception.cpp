@@ -3,6 +3,7 @@
 #include "fbpp/core/environment.hpp"
 #include "fbpp/core/connection.hpp"
 #include "../test_base.hpp"
+#include <tuple>
 #include <firebird/Interface.h>
 #ifdef _WIN32
 #include <iberror.h>
@@ -408,3 +409,55 @@ TEST_F(FirebirdExceptionTest, StatusVectorSnapshotSurvivesStatusLifetime) {
     EXPECT_EQ(snapshot[0].numericValue, 335544580);
     EXPECT_EQ(snapshot[1].textValue, "TEST_TABLE");
 }
+
+TEST_F(FirebirdExceptionTest, MessageFormattedLazilyFromSnapshot) {
+    auto& env = Environment::getInstance();
+    Firebird::IStatus* status = env.getMaster()->getStatus();
+
+    intptr_t errorVector[] = {
+        isc_arg_gds,
+        335544580,  // isc_dsql_relation_err: Table unknown
+        isc_arg_gds,
+        335544569,  // isc_dsql_command_err
+        isc_arg_string,
+        reinterpret_cast<intptr_t>("LAZY_TABLE"),
+        isc_arg_end
+    };
+
+    status->setErrors(errorVector);
+    Firebird::FbException fbEx(status);
+    FirebirdException ex(fbEx);
+    status->dispose();   // Formatting below works from the snapshot only
+
+    EXPECT_EQ(ex.getErrorCode(), 335544580);
+    const FirebirdException copy = ex;
+    const std::string message = copy.what();
+    EXPECT_NE(message.find("LAZY_TABLE"), std::string::npos);
+    EXPECT_NE(message.find("Error chain:"), std::string::npos);
+    EXPECT_EQ(ex.what(), copy.what());   // Formatted once, shared by copies
+    ASSERT_EQ(ex.getErrorMessages().size(), 2u);
+    EXPECT_NE(ex.getErrorMessages()[1].find(" - LAZY_TABLE"), std::string::npos);
+}
+
+TEST_F(FirebirdExceptionIntegrationTest, TryExecuteReturnsTheError) {
+    connection_->ExecuteDDL("CREATE TABLE try_t (id INTEGER NOT NULL PRIMARY KEY)");
+    auto tra = connection_->StartTransaction();
+    auto insert = connection_->prepareStatement("INSERT INTO try_t VALUES (?)");
+
+    auto first = tra->tryExecute(insert, std::make_tuple(1));
+    ASSERT_TRUE(first);
+    EXPECT_EQ(*first, 1u);
+
+    auto duplicate = tra->tryExecute(insert, std::make_tuple(1));
+    ASSERT_FALSE(duplicate);
+    EXPECT_EQ(duplicate.error().getSQLState(), "23000");
+    EXPECT_THROW(duplicate.value(), FirebirdException);
+
+    auto cursor = tra->openCursor(connection_->prepareStatement("SELECT id FROM try_t"));
+    std::tuple<int32_t> row;
+    auto fetched = cursor->tryFetch(row);
+    ASSERT_TRUE(fetched);
+    EXPECT_TRUE(*fetched);
+    cursor->close();
+    tra->Commit();
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/schema/index_maintenance.hpp"
+#include "fbpp/schema/schema_inspector.hpp"
+
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Index deactivate / rebuild / statistics refresh around a bulk load, on an
+// attachment with Firebird 5 parallel workers.
+
+using namespace fbpp::core;
+using namespace fbpp::schema;
+using namespace fbpp::test;
+
+namespace {
+
+bool hasIndex(const std::vector<std::string>& names, const std::string& name) {
+    return std::find(names.begin(), names.end(), name) != names.end();
+}
+
+} // namespace
+
+class IndexMaintenanceTest : public TempDatabaseTest {
+protected:
+    void SetUp() override {
+        TempDatabaseTest::SetUp();
+        connection_->ExecuteDDL(
+            "CREATE TABLE im_event (id INTEGER NOT NULL PRIMARY KEY, kind INTEGER)");
+        connection_->ExecuteDDL("CREATE INDEX im_event_kind ON im_event (kind)");
+    }
+
+    double selectivity(Connection& conn, const std::string& index) {
+        auto tx = conn.StartTransaction();
+        auto stmt = conn.prepareStatement(
+            "SELECT CAST(RDB$STATISTICS AS DOUBLE PRECISION) FROM RDB$INDICES "
+            "WHERE RDB$INDEX_NAME = ?");
+        auto cur = tx->openCursor(stmt, std::make_tuple(index));
+        std::tuple<double> row{-1.0};
+        EXPECT_TRUE(cur->fetch(row));
+        tx->Commit();
+        return std::get<0>(row);
+    }
+};
+
+TEST_F(IndexMaintenanceTest, RebuildsAndRefreshesAfterABulkLoad) {
+    ConnectionParams params = db_params_;
+    params.parallelWorkers = 2;
+    Connection conn(params);
+
+    const auto parked = deactivateIndexes(conn, "im_event");
+    ASSERT_EQ(parked, std::vector<std::string>{"IM_EVENT_KIND"});   // Not the PK index
+
+    {
+        auto tx = conn.StartTransaction();
+        auto ins = conn.prepareStatement("INSERT INTO im_event (id, kind) VALUES (?, ?)");
+        for (int32_t id = 0; id < 1000; ++id) {
+            tx->execute(ins, std::make_tuple(id, id % 10));
+        }
+        tx->Commit();
+    }
+
+    activateIndexes(conn, parked);
+    const TableInfo info = SchemaInspector(conn).getTableInfo("im_event");
+    for (const IndexInfo& index : info.indexes) {
+        EXPECT_TRUE(index.active) << index.name;
+    }
+
+    const auto refreshed = refreshIndexStatistics(conn, {"im_event"});
+    EXPECT_TRUE(hasIndex(refreshed, "IM_EVENT_KIND"));
+    EXPECT_EQ(refreshed.size(), info.indexes.size());
+    // Ten distinct keys: selectivity 1/10
+    EXPECT_NEAR(selectivity(conn, "IM_EVENT_KIND"), 0.1, 1e-6);
+}
+
+TEST_F(IndexMaintenanceTest, RefreshesEveryTableByDefault) {
+    connection_->ExecuteDDL("CREATE TABLE im_other (code INTEGER)");
+    connection_->ExecuteDDL("CREATE INDEX im_other_code ON im_other (code)");
+    const auto refreshed = refreshIndexStatistics(*connection_);
+    EXPECT_TRUE(hasIndex(refreshed, "IM_EVENT_KIND"));
+    EXPECT_TRUE(hasIndex(refreshed, "IM_OTHER_CODE"));
+}
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include "fbpp/core/int128_chars.hpp"
+#include "fbpp/core/environment.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/firebird_compat.hpp"
+
+#include <cstring>
+#include <random>
+#include <string>
+
+// Native INT128 / NUMERIC(38,x) text conversion: Firebird layout rules,
+// rounding, range limits, and parity with IUtil's IInt128.
+
+using namespace fbpp::core;
+
+namespace {
+
+Int128 fromParts(uint64_t lo, uint64_t hi) {
+    uint8_t bytes[16];
+    std::memcpy(bytes, &lo, 8);
+    std::memcpy(bytes + 8, &hi, 8);
+    return Int128(bytes);
+}
+
+const Int128 kMax = fromParts(~uint64_t{0}, ~uint64_t{0} >> 1);
+const Int128 kMin = fromParts(0, uint64_t{1} << 63);
+
+} // namespace
+
+TEST(Int128CharsTest, FormatsWithScale) {
+    EXPECT_EQ(int128ToString(Int128(int64_t{0})), "0");
+    EXPECT_EQ(int128ToString(Int128(int64_t{12345}), -2), "123.45");
+    EXPECT_EQ(int128ToString(Int128(int64_t{-12345}), -2), "-123.45");
+    EXPECT_EQ(int128ToString(Int128(int64_t{5}), -2), "0.05");
+    EXPECT_EQ(int128ToString(Int128(int64_t{-5}), -3), "-0.005");
+    EXPECT_EQ(int128ToString(Int128(int64_t{12}), -2), "0.12");
+    EXPECT_EQ(int128ToString(Int128(int64_t{7}), 3), "7000");
+    EXPECT_EQ(int128ToString(kMax), "170141183460469231731687303715884105727");
+    EXPECT_EQ(int128ToString(kMin), "-170141183460469231731687303715884105728");
+    EXPECT_EQ(int128ToString(kMin, -38), "-1.70141183460469231731687303715884105728");
+}
+
+TEST(Int128CharsTest, ToCharsReportsShortBuffer) {
+    char small[4];
+    auto result = toChars(small, small + sizeof(small), Int128(int64_t{-12345}), -2);
+    EXPECT_EQ(result.ec, std::errc::value_too_large);
+
+    char exact[7];
+    result = toChars(exact, exact + sizeof(exact), Int128(int64_t{-12345}), -2);
+    ASSERT_EQ(result.ec, std::errc{});
+    EXPECT_EQ(std::string(exact, result.ptr), "-123.45");
+}
+
+TEST(Int128CharsTest, ParsesAndRescales) {
+    EXPECT_EQ(int128FromString("123.45", -2), Int128(int64_t{12345}));
+    EXPECT_EQ(int128FromString("  -123.4 ", -2), Int128(int64_t{-12340}));
+    EXPECT_EQ(int128FromString("+7", -4), Int128(int64_t{70000}));
+    EXPECT_EQ(int128FromString(".5", -1), Int128(int64_t{5}));
+    EXPECT_EQ(int128FromString("1.5e2", 0), Int128(int64_t{150}));
+    EXPECT_EQ(int128FromString("125E-2", -1), Int128(int64_t{13}));   // 1.25 -> 1.3
+    EXPECT_EQ(int128FromString("1.005", -2), Int128(int64_t{101}));   // Half away from zero
+    EXPECT_EQ(int128FromString("-1.005", -2), Int128(int64_t{-101}));
+    EXPECT_EQ(int128FromString("0.0049", -2), Int128(int64_t{0}));
+    EXPECT_EQ(int128FromString("170141183460469231731687303715884105727"), kMax);
+    EXPECT_EQ(int128FromString("-170141183460469231731687303715884105728"), kMin);
+}
+
+TEST(Int128CharsTest, RejectsMalformedAndOutOfRange) {
+    EXPECT_THROW(int128FromString(""), FirebirdException);
+    EXPECT_THROW(int128FromString("-"), FirebirdException);
+    EXPECT_THROW(int128FromString("12a"), FirebirdException);
+    EXPECT_THROW(int128FromString("170141183460469231731687303715884105728"), FirebirdException);
+    EXPECT_THROW(int128FromString("1.7014118346046923173168730371588410573", -38), FirebirdException);
+
+    Int128 value;
+    const std::string text = "99999999999999999999999999999999999999999";
+    const auto result = fromChars(text.data(), text.data() + text.size(), value);
+    EXPECT_EQ(result.ec, std::errc::result_out_of_range);
+}
+
+TEST(Int128CharsTest, RoundTripsRandomValues) {
+    std::mt19937_64 rng(128);
+    for (int i = 0; i < 5000; ++i) {
+        const Int128 value = fromParts(rng(), rng() >> (rng() % 64));
+        const int scale = -static_cast<int>(rng() % 39);
+        const std::string text = int128ToString(value, scale);
+        EXPECT_EQ(int128FromString(text, scale), value) << text;
+    }
+}
+
+TEST(Int128CharsTest, ComparesAndAddsWithWrap) {
+    const Int128 minusOne(int64_t{-1});
+    const Int128 one(int64_t{1});
+    EXPECT_LT(kMin, minusOne);
+    EXPECT_LT(minusOne, one);
+    EXPECT_GT(kMax, fromParts(0, 1));
+    EXPECT_LT(fromParts(~uint64_t{0}, 0), fromParts(0, 1));   // Carry between the halves
+
+    EXPECT_EQ(fromParts(~uint64_t{0}, 0) + one, fromParts(0, 1));
+    EXPECT_EQ(fromParts(0, 1) - one, fromParts(~uint64_t{0}, 0));
+    EXPECT_EQ(kMax + one, kMin);                                // Wraps like unsigned types
+    EXPECT_EQ(-minusOne, one);
+    EXPECT_EQ(-kMin, kMin);
+    EXPECT_TRUE(minusOne.isNegative());
+    EXPECT_EQ(Int128::fromParts(-1, ~uint64_t{0}), minusOne);
+    EXPECT_EQ(minusOne.high(), -1);
+
+    std::mt19937_64 rng(82);
+    for (int i = 0; i < 2000; ++i) {
+        const Int128 a = fromParts(rng(), rng() >> 2);
+        const Int128 b = fromParts(rng(), rng() >> 2);
+        EXPECT_EQ(a + b - b, a);
+        EXPECT_EQ(a < b, b > a);
+    }
+}
+
+TEST(Int128CharsTest, RescalesExactlyAndRounds) {
+    Int128 values[4] = {int128FromString("123.456", -3), int128FromString("-123.455", -3),
+                        int128FromString("0.004", -3), kMax};
+    Int128 out[4];
+    rescaleInt128(values, 3, -3, -2, out);
+    EXPECT_EQ(int128ToString(out[0], -2), "123.46");
+    EXPECT_EQ(int128ToString(out[1], -2), "-123.46");   // Half away from zero
+    EXPECT_EQ(int128ToString(out[2], -2), "0.00");
+
+    rescaleInt128(values, 1, -3, -30, out);
+    EXPECT_EQ(int128ToString(out[0], -30), "123.456000000000000000000000000000");
+    // 10^37 * 123456 does not fit
+    EXPECT_THROW(rescaleInt128(values, 1, -3, -40, out), FirebirdException);
+    EXPECT_THROW(rescaleInt128(values + 3, 1, 0, -1, out), FirebirdException);
+
+    rescaleInt128(values + 3, 1, 0, 38, out);
+    EXPECT_EQ(out[0], Int128(int64_t{2}));             // 1.70e38 / 10^38 rounds to 2
+    rescaleInt128(values, 2, -3, -3, values);           // In place, no change
+    EXPECT_EQ(int128ToString(values[1], -3), "-123.455");
+}
+
+TEST(Int128CharsTest, MatchesFirebirdUtil) {
+    auto& env = Environment::getInstance();
+    Firebird::ThrowStatusWrapper status(env.getMaster()->getStatus());
+    auto* helper = env.getUtil()->getInt128(&status);
+
+    std::mt19937_64 rng(38);
+    for (int i = 0; i < 2000; ++i) {
+        const Int128 value = fromParts(rng(), rng() >> (rng() % 64));
+        const int scale = -static_cast<int>(rng() % 39);
+
+        FB_I128 raw;
+        std::memcpy(&raw, value.data(), 16);
+        char expected[64];
+        helper->toString(&status, &raw, scale, sizeof(expected), expected);
+        ASSERT_EQ(int128ToString(value, scale), expected);
+
+        FB_I128 parsed;
+        helper->fromString(&status, scale, expected, &parsed);
+        EXPECT_EQ(std::memcmp(&parsed, int128FromString(expected, scale).data(), 16), 0) << expected;
+    }
+    status.dispose();
+}
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/json_nest_writer.hpp"
+#include "fbpp/core/json_stream_writer.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <sstream>
+#include <string>
+#include <tuple>
+
+// JsonNestWriter — one joined query grouped into parent objects with
+// nested child arrays, written through JsonStreamWriter.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+namespace {
+
+const char* kOrdersSql = R"(
+    SELECT o.id, o.customer, l.line_no, l.sku, l.qty
+    FROM nest_orders o LEFT JOIN nest_lines l ON l.order_id = o.id
+    ORDER BY o.id, l.line_no
+)";
+
+const std::vector<JsonNestLevel> kOrderLevels = {
+    {{"ID", "CUSTOMER"}, 1, "LINES"},
+    {{"LINE_NO", "SKU", "QTY"}, 0},
+};
+
+} // namespace
+
+class JsonNestWriterTest : public TempDatabaseTest {
+protected:
+    void createTestSchema() override {
+        TempDatabaseTest::createTestSchema();
+        connection_->ExecuteDDL(R"(
+            CREATE TABLE nest_orders (
+                id INTEGER NOT NULL PRIMARY KEY,
+                customer VARCHAR(40)
+            )
+        )");
+        connection_->ExecuteDDL(R"(
+            CREATE TABLE nest_lines (
+                order_id INTEGER NOT NULL,
+                line_no INTEGER NOT NULL,
+                sku VARCHAR(20),
+                qty INTEGER
+            )
+        )");
+        auto tx = connection_->StartTransaction();
+        auto order = connection_->prepareStatement(
+            "INSERT INTO nest_orders (id, customer) VALUES (?, ?)");
+        auto line = connection_->prepareStatement(
+            "INSERT INTO nest_lines (order_id, line_no, sku, qty) VALUES (?, ?, ?, ?)");
+        tx->execute(order, std::make_tuple(int32_t{1}, std::string("acme")));
+        tx->execute(order, std::make_tuple(int32_t{2}, std::string("empty")));
+        tx->execute(order, std::make_tuple(int32_t{3}, std::string("beta")));
+        tx->execute(line, std::make_tuple(int32_t{1}, int32_t{1}, std::string("A-1"), int32_t{2}));
+        tx->execute(line, std::make_tuple(int32_t{1}, int32_t{2}, std::string("A-2"), int32_t{5}));
+        tx->execute(line, std::make_tuple(int32_t{3}, int32_t{1}, std::string("B-1"), int32_t{1}));
+        tx->Commit();
+    }
+
+    nlohmann::json writeNested(const std::string& sql, std::vector<JsonNestLevel> levels,
+                               size_t chunkBytes = 64 * 1024) {
+        std::ostringstream out;
+        JsonStreamWriter json(out, JsonRowShape::Object, chunkBytes);
+        JsonNestWriter nest(json, std::move(levels));
+        auto tx = connection_->StartTransaction();
+        auto cur = tx->openCursor(connection_->prepareStatement(sql));
+        rows_ = cur->writeJson(nest);
+        cur->close();
+        nest.finish();
+        json.finish();
+        objects_ = json.rowCount();
+        tx->Commit();
+        return nlohmann::json::parse(out.str());
+    }
+
+    size_t rows_ = 0;
+    size_t objects_ = 0;
+};
+
+TEST_F(JsonNestWriterTest, GroupsChildRowsUnderTheirParent) {
+    const auto doc = writeNested(kOrdersSql, kOrderLevels);
+
+    const auto expected = nlohmann::json::parse(R"([
+        {"ID":1,"CUSTOMER":"acme","LINES":[
+            {"LINE_NO":1,"SKU":"A-1","QTY":2},
+            {"LINE_NO":2,"SKU":"A-2","QTY":5}]},
+        {"ID":2,"CUSTOMER":"empty","LINES":[]},
+        {"ID":3,"CUSTOMER":"beta","LINES":[
+            {"LINE_NO":1,"SKU":"B-1","QTY":1}]}
+    ])");
+    EXPECT_EQ(doc, expected);
+    EXPECT_EQ(rows_, 4u);
+    EXPECT_EQ(objects_, 3u);
+}
+
+TEST_F(JsonNestWriterTest, SmallChunksProduceTheSameDocument) {
+    EXPECT_EQ(writeNested(kOrdersSql, kOrderLevels, 1), writeNested(kOrdersSql, kOrderLevels));
+}
+
+TEST_F(JsonNestWriterTest, ThreeLevelsWithTextKey) {
+    // Customer -> orders -> lines, the customer grouped by its VARCHAR name
+    const auto doc = writeNested(R"(
+        SELECT CASE WHEN o.id = 2 THEN 'beta' ELSE o.customer END AS who,
+               o.id, l.sku
+        FROM nest_orders o LEFT JOIN nest_lines l ON l.order_id = o.id
+        ORDER BY 1, o.id, l.line_no
+    )", {
+        {{"WHO"}, 1, "ORDERS"},
+        {{"ID"}, 1, "SKUS"},
+        {{"SKU"}, 0},
+    });
+
+    const auto expected = nlohmann::json::parse(R"([
+        {"WHO":"acme","ORDERS":[{"ID":1,"SKUS":[{"SKU":"A-1"},{"SKU":"A-2"}]}]},
+        {"WHO":"beta","ORDERS":[{"ID":2,"SKUS":[]},{"ID":3,"SKUS":[{"SKU":"B-1"}]}]}
+    ])");
+    EXPECT_EQ(doc, expected);
+}
+
+TEST_F(JsonNestWriterTest, NoRowsIsAnEmptyArray) {
+    const auto doc = writeNested("SELECT id, customer FROM nest_orders WHERE id < 0",
+                                 {{{"ID", "CUSTOMER"}, 1}});
+    EXPECT_EQ(doc, nlohmann::json::array());
+}
+
+TEST_F(JsonNestWriterTest, UnknownColumnThrows) {
+    std::ostringstream out;
+    JsonStreamWriter json(out);
+    JsonNestWriter nest(json, {{{"ID"}, 1, "LINES"}, {{"NOPE"}, 0}});
+    auto tx = connection_->StartTransaction();
+    auto cur = tx->openCursor(connection_->prepareStatement(kOrdersSql));
+    EXPECT_THROW(cur->writeJson(nest), FirebirdException);
+    cur->close();
+    tx->Rollback();
+}
+
+TEST(JsonNestWriterLevelsTest, RejectsInconsistentLevels) {
+    std::ostringstream out;
+    JsonStreamWriter json(out);
+    EXPECT_THROW(JsonNestWriter(json, {}), FirebirdException);
+    EXPECT_THROW(JsonNestWriter(json, {{{}, 0}}), FirebirdException);
+    EXPECT_THROW(JsonNestWriter(json, {{{"ID"}, 2}}), FirebirdException);
+    // An outer level needs a key and a member for its children
+    EXPECT_THROW(JsonNestWriter(json, {{{"ID"}, 0, "LINES"}, {{"SKU"}, 0}}), FirebirdException);
+    EXPECT_THROW(JsonNestWriter(json, {{{"ID"}, 1}, {{"SKU"}, 0}}), FirebirdException);
+    EXPECT_NO_THROW(JsonNestWriter(json, {{{"ID"}, 1, "LINES"}, {{"SKU"}, 0}}));
+}
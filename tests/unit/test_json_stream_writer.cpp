@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/json_stream_writer.hpp"
+#include "fbpp/core/json_unpacker.hpp"
+#include "fbpp/core/exception.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+// JsonStreamWriter — JSON text straight from fetch buffers, same value
+// mapping as JsonUnpacker.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+class JsonStreamWriterTest : public TempDatabaseTest {};
+
+namespace {
+
+const char* kMixedSql = R"(
+    SELECT CAST(7 AS INTEGER) AS i,
+           CAST(-12.34 AS NUMERIC(10,2)) AS amount,
+           CAST(12345678901234567890 AS INT128) AS big,
+           CAST('say "hi"' || ASCII_CHAR(10) || ASCII_CHAR(1) AS VARCHAR(32)) AS note,
+           CAST('ab' AS CHAR(6)) AS fixed,
+           CAST(NULL AS INTEGER) AS missing,
+           TRUE AS flag,
+           CAST(1.5 AS DOUBLE PRECISION) AS ratio,
+           CAST(2 AS DOUBLE PRECISION) AS whole,
+           CAST(0.1 AS FLOAT) AS approx,
+           DATE '2024-02-29' AS d,
+           TIMESTAMP '2024-02-29 13:45:01.0123' AS ts,
+           CAST('1.25' AS DECFLOAT(16)) AS df,
+           CAST('blob text' AS BLOB SUB_TYPE TEXT) AS memo
+    FROM RDB$DATABASE
+)";
+
+} // namespace
+
+TEST_F(JsonStreamWriterTest, MatchesJsonUnpackerMapping) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement(kMixedSql);
+
+    nlohmann::json expected;
+    {
+        auto cur = tx->openCursor(stmt);
+        ASSERT_TRUE(cur->fetch(expected));
+        cur->close();
+    }
+
+    std::ostringstream out;
+    JsonStreamWriter writer(out);
+    auto cur = tx->openCursor(stmt);
+    EXPECT_EQ(cur->writeJson(writer), 1u);
+    cur->close();
+    writer.finish();
+
+    const auto streamed = nlohmann::json::parse(out.str());
+    ASSERT_TRUE(streamed.is_array());
+    ASSERT_EQ(streamed.size(), 1u);
+    EXPECT_EQ(streamed[0], expected);
+    EXPECT_EQ(streamed[0]["NOTE"], "say \"hi\"\n\x01");
+    EXPECT_EQ(streamed[0]["FIXED"], "ab");
+    EXPECT_EQ(streamed[0]["AMOUNT"], "-12.34");
+
+    // Text follows dump()'s number forms
+    const std::string text = out.str();
+    EXPECT_NE(text.find("\"WHOLE\":2.0"), std::string::npos) << text;
+    EXPECT_NE(text.find("\"MISSING\":null"), std::string::npos) << text;
+    EXPECT_NE(text.find("\\u0001"), std::string::npos) << text;
+    tx->Commit();
+}
+
+TEST_F(JsonStreamWriterTest, ArrayRowsInChunks) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement(R"(
+        WITH RECURSIVE r (n) AS (
+            SELECT 1 FROM RDB$DATABASE
+            UNION ALL
+            SELECT n + 1 FROM r WHERE n < 500
+        )
+        SELECT n, 'row ' || n FROM r
+    )");
+
+    std::string text;
+    std::size_t chunks = 0;
+    JsonStreamWriter writer(
+        [&](std::string_view chunk) {
+            ++chunks;
+            text.append(chunk);
+        },
+        JsonRowShape::Array, 1024);
+
+    auto cur = tx->openCursor(stmt);
+    EXPECT_EQ(cur->writeJson(writer, 200), 200u);   // Continues where it stopped
+    EXPECT_EQ(cur->writeJson(writer), 300u);
+    EXPECT_EQ(cur->writeJson(writer), 0u);
+    cur->close();
+    writer.finish();
+    EXPECT_EQ(writer.rowCount(), 500u);
+    EXPECT_GT(chunks, 5u);
+    EXPECT_THROW(writer.writeRow(nullptr, *stmt->getOutputMetadata()), FirebirdException);
+
+    const auto rows = nlohmann::json::parse(text);
+    ASSERT_EQ(rows.size(), 500u);
+    EXPECT_EQ(rows[0], nlohmann::json::array({1, "row 1"}));
+    EXPECT_EQ(rows[499], nlohmann::json::array({500, "row 500"}));
+    tx->Commit();
+}
+
+TEST_F(JsonStreamWriterTest, EmptyResultIsEmptyArray) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement("SELECT 1 FROM RDB$DATABASE WHERE 1 = 0");
+    std::ostringstream out;
+    JsonStreamWriter writer(out);
+    auto cur = tx->openCursor(stmt);
+    EXPECT_EQ(cur->writeJson(writer), 0u);
+    cur->close();
+    writer.finish();
+    EXPECT_EQ(out.str(), "[]");
+    tx->Commit();
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/json_packer.hpp"
+#include "fbpp/core/json_text_packer.hpp"
+#include "fbpp/core/exception.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// JsonTextPacker — raw JSON text packed without a DOM, same value mapping
+// as JsonPacker.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+class JsonTextPackerTest : public TempDatabaseTest {};
+
+namespace {
+
+const char* kParamsSql = R"(
+    SELECT CAST(? AS INTEGER) AS i,
+           CAST(? AS VARCHAR(32)) AS note,
+           CAST(? AS DOUBLE PRECISION) AS ratio,
+           CAST(? AS BOOLEAN) AS flag,
+           CAST(? AS INT128) AS big,
+           CAST(? AS NUMERIC(10,2)) AS amount,
+           CAST(? AS BIGINT) AS id,
+           CAST(? AS DATE) AS d
+    FROM RDB$DATABASE
+)";
+
+std::vector<uint8_t> packDom(const nlohmann::json& params, const MessageMetadata& meta) {
+    std::vector<uint8_t> buffer(meta.getMessageLength());
+    JsonPacker().pack(params, buffer.data(), &meta, nullptr);
+    return buffer;
+}
+
+std::vector<uint8_t> packText(const std::string& text, const MessageMetadata& meta) {
+    std::vector<uint8_t> buffer(meta.getMessageLength(), 0xAB);   // Packer clears it
+    JsonTextPacker::of(meta).pack(text, buffer.data());
+    return buffer;
+}
+
+} // namespace
+
+TEST_F(JsonTextPackerTest, MatchesJsonPackerBytes) {
+    auto stmt = connection_->prepareStatement(kParamsSql);
+    auto meta = stmt->getInputMetadata();
+    ASSERT_TRUE(meta);
+
+    const std::vector<std::string> documents = {
+        R"([7, "say \"hi\"\n", 1.5, true, 123, "-12.34", -9007199254740993, "2024-02-29"])",
+        R"({"0": -1, "1": "café 😀", "2": 2e3, "3": false, "4": -5, "5": 3, "6": 0, "7": null})",
+        R"( { "1" : "only one" } )",
+        R"([null, null, null, null, null, null, null, null])",
+    };
+    for (const auto& text : documents) {
+        SCOPED_TRACE(text);
+        EXPECT_EQ(packText(text, *meta), packDom(nlohmann::json::parse(text), *meta));
+    }
+
+    // Beyond int64 the text is kept exact (the DOM would round it to double)
+    EXPECT_EQ(packText(R"({"4": 170141183460469231731687303715884105727})", *meta),
+              packDom({{"4", "170141183460469231731687303715884105727"}}, *meta));
+}
+
+TEST_F(JsonTextPackerTest, ReportsMalformedInput) {
+    auto stmt = connection_->prepareStatement(kParamsSql);
+    auto meta = stmt->getInputMetadata();
+    const auto& packer = JsonTextPacker::of(*meta);
+    EXPECT_EQ(&packer, &JsonTextPacker::of(*meta));   // Cached on the metadata
+    std::vector<uint8_t> buffer(meta->getMessageLength());
+
+    for (const char* text : {R"({"0": 1,)", R"([1, 2])", R"({"9": 1})", R"({"NOTE": "x"})",
+                             R"({"0": [1]})", R"({"1": "\ud800"})", R"({"0": 1} x)", "42"}) {
+        SCOPED_TRACE(text);
+        EXPECT_THROW(packer.pack(text, buffer.data()), FirebirdException);
+    }
+    try {
+        packer.pack(R"({"0": tru})", buffer.data());
+        FAIL() << "expected an exception";
+    } catch (const FirebirdException& e) {
+        EXPECT_NE(std::string(e.what()).find("offset 6"), std::string::npos) << e.what();
+    }
+}
+
+TEST_F(JsonTextPackerTest, ExecutesWithNamedKeys) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement(
+        "SELECT CAST(:id AS INTEGER) AS a, CAST(:Name AS VARCHAR(20)) AS b, "
+        "CAST(:id AS INTEGER) + 1 AS c FROM RDB$DATABASE");
+
+    auto cur = tx->openCursor(stmt, JsonText{R"({"ID": 41, "name": "x"})"});
+    nlohmann::json row;
+    ASSERT_TRUE(cur->fetch(row));
+    cur->close();
+    EXPECT_EQ(row["A"], 41);
+    EXPECT_EQ(row["B"], "x");
+    EXPECT_EQ(row["C"], 42);
+
+    EXPECT_THROW(tx->openCursor(stmt, JsonText{R"({"id": 1, "nmae": "x"})"}), FirebirdException);
+    tx->Commit();
+}
+
+TEST(JsonTextLinesTest, SplitsNonBlankLines) {
+    const auto lines = splitJsonLines("{\"a\":1}\r\n\n  \n[2]\n{\"c\":3}");
+    ASSERT_EQ(lines.size(), 3u);
+    EXPECT_EQ(lines[0].text, "{\"a\":1}");
+    EXPECT_EQ(lines[1].text, "[2]");
+    EXPECT_EQ(lines[2].text, "{\"c\":3}");
+    EXPECT_TRUE(splitJsonLines("").empty());
+}
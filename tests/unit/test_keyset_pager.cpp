@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/batch.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/schema/keyset_pager.hpp"
+
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// KeysetPager — seek pagination on a composite primary key.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+using fbpp::schema::KeysetPager;
+using fbpp::schema::KeysetPagerOptions;
+
+class KeysetPagerTest : public TempDatabaseTest {
+protected:
+    using Line = std::tuple<int32_t, int32_t, std::string>;
+    using LineKey = std::tuple<int32_t, int32_t>;
+
+    // 5 orders of 5 lines: keys (1,1) .. (5,5)
+    void createTestSchema() override {
+        connection_->ExecuteDDL(
+            "CREATE TABLE order_line (order_id INTEGER NOT NULL, line_no INTEGER NOT NULL,"
+            " note VARCHAR(20), PRIMARY KEY (order_id, line_no))");
+        auto tx = connection_->StartTransaction();
+        auto batch = connection_->prepareStatement("INSERT INTO order_line VALUES (?, ?, ?)")
+                         ->createBatch(tx.get(), false);
+        std::vector<Line> rows;
+        for (int32_t order = 5; order >= 1; --order) {
+            for (int32_t line = 1; line <= 5; ++line) {
+                rows.emplace_back(order, line, std::to_string(order) + "/" + std::to_string(line));
+            }
+        }
+        batch->addMany(rows);
+        batch->execute(tx.get());
+        tx->Commit();
+    }
+
+    static std::vector<LineKey> keys(const std::vector<Line>& page) {
+        std::vector<LineKey> result;
+        for (const auto& [order, line, note] : page) {
+            result.emplace_back(order, line);
+        }
+        return result;
+    }
+};
+
+TEST_F(KeysetPagerTest, WalksForwardAndBackOnThePrimaryKey) {
+    KeysetPagerOptions options;
+    options.select = "order_id, line_no, note";
+    options.pageRows = 7;
+    KeysetPager<Line, LineKey> pager(*connection_, "order_line", options);
+    EXPECT_EQ(pager.plan().key(), (std::vector<std::string>{"ORDER_ID", "LINE_NO"}));
+    EXPECT_NE(pager.plan().afterSql().find("ORDER_ID >= ? AND (ORDER_ID > ? OR "
+                                           "(ORDER_ID = ? AND LINE_NO > ?))"),
+              std::string::npos);
+
+    auto tx = connection_->StartTransaction();
+    std::vector<LineKey> seen;
+    std::vector<size_t> sizes;
+    for (auto page = pager.first(*tx); !page.empty(); page = pager.next(*tx)) {
+        sizes.push_back(page.size());
+        for (const auto& key : keys(page)) {
+            seen.push_back(key);
+        }
+    }
+    EXPECT_EQ(sizes, (std::vector<size_t>{7, 7, 7, 4}));
+    ASSERT_EQ(seen.size(), 25u);
+    for (size_t i = 0; i < seen.size(); ++i) {
+        EXPECT_EQ(seen[i], LineKey(static_cast<int32_t>(i / 5 + 1),
+                                   static_cast<int32_t>(i % 5 + 1)));
+    }
+    // Past the end the pager stays on the last page
+    EXPECT_EQ(pager.firstKey(), LineKey(5, 2));
+    EXPECT_EQ(pager.lastKey(), LineKey(5, 5));
+
+    auto back = pager.prev(*tx);
+    ASSERT_EQ(back.size(), 7u);
+    EXPECT_EQ(keys(back).front(), LineKey(3, 5));
+    EXPECT_EQ(keys(back).back(), LineKey(5, 1));
+    EXPECT_EQ(pager.firstKey(), LineKey(3, 5));
+
+    auto end = pager.last(*tx);
+    ASSERT_EQ(end.size(), 7u);
+    EXPECT_EQ(keys(end).front(), LineKey(4, 4));
+    EXPECT_EQ(std::get<2>(end.back()), "5/5");
+
+    auto from = pager.after(*tx, LineKey(2, 5));
+    EXPECT_EQ(keys(from).front(), LineKey(3, 1));
+    tx->Commit();
+}
+
+TEST_F(KeysetPagerTest, FilterAndExplicitKey) {
+    KeysetPagerOptions options;
+    options.where = "line_no = 1";
+    options.key = {"order_id"};
+    options.pageRows = 2;
+    KeysetPager<Line, std::tuple<int32_t>> pager(*connection_, "ORDER_LINE", options);
+
+    auto tx = connection_->StartTransaction();
+    auto page = pager.next(*tx);
+    ASSERT_EQ(page.size(), 2u);
+    page = pager.next(*tx);
+    ASSERT_EQ(page.size(), 2u);
+    EXPECT_EQ(std::get<0>(page.front()), 3);
+    EXPECT_EQ(std::get<1>(page.front()), 1);
+    EXPECT_EQ(pager.next(*tx).size(), 1u);
+    EXPECT_TRUE(pager.next(*tx).empty());
+    tx->Commit();
+}
+
+TEST_F(KeysetPagerTest, RejectsMismatchedKeys) {
+    using Wide = KeysetPager<Line, std::tuple<int32_t>>;
+    EXPECT_THROW(Wide(*connection_, "order_line"), FirebirdException);
+
+    KeysetPagerOptions narrow;
+    narrow.select = "note";
+    EXPECT_THROW((KeysetPager<std::tuple<std::string>, LineKey>(*connection_, "order_line",
+                                                                 narrow)),
+                 FirebirdException);
+    EXPECT_THROW((KeysetPager<Line, LineKey>(*connection_, "no_such_table")), FirebirdException);
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/batch.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/memory_usage.hpp"
+#include "fbpp/core/result_arena.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Connection::memoryUsage() — per-connection client memory, server memory
+// and ConnectionOptions::memorySoftLimit.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+TEST(MemoryChargeTest, FollowsSetAndReleasesOnDestruction) {
+    auto account = std::make_shared<detail::MemoryAccount>();
+    {
+        detail::MemoryCharge charge;
+        charge.set(100);   // Unattached: ignored
+        charge.attach(account, detail::MemoryAccount::batches, 64);
+        EXPECT_EQ(account->objects(detail::MemoryAccount::batches), 1u);
+        EXPECT_EQ(account->bytes(detail::MemoryAccount::batches), 64u);
+        charge.set(256);
+        charge.set(128);
+        EXPECT_EQ(account->bytes(detail::MemoryAccount::batches), 128u);
+
+        detail::MemoryCharge moved = std::move(charge);
+        EXPECT_EQ(account->objects(detail::MemoryAccount::batches), 1u);
+        EXPECT_EQ(account->bytes(detail::MemoryAccount::batches), 128u);
+    }
+    EXPECT_EQ(account->objects(detail::MemoryAccount::batches), 0u);
+    EXPECT_EQ(account->bytes(detail::MemoryAccount::batches), 0u);
+}
+
+class MemoryUsageTest : public TempDatabaseTest {
+protected:
+    void createTestSchema() override {
+        connection_->ExecuteDDL("CREATE TABLE item (id INTEGER NOT NULL PRIMARY KEY, "
+                                "name VARCHAR(100))");
+        auto tx = connection_->StartTransaction();
+        std::vector<std::tuple<int32_t, std::string>> rows;
+        for (int32_t i = 1; i <= 200; ++i) {
+            rows.emplace_back(i, "item " + std::to_string(i));
+        }
+        auto batch = connection_->prepareStatement("INSERT INTO item VALUES (?, ?)")
+                         ->createBatch(tx.get(), false);
+        batch->addMany(rows);
+        batch->execute(tx.get());
+        tx->Commit();
+    }
+};
+
+TEST_F(MemoryUsageTest, ChargesCursorsBatchesAndArenas) {
+    auto tx = connection_->StartTransaction();
+    {
+        auto rs = tx->openCursor(connection_->prepareStatement("SELECT id, name FROM item"));
+        auto arena = std::make_shared<ResultArena>();
+        rs->setArena(arena);
+        std::vector<Row> rows;
+        rs->fetchRows(rows);
+        ASSERT_EQ(rows.size(), 200u);
+
+        const auto usage = connection_->memoryUsage(false);
+        EXPECT_EQ(usage.resultSets, 1u);
+        EXPECT_GT(usage.resultSetBytes, 0u);
+        EXPECT_EQ(usage.arenas, 1u);
+        EXPECT_GE(usage.arenaBytes, arena->bytesReserved());
+        rs->close();
+    }
+    auto usage = connection_->memoryUsage(false);
+    EXPECT_EQ(usage.resultSets, 0u);
+    EXPECT_EQ(usage.arenas, 0u);
+    EXPECT_EQ(usage.arenaBytes, 0u);
+
+    {
+        auto batch = connection_->prepareStatement("UPDATE item SET name = ? WHERE id = ?")
+                         ->createBatch(tx.get(), false);
+        batch->addMany(std::vector<std::tuple<std::string, int32_t>>{{"x", 1}, {"y", 2}});
+        usage = connection_->memoryUsage(false);
+        EXPECT_EQ(usage.batches, 1u);
+        EXPECT_GT(usage.batchBytes, 0u);
+    }
+    EXPECT_EQ(connection_->memoryUsage(false).batches, 0u);
+    tx->Rollback();
+}
+
+TEST_F(MemoryUsageTest, ReportsCacheAndServerMemory) {
+    connection_->prepareStatement("SELECT id, name FROM item WHERE id = ?");
+    connection_->prepareStatement("SELECT COUNT(*) FROM item");
+
+    const auto usage = connection_->memoryUsage();
+    EXPECT_GE(usage.cachedStatements, 2u);
+    EXPECT_GE(usage.idleStatements, 2u);
+    EXPECT_GT(usage.statementCacheBytes, 0u);
+    EXPECT_GE(usage.clientBytes(), usage.statementCacheBytes);
+    ASSERT_TRUE(usage.serverCurrentMemory.has_value());
+    ASSERT_TRUE(usage.serverMaxMemory.has_value());
+    EXPECT_GT(*usage.serverCurrentMemory, 0u);
+    EXPECT_GE(*usage.serverMaxMemory, *usage.serverCurrentMemory);
+}
+
+TEST_F(MemoryUsageTest, SoftLimitShrinksStatementCache) {
+    ConnectionOptions options = connection_->getOptions();
+    options.memorySoftLimit = 1;
+    connection_->setOptions(options);
+
+    for (int i = 0; i < 70; ++i) {
+        connection_->prepareStatement("SELECT name FROM item WHERE id = " + std::to_string(i));
+    }
+    const auto usage = connection_->memoryUsage(false);
+    EXPECT_GE(usage.softLimitShrinks, 1u);
+    EXPECT_LT(usage.cachedStatements, 70u);
+}
@@ -146,6 +146,24 @@ TEST_F(MessageMetadataTest, LiteralColumnsDisambiguatedByAlias) {
     EXPECT_EQ(*i_new, 1u);
 }
 
+TEST_F(MessageMetadataTest, SortedLookupKeepsFirstIndexAndPassOrder) {
+    auto stmt = connection_->prepareStatement(
+        "SELECT 1 AS a, 2 AS \"a\", 3 AS b, 4 AS a FROM RDB$DATABASE");
+    auto meta = stmt->getOutputMetadata();
+    ASSERT_TRUE(meta);
+    ASSERT_EQ(meta->getCount(), 4u);
+
+    EXPECT_EQ(meta->getIndex("A"), std::optional<unsigned>(0));          // First of two "A"
+    EXPECT_EQ(meta->getIndex("a"), std::optional<unsigned>(1));          // Exact pass first
+    EXPECT_EQ(meta->getIndex(" b "), std::optional<unsigned>(2));
+    EXPECT_EQ(meta->getIndex("CONSTANT"), std::optional<unsigned>(0));   // Shared raw name
+    EXPECT_EQ(meta->getField("b")->alias, "B");
+
+    // Lookups longer than the stack buffer take the allocating path
+    EXPECT_FALSE(meta->getIndex(std::string(70, 'x')).has_value());
+    EXPECT_EQ(meta->getIndex(std::string(70, ' ') + "b"), std::optional<unsigned>(2));
+}
+
 // ----------------------------------------------------------------------------
 // Quoted identifier preservation (exact-pass wins)
 // ----------------------------------------------------------------------------
@@ -175,3 +193,44 @@ TEST_F(MessageMetadataTest, QuotedIdentifierPreservesCase) {
     ASSERT_TRUE(folded.has_value());
     EXPECT_EQ(folded->name, "MyCol");
 }
+
+// ----------------------------------------------------------------------------
+// Column plan (string-free per-column layout for hot paths)
+// ----------------------------------------------------------------------------
+
+TEST_F(MessageMetadataTest, ColumnPlanMirrorsFieldInfo) {
+    auto stmt = connection_->prepareStatement(
+        "SELECT id, name, amount FROM test_table");
+    auto meta = stmt->getOutputMetadata();
+    ASSERT_TRUE(meta);
+
+    const auto& plan = meta->getColumnPlan();
+    ASSERT_EQ(plan.size(), meta->getCount());
+
+    for (unsigned i = 0; i < plan.size(); ++i) {
+        const FieldInfo fi = meta->getField(i);
+        EXPECT_EQ(plan[i].type, fi.type);
+        EXPECT_EQ(plan[i].subType, fi.subType);
+        EXPECT_EQ(plan[i].length, fi.length);
+        EXPECT_EQ(plan[i].scale, fi.scale);
+        EXPECT_EQ(plan[i].charSet, fi.charSet);
+        EXPECT_EQ(plan[i].offset, meta->getOffset(i));
+        EXPECT_EQ(plan[i].nullOffset, meta->getNullOffset(i));
+        EXPECT_EQ(plan[i].nullable, fi.nullable);
+        ASSERT_NE(plan[i].field, nullptr);
+        EXPECT_EQ(plan[i].field, &meta->getFieldRef(i));
+    }
+}
+
+TEST_F(MessageMetadataTest, ColumnPlanIsStableAcrossCalls) {
+    auto stmt = connection_->prepareStatement(
+        "SELECT id, name FROM test_table");
+    auto meta = stmt->getOutputMetadata();
+    ASSERT_TRUE(meta);
+
+    const auto* first = &meta->getColumnPlan();
+    const auto* second = &meta->getColumnPlan();
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(&meta->getFieldRef(1), &meta->getFieldRef(1));
+    EXPECT_THROW(meta->getFieldRef(2), FirebirdException);
+}
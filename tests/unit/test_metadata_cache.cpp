@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/schema/metadata_cache.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace fbpp::test;
+using namespace fbpp::schema;
+
+// MetadataCache — describe results persisted and validated by fingerprint.
+
+class MetadataCacheTest : public TempDatabaseTest {
+protected:
+    void SetUp() override {
+        TempDatabaseTest::SetUp();
+        path_ = (std::filesystem::temp_directory_path() /
+                 ("fbpp_metadata_cache_" + std::to_string(getCurrentProcessId()) + ".json")).string();
+        std::filesystem::remove(path_);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(path_);
+        TempDatabaseTest::TearDown();
+    }
+
+    void createTestSchema() override {
+        TempDatabaseTest::createTestSchema();
+        connection_->ExecuteDDL(
+            "CREATE TABLE mdc_item (id INTEGER NOT NULL PRIMARY KEY, title VARCHAR(40))");
+        connection_->ExecuteDDL(
+            "CREATE PROCEDURE mdc_double (x INTEGER) RETURNS (y INTEGER)"
+            " AS BEGIN y = x * 2; SUSPEND; END");
+    }
+
+    static constexpr const char* kQuery = "SELECT id, title FROM mdc_item WHERE id = ?";
+    std::string path_;
+};
+
+TEST_F(MetadataCacheTest, WarmStartServesEverythingFromDisk) {
+    {
+        MetadataCache cold(*connection_, path_);
+        EXPECT_FALSE(cold.stats().warm);
+        cold.describeQuery(kQuery);
+        cold.listProcedures();
+        cold.describeProcedure("MDC_DOUBLE");
+        cold.getAllTables();
+        EXPECT_EQ(cold.stats().misses, 4u);
+        cold.save();
+    }
+    ASSERT_TRUE(std::filesystem::exists(path_));
+
+    MetadataCache warm(*connection_, path_);
+    EXPECT_TRUE(warm.stats().warm);
+    const auto cached = warm.describeQuery("select ID, TITLE  from MDC_ITEM where ID = ?");
+    const auto live = connection_->describeQuery(kQuery);
+    ASSERT_EQ(cached.outputFields.size(), live.outputFields.size());
+    EXPECT_EQ(cached.outputFields[1].alias, live.outputFields[1].alias);
+    EXPECT_EQ(cached.outputFields[1].length, live.outputFields[1].length);
+    EXPECT_EQ(cached.inputFields.size(), 1u);
+
+    const auto proc = warm.describeProcedure("MDC_DOUBLE");
+    EXPECT_EQ(proc.kind, fbpp::core::ProcedureKind::Selectable);
+    ASSERT_EQ(proc.params.size(), 2u);
+    EXPECT_EQ(proc.params[1].name, "Y");
+
+    const auto tables = warm.getAllTables();
+    EXPECT_NE(std::find_if(tables.begin(), tables.end(),
+                           [](const TableInfo& t) { return t.name == "MDC_ITEM"; }),
+              tables.end());
+    warm.listProcedures();
+    EXPECT_EQ(warm.stats().hits, 4u);
+    EXPECT_EQ(warm.stats().misses, 0u);
+}
+
+TEST_F(MetadataCacheTest, SchemaChangeInvalidates) {
+    const auto before = MetadataCache::schemaFingerprint(*connection_);
+    EXPECT_EQ(MetadataCache::schemaFingerprint(*connection_), before);   // Stable
+    {
+        MetadataCache cache(*connection_, path_);
+        cache.describeQuery(kQuery);
+        cache.save();
+    }
+
+    connection_->ExecuteDDL("ALTER TABLE mdc_item ADD note VARCHAR(10)");
+    EXPECT_NE(MetadataCache::schemaFingerprint(*connection_), before);
+
+    MetadataCache cache(*connection_, path_);
+    EXPECT_FALSE(cache.stats().warm);
+    EXPECT_EQ(cache.describeQuery("SELECT * FROM mdc_item").outputFields.size(), 3u);
+    EXPECT_FALSE(cache.revalidate());
+
+    connection_->ExecuteDDL("CREATE INDEX mdc_item_title ON mdc_item (title)");
+    EXPECT_TRUE(cache.revalidate());
+    cache.describeQuery(kQuery);
+    EXPECT_EQ(cache.stats().hits, 0u);
+}
+
+TEST_F(MetadataCacheTest, DamagedFileMeansColdStart) {
+    {
+        std::ofstream out(path_, std::ios::binary);
+        out << "{ not json";
+    }
+    MetadataCache cache(*connection_, path_);
+    EXPECT_FALSE(cache.stats().warm);
+    cache.describeQuery(kQuery);
+    cache.save();
+    EXPECT_TRUE(MetadataCache(*connection_, path_).stats().warm);
+}
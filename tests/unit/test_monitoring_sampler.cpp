@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/monitoring_sampler.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <tuple>
+
+// MonitoringSampler: MON$ counter deltas per fingerprint and correlation with
+// the client-side statement metrics of another connection.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr const char* kQuery = "SELECT COUNT(*) FROM RDB$RELATIONS r JOIN RDB$FIELDS f ON 1 = 1";
+
+MonitoringSamplerOptions manualOptions() {
+    MonitoringSamplerOptions options;
+    options.interval = 0ms;   // Tests call sample()
+    options.traceLevel.reset();
+    return options;
+}
+
+const MonitoredStatement* findEntry(const MonitoringSample& sample, uint64_t fingerprint) {
+    for (const auto& entry : sample.topByReads) {
+        if (entry.fingerprint == fingerprint) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+class MonitoringSamplerTest : public TempDatabaseTest {
+protected:
+    void SetUp() override {
+        TempDatabaseTest::SetUp();
+        ConnectionParams params = db_params_;
+        params.options.statementCache.collectMetrics = true;
+        app_ = std::make_unique<Connection>(params);
+    }
+
+    void TearDown() override {
+        app_.reset();
+        TempDatabaseTest::TearDown();
+    }
+
+    // Runs kQuery on the app connection; the statement stays prepared in its cache
+    uint64_t runQuery() {
+        auto stmt = app_->prepareStatement(kQuery);
+        auto tx = app_->StartTransaction();
+        auto cursor = tx->openCursor(stmt);
+        std::tuple<int64_t> row;
+        EXPECT_TRUE(cursor->fetch(row));
+        cursor->close();
+        tx->Commit();
+        return stmt->getFingerprint();
+    }
+
+    std::unique_ptr<Connection> app_;
+};
+
+TEST_F(MonitoringSamplerTest, ReportsCounterDeltasPerFingerprint) {
+    MonitoringSampler sampler(db_params_, manualOptions());
+    sampler.addMetricsSource(*app_);
+    const uint64_t fingerprint = runQuery();
+
+    const auto first = sampler.sample();
+    EXPECT_GE(first.attachments, 1u);
+    const MonitoredStatement* entry = findEntry(first, fingerprint);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->sql, kQuery);
+    EXPECT_GT(entry->pageFetches, 0u);
+    ASSERT_TRUE(entry->client.has_value());
+    EXPECT_GE(entry->client->useCount, 1u);
+
+    // Nothing ran in between: no growth, so not among the top readers
+    const auto idle = sampler.sample();
+    EXPECT_EQ(findEntry(idle, fingerprint), nullptr);
+
+    runQuery();
+    const auto again = sampler.sample();
+    entry = findEntry(again, fingerprint);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_GT(entry->pageFetches, 0u);
+
+    ASSERT_TRUE(sampler.latest().has_value());
+    EXPECT_EQ(sampler.latest()->taken, again.taken);
+}
+
+TEST_F(MonitoringSamplerTest, SamplesOnItsOwnThread) {
+    auto options = manualOptions();
+    options.interval = 50ms;
+    MonitoringSampler sampler(db_params_, options);
+    for (int i = 0; i < 100 && !sampler.latest(); ++i) {
+        std::this_thread::sleep_for(20ms);
+    }
+    EXPECT_TRUE(sampler.latest().has_value());
+    sampler.stop();
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/batch.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/multi_get.hpp"
+#include "fbpp/core/named_param_parser.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// MultiGet — bucketed IN-lists and GTT key table, rows demultiplexed per key.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+TEST(NamedParamReplaceTest, ReplacesMarkersOutsideLiterals) {
+    EXPECT_EQ(NamedParamParser::replaceParam(
+                  "SELECT ':ids' FROM t WHERE id IN (:IDS) -- :ids", "ids", "SELECT k FROM q"),
+              "SELECT ':ids' FROM t WHERE id IN (SELECT k FROM q) -- :ids");
+}
+
+class MultiGetTest : public TempDatabaseTest {
+protected:
+    static constexpr int32_t kRows = 3000;
+
+    void createTestSchema() override {
+        connection_->ExecuteDDL(
+            "CREATE TABLE mg (id INTEGER NOT NULL PRIMARY KEY, code VARCHAR(10), owner INTEGER)");
+        auto tx = connection_->StartTransaction();
+        std::vector<std::tuple<int32_t, std::string, int32_t>> rows;
+        for (int32_t i = 1; i <= kRows; ++i) {
+            rows.emplace_back(i, "c" + std::to_string(i), i % 10);
+        }
+        auto batch = connection_->prepareStatement("INSERT INTO mg VALUES (?, ?, ?)")
+                         ->createBatch(tx.get(), false);
+        batch->addMany(rows);
+        batch->execute(tx.get());
+        tx->Commit();
+    }
+};
+
+TEST_F(MultiGetTest, InListChunksDemultiplexPerKey) {
+    MultiGetOptions options;
+    options.strategy = MultiGetStrategy::inList;
+    options.maxInList = 100;   // Rounded down to 64
+    MultiGet lookup(*connection_, "SELECT id, code FROM mg WHERE id IN (:ids)", "ids", options);
+
+    std::vector<int32_t> keys;
+    for (int32_t i = 1; i <= 150; ++i) {
+        keys.push_back(i * 7);
+    }
+    keys.push_back(7);                 // Duplicate
+    keys.push_back(kRows + 1);         // Missing
+
+    auto tx = connection_->StartTransaction();
+    const auto rows = lookup.fetch(*tx, keys);
+    ASSERT_EQ(rows.size(), keys.size());
+    for (std::size_t i = 0; i < 150; ++i) {
+        ASSERT_EQ(rows[i].size(), 1u);
+        EXPECT_EQ(rows[i][0].get<std::string>(1).value(), "c" + std::to_string(keys[i]));
+    }
+    ASSERT_EQ(rows[150].size(), 1u);
+    EXPECT_EQ(rows[150][0].get<int32_t>(0).value(), 7);
+    EXPECT_TRUE(rows[151].empty());
+
+    const auto& stats = lookup.lastStats();
+    EXPECT_EQ(stats.strategy, MultiGetStrategy::inList);
+    EXPECT_EQ(stats.distinctKeys, 151u);
+    EXPECT_EQ(stats.roundTrips, 3u);
+    EXPECT_EQ(stats.rows, 150u);
+    tx->Commit();
+}
+
+TEST_F(MultiGetTest, KeyTableJoinsAndMatchesByKeyColumn) {
+    MultiGetOptions options;
+    options.keyTableThreshold = 16;
+    options.keyColumn = "OWNER";
+    MultiGet lookup(*connection_, "SELECT id, owner FROM mg WHERE owner IN (:owners)", "owners",
+                    options);
+
+    std::vector<int64_t> owners;
+    for (int64_t i = 0; i < 40; ++i) {
+        owners.push_back(i);           // Only 0..9 exist
+    }
+
+    auto tx = connection_->StartTransaction();
+    std::vector<std::size_t> perKey(owners.size(), 0);
+    lookup.each<int64_t>(*tx, owners, [&](std::size_t index, const RowView& row) {
+        EXPECT_EQ(row.get<int32_t>(1).value(), owners[index]);
+        ++perKey[index];
+    });
+    const auto& stats = lookup.lastStats();
+    EXPECT_EQ(stats.strategy, MultiGetStrategy::keyTable);
+    EXPECT_EQ(stats.roundTrips, 2u);
+    EXPECT_EQ(stats.rows, static_cast<std::size_t>(kRows));
+    EXPECT_EQ(perKey[3], static_cast<std::size_t>(kRows / 10));
+    EXPECT_EQ(perKey[10], 0u);
+
+    // A second call in the same transaction sees only its own keys
+    options.strategy = MultiGetStrategy::keyTable;
+    MultiGet single(*connection_, "SELECT id, owner FROM mg WHERE owner IN (:owners)", "owners",
+                    options);
+    const auto again = single.fetch(*tx, std::vector<int64_t>{1});
+    EXPECT_EQ(single.lastStats().rows, static_cast<std::size_t>(kRows / 10));
+    EXPECT_EQ(again[0].size(), static_cast<std::size_t>(kRows / 10));
+    tx->Commit();
+}
+
+TEST_F(MultiGetTest, StringKeysThroughTheKeyTable) {
+    MultiGetOptions options;
+    options.strategy = MultiGetStrategy::keyTable;
+    options.keyColumn = "CODE";
+    MultiGet lookup(*connection_, "SELECT id, code FROM mg WHERE code IN (:codes)", "codes",
+                    options);
+    auto tx = connection_->StartTransaction();
+    const auto rows = lookup.fetch(*tx, std::vector<std::string>{"c5", "nope", "c2999"});
+    ASSERT_EQ(rows[0].size(), 1u);
+    EXPECT_EQ(rows[0][0].get<int32_t>(0).value(), 5);
+    EXPECT_TRUE(rows[1].empty());
+    EXPECT_EQ(rows[2][0].get<int32_t>(0).value(), 2999);
+    tx->Commit();
+}
+
+TEST_F(MultiGetTest, MissingListParameterThrows) {
+    MultiGet lookup(*connection_, "SELECT id FROM mg WHERE id = 1", "ids");
+    auto tx = connection_->StartTransaction();
+    EXPECT_THROW(lookup.fetch(*tx, std::vector<int32_t>{1}), FirebirdException);
+    tx->Rollback();
+}
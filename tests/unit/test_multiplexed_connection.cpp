@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/multiplexed_connection.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// MultiplexedConnection: many threads over one attachment, grouped
+// autocommit writes and per-write errors after a failed group.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+class MultiplexedConnectionTest : public TempDatabaseTest {
+protected:
+    void SetUp() override {
+        TempDatabaseTest::SetUp();
+        connection_->ExecuteDDL("CREATE TABLE mux_item (id INTEGER NOT NULL PRIMARY KEY, "
+                                "owner INTEGER NOT NULL)");
+    }
+
+    int64_t count() {
+        auto tx = connection_->StartTransaction();
+        auto stmt = connection_->prepareStatement("SELECT COUNT(*) FROM mux_item");
+        auto cursor = tx->openCursor(stmt);
+        std::tuple<int64_t> row{0};
+        cursor->fetch(row);
+        cursor->close();
+        tx->Commit();
+        return std::get<0>(row);
+    }
+};
+
+TEST_F(MultiplexedConnectionTest, ThreadsShareOneAttachment) {
+    MultiplexedConnection db(db_params_);
+    constexpr int kThreads = 8;
+    constexpr int kWrites = 25;
+
+    std::vector<std::thread> threads;
+    std::set<int64_t> attachments;
+    std::mutex attachmentsMutex;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < kWrites; ++i) {
+                EXPECT_EQ(db.execute("INSERT INTO mux_item (id, owner) VALUES (?, ?)",
+                                     std::make_tuple(t * kWrites + i, t)),
+                          1u);
+            }
+            auto rows = db.query<std::tuple<int64_t>>(
+                "SELECT CURRENT_CONNECTION FROM RDB$DATABASE");
+            ASSERT_EQ(rows.size(), 1u);
+            std::lock_guard<std::mutex> lock(attachmentsMutex);
+            attachments.insert(std::get<0>(rows[0]));
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(attachments.size(), 1u);
+    EXPECT_EQ(count(), kThreads * kWrites);
+    const auto stats = db.stats();
+    EXPECT_EQ(stats.requests, static_cast<uint64_t>(kThreads * (kWrites + 1)));
+    EXPECT_LE(stats.wakeups, stats.requests);
+}
+
+TEST_F(MultiplexedConnectionTest, QueuedWritesCommitTogether) {
+    MultiplexedConnection db(db_params_);
+    // Hold the I/O thread so the writes pile up behind it
+    std::promise<void> release;
+    auto gate = db.submit([held = release.get_future().share()](Connection&) { held.wait(); });
+
+    std::vector<std::future<unsigned>> writes;
+    for (int i = 0; i < 10; ++i) {
+        writes.push_back(std::async(std::launch::async, [&db, i] {
+            return db.execute("INSERT INTO mux_item (id, owner) VALUES (?, 0)",
+                              std::make_tuple(i));
+        }));
+    }
+    while (db.stats().requests < 11) {
+        std::this_thread::yield();
+    }
+    release.set_value();
+    gate.get();
+    for (auto& write : writes) {
+        EXPECT_EQ(write.get(), 1u);
+    }
+
+    const auto stats = db.stats();
+    EXPECT_EQ(stats.groups, 1u);
+    EXPECT_EQ(stats.groupedWrites, 10u);
+    EXPECT_EQ(count(), 10);
+}
+
+TEST_F(MultiplexedConnectionTest, FailedGroupReportsOnlyTheBadWrite) {
+    MultiplexedConnection db(db_params_);
+    std::promise<void> release;
+    auto gate = db.submit([held = release.get_future().share()](Connection&) { held.wait(); });
+
+    // Ids 0, 1, 1, 2: the second 1 violates the primary key
+    std::vector<std::future<unsigned>> writes;
+    for (int id : {0, 1, 1, 2}) {
+        writes.push_back(std::async(std::launch::async, [&db, id] {
+            return db.execute("INSERT INTO mux_item (id, owner) VALUES (?, 0)",
+                              std::make_tuple(id));
+        }));
+        while (db.stats().requests < writes.size() + 1) {
+            std::this_thread::yield();   // Keep queue order = id order
+        }
+    }
+    release.set_value();
+    gate.get();
+
+    EXPECT_EQ(writes[0].get(), 1u);
+    EXPECT_EQ(writes[1].get(), 1u);
+    EXPECT_THROW(writes[2].get(), FirebirdException);
+    EXPECT_EQ(writes[3].get(), 1u);
+    EXPECT_EQ(db.stats().groupRetries, 1u);
+    EXPECT_EQ(count(), 3);
+}
+
+TEST_F(MultiplexedConnectionTest, RunRethrows) {
+    MultiplexedConnection db(db_params_);
+    EXPECT_EQ(db.run([](Connection& conn) { return conn.getEngineMajorVersion() > 0; }), true);
+    EXPECT_THROW(db.run([](Connection& conn) { conn.prepareStatement("SELECT * FROM nowhere"); }),
+                 FirebirdException);
+}
@@ -2,6 +2,8 @@
 #include "../test_base.hpp"
 #include "fbpp/core/named_param_parser.hpp"
 #include "fbpp/core/named_param_helper.hpp"
+#include "fbpp/core/param_binder.hpp"
+#include "fbpp/core/sql_literal.hpp"
 #include "fbpp/core/connection.hpp"
 #include "fbpp/core/transaction.hpp"
 #include "fbpp/core/statement.hpp"
@@ -186,6 +188,66 @@ TEST_F(NamedParametersTest, CaseInsensitiveParams) {
     EXPECT_TRUE(result.nameToPositions.find("userid") != result.nameToPositions.end());
 }
 
+// Test a long generated call: linear pass, positions and offsets intact
+TEST_F(NamedParametersTest, ParseLongGeneratedCall) {
+    std::string sql = "EXECUTE PROCEDURE big_proc(";
+    std::string expected = sql;
+    std::vector<size_t> offsets;
+    for (int i = 0; i < 200; ++i) {
+        if (i != 0) {
+            sql += ", ";
+            expected += ", ";
+        }
+        offsets.push_back(sql.size());
+        sql += ":P" + std::to_string(i) + " /* 'p" + std::to_string(i) + "' */";
+        expected += "? /* 'p" + std::to_string(i) + "' */";
+    }
+    sql += ", ':not_a_param', :p0)";
+    expected += ", ':not_a_param', ?)";
+
+    auto result = NamedParamParser::parse(sql);
+    EXPECT_EQ(result.convertedSql, expected);
+    ASSERT_EQ(result.parameters.size(), 201u);
+    EXPECT_EQ(result.parameters[57].name, "p57");
+    EXPECT_EQ(result.parameters[57].position, 57u);
+    EXPECT_EQ(result.parameters[57].sqlOffset, offsets[57]);
+    EXPECT_EQ(result.nameToPositions.at("p0"), (std::vector<size_t>{0, 200}));
+}
+
+// Test memoized parsing returns one shared result per text
+TEST_F(NamedParametersTest, ParseCachedSharesResult) {
+    const std::string sql = "SELECT * FROM users WHERE id = :cached_id";
+    auto first = NamedParamParser::parseCached(sql);
+    auto second = NamedParamParser::parseCached(std::string(sql));
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(first->convertedSql, "SELECT * FROM users WHERE id = ?");
+
+    auto other = NamedParamParser::parseCached(sql + " ");
+    EXPECT_NE(other, first);   // Exact text, not the normalized cache key
+}
+
+// Test list expansion into bucketed placeholder shapes
+TEST_F(NamedParametersTest, ExpandListToBucketedShape) {
+    EXPECT_EQ(NamedParamParser::listBucket(0), 1u);
+    EXPECT_EQ(NamedParamParser::listBucket(1), 1u);
+    EXPECT_EQ(NamedParamParser::listBucket(3), 4u);
+    EXPECT_EQ(NamedParamParser::listBucket(1000), 1024u);
+
+    const std::string sql =
+        "SELECT * FROM t WHERE id IN (:IDS) AND note <> ':ids' /* :ids */ AND x = :ids_x";
+    EXPECT_EQ(NamedParamParser::expandList(sql, "ids", 3),
+              "SELECT * FROM t WHERE id IN (:ids__0, :ids__1, :ids__2, :ids__3)"
+              " AND note <> ':ids' /* :ids */ AND x = :ids_x");
+    EXPECT_EQ(NamedParamParser::expandList(sql, "ids", 4),
+              NamedParamParser::expandList(sql, "ids", 3));   // Same shape, same cache key
+    EXPECT_EQ(NamedParamParser::expandList(sql, "other", 3), sql);
+
+    auto parsed = NamedParamParser::parse(NamedParamParser::expandList(sql, "ids", 2));
+    EXPECT_EQ(parsed.nameToPositions.at("ids__1"), (std::vector<size_t>{1}));
+    EXPECT_EQ(parsed.nameToPositions.at("ids_x"), (std::vector<size_t>{2}));
+}
+
 // Test NamedParamHelper JSON conversion
 TEST_F(NamedParametersTest, ConvertJsonToPositional) {
     std::unordered_map<std::string, std::vector<size_t>> mapping = {
@@ -334,6 +396,69 @@ TEST_F(NamedParametersDbTest, StatementNamedParamGetters) {
     }
 }
 
+// sql<"..."> parses at compile time exactly as NamedParamParser::parse does
+TEST_F(NamedParametersTest, CompileTimeLiteralMatchesRuntimeParse) {
+    constexpr auto literal = sql<"SELECT * FROM users /* :skip */ WHERE id = :Id "
+                                 "AND name = 'a:b' AND x = ? AND owner = @ID -- :tail\n">;
+    static_assert(literal.positionalSql() ==
+                  "SELECT * FROM users /* :skip */ WHERE id = ? "
+                  "AND name = 'a:b' AND x = ? AND owner = ? -- :tail\n");
+    static_assert(literal.parameterCount == 3);
+    static_assert(literal.positions<"id">.size() == 2);
+    static_assert(literal.positions<"ID">[1] == 2);
+
+    const std::string text(literal.text());
+    const auto runtime = NamedParamParser::parse(text);
+    EXPECT_EQ(std::string(literal.positionalSql()), runtime.convertedSql);
+    EXPECT_EQ(literal.hash, SqlKey::hashOf(text, Statement::PREPARE_DEFAULT));
+
+    const SqlKey& key = literal;
+    EXPECT_EQ(&key, &literal.key());   // Built once
+    EXPECT_EQ(key.sql(), text);
+    EXPECT_EQ(key.hash(), SqlKey(text).hash());
+    ASSERT_NE(key.parsed(), nullptr);
+    EXPECT_EQ(key.parsed()->convertedSql, runtime.convertedSql);
+    EXPECT_EQ(key.parsed()->nameToPositions, runtime.nameToPositions);
+    ASSERT_EQ(key.parsed()->parameters.size(), runtime.parameters.size());
+    for (size_t i = 0; i < runtime.parameters.size(); ++i) {
+        EXPECT_EQ(key.parsed()->parameters[i].name, runtime.parameters[i].name);
+        EXPECT_EQ(key.parsed()->parameters[i].position, runtime.parameters[i].position);
+        EXPECT_EQ(key.parsed()->parameters[i].sqlOffset, runtime.parameters[i].sqlOffset);
+    }
+
+    constexpr auto positional = sql<"SELECT 1 FROM rdb$database WHERE ? = 1">;
+    static_assert(!positional.hasNamedParams && positional.parameterCount == 1);
+}
+
+TEST_F(NamedParametersDbTest, CompileTimeLiteralPreparesAndBinds) {
+    constexpr auto insert = sql<"INSERT INTO test_named_params (id, name, status) "
+                                "VALUES (:id, :name, :status)">;
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement(insert);
+    EXPECT_TRUE(stmt->hasNamedParameters());
+    EXPECT_EQ(stmt->getSql(), insert.positionalSql());
+
+    auto& binder = stmt->binder(tx.get());
+    EXPECT_TRUE(binder.set(insert.positions<"id">, int32_t{7}));
+    EXPECT_TRUE(binder.set(insert.positions<"name">, std::string("seven")));
+    EXPECT_TRUE(binder.setNull(insert.positions<"status">));
+    EXPECT_EQ(tx->execute(stmt, binder), 1u);
+
+    // The same text as a string shares the cache entry
+    auto again = connection_->prepareStatement(std::string(insert.text()));
+    EXPECT_EQ(again->getSql(), stmt->getSql());
+
+    auto select = connection_->prepareStatement(
+        sql<"SELECT name, status FROM test_named_params WHERE id = :id">);
+    auto cursor = tx->openCursor(select, std::make_tuple(int32_t{7}));
+    std::tuple<std::string, std::optional<std::string>> row;
+    ASSERT_TRUE(cursor->fetch(row));
+    EXPECT_EQ(std::get<0>(row), "seven");
+    EXPECT_FALSE(std::get<1>(row).has_value());
+    cursor->close();
+    tx->Commit();
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/detail/conversion_utils.hpp"
+#include "fbpp/core/detail/sql_value_codec.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+
+// Number <-> text in the codec: std::to_chars / std::from_chars for
+// integers and shortest round-trip floating point, scaled integers, and
+// the exponent expansion of DECFLOAT text.
+
+using namespace fbpp::core;
+using namespace fbpp::core::detail;
+using fbpp::core::detail::sql_value_codec::assign_plain_decimal;
+using fbpp::core::detail::sql_value_codec::normalize_scientific;
+
+TEST(NumberTextTest, IntegersAsDecimalText) {
+    EXPECT_EQ(number_to_string(int16_t{-32768}), "-32768");
+    EXPECT_EQ(number_to_string(int32_t{0}), "0");
+    EXPECT_EQ(number_to_string(std::numeric_limits<int64_t>::min()), "-9223372036854775808");
+    EXPECT_EQ(number_to_string(std::numeric_limits<int64_t>::max()), "9223372036854775807");
+}
+
+TEST(NumberTextTest, FloatingPointIsShortestRoundTrip) {
+    EXPECT_EQ(number_to_string(0.1), "0.1");
+    EXPECT_EQ(number_to_string(1.25f), "1.25");
+    EXPECT_EQ(number_to_string(3.14f), "3.14");       // std::to_string gave "3.140000"
+    EXPECT_EQ(number_to_string(-2.5), "-2.5");
+    EXPECT_EQ(number_to_string(1e20), "1e+20");
+    EXPECT_EQ(number_to_string(1e-7), "1e-07");
+
+    std::mt19937_64 rng(20240611);
+    for (int i = 0; i < 10000; ++i) {
+        const uint64_t bits = rng();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        if (!std::isfinite(value)) {
+            continue;
+        }
+        const std::string text = number_to_string(value);
+        EXPECT_EQ(string_to_floating<double>(text, "DOUBLE PRECISION"), value) << text;
+    }
+}
+
+TEST(NumberTextTest, AssignReusesTheString) {
+    std::string out;
+    out.reserve(64);
+    const char* data = out.data();
+    assign_number(out, 123456789.5);
+    EXPECT_EQ(out, "123456789.5");
+    EXPECT_EQ(out.data(), data);
+}
+
+TEST(NumberTextTest, ParsesFloatingPointText) {
+    EXPECT_EQ(string_to_floating<double>("1.5", "DOUBLE PRECISION"), 1.5);
+    EXPECT_EQ(string_to_floating<double>("  +2.25e1 ", "DOUBLE PRECISION"), 22.5);
+    EXPECT_EQ(string_to_floating<double>("-0.125", "DOUBLE PRECISION"), -0.125);
+    EXPECT_EQ(string_to_floating<float>("3.14", "FLOAT"), 3.14f);
+    EXPECT_TRUE(std::isinf(string_to_floating<double>("inf", "DOUBLE PRECISION")));
+
+    EXPECT_THROW(string_to_floating<double>("", "DOUBLE PRECISION"), FirebirdException);
+    EXPECT_THROW(string_to_floating<double>("abc", "DOUBLE PRECISION"), FirebirdException);
+    EXPECT_THROW(string_to_floating<double>("1.5abc", "DOUBLE PRECISION"), FirebirdException);
+    EXPECT_THROW(string_to_floating<double>("+-1", "DOUBLE PRECISION"), FirebirdException);
+    EXPECT_THROW(string_to_floating<float>("1e100", "FLOAT"), FirebirdException);
+}
+
+TEST(NumberTextTest, ScaledIntegers) {
+    EXPECT_EQ(decimal_to_string_i64(123456, -4), "12.3456");
+    EXPECT_EQ(decimal_to_string_i64(-123456, -4), "-12.3456");
+    EXPECT_EQ(decimal_to_string_i64(5, -2), "0.05");
+    EXPECT_EQ(decimal_to_string_i64(-5, -3), "-0.005");
+    EXPECT_EQ(decimal_to_string_i64(0, -2), "0.00");
+    EXPECT_EQ(decimal_to_string_i64(std::numeric_limits<int64_t>::min(), -18),
+              "-9.223372036854775808");
+    EXPECT_THROW(decimal_to_string_i64(1, -19), FirebirdException);
+}
+
+TEST(NumberTextTest, ExpandsDecimalExponents) {
+    EXPECT_EQ(normalize_scientific("1.2345E+10"), "12345000000");
+    EXPECT_EQ(normalize_scientific("9.87654321098765432109876543210E-10"),
+              "0.000000000987654321098765432109876543210");
+    EXPECT_EQ(normalize_scientific("1.23456789012345678901234567890E+20"),
+              "123456789012345678901.234567890");
+    EXPECT_EQ(normalize_scientific("-1.5E+1"), "-15");
+    EXPECT_EQ(normalize_scientific("1.20E-1"), "0.120");
+    EXPECT_EQ(normalize_scientific("5E-3"), "0.005");
+    EXPECT_EQ(normalize_scientific("0E+2"), "0");
+    EXPECT_EQ(normalize_scientific("-0E+2"), "0");
+    EXPECT_EQ(normalize_scientific("1.25"), "1.25");
+    EXPECT_EQ(normalize_scientific("-Infinity"), "-Infinity");
+    EXPECT_THROW(normalize_scientific("1E+x"), FirebirdException);
+
+    std::string out = "previous contents";
+    assign_plain_decimal(out, "1.5E+2");
+    EXPECT_EQ(out, "150");
+}
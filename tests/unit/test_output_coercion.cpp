@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/extended_types.hpp"
+#include "fbpp/core/output_coercion.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <cstdint>
+#include <string>
+#include <tuple>
+
+// OutputCoercion: spec parsing, coerced formats, and cursors whose rows the
+// server converts before sending.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+namespace {
+
+constexpr const char* kSelect =
+    "SELECT id, amount, price, created FROM coerced_item WHERE id = ?";
+
+} // namespace
+
+TEST(OutputCoercionSpec, ParsesAndPrintsCanonically) {
+    const auto coercion =
+        OutputCoercion::parse(" numeric = double , DecFloat=VARCHAR; column:created=Timestamp ");
+    EXPECT_EQ(coercion.numerics, CoerceTo::Double);
+    EXPECT_EQ(coercion.decfloats, CoerceTo::Varchar);
+    EXPECT_EQ(coercion.timeZones, CoerceTo::Native);
+    ASSERT_EQ(coercion.columns.count("CREATED"), 1u);
+    EXPECT_EQ(coercion.columns.at("CREATED"), CoerceTo::Timestamp);
+
+    const std::string text = coercion.toString();
+    EXPECT_EQ(text, "NUMERIC=DOUBLE;DECFLOAT=VARCHAR;column:CREATED=TIMESTAMP");
+    EXPECT_EQ(OutputCoercion::parse(text).toString(), text);
+
+    EXPECT_TRUE(OutputCoercion{}.empty());
+    EXPECT_TRUE(OutputCoercion::parse("NUMERIC=NATIVE").empty());
+    EXPECT_THROW(OutputCoercion::parse("NUMERIC"), FirebirdException);
+    EXPECT_THROW(OutputCoercion::parse("NUMERIC=FLOAT"), FirebirdException);
+    EXPECT_THROW(OutputCoercion::parse("MONEY=DOUBLE"), FirebirdException);
+}
+
+class OutputCoercionTest : public TempDatabaseTest {
+protected:
+    void SetUp() override {
+        TempDatabaseTest::SetUp();
+        connection_->ExecuteDDL(
+            "CREATE TABLE coerced_item (id INTEGER NOT NULL PRIMARY KEY, "
+            "amount NUMERIC(18,4), price DECFLOAT(34), created TIMESTAMP WITH TIME ZONE)");
+        auto tx = connection_->StartTransaction();
+        tx->execute(connection_->prepareStatement(
+            "INSERT INTO coerced_item VALUES (1, 1234.5678, 0.1, "
+            "TIMESTAMP '2024-03-01 12:30:00 UTC')"));
+        tx->Commit();
+    }
+};
+
+TEST_F(OutputCoercionTest, FormatDescribesConvertedColumns) {
+    auto stmt = connection_->prepareStatement(kSelect);
+    OutputCoercion coercion;
+    coercion.numerics = CoerceTo::Double;
+    coercion.decfloats = CoerceTo::Varchar;
+    coercion.timeZones = CoerceTo::Timestamp;
+
+    auto format = stmt->getCoercedOutputMetadata(coercion);
+    ASSERT_NE(format, nullptr);
+    ASSERT_EQ(format->getCount(), 4u);
+    EXPECT_EQ(format->getField(0).type, static_cast<unsigned>(SQL_LONG));
+    EXPECT_EQ(format->getField(1).type, static_cast<unsigned>(SQL_DOUBLE));
+    EXPECT_EQ(format->getField(2).type, static_cast<unsigned>(SQL_VARYING));
+    EXPECT_EQ(format->getField(3).type, static_cast<unsigned>(SQL_TIMESTAMP));
+    EXPECT_EQ(format->getDisplayName(1), "AMOUNT");
+
+    // Same spec: the cached format; nothing to convert: no format
+    EXPECT_EQ(stmt->getCoercedOutputMetadata(coercion), format);
+    OutputCoercion exempt = coercion;
+    exempt.columns = {{"AMOUNT", CoerceTo::Native}};
+    EXPECT_EQ(stmt->getCoercedOutputMetadata(exempt)->getField(1).type,
+              static_cast<unsigned>(SQL_INT64));
+    EXPECT_EQ(stmt->getCoercedOutputMetadata(OutputCoercion{}), nullptr);
+
+    OutputCoercion invalid;
+    invalid.columns = {{"ID", CoerceTo::Timestamp}};
+    EXPECT_THROW(stmt->getCoercedOutputMetadata(invalid), FirebirdException);
+}
+
+TEST_F(OutputCoercionTest, ServerConvertsRows) {
+    auto stmt = connection_->prepareStatement(kSelect);
+    auto tx = connection_->StartTransaction();
+    OutputCoercion coercion = OutputCoercion::parse("NUMERIC=DOUBLE;DECFLOAT=VARCHAR");
+    auto cursor = tx->openCursor(stmt, std::make_tuple(int32_t{1}), coercion);
+    std::tuple<int32_t, double, std::string, TimestampTz> row;
+    ASSERT_TRUE(cursor->fetch(row));
+    EXPECT_DOUBLE_EQ(std::get<1>(row), 1234.5678);
+    EXPECT_EQ(std::get<2>(row), "0.1");
+    cursor->close();
+
+    // The same statement still opens with its native format
+    auto native = tx->openCursor(stmt, std::make_tuple(int32_t{1}));
+    EXPECT_EQ(native->getMetadata()->getField(1).type, static_cast<unsigned>(SQL_INT64));
+    native->close();
+    tx->Commit();
+}
+
+TEST_F(OutputCoercionTest, TimeZoneArrivesInSessionZone) {
+    auto stmt = connection_->prepareStatement(
+        "SELECT created, CAST(created AS TIMESTAMP) FROM coerced_item");
+    auto tx = connection_->StartTransaction();
+    OutputCoercion coercion;
+    coercion.timeZones = CoerceTo::Timestamp;
+    auto cursor = tx->openCursor(stmt, coercion);
+    std::tuple<Timestamp, Timestamp> row;
+    ASSERT_TRUE(cursor->fetch(row));
+    EXPECT_EQ(std::get<0>(row).getDate(), std::get<1>(row).getDate());
+    EXPECT_EQ(std::get<0>(row).getTime(), std::get<1>(row).getTime());
+    cursor->close();
+    tx->Commit();
+}
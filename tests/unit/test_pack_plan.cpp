@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/param_binder.hpp"
+#include "fbpp/core/pack_plan.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+// PackPlan<T>: per-metadata tuple/struct packing with direct column stores.
+
+namespace {
+
+struct PlanRow {
+    int32_t id;
+    int16_t small;
+    int64_t big;
+    double dbl;
+    std::string vc;
+    std::string ch;
+    double num;
+    std::optional<int32_t> opt;
+};
+
+} // namespace
+
+namespace fbpp::core {
+
+template<>
+struct StructDescriptor<PlanRow> {
+    static constexpr auto fields = std::make_tuple(
+        makeField<&PlanRow::id>("ID", SQL_LONG, 0, sizeof(int32_t)),
+        makeField<&PlanRow::small>("F_SMALL", SQL_SHORT, 0, sizeof(int16_t), 0, true),
+        makeField<&PlanRow::big>("F_BIG", SQL_INT64, 0, sizeof(int64_t), 0, true),
+        makeField<&PlanRow::dbl>("F_DBL", SQL_DOUBLE, 0, sizeof(double), 0, true),
+        makeField<&PlanRow::vc>("F_VC", SQL_VARYING, 0, 16, 0, true),
+        makeField<&PlanRow::ch>("F_CH", SQL_TEXT, 0, 4, 0, true),
+        makeField<&PlanRow::num>("F_NUM", SQL_LONG, -2, sizeof(int32_t), 0, true),
+        makeField<&PlanRow::opt>("F_OPT", SQL_LONG, 0, sizeof(int32_t), 0, true)
+    );
+};
+
+} // namespace fbpp::core
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+namespace {
+
+using PlanTuple = std::tuple<int32_t, int16_t, int64_t, double, std::string,
+                             std::string, double, std::optional<int32_t>>;
+
+constexpr const char* kInsert =
+    "INSERT INTO pp_t (id, f_small, f_big, f_dbl, f_vc, f_ch, f_num, f_opt) "
+    "VALUES (?, ?, ?, ?, ?, ?, ?, ?)";
+
+} // namespace
+
+class PackPlanTest : public TempDatabaseTest {
+protected:
+    void createTestSchema() override {
+        TempDatabaseTest::createTestSchema();
+        connection_->ExecuteDDL(R"(
+            CREATE TABLE pp_t (
+                id      INTEGER NOT NULL PRIMARY KEY,
+                f_small SMALLINT,
+                f_big   BIGINT,
+                f_dbl   DOUBLE PRECISION,
+                f_vc    VARCHAR(16),
+                f_ch    CHAR(4),
+                f_num   NUMERIC(9,2),
+                f_opt   INTEGER
+            )
+        )");
+    }
+
+    PlanTuple readBack(int32_t id) {
+        auto tx = connection_->StartTransaction();
+        auto sel = connection_->prepareStatement(
+            "SELECT id, f_small, f_big, f_dbl, f_vc, f_ch, f_num, f_opt FROM pp_t WHERE id = ?");
+        auto cur = tx->openCursor(sel, std::make_tuple(id));
+        PlanTuple row;
+        EXPECT_TRUE(cur->fetch(row));
+        tx->Commit();
+        return row;
+    }
+};
+
+TEST_F(PackPlanTest, PlanIsBuiltOncePerMetadata) {
+    auto stmt = connection_->prepareStatement(kInsert);
+    auto meta = stmt->getInputMetadata();
+    ASSERT_TRUE(meta);
+
+    const auto& first = PackPlan<PlanTuple>::of(*meta);
+    const auto& second = PackPlan<PlanTuple>::of(*meta);
+    EXPECT_EQ(&first, &second);
+    EXPECT_EQ(first.messageLength(), meta->getMessageLength());
+
+    // Different row types get their own plan on the same metadata.
+    EXPECT_NE(static_cast<const void*>(&PackPlan<PlanRow>::of(*meta)),
+              static_cast<const void*>(&first));
+}
+
+TEST_F(PackPlanTest, ValidatesShapeUpFront) {
+    auto stmt = connection_->prepareStatement(kInsert);
+    auto meta = stmt->getInputMetadata();
+
+    EXPECT_THROW(PackPlan<std::tuple<int32_t>>{*meta}, FirebirdException);
+
+    // A failed plan is not cached: the next use throws again.
+    using Pair = std::tuple<int32_t, int32_t>;
+    auto one = connection_->prepareStatement("SELECT 1 FROM rdb$database WHERE 1 = ?");
+    EXPECT_THROW((void)PackPlan<Pair>::of(*one->getInputMetadata()), FirebirdException);
+    EXPECT_THROW((void)PackPlan<Pair>::of(*one->getInputMetadata()), FirebirdException);
+}
+
+TEST_F(PackPlanTest, TupleStructAndBinderPackTheSameValues) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement(kInsert);
+
+    tx->execute(stmt, PlanTuple{1, int16_t{-7}, int64_t{9'000'000'000LL}, 0.5,
+                                "varying", "ab", 12.34, std::nullopt});
+
+    ParamBinder binder(stmt, tx.get());
+    binder.setAll(PlanRow{2, -7, 9'000'000'000LL, 0.5, "varying", "ab", 12.34, std::nullopt});
+    EXPECT_EQ(tx->execute(stmt, binder), 1u);
+    tx->Commit();
+
+    for (int32_t id : {1, 2}) {
+        const auto row = readBack(id);
+        EXPECT_EQ(std::get<1>(row), -7);
+        EXPECT_EQ(std::get<2>(row), 9'000'000'000LL);
+        EXPECT_DOUBLE_EQ(std::get<3>(row), 0.5);
+        EXPECT_EQ(std::get<4>(row), "varying");
+        EXPECT_EQ(std::get<5>(row), "ab  ");      // CHAR is blank-padded
+        EXPECT_DOUBLE_EQ(std::get<6>(row), 12.34); // scaled: codec path
+        EXPECT_FALSE(std::get<7>(row).has_value());
+    }
+}
+
+TEST_F(PackPlanTest, DirectStoresKeepCodecChecks) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement(kInsert);
+    auto meta = stmt->getInputMetadata();
+
+    // int32_t into SMALLINT: direct store, still range-checked
+    using Wide = std::tuple<int32_t, int32_t, int64_t, double, std::string,
+                            std::string, double, std::optional<int32_t>>;
+    const auto& plan = PackPlan<Wide>::of(*meta);
+    std::vector<uint8_t> buffer(plan.messageLength());
+
+    EXPECT_THROW(plan.pack(Wide{1, 70000, 0, 0.0, "", "", 0.0, 7}, buffer.data()),
+                 FirebirdException);
+    EXPECT_NO_THROW(plan.pack(Wide{1, 7, 0, 0.0, "", "", 0.0, 7}, buffer.data()));
+    // VARCHAR(16) overflow
+    EXPECT_THROW(plan.pack(Wide{1, 7, 0, 0.0, std::string(17, 'x'), "", 0.0, 7}, buffer.data()),
+                 FirebirdException);
+    tx->Commit();
+}
+
+TEST_F(PackPlanTest, StringViewsPackFromTheirSource) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement(kInsert);
+
+    const std::string frame = "..varying..ab..";
+    using Views = std::tuple<int32_t, int16_t, int64_t, double, std::string_view,
+                             const char*, double, std::optional<int32_t>>;
+    tx->execute(stmt, Views{3, int16_t{1}, int64_t{2}, 0.25,
+                            std::string_view(frame).substr(2, 7), "ab", 1.5, 4});
+    tx->Commit();
+
+    const auto row = readBack(3);
+    EXPECT_EQ(std::get<4>(row), "varying");
+    EXPECT_EQ(std::get<5>(row), "ab  ");
+    EXPECT_EQ(std::get<7>(row), 4);
+
+    // Same length checks as std::string on the direct store
+    const auto& plan = PackPlan<Views>::of(*stmt->getInputMetadata());
+    std::vector<uint8_t> buffer(plan.messageLength());
+    const std::string longer(17, 'x');
+    EXPECT_THROW(plan.pack(Views{1, 1, 0, 0.0, longer, "", 0.0, 1}, buffer.data()),
+                 FirebirdException);
+}
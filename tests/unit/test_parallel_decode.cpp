@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/batch.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// ResultSet::decodeParallel — fetch on the caller, decode on workers.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+class ParallelDecodeTest : public TempDatabaseTest {
+protected:
+    static constexpr int32_t kRows = 3000;
+
+    void createTestSchema() override {
+        connection_->ExecuteDDL(R"(
+            CREATE TABLE pd (
+                id INTEGER NOT NULL PRIMARY KEY,
+                name VARCHAR(40),
+                amount DOUBLE PRECISION
+            )
+        )");
+        auto tx = connection_->StartTransaction();
+        auto ins = connection_->prepareStatement(
+            "INSERT INTO pd (id, name, amount) VALUES (?, ?, ?)");
+        std::vector<std::tuple<int32_t, std::string, double>> rows;
+        for (int32_t i = 1; i <= kRows; ++i) {
+            rows.emplace_back(i, "row " + std::to_string(i), i * 0.5);
+        }
+        auto batch = ins->createBatch(tx.get(), false);
+        batch->addMany(rows);
+        batch->execute(tx.get());
+        tx->Commit();
+    }
+
+    std::unique_ptr<ResultSet> open(std::shared_ptr<Transaction>& tx) {
+        tx = connection_->StartTransaction();
+        return tx->openCursor(connection_->prepareStatement(
+            "SELECT id, name, amount FROM pd ORDER BY id"));
+    }
+};
+
+TEST_F(ParallelDecodeTest, OrderedDeliveryKeepsFetchOrder) {
+    std::shared_ptr<Transaction> tx;
+    auto cur = open(tx);
+    std::vector<int32_t> ids;
+    ParallelDecodeOptions options;
+    options.workers = 4;
+    options.blockRows = 97;
+    const auto n = cur->decodeParallel<std::tuple<int32_t, std::string, double>>(
+        [&](std::vector<std::tuple<int32_t, std::string, double>>& rows) {
+            for (const auto& row : rows) {
+                ids.push_back(std::get<0>(row));
+                EXPECT_EQ(std::get<1>(row), "row " + std::to_string(std::get<0>(row)));
+            }
+        },
+        options);
+    EXPECT_EQ(n, static_cast<std::size_t>(kRows));
+    ASSERT_EQ(ids.size(), static_cast<std::size_t>(kRows));
+    EXPECT_TRUE(std::is_sorted(ids.begin(), ids.end()));
+    EXPECT_TRUE(cur->isEof());
+    tx->Commit();
+}
+
+TEST_F(ParallelDecodeTest, RelaxedDeliveryDecodesEveryRow) {
+    std::shared_ptr<Transaction> tx;
+    auto cur = open(tx);
+    cur->setPrefetch(64);
+    std::vector<int32_t> ids;
+    ParallelDecodeOptions options;
+    options.workers = 3;
+    options.blockRows = 50;
+    options.ordered = false;
+    cur->decodeParallel<nlohmann::json>(
+        [&](std::vector<nlohmann::json>& rows) {
+            for (const auto& row : rows) {
+                ids.push_back(row.at("ID").get<int32_t>());
+            }
+        },
+        options);
+    std::sort(ids.begin(), ids.end());
+    ASSERT_EQ(ids.size(), static_cast<std::size_t>(kRows));
+    EXPECT_EQ(ids.front(), 1);
+    EXPECT_EQ(ids.back(), kRows);
+    EXPECT_EQ(std::adjacent_find(ids.begin(), ids.end()), ids.end());
+    tx->Commit();
+}
+
+TEST_F(ParallelDecodeTest, SinkExceptionStopsThePipeline) {
+    std::shared_ptr<Transaction> tx;
+    auto cur = open(tx);
+    std::size_t blocks = 0;
+    ParallelDecodeOptions options;
+    options.workers = 2;
+    options.blockRows = 100;
+    auto sink = [&](std::vector<std::tuple<int32_t, std::string, double>>&) {
+        if (++blocks == 3) {
+            throw std::runtime_error("stop");
+        }
+    };
+    using Row3 = std::tuple<int32_t, std::string, double>;
+    EXPECT_THROW(cur->decodeParallel<Row3>(sink, options), std::runtime_error);
+    EXPECT_EQ(blocks, 3u);
+    cur->close();
+    tx->Commit();
+}
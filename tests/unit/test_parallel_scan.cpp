@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/batch.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/schema/parallel_scan.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// ParallelScan — key / DB_KEY partitioning, shared snapshot, merged stream.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+using fbpp::schema::ParallelScan;
+using fbpp::schema::ParallelScanOptions;
+using fbpp::schema::ScanPartitioning;
+
+class ParallelScanTest : public TempDatabaseTest {
+protected:
+    static constexpr int32_t kRows = 2000;
+
+    void createTestSchema() override {
+        connection_->ExecuteDDL(
+            "CREATE TABLE ps (id INTEGER NOT NULL PRIMARY KEY, grp INTEGER, name VARCHAR(20))");
+        connection_->ExecuteDDL("CREATE TABLE ps_nokey (code VARCHAR(10), val INTEGER)");
+        auto tx = connection_->StartTransaction();
+        std::vector<std::tuple<int32_t, int32_t, std::string>> rows;
+        std::vector<std::tuple<std::string, int32_t>> plain;
+        for (int32_t i = 1; i <= kRows; ++i) {
+            rows.emplace_back(i * 3, i % 7, "r" + std::to_string(i));
+            plain.emplace_back("c" + std::to_string(i), i);
+        }
+        auto batch = connection_->prepareStatement("INSERT INTO ps VALUES (?, ?, ?)")
+                         ->createBatch(tx.get(), false);
+        batch->addMany(rows);
+        batch->execute(tx.get());
+        auto plainBatch = connection_->prepareStatement("INSERT INTO ps_nokey VALUES (?, ?)")
+                              ->createBatch(tx.get(), false);
+        plainBatch->addMany(plain);
+        plainBatch->execute(tx.get());
+        tx->Commit();
+    }
+
+    std::vector<int32_t> scanIds(ParallelScan& scan) {
+        std::mutex mutex;
+        std::vector<int32_t> ids;
+        const auto result = scan.run([&](unsigned, const RowView& row) {
+            const auto id = row.get<int32_t>(0).value();
+            std::lock_guard<std::mutex> lock(mutex);
+            ids.push_back(id);
+        });
+        EXPECT_TRUE(result.ok());
+        EXPECT_EQ(result.rows, ids.size());
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }
+};
+
+TEST_F(ParallelScanTest, PrimaryKeyRangesCoverTheTableOnce) {
+    ParallelScanOptions options;
+    options.partitions = 4;
+    options.columns = "id, name";
+    ParallelScan scan(db_params_, "ps", options);
+
+    const auto predicates = scan.plan();
+    ASSERT_EQ(predicates.size(), 4u);
+    EXPECT_NE(predicates[0].find("ID >= 3"), std::string::npos);
+
+    const auto ids = scanIds(scan);
+    ASSERT_EQ(ids.size(), static_cast<std::size_t>(kRows));
+    EXPECT_EQ(std::adjacent_find(ids.begin(), ids.end()), ids.end());
+    EXPECT_EQ(ids.front(), 3);
+    EXPECT_EQ(ids.back(), kRows * 3);
+}
+
+TEST_F(ParallelScanTest, QuerySourceWithKeyAndFilter) {
+    ParallelScanOptions options;
+    options.partitions = 3;
+    options.keyColumn = "id";
+    options.where = "grp = 2";
+    ParallelScan scan(db_params_, "SELECT id, grp FROM ps", options);
+    const auto ids = scanIds(scan);
+    EXPECT_EQ(ids.size(), static_cast<std::size_t>(std::count_if(
+        ids.begin(), ids.end(), [](int32_t id) { return (id / 3) % 7 == 2; })));
+    EXPECT_EQ(ids.size(), static_cast<std::size_t>((kRows + 5) / 7));
+}
+
+TEST_F(ParallelScanTest, PartitionsShareTheCoordinatorSnapshot) {
+    if (connection_->getEngineMajorVersion() < 4) {
+        GTEST_SKIP() << "isc_tpb_at_snapshot_number needs Firebird 4";
+    }
+    ParallelScanOptions options;
+    options.partitions = 2;
+    options.columns = "id";
+    std::atomic<bool> inserted{false};
+    ParallelScan scan(db_params_, "ps", options);
+    const auto result = scan.run([&](unsigned, const RowView&) {
+        if (!inserted.exchange(true)) {
+            // Committed after the scan's snapshot: must not be seen
+            auto tx = connection_->StartTransaction();
+            tx->execute(connection_->prepareStatement("INSERT INTO ps VALUES (1, 0, 'late')"));
+            tx->Commit();
+        }
+    });
+    ASSERT_TRUE(result.ok());
+    ASSERT_TRUE(result.snapshotNumber.has_value());
+    EXPECT_EQ(result.rows, static_cast<uint64_t>(kRows));
+}
+
+TEST_F(ParallelScanTest, DbKeyRangesAndMergedSink) {
+    if (connection_->getEngineMajorVersion() < 4) {
+        GTEST_SKIP() << "MAKE_DBKEY needs Firebird 4";
+    }
+    ParallelScanOptions options;
+    options.partitions = 4;
+    options.mergeBlockRows = 64;
+    ParallelScan scan(db_params_, "ps_nokey", options);   // No primary key: DB_KEY
+
+    std::vector<int32_t> values;
+    const auto result = scan.runMerged([&](const RowView& row) {
+        values.push_back(row.get<int32_t>("VAL").value());
+    });
+    EXPECT_TRUE(result.ok());
+    std::sort(values.begin(), values.end());
+    ASSERT_EQ(values.size(), static_cast<std::size_t>(kRows));
+    EXPECT_EQ(std::adjacent_find(values.begin(), values.end()), values.end());
+}
+
+TEST_F(ParallelScanTest, QueryWithoutKeyIsRejected) {
+    ParallelScan scan(db_params_, "SELECT id FROM ps");
+    EXPECT_THROW(scan.plan(), FirebirdException);
+}
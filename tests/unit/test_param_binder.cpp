@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include "../test_base.hpp"
+#include "fbpp/core/batch.hpp"
 #include "fbpp/core/connection.hpp"
 #include "fbpp/core/transaction.hpp"
 #include "fbpp/core/statement.hpp"
@@ -13,8 +14,11 @@
 #include <nlohmann/json.hpp>
 
 #include <chrono>
+#include <cstddef>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <tuple>
 
 using namespace fbpp::core;
@@ -230,6 +234,41 @@ TEST_F(ParamBinderTest, BindsBlobBinary) {
     tx->Commit();
 }
 
+TEST_F(ParamBinderTest, BindsViewsOfCallerMemory) {
+    auto tx = connection_->StartTransaction();
+    auto ins = connection_->prepareStatement(
+        "INSERT INTO pb_blob (id, payload, payload_bin) VALUES (:id, :p, :b)");
+
+    const std::string frame = "header|text payload|trailer";
+    const std::string_view text = std::string_view(frame).substr(7, 12);
+    const unsigned char bytes[] = {0x00, 0x01, 0xFE, 0xFF};
+
+    ParamBinder b(ins, tx.get());
+    b.set("id", int32_t{1});
+    EXPECT_TRUE(b.set("p", text));
+    EXPECT_TRUE(b.set("b", std::as_bytes(std::span<const unsigned char>(bytes))));
+    EXPECT_EQ(tx->execute(ins, b), 1u);
+
+    b.clear();
+    b.set("id", int32_t{2});
+    EXPECT_TRUE(b.set("p", "literal"));
+    EXPECT_TRUE(b.set("b", std::span<const std::byte>{}));
+    EXPECT_EQ(tx->execute(ins, b), 1u);
+
+    auto sel = connection_->prepareStatement(
+        "SELECT payload, payload_bin FROM pb_blob ORDER BY id");
+    auto cur = tx->openCursor(sel);
+    std::tuple<std::string, std::string> row;
+    ASSERT_TRUE(cur->fetch(row));
+    EXPECT_EQ(std::get<0>(row), "text payload");
+    EXPECT_EQ(std::get<1>(row), std::string("\x00\x01\xFE\xFF", 4));
+    ASSERT_TRUE(cur->fetch(row));
+    EXPECT_EQ(std::get<0>(row), "literal");
+    EXPECT_TRUE(std::get<1>(row).empty());
+    cur->close();
+    tx->Commit();
+}
+
 // ============================================================================
 // clear() and reuse of binder across iterations
 // ============================================================================
@@ -263,6 +302,50 @@ TEST_F(ParamBinderTest, ClearAndReuse) {
     tx->Commit();
 }
 
+// ============================================================================
+// Batch::add(ParamBinder) — named rows into a batch
+// ============================================================================
+
+TEST_F(ParamBinderTest, BatchesBinderRows) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement(
+        "INSERT INTO pb_basic (id, f_bigint, f_varchar) VALUES (:id, :big, :name)");
+    auto batch = stmt->createBatch(tx.get(), true);
+
+    ParamBinder b(stmt, tx.get());
+    const ParamSlot id = b.slot("id");
+    for (int i = 1; i <= 50; ++i) {
+        b.clear();
+        ASSERT_TRUE(b.bind(id, int32_t{i}));
+        if (i % 2 == 0) {
+            ASSERT_TRUE(b.set("name", std::string("row_" + std::to_string(i))));
+        }
+        ASSERT_TRUE(b.set("big", int64_t{i} * 1000000000));
+        batch->add(b);
+    }
+    EXPECT_EQ(batch->getMessageCount(), 50u);
+
+    // Another statement's parameters do not fit
+    auto other = connection_->prepareStatement("INSERT INTO pb_basic (id) VALUES (:id)");
+    ParamBinder wrong(other, tx.get());
+    wrong.set("id", int32_t{99});
+    EXPECT_THROW(batch->add(wrong), FirebirdException);
+
+    const auto result = batch->execute(tx.get());
+    EXPECT_EQ(result.successCount, 50u);
+    EXPECT_EQ(result.failedCount, 0u);
+
+    auto cur = tx->openCursor(connection_->prepareStatement(
+        "SELECT COUNT(*), SUM(f_bigint), COUNT(f_varchar) FROM pb_basic"));
+    std::tuple<int64_t, int64_t, int64_t> row;
+    ASSERT_TRUE(cur->fetch(row));
+    EXPECT_EQ(std::get<0>(row), 50);
+    EXPECT_EQ(std::get<1>(row), int64_t{1275} * 1000000000);
+    EXPECT_EQ(std::get<2>(row), 25);
+    cur->close();
+    tx->Commit();
+}
+
 // ============================================================================
 // Unknown name returns false (non-fatal — legacy IBO behaviour)
 // ============================================================================
@@ -346,6 +429,98 @@ TEST_F(ParamBinderTest, RepeatedParameterFillsAllPositions) {
     tx->Commit();
 }
 
+// ============================================================================
+// Pre-resolved slots — resolve once, bind per row
+// ============================================================================
+
+TEST_F(ParamBinderTest, SlotBindsAllPositionsAcrossBinders) {
+    auto tx = connection_->StartTransaction();
+    auto ins = connection_->prepareStatement(
+        "INSERT INTO pb_basic (id, f_varchar, f_bigint) VALUES (:id, :name, :v)");
+
+    ParamBinder first(ins, tx.get());
+    const ParamSlot id = first.slot(" ID ");
+    const ParamSlot name = first.slot("name");
+    const ParamSlot v = first.slot("v");
+    ASSERT_FALSE(id.empty());
+    EXPECT_TRUE(first.slot("nope").empty());
+    EXPECT_FALSE(first.bind(first.slot("nope"), int32_t{1}));
+
+    for (int32_t i = 1; i <= 3; ++i) {
+        ParamBinder b(ins, tx.get());   // Same statement: slots stay valid
+        ASSERT_TRUE(b.bind(id, i));
+        ASSERT_TRUE(b.bind(name, std::string("row") + std::to_string(i)));
+        if (i == 2) {
+            ASSERT_TRUE(b.bind(v, std::nullopt));
+        } else {
+            ASSERT_TRUE(b.bind(v, int64_t{i * 100}));
+        }
+        EXPECT_EQ(tx->execute(ins, b), 1u);
+    }
+
+    auto sel = connection_->prepareStatement(
+        "SELECT id FROM pb_basic WHERE f_bigint >= :v OR id = :v ORDER BY id");
+    ParamBinder b(sel, tx.get());
+    const ParamSlot both = b.slot("v");
+    EXPECT_EQ(both.size(), 2u);
+    ASSERT_TRUE(b.bind(both, int64_t{300}));
+
+    auto cur = tx->openCursor(sel, b);
+    std::vector<int32_t> ids;
+    std::tuple<int32_t> row;
+    while (cur->fetch(row)) ids.push_back(std::get<0>(row));
+    cur->close();
+    ASSERT_EQ(ids.size(), 1u);
+    EXPECT_EQ(ids[0], 3);
+
+    EXPECT_THROW(b.bind(id, int32_t{1}), FirebirdException);   // Slot of `ins`
+    tx->Commit();
+}
+
+// ============================================================================
+// List parameters — IN (:ids) expanded to a bucketed shape
+// ============================================================================
+
+TEST_F(ParamBinderTest, SetListPadsBucketWithLastValue) {
+    auto tx = connection_->StartTransaction();
+    auto ins = connection_->prepareStatement(
+        "INSERT INTO pb_basic (id, f_bigint) VALUES (:id, :v)");
+    for (int32_t i = 1; i <= 6; ++i) {
+        ParamBinder b(ins, tx.get());
+        b.set("id", i);
+        b.set("v", int64_t{i});
+        tx->execute(ins, b);
+    }
+
+    const std::string sql =
+        "SELECT id FROM pb_basic WHERE id NOT IN (:ids) AND f_bigint < :lim ORDER BY id";
+    auto query = [&](const std::vector<int32_t>& ids) {
+        auto sel = connection_->prepareStatement(
+            NamedParamParser::expandList(sql, "ids", ids.size()));
+        ParamBinder b(sel, tx.get());
+        EXPECT_TRUE(b.setList("ids", ids));
+        b.set("lim", int64_t{6});
+        auto cur = tx->openCursor(sel, b);
+        std::vector<int32_t> found;
+        std::tuple<int32_t> row;
+        while (cur->fetch(row)) found.push_back(std::get<0>(row));
+        cur->close();
+        return found;
+    };
+
+    // 3 values in a 4-slot shape: the padded slot repeats 4, so NOT IN
+    // still sees no NULL
+    EXPECT_EQ(query({2, 3, 4}), (std::vector<int32_t>{1, 5}));
+    EXPECT_EQ(query({1}), (std::vector<int32_t>{2, 3, 4, 5}));
+
+    auto sel = connection_->prepareStatement(NamedParamParser::expandList(sql, "ids", 2));
+    ParamBinder b(sel, tx.get());
+    const std::vector<int32_t> tooMany{1, 2, 3};
+    EXPECT_THROW(b.setList("ids", tooMany), FirebirdException);
+    EXPECT_FALSE(b.setList("lim", tooMany));   // Not a list parameter
+    tx->Commit();
+}
+
 // ============================================================================
 // Missing parameter → NULL (must match JSON-path behaviour)
 // ============================================================================
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/ext/parquet_export.hpp"
+
+#include <arrow/api.h>
+#include <arrow/io/memory.h>
+#include <parquet/arrow/reader.h>
+#include <parquet/file_reader.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+// fbpp::ext::writeParquet — ResultSet as Parquet row groups.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+class ParquetExportTest : public TempDatabaseTest {
+protected:
+    std::shared_ptr<Statement> series(int rows) {
+        return connection_->prepareStatement(
+            "WITH RECURSIVE r (n) AS ("
+            "  SELECT 1 FROM RDB$DATABASE UNION ALL SELECT n + 1 FROM r WHERE n < " +
+            std::to_string(rows) + ") "
+            "SELECT CAST(n AS INTEGER) AS id, CAST(n / 100.0 AS NUMERIC(18,2)) AS amount, "
+            "       IIF(MOD(n, 10) = 0, NULL, 'row ' || n) AS label, "
+            "       DATEADD(n SECOND TO TIMESTAMP '2024-01-01 00:00:00') AS ts "
+            "FROM r");
+    }
+};
+
+TEST_F(ParquetExportTest, WritesBoundedRowGroups) {
+    const auto path = std::filesystem::temp_directory_path() / "fbpp_parquet_export_test.parquet";
+
+    auto tx = connection_->StartTransaction();
+    auto cur = tx->openCursor(series(2500));
+    fbpp::ext::ParquetExportOptions options;
+    options.rowGroupRows = 1000;
+    options.batchSize = 300;                 // Batches straddle row-group boundaries
+    options.compression = arrow::Compression::SNAPPY;
+    auto result = fbpp::ext::writeParquet(*cur, path.string(), options);
+    cur->close();
+    tx->Commit();
+
+    EXPECT_EQ(result.rows, 2500u);
+    EXPECT_EQ(result.rowGroups, 3u);
+
+    auto fileReader = parquet::ParquetFileReader::OpenFile(path.string());
+    auto metadata = fileReader->metadata();
+    ASSERT_EQ(metadata->num_row_groups(), 3);
+    EXPECT_EQ(metadata->num_rows(), 2500);
+    EXPECT_EQ(metadata->RowGroup(0)->num_rows(), 1000);
+    EXPECT_EQ(metadata->RowGroup(2)->num_rows(), 500);
+
+    std::unique_ptr<parquet::arrow::FileReader> reader;
+    ASSERT_TRUE(parquet::arrow::FileReader::Make(arrow::default_memory_pool(),
+                                                 std::move(fileReader), &reader).ok());
+    std::shared_ptr<arrow::Table> table;
+    ASSERT_TRUE(reader->ReadTable(&table).ok());
+    std::filesystem::remove(path);
+
+    ASSERT_EQ(table->num_rows(), 2500);
+    EXPECT_TRUE(table->schema()->field(1)->type()->Equals(arrow::decimal128(18, 2)));
+    EXPECT_TRUE(table->schema()->field(3)->type()->Equals(arrow::timestamp(arrow::TimeUnit::MICRO)));
+
+    auto combined = table->CombineChunksToBatch();
+    ASSERT_TRUE(combined.ok());
+    const auto& batch = *combined;
+    auto ids = std::static_pointer_cast<arrow::Int32Array>(batch->column(0));
+    EXPECT_EQ(ids->Value(0), 1);
+    EXPECT_EQ(ids->Value(2499), 2500);
+    auto amounts = std::static_pointer_cast<arrow::Decimal128Array>(batch->column(1));
+    EXPECT_EQ(amounts->FormatValue(1234), "12.35");
+    auto labels = std::static_pointer_cast<arrow::StringArray>(batch->column(2));
+    EXPECT_EQ(labels->GetView(0), "row 1");
+    EXPECT_TRUE(labels->IsNull(9));
+    EXPECT_EQ(std::static_pointer_cast<arrow::TimestampArray>(batch->column(3))->Value(0),
+              1704067201000000);
+}
+
+TEST_F(ParquetExportTest, EmptyResultStillWritesFooter) {
+    auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement("SELECT 1 AS one FROM RDB$DATABASE WHERE 1 = 0");
+    auto cur = tx->openCursor(stmt);
+    auto result = fbpp::ext::writeParquet(*cur, sink);
+    cur->close();
+
+    EXPECT_EQ(result.rows, 0u);
+    auto buffer = sink->Finish().ValueOrDie();
+    auto fileReader = parquet::ParquetFileReader::Open(
+        std::make_shared<arrow::io::BufferReader>(buffer));
+    EXPECT_EQ(fileReader->metadata()->num_rows(), 0);
+    EXPECT_EQ(fileReader->metadata()->num_columns(), 1);
+
+    auto again = tx->openCursor(stmt);
+    fbpp::ext::ParquetExportOptions options;
+    options.rowGroupRows = 0;
+    EXPECT_THROW(fbpp::ext::writeParquet(*again, sink, options), FirebirdException);
+    again->close();
+    tx->Commit();
+}
@@ -6,11 +6,15 @@
 #include "fbpp/core/statement.hpp"
 #include "fbpp/core/exception.hpp"
 
+#include <nlohmann/json.hpp>
+#include <optional>
 #include <string>
+#include <tuple>
 
 // Connection::prepareStatementUncached + describeQuery refactor.
 // The motivation is CI manifest tooling that scans 1000+ procedures —
-// the cache would otherwise be flushed by transient lookups.
+// the cache would otherwise be flushed by transient lookups. The one-shot
+// executeOnce / openCursorOnce paths skip the prepare altogether.
 
 using namespace fbpp::core;
 using namespace fbpp::test;
@@ -81,3 +85,53 @@ TEST_F(PrepareUncachedTest, PrepareUncachedNamedParamsRecognized) {
     const auto& mapping = stmt->getNamedParamMapping();
     EXPECT_EQ(mapping.count("the_id"), 1u);
 }
+
+TEST_F(PrepareUncachedTest, ExecuteOnceBypassesCache) {
+    auto sizeBefore = connection_->getCacheStatistics().cacheSize;
+    auto tra = connection_->StartTransaction();
+    connection_->executeOnce(tra.get(),
+                             "INSERT INTO test_table (id, name, amount) VALUES (?, ?, ?)",
+                             std::make_tuple(1, std::string("one"), 1.5));
+    connection_->executeOnce(tra.get(),
+                             "INSERT INTO test_table (id, name) VALUES (:id, :name)",
+                             nlohmann::json{{"id", 2}, {"name", "two"}});
+    connection_->executeOnce(tra.get(), "UPDATE test_table SET amount = 0 WHERE amount IS NULL");
+
+    auto rs = connection_->openCursorOnce(
+        tra, "SELECT id, name, amount FROM test_table WHERE id >= ? ORDER BY id",
+        std::make_tuple(1));
+    std::tuple<int32_t, std::optional<std::string>, std::optional<double>> row;
+    ASSERT_TRUE(rs->fetch(row));
+    EXPECT_EQ(std::get<0>(row), 1);
+    EXPECT_EQ(std::get<1>(row), "one");
+    EXPECT_DOUBLE_EQ(std::get<2>(row).value_or(0), 1.5);
+    ASSERT_TRUE(rs->fetch(row));
+    EXPECT_EQ(std::get<0>(row), 2);
+    EXPECT_EQ(std::get<1>(row), "two");
+    EXPECT_DOUBLE_EQ(std::get<2>(row).value_or(-1), 0.0);
+    EXPECT_FALSE(rs->fetch(row));
+    rs->close();
+    tra->Commit();
+
+    EXPECT_EQ(connection_->getCacheStatistics().cacheSize, sizeBefore);
+}
+
+TEST_F(PrepareUncachedTest, ExecuteOnceNullAndLongStringParameters) {
+    auto tra = connection_->StartTransaction();
+    connection_->executeOnce(tra.get(),
+                             "INSERT INTO test_table (id, name) VALUES (?, ?)",
+                             std::make_tuple(7, std::optional<std::string>{}));
+    auto rs = connection_->openCursorOnce(
+        tra, "SELECT name FROM test_table WHERE id = ?", nlohmann::json::array({7}));
+    std::tuple<std::optional<std::string>> row;
+    ASSERT_TRUE(rs->fetch(row));
+    EXPECT_FALSE(std::get<0>(row).has_value());
+    rs->close();
+
+    // Wider than the column: the server reports the truncation
+    EXPECT_THROW(connection_->executeOnce(tra.get(),
+                                          "INSERT INTO test_table (id, name) VALUES (?, ?)",
+                                          std::make_tuple(8, std::string(200, 'x'))),
+                 FirebirdException);
+    tra->Rollback();
+}
@@ -3,9 +3,11 @@
 #include "../test_base.hpp"
 #include "fbpp/core/connection.hpp"
 #include "fbpp/core/exception.hpp"
+#include "fbpp/core/procedure_call.hpp"
 
 #include <algorithm>
 #include <string>
+#include <tuple>
 
 // Connection::listProcedures() / describeProcedure().
 //
@@ -112,3 +114,37 @@ TEST_F(ProcedureMetadataTest, ProcedureParamFieldMatchesDescribeQuery) {
     EXPECT_EQ(info.params[1].field.type, probe.inputFields[1].type);
     EXPECT_EQ(info.params[2].field.type, probe.outputFields[0].type);
 }
+
+TEST_F(ProcedureMetadataTest, ProcedureCallReusesOnePrepare) {
+    ProcedureCall sum(*connection_, connection_->describeProcedure("PM_EXECUTABLE"));
+    EXPECT_EQ(sum.sql(), "EXECUTE PROCEDURE \"PM_EXECUTABLE\"(?,?)");
+    EXPECT_EQ(sum.inputCount(), 2u);
+    EXPECT_EQ(sum.outputCount(), 1u);
+
+    auto tx = connection_->StartTransaction();
+    const auto cacheBefore = connection_->getCacheStatistics().cacheSize;
+    for (int i = 0; i < 5; ++i) {
+        auto [total] = sum.call<std::tuple<int32_t>>(*tx, std::make_tuple(i, 10));
+        EXPECT_EQ(total, i + 10);
+    }
+    EXPECT_EQ(connection_->getCacheStatistics().cacheSize, cacheBefore);
+    EXPECT_THROW(sum.open(*tx, std::make_tuple(1, 2)), FirebirdException);
+
+    ProcedureCall rows(*connection_, "PM_SELECTABLE");
+    auto cursor = rows.open(*tx);
+    std::tuple<int32_t, std::string> row;
+    ASSERT_TRUE(cursor->fetch(row));
+    EXPECT_EQ(std::get<1>(row), "a");
+    ASSERT_TRUE(cursor->fetch(row));
+    EXPECT_EQ(std::get<0>(row), 2);
+    EXPECT_FALSE(cursor->fetch(row));
+    cursor->close();
+    EXPECT_THROW(rows.execute(*tx), FirebirdException);
+    tx->Commit();
+}
+
+TEST_F(ProcedureMetadataTest, ProcedureCallRejectsStaleInfo) {
+    auto info = connection_->describeProcedure("PM_EXECUTABLE");
+    info.params.erase(info.params.begin());    // As if IN_X had been added later
+    EXPECT_THROW(ProcedureCall(*connection_, info), FirebirdException);
+}
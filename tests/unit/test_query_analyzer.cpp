@@ -68,6 +68,29 @@ TEST(QueryAnalyzerClassify, LeadingWhitespace) {
               QueryKind::select_query);
 }
 
+TEST(QueryAnalyzerPlan, NaturalScanTablesDetailedPlan) {
+    const auto tables = QueryAnalyzer::naturalScanTables(
+        "\nSelect Expression\n"
+        "    -> Nested Loop Join (inner)\n"
+        "        -> Table \"ORDERS\" as \"O\" Full Scan\n"
+        "        -> Filter\n"
+        "            -> Table \"CUSTOMERS\" as \"C\" Access By ID\n"
+        "                -> Bitmap\n"
+        "                    -> Index \"PK_CUSTOMERS\" Unique Scan\n"
+        "        -> Table \"ORDERS\" Full Scan\n");
+    ASSERT_EQ(tables.size(), 1u);   // Each table once
+    EXPECT_EQ(tables[0], "ORDERS");
+}
+
+TEST(QueryAnalyzerPlan, NaturalScanTablesLegacyPlan) {
+    const auto tables = QueryAnalyzer::naturalScanTables(
+        "PLAN JOIN (O NATURAL, C INDEX (PK_CUSTOMERS), L NATURAL)");
+    ASSERT_EQ(tables.size(), 2u);
+    EXPECT_EQ(tables[0], "O");
+    EXPECT_EQ(tables[1], "L");
+    EXPECT_TRUE(QueryAnalyzer::naturalScanTables("PLAN (T INDEX (T_PK))").empty());
+}
+
 // ============================================================================
 // Integration tests — require live DB via TempDatabaseTest
 // ============================================================================
@@ -245,3 +268,55 @@ TEST_F(QueryAnalyzerPipelineTest, MultipleNamedParamsPreserveAllNames) {
     EXPECT_EQ(specs[0].inputs[1].sqlName, "row_name");
     EXPECT_EQ(specs[0].inputs[1].memberName, "rowName");
 }
+
+// ============================================================================
+// Plan capture — NATURAL scans flagged by unique-index row estimates
+// ============================================================================
+
+class QueryAnalyzerPlanTest : public TempDatabaseTest {
+protected:
+    void createTestSchema() override {
+        TempDatabaseTest::createTestSchema();
+        connection_->ExecuteDDL(
+            "CREATE TABLE plan_big (id INTEGER NOT NULL, note VARCHAR(20),"
+            " CONSTRAINT pk_plan_big PRIMARY KEY (id))");
+        auto tx = connection_->StartTransaction();
+        connection_->ExecuteInTransaction(tx.get(),
+            "EXECUTE BLOCK AS DECLARE i INTEGER = 0; BEGIN"
+            " WHILE (i < 50) DO BEGIN INSERT INTO plan_big VALUES (:i, 'n'); i = i + 1; END END");
+        tx->Commit();
+        connection_->ExecuteDDL("SET STATISTICS INDEX pk_plan_big");
+    }
+};
+
+TEST_F(QueryAnalyzerPlanTest, CapturesPlanAndFlagsLargeNaturalScans) {
+    QueryAnalyzer analyzer(*connection_);
+    EXPECT_TRUE(analyzer.analyze("SELECT id FROM plan_big").plan.empty());   // Off by default
+
+    QueryAnalysisOptions options;
+    options.capturePlan = true;
+    options.largeTableRows = 20;
+    auto scan = analyzer.analyze("SELECT id, note FROM plan_big WHERE note = :note", options);
+    EXPECT_FALSE(scan.plan.empty());
+    ASSERT_EQ(scan.naturalScans.size(), 1u);
+    EXPECT_EQ(scan.naturalScans[0].table, "PLAN_BIG");
+    ASSERT_TRUE(scan.naturalScans[0].estimatedRows.has_value());
+    EXPECT_EQ(*scan.naturalScans[0].estimatedRows, 50u);
+    EXPECT_TRUE(scan.naturalScans[0].large);
+
+    auto lookup = analyzer.analyze("SELECT note FROM plan_big WHERE id = :id", options);
+    EXPECT_FALSE(lookup.plan.empty());
+    EXPECT_TRUE(lookup.naturalScans.empty());
+}
+
+TEST_F(QueryAnalyzerPlanTest, PlanReportMarksOnlyLargeScans) {
+    fbpp::core::QueryGeneratorService svc(*connection_);
+    auto specs = svc.buildQuerySpecs({{"ByNote", "SELECT id FROM plan_big WHERE note = :note"},
+                                      {"ById", "SELECT note FROM plan_big WHERE id = :id"}});
+    ASSERT_EQ(specs.size(), 2u);
+
+    const auto report = fbpp::core::renderQueryPlanReport(specs, 20);
+    EXPECT_LT(report.find("== ById\n"), report.find("== ByNote\n"));
+    EXPECT_NE(report.find("!! NATURAL scan of large table PLAN_BIG"), std::string::npos);
+    EXPECT_EQ(fbpp::core::renderQueryPlanReport(specs).find("!!"), std::string::npos);   // 50 < 10000
+}
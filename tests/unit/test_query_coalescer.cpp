@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/query_coalescer.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/transaction_options.hpp"
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// QueryCoalescer — concurrent identical queries run once and share the snapshot.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+using namespace std::chrono_literals;
+
+class QueryCoalescerTest : public TempDatabaseTest {
+protected:
+    static constexpr int kCallers = 4;
+
+    void createTestSchema() override {
+        TempDatabaseTest::createTestSchema();
+        connection_->ExecuteDDL(
+            "CREATE TABLE qco_ref (id INTEGER NOT NULL PRIMARY KEY, name VARCHAR(20))");
+        auto tx = connection_->StartTransaction();
+        connection_->ExecuteInTransaction(tx.get(), "INSERT INTO qco_ref VALUES (1, 'one')");
+        connection_->ExecuteInTransaction(tx.get(), "INSERT INTO qco_ref VALUES (2, 'two')");
+        tx->Commit();
+    }
+
+    // Waits while another transaction has the row updated: keeps the leader running
+    static constexpr const char* kLocked =
+        "SELECT id, name FROM qco_ref WHERE id = ? FOR UPDATE WITH LOCK";
+
+    // Holds row 1 until the returned transaction ends
+    std::shared_ptr<Transaction> lockRowOne() {
+        auto tx = connection_->StartTransaction();
+        connection_->ExecuteInTransaction(tx.get(),
+                                          "UPDATE qco_ref SET name = 'uno' WHERE id = 1");
+        return tx;
+    }
+
+    static void waitFor(const std::function<bool()>& condition) {
+        const auto deadline = std::chrono::steady_clock::now() + 10s;
+        while (!condition()) {
+            ASSERT_LT(std::chrono::steady_clock::now(), deadline);
+            std::this_thread::sleep_for(1ms);
+        }
+    }
+};
+
+TEST_F(QueryCoalescerTest, ConcurrentDuplicatesShareOneRun) {
+    auto writer = lockRowOne();
+    QueryCoalescer coalescer;
+
+    std::vector<std::unique_ptr<Connection>> connections;
+    std::vector<std::future<std::shared_ptr<const ResultSnapshot>>> calls;
+    for (int i = 0; i < kCallers; ++i) {
+        connections.push_back(std::make_unique<Connection>(db_params_));
+        Connection* connection = connections.back().get();
+        calls.push_back(std::async(std::launch::async, [&, connection] {
+            auto tx = connection->StartTransaction();
+            auto rows = coalescer.query(*connection, *tx, kLocked, std::make_tuple(1));
+            tx->Commit();
+            return rows;
+        }));
+    }
+    waitFor([&] {
+        const auto stats = coalescer.stats();
+        return stats.inFlight == 1 && stats.waiting == kCallers - 1;
+    });
+
+    // Other parameters are another run, not a join
+    auto tx = connection_->StartTransaction();
+    auto two = coalescer.query(*connection_, *tx, kLocked, std::make_tuple(2));
+    tx->Commit();
+    ASSERT_EQ(two->rowCount(), 1u);
+    EXPECT_EQ(two->row(0).get<std::string>("NAME"), "two");
+
+    writer->Rollback();
+    auto first = calls[0].get();
+    for (int i = 1; i < kCallers; ++i) {
+        EXPECT_EQ(calls[i].get(), first);
+    }
+    ASSERT_EQ(first->rowCount(), 1u);
+    EXPECT_EQ(first->row(0).get<std::string>("NAME"), "one");
+
+    auto stats = coalescer.stats();
+    EXPECT_EQ(stats.runs, 2u);
+    EXPECT_EQ(stats.joined, static_cast<std::size_t>(kCallers - 1));
+    EXPECT_EQ(stats.inFlight, 0u);
+    EXPECT_EQ(stats.waiting, 0u);
+
+    // Nothing is kept once the run is over
+    tx = connection_->StartTransaction();
+    EXPECT_NE(coalescer.query(*connection_, *tx, kLocked, std::make_tuple(1)), first);
+    tx->Commit();
+    EXPECT_EQ(coalescer.stats().runs, 3u);
+}
+
+TEST_F(QueryCoalescerTest, FailedRunFailsEveryJoinedCall) {
+    auto writer = lockRowOne();
+    QueryCoalescer coalescer;
+
+    // Attached up front, so the joining calls start well within the timeout
+    std::vector<std::unique_ptr<Connection>> connections;
+    for (int i = 1; i < kCallers; ++i) {
+        connections.push_back(std::make_unique<Connection>(db_params_));
+    }
+
+    // The leader gives up on the lock after two seconds
+    Connection leaderConnection(db_params_);
+    auto leader = std::async(std::launch::async, [&] {
+        auto tx = leaderConnection.StartTransaction(TransactionOptions::lockTimeout(2));
+        auto rows = coalescer.query(leaderConnection, *tx, kLocked, std::make_tuple(1));
+        tx->Commit();
+        return rows;
+    });
+    waitFor([&] { return coalescer.stats().inFlight == 1; });
+
+    std::vector<std::future<std::shared_ptr<const ResultSnapshot>>> joined;
+    for (auto& owned : connections) {
+        Connection* connection = owned.get();
+        joined.push_back(std::async(std::launch::async, [&, connection] {
+            auto tx = connection->StartTransaction(TransactionOptions::lockTimeout(2));
+            auto rows = coalescer.query(*connection, *tx, kLocked, std::make_tuple(1));
+            tx->Commit();
+            return rows;
+        }));
+    }
+
+    EXPECT_THROW(leader.get(), FirebirdException);
+    for (auto& call : joined) {
+        EXPECT_THROW(call.get(), FirebirdException);
+    }
+    writer->Rollback();
+
+    const auto stats = coalescer.stats();
+    EXPECT_EQ(stats.runs, 1u);
+    EXPECT_EQ(stats.failures, 1u);
+    EXPECT_EQ(stats.joined, static_cast<std::size_t>(kCallers - 1));
+}
@@ -2,6 +2,7 @@
 #include "../test_base.hpp"
 #include "fbpp/core/connection.hpp"
 #include "fbpp/core/exception.hpp"
+#include <chrono>
 #include <filesystem>
 #include <fstream>
 #include <cstdlib>
@@ -125,10 +126,39 @@ TEST_F(QueryGeneratorTest, GeneratesHeadersForSelect) {
     EXPECT_NE(mainContents.find("fbpp::core::TimeTz"), std::string::npos);
     EXPECT_NE(mainContents.find("fbpp::core::TimestampTz"), std::string::npos);
     EXPECT_NE(mainContents.find("fbpp::core::Blob"), std::string::npos);
+    EXPECT_NE(mainContents.find("struct SelectAllColumns"), std::string::npos);
+    EXPECT_NE(mainContents.find("std::array<fbpp::core::ColumnType, 20> columnTypes"),
+              std::string::npos);
+    EXPECT_NE(mainContents.find("fbpp::core::ColumnArray<std::array<std::uint8_t, 16>>"),
+              std::string::npos);
+    EXPECT_NE(mainContents.find("using Columns = SelectAllColumns;"), std::string::npos);
+    EXPECT_NE(mainContents.find("enum class SelectAllCol : unsigned {\n    ID,\n    F_BIGINT,"),
+              std::string::npos);
+    EXPECT_NE(mainContents.find("enum class SelectAllParam : unsigned {\n    ID\n};"),
+              std::string::npos);
+    EXPECT_NE(mainContents.find("using Col = SelectAllCol;"), std::string::npos);
 
     auto supportContents = slurp(supportHeader);
     EXPECT_NE(supportContents.find("StructDescriptor<generated::queries::SelectAllIn>"), std::string::npos);
     EXPECT_NE(supportContents.find("StructDescriptor<generated::queries::SelectAllOut>"), std::string::npos);
+    EXPECT_NE(supportContents.find("static constexpr bool pinned_decode = true;"), std::string::npos);
+    EXPECT_NE(supportContents.find("static constexpr std::uint64_t layout_hash = 0x"), std::string::npos);
+    EXPECT_NE(supportContents.find("static constexpr std::array<unsigned, 20> offsets"), std::string::npos);
+    EXPECT_NE(supportContents.find("static constexpr std::array<unsigned, 1> null_offsets"), std::string::npos);
+    EXPECT_NE(supportContents.find("fbpp::core::QueryStream<SelectAllOut> stream("), std::string::npos);
+    EXPECT_NE(supportContents.find("SelectAllColumns fetchColumns("), std::string::npos);
+    EXPECT_NE(supportContents.find("#include \"fbpp/core/query_fields.hpp\""), std::string::npos);
+    EXPECT_NE(supportContents.find("struct QueryFields<generated::queries::SelectAllCol>"),
+              std::string::npos);
+    EXPECT_NE(supportContents.find("std::array<QueryFieldInfo, 20> fields"), std::string::npos);
+    // Column value types without the optional; get<>() adds it
+    EXPECT_NE(supportContents.find("struct QueryField<generated::queries::SelectAllCol::F_BOOLEAN> {\n"
+                                   "    using type = bool;\n"
+                                   "    static constexpr unsigned index = 2;"),
+              std::string::npos);
+    EXPECT_NE(supportContents.find("static constexpr std::array<std::size_t, 1> positions = {0};"),
+              std::string::npos);
+    EXPECT_EQ(supportContents.find("executeMany("), std::string::npos);   // SELECT only
 
     fs::remove_all(tempDir);
 }
@@ -174,3 +204,130 @@ TEST_F(QueryGeneratorTest, GeneratesChronoHeadersKeepingTimeTzRaw) {
 
     fs::remove_all(tempDir);
 }
+
+TEST_F(QueryGeneratorTest, GeneratesCoercedOutputTypes) {
+    namespace fs = std::filesystem;
+
+    fs::path tempDir = fs::temp_directory_path() / "fbpp_query_gen_coercion_test";
+    fs::remove_all(tempDir);
+    fs::create_directories(tempDir);
+
+    fs::path inputJson = tempDir / "queries.json";
+    std::ofstream inputFile(inputJson);
+    inputFile << R"({
+        "SelectCoerced": "SELECT F_NUMERIC, F_DECFLOAT, F_TIMESHTAMP_TZ FROM TABLE_TEST_1 WHERE ID = :id",
+        "SelectPlain": "SELECT ID FROM TABLE_TEST_1 WHERE ID = :id"
+    })";
+    inputFile.close();
+
+    fs::path outputHeader = tempDir / "queries.generated.hpp";
+    fs::path supportHeader = tempDir / "queries.structs.generated.hpp";
+
+    fs::path generatorExe = fs::path(QUERY_GENERATOR_EXE);
+    ASSERT_TRUE(fs::exists(generatorExe)) << "query_generator executable not found";
+
+    const auto rc = runProcess(generatorExe, {
+        "--dsn", db_params_.database,
+        "--user", db_params_.user,
+        "--password", db_params_.password,
+        "--charset", db_params_.charset,
+        "--input", inputJson.string(),
+        "--output", outputHeader.string(),
+        "--support", supportHeader.string(),
+        "--output-coercion", "numeric=double;decfloat=varchar;timezone=timestamp"
+    });
+    ASSERT_EQ(rc, 0) << "Generator failed with exit code " << rc;
+
+    auto mainContents = slurp(outputHeader);
+    const auto coerced = mainContents.find("QueryDescriptor<QueryId::SelectCoerced>");
+    const auto plain = mainContents.find("QueryDescriptor<QueryId::SelectPlain>");
+    ASSERT_NE(coerced, std::string::npos);
+    ASSERT_NE(plain, std::string::npos);
+    const auto line = mainContents.find(
+        "static constexpr std::string_view outputCoercion = "
+        "\"NUMERIC=DOUBLE;DECFLOAT=VARCHAR;TIMEZONE=TIMESTAMP\"");
+    ASSERT_NE(line, std::string::npos);
+    EXPECT_EQ(mainContents.find("outputCoercion", line + 1), std::string::npos);   // Plain: none
+    EXPECT_EQ(mainContents.find("fbpp::core::DecFloat34"), std::string::npos);
+    EXPECT_EQ(mainContents.find("fbpp::core::TimestampTz"), std::string::npos);
+    EXPECT_NE(mainContents.find("std::optional<double>"), std::string::npos);
+    EXPECT_NE(mainContents.find("fbpp::core::Timestamp"), std::string::npos);
+
+    fs::remove_all(tempDir);
+}
+
+TEST_F(QueryGeneratorTest, CachedParallelRunLeavesHeadersUntouched) {
+    namespace fs = std::filesystem;
+
+    fs::path tempDir = fs::temp_directory_path() / "fbpp_query_gen_cache_test";
+    fs::remove_all(tempDir);
+    fs::create_directories(tempDir);
+
+    fs::path inputJson = tempDir / "queries.json";
+    {
+        std::ofstream inputFile(inputJson);
+        inputFile << R"({
+            "SelectById": "SELECT ID, F_VARCHAR FROM TABLE_TEST_1 WHERE ID = :id",
+            "SelectByInt": "SELECT ID FROM TABLE_TEST_1 WHERE F_INTEGER = :value",
+            "CountAll": "SELECT COUNT(*) FROM TABLE_TEST_1",
+            "DeleteById": "DELETE FROM TABLE_TEST_1 WHERE ID = :id"
+        })";
+    }
+
+    fs::path outputHeader = tempDir / "queries.generated.hpp";
+    fs::path supportHeader = tempDir / "queries.structs.generated.hpp";
+    fs::path cacheFile = tempDir / "queries.cache.json";
+
+    fs::path generatorExe = fs::path(QUERY_GENERATOR_EXE);
+    ASSERT_TRUE(fs::exists(generatorExe)) << "query_generator executable not found";
+
+    auto run = [&](std::vector<std::string> extra) {
+        std::vector<std::string> args = {
+            "--dsn", db_params_.database,
+            "--user", db_params_.user,
+            "--password", db_params_.password,
+            "--charset", db_params_.charset,
+            "--input", inputJson.string(),
+            "--output", outputHeader.string(),
+            "--support", supportHeader.string(),
+            "--cache", cacheFile.string()
+        };
+        args.insert(args.end(), extra.begin(), extra.end());
+        return runProcess(generatorExe, args);
+    };
+
+    ASSERT_EQ(run({"--jobs", "3"}), 0);
+    ASSERT_TRUE(fs::exists(cacheFile));
+    const auto mainContents = slurp(outputHeader);
+    EXPECT_NE(mainContents.find("struct SelectByIdIn"), std::string::npos);
+    EXPECT_NE(mainContents.find("QueryDescriptor<QueryId::DeleteById>"), std::string::npos);
+
+    // Push the timestamps into the past so an unneeded rewrite would show
+    const auto past = fs::last_write_time(outputHeader) - std::chrono::hours(1);
+    fs::last_write_time(outputHeader, past);
+    fs::last_write_time(supportHeader, past);
+
+    ASSERT_EQ(run({}), 0);
+    EXPECT_EQ(fs::last_write_time(outputHeader), past);
+    EXPECT_EQ(fs::last_write_time(supportHeader), past);
+    EXPECT_EQ(slurp(outputHeader), mainContents);
+
+    // A new definition is prepared, the rest still come from the cache
+    {
+        std::ofstream inputFile(inputJson);
+        inputFile << R"({
+            "SelectById": "SELECT ID, F_VARCHAR FROM TABLE_TEST_1 WHERE ID = :id",
+            "SelectByInt": "SELECT ID FROM TABLE_TEST_1 WHERE F_INTEGER = :value",
+            "CountAll": "SELECT COUNT(*) FROM TABLE_TEST_1",
+            "DeleteById": "DELETE FROM TABLE_TEST_1 WHERE ID = :id",
+            "SelectDate": "SELECT F_DATE FROM TABLE_TEST_1 WHERE ID = :id"
+        })";
+    }
+    ASSERT_EQ(run({"--jobs", "2"}), 0);
+    EXPECT_NE(fs::last_write_time(outputHeader), past);
+    EXPECT_NE(slurp(outputHeader).find("struct SelectDateOut"), std::string::npos);
+
+    EXPECT_NE(run({"--jobs", "0"}), 0);
+
+    fs::remove_all(tempDir);
+}
@@ -3,12 +3,14 @@
 #include "queries.generated.hpp"
 #include "fbpp/core/exception.hpp"
 #include "fbpp/core/firebird_compat.hpp"
+#include "fbpp/core/pack_plan.hpp"
 
 #include <chrono>
 #include <optional>
 #include <iostream>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 using namespace fbpp::test;
 
@@ -232,3 +234,69 @@ TEST_F(QueryGeneratorIntegrationTest, ReturningInsertYieldsGeneratedId) {
         FAIL() << "std::exception: " << e.what();
     }
 }
+
+// The generated descriptors carry the layout described at build time; against
+// the same schema it matches, so rows go through the constant-offset paths.
+TEST_F(QueryGeneratorIntegrationTest, GeneratedLayoutMatchesLiveMetadata) {
+    using namespace generated::queries;
+    using S = QueryDescriptor<QueryId::TABLE_TEST_1_S>;
+
+    auto statement = connection_->prepareStatement(std::string(S::sql));
+    const auto input = statement->getInputMetadata();
+    const auto output = statement->getOutputMetadata();
+    ASSERT_TRUE(input);
+    ASSERT_TRUE(output);
+
+    EXPECT_EQ(input->getLayout()->layoutHash,
+              fbpp::core::StructDescriptor<S::Input>::layout_hash);
+    EXPECT_EQ(output->getLayout()->layoutHash,
+              fbpp::core::StructDescriptor<S::Output>::layout_hash);
+    EXPECT_TRUE(fbpp::core::PackPlan<S::Input>::of(*input).exact());
+    EXPECT_TRUE(fbpp::core::detail::PinnedLayout<S::Output>::of(*output).exact());
+
+    const auto& fields = output->getLayout()->fields;
+    const auto& offsets = fbpp::core::StructDescriptor<S::Output>::offsets;
+    ASSERT_EQ(fields.size(), offsets.size());
+    for (std::size_t i = 0; i < fields.size(); ++i) {
+        EXPECT_EQ(fields[i].offset, offsets[i]) << "column " << i;
+    }
+}
+
+// executeMany() sends all rows in one batch; stream() walks the result
+// through a prefetching cursor without collecting it first.
+TEST_F(QueryGeneratorIntegrationTest, BatchInsertAndStreamedSelect) {
+    using namespace generated::queries;
+    const auto suffix = static_cast<std::int32_t>(
+        std::chrono::high_resolution_clock::now().time_since_epoch().count() % 1000000);
+    const std::int32_t testInteger = 800000 + suffix;
+    const std::string label = "bulk_row_" + std::to_string(suffix);
+
+    auto transaction = connection_->StartTransaction();
+
+    std::vector<TABLE_TEST_1_IIn> rows(50);
+    for (auto& row : rows) {
+        assignField(row.fInteger, testInteger);
+        assignField(row.fVarchar, label);
+        assignField(row.fBoolean, false);
+    }
+    const auto result = executeMany(*connection_, *transaction,
+                                    std::span<const TABLE_TEST_1_IIn>(rows));
+    EXPECT_EQ(result.totalMessages, 50u);
+    EXPECT_EQ(result.successCount, 50u);
+    EXPECT_EQ(result.failedCount, 0u);
+
+    TABLE_TEST_1_SIn filter{};
+    assignField(filter.fInteger, testInteger);
+    assignField(filter.fVarchar, label);
+    auto rowsStream = stream(*connection_, *transaction, filter, 16);
+    EXPECT_EQ(rowsStream.cursor().getPrefetch(), 16u);
+    std::size_t seen = 0;
+    for (const auto& row : rowsStream) {
+        expectFieldEquals(row.fVarchar, label);
+        ++seen;
+    }
+    EXPECT_EQ(seen, 50u);
+
+    EXPECT_EQ(executeMany(*connection_, *transaction, std::span<const TABLE_TEST_1_IIn>()).totalMessages, 0u);
+    transaction->Rollback();
+}
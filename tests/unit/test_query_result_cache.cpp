@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/query_result_cache.hpp"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <tuple>
+
+// QueryResultCache — snapshots keyed by normalized SQL and packed parameters.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+class QueryResultCacheTest : public TempDatabaseTest {
+protected:
+    void createTestSchema() override {
+        TempDatabaseTest::createTestSchema();
+        connection_->ExecuteDDL(
+            "CREATE TABLE qrc_ref (id INTEGER NOT NULL PRIMARY KEY, name VARCHAR(20))");
+        auto tx = connection_->StartTransaction();
+        connection_->ExecuteInTransaction(tx.get(), "INSERT INTO qrc_ref VALUES (1, 'one')");
+        connection_->ExecuteInTransaction(tx.get(), "INSERT INTO qrc_ref VALUES (2, 'two')");
+        tx->Commit();
+    }
+
+    static constexpr const char* kLookup = "SELECT id, name FROM qrc_ref WHERE id = ?";
+};
+
+TEST_F(QueryResultCacheTest, HitsOnSameSqlAndParameterBytes) {
+    QueryResultCache cache;
+    auto tx = connection_->StartTransaction();
+
+    auto first = cache.query(*connection_, *tx, kLookup, std::make_tuple(1));
+    ASSERT_EQ(first->rowCount(), 1u);
+    EXPECT_EQ(first->row(0).get<std::string>("NAME"), "one");
+
+    auto again = cache.query(*connection_, *tx, "select ID, NAME\n  from QRC_REF where ID = ?",
+                             std::make_tuple(1));
+    EXPECT_EQ(again, first);                       // Same entry, no second fetch
+    auto other = cache.query(*connection_, *tx, kLookup, std::make_tuple(2));
+    EXPECT_NE(other, first);
+    EXPECT_EQ(other->row(0).get<std::string>("NAME"), "two");
+    auto none = cache.query(*connection_, *tx, kLookup, std::make_tuple(3));
+    EXPECT_TRUE(none->empty());
+    tx->Commit();
+
+    const auto stats = cache.stats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 3u);
+    EXPECT_EQ(stats.entries, 3u);
+    EXPECT_GT(stats.bytes, 0u);
+}
+
+TEST_F(QueryResultCacheTest, InvalidatesByTableAndExpires) {
+    QueryResultCache cache;
+    auto tx = connection_->StartTransaction();
+    cache.query(*connection_, *tx, "SELECT COUNT(*) FROM qrc_ref",
+                QueryCacheHints{std::nullopt, {"qrc_ref"}});        // Dependency given by hand
+    auto byId = cache.query(*connection_, *tx, kLookup, std::make_tuple(1));
+    connection_->ExecuteInTransaction(tx.get(), "UPDATE qrc_ref SET name = 'uno' WHERE id = 1");
+
+    // Stale until told otherwise; both entries depend on QRC_REF
+    EXPECT_EQ(cache.query(*connection_, *tx, kLookup, std::make_tuple(1)), byId);
+    EXPECT_EQ(cache.invalidateTable(" Qrc_Ref "), 2u);
+    auto fresh = cache.query(*connection_, *tx, kLookup, std::make_tuple(1));
+    EXPECT_EQ(fresh->row(0).get<std::string>("NAME"), "uno");
+    EXPECT_EQ(byId->row(0).get<std::string>("NAME"), "one");   // Callers keep their snapshot
+
+    QueryCacheHints shortLived;
+    shortLived.ttl = std::chrono::milliseconds(1);
+    auto brief = cache.query(*connection_, *tx, kLookup, std::make_tuple(2), shortLived);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_NE(cache.query(*connection_, *tx, kLookup, std::make_tuple(2)), brief);
+    tx->Commit();
+
+    const auto stats = cache.stats();
+    EXPECT_EQ(stats.invalidations, 2u);
+    EXPECT_EQ(stats.expirations, 1u);
+}
+
+TEST_F(QueryResultCacheTest, EvictsLeastRecentlyUsedBySize) {
+    auto tx = connection_->StartTransaction();
+    QueryResultCache probe;
+    const auto entryBytes = [&] {
+        probe.query(*connection_, *tx, kLookup, std::make_tuple(1));
+        return probe.stats().bytes;
+    }();
+
+    QueryResultCacheOptions options;
+    options.maxBytes = entryBytes * 2;
+    QueryResultCache cache(options);
+    auto one = cache.query(*connection_, *tx, kLookup, std::make_tuple(1));
+    cache.query(*connection_, *tx, kLookup, std::make_tuple(2));
+    EXPECT_EQ(cache.query(*connection_, *tx, kLookup, std::make_tuple(1)), one);   // 1 is now newest
+    cache.query(*connection_, *tx, kLookup, std::make_tuple(3));                   // Evicts 2
+
+    EXPECT_EQ(cache.stats().evictions, 1u);
+    EXPECT_EQ(cache.query(*connection_, *tx, kLookup, std::make_tuple(1)), one);
+    tx->Commit();
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include "fbpp/core/batch.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/message_builder.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp_util/replay_backend.hpp"
+
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Replay backend — recorded messages served through the ordinary
+// Statement / ResultSet / Batch wrappers, no server involved.
+
+using namespace fbpp::core;
+using fbpp::util::RecordedMessages;
+using fbpp::util::ReplayCapture;
+using fbpp::util::ReplaySession;
+
+namespace {
+
+std::shared_ptr<const MessageMetadata> idLabelMetadata() {
+    MessageBuilder builder(2);
+    builder.addField<int32_t>("ID");
+    builder.addFieldWithLength<std::string>("LABEL", 16);
+    return std::shared_ptr<const MessageMetadata>(builder.build());
+}
+
+// Messages packed by a replay batch, i.e. by the real Batch packing
+std::shared_ptr<RecordedMessages> recordRows(ReplaySession& session,
+                                             const std::vector<std::tuple<int32_t, std::string>>& rows) {
+    auto metadata = idLabelMetadata();
+    auto layout = std::make_shared<RecordedMessages>(*metadata);
+    auto capture = std::make_shared<ReplayCapture>(true);
+    auto insert = session.prepareInsert(layout, capture);
+
+    auto batch = insert->createBatch(session.transaction().get());
+    batch->addMany(rows);
+    batch->execute(session.transaction().get());
+
+    auto recording = std::make_shared<RecordedMessages>(*metadata);
+    const auto bytes = capture->data();
+    for (size_t offset = 0; offset < bytes.size(); offset += recording->messageLength()) {
+        recording->add(bytes.data() + offset);
+    }
+    return recording;
+}
+
+} // namespace
+
+TEST(ReplayBackendTest, BatchPacksAndCursorDecodes) {
+    ReplaySession session;
+    const std::vector<std::tuple<int32_t, std::string>> rows{{1, "one"}, {2, "two"}, {3, "three"}};
+    auto recording = recordRows(session, rows);
+    ASSERT_EQ(recording->rowCount(), rows.size());
+
+    auto select = session.prepare(recording);
+    auto cursor = session.transaction()->openCursor(select);
+    std::tuple<int32_t, std::string> row;
+    std::vector<std::tuple<int32_t, std::string>> fetched;
+    while (cursor->fetch(row)) {
+        fetched.push_back(row);
+    }
+    EXPECT_EQ(fetched, rows);
+    cursor->close();
+}
+
+TEST(ReplayBackendTest, SelectOneServesASingleRecordedRow) {
+    ReplaySession session;
+    auto* tx = session.transaction().get();
+    using Row = std::tuple<int32_t, std::string>;
+
+    auto one = session.prepare(recordRows(session, {{4, "four"}}));
+    EXPECT_EQ(one->selectOne<Row>(tx), Row(4, "four"));
+
+    auto none = session.prepare(std::make_shared<RecordedMessages>(*idLabelMetadata()));
+    EXPECT_FALSE(none->selectOne<Row>(tx).has_value());
+
+    auto two = session.prepare(recordRows(session, {{1, "one"}, {2, "two"}}));
+    EXPECT_THROW(two->selectOne<Row>(tx), FirebirdException);
+}
+
+TEST(ReplayBackendTest, RepeatServesRecordingAgain) {
+    ReplaySession session;
+    auto recording = recordRows(session, {{7, "seven"}, {8, "eight"}});
+
+    auto select = session.prepare(recording, 50);
+    auto cursor = session.transaction()->openCursor(select);
+    size_t count = 0;
+    int64_t sum = 0;
+    for (const auto& row : cursor->rows()) {
+        sum += row.get<int32_t>(0).value();
+        ++count;
+    }
+    EXPECT_EQ(count, 100u);
+    EXPECT_EQ(sum, 50 * (7 + 8));
+}
+
+TEST(ReplayBackendTest, MetadataMatchesRecordedLayout) {
+    ReplaySession session;
+    auto recording = recordRows(session, {{1, "x"}});
+    auto select = session.prepare(recording);
+
+    auto metadata = select->getOutputMetadata();
+    ASSERT_EQ(metadata->getCount(), 2u);
+    EXPECT_EQ(metadata->getFieldName(1), "LABEL");
+    EXPECT_EQ(metadata->getMessageLength(), recording->messageLength());
+    EXPECT_EQ(metadata->getOffset(1), recording->fields()[1].offset);
+    EXPECT_EQ(select->kind(), Statement::StatementKind::Select);
+}
+
+TEST(ReplayBackendTest, CaptureCountsWithoutKeeping) {
+    ReplaySession session;
+    auto metadata = idLabelMetadata();
+    auto layout = std::make_shared<RecordedMessages>(*metadata);
+    auto capture = std::make_shared<ReplayCapture>();
+    auto insert = session.prepareInsert(layout, capture);
+
+    EXPECT_EQ(session.transaction()->execute(insert, std::make_tuple(int32_t{5}, std::string("five"))), 1u);
+    auto batch = insert->createBatch(session.transaction().get());
+    batch->add(std::make_tuple(int32_t{6}, std::string("six")));
+    batch->add(std::make_tuple(int32_t{7}, std::string("seven")));
+    const auto result = batch->execute(session.transaction().get());
+
+    EXPECT_EQ(result.totalMessages, 2u);
+    EXPECT_EQ(capture->messages(), 3u);
+    EXPECT_EQ(capture->bytes(), 3u * layout->messageLength());
+    EXPECT_TRUE(capture->data().empty());
+}
+
+TEST(ReplayBackendTest, BlobAccessThrows) {
+    ReplaySession session;
+    ISC_QUAD id{};
+    EXPECT_THROW(session.transaction()->openBlob(id), FirebirdException);
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/pool/replica_router.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/exception.hpp"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+// ReplicaRouter: read-only routing, least-outstanding balancing,
+// heartbeat lag checks and primary fallback. The "replicas" here are the
+// primary's own database (no lag) or a database nothing replicates to.
+
+using namespace fbpp::core;
+using namespace fbpp::pool;
+using namespace fbpp::test;
+using namespace std::chrono_literals;
+
+namespace {
+
+ReplicaRouterOptions manualOptions() {
+    ReplicaRouterOptions options;
+    options.pool.reapInterval = 0ms;
+    options.pool.acquireTimeout = 200ms;
+    options.checkInterval = 0ms;   // Tests call checkReplicas()
+    return options;
+}
+
+} // namespace
+
+class ReplicaRouterTest : public TempDatabaseTest {};
+
+TEST_F(ReplicaRouterTest, RoutesByTransactionAccessMode) {
+    ReplicaRouter router(db_params_, {db_params_, db_params_}, 0, 4, manualOptions());
+    ASSERT_EQ(router.replicaCount(), 2u);
+
+    auto write = router.acquire(TransactionOptions{});
+    EXPECT_FALSE(write.replica().has_value());
+
+    const auto readOnly = TransactionOptions::readOnlyReadCommitted();
+    auto read = router.acquire(readOnly);
+    ASSERT_TRUE(read);
+    ASSERT_TRUE(read.replica().has_value());
+    auto tx = read->StartTransaction(readOnly);
+    tx->Commit();
+
+    const auto stats = router.stats();
+    EXPECT_EQ(stats.primary.outstanding, 1u);
+    EXPECT_EQ(stats.replicas[*read.replica()].outstanding, 1u);
+    EXPECT_EQ(stats.primaryFallbacks, 0u);
+}
+
+TEST_F(ReplicaRouterTest, BalancesByOutstandingLeases) {
+    ReplicaRouter router(db_params_, {db_params_, db_params_}, 0, 4, manualOptions());
+    auto first = router.acquireReplica();
+    auto second = router.acquireReplica();
+    ASSERT_TRUE(first.replica() && second.replica());
+    EXPECT_NE(*first.replica(), *second.replica());
+
+    const size_t freed = *first.replica();
+    first.release();
+    EXPECT_EQ(router.stats().replicas[freed].outstanding, 0u);
+    auto third = router.acquireReplica();
+    EXPECT_EQ(third.replica().value_or(99), freed);
+}
+
+TEST_F(ReplicaRouterTest, MeasuresLagWithHeartbeats) {
+    // Replica 1 is a database of its own: it never sees the primary's beats
+    auto stale = makeScopedTestDatabaseParams("replica_router_stale");
+    recreateTestDatabase(stale);
+    {
+        Connection conn(stale);
+        conn.ExecuteDDL("CREATE TABLE FBPP_HEARTBEAT (ID SMALLINT NOT NULL PRIMARY KEY, "
+                        "BEAT BIGINT NOT NULL)");
+    }
+    {
+        auto options = manualOptions();
+        options.maxLag = 50ms;
+        ReplicaRouter router(db_params_, {db_params_, stale}, 0, 4, options);
+        EXPECT_EQ(router.stats().replicas[0].lag.value_or(1h), 0ms);
+
+        std::this_thread::sleep_for(100ms);
+        EXPECT_EQ(router.checkReplicas(), 1u);
+        const auto stats = router.stats();
+        EXPECT_TRUE(stats.replicas[0].healthy);
+        EXPECT_FALSE(stats.replicas[1].healthy);
+        ASSERT_TRUE(stats.replicas[1].lag.has_value());
+        EXPECT_GE(*stats.replicas[1].lag, 50ms);
+
+        // Reads avoid the lagging replica
+        for (int i = 0; i < 4; ++i) {
+            EXPECT_EQ(router.acquireReplica().replica().value_or(99), 0u);
+        }
+    }
+    dropTestDatabaseQuietly(stale);
+}
+
+TEST_F(ReplicaRouterTest, FallsBackToPrimary) {
+    auto broken = db_params_;
+    broken.password = "__wrong__";
+    ReplicaRouter router(db_params_, {broken}, 0, 2, manualOptions());
+    EXPECT_FALSE(router.stats().replicas[0].healthy);
+
+    auto read = router.acquireReplica();
+    ASSERT_TRUE(read);
+    EXPECT_FALSE(read.replica().has_value());
+    EXPECT_EQ(router.stats().primaryFallbacks, 1u);
+
+    auto options = manualOptions();
+    options.primaryFallback = false;
+    ReplicaRouter strict(db_params_, {broken}, 0, 2, options);
+    EXPECT_THROW(strict.acquireReplica(), FirebirdException);
+}
@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/result_arena.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/row.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ResultArena — bump allocator — and arena-backed Rows from ResultSet.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+TEST(ResultArenaTest, AllocationsAreAlignedAndContiguous) {
+    ResultArena arena(1024);
+    auto* a = static_cast<uint8_t*>(arena.allocate(3, 1));
+    auto* b = static_cast<uint8_t*>(arena.allocate(8, 8));
+    auto* c = static_cast<uint8_t*>(arena.allocate(16, 16));
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b) % 8, 0u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(c) % 16, 0u);
+    EXPECT_LT(a, b);
+    EXPECT_LT(b, c);
+    EXPECT_LT(c - a, 64);
+    EXPECT_EQ(arena.blockCount(), 1u);
+    EXPECT_EQ(arena.bytesUsed(), 27u);
+}
+
+TEST(ResultArenaTest, GrowsByBlocksAndServesLargeRequestsAlone) {
+    ResultArena arena(256);
+    for (int i = 0; i < 100; ++i) {
+        arena.allocate(32, 8);
+    }
+    EXPECT_GT(arena.blockCount(), 1u);
+    const auto blocks = arena.blockCount();
+
+    void* big = arena.allocate(1 << 20, 64);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(big) % 64, 0u);
+    EXPECT_EQ(arena.blockCount(), blocks + 1);
+    EXPECT_GE(arena.bytesReserved(), arena.bytesUsed());
+}
+
+TEST(ResultArenaTest, CopyStringAndClearKeepsOneBlock) {
+    ResultArena arena(256);
+    const auto text = arena.copyString("hello arena");
+    EXPECT_EQ(text, "hello arena");
+    for (int i = 0; i < 50; ++i) {
+        arena.copyString(std::string(40, 'x'));
+    }
+    ASSERT_GT(arena.blockCount(), 1u);
+
+    arena.clear();
+    EXPECT_EQ(arena.blockCount(), 1u);
+    EXPECT_EQ(arena.bytesUsed(), 0u);
+    EXPECT_EQ(arena.copyString("again"), "again");
+}
+
+#ifndef _WIN32
+TEST(ResultArenaTest, SpillsBlocksPastTheBudget) {
+    ResultArena arena(4096);
+    arena.spillTo(16 * 1024);
+    std::vector<uint8_t*> pieces;
+    for (int i = 0; i < 400; ++i) {
+        auto* p = static_cast<uint8_t*>(arena.allocate(1000, 1));
+        std::memset(p, i & 0xFF, 1000);
+        pieces.push_back(p);
+    }
+    EXPECT_GT(arena.bytesSpilled(), 0u);
+    EXPECT_LE(arena.bytesReserved() - arena.bytesSpilled(), 16u * 1024);
+    for (int i = 0; i < 400; ++i) {   // Paged back in from the spill file
+        ASSERT_EQ(pieces[i][0], static_cast<uint8_t>(i & 0xFF));
+        ASSERT_EQ(pieces[i][999], static_cast<uint8_t>(i & 0xFF));
+    }
+
+    arena.clear();
+    EXPECT_EQ(arena.bytesSpilled(), 0u);
+    EXPECT_EQ(arena.copyString("again"), "again");
+}
+#endif
+
+class ResultArenaRowsTest : public TempDatabaseTest {
+protected:
+    void createTestSchema() override {
+        connection_->ExecuteDDL(R"(
+            CREATE TABLE ra (
+                id INTEGER NOT NULL PRIMARY KEY,
+                name VARCHAR(32),
+                payload BLOB SUB_TYPE BINARY
+            )
+        )");
+        auto tx = connection_->StartTransaction();
+        auto ins = connection_->prepareStatement(
+            "INSERT INTO ra (id, name) VALUES (?, ?)");
+        for (int32_t i = 1; i <= 500; ++i) {
+            tx->execute(ins, std::make_tuple(i, "name " + std::to_string(i)));
+        }
+        std::vector<uint8_t> bytes{1, 2, 3, 4, 5};
+        auto blobId = tx->createBlob(bytes);
+        Blob blob(reinterpret_cast<const uint8_t*>(&blobId));
+        tx->execute(connection_->prepareStatement("UPDATE ra SET payload = ? WHERE id = 1"),
+                    std::make_tuple(blob));
+        tx->Commit();
+    }
+};
+
+TEST_F(ResultArenaRowsTest, FetchRowsCopiesIntoArena) {
+    auto arena = std::make_shared<ResultArena>();
+    std::vector<Row> rows;
+    {
+        auto tx = connection_->StartTransaction();
+        auto cur = tx->openCursor(connection_->prepareStatement(
+            "SELECT id, name FROM ra ORDER BY id"));
+        cur->setArena(arena);
+        EXPECT_EQ(cur->fetchRows(rows, 200), 200u);
+        EXPECT_EQ(cur->fetchRows(rows), 300u);
+        cur->close();
+        tx->Commit();
+    }
+    ASSERT_EQ(rows.size(), 500u);
+    EXPECT_EQ(rows.back().get<int32_t>("ID").value_or(-1), 500);
+    EXPECT_EQ(rows[41].getView("NAME").value_or(""), "name 42");
+    EXPECT_EQ(rows[0].arena(), arena);
+    EXPECT_LT(arena->blockCount(), 10u);
+    EXPECT_GE(arena->bytesUsed(), 500u * rows[0].metadata().getMessageLength());
+
+    // Rows keep the arena alive
+    arena.reset();
+    EXPECT_EQ(rows[7].get<std::string>("NAME").value_or(""), "name 8");
+}
+
+TEST_F(ResultArenaRowsTest, BlobBytesLandInTheArena) {
+    auto arena = std::make_shared<ResultArena>();
+    auto tx = connection_->StartTransaction();
+    auto cur = tx->openCursor(connection_->prepareStatement(
+        "SELECT id, payload FROM ra WHERE id <= 2 ORDER BY id"));
+    cur->setArena(arena);
+    std::vector<Row> rows;
+    ASSERT_EQ(cur->fetchRows(rows), 2u);
+    cur->close();
+
+    const auto used = arena->bytesUsed();
+    auto bytes = rows[0].getBlobBytes("PAYLOAD");
+    ASSERT_TRUE(bytes.has_value());
+    ASSERT_EQ(bytes->size(), 5u);
+    EXPECT_EQ(static_cast<int>((*bytes)[4]), 5);
+    EXPECT_EQ(arena->bytesUsed(), used + 5);
+    EXPECT_FALSE(rows[1].getBlobBytes("PAYLOAD").has_value());
+    EXPECT_THROW(rows[0].getBlobBytes("ID"), FirebirdException);
+    tx->Commit();
+}
+
+TEST_F(ResultArenaRowsTest, FetchOneWithoutArenaOwnsItsBuffer) {
+    auto tx = connection_->StartTransaction();
+    auto cur = tx->openCursor(connection_->prepareStatement(
+        "SELECT id FROM ra WHERE id = 3"));
+    auto row = cur->fetchOne();
+    ASSERT_TRUE(row.has_value());
+    EXPECT_EQ(row->arena(), nullptr);
+    EXPECT_EQ(row->get<int32_t>(0).value_or(-1), 3);
+    cur->close();
+    tx->Commit();
+}
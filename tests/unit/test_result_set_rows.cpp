@@ -8,9 +8,15 @@
 #include "fbpp/core/row.hpp"
 #include "fbpp/core/exception.hpp"
 
+#include <nlohmann/json.hpp>
+
+#include <optional>
 #include <string>
+#include <tuple>
+#include <vector>
 
-// ResultSet::rows() iterator + fetchOne() + generation guard.
+// ResultSet::rows() iterator + fetchOne() + fetchInto() + generation guard
+// + row limits.
 
 using namespace fbpp::core;
 using namespace fbpp::test;
@@ -116,3 +122,161 @@ TEST_F(ResultSetRowsTest, FetchOneAfterCloseThrows) {
     cur->close();
     EXPECT_THROW((void)cur->fetchOne(), FirebirdException);
 }
+
+// ----------------------------------------------------------------------------
+// Prefetch window
+// ----------------------------------------------------------------------------
+
+TEST_F(ResultSetRowsTest, PrefetchWindowServesAllRowsInOrder) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement("SELECT id, v FROM rs_t ORDER BY id");
+    auto cur = tx->openCursor(stmt);
+    cur->setPrefetch(2);  // 5 rows -> refills of 2, 2, 1
+    EXPECT_EQ(cur->getPrefetch(), 2u);
+
+    std::vector<int32_t> ids;
+    for (const auto& v : cur->rows()) {
+        ids.push_back(v.get<int32_t>("id").value_or(-1));
+    }
+    EXPECT_EQ(ids, (std::vector<int32_t>{1, 2, 3, 4, 5}));
+    EXPECT_TRUE(cur->isEof());
+}
+
+TEST_F(ResultSetRowsTest, PrefetchWindowWithTypedFetch) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement("SELECT id, v FROM rs_t ORDER BY id");
+    auto cur = tx->openCursor(stmt);
+    cur->setPrefetch(16);  // larger than the result set
+
+    std::vector<std::tuple<int32_t, int32_t>> rows;
+    cur->fetchAll(rows);
+    ASSERT_EQ(rows.size(), 5u);
+    EXPECT_EQ(std::get<0>(rows.front()), 1);
+    EXPECT_EQ(std::get<1>(rows.back()), 50);
+}
+
+TEST_F(ResultSetRowsTest, PrefetchWindowCanBeChangedMidStream) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement("SELECT id FROM rs_t ORDER BY id");
+    auto cur = tx->openCursor(stmt);
+    cur->setPrefetch(3);
+
+    auto first = cur->fetchOne();
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->get<int32_t>(0).value_or(-1), 1);
+
+    // Rows 2 and 3 are already buffered and must not be lost.
+    cur->setPrefetch(1);
+    std::vector<int32_t> rest;
+    while (auto row = cur->fetchOne()) {
+        rest.push_back(row->get<int32_t>(0).value_or(-1));
+    }
+    EXPECT_EQ(rest, (std::vector<int32_t>{2, 3, 4, 5}));
+}
+
+TEST_F(ResultSetRowsTest, PrefetchWindowKeepsStalenessGuard) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement("SELECT id FROM rs_t ORDER BY id");
+    auto cur = tx->openCursor(stmt);
+    cur->setPrefetch(4);
+
+    auto it = cur->rows().begin();
+    RowView first = *it;
+    EXPECT_TRUE(first.isValid());
+    ++it;
+    EXPECT_FALSE(first.isValid());
+}
+
+TEST_F(ResultSetRowsTest, FetchIntoReusesElements) {
+    using Record = std::tuple<int32_t, std::optional<std::string>>;
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement(
+        "SELECT id, CAST('longer than the small string buffer ' || id AS VARCHAR(64)) "
+        "FROM rs_t WHERE id <= ? ORDER BY id");
+
+    std::vector<Record> records;
+    EXPECT_EQ(tx->openCursor(stmt, std::make_tuple(int32_t{5}))->fetchInto(records), 5u);
+    ASSERT_EQ(records.size(), 5u);
+    ASSERT_TRUE(std::get<1>(records[4]).has_value());
+    EXPECT_EQ(*std::get<1>(records[4]), "longer than the small string buffer 5");
+
+    // Same query again: strings are overwritten in their own buffers
+    std::vector<const char*> buffers;
+    for (const auto& record : records) {
+        buffers.push_back(std::get<1>(record)->data());
+    }
+    EXPECT_EQ(tx->openCursor(stmt, std::make_tuple(int32_t{5}))->fetchInto(records), 5u);
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        EXPECT_EQ(std::get<0>(records[i]), static_cast<int32_t>(i + 1));
+        EXPECT_EQ(std::get<1>(records[i])->data(), buffers[i]);
+    }
+
+    // Fewer rows: the tail is dropped
+    EXPECT_EQ(tx->openCursor(stmt, std::make_tuple(int32_t{2}))->fetchInto(records), 2u);
+    EXPECT_EQ(records.size(), 2u);
+    EXPECT_EQ(*std::get<1>(records[1]), "longer than the small string buffer 2");
+}
+
+TEST_F(ResultSetRowsTest, RowLimitRunsTheRowsShape) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement("SELECT id FROM rs_t ORDER BY id");
+    auto limited = stmt->limitedTo(2);
+    ASSERT_TRUE(limited);
+    EXPECT_EQ(limited->getSql(), "SELECT id FROM rs_t ORDER BY id ROWS 2");
+    EXPECT_FALSE(stmt->limitedTo(0));
+
+    auto cur = tx->openCursor(stmt, RowLimit{2});
+    cur->setPrefetch(128);
+    EXPECT_EQ(cur->getRowLimit(), 2u);
+    std::vector<int32_t> ids;
+    for (const auto& row : cur->rows()) {
+        ids.push_back(row.get<int32_t>("id").value_or(-1));
+    }
+    EXPECT_EQ(ids, (std::vector<int32_t>{1, 2}));
+    EXPECT_TRUE(cur->isEof());
+}
+
+TEST_F(ResultSetRowsTest, RowLimitStopsTextsThatKeepTheirOwnClause) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement("SELECT FIRST 4 id FROM rs_t ORDER BY id");
+    EXPECT_FALSE(stmt->limitedTo(1));
+
+    // Limited on the client: one row, and the window asks for no more
+    auto cur = tx->openCursor(stmt, RowLimit{1});
+    cur->setPrefetch(64);
+    auto first = cur->fetchOne();
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->get<int32_t>("id").value_or(-1), 1);
+    EXPECT_FALSE(cur->fetchOne().has_value());
+    std::tuple<int32_t> id{};
+    EXPECT_FALSE(cur->fetch(id));
+}
+
+TEST_F(ResultSetRowsTest, RowLimitKeepsNamedParameters) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement(
+        "SELECT id FROM rs_t WHERE id >= :lo ORDER BY id");
+    auto cur = tx->openCursor(stmt, nlohmann::json{{"lo", 3}}, RowLimit{1});
+    auto row = cur->fetchOne();
+    ASSERT_TRUE(row.has_value());
+    EXPECT_EQ(row->get<int32_t>("id").value_or(-1), 3);
+    EXPECT_FALSE(cur->fetchOne().has_value());
+}
+
+TEST_F(ResultSetRowsTest, RowLimitStopsColumnarFetches) {
+    auto tx = connection_->StartTransaction();
+    // FIRST keeps the limit on the client side
+    auto stmt = connection_->prepareStatement("SELECT FIRST 5 id FROM rs_t ORDER BY id");
+    auto cur = tx->openCursor(stmt, RowLimit{3});
+    cur->setPrefetch(16);
+
+    ColumnBatch batch;
+    ASSERT_TRUE(cur->fetchColumns(batch, 2));
+    ASSERT_EQ(batch.rowCount, 2u);
+    EXPECT_EQ(batch.columns[0].view<int32_t>()[1], 2);
+    ASSERT_TRUE(cur->fetchColumns(batch, 2));
+    ASSERT_EQ(batch.rowCount, 1u);
+    EXPECT_EQ(batch.columns[0].view<int32_t>()[0], 3);
+    EXPECT_FALSE(cur->fetchColumns(batch, 2));
+    EXPECT_EQ(batch.rowCount, 0u);
+}
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/result_snapshot.hpp"
+#include "fbpp/core/exception.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ResultSnapshot — raw message buffers saved and served without a database.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+class ResultSnapshotTest : public TempDatabaseTest {
+protected:
+    std::vector<uint8_t> snapshotOf(const std::string& sql, SnapshotWriteOptions options = {}) {
+        auto tx = connection_->StartTransaction();
+        auto stmt = connection_->prepareStatement(sql);
+        auto cur = tx->openCursor(stmt);
+        std::ostringstream out;
+        ResultSnapshotWriter writer(out, *cur->getMetadata(), options);
+        cur->writeSnapshot(writer);
+        cur->close();
+        writer.finish();
+        tx->Commit();
+        const std::string bytes = out.str();
+        return std::vector<uint8_t>(bytes.begin(), bytes.end());
+    }
+
+    static constexpr const char* kSeries = R"(
+        WITH RECURSIVE r (n) AS (
+            SELECT 1 FROM RDB$DATABASE
+            UNION ALL
+            SELECT n + 1 FROM r WHERE n < 1000
+        )
+        SELECT CAST(n AS INTEGER) AS id,
+               IIF(MOD(n, 7) = 0, NULL, 'row ' || n) AS label,
+               CAST(n AS INT128) * 170141183460469231731687303715884 AS big
+        FROM r
+    )";
+};
+
+TEST_F(ResultSnapshotTest, RoundTripsExtendedTypesBitForBit) {
+    auto snapshot = ResultSnapshot::fromBytes(snapshotOf(R"(
+        SELECT CAST(170141183460469231731687303715884105727 AS INT128) AS big,
+               CAST('1.000000000000000000000000000000001' AS DECFLOAT(34)) AS df,
+               CAST(-12.3456 AS NUMERIC(18,4)) AS amount,
+               TIMESTAMP '2024-02-29 13:45:01.1234 Europe/Moscow' AS ts_tz,
+               CAST('héllo' AS VARCHAR(16)) AS note,
+               CAST(NULL AS DATE) AS missing
+        FROM RDB$DATABASE
+    )"));
+
+    ASSERT_EQ(snapshot.rowCount(), 1u);
+    ASSERT_EQ(snapshot.metadata()->getCount(), 6u);
+    EXPECT_EQ(snapshot.metadata()->getDisplayName(3), "TS_TZ");
+
+    const RowView row = snapshot.row(0);
+    EXPECT_EQ(row.get<std::string>("BIG"), "170141183460469231731687303715884105727");
+    EXPECT_EQ(row.get<std::string>("DF"), "1.000000000000000000000000000000001");
+    EXPECT_EQ(row.get<std::string>("AMOUNT"), "-12.3456");
+    EXPECT_EQ(row.getView(4), "héllo");
+    EXPECT_TRUE(row.isNull("MISSING"));
+}
+
+TEST_F(ResultSnapshotTest, MapsFileAndIndexesAcrossBlocks) {
+    SnapshotWriteOptions options;
+    options.blockRows = 64;
+    const auto bytes = snapshotOf(kSeries, options);
+
+    const auto path = std::filesystem::temp_directory_path() / "fbpp_result_snapshot_test.snap";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    }
+    {
+        auto snapshot = ResultSnapshot::open(path.string());
+        ASSERT_EQ(snapshot.rowCount(), 1000u);
+        EXPECT_EQ(snapshot.row(0).get<int32_t>("ID"), 1);
+        EXPECT_EQ(snapshot.row(63).get<int32_t>("ID"), 64);
+        EXPECT_EQ(snapshot.row(64).get<int32_t>("ID"), 65);
+        EXPECT_EQ(snapshot.row(999).get<std::string>("LABEL"), "row 1000");
+        EXPECT_TRUE(snapshot.row(6).isNull("LABEL"));
+        EXPECT_THROW(snapshot.rowData(1000), FirebirdException);
+
+        std::size_t seen = 0;
+        for (const RowView row : snapshot) {
+            EXPECT_EQ(row.get<int32_t>(0), static_cast<int32_t>(++seen));
+        }
+        EXPECT_EQ(seen, 1000u);
+
+        ResultSnapshot moved = std::move(snapshot);   // Views still address the mapping
+        EXPECT_EQ(moved.row(500).get<int32_t>("ID"), 501);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_F(ResultSnapshotTest, RejectsBlobsAndDamagedInput) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement(
+        "SELECT CAST('x' AS BLOB SUB_TYPE TEXT) FROM RDB$DATABASE");
+    auto cur = tx->openCursor(stmt);
+    std::ostringstream out;
+    EXPECT_THROW(ResultSnapshotWriter(out, *cur->getMetadata()), FirebirdException);
+    cur->close();
+    tx->Commit();
+
+    auto bytes = snapshotOf(kSeries);
+    auto truncated = bytes;
+    truncated.resize(truncated.size() - 5);
+    EXPECT_THROW(ResultSnapshot::fromBytes(std::move(truncated)), FirebirdException);
+    bytes[0] = 'X';
+    EXPECT_THROW(ResultSnapshot::fromBytes(std::move(bytes)), FirebirdException);
+}
+
+#ifdef FBPP_WITH_ZSTD
+TEST_F(ResultSnapshotTest, ZstdBlocksInflateOnOpen) {
+    const auto plain = snapshotOf(kSeries);
+    SnapshotWriteOptions options;
+    options.compression = SnapshotCompression::zstd;
+    options.blockRows = 100;
+    auto packed = snapshotOf(kSeries, options);
+    EXPECT_LT(packed.size(), plain.size());
+
+    auto snapshot = ResultSnapshot::fromBytes(std::move(packed));
+    ASSERT_EQ(snapshot.rowCount(), 1000u);
+    EXPECT_EQ(snapshot.row(250).get<std::string>("LABEL"), "row 251");
+    EXPECT_EQ(snapshot.row(999).get<std::string>("BIG"),
+              "170141183460469231731687303715884000");
+}
+#endif
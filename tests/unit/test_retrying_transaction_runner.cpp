@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/retrying_transaction_runner.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+
+// RetryingTransactionRunner — conflict classification, retry, give-up.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+class RetryingTransactionRunnerTest : public TempDatabaseTest {
+protected:
+    void createTestSchema() override {
+        connection_->ExecuteDDL("CREATE TABLE counter (id INTEGER NOT NULL PRIMARY KEY, n INTEGER)");
+        auto tx = connection_->StartTransaction();
+        tx->execute(connection_->prepareStatement("INSERT INTO counter VALUES (1, 0)"));
+        tx->Commit();
+    }
+
+    // Uncommitted update of the counter row from a second attachment
+    std::shared_ptr<Transaction> holdRow(Connection& other) {
+        auto tx = other.StartTransaction();
+        tx->execute(other.prepareStatement("UPDATE counter SET n = n + 100 WHERE id = 1"));
+        return tx;
+    }
+
+    int32_t counter() {
+        auto tx = connection_->StartTransaction();
+        auto cur = tx->openCursor(connection_->prepareStatement("SELECT n FROM counter WHERE id = 1"));
+        std::tuple<int32_t> row;
+        EXPECT_TRUE(cur->fetch(row));
+        cur->close();
+        tx->Commit();
+        return std::get<0>(row);
+    }
+
+    static RetryPolicy fastNoWait() {
+        RetryPolicy policy;
+        policy.transaction = TransactionOptions::noWait();
+        policy.initialBackoff = std::chrono::milliseconds(1);
+        policy.maxBackoff = std::chrono::milliseconds(5);
+        return policy;
+    }
+};
+
+TEST_F(RetryingTransactionRunnerTest, RetriesAfterConflictAndCommits) {
+    Connection other(db_params_);
+    auto holder = holdRow(other);
+
+    RetryPolicy policy = fastNoWait();
+    unsigned retries = 0;
+    policy.onRetry = [&](unsigned attempt, const FirebirdException& error) {
+        EXPECT_EQ(attempt, retries + 1);
+        EXPECT_TRUE(RetryingTransactionRunner::isConflict(error));
+        if (++retries == 2) {
+            holder->Commit();   // Conflict goes away
+        }
+    };
+    RetryingTransactionRunner runner(*connection_, policy);
+    auto update = connection_->prepareStatement("UPDATE counter SET n = n + 1 WHERE id = 1");
+    const unsigned affected = runner.run([&](Transaction& tx) { return tx.execute(update); });
+
+    EXPECT_EQ(affected, 1u);
+    EXPECT_EQ(counter(), 101);
+    const auto stats = runner.stats();
+    EXPECT_EQ(stats.runs, 1u);
+    EXPECT_EQ(stats.attempts, 3u);
+    EXPECT_EQ(stats.commits, 1u);
+    EXPECT_EQ(stats.conflicts, 2u);
+    EXPECT_EQ(stats.backoff.count, 2u);
+    EXPECT_DOUBLE_EQ(stats.retriesPerRun(), 2.0);
+}
+
+TEST_F(RetryingTransactionRunnerTest, GivesUpAfterMaxAttempts) {
+    Connection other(db_params_);
+    auto holder = holdRow(other);
+
+    RetryPolicy policy = fastNoWait();
+    policy.maxAttempts = 3;
+    RetryingTransactionRunner runner(*connection_, policy);
+    auto update = connection_->prepareStatement("UPDATE counter SET n = n + 1 WHERE id = 1");
+    try {
+        runner.run([&](Transaction& tx) { tx.execute(update); });
+        FAIL() << "Expected the conflict to propagate";
+    } catch (const FirebirdException& e) {
+        EXPECT_TRUE(runner.isRetryable(e));
+    }
+    holder->Rollback();
+    EXPECT_EQ(runner.stats().attempts, 3u);
+    EXPECT_EQ(runner.stats().exhausted, 1u);
+    EXPECT_EQ(counter(), 0);
+}
+
+TEST_F(RetryingTransactionRunnerTest, OtherErrorsPropagateAtOnce) {
+    RetryingTransactionRunner runner(*connection_, fastNoWait());
+    auto duplicate = connection_->prepareStatement("INSERT INTO counter VALUES (1, 5)");
+    EXPECT_THROW(runner.run([&](Transaction& tx) { tx.execute(duplicate); }), FirebirdException);
+    EXPECT_THROW(runner.run([](Transaction&) { throw std::runtime_error("app"); }),
+                 std::runtime_error);
+    const auto stats = runner.stats();
+    EXPECT_EQ(stats.attempts, 2u);
+    EXPECT_EQ(stats.failures, 2u);
+    EXPECT_EQ(stats.conflicts, 0u);
+}
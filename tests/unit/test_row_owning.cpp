@@ -9,8 +9,10 @@
 
 #include <optional>
 #include <string>
+#include <tuple>
+#include <vector>
 
-// Row — owning copy that survives cursor close.
+// Row — owning copy that survives cursor close; borrowed rows and cursors.
 
 using namespace fbpp::core;
 using namespace fbpp::test;
@@ -108,3 +110,46 @@ TEST_F(RowOwningTest, FetchOneEmpty) {
     auto cur = tx->openCursor(stmt);
     EXPECT_FALSE(cur->fetchOne().has_value());
 }
+
+TEST_F(RowOwningTest, BorrowedRowsHoldNoTransactionReference) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement(
+        "SELECT id, payload FROM ro WHERE id = ?");
+    const long before = tx.use_count();
+
+    auto cur = tx->openCursor(stmt, std::make_tuple(int32_t{1}));
+    cur->setRowOwnership(RowOwnership::borrowed);
+    std::vector<Row> rows;
+    ASSERT_EQ(cur->fetchRows(rows), 1u);
+    cur->close();
+    cur.reset();
+
+    EXPECT_EQ(tx.use_count(), before);
+    EXPECT_FALSE(rows[0].ownsTransaction());
+    EXPECT_EQ(rows[0].transaction(), tx.get());
+    // The transaction is still alive in this scope, so BLOB reads work
+    EXPECT_EQ(rows[0].get<std::string>("payload").value_or(""), "hello");
+}
+
+TEST_F(RowOwningTest, BorrowedCursorTakesNoReferences) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement(
+        "SELECT id, name FROM ro WHERE id = ?");
+    const long txRefs = tx.use_count();
+    const long stmtRefs = stmt.use_count();
+    {
+        auto cur = tx->openBorrowedCursor(*stmt, std::make_tuple(int32_t{1}));
+        EXPECT_EQ(cur->rowOwnership(), RowOwnership::borrowed);
+        EXPECT_EQ(tx.use_count(), txRefs);
+        EXPECT_EQ(stmt.use_count(), stmtRefs);
+
+        auto row = cur->fetchOne();
+        ASSERT_TRUE(row.has_value());
+        EXPECT_FALSE(row->ownsTransaction());
+        EXPECT_EQ(row->get<std::string>("name").value_or(""), "Alice");
+        EXPECT_FALSE(cur->fetchOne().has_value());
+    }
+    // Reopening the same statement works once the borrowed cursor is gone
+    auto again = tx->openBorrowedCursor(*stmt, std::make_tuple(int32_t{1}));
+    EXPECT_TRUE(again->fetchOne().has_value());
+}
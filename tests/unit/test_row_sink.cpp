@@ -0,0 +1,246 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/batch.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/csv_stream_writer.hpp"
+#include "fbpp/core/json_stream_writer.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/row_sink.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// ResultSet::writeTo — RowSink engine and the adapters of row_sink.hpp.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+namespace {
+
+// Records the ids it sees and the block order
+struct IdSink {
+    std::vector<int32_t> ids;
+    std::vector<std::size_t> seqs;
+    bool begun = false;
+    bool ended = false;
+
+    void begin(const MessageMetadata& metadata) {
+        begun = true;
+        EXPECT_EQ(metadata.getCount(), 3u);
+    }
+    void consume(const MessageBlock& block) {
+        seqs.push_back(block.seq);
+        EXPECT_EQ(block.firstRow, ids.size());
+        for (std::size_t r = 0; r < block.rows; ++r) {
+            ids.push_back(block.view(r).get<int32_t>(0).value_or(-1));
+        }
+    }
+    void end() { ended = true; }
+};
+
+// consume() from several workers at once
+struct ConcurrentCountSink {
+    static constexpr bool concurrent = true;
+    std::atomic<std::size_t> rows{0};
+    std::atomic<int> active{0};
+    std::atomic<int> maxActive{0};
+
+    void begin(const MessageMetadata&) {}
+    void consume(const MessageBlock& block) {
+        const int now = ++active;
+        int seen = maxActive.load();
+        while (now > seen && !maxActive.compare_exchange_weak(seen, now)) {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        rows += block.rows;
+        --active;
+    }
+    void end() {}
+};
+
+struct FailingSink {
+    std::size_t blocks = 0;
+    bool ended = false;
+    void begin(const MessageMetadata&) {}
+    void consume(const MessageBlock&) {
+        if (++blocks == 2) {
+            throw std::runtime_error("sink failed");
+        }
+    }
+    void end() { ended = true; }
+};
+
+static_assert(RowSink<IdSink>);
+static_assert(RowSink<JsonRowSink>);
+static_assert(!row_sink_concurrent_v<IdSink>);
+static_assert(row_sink_concurrent_v<ConcurrentCountSink>);
+
+} // namespace
+
+class RowSinkTest : public TempDatabaseTest {
+protected:
+    static constexpr int32_t kRows = 1000;
+
+    void createTestSchema() override {
+        connection_->ExecuteDDL(R"(
+            CREATE TABLE rsk (
+                id INTEGER NOT NULL PRIMARY KEY,
+                name VARCHAR(40),
+                amount DOUBLE PRECISION
+            )
+        )");
+        auto tx = connection_->StartTransaction();
+        auto ins = connection_->prepareStatement(
+            "INSERT INTO rsk (id, name, amount) VALUES (?, ?, ?)");
+        std::vector<std::tuple<int32_t, std::string, double>> rows;
+        for (int32_t i = 1; i <= kRows; ++i) {
+            rows.emplace_back(i, "row " + std::to_string(i), i * 0.5);
+        }
+        auto batch = ins->createBatch(tx.get(), false);
+        batch->addMany(rows);
+        batch->execute(tx.get());
+        tx->Commit();
+    }
+
+    std::unique_ptr<ResultSet> open(std::shared_ptr<Transaction>& tx) {
+        tx = connection_->StartTransaction();
+        return tx->openCursor(connection_->prepareStatement(
+            "SELECT id, name, amount FROM rsk ORDER BY id"));
+    }
+
+    static void expectAllInOrder(const std::vector<int32_t>& ids) {
+        ASSERT_EQ(ids.size(), static_cast<std::size_t>(kRows));
+        for (int32_t i = 0; i < kRows; ++i) {
+            ASSERT_EQ(ids[i], i + 1);
+        }
+    }
+};
+
+TEST_F(RowSinkTest, CallingThreadSeesEveryRowInOrder) {
+    std::shared_ptr<Transaction> tx;
+    auto cur = open(tx);
+    IdSink sink;
+    EXPECT_EQ(cur->writeTo(sink, {.blockRows = 64}), static_cast<std::size_t>(kRows));
+    EXPECT_TRUE(sink.begun);
+    EXPECT_TRUE(sink.ended);
+    expectAllInOrder(sink.ids);
+    EXPECT_EQ(sink.seqs.size(), static_cast<std::size_t>((kRows + 63) / 64));
+    EXPECT_TRUE(cur->isEof());
+}
+
+TEST_F(RowSinkTest, SingleWorkerKeepsOrderWithBackpressure) {
+    std::shared_ptr<Transaction> tx;
+    auto cur = open(tx);
+    cur->setPrefetch(128);
+    IdSink sink;
+    // Sequential sinks get one worker however many are asked for
+    EXPECT_EQ(cur->writeTo(sink, {.blockRows = 50, .workers = 4, .maxBlocksInFlight = 1}),
+              static_cast<std::size_t>(kRows));
+    expectAllInOrder(sink.ids);
+    for (std::size_t i = 0; i < sink.seqs.size(); ++i) {
+        EXPECT_EQ(sink.seqs[i], i);
+    }
+}
+
+TEST_F(RowSinkTest, ConcurrentSinkRunsOnSeveralWorkers) {
+    std::shared_ptr<Transaction> tx;
+    auto cur = open(tx);
+    ConcurrentCountSink sink;
+    EXPECT_EQ(cur->writeTo(sink, {.blockRows = 25, .workers = 4}),
+              static_cast<std::size_t>(kRows));
+    EXPECT_EQ(sink.rows.load(), static_cast<std::size_t>(kRows));
+    EXPECT_GE(sink.maxActive.load(), 1);
+}
+
+TEST_F(RowSinkTest, MaxRowsStopsEarly) {
+    std::shared_ptr<Transaction> tx;
+    auto cur = open(tx);
+    IdSink sink;
+    EXPECT_EQ(cur->writeTo(sink, {.blockRows = 64, .maxRows = 100}), 100u);
+    ASSERT_EQ(sink.ids.size(), 100u);
+    EXPECT_EQ(sink.ids.back(), 100);
+
+    // The rest is still there for the next call
+    std::tuple<int32_t, std::string, double> row;
+    ASSERT_TRUE(cur->fetch(row));
+    EXPECT_EQ(std::get<0>(row), 101);
+}
+
+TEST_F(RowSinkTest, SinkExceptionIsRethrown) {
+    for (unsigned workers : {0u, 1u}) {
+        std::shared_ptr<Transaction> tx;
+        auto cur = open(tx);
+        FailingSink sink;
+        EXPECT_THROW(cur->writeTo(sink, {.blockRows = 10, .workers = workers}), std::runtime_error);
+        EXPECT_FALSE(sink.ended);
+    }
+}
+
+TEST_F(RowSinkTest, DecodeSinkReusesRows) {
+    std::shared_ptr<Transaction> tx;
+    auto cur = open(tx);
+    std::vector<int32_t> ids;
+    std::size_t blocks = 0;
+    cur->writeTo(decodeSink<std::tuple<int32_t, std::string, double>>(
+                     [&](std::vector<std::tuple<int32_t, std::string, double>>& rows) {
+                         ++blocks;
+                         for (const auto& row : rows) {
+                             ids.push_back(std::get<0>(row));
+                         }
+                     }),
+                 {.blockRows = 100, .workers = 1});
+    expectAllInOrder(ids);
+    EXPECT_EQ(blocks, 10u);
+}
+
+TEST_F(RowSinkTest, WriterAdaptersMatchDirectOutput) {
+    std::string direct;
+    {
+        std::shared_ptr<Transaction> tx;
+        auto cur = open(tx);
+        JsonStreamWriter writer([&](std::string_view chunk) { direct.append(chunk); });
+        cur->writeJson(writer);
+        writer.finish();
+    }
+    std::string viaSink;
+    {
+        std::shared_ptr<Transaction> tx;
+        auto cur = open(tx);
+        JsonStreamWriter writer([&](std::string_view chunk) { viaSink.append(chunk); });
+        cur->writeTo(JsonRowSink(writer), {.blockRows = 77, .workers = 1});
+        writer.finish();
+    }
+    EXPECT_EQ(viaSink, direct);
+    EXPECT_EQ(nlohmann::json::parse(viaSink).size(), static_cast<std::size_t>(kRows));
+
+    std::string csv;
+    {
+        std::shared_ptr<Transaction> tx;
+        auto cur = open(tx);
+        CsvStreamWriter writer([&](std::string_view chunk) { csv.append(chunk); });
+        cur->writeTo(CsvRowSink(writer), {.maxRows = 2});
+        writer.finish();
+    }
+    EXPECT_EQ(csv.rfind("ID,NAME,AMOUNT", 0), 0u);
+}
+
+TEST_F(RowSinkTest, RowViewSinkVisitsRows) {
+    std::shared_ptr<Transaction> tx;
+    auto cur = open(tx);
+    std::vector<int32_t> ids;
+    cur->writeTo(rowViewSink([&](const RowView& view) {
+        ids.push_back(view.get<int32_t>("ID").value_or(-1));
+    }));
+    expectAllInOrder(ids);
+}
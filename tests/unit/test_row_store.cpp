@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/row_store.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// RowStore — compact encoding, random access, sorting, filtering and spilling.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+class RowStoreTest : public TempDatabaseTest {
+protected:
+    void createTestSchema() override {
+        connection_->ExecuteDDL(R"(
+            CREATE TABLE rs (
+                id INTEGER NOT NULL PRIMARY KEY,
+                name VARCHAR(200),
+                code CHAR(10),
+                amount NUMERIC(12,2),
+                score DOUBLE PRECISION
+            )
+        )");
+        auto tx = connection_->StartTransaction();
+        auto ins = connection_->prepareStatement(
+            "INSERT INTO rs (id, name, code, amount, score) VALUES (?, ?, ?, ?, ?)");
+        for (int32_t i = 1; i <= 100; ++i) {
+            std::optional<std::string> name;
+            if (i % 10 != 0) {
+                name = "n" + std::to_string(101 - i);
+            }
+            tx->execute(ins, std::make_tuple(i, name, std::string("C") + std::to_string(i % 3),
+                                             i * 1.25, 1000.0 / i));
+        }
+        tx->Commit();
+    }
+
+    RowStore load(const std::string& sql) {
+        auto tx = connection_->StartTransaction();
+        auto cur = tx->openCursor(connection_->prepareStatement(sql));
+        auto store = RowStore::fromResultSet(*cur);
+        cur->close();
+        tx->Commit();
+        return store;
+    }
+};
+
+TEST_F(RowStoreTest, EncodesSmallerThanMessages) {
+    auto store = load("SELECT id, name, code, amount, score FROM rs ORDER BY id");
+    ASSERT_EQ(store.size(), 100u);
+    EXPECT_LT(store.bytesUsed(), store.size() * store.metadata().getMessageLength() / 3);
+
+    EXPECT_EQ(store.get<int32_t>(0, 0).value_or(-1), 1);
+    EXPECT_EQ(store.getView(0, 1).value_or(""), "n100");
+    EXPECT_TRUE(store.isNull(9, 1));
+    EXPECT_FALSE(store.getView(9, 1).has_value());
+    EXPECT_EQ(store.getView(4, 2).value_or(""), "C2");          // CHAR pad dropped
+    EXPECT_NEAR(store.get<double>(3, "AMOUNT").value_or(0), 5.0, 1e-9);
+}
+
+TEST_F(RowStoreTest, ViewExpandsToMessageLayout) {
+    auto store = load("SELECT id, name, code FROM rs ORDER BY id");
+    RowView row = store.view(41);
+    EXPECT_EQ(row.get<int32_t>("ID").value_or(-1), 42);
+    EXPECT_EQ(row.get<std::string>("NAME").value_or(""), "n59");
+    EXPECT_EQ(row.get<std::string>("CODE").value_or(""), "C0");
+    ASSERT_TRUE(row.getBytes("CODE").has_value());
+    EXPECT_EQ(row.getBytes("CODE")->size(), 10u);                 // Re-padded CHAR(10)
+
+    Row owned = store.toRow(99);
+    EXPECT_EQ(owned.get<int32_t>(0).value_or(-1), 100);
+    EXPECT_TRUE(owned.isNull(1));
+    EXPECT_THROW(store.view(100), FirebirdException);
+}
+
+TEST_F(RowStoreTest, SortByColumnOrdersEncodedValues) {
+    auto store = load("SELECT id, name, score FROM rs");
+    store.sortBy(store.column("SCORE"));
+    EXPECT_EQ(store.get<int32_t>(0, 0).value_or(-1), 100);
+    EXPECT_EQ(store.get<int32_t>(99, 0).value_or(-1), 1);
+
+    store.sortBy(store.column("NAME"));                          // NULLs first
+    for (std::size_t i = 0; i < 10; ++i) {
+        EXPECT_TRUE(store.isNull(i, 1));
+    }
+    EXPECT_EQ(store.getView(10, 1).value_or(""), "n10");
+    EXPECT_LE(store.getView(10, 1).value(), store.getView(11, 1).value());
+
+    store.sortBy(0, true);
+    EXPECT_EQ(store.get<int32_t>(0, 0).value_or(-1), 100);
+}
+
+TEST_F(RowStoreTest, SortWithComparatorAndFilter) {
+    auto store = load("SELECT id, code, amount FROM rs");
+    store.sort([](const RowView& a, const RowView& b) {
+        return a.get<double>(2).value_or(0) > b.get<double>(2).value_or(0);
+    });
+    EXPECT_EQ(store.get<int32_t>(0, 0).value_or(-1), 100);
+
+    auto ones = store.filter([](const RowView& r) {
+        return r.getView(1).value_or("") == "C1";
+    });
+    EXPECT_EQ(ones.size(), 34u);
+    EXPECT_EQ(ones.arena(), store.arena());
+    EXPECT_EQ(ones.get<int32_t>(0, 0).value_or(-1), 100);
+    EXPECT_LT(ones.bytesUsed(), store.bytesUsed());
+}
+
+#ifndef _WIN32
+TEST_F(RowStoreTest, SpilledStoreKeepsRandomAccess) {
+    auto tx = connection_->StartTransaction();
+    auto cur = tx->openCursor(
+        connection_->prepareStatement("SELECT id, name, code, amount, score FROM rs"));
+    RowStore store(cur->getSharedMetadata(), cur->getTransaction(),
+                   std::make_shared<ResultArena>(512));
+    store.spillTo(1024);
+    EXPECT_EQ(store.append(*cur), 100u);
+    cur->close();
+    tx->Commit();
+    EXPECT_GT(store.arena()->bytesSpilled(), 0u);
+
+    store.sortBy(0, true);
+    EXPECT_EQ(store.get<int32_t>(0, 0).value_or(-1), 100);
+    RowView row = store.view(58);
+    EXPECT_EQ(row.get<int32_t>("ID").value_or(-1), 42);
+    EXPECT_EQ(row.get<std::string>("NAME").value_or(""), "n59");
+    EXPECT_EQ(store.getView(58, 2).value_or(""), "C0");
+}
+#endif
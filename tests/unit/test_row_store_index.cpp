@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/row_store_index.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// RowStoreIndex — hash lookups on one RowStore column, and hashJoin().
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+class RowStoreIndexTest : public TempDatabaseTest {
+protected:
+    void createTestSchema() override {
+        connection_->ExecuteDDL(R"(
+            CREATE TABLE item (
+                id INTEGER NOT NULL PRIMARY KEY,
+                name VARCHAR(100),
+                code CHAR(10),
+                amount NUMERIC(12,2),
+                score DOUBLE PRECISION
+            )
+        )");
+        connection_->ExecuteDDL(R"(
+            CREATE TABLE item_ref (
+                item_id BIGINT NOT NULL,
+                label VARCHAR(40)
+            )
+        )");
+        auto tx = connection_->StartTransaction();
+        auto ins = connection_->prepareStatement(
+            "INSERT INTO item (id, name, code, amount, score) VALUES (?, ?, ?, ?, ?)");
+        for (int32_t i = 1; i <= 100; ++i) {
+            std::optional<std::string> name;
+            if (i % 10 != 0) {
+                name = "n" + std::to_string(i);
+            }
+            tx->execute(ins, std::make_tuple(i, name, std::string("C") + std::to_string(i % 3),
+                                             i * 1.25, 1000.0 / i));
+        }
+        auto ref =
+            connection_->prepareStatement("INSERT INTO item_ref (item_id, label) VALUES (?, ?)");
+        for (int64_t id : {3, 7, 7, 42, 500}) {
+            tx->execute(ref, std::make_tuple(id, "ref " + std::to_string(id)));
+        }
+        tx->Commit();
+    }
+
+    RowStore load(const std::string& sql) {
+        auto tx = connection_->StartTransaction();
+        auto cur = tx->openCursor(connection_->prepareStatement(sql));
+        auto store = RowStore::fromResultSet(*cur);
+        cur->close();
+        tx->Commit();
+        return store;
+    }
+};
+
+TEST_F(RowStoreIndexTest, FindsByIntegerAndText) {
+    auto store = load("SELECT id, name, code, amount FROM item ORDER BY id");
+
+    RowStoreIndex byId(store, 0u);
+    EXPECT_EQ(byId.keys(), 100u);
+    auto hit = byId.find(int64_t{42});
+    ASSERT_FALSE(hit.empty());
+    EXPECT_EQ(hit.count(), 1u);
+    EXPECT_EQ(store.get<int32_t>(hit.front(), 0u).value_or(0), 42);
+    EXPECT_TRUE(byId.find(int64_t{0}).empty());
+    EXPECT_TRUE(byId.find(int64_t{-42}).empty());
+
+    // CHAR keys without their pad; duplicates in row order
+    RowStoreIndex byCode(store, "CODE");
+    EXPECT_EQ(byCode.keys(), 3u);
+    std::vector<std::size_t> rows(byCode.find("C1").begin(), byCode.find("C1").end());
+    ASSERT_EQ(rows.size(), 34u);
+    for (std::size_t i = 1; i < rows.size(); ++i) {
+        EXPECT_LT(rows[i - 1], rows[i]);
+    }
+    EXPECT_TRUE(byCode.find("C1 ").empty());
+    EXPECT_TRUE(byCode.find("C9").empty());
+
+    // Unscaled values for NUMERIC keys: 5 * 1.25
+    RowStoreIndex byAmount(store, 3u);
+    EXPECT_FALSE(byAmount.find(int64_t{625}).empty());
+
+    EXPECT_THROW(byId.find("42"), FirebirdException);
+    EXPECT_THROW(byCode.find(int64_t{1}), FirebirdException);
+}
+
+TEST_F(RowStoreIndexTest, SkipsNullKeys) {
+    auto store = load("SELECT id, name FROM item ORDER BY id");
+    RowStoreIndex byName(store, 1u);
+    EXPECT_EQ(byName.rows(), 90u);
+    EXPECT_EQ(byName.keys(), 90u);
+    EXPECT_FALSE(byName.find("n7").empty());
+    EXPECT_GT(byName.bytesUsed(), 0u);
+
+    // A NULL probe key matches nothing
+    std::size_t matched = hashJoin(store, 1u, byName, [](std::size_t, std::size_t) {});
+    EXPECT_EQ(matched, 90u);
+}
+
+TEST_F(RowStoreIndexTest, JoinsAcrossIntegerWidths) {
+    auto items = load("SELECT id, name FROM item ORDER BY id");
+    auto refs = load("SELECT item_id, label FROM item_ref ORDER BY item_id");
+    RowStoreIndex byId(items, 0u);
+
+    std::vector<std::pair<int64_t, int32_t>> inner;
+    std::size_t calls = hashJoin(refs, 0u, byId, [&](std::size_t ref, std::size_t item) {
+        inner.emplace_back(refs.get<int64_t>(ref, 0u).value_or(0),
+                           items.get<int32_t>(item, 0u).value_or(0));
+    });
+    ASSERT_EQ(calls, 4u);
+    EXPECT_EQ(inner[0], std::make_pair(int64_t{3}, 3));
+    EXPECT_EQ(inner[1], std::make_pair(int64_t{7}, 7));
+    EXPECT_EQ(inner[2], std::make_pair(int64_t{7}, 7));
+    EXPECT_EQ(inner[3], std::make_pair(int64_t{42}, 42));
+
+    std::size_t unmatched = 0;
+    calls = hashJoin(
+        refs, 0u, byId,
+        [&](std::size_t ref, std::size_t item) {
+            if (item == RowStoreIndex::npos) {
+                ++unmatched;
+                EXPECT_EQ(refs.get<int64_t>(ref, 0u).value_or(0), 500);
+            }
+        },
+        JoinKind::left);
+    EXPECT_EQ(calls, 5u);
+    EXPECT_EQ(unmatched, 1u);
+
+    // Build side BIGINT with duplicates, probe side INTEGER
+    RowStoreIndex byRef(refs, 0u);
+    EXPECT_EQ(byRef.keys(), 4u);
+    EXPECT_EQ(byRef.find(items, 6u, 0u).count(), 2u);   // id 7
+}
+
+TEST_F(RowStoreIndexTest, RejectsKeysWithoutCanonicalBytes) {
+    auto store = load("SELECT id, name, amount, score FROM item ORDER BY id");
+    EXPECT_THROW(RowStoreIndex(store, 3u), FirebirdException);
+
+    // Different scales, or integers against text
+    RowStoreIndex byId(store, 0u);
+    EXPECT_FALSE(byId.joinable(store, 2u));
+    EXPECT_FALSE(byId.joinable(store, 1u));
+    EXPECT_TRUE(byId.joinable(store, 0u));
+    EXPECT_THROW(hashJoin(store, 2u, byId, [](std::size_t, std::size_t) {}), FirebirdException);
+}
+
+TEST_F(RowStoreIndexTest, GoesStaleWhenTheStoreChanges) {
+    auto store = load("SELECT id, name FROM item ORDER BY id");
+    RowStoreIndex byId(store, 0u);
+    EXPECT_FALSE(byId.stale());
+
+    store.sortBy(0u, true);
+    EXPECT_TRUE(byId.stale());
+    EXPECT_THROW(byId.find(int64_t{1}), FirebirdException);
+
+    RowStoreIndex rebuilt(store, 0u);
+    EXPECT_EQ(rebuilt.find(int64_t{1}).front(), 99u);
+}
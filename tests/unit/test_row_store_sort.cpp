@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/row_store.hpp"
+#include "fbpp/core/row_store_sort.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// RowSorter — multi-key parallel sorts and k-way merges of RowStores.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+class RowSorterTest : public TempDatabaseTest {
+protected:
+    static constexpr int32_t kRows = 500;
+
+    void createTestSchema() override {
+        connection_->ExecuteDDL(R"(
+            CREATE TABLE srt (
+                id INTEGER NOT NULL PRIMARY KEY,
+                region CHAR(4),
+                name VARCHAR(40),
+                amount NUMERIC(12,2),
+                note BLOB SUB_TYPE TEXT
+            )
+        )");
+        auto tx = connection_->StartTransaction();
+        auto ins = connection_->prepareStatement(
+            "INSERT INTO srt (id, region, name, amount) VALUES (?, ?, ?, ?)");
+        for (int32_t i = 0; i < kRows; ++i) {
+            std::optional<std::string> name;
+            if (i % 17 != 0) {
+                // Mixed case: "Item 7" and "item 7" tie case-insensitively
+                name = std::string(i % 2 ? "Item " : "item ") + std::to_string(i % 53);
+            }
+            tx->execute(ins, std::make_tuple(i, std::string(i % 3 ? "EU" : "US"), name,
+                                             (i * 7919 % 1000) * 0.25));
+        }
+        tx->Commit();
+    }
+
+    RowStore load(const std::string& sql) {
+        auto tx = connection_->StartTransaction();
+        auto cur = tx->openCursor(connection_->prepareStatement(sql));
+        auto store = RowStore::fromResultSet(*cur);
+        cur->close();
+        tx->Commit();
+        return store;
+    }
+
+    static std::vector<int32_t> ids(const RowStore& store) {
+        std::vector<int32_t> out;
+        for (std::size_t i = 0; i < store.size(); ++i) {
+            out.push_back(store.get<int32_t>(i, 0).value_or(-1));
+        }
+        return out;
+    }
+};
+
+TEST_F(RowSorterTest, ParallelRunsMatchOneRun) {
+    auto store = load("SELECT id, region, name, amount FROM srt ORDER BY id");
+    const std::vector<SortKey> keys{{1}, {3, true}, {2}};
+
+    RowSortOptions runs;
+    runs.runRows = 37;
+    runs.threads = 3;
+    EXPECT_EQ(RowSorter(keys, runs).sort(store), 14u);   // ceil(500 / 37)
+
+    RowSortOptions whole;
+    whole.runRows = kRows;
+    auto reference = load("SELECT id, region, name, amount FROM srt ORDER BY id");
+    EXPECT_EQ(RowSorter(keys, whole).sort(reference), 1u);
+    EXPECT_EQ(ids(store), ids(reference));
+
+    // Region ascending, amount descending, then input order (stable)
+    for (std::size_t i = 1; i < store.size(); ++i) {
+        const auto region = std::string(store.getView(i, 1).value());
+        const auto previous = std::string(store.getView(i - 1, 1).value());
+        ASSERT_LE(previous, region);
+        if (previous == region) {
+            ASSERT_GE(store.get<double>(i - 1, 3).value(), store.get<double>(i, 3).value());
+        }
+    }
+    EXPECT_EQ(store.getView(0, 1).value_or(""), "EU");
+}
+
+TEST_F(RowSorterTest, CaseInsensitiveTextAndNullOrder) {
+    auto store = load("SELECT id, name FROM srt ORDER BY id");
+    RowSorter sorter({SortKey{1, false, NullOrder::Last, true}, SortKey{0, true}});
+    sorter.sort(store);
+
+    const std::size_t nulls = (kRows + 16) / 17;
+    for (std::size_t i = store.size() - nulls; i < store.size(); ++i) {
+        EXPECT_TRUE(store.isNull(i, 1));
+    }
+    for (std::size_t i = 1; i < store.size() - nulls; ++i) {
+        std::string a(store.getView(i - 1, 1).value());
+        std::string b(store.getView(i, 1).value());
+        std::transform(a.begin(), a.end(), a.begin(), ::tolower);
+        std::transform(b.begin(), b.end(), b.begin(), ::tolower);
+        ASSERT_LE(a, b);
+        if (a == b) {   // "Item n" and "item n" interleave by id, descending
+            ASSERT_GT(store.get<int32_t>(i - 1, 0).value(), store.get<int32_t>(i, 0).value());
+        }
+    }
+
+    // Default NULL order: first ascending
+    RowSorter({{1}}).sort(store);
+    EXPECT_TRUE(store.isNull(0, 1));
+    EXPECT_LT(sorter.compare(store, store.size() - 1, store, 0), 0);
+}
+
+TEST_F(RowSorterTest, MergesSortedStoresIntoOne) {
+    RowSorter sorter({{3}, {0}});
+    std::vector<RowStore> parts;
+    for (int part = 0; part < 3; ++part) {
+        parts.push_back(load("SELECT id, region, name, amount FROM srt WHERE MOD(id, 3) = " +
+                             std::to_string(part)));
+        sorter.sort(parts.back());
+    }
+    parts.push_back(load("SELECT id, region, name, amount FROM srt WHERE id < 0"));   // Empty
+
+    auto arena = std::make_shared<ResultArena>();
+    RowStore merged = sorter.merge({&parts[0], &parts[1], &parts[2], &parts[3]}, arena);
+    EXPECT_EQ(merged.arena(), arena);
+    auto expected = load("SELECT id, region, name, amount FROM srt ORDER BY amount, id");
+    ASSERT_EQ(merged.size(), static_cast<std::size_t>(kRows));
+    EXPECT_EQ(ids(merged), ids(expected));
+    EXPECT_EQ(merged.getView(5, 2), expected.getView(5, 2));
+
+    // The copies outlive the inputs
+    parts.clear();
+    EXPECT_EQ(merged.get<int32_t>(kRows - 1, 0), expected.get<int32_t>(kRows - 1, 0));
+
+    auto other = load("SELECT id, name FROM srt");
+    EXPECT_THROW(sorter.merge({&expected, &other}), FirebirdException);
+}
+
+TEST_F(RowSorterTest, RejectsKeysWithoutDirectOrdering) {
+    auto store = load("SELECT id, note FROM srt");
+    EXPECT_THROW(RowSorter({{1}}).sort(store), FirebirdException);                 // BLOB
+    EXPECT_THROW(RowSorter({SortKey{0, false, NullOrder::Default, true}}).sort(store),
+                 FirebirdException);                                              // Not text
+    EXPECT_THROW(RowSorter({{5}}).sort(store), FirebirdException);                 // No column
+    EXPECT_THROW(RowSorter(std::vector<SortKey>{}), FirebirdException);
+}
@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/row_store_view.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// RowStoreView — filtered, sorted windows over a RowStore.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+class RowStoreViewTest : public TempDatabaseTest {
+protected:
+    void createTestSchema() override {
+        connection_->ExecuteDDL(R"(
+            CREATE TABLE item (
+                id INTEGER NOT NULL PRIMARY KEY,
+                name VARCHAR(100),
+                code CHAR(10),
+                amount NUMERIC(12,2),
+                score DOUBLE PRECISION
+            )
+        )");
+        auto tx = connection_->StartTransaction();
+        auto ins = connection_->prepareStatement(
+            "INSERT INTO item (id, name, code, amount, score) VALUES (?, ?, ?, ?, ?)");
+        for (int32_t i = 1; i <= 100; ++i) {
+            std::optional<std::string> name;
+            if (i % 10 != 0) {
+                name = "n" + std::to_string(i);
+            }
+            tx->execute(ins, std::make_tuple(i, name, std::string("C") + std::to_string(i % 3),
+                                             i * 1.25, 1000.0 / i));
+        }
+        tx->Commit();
+    }
+
+    RowStore load(const std::string& sql) {
+        auto tx = connection_->StartTransaction();
+        auto cur = tx->openCursor(connection_->prepareStatement(sql));
+        auto store = RowStore::fromResultSet(*cur);
+        cur->close();
+        tx->Commit();
+        return store;
+    }
+
+    static std::vector<int32_t> ids(const RowStore& store, const RowStoreView& view) {
+        std::vector<int32_t> out;
+        for (std::size_t row : view.window(0, view.size())) {
+            out.push_back(store.get<int32_t>(row, 0u).value_or(-1));
+        }
+        return out;
+    }
+};
+
+TEST_F(RowStoreViewTest, FiltersKeepTheOrder) {
+    auto store = load("SELECT id, name, code, amount FROM item ORDER BY id");
+    RowStoreView view(store);
+    EXPECT_EQ(view.size(), 100u);
+    EXPECT_FALSE(view.filtered());
+
+    view.orderBy({{store.column("AMOUNT"), true}});
+    EXPECT_EQ(store.get<int32_t>(view.row(0), 0u).value_or(-1), 100);
+
+    view.whereText(store.column("NAME"), "1");
+    EXPECT_EQ(ids(store, view), (std::vector<int32_t>{91, 81, 71, 61, 51, 41, 31, 21, 19, 18,
+                                                      17, 16, 15, 14, 13, 12, 11, 1}));
+
+    // A second filter narrows, in the same order
+    view.whereEquals(store.column("CODE"), "C1");
+    EXPECT_EQ(ids(store, view), (std::vector<int32_t>{91, 61, 31, 19, 16, 13, 1}));
+
+    // Re-ordering keeps the filters
+    view.orderBy({});
+    EXPECT_EQ(ids(store, view), (std::vector<int32_t>{1, 13, 16, 19, 31, 61, 91}));
+
+    view.clearFilters();
+    EXPECT_EQ(view.size(), 100u);
+    EXPECT_EQ(store.get<int32_t>(view.row(0), 0u).value_or(-1), 1);
+}
+
+TEST_F(RowStoreViewTest, IndexedEqualityMatchesAScan) {
+    auto store = load("SELECT id, name, code, amount FROM item ORDER BY id");
+    const unsigned code = store.column("CODE");
+    const unsigned id = store.column("ID");
+
+    RowStoreView scanned(store);
+    RowStoreView indexed(store);
+    indexed.addIndex(code);
+    indexed.addIndex(id);
+    EXPECT_TRUE(indexed.indexed(code));
+    EXPECT_FALSE(scanned.indexed(code));
+
+    for (RowStoreView* view : {&scanned, &indexed}) {
+        view->orderBy({{id, true}});
+        view->whereEquals(code, "C1");
+    }
+    EXPECT_EQ(indexed.size(), 34u);
+    EXPECT_EQ(ids(store, indexed), ids(store, scanned));
+    EXPECT_EQ(store.get<int32_t>(indexed.row(0), 0u).value_or(-1), 100);
+
+    for (RowStoreView* view : {&scanned, &indexed}) {
+        view->clearFilters();
+        view->whereEquals(id, int64_t{42});
+    }
+    EXPECT_EQ(ids(store, indexed), (std::vector<int32_t>{42}));
+    EXPECT_EQ(ids(store, scanned), (std::vector<int32_t>{42}));
+
+    // Unscaled NUMERIC values: 12.50 is 1250
+    scanned.clearFilters();
+    scanned.whereEquals(store.column("AMOUNT"), int64_t{1250});
+    EXPECT_EQ(ids(store, scanned), (std::vector<int32_t>{10}));
+}
+
+TEST_F(RowStoreViewTest, TextMatchModes) {
+    auto store = load("SELECT id, name FROM item ORDER BY id");
+    const unsigned name = store.column("NAME");
+    RowStoreView view(store);
+
+    view.whereText(name, "N1", TextMatch::Prefix);
+    EXPECT_EQ(view.size(), 10u);   // n1, n11 .. n19 (n10 is NULL)
+
+    view.clearFilters();
+    view.whereText(name, "N1", TextMatch::Prefix, false);
+    EXPECT_TRUE(view.empty());
+
+    view.clearFilters();
+    view.whereText(name, "n42", TextMatch::Exact);
+    EXPECT_EQ(ids(store, view), (std::vector<int32_t>{42}));
+
+    // Empty text keeps every non-NULL value
+    view.clearFilters();
+    view.whereText(name, "");
+    EXPECT_EQ(view.size(), 90u);
+
+    view.clearFilters();
+    view.where([&](const RowStore& s, std::size_t row) {
+        return s.get<int32_t>(row, 0u).value_or(0) > 95;
+    });
+    EXPECT_EQ(ids(store, view), (std::vector<int32_t>{96, 97, 98, 99, 100}));
+}
+
+TEST_F(RowStoreViewTest, WindowsAreClipped) {
+    auto store = load("SELECT id FROM item ORDER BY id");
+    RowStoreView view(store);
+    EXPECT_EQ(view.window(0, 10).size(), 10u);
+    EXPECT_EQ(view.window(95, 10).size(), 5u);
+    EXPECT_EQ(view.window(95, 10)[0], 95u);
+    EXPECT_TRUE(view.window(100, 10).empty());
+    EXPECT_THROW(view.row(100), FirebirdException);
+}
+
+TEST_F(RowStoreViewTest, RejectsUnsupportedColumnsAndStaleStores) {
+    auto store = load("SELECT id, name, score FROM item ORDER BY id");
+    RowStoreView view(store);
+    EXPECT_THROW(view.whereText(store.column("ID"), "1"), FirebirdException);
+    EXPECT_THROW(view.whereEquals(store.column("SCORE"), int64_t{10}), FirebirdException);
+    EXPECT_THROW(view.addIndex(store.column("SCORE")), FirebirdException);
+
+    store.sortBy(0, true);
+    EXPECT_TRUE(view.stale());
+    EXPECT_THROW(view.clearFilters(), FirebirdException);
+}
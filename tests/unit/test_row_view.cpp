@@ -7,15 +7,62 @@
 #include "fbpp/core/result_set.hpp"
 #include "fbpp/core/row.hpp"
 #include "fbpp/core/exception.hpp"
+#include "fbpp/core/param_binder.hpp"
+#include "fbpp/core/query_fields.hpp"
 
+#include <array>
+#include <cstdint>
 #include <optional>
 #include <string>
+#include <vector>
 
 // RowView — non-owning runtime row access.
 
 using namespace fbpp::core;
 using namespace fbpp::test;
 
+// What query_generator emits for
+// "SELECT id, name FROM rv WHERE id = :id OR id = :other OR id = :id"
+namespace generated::queries {
+enum class RvByIdParam : unsigned { ID, OTHER };
+enum class RvByIdCol : unsigned { ID, NAME };
+} // namespace generated::queries
+
+namespace fbpp::core {
+template<>
+struct QueryFields<generated::queries::RvByIdParam> {
+    static constexpr std::array<QueryFieldInfo, 3> fields = {{
+        {"id", SQL_LONG, 0}, {"other", SQL_LONG, 0}, {"id", SQL_LONG, 0}
+    }};
+};
+template<>
+struct QueryField<generated::queries::RvByIdParam::ID> {
+    using type = std::optional<std::int32_t>;
+    static constexpr std::array<std::size_t, 2> positions = {0, 2};
+};
+template<>
+struct QueryField<generated::queries::RvByIdParam::OTHER> {
+    using type = std::optional<std::int32_t>;
+    static constexpr std::array<std::size_t, 1> positions = {1};
+};
+template<>
+struct QueryFields<generated::queries::RvByIdCol> {
+    static constexpr std::array<QueryFieldInfo, 2> fields = {{
+        {"ID", SQL_LONG, 0}, {"NAME", SQL_VARYING, 0}
+    }};
+};
+template<>
+struct QueryField<generated::queries::RvByIdCol::ID> {
+    using type = std::int32_t;
+    static constexpr unsigned index = 0;
+};
+template<>
+struct QueryField<generated::queries::RvByIdCol::NAME> {
+    using type = std::string;
+    static constexpr unsigned index = 1;
+};
+} // namespace fbpp::core
+
 class RowViewTest : public TempDatabaseTest {
 protected:
     void createTestSchema() override {
@@ -176,6 +223,112 @@ TEST_F(RowViewTest, StringTrimmedForChar) {
     }
 }
 
+TEST_F(RowViewTest, GetViewReadsTextWithoutCopy) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement(
+        "SELECT id, name, fixed FROM rv ORDER BY id");
+    auto cur = tx->openCursor(stmt);
+    int seen = 0;
+    for (const auto& v : cur->rows()) {
+        ++seen;
+        if (*v.get<int32_t>("id") == 1) {
+            ASSERT_TRUE(v.getView("name").has_value());
+            EXPECT_EQ(*v.getView("name"), "Alice");
+            EXPECT_EQ(*v.getView("fixed"), "CHARFLD");   // CHAR padding trimmed
+            // The view aliases the fetch buffer.
+            EXPECT_GE(v.getView(1)->data(), reinterpret_cast<const char*>(v.data()));
+        } else {
+            EXPECT_FALSE(v.getView("name").has_value());
+            EXPECT_FALSE(v.getView("fixed").has_value());
+        }
+        EXPECT_THROW((void)v.getView("id"), FirebirdException);
+    }
+    EXPECT_EQ(seen, 2);
+}
+
+TEST_F(RowViewTest, ColumnRefAndBytesAccess) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement(
+        "SELECT id, name, fixed FROM rv ORDER BY id");
+    auto cur = tx->openCursor(stmt);
+    const ColumnRef id = cur->column("ID");
+    const ColumnRef name = cur->column("name");
+    const ColumnRef fixed = cur->column("fixed");
+    EXPECT_EQ(name.index(), 1u);
+    EXPECT_THROW((void)cur->column("missing"), FirebirdException);
+
+    int seen = 0;
+    for (const auto& v : cur->rows()) {
+        ++seen;
+        if (*v.get<int32_t>(id) == 1) {
+            EXPECT_EQ(*v.getView(name), "Alice");
+            auto bytes = v.getBytes(name);
+            ASSERT_TRUE(bytes.has_value());
+            EXPECT_EQ(std::string_view(reinterpret_cast<const char*>(bytes->data()), bytes->size()),
+                      "Alice");
+            auto padded = v.getBytes(fixed);   // CHAR slot with its padding
+            ASSERT_TRUE(padded.has_value());
+            ASSERT_GE(padded->size(), 8u);
+            EXPECT_EQ(std::string_view(reinterpret_cast<const char*>(padded->data()), 8),
+                      "CHARFLD ");
+        } else {
+            EXPECT_TRUE(v.isNull(name));
+            EXPECT_FALSE(v.getBytes(fixed).has_value());
+        }
+        EXPECT_THROW((void)v.getBytes(id), FirebirdException);
+    }
+    EXPECT_EQ(seen, 2);
+
+    // Cursors of the same statement share its metadata, and so the ref
+    auto again = tx->openCursor(stmt);
+    auto first = again->fetchOne();
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->get<int32_t>(id).value_or(-1), 1);
+
+    // Another statement's rows reject it
+    auto otherStmt = connection_->prepareStatement("SELECT name, id FROM rv WHERE id = 1");
+    auto other = tx->openCursor(otherStmt);
+    auto row = other->fetchOne();
+    ASSERT_TRUE(row.has_value());
+    EXPECT_THROW((void)row->get<int32_t>(id), FirebirdException);
+    EXPECT_EQ(row->get<int32_t>(row->column("id")).value_or(-1), 1);
+}
+
+TEST_F(RowViewTest, GeneratedColumnAndParamIndexes) {
+    using Col = generated::queries::RvByIdCol;
+    using Param = generated::queries::RvByIdParam;
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement(
+        "SELECT id, name FROM rv WHERE id = :id OR id = :other OR id = :id ORDER BY id");
+    auto& binder = stmt->binder(tx.get());
+    EXPECT_TRUE(set<Param::ID>(binder, 1));
+    EXPECT_TRUE(set<Param::OTHER>(binder, 2));
+
+    auto cur = tx->openCursor(stmt, binder);
+    std::vector<std::optional<std::string>> names;
+    for (const auto& v : cur->rows()) {
+        EXPECT_EQ(get<Col::ID>(v).value_or(-1), static_cast<int32_t>(names.size() + 1));
+        names.push_back(get<Col::NAME>(v));
+    }
+    ASSERT_EQ(names.size(), 2u);
+    EXPECT_EQ(names[0], std::optional<std::string>("Alice"));
+    EXPECT_FALSE(names[1].has_value());   // NULL name
+
+    EXPECT_TRUE(setNull<Param::OTHER>(binder));
+    auto one = tx->openCursor(stmt, binder);
+    auto row = one->fetchOne();
+    ASSERT_TRUE(row.has_value());
+    EXPECT_EQ(get<Col::NAME>(*row).value_or(""), "Alice");
+    EXPECT_FALSE(one->fetchOne().has_value());
+
+    // The columns checked once per statement: a different select list throws
+    auto swapped = connection_->prepareStatement("SELECT name, id FROM rv WHERE id = 1");
+    auto other = tx->openCursor(swapped);
+    auto otherRow = other->fetchOne();
+    ASSERT_TRUE(otherRow.has_value());
+    EXPECT_THROW((void)get<Col::ID>(*otherRow), FirebirdException);
+}
+
 #ifndef NDEBUG
 TEST_F(RowViewTest, GenerationGuardCatchesStaleViewInDebug) {
     auto tx = connection_->StartTransaction();
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include "fbpp/core/column_batch.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/scaled_numeric.hpp"
+#include "fbpp/adapters/ttmath_numeric.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+// NUMERIC scaling: power-of-ten tables, double and fixed-point kernels,
+// and the ColumnVector helpers built on them.
+
+using namespace fbpp::core;
+
+TEST(ScaledNumericTest, TablesHoldExactPowers) {
+    int64_t expected = 1;
+    for (int n = 0; n <= kMaxInt64Pow10; ++n) {
+        EXPECT_EQ(pow10Int64(n), expected);
+        expected = n < kMaxInt64Pow10 ? expected * 10 : expected;
+    }
+    for (int n = 0; n <= 22; ++n) {
+        EXPECT_EQ(pow10Double(n), std::pow(10.0, n));
+    }
+}
+
+TEST(ScaledNumericTest, ScaledToDoubleMatchesExactDivision) {
+    std::mt19937_64 rng(38);
+    std::vector<int64_t> raw(1000);
+    for (auto& v : raw) {
+        v = static_cast<int64_t>(rng() >> 10) - (int64_t{1} << 53);
+    }
+    for (int scale = -18; scale <= 2; ++scale) {
+        std::vector<double> out(raw.size());
+        scaledToDouble(raw.data(), raw.size(), scale, out.data());
+        for (std::size_t i = 0; i < raw.size(); ++i) {
+            const double expected = scale < 0
+                ? static_cast<double>(raw[i]) / std::pow(10.0, -scale)
+                : static_cast<double>(raw[i]) * std::pow(10.0, scale);
+            ASSERT_EQ(out[i], expected) << raw[i] << " at scale " << scale;
+            ASSERT_EQ(scaledToDouble(raw[i], scale), expected);
+        }
+    }
+    EXPECT_EQ(scaledToDouble(int64_t{1}, -1), 0.1);
+}
+
+TEST(ScaledNumericTest, RescaleIsExactAndRoundsHalfAway) {
+    const int64_t raw[] = {12345, -12345, 12350, -12350, 12349, -12349, 0};
+    int64_t out[7];
+
+    rescaleNumeric(raw, 7, -4, -2, out);   // 1.2345 -> 1.23
+    const int64_t down[] = {123, -123, 124, -124, 123, -123, 0};
+    for (int i = 0; i < 7; ++i) EXPECT_EQ(out[i], down[i]) << raw[i];
+
+    rescaleNumeric(raw, 7, -2, -6, out);
+    for (int i = 0; i < 7; ++i) EXPECT_EQ(out[i], raw[i] * 10000);
+
+    const int64_t edge[] = {std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max()};
+    rescaleNumeric(edge, 2, -2, -2, out);
+    EXPECT_EQ(out[0], edge[0]);
+    EXPECT_EQ(out[1], edge[1]);
+
+    const int64_t big[] = {1, 922337203685477581};
+    EXPECT_THROW(rescaleNumeric(big, 2, 0, -1, out), FirebirdException);
+    EXPECT_THROW(rescaleNumeric(raw, 1, 0, -19, out), FirebirdException);
+}
+
+TEST(ScaledNumericTest, ColumnHelpersApplyColumnScale) {
+    ColumnVector col;
+    col.name = "AMOUNT";
+    col.type = ColumnType::Int32;
+    col.scale = -2;
+    col.length = 3;
+    const int32_t values[] = {1999, -5, 0};
+    col.values.resize(sizeof(values));
+    std::memcpy(col.values.data(), values, sizeof(values));
+
+    double asDouble[3];
+    numericToDouble(col, asDouble);
+    EXPECT_EQ(asDouble[0], 19.99);
+    EXPECT_EQ(asDouble[1], -0.05);
+    EXPECT_EQ(asDouble[2], 0.0);
+
+    int64_t cents4[3];
+    numericToInt64(col, -4, cents4);
+    EXPECT_EQ(cents4[0], 199900);
+    EXPECT_EQ(cents4[1], -500);
+
+    col.type = ColumnType::Double;
+    EXPECT_THROW(numericToDouble(col, asDouble), FirebirdException);
+}
+
+TEST(ScaledNumericTest, TTNumericScalesByPowerTables) {
+    using Fixed = fbpp::adapters::TTNumeric<2, -12>;
+    const Fixed a("1.5");
+    const Fixed b("2.25");
+    EXPECT_EQ((a * b).to_string(), "3.375");
+    EXPECT_EQ((b / a).to_string(), "1.5");
+    EXPECT_DOUBLE_EQ(Fixed(-0.125).to_double(), -0.125);
+
+    ttmath::Int<2> v(-123456789);
+    detail::mul_pow10(v, 20);
+    detail::div_pow10_trunc(v, 19);
+    EXPECT_EQ(v.ToString(), "-1234567890");
+    detail::div_pow10_trunc(v, 11);
+    EXPECT_EQ(v.ToString(), "0");
+}
@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -33,9 +34,58 @@ protected:
             " END");
 
         connection_->ExecuteDDL("CREATE SEQUENCE test_seq INCREMENT BY 5");
+
+        // Child table: FK, unique key and a descending index for getAllTables()
+        connection_->ExecuteDDL(
+            "CREATE TABLE test_child ("
+            " id INTEGER NOT NULL PRIMARY KEY,"
+            " parent_id INTEGER REFERENCES test_table (id) ON DELETE CASCADE,"
+            " code VARCHAR(10) NOT NULL UNIQUE,"
+            " ordered_at TIMESTAMP)");
+        connection_->ExecuteDDL("CREATE DESCENDING INDEX test_child_at ON test_child (ordered_at, id)");
     }
 };
 
+namespace {
+
+void expectSameTable(const TableInfo& bulk, const TableInfo& single) {
+    SCOPED_TRACE(single.name);
+    EXPECT_EQ(bulk.name, single.name);
+    EXPECT_EQ(bulk.relationType, single.relationType);
+    ASSERT_EQ(bulk.columns.size(), single.columns.size());
+    for (size_t i = 0; i < single.columns.size(); ++i) {
+        EXPECT_EQ(bulk.columns[i].name, single.columns[i].name);
+        EXPECT_EQ(bulk.columns[i].sqlType, single.columns[i].sqlType);
+        EXPECT_EQ(bulk.columns[i].length, single.columns[i].length);
+        EXPECT_EQ(bulk.columns[i].notNull, single.columns[i].notNull);
+    }
+    ASSERT_EQ(bulk.indexes.size(), single.indexes.size());
+    for (size_t i = 0; i < single.indexes.size(); ++i) {
+        EXPECT_EQ(bulk.indexes[i].name, single.indexes[i].name);
+        EXPECT_EQ(bulk.indexes[i].unique, single.indexes[i].unique);
+        EXPECT_EQ(bulk.indexes[i].sortOrder, single.indexes[i].sortOrder);
+        ASSERT_EQ(bulk.indexes[i].segments.size(), single.indexes[i].segments.size());
+        for (size_t j = 0; j < single.indexes[i].segments.size(); ++j) {
+            EXPECT_EQ(bulk.indexes[i].segments[j].columnName, single.indexes[i].segments[j].columnName);
+        }
+    }
+    ASSERT_EQ(bulk.constraints.size(), single.constraints.size());
+    for (size_t i = 0; i < single.constraints.size(); ++i) {
+        EXPECT_EQ(bulk.constraints[i].name, single.constraints[i].name);
+        EXPECT_EQ(bulk.constraints[i].type, single.constraints[i].type);
+        EXPECT_EQ(bulk.constraints[i].columns, single.constraints[i].columns);
+        ASSERT_EQ(bulk.constraints[i].foreignKey.has_value(), single.constraints[i].foreignKey.has_value());
+        if (single.constraints[i].foreignKey) {
+            EXPECT_EQ(bulk.constraints[i].foreignKey->referencedTable,
+                      single.constraints[i].foreignKey->referencedTable);
+            EXPECT_EQ(bulk.constraints[i].foreignKey->deleteRule,
+                      single.constraints[i].foreignKey->deleteRule);
+        }
+    }
+}
+
+} // namespace
+
 // ---------------------------------------------------------------------------
 // Table existence
 // ---------------------------------------------------------------------------
@@ -178,6 +228,54 @@ TEST_F(SchemaInspectorTest, GetTableInfo_NonExistent) {
     EXPECT_TRUE(info.constraints.empty());
 }
 
+// ---------------------------------------------------------------------------
+// getAllTables — bulk load
+// ---------------------------------------------------------------------------
+
+TEST_F(SchemaInspectorTest, GetAllTables_MatchesGetTableInfo) {
+    SchemaInspector inspector(*connection_);
+    auto tables = inspector.getAllTables();
+
+    std::vector<std::string> names;
+    for (const auto& table : tables) {
+        names.push_back(table.name);
+        expectSameTable(table, inspector.getTableInfo(table.name));
+    }
+    EXPECT_TRUE(std::is_sorted(names.begin(), names.end()));
+    EXPECT_EQ(names, inspector.getTableNames());   // The basic schema has no views
+
+    auto child = std::find_if(tables.begin(), tables.end(),
+                              [](const TableInfo& t) { return t.name == "TEST_CHILD"; });
+    ASSERT_NE(child, tables.end());
+    auto desc = std::find_if(child->indexes.begin(), child->indexes.end(),
+                             [](const IndexInfo& i) { return i.name == "TEST_CHILD_AT"; });
+    ASSERT_NE(desc, child->indexes.end());
+    EXPECT_EQ(desc->sortOrder, SortOrder::descending);
+    ASSERT_EQ(desc->segments.size(), 2u);
+    EXPECT_EQ(desc->segments[1].columnName, "ID");
+    auto fk = std::find_if(child->constraints.begin(), child->constraints.end(),
+                           [](const ConstraintInfo& c) { return c.type == ConstraintType::foreign_key; });
+    ASSERT_NE(fk, child->constraints.end());
+    ASSERT_TRUE(fk->foreignKey.has_value());
+    EXPECT_EQ(fk->foreignKey->referencedTable, "TEST_TABLE");
+    EXPECT_EQ(fk->foreignKey->deleteRule, "CASCADE");
+    EXPECT_EQ(fk->columns, std::vector<std::string>{"PARENT_ID"});
+}
+
+TEST_F(SchemaInspectorTest, GetAllTables_PartitionedAcrossConnections) {
+    auto bulk = SchemaInspector(*connection_).getAllTables();
+
+    Connection second(db_params_);
+    Connection third(db_params_);
+    auto parted = SchemaInspector::getAllTables({connection_.get(), &second, &third});
+    ASSERT_EQ(parted.size(), bulk.size());
+    for (size_t i = 0; i < bulk.size(); ++i) {
+        expectSameTable(parted[i], bulk[i]);
+    }
+
+    EXPECT_THROW(SchemaInspector::getAllTables({}), std::invalid_argument);
+}
+
 // ---------------------------------------------------------------------------
 // Stored procedures
 // ---------------------------------------------------------------------------
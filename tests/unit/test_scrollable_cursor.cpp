@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/batch.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Scrollable cursors — server-side positioning and page fetches.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+class ScrollableCursorTest : public TempDatabaseTest {
+protected:
+    static constexpr int32_t kRows = 100;
+
+    void createTestSchema() override {
+        connection_->ExecuteDDL("CREATE TABLE sc (id INTEGER NOT NULL PRIMARY KEY, name VARCHAR(20))");
+        auto tx = connection_->StartTransaction();
+        std::vector<std::tuple<int32_t, std::string>> rows;
+        for (int32_t i = 1; i <= kRows; ++i) {
+            rows.emplace_back(i, "n" + std::to_string(i));
+        }
+        auto batch = connection_->prepareStatement("INSERT INTO sc VALUES (?, ?)")
+                         ->createBatch(tx.get(), false);
+        batch->addMany(rows);
+        batch->execute(tx.get());
+        tx->Commit();
+    }
+
+    std::unique_ptr<ResultSet> open(Transaction& tx) {
+        return tx.openScrollableCursor(
+            connection_->prepareStatement("SELECT id, name FROM sc ORDER BY id"));
+    }
+};
+
+TEST_F(ScrollableCursorTest, PositioningMoves) {
+    if (connection_->getEngineMajorVersion() < 3) {
+        GTEST_SKIP() << "Scrollable cursors need Firebird 3";
+    }
+    auto tx = connection_->StartTransaction();
+    auto cur = open(*tx);
+    std::tuple<int32_t, std::string> row;
+
+    ASSERT_TRUE(cur->fetchLast(row));
+    EXPECT_EQ(std::get<0>(row), kRows);
+    ASSERT_TRUE(cur->fetchPrior(row));
+    EXPECT_EQ(std::get<0>(row), kRows - 1);
+    ASSERT_TRUE(cur->fetchAbsolute(10, row));
+    EXPECT_EQ(std::get<1>(row), "n10");
+    ASSERT_TRUE(cur->fetchRelative(5, row));
+    EXPECT_EQ(std::get<0>(row), 15);
+    ASSERT_TRUE(cur->fetchAbsolute(-2, row));
+    EXPECT_EQ(std::get<0>(row), kRows - 1);
+    ASSERT_TRUE(cur->fetchFirst(row));
+    EXPECT_EQ(std::get<0>(row), 1);
+    EXPECT_FALSE(cur->fetchPrior(row));
+
+    // Forward fetching continues from the position
+    ASSERT_TRUE(cur->fetchAbsolute(50, row));
+    ASSERT_TRUE(cur->fetch(row));
+    EXPECT_EQ(std::get<0>(row), 51);
+    EXPECT_FALSE(cur->fetchAbsolute(kRows + 1, row));
+    cur->close();
+    tx->Commit();
+}
+
+TEST_F(ScrollableCursorTest, RelativeMovesAccountForThePrefetchWindow) {
+    if (connection_->getEngineMajorVersion() < 3) {
+        GTEST_SKIP() << "Scrollable cursors need Firebird 3";
+    }
+    auto tx = connection_->StartTransaction();
+    auto cur = open(*tx);
+    cur->setPrefetch(16);
+    std::tuple<int32_t, std::string> row;
+
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(cur->fetch(row));
+    }
+    EXPECT_EQ(std::get<0>(row), 3);
+    ASSERT_TRUE(cur->fetchPrior(row));
+    EXPECT_EQ(std::get<0>(row), 2);
+    ASSERT_TRUE(cur->fetchRelative(0, row));
+    EXPECT_EQ(std::get<0>(row), 2);
+
+    // Window ran past the end: relative moves still count from the last row served
+    ASSERT_TRUE(cur->fetchAbsolute(kRows - 3, row));
+    ASSERT_TRUE(cur->fetch(row));
+    EXPECT_EQ(std::get<0>(row), kRows - 2);
+    ASSERT_TRUE(cur->fetchRelative(-1, row));
+    EXPECT_EQ(std::get<0>(row), kRows - 3);
+    cur->close();
+    tx->Commit();
+}
+
+TEST_F(ScrollableCursorTest, PagesReuseTheBatch) {
+    if (connection_->getEngineMajorVersion() < 3) {
+        GTEST_SKIP() << "Scrollable cursors need Firebird 3";
+    }
+    auto tx = connection_->StartTransaction();
+    auto cur = open(*tx);
+    ColumnBatch page;
+
+    ASSERT_TRUE(cur->fetchPage(41, 20, page));
+    ASSERT_EQ(page.rowCount, 20u);
+    EXPECT_EQ(page.columns[0].view<int32_t>()[0], 41);
+    EXPECT_EQ(page.columns[1].stringAt(19), "n60");
+
+    ASSERT_TRUE(cur->fetchPage(1, 20, page));
+    EXPECT_EQ(page.columns[0].view<int32_t>()[0], 1);
+
+    ASSERT_TRUE(cur->fetchPage(91, 20, page));
+    EXPECT_EQ(page.rowCount, 10u);
+    EXPECT_EQ(page.columns[0].view<int32_t>()[9], kRows);
+
+    EXPECT_FALSE(cur->fetchPage(kRows + 1, 20, page));
+    EXPECT_EQ(page.rowCount, 0u);
+    EXPECT_THROW(cur->fetchPage(1, 0, page), FirebirdException);
+    cur->close();
+    tx->Commit();
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/schema/sequence_allocator.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// SequenceAllocator — GEN_ID blocks, concurrent hand-out, background refill.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+using fbpp::schema::SequenceAllocator;
+using fbpp::schema::SequenceAllocatorOptions;
+
+class SequenceAllocatorTest : public TempDatabaseTest {
+protected:
+    void createTestSchema() override {
+        connection_->ExecuteDDL("CREATE SEQUENCE alloc_seq");
+        connection_->ExecuteDDL("CREATE SEQUENCE alloc_step START WITH 10 INCREMENT BY 5");
+    }
+
+    int64_t current(const std::string& sequence) {
+        auto tx = connection_->StartTransaction();
+        auto cur = tx->openCursor(connection_->prepareStatement(
+            "SELECT GEN_ID(" + sequence + ", 0) FROM RDB$DATABASE"));
+        std::tuple<int64_t> row;
+        EXPECT_TRUE(cur->fetch(row));
+        cur->close();
+        tx->Commit();
+        return std::get<0>(row);
+    }
+};
+
+TEST_F(SequenceAllocatorTest, HandsOutBlocksInOrder) {
+    SequenceAllocatorOptions options;
+    options.blockSize = 10;
+    options.asyncRefill = false;
+    SequenceAllocator ids(db_params_, "alloc_seq", options);
+
+    std::vector<int64_t> values(25);
+    ids.next(values.data(), values.size());
+    for (std::size_t i = 1; i < values.size(); ++i) {
+        EXPECT_EQ(values[i], values[i - 1] + 1);
+    }
+    EXPECT_EQ(ids.stats().blocks, 3u);
+    EXPECT_EQ(ids.stats().issued, 25u);
+    EXPECT_EQ(current("alloc_seq"), values.front() + 29);   // Three blocks reserved
+}
+
+TEST_F(SequenceAllocatorTest, UsesTheSequenceIncrement) {
+    SequenceAllocatorOptions options;
+    options.blockSize = 4;
+    SequenceAllocator ids(db_params_, "ALLOC_STEP", options);
+    EXPECT_EQ(ids.increment(), 5);
+    const int64_t first = ids.next();
+    for (int i = 1; i < 10; ++i) {
+        EXPECT_EQ(ids.next(), first + 5 * i);
+    }
+}
+
+TEST_F(SequenceAllocatorTest, ConcurrentCallersGetUniqueIds) {
+    SequenceAllocatorOptions options;
+    options.blockSize = 100;
+    SequenceAllocator ids(db_params_, "alloc_seq", options);
+
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 5000;
+    std::vector<std::vector<int64_t>> taken(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            taken[t].reserve(kPerThread);
+            for (int i = 0; i < kPerThread; ++i) {
+                taken[t].push_back(ids.next());
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<int64_t> all;
+    for (const auto& part : taken) {
+        all.insert(all.end(), part.begin(), part.end());
+    }
+    std::sort(all.begin(), all.end());
+    EXPECT_EQ(std::adjacent_find(all.begin(), all.end()), all.end());
+    EXPECT_LE(all.back(), current("alloc_seq"));
+    const auto stats = ids.stats();
+    EXPECT_EQ(stats.issued, static_cast<uint64_t>(kThreads * kPerThread));
+    EXPECT_GE(stats.blocks, static_cast<uint64_t>(kThreads * kPerThread / 100));
+}
+
+TEST_F(SequenceAllocatorTest, UnknownSequenceIsRejected) {
+    EXPECT_THROW(SequenceAllocator(db_params_, "NO_SUCH_SEQ"), FirebirdException);
+}
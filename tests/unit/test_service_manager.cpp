@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/services/service_manager.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <tuple>
+#include <unistd.h>
+#include <vector>
+
+// ServiceManager: server version, gbak backup/restore streamed over the
+// service connection (to memory and to a client-side file) and sweep.
+
+using namespace fbpp::core;
+using namespace fbpp::services;
+using namespace fbpp::test;
+
+namespace {
+
+constexpr int kRows = 500;
+
+// "host:/path/db.fdb" -> host; a bare path means the local server
+std::string serverOf(const std::string& database) {
+    const auto separator = database.find(':');
+    return separator == std::string::npos || separator < 2 ? std::string()
+                                                           : database.substr(0, separator);
+}
+
+std::string pathOf(const std::string& database) {
+    const auto separator = database.find(':');
+    return separator == std::string::npos || separator < 2 ? database
+                                                           : database.substr(separator + 1);
+}
+
+int64_t countRows(const ConnectionParams& params) {
+    Connection conn(params);
+    auto tx = conn.StartTransaction();
+    auto stmt = conn.prepareStatement("SELECT COUNT(*) FROM svc_item");
+    auto cur = tx->openCursor(stmt);
+    std::tuple<int64_t> row;
+    EXPECT_TRUE(cur->fetch(row));
+    tx->Commit();
+    return std::get<0>(row);
+}
+
+} // namespace
+
+class ServiceManagerTest : public TempDatabaseTest {
+protected:
+    void SetUp() override {
+        TempDatabaseTest::SetUp();
+        connection_->ExecuteDDL(
+            "CREATE TABLE svc_item (id INTEGER NOT NULL PRIMARY KEY, name VARCHAR(40))");
+        auto tx = connection_->StartTransaction();
+        auto ins = connection_->prepareStatement("INSERT INTO svc_item (id, name) VALUES (?, ?)");
+        for (int32_t id = 1; id <= kRows; ++id) {
+            tx->execute(ins, std::make_tuple(id, std::string("item ") + std::to_string(id)));
+        }
+        tx->Commit();
+
+        target_ = makeScopedTestDatabaseParams("services_restore");
+        dropTestDatabaseQuietly(target_);
+    }
+
+    void TearDown() override {
+        dropTestDatabaseQuietly(target_);
+        TempDatabaseTest::TearDown();
+    }
+
+    ServiceConnectParams serviceParams() const {
+        ServiceConnectParams params;
+        params.server = serverOf(db_params_.database);
+        params.user = db_params_.user;
+        params.password = db_params_.password;
+        return params;
+    }
+
+    ConnectionParams target_;
+};
+
+TEST_F(ServiceManagerTest, ReportsServerVersion) {
+    ServiceManager svc(serviceParams());
+    const std::string version = svc.getServerVersion();
+    EXPECT_NE(version.find("5."), std::string::npos) << version;
+}
+
+TEST_F(ServiceManagerTest, StreamsBackupAndRestoreThroughMemory) {
+    ServiceManager svc(serviceParams());
+
+    std::vector<uint8_t> backup;
+    uint64_t reports = 0;
+    BackupOptions backupOptions;
+    backupOptions.parallelWorkers = 2;
+    const uint64_t written = svc.backupTo(
+        pathOf(db_params_.database),
+        [&](const uint8_t* data, size_t size) { backup.insert(backup.end(), data, data + size); },
+        backupOptions, [&](const ServiceProgress& progress) {
+            ++reports;
+            EXPECT_LE(progress.bytes, backup.size());
+        });
+    ASSERT_GT(written, 0u);
+    EXPECT_EQ(written, backup.size());
+    EXPECT_GT(reports, 0u);
+
+    size_t offset = 0;
+    uint64_t lines = 0;
+    RestoreOptions restoreOptions;
+    restoreOptions.replace = true;
+    restoreOptions.verboseInterval = 100;
+    restoreOptions.parallelWorkers = 2;
+    const uint64_t read = svc.restoreFrom(
+        [&](uint8_t* buffer, size_t capacity) {
+            const size_t n = std::min(capacity, backup.size() - offset);
+            std::memcpy(buffer, backup.data() + offset, n);
+            offset += n;
+            return n;
+        },
+        pathOf(target_.database), restoreOptions, [&](const ServiceProgress& progress) {
+            if (!progress.line.empty()) {
+                lines = progress.lines;
+            }
+        });
+    EXPECT_EQ(read, backup.size());
+    EXPECT_GT(lines, 0u);
+
+    EXPECT_EQ(countRows(target_), kRows);
+}
+
+TEST_F(ServiceManagerTest, StreamsBackupToAClientFile) {
+    const auto file = std::filesystem::temp_directory_path() /
+                      ("fbpp_services_" + std::to_string(::getpid()) + ".fbk");
+    ServiceManager svc(serviceParams());
+    const uint64_t written = svc.backupToFile(pathOf(db_params_.database), file);
+    EXPECT_EQ(written, std::filesystem::file_size(file));
+
+    RestoreOptions options;
+    options.replace = true;
+    EXPECT_EQ(svc.restoreFromFile(file, pathOf(target_.database), options), written);
+    std::filesystem::remove(file);
+
+    EXPECT_EQ(countRows(target_), kRows);
+}
+
+TEST_F(ServiceManagerTest, CreateOnlyRestoreRefusesAnExistingDatabase) {
+    ServiceManager svc(serviceParams());
+    std::vector<uint8_t> backup;
+    BackupOptions metadataOnly;
+    metadataOnly.metadataOnly = true;
+    svc.backupTo(pathOf(db_params_.database), [&](const uint8_t* data, size_t size) {
+        backup.insert(backup.end(), data, data + size);
+    }, metadataOnly);
+
+    size_t offset = 0;
+    auto source = [&](uint8_t* buffer, size_t capacity) {
+        const size_t n = std::min(capacity, backup.size() - offset);
+        std::memcpy(buffer, backup.data() + offset, n);
+        offset += n;
+        return n;
+    };
+    // The source database exists, so a create-only restore onto it must fail
+    EXPECT_THROW(svc.restoreFrom(source, pathOf(db_params_.database)), FirebirdException);
+}
+
+TEST_F(ServiceManagerTest, SweepsWithParallelWorkers) {
+    ServiceManager svc(serviceParams());
+    const std::string database = pathOf(db_params_.database);
+    svc.setSweepInterval(database, 0);
+    svc.sweep(database, 2);
+    svc.setSweepInterval(database, 20000);
+
+    // The database stays usable
+    EXPECT_EQ(countRows(db_params_), kRows);
+}
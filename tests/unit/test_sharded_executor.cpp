@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/sharded_executor.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// ShardedExecutor — fan-out over several databases with merged results.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+namespace {
+
+constexpr std::size_t kShards = 3;
+
+// Runs for minutes unless cancelled
+constexpr const char* kSlowQuery =
+    "SELECT COUNT(*) FROM RDB$FIELDS a, RDB$FIELDS b, RDB$FIELDS c";
+
+} // namespace
+
+class ShardedExecutorTest : public TempDatabaseTest {
+protected:
+    void SetUp() override {
+        TempDatabaseTest::SetUp();
+        // connection_ is shard 0; two more databases of their own
+        for (std::size_t s = 1; s < kShards; ++s) {
+            auto params = makeScopedTestDatabaseParams("sharded_" + std::to_string(s));
+            recreateTestDatabase(params);
+            extraParams_.push_back(params);
+            extra_.push_back(std::make_unique<Connection>(params));
+        }
+        std::vector<Connection*> shards{connection_.get()};
+        for (auto& conn : extra_) {
+            shards.push_back(conn.get());
+        }
+        for (std::size_t s = 0; s < kShards; ++s) {
+            seed(*shards[s], s);
+        }
+        executor_ = std::make_unique<ShardedExecutor>(shards);
+    }
+
+    void TearDown() override {
+        executor_.reset();
+        extra_.clear();
+        for (const auto& params : extraParams_) {
+            dropTestDatabaseQuietly(params);
+        }
+        TempDatabaseTest::TearDown();
+    }
+
+    // Shard s holds ids s, s + 3, ... below 30
+    static void seed(Connection& conn, std::size_t shard) {
+        conn.ExecuteDDL("CREATE TABLE tenant_order (id INTEGER NOT NULL, total BIGINT)");
+        if (shard == kShards - 1) {
+            conn.ExecuteDDL("CREATE TABLE shard_only (id INTEGER)");
+        }
+        auto tx = conn.StartTransaction();
+        auto ins = conn.prepareStatement("INSERT INTO tenant_order (id, total) VALUES (?, ?)");
+        for (int32_t id = static_cast<int32_t>(shard); id < 30; id += kShards) {
+            tx->execute(ins, std::make_tuple(id, int64_t{id} * 10));
+        }
+        tx->Commit();
+    }
+
+    std::vector<ConnectionParams> extraParams_;
+    std::vector<std::unique_ptr<Connection>> extra_;
+    std::unique_ptr<ShardedExecutor> executor_;
+};
+
+TEST_F(ShardedExecutorTest, ConcatenatesInShardOrder) {
+    auto result = executor_->concat<std::tuple<int32_t, int64_t>>(
+        "SELECT id, total FROM tenant_order WHERE total >= ? ORDER BY id",
+        std::make_tuple(int64_t{0}));
+    ASSERT_TRUE(result.complete());
+    ASSERT_EQ(result.rows.size(), 30u);
+    ASSERT_EQ(result.shardRows.size(), kShards);
+    for (std::size_t s = 0; s < kShards; ++s) {
+        EXPECT_EQ(result.shardRows[s], 10u);
+    }
+    EXPECT_EQ(std::get<0>(result.rows[0]), 0);
+    EXPECT_EQ(std::get<0>(result.rows[10]), 1);
+    EXPECT_EQ(std::get<0>(result.rows[20]), 2);
+}
+
+TEST_F(ShardedExecutorTest, MergesOrderedShards) {
+    auto result = executor_->mergeSorted<std::tuple<int32_t, int64_t>>(
+        "SELECT id, total FROM tenant_order ORDER BY id DESC",
+        [](const auto& a, const auto& b) { return std::get<0>(a) > std::get<0>(b); });
+    ASSERT_TRUE(result.complete());
+    ASSERT_EQ(result.rows.size(), 30u);
+    for (std::size_t i = 0; i < result.rows.size(); ++i) {
+        EXPECT_EQ(std::get<0>(result.rows[i]), static_cast<int32_t>(29 - i));
+    }
+}
+
+TEST_F(ShardedExecutorTest, MergesShardStoresSortedOnTheClient) {
+    // No ORDER BY: each shard's store is sorted by the sorter's keys
+    RowSorter sorter({SortKey{1, true}, SortKey{0}});
+    auto result = executor_->mergeSortedStore("SELECT id, total FROM tenant_order", sorter);
+    ASSERT_TRUE(result.complete());
+    ASSERT_EQ(result.rows.size(), 30u);
+    EXPECT_EQ(result.shardRows, (std::vector<std::size_t>{10, 10, 10}));
+    for (std::size_t i = 0; i < result.rows.size(); ++i) {
+        EXPECT_EQ(result.rows.get<int32_t>(i, 0).value_or(-1), static_cast<int32_t>(29 - i));
+    }
+
+    auto failed = executor_->mergeSortedStore("SELECT id FROM shard_only", RowSorter({{0}}));
+    ASSERT_EQ(failed.errors.size(), kShards - 1);
+    EXPECT_EQ(failed.rows.size(), 0u);
+    EXPECT_EQ(failed.rows.columnCount(), 1u);   // The shard that has the table
+}
+
+TEST_F(ShardedExecutorTest, CombinesPartialAggregates) {
+    auto result = executor_->combine<std::tuple<int64_t, int64_t>>(
+        "SELECT COUNT(*), SUM(total) FROM tenant_order",
+        [](std::tuple<int64_t, int64_t> acc, const std::tuple<int64_t, int64_t>& next) {
+            std::get<0>(acc) += std::get<0>(next);
+            std::get<1>(acc) += std::get<1>(next);
+            return acc;
+        });
+    ASSERT_TRUE(result.complete());
+    ASSERT_EQ(result.rows.size(), 1u);
+    EXPECT_EQ(std::get<0>(result.rows[0]), 30);
+    EXPECT_EQ(std::get<1>(result.rows[0]), 4350);   // 10 * (0 + ... + 29)
+}
+
+TEST_F(ShardedExecutorTest, AggregatesRowsExactly) {
+    auto result = executor_->aggregate(
+        "SELECT total, CAST(total AS NUMERIC(18, 2)) / 4 AS quarter FROM tenant_order");
+    ASSERT_TRUE(result.complete());
+    ASSERT_EQ(result.columns.size(), 2u);
+    EXPECT_EQ(result.shardRows, (std::vector<std::size_t>{10, 10, 10}));
+
+    const auto& total = result.columns[0];
+    EXPECT_EQ(total.count(), 30u);
+    EXPECT_EQ(total.sumText(), "4350");
+    EXPECT_EQ(total.minText(), "0");
+    EXPECT_EQ(total.maxText(), "290");
+
+    const auto* quarter = result.find("quarter");
+    ASSERT_NE(quarter, nullptr);
+    EXPECT_EQ(quarter->sumText(), "1087.50");
+    EXPECT_EQ(quarter->maxText(), "72.50");
+
+    auto failed = executor_->aggregate("SELECT id FROM shard_only");
+    ASSERT_EQ(failed.errors.size(), kShards - 1);
+    ASSERT_EQ(failed.columns.size(), 1u);   // The shard that has the table
+    EXPECT_EQ(failed.columns[0].count(), 0u);
+    EXPECT_FALSE(failed.columns[0].sumText().has_value());
+}
+
+TEST_F(ShardedExecutorTest, ReportsPerShardErrors) {
+    auto result = executor_->concat<std::tuple<int32_t>>("SELECT id FROM shard_only");
+    ASSERT_EQ(result.errors.size(), kShards - 1);
+    EXPECT_EQ(result.errors[0].shard, 0u);
+    EXPECT_EQ(result.errors[1].shard, 1u);
+    EXPECT_FALSE(result.errors[0].cancelled);
+    EXPECT_FALSE(result.errors[0].message.empty());
+    EXPECT_EQ(result.shardRows[kShards - 1], 0u);
+    EXPECT_TRUE(result.rows.empty());
+    EXPECT_THROW(result.rethrow(), FirebirdException);
+
+    // The connections stay usable
+    EXPECT_TRUE(executor_->concat<std::tuple<int32_t>>("SELECT id FROM tenant_order").complete());
+}
+
+TEST_F(ShardedExecutorTest, TimeoutCancelsEveryShard) {
+    ShardOptions options;
+    options.timeout = std::chrono::milliseconds(300);
+    const auto started = std::chrono::steady_clock::now();
+    auto result = executor_->concat<std::tuple<int64_t>>(kSlowQuery, std::tuple<>{}, options);
+    EXPECT_LT(std::chrono::steady_clock::now() - started, std::chrono::seconds(10));
+    ASSERT_EQ(result.errors.size(), kShards);
+    for (const auto& error : result.errors) {
+        EXPECT_TRUE(error.cancelled);
+    }
+}
+
+TEST_F(ShardedExecutorTest, RunsOnAnExecutor) {
+    std::size_t posted = 0;
+    ShardOptions options;
+    options.executor = [&](std::function<void()> task) {
+        ++posted;
+        task();   // Inline: the caller's pool would run it elsewhere
+    };
+    auto errors = executor_->forEach(
+        [](Connection& conn, std::size_t) {
+            auto tx = conn.StartTransaction();
+            tx->Commit();
+        },
+        options);
+    EXPECT_TRUE(errors.empty());
+    EXPECT_EQ(posted, kShards);
+}
@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/slow_query_log.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/statement_cache.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp_util/trace.h"
+
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// SlowQueryLog — sampled statements over a threshold, with breakdown and plan.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+namespace {
+
+struct RecordedEntry {
+    SlowQueryKind kind;
+    std::string sql;
+    uint64_t fingerprint = 0;
+    std::string parameters;
+    SlowQueryTimings timings;
+    uint64_t rows = 0;
+    bool failed = false;
+    std::string plan;
+};
+
+class RecordingLog : public SlowQueryLog {
+public:
+    using SlowQueryLog::SlowQueryLog;
+
+    std::vector<RecordedEntry> recorded() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_;
+    }
+
+protected:
+    void write(const SlowQueryEntry& entry) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.push_back(RecordedEntry{entry.kind, std::string(entry.sql), entry.fingerprint,
+                                         entry.parameters, entry.timings, entry.rows,
+                                         entry.failed, entry.plan});
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<RecordedEntry> entries_;
+};
+
+class CapturingSink : public fbpp::util::TraceSink {
+public:
+    void log(fbpp::util::TraceLevel, std::string_view component,
+             std::string_view message) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (component == "SlowQuery") {
+            messages.emplace_back(message);
+        }
+    }
+
+    std::mutex mutex;
+    std::vector<std::string> messages;
+};
+
+SlowQueryLogOptions logEverything() {
+    SlowQueryLogOptions options;
+    options.threshold = std::chrono::microseconds(0);
+    return options;
+}
+
+} // namespace
+
+class SlowQueryLogTest : public TempDatabaseTest {
+protected:
+    void createTestSchema() override {
+        connection_->ExecuteDDL(
+            "CREATE TABLE slow_t (id INTEGER NOT NULL PRIMARY KEY, name VARCHAR(20))");
+    }
+
+    void TearDown() override {
+        setSlowQueryLog(nullptr);
+        TempDatabaseTest::TearDown();
+    }
+
+    void insertRows(int32_t count) {
+        auto tx = connection_->StartTransaction();
+        auto insert = connection_->prepareStatement("INSERT INTO slow_t (id, name) VALUES (?, ?)");
+        for (int32_t id = 1; id <= count; ++id) {
+            tx->execute(insert, std::make_tuple(id, std::string("name") + std::to_string(id)));
+        }
+        tx->Commit();
+    }
+};
+
+TEST_F(SlowQueryLogTest, ExecuteEntryHasSizesAndAffectedRows) {
+    RecordingLog log(logEverything());
+    setSlowQueryLog(&log);
+
+    const std::string sql = "INSERT INTO slow_t (id, name) VALUES (?, ?)";
+    auto tx = connection_->StartTransaction();
+    auto insert = connection_->prepareStatement(sql);
+    tx->execute(insert, std::make_tuple(int32_t{7}, std::string("seven")));
+    tx->execute(insert, std::make_tuple(int32_t{8}, std::optional<std::string>{}));
+    EXPECT_THROW(tx->execute(insert, std::make_tuple(int32_t{7}, std::string("dup"))),
+                 FirebirdException);
+    tx->Rollback();
+
+    auto entries = log.recorded();
+    ASSERT_EQ(entries.size(), 3u);
+    EXPECT_EQ(entries[0].kind, SlowQueryKind::Execute);
+    EXPECT_EQ(entries[0].sql, sql);
+    EXPECT_EQ(entries[0].fingerprint, SqlKey::hashOf(sql, 0));
+    EXPECT_EQ(entries[0].parameters, "$1=4B $2=5B");   // Sizes, not values
+    EXPECT_EQ(entries[0].rows, 1u);
+    EXPECT_FALSE(entries[0].failed);
+    EXPECT_GT(entries[0].timings.execute.count(), 0);
+    EXPECT_EQ(entries[0].timings.fetch.count(), 0);
+    EXPECT_EQ(entries[1].parameters, "$1=4B $2=NULL");
+    EXPECT_TRUE(entries[2].failed);
+    EXPECT_EQ(log.stats().sampled, 3u);
+    EXPECT_EQ(log.stats().logged, 3u);
+}
+
+TEST_F(SlowQueryLogTest, CursorEntryHasBreakdownRowsAndPlan) {
+    insertRows(25);
+    auto options = logEverything();
+    options.parameterValues = true;
+    RecordingLog log(options);
+    setSlowQueryLog(&log);
+
+    const std::string sql = "SELECT id, name FROM slow_t WHERE id > ? ORDER BY id";
+    auto tx = connection_->StartTransaction();
+    auto select = connection_->prepareStatement(sql);
+    {
+        auto cursor = tx->openCursor(select, std::make_tuple(int32_t{5}));
+        std::tuple<int32_t, std::optional<std::string>> row;
+        while (cursor->fetch(row)) {
+        }
+        cursor->close();
+    }
+    tx->Commit();
+
+    auto entries = log.recorded();
+    ASSERT_EQ(entries.size(), 1u);
+    const auto& entry = entries[0];
+    EXPECT_EQ(entry.kind, SlowQueryKind::Cursor);
+    EXPECT_EQ(entry.sql, sql);
+    EXPECT_EQ(entry.parameters, "$1=5");
+    EXPECT_EQ(entry.rows, 20u);
+    EXPECT_GT(entry.timings.pack.count(), 0);
+    EXPECT_GT(entry.timings.execute.count(), 0);
+    EXPECT_GT(entry.timings.fetch.count(), 0);
+    EXPECT_GT(entry.timings.unpack.count(), 0);
+    EXPECT_EQ(entry.plan, select->getPlan(true));
+    EXPECT_NE(entry.plan.find("SLOW_T"), std::string::npos);
+}
+
+TEST_F(SlowQueryLogTest, ThresholdAndSamplingFilter) {
+    insertRows(3);
+    SlowQueryLogOptions slowOnly;
+    slowOnly.threshold = std::chrono::hours(1);
+    RecordingLog highBar(slowOnly);
+    setSlowQueryLog(&highBar);
+
+    auto tx = connection_->StartTransaction();
+    auto select = connection_->prepareStatement("SELECT id FROM slow_t");
+    for (int i = 0; i < 3; ++i) {
+        auto cursor = tx->openCursor(select);
+        std::tuple<int32_t> row;
+        while (cursor->fetch(row)) {
+        }
+        cursor->close();
+    }
+    EXPECT_EQ(highBar.stats().sampled, 3u);
+    EXPECT_EQ(highBar.stats().logged, 0u);
+
+    auto none = logEverything();
+    none.sampleRate = 0.0;
+    RecordingLog unsampled(none);
+    setSlowQueryLog(&unsampled);
+    tx->execute(connection_->prepareStatement("UPDATE slow_t SET name = 'x'"));
+    tx->Commit();
+    EXPECT_EQ(unsampled.stats().sampled, 0u);
+    EXPECT_TRUE(unsampled.recorded().empty());
+
+    auto invalid = logEverything();
+    invalid.sampleRate = 1.5;
+    EXPECT_THROW(RecordingLog rejected(invalid), FirebirdException);
+}
+
+TEST_F(SlowQueryLogTest, DefaultWriteGoesToTraceSink) {
+    CapturingSink sink;
+    fbpp::util::setTraceSink(&sink);
+    SlowQueryLog log(logEverything());
+    setSlowQueryLog(&log);
+
+    auto tx = connection_->StartTransaction();
+    tx->execute(connection_->prepareStatement("INSERT INTO slow_t (id) VALUES (1)"));
+    tx->Commit();
+    setSlowQueryLog(nullptr);
+    fbpp::util::setTraceSink(nullptr);
+
+    ASSERT_EQ(sink.messages.size(), 1u);
+    EXPECT_EQ(sink.messages[0].rfind("execute ", 0), 0u);
+    EXPECT_NE(sink.messages[0].find("rows=1"), std::string::npos);
+    EXPECT_NE(sink.messages[0].find("sql: INSERT INTO slow_t (id) VALUES (1)"),
+              std::string::npos);
+}
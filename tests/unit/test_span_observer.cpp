@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/span_observer.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/statement_cache.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// core::SpanObserver hooks: one span per connect / prepare / execute /
+// fetch loop / commit / rollback.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+namespace {
+
+struct RecordedSpan {
+    SpanKind kind;
+    std::string sql;
+    uint64_t fingerprint = 0;
+    std::string database;
+    uint64_t rows = 0;
+    bool failed = false;
+    bool ended = false;
+};
+
+class RecordingObserver : public SpanObserver {
+public:
+    void* startSpan(const SpanStart& start) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        spans.push_back(RecordedSpan{start.kind, std::string(start.sql), start.fingerprint,
+                                     std::string(start.database)});
+        return reinterpret_cast<void*>(spans.size());
+    }
+
+    void endSpan(void* span, const SpanEnd& end) noexcept override {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& recorded = spans.at(reinterpret_cast<size_t>(span) - 1);
+        recorded.rows = end.rows;
+        recorded.failed = end.failed;
+        recorded.ended = true;
+    }
+
+    std::vector<RecordedSpan> ofKind(SpanKind kind) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<RecordedSpan> result;
+        for (const auto& span : spans) {
+            if (span.kind == kind) result.push_back(span);
+        }
+        return result;
+    }
+
+    std::mutex mutex;
+    std::vector<RecordedSpan> spans;
+};
+
+} // namespace
+
+class SpanObserverTest : public TempDatabaseTest {
+protected:
+    void createTestSchema() override {
+        connection_->ExecuteDDL(
+            "CREATE TABLE span_t (id INTEGER NOT NULL PRIMARY KEY, name VARCHAR(20))");
+    }
+
+    void TearDown() override {
+        setSpanObserver(nullptr);
+        TempDatabaseTest::TearDown();
+    }
+
+    RecordingObserver observer_;
+};
+
+TEST_F(SpanObserverTest, ReportsStatementLifecycle) {
+    setSpanObserver(&observer_);
+
+    const std::string insertSql = "INSERT INTO span_t (id, name) VALUES (?, ?)";
+    auto tx = connection_->StartTransaction();
+    auto insert = connection_->prepareStatement(insertSql);
+    for (int32_t id = 1; id <= 3; ++id) {
+        tx->execute(insert, std::make_tuple(id, std::string("n")));
+    }
+    auto select = connection_->prepareStatement("select ID, NAME from SPAN_T");
+    {
+        auto cursor = tx->openCursor(select);
+        std::tuple<int32_t, std::optional<std::string>> row;
+        while (cursor->fetch(row)) {
+        }
+        cursor->close();
+    }
+    tx->Commit();
+
+    auto prepares = observer_.ofKind(SpanKind::Prepare);
+    ASSERT_EQ(prepares.size(), 2u);
+    EXPECT_EQ(prepares[0].sql, insertSql);
+    EXPECT_EQ(prepares[0].fingerprint, SqlKey::hashOf(insertSql, 0));
+    EXPECT_TRUE(prepares[0].ended);
+
+    auto executes = observer_.ofKind(SpanKind::Execute);
+    ASSERT_EQ(executes.size(), 3u);
+    for (const auto& span : executes) {
+        EXPECT_EQ(span.fingerprint, prepares[0].fingerprint);
+        EXPECT_EQ(span.rows, 1u);
+        EXPECT_FALSE(span.failed);
+    }
+
+    auto fetches = observer_.ofKind(SpanKind::FetchLoop);
+    ASSERT_EQ(fetches.size(), 1u);
+    EXPECT_TRUE(fetches[0].ended);
+    EXPECT_EQ(fetches[0].rows, 3u);
+    // Fingerprints ignore case and whitespace
+    EXPECT_EQ(fetches[0].fingerprint, SqlKey::hashOf("SELECT id, name FROM span_t", 0));
+
+    auto commits = observer_.ofKind(SpanKind::Commit);
+    ASSERT_EQ(commits.size(), 1u);
+    EXPECT_TRUE(commits[0].ended);
+}
+
+TEST_F(SpanObserverTest, FailedExecuteEndsSpanAsFailed) {
+    setSpanObserver(&observer_);
+
+    auto tx = connection_->StartTransaction();
+    auto insert = connection_->prepareStatement("INSERT INTO span_t (id, name) VALUES (?, ?)");
+    tx->execute(insert, std::make_tuple(int32_t{1}, std::string("a")));
+    EXPECT_THROW(tx->execute(insert, std::make_tuple(int32_t{1}, std::string("dup"))),
+                 FirebirdException);
+    tx->Rollback();
+
+    auto executes = observer_.ofKind(SpanKind::Execute);
+    ASSERT_EQ(executes.size(), 2u);
+    EXPECT_FALSE(executes[0].failed);
+    EXPECT_TRUE(executes[1].failed);
+    EXPECT_TRUE(executes[1].ended);
+    EXPECT_EQ(observer_.ofKind(SpanKind::Rollback).size(), 1u);
+}
+
+TEST_F(SpanObserverTest, ConnectSpanCarriesDatabase) {
+    setSpanObserver(&observer_);
+    {
+        Connection other(db_params_);
+    }
+    auto connects = observer_.ofKind(SpanKind::Connect);
+    ASSERT_EQ(connects.size(), 1u);
+    EXPECT_EQ(connects[0].database, db_params_.database);
+    EXPECT_TRUE(connects[0].ended);
+}
+
+TEST_F(SpanObserverTest, NoObserverNoSpans) {
+    auto tx = connection_->StartTransaction();
+    tx->execute(connection_->prepareStatement("INSERT INTO span_t (id) VALUES (1)"));
+    tx->Commit();
+    EXPECT_TRUE(observer_.spans.empty());
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include "fbpp/core/detail/sql_row_limit.hpp"
+
+#include <optional>
+#include <string>
+
+// detail::limitRowsSql — which SELECT texts get "ROWS n" appended.
+
+using fbpp::core::detail::limitRowsSql;
+
+TEST(SqlRowLimitTest, AppendsRowsToPlainSelects) {
+    EXPECT_EQ(limitRowsSql("SELECT ID FROM T", 1), "SELECT ID FROM T ROWS 1");
+    EXPECT_EQ(limitRowsSql("  select id from t where name = ? order by id  ", 10),
+              "  select id from t where name = ? order by id ROWS 10");
+    EXPECT_EQ(limitRowsSql("WITH C AS (SELECT ID FROM T) SELECT ID FROM C", 5),
+              "WITH C AS (SELECT ID FROM T) SELECT ID FROM C ROWS 5");
+    EXPECT_EQ(limitRowsSql("SELECT A FROM T UNION ALL SELECT B FROM U", 2),
+              "SELECT A FROM T UNION ALL SELECT B FROM U ROWS 2");
+}
+
+TEST(SqlRowLimitTest, DropsTrailingCommentsAndTerminator) {
+    EXPECT_EQ(limitRowsSql("SELECT ID FROM T; -- lookup", 1), "SELECT ID FROM T ROWS 1");
+    EXPECT_EQ(limitRowsSql("SELECT ID FROM T WHERE N = 'a;b' /* x */\n", 1),
+              "SELECT ID FROM T WHERE N = 'a;b' ROWS 1");
+    EXPECT_EQ(limitRowsSql("SELECT ID FROM T -- first rows\nWHERE ID > 0", 3),
+              "SELECT ID FROM T -- first rows\nWHERE ID > 0 ROWS 3");
+}
+
+TEST(SqlRowLimitTest, NestedClausesDoNotCount) {
+    EXPECT_EQ(limitRowsSql("SELECT (SELECT FIRST 1 X FROM U), SUBSTRING(N FROM 1 FOR 2) FROM T",
+                           1),
+              "SELECT (SELECT FIRST 1 X FROM U), SUBSTRING(N FROM 1 FOR 2) FROM T ROWS 1");
+    EXPECT_EQ(limitRowsSql("SELECT FIRST_NAME, \"ROWS\" FROM T", 1),
+              "SELECT FIRST_NAME, \"ROWS\" FROM T ROWS 1");
+}
+
+TEST(SqlRowLimitTest, LeavesOtherTextsAlone) {
+    EXPECT_EQ(limitRowsSql("SELECT ID FROM T", 0), std::nullopt);
+    EXPECT_EQ(limitRowsSql("SELECT FIRST 5 ID FROM T", 1), std::nullopt);
+    EXPECT_EQ(limitRowsSql("SELECT SKIP 5 ID FROM T", 1), std::nullopt);
+    EXPECT_EQ(limitRowsSql("SELECT ID FROM T ROWS 10", 1), std::nullopt);
+    EXPECT_EQ(limitRowsSql("SELECT ID FROM T OFFSET 2 ROWS", 1), std::nullopt);
+    EXPECT_EQ(limitRowsSql("SELECT ID FROM T FETCH FIRST 3 ROWS ONLY", 1), std::nullopt);
+    EXPECT_EQ(limitRowsSql("SELECT ID FROM T FOR UPDATE", 1), std::nullopt);
+    EXPECT_EQ(limitRowsSql("SELECT ID FROM T WITH LOCK", 1), std::nullopt);
+    EXPECT_EQ(limitRowsSql("UPDATE T SET N = 1 RETURNING ID", 1), std::nullopt);
+    EXPECT_EQ(limitRowsSql("EXECUTE BLOCK AS BEGIN END", 1), std::nullopt);
+    EXPECT_EQ(limitRowsSql("SELECT ID FROM T; SELECT 1 FROM U", 1), std::nullopt);
+    EXPECT_EQ(limitRowsSql("SELECT (ID FROM T", 1), std::nullopt);
+    EXPECT_EQ(limitRowsSql("-- nothing", 1), std::nullopt);
+}
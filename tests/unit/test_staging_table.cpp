@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/batch.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/staging_table.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// StagingTable — GTT creation / reuse, chunked Batch loads, set-based joins.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+TEST(ChunkEndTest, StopsAtCountOrRangeEnd) {
+    const std::vector<int> values{1, 2, 3};
+    const detail::ChunkEnd<std::vector<int>::const_iterator> end{values.end()};
+    std::size_t seen = 0;
+    for (auto it = std::counted_iterator(values.begin(), 10); it != end; ++it) {
+        ++seen;
+    }
+    EXPECT_EQ(seen, 3u);
+    seen = 0;
+    for (auto it = std::counted_iterator(values.begin(), 2); it != end; ++it) {
+        ++seen;
+    }
+    EXPECT_EQ(seen, 2u);
+}
+
+class StagingTableTest : public TempDatabaseTest {
+protected:
+    void createTestSchema() override {
+        connection_->ExecuteDDL(
+            "CREATE TABLE customer (id BIGINT NOT NULL PRIMARY KEY, name VARCHAR(20))");
+        auto tx = connection_->StartTransaction();
+        std::vector<std::tuple<int64_t, std::string>> rows;
+        for (int64_t i = 1; i <= 500; ++i) {
+            rows.emplace_back(i, "c" + std::to_string(i));
+        }
+        auto batch = connection_->prepareStatement("INSERT INTO customer VALUES (?, ?)")
+                         ->createBatch(tx.get(), false);
+        batch->addMany(rows);
+        batch->execute(tx.get());
+        tx->Commit();
+    }
+
+    static std::vector<StagingColumn> keyColumns() {
+        return {{"id", "BIGINT NOT NULL"}};
+    }
+};
+
+TEST_F(StagingTableTest, LoadsKeysForOneJoin) {
+    StagingTableOptions options;
+    options.primaryKey = {"id"};
+    options.flushBytes = 256;   // Several batches
+    StagingTable keys(*connection_, keyColumns(), options);
+    EXPECT_EQ(keys.name().rfind("FBPP_STAGE_", 0), 0u);
+    EXPECT_EQ(keys.insertSql(), "INSERT INTO " + keys.name() + " (ID) VALUES (?)");
+
+    std::vector<std::tuple<int64_t>> ids;
+    for (int64_t i = 2; i <= 1000; i += 2) {
+        ids.emplace_back(i);
+    }
+    auto tx = connection_->StartTransaction();
+    EXPECT_EQ(keys.load(*tx, ids), ids.size());
+
+    auto cur = tx->openCursor(connection_->prepareStatement(
+        "SELECT COUNT(*), MIN(c.id), MAX(c.id) FROM customer c JOIN " + keys.name() +
+        " k ON k.id = c.id"));
+    std::tuple<int64_t, int64_t, int64_t> row;
+    ASSERT_TRUE(cur->fetch(row));
+    cur->close();
+    EXPECT_EQ(row, std::make_tuple(int64_t{250}, int64_t{2}, int64_t{500}));
+
+    keys.clear(*tx);
+    auto left = tx->openCursor(connection_->prepareStatement("SELECT COUNT(*) FROM " + keys.name()));
+    std::tuple<int64_t> count;
+    ASSERT_TRUE(left->fetch(count));
+    left->close();
+    EXPECT_EQ(std::get<0>(count), 0);
+    tx->Commit();
+}
+
+TEST_F(StagingTableTest, SameDefinitionReusesTheTable) {
+    StagingTable first(*connection_, keyColumns());
+    StagingTable second(*connection_, keyColumns());
+    StagingTable other(*connection_, {{"id", "INTEGER NOT NULL"}});
+    EXPECT_EQ(first.name(), second.name());
+    EXPECT_NE(first.name(), other.name());
+
+    // Rows do not outlive the loading transaction
+    auto tx = connection_->StartTransaction();
+    first.load(*tx, std::vector<std::tuple<int64_t>>{{1}, {2}});
+    tx->Commit();
+    auto check = connection_->StartTransaction();
+    auto cur = check->openCursor(connection_->prepareStatement("SELECT COUNT(*) FROM " + first.name()));
+    std::tuple<int64_t> count;
+    ASSERT_TRUE(cur->fetch(count));
+    cur->close();
+    EXPECT_EQ(std::get<0>(count), 0);
+    check->Commit();
+}
+
+TEST_F(StagingTableTest, RejectedRowThrows) {
+    StagingTableOptions options;
+    options.primaryKey = {"id"};
+    StagingTable keys(*connection_, keyColumns(), options);
+    auto tx = connection_->StartTransaction();
+    EXPECT_THROW(keys.load(*tx, std::vector<std::tuple<int64_t>>{{7}, {7}}), FirebirdException);
+    tx->Rollback();
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/environment.hpp"
+#include "fbpp/core/startup_profile.hpp"
+#include "fbpp/core/statement.hpp"
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Startup profile — the first master init, provider load, attach and prepare.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+class StartupProfileTest : public TempDatabaseTest {};
+
+TEST_F(StartupProfileTest, RecordsEachPhaseInOrder) {
+    connection_->prepareStatement("SELECT 1 FROM RDB$DATABASE");
+
+    const auto profile = startupProfile();
+    const StartupPhase phases[] = {StartupPhase::MasterInit, StartupPhase::ProviderLoad,
+                                   StartupPhase::FirstAttach, StartupPhase::FirstPrepare};
+    std::chrono::microseconds previous{0};
+    for (auto phase : phases) {
+        const auto& timing = profile[phase];
+        ASSERT_TRUE(timing.reached) << startupPhaseName(phase);
+        EXPECT_GE(timing.at, timing.took) << startupPhaseName(phase);
+        EXPECT_GE(timing.at, previous) << startupPhaseName(phase);
+        previous = timing.at;
+    }
+    // Attaching is a round trip: never free
+    EXPECT_GT(profile.firstAttach.took.count(), 0);
+}
+
+TEST_F(StartupProfileTest, LaterAttachAndPrepareDoNotChangeIt) {
+    connection_->prepareStatement("SELECT 1 FROM RDB$DATABASE");
+    const auto before = startupProfile();
+
+    Connection second(db_params_);
+    second.prepareStatement("SELECT 2 FROM RDB$DATABASE");
+    Environment::getInstance().getProvider();
+
+    const auto after = startupProfile();
+    EXPECT_EQ(after.masterInit.at, before.masterInit.at);
+    EXPECT_EQ(after.providerLoad.at, before.providerLoad.at);
+    EXPECT_EQ(after.firstAttach.took, before.firstAttach.took);
+    EXPECT_EQ(after.firstAttach.at, before.firstAttach.at);
+    EXPECT_EQ(after.firstPrepare.at, before.firstPrepare.at);
+}
+
+TEST_F(StartupProfileTest, DescribeHasOneLinePerPhase) {
+    connection_->prepareStatement("SELECT 1 FROM RDB$DATABASE");
+
+    std::istringstream text(startupProfile().describe());
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(text, line);) {
+        lines.push_back(line);
+    }
+    ASSERT_EQ(lines.size(), 4u);
+    EXPECT_EQ(lines[0].rfind("master init ", 0), 0u);
+    EXPECT_EQ(lines[1].rfind("provider load ", 0), 0u);
+    EXPECT_EQ(lines[2].rfind("first attach ", 0), 0u);
+    EXPECT_EQ(lines[3].rfind("first prepare ", 0), 0u);
+    for (const auto& line : lines) {
+        EXPECT_NE(line.find(" ms (at "), std::string::npos) << line;
+    }
+
+    StartupProfile empty;
+    EXPECT_EQ(empty.describe(),
+              "master init not reached\nprovider load not reached\n"
+              "first attach not reached\nfirst prepare not reached");
+}
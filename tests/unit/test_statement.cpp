@@ -286,6 +286,44 @@ TEST_F(StatementTest, GetMetadata) {
     // May be null or have 0 fields for non-SELECT statements
 }
 
+TEST_F(StatementTest, MetadataIsCachedAndShared) {
+    auto stmt = connection_->prepareStatement(
+        "SELECT id, name FROM statement_test WHERE id > ?"
+    );
+
+    auto in1 = stmt->getInputMetadata();
+    auto in2 = stmt->getInputMetadata();
+    ASSERT_NE(in1, nullptr);
+    EXPECT_EQ(in1.get(), in2.get());
+
+    auto out = stmt->getOutputMetadata();
+    ASSERT_NE(out, nullptr);
+    EXPECT_EQ(out.get(), stmt->getOutputMetadata().get());
+
+    // Binders and cursors reuse the statement's instances.
+    {
+        ParamBinder binder(stmt);
+        EXPECT_EQ(binder.metadata(), in1.get());
+    }
+
+    auto tx = connection_->StartTransaction();
+    auto rs = tx->openCursor(stmt, std::make_tuple(0));
+    EXPECT_EQ(rs->getMetadata(), out.get());
+    rs->close();
+    rs.reset();
+
+    // Back in the cache, the instance is handed out again with its metadata.
+    const Statement* const raw = stmt.get();
+    stmt.reset();
+    auto again = connection_->prepareStatement(
+        "SELECT id, name FROM statement_test WHERE id > ?"
+    );
+    ASSERT_EQ(again.get(), raw);
+    EXPECT_EQ(again->getInputMetadata().get(), in1.get());
+    EXPECT_EQ(again->getOutputMetadata().get(), out.get());
+    tx->Commit();
+}
+
 TEST_F(StatementTest, GetStatementType) {
     // SELECT statement
     auto selectStmt = connection_->prepareStatement(
@@ -404,3 +442,36 @@ TEST_F(StatementTest, ErrorHandling) {
     }, FirebirdException);
     tra->Rollback();
 }
+
+TEST_F(StatementTest, SelectOneRunsAsSingleton) {
+    auto tra = connection_->StartTransaction();
+    auto insert = connection_->prepareStatement(
+        "INSERT INTO statement_test (id, name, amount) VALUES (?, ?, ?)");
+    tra->execute(insert, std::make_tuple(1, std::string("one"), 1.5));
+    tra->execute(insert, std::make_tuple(2, std::string("two"), 2.5));
+
+    using Row = std::tuple<std::string, double>;
+    auto byId = connection_->prepareStatement(
+        "SELECT name, amount FROM statement_test WHERE id = ?");
+    auto row = byId->selectOne<Row>(tra.get(), std::make_tuple(2));
+    ASSERT_TRUE(row.has_value());
+    EXPECT_EQ(std::get<0>(*row), "two");
+    EXPECT_DOUBLE_EQ(std::get<1>(*row), 2.5);
+
+    // No row is not an error; the statement stays usable
+    EXPECT_FALSE(byId->selectOne<Row>(tra.get(), std::make_tuple(3)).has_value());
+    auto again = byId->selectOne<nlohmann::json>(tra.get(), std::make_tuple(1));
+    ASSERT_TRUE(again.has_value());
+    EXPECT_EQ((*again)["NAME"], "one");
+
+    auto count = connection_->prepareStatement("SELECT COUNT(*) FROM statement_test");
+    EXPECT_EQ(std::get<0>(*count->selectOne<std::tuple<int64_t>>(tra.get())), 2);
+
+    // More than one row is the server's singleton error
+    auto all = connection_->prepareStatement("SELECT id FROM statement_test");
+    EXPECT_THROW(all->selectOne<std::tuple<int32_t>>(tra.get()), FirebirdException);
+    EXPECT_THROW(insert->selectOne<std::tuple<int32_t>>(tra.get(),
+                                                        std::make_tuple(3, std::string("x"), 0.0)),
+                 FirebirdException);
+    tra->Rollback();
+}
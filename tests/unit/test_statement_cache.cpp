@@ -1,10 +1,18 @@
 #include <gtest/gtest.h>
 #include "../test_base.hpp"
 #include "fbpp/core/statement_cache.hpp"
+#include "fbpp/core/statement_template.hpp"
+#include "fbpp/core/message_metadata.hpp"
 #include "fbpp/core/connection.hpp"
+#include "fbpp/core/param_binder.hpp"
 #include "fbpp/core/statement.hpp"
 #include "fbpp/core/transaction.hpp"
+#include <filesystem>
 #include <thread>
+#include <latch>
+#include <vector>
+#include <tuple>
+#include <optional>
 #include <chrono>
 
 using namespace fbpp::core;
@@ -40,6 +48,9 @@ TEST_F(StatementCacheTest, BasicCacheOperations) {
     EXPECT_EQ(stats.cacheSize, 0);
     EXPECT_EQ(stats.hitCount, 0);
     EXPECT_EQ(stats.missCount, 0);
+    EXPECT_EQ(stats.lockContentionCount, 0);
+    EXPECT_EQ(stats.singleFlightWaitCount, 0);
+    EXPECT_EQ(stats.concurrentPrepareCount, 0);
 }
 
 // Test cache hit and miss
@@ -116,6 +127,295 @@ TEST_F(StatementCacheTest, LRUEviction) {
     EXPECT_EQ(stats.evictionCount, 2);  // Another eviction occurred
 }
 
+// SqlKey: streaming hash over the normalized token stream
+TEST(SqlKeyTest, NormalizationIgnoresCaseWhitespaceAndComments) {
+    const SqlKey a("select *  from test_cache\n where id = 1", 0);
+    const SqlKey b("  SELECT * /* note */ FROM test_cache WHERE id = 1 -- tail", 0);
+    EXPECT_EQ(a.hash(), b.hash());
+    EXPECT_TRUE(SqlKey::equivalent(a.sql(), b.sql()));
+
+    // Literals keep case and spacing; flags are part of the key.
+    EXPECT_NE(SqlKey::hashOf("SELECT 'a  b' FROM rdb$database", 0),
+              SqlKey::hashOf("SELECT 'A b' FROM rdb$database", 0));
+    EXPECT_FALSE(SqlKey::equivalent("SELECT 'x'", "SELECT 'X'"));
+    EXPECT_NE(SqlKey::hashOf(a.sql(), 0), SqlKey::hashOf(a.sql(), 1));
+}
+
+TEST_F(StatementCacheTest, SqlKeyHandleHitsSameEntry) {
+    StatementCache::CacheConfig config;
+    config.maxSize = 5;
+    config.enabled = true;
+
+    StatementCache cache(config);
+
+    const SqlKey key("SELECT * FROM test_cache WHERE id = ?");
+    cache.get(connection_.get(), key);
+    cache.get(connection_.get(), key);
+    cache.get(connection_.get(), "select *\n  from TEST_CACHE where ID = ?", 0);
+
+    auto stats = cache.getStatistics();
+    EXPECT_EQ(stats.cacheSize, 1);
+    EXPECT_EQ(stats.missCount, 1);
+    EXPECT_EQ(stats.hitCount, 2);
+
+    EXPECT_TRUE(cache.remove("SELECT * FROM test_cache WHERE id = ?", 0));
+    EXPECT_EQ(cache.getStatistics().cacheSize, 0);
+}
+
+// Test that pooled instances keep their binder across checkouts
+TEST_F(StatementCacheTest, PooledBinderSurvivesCheckout) {
+    StatementCache cache;
+    const std::string sql = "INSERT INTO test_cache (id, name) VALUES (:id, :name)";
+    auto tx = connection_->StartTransaction();
+
+    const ParamBinder* firstBinder = nullptr;
+    {
+        auto stmt = cache.get(connection_.get(), sql, 0);
+        ParamBinder& b = stmt->binder(tx.get());
+        firstBinder = &b;
+        b.set("id", int32_t{1});
+        b.set("name", std::string("first"));
+        EXPECT_EQ(tx->execute(stmt, b), 1u);
+    }
+    {
+        auto stmt = cache.get(connection_.get(), sql, 0);   // Same pooled instance
+        ParamBinder& b = stmt->binder(tx.get());
+        EXPECT_EQ(&b, firstBinder);
+        EXPECT_EQ(b.transaction(), tx.get());
+        b.set("id", int32_t{2});                          // :name cleared to NULL
+        EXPECT_EQ(tx->execute(stmt, b), 1u);
+    }
+    EXPECT_EQ(cache.getStatistics().hitCount, 1u);
+
+    auto sel = connection_->prepareStatement("SELECT name FROM test_cache WHERE id = 2");
+    auto cur = tx->openCursor(sel);
+    std::tuple<std::optional<std::string>> row;
+    ASSERT_TRUE(cur->fetch(row));
+    EXPECT_FALSE(std::get<0>(row).has_value());
+    cur->close();
+    tx->Commit();
+}
+
+// Leases check out the same pooled instances as get(), without a shared_ptr
+TEST_F(StatementCacheTest, LeaseReturnsInstanceToPool) {
+    StatementCache cache;
+    const SqlKey key("INSERT INTO test_cache (id, name) VALUES (?, ?)");
+    auto tx = connection_->StartTransaction();
+
+    Statement* first = nullptr;
+    {
+        StatementLease lease = cache.lease(connection_.get(), key);
+        ASSERT_TRUE(lease);
+        first = lease.get();
+        EXPECT_EQ(cache.getStatistics().idleCount, 0u);
+        EXPECT_EQ(tx->execute(lease.statement(), std::make_tuple(1, std::string("a"))), 1u);
+    }
+    EXPECT_EQ(cache.getStatistics().idleCount, 1u);
+
+    StatementLease moved;
+    {
+        StatementLease lease = cache.lease(connection_.get(), key);
+        EXPECT_EQ(lease.get(), first);
+        moved = std::move(lease);
+    }
+    EXPECT_EQ(cache.getStatistics().idleCount, 0u);   // Still held by `moved`
+    moved.reset();
+    EXPECT_FALSE(moved);
+    EXPECT_EQ(cache.getStatistics().idleCount, 1u);
+
+    // Both handle kinds share the pool
+    EXPECT_EQ(cache.get(connection_.get(), key).get(), first);
+    EXPECT_TRUE(connection_->leaseStatement(key));   // The connection's own cache
+    auto stats = cache.getStatistics();
+    EXPECT_EQ(stats.missCount, 1u);
+    EXPECT_EQ(stats.hitCount, 2u);
+
+    // A lease may outlive its cache
+    auto orphan = std::make_unique<StatementCache>();
+    StatementLease late = orphan->lease(connection_.get(), key);
+    orphan.reset();
+    EXPECT_EQ(tx->execute(late.statement(), std::make_tuple(2, std::string("b"))), 1u);
+    late.reset();
+    tx->Commit();
+}
+
+// Test that caches of two connections share one statement template
+TEST_F(StatementCacheTest, SharedTemplatesAcrossConnections) {
+    StatementCache::CacheConfig config;
+    config.sharedTemplates = true;
+
+    auto& registry = StatementTemplateRegistry::instance();
+    registry.clear();
+    const auto before = registry.getStatistics();
+
+    Connection other(db_params_);
+    StatementCache cacheA(config);
+    StatementCache cacheB(config);
+
+    const std::string sql = "SELECT id, name FROM test_cache WHERE id = :id";
+    auto a = cacheA.get(connection_.get(), sql);
+    auto b = cacheB.get(&other, sql);
+
+    auto stats = registry.getStatistics();
+    EXPECT_EQ(stats.missCount - before.missCount, 1);
+    EXPECT_EQ(stats.hitCount - before.hitCount, 1);
+    EXPECT_EQ(stats.layoutReuseCount - before.layoutReuseCount, 1);
+    EXPECT_EQ(stats.templateCount, 1);
+
+    // Same decoded layout, distinct IStatement handles
+    EXPECT_NE(a->getRawStatement(), b->getRawStatement());
+    EXPECT_EQ(a->getOutputMetadata()->getLayout(), b->getOutputMetadata()->getLayout());
+    EXPECT_EQ(a->getInputMetadata()->getLayout(), b->getInputMetadata()->getLayout());
+    EXPECT_TRUE(b->hasNamedParameters());
+    EXPECT_EQ(b->getNamedParamMapping().count("id"), 1);
+
+    // DDL through either connection unregisters the scope's templates
+    a.reset();
+    b.reset();
+    connection_->ExecuteDDL("CREATE TABLE test_cache_ddl (id INTEGER)");
+    EXPECT_EQ(registry.getStatistics().templateCount, 0);
+
+    StatementCache cacheC(config);
+    cacheC.get(&other, sql);
+    EXPECT_EQ(registry.getStatistics().missCount - before.missCount, 2);
+}
+
+// DDL on one connection empties the caches of the others on their next
+// prepare and warms their hot keys again in the background
+TEST_F(StatementCacheTest, SchemaChangeInvalidatesOtherConnections) {
+    auto& registry = StatementTemplateRegistry::instance();
+    const std::string scope = connection_->getTemplateScope();
+
+    Connection other(db_params_);
+    ConnectionParams staticParams = db_params_;
+    staticParams.options.statementCache.followSchemaChanges = false;
+    Connection unaware(staticParams);
+    for (int i = 0; i < 3; ++i) {
+        other.prepareStatement("SELECT id FROM test_cache WHERE id = ?");
+    }
+    other.prepareStatement("SELECT name FROM test_cache WHERE id = ?");
+    unaware.prepareStatement("SELECT id FROM test_cache WHERE id = ?");
+    ASSERT_EQ(other.getCacheStatistics().cacheSize, 2);
+
+    const uint64_t epoch = registry.schemaEpoch(scope);
+    connection_->ExecuteDDL("ALTER TABLE test_cache ADD extra INTEGER");
+    EXPECT_EQ(registry.schemaEpoch(scope), epoch + 1);
+
+    auto stmt = other.prepareStatement("SELECT name FROM test_cache WHERE id = ?");
+    other.waitForWarmup();
+    const auto stats = other.getCacheStatistics();
+    EXPECT_EQ(stats.cacheSize, 2);
+    EXPECT_EQ(stats.warmupCount, 2);
+
+    auto tx = other.StartTransaction();
+    auto cursor = tx->openCursor(other.prepareStatement("SELECT extra FROM test_cache"));
+    std::tuple<std::optional<int32_t>> row;
+    EXPECT_FALSE(cursor->fetch(row));
+    cursor->close();
+    tx->Commit();
+
+    // Opted out: the cache is left as it was
+    unaware.prepareStatement("SELECT id FROM test_cache WHERE id = ?");
+    EXPECT_EQ(unaware.getCacheStatistics().cacheSize, 1);
+    EXPECT_EQ(unaware.getCacheStatistics().hitCount, 1);
+
+    EXPECT_FALSE(Connection::isMetadataChanged(FirebirdException("no status vector")));
+}
+
+// Test hot-set export and warm-up of a new connection
+TEST_F(StatementCacheTest, HotSetExportAndWarmUp) {
+    const auto path = (std::filesystem::temp_directory_path() /
+                       ("fbpp_hotset_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) +
+                        ".json")).string();
+
+    StatementCache cache;
+    for (int i = 0; i < 3; ++i) {
+        cache.get(connection_.get(), "SELECT id FROM test_cache WHERE id = ?");
+    }
+    cache.get(connection_.get(), "SELECT name FROM test_cache WHERE id = ?");
+    cache.saveHotSet(path);
+
+    auto hot = StatementCache::loadHotSet(path);
+    ASSERT_EQ(hot.size(), 2);
+    EXPECT_EQ(hot[0].sql, "SELECT id FROM test_cache WHERE id = ?");
+    EXPECT_EQ(hot[0].useCount, 3);
+    EXPECT_EQ(hot[1].useCount, 1);
+
+    // Synchronous warm-up of the top entry only
+    ConnectionParams params = db_params_;
+    params.options.statementCache.warmupFile = path;
+    params.options.statementCache.warmupTopN = 1;
+    params.options.statementCache.warmupInBackground = false;
+    {
+        Connection warmed(params);
+        auto stats = warmed.getCacheStatistics();
+        EXPECT_EQ(stats.cacheSize, 1);
+        EXPECT_EQ(stats.warmupCount, 1);
+
+        warmed.prepareStatement("SELECT id FROM test_cache WHERE id = ?");
+        EXPECT_EQ(warmed.getCacheStatistics().hitCount, 1);
+    }
+
+    // Background warm-up, awaited before use
+    params.options.statementCache.warmupTopN = 10;
+    params.options.statementCache.warmupInBackground = true;
+    {
+        Connection warmed(params);
+        warmed.waitForWarmup();
+        EXPECT_EQ(warmed.getCacheStatistics().warmupCount, 2);
+    }
+
+    std::filesystem::remove(path);
+    EXPECT_THROW(StatementCache::loadHotSet(path), FirebirdException);
+}
+
+// Test that a scan of one-off statements does not flush the hot set
+TEST_F(StatementCacheTest, CostAwarePolicyResistsScans) {
+    auto runWorkload = [&](StatementCachePolicy policy) {
+        StatementCache::CacheConfig config;
+        config.maxSize = 3;
+        config.policy = policy;
+        StatementCache cache(config);
+
+        const std::vector<std::string> hot = {
+            "SELECT a.id, b.name FROM test_cache a JOIN test_cache b ON b.id = a.id WHERE a.id = ?",
+            "SELECT COUNT(*) FROM test_cache a LEFT JOIN test_cache b ON b.id > a.id"
+        };
+        for (int round = 0; round < 10; ++round) {
+            for (const auto& sql : hot) {
+                cache.get(connection_.get(), sql);
+            }
+        }
+        for (int i = 0; i < 20; ++i) {
+            cache.get(connection_.get(), "SELECT id FROM test_cache WHERE id = " + std::to_string(i));
+        }
+
+        const size_t hitsBefore = cache.getStatistics().hitCount;
+        for (const auto& sql : hot) {
+            cache.get(connection_.get(), sql);
+        }
+        auto stats = cache.getStatistics();
+        EXPECT_EQ(stats.policy, policy);
+        EXPECT_LE(stats.cacheSize, 3);
+        return std::make_pair(stats.hitCount - hitsBefore, stats);
+    };
+
+    auto [lruHits, lruStats] = runWorkload(StatementCachePolicy::Lru);
+    EXPECT_EQ(lruHits, 0);
+    EXPECT_EQ(lruStats.admissionRejectCount, 0);
+
+    auto [lfuHits, lfuStats] = runWorkload(StatementCachePolicy::CostAwareLfu);
+    EXPECT_EQ(lfuHits, 2);
+    EXPECT_GT(lfuStats.admissionRejectCount, 0);
+    EXPECT_GT(lfuStats.prepareMicrosSaved, 0);
+
+    ASSERT_EQ(lfuStats.byPolicy.size(), 2);
+    const auto& lfu = lfuStats.byPolicy[1];
+    EXPECT_EQ(lfu.policy, StatementCachePolicy::CostAwareLfu);
+    EXPECT_EQ(lfu.hitCount, lfuStats.hitCount);
+    EXPECT_EQ(lfuStats.byPolicy[0].hitCount + lfuStats.byPolicy[0].missCount, 0);
+}
+
 // Test cache with different flags
 TEST_F(StatementCacheTest, CacheWithDifferentFlags) {
     StatementCache::CacheConfig config;
@@ -325,6 +625,130 @@ TEST_F(StatementCacheTest, ThreadSafety) {
     EXPECT_EQ(stats.missCount, numThreads * opsPerThread);  // All should be misses
 }
 
+// Concurrent misses on one key: a single prepare creates the entry, the rest
+// proceed as hits (each still gets its own exclusive instance).
+TEST_F(StatementCacheTest, ConcurrentMissesAreSingleFlighted) {
+    StatementCache::CacheConfig config;
+    config.maxSize = 10;
+    config.enabled = true;
+
+    StatementCache cache(config);
+
+    const int numThreads = 8;
+    const std::string sql = "SELECT * FROM test_cache WHERE id = ?";
+    std::latch start(numThreads);
+    std::latch acquired(numThreads);
+    std::vector<std::shared_ptr<Statement>> held(numThreads);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            start.arrive_and_wait();
+            held[t] = cache.get(connection_.get(), sql, 0);
+            acquired.arrive_and_wait();   // keep every instance checked out
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (int t = 0; t < numThreads; ++t) {
+        ASSERT_NE(held[t], nullptr);
+        for (int u = t + 1; u < numThreads; ++u) {
+            EXPECT_NE(held[t].get(), held[u].get());
+        }
+    }
+
+    auto stats = cache.getStatistics();
+    EXPECT_EQ(stats.cacheSize, 1);
+    EXPECT_EQ(stats.missCount, 1);
+    EXPECT_EQ(stats.hitCount, numThreads - 1);
+    EXPECT_EQ(stats.concurrentPrepareCount, numThreads - 1);
+    EXPECT_LE(stats.singleFlightWaitCount, static_cast<size_t>(numThreads - 1));
+}
+
+// Idle pools follow the key's peak of concurrent checkouts, past the old
+// fixed cap of 8, and a sequentially used key keeps a single instance.
+TEST_F(StatementCacheTest, IdlePoolFollowsCheckoutPeak) {
+    StatementCache::CacheConfig config;
+    config.maxSize = 10;
+    StatementCache cache(config);
+
+    const std::string hot = "SELECT * FROM test_cache WHERE id = ?";
+    const std::string cold = "SELECT name FROM test_cache WHERE id = ?";
+    for (int i = 0; i < 5; ++i) {
+        cache.get(connection_.get(), cold, 0);
+    }
+    EXPECT_EQ(cache.getStatistics().idleCount, 1u);
+
+    std::vector<std::shared_ptr<Statement>> held;
+    for (int i = 0; i < 12; ++i) {
+        held.push_back(cache.get(connection_.get(), hot, 0));
+    }
+    held.clear();
+    auto stats = cache.getStatistics();
+    EXPECT_EQ(stats.idleCount, 13u);
+    EXPECT_EQ(stats.idleDropCount, 0u);
+
+    // The pooled instances serve the same concurrency without prepares
+    const size_t prepared = stats.concurrentPrepareCount;
+    for (int i = 0; i < 12; ++i) {
+        held.push_back(cache.get(connection_.get(), hot, 0));
+    }
+    EXPECT_EQ(cache.getStatistics().concurrentPrepareCount, prepared);
+}
+
+// The cache-wide budget caps pooling beyond each key's first instance.
+TEST_F(StatementCacheTest, IdleBudgetCapsPools) {
+    StatementCache::CacheConfig config;
+    config.maxSize = 10;
+    config.maxIdleStatements = 3;
+    StatementCache cache(config);
+
+    const std::string sql = "SELECT * FROM test_cache WHERE id = ?";
+    std::vector<std::shared_ptr<Statement>> held;
+    for (int i = 0; i < 6; ++i) {
+        held.push_back(cache.get(connection_.get(), sql, 0));
+    }
+    held.clear();
+    auto stats = cache.getStatistics();
+    EXPECT_EQ(stats.idleCount, 3u);
+    EXPECT_EQ(stats.idleDropCount, 3u);
+
+    // A new key still pools its first instance over the budget
+    cache.get(connection_.get(), "SELECT name FROM test_cache WHERE id = ?", 0);
+    EXPECT_EQ(cache.getStatistics().idleCount, 4u);
+
+    cache.clear();
+    EXPECT_EQ(cache.getStatistics().idleCount, 0u);
+}
+
+// A hit refreshes the entry, so eviction picks the next-oldest key.
+TEST_F(StatementCacheTest, HitRefreshesLruOrder) {
+    StatementCache::CacheConfig config;
+    config.maxSize = 2;
+    config.enabled = true;
+
+    StatementCache cache(config);
+
+    const std::string sqlA = "SELECT * FROM test_cache WHERE id = 1";
+    const std::string sqlB = "SELECT * FROM test_cache WHERE id = 2";
+    const std::string sqlC = "SELECT * FROM test_cache WHERE id = 3";
+
+    cache.get(connection_.get(), sqlA, 0);
+    cache.get(connection_.get(), sqlB, 0);
+    cache.get(connection_.get(), sqlA, 0);   // A is now most recent
+    cache.get(connection_.get(), sqlC, 0);   // evicts B
+
+    EXPECT_TRUE(cache.remove(sqlA, 0));
+    EXPECT_FALSE(cache.remove(sqlB, 0));
+    EXPECT_TRUE(cache.remove(sqlC, 0));
+
+    auto stats = cache.getStatistics();
+    EXPECT_EQ(stats.evictionCount, 1);
+    EXPECT_EQ(stats.cacheSize, 0);
+}
+
 // Test cache size adjustment
 TEST_F(StatementCacheTest, CacheSizeAdjustment) {
     StatementCache::CacheConfig config;
@@ -383,3 +807,108 @@ TEST_F(StatementCacheTest, HitRateCalculation) {
     EXPECT_EQ(stats.hitCount, 3);
     EXPECT_DOUBLE_EQ(stats.hitRate, 75.0);  // 3 hits out of 4 total = 75%
 }
+
+// Test per-statement metrics: rows, bytes and latencies per cached key
+TEST_F(StatementCacheTest, CollectsPerStatementMetrics) {
+    StatementCache::CacheConfig config;
+    config.collectMetrics = true;
+    StatementCache cache(config);
+
+    const std::string insertSql = "INSERT INTO test_cache (id, name) VALUES (?, ?)";
+    const std::string selectSql = "SELECT id, name FROM test_cache ORDER BY id";
+    auto tx = connection_->StartTransaction();
+    for (int32_t id = 1; id <= 3; ++id) {
+        auto stmt = cache.get(connection_.get(), insertSql, 0);
+        EXPECT_EQ(tx->execute(stmt, std::make_tuple(id, std::string("row"))), 1u);
+    }
+    {
+        auto stmt = cache.get(connection_.get(), selectSql, 0);
+        auto cur = tx->openCursor(stmt);
+        std::tuple<int32_t, std::optional<std::string>> row;
+        int fetched = 0;
+        while (cur->fetch(row)) {
+            ++fetched;
+        }
+        EXPECT_EQ(fetched, 3);
+        cur->close();
+    }
+    tx->Commit();
+
+    auto metrics = cache.getMetrics();
+    ASSERT_EQ(metrics.size(), 2u);
+    auto find = [&](const std::string& sql) {
+        for (const auto& m : metrics) {
+            if (m.sql == sql) return m;
+        }
+        ADD_FAILURE() << "no metrics for " << sql;
+        return StatementMetricsSnapshot{};
+    };
+
+    const auto insert = find(insertSql);
+    EXPECT_EQ(insert.useCount, 3u);
+    EXPECT_EQ(insert.prepare.count, 1u);
+    EXPECT_EQ(insert.execute.count, 3u);
+    EXPECT_EQ(insert.rowsAffected, 3u);
+    EXPECT_GT(insert.messageBytesIn, 0u);
+    EXPECT_EQ(insert.openCursor.count, 0u);
+
+    const auto select = find(selectSql);
+    EXPECT_EQ(select.openCursor.count, 1u);
+    EXPECT_EQ(select.rowsFetched, 3u);
+    EXPECT_GE(select.fetch.count, 1u);
+    EXPECT_GT(select.messageBytesOut, 0u);
+    EXPECT_GE(select.execute.maxMicros, select.execute.p50Micros);
+
+    cache.resetMetrics();
+    EXPECT_EQ(cache.getMetrics(1).front().execute.count, 0u);
+
+    // Off: keys prepared afterwards carry no metrics
+    cache.setCollectMetrics(false);
+    cache.get(connection_.get(), "SELECT name FROM test_cache WHERE id = ?", 0);
+    EXPECT_EQ(cache.getMetrics().size(), 2u);
+}
+
+TEST_F(StatementCacheTest, CapturesServerCounters) {
+    StatementCache::CacheConfig config;
+    config.collectMetrics = true;
+    config.captureServerCounters = true;
+    StatementCache cache(config);
+
+    const std::string insertSql = "INSERT INTO test_cache (id, name) VALUES (?, ?)";
+    const std::string selectSql = "SELECT id, name FROM test_cache";
+    auto tx = connection_->StartTransaction();
+    for (int32_t id = 1; id <= 3; ++id) {
+        auto stmt = cache.get(connection_.get(), insertSql, 0);
+        tx->execute(stmt, std::make_tuple(id, std::string("row")));
+    }
+    {
+        auto stmt = cache.get(connection_.get(), selectSql, 0);
+        auto cur = tx->openCursor(stmt);
+        std::tuple<int32_t, std::optional<std::string>> row;
+        while (cur->fetch(row)) {
+        }
+        cur->close();
+    }
+    tx->Commit();
+
+    for (const auto& m : cache.getMetrics()) {
+        const auto records = m.server.totals();
+        if (m.sql == insertSql) {
+            EXPECT_EQ(m.serverSamples, 3u);
+            EXPECT_EQ(records.inserts, 3u);
+        } else {
+            EXPECT_EQ(m.serverSamples, 1u);
+            EXPECT_EQ(records.seqReads, 3u);   // Full scan of test_cache
+            EXPECT_EQ(records.inserts, 0u);
+        }
+        EXPECT_GT(m.server.fetches, 0u);
+    }
+
+    // Counters are also readable directly
+    const auto before = connection_->getServerCounters();
+    auto tx2 = connection_->StartTransaction();
+    tx2->execute(connection_->prepareStatement("DELETE FROM test_cache WHERE id = 1"));
+    tx2->Commit();
+    const auto delta = ServerCounters::delta(connection_->getServerCounters(), before);
+    EXPECT_EQ(delta.totals().deletes, 1u);
+}
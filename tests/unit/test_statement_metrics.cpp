@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include "fbpp/core/statement_metrics.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace fbpp::core;
+
+TEST(LatencyHistogramTest, BucketsAreExactBelowEightAndLogLinearAbove) {
+    for (uint64_t v = 0; v < 16; ++v) {
+        EXPECT_EQ(LatencyHistogram::bucketUpperBound(LatencyHistogram::bucketOf(v)), v);
+    }
+    // 1000 us lies in [960, 1023]: 8 sub-buckets per power of two
+    EXPECT_EQ(LatencyHistogram::bucketUpperBound(LatencyHistogram::bucketOf(1000)), 1023u);
+    EXPECT_EQ(LatencyHistogram::bucketOf(960), LatencyHistogram::bucketOf(1023));
+    EXPECT_NE(LatencyHistogram::bucketOf(959), LatencyHistogram::bucketOf(960));
+
+    // Every value lies within its bucket, at most 1/8 below the bound
+    for (uint64_t v : {17ull, 100ull, 12345ull, 987654321ull}) {
+        const uint64_t upper = LatencyHistogram::bucketUpperBound(LatencyHistogram::bucketOf(v));
+        EXPECT_GE(upper, v);
+        EXPECT_LE(upper - v, v / 8);
+    }
+    EXPECT_EQ(LatencyHistogram::bucketOf(~uint64_t{0}), LatencyHistogram::kBucketCount - 1);
+}
+
+TEST(LatencyHistogramTest, PercentilesAndSnapshot) {
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.percentile(0.5), 0u);
+
+    for (uint64_t v = 1; v <= 100; ++v) {
+        histogram.record(v);
+    }
+    histogram.record(std::chrono::milliseconds(50));
+
+    const auto snap = histogram.snapshot();
+    EXPECT_EQ(snap.count, 101u);
+    EXPECT_EQ(snap.totalMicros, 5050u + 50000u);
+    EXPECT_EQ(snap.maxMicros, 50000u);
+    EXPECT_GE(snap.p50Micros, 51u);
+    EXPECT_LE(snap.p50Micros, 55u);
+    EXPECT_GE(snap.p99Micros, 99u);
+    EXPECT_LE(snap.p99Micros, 103u);
+    EXPECT_EQ(snap.p999Micros, 50000u);   // Capped at the largest value seen
+    EXPECT_EQ(histogram.percentile(1.0), 50000u);
+
+    histogram.reset();
+    EXPECT_EQ(histogram.count(), 0u);
+    EXPECT_EQ(histogram.snapshot().maxMicros, 0u);
+}
+
+TEST(LatencyHistogramTest, ConcurrentRecordsAreCounted) {
+    LatencyHistogram histogram;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&histogram, t] {
+            for (uint64_t i = 0; i < 10000; ++i) {
+                histogram.record(i % 500 + static_cast<uint64_t>(t));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(histogram.count(), 40000u);
+    EXPECT_EQ(histogram.snapshot().maxMicros, 502u);
+}
+
+TEST(StatementMetricsTest, CountersAndBlobAttribution) {
+    auto metrics = std::make_shared<StatementMetrics>();
+    metrics->recordExecute(std::chrono::microseconds(120), 64, 16, 2);
+    metrics->recordOpenCursor(std::chrono::microseconds(80), 64);
+    metrics->recordFetch(std::chrono::microseconds(30), 10, 400);
+
+    detail::BlobMetricsScope::noteBytes(100);   // No target: dropped
+    detail::BlobMetricsScope::set(metrics);
+    detail::BlobMetricsScope::noteBytes(100);
+    detail::BlobMetricsScope::release(metrics.get());
+    detail::BlobMetricsScope::noteBytes(100);
+
+    const auto snap = StatementMetricsSnapshot::of(*metrics);
+    EXPECT_EQ(snap.execute.count, 1u);
+    EXPECT_EQ(snap.openCursor.count, 1u);
+    EXPECT_EQ(snap.fetch.totalMicros, 30u);
+    EXPECT_EQ(snap.rowsAffected, 2u);
+    EXPECT_EQ(snap.rowsFetched, 10u);
+    EXPECT_EQ(snap.messageBytesIn, 128u);
+    EXPECT_EQ(snap.messageBytesOut, 416u);
+    EXPECT_EQ(snap.blobBytes, 100u);
+
+    // A target that died is not written to
+    detail::BlobMetricsScope::set(metrics);
+    metrics.reset();
+    detail::BlobMetricsScope::noteBytes(100);
+}
+
+TEST(StatementMetricsTest, ServerCounterDeltas) {
+    ServerCounters before;
+    before.reads = 10;
+    before.fetches = 100;
+    before.tables = {{128, 5, 0}, {130, 0, 7}};
+
+    ServerCounters after;
+    after.reads = 12;
+    after.fetches = 160;
+    after.marks = 3;
+    after.tables = {{128, 5, 0}, {129, 0, 0, 4}, {130, 0, 9}};
+
+    const auto delta = ServerCounters::delta(after, before);
+    EXPECT_EQ(delta.reads, 2u);
+    EXPECT_EQ(delta.fetches, 60u);
+    EXPECT_EQ(delta.marks, 3u);
+    // Unchanged table 128 is dropped, new table 129 counts from zero
+    ASSERT_EQ(delta.tables.size(), 2u);
+    EXPECT_EQ(delta.tables[0].relationId, 129u);
+    EXPECT_EQ(delta.tables[0].inserts, 4u);
+    EXPECT_EQ(delta.tables[1].relationId, 130u);
+    EXPECT_EQ(delta.tables[1].idxReads, 2u);
+
+    StatementMetrics metrics;
+    metrics.recordServerCounters(delta);
+    metrics.recordServerCounters(delta);
+    const auto snap = StatementMetricsSnapshot::of(metrics);
+    EXPECT_EQ(snap.serverSamples, 2u);
+    EXPECT_EQ(snap.server.fetches, 120u);
+    EXPECT_EQ(snap.server.totals().inserts, 8u);
+    EXPECT_EQ(snap.server.totals().idxReads, 4u);
+
+    metrics.reset();
+    EXPECT_EQ(metrics.serverSamples(), 0u);
+    EXPECT_TRUE(metrics.serverCounters().tables.empty());
+}
+
+TEST(StatementMetricsTest, PhaseBreakdown) {
+    using namespace std::chrono_literals;
+
+    StatementMetrics metrics;
+    metrics.recordPhase(Phase::Pack, 2us);
+    metrics.recordPhase(Phase::Pack, 4us);
+    metrics.recordPhase(Phase::Wire, 1ms);
+    auto snap = StatementMetricsSnapshot::of(metrics);
+    EXPECT_EQ(snap.phases[Phase::Pack].calls, 2u);
+    EXPECT_EQ(snap.phases[Phase::Pack].totalNanos, 6000u);
+    EXPECT_DOUBLE_EQ(snap.phases[Phase::Pack].meanNanos(), 3000.0);
+    EXPECT_EQ(snap.phases[Phase::Wire].totalNanos, 1000000u);
+    EXPECT_EQ(snap.phases[Phase::Unpack].calls, 0u);
+    EXPECT_EQ(snap.phases.totalNanos(), 1006000u);
+
+    // A timer records only with FBPP_PROFILE and the runtime switch on
+    { detail::PhaseTimer timer(&metrics, Phase::Unpack); }
+    EXPECT_EQ(metrics.phases()[Phase::Unpack].calls, 0u);
+    metrics.setProfilePhases(true);
+    { detail::PhaseTimer timer(&metrics, Phase::Unpack); }
+    { detail::PhaseTimer timer(nullptr, Phase::Unpack); }
+#if defined(FBPP_PROFILE)
+    EXPECT_EQ(metrics.phases()[Phase::Unpack].calls, 1u);
+#else
+    EXPECT_EQ(metrics.phases()[Phase::Unpack].calls, 0u);
+#endif
+
+    metrics.reset();
+    EXPECT_TRUE(metrics.phases().empty());
+    EXPECT_EQ(metrics.phases()[Phase::Pack].calls, 0u);
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/statement_pipeline.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/result_set.hpp"
+
+#include <string>
+#include <tuple>
+
+// StatementPipeline: same-statement runs go through one Batch, mixed steps
+// execute directly, per-step results and stop/continue on error.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+class StatementPipelineTest : public TempDatabaseTest {
+protected:
+    void SetUp() override {
+        TempDatabaseTest::SetUp();
+        connection_->ExecuteDDL(
+            "CREATE TABLE pipe_lines (id INTEGER NOT NULL PRIMARY KEY, item VARCHAR(20))");
+        connection_->ExecuteDDL(
+            "CREATE TABLE pipe_totals (id INTEGER NOT NULL PRIMARY KEY, n INTEGER)");
+        auto tx = connection_->StartTransaction();
+        connection_->ExecuteInTransaction(tx.get(), "INSERT INTO pipe_totals VALUES (1, 0)");
+        tx->Commit();
+    }
+
+    int32_t count(const std::string& sql) {
+        auto tx = connection_->StartTransaction();
+        auto cursor = tx->openCursor(connection_->prepareStatement(sql));
+        std::tuple<int32_t> row{};
+        EXPECT_TRUE(cursor->fetch(row));
+        cursor->close();
+        tx->Commit();
+        return std::get<0>(row);
+    }
+};
+
+TEST_F(StatementPipelineTest, BatchesSameStatementRuns) {
+    auto insert = connection_->prepareStatement("INSERT INTO pipe_lines VALUES (?, ?)");
+    auto update = connection_->prepareStatement("UPDATE pipe_totals SET n = n + ? WHERE id = 1");
+
+    auto tx = connection_->StartTransaction();
+    StatementPipeline pipe(tx);
+    for (int32_t i = 1; i <= 5; ++i) {
+        pipe.add(insert, std::make_tuple(i, std::string("item ") + std::to_string(i)));
+    }
+    pipe.add(update, std::make_tuple(int32_t{5}));
+    EXPECT_EQ(pipe.size(), 6u);
+
+    auto result = pipe.flush();
+    EXPECT_TRUE(pipe.empty());
+    ASSERT_EQ(result.steps.size(), 6u);
+    EXPECT_TRUE(result.ok());
+    EXPECT_EQ(result.batches, 1u);
+    EXPECT_EQ(result.directExecutes, 1u);
+    for (const auto& step : result.steps) {
+        EXPECT_EQ(step.status, PipelineStepStatus::Ok);
+        EXPECT_EQ(step.affected, 1);
+    }
+    tx->Commit();
+
+    EXPECT_EQ(count("SELECT COUNT(*) FROM pipe_lines"), 5);
+    EXPECT_EQ(count("SELECT n FROM pipe_totals WHERE id = 1"), 5);
+}
+
+TEST_F(StatementPipelineTest, StopsAtFirstFailure) {
+    auto insert = connection_->prepareStatement("INSERT INTO pipe_lines VALUES (?, ?)");
+    auto update = connection_->prepareStatement("UPDATE pipe_totals SET n = n + ? WHERE id = 1");
+
+    auto tx = connection_->StartTransaction();
+    StatementPipeline pipe(tx);
+    pipe.add(insert, std::make_tuple(int32_t{1}, std::string("a")));
+    pipe.add(insert, std::make_tuple(int32_t{1}, std::string("duplicate")));
+    pipe.add(insert, std::make_tuple(int32_t{2}, std::string("b")));
+    pipe.add(update, std::make_tuple(int32_t{1}));
+
+    auto result = pipe.flush();
+    EXPECT_FALSE(result.ok());
+    EXPECT_EQ(result.failedCount, 1u);
+    EXPECT_EQ(result.steps[0].status, PipelineStepStatus::Ok);
+    EXPECT_EQ(result.steps[1].status, PipelineStepStatus::Failed);
+    EXPECT_FALSE(result.steps[1].error.empty());
+    EXPECT_EQ(result.steps[2].status, PipelineStepStatus::Skipped);
+    EXPECT_EQ(result.steps[3].status, PipelineStepStatus::Skipped);
+    EXPECT_EQ(result.directExecutes, 0u);
+    tx->Rollback();
+}
+
+TEST_F(StatementPipelineTest, ContinueOnErrorRunsEveryStep) {
+    auto insert = connection_->prepareStatement("INSERT INTO pipe_lines VALUES (?, ?)");
+    auto update = connection_->prepareStatement("UPDATE pipe_totals SET n = n + ? WHERE id = 1");
+
+    auto tx = connection_->StartTransaction();
+    StatementPipelineOptions options;
+    options.stopOnError = false;
+    options.minBatchRun = 0;   // Everything direct
+    StatementPipeline pipe(tx, options);
+    pipe.add(insert, std::make_tuple(int32_t{1}, std::string("a")));
+    pipe.add(insert, std::make_tuple(int32_t{1}, std::string("duplicate")));
+    pipe.add(update, std::make_tuple(int32_t{2}));
+    pipe.add(connection_->prepareStatement("DELETE FROM pipe_lines WHERE id = 99"));
+
+    auto result = pipe.flush();
+    EXPECT_EQ(result.batches, 0u);
+    EXPECT_EQ(result.directExecutes, 4u);
+    EXPECT_EQ(result.failedCount, 1u);
+    EXPECT_EQ(result.steps[1].status, PipelineStepStatus::Failed);
+    EXPECT_EQ(result.steps[2].status, PipelineStepStatus::Ok);
+    EXPECT_EQ(result.steps[3].status, PipelineStepStatus::Ok);
+    EXPECT_EQ(result.steps[3].affected, 0);
+    tx->Commit();
+
+    EXPECT_EQ(count("SELECT COUNT(*) FROM pipe_lines"), 1);
+    EXPECT_EQ(count("SELECT n FROM pipe_totals WHERE id = 1"), 2);
+}
@@ -3,6 +3,7 @@
 #include "fbpp/core/connection.hpp"
 #include "fbpp/core/extended_types.hpp"
 #include "fbpp/core/firebird_compat.hpp"
+#include "fbpp/core/pack_plan.hpp"
 #include "fbpp/core/query_executor.hpp"
 #include "fbpp/core/result_set.hpp"
 #include "fbpp/core/struct_pack.hpp"
@@ -213,6 +214,119 @@ struct StructDescriptor<local::InsertReturningOutput> {
 
 } // namespace fbpp::core
 
+namespace local {
+
+// Descriptor with pinned types, read by the compile-time decoder when the
+// statement's columns match it.
+struct PinnedRow {
+    int32_t id;
+    std::optional<int32_t> fInteger;
+    std::string fVarchar;
+    std::string fChar;
+    int64_t fSmall;
+    double fDouble;
+    std::optional<bool> fBoolean;
+    double fNumeric;
+};
+
+struct StaleLayoutRow {
+    int32_t id;
+    std::string name;
+};
+
+// Short codes held inline (AdapterConfig::inlineStringBytes)
+struct InlineCodeRow {
+    int32_t id;
+    FixedString<16> code;
+    std::optional<FixedString<4>> flag;
+};
+
+// Laid out as its own message: value, null indicator, value, ...
+struct MessageRow {
+    int32_t id;
+    int16_t idNull;
+    int64_t amount;
+    int16_t amountNull;
+    double ratio;
+    int16_t ratioNull;
+    Timestamp created;
+    int16_t createdNull;
+    std::array<char, 4> code;
+    int16_t codeNull;
+};
+
+// Indicator ahead of its value: not the message's layout
+struct SwappedMessageRow {
+    int16_t idNull;
+    int32_t id;
+};
+
+} // namespace local
+
+namespace fbpp::core {
+
+template<>
+struct StructDescriptor<local::PinnedRow> {
+    static constexpr bool pinned_decode = true;
+    static constexpr auto fields = std::make_tuple(
+        makeField<&local::PinnedRow::id>("ID", SQL_LONG, 0, sizeof(int32_t)),
+        makeField<&local::PinnedRow::fInteger>("F_INTEGER", SQL_LONG, 0, sizeof(int32_t), 0, true),
+        makeField<&local::PinnedRow::fVarchar>("F_VARCHAR", SQL_VARYING, 0, 64, 0, true),
+        makeField<&local::PinnedRow::fChar>("F_CHAR", SQL_TEXT, 0, 16, 0, true),
+        makeField<&local::PinnedRow::fSmall>("F_SMALL", SQL_SHORT, 0, sizeof(int16_t), 0, true),
+        makeField<&local::PinnedRow::fDouble>("F_DOUBLE", SQL_DOUBLE, 0, sizeof(double), 0, true),
+        makeField<&local::PinnedRow::fBoolean>("F_BOOLEAN", SQL_BOOLEAN, 0, 1, 0, true),
+        makeField<&local::PinnedRow::fNumeric>("F_NUMERIC", SQL_LONG, 0, sizeof(int32_t), 0, true)
+    );
+};
+
+// Claims a build-time layout that no live statement has
+template<>
+struct StructDescriptor<local::StaleLayoutRow> {
+    static constexpr bool pinned_decode = true;
+    static constexpr auto fields = std::make_tuple(
+        makeField<&local::StaleLayoutRow::id>("ID", SQL_LONG, 0, sizeof(int32_t)),
+        makeField<&local::StaleLayoutRow::name>("NAME", SQL_VARYING, 0, 64, 0, true)
+    );
+    static constexpr std::uint64_t layout_hash = 0x1ull;
+    static constexpr std::array<unsigned, 2> offsets = {1000, 2000};
+    static constexpr std::array<unsigned, 2> null_offsets = {3000, 4000};
+};
+
+template<>
+struct StructDescriptor<local::InlineCodeRow> {
+    static constexpr bool pinned_decode = true;
+    static constexpr auto fields = std::make_tuple(
+        makeField<&local::InlineCodeRow::id>("ID", SQL_LONG, 0, sizeof(int32_t)),
+        makeField<&local::InlineCodeRow::code>("CODE", SQL_VARYING, 0, 16, 0, true),
+        makeField<&local::InlineCodeRow::flag>("FLAG", SQL_TEXT, 0, 4, 0, true)
+    );
+};
+
+template<>
+struct StructDescriptor<local::MessageRow> {
+    static constexpr auto fields = std::make_tuple(
+        makeField<&local::MessageRow::id>("ID", SQL_LONG),
+        makeField<&local::MessageRow::amount>("AMOUNT", SQL_INT64),
+        makeField<&local::MessageRow::ratio>("RATIO", SQL_DOUBLE),
+        makeField<&local::MessageRow::created>("CREATED", SQL_TIMESTAMP),
+        makeField<&local::MessageRow::code>("CODE", SQL_TEXT, 0, 4)
+    );
+    static constexpr auto null_indicators = std::make_tuple(
+        &local::MessageRow::idNull, &local::MessageRow::amountNull,
+        &local::MessageRow::ratioNull, &local::MessageRow::createdNull,
+        &local::MessageRow::codeNull);
+};
+
+template<>
+struct StructDescriptor<local::SwappedMessageRow> {
+    static constexpr auto fields = std::make_tuple(
+        makeField<&local::SwappedMessageRow::id>("ID", SQL_LONG));
+    static constexpr auto null_indicators = std::make_tuple(&local::SwappedMessageRow::idNull);
+};
+
+} // namespace fbpp::core
+
 class StructPackTest : public SuiteDatabaseTest {
 protected:
     std::vector<SchemaProfile> schemaProfiles() const override {
@@ -293,6 +407,17 @@ TEST_F(StructPackTest, PackAndUnpackStructAgainstTableTest1) {
     EXPECT_EQ(updatedRow->fVarchar, "UpdatedName");
     verifyTra->Commit();
 
+    // Autocommit reads on the connection's read transaction see the commit
+    auto sharedRow = fbpp::core::fetchOne<local::QueryDescriptor<local::QueryId::SelectById>>(
+        *connection_, TableTestSelectInput{targetId});
+    ASSERT_TRUE(sharedRow.has_value());
+    EXPECT_EQ(sharedRow->fVarchar, "UpdatedName");
+    auto sharedRows = fbpp::core::executeQuery<local::QueryDescriptor<local::QueryId::SelectById>>(
+        *connection_, TableTestSelectInput{targetId});
+    ASSERT_EQ(sharedRows.size(), 1u);
+    EXPECT_EQ(sharedRows[0].id, targetId);
+    EXPECT_TRUE(connection_->readTransaction()->isActive());
+
     auto restoreTra = connection_->StartTransaction();
     local::TableTestUpdateInput restoreParams{originalName, targetId};
     fbpp::core::executeNonQuery<local::QueryDescriptor<local::QueryId::UpdateName>>(
@@ -443,3 +568,194 @@ TEST_F(StructPackTest, ExtendedTypesRoundTripUsingStructDescriptors) {
     ASSERT_EQ(deleteTra->execute(deleteStmt, fetchParams), 1u);
     deleteTra->Commit();
 }
+
+TEST_F(StructPackTest, PinnedDescriptorDecodesAndFallsBack) {
+    auto tra = connection_->StartTransaction();
+
+    // Columns exactly as pinned: the direct decoder
+    auto exact = connection_->prepareStatement(
+        "SELECT CAST(7 AS INTEGER), CAST(NULL AS INTEGER), CAST('abc' AS VARCHAR(16)), "
+        "CAST('xy' AS CHAR(4)), CAST(-3 AS SMALLINT), CAST(1.5 AS DOUBLE PRECISION), "
+        "TRUE, CAST(12 AS INTEGER) FROM RDB$DATABASE");
+    auto cursor = tra->openCursor(exact);
+    local::PinnedRow row{};
+    row.fInteger = 1;
+    ASSERT_TRUE(cursor->fetch(row));
+    EXPECT_EQ(row.id, 7);
+    EXPECT_FALSE(row.fInteger.has_value());
+    EXPECT_EQ(row.fVarchar, "abc");
+    EXPECT_EQ(row.fChar, "xy");
+    EXPECT_EQ(row.fSmall, -3);
+    EXPECT_DOUBLE_EQ(row.fDouble, 1.5);
+    ASSERT_TRUE(row.fBoolean.has_value());
+    EXPECT_TRUE(*row.fBoolean);
+    EXPECT_DOUBLE_EQ(row.fNumeric, 12.0);
+    cursor->close();
+
+    // A scaled column breaks the pin: the generic codec de-scales it
+    auto scaled = connection_->prepareStatement(
+        "SELECT CAST(7 AS INTEGER), CAST(5 AS INTEGER), CAST('abc' AS VARCHAR(16)), "
+        "CAST('xy' AS CHAR(4)), CAST(-3 AS SMALLINT), CAST(1.5 AS DOUBLE PRECISION), "
+        "FALSE, CAST(12.25 AS NUMERIC(9,2)) FROM RDB$DATABASE");
+    cursor = tra->openCursor(scaled);
+    ASSERT_TRUE(cursor->fetch(row));
+    EXPECT_EQ(row.fInteger, std::optional<int32_t>(5));
+    EXPECT_EQ(row.fBoolean, std::optional<bool>(false));
+    EXPECT_DOUBLE_EQ(row.fNumeric, 12.25);
+    cursor->close();
+
+    // NULL into a non-optional pinned field keeps the codec's error
+    auto nullId = connection_->prepareStatement(
+        "SELECT CAST(NULL AS INTEGER), CAST(NULL AS INTEGER), CAST('abc' AS VARCHAR(16)), "
+        "CAST('xy' AS CHAR(4)), CAST(-3 AS SMALLINT), CAST(1.5 AS DOUBLE PRECISION), "
+        "TRUE, CAST(12 AS INTEGER) FROM RDB$DATABASE");
+    cursor = tra->openCursor(nullId);
+    EXPECT_THROW(cursor->fetch(row), FirebirdException);
+    cursor->close();
+
+    tra->Commit();
+}
+
+TEST_F(StructPackTest, StaleBuildTimeLayoutFallsBackToLiveOffsets) {
+    auto tra = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement(
+        "SELECT CAST(? AS INTEGER), CAST(? AS VARCHAR(16)) FROM RDB$DATABASE");
+    const auto input = stmt->getInputMetadata();
+    const auto output = stmt->getOutputMetadata();
+    EXPECT_EQ(output->getLayout()->layoutHash, messageLayoutHash(output->getLayout()->fields));
+    EXPECT_NE(output->getLayout()->layoutHash, 0x1ull);
+
+    // Hash differs: neither path may touch the bogus constant offsets
+    EXPECT_FALSE(PackPlan<local::StaleLayoutRow>::of(*input).exact());
+    const auto& pinned = detail::PinnedLayout<local::StaleLayoutRow>::of(*output);
+    EXPECT_FALSE(pinned.exact());
+    EXPECT_TRUE(pinned.matches());
+
+    auto cursor = tra->openCursor(stmt, local::StaleLayoutRow{42, "stale"});
+    local::StaleLayoutRow row{};
+    ASSERT_TRUE(cursor->fetch(row));
+    EXPECT_EQ(row.id, 42);
+    EXPECT_EQ(row.name, "stale");
+    cursor->close();
+    tra->Commit();
+}
+
+TEST_F(StructPackTest, FixedStringColumnsRoundTripInline) {
+    auto tra = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement(
+        "SELECT CAST(? AS INTEGER), CAST(? AS VARCHAR(16)), CAST(? AS CHAR(4)) FROM RDB$DATABASE");
+    EXPECT_TRUE(detail::PinnedLayout<local::InlineCodeRow>::of(*stmt->getOutputMetadata()).matches());
+
+    auto cursor = tra->openCursor(stmt, local::InlineCodeRow{1, "EUR-USD", FixedString<4>("ab")});
+    local::InlineCodeRow row{};
+    ASSERT_TRUE(cursor->fetch(row));
+    EXPECT_EQ(row.id, 1);
+    EXPECT_EQ(row.code, "EUR-USD");
+    ASSERT_TRUE(row.flag.has_value());
+    EXPECT_EQ(*row.flag, "ab");                 // CHAR padding trimmed
+    cursor->close();
+
+    cursor = tra->openCursor(stmt, local::InlineCodeRow{2, "", std::nullopt});
+    ASSERT_TRUE(cursor->fetch(row));
+    EXPECT_TRUE(row.code.empty());
+    EXPECT_FALSE(row.flag.has_value());
+    cursor->close();
+
+    // Generic codec path: conversions as for std::string, capacity checked
+    auto other = connection_->prepareStatement(
+        "SELECT CAST(42 AS INTEGER), CAST('toolong' AS VARCHAR(10)) FROM RDB$DATABASE");
+    cursor = tra->openCursor(other);
+    std::tuple<FixedString<8>, FixedString<8>> converted;
+    ASSERT_TRUE(cursor->fetch(converted));
+    EXPECT_EQ(std::get<0>(converted), "42");
+    EXPECT_EQ(std::get<1>(converted), "toolong");
+    cursor->close();
+    cursor = tra->openCursor(other);
+    std::tuple<FixedString<8>, FixedString<4>> narrow;
+    EXPECT_THROW(cursor->fetch(narrow), FirebirdException);
+    cursor->close();
+
+    EXPECT_THROW(FixedString<2>("abc"), std::length_error);
+    tra->Commit();
+}
+
+TEST_F(StructPackTest, MessageLayoutRowsFetchWithoutDecode) {
+    const auto& format = messageFormat<local::MessageRow>();
+    ASSERT_EQ(format->getCount(), 5u);
+    EXPECT_LE(format->getMessageLength(), sizeof(local::MessageRow));
+    EXPECT_EQ(messageFormat<local::MessageRow>(), format);   // Built once
+    EXPECT_THROW(messageFormat<local::SwappedMessageRow>(), FirebirdException);
+
+    auto tra = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement(
+        "WITH RECURSIVE n (i) AS (SELECT 1 FROM RDB$DATABASE "
+        "UNION ALL SELECT i + 1 FROM n WHERE i < 5) "
+        "SELECT i, i * 10, i / 2e0, TIMESTAMP '2024-03-01 12:30:00', "
+        "IIF(i = 3, NULL, 'ab') FROM n");
+
+    // Straight into the vector: the server converts to the struct's format
+    auto cursor = tra->openCursor(stmt, format);
+    EXPECT_EQ(cursor->getMetadata(), format.get());
+    std::vector<local::MessageRow> rows;
+    cursor->fetchAll(rows);
+    cursor->close();
+    ASSERT_EQ(rows.size(), 5u);
+    EXPECT_EQ(rows[4].id, 5);
+    EXPECT_EQ(rows[4].amount, 50);
+    EXPECT_DOUBLE_EQ(rows[4].ratio, 2.5);
+    EXPECT_EQ(rows[4].created.getDate(), Date(2024, 3, 1).getDate());
+    EXPECT_EQ(rows[0].idNull, 0);
+    EXPECT_EQ(std::string(rows[0].code.data(), rows[0].code.size()), "ab  ");
+    EXPECT_EQ(rows[2].codeNull, -1);
+    EXPECT_EQ(rows[1].codeNull, 0);
+
+    // Through the prefetch window, reusing the elements
+    cursor = tra->openCursor(stmt, format);
+    cursor->setPrefetch(2);
+    rows.resize(8);
+    EXPECT_EQ(cursor->fetchInto(rows), 5u);
+    EXPECT_EQ(rows.size(), 5u);
+    EXPECT_EQ(rows[4].amount, 50);
+    cursor->close();
+
+    // One row at a time: a copy of the message
+    cursor = tra->openCursor(stmt, format);
+    local::MessageRow row{};
+    ASSERT_TRUE(cursor->fetch(row));
+    EXPECT_EQ(row.id, 1);
+    EXPECT_EQ(row.amount, 10);
+    cursor->close();
+    tra->Commit();
+}
+
+TEST_F(StructPackTest, DescriptorStatementSlotSkipsCacheLookup) {
+    using SelectById = local::QueryDescriptor<local::QueryId::SelectById>;
+    const fbpp::core::SqlKey key{std::string(SelectById::sql)};
+    const size_t slot = fbpp::core::statementSlot<SelectById>();
+    EXPECT_EQ(fbpp::core::statementSlot<SelectById>(), slot);
+    EXPECT_NE(fbpp::core::statementSlot<local::QueryDescriptor<local::QueryId::UpdateName>>(),
+              slot);
+
+    Statement* first = nullptr;
+    {
+        auto tra = connection_->StartTransaction();
+        auto rows = fbpp::core::executeQuery<SelectById>(*connection_, *tra,
+                                                           TableTestSelectInput{-1});
+        EXPECT_TRUE(rows.empty());
+        tra->Commit();
+        first = connection_->prepareStatement(key, slot).get();
+    }
+    EXPECT_EQ(connection_->prepareStatement(key, slot).get(), first);
+
+    // Held elsewhere: another instance, the slot keeps its own
+    auto held = connection_->prepareStatement(key, slot);
+    auto other = connection_->prepareStatement(key, slot);
+    EXPECT_NE(other.get(), held.get());
+    other.reset();
+    held.reset();
+
+    connection_->clearStatementCache();
+    auto fresh = connection_->prepareStatement(key, slot);
+    ASSERT_TRUE(fresh);
+    EXPECT_TRUE(fresh->isValid());
+}
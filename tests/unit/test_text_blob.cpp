@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/exception.hpp"
+#include "fbpp/core/extended_types.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// TextBlob — BLOB id handle with lazily loaded content shared by copies.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+TEST(TextBlobHandleTest, LoadsOnceAndSharesAcrossCopies) {
+    const uint8_t id[8] = {1, 0, 0, 0, 2, 0, 0, 0};
+    int loads = 0;
+    TextBlob blob(id, [&](const uint8_t*) {
+        ++loads;
+        return std::string("memo text");
+    });
+    TextBlob copy = blob;
+    EXPECT_FALSE(blob.hasText());
+    EXPECT_EQ(loads, 0);
+
+    EXPECT_EQ(copy.getText(), "memo text");
+    EXPECT_TRUE(blob.hasText());
+    EXPECT_EQ(&blob.getText(), &copy.getText());
+    EXPECT_EQ(loads, 1);
+
+    copy.setText("changed");   // Detaches the copy only
+    EXPECT_EQ(blob.getText(), "memo text");
+    EXPECT_EQ(copy.getText(), "changed");
+    EXPECT_TRUE(TextBlob("direct").hasText());
+    EXPECT_EQ(TextBlob().getText(), "");
+}
+
+class TextBlobTest : public TempDatabaseTest {
+protected:
+    void createTestSchema() override {
+        connection_->ExecuteDDL(
+            "CREATE TABLE memo (id INTEGER NOT NULL PRIMARY KEY, note BLOB SUB_TYPE TEXT)");
+        auto tx = connection_->StartTransaction();
+        auto ins = connection_->prepareStatement("INSERT INTO memo VALUES (?, ?)");
+        for (int32_t i = 1; i <= 3; ++i) {
+            tx->execute(ins, std::make_tuple(i, std::string(1000 * i, static_cast<char>('a' + i))));
+        }
+        tx->execute(connection_->prepareStatement("INSERT INTO memo VALUES (4, NULL)"));
+        tx->Commit();
+    }
+};
+
+TEST_F(TextBlobTest, FetchReadsNothingUntilAsked) {
+    auto tx = connection_->StartTransaction();
+    auto cur = tx->openCursor(connection_->prepareStatement(
+        "SELECT id, note FROM memo ORDER BY id"));
+    std::vector<TextBlob> notes;
+    std::tuple<int32_t, TextBlob> row;
+    while (cur->fetch(row)) {
+        notes.push_back(std::get<1>(row));
+        EXPECT_FALSE(std::get<1>(row).hasText());
+    }
+    cur->close();
+    ASSERT_EQ(notes.size(), 4u);
+
+    EXPECT_EQ(notes[1].getText(), std::string(2000, 'c'));
+    EXPECT_TRUE(notes[1].hasText());
+    EXPECT_FALSE(notes[0].hasText());
+    EXPECT_TRUE(notes[3].isNull());
+    EXPECT_EQ(notes[3].getText(), "");
+    tx->Commit();
+
+    EXPECT_EQ(notes[1].getText(), std::string(2000, 'c'));   // Already loaded
+    EXPECT_THROW(notes[0].getText(), FirebirdException);
+}
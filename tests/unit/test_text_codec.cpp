@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include "fbpp/core/text_codec.hpp"
+#include "fbpp/core/exception.hpp"
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+// UTF-8 validation / UTF-16 decoding and single-byte code page transcoding.
+// Lengths straddle the 16-byte ASCII fast path on purpose. TextTranscoder
+// is fed the same text in pieces of every small size.
+
+using namespace fbpp::core;
+
+TEST(TextCodecTest, ValidatesUtf8) {
+    EXPECT_TRUE(isValidUtf8(""));
+    EXPECT_TRUE(isValidUtf8(std::string(40, 'a')));
+    EXPECT_TRUE(isValidUtf8("price \xE2\x82\xAC 10, \xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82"));
+    EXPECT_TRUE(isValidUtf8("\xF0\x9F\x98\x80"));                       // U+1F600
+
+    EXPECT_FALSE(isValidUtf8("\xC0\xAF"));                              // Overlong '/'
+    EXPECT_FALSE(isValidUtf8("\xED\xA0\x80"));                          // Surrogate
+    EXPECT_FALSE(isValidUtf8("\xF4\x90\x80\x80"));                      // > U+10FFFF
+    EXPECT_FALSE(isValidUtf8(std::string(20, 'x') + "\xE2\x82"));       // Truncated
+    EXPECT_FALSE(isValidUtf8(std::string(17, 'x') + "\x80"));           // Stray continuation
+}
+
+TEST(TextCodecTest, DecodesUtf8ToUtf16) {
+    const std::string ascii(37, 'q');
+    EXPECT_EQ(utf8ToUtf16(ascii), std::u16string(37, u'q'));
+
+    const std::string mixed = std::string(18, 'a') + "\xD0\x96" + "\xE2\x82\xAC" + "\xF0\x9F\x98\x80" + "z";
+    const std::u16string expected = std::u16string(18, u'a') + u"Ж€\U0001F600z";
+    EXPECT_EQ(utf16Length(mixed), expected.size());
+    EXPECT_EQ(utf8ToUtf16(mixed), expected);
+
+    char16_t buffer[64] = {};
+    ASSERT_EQ(utf8ToUtf16(mixed, buffer), expected.size());
+    EXPECT_EQ(std::u16string(buffer, expected.size()), expected);
+}
+
+TEST(TextCodecTest, InvalidUtf8ThrowsOrReplaces) {
+    const std::string bad = "ok\xFFok";
+    EXPECT_THROW(utf8ToUtf16(bad), FirebirdException);
+    EXPECT_EQ(utf8ToUtf16(bad, Utf8Errors::Replace), u"ok�ok");
+    EXPECT_EQ(utf16Length(bad, Utf8Errors::Replace), 5u);
+}
+
+TEST(TextCodecTest, SingleByteCodePagesToUtf8AndUtf16) {
+    ASSERT_EQ(singleByteCharsetForId(52), SingleByteCharset::Win1251);
+    EXPECT_FALSE(singleByteCharsetForId(4).has_value());   // UTF8 is not single-byte
+
+    // "Привет" in WIN1251 and KOI8-R, behind an ASCII run longer than a block
+    const std::string prefix(20, '-');
+    const std::string win1251 = prefix + "\xCF\xF0\xE8\xE2\xE5\xF2";
+    const std::string koi8r = prefix + "\xF0\xD2\xC9\xD7\xC5\xD4";
+    const std::string utf8 = prefix + "\xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82";
+    EXPECT_EQ(singleByteToUtf8(win1251, SingleByteCharset::Win1251), utf8);
+    EXPECT_EQ(singleByteToUtf8(koi8r, SingleByteCharset::Koi8R), utf8);
+
+    EXPECT_EQ(singleByteToUtf8("\x80", SingleByteCharset::Win1252), "\xE2\x82\xAC");   // Euro
+    EXPECT_EQ(singleByteToUtf8("\xE9", SingleByteCharset::Latin1), "\xC3\xA9");
+
+    std::u16string wide(win1251.size(), u'\0');
+    singleByteToUtf16(win1251, SingleByteCharset::Win1251, wide.data());
+    EXPECT_EQ(wide, utf8ToUtf16(utf8));
+}
+
+namespace {
+
+// Feed `text` in pieces of `step` bytes, finish, return everything written
+std::string transcodeInPieces(TextTranscoder& transcoder, const std::string& text,
+                              std::size_t step) {
+    std::string out;
+    for (std::size_t at = 0; at < text.size(); at += step) {
+        transcoder.feed(std::string_view(text).substr(at, step), out);
+    }
+    transcoder.finish(out);
+    return out;
+}
+
+} // namespace
+
+TEST(TextCodecTest, TranscoderHoldsSequencesCutByChunks) {
+    // Two-, three- and four-byte sequences, each cut at every position by some step
+    const std::string utf8 = std::string(17, '-') + "\xD0\x9F\xD1\x80\xD0\xB8\xE2\x82\xAC" +
+                             "\xF0\x9F\x98\x80" + "end";
+    for (std::size_t step = 1; step <= 6; ++step) {
+        TextTranscoder validate(std::nullopt, std::nullopt);
+        EXPECT_EQ(transcodeInPieces(validate, utf8, step), utf8) << "step " << step;
+        EXPECT_EQ(validate.pending(), 0u);
+    }
+
+    const std::string win1251 = std::string(17, '-') + "\xCF\xF0\xE8\x88";   // "При€"
+    const std::string cyrillic = std::string(17, '-') + "\xD0\x9F\xD1\x80\xD0\xB8\xE2\x82\xAC";
+    for (std::size_t step = 1; step <= 4; ++step) {
+        TextTranscoder toWin1251(std::nullopt, SingleByteCharset::Win1251);
+        EXPECT_EQ(transcodeInPieces(toWin1251, cyrillic, step), win1251) << "step " << step;
+
+        TextTranscoder fromWin1251(SingleByteCharset::Win1251, std::nullopt);
+        EXPECT_EQ(transcodeInPieces(fromWin1251, win1251, step), cyrillic) << "step " << step;
+    }
+
+    // KOI8-R to WIN1251 goes through code points
+    TextTranscoder koiToWin(SingleByteCharset::Koi8R, SingleByteCharset::Win1251);
+    std::string out;
+    koiToWin.feed("\xF0\xD2\xC9", out);
+    EXPECT_EQ(out, "\xCF\xF0\xE8");
+}
+
+TEST(TextCodecTest, TranscoderReportsMalformedAndUnmappableText) {
+    TextTranscoder strict(std::nullopt, SingleByteCharset::Win1251);
+    std::string out;
+    strict.feed("ok\xE2\x82", out);
+    EXPECT_EQ(out, "ok");
+    EXPECT_EQ(strict.pending(), 2u);
+    EXPECT_THROW(strict.finish(out), FirebirdException);   // Truncated at the end
+
+    strict.reset();
+    EXPECT_THROW(strict.feed("\xC3\xA9", out), FirebirdException);   // No e-acute in WIN1251
+    strict.reset();
+    EXPECT_THROW(strict.feed("a\xFF", out), FirebirdException);
+
+    // A cut sequence that the next chunk does not continue is malformed
+    TextTranscoder lenient(std::nullopt, std::nullopt, Utf8Errors::Replace);
+    out.clear();
+    lenient.feed("a\xE2\x82", out);
+    lenient.feed("b", out);
+    lenient.finish(out);
+    EXPECT_EQ(out, "a\xEF\xBF\xBD\xEF\xBF\xBD" "b");
+
+    TextTranscoder toLatin1(std::nullopt, SingleByteCharset::Latin1, Utf8Errors::Replace);
+    out.clear();
+    toLatin1.feed("\xC3\xA9\xE2\x82\xAC", out);
+    EXPECT_EQ(out, "\xE9?");
+}
+
+TEST(TextCodecTest, TranscoderForCharsetIds) {
+    EXPECT_TRUE(TextTranscoder::forCharsetIds(52, 52).passThrough());
+    EXPECT_TRUE(TextTranscoder::forCharsetIds(0, 0).passThrough());     // NONE as is
+    EXPECT_FALSE(TextTranscoder::forCharsetIds(4, 52).passThrough());
+    EXPECT_THROW(TextTranscoder::forCharsetIds(5, 4), FirebirdException);   // SJIS_0208
+
+    auto fromFss = TextTranscoder::forCharsetIds(3, 53);
+    std::string out;
+    fromFss.feed("\xE2\x82\xAC", out);
+    EXPECT_EQ(out, "\x80");
+    EXPECT_EQ(fromFss.bytesIn(), 3u);
+}
@@ -1,8 +1,11 @@
 #include <gtest/gtest.h>
 
 #include "fbpp/core/timestamp_utils.hpp"
+#include "fbpp/core/time_zone_table.hpp"
 
 #include <chrono>
+#include <cstdint>
+#include <vector>
 
 namespace {
 
@@ -39,4 +42,92 @@ TEST(TimestampUtilsTest, DateRoundTripsCalendarValue) {
     EXPECT_EQ(restored, original);
 }
 
+TEST(TimestampUtilsTest, CalendarFieldsMatchChrono) {
+    using namespace std::chrono;
+    namespace tu = fbpp::core::timestamp_utils;
+
+    // Every 7th day from 0001-01-01 to 9999-12-31 (Firebird's DATE range).
+    const auto first = sys_days{year{1} / January / 1};
+    const auto last = sys_days{year{9999} / December / 31};
+    for (auto d = first; d <= last; d += days{7}) {
+        const year_month_day ymd{d};
+        const auto fbDate = static_cast<uint32_t>(
+            static_cast<int32_t>(d.time_since_epoch().count() + tu::FIREBIRD_EPOCH_DIFF));
+        unsigned y = 0;
+        unsigned m = 0;
+        unsigned dd = 0;
+        tu::decode_firebird_date(fbDate, y, m, dd);
+        ASSERT_EQ(static_cast<int>(y), static_cast<int>(ymd.year()));
+        ASSERT_EQ(m, static_cast<unsigned>(ymd.month()));
+        ASSERT_EQ(dd, static_cast<unsigned>(ymd.day()));
+        ASSERT_EQ(tu::encode_firebird_date(y, m, dd), fbDate);
+    }
+
+    unsigned h = 0;
+    unsigned mi = 0;
+    unsigned sec = 0;
+    unsigned frac = 0;
+    tu::decode_firebird_time(tu::encode_firebird_time(23, 59, 58, 9999), h, mi, sec, frac);
+    EXPECT_EQ(h, 23u);
+    EXPECT_EQ(mi, 59u);
+    EXPECT_EQ(sec, 58u);
+    EXPECT_EQ(frac, 9999u);
+}
+
+TEST(TimestampUtilsTest, BatchKernelsMatchScalarConversion) {
+    namespace tu = fbpp::core::timestamp_utils;
+
+    // Before 1858 (negative ISC_DATE), around the Unix epoch, and far ahead.
+    const std::vector<int64_t> micros = {
+        -62135596800000000LL, -3506716800000000LL - 100, -100, 0, 100,
+        86399999900LL, 1705320645123400LL, 253402300799999900LL};
+    std::vector<uint32_t> dateTime(micros.size() * 2);
+    tu::unix_micros_to_firebird_timestamps(micros.data(), micros.size(), dateTime.data());
+
+    std::vector<int64_t> back(micros.size());
+    tu::firebird_timestamps_to_unix_micros(dateTime.data(), micros.size(), back.data());
+    EXPECT_EQ(back, micros);
+
+    std::vector<uint32_t> dates(micros.size());
+    std::vector<uint32_t> times(micros.size());
+    for (std::size_t i = 0; i < micros.size(); ++i) {
+        dates[i] = dateTime[2 * i];
+        times[i] = dateTime[2 * i + 1];
+        EXPECT_LT(times[i], tu::TIME_UNITS_PER_DAY);
+    }
+    std::vector<int32_t> days(micros.size());
+    std::vector<int64_t> timeMicros(micros.size());
+    tu::firebird_dates_to_unix_days(dates.data(), dates.size(), days.data());
+    tu::firebird_times_to_micros(times.data(), times.size(), timeMicros.data());
+    for (std::size_t i = 0; i < micros.size(); ++i) {
+        EXPECT_EQ(days[i] * tu::MICROS_PER_DAY + timeMicros[i], micros[i]);
+    }
+
+    std::vector<uint32_t> datesBack(micros.size());
+    std::vector<uint32_t> timesBack(micros.size());
+    tu::unix_days_to_firebird_dates(days.data(), days.size(), datesBack.data());
+    tu::micros_to_firebird_times(timeMicros.data(), timeMicros.size(), timesBack.data());
+    EXPECT_EQ(datesBack, dates);
+    EXPECT_EQ(timesBack, times);
+}
+
+TEST(TimestampUtilsTest, OffsetZonesNeedNoLookup) {
+    auto& zones = fbpp::core::TimeZoneTable::instance();
+    // Firebird offset zone ids are displacement-in-minutes + 1439.
+    EXPECT_TRUE(zones.isOffsetZone(1439));
+    EXPECT_FALSE(zones.isOffsetZone(65535));
+    EXPECT_EQ(zones.name(1439), "+00:00");
+    EXPECT_EQ(zones.name(1439 + 330), "+05:30");
+    EXPECT_EQ(zones.name(1439 - 180), "-03:00");
+    EXPECT_EQ(zones.offsetMinutes(1439 + 120, 0), 120);
+    EXPECT_EQ(&zones.name(1439 + 330), &zones.name(1439 + 330));   // Formatted once
+
+    const std::vector<int64_t> utc = {0, 1000000};
+    const std::vector<uint16_t> ids = {1439 + 60, 1439 - 90};
+    std::vector<int64_t> local(utc.size());
+    zones.toLocalMicros(utc.data(), ids.data(), utc.size(), local.data());
+    EXPECT_EQ(local[0], 3600000000LL);
+    EXPECT_EQ(local[1], 1000000LL - 5400000000LL);
+}
+
 } // namespace
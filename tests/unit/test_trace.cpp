@@ -1,7 +1,11 @@
 #include <gtest/gtest.h>
 #include <fbpp_util/trace.h>
 
+#include <atomic>
+#include <cstdint>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <vector>
 
@@ -47,3 +51,78 @@ TEST(TraceTest, TraceMessageBypassesFormatter) {
     EXPECT_EQ(std::get<2>(sink.entries[0]), "preformatted");
 }
 
+
+TEST(TraceTest, LevelGateSkipsFormatting) {
+    CapturingSink sink;
+    fbpp::util::setTraceSink(&sink);
+    EXPECT_EQ(fbpp::util::getTraceLevel(), fbpp::util::TraceLevel::info);
+
+    bool formatted = false;
+    fbpp::util::trace(fbpp::util::TraceLevel::debug, "TraceTest",
+                      [&](auto& oss) { formatted = true; oss << "hidden"; });
+    EXPECT_FALSE(formatted);
+    EXPECT_FALSE(fbpp::util::traceEnabled(fbpp::util::TraceLevel::trace));
+
+    fbpp::util::setTraceLevel(fbpp::util::TraceLevel::trace);
+    fbpp::util::trace(fbpp::util::TraceLevel::debug, "TraceTest",
+                      [&](auto& oss) { formatted = true; oss << "shown"; });
+    fbpp::util::setTraceLevel(fbpp::util::TraceLevel::info);
+    fbpp::util::setTraceSink(nullptr);
+
+    EXPECT_TRUE(formatted);
+    ASSERT_EQ(sink.entries.size(), 1);
+    EXPECT_EQ(std::get<0>(sink.entries[0]), fbpp::util::TraceLevel::debug);
+    EXPECT_EQ(std::get<2>(sink.entries[0]), "shown");
+}
+
+TEST(TraceTest, AsyncSinkDeliversInOrderPerProducer) {
+    CapturingSink target;   // Called from the worker thread only
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 500;
+    {
+        fbpp::util::AsyncTraceSink async(target, 4 * kThreads * kPerThread);
+        std::vector<std::thread> producers;
+        for (int t = 0; t < kThreads; ++t) {
+            producers.emplace_back([&async, t] {
+                for (int i = 0; i < kPerThread; ++i) {
+                    async.log(fbpp::util::TraceLevel::trace, "T" + std::to_string(t),
+                              std::to_string(i));
+                }
+            });
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        async.flush();
+        EXPECT_EQ(async.dropped(), 0u);
+        EXPECT_EQ(target.entries.size(), static_cast<size_t>(kThreads * kPerThread));
+    }
+
+    std::vector<int> next(kThreads, 0);
+    for (const auto& [level, component, message] : target.entries) {
+        const int t = std::stoi(component.substr(1));
+        EXPECT_EQ(std::stoi(message), next[t]++);
+    }
+}
+
+TEST(TraceTest, AsyncSinkDropsWhenFull) {
+    struct BlockingSink : fbpp::util::TraceSink {
+        std::mutex gate;
+        std::atomic<int> delivered{0};
+        void log(fbpp::util::TraceLevel, std::string_view, std::string_view) override {
+            std::lock_guard<std::mutex> lock(gate);
+            ++delivered;
+        }
+    } target;
+
+    std::unique_lock<std::mutex> hold(target.gate);   // Worker stalls on the first entry
+    fbpp::util::AsyncTraceSink async(target, 4);
+    ASSERT_EQ(async.capacity(), 4u);
+    for (int i = 0; i < 64; ++i) {
+        async.log(fbpp::util::TraceLevel::info, "TraceTest", "x");
+    }
+    EXPECT_GE(async.dropped(), 64u - 5u);   // Ring plus the one in delivery
+    hold.unlock();
+    async.flush();
+    EXPECT_EQ(static_cast<std::uint64_t>(target.delivered.load()) + async.dropped(), 64u);
+}
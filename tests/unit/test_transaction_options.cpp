@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/transaction_options.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/exception.hpp"
+
+#include <chrono>
+#include <tuple>
+
+// TransactionOptions: read-only, NO WAIT / LOCK TIMEOUT conflicts between
+// two connections, snapshot vs read committed visibility, validation.
+// Connection::readTransaction(): reuse, refresh and restart.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+class TransactionOptionsTest : public TempDatabaseTest {
+protected:
+    void SetUp() override {
+        TempDatabaseTest::SetUp();
+        connection_->ExecuteDDL("CREATE TABLE tpb_t (id INTEGER NOT NULL PRIMARY KEY, v INTEGER)");
+        auto tx = connection_->StartTransaction();
+        connection_->ExecuteInTransaction(tx.get(), "INSERT INTO tpb_t VALUES (1, 0)");
+        tx->Commit();
+    }
+
+    int32_t readValue(const std::shared_ptr<Transaction>& tx) {
+        auto cursor = tx->openCursor(connection_->prepareStatement("SELECT v FROM tpb_t WHERE id = 1"));
+        std::tuple<int32_t> row{};
+        EXPECT_TRUE(cursor->fetch(row));
+        cursor->close();
+        return std::get<0>(row);
+    }
+};
+
+TEST_F(TransactionOptionsTest, DefaultOptionsMatchDefaultTransaction) {
+    auto tx = connection_->StartTransaction(TransactionOptions{});
+    connection_->ExecuteInTransaction(tx.get(), "UPDATE tpb_t SET v = 5 WHERE id = 1");
+    EXPECT_EQ(readValue(tx), 5);
+    tx->Commit();
+}
+
+TEST_F(TransactionOptionsTest, ReadOnlyRejectsWrites) {
+    auto tx = connection_->StartTransaction(TransactionOptions::readOnlyReadCommitted());
+    EXPECT_EQ(readValue(tx), 0);
+    EXPECT_THROW(connection_->ExecuteInTransaction(tx.get(), "UPDATE tpb_t SET v = 1 WHERE id = 1"),
+                 FirebirdException);
+    tx->Rollback();
+}
+
+TEST_F(TransactionOptionsTest, ReadCommittedSeesLaterCommits) {
+    auto snapshot = connection_->StartTransaction();
+    auto committed = connection_->StartTransaction(TransactionOptions::readOnlyReadCommitted());
+    EXPECT_EQ(readValue(snapshot), 0);
+    EXPECT_EQ(readValue(committed), 0);
+
+    Connection other(db_params_);
+    auto writer = other.StartTransaction();
+    other.ExecuteInTransaction(writer.get(), "UPDATE tpb_t SET v = 7 WHERE id = 1");
+    writer->Commit();
+
+    EXPECT_EQ(readValue(snapshot), 0);
+    EXPECT_EQ(readValue(committed), 7);
+    snapshot->Commit();
+    committed->Commit();
+}
+
+TEST_F(TransactionOptionsTest, NoWaitConflictsImmediately) {
+    auto holder = connection_->StartTransaction();
+    connection_->ExecuteInTransaction(holder.get(), "UPDATE tpb_t SET v = 1 WHERE id = 1");
+
+    Connection other(db_params_);
+    auto tx = other.StartTransaction(TransactionOptions::noWait(TxIsolation::ReadCommittedRecordVersion));
+    const auto started = std::chrono::steady_clock::now();
+    EXPECT_THROW(other.ExecuteInTransaction(tx.get(), "UPDATE tpb_t SET v = 2 WHERE id = 1"),
+                 FirebirdException);
+    EXPECT_LT(std::chrono::steady_clock::now() - started, std::chrono::milliseconds(900));
+    tx->Rollback();
+    holder->Rollback();
+}
+
+TEST_F(TransactionOptionsTest, LockTimeoutWaitsThenFails) {
+    auto holder = connection_->StartTransaction();
+    connection_->ExecuteInTransaction(holder.get(), "UPDATE tpb_t SET v = 1 WHERE id = 1");
+
+    Connection other(db_params_);
+    auto tx = other.StartTransaction(TransactionOptions::lockTimeout(1, TxIsolation::ReadCommittedRecordVersion));
+    const auto started = std::chrono::steady_clock::now();
+    EXPECT_THROW(other.ExecuteInTransaction(tx.get(), "UPDATE tpb_t SET v = 2 WHERE id = 1"),
+                 FirebirdException);
+    const auto waited = std::chrono::steady_clock::now() - started;
+    EXPECT_GE(waited, std::chrono::milliseconds(800));
+    EXPECT_LT(waited, std::chrono::seconds(5));
+    tx->Rollback();
+    holder->Rollback();
+}
+
+TEST_F(TransactionOptionsTest, LockTimeoutWithNoWaitIsRejected) {
+    TransactionOptions options = TransactionOptions::noWait();
+    options.lockTimeoutSeconds = 3;
+    EXPECT_THROW(connection_->StartTransaction(options), FirebirdException);
+}
+
+TEST_F(TransactionOptionsTest, RepeatedOptionsReuseCachedTpb) {
+    const auto options = TransactionOptions::lockTimeout(2);
+    for (int i = 0; i < 3; ++i) {
+        auto tx = connection_->StartTransaction(options);
+        EXPECT_TRUE(tx->isActive());
+        tx->Commit();
+    }
+}
+
+TEST_F(TransactionOptionsTest, SharedReadTransactionIsReusedAndSeesCommits) {
+    auto first = connection_->readTransaction();
+    EXPECT_EQ(readValue(first), 0);
+    EXPECT_EQ(connection_->readTransaction(), first);
+
+    auto writer = connection_->StartTransaction();
+    connection_->ExecuteInTransaction(writer.get(), "UPDATE tpb_t SET v = 3 WHERE id = 1");
+    writer->Commit();
+    EXPECT_EQ(readValue(connection_->readTransaction()), 3);
+
+    EXPECT_THROW(connection_->ExecuteInTransaction(connection_->readTransaction().get(),
+                                                   "UPDATE tpb_t SET v = 4 WHERE id = 1"),
+                 FirebirdException);
+}
+
+TEST_F(TransactionOptionsTest, SharedReadTransactionRestartsAfterCommit) {
+    auto options = connection_->getOptions();
+    options.readTransactionRefresh = 2;
+    connection_->setOptions(options);
+
+    auto tx = connection_->readTransaction();
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(readValue(connection_->readTransaction()), 0);   // CommitRetaining keeps it
+    }
+    EXPECT_EQ(connection_->readTransaction(), tx);
+
+    tx->Commit();
+    auto restarted = connection_->readTransaction();
+    EXPECT_TRUE(restarted->isActive());
+    EXPECT_NE(restarted, tx);
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/batch.hpp"
+#include "fbpp/core/blob.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/transfer_tuning.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// Transfer tuning — BLOB read, batch chunk and prefetch sizes chosen from
+// the attachment's database info, and the options that override them.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+namespace {
+
+DatabaseInfo remoteInfo(unsigned pageSize, bool compressed = false) {
+    DatabaseInfo info;
+    info.pageSize = pageSize;
+    info.protocolVersion = 17;
+    info.compressed = compressed;
+    return info;
+}
+
+DatabaseInfo embeddedInfo(unsigned pageSize) {
+    DatabaseInfo info;
+    info.pageSize = pageSize;
+    return info;
+}
+
+} // namespace
+
+TEST(TransferTuningTest, RemoteReadsWholeSegmentsAndPrefetches) {
+    const auto tuning = TransferTuning::choose(remoteInfo(8192), {});
+    EXPECT_EQ(tuning.blobReadBytes, TransferTuning::kDefaultBlobReadBytes);
+    EXPECT_EQ(tuning.batchChunkBytes, 1024u * 1024u);
+    EXPECT_EQ(tuning.prefetchFor(256), 256u);
+    EXPECT_EQ(tuning.prefetchFor(16), 1024u);        // Capped
+    EXPECT_EQ(tuning.prefetchFor(32000), 16u);       // Floor for wide rows
+
+    const auto compressed = TransferTuning::choose(remoteInfo(8192, true), {});
+    EXPECT_EQ(compressed.prefetchFor(256), 512u);
+}
+
+TEST(TransferTuningTest, EmbeddedReadsPagesAndDoesNotPrefetch) {
+    const auto small = TransferTuning::choose(embeddedInfo(4096), {});
+    EXPECT_EQ(small.blobReadBytes, 16u * 1024u);
+    EXPECT_EQ(small.batchChunkBytes, 512u * 1024u);
+    EXPECT_EQ(small.prefetchFor(64), 1u);
+
+    const auto large = TransferTuning::choose(embeddedInfo(32768), {});
+    EXPECT_EQ(large.blobReadBytes, TransferTuning::kDefaultBlobReadBytes);
+    EXPECT_EQ(large.batchChunkBytes, TransferTuning::kDefaultBatchChunkBytes);
+}
+
+TEST(TransferTuningTest, UnknownInfoKeepsLibraryDefaults) {
+    const auto tuning = TransferTuning::choose(DatabaseInfo{}, {});
+    EXPECT_EQ(tuning.blobReadBytes, BlobReader::kDefaultReadSize);
+    EXPECT_EQ(tuning.batchChunkBytes, Batch::kDefaultStreamChunkBytes);
+    EXPECT_EQ(tuning.prefetchFor(64), 1u);
+}
+
+TEST(TransferTuningTest, OptionsOverrideChosenSizes) {
+    TransferOptions options;
+    options.blobReadBytes = 1000;
+    options.batchChunkBytes = 70000;
+    options.prefetchRows = 8;
+    const auto tuning = TransferTuning::choose(remoteInfo(16384), options);
+    EXPECT_EQ(tuning.blobReadBytes, 1000u);
+    EXPECT_EQ(tuning.batchChunkBytes, 70000u);
+    EXPECT_EQ(tuning.prefetchFor(16), 8u);
+    EXPECT_EQ(tuning.prefetchFor(60000), 8u);
+
+    TransferOptions fixed;
+    fixed.autoTune = false;
+    const auto untuned = TransferTuning::choose(remoteInfo(4096), fixed);
+    EXPECT_EQ(untuned.blobReadBytes, BlobReader::kDefaultReadSize);
+    EXPECT_EQ(untuned.batchChunkBytes, Batch::kDefaultStreamChunkBytes);
+    EXPECT_EQ(untuned.prefetchFor(64), 1u);
+}
+
+class TransferTuningConnectionTest : public TempDatabaseTest {};
+
+TEST_F(TransferTuningConnectionTest, DatabaseInfoDescribesTheAttachment) {
+    const auto info = connection_->getDatabaseInfo();
+    EXPECT_GE(info.pageSize, 4096u);
+    EXPECT_GE(info.odsMajor, 12u);
+    EXPECT_FALSE(info.serverVersion.empty());
+
+    const auto& tuning = connection_->transferTuning();
+    const auto expected = TransferTuning::choose(info, {});
+    EXPECT_EQ(tuning.blobReadBytes, expected.blobReadBytes);
+    EXPECT_EQ(tuning.batchChunkBytes, expected.batchChunkBytes);
+    EXPECT_EQ(tuning.prefetchFor(128), expected.prefetchFor(128));
+}
+
+TEST_F(TransferTuningConnectionTest, CursorsBatchesAndBlobsUseTheTuning) {
+    auto tx = connection_->StartTransaction();
+    auto select = connection_->prepareStatement("SELECT id, name FROM test_table");
+    auto cursor = tx->openCursor(select);
+    EXPECT_EQ(cursor->getPrefetch(), connection_->transferTuning().prefetchFor(
+                                         select->getOutputMetadata()->getAlignedLength()));
+    cursor->close();
+
+    auto insert = connection_->prepareStatement("INSERT INTO test_table (id, name) VALUES (?, ?)");
+    auto batch = insert->createBatch(tx.get());
+    EXPECT_EQ(batch->getStreamChunkBytes(), connection_->transferTuning().batchChunkBytes);
+
+    const std::vector<uint8_t> data(1000, 0x5a);
+    const ISC_QUAD id = tx->createBlob(data);
+    auto reader = tx->openBlob(id);
+    EXPECT_EQ(reader.readSize(), connection_->transferTuning().blobReadBytes);
+    EXPECT_EQ(reader.readAll(), data);
+    tx->Rollback();
+}
+
+TEST_F(TransferTuningConnectionTest, ExplicitOptionsWin) {
+    ConnectionOptions options = connection_->getOptions();
+    options.transfer.blobReadBytes = 100;
+    options.transfer.batchChunkBytes = 300000;
+    options.transfer.prefetchRows = 7;
+    connection_->setOptions(options);
+
+    auto tx = connection_->StartTransaction();
+    auto cursor = tx->openCursor(connection_->prepareStatement("SELECT id FROM test_table"));
+    EXPECT_EQ(cursor->getPrefetch(), 7u);
+    cursor->close();
+
+    auto insert = connection_->prepareStatement("INSERT INTO test_table (id) VALUES (?)");
+    EXPECT_EQ(insert->createBatch(tx.get())->getStreamChunkBytes(), 300000u);
+
+    const std::vector<uint8_t> data(250, 0x11);
+    auto reader = tx->openBlob(tx->createBlob(data));
+    EXPECT_EQ(reader.readSize(), 100u);
+    EXPECT_EQ(reader.readAll(), data);
+
+    // An explicit read size still beats both
+    auto wide = tx->openBlob(tx->createBlob(data), 4096);
+    EXPECT_EQ(wide.readSize(), 4096u);
+    tx->Rollback();
+}
@@ -237,6 +237,22 @@ TEST(TypeMapper, TimeTz) {
     EXPECT_TRUE(r.needsExtendedTypes);
 }
 
+TEST(TypeMapper, ShortStringsInlineWhenEnabled) {
+    AdapterConfig cfg;
+    cfg.inlineStringBytes = 16;
+    auto code = TypeMapper::mapField(makeField(SQL_VARYING, 0, 12), false, cfg);
+    EXPECT_EQ(code.cppType, "fbpp::core::FixedString<12>");
+    EXPECT_TRUE(code.needsExtendedTypes);
+    EXPECT_FALSE(code.needsString);
+
+    auto flag = TypeMapper::mapField(makeField(SQL_TEXT | 1U, 0, 16), true, cfg);
+    EXPECT_EQ(flag.cppType, "std::optional<fbpp::core::FixedString<16>>");
+
+    auto wide = TypeMapper::mapField(makeField(SQL_VARYING, 0, 17), false, cfg);
+    EXPECT_EQ(wide.cppType, "std::string");
+    EXPECT_EQ(TypeMapper::mapField(makeField(SQL_VARYING, 0, 12), false).cppType, "std::string");
+}
+
 // ---------------------------------------------------------------------------
 // BLOB
 // ---------------------------------------------------------------------------
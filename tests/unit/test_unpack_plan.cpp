@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/pack_utils.hpp"
+#include "fbpp/core/unpack_plan.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// UnpackPlan<T>: per-metadata tuple/struct unpacking with typed column loads.
+
+namespace {
+
+struct UnplanRow {
+    int32_t id;
+    int64_t small;               // wider than SMALLINT: typed load
+    double dbl;
+    std::string vc;
+    std::string ch;
+    double num;                  // scaled: codec
+    std::optional<int32_t> opt;
+    std::optional<std::string> asText;   // INTEGER as text: codec
+};
+
+} // namespace
+
+namespace fbpp::core {
+
+template<>
+struct StructDescriptor<UnplanRow> {
+    static constexpr auto fields = std::make_tuple(
+        makeField<&UnplanRow::id>("ID", SQL_LONG, 0, sizeof(int32_t)),
+        makeField<&UnplanRow::small>("F_SMALL", SQL_SHORT, 0, sizeof(int16_t), 0, true),
+        makeField<&UnplanRow::dbl>("F_DBL", SQL_DOUBLE, 0, sizeof(double), 0, true),
+        makeField<&UnplanRow::vc>("F_VC", SQL_VARYING, 0, 16, 0, true),
+        makeField<&UnplanRow::ch>("F_CH", SQL_TEXT, 0, 4, 0, true),
+        makeField<&UnplanRow::num>("F_NUM", SQL_LONG, -2, sizeof(int32_t), 0, true),
+        makeField<&UnplanRow::opt>("F_OPT", SQL_LONG, 0, sizeof(int32_t), 0, true),
+        makeField<&UnplanRow::asText>("F_TEXT", SQL_LONG, 0, sizeof(int32_t), 0, true)
+    );
+};
+
+} // namespace fbpp::core
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+
+namespace {
+
+using UnplanTuple = std::tuple<int32_t, int64_t, double, std::string, std::string, double,
+                               std::optional<int32_t>, std::optional<std::string>>;
+
+constexpr const char* kSelect =
+    "SELECT id, f_small, f_dbl, f_vc, f_ch, f_num, f_opt, f_opt AS f_text "
+    "FROM up_t ORDER BY id";
+
+} // namespace
+
+class UnpackPlanTest : public TempDatabaseTest {
+protected:
+    void createTestSchema() override {
+        TempDatabaseTest::createTestSchema();
+        connection_->ExecuteDDL(R"(
+            CREATE TABLE up_t (
+                id      INTEGER NOT NULL PRIMARY KEY,
+                f_small SMALLINT,
+                f_dbl   DOUBLE PRECISION,
+                f_vc    VARCHAR(16),
+                f_ch    CHAR(4),
+                f_num   NUMERIC(9,2),
+                f_opt   INTEGER
+            )
+        )");
+        auto tx = connection_->StartTransaction();
+        auto insert = connection_->prepareStatement(
+            "INSERT INTO up_t (id, f_small, f_dbl, f_vc, f_ch, f_num, f_opt) "
+            "VALUES (?, ?, ?, ?, ?, ?, ?)");
+        tx->execute(insert, std::make_tuple(int32_t{1}, int16_t{-7}, 0.5, std::string("varying"),
+                                            std::string("ab"), 12.34, std::optional<int32_t>(42)));
+        tx->execute(insert, std::make_tuple(int32_t{2}, int16_t{3}, -1.25, std::string("x"),
+                                            std::string("abcd"), -0.01,
+                                            std::optional<int32_t>{}));
+        tx->Commit();
+    }
+};
+
+TEST_F(UnpackPlanTest, PlanIsBuiltOncePerMetadata) {
+    auto stmt = connection_->prepareStatement(kSelect);
+    auto meta = stmt->getOutputMetadata();
+    ASSERT_TRUE(meta);
+
+    const auto& first = UnpackPlan<UnplanTuple>::of(*meta);
+    EXPECT_EQ(&first, &UnpackPlan<UnplanTuple>::of(*meta));
+    EXPECT_NE(static_cast<const void*>(&UnpackPlan<UnplanRow>::of(*meta)),
+              static_cast<const void*>(&first));
+}
+
+TEST_F(UnpackPlanTest, ValidatesShapeUpFront) {
+    auto stmt = connection_->prepareStatement(kSelect);
+    auto meta = stmt->getOutputMetadata();
+
+    EXPECT_THROW(UnpackPlan<std::tuple<int32_t>>{*meta}, FirebirdException);
+
+    // A struct whose descriptor disagrees with the column type fails at
+    // plan time, and is not cached: the next use throws again
+    auto other = connection_->prepareStatement(
+        "SELECT id, f_dbl, f_dbl, f_vc, f_ch, f_num, f_opt, f_opt FROM up_t");
+    EXPECT_THROW((void)UnpackPlan<UnplanRow>::of(*other->getOutputMetadata()), FirebirdException);
+    EXPECT_THROW((void)UnpackPlan<UnplanRow>::of(*other->getOutputMetadata()), FirebirdException);
+}
+
+TEST_F(UnpackPlanTest, TupleAndStructReadTheSameValues) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement(kSelect);
+
+    auto cur = tx->openCursor(stmt);
+    std::vector<UnplanTuple> tuples;
+    UnplanTuple tuple;
+    while (cur->fetch(tuple)) {
+        tuples.push_back(tuple);
+    }
+    cur->close();
+
+    cur = tx->openCursor(stmt);
+    std::vector<UnplanRow> rows;
+    UnplanRow row;
+    while (cur->fetch(row)) {
+        rows.push_back(row);
+    }
+    cur->close();
+    tx->Commit();
+
+    ASSERT_EQ(tuples.size(), 2u);
+    ASSERT_EQ(rows.size(), 2u);
+
+    EXPECT_EQ(std::get<1>(tuples[0]), -7);
+    EXPECT_DOUBLE_EQ(std::get<2>(tuples[0]), 0.5);
+    EXPECT_EQ(std::get<3>(tuples[0]), "varying");
+    EXPECT_EQ(std::get<4>(tuples[0]), "ab");          // CHAR padding trimmed as by the codec
+    EXPECT_DOUBLE_EQ(std::get<5>(tuples[0]), 12.34);
+    EXPECT_EQ(std::get<6>(tuples[0]), 42);
+    EXPECT_EQ(std::get<7>(tuples[0]), "42");
+    EXPECT_FALSE(std::get<6>(tuples[1]).has_value());
+    EXPECT_FALSE(std::get<7>(tuples[1]).has_value());
+    EXPECT_EQ(std::get<4>(tuples[1]), "abcd");
+
+    for (size_t i = 0; i < rows.size(); ++i) {
+        EXPECT_EQ(rows[i].id, std::get<0>(tuples[i]));
+        EXPECT_EQ(rows[i].small, std::get<1>(tuples[i]));
+        EXPECT_DOUBLE_EQ(rows[i].dbl, std::get<2>(tuples[i]));
+        EXPECT_EQ(rows[i].vc, std::get<3>(tuples[i]));
+        EXPECT_EQ(rows[i].ch, std::get<4>(tuples[i]));
+        EXPECT_DOUBLE_EQ(rows[i].num, std::get<5>(tuples[i]));
+        EXPECT_EQ(rows[i].opt, std::get<6>(tuples[i]));
+        EXPECT_EQ(rows[i].asText, std::get<7>(tuples[i]));
+    }
+}
+
+TEST_F(UnpackPlanTest, TypedLoadsKeepCodecNullRules) {
+    auto tx = connection_->StartTransaction();
+    auto stmt = connection_->prepareStatement("SELECT f_opt FROM up_t WHERE id = 2");
+    auto cur = tx->openCursor(stmt);
+
+    // NULL into a plain int32_t: typed load, same error as the codec
+    std::tuple<int32_t> plain;
+    EXPECT_THROW(cur->fetch(plain), FirebirdException);
+    cur->close();
+
+    // A present optional is reset
+    cur = tx->openCursor(stmt);
+    std::tuple<std::optional<int32_t>> opt{5};
+    ASSERT_TRUE(cur->fetch(opt));
+    EXPECT_FALSE(std::get<0>(opt).has_value());
+    cur->close();
+    tx->Commit();
+}
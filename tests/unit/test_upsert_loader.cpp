@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/batch.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/schema/upsert_loader.hpp"
+
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// UpsertLoader — PK-matched MERGE through a staging GTT, UPDATE OR INSERT.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+using fbpp::schema::UpsertLoader;
+using fbpp::schema::UpsertMode;
+using fbpp::schema::UpsertOptions;
+
+class UpsertLoaderTest : public TempDatabaseTest {
+protected:
+    using Product = std::tuple<int32_t, std::string, double>;
+
+    void createTestSchema() override {
+        connection_->ExecuteDDL(
+            "CREATE TABLE product (id INTEGER NOT NULL PRIMARY KEY,"
+            " name VARCHAR(30) CHARACTER SET UTF8, price NUMERIC(12, 2))");
+        connection_->ExecuteDDL("CREATE TABLE nokey (code VARCHAR(10), val INTEGER)");
+        auto tx = connection_->StartTransaction();
+        auto batch = connection_->prepareStatement("INSERT INTO product VALUES (?, ?, ?)")
+                         ->createBatch(tx.get(), false);
+        std::vector<Product> rows;
+        for (int32_t i = 1; i <= 100; ++i) {
+            rows.emplace_back(i, "old " + std::to_string(i), 1.0);
+        }
+        batch->addMany(rows);
+        batch->execute(tx.get());
+        tx->Commit();
+    }
+
+    // Rows 51..150: half of them present, half new
+    static std::vector<Product> changes() {
+        std::vector<Product> rows;
+        for (int32_t i = 51; i <= 150; ++i) {
+            rows.emplace_back(i, "new " + std::to_string(i), 2.5);
+        }
+        return rows;
+    }
+
+    std::tuple<int64_t, int64_t> countNewAndAll() {
+        auto tx = connection_->StartTransaction();
+        auto cur = tx->openCursor(connection_->prepareStatement(
+            "SELECT COUNT(CASE WHEN name STARTING WITH 'new' THEN 1 END), COUNT(*) FROM product"));
+        std::tuple<int64_t, int64_t> row;
+        EXPECT_TRUE(cur->fetch(row));
+        cur->close();
+        tx->Commit();
+        return row;
+    }
+};
+
+TEST_F(UpsertLoaderTest, MergeCountsInsertedAndUpdated) {
+    auto tx = connection_->StartTransaction();
+    UpsertOptions options;
+    options.load.flushBytes = 2048;   // Several flushes, each merged on its own
+    UpsertLoader<Product> loader(*connection_, tx, "product", options);
+    EXPECT_EQ(loader.plan().matching(), std::vector<std::string>{"ID"});
+    EXPECT_EQ(loader.plan().stagingTable().rfind("FBPP_STAGE_", 0), 0u);
+
+    loader.addMany(changes());
+    const auto stats = loader.finish();
+    tx->Commit();
+
+    EXPECT_GT(stats.flushes, 1u);
+    EXPECT_EQ(stats.rows, 100u);
+    EXPECT_EQ(stats.failed, 0u);
+    EXPECT_EQ(stats.affected, 100u);
+    ASSERT_TRUE(stats.inserted && stats.updated);
+    EXPECT_EQ(*stats.inserted, 50u);
+    EXPECT_EQ(*stats.updated, 50u);
+    EXPECT_EQ(countNewAndAll(), std::make_tuple(int64_t{100}, int64_t{150}));
+}
+
+TEST_F(UpsertLoaderTest, UpdateOrInsertReportsTotalsOnly) {
+    auto tx = connection_->StartTransaction();
+    UpsertOptions options;
+    options.mode = UpsertMode::updateOrInsert;
+    UpsertLoader<Product> loader(*connection_, tx, "PRODUCT", options);
+    EXPECT_NE(loader.plan().loadSql().find("MATCHING (ID)"), std::string::npos);
+
+    loader.addMany(changes());
+    const auto stats = loader.finish();
+    tx->Commit();
+
+    EXPECT_EQ(stats.affected, 100u);
+    EXPECT_FALSE(stats.inserted.has_value());
+    EXPECT_EQ(countNewAndAll(), std::make_tuple(int64_t{100}, int64_t{150}));
+}
+
+TEST_F(UpsertLoaderTest, ExplicitColumnsAndMatching) {
+    auto tx = connection_->StartTransaction();
+    UpsertOptions options;
+    options.columns = {"code", "val"};
+    options.matching = {"code"};
+    UpsertLoader<std::tuple<std::string, int32_t>> loader(*connection_, tx, "nokey", options);
+    loader.add({"a", 1});
+    loader.flush();
+    loader.add({"a", 2});
+    loader.add({"b", 3});
+    const auto stats = loader.finish();
+    tx->Commit();
+
+    EXPECT_EQ(*stats.inserted, 2u);
+    EXPECT_EQ(*stats.updated, 1u);
+}
+
+TEST_F(UpsertLoaderTest, TableWithoutKeyNeedsMatching) {
+    auto tx = connection_->StartTransaction();
+    using Row = std::tuple<std::string, int32_t>;
+    EXPECT_THROW(UpsertLoader<Row>(*connection_, tx, "nokey"), FirebirdException);
+    EXPECT_THROW(UpsertLoader<Row>(*connection_, tx, "no_such_table"), FirebirdException);
+    tx->Rollback();
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp/schema/watermark_sync.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <tuple>
+
+// WatermarkSync — incremental copy by a version column, one commit per chunk.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+using fbpp::schema::WatermarkSync;
+using fbpp::schema::WatermarkSyncOptions;
+
+class WatermarkSyncTest : public TempDatabaseTest {
+protected:
+    using Account = std::tuple<int32_t, std::string, int64_t>;
+    using Sync = WatermarkSync<Account, int64_t>;
+
+    // Ten accounts; versions 1,1,2,2,...,5,5 so chunks meet equal watermarks
+    void createTestSchema() override {
+        const char* columns =
+            " (id INTEGER NOT NULL PRIMARY KEY, name VARCHAR(30), version BIGINT)";
+        connection_->ExecuteDDL(std::string("CREATE TABLE account") + columns);
+        connection_->ExecuteDDL(std::string("CREATE TABLE account_copy") + columns);
+        auto tx = connection_->StartTransaction();
+        auto insert = connection_->prepareStatement("INSERT INTO account VALUES (?, ?, ?)");
+        for (int32_t id = 1; id <= 10; ++id) {
+            tx->execute(insert, std::make_tuple(id, "v1 " + std::to_string(id),
+                                                static_cast<int64_t>((id + 1) / 2)));
+        }
+        tx->Commit();
+    }
+
+    WatermarkSyncOptions options() const {
+        WatermarkSyncOptions options;
+        options.watermarkColumn = "version";
+        options.targetTable = "account_copy";
+        options.chunkRows = 3;
+        return options;
+    }
+
+    std::tuple<int64_t, int64_t> copied() {
+        auto tx = connection_->StartTransaction();
+        auto cur = tx->openCursor(connection_->prepareStatement(
+            "SELECT COUNT(*), COUNT(CASE WHEN name STARTING WITH 'v2' THEN 1 END)"
+            " FROM account_copy"));
+        std::tuple<int64_t, int64_t> row;
+        EXPECT_TRUE(cur->fetch(row));
+        cur->close();
+        tx->Commit();
+        return row;
+    }
+};
+
+TEST_F(WatermarkSyncTest, CopiesOnlyWhatChanged) {
+    Sync sync(*connection_, *connection_, "account", options());
+    EXPECT_EQ(sync.plan().columns(), (std::vector<std::string>{"ID", "NAME", "VERSION"}));
+    EXPECT_EQ(sync.plan().watermarkIndex(), 2u);
+    EXPECT_FALSE(sync.watermark().has_value());
+
+    const auto first = sync.run();
+    EXPECT_EQ(first.rows, 10u);
+    EXPECT_EQ(first.affected, 10u);
+    // 3 rows reach the limit mid-way through a version; chunks close at 4, 8, 10
+    EXPECT_EQ(first.chunks, 3u);
+    EXPECT_EQ(sync.watermark(), std::optional<int64_t>(5));
+    EXPECT_EQ(copied(), std::make_tuple(int64_t{10}, int64_t{0}));
+
+    EXPECT_EQ(sync.run().rows, 0u);
+
+    auto tx = connection_->StartTransaction();
+    tx->execute(connection_->prepareStatement(
+        "UPDATE account SET name = 'v2 ' || id, version = 6 WHERE id IN (2, 7)"));
+    tx->Commit();
+
+    const auto second = sync.run();
+    EXPECT_EQ(second.rows, 2u);
+    EXPECT_EQ(second.chunks, 1u);
+    EXPECT_EQ(sync.watermark(), std::optional<int64_t>(6));
+    EXPECT_EQ(copied(), std::make_tuple(int64_t{10}, int64_t{2}));
+}
+
+TEST_F(WatermarkSyncTest, RejectsMissingWatermarkColumn) {
+    auto missing = options();
+    missing.columns = {"id", "name"};
+    EXPECT_THROW(Sync(*connection_, *connection_, "account", missing), FirebirdException);
+
+    auto unnamed = options();
+    unnamed.watermarkColumn.clear();
+    EXPECT_THROW(Sync(*connection_, *connection_, "account", unnamed), FirebirdException);
+}
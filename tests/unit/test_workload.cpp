@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include "../test_base.hpp"
+#include "fbpp/core/connection.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp/core/span_observer.hpp"
+#include "fbpp/core/statement.hpp"
+#include "fbpp/core/transaction.hpp"
+#include "fbpp_util/workload.hpp"
+
+#include <sstream>
+#include <string>
+#include <tuple>
+
+// Workload record / replay: WorkloadRecorder file format, replay against
+// the test database and the baseline comparison.
+
+using namespace fbpp::core;
+using namespace fbpp::test;
+using fbpp::util::StatementTiming;
+using fbpp::util::WorkloadCall;
+using fbpp::util::WorkloadRecorder;
+
+class WorkloadTest : public TempDatabaseTest {
+protected:
+    void createTestSchema() override {
+        connection_->ExecuteDDL(
+            "CREATE TABLE wl_t (id INTEGER NOT NULL PRIMARY KEY, name VARCHAR(20))");
+    }
+
+    void TearDown() override {
+        setSpanObserver(nullptr);
+        TempDatabaseTest::TearDown();
+    }
+};
+
+TEST_F(WorkloadTest, RecordsCallsWithInputMessages) {
+    std::stringstream out;
+    {
+        WorkloadRecorder recorder(out);
+        setSpanObserver(&recorder);
+        auto insert = connection_->prepareStatement("INSERT INTO wl_t (id, name) VALUES (?, ?)");
+        auto select = connection_->prepareStatement("SELECT id, name FROM wl_t WHERE id = ?");
+        auto tx = connection_->StartTransaction();
+        tx->execute(insert, std::make_tuple(1, std::string("one")));
+        tx->execute(insert, std::make_tuple(2, std::string("two")));
+        auto cursor = tx->openCursor(select, std::make_tuple(2));
+        std::tuple<int, std::string> row;
+        EXPECT_TRUE(cursor->fetch(row));
+        cursor->close();
+        tx->Commit();
+        setSpanObserver(nullptr);
+        EXPECT_EQ(recorder.calls(), 4u);
+    }
+
+    const auto workload = fbpp::util::readWorkload(out);
+    ASSERT_EQ(workload.statements.size(), 2u);
+    ASSERT_EQ(workload.calls.size(), 4u);
+    EXPECT_EQ(workload.calls[0].kind, WorkloadCall::Kind::Execute);
+    EXPECT_EQ(workload.calls[2].kind, WorkloadCall::Kind::Cursor);
+    EXPECT_EQ(workload.calls[2].rows, 1u);
+    EXPECT_EQ(workload.calls[3].kind, WorkloadCall::Kind::Commit);
+
+    const auto& insert = workload.statements.at(workload.calls[0].fingerprint);
+    EXPECT_EQ(insert.input.size(), 2u);
+    EXPECT_EQ(workload.calls[0].input.size(), insert.inputLength);
+    EXPECT_NE(workload.calls[0].input, workload.calls[1].input);
+}
+
+TEST_F(WorkloadTest, ReplaysRecordingAgainstDatabase) {
+    std::stringstream out;
+    {
+        WorkloadRecorder recorder(out);
+        setSpanObserver(&recorder);
+        auto insert = connection_->prepareStatement("INSERT INTO wl_t (id, name) VALUES (?, ?)");
+        auto select = connection_->prepareStatement("SELECT id, name FROM wl_t WHERE id <= ?");
+        auto tx = connection_->StartTransaction();
+        for (int i = 1; i <= 10; ++i) {
+            tx->execute(insert, std::make_tuple(i, "row " + std::to_string(i)));
+        }
+        auto cursor = tx->openCursor(select, std::make_tuple(5));
+        std::tuple<int, std::string> row;
+        while (cursor->fetch(row)) {
+        }
+        cursor->close();
+        tx->Rollback();   // Keep the table empty for the replay
+        setSpanObserver(nullptr);
+    }
+
+    const auto workload = fbpp::util::readWorkload(out);
+    const auto timings = fbpp::util::replayWorkload(*connection_, workload);
+    ASSERT_EQ(timings.size(), 2u);
+    for (const auto& [fingerprint, t] : timings) {
+        EXPECT_EQ(t.failures, 0u) << t.sql;
+        if (t.sql.rfind("INSERT", 0) == 0) {
+            EXPECT_EQ(t.calls, 10u);
+            EXPECT_EQ(t.rows, 10u);
+        } else {
+            EXPECT_EQ(t.calls, 1u);
+            EXPECT_EQ(t.rows, 5u);   // The replayed inserts are visible in its transaction
+        }
+        EXPECT_GT(t.p50Micros, 0.0);
+    }
+
+    // The recorded rollback undid the replayed rows too
+    auto tx = connection_->StartTransaction();
+    auto count = tx->openCursor(connection_->prepareStatement("SELECT COUNT(*) FROM wl_t"));
+    std::tuple<int64_t> n;
+    ASSERT_TRUE(count->fetch(n));
+    EXPECT_EQ(std::get<0>(n), 0);
+    count->close();
+    tx->Commit();
+}
+
+TEST(WorkloadBaselineTest, FlagsStatementsSlowerThanThreshold) {
+    std::map<uint64_t, StatementTiming> before;
+    before[1] = StatementTiming{1, "SELECT 1", 10, 0, 10, 100.0, 100.0, 150.0};
+    before[2] = StatementTiming{2, "SELECT 2", 10, 0, 10, 200.0, 200.0, 300.0};
+    before[3] = StatementTiming{3, "SELECT 3", 10, 0, 10, 50.0, 50.0, 60.0};
+    const auto baseline = fbpp::util::timingsToJson(before);
+
+    auto after = before;
+    after[1].p50Micros = 109.0;   // +9%: within 10%
+    after[2].p50Micros = 260.0;   // +30%
+    after[3].p50Micros = 80.0;    // +60%, but too few calls
+    after[3].calls = 2;
+
+    const auto regressions = fbpp::util::compareToBaseline(after, baseline, 0.10);
+    ASSERT_EQ(regressions.size(), 1u);
+    EXPECT_EQ(regressions[0].fingerprint, 2u);
+    EXPECT_NEAR(regressions[0].change, 0.30, 1e-9);
+}
+
+TEST(WorkloadFileTest, RejectsMalformedLines) {
+    std::istringstream in("{\"call\":\"execute\",\"fp\":\"00000000000000ff\",\"input\":\"abc\"}\n");
+    EXPECT_THROW(fbpp::util::readWorkload(in), std::runtime_error);
+}
@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+
+#include "fbpp/core/batch.hpp"
+#include "fbpp/core/message_builder.hpp"
+#include "fbpp/core/param_binder.hpp"
+#include "fbpp/core/result_set.hpp"
+#include "fbpp_util/alloc_counter.hpp"
+#include "fbpp_util/replay_backend.hpp"
+
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Zero-allocation hot paths — after warm-up, reading or binding one more
+// row must not touch the heap. Runs on the replay backend, no server.
+
+using namespace fbpp::core;
+using fbpp::util::AllocationCounter;
+using fbpp::util::RecordedMessages;
+using fbpp::util::ReplayCapture;
+using fbpp::util::ReplaySession;
+
+namespace {
+
+constexpr int32_t kWarmRows = 16;
+constexpr int32_t kRows = 512;
+
+std::shared_ptr<const MessageMetadata> idLabelMetadata() {
+    MessageBuilder builder(2);
+    builder.addField<int32_t>("ID");
+    builder.addFieldWithLength<std::string>("LABEL", 64);
+    return std::shared_ptr<const MessageMetadata>(builder.build());
+}
+
+// Past the small-string buffer, so a copy of it would allocate
+std::string longLabel(int32_t id) {
+    return std::string(40, 'x') + std::to_string(id);
+}
+
+std::shared_ptr<RecordedMessages> recordRows(ReplaySession& session, int32_t count) {
+    auto metadata = idLabelMetadata();
+    auto layout = std::make_shared<RecordedMessages>(*metadata);
+    auto capture = std::make_shared<ReplayCapture>(true);
+    auto insert = session.prepareInsert(layout, capture);
+
+    std::vector<std::tuple<int32_t, std::string>> rows;
+    for (int32_t id = 1; id <= count; ++id) {
+        rows.emplace_back(id, longLabel(id));
+    }
+    auto batch = insert->createBatch(session.transaction().get());
+    batch->addMany(rows);
+    batch->execute(session.transaction().get());
+
+    auto recording = std::make_shared<RecordedMessages>(*metadata);
+    const auto bytes = capture->data();
+    for (size_t offset = 0; offset < bytes.size(); offset += recording->messageLength()) {
+        recording->add(bytes.data() + offset);
+    }
+    return recording;
+}
+
+// Statement counting its input messages without keeping them
+std::shared_ptr<Statement> countingInsert(ReplaySession& session) {
+    auto layout = std::make_shared<RecordedMessages>(*idLabelMetadata());
+    return session.prepareInsert(layout, std::make_shared<ReplayCapture>());
+}
+
+} // namespace
+
+TEST(ZeroAllocTest, CounterSeesThisThreadsAllocations) {
+    AllocationCounter counter;
+    auto owned = std::make_unique<std::vector<int>>(100);
+    EXPECT_GE(counter.allocations(), 2u);
+    EXPECT_GE(counter.bytes(), 100 * sizeof(int));
+    owned.reset();
+    EXPECT_GE(counter.deallocations(), 2u);
+
+    counter.reset();
+    int local = 42;
+    EXPECT_EQ(local, 42);
+    EXPECT_EQ(counter.allocations(), 0u);
+    EXPECT_EQ(counter.bytes(), 0u);
+}
+
+TEST(ZeroAllocTest, RowViewIteration) {
+    ReplaySession session;
+    auto select = session.prepare(recordRows(session, kRows));
+    auto cursor = session.transaction()->openCursor(select);
+    cursor->setPrefetch(64);
+
+    AllocationCounter counter;
+    int32_t seen = 0;
+    int64_t sum = 0;
+    size_t labelBytes = 0;
+    for (const auto& view : cursor->rows()) {
+        if (seen == kWarmRows) {
+            counter.reset();
+        }
+        sum += view.get<int32_t>(0).value();
+        labelBytes += view.getView(1).value().size();
+        ++seen;
+    }
+    const auto allocations = counter.allocations();
+    EXPECT_EQ(allocations, 0u);
+    EXPECT_EQ(seen, kRows);
+    EXPECT_EQ(sum, int64_t{kRows} * (kRows + 1) / 2);
+    EXPECT_GT(labelBytes, 40u * kRows);
+    cursor->close();
+}
+
+TEST(ZeroAllocTest, ParamBinderSlotRebinding) {
+    ReplaySession session;
+    auto insert = countingInsert(session);
+    insert->setNamedParamMapping({{"id", {0}}, {"label", {1}}}, true);
+    auto tx = session.transaction();
+
+    auto& binder = insert->binder(tx.get());
+    const ParamSlot id = binder.slot("id");
+    const ParamSlot label = binder.slot("label");
+    ASSERT_FALSE(id.empty());
+    ASSERT_FALSE(label.empty());
+
+    // Labels made up front: building them is the caller's allocation
+    std::vector<std::string> labels;
+    for (int32_t i = 0; i < kRows; ++i) {
+        labels.push_back(longLabel(i));
+    }
+
+    AllocationCounter counter;
+    for (int32_t i = 0; i < kRows; ++i) {
+        if (i == kWarmRows) {
+            counter.reset();
+        }
+        auto& rebound = insert->binder(tx.get());
+        ASSERT_TRUE(rebound.bind(id, i));
+        ASSERT_TRUE(rebound.bind(label, labels[i]));
+        tx->execute(insert, rebound);
+    }
+    EXPECT_EQ(counter.allocations(), 0u);
+}
+
+TEST(ZeroAllocTest, CachedStatementExecute) {
+    ReplaySession session;
+    auto insert = countingInsert(session);
+    auto tx = session.transaction();
+
+    std::vector<std::tuple<int32_t, std::string>> rows;
+    for (int32_t i = 0; i < kRows; ++i) {
+        rows.emplace_back(i, i % 2 ? longLabel(i) : std::string("short"));
+    }
+
+    AllocationCounter counter;
+    for (int32_t i = 0; i < kRows; ++i) {
+        if (i == kWarmRows) {
+            counter.reset();
+        }
+        tx->execute(insert, rows[i]);
+    }
+    EXPECT_EQ(counter.allocations(), 0u);
+}
+
+TEST(ZeroAllocTest, BatchChunkPacking) {
+    ReplaySession session;
+    auto insert = countingInsert(session);
+    auto tx = session.transaction();
+
+    std::vector<std::tuple<int32_t, std::string>> chunk;
+    for (int32_t i = 0; i < 64; ++i) {
+        chunk.emplace_back(i, longLabel(i));
+    }
+
+    auto batch = insert->createBatch(tx.get());
+    batch->addMany(chunk);   // Sizes the packing stream and the add() buffer
+    batch->add(chunk.front());
+
+    AllocationCounter counter;
+    for (int round = 0; round < 8; ++round) {
+        batch->addMany(chunk);
+        batch->add(chunk.front());
+    }
+    EXPECT_EQ(counter.allocations(), 0u);
+}
+
+TEST(ZeroAllocTest, CursorReopenReusesFetchBuffers) {
+    ReplaySession session;
+    auto select = session.prepare(recordRows(session, kRows));
+    auto tx = session.transaction();
+    const size_t windowBytes = size_t{64} * idLabelMetadata()->getAlignedLength();
+    EXPECT_EQ(select->recycledFetchBytes(), 0u);
+
+    auto drain = [&] {
+        auto cursor = tx->openCursor(select);
+        cursor->setPrefetch(64);
+        int32_t seen = 0;
+        for (const auto& view : cursor->rows()) {
+            seen += view.get<int32_t>(0).value() > 0;
+        }
+        cursor->close();
+        return seen;
+    };
+    ASSERT_EQ(drain(), kRows);
+    EXPECT_GE(select->recycledFetchBytes(), windowBytes);
+
+    // Each reopen still allocates its ResultSet and the server cursor, but
+    // no longer the prefetch window
+    AllocationCounter counter;
+    for (int round = 0; round < 8; ++round) {
+        ASSERT_EQ(drain(), kRows);
+    }
+    EXPECT_LT(counter.bytes() / 8, windowBytes);
+    EXPECT_GE(select->recycledFetchBytes(), windowBytes);
+}